@@ -13,8 +13,11 @@
 #ifndef __PROCESS_COLLECT_HPP__
 #define __PROCESS_COLLECT_HPP__
 
+#include <atomic>
 #include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <tuple>
 
 #include <process/check.hpp>
@@ -24,7 +27,9 @@
 #include <process/owned.hpp>
 #include <process/process.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/lambda.hpp>
+#include <stout/synchronized.hpp>
 
 // TODO(bmahler): Move these into a futures.hpp header to group Future
 // related utilities.
@@ -115,153 +120,144 @@ Future<Future<T>> await(const Future<T>& future)
 
 namespace internal {
 
-template <typename T>
-class CollectProcess : public Process<CollectProcess<T>>
+// The state shared by the callbacks of the futures being collected or
+// awaited, which complete the promise from whichever thread completes
+// the last future rather than dispatching to a process of their own.
+//
+// The first callback to take the promise out of the state, under the
+// lock, is the one completing it, so that the promise gets completed
+// (and its callbacks run) outside of the lock. Taking out the futures
+// along with the promise breaks the cycle between the futures and the
+// callbacks referencing this state.
+template <typename T, typename R>
+class Waiter
 {
 public:
-  CollectProcess(
-      const std::list<Future<T>>& _futures,
-      Promise<std::list<T>>* _promise)
-    : ProcessBase(ID::generate("__collect__")),
-      futures(_futures),
-      promise(_promise),
-      ready(0) {}
-
-  virtual ~CollectProcess()
-  {
-    delete promise;
-  }
+  explicit Waiter(const std::list<Future<T>>& _futures)
+    : futures(_futures),
+      promise(new Promise<R>()),
+      pending(_futures.size()) {}
+
+  Future<R> future() { return promise->future(); }
+
+  // Returns whether this was the last future to complete.
+  bool completed() { return pending.fetch_sub(1) == 1; }
 
-protected:
-  virtual void initialize()
+  // Returns the promise along with the futures, unless they were
+  // already taken out.
+  std::unique_ptr<Promise<R>> take(std::list<Future<T>>* _futures)
   {
-    // Stop this nonsense if nobody cares.
-    promise->future().onDiscard(defer(this, &CollectProcess::discarded));
+    std::unique_ptr<Promise<R>> result;
 
-    foreach (const Future<T>& future, futures) {
-      future.onAny(defer(this, &CollectProcess::waited, lambda::_1));
-      future.onAbandoned(defer(this, &CollectProcess::abandoned));
+    synchronized (mutex) {
+      result = std::move(promise);
+      std::swap(*_futures, futures);
     }
-  }
 
-private:
-  void abandoned()
-  {
-    // There is no use waiting because this future will never complete
-    // so terminate this process which will cause `promise` to get
-    // deleted and our future to also be abandoned.
-    terminate(this);
+    return result;
   }
 
   void discarded()
   {
-    foreach (Future<T> future, futures) {
-      future.discard();
-    }
-
-    // NOTE: we discard the promise after we set discard on each of
-    // the futures so that there is a happens-before relationship that
-    // can be assumed by callers.
-    promise->discard();
+    std::list<Future<T>> _futures;
+    std::unique_ptr<Promise<R>> _promise = take(&_futures);
+    if (_promise) {
+      foreach (Future<T> future, _futures) {
+        future.discard();
+      }
 
-    terminate(this);
+      // NOTE: we discard the promise after we set discard on each of
+      // the futures so that there is a happens-before relationship
+      // that can be assumed by callers.
+      _promise->discard();
+    }
   }
 
-  void waited(const Future<T>& future)
+  void abandoned()
   {
-    if (future.isFailed()) {
-      promise->fail("Collect failed: " + future.failure());
-      terminate(this);
-    } else if (future.isDiscarded()) {
-      promise->fail("Collect failed: future discarded");
-      terminate(this);
-    } else {
-      CHECK_READY(future);
-      ready += 1;
-      if (ready == futures.size()) {
-        std::list<T> values;
-        foreach (const Future<T>& future, futures) {
-          values.push_back(future.get());
-        }
-        promise->set(values);
-        terminate(this);
-      }
-    }
+    // There is no use waiting because this future will never
+    // complete, so delete the promise which causes our future to also
+    // be abandoned.
+    std::list<Future<T>> _futures;
+    take(&_futures);
   }
 
-  const std::list<Future<T>> futures;
-  Promise<std::list<T>>* promise;
-  size_t ready;
+private:
+  std::mutex mutex;
+  std::list<Future<T>> futures;
+  std::unique_ptr<Promise<R>> promise;
+  std::atomic<size_t> pending;
 };
 
 
 template <typename T>
-class AwaitProcess : public Process<AwaitProcess<T>>
+void collected(
+    const std::shared_ptr<Waiter<T, std::list<T>>>& waiter,
+    const Future<T>& future)
 {
-public:
-  AwaitProcess(
-      const std::list<Future<T>>& _futures,
-      Promise<std::list<Future<T>>>* _promise)
-    : ProcessBase(ID::generate("__await__")),
-      futures(_futures),
-      promise(_promise),
-      ready(0) {}
-
-  virtual ~AwaitProcess()
-  {
-    delete promise;
-  }
-
-  virtual void initialize()
-  {
-    // Stop this nonsense if nobody cares.
-    promise->future().onDiscard(defer(this, &AwaitProcess::discarded));
-
-    foreach (const Future<T>& future, futures) {
-      future.onAny(defer(this, &AwaitProcess::waited, lambda::_1));
-      future.onAbandoned(defer(this, &AwaitProcess::abandoned));
+  std::list<Future<T>> futures;
+
+  if (future.isFailed() || future.isDiscarded()) {
+    std::unique_ptr<Promise<std::list<T>>> promise = waiter->take(&futures);
+    if (promise) {
+      promise->fail(
+          "Collect failed: " +
+          (future.isFailed() ? future.failure() : "future discarded"));
+    }
+  } else if (waiter->completed()) {
+    CHECK_READY(future);
+
+    std::unique_ptr<Promise<std::list<T>>> promise = waiter->take(&futures);
+    if (promise) {
+      std::list<T> values;
+      foreach (const Future<T>& future, futures) {
+        values.push_back(future.get());
+      }
+      promise->set(std::move(values));
     }
   }
+}
 
-private:
-  void abandoned()
-  {
-    // There is no use waiting because this future will never complete
-    // so terminate this process which will cause `promise` to get
-    // deleted and our future to also be abandoned.
-    terminate(this);
-  }
 
-  void discarded()
-  {
-    foreach (Future<T> future, futures) {
-      future.discard();
+template <typename T>
+void awaited(
+    const std::shared_ptr<Waiter<T, std::list<Future<T>>>>& waiter,
+    const Future<T>&)
+{
+  if (waiter->completed()) {
+    std::list<Future<T>> futures;
+    std::unique_ptr<Promise<std::list<Future<T>>>> promise =
+      waiter->take(&futures);
+
+    if (promise) {
+      promise->set(std::move(futures));
     }
+  }
+}
 
-    // NOTE: we discard the promise after we set discard on each of
-    // the futures so that there is a happens-before relationship that
-    // can be assumed by callers.
-    promise->discard();
 
-    terminate(this);
-  }
+// Registers the callbacks of a waiter on the futures and on the
+// future of its promise.
+template <typename T, typename R, typename F>
+Future<R> wait(
+    const std::list<Future<T>>& futures,
+    const std::shared_ptr<Waiter<T, R>>& waiter,
+    F callback)
+{
+  Future<R> result = waiter->future();
 
-  void waited(const Future<T>& future)
-  {
-    CHECK(!future.isPending());
+  // Stop this nonsense if nobody cares.
+  result.onDiscard([waiter]() { waiter->discarded(); });
 
-    ready += 1;
-    if (ready == futures.size()) {
-      promise->set(futures);
-      terminate(this);
-    }
+  foreach (const Future<T>& future, futures) {
+    future.onAny([waiter, callback](const Future<T>& future) {
+      callback(waiter, future);
+    });
+    future.onAbandoned([waiter]() { waiter->abandoned(); });
   }
 
-  const std::list<Future<T>> futures;
-  Promise<std::list<Future<T>>>* promise;
-  size_t ready;
-};
-
+  return result;
+}
 
 } // namespace internal {
 
@@ -274,10 +270,10 @@ inline Future<std::list<T>> collect(
     return std::list<T>();
   }
 
-  Promise<std::list<T>>* promise = new Promise<std::list<T>>();
-  Future<std::list<T>> future = promise->future();
-  spawn(new internal::CollectProcess<T>(futures, promise), true);
-  return future;
+  std::shared_ptr<internal::Waiter<T, std::list<T>>> waiter(
+      new internal::Waiter<T, std::list<T>>(futures));
+
+  return internal::wait(futures, waiter, &internal::collected<T>);
 }
 
 
@@ -309,11 +305,10 @@ inline Future<std::list<Future<T>>> await(
     return futures;
   }
 
-  Promise<std::list<Future<T>>>* promise =
-    new Promise<std::list<Future<T>>>();
-  Future<std::list<Future<T>>> future = promise->future();
-  spawn(new internal::AwaitProcess<T>(futures, promise), true);
-  return future;
+  std::shared_ptr<internal::Waiter<T, std::list<Future<T>>>> waiter(
+      new internal::Waiter<T, std::list<Future<T>>>(futures));
+
+  return internal::wait(futures, waiter, &internal::awaited<T>);
 }
 
 
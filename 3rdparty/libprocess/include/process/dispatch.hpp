@@ -63,7 +63,7 @@ namespace internal {
 // argument.
 void dispatch(
     const UPID& pid,
-    std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f,
+    lambda::CallableOnce<void(ProcessBase*)> f,
     const Option<const std::type_info*>& functionType = None());
 
 
@@ -83,14 +83,13 @@ struct Dispatch<void>
   template <typename F>
   void operator()(const UPID& pid, F&& f)
   {
-    std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f_(
-        new lambda::CallableOnce<void(ProcessBase*)>(
-            lambda::partial(
-                [](typename std::decay<F>::type&& f, ProcessBase*) {
-                  std::move(f)();
-                },
-                std::forward<F>(f),
-                lambda::_1)));
+    lambda::CallableOnce<void(ProcessBase*)> f_(
+        lambda::partial(
+            [](typename std::decay<F>::type&& f, ProcessBase*) {
+              std::move(f)();
+            },
+            std::forward<F>(f),
+            lambda::_1));
 
     internal::dispatch(pid, std::move(f_));
   }
@@ -110,17 +109,16 @@ struct Dispatch<Future<R>>
     std::unique_ptr<Promise<R>> promise(new Promise<R>());
     Future<R> future = promise->future();
 
-    std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f_(
-        new lambda::CallableOnce<void(ProcessBase*)>(
-            lambda::partial(
-                [](std::unique_ptr<Promise<R>> promise,
-                   typename std::decay<F>::type&& f,
-                   ProcessBase*) {
-                  promise->associate(std::move(f)());
-                },
-                std::move(promise),
-                std::forward<F>(f),
-                lambda::_1)));
+    lambda::CallableOnce<void(ProcessBase*)> f_(
+        lambda::partial(
+            [](std::unique_ptr<Promise<R>> promise,
+               typename std::decay<F>::type&& f,
+               ProcessBase*) {
+              promise->associate(std::move(f)());
+            },
+            std::move(promise),
+            std::forward<F>(f),
+            lambda::_1));
 
     internal::dispatch(pid, std::move(f_));
 
@@ -141,17 +139,16 @@ struct Dispatch
     std::unique_ptr<Promise<R>> promise(new Promise<R>());
     Future<R> future = promise->future();
 
-    std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f_(
-        new lambda::CallableOnce<void(ProcessBase*)>(
-            lambda::partial(
-                [](std::unique_ptr<Promise<R>> promise,
-                   typename std::decay<F>::type&& f,
-                   ProcessBase*) {
-                  promise->set(std::move(f)());
-                },
-                std::move(promise),
-                std::forward<F>(f),
-                lambda::_1)));
+    lambda::CallableOnce<void(ProcessBase*)> f_(
+        lambda::partial(
+            [](std::unique_ptr<Promise<R>> promise,
+               typename std::decay<F>::type&& f,
+               ProcessBase*) {
+              promise->set(std::move(f)());
+            },
+            std::move(promise),
+            std::forward<F>(f),
+            lambda::_1));
 
     internal::dispatch(pid, std::move(f_));
 
@@ -173,14 +170,13 @@ struct Dispatch
 template <typename T>
 void dispatch(const PID<T>& pid, void (T::*method)())
 {
-  std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f(
-      new lambda::CallableOnce<void(ProcessBase*)>(
-          [=](ProcessBase* process) {
-            assert(process != nullptr);
-            T* t = dynamic_cast<T*>(process);
-            assert(t != nullptr);
-            (t->*method)();
-          }));
+  lambda::CallableOnce<void(ProcessBase*)> f(
+      [=](ProcessBase* process) {
+        assert(process != nullptr);
+        T* t = dynamic_cast<T*>(process);
+        assert(t != nullptr);
+        (t->*method)();
+      });
 
   internal::dispatch(pid, std::move(f), &typeid(method));
 }
@@ -215,17 +211,16 @@ void dispatch(const Process<T>* process, void (T::*method)())
       void (T::*method)(ENUM_PARAMS(N, P)),                             \
       ENUM_BINARY_PARAMS(N, A, &&a))                                    \
   {                                                                     \
-    std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f(        \
-        new lambda::CallableOnce<void(ProcessBase*)>(                   \
-            lambda::partial(                                            \
-                [method](ENUM(N, DECL, _), ProcessBase* process) {      \
-                  assert(process != nullptr);                           \
-                  T* t = dynamic_cast<T*>(process);                     \
-                  assert(t != nullptr);                                 \
-                  (t->*method)(ENUM(N, MOVE, _));                       \
-                },                                                      \
-                ENUM(N, FORWARD, _),                                    \
-                lambda::_1)));                                          \
+    lambda::CallableOnce<void(ProcessBase*)> f(                         \
+        lambda::partial(                                                \
+            [method](ENUM(N, DECL, _), ProcessBase* process) {          \
+              assert(process != nullptr);                               \
+              T* t = dynamic_cast<T*>(process);                         \
+              assert(t != nullptr);                                     \
+              (t->*method)(ENUM(N, MOVE, _));                           \
+            },                                                          \
+            ENUM(N, FORWARD, _),                                        \
+            lambda::_1));                                               \
                                                                         \
     internal::dispatch(pid, std::move(f), &typeid(method));             \
   }                                                                     \
@@ -264,17 +259,16 @@ Future<R> dispatch(const PID<T>& pid, Future<R> (T::*method)())
   std::unique_ptr<Promise<R>> promise(new Promise<R>());
   Future<R> future = promise->future();
 
-  std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f(
-      new lambda::CallableOnce<void(ProcessBase*)>(
-          lambda::partial(
-              [=](std::unique_ptr<Promise<R>> promise, ProcessBase* process) {
-                assert(process != nullptr);
-                T* t = dynamic_cast<T*>(process);
-                assert(t != nullptr);
-                promise->associate((t->*method)());
-              },
-              std::move(promise),
-              lambda::_1)));
+  lambda::CallableOnce<void(ProcessBase*)> f(
+      lambda::partial(
+          [=](std::unique_ptr<Promise<R>> promise, ProcessBase* process) {
+            assert(process != nullptr);
+            T* t = dynamic_cast<T*>(process);
+            assert(t != nullptr);
+            promise->associate((t->*method)());
+          },
+          std::move(promise),
+          lambda::_1));
 
   internal::dispatch(pid, std::move(f), &typeid(method));
 
@@ -306,21 +300,20 @@ Future<R> dispatch(const Process<T>* process, Future<R> (T::*method)())
     std::unique_ptr<Promise<R>> promise(new Promise<R>());              \
     Future<R> future = promise->future();                               \
                                                                         \
-    std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f(        \
-        new lambda::CallableOnce<void(ProcessBase*)>(                   \
-            lambda::partial(                                            \
-                [method](std::unique_ptr<Promise<R>> promise,           \
-                         ENUM(N, DECL, _),                              \
-                         ProcessBase* process) {                        \
-                  assert(process != nullptr);                           \
-                  T* t = dynamic_cast<T*>(process);                     \
-                  assert(t != nullptr);                                 \
-                  promise->associate(                                   \
-                      (t->*method)(ENUM(N, MOVE, _)));                  \
-                },                                                      \
-                std::move(promise),                                     \
-                ENUM(N, FORWARD, _),                                    \
-                lambda::_1)));                                          \
+    lambda::CallableOnce<void(ProcessBase*)> f(                         \
+        lambda::partial(                                                \
+            [method](std::unique_ptr<Promise<R>> promise,               \
+                     ENUM(N, DECL, _),                                  \
+                     ProcessBase* process) {                            \
+              assert(process != nullptr);                               \
+              T* t = dynamic_cast<T*>(process);                         \
+              assert(t != nullptr);                                     \
+              promise->associate(                                       \
+                  (t->*method)(ENUM(N, MOVE, _)));                      \
+            },                                                          \
+            std::move(promise),                                         \
+            ENUM(N, FORWARD, _),                                        \
+            lambda::_1));                                               \
                                                                         \
     internal::dispatch(pid, std::move(f), &typeid(method));             \
                                                                         \
@@ -363,17 +356,16 @@ Future<R> dispatch(const PID<T>& pid, R (T::*method)())
   std::unique_ptr<Promise<R>> promise(new Promise<R>());
   Future<R> future = promise->future();
 
-  std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f(
-      new lambda::CallableOnce<void(ProcessBase*)>(
-          lambda::partial(
-              [=](std::unique_ptr<Promise<R>> promise, ProcessBase* process) {
-                assert(process != nullptr);
-                T* t = dynamic_cast<T*>(process);
-                assert(t != nullptr);
-                promise->set((t->*method)());
-              },
-              std::move(promise),
-              lambda::_1)));
+  lambda::CallableOnce<void(ProcessBase*)> f(
+      lambda::partial(
+          [=](std::unique_ptr<Promise<R>> promise, ProcessBase* process) {
+            assert(process != nullptr);
+            T* t = dynamic_cast<T*>(process);
+            assert(t != nullptr);
+            promise->set((t->*method)());
+          },
+          std::move(promise),
+          lambda::_1));
 
   internal::dispatch(pid, std::move(f), &typeid(method));
 
@@ -405,20 +397,19 @@ Future<R> dispatch(const Process<T>* process, R (T::*method)())
     std::unique_ptr<Promise<R>> promise(new Promise<R>());              \
     Future<R> future = promise->future();                               \
                                                                         \
-    std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f(        \
-        new lambda::CallableOnce<void(ProcessBase*)>(                   \
-            lambda::partial(                                            \
-                [method](std::unique_ptr<Promise<R>> promise,           \
-                         ENUM(N, DECL, _),                              \
-                         ProcessBase* process) {                        \
-                  assert(process != nullptr);                           \
-                  T* t = dynamic_cast<T*>(process);                     \
-                  assert(t != nullptr);                                 \
-                  promise->set((t->*method)(ENUM(N, MOVE, _)));         \
-                },                                                      \
-                std::move(promise),                                     \
-                ENUM(N, FORWARD, _),                                    \
-                lambda::_1)));                                          \
+    lambda::CallableOnce<void(ProcessBase*)> f(                         \
+        lambda::partial(                                                \
+            [method](std::unique_ptr<Promise<R>> promise,               \
+                     ENUM(N, DECL, _),                                  \
+                     ProcessBase* process) {                            \
+              assert(process != nullptr);                               \
+              T* t = dynamic_cast<T*>(process);                         \
+              assert(t != nullptr);                                     \
+              promise->set((t->*method)(ENUM(N, MOVE, _)));             \
+            },                                                          \
+            std::move(promise),                                         \
+            ENUM(N, FORWARD, _),                                        \
+            lambda::_1));                                               \
                                                                         \
     internal::dispatch(pid, std::move(f), &typeid(method));             \
                                                                         \
@@ -13,6 +13,7 @@
 #ifndef __PROCESS_EVENT_HPP__
 #define __PROCESS_EVENT_HPP__
 
+#include <chrono>
 #include <memory> // TODO(benh): Replace shared_ptr with unique_ptr.
 
 #include <process/future.hpp>
@@ -97,6 +98,14 @@ struct Event
 
   // JSON representation for an Event.
   operator JSON::Object() const;
+
+  // When the event was enqueued, used to account for how long the
+  // event waited before it got served.
+  std::chrono::steady_clock::time_point enqueued;
+
+  // The ID of the trace the event belongs to, if tracing is enabled
+  // (see 'LIBPROCESS_TRACE_CAPACITY').
+  uint64_t trace = 0;
 };
 
 
@@ -179,7 +188,7 @@ struct DispatchEvent : Event
 {
   DispatchEvent(
       const UPID& _pid,
-      std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> _f,
+      lambda::CallableOnce<void(ProcessBase*)> _f,
       const Option<const std::type_info*>& _functionType)
     : pid(_pid),
       f(std::move(_f)),
@@ -205,7 +214,10 @@ struct DispatchEvent : Event
   UPID pid;
 
   // Function to get invoked as a result of this dispatch event.
-  std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f;
+  //
+  // NOTE: `CallableOnce` already owns its target through a pointer so
+  // we store it by value to avoid another allocation per dispatch.
+  lambda::CallableOnce<void(ProcessBase*)> f;
 
   Option<const std::type_info*> functionType;
 };
@@ -96,6 +96,8 @@ public:
 
   /*implicit*/ Future(const T& _t);
 
+  /*implicit*/ Future(T&& _t);
+
   template <typename U>
   /*implicit*/ Future(const U& u);
 
@@ -109,6 +111,8 @@ public:
 
   /*implicit*/ Future(const Try<T>& t);
 
+  /*implicit*/ Future(Try<T>&& t);
+
   /*implicit*/ Future(const Try<Future<T>>& t);
 
   ~Future() = default;
@@ -971,7 +975,7 @@ void select(
 template <typename T>
 Future<Future<T>> select(const std::set<Future<T>>& futures)
 {
-  std::shared_ptr<Promise<Future<T>>> promise(new Promise<Future<T>>());
+  auto promise = std::make_shared<Promise<Future<T>>>();
 
   promise->future().onDiscard(
       lambda::bind(&internal::discarded<Future<T>>, promise->future()));
@@ -1067,7 +1071,7 @@ void Future<T>::Data::clearAllCallbacks()
 
 template <typename T>
 Future<T>::Future()
-  : data(new Data())
+  : data(std::make_shared<Data>())
 {
   data->abandoned = true;
 }
@@ -1075,16 +1079,24 @@ Future<T>::Future()
 
 template <typename T>
 Future<T>::Future(const T& _t)
-  : data(new Data())
+  : data(std::make_shared<Data>())
 {
   set(_t);
 }
 
 
+template <typename T>
+Future<T>::Future(T&& _t)
+  : data(std::make_shared<Data>())
+{
+  set(std::move(_t));
+}
+
+
 template <typename T>
 template <typename U>
 Future<T>::Future(const U& u)
-  : data(new Data())
+  : data(std::make_shared<Data>())
 {
   set(u);
 }
@@ -1092,7 +1104,7 @@ Future<T>::Future(const U& u)
 
 template <typename T>
 Future<T>::Future(const Failure& failure)
-  : data(new Data())
+  : data(std::make_shared<Data>())
 {
   fail(failure.message);
 }
@@ -1100,7 +1112,7 @@ Future<T>::Future(const Failure& failure)
 
 template <typename T>
 Future<T>::Future(const ErrnoFailure& failure)
-  : data(new Data())
+  : data(std::make_shared<Data>())
 {
   fail(failure.message);
 }
@@ -1118,7 +1130,7 @@ Future<T>::Future(Future<T>&& that)
 
 template <typename T>
 Future<T>::Future(const Try<T>& t)
-  : data(new Data())
+  : data(std::make_shared<Data>())
 {
   if (t.isSome()){
     set(t.get());
@@ -1128,6 +1140,18 @@ Future<T>::Future(const Try<T>& t)
 }
 
 
+template <typename T>
+Future<T>::Future(Try<T>&& t)
+  : data(std::make_shared<Data>())
+{
+  if (t.isSome()){
+    set(std::move(t).get());
+  } else {
+    fail(t.error());
+  }
+}
+
+
 template <typename T>
 Future<T>::Future(const Try<Future<T>>& t)
   : data(t.isSome() ? t->data : std::shared_ptr<Data>(new Data()))
@@ -1639,7 +1663,7 @@ template <typename T>
 template <typename F>
 Future<T> Future<T>::recover(F&& f) const
 {
-  std::shared_ptr<Promise<T>> promise(new Promise<T>());
+  auto promise = std::make_shared<Promise<T>>();
 
   const Future<T> future = *this;
 
@@ -1712,8 +1736,8 @@ Future<T> Future<T>::after(
   // TODO(benh): Using a Latch here but Once might be cleaner.
   // Unfortunately, Once depends on Future so we can't easily use it
   // from here.
-  std::shared_ptr<Latch> latch(new Latch());
-  std::shared_ptr<Promise<T>> promise(new Promise<T>());
+  auto latch = std::make_shared<Latch>();
+  auto promise = std::make_shared<Promise<T>>();
 
   // We need to control the lifetime of the timer we create below so
   // that we can force the timer to get deallocated after it
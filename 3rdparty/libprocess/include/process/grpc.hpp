@@ -18,6 +18,7 @@
 #include <memory>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 #include <google/protobuf/message.h>
 
@@ -90,13 +91,13 @@ namespace client {
 
 /**
  * A copyable interface to manage an internal gRPC runtime instance for
- * asynchronous gRPC calls. A gRPC runtime instance includes a gRPC
- * `CompletionQueue` to manage outstanding requests, a looper thread to
- * wait for any incoming responses from the `CompletionQueue`, and a
- * process to handle the responses. All `Runtime` copies share the same
- * gRPC runtime instance. Usually we only need a single gRPC runtime
- * instance to handle all gRPC calls, but multiple instances can be
- * instantiated for more parallelism or isolation.
+ * asynchronous gRPC calls. A gRPC runtime instance includes a pool of
+ * gRPC `CompletionQueue`s to manage outstanding requests, a looper
+ * thread per `CompletionQueue` to wait for any incoming responses, and
+ * a process to handle the responses. All `Runtime` copies share the
+ * same gRPC runtime instance. Usually we only need a single gRPC
+ * runtime instance to handle all gRPC calls, but multiple instances
+ * can be instantiated for isolation.
  * NOTE: The destruction of the internal gRPC runtime instance is a
  * blocking operation: it waits for the managed process to terminate.
  * The user should ensure that this only happens at shutdown.
@@ -104,7 +105,12 @@ namespace client {
 class Runtime
 {
 public:
-  Runtime() : data(new Data()) {}
+  /**
+   * @param workers The number of `CompletionQueue`s, each polled by its
+   *     own looper thread, over which the gRPC calls are spread in a
+   *     round-robin fashion. More workers allow for a higher call rate.
+   */
+  explicit Runtime(size_t workers = 1) : data(new Data(workers)) {}
 
   /**
    * Sends an asynchronous gRPC call.
@@ -153,7 +159,7 @@ public:
       std::shared_ptr<::grpc::Status> status(new ::grpc::Status());
 
       std::shared_ptr<::grpc::ClientAsyncResponseReader<Response>> reader(
-          (Stub(channel.channel).*rpc)(context.get(), request, &data->queue));
+          (Stub(channel.channel).*rpc)(context.get(), request, data->queue()));
 
       reader->Finish(
           response.get(),
@@ -179,30 +185,41 @@ public:
 
   /**
    * Asks the internal gRPC runtime instance to shut down the
-   * `CompletionQueue`, which would stop its looper thread, drain and
-   * fail all pending gRPC calls in the `CompletionQueue`, then
-   * asynchronously join the looper thread.
+   * `CompletionQueue`s, which would stop their looper threads, drain
+   * and fail all pending gRPC calls in the `CompletionQueue`s, then
+   * asynchronously join the looper threads.
    */
   void terminate();
 
   /**
    * @return A `Future` waiting for all pending gRPC calls in the
-   *     `CompletionQueue` of the internal gRPC runtime instance to be
-   *     drained and the looper thread to be joined.
+   *     `CompletionQueue`s of the internal gRPC runtime instance to be
+   *     drained and the looper threads to be joined.
    */
   Future<Nothing> wait();
 
 private:
   struct Data
   {
-    Data();
+    explicit Data(size_t workers);
     ~Data();
 
-    void loop();
+    // Returns the `CompletionQueue` for the next call.
+    //
+    // NOTE: The `lock` must be held.
+    ::grpc::CompletionQueue* queue();
+
+    void loop(size_t index);
     void terminate();
 
-    std::unique_ptr<std::thread> looper;
-    ::grpc::CompletionQueue queue;
+    std::vector<std::unique_ptr<::grpc::CompletionQueue>> queues;
+    std::vector<std::unique_ptr<std::thread>> loopers;
+    size_t next = 0;
+
+    // The number of looper threads not joined yet. Only accessed
+    // within `process`.
+    size_t running;
+
     ProcessBase process;
     std::atomic_flag lock = ATOMIC_FLAG_INIT;
     bool terminating = false;
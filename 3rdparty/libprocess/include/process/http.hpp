@@ -32,6 +32,7 @@
 #include <process/pid.hpp>
 #include <process/socket.hpp>
 
+#include <stout/duration.hpp>
 #include <stout/error.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/ip.hpp>
@@ -1184,6 +1185,74 @@ Future<Response> request(
     bool streamedResponse = false);
 
 
+// Forward declaration.
+class ConnectionPoolProcess;
+
+
+/**
+ * A pool of keep-alive connections shared by the requests sent
+ * through it. Connections are kept per origin (scheme, host and
+ * port) and reused for subsequent requests to the same origin rather
+ * than establishing (and tearing down) a new connection per request
+ * as `http::request` does.
+ *
+ * The pool exposes the following metrics, where `<name>` is the name
+ * given to the pool on construction:
+ *   `http/connection_pools/<name>/hits`: reused connections.
+ *   `http/connection_pools/<name>/misses`: newly established connections.
+ */
+class ConnectionPool
+{
+public:
+  // NOTE: see the note in `Server` as to why we have `DEFAULT_OPTIONS`.
+  struct Options
+  {
+    // How long a connection may stay idle in the pool before it
+    // gets closed.
+    Duration idle_timeout;
+
+    // The maximum number of connections (idle or in use) to a single
+    // origin. Requests sent while this many connections are in use
+    // are queued until one of them becomes available.
+    size_t max_connections_per_origin;
+  };
+
+  static Options DEFAULT_OPTIONS()
+  {
+    return {
+      /* .idle_timeout = */ Seconds(30),
+      /* .max_connections_per_origin = */ 8,
+    };
+  };
+
+  explicit ConnectionPool(
+      const std::string& name,
+      const Options& options = DEFAULT_OPTIONS());
+
+  // Movable but not copyable, not assignable.
+  ConnectionPool(ConnectionPool&& that) = default;
+  ConnectionPool(const ConnectionPool&) = delete;
+  ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+  ~ConnectionPool();
+
+  /**
+   * Sends the request over a pooled connection to the origin of
+   * `request.url` and returns the HTTP response of type 'BODY' once
+   * the entire response is received. The request is always sent as a
+   * keep-alive request, and the connection is returned to the pool
+   * afterwards unless the server asked for it to be closed.
+   *
+   * NOTE: streamed responses are not supported since the connection
+   * can only be reused once the response body has been read.
+   */
+  Future<Response> request(const Request& request);
+
+private:
+  std::unique_ptr<ConnectionPoolProcess> process;
+};
+
+
 // TODO(Yongqiao Wang): Refactor other functions
 // (such as post/get/requestDelete) to use the 'request' function.
 
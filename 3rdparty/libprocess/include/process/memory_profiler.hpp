@@ -0,0 +1,95 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#ifndef __PROCESS_MEMORY_PROFILER_HPP__
+#define __PROCESS_MEMORY_PROFILER_HPP__
+
+#include <string>
+
+#include <process/future.hpp>
+#include <process/http.hpp>
+#include <process/process.hpp>
+
+#include <stout/option.hpp>
+
+namespace process {
+
+// Exposes the heap profiling facilities of tcmalloc, which libprocess
+// is linked against when configured with `--enable-perftools`:
+//
+//   /memory-profiler/start          Starts the heap profiler.
+//   /memory-profiler/stop           Stops the heap profiler and returns
+//                                   the heap profile.
+//   /memory-profiler/download/heap  Returns the current heap profile
+//                                   of the running heap profiler.
+//   /memory-profiler/heap_sample    Returns a sample of the live heap
+//                                   allocations and their call sites.
+//   /memory-profiler/statistics     Returns the tcmalloc statistics.
+//
+// The profiles are in the format understood by `pprof`.
+class MemoryProfiler : public Process<MemoryProfiler>
+{
+public:
+  MemoryProfiler(const Option<std::string>& _authenticationRealm)
+    : ProcessBase("memory-profiler"),
+      authenticationRealm(_authenticationRealm) {}
+
+  virtual ~MemoryProfiler() {}
+
+protected:
+  virtual void initialize();
+
+private:
+  static const std::string START_HELP();
+  static const std::string STOP_HELP();
+  static const std::string DOWNLOAD_HEAP_HELP();
+  static const std::string HEAP_SAMPLE_HELP();
+  static const std::string STATISTICS_HELP();
+
+  // HTTP endpoints.
+
+  // Starts the heap profiler. There are no request parameters.
+  Future<http::Response> start(
+      const http::Request& request,
+      const Option<http::authentication::Principal>&);
+
+  // Stops the heap profiler and returns the last heap profile.
+  // There are no request parameters.
+  Future<http::Response> stop(
+      const http::Request& request,
+      const Option<http::authentication::Principal>&);
+
+  // Returns the current heap profile. There are no request parameters.
+  Future<http::Response> downloadHeap(
+      const http::Request& request,
+      const Option<http::authentication::Principal>&);
+
+  // Returns a sample of the live heap allocations, which does not
+  // need the heap profiler to be running. There are no request
+  // parameters.
+  Future<http::Response> heapSample(
+      const http::Request& request,
+      const Option<http::authentication::Principal>&);
+
+  // Returns the allocator statistics. There are no request parameters.
+  Future<http::Response> statistics(
+      const http::Request& request,
+      const Option<http::authentication::Principal>&);
+
+  // The authentication realm that the memory profiler's HTTP endpoints
+  // will be installed into.
+  Option<std::string> authenticationRealm;
+};
+
+} // namespace process {
+
+#endif // __PROCESS_MEMORY_PROFILER_HPP__
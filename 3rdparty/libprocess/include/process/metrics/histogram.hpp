@@ -0,0 +1,251 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#ifndef __PROCESS_METRICS_HISTOGRAM_HPP__
+#define __PROCESS_METRICS_HISTOGRAM_HPP__
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <process/future.hpp>
+#include <process/statistics.hpp>
+
+#include <process/metrics/metric.hpp>
+
+#include <stout/none.hpp>
+#include <stout/option.hpp>
+
+namespace process {
+namespace metrics {
+
+// A Metric that represents the distribution of the values recorded
+// into it, e.g., latencies or sizes.
+//
+// Unlike the statistics of a Metric with a window, which are computed
+// from a `TimeSeries` of all the values in the window, the values are
+// counted in a fixed number of buckets with logarithmically growing
+// widths (similar to an HDR histogram). Recording a value neither
+// allocates nor locks, it only increments an atomic counter, and the
+// memory used is fixed. The price is that percentiles are only
+// accurate to within half the width of a bucket, i.e., about 3% of the
+// value, and that they cover all the values recorded since the
+// histogram was created rather than a window.
+//
+// The value of the metric is the number of values recorded, its
+// statistics hold the percentiles.
+class Histogram : public Metric
+{
+public:
+  // 'name' is the unique name for the instance of Histogram being
+  // constructed. This is what will be used as the key in the JSON
+  // endpoint.
+  explicit Histogram(const std::string& name)
+    : Metric(name, None()),
+      data(new Data()) {}
+
+  virtual ~Histogram() {}
+
+  virtual Future<double> value() const
+  {
+    return static_cast<double>(data->count.load(std::memory_order_relaxed));
+  }
+
+  virtual Option<Statistics<double>> statistics() const
+  {
+    // Take a copy of the buckets first, so that the percentiles are
+    // computed from a consistent set of counts.
+    uint64_t counts[BUCKETS];
+    uint64_t count = 0;
+
+    for (size_t i = 0; i < BUCKETS; i++) {
+      counts[i] = data->buckets[i].load(std::memory_order_relaxed);
+      count += counts[i];
+    }
+
+    // Like for a `TimeSeries`, we need at least 2 values to compute
+    // aggregates.
+    if (count < 2) {
+      return None();
+    }
+
+    const double min = data->min.load(std::memory_order_relaxed);
+    const double max = data->max.load(std::memory_order_relaxed);
+
+    Statistics<double> statistics;
+
+    statistics.count = count;
+    statistics.min = min;
+    statistics.max = max;
+
+    // Returns the midpoint of the bucket holding the value at the
+    // requested percentile, clamped to the recorded minimum and maximum.
+    auto percentile = [&](double percentile) {
+      const uint64_t rank =
+        static_cast<uint64_t>(std::floor(percentile * (count - 1)));
+
+      uint64_t seen = 0;
+
+      for (size_t i = 0; i < BUCKETS; i++) {
+        seen += counts[i];
+
+        if (seen > rank) {
+          const double midpoint = (lowerBound(i) + lowerBound(i + 1)) / 2;
+          return std::min(std::max(midpoint, min), max);
+        }
+      }
+
+      return max;
+    };
+
+    statistics.p50 = percentile(0.5);
+    statistics.p90 = percentile(0.90);
+    statistics.p95 = percentile(0.95);
+    statistics.p99 = percentile(0.99);
+    statistics.p999 = percentile(0.999);
+    statistics.p9999 = percentile(0.9999);
+
+    return statistics;
+  }
+
+  void record(double value)
+  {
+    data->buckets[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    data->count.fetch_add(1, std::memory_order_relaxed);
+
+    update(&data->min, value, [](double a, double b) { return a < b; });
+    update(&data->max, value, [](double a, double b) { return a > b; });
+  }
+
+  // Adds the values recorded into 'that' histogram to this one, e.g.,
+  // to aggregate histograms recorded separately.
+  void merge(const Histogram& that)
+  {
+    if (that.data == data) {
+      return;
+    }
+
+    for (size_t i = 0; i < BUCKETS; i++) {
+      const uint64_t count =
+        that.data->buckets[i].load(std::memory_order_relaxed);
+
+      if (count > 0) {
+        data->buckets[i].fetch_add(count, std::memory_order_relaxed);
+        data->count.fetch_add(count, std::memory_order_relaxed);
+      }
+    }
+
+    update(
+        &data->min,
+        that.data->min.load(std::memory_order_relaxed),
+        [](double a, double b) { return a < b; });
+
+    update(
+        &data->max,
+        that.data->max.load(std::memory_order_relaxed),
+        [](double a, double b) { return a > b; });
+  }
+
+private:
+  // Each power of two between 2^(MIN_EXPONENT - 1) and 2^MAX_EXPONENT
+  // is split into SUB_BUCKETS buckets of equal width. All smaller
+  // values (including zero and negative values) are counted in the
+  // first bucket, and all larger values in the last one.
+  static constexpr int MIN_EXPONENT = -20;
+  static constexpr int MAX_EXPONENT = 44;
+  static constexpr size_t SUB_BUCKETS = 16;
+  static constexpr size_t BUCKETS =
+    (MAX_EXPONENT - MIN_EXPONENT + 1) * SUB_BUCKETS + 2;
+
+  static size_t bucket(double value)
+  {
+    if (!(value >= std::ldexp(0.5, MIN_EXPONENT))) {
+      return 0; // Also catches NaN.
+    }
+
+    int exponent;
+    const double mantissa = std::frexp(value, &exponent);
+
+    if (exponent > MAX_EXPONENT) {
+      return BUCKETS - 1;
+    }
+
+    // The mantissa is in [0.5, 1).
+    const size_t sub = std::min(
+        static_cast<size_t>((mantissa - 0.5) * 2 * SUB_BUCKETS),
+        SUB_BUCKETS - 1);
+
+    return 1 + (exponent - MIN_EXPONENT) * SUB_BUCKETS + sub;
+  }
+
+  // Returns the smallest value counted in the bucket, where the bucket
+  // past the last one bounds the last bucket.
+  static double lowerBound(size_t bucket)
+  {
+    if (bucket == 0) {
+      return 0.0;
+    }
+
+    if (bucket >= BUCKETS - 1) {
+      return std::ldexp(1.0, MAX_EXPONENT);
+    }
+
+    const size_t octave = (bucket - 1) / SUB_BUCKETS;
+    const size_t sub = (bucket - 1) % SUB_BUCKETS;
+
+    return std::ldexp(
+        0.5 + static_cast<double>(sub) / (2 * SUB_BUCKETS),
+        MIN_EXPONENT + static_cast<int>(octave));
+  }
+
+  // Replaces the value of 'target' with 'value' for as long as
+  // 'better' says it should, without locking.
+  template <typename F>
+  static void update(std::atomic<double>* target, double value, F better)
+  {
+    double current = target->load(std::memory_order_relaxed);
+
+    while (better(value, current) &&
+           !target->compare_exchange_weak(
+               current, value, std::memory_order_relaxed)) {}
+  }
+
+  struct Data
+  {
+    Data()
+      : count(0),
+        min(std::numeric_limits<double>::infinity()),
+        max(-std::numeric_limits<double>::infinity())
+    {
+      for (size_t i = 0; i < BUCKETS; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    std::atomic<uint64_t> buckets[BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<double> min;
+    std::atomic<double> max;
+  };
+
+  std::shared_ptr<Data> data;
+};
+
+} // namespace metrics {
+} // namespace process {
+
+#endif // __PROCESS_METRICS_HISTOGRAM_HPP__
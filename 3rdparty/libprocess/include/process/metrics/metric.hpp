@@ -41,7 +41,10 @@ public:
     return data->name;
   }
 
-  Option<Statistics<double>> statistics() const
+  // Returns the statistics of the history of this metric, if any.
+  // Metrics that keep track of the distribution of their values in
+  // some other way can override this.
+  virtual Option<Statistics<double>> statistics() const
   {
     Option<Statistics<double>> statistics = None();
 
@@ -0,0 +1,156 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#ifndef __PROCESS_METRICS_SAMPLED_GAUGE_HPP__
+#define __PROCESS_METRICS_SAMPLED_GAUGE_HPP__
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <process/clock.hpp>
+#include <process/future.hpp>
+#include <process/process.hpp>
+#include <process/time.hpp>
+#include <process/timer.hpp>
+
+#include <process/metrics/metric.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/option.hpp>
+#include <stout/stringify.hpp>
+#include <stout/synchronized.hpp>
+
+namespace process {
+namespace metrics {
+
+// A Metric that represents an instantaneous value which, unlike a
+// `Gauge`, is evaluated on its own schedule rather than when 'value'
+// is called. The last sampled value is cached and returned right
+// away, so taking a snapshot of the metrics does not have to wait on
+// the (possibly busy) process that owns the value. This is intended
+// for gauges that are expensive to evaluate or are owned by processes
+// whose queues can get long, e.g., the allocator.
+//
+// A new sample is only taken once the previous one has completed, so
+// a slow process is never sent more than one outstanding request.
+class SampledGauge : public Metric
+{
+public:
+  // 'name' is the unique name for the instance of SampledGauge being
+  // constructed. It will be the key exposed in the JSON endpoint.
+  //
+  // 'f' is the function that is called to take a sample, the first
+  // time on construction and then 'interval' after the previous
+  // sample completed. The user of `SampledGauge` must ensure that `f`
+  // is safe to execute until the last copy of the `SampledGauge` is
+  // destroyed; using `defer` is the simplest way to achieve this.
+  //
+  // 'staleness' bounds the age of the cached value: once the last
+  // successful sample is older than 'staleness' the value is omitted
+  // from snapshots until the next sample succeeds. By default the
+  // last successful sample is always returned.
+  SampledGauge(
+      const std::string& name,
+      const std::function<Future<double>()>& f,
+      const Duration& interval,
+      const Option<Duration>& staleness = None())
+    : Metric(name, None()),
+      data(new Data(f, interval, staleness))
+  {
+    // The clock is needed for sampling.
+    process::initialize();
+
+    sample(data);
+  }
+
+  virtual ~SampledGauge() {}
+
+  virtual Future<double> value() const
+  {
+    synchronized (data->mutex) {
+      if (data->value.isNone()) {
+        return Failure("Not sampled yet");
+      }
+
+      if (data->staleness.isSome() &&
+          Clock::now() - data->time > data->staleness.get()) {
+        return Failure(
+            "Last sampled " + stringify(Clock::now() - data->time) + " ago");
+      }
+
+      return data->value.get();
+    }
+  }
+
+private:
+  struct Data
+  {
+    Data(const std::function<Future<double>()>& _f,
+         const Duration& _interval,
+         const Option<Duration>& _staleness)
+      : f(_f), interval(_interval), staleness(_staleness) {}
+
+    ~Data()
+    {
+      if (timer.isSome()) {
+        Clock::cancel(timer.get());
+      }
+    }
+
+    const std::function<Future<double>()> f;
+    const Duration interval;
+    const Option<Duration> staleness;
+
+    std::mutex mutex;
+    Option<double> value;
+    Time time;
+    Option<Timer> timer;
+  };
+
+  // The sampling only holds weak references to the data so that it
+  // stops once the last copy of the gauge is destroyed.
+  static void sample(const std::weak_ptr<Data>& weak)
+  {
+    std::shared_ptr<Data> data = weak.lock();
+    if (!data) {
+      return;
+    }
+
+    data->f()
+      .onAny([weak](const Future<double>& future) {
+        std::shared_ptr<Data> data = weak.lock();
+        if (!data) {
+          return;
+        }
+
+        synchronized (data->mutex) {
+          if (future.isReady()) {
+            data->value = future.get();
+            data->time = Clock::now();
+          }
+
+          data->timer = Clock::timer(data->interval, [weak]() {
+            sample(weak);
+          });
+        }
+      });
+  }
+
+  std::shared_ptr<Data> data;
+};
+
+} // namespace metrics {
+} // namespace process {
+
+#endif // __PROCESS_METRICS_SAMPLED_GAUGE_HPP__
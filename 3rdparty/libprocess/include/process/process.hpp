@@ -466,6 +466,32 @@ private:
   // process itself in order to safely examine events.
   operator JSON::Object();
 
+  // Accounting of the events served by the process, kept by
+  // `ProcessManager::resume`. Like the consumer side of `events`,
+  // this must only be accessed from within the process itself.
+  struct EventStatistics
+  {
+    struct Entry
+    {
+      uint64_t count = 0;
+
+      // Total time spent serving the events.
+      Duration served = Duration::zero();
+
+      // Total time the events waited in the event queue.
+      Duration queued = Duration::zero();
+    };
+
+    // Keyed by the event type, e.g., "MESSAGE".
+    hashmap<std::string, Entry> types;
+
+    // Keyed by message name. To bound the memory used when peers send
+    // arbitrary messages, only the first `MAX_MESSAGE_NAMES` distinct
+    // message names are accounted for individually.
+    static constexpr size_t MAX_MESSAGE_NAMES = 256;
+    hashmap<std::string, Entry> messages;
+  } statistics;
+
   // Static assets(s) to provide.
   std::map<std::string, Asset> assets;
 
@@ -657,6 +683,22 @@ void post(const UPID& from,
           size_t length = 0);
 
 
+/**
+ * Like the overloads above but moves the name and the data into the
+ * message rather than copying them. Prefer these if the data can be
+ * moved in.
+ */
+void post(const UPID& to,
+          std::string&& name,
+          std::string&& data);
+
+
+void post(const UPID& from,
+          const UPID& to,
+          std::string&& name,
+          std::string&& data);
+
+
 /**
  * @copydoc process::terminate
  */
@@ -79,6 +79,9 @@ private:
   // The authentication realm that the profiler's HTTP endpoints will be
   // installed into.
   Option<std::string> authenticationRealm;
+
+  // Whether the CPU profiler is running.
+  bool started = false;
 };
 
 } // namespace process {
@@ -33,6 +33,10 @@
 
 
 // Provides an implementation of process::post that for a protobuf.
+//
+// NOTE: the message is serialized straight into the string that
+// becomes the body of the outgoing message, which is then moved (not
+// copied) all the way to the socket for remote messages.
 namespace process {
 
 inline void post(const process::UPID& to,
@@ -40,7 +44,7 @@ inline void post(const process::UPID& to,
 {
   std::string data;
   message.SerializeToString(&data);
-  post(to, message.GetTypeName(), data.data(), data.size());
+  post(to, message.GetTypeName(), std::move(data));
 }
 
 
@@ -50,7 +54,7 @@ inline void post(const process::UPID& from,
 {
   std::string data;
   message.SerializeToString(&data);
-  post(from, to, message.GetTypeName(), data.data(), data.size());
+  post(from, to, message.GetTypeName(), std::move(data));
 }
 
 } // namespace process {
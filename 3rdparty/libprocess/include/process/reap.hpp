@@ -19,10 +19,13 @@
 #include <process/id.hpp>
 #include <process/process.hpp>
 
+#include <stout/hashmap.hpp>
 #include <stout/multihashmap.hpp>
 #include <stout/option.hpp>
 #include <stout/result.hpp>
 
+#include <stout/os/int_fd.hpp>
+
 namespace process {
 
 // The upper bound for the poll interval in the reaper.
@@ -42,12 +45,19 @@ protected:
 
   void wait();
 
+  // Invoked once the pidfd of the pid becomes readable, i.e., when
+  // the process has terminated.
+  void exited(pid_t pid, const Future<short>& poll);
+
   void notify(pid_t pid, Result<int> status);
 
 private:
   const Duration interval();
 
   multihashmap<pid_t, Owned<Promise<Option<int>>>> promises;
+
+  // The pidfds of the pids, only on Linux.
+  hashmap<pid_t, int_fd> pidfds;
 };
 
 
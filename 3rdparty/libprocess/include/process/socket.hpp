@@ -19,6 +19,7 @@
 #endif // __WINDOWS__
 
 #include <memory>
+#include <vector>
 
 #include <process/address.hpp>
 #include <process/future.hpp>
@@ -69,6 +70,16 @@ public:
 #endif
   };
 
+  /**
+   * A contiguous region of memory to be sent, see the scatter/gather
+   * overload of `send` below.
+   */
+  struct Segment
+  {
+    const char* data;
+    size_t size;
+  };
+
   /**
    * Returns the default `Kind` of implementation.
    */
@@ -153,6 +164,18 @@ public:
   virtual Future<size_t> send(const char* data, size_t size) = 0;
   virtual Future<size_t> sendfile(int_fd fd, off_t offset, size_t size) = 0;
 
+  /**
+   * An overload of `send`, which sends the specified segments, in
+   * order, as a single "gather" write. Like `send` above this might
+   * not send all of the data and returns the number of bytes that
+   * were actually sent. The data that the segments point to must
+   * remain valid until the returned future has completed.
+   *
+   * The default implementation only sends the first non-empty
+   * segment.
+   */
+  virtual Future<size_t> send(const std::vector<Segment>& segments);
+
   /**
    * An overload of `recv`, which receives data based on the specified
    * 'size' parameter.
@@ -377,6 +400,11 @@ public:
     return impl->sendfile(fd, offset, size);
   }
 
+  Future<size_t> send(const std::vector<SocketImpl::Segment>& segments) const
+  {
+    return impl->send(segments);
+  }
+
   Future<std::string> recv(const Option<ssize_t>& size = None())
   {
     return impl->recv(size);
@@ -31,6 +31,7 @@
 #include <stout/unreachable.hpp>
 
 #include "event_loop.hpp"
+#include "timer_wheel.hpp"
 
 using std::list;
 using std::map;
@@ -39,10 +40,9 @@ using std::set;
 
 namespace process {
 
-// We store the timers in a map of lists indexed by the timeout of the
-// timer so that we can have two timers that have the same timeout. We
-// exploit that the map is SORTED!
-static map<Time, list<Timer>>* timers = new map<Time, list<Timer>>();
+// We store the timers in a timing wheel so that adding and canceling
+// timers takes constant time regardless of the number of timers.
+static TimerWheel* timers = new TimerWheel();
 static recursive_mutex* timers_mutex = new recursive_mutex();
 
 
@@ -82,13 +82,12 @@ set<Time>* ticks = new set<Time>();
 // timers are expired. Note that we don't manipulate 'timers' directly
 // so that it's clear from the callsite that the use of 'timers' is
 // within a 'synchronized' block.
-//
-// TODO(benh): Create a generic 'Timers' abstraction which hides this
-// and more away (i.e., all manipulations of 'timers' below).
-Option<Time> next(const map<Time, list<Timer>>& timers)
+Option<Time> next(TimerWheel* timers)
 {
-  if (!timers.empty()) {
-    Time first = timers.begin()->first;
+  const Option<Time> earliest = timers->next();
+
+  if (earliest.isSome()) {
+    Time first = earliest.get();
 
     // If the clock is paused and no timers are expired, the
     // timers cannot fire until the clock is advanced, so we
@@ -116,7 +115,7 @@ void tick(const Time& time);
 // a 'synchronized' block.
 // TODO(bmahler): Consider taking an optional 'now' to avoid
 // excessive syscalls via Clock::now(nullptr).
-void scheduleTick(const map<Time, list<Timer>>& timers, set<Time>* ticks)
+void scheduleTick(TimerWheel* timers, set<Time>* ticks)
 {
   // Determine when the next 'tick' should fire.
   const Option<Time> next = clock::next(timers);
@@ -151,12 +150,11 @@ void tick(const Time& time)
 
     VLOG(3) << "Handling timers up to " << now;
 
-    foreachkey (const Time& timeout, *timers) {
-      if (timeout > now) {
-        break;
-      }
+    // All the expired timers are fired in a single batch below.
+    timedout = timers->expire(now);
 
-      VLOG(3) << "Have timeout(s) at " << timeout;
+    if (!timedout.empty()) {
+      VLOG(3) << "Have " << timedout.size() << " timeout(s)";
 
       // Need to toggle 'settling' so that we don't prematurely say
       // we're settled until after the timers are executed below,
@@ -164,15 +162,10 @@ void tick(const Time& time)
       if (clock::paused) {
         clock::settling = true;
       }
-
-      timedout.splice(timedout.end(), (*timers)[timeout]);
     }
 
-    // Now erase the range of timers that timed out.
-    timers->erase(timers->begin(), timers->upper_bound(now));
-
     // Okay, so the timeout for the next timer should not have fired.
-    CHECK(timers->empty() || (timers->begin()->first > now));
+    CHECK(timers->empty() || (timers->next().get() > now));
 
     // Remove this tick from the scheduled 'ticks', it may have
     // been removed already if the clock was paused / manipulated
@@ -180,7 +173,7 @@ void tick(const Time& time)
     ticks->erase(time);
 
     // Schedule another "tick" if necessary.
-    scheduleTick(*timers, ticks);
+    scheduleTick(timers, ticks);
   }
 
   (*clock::callback)(timedout);
@@ -192,8 +185,7 @@ void tick(const Time& time)
   // executing expired timers.
   synchronized (timers_mutex) {
     if (clock::paused &&
-        (timers->size() == 0 ||
-         timers->begin()->first > *clock::current)) {
+        (timers->empty() || timers->next().get() > *clock::current)) {
       VLOG(3) << "Clock has settled";
       clock::settling = false;
     }
@@ -221,7 +213,7 @@ void Clock::finalize()
     // This, along with the `timers_mutex`, is all that is required to clean
     // up any pending timers.  Timers are triggered via "ticks".  However,
     // we do not need to clear `ticks` because a "tick" with an empty `timers`
-    // map will effectively be a no-op.
+    // wheel will effectively be a no-op.
     timers->clear();
   }
 }
@@ -281,17 +273,22 @@ Timer Clock::timer(
 
   // Add the timer.
   synchronized (timers_mutex) {
-    if (timers->size() == 0 ||
-        timer.timeout().time() < timers->begin()->first) {
-      // Need to interrupt the loop to update/set timer repeat.
-      (*timers)[timer.timeout().time()].push_back(timer);
+    if (timers->empty()) {
+      // Start the wheel from the current time rather than from the
+      // time its last timer expired.
+      timers->reset(Clock::now(nullptr));
+    }
 
+    const bool earliest =
+      timers->empty() || timer.timeout().time() < timers->next().get();
+
+    timers->add(timer);
+
+    // Need to interrupt the loop to update/set timer repeat, otherwise
+    // the timer repeat is adequate.
+    if (earliest) {
       // Schedule another "tick" if necessary.
-      clock::scheduleTick(*timers, clock::ticks);
-    } else {
-      // Timer repeat is adequate, just add the timeout.
-      CHECK(timers->size() >= 1);
-      (*timers)[timer.timeout().time()].push_back(timer);
+      clock::scheduleTick(timers, clock::ticks);
     }
   }
 
@@ -301,22 +298,12 @@ Timer Clock::timer(
 
 bool Clock::cancel(const Timer& timer)
 {
-  bool canceled = false;
   synchronized (timers_mutex) {
-    // Check if the timeout is still pending, and if so, erase it. In
-    // addition, erase an empty list if we just removed the last
-    // timeout.
-    Time time = timer.timeout().time();
-    if (timers->count(time) > 0) {
-      canceled = true;
-      (*timers)[time].remove(timer);
-      if ((*timers)[time].empty()) {
-        timers->erase(time);
-      }
-    }
+    // Erase the timer if it is still pending.
+    return timers->remove(timer);
   }
 
-  return canceled;
+  UNREACHABLE();
 }
 
 
@@ -365,7 +352,7 @@ void Clock::resume()
       clock::currents->clear();
 
       // Schedule another "tick" if necessary.
-      clock::scheduleTick(*timers, clock::ticks);
+      clock::scheduleTick(timers, clock::ticks);
     }
   }
 }
@@ -383,7 +370,7 @@ void Clock::advance(const Duration& duration)
       // Schedule another "tick" if necessary. Only "ticks" that
       // fire immediately will be scheduled here, since the clock
       // is paused.
-      clock::scheduleTick(*timers, clock::ticks);
+      clock::scheduleTick(timers, clock::ticks);
     }
   }
 }
@@ -420,7 +407,7 @@ void Clock::update(const Time& time)
         // Schedule another "tick" if necessary. Only "ticks" that
         // fire immediately will be scheduled here, since the clock
         // is paused.
-        clock::scheduleTick(*timers, clock::ticks);
+        clock::scheduleTick(timers, clock::ticks);
       }
     }
   }
@@ -460,8 +447,7 @@ bool Clock::settled()
     if (clock::settling) {
       VLOG(3) << "Clock still not settled";
       return false;
-    } else if (timers->size() == 0 ||
-               timers->begin()->first > *clock::current) {
+    } else if (timers->empty() || timers->next().get() > *clock::current) {
       VLOG(3) << "Clock is settled";
       return true;
     }
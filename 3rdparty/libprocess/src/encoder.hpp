@@ -19,9 +19,12 @@
 #include <limits>
 #include <map>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <process/http.hpp>
 #include <process/process.hpp>
+#include <process/socket.hpp>
 
 #include <stout/foreach.hpp>
 #include <stout/gzip.hpp>
@@ -34,6 +37,18 @@ namespace process {
 
 const uint32_t GZIP_MINIMUM_BODY_LENGTH = 1024;
 
+// The gzip compression level used for responses, and the minimum
+// length of a response body for it to get compressed. These are set
+// from LIBPROCESS_HTTP_COMPRESSION_LEVEL and
+// LIBPROCESS_HTTP_COMPRESSION_MINIMUM_LENGTH in `process::initialize`.
+// Responses are not compressed if the level is `Z_NO_COMPRESSION`.
+extern int http_compression_level;
+extern size_t http_compression_minimum_length;
+
+// Terminates the (only) chunk of a message body and then the chunked
+// transfer encoding, see `MessageEncoder`.
+const char MESSAGE_BODY_TRAILER[] = "\r\n0\r\n\r\n";
+
 // Forward declarations.
 class Encoder;
 
@@ -59,11 +74,18 @@ public:
 };
 
 
+// Encodes data that is held in memory. The data may be made up of
+// multiple strings (e.g., the headers and the body of a message) so
+// that it doesn't have to be copied into a single buffer first; see
+// the gather `next()` below.
 class DataEncoder : public Encoder
 {
 public:
-  DataEncoder(const std::string& _data)
-    : data(_data), index(0) {}
+  DataEncoder(std::string _data)
+    : size(_data.size()), index(0)
+  {
+    data.push_back(std::move(_data));
+  }
 
   virtual ~DataEncoder() {}
 
@@ -72,12 +94,41 @@ public:
     return Encoder::DATA;
   }
 
+  // Returns the remaining data of the current string.
   virtual const char* next(size_t* length)
   {
-    size_t temp = index;
-    index = data.size();
-    *length = data.size() - temp;
-    return data.data() + temp;
+    size_t offset = index;
+    foreach (const std::string& s, data) {
+      if (offset < s.size()) {
+        *length = s.size() - offset;
+        index += *length;
+        return s.data() + offset;
+      }
+      offset -= s.size();
+    }
+
+    *length = 0;
+    return nullptr;
+  }
+
+  // Appends all of the remaining data to `segments` so that it can be
+  // sent with a single gather write, returns the number of bytes.
+  virtual size_t next(
+      std::vector<network::internal::SocketImpl::Segment>* segments)
+  {
+    size_t offset = index;
+    foreach (const std::string& s, data) {
+      if (offset < s.size()) {
+        segments->push_back({s.data() + offset, s.size() - offset});
+        offset = 0;
+      } else {
+        offset -= s.size();
+      }
+    }
+
+    size_t length = size - index;
+    index = size;
+    return length;
   }
 
   virtual void backup(size_t length)
@@ -89,22 +140,67 @@ public:
 
   virtual size_t remaining() const
   {
-    return data.size() - index;
+    return size - index;
+  }
+
+protected:
+  DataEncoder(std::vector<std::string>&& _data)
+    : data(std::move(_data)), size(0), index(0)
+  {
+    foreach (const std::string& s, data) {
+      size += s.size();
+    }
   }
 
 private:
-  const std::string data;
+  std::vector<std::string> data;
+  size_t size;
   size_t index;
 };
 
 
+// Encodes a message for sending over the wire. The body of the
+// message is moved into the encoder (rather than copied into one
+// buffer with the HTTP framing) and sent along with the framing using
+// a gather write, which matters for big messages.
 class MessageEncoder : public DataEncoder
 {
 public:
-  MessageEncoder(const Message& message)
-    : DataEncoder(encode(message)) {}
+  MessageEncoder(Message message)
+    : DataEncoder(frame(std::move(message))) {}
 
   static std::string encode(const Message& message)
+  {
+    std::string data = header(message);
+
+    if (message.body.size() > 0) {
+      data.reserve(
+          data.size() + message.body.size() + sizeof(MESSAGE_BODY_TRAILER));
+
+      data += message.body;
+      data += MESSAGE_BODY_TRAILER;
+    }
+
+    return data;
+  }
+
+private:
+  static std::vector<std::string> frame(Message&& message)
+  {
+    std::vector<std::string> data;
+    data.push_back(header(message));
+
+    if (message.body.size() > 0) {
+      data.push_back(std::move(message.body));
+      data.push_back(MESSAGE_BODY_TRAILER);
+    }
+
+    return data;
+  }
+
+  // Everything that precedes the body, including the size of the
+  // (only) chunk if there is a body.
+  static std::string header(const Message& message)
   {
     std::ostringstream out;
 
@@ -127,10 +223,6 @@ public:
     if (message.body.size() > 0) {
       out << "Transfer-Encoding: chunked\r\n\r\n"
           << std::hex << message.body.size() << "\r\n";
-      out.write(message.body.data(), message.body.size());
-      out << "\r\n"
-          << "0\r\n"
-          << "\r\n";
     } else {
       out << "\r\n";
     }
@@ -182,10 +274,12 @@ public:
     std::string body = response.body;
 
     if (response.type == http::Response::BODY &&
-        response.body.length() >= GZIP_MINIMUM_BODY_LENGTH &&
+        http_compression_level != Z_NO_COMPRESSION &&
+        response.body.length() >= http_compression_minimum_length &&
         !headers.contains("Content-Encoding") &&
         request.acceptsEncoding("gzip")) {
-      Try<std::string> compressed = gzip::compress(body);
+      Try<std::string> compressed =
+        gzip::compress(body, http_compression_level);
       if (compressed.isError()) {
         LOG(WARNING) << "Failed to gzip response body: " << compressed.error();
       } else {
@@ -65,6 +65,16 @@ namespace process {
 // this efficiently we require only a single consumer, which fits well
 // into the actor model because there will only ever be a single
 // thread consuming an actors events at a time.
+//
+// Notes on the locking implementation:
+//
+// The consumer delivers events in batches: when it runs out of
+// events it takes the lock once and moves everything that has been
+// enqueued so far into a consumer-only `batch`, after which events
+// are dequeued without any locking until the batch is drained. This
+// is what the lock-free implementation already does with `items`
+// and it means a busy process acquires the lock once per batch
+// rather than twice per event.
 class EventQueue
 {
 public:
@@ -123,23 +133,25 @@ private:
 
   Event* dequeue()
   {
-    Event* event = nullptr;
-
-    synchronized (mutex) {
-      if (events.size() > 0) {
-        Event* event = events.front();
-        events.pop_front();
-        return event;
-      }
+    if (batch.empty()) {
+      fill();
     }
 
     // Semantics are the consumer _must_ call `empty()` before calling
     // `dequeue()` which means an event must be present.
-    return CHECK_NOTNULL(event);
+    CHECK(!batch.empty());
+
+    Event* event = batch.front();
+    batch.pop_front();
+    return event;
   }
 
   bool empty()
   {
+    if (!batch.empty()) {
+      return false;
+    }
+
     synchronized (mutex) {
       return events.size() == 0;
     }
@@ -147,43 +159,67 @@ private:
 
   void decomission()
   {
+    // Delete the events outside of the lock as deleting an event can
+    // cause other events to get enqueued (which are then dropped).
     synchronized (mutex) {
       comissioned = false;
-      while (!events.empty()) {
-        Event* event = events.front();
-        events.pop_front();
-        delete event;
-      }
+      batch.insert(batch.end(), events.begin(), events.end());
+      events.clear();
+    }
+
+    while (!batch.empty()) {
+      Event* event = batch.front();
+      batch.pop_front();
+      delete event;
     }
   }
 
   template <typename T>
   size_t count()
   {
-    synchronized (mutex) {
-      return std::count_if(
-          events.begin(),
-          events.end(),
-          [](const Event* event) {
-            return event->is<T>();
-          });
-    }
+    fill();
+
+    return std::count_if(
+        batch.begin(),
+        batch.end(),
+        [](const Event* event) {
+          return event->is<T>();
+        });
   }
 
   operator JSON::Array()
   {
+    fill();
+
     JSON::Array array;
+    foreach (Event* event, batch) {
+      array.values.push_back(JSON::Object(*event));
+    }
+    return array;
+  }
+
+  // Moves all of the enqueued events to the back of `batch`.
+  void fill()
+  {
     synchronized (mutex) {
-      foreach (Event* event, events) {
-        array.values.push_back(JSON::Object(*event));
+      if (batch.empty()) {
+        // The common case, avoid copying the events one by one.
+        std::swap(batch, events);
+      } else {
+        batch.insert(batch.end(), events.begin(), events.end());
+        events.clear();
       }
     }
-    return array;
   }
 
   std::mutex mutex;
   std::deque<Event*> events;
   bool comissioned = true;
+
+  // Events that have been taken from `events` but not yet dequeued.
+  // Like the `items` of the lock-free implementation this is only
+  // ever read/written by the single consumer, so it needs no lock.
+  std::deque<Event*> batch;
 #else // LOCK_FREE_EVENT_QUEUE
   void enqueue(Event* event)
   {
@@ -14,6 +14,9 @@
 #include <process/grpc.hpp>
 #include <process/id.hpp>
 
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+
 namespace process {
 namespace grpc {
 
@@ -31,14 +34,24 @@ Future<Nothing> Runtime::wait()
 }
 
 
-Runtime::Data::Data()
-  : process(ID::generate("__grpc_client__"))
+Runtime::Data::Data(size_t workers)
+  : loopers(workers),
+    running(workers),
+    process(ID::generate("__grpc_client__"))
 {
+  CHECK_GT(workers, 0u);
+
+  for (size_t i = 0; i < workers; i++) {
+    queues.emplace_back(new ::grpc::CompletionQueue());
+  }
+
   spawn(process);
 
-  // The looper thread can only be created here since it need to happen
-  // after `queue` is initialized.
-  looper.reset(new std::thread(&Runtime::Data::loop, this));
+  // The looper threads can only be created here since it need to
+  // happen after `queues` are initialized.
+  for (size_t i = 0; i < workers; i++) {
+    loopers[i].reset(new std::thread(&Runtime::Data::loop, this, i));
+  }
 }
 
 
@@ -49,12 +62,18 @@ Runtime::Data::~Data()
 }
 
 
-void Runtime::Data::loop()
+::grpc::CompletionQueue* Runtime::Data::queue()
+{
+  return queues[next++ % queues.size()].get();
+}
+
+
+void Runtime::Data::loop(size_t index)
 {
   void* tag;
   bool ok;
 
-  while (queue.Next(&tag, &ok)) {
+  while (queues[index]->Next(&tag, &ok)) {
     // The returned callback object is managed by the `callback` shared
     // pointer, so if we get a regular event from the `CompletionQueue`,
     // then the object would be captured by the following lambda
@@ -66,14 +85,18 @@ void Runtime::Data::loop()
     }
   }
 
-  dispatch(process, [this] {
+  dispatch(process, [this, index] {
     // NOTE: This is a blocking call. However, the thread is guaranteed
     // to be exiting, therefore the amount of blocking time should be
     // short (just like other syscalls we invoke).
-    looper->join();
-    // Terminate `process` after all events are drained.
-    process::terminate(process, false);
-    terminated.set(Nothing());
+    loopers[index]->join();
+
+    // Terminate `process` after all events of all the looper threads
+    // are drained.
+    if (--running == 0) {
+      process::terminate(process, false);
+      terminated.set(Nothing());
+    }
   });
 }
 
@@ -83,7 +106,10 @@ void Runtime::Data::terminate()
   synchronized (lock) {
     if (!terminating) {
       terminating = true;
-      queue.Shutdown();
+
+      foreach (const std::unique_ptr<::grpc::CompletionQueue>& queue, queues) {
+        queue->Shutdown();
+      }
     }
   }
 }
@@ -32,8 +32,10 @@
 #include <vector>
 
 #include <process/after.hpp>
+#include <process/clock.hpp>
 #include <process/collect.hpp>
 #include <process/defer.hpp>
+#include <process/delay.hpp>
 #include <process/dispatch.hpp>
 #include <process/future.hpp>
 #include <process/http.hpp>
@@ -45,6 +47,10 @@
 #include <process/queue.hpp>
 #include <process/socket.hpp>
 #include <process/state_machine.hpp>
+#include <process/timer.hpp>
+
+#include <process/metrics/counter.hpp>
+#include <process/metrics/metrics.hpp>
 
 #include <stout/foreach.hpp>
 #include <stout/ip.hpp>
@@ -2316,6 +2322,270 @@ Future<Response> request(const Request& request, bool streamedResponse)
 }
 
 
+class ConnectionPoolProcess : public Process<ConnectionPoolProcess>
+{
+public:
+  ConnectionPoolProcess(
+      const string& name,
+      const ConnectionPool::Options& _options)
+    : ProcessBase(ID::generate("__http_connection_pool__")),
+      options(_options),
+      metrics(name) {}
+
+  Future<Response> request(Request request)
+  {
+    // Pooled connections are only handed out once the previous
+    // response on them has been received, so there is no pipelining.
+    request.keepAlive = true;
+
+    const string key = origin(request.url);
+    Origin& entry = origins[key];
+
+    // Prefer the most recently used connection so that the
+    // least recently used ones get a chance to time out.
+    if (!entry.idle.empty()) {
+      Idle idle = entry.idle.back();
+      entry.idle.pop_back();
+
+      Clock::cancel(idle.timer);
+
+      ++metrics.hits;
+
+      return _request(key, idle.connection, request);
+    }
+
+    if (entry.connections >= options.max_connections_per_origin) {
+      Owned<Promise<Response>> promise(new Promise<Response>());
+      entry.pending.push_back(Pending{request, promise});
+      return promise->future();
+    }
+
+    return connect(key, request);
+  }
+
+protected:
+  void finalize() override
+  {
+    foreachvalue (Origin& entry, origins) {
+      foreach (Idle& idle, entry.idle) {
+        Clock::cancel(idle.timer);
+        idle.connection.disconnect();
+      }
+
+      foreach (Pending& pending, entry.pending) {
+        pending.promise->fail("Connection pool is terminating");
+      }
+    }
+
+    origins.clear();
+  }
+
+private:
+  struct Idle
+  {
+    uint64_t id;
+    Connection connection;
+    Timer timer;
+  };
+
+  struct Pending
+  {
+    Request request;
+    Owned<Promise<Response>> promise;
+  };
+
+  struct Origin
+  {
+    // The number of connections to the origin, either idle or in use.
+    size_t connections = 0;
+
+    deque<Idle> idle;
+    deque<Pending> pending;
+  };
+
+  static string origin(const URL& url)
+  {
+    return url.scheme.getOrElse("http") + "://" +
+           (url.ip.isSome() ? stringify(url.ip.get())
+                            : url.domain.getOrElse("")) +
+           ":" + (url.port.isSome() ? stringify(url.port.get()) : "");
+  }
+
+  Future<Response> connect(const string& key, const Request& request)
+  {
+    ++metrics.misses;
+    ++origins[key].connections;
+
+    return http::connect(request.url)
+      .onAny(defer(self(), [=](const Future<Connection>& connection) {
+        if (!connection.isReady()) {
+          release(key);
+        }
+      }))
+      .then(defer(self(), [=](const Connection& connection) {
+        return _request(key, connection, request);
+      }));
+  }
+
+  Future<Response> _request(
+      const string& key,
+      Connection connection,
+      const Request& request)
+  {
+    return connection.send(request)
+      .onAny(defer(self(), [=](const Future<Response>& response) {
+        reuse(key, connection, response);
+      }));
+  }
+
+  // Hands the connection over to the next pending request to the
+  // origin or parks it as idle, unless it can no longer be used.
+  void reuse(
+      const string& key,
+      Connection connection,
+      const Future<Response>& response)
+  {
+    Option<string> header;
+    if (response.isReady()) {
+      header = response->headers.get("Connection");
+    }
+
+    if (!response.isReady() ||
+        (header.isSome() && strings::lower(header.get()) == "close")) {
+      connection.disconnect();
+      release(key);
+      return;
+    }
+
+    Origin& entry = origins[key];
+
+    if (!entry.pending.empty()) {
+      Pending pending = entry.pending.front();
+      entry.pending.pop_front();
+
+      ++metrics.hits;
+
+      pending.promise->associate(_request(key, connection, pending.request));
+      return;
+    }
+
+    const uint64_t id = nextId++;
+
+    entry.idle.push_back(Idle{
+        id,
+        connection,
+        delay(
+            options.idle_timeout,
+            self(),
+            &ConnectionPoolProcess::expire,
+            key,
+            id)});
+
+    // The server is free to close an idle connection at any time.
+    connection.disconnected()
+      .onAny(defer(self(), [=]() { expire(key, id); }));
+  }
+
+  // Closes the idle connection identified by `id`, if it is still
+  // idle, i.e., it has neither been reused nor expired already.
+  void expire(const string& key, uint64_t id)
+  {
+    if (!origins.contains(key)) {
+      return;
+    }
+
+    Origin& entry = origins.at(key);
+
+    auto it = std::find_if(
+        entry.idle.begin(),
+        entry.idle.end(),
+        [id](const Idle& idle) { return idle.id == id; });
+
+    if (it == entry.idle.end()) {
+      return;
+    }
+
+    Clock::cancel(it->timer);
+    it->connection.disconnect();
+    entry.idle.erase(it);
+
+    release(key);
+  }
+
+  // Accounts for a closed connection to the origin, which lets the
+  // next pending request (if any) establish a new connection.
+  void release(const string& key)
+  {
+    Origin& entry = origins.at(key);
+
+    CHECK_GT(entry.connections, 0u);
+    --entry.connections;
+
+    if (!entry.pending.empty()) {
+      Pending pending = entry.pending.front();
+      entry.pending.pop_front();
+
+      pending.promise->associate(connect(key, pending.request));
+      return;
+    }
+
+    if (entry.connections == 0) {
+      origins.erase(key);
+    }
+  }
+
+  struct Metrics
+  {
+    explicit Metrics(const string& name)
+      : hits("http/connection_pools/" + name + "/hits"),
+        misses("http/connection_pools/" + name + "/misses")
+    {
+      process::metrics::add(hits);
+      process::metrics::add(misses);
+    }
+
+    ~Metrics()
+    {
+      process::metrics::remove(hits);
+      process::metrics::remove(misses);
+    }
+
+    process::metrics::Counter hits;
+    process::metrics::Counter misses;
+  };
+
+  const ConnectionPool::Options options;
+
+  hashmap<string, Origin> origins;
+  uint64_t nextId = 0;
+
+  Metrics metrics;
+};
+
+
+ConnectionPool::ConnectionPool(const string& name, const Options& options)
+  : process(new ConnectionPoolProcess(name, options))
+{
+  spawn(*process);
+}
+
+
+ConnectionPool::~ConnectionPool()
+{
+  // `process` may be a `nullptr` if we've moved `this`.
+  if (process.get() != nullptr) {
+    terminate(*process);
+    wait(*process);
+  }
+}
+
+
+Future<Response> ConnectionPool::request(const Request& request)
+{
+  return dispatch(*process, &ConnectionPoolProcess::request, request);
+}
+
+
 Future<Response> get(
     const URL& url,
     const Option<Headers>& headers)
@@ -44,6 +44,12 @@ void HttpProxy::finalize()
     reader.close();
   }
   pipe = None();
+  compressor.reset();
+
+  if (waiter.isSome()) {
+    waiter.get()->promise.fail("Connection closed");
+    waiter = None();
+  }
 
   while (!items.empty()) {
     Item* item = items.front();
@@ -74,25 +80,67 @@ void HttpProxy::finalize()
 }
 
 
-void HttpProxy::enqueue(const Response& response, const Request& request)
+void HttpProxy::enqueue(
+    const Response& response,
+    const Owned<Request>& request)
 {
   handle(Future<Response>(response), request);
 }
 
 
-void HttpProxy::handle(const Future<Response>& future, const Request& request)
+void HttpProxy::handle(
+    const Future<Response>& future,
+    const Owned<Request>& request)
 {
   items.push(new Item(request, future));
 
-  if (items.size() == 1) {
+  // NOTE: While streaming, `next` gets invoked once the stream is
+  // finished so that the responses stay in order.
+  if (items.size() == 1 && pipe.isNone()) {
     next();
   }
 }
 
 
+Future<Nothing> HttpProxy::available(size_t window)
+{
+  CHECK_GT(window, 0u);
+  CHECK_NONE(waiter);
+
+  if (items.size() + (pipe.isSome() ? 1 : 0) < window) {
+    return Nothing();
+  }
+
+  waiter = Owned<Waiter>(new Waiter(window));
+  return waiter.get()->promise.future();
+}
+
+
 void HttpProxy::next()
 {
-  if (items.size() > 0) {
+  // Process the responses that are already available right away
+  // rather than waiting for each of them in turn, which would take a
+  // dispatch per response for pipelined requests.
+  while (!items.empty() && !items.front()->future.isPending()) {
+    Item* item = items.front();
+
+    bool processed = process(item->future, item->request);
+
+    items.pop();
+    delete item;
+
+    if (!processed) {
+      break; // Streaming, `next` gets invoked once finished.
+    }
+  }
+
+  if (waiter.isSome() &&
+      items.size() + (pipe.isSome() ? 1 : 0) < waiter.get()->window) {
+    waiter.get()->promise.set(Nothing());
+    waiter = None();
+  }
+
+  if (!items.empty() && pipe.isNone()) {
     // Wait for any transition of the future.
     items.front()->future.onAny(
         defer(self(), &HttpProxy::waited, lambda::_1));
@@ -120,8 +168,12 @@ void HttpProxy::waited(const Future<Response>& future)
 }
 
 
-bool HttpProxy::process(const Future<Response>& future, const Request& request)
+bool HttpProxy::process(
+    const Future<Response>& future,
+    const Owned<Request>& request_)
 {
+  const Request& request = *request_;
+
   if (!future.isReady()) {
     // TODO(benh): Consider handling other "states" of future
     // (discarded, failed, etc) with different HTTP statuses.
@@ -213,6 +265,19 @@ bool HttpProxy::process(const Future<Response>& future, const Request& request)
     // header, we fill in (or overwrite) 'Transfer-Encoding' header.
     response.headers["Transfer-Encoding"] = "chunked";
 
+    // Compress the stream if the client accepts gzip. Since the length
+    // of a stream isn't known upfront, there is no minimum length.
+    // Every chunk is flushed so that the client can decompress it as
+    // soon as it is received.
+    compressor.reset();
+
+    if (http_compression_level != Z_NO_COMPRESSION &&
+        !response.headers.contains("Content-Encoding") &&
+        request.acceptsEncoding("gzip")) {
+      response.headers["Content-Encoding"] = "gzip";
+      compressor.reset(new gzip::Compressor(http_compression_level));
+    }
+
     VLOG(3) << "Starting \"chunked\" streaming";
 
     socket_manager->send(
@@ -225,12 +290,6 @@ bool HttpProxy::process(const Future<Response>& future, const Request& request)
 
     pipe = reader;
 
-    // Avoid copying the request for each chunk read on the pipe.
-    //
-    // TODO(bmahler): Make request a process::Owned or
-    // process::Shared from the point where it is decoded.
-    Owned<Request> request_(new Request(request));
-
     reader.read()
       .onAny(defer(self(), &Self::stream, request_, lambda::_1));
 
@@ -254,18 +313,35 @@ void HttpProxy::stream(
 
   bool finished = false; // Whether we're done streaming.
 
-  if (chunk.isReady()) {
+  // Compress the chunk if needed, the empty chunk marking the end of
+  // the stream finishes the compressed stream.
+  Try<string> data = chunk.isReady() ? chunk.get() : string();
+
+  if (chunk.isReady() && compressor.get() != nullptr) {
+    data = chunk->empty()
+      ? compressor->finish()
+      : compressor->compress(chunk.get());
+  }
+
+  if (data.isError()) {
+    VLOG(1) << "Failed to compress stream: " << data.error();
+    // TODO(bmahler): Have to close connection if headers were sent!
+    socket_manager->send(InternalServerError(), *request, socket);
+    finished = true;
+  } else if (chunk.isReady()) {
     std::ostringstream out;
 
-    if (chunk.get().empty()) {
+    if (!data->empty()) {
+      out << std::hex << data->size() << "\r\n";
+      out << data.get();
+      out << "\r\n";
+    }
+
+    if (chunk->empty()) {
       // Finished reading.
       out << "0\r\n" << "\r\n";
       finished = true;
     } else {
-      out << std::hex << chunk.get().size() << "\r\n";
-      out << chunk.get();
-      out << "\r\n";
-
       // Keep reading.
       reader.read()
         .onAny(defer(self(), &Self::stream, request, lambda::_1));
@@ -291,6 +367,7 @@ void HttpProxy::stream(
   if (finished) {
     reader.close();
     pipe = None();
+    compressor.reset();
     next();
   }
 }
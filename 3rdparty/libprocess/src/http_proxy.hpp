@@ -17,9 +17,12 @@
 
 #include <process/future.hpp>
 #include <process/http.hpp>
+#include <process/owned.hpp>
 #include <process/process.hpp>
 #include <process/socket.hpp>
 
+#include <stout/gzip.hpp>
+#include <stout/nothing.hpp>
 #include <stout/option.hpp>
 
 namespace process {
@@ -44,14 +47,20 @@ public:
   // responses have been processed (e.g., waited for and sent).
   void enqueue(
       const http::Response& response,
-      const http::Request& request);
+      const Owned<http::Request>& request);
 
   // Enqueues a future to a response that will get waited on (up to
   // some timeout) and then sent once all previously enqueued
   // responses have been processed (e.g., waited for and sent).
   void handle(
       const Future<http::Response>& future,
-      const http::Request& request);
+      const Owned<http::Request>& request);
+
+  // Returns a future that is satisfied once fewer than 'window'
+  // responses are outstanding, i.e., waited for or being sent. This is
+  // used to stop reading pipelined requests off the connection while
+  // too many of them are being handled.
+  Future<Nothing> available(size_t window);
 
 protected:
   void finalize() override;
@@ -66,7 +75,7 @@ private:
   // Demuxes and handles a response.
   bool process(
       const Future<http::Response>& future,
-      const http::Request& request);
+      const Owned<http::Request>& request);
 
   // Handles stream based responses.
   void stream(
@@ -81,16 +90,33 @@ private:
   // are acceptable and whether to persist the connection.
   struct Item
   {
-    Item(const http::Request& _request, const Future<http::Response>& _future)
+    Item(
+        const Owned<http::Request>& _request,
+        const Future<http::Response>& _future)
       : request(_request), future(_future) {}
 
-    const http::Request request; // Make a copy.
+    const Owned<http::Request> request;
     Future<http::Response> future; // Make a copy.
   };
 
   std::queue<Item*> items;
 
   Option<http::Pipe::Reader> pipe; // Current pipe, if streaming.
+
+  // Compresses the current stream, if the client accepts gzip.
+  Owned<gzip::Compressor> compressor;
+
+  // Set while waiting for the outstanding responses to drop below
+  // the window (see `available`).
+  struct Waiter
+  {
+    explicit Waiter(size_t _window) : window(_window) {}
+
+    const size_t window;
+    Promise<Nothing> promise;
+  };
+
+  Option<Owned<Waiter>> waiter;
 };
 
 } // namespace process {
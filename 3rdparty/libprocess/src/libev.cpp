@@ -14,10 +14,20 @@
 
 #include <mutex>
 #include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glog/logging.h>
 
 #include <stout/duration.hpp>
+#include <stout/foreach.hpp>
 #include <stout/lambda.hpp>
 #include <stout/nothing.hpp>
+#include <stout/numify.hpp>
+#include <stout/option.hpp>
+
+#include <stout/os/getenv.hpp>
 
 #include "event_loop.hpp"
 #include "libev.hpp"
@@ -41,6 +51,22 @@ std::queue<lambda::function<void()>>* functions =
 
 thread_local bool* _in_event_loop_ = nullptr;
 
+std::vector<IOLoop*>* io_loops = new std::vector<IOLoop*>();
+
+thread_local IOLoop* _io_loop_ = nullptr;
+
+
+IOLoop* io_loop(int_fd fd)
+{
+  if (io_loops->empty()) {
+    return nullptr;
+  }
+
+  const size_t index = static_cast<size_t>(fd) % (io_loops->size() + 1);
+
+  return index == 0 ? nullptr : io_loops->at(index - 1);
+}
+
 
 void handle_async(struct ev_loop* loop, ev_async* _, int revents)
 {
@@ -79,6 +105,34 @@ void handle_shutdown(struct ev_loop* loop, ev_async* _, int revents)
 }
 
 
+void handle_io_async(struct ev_loop* loop, ev_async* watcher, int revents)
+{
+  IOLoop* io_loop = static_cast<IOLoop*>(watcher->data);
+
+  // See the comments in 'handle_async' for why the functions are
+  // invoked outside of the mutex.
+  std::queue<lambda::function<void()>> run_functions;
+  synchronized (io_loop->mutex) {
+    std::swap(run_functions, io_loop->functions);
+  }
+
+  while (!run_functions.empty()) {
+    (run_functions.front())();
+    run_functions.pop();
+  }
+}
+
+
+void run_io_loop(IOLoop* io_loop)
+{
+  _io_loop_ = io_loop;
+
+  ev_loop(io_loop->loop, 0);
+
+  _io_loop_ = nullptr;
+}
+
+
 void EventLoop::initialize()
 {
   loop = ev_default_loop(EVFLAG_AUTO);
@@ -88,6 +142,42 @@ void EventLoop::initialize()
 
   ev_async_start(loop, &async_watcher);
   ev_async_start(loop, &shutdown_watcher);
+
+  // We allow the operator to spread the polling of file descriptors
+  // across multiple threads, each running its own loop, for when a
+  // single thread can't keep up with the network I/O. The first of
+  // these threads is the one running 'loop'.
+  constexpr char env_var[] = "LIBPROCESS_NUM_IO_THREADS";
+  Option<std::string> value = os::getenv(env_var);
+  if (value.isSome()) {
+    constexpr long maxval = 128;
+    Try<long> number = numify<long>(value.get().c_str());
+    if (number.isSome() && number.get() > 0L && number.get() <= maxval) {
+      VLOG(1) << "Using " << number.get() << " I/O threads";
+
+      for (long i = 1; i < number.get(); i++) {
+        IOLoop* io_loop = new IOLoop();
+        io_loop->loop = ev_loop_new(EVFLAG_AUTO);
+        CHECK(io_loop->loop != nullptr) << "Failed to create I/O loop";
+
+        io_loop->async_watcher.data = io_loop;
+
+        ev_async_init(&io_loop->async_watcher, handle_io_async);
+        ev_async_init(&io_loop->shutdown_watcher, handle_shutdown);
+
+        ev_async_start(io_loop->loop, &io_loop->async_watcher);
+        ev_async_start(io_loop->loop, &io_loop->shutdown_watcher);
+
+        io_loops->push_back(io_loop);
+      }
+    } else {
+      LOG(WARNING) << "Ignoring invalid value " << value.get()
+                   << " for " << env_var
+                   << ", using a single I/O thread."
+                   << " Valid values are integers in the range 1 to "
+                   << maxval;
+    }
+  }
 }
 
 
@@ -150,16 +240,29 @@ double EventLoop::time()
 
 void EventLoop::run()
 {
+  std::vector<std::thread> threads;
+  foreach (IOLoop* io_loop, *io_loops) {
+    threads.emplace_back(&run_io_loop, io_loop);
+  }
+
   __in_event_loop__ = true;
 
   ev_loop(loop, 0);
 
   __in_event_loop__ = false;
+
+  foreach (std::thread& thread, threads) {
+    thread.join();
+  }
 }
 
 
 void EventLoop::stop()
 {
+  foreach (IOLoop* io_loop, *io_loops) {
+    ev_async_send(io_loop->loop, &io_loop->shutdown_watcher);
+  }
+
   ev_async_send(loop, &shutdown_watcher);
 }
 
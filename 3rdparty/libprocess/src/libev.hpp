@@ -17,6 +17,7 @@
 
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include <process/future.hpp>
 #include <process/owned.hpp>
@@ -24,6 +25,8 @@
 #include <stout/lambda.hpp>
 #include <stout/synchronized.hpp>
 
+#include <stout/os/int_fd.hpp>
+
 namespace process {
 
 // Event loop.
@@ -52,6 +55,36 @@ extern thread_local bool* _in_event_loop_;
   _in_event_loop_ = new bool(false) : _in_event_loop_)
 
 
+// An additional event loop, run by its own thread, for polling file
+// descriptors. Unlike 'loop' these loops don't run timers.
+struct IOLoop
+{
+  struct ev_loop* loop;
+
+  // Asynchronous watchers for interrupting the loop to invoke the
+  // queued 'functions' and to shut it down.
+  ev_async async_watcher;
+  ev_async shutdown_watcher;
+
+  std::mutex mutex;
+  std::queue<lambda::function<void()>> functions;
+};
+
+
+// The additional I/O loops, see 'LIBPROCESS_NUM_IO_THREADS'. The
+// file descriptors are sharded across 'loop' and these loops by their
+// value, so a file descriptor is always polled by the same thread.
+extern std::vector<IOLoop*>* io_loops;
+
+// The I/O loop run by the current thread, if any.
+extern thread_local IOLoop* _io_loop_;
+
+
+// Returns the I/O loop for the file descriptor, or nullptr if the
+// file descriptor is polled by 'loop'.
+IOLoop* io_loop(int_fd fd);
+
+
 // Wrapper around function we want to run in the event loop.
 template <typename T>
 void _run_in_event_loop(
@@ -91,6 +124,31 @@ Future<T> run_in_event_loop(const lambda::function<Future<T>()>& f)
   return future;
 }
 
+
+// Helper for running a function in an I/O loop, see
+// 'run_in_event_loop'.
+template <typename T>
+Future<T> run_in_io_loop(
+    IOLoop* io_loop,
+    const lambda::function<Future<T>()>& f)
+{
+  if (_io_loop_ == io_loop) {
+    return f();
+  }
+
+  Owned<Promise<T>> promise(new Promise<T>());
+
+  Future<T> future = promise->future();
+
+  synchronized (io_loop->mutex) {
+    io_loop->functions.push(lambda::bind(&_run_in_event_loop<T>, f, promise));
+  }
+
+  ev_async_send(io_loop->loop, &io_loop->async_watcher);
+
+  return future;
+}
+
 } // namespace process {
 
 #endif // __LIBEV_HPP__
@@ -25,6 +25,8 @@
 
 #include <stout/synchronized.hpp>
 
+#include <stout/os/getenv.hpp>
+
 #include "event_loop.hpp"
 #include "libevent.hpp"
 
@@ -203,6 +205,13 @@ void EventLoop::initialize()
   // when the implementation settles and after we gain confidence.
   event_enable_debug_mode();
 
+  // NOTE: Unlike the libev event loop, all I/O is done on a single
+  // event base.
+  if (os::getenv("LIBPROCESS_NUM_IO_THREADS").isSome()) {
+    LOG(WARNING) << "Ignoring LIBPROCESS_NUM_IO_THREADS, which is not"
+                 << " supported by the libevent event loop";
+  }
+
   // TODO(jmlvanre): Allow support for 'epoll' once SSL related
   // issues are resolved.
   struct event_config* config = event_config_new();
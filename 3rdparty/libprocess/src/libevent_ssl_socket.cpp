@@ -25,7 +25,9 @@
 
 #include <process/ssl/flags.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/net.hpp>
+#include <stout/stringify.hpp>
 #include <stout/synchronized.hpp>
 
 #include <stout/os/close.hpp>
@@ -442,6 +444,8 @@ void LibeventSSLSocketImpl::event_callback(short events)
       return;
     }
 
+    openssl::connected_session(ssl);
+
     current_connect_request->promise.set(Nothing());
   } else if (events & BEV_EVENT_ERROR) {
     CHECK(EVUTIL_SOCKET_ERROR() != 0);
@@ -515,6 +519,8 @@ Future<Nothing> LibeventSSLSocketImpl::connect(const Address& address)
     return Failure("Failed to connect: SSL_new");
   }
 
+  openssl::resume_session(ssl, stringify(address));
+
   // Construct the bufferevent in the connecting state.
   // We set 'BEV_OPT_DEFER_CALLBACKS' to avoid calling the
   // 'event_callback' before 'bufferevent_socket_connect' returns.
@@ -718,6 +724,18 @@ Future<size_t> LibeventSSLSocketImpl::recv(char* data, size_t size)
 
 Future<size_t> LibeventSSLSocketImpl::send(const char* data, size_t size)
 {
+  return send(std::vector<Segment>({{data, size}}));
+}
+
+
+Future<size_t> LibeventSSLSocketImpl::send(
+    const std::vector<Segment>& segments)
+{
+  size_t size = 0;
+  foreach (const Segment& segment, segments) {
+    size += segment.size;
+  }
+
   // Optimistically construct a 'SendRequest' and future.
   Owned<SendRequest> request(new SendRequest(size));
   Future<size_t> future = request->promise.future();
@@ -737,10 +755,17 @@ Future<size_t> LibeventSSLSocketImpl::send(const char* data, size_t size)
     std::swap(request, send_request);
   }
 
+  // NOTE: we copy all of the segments into a single buffer so that
+  // they get written to the SSL connection together rather than
+  // requiring a round trip through the event loop for each segment.
   evbuffer* buffer = CHECK_NOTNULL(evbuffer_new());
 
-  int result = evbuffer_add(buffer, data, size);
-  CHECK_EQ(0, result);
+  foreach (const Segment& segment, segments) {
+    if (segment.size > 0) {
+      int result = evbuffer_add(buffer, segment.data, segment.size);
+      CHECK_EQ(0, result);
+    }
+  }
 
   // Extend the life-time of 'this' through the execution of the
   // lambda in the event loop. Note: The 'self' needs to be explicitly
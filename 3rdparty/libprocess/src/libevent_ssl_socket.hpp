@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 #include <process/queue.hpp>
 #include <process/socket.hpp>
@@ -45,6 +46,7 @@ public:
   // Send does not currently support discard. See implementation.
   Future<size_t> send(const char* data, size_t size) override;
   Future<size_t> sendfile(int_fd fd, off_t offset, size_t size) override;
+  Future<size_t> send(const std::vector<Segment>& segments) override;
   Try<Nothing> listen(int backlog) override;
   Future<std::shared_ptr<SocketImpl>> accept() override;
   SocketImpl::Kind kind() const override { return SocketImpl::Kind::SSL; }
@@ -0,0 +1,269 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include <glog/logging.h>
+
+#ifdef ENABLE_GPERFTOOLS
+#include <gperftools/heap-profiler.h>
+#include <gperftools/malloc_extension.h>
+#endif
+
+#include "process/future.hpp"
+#include "process/help.hpp"
+#include "process/http.hpp"
+#include "process/memory_profiler.hpp"
+
+#include "stout/format.hpp"
+#include "stout/option.hpp"
+#include "stout/os.hpp"
+
+namespace process {
+
+namespace {
+
+#ifdef ENABLE_GPERFTOOLS
+// The prefix of the heap profiles periodically dumped by the heap
+// profiler into the working directory.
+constexpr char HEAP_PROFILE_PREFIX[] = "memory-profiler";
+
+// The size of the buffer the tcmalloc statistics are written into.
+constexpr int STATISTICS_BUFFER_SIZE = 64 * 1024;
+
+
+http::Response profile(const std::string& data, const std::string& name)
+{
+  http::OK response(data);
+  response.headers["Content-Type"] = "application/octet-stream";
+  response.headers["Content-Disposition"] =
+    strings::format("attachment; filename=%s", name).get();
+
+  return response;
+}
+#else
+http::Response disabled()
+{
+  return http::BadRequest(
+      "Perftools is disabled. To enable perftools, "
+      "configure libprocess with --enable-perftools.\n");
+}
+#endif
+
+} // namespace {
+
+
+void MemoryProfiler::initialize()
+{
+  typedef Future<http::Response>(MemoryProfiler::*Handler)(
+      const http::Request&,
+      const Option<http::authentication::Principal>&);
+
+  auto add = [this](
+      const std::string& name,
+      const std::string& help,
+      Handler handler) {
+    if (authenticationRealm.isSome()) {
+      route(name, authenticationRealm.get(), help, handler);
+    } else {
+      route(name,
+            help,
+            [this, handler](const http::Request& request) {
+              return (this->*handler)(request, None());
+            });
+    }
+  };
+
+  add("/start", START_HELP(), &MemoryProfiler::start);
+  add("/stop", STOP_HELP(), &MemoryProfiler::stop);
+  add("/download/heap", DOWNLOAD_HEAP_HELP(), &MemoryProfiler::downloadHeap);
+  add("/heap_sample", HEAP_SAMPLE_HELP(), &MemoryProfiler::heapSample);
+  add("/statistics", STATISTICS_HELP(), &MemoryProfiler::statistics);
+}
+
+
+const std::string MemoryProfiler::START_HELP()
+{
+  return HELP(
+    TLDR(
+        "Starts the heap profiler."),
+    DESCRIPTION(
+        "Starts the tcmalloc heap profiler, which records the call",
+        "sites of all allocations until it is stopped. This slows",
+        "down allocations, hence libprocess must be started with",
+        "LIBPROCESS_ENABLE_PROFILER=1 in the environment."),
+    AUTHENTICATION(true));
+}
+
+
+const std::string MemoryProfiler::STOP_HELP()
+{
+  return HELP(
+    TLDR(
+        "Stops the heap profiler."),
+    DESCRIPTION(
+        "Stops the tcmalloc heap profiler and returns the heap profile",
+        "in the format understood by pprof."),
+    AUTHENTICATION(true));
+}
+
+
+const std::string MemoryProfiler::DOWNLOAD_HEAP_HELP()
+{
+  return HELP(
+    TLDR(
+        "Returns the current heap profile."),
+    DESCRIPTION(
+        "Returns the heap profile recorded so far by the running heap",
+        "profiler in the format understood by pprof."),
+    AUTHENTICATION(true));
+}
+
+
+const std::string MemoryProfiler::HEAP_SAMPLE_HELP()
+{
+  return HELP(
+    TLDR(
+        "Returns a sample of the live heap allocations."),
+    DESCRIPTION(
+        "Returns the call sites of a sample of the live heap",
+        "allocations in the format understood by pprof. This does not",
+        "need the heap profiler to be running, but sampling must be",
+        "enabled with TCMALLOC_SAMPLE_PARAMETER in the environment",
+        "(e.g., 524288 to sample an allocation every 512KB)."),
+    AUTHENTICATION(true));
+}
+
+
+const std::string MemoryProfiler::STATISTICS_HELP()
+{
+  return HELP(
+    TLDR(
+        "Returns the tcmalloc statistics."),
+    DESCRIPTION(
+        "Returns the human readable statistics of tcmalloc, e.g., the",
+        "memory in use by the application and held in its caches."),
+    AUTHENTICATION(true));
+}
+
+
+Future<http::Response> MemoryProfiler::start(
+    const http::Request& request,
+    const Option<http::authentication::Principal>&)
+{
+#ifdef ENABLE_GPERFTOOLS
+  const Option<std::string>
+    enableProfiler = os::getenv("LIBPROCESS_ENABLE_PROFILER");
+  if (enableProfiler.isNone() || enableProfiler.get() != "1") {
+    return http::BadRequest(
+        "The profiler is not enabled. To enable the profiler, libprocess "
+        "must be started with LIBPROCESS_ENABLE_PROFILER=1 in the "
+        "environment.\n");
+  }
+
+  if (IsHeapProfilerRunning()) {
+    return http::BadRequest("Heap profiler already started.\n");
+  }
+
+  LOG(INFO) << "Starting heap profiler";
+
+  HeapProfilerStart(HEAP_PROFILE_PREFIX);
+
+  return http::OK("Heap profiler started.\n");
+#else
+  return disabled();
+#endif
+}
+
+
+Future<http::Response> MemoryProfiler::stop(
+    const http::Request& request,
+    const Option<http::authentication::Principal>&)
+{
+#ifdef ENABLE_GPERFTOOLS
+  if (!IsHeapProfilerRunning()) {
+    return http::BadRequest("Heap profiler not running.\n");
+  }
+
+  LOG(INFO) << "Stopping heap profiler";
+
+  // NOTE: The profile can only be retrieved while the heap profiler
+  // is running. It is allocated with `malloc` and owned by the caller.
+  char* heap = GetHeapProfile();
+  const std::string result = heap != nullptr ? heap : "";
+  free(heap);
+
+  HeapProfilerStop();
+
+  return profile(result, "heap.prof");
+#else
+  return disabled();
+#endif
+}
+
+
+Future<http::Response> MemoryProfiler::downloadHeap(
+    const http::Request& request,
+    const Option<http::authentication::Principal>&)
+{
+#ifdef ENABLE_GPERFTOOLS
+  if (!IsHeapProfilerRunning()) {
+    return http::BadRequest("Heap profiler not running.\n");
+  }
+
+  char* heap = GetHeapProfile();
+  const std::string result = heap != nullptr ? heap : "";
+  free(heap);
+
+  return profile(result, "heap.prof");
+#else
+  return disabled();
+#endif
+}
+
+
+Future<http::Response> MemoryProfiler::heapSample(
+    const http::Request& request,
+    const Option<http::authentication::Principal>&)
+{
+#ifdef ENABLE_GPERFTOOLS
+  std::string sample;
+  MallocExtension::instance()->GetHeapSample(&sample);
+
+  return profile(sample, "heap_sample.prof");
+#else
+  return disabled();
+#endif
+}
+
+
+Future<http::Response> MemoryProfiler::statistics(
+    const http::Request& request,
+    const Option<http::authentication::Principal>&)
+{
+#ifdef ENABLE_GPERFTOOLS
+  std::string buffer(STATISTICS_BUFFER_SIZE, '\0');
+  MallocExtension::instance()->GetStats(&buffer[0], STATISTICS_BUFFER_SIZE);
+
+  // `GetStats` writes a null-terminated string into the buffer.
+  buffer.resize(::strlen(buffer.data()));
+
+  return http::OK(buffer);
+#else
+  return disabled();
+#endif
+}
+
+} // namespace process {
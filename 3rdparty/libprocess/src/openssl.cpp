@@ -21,6 +21,7 @@
 #include <openssl/ssl.h>
 #include <openssl/x509v3.h>
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <string>
@@ -28,10 +29,15 @@
 
 #include <process/once.hpp>
 
+#include <process/metrics/gauge.hpp>
+#include <process/metrics/metrics.hpp>
+
 #include <process/ssl/flags.hpp>
 
+#include <stout/hashmap.hpp>
 #include <stout/os.hpp>
 #include <stout/strings.hpp>
+#include <stout/synchronized.hpp>
 
 #ifdef __WINDOWS__
 // OpenSSL on Windows requires this adapter module to be compiled as part of the
@@ -159,6 +165,20 @@ Flags::Flags()
       "enable_tls_v1_2",
       "Enable SSLV1.2.",
       true);
+
+  add(&Flags::enable_session_resumption,
+      "enable_session_resumption",
+      "Enable resuming TLS sessions, which saves reconnecting peers the "
+      "cost of a full handshake. Accepted sessions can be resumed by "
+      "session ID or session ticket, and the sessions of outgoing "
+      "connections are cached per peer address for later connections.",
+      false);
+
+  add(&Flags::session_cache_size,
+      "session_cache_size",
+      "Maximum number of TLS sessions cached for accepted connections, "
+      "and for outgoing connections, when session resumption is enabled.",
+      SSL_SESSION_CACHE_MAX_SIZE_DEFAULT);
 }
 
 
@@ -177,6 +197,25 @@ const Flags& flags()
 static std::mutex* mutexes = nullptr;
 
 
+// The sessions of outgoing connections, keyed by the address of the
+// peer, in order to resume them when connecting to the peer again.
+// NOTE: These are intentionally leaked to avoid destruction order
+// issues with sockets that are still connecting.
+static std::mutex* sessions_mutex = new std::mutex();
+static hashmap<string, SSL_SESSION*>* sessions =
+  new hashmap<string, SSL_SESSION*>();
+
+// The number of outgoing connections, and how many of them resumed a
+// cached session. The numbers for accepted connections are kept by
+// OpenSSL as part of the context.
+static std::atomic<uint64_t> connected(0);
+static std::atomic<uint64_t> connected_resumed(0);
+
+// The index of the peer address stored with each connecting SSL
+// connection, see 'resume_session' and 'new_session_callback'.
+static int peer_index = -1;
+
+
 // Callback needed to perform locking on shared data structures. From
 // the OpenSSL documentation:
 //
@@ -286,6 +325,60 @@ int verify_callback(int ok, X509_STORE_CTX* store)
 }
 
 
+// Frees the peer address stored with an SSL connection.
+void free_peer(
+    void* /*parent*/,
+    void* peer,
+    CRYPTO_EX_DATA* /*data*/,
+    int /*index*/,
+    long /*argl*/,
+    void* /*argp*/)
+{
+  delete static_cast<string*>(peer);
+}
+
+
+// Callback for OpenSSL whenever a session is established, or a
+// session ticket is received, which caches the sessions of outgoing
+// connections. With TLS 1.3 the session tickets are only received
+// after the handshake, which is why we can't cache the session when
+// the connection is established.
+int new_session_callback(SSL* ssl, SSL_SESSION* session)
+{
+  if (SSL_is_server(ssl)) {
+    return 0;
+  }
+
+  const string* peer =
+    static_cast<const string*>(SSL_get_ex_data(ssl, peer_index));
+
+  if (peer == nullptr) {
+    return 0;
+  }
+
+  synchronized (sessions_mutex) {
+    auto cached = sessions->find(*peer);
+    if (cached != sessions->end()) {
+      SSL_SESSION_free(cached->second);
+      cached->second = session;
+      return 1;
+    }
+
+    // Make room by evicting an arbitrary session.
+    if (sessions->size() >= ssl_flags->session_cache_size &&
+        !sessions->empty()) {
+      SSL_SESSION_free(sessions->begin()->second);
+      sessions->erase(sessions->begin());
+    }
+
+    sessions->put(*peer, session);
+  }
+
+  // Returning 1 takes the reference on the session.
+  return 1;
+}
+
+
 string error_string(unsigned long code)
 {
   // SSL library guarantees to stay within 120 bytes.
@@ -463,12 +556,38 @@ void reinitialize()
   CHECK(ctx) << "Failed to create SSL context: "
              << ERR_error_string(ERR_get_error(), nullptr);
 
-  // Disable SSL session caching.
-  SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+  // The cached sessions of outgoing connections belong to the
+  // previous context.
+  synchronized (sessions_mutex) {
+    foreachvalue (SSL_SESSION* session, *sessions) {
+      SSL_SESSION_free(session);
+    }
+    sessions->clear();
+  }
+
+  if (ssl_flags->enable_session_resumption) {
+    if (peer_index < 0) {
+      peer_index =
+        SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, &free_peer);
+    }
+
+    // Cache the sessions of accepted connections so that they can be
+    // resumed by session ID. Resuming by session ticket, which doesn't
+    // need the cache, is enabled by default. The sessions of outgoing
+    // connections are cached by 'new_session_callback' instead.
+    SSL_CTX_set_session_cache_mode(
+        ctx,
+        SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_CLIENT);
+    SSL_CTX_sess_set_cache_size(ctx, ssl_flags->session_cache_size);
+    SSL_CTX_sess_set_new_cb(ctx, &new_session_callback);
+  } else {
+    // Disable SSL session caching.
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+  }
 
   // Set a session id to avoid connection termination upon
-  // re-connect. We can use something more relevant when we care
-  // about session caching.
+  // re-connect. Sessions can only be resumed within the same
+  // context, so any constant will do.
   const uint64_t session_ctx = 7;
 
   const unsigned char* session_id =
@@ -711,6 +830,74 @@ SSL_CTX* context()
 }
 
 
+void resume_session(SSL* ssl, const string& peer)
+{
+  if (!ssl_flags->enable_session_resumption) {
+    return;
+  }
+
+  // Remember the peer in order to cache the session once it has been
+  // established, see 'new_session_callback'.
+  SSL_set_ex_data(ssl, peer_index, new string(peer));
+
+  synchronized (sessions_mutex) {
+    auto session = sessions->find(peer);
+    if (session != sessions->end()) {
+      // NOTE: This takes a reference on the session.
+      SSL_set_session(ssl, session->second);
+    }
+  }
+}
+
+
+void connected_session(SSL* ssl)
+{
+  ++connected;
+
+  if (SSL_session_reused(ssl)) {
+    ++connected_resumed;
+  }
+}
+
+
+void add_metrics()
+{
+  static Once* added = new Once();
+
+  if (added->once()) {
+    return;
+  }
+
+  // NOTE: The gauges are intentionally leaked, like the metrics of
+  // the other global libprocess processes.
+  auto gauge = [](const string& name, const std::function<double()>& f) {
+    metrics::Gauge* gauge = new metrics::Gauge(
+        "ssl/sessions/" + name,
+        [f]() -> Future<double> { return f(); });
+
+    metrics::add(*gauge);
+  };
+
+  gauge("accepted", []() {
+    return ctx == nullptr ? 0 : SSL_CTX_sess_accept_good(ctx);
+  });
+
+  gauge("accepted_resumed", []() {
+    return ctx == nullptr ? 0 : SSL_CTX_sess_hits(ctx);
+  });
+
+  gauge("connected", []() {
+    return static_cast<double>(connected.load());
+  });
+
+  gauge("connected_resumed", []() {
+    return static_cast<double>(connected_resumed.load());
+  });
+
+  added->done();
+}
+
+
 Try<Nothing> verify(
     const SSL* const ssl,
     const Option<string>& hostname,
@@ -52,6 +52,8 @@ namespace openssl {
 //    LIBPROCESS_SSL_ENABLE_TLS_V1_1=(false|0,true|1)
 //    LIBPROCESS_SSL_ENABLE_TLS_V1_2=(false|0,true|1)
 //    LIBPROCESS_SSL_ECDH_CURVES=(auto|list of curves separated by ':')
+//    LIBPROCESS_SSL_ENABLE_SESSION_RESUMPTION=(false|0,true|1)
+//    LIBPROCESS_SSL_SESSION_CACHE_SIZE=(number of sessions)
 //
 // TODO(benh): When/If we need to support multiple contexts in the
 // same process, for example for Server Name Indication (SNI), then
@@ -63,6 +65,24 @@ void initialize();
 // Returns the _global_ OpenSSL context.
 SSL_CTX* context();
 
+// Sets the cached session of the peer, if any, on a connecting SSL
+// connection so that the session gets resumed. The session of the
+// connection gets cached for the next connection to the peer. The
+// peer is an address as returned by `stringify`.
+void resume_session(SSL* ssl, const std::string& peer);
+
+// Accounts for an established outgoing SSL connection in the metrics
+// (see `add_metrics`).
+void connected_session(SSL* ssl);
+
+// Adds the gauges for the TLS session resumption statistics:
+//
+//    ssl/sessions/accepted
+//    ssl/sessions/accepted_resumed
+//    ssl/sessions/connected
+//    ssl/sessions/connected_resumed
+void add_metrics();
+
 // Verify that the hostname is properly associated with the peer
 // certificate associated with the specified SSL connection.
 Try<Nothing> verify(
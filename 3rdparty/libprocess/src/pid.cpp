@@ -36,24 +36,90 @@
 
 using std::ios_base;
 using std::istream;
-using std::istringstream;
 using std::ostream;
 using std::ostringstream;
 using std::string;
 
 namespace process {
 
+// Parses the 'id@ip:port' at the start of `s`, after any whitespace
+// and up to the next whitespace, like extracting a string from a
+// stream would. Returns false if it is malformed, in which case the
+// UPID is left empty.
+//
+// NOTE: This avoids going through a stream since the UPID of the
+// sender gets parsed for every message received from a peer.
+static bool parse(const string& s, UPID* pid)
+{
+  pid->id = "";
+  pid->address.ip = net::IP(INADDR_ANY);
+  pid->address.port = 0;
+
+  const char* whitespace = " \t\n\v\f\r";
+
+  const size_t start = s.find_first_not_of(whitespace);
+  if (start == string::npos) {
+    return false;
+  }
+
+  size_t end = s.find_first_of(whitespace, start);
+  if (end == string::npos) {
+    end = s.size();
+  }
+
+  VLOG(3) << "Attempting to parse '" << s.substr(start, end - start)
+          << "' into a PID";
+
+  const size_t at = s.find('@', start);
+  if (at == string::npos || at >= end) {
+    return false;
+  }
+
+  const size_t colon = s.find(':', at + 1);
+  if (colon == string::npos || colon >= end) {
+    return false;
+  }
+
+  const string host = s.substr(at + 1, colon - at - 1);
+
+  // Most peers announce an IP address rather than a hostname, which
+  // does not need to go through the resolver.
+  //
+  // TODO(evelinad): Extend this to support IPv6.
+  Try<net::IP> ip = net::IP::parse(host, AF_INET);
+  if (ip.isError()) {
+    ip = net::getIP(host, AF_INET);
+  }
+
+  if (ip.isError()) {
+    VLOG(2) << ip.error();
+    return false;
+  }
+
+  uint16_t port;
+  if (sscanf(s.substr(colon + 1, end - colon - 1).c_str(), "%hu", &port) != 1) {
+    return false;
+  }
+
+  pid->id = s.substr(start, at - start);
+  pid->address.ip = ip.get();
+  pid->address.port = port;
+
+  pid->resolve();
+
+  return true;
+}
+
+
 UPID::UPID(const char* s)
 {
-  istringstream in(s);
-  in >> *this;
+  parse(s, this);
 }
 
 
 UPID::UPID(const string& s)
 {
-  istringstream in(s);
-  in >> *this;
+  parse(s, this);
 }
 
 
@@ -78,70 +144,11 @@ ostream& operator<<(ostream& stream, const UPID& pid)
 
 istream& operator>>(istream& stream, UPID& pid)
 {
-  pid.id = "";
-  pid.address.ip = net::IP(INADDR_ANY);
-  pid.address.port = 0;
-
   string str;
-  if (!(stream >> str)) {
-    stream.setstate(ios_base::badbit);
-    return stream;
-  }
-
-  VLOG(3) << "Attempting to parse '" << str << "' into a PID";
-
-  if (str.size() == 0) {
-    stream.setstate(ios_base::badbit);
-    return stream;
-  }
-
-  string id;
-  string host;
-  network::inet::Address address = network::inet4::Address::ANY_ANY();
-
-  size_t index = str.find('@');
-
-  if (index != string::npos) {
-    id = str.substr(0, index);
-  } else {
-    stream.setstate(ios_base::badbit);
-    return stream;
-  }
-
-  str = str.substr(index + 1);
-
-  index = str.find(':');
-
-  if (index != string::npos) {
-    host = str.substr(0, index);
-  } else {
+  if (!(stream >> str) || !parse(str, &pid)) {
     stream.setstate(ios_base::badbit);
-    return stream;
   }
 
-  // TODO(evelinad): Extend this to support IPv6.
-  Try<net::IP> ip = net::getIP(host, AF_INET);
-
-  if (ip.isError()) {
-    VLOG(2) << ip.error();
-    stream.setstate(ios_base::badbit);
-    return stream;
-  }
-
-  address.ip = ip.get();
-
-  str = str.substr(index + 1);
-
-  if (sscanf(str.c_str(), "%hu", &address.port) != 1) {
-    stream.setstate(ios_base::badbit);
-    return stream;
-  }
-
-  pid.id = std::move(id);
-  pid.address = address;
-
-  pid.resolve();
-
   return stream;
 }
 
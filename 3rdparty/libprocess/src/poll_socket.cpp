@@ -14,14 +14,21 @@
 #ifdef __WINDOWS__
 #include <stout/windows.hpp>
 #else
+#include <limits.h>
 #include <netinet/tcp.h>
+#include <string.h>
+#include <sys/uio.h>
 #endif // __WINDOWS__
 
+#include <algorithm>
+#include <vector>
+
 #include <process/io.hpp>
 #include <process/loop.hpp>
 #include <process/network.hpp>
 #include <process/socket.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/os/sendfile.hpp>
 #include <stout/os/strerror.hpp>
 #include <stout/os.hpp>
@@ -57,59 +64,110 @@ Future<std::shared_ptr<SocketImpl>> PollSocketImpl::accept()
   // `io::poll` and end up accepting a socket incorrectly.
   auto self = shared(this);
 
-  return io::poll(get(), io::READ)
-    .then([self]() -> Future<std::shared_ptr<SocketImpl>> {
-      Try<int_fd> accepted = network::accept(self->get());
-      if (accepted.isError()) {
-        return Failure(accepted.error());
-      }
-
-      int_fd s = accepted.get();
-      Try<Nothing> nonblock = os::nonblock(s);
-      if (nonblock.isError()) {
-        os::close(s);
-        return Failure("Failed to accept, nonblock: " + nonblock.error());
-      }
-
-      Try<Nothing> cloexec = os::cloexec(s);
-      if (cloexec.isError()) {
-        os::close(s);
-        return Failure("Failed to accept, cloexec: " + cloexec.error());
-      }
-
-      Try<Address> address = network::address(s);
-      if (address.isError()) {
-        os::close(s);
-        return Failure("Failed to get address: " + address.error());
-      }
-
-      // Turn off Nagle (TCP_NODELAY) so pipelined requests don't wait.
-      // NOTE: We cast to `char*` here because the function prototypes
-      // on Windows use `char*` instead of `void*`.
-      if (address->family() == Address::Family::INET4 ||
-          address->family() == Address::Family::INET6) {
-        int on = 1;
-        if (::setsockopt(
-                s,
-                SOL_TCP,
-                TCP_NODELAY,
-                reinterpret_cast<const char*>(&on),
-                sizeof(on)) < 0) {
-          const string error = os::strerror(errno);
-          os::close(s);
-          return Failure(
-              "Failed to turn off the Nagle algorithm: " + stringify(error));
+  // Because the listening socket is non-blocking, we try to accept
+  // immediately and only poll if there are no pending connections.
+  // When many peers connect at once this accepts the backlog without
+  // a trip through the event loop per connection.
+  return loop(
+      None(),
+      [self]() -> Future<Option<std::shared_ptr<SocketImpl>>> {
+        return self->_accept();
+      },
+      [self](const Option<std::shared_ptr<SocketImpl>>& impl)
+          -> Future<ControlFlow<std::shared_ptr<SocketImpl>>> {
+        // Retry after we've polled if there was nothing to accept.
+        if (impl.isNone()) {
+          return io::poll(self->get(), io::READ)
+            .then([]() -> ControlFlow<std::shared_ptr<SocketImpl>> {
+              return Continue();
+            });
         }
-      }
+        return Break(impl.get());
+      });
+}
 
-      Try<std::shared_ptr<SocketImpl>> impl = create(s);
-      if (impl.isError()) {
-        os::close(s);
-        return Failure("Failed to create socket: " + impl.error());
-      }
 
-      return impl.get();
-    });
+Try<Option<std::shared_ptr<SocketImpl>>> PollSocketImpl::_accept()
+{
+  sockaddr_storage storage;
+  socklen_t length = sizeof(storage);
+
+  int_fd s;
+
+  while (true) {
+#ifdef __linux__
+    // Save the system calls for making the socket non-blocking and
+    // close-on-exec below.
+    s = ::accept4(
+        get(),
+        reinterpret_cast<sockaddr*>(&storage),
+        &length,
+        SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+    s = net::accept(get(), reinterpret_cast<sockaddr*>(&storage), &length);
+#endif // __linux__
+
+    if (s >= 0) {
+      break;
+    }
+
+#ifdef __WINDOWS__
+    int error = WSAGetLastError();
+#else
+    int error = errno;
+#endif // __WINDOWS__
+
+    if (net::is_restartable_error(error)) {
+      // Interrupted, try again now.
+      continue;
+    } else if (net::is_retryable_error(error)) {
+      return None();
+    }
+
+    return Error("Failed to accept: " + os::strerror(error));
+  }
+
+#ifndef __linux__
+  Try<Nothing> nonblock = os::nonblock(s);
+  if (nonblock.isError()) {
+    os::close(s);
+    return Error("Failed to accept, nonblock: " + nonblock.error());
+  }
+
+  Try<Nothing> cloexec = os::cloexec(s);
+  if (cloexec.isError()) {
+    os::close(s);
+    return Error("Failed to accept, cloexec: " + cloexec.error());
+  }
+#endif // __linux__
+
+  // Turn off Nagle (TCP_NODELAY) so pipelined requests don't wait.
+  // NOTE: The peer address returned by `accept` has the same family as
+  // the accepted socket.
+  // NOTE: We cast to `char*` here because the function prototypes on
+  // Windows use `char*` instead of `void*`.
+  if (storage.ss_family == AF_INET || storage.ss_family == AF_INET6) {
+    int on = 1;
+    if (::setsockopt(
+            s,
+            SOL_TCP,
+            TCP_NODELAY,
+            reinterpret_cast<const char*>(&on),
+            sizeof(on)) < 0) {
+      const string error = os::strerror(errno);
+      os::close(s);
+      return Error(
+          "Failed to turn off the Nagle algorithm: " + stringify(error));
+    }
+  }
+
+  Try<std::shared_ptr<SocketImpl>> impl = create(s);
+  if (impl.isError()) {
+    os::close(s);
+    return Error("Failed to create socket: " + impl.error());
+  }
+
+  return impl.get();
 }
 
 
@@ -226,6 +284,82 @@ Future<size_t> PollSocketImpl::send(const char* data, size_t size)
 }
 
 
+Future<size_t> PollSocketImpl::send(const std::vector<Segment>& segments)
+{
+#ifdef __WINDOWS__
+  // TODO(benh): Use `WSASend` to do gather writes on Windows.
+  return SocketImpl::send(segments);
+#else
+  // Build the `iovec`s once rather than on every attempt below.
+  std::vector<struct iovec> iov;
+  iov.reserve(std::min<size_t>(segments.size(), IOV_MAX));
+
+  foreach (const Segment& segment, segments) {
+    if (iov.size() == IOV_MAX) {
+      break;
+    }
+
+    if (segment.size > 0) {
+      struct iovec vec;
+      vec.iov_base = const_cast<char*>(segment.data);
+      vec.iov_len = segment.size;
+      iov.push_back(vec);
+    }
+  }
+
+  if (iov.empty()) {
+    return 0;
+  }
+
+  // Need to hold a copy of `this` so that the underlying socket
+  // doesn't end up getting reused before we return.
+  auto self = shared(this);
+
+  // NOTE: we use `sendmsg` rather than `writev` so that we can pass
+  // `MSG_NOSIGNAL` just like `send` above.
+  return loop(
+      None(),
+      [self, iov]() mutable -> Future<Option<size_t>> {
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = iov.data();
+        message.msg_iovlen = iov.size();
+
+        while (true) {
+          ssize_t length = ::sendmsg(self->get(), &message, MSG_NOSIGNAL);
+
+          if (length < 0) {
+            int error = errno;
+
+            if (net::is_restartable_error(error)) {
+              // Interrupted, try again now.
+              continue;
+            } else if (!net::is_retryable_error(error)) {
+              VLOG(1) << "Socket error while sending: " << os::strerror(error);
+              return Failure(os::strerror(error));
+            }
+
+            return None();
+          }
+
+          return length;
+        }
+      },
+      [self](const Option<size_t>& length) -> Future<ControlFlow<size_t>> {
+        // Retry after we've polled if we don't yet have a result.
+        if (length.isNone()) {
+          return io::poll(self->get(), io::WRITE)
+            .then([](short event) -> ControlFlow<size_t> {
+              CHECK_EQ(io::WRITE, event);
+              return Continue();
+            });
+        }
+        return Break(length.get());
+      });
+#endif // __WINDOWS__
+}
+
+
 Future<size_t> PollSocketImpl::sendfile(int_fd fd, off_t offset, size_t size)
 {
   CHECK(size > 0); // TODO(benh): Just return 0 if `size` is 0?
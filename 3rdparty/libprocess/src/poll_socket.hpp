@@ -11,9 +11,11 @@
 // limitations under the License
 
 #include <memory>
+#include <vector>
 
 #include <process/socket.hpp>
 
+#include <stout/option.hpp>
 #include <stout/try.hpp>
 
 namespace process {
@@ -36,7 +38,12 @@ public:
   virtual Future<size_t> recv(char* data, size_t size);
   virtual Future<size_t> send(const char* data, size_t size);
   virtual Future<size_t> sendfile(int_fd fd, off_t offset, size_t size);
+  virtual Future<size_t> send(const std::vector<Segment>& segments);
   virtual Kind kind() const { return SocketImpl::Kind::POLL; }
+
+private:
+  // Accepts a pending connection, if any, without blocking.
+  Try<Option<std::shared_ptr<SocketImpl>>> _accept();
 };
 
 } // namespace internal {
@@ -27,6 +27,11 @@
 #include <arpa/inet.h>
 #endif // __WINDOWS__
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif // __linux__
+
 #include <glog/logging.h>
 
 #ifndef __WINDOWS__
@@ -73,6 +78,7 @@
 #include <process/id.hpp>
 #include <process/io.hpp>
 #include <process/logging.hpp>
+#include <process/memory_profiler.hpp>
 #include <process/mime.hpp>
 #include <process/owned.hpp>
 #include <process/process.hpp>
@@ -85,6 +91,7 @@
 #include <process/time.hpp>
 #include <process/timer.hpp>
 
+#include <process/metrics/gauge.hpp>
 #include <process/metrics/metrics.hpp>
 
 #include <process/ssl/flags.hpp>
@@ -93,6 +100,7 @@
 #include <process/windows/jobobject.hpp>
 #endif // __WINDOWS__
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/flags.hpp>
 #include <stout/foreach.hpp>
@@ -118,6 +126,11 @@
 #include "process_reference.hpp"
 #include "socket_manager.hpp"
 #include "run_queue.hpp"
+#include "tracer.hpp"
+
+#ifdef USE_SSL_SOCKET
+#include "openssl.hpp"
+#endif // USE_SSL_SOCKET
 
 namespace inet = process::network::inet;
 namespace inet4 = process::network::inet4;
@@ -164,6 +177,40 @@ namespace process {
 
 namespace internal {
 
+// Parses a list of CPUs and CPU ranges, e.g., "0-7,16-23", as taken by
+// `LIBPROCESS_WORKER_CPUS`.
+static Try<set<unsigned int>> parse_cpus(const string& value)
+{
+  set<unsigned int> cpus;
+
+  foreach (const string& token, strings::tokenize(value, ",")) {
+    const vector<string> range = strings::split(token, "-");
+    if (range.size() > 2) {
+      return Error("Invalid CPU range '" + token + "'");
+    }
+
+    Try<unsigned int> first = numify<unsigned int>(strings::trim(range[0]));
+    Try<unsigned int> last = range.size() == 1
+      ? first
+      : numify<unsigned int>(strings::trim(range[1]));
+
+    if (first.isError() || last.isError() || first.get() > last.get()) {
+      return Error("Invalid CPU range '" + token + "'");
+    }
+
+    for (unsigned int cpu = first.get(); cpu <= last.get(); ++cpu) {
+      cpus.insert(cpu);
+    }
+  }
+
+  if (cpus.empty()) {
+    return Error("No CPUs specified");
+  }
+
+  return cpus;
+}
+
+
 // These are environment variables expected in `process::initialize`.
 // All these flags should be loaded with the prefix "LIBPROCESS_".
 struct Flags : public virtual flags::FlagsBase
@@ -246,6 +293,89 @@ struct Flags : public virtual flags::FlagsBase
         "libprocess is listening may not match the address from\n"
         "which libprocess connects to other actors.\n",
         false);
+
+    add(&Flags::http_pipeline_window,
+        "http_pipeline_window",
+        "If set, the maximum number of pipelined HTTP requests that are\n"
+        "handled concurrently per connection. Further requests are not\n"
+        "read off the connection until responses have been sent.",
+        [](const Option<size_t>& value) -> Option<Error> {
+          if (value.isSome() && value.get() == 0) {
+            return Error("LIBPROCESS_HTTP_PIPELINE_WINDOW must be positive");
+          }
+          return None();
+        });
+
+    add(&Flags::http_compression_level,
+        "http_compression_level",
+        "The gzip compression level of HTTP responses sent to clients that\n"
+        "accept gzip, from 1 (fastest) to 9 (best compression), or -1 for\n"
+        "the zlib default. Setting it to 0 disables compression.",
+        Z_DEFAULT_COMPRESSION,
+        [](int value) -> Option<Error> {
+          if (value < Z_DEFAULT_COMPRESSION || value > Z_BEST_COMPRESSION) {
+            return Error(
+                "LIBPROCESS_HTTP_COMPRESSION_LEVEL must be within [-1, 9]");
+          }
+          return None();
+        });
+
+    add(&Flags::http_compression_minimum_length,
+        "http_compression_minimum_length",
+        "The minimum length of an HTTP response body for it to get\n"
+        "compressed. Streamed responses are compressed regardless.",
+        Bytes(GZIP_MINIMUM_BODY_LENGTH));
+
+    add(&Flags::trace_capacity,
+        "trace_capacity",
+        "If set, the number of the most recently served events and sent\n"
+        "messages that are recorded, along with timing information and an\n"
+        "ID correlating them across processes. The records are served in\n"
+        "the Chrome trace event format at '/__trace__'.",
+        [](const Option<size_t>& value) -> Option<Error> {
+          if (value.isSome() && value.get() == 0) {
+            return Error("LIBPROCESS_TRACE_CAPACITY must be positive");
+          }
+          return None();
+        });
+
+    add(&Flags::lightweight,
+        "lightweight",
+        "If set, libprocess initializes a minimal runtime, meant for\n"
+        "executors and helper binaries which only run a few actors: it\n"
+        "defaults to 2 worker threads (unless LIBPROCESS_NUM_WORKER_THREADS\n"
+        "is set), and does not start the profiler and the system\n"
+        "statistics processes.",
+        false);
+
+    add(&Flags::worker_cpus,
+        "worker_cpus",
+        "If set, the list of CPUs and CPU ranges (e.g., '0-7,16-23') to\n"
+        "which the worker threads and the event loop thread are pinned.\n"
+        "On multi-socket hosts, pinning to the CPUs of a single NUMA node\n"
+        "avoids cross-socket cache traffic and, since memory is allocated\n"
+        "on the node of the thread first touching it, keeps the heap\n"
+        "local to the node. Only supported on Linux.",
+        [](const Option<string>& value) -> Option<Error> {
+          if (value.isSome()) {
+#ifndef __linux__
+            return Error("LIBPROCESS_WORKER_CPUS is only supported on Linux");
+#else
+            Try<set<unsigned int>> cpus = parse_cpus(value.get());
+            if (cpus.isError()) {
+              return Error(
+                  "Invalid LIBPROCESS_WORKER_CPUS: " + cpus.error());
+            }
+
+            if (*cpus->rbegin() >= static_cast<unsigned int>(CPU_SETSIZE)) {
+              return Error(
+                  "LIBPROCESS_WORKER_CPUS must only contain CPUs below " +
+                  stringify(CPU_SETSIZE));
+            }
+#endif // __linux__
+          }
+          return None();
+        });
   }
 
   Option<net::IP> ip;
@@ -254,6 +384,12 @@ struct Flags : public virtual flags::FlagsBase
   Option<int> port;
   Option<int> advertise_port;
   bool require_peer_address_ip_match;
+  Option<size_t> http_pipeline_window;
+  int http_compression_level;
+  Bytes http_compression_minimum_length;
+  Option<size_t> trace_capacity;
+  bool lightweight;
+  Option<string> worker_cpus;
 };
 
 } // namespace internal {
@@ -348,8 +484,11 @@ public:
   void finalize();
 
   // Initializes the processing threads and the event loop thread,
-  // and returns the number of processing threads created.
-  long init_threads();
+  // optionally pinned to the given CPUs, and returns the number of
+  // processing threads created.
+  long init_threads(
+      bool lightweight,
+      const Option<set<unsigned int>>& cpus = None());
 
   ProcessReference use(const UPID& pid);
 
@@ -410,6 +549,13 @@ public:
     return threads.size() - 1; // Less 1 for event loop thread.
   }
 
+  // Returns the total time the worker thread spent serving events.
+  Duration served(long worker) const
+  {
+    CHECK_LT(worker, workers());
+    return Nanoseconds(worker_served_ns[worker].load());
+  }
+
 private:
   // Delegate process name to receive root HTTP requests.
   const Option<string> delegate;
@@ -430,6 +576,10 @@ private:
   // Stores the thread handles so that we can join during shutdown.
   vector<std::thread*> threads;
 
+  // The time spent serving events by each worker thread, see
+  // `_worker_served_ns_`.
+  std::unique_ptr<std::atomic<int64_t>[]> worker_served_ns;
+
   // Boolean used to signal processing threads to stop running.
   std::atomic_bool joining_threads;
 
@@ -452,11 +602,21 @@ private:
 
 static internal::Flags* libprocess_flags = new internal::Flags();
 
+int http_compression_level = Z_DEFAULT_COMPRESSION;
+size_t http_compression_minimum_length = GZIP_MINIMUM_BODY_LENGTH;
+
 // Synchronization primitives for `initialize`.
 // See documentation in `initialize` for how they are used.
 static std::atomic_bool initialize_started(false);
 static std::atomic_bool initialize_complete(false);
 
+// The number of events served by all processes, along with the total
+// time spent serving them and the total time they waited in the event
+// queues (see `ProcessManager::resume`).
+static std::atomic<uint64_t> events_served(0);
+static std::atomic<int64_t> events_served_ns(0);
+static std::atomic<int64_t> events_queued_ns(0);
+
 // Server socket listen backlog.
 static const int LISTEN_BACKLOG = 500000;
 
@@ -496,6 +656,15 @@ static AuthorizationCallbacks* authorization_callbacks = nullptr;
 // Global route that returns process information.
 static Route* processes_route = nullptr;
 
+// Records the events served by processes if tracing is enabled (see
+// 'LIBPROCESS_TRACE_CAPACITY'), along with the route to dump them.
+static Tracer* tracer = nullptr;
+static Route* trace_route = nullptr;
+
+// Per-thread ID of the trace of the event being served, which the
+// events enqueued while serving it inherit.
+thread_local uint64_t _trace_ = 0;
+
 // Global help.
 PID<Help> help;
 
@@ -508,6 +677,19 @@ thread_local ProcessBase* __process__ = nullptr;
 // Per-thread executor pointer.
 thread_local Executor* _executor_ = nullptr;
 
+// Per-thread pointer to the time spent serving events by the worker
+// thread, used for the 'libprocess/workers/<i>/events_served_secs'
+// gauges. Not set for threads other than the worker threads.
+thread_local std::atomic<int64_t>* _worker_served_ns_ = nullptr;
+
+// Per-thread copy of the UPID, including its reference, of the last
+// local process found by `ProcessManager::use` for a UPID without a
+// reference (e.g., the UPIDs parsed from the messages received from
+// remote peers), so that looking up the same process again does not
+// need the `processes_mutex`. Never deleted since threads can exit
+// at any time.
+thread_local UPID* _resolved_ = nullptr;
+
 namespace metrics {
 namespace internal {
 
@@ -598,6 +780,28 @@ static Message encode(
 }
 
 
+// Records a message sent to a remote process, if tracing is enabled.
+static void trace(const string& name, ProcessBase* sender)
+{
+  if (tracer == nullptr) {
+    return;
+  }
+
+  Tracer::Record record;
+  record.phase = 'i';
+  record.category = "SEND";
+  record.name = name;
+  if (sender != nullptr) {
+    record.process = sender->self().id;
+  }
+  record.trace = _trace_ != 0 ? _trace_ : tracer->trace();
+  record.started = std::chrono::steady_clock::now();
+  record.thread = std::this_thread::get_id();
+
+  tracer->record(std::move(record));
+}
+
+
 static void transport(Message&& message, ProcessBase* sender = nullptr)
 {
   if (message.to.address == __address__) {
@@ -606,6 +810,7 @@ static void transport(Message&& message, ProcessBase* sender = nullptr)
     process_manager->deliver(event->message.to, event, sender);
   } else {
     // Remote message.
+    trace(message.name, sender);
     socket_manager->send(std::move(message));
   }
 }
@@ -631,6 +836,7 @@ static void transport(
     process_manager->deliver(event->message.to, event, sender);
   } else {
     // Remote message.
+    trace(name, sender);
     socket_manager->send(encode(from, to, string(name), string(data, length)));
   }
 }
@@ -654,6 +860,7 @@ static void transport(
     process_manager->deliver(event->message.to, event, sender);
   } else {
     // Remote message.
+    trace(name, sender);
     socket_manager->send(encode(from, to, std::move(name), std::move(data)));
   }
 }
@@ -791,6 +998,36 @@ void decode_recv(
   const deque<Request*> requests = decoder->decode(data, length.get());
 
   if (requests.empty() && decoder->failed()) {
+    // HTTP/2 clients using "prior knowledge" (e.g., `curl
+    // --http2-prior-knowledge`) start the connection with the HTTP/2
+    // connection preface "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n", which no
+    // HTTP/1.1 request starts with. Rather than resetting the
+    // connection, which such clients can't tell apart from a network
+    // error, we answer with an empty SETTINGS frame followed by a
+    // GOAWAY frame with the HTTP_1_1_REQUIRED error code so that they
+    // can fall back to HTTP/1.1 right away (see RFC 7540).
+    if (strings::startsWith(string(data, length.get()), "PRI")) {
+      VLOG(1) << "Rejecting HTTP/2 connection, HTTP/1.1 is required";
+
+      // Frames are a 9 byte header (24 bit length, 8 bit type, 8 bit
+      // flags, 32 bit stream ID) followed by the payload; the GOAWAY
+      // payload is the last stream ID and the error code (0xd).
+      const char frames[] = {
+        0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x08, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d};
+
+      // The socket gets closed once the frames have been sent.
+      socket_manager->send(
+          new DataEncoder(string(frames, sizeof(frames))),
+          false,
+          socket);
+
+      delete[] data;
+      delete decoder;
+      return;
+    }
+
      VLOG(1) << "Decoder error while receiving";
      socket_manager->close(socket);
      delete[] data;
@@ -817,8 +1054,36 @@ void decode_recv(
     }
   }
 
-  socket.recv(data, size)
-    .onAny(lambda::bind(&decode_recv, lambda::_1, data, size, socket, decoder));
+  // Stop reading requests off the connection while as many of them
+  // as the pipeline window allows are outstanding.
+  Future<Nothing> available = Nothing();
+
+  if (!requests.empty() && libprocess_flags->http_pipeline_window.isSome()) {
+    available = dispatch(
+        socket_manager->proxy(socket),
+        &HttpProxy::available,
+        libprocess_flags->http_pipeline_window.get());
+  }
+
+  available
+    .onAny([data, size, socket, decoder](const Future<Nothing>& future) {
+      if (!future.isReady()) {
+        socket_manager->close(socket);
+        delete[] data;
+        delete decoder;
+        return;
+      }
+
+      socket.recv(data, size)
+        .onAny(lambda::bind(
+            &decode_recv, lambda::_1, data, size, socket, decoder));
+    })
+    .onAbandoned([data, socket, decoder]() {
+      // The proxy was terminated before handling the dispatch.
+      socket_manager->close(socket);
+      delete[] data;
+      delete decoder;
+    });
 }
 
 } // namespace internal {
@@ -1025,14 +1290,6 @@ bool initialize(
   // Initialize the event loop.
   EventLoop::initialize();
 
-  // Setup processing threads.
-  long num_worker_threads = process_manager->init_threads();
-
-  Clock::initialize(lambda::bind(&timedout, lambda::_1));
-
-  // Fill in the local IP and port for inter-libprocess communication.
-  __address__ = inet4::Address::ANY_ANY();
-
   // Fetch and parse the libprocess environment variables.
   Try<flags::Warnings> load = libprocess_flags->load("LIBPROCESS_");
 
@@ -1045,6 +1302,34 @@ bool initialize(
     LOG(WARNING) << warning.message;
   }
 
+  // Setup processing threads.
+  //
+  // NOTE: This happens after loading the flags, since the default
+  // number of worker threads depends on `LIBPROCESS_LIGHTWEIGHT`.
+  Option<set<unsigned int>> worker_cpus;
+  if (libprocess_flags->worker_cpus.isSome()) {
+    // NOTE: The value has already been validated when loading the flags.
+    worker_cpus =
+      internal::parse_cpus(libprocess_flags->worker_cpus.get()).get();
+  }
+
+  long num_worker_threads = process_manager->init_threads(
+      libprocess_flags->lightweight,
+      worker_cpus);
+
+  Clock::initialize(lambda::bind(&timedout, lambda::_1));
+
+  // Fill in the local IP and port for inter-libprocess communication.
+  __address__ = inet4::Address::ANY_ANY();
+
+  http_compression_level = libprocess_flags->http_compression_level;
+
+  if (libprocess_flags->trace_capacity.isSome() && tracer == nullptr) {
+    tracer = new Tracer(libprocess_flags->trace_capacity.get());
+  }
+  http_compression_minimum_length =
+    libprocess_flags->http_compression_minimum_length.bytes();
+
   uint16_t port = 0;
 
   if (libprocess_flags->port.isSome()) {
@@ -1156,6 +1441,7 @@ bool initialize(
   //   |
   //   |--logging
   //   |--profiler
+  //   |--memory-profiler
   //   |--processesRoute
   //
   //   authenticator_manager
@@ -1171,11 +1457,55 @@ bool initialize(
   // Create the global logging process.
   _logging = spawn(new Logging(readwriteAuthenticationRealm), true);
 
-  // Create the global profiler process.
-  spawn(new Profiler(readwriteAuthenticationRealm), true);
+  // The profiler and the system statistics are not needed by the
+  // executors and helper binaries running a lightweight runtime.
+  if (!libprocess_flags->lightweight) {
+    // Create the global profiler processes.
+    spawn(new Profiler(readwriteAuthenticationRealm), true);
+    spawn(new MemoryProfiler(readwriteAuthenticationRealm), true);
+
+    // Create the global system statistics process.
+    spawn(new System(), true);
+  }
+
+#ifdef USE_SSL_SOCKET
+  if (network::openssl::flags().enabled) {
+    network::openssl::add_metrics();
+  }
+#endif // USE_SSL_SOCKET
+
+  // Add the gauges for the events served by all processes, the per
+  // process numbers are included in the '/__processes__' endpoint.
+  // NOTE: The gauges are intentionally leaked, like the gauges of the
+  // other global processes.
+  {
+    auto gauge = [](const string& name, const std::function<double()>& f) {
+      metrics::add(*new metrics::Gauge(
+          name,
+          [f]() -> Future<double> { return f(); }));
+    };
+
+    gauge("libprocess/events_served", []() {
+      return static_cast<double>(events_served.load());
+    });
+
+    gauge("libprocess/events_served_secs", []() {
+      return Nanoseconds(events_served_ns.load()).secs();
+    });
+
+    gauge("libprocess/events_queued_secs", []() {
+      return Nanoseconds(events_queued_ns.load()).secs();
+    });
 
-  // Create the global system statistics process.
-  spawn(new System(), true);
+    // The per worker thread utilization is given by the rate of these.
+    for (long worker = 0; worker < process_manager->workers(); worker++) {
+      gauge(
+          "libprocess/workers/" + stringify(worker) + "/events_served_secs",
+          [worker]() {
+            return process_manager->served(worker).secs();
+          });
+    }
+  }
 
   // Create the global HTTP authentication router.
   authenticator_manager = new AuthenticatorManager();
@@ -1199,6 +1529,13 @@ bool initialize(
 
   processes_route = new Route("/__processes__", None(), __processes__);
 
+  // Add a route for dumping the trace, if tracing is enabled.
+  if (tracer != nullptr) {
+    trace_route = new Route("/__trace__", None(), [](const Request&) {
+      return OK(tracer->json());
+    });
+  }
+
   VLOG(1) << "libprocess is initialized on " << address() << " with "
           << num_worker_threads << " worker threads";
 
@@ -1223,6 +1560,9 @@ void finalize(bool finalize_wsa)
   delete processes_route;
   processes_route = nullptr;
 
+  delete trace_route;
+  trace_route = nullptr;
+
   // Close the server socket.
   // This will prevent any further connections managed by the `SocketManager`.
   synchronized (socket_mutex) {
@@ -1710,9 +2050,9 @@ void send(Encoder* encoder, Socket socket)
 {
   switch (encoder->kind()) {
     case Encoder::DATA: {
-      size_t size;
-      const char* data = static_cast<DataEncoder*>(encoder)->next(&size);
-      socket.send(data, size)
+      vector<SocketImpl::Segment> segments;
+      size_t size = static_cast<DataEncoder*>(encoder)->next(&segments);
+      socket.send(segments)
         .onAny(lambda::bind(
             &internal::_send,
             lambda::_1,
@@ -1823,12 +2163,14 @@ void SocketManager::send(
 void SocketManager::send_connect(
     const Future<Nothing>& future,
     Socket socket,
-    Message&& message)
+    Encoder* encoder,
+    const string& name,
+    const Address& address)
 {
   if (future.isDiscarded() || future.isFailed()) {
     if (future.isFailed()) {
-      VLOG(1) << "Failed to send '" << message.name << "' to '"
-              << message.to.address << "', connect: " << future.failure();
+      VLOG(1) << "Failed to send '" << name << "' to '"
+              << address << "', connect: " << future.failure();
     }
 
     // Check if SSL is enabled, and whether we allow a downgrade to
@@ -1850,6 +2192,7 @@ void SocketManager::send_connect(
         if (create.isError()) {
           VLOG(1) << "Failed to link, create socket: " << create.error();
           socket_manager->close(socket);
+          delete encoder;
           return;
         }
 
@@ -1864,15 +2207,12 @@ void SocketManager::send_connect(
       }
 
       CHECK_SOME(poll_socket);
-      Future<Nothing> connect = poll_socket.get().connect(message.to.address);
-      connect.onAny(lambda::bind(
-          // TODO(benh): with C++14 we can use lambda instead of
-          // `std::bind` and capture `message` with a `std::move`.
-          [this, poll_socket](Message& message, const Future<Nothing>& f) {
-            send_connect(f, poll_socket.get(), std::move(message));
-          },
-          std::move(message),
-          lambda::_1));
+      Future<Nothing> connect = poll_socket.get().connect(address);
+      connect.onAny(
+          [this, poll_socket, encoder, name, address](
+              const Future<Nothing>& f) {
+            send_connect(f, poll_socket.get(), encoder, name, address);
+          });
 
       // We don't need to 'shutdown()' the socket as it was never
       // connected.
@@ -1881,12 +2221,11 @@ void SocketManager::send_connect(
 #endif
 
     socket_manager->close(socket);
+    delete encoder;
 
     return;
   }
 
-  Encoder* encoder = new MessageEncoder(message);
-
   // Receive and ignore data from this socket. Note that we don't
   // expect to receive anything other than HTTP '202 Accepted'
   // responses which we just ignore.
@@ -1907,7 +2246,13 @@ void SocketManager::send_connect(
 
 void SocketManager::send(Message&& message, const SocketImpl::Kind& kind)
 {
-  const Address& address = message.to.address;
+  const Address address = message.to.address;
+  const string name = message.name;
+
+  // The message gets encoded before taking the lock, so that the
+  // other threads sending messages or picking the next encoder of a
+  // socket do not wait on it.
+  Encoder* encoder = new MessageEncoder(std::move(message));
 
   Option<Socket> socket = None();
   bool connect = false;
@@ -1928,7 +2273,7 @@ void SocketManager::send(Message&& message, const SocketImpl::Kind& kind)
       }
 
       if (outgoing.count(socket.get()) > 0) {
-        outgoing[socket.get()].push(new MessageEncoder(message));
+        outgoing[socket.get()].push(encoder);
         return;
       } else {
         // Initialize the outgoing queue.
@@ -1944,6 +2289,7 @@ void SocketManager::send(Message&& message, const SocketImpl::Kind& kind)
       Try<Socket> create = Socket::create(kind);
       if (create.isError()) {
         VLOG(1) << "Failed to send, create socket: " << create.error();
+        delete encoder;
         return;
       }
       socket = create.get();
@@ -1967,16 +2313,13 @@ void SocketManager::send(Message&& message, const SocketImpl::Kind& kind)
   if (connect) {
     CHECK_SOME(socket);
     socket->connect(address)
-      .onAny(lambda::bind(
-            // TODO(benh): with C++14 we can use lambda instead of
-            // `std::bind` and capture `message` with a `std::move`.
-            [this, socket](Message& message, const Future<Nothing>& f) {
-              send_connect(f, socket.get(), std::move(message));
-            }, std::move(message), lambda::_1));
+      .onAny([this, socket, encoder, name, address](const Future<Nothing>& f) {
+        send_connect(f, socket.get(), encoder, name, address);
+      });
   } else {
     // If we're not connecting and we haven't added the encoder to
     // the 'outgoing' queue then schedule it to be sent.
-    internal::send(new MessageEncoder(message), socket.get());
+    internal::send(encoder, socket.get());
   }
 }
 
@@ -2378,7 +2721,48 @@ void ProcessManager::finalize()
 }
 
 
-long ProcessManager::init_threads()
+// Sets the CPU affinity of the calling thread, which is inherited by
+// the threads it creates afterwards.
+static Try<Nothing> set_affinity(const set<unsigned int>& cpus)
+{
+#ifdef __linux__
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+
+  foreach (unsigned int cpu, cpus) {
+    CPU_SET(cpu, &cpuset);
+  }
+
+  int error = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+
+  if (error != 0) {
+    return Error(os::strerror(error));
+  }
+
+  return Nothing();
+#else
+  return Error("Pinning threads is only supported on Linux");
+#endif // __linux__
+}
+
+
+// Pins the calling thread to the given CPUs, if any.
+static void pin(const Option<set<unsigned int>>& cpus)
+{
+  if (cpus.isSome()) {
+    Try<Nothing> pinned = set_affinity(cpus.get());
+    if (pinned.isError()) {
+      EXIT(EXIT_FAILURE)
+        << "Failed to pin libprocess thread to CPUs "
+        << stringify(cpus.get()) << ": " << pinned.error();
+    }
+  }
+}
+
+
+long ProcessManager::init_threads(
+    bool lightweight,
+    const Option<set<unsigned int>>& cpus)
 {
   // We create no fewer than 8 threads because some tests require
   // more worker threads than `sysconf(_SC_NPROCESSORS_ONLN)` on
@@ -2389,8 +2773,12 @@ long ProcessManager::init_threads()
   // Allocating a static number of threads can cause starvation if
   // there are more waiting Processes than the number of worker
   // threads. On error assumes one core.
-  long num_worker_threads =
-    std::max(8L, os::cpus().isSome() ? os::cpus().get() : 1);
+  //
+  // A lightweight runtime only runs a few actors, so 2 worker threads
+  // suffice, see `LIBPROCESS_LIGHTWEIGHT`.
+  long num_worker_threads = lightweight
+    ? 2L
+    : std::max(8L, os::cpus().isSome() ? os::cpus().get() : 1);
 
   // We allow the operator to set the number of libprocess worker
   // threads, using an environment variable. The motivation is that
@@ -2427,11 +2815,20 @@ long ProcessManager::init_threads()
 
   threads.reserve(num_worker_threads + 1);
 
+  worker_served_ns.reset(new std::atomic<int64_t>[num_worker_threads]);
+  for (long i = 0; i < num_worker_threads; i++) {
+    worker_served_ns[i].store(0);
+  }
+
   // Create processing threads.
   for (long i = 0; i < num_worker_threads; i++) {
     // Retain the thread handles so that we can join when shutting down.
     threads.emplace_back(new std::thread(
-        [this]() {
+        [this, i, cpus]() {
+          pin(cpus);
+
+          _worker_served_ns_ = &worker_served_ns[i];
+
           running.fetch_add(1);
           do {
             ProcessBase* process = dequeue();
@@ -2453,7 +2850,17 @@ long ProcessManager::init_threads()
   }
 
   // Create a thread for the event loop.
-  threads.emplace_back(new std::thread(&EventLoop::run));
+  //
+  // NOTE: The event loop thread is pinned before it runs the event
+  // loop, so that the I/O threads it creates inherit its affinity.
+  threads.emplace_back(new std::thread([cpus]() {
+    pin(cpus);
+    EventLoop::run();
+  }));
+
+  if (cpus.isSome()) {
+    VLOG(1) << "Pinning libprocess threads to CPUs " << stringify(cpus.get());
+  }
 
   return num_worker_threads;
 }
@@ -2468,9 +2875,29 @@ ProcessReference ProcessManager::use(const UPID& pid)
   }
 
   if (pid.address == __address__) {
+    // NOTE: The reference of a terminating process expires before the
+    // process is removed from `processes`, so a reference that can be
+    // locked still refers to the process spawned with this ID.
+    if (_resolved_ != nullptr &&
+        _resolved_->id == static_cast<const string&>(pid.id)) {
+      CHECK_SOME(_resolved_->reference);
+      if (std::shared_ptr<ProcessBase*> reference =
+            _resolved_->reference->lock()) {
+        return ProcessReference(std::move(reference));
+      }
+    }
+
     synchronized (processes_mutex) {
       Option<ProcessBase*> process = processes.get(pid.id);
       if (process.isSome()) {
+        if (process.get()->pid.reference.isSome()) {
+          if (_resolved_ == nullptr) {
+            _resolved_ = new UPID();
+          }
+
+          *_resolved_ = process.get()->pid;
+        }
+
         return ProcessReference(process.get()->reference);
       }
     }
@@ -2499,10 +2926,8 @@ void ProcessManager::handle(
         proxy,
         &HttpProxy::enqueue,
         BadRequest("Request URL path must start with '/'"),
-        *request);
+        Owned<Request>(request));
 
-    // Cleanup request.
-    delete request;
     return;
   }
 
@@ -2523,12 +2948,15 @@ void ProcessManager::handle(
           Response response = InternalServerError(
               future.isFailed() ? future.failure() : "discarded future");
 
-          dispatch(proxy, &HttpProxy::enqueue, response, *request);
-
           VLOG(1) << "Returning '" << response.status << "' for '"
                   << request->url.path << "': " << response.body;
 
-          delete request;
+          dispatch(
+              proxy,
+              &HttpProxy::enqueue,
+              response,
+              Owned<Request>(request));
+
           return;
         }
 
@@ -2551,13 +2979,16 @@ void ProcessManager::handle(
                 stringify(event->message.from) + " was sent from IP " +
                 stringify(request->client.get()));
 
-            dispatch(proxy, &HttpProxy::enqueue, response, *request);
-
             VLOG(1) << "Returning '" << response.status << "'"
                     << " for '" << request->url.path << "'"
                     << ": " << response.body;
 
-            delete request;
+            dispatch(
+                proxy,
+                &HttpProxy::enqueue,
+                response,
+                Owned<Request>(request));
+
             delete event;
             return;
           }
@@ -2573,14 +3004,21 @@ void ProcessManager::handle(
         // responses. Now we always send a response.
         if (accepted) {
           VLOG(2) << "Delivered libprocess message to " << request->url.path;
-          dispatch(proxy, &HttpProxy::enqueue, Accepted(), *request);
+          dispatch(
+              proxy,
+              &HttpProxy::enqueue,
+              Accepted(),
+              Owned<Request>(request));
         } else {
           VLOG(1) << "Failed to deliver libprocess message to "
                   << request->url.path;
-          dispatch(proxy, &HttpProxy::enqueue, NotFound(), *request);
+          dispatch(
+              proxy,
+              &HttpProxy::enqueue,
+              NotFound(),
+              Owned<Request>(request));
         }
 
-        delete request;
         return;
       });
 
@@ -2599,10 +3037,8 @@ void ProcessManager::handle(
 
     // Enqueue the response with the HttpProxy so that it respects the
     // order of requests to account for HTTP/1.1 pipelining.
-    dispatch(proxy, &HttpProxy::enqueue, NotFound(), *request);
+    dispatch(proxy, &HttpProxy::enqueue, NotFound(), Owned<Request>(request));
 
-    // Cleanup request.
-    delete request;
     return;
   }
 
@@ -2650,10 +3086,8 @@ void ProcessManager::handle(
             proxy,
             &HttpProxy::enqueue,
             rejection.get(),
-            *request);
+            Owned<Request>(request));
 
-        // Cleanup request.
-        delete request;
         return;
       }
     }
@@ -2667,8 +3101,14 @@ void ProcessManager::handle(
     PID<HttpProxy> proxy = socket_manager->proxy(socket);
 
     // Enqueue the response with the HttpProxy so that it respects the
-    // order of requests to account for HTTP/1.1 pipelining.
-    dispatch(proxy, &HttpProxy::handle, promise->future(), *request);
+    // order of requests to account for HTTP/1.1 pipelining. The proxy
+    // gets its own copy of the request since the handler owns (and
+    // might modify) the request delivered with the `HttpEvent`.
+    dispatch(
+        proxy,
+        &HttpProxy::handle,
+        promise->future(),
+        Owned<Request>(new Request(*request)));
 
     // TODO(benh): Use the sender PID in order to capture
     // happens-before timing relationships for testing.
@@ -2685,10 +3125,7 @@ void ProcessManager::handle(
 
   // Enqueue the response with the HttpProxy so that it respects the
   // order of requests to account for HTTP/1.1 pipelining.
-  dispatch(proxy, &HttpProxy::enqueue, NotFound(), *request);
-
-  // Cleanup request.
-  delete request;
+  dispatch(proxy, &HttpProxy::enqueue, NotFound(), Owned<Request>(request));
 }
 
 
@@ -2915,6 +3352,82 @@ void ProcessManager::resume(ProcessBase* process)
       // Determine if we should terminate.
       terminate = event->is<TerminateEvent>();
 
+      // Determine the type of the event, and the message name or the
+      // HTTP request path, before serving it since serving moves the
+      // event.
+      struct Visitor : EventVisitor
+      {
+        virtual void visit(const MessageEvent& event)
+        {
+          category = "MESSAGE";
+          name = &event.message.name;
+        }
+
+        virtual void visit(const DispatchEvent&)
+        {
+          category = "DISPATCH";
+        }
+
+        virtual void visit(const HttpEvent& event)
+        {
+          category = "HTTP";
+          name = &event.request->url.path;
+        }
+
+        virtual void visit(const ExitedEvent&)
+        {
+          category = "EXITED";
+        }
+
+        virtual void visit(const TerminateEvent&)
+        {
+          category = "TERMINATE";
+        }
+
+        const char* category = nullptr;
+        const string* name = nullptr;
+      } visitor;
+
+      event->visit(&visitor);
+
+      CHECK_NOTNULL(visitor.category);
+
+      // Look up the statistics to account the event to.
+      ProcessBase::EventStatistics& statistics = process->statistics;
+      ProcessBase::EventStatistics::Entry* type =
+        &statistics.types[visitor.category];
+      ProcessBase::EventStatistics::Entry* message = nullptr;
+
+      if (event->is<MessageEvent>()) {
+        auto entry = statistics.messages.find(*visitor.name);
+        if (entry != statistics.messages.end()) {
+          message = &entry->second;
+        } else if (statistics.messages.size() <
+                   ProcessBase::EventStatistics::MAX_MESSAGE_NAMES) {
+          message = &statistics.messages[*visitor.name];
+        }
+      }
+
+      const std::chrono::steady_clock::time_point started =
+        std::chrono::steady_clock::now();
+
+      Option<Tracer::Record> record;
+      if (tracer != nullptr) {
+        record = Tracer::Record();
+        record->phase = 'X';
+        record->category = visitor.category;
+        record->name = visitor.name != nullptr ? *visitor.name : string();
+        record->process = process->pid.id;
+        record->trace = event->trace;
+        record->started = started;
+        record->queued = started - event->enqueued;
+        record->thread = std::this_thread::get_id();
+
+        // The events enqueued while serving this event belong to the
+        // same trace.
+        _trace_ = event->trace;
+      }
+
       // Now service the event.
       try {
         process->serve(std::move(*event));
@@ -2928,6 +3441,44 @@ void ProcessManager::resume(ProcessBase* process)
         terminate = true;
       }
 
+      const std::chrono::steady_clock::time_point finished =
+        std::chrono::steady_clock::now();
+
+      const Duration served = Nanoseconds(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              finished - started).count());
+
+      const Duration queued = Nanoseconds(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              started - event->enqueued).count());
+
+      // NOTE: The entries remain valid while serving the event since
+      // the statistics are only accessed from within the process, and
+      // `hashmap` doesn't invalidate references to its values when
+      // inserting.
+      for (ProcessBase::EventStatistics::Entry* entry : {type, message}) {
+        if (entry != nullptr) {
+          entry->count++;
+          entry->served += served;
+          entry->queued += queued;
+        }
+      }
+
+      events_served.fetch_add(1, std::memory_order_relaxed);
+      events_served_ns.fetch_add(served.ns(), std::memory_order_relaxed);
+
+      if (_worker_served_ns_ != nullptr) {
+        _worker_served_ns_->fetch_add(
+            served.ns(), std::memory_order_relaxed);
+      }
+      events_queued_ns.fetch_add(queued.ns(), std::memory_order_relaxed);
+
+      if (record.isSome()) {
+        record->served = finished - started;
+        tracer->record(std::move(record.get()));
+        _trace_ = 0;
+      }
+
       delete event;
     }
   }
@@ -3411,6 +3962,12 @@ void ProcessBase::enqueue(Event* event)
     case State::BOTTOM:
     case State::READY:
     case State::BLOCKED:
+      event->enqueued = std::chrono::steady_clock::now();
+
+      if (tracer != nullptr && event->trace == 0) {
+        event->trace = _trace_ != 0 ? _trace_ : tracer->trace();
+      }
+
       events->producer.enqueue(event);
       break;
     case State::TERMINATING:
@@ -3494,7 +4051,7 @@ void ProcessBase::consume(MessageEvent&& event)
 
 void ProcessBase::consume(DispatchEvent&& event)
 {
-  std::move(*event.f)(this);
+  std::move(event.f)(this);
 }
 
 
@@ -3758,6 +4315,26 @@ ProcessBase:: operator JSON::Object()
   JSON::Object object;
   object.values["id"] = (const string&) pid.id;
   object.values["events"] = JSON::Array(events->consumer);
+
+  auto json = [](const hashmap<string, EventStatistics::Entry>& entries) {
+    JSON::Object object;
+    foreachpair (const string& key,
+                 const EventStatistics::Entry& entry,
+                 entries) {
+      JSON::Object value;
+      value.values["count"] = entry.count;
+      value.values["served_secs"] = entry.served.secs();
+      value.values["queued_secs"] = entry.queued.secs();
+      object.values[key] = value;
+    }
+    return object;
+  };
+
+  JSON::Object statistics_;
+  statistics_.values["types"] = json(statistics.types);
+  statistics_.values["messages"] = json(statistics.messages);
+  object.values["statistics"] = statistics_;
+
   return object;
 }
 
@@ -3901,6 +4478,32 @@ void post(const UPID& from,
 }
 
 
+void post(const UPID& to, string&& name, string&& data)
+{
+  process::initialize();
+
+  if (!to) {
+    return;
+  }
+
+  // Transport outgoing message.
+  transport(UPID(), to, std::move(name), std::move(data));
+}
+
+
+void post(const UPID& from, const UPID& to, string&& name, string&& data)
+{
+  process::initialize();
+
+  if (!to) {
+    return;
+  }
+
+  // Transport outgoing message.
+  transport(from, to, std::move(name), std::move(data));
+}
+
+
 namespace inject {
 
 bool exited(const UPID& from, const UPID& to)
@@ -3918,7 +4521,7 @@ namespace internal {
 
 void dispatch(
     const UPID& pid,
-    std::unique_ptr<lambda::CallableOnce<void(ProcessBase*)>> f,
+    lambda::CallableOnce<void(ProcessBase*)> f,
     const Option<const std::type_info*>& functionType)
 {
   process::initialize();
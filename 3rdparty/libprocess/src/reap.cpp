@@ -16,16 +16,22 @@
 #ifndef __WINDOWS__
 #include <sys/wait.h>
 #endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
+#include <process/defer.hpp>
 #include <process/delay.hpp>
 #include <process/future.hpp>
 #include <process/id.hpp>
+#include <process/io.hpp>
 #include <process/once.hpp>
 #include <process/owned.hpp>
 #include <process/reap.hpp>
 
 #include <stout/check.hpp>
 #include <stout/foreach.hpp>
+#include <stout/lambda.hpp>
 #include <stout/multihashmap.hpp>
 #include <stout/none.hpp>
 #include <stout/option.hpp>
@@ -33,12 +39,21 @@
 #include <stout/result.hpp>
 #include <stout/try.hpp>
 
+#include <stout/os/close.hpp>
+
+// Older libc headers don't define the syscall number, which is the
+// same on all architectures.
+#if defined(__linux__) && !defined(SYS_pidfd_open)
+#define SYS_pidfd_open 434
+#endif
+
 namespace process {
 
 
-// TODO(bmahler): This can be optimized to use a thread per pid, where
-// each thread makes a blocking call to waitpid. This eliminates the
-// unfortunate poll delay.
+// NOTE: On Linux 5.3 and later, the reaper gets notified of the
+// termination of a pid through a pidfd (see `pidfd_open(2)`) becoming
+// readable, without any delay. The pids are only polled when a pidfd
+// can't be opened for them.
 //
 // Simple bounded linear model for computing the poll interval.
 // Values were chosen such that at (50 pids, 100 ms) the CPU usage is
@@ -63,6 +78,20 @@ Duration MAX_REAP_INTERVAL() { return Seconds(1); }
 
 namespace internal {
 
+#ifdef __linux__
+static Try<int_fd> pidfd_open(pid_t pid)
+{
+  // NOTE: The returned file descriptor has `FD_CLOEXEC` set.
+  int fd = ::syscall(SYS_pidfd_open, pid, 0);
+  if (fd < 0) {
+    return ErrnoError();
+  }
+
+  return fd;
+}
+#endif // __linux__
+
+
 ReaperProcess::ReaperProcess() : ProcessBase(ID::generate("__reaper__")) {}
 
 
@@ -72,6 +101,21 @@ Future<Option<int>> ReaperProcess::reap(pid_t pid)
   if (os::exists(pid)) {
     Owned<Promise<Option<int>>> promise(new Promise<Option<int>>());
     promises.put(pid, promise);
+
+#ifdef __linux__
+    if (!pidfds.contains(pid)) {
+      // The pid keeps being polled if the kernel doesn't support
+      // pidfds, or if it has just been reaped by someone else.
+      Try<int_fd> pidfd = pidfd_open(pid);
+      if (pidfd.isSome()) {
+        pidfds[pid] = pidfd.get();
+
+        io::poll(pidfd.get(), io::READ)
+          .onAny(defer(self(), &ReaperProcess::exited, pid, lambda::_1));
+      }
+    }
+#endif // __linux__
+
     return promise->future();
   } else {
     return None();
@@ -98,6 +142,11 @@ void ReaperProcess::wait()
   // between waitpid and the (!exists) conditional it will still exist as a
   // zombie; it will be reaped by us on the next loop.
   foreach (pid_t pid, promises.keys()) {
+    // Pids with a pidfd get reaped once it becomes readable.
+    if (pidfds.contains(pid)) {
+      continue;
+    }
+
     int status;
     Result<pid_t> child_pid = os::waitpid(pid, &status, WNOHANG);
     if (child_pid.isSome()) {
@@ -113,6 +162,33 @@ void ReaperProcess::wait()
 }
 
 
+void ReaperProcess::exited(pid_t pid, const Future<short>& poll)
+{
+  CHECK(pidfds.contains(pid));
+
+  os::close(pidfds.at(pid));
+  pidfds.erase(pid);
+
+  // Fall back to polling the pid if waiting for the pidfd failed.
+  if (!poll.isReady()) {
+    LOG(WARNING) << "Failed to wait for the termination of pid " << pid
+                 << ": " << (poll.isFailed() ? poll.failure() : "discarded");
+    return;
+  }
+
+  // The process has terminated. As above, we either reap it, or it
+  // was not our child (or got reaped by someone else in the meantime)
+  // in which case we can't know the exit status.
+  int status;
+  Result<pid_t> child_pid = os::waitpid(pid, &status, WNOHANG);
+  if (child_pid.isSome()) {
+    notify(pid, status);
+  } else {
+    notify(pid, None());
+  }
+}
+
+
 void ReaperProcess::notify(pid_t pid, Result<int> status)
 {
   foreach (const Owned<Promise<Option<int>>>& promise, promises.get(pid)) {
@@ -130,7 +206,8 @@ void ReaperProcess::notify(pid_t pid, Result<int> status)
 
 const Duration ReaperProcess::interval()
 {
-  size_t count = promises.size();
+  // Only the pids without a pidfd are polled.
+  size_t count = promises.size() - pidfds.size();
 
   if (count <= LOW_PID_COUNT) {
     return MIN_REAP_INTERVAL();
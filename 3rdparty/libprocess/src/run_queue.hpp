@@ -20,7 +20,12 @@
 //      -DENABLE_LOCK_FREE_RUN_QUEUE (cmake) which enables the
 //      lock-free run queue implementation (see below for more details).
 //
-//  (2) --enable-last-in-first-out-fixed-size-semaphore (autotools) or
+//  (2) --enable-work-stealing-run-queue (autotools) or
+//      -DENABLE_WORK_STEALING_RUN_QUEUE (cmake) which enables the
+//      per-worker work-stealing run queue implementation (see below
+//      for more details). This can not be combined with (1).
+//
+//  (3) --enable-last-in-first-out-fixed-size-semaphore (autotools) or
 //      -DENABLE_LAST_IN_FIRST_OUT_FIXED_SIZE_SEMAPHORE (cmake) which
 //      enables an optimized semaphore implementation (see semaphore.hpp
 //      for more details).
@@ -37,7 +42,11 @@
 #endif // LOCK_FREE_RUN_QUEUE
 
 #include <algorithm>
+#include <atomic>
 #include <list>
+#include <memory>
+
+#include <glog/logging.h>
 
 #include <process/process.hpp>
 
@@ -47,7 +56,180 @@
 
 namespace process {
 
-#ifndef LOCK_FREE_RUN_QUEUE
+#if defined(WORK_STEALING_RUN_QUEUE)
+
+// A run queue made of one queue per worker thread. A process that is
+// enqueued from a worker thread is put on that worker's queue, so
+// that it preferentially runs on the same worker (and thus on a warm
+// cache) as the process that dispatched to it. A worker first looks
+// at its own queue and only if that is empty does it steal from the
+// queues of the other workers. Processes enqueued from threads that
+// are not workers (e.g., the event loop) are spread across the queues
+// in a round-robin fashion.
+//
+// Each queue has its own lock, which is only contended when a worker
+// steals from another worker, rather than a single lock that every
+// worker contends on for every enqueue and dequeue. Unlike the
+// lock-free run queue this still supports `extract`, which is used to
+// donate a thread to a process that is being waited on.
+//
+// NOTE: Workers register themselves on their first call to `dequeue`.
+class RunQueue
+{
+public:
+  RunQueue() : queues(new Queue[MAX_WORKERS]) {}
+
+  bool extract(ProcessBase* process)
+  {
+    const size_t size = std::max<size_t>(1, workers.load());
+
+    for (size_t i = 0; i < size; i++) {
+      Queue& queue = queues[i];
+
+      synchronized (queue.mutex) {
+        std::list<ProcessBase*>::iterator it = std::find(
+            queue.processes.begin(),
+            queue.processes.end(),
+            process);
+
+        if (it != queue.processes.end()) {
+          queue.processes.erase(it);
+          count.fetch_sub(1);
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+  void wait()
+  {
+    semaphore.wait();
+  }
+
+  void enqueue(ProcessBase* process)
+  {
+    long index = worker();
+
+    // Spread processes that are not enqueued by a worker across the
+    // queues of all (registered) workers.
+    if (index < 0) {
+      const size_t size = std::max<size_t>(1, workers.load());
+      index = next.fetch_add(1) % size;
+    }
+
+    Queue& queue = queues[index];
+
+    synchronized (queue.mutex) {
+      queue.processes.push_back(process);
+    }
+
+    count.fetch_add(1);
+    epoch.fetch_add(1);
+    semaphore.signal();
+  }
+
+  // Precondition: `wait` must get called before `dequeue`!
+  ProcessBase* dequeue()
+  {
+    const long self = registered();
+
+    // NOTE: As with the lock-free run queue we loop until we actually
+    // dequeue a process (because the contract for using the run queue
+    // is that `wait` must be called first so we know that there is
+    // something to be dequeued), unless the run queue is empty and
+    // the process we were woken up for has been extracted, or the run
+    // queue has been decommissioned.
+    do {
+      const size_t size = workers.load();
+
+      // Look at our own queue first, then steal from the others.
+      for (size_t i = 0; i < size; i++) {
+        Queue& queue = queues[(self + i) % size];
+
+        synchronized (queue.mutex) {
+          if (!queue.processes.empty()) {
+            ProcessBase* process = queue.processes.front();
+            queue.processes.pop_front();
+            count.fetch_sub(1);
+            return process;
+          }
+        }
+      }
+    } while (count.load() > 0 && !semaphore.decomissioned());
+
+    return nullptr;
+  }
+
+  bool empty() const
+  {
+    return count.load() == 0;
+  }
+
+  void decomission()
+  {
+    semaphore.decomission();
+  }
+
+  size_t capacity() const
+  {
+    return std::min(static_cast<size_t>(MAX_WORKERS), semaphore.capacity());
+  }
+
+  // Epoch used to capture changes to the run queue when settling.
+  std::atomic_long epoch = ATOMIC_VAR_INIT(0L);
+
+private:
+  // Matches the maximum of `LIBPROCESS_NUM_WORKER_THREADS`.
+  static constexpr size_t MAX_WORKERS = 1024;
+
+  struct Queue
+  {
+    std::list<ProcessBase*> processes;
+    std::mutex mutex;
+  };
+
+  // Returns the index of the calling worker thread, or -1 if the
+  // calling thread is not a worker.
+  static long& worker()
+  {
+    static thread_local long index = -1;
+    return index;
+  }
+
+  // Returns the index of the calling worker thread, registering the
+  // calling thread as a worker if necessary.
+  long registered()
+  {
+    long& index = worker();
+    if (index < 0) {
+      index = workers.fetch_add(1);
+      CHECK_LT(index, static_cast<long>(MAX_WORKERS));
+    }
+    return index;
+  }
+
+  std::unique_ptr<Queue[]> queues;
+
+  // Number of registered workers, i.e., of queues in use.
+  std::atomic_long workers = ATOMIC_VAR_INIT(0L);
+
+  // Used to pick a queue for processes enqueued by non-workers.
+  std::atomic_ulong next = ATOMIC_VAR_INIT(0UL);
+
+  // Total number of processes across all queues.
+  std::atomic_long count = ATOMIC_VAR_INIT(0L);
+
+  // Semaphore used for threads to wait.
+#ifndef LAST_IN_FIRST_OUT_FIXED_SIZE_SEMAPHORE
+  DecomissionableKernelSemaphore semaphore;
+#else
+  DecomissionableLastInFirstOutFixedSizeSemaphore semaphore;
+#endif // LAST_IN_FIRST_OUT_FIXED_SIZE_SEMAPHORE
+};
+
+#elif !defined(LOCK_FREE_RUN_QUEUE)
 class RunQueue
 {
 public:
@@ -199,7 +381,7 @@ private:
 #endif // LAST_IN_FIRST_OUT_FIXED_SIZE_SEMAPHORE
 };
 
-#endif // LOCK_FREE_RUN_QUEUE
+#endif // WORK_STEALING_RUN_QUEUE
 
 } // namespace process {
 
@@ -12,6 +12,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/shared_array.hpp>
 
@@ -22,6 +23,7 @@
 
 #include <process/ssl/flags.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/os.hpp>
 #include <stout/unreachable.hpp>
 
@@ -217,6 +219,18 @@ Future<Nothing> SocketImpl::send(const string& data)
       });
 }
 
+
+Future<size_t> SocketImpl::send(const std::vector<Segment>& segments)
+{
+  foreach (const Segment& segment, segments) {
+    if (segment.size > 0) {
+      return send(segment.data, segment.size);
+    }
+  }
+
+  return 0;
+}
+
 } // namespace internal {
 } // namespace network {
 } // namespace process {
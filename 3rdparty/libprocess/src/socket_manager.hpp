@@ -15,6 +15,7 @@
 
 #include <mutex>
 #include <queue>
+#include <string>
 
 #include <process/address.hpp>
 #include <process/future.hpp>
@@ -119,7 +120,9 @@ private:
   void send_connect(
       const Future<Nothing>& future,
       network::inet::Socket socket,
-      Message&& message);
+      Encoder* encoder,
+      const std::string& name,
+      const network::inet::Address& address);
 
   // Collection of all active sockets (both inbound and outbound).
   hashmap<int_fd, network::inet::Socket> sockets;
@@ -18,6 +18,8 @@
 #endif // __linux__
 #include <sys/types.h>
 
+#include <spawn.h>
+
 #include <string>
 
 #include <glog/logging.h>
@@ -34,6 +36,7 @@
 #include <stout/none.hpp>
 #include <stout/option.hpp>
 #include <stout/os.hpp>
+#include <stout/strings.hpp>
 #include <stout/try.hpp>
 #include <stout/unreachable.hpp>
 
@@ -197,6 +200,62 @@ inline int childMain(
 }
 
 
+// Spawns the child process with `posix_spawn`, which avoids copying
+// the page tables of the parent (glibc uses `vfork` semantics), unlike
+// `fork`. This is only possible without any hooks or custom clone
+// function, as it leaves no room to run code before the exec.
+//
+// NOTE: All the file descriptors are expected to be close-on-exec
+// (see `cloexec` above), so that only the stdin/stdout/stderr of the
+// child need to be set up, like in `childMain`.
+inline Try<pid_t> spawnChild(
+    const std::string& path,
+    char** argv,
+    char** envp,
+    bool search,
+    const InputFileDescriptors& stdinfds,
+    const OutputFileDescriptors& stdoutfds,
+    const OutputFileDescriptors& stderrfds)
+{
+  posix_spawn_file_actions_t actions;
+
+  int error = ::posix_spawn_file_actions_init(&actions);
+  if (error != 0) {
+    return ErrnoError(error, "Failed to initialize spawn file actions");
+  }
+
+  // Redirect I/O for stdin/stdout/stderr.
+  const int redirects[][2] = {
+    {stdinfds.read, STDIN_FILENO},
+    {stdoutfds.write, STDOUT_FILENO},
+    {stderrfds.write, STDERR_FILENO}
+  };
+
+  foreach (const int (&redirect)[2], redirects) {
+    error = ::posix_spawn_file_actions_adddup2(
+        &actions, redirect[0], redirect[1]);
+
+    if (error != 0) {
+      ::posix_spawn_file_actions_destroy(&actions);
+      return ErrnoError(error, "Failed to add spawn file action");
+    }
+  }
+
+  pid_t pid;
+  error = search
+    ? ::posix_spawnp(&pid, path.c_str(), &actions, nullptr, argv, envp)
+    : ::posix_spawn(&pid, path.c_str(), &actions, nullptr, argv, envp);
+
+  ::posix_spawn_file_actions_destroy(&actions);
+
+  if (error != 0) {
+    return ErrnoError(error, "Failed to spawn");
+  }
+
+  return pid;
+}
+
+
 inline Try<pid_t> cloneChild(
     const std::string& path,
     std::vector<std::string> argv,
@@ -240,6 +299,39 @@ inline Try<pid_t> cloneChild(
     envp[index] = nullptr;
   }
 
+  // Without any hooks or custom clone function, try to spawn the child
+  // rather than forking it. The path is searched for like `execvp` does
+  // in `childMain`, which looks at the `PATH` of the child environment,
+  // so it must not be overridden for `posix_spawnp` to be equivalent.
+  //
+  // NOTE: If spawning fails, e.g., because the path does not exist, we
+  // fall back to forking so that the failure gets reported through the
+  // exit status of the child as always.
+  Option<pid_t> spawned;
+
+  if (_clone.isNone() &&
+      parent_hooks.empty() &&
+      child_hooks.empty() &&
+      (strings::contains(path, "/") ||
+       environment.isNone() ||
+       environment->count("PATH") == 0)) {
+    Try<pid_t> spawn = spawnChild(
+        path,
+        _argv,
+        envp,
+        !strings::contains(path, "/"),
+        stdinfds,
+        stdoutfds,
+        stderrfds);
+
+    if (spawn.isSome()) {
+      spawned = spawn.get();
+    } else {
+      VLOG(1) << "Falling back to forking '" << path << "': "
+              << spawn.error();
+    }
+  }
+
   // Determine the function to clone the child process. If the user
   // does not specify the clone function, we will use the default.
   lambda::function<pid_t(const lambda::function<int()>&)> clone =
@@ -259,8 +351,8 @@ inline Try<pid_t> cloneChild(
     pipes = pipe.get();
   }
 
-  // Now, clone the child process.
-  pid_t pid = clone(lambda::bind(
+  // Now, clone the child process unless it has been spawned.
+  pid_t pid = spawned.isSome() ? spawned.get() : clone(lambda::bind(
       &childMain,
       path,
       _argv,
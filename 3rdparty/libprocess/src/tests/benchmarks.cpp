@@ -19,6 +19,7 @@
 #include <gmock/gmock.h>
 
 #include <deque>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -26,18 +27,28 @@
 
 #include <process/collect.hpp>
 #include <process/count_down_latch.hpp>
+#include <process/clock.hpp>
+#include <process/dispatch.hpp>
 #include <process/future.hpp>
 #include <process/gmock.hpp>
 #include <process/gtest.hpp>
 #include <process/owned.hpp>
 #include <process/process.hpp>
 #include <process/protobuf.hpp>
+#include <process/subprocess.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/gtest.hpp>
 #include <stout/hashset.hpp>
+#include <stout/json.hpp>
+#include <stout/jsonify.hpp>
+#include <stout/os.hpp>
+#include <stout/protobuf.hpp>
 #include <stout/stopwatch.hpp>
 
+#include <stout/tests/benchmark.hpp>
+
 #include "benchmarks.pb.h"
 
 namespace http = process::http;
@@ -46,9 +57,11 @@ using process::CountDownLatch;
 using process::Future;
 using process::MessageEvent;
 using process::Owned;
+using process::PID;
 using process::Process;
 using process::ProcessBase;
 using process::Promise;
+using process::Subprocess;
 using process::UPID;
 
 using std::cout;
@@ -271,6 +284,12 @@ TEST(ProcessTest, Process_BENCHMARK_ClientServer)
 
   Duration elapsed = watch.elapsed();
 
+  BenchmarkReport report;
+  report.parameter("requests", numRequests);
+  report.parameter("concurrency", concurrency);
+  report.parameter("clients", numClients);
+  report.parameter("message_size", messageSize.bytes());
+
   // Print the throughput of each client.
   size_t i = 0;
   foreach (const http::Response& response, responses.get()) {
@@ -283,12 +302,17 @@ TEST(ProcessTest, Process_BENCHMARK_ClientServer)
 
     cout << "Client " << i << ": " << throughput << " rpcs / sec" << endl;
 
+    report.sample("client_throughput", throughput, "rpcs/s");
+
     i++;
   }
 
   double throughput = (numRequests * numClients) / elapsed.secs();
   cout << "Estimated Total: " << throughput << " rpcs / sec" << endl;
 
+  report.sample("throughput", throughput, "rpcs/s");
+  report.write();
+
   foreach (const Owned<ClientProcess>& client, clients) {
     terminate(*client);
     wait(*client);
@@ -581,6 +605,279 @@ TEST(ProcessTest, Process_BENCHMARK_DispatchDefer)
 }
 
 
+// Measures the cost of creating and completing futures, which is
+// dominated by the allocation of their shared state and callbacks.
+TEST(ProcessTest, Process_BENCHMARK_FutureChain)
+{
+  constexpr long repeats = 1000000;
+
+  long sum = 0;
+
+  Stopwatch watch;
+  watch.start();
+
+  for (long i = 0; i < repeats; i++) {
+    Promise<long> promise;
+
+    Future<long> future = promise.future()
+      .then([](long value) { return value + 1; })
+      .then([](long value) { return value + 1; });
+
+    promise.set(i);
+
+    sum += future.get();
+  }
+
+  watch.stop();
+
+  EXPECT_EQ(repeats * (repeats + 3), 2 * sum);
+
+  cout << "Completed " << repeats << " chains of futures in "
+       << watch.elapsed() << endl;
+}
+
+
+// A process running chains of five continuations, either deferring
+// each step back to the process, as for the `_foo`, `__foo`, ...
+// continuations of the agent and the containerizer, or only
+// deferring the last step.
+class ChainProcess : public Process<ChainProcess>
+{
+public:
+  Future<long> deferred(long value)
+  {
+    return step(value)
+      .then(defer(self(), &Self::step, lambda::_1))
+      .then(defer(self(), &Self::step, lambda::_1))
+      .then(defer(self(), &Self::step, lambda::_1))
+      .then(defer(self(), &Self::step, lambda::_1));
+  }
+
+  Future<long> inlined(long value)
+  {
+    return step(value)
+      .then([](long value) { return value + 1; })
+      .then([](long value) { return value + 1; })
+      .then([](long value) { return value + 1; })
+      .then(defer(self(), &Self::step, lambda::_1));
+  }
+
+private:
+  Future<long> step(long value)
+  {
+    return value + 1;
+  }
+};
+
+
+TEST(ProcessTest, Process_BENCHMARK_DeferChain)
+{
+  constexpr long repeats = 100000;
+
+  ChainProcess process;
+  spawn(process);
+
+  // Every chain adds 5 to its input.
+  const long expected = repeats * (repeats + 9) / 2;
+
+  BenchmarkReport report;
+  report.parameter("repeats", repeats);
+
+  foreach (bool defers, vector<bool>({true, false})) {
+    Stopwatch watch;
+    watch.start();
+
+    long sum = 0;
+    for (long i = 0; i < repeats; i++) {
+      Future<long> future = defers
+        ? dispatch(process, &ChainProcess::deferred, i)
+        : dispatch(process, &ChainProcess::inlined, i);
+
+      AWAIT_READY(future);
+      sum += future.get();
+    }
+
+    watch.stop();
+
+    EXPECT_EQ(expected, sum);
+
+    cout << "Completed " << repeats << " chains of five "
+         << (defers ? "deferred" : "inlined") << " steps in "
+         << watch.elapsed() << endl;
+
+    report.sample(defers ? "deferred" : "inlined", watch.elapsed());
+  }
+
+  report.write();
+
+  terminate(process);
+  wait(process);
+}
+
+
+// A process counting the dispatches it gets, used to measure the cost
+// of dispatches which don't return a result.
+class CounterProcess : public Process<CounterProcess>
+{
+public:
+  CounterProcess(Promise<Nothing>* promise, long total)
+    : promise(promise), total(total), count(0) {}
+
+  void increment() { add(1); }
+
+  void add(long n)
+  {
+    count += n;
+    if (count == total) {
+      promise->set(Nothing());
+    }
+  }
+
+  void addAll(const vector<long>& ns)
+  {
+    foreach (long n, ns) {
+      add(n);
+    }
+  }
+
+private:
+  Promise<Nothing>* promise;
+  const long total;
+  long count;
+};
+
+
+// Measures the throughput of "fire and forget" dispatches, i.e., of
+// methods returning void, which need neither a promise nor a future.
+TEST(ProcessTest, Process_BENCHMARK_DispatchVoid)
+{
+  constexpr long repeats = 1000000;
+
+  auto run = [](
+      const string& name,
+      const std::function<void(const PID<CounterProcess>&)>& dispatcher,
+      long total) {
+    Promise<Nothing> promise;
+
+    Owned<CounterProcess> process(new CounterProcess(&promise, total));
+    spawn(*process);
+
+    Stopwatch watch;
+    watch.start();
+
+    for (long i = 0; i < repeats; i++) {
+      dispatcher(process->self());
+    }
+
+    AWAIT_READY(promise.future());
+
+    Duration elapsed = watch.elapsed();
+
+    cout << name << ": " << std::fixed << (repeats / elapsed.secs())
+         << " dispatches/s" << endl;
+
+    terminate(process.get());
+    wait(process.get());
+  };
+
+  run("No arguments",
+      [](const PID<CounterProcess>& pid) {
+        dispatch(pid, &CounterProcess::increment);
+      },
+      repeats);
+
+  run("Small argument",
+      [](const PID<CounterProcess>& pid) {
+        dispatch(pid, &CounterProcess::add, 1L);
+      },
+      repeats);
+
+  const vector<long> ns(4, 1);
+
+  run("Vector argument",
+      [&ns](const PID<CounterProcess>& pid) {
+        dispatch(pid, &CounterProcess::addAll, ns);
+      },
+      repeats * static_cast<long>(ns.size()));
+}
+
+
+// A process in a ring of processes, which passes each token it
+// receives on to the next process in the ring.
+class RingProcess : public Process<RingProcess>
+{
+public:
+  explicit RingProcess(CountDownLatch* latch) : latch(latch) {}
+
+  void pass(long hops)
+  {
+    if (hops == 0) {
+      latch->decrement();
+      return;
+    }
+
+    dispatch(next, &RingProcess::pass, hops - 1);
+  }
+
+  PID<RingProcess> next;
+
+private:
+  CountDownLatch* latch;
+};
+
+
+// Measures the throughput of dispatches between many processes, which
+// is dominated by the run queue. With a single token only one process
+// is runnable at a time, which shows the cost of handing a process
+// from one worker to another. With more tokens than workers all
+// workers are busy, which shows the contention on the run queue.
+TEST(ProcessTest, Process_BENCHMARK_DispatchRing)
+{
+  constexpr long numberOfProcesses = 1000;
+  constexpr long totalHops = 1000000;
+
+  const long workers = process::workers();
+
+  foreach (long tokens, vector<long>({1L, workers, 10 * workers})) {
+    CountDownLatch latch(tokens);
+
+    vector<Owned<RingProcess>> ring;
+    for (long i = 0; i < numberOfProcesses; i++) {
+      ring.push_back(Owned<RingProcess>(new RingProcess(&latch)));
+    }
+
+    for (long i = 0; i < numberOfProcesses; i++) {
+      ring[i]->next = ring[(i + 1) % numberOfProcesses]->self();
+      spawn(*ring[i]);
+    }
+
+    Stopwatch watch;
+    watch.start();
+
+    for (long i = 0; i < tokens; i++) {
+      dispatch(
+          ring[(i * numberOfProcesses) / tokens]->self(),
+          &RingProcess::pass,
+          totalHops / tokens);
+    }
+
+    AWAIT_READY(latch.triggered());
+
+    Duration elapsed = watch.elapsed();
+
+    cout << tokens << " token(s) across " << numberOfProcesses
+         << " processes on " << workers << " workers: "
+         << std::fixed << (totalHops / elapsed.secs()) << " dispatches/s"
+         << endl;
+
+    foreach (const Owned<RingProcess>& process, ring) {
+      terminate(process->self());
+      wait(process->self());
+    }
+  }
+}
+
+
 class ProtobufInstallHandlerBenchmarkProcess
   : public ProtobufProcess<ProtobufInstallHandlerBenchmarkProcess>
 {
@@ -681,3 +978,201 @@ TEST(ProcessTest, Process_BENCHMARK_ProtobufInstallHandler)
     process.run(num_submessages);
   }
 }
+
+
+// Measures the cost of creating and canceling timers, e.g., for the
+// timeouts of offers or of pings, while many timers are pending.
+TEST(ProcessTest, Process_BENCHMARK_Timers)
+{
+  const size_t counts[] = {10000, 100000, 1000000};
+
+  foreach (size_t count, counts) {
+    vector<process::Timer> timers;
+    timers.reserve(count);
+
+    Stopwatch watch;
+    watch.start();
+
+    for (size_t i = 0; i < count; i++) {
+      // Spread the timeouts over an hour, like timeouts of minutes.
+      timers.push_back(process::Clock::timer(
+          Milliseconds(1 + (i * 7919) % 3600000), []() {}));
+    }
+
+    const Duration created = watch.elapsed();
+
+    watch.start();
+
+    foreach (const process::Timer& timer, timers) {
+      process::Clock::cancel(timer);
+    }
+
+    watch.stop();
+
+    cout << "Created " << count << " timers in " << created
+         << " and canceled them in " << watch.elapsed() << endl;
+  }
+}
+
+
+#ifndef __WINDOWS__
+// Measures the latency of launching subprocesses depending on the
+// memory used by the parent, with and without a child hook. A child
+// hook requires forking the parent, which copies its page tables,
+// while subprocesses without hooks get spawned.
+TEST(ProcessTest, Process_BENCHMARK_Subprocess)
+{
+  constexpr size_t repeats = 100;
+
+  const Bytes sizes[] = {Bytes(0), Megabytes(256), Gigabytes(1)};
+
+  foreach (const Bytes& size, sizes) {
+    // Touch every page so that they are actually mapped.
+    vector<char> memory(size.bytes(), 1);
+
+    foreach (bool hook, vector<bool>({false, true})) {
+      vector<Subprocess::ChildHook> hooks;
+      if (hook) {
+        hooks.push_back(Subprocess::ChildHook::CHDIR(os::getcwd()));
+      }
+
+      Stopwatch watch;
+      watch.start();
+
+      for (size_t i = 0; i < repeats; i++) {
+        Try<Subprocess> s = process::subprocess(
+            "true",
+            {"true"},
+            Subprocess::PATH(os::DEV_NULL),
+            Subprocess::PATH(os::DEV_NULL),
+            Subprocess::PATH(os::DEV_NULL),
+            nullptr,
+            None(),
+            None(),
+            {},
+            hooks);
+
+        ASSERT_SOME(s);
+        AWAIT_READY(s->status());
+      }
+
+      watch.stop();
+
+      cout << "Launched " << repeats << " subprocesses "
+           << (hook ? "with" : "without") << " a child hook from a parent"
+           << " using " << size << " in " << watch.elapsed() << endl;
+    }
+  }
+}
+#endif // __WINDOWS__
+
+
+// Measures parsing and writing a JSON document like the state of a
+// cluster, comparing the parser building `JSON::Value`s directly with
+// parsing into picojson values first and converting them.
+TEST(ProcessTest, Process_BENCHMARK_JSON)
+{
+  JSON::Array tasks;
+  for (size_t i = 0; i < 50000; i++) {
+    JSON::Object task;
+    task.values["id"] = "task-" + stringify(i);
+    task.values["name"] = "a task named \"" + stringify(i) + "\"";
+    task.values["state"] = "TASK_RUNNING";
+    task.values["cpus"] = 0.5;
+    task.values["mem"] = 1024;
+    task.values["labels"] = JSON::Array({"label1", "label2"});
+
+    tasks.values.push_back(task);
+  }
+
+  Stopwatch watch;
+  watch.start();
+
+  const string json = jsonify(tasks);
+
+  watch.stop();
+
+  cout << "Wrote " << Bytes(json.size()) << " of JSON in "
+       << watch.elapsed() << endl;
+
+  watch.start();
+
+  picojson::value value;
+  const string error = picojson::parse(value, json);
+  ASSERT_TRUE(error.empty()) << error;
+
+  const JSON::Value converted = JSON::internal::convert(value);
+
+  watch.stop();
+
+  cout << "Parsed the JSON through picojson values in "
+       << watch.elapsed() << endl;
+
+  watch.start();
+
+  Try<JSON::Value> parsed = JSON::parse(json);
+  ASSERT_SOME(parsed);
+
+  watch.stop();
+
+  cout << "Parsed the JSON in " << watch.elapsed() << endl;
+
+  EXPECT_EQ(converted, parsed.get());
+}
+
+
+// Measures converting a large protobuf message to and from JSON, like
+// the calls and events of the HTTP APIs, comparing the conversions
+// through `JSON::Value`s with the direct ones.
+TEST(ProcessTest, Process_BENCHMARK_ProtobufJSON)
+{
+  tests::Message message;
+  for (int i = 0; i < 50000; i++) {
+    tests::Message* submessage = message.add_submessages();
+    submessage->add_payload(i);
+    submessage->add_payload(-i);
+    submessage->add_submessages()->add_payload(i);
+  }
+
+  Stopwatch watch;
+  watch.start();
+
+  const string json = stringify(JSON::protobuf(message));
+
+  watch.stop();
+
+  cout << "Converted the message to JSON through a JSON::Object in "
+       << watch.elapsed() << endl;
+
+  watch.start();
+
+  const string written = jsonify(JSON::Protobuf(message));
+
+  watch.stop();
+
+  cout << "Converted the message to JSON in " << watch.elapsed() << endl;
+
+  watch.start();
+
+  Try<JSON::Value> value = JSON::parse(json);
+  ASSERT_SOME(value);
+
+  Try<tests::Message> parse = protobuf::parse<tests::Message>(value.get());
+  ASSERT_SOME(parse);
+
+  watch.stop();
+
+  cout << "Converted JSON to the message through a JSON::Value in "
+       << watch.elapsed() << endl;
+
+  watch.start();
+
+  Try<tests::Message> parseJSON = protobuf::parseJSON<tests::Message>(written);
+  ASSERT_SOME(parseJSON);
+
+  watch.stop();
+
+  cout << "Converted JSON to the message in " << watch.elapsed() << endl;
+
+  EXPECT_EQ(parse->SerializeAsString(), parseJSON->SerializeAsString());
+}
@@ -13,6 +13,7 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <utility>
 
 #include <process/clock.hpp>
 #include <process/future.hpp>
@@ -668,6 +669,32 @@ TEST(FutureTest, FromTry)
 }
 
 
+// This test verifies that constructing a future from an rvalue, or
+// from an rvalue `Try`, moves the value rather than copying it.
+TEST(FutureTest, FromRvalue)
+{
+  struct Copyable
+  {
+    Copyable() : copies(0) {}
+    Copyable(const Copyable& that) : copies(that.copies + 1) {}
+    Copyable(Copyable&& that) : copies(that.copies) {}
+
+    int copies;
+  };
+
+  Future<Copyable> future = Copyable();
+
+  ASSERT_TRUE(future.isReady());
+  EXPECT_EQ(0, future->copies);
+
+  Try<Copyable> t = Copyable();
+  future = std::move(t);
+
+  ASSERT_TRUE(future.isReady());
+  EXPECT_EQ(0, future->copies);
+}
+
+
 TEST(FutureTest, FromTryFuture)
 {
   Try<Future<int>> t = 1;
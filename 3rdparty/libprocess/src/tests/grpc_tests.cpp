@@ -15,6 +15,7 @@
 // limitations under the License.
 
 #include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 
@@ -22,6 +23,7 @@
 #include <process/grpc.hpp>
 #include <process/gtest.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/path.hpp>
 #include <stout/try.hpp>
 
@@ -35,6 +37,7 @@ namespace client = process::grpc::client;
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
+using std::vector;
 
 using ::grpc::InsecureServerCredentials;
 using ::grpc::Server;
@@ -194,6 +197,34 @@ TEST_F(GRPCClientTest, ConcurrentRPCs)
 }
 
 
+// This test verifies that the gRPC calls spread over the completion
+// queues of a runtime with several workers all get processed, and that
+// the runtime terminates once all of its looper threads are joined.
+TEST_F(GRPCClientTest, MultipleWorkers)
+{
+  PingPongServer server;
+  ASSERT_SOME(server.Startup(server_address()));
+
+  client::Runtime runtime(3);
+  Channel channel(server_address());
+
+  vector<Future<RpcResult<Pong>>> pongs;
+  for (int i = 0; i < 10; i++) {
+    pongs.push_back(runtime.call(channel, GRPC_RPC(PingPong, Send), Ping()));
+  }
+
+  foreach (const Future<RpcResult<Pong>>& pong, pongs) {
+    AWAIT_ASSERT_READY(pong);
+    EXPECT_TRUE(pong->status.ok());
+  }
+
+  runtime.terminate();
+  AWAIT_ASSERT_READY(runtime.wait());
+
+  ASSERT_SOME(server.Shutdown());
+}
+
+
 // This test verifies that a gRPC future fails when the server responds
 // with a status other than OK for the given call.
 TEST_F(GRPCClientTest, Failed)
@@ -232,6 +232,37 @@ INSTANTIATE_TEST_CASE_P(
 // TODO(vinod): Use AWAIT_EXPECT_RESPONSE_STATUS_EQ in the tests.
 
 
+// This test verifies that an HTTP/2 connection preface is answered
+// with a GOAWAY frame requiring HTTP/1.1, so that HTTP/2 clients can
+// fall back to HTTP/1.1.
+TEST_P(HTTPTest, HTTP2Preface)
+{
+  Http http;
+
+  Try<inet::Socket> create = inet::Socket::create();
+  ASSERT_SOME(create);
+
+  inet::Socket socket = create.get();
+
+  AWAIT_READY(socket.connect(http.process->self().address));
+
+  AWAIT_READY(socket.send("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"));
+
+  // An empty SETTINGS frame followed by the GOAWAY frame.
+  const char frames[] = {
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x08, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d};
+
+  AWAIT_EXPECT_EQ(
+      string(frames, sizeof(frames)),
+      socket.recv(sizeof(frames)));
+
+  // The connection should get closed afterwards.
+  AWAIT_EXPECT_EQ("", socket.recv(1));
+}
+
+
 TEST_P(HTTPTest, Endpoints)
 {
   Http http;
@@ -1010,6 +1041,61 @@ TEST(HTTPConnectionTest, GzipRequestBody)
 }
 
 
+// This test verifies that a streamed response is gzip compressed when
+// the client accepts it, and that each chunk can be decompressed as
+// soon as it is received.
+TEST(HTTPConnectionTest, GzipStreamedResponse)
+{
+  Http http;
+
+  http::URL url = http::URL(
+      "http",
+      http.process->self().address.ip,
+      http.process->self().address.port,
+      http.process->self().id + "/pipe");
+
+  Future<http::Connection> connect = http::connect(url);
+  AWAIT_READY(connect);
+
+  http::Connection connection = connect.get();
+
+  http::Pipe pipe;
+  http::OK ok;
+  ok.type = http::Response::PIPE;
+  ok.reader = pipe.reader();
+
+  EXPECT_CALL(*http.process, pipe(_))
+    .WillOnce(Return(ok));
+
+  http::Request request;
+  request.method = "GET";
+  request.url = url;
+  request.keepAlive = true;
+  request.headers["Accept-Encoding"] = "gzip";
+
+  Future<http::Response> response = connection.send(request, true);
+
+  AWAIT_READY(response);
+  EXPECT_SOME_EQ("gzip", response->headers.get("Content-Encoding"));
+  ASSERT_SOME(response->reader);
+
+  http::Pipe::Reader reader = response->reader.get();
+  http::Pipe::Writer writer = pipe.writer();
+
+  EXPECT_TRUE(writer.write("Hello "));
+  AWAIT_EQ("Hello ", reader.read());
+
+  EXPECT_TRUE(writer.write("World\n"));
+  AWAIT_EQ("World\n", reader.read());
+
+  EXPECT_TRUE(writer.close());
+  AWAIT_EQ("", reader.read());
+
+  AWAIT_READY(connection.disconnect());
+  AWAIT_READY(connection.disconnected());
+}
+
+
 TEST(HTTPConnectionTest, Serial)
 {
   Http http;
@@ -1185,6 +1271,82 @@ TEST(HTTPConnectionTest, Pipeline)
 }
 
 
+// This test verifies that a response to a request pipelined behind a
+// streaming response is only sent once the stream is finished.
+TEST(HTTPConnectionTest, PipelineBehindStream)
+{
+  Http http;
+
+  http::URL url = http::URL(
+      "http",
+      http.process->self().address.ip,
+      http.process->self().address.port,
+      http.process->self().id + "/pipe");
+
+  Future<http::Connection> connect = http::connect(url);
+  AWAIT_READY(connect);
+
+  http::Connection connection = connect.get();
+
+  http::Pipe pipe;
+  http::OK ok;
+  ok.type = http::Response::PIPE;
+  ok.reader = pipe.reader();
+
+  EXPECT_CALL(*http.process, pipe(_))
+    .WillOnce(Return(ok));
+
+  http::Request request1;
+  request1.method = "GET";
+  request1.url = url;
+  request1.keepAlive = true;
+
+  Future<http::Response> response1 = connection.send(request1, true);
+
+  AWAIT_READY(response1);
+  ASSERT_SOME(response1->reader);
+
+  http::Pipe::Reader reader = response1->reader.get();
+  http::Pipe::Writer writer = pipe.writer();
+
+  EXPECT_TRUE(writer.write("1"));
+  AWAIT_EQ("1", reader.read());
+
+  // Pipeline a request while the first response is being streamed.
+  Future<http::Request> get;
+  EXPECT_CALL(*http.process, get(_))
+    .WillOnce(DoAll(FutureArg<0>(&get),
+                    Return(http::OK("2"))));
+
+  http::Request request2;
+  request2.method = "GET";
+  request2.url = http::URL(
+      "http",
+      http.process->self().address.ip,
+      http.process->self().address.port,
+      http.process->self().id + "/get");
+  request2.keepAlive = true;
+
+  Future<http::Response> response2 = connection.send(request2);
+
+  AWAIT_READY(get);
+
+  EXPECT_TRUE(writer.write("3"));
+  AWAIT_EQ("3", reader.read());
+
+  EXPECT_TRUE(response2.isPending());
+
+  EXPECT_TRUE(writer.close());
+  AWAIT_EQ("", reader.read());
+
+  AWAIT_READY(response2);
+  EXPECT_EQ("2", response2->body);
+
+  AWAIT_READY(connection.disconnect());
+  AWAIT_READY(connection.disconnected());
+}
+
+
 TEST(HTTPConnectionTest, ClosingRequest)
 {
   Http http;
@@ -1422,6 +1584,90 @@ TEST(HTTPConnectionTest, RequestStreaming)
 // incorrect) results across platforms. Fix and enable the test on Windows. In
 // particular, the encoding in the 3rd example puts the first variable into the
 // query string before the second, but we expect the reverse. See MESOS-5814.
+// Tests that sequential requests sent through a connection pool
+// reuse the same keep-alive connection.
+TEST(HTTPConnectionPoolTest, Reuse)
+{
+  Http http;
+
+  http::URL url = http::URL(
+      "http",
+      http.process->self().address.ip,
+      http.process->self().address.port,
+      http.process->self().id + "/get");
+
+  http::ConnectionPool pool("reuse");
+
+  Future<http::Request> get1, get2;
+
+  EXPECT_CALL(*http.process, get(_))
+    .WillOnce(DoAll(FutureArg<0>(&get1), Return(http::OK("1"))))
+    .WillOnce(DoAll(FutureArg<0>(&get2), Return(http::OK("2"))));
+
+  http::Request request;
+  request.method = "GET";
+  request.url = url;
+
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("1", pool.request(request));
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("2", pool.request(request));
+
+  AWAIT_READY(get1);
+  AWAIT_READY(get2);
+
+  EXPECT_TRUE(get1->keepAlive);
+  ASSERT_SOME(get1->client);
+  EXPECT_EQ(get1->client, get2->client);
+}
+
+
+// Tests that requests beyond the maximum number of connections to
+// an origin are queued until a connection becomes available.
+TEST(HTTPConnectionPoolTest, MaxConnectionsPerOrigin)
+{
+  Http http;
+
+  http::URL url = http::URL(
+      "http",
+      http.process->self().address.ip,
+      http.process->self().address.port,
+      http.process->self().id + "/get");
+
+  http::ConnectionPool::Options options =
+    http::ConnectionPool::DEFAULT_OPTIONS();
+  options.max_connections_per_origin = 1;
+
+  http::ConnectionPool pool("max_connections_per_origin", options);
+
+  Promise<http::Response> promise1;
+  Future<http::Request> get1, get2;
+
+  EXPECT_CALL(*http.process, get(_))
+    .WillOnce(DoAll(FutureArg<0>(&get1), Return(promise1.future())))
+    .WillOnce(DoAll(FutureArg<0>(&get2), Return(http::OK("2"))));
+
+  http::Request request;
+  request.method = "GET";
+  request.url = url;
+
+  Future<http::Response> response1 = pool.request(request);
+  Future<http::Response> response2 = pool.request(request);
+
+  AWAIT_READY(get1);
+
+  // The second request must wait for the only connection.
+  EXPECT_TRUE(get2.isPending());
+  EXPECT_TRUE(response2.isPending());
+
+  promise1.set(http::OK("1"));
+
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("1", response1);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("2", response2);
+
+  AWAIT_READY(get2);
+  EXPECT_EQ(get1->client, get2->client);
+}
+
+
 TEST_P_TEMP_DISABLED_ON_WINDOWS(HTTPTest, QueryEncodeDecode)
 {
   // If we use Type<a, b> directly inside a macro without surrounding
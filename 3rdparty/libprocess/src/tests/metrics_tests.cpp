@@ -12,6 +12,7 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -30,7 +31,10 @@
 
 #include <process/metrics/counter.hpp>
 #include <process/metrics/gauge.hpp>
+#include <process/metrics/histogram.hpp>
 #include <process/metrics/metrics.hpp>
+#include <process/metrics/push_gauge.hpp>
+#include <process/metrics/sampled_gauge.hpp>
 #include <process/metrics/timer.hpp>
 
 namespace authentication = process::http::authentication;
@@ -47,6 +51,9 @@ using http::Unauthorized;
 
 using metrics::Counter;
 using metrics::Gauge;
+using metrics::Histogram;
+using metrics::PushGauge;
+using metrics::SampledGauge;
 using metrics::Timer;
 
 using process::Clock;
@@ -141,6 +148,100 @@ TEST_F(MetricsTest, Counter)
 }
 
 
+TEST_F(MetricsTest, PushGauge)
+{
+  PushGauge gauge("test/push_gauge", process::TIME_SERIES_WINDOW);
+
+  // We have to pause the clock to ensure the time series
+  // entries are unique.
+  Clock::pause();
+
+  AWAIT_READY(metrics::add(gauge));
+
+  AWAIT_EXPECT_EQ(0.0, gauge.value());
+
+  // Nothing is recorded in the history until a value is set.
+  EXPECT_NONE(gauge.statistics());
+
+  gauge = 42;
+  AWAIT_EXPECT_EQ(42.0, gauge.value());
+
+  Clock::advance(Seconds(1));
+
+  gauge = 2;
+  AWAIT_EXPECT_EQ(2.0, gauge.value());
+
+  Option<Statistics<double>> statistics = gauge.statistics();
+  ASSERT_SOME(statistics);
+
+  EXPECT_EQ(2u, statistics->count);
+  EXPECT_FLOAT_EQ(2.0, statistics->min);
+  EXPECT_FLOAT_EQ(42.0, statistics->max);
+
+  AWAIT_READY(metrics::remove(gauge));
+
+  Clock::resume();
+}
+
+
+// This test verifies that a sampled gauge returns the cached value of
+// its last sample, and omits it once it gets stale.
+TEST_F(MetricsTest, SampledGauge)
+{
+  Clock::pause();
+
+  std::atomic<int> samples(0);
+  std::atomic_bool block(false);
+  Promise<double> promise;
+
+  SampledGauge gauge(
+      "test/sampled_gauge",
+      [&]() -> Future<double> {
+        if (block.load()) {
+          return promise.future();
+        }
+        return ++samples;
+      },
+      Seconds(10),
+      Seconds(30));
+
+  AWAIT_READY(metrics::add(gauge));
+
+  AWAIT_EXPECT_EQ(1.0, gauge.value());
+
+  // Reading the value does not take a sample.
+  AWAIT_EXPECT_EQ(1.0, gauge.value());
+  EXPECT_EQ(1, samples.load());
+
+  Clock::advance(Seconds(10));
+  Clock::settle();
+
+  AWAIT_EXPECT_EQ(2.0, gauge.value());
+
+  // While a sample is pending the cached value keeps being returned,
+  // until it exceeds the staleness bound.
+  block.store(true);
+
+  Clock::advance(Seconds(10));
+  Clock::settle();
+
+  AWAIT_EXPECT_EQ(2.0, gauge.value());
+
+  Clock::advance(Seconds(30));
+  Clock::settle();
+
+  AWAIT_EXPECT_FAILED(gauge.value());
+
+  promise.set(5.0);
+
+  AWAIT_EXPECT_EQ(5.0, gauge.value());
+
+  AWAIT_READY(metrics::remove(gauge));
+
+  Clock::resume();
+}
+
+
 TEST_F(MetricsTest, THREADSAFE_Gauge)
 {
   GaugeProcess process;
@@ -204,6 +305,82 @@ TEST_F(MetricsTest, Statistics)
 }
 
 
+TEST_F(MetricsTest, Histogram)
+{
+  Histogram histogram("test/histogram");
+
+  AWAIT_READY(metrics::add(histogram));
+
+  // A histogram needs two values for its statistics, like a metric
+  // with a window.
+  histogram.record(1.0);
+  EXPECT_NONE(histogram.statistics());
+
+  for (size_t i = 2; i <= 1000; ++i) {
+    histogram.record(static_cast<double>(i));
+  }
+
+  AWAIT_EXPECT_EQ(1000.0, histogram.value());
+
+  Option<Statistics<double>> statistics = histogram.statistics();
+  ASSERT_SOME(statistics);
+
+  EXPECT_EQ(1000u, statistics->count);
+
+  EXPECT_FLOAT_EQ(1.0, statistics->min);
+  EXPECT_FLOAT_EQ(1000.0, statistics->max);
+
+  // The percentiles are accurate to within the width of a bucket.
+  EXPECT_NEAR(500.0, statistics->p50, 500.0 * 0.04);
+  EXPECT_NEAR(900.0, statistics->p90, 900.0 * 0.04);
+  EXPECT_NEAR(990.0, statistics->p99, 990.0 * 0.04);
+  EXPECT_GE(1000.0, statistics->p9999);
+
+  // Merging a histogram adds its values.
+  Histogram other("test/other");
+  other.record(0.0);
+  other.record(5000.0);
+
+  histogram.merge(other);
+
+  statistics = histogram.statistics();
+  ASSERT_SOME(statistics);
+
+  EXPECT_EQ(1002u, statistics->count);
+
+  EXPECT_FLOAT_EQ(0.0, statistics->min);
+  EXPECT_FLOAT_EQ(5000.0, statistics->max);
+  EXPECT_NEAR(500.0, statistics->p50, 500.0 * 0.04);
+
+  // The percentiles are exported by the snapshot endpoint.
+  UPID upid("metrics", process::address());
+
+  Future<Response> response = http::get(upid, "snapshot");
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+
+  Try<JSON::Object> responseJSON =
+    JSON::parse<JSON::Object>(response->body);
+
+  ASSERT_SOME(responseJSON);
+
+  Result<JSON::Number> value =
+    responseJSON->at<JSON::Number>("test/histogram");
+
+  ASSERT_SOME(value);
+  EXPECT_FLOAT_EQ(1002.0, value->as<double>());
+
+  Result<JSON::Number> count =
+    responseJSON->at<JSON::Number>("test/histogram/count");
+
+  ASSERT_SOME(count);
+  EXPECT_FLOAT_EQ(1002.0, count->as<double>());
+
+  EXPECT_SOME(responseJSON->at<JSON::Number>("test/histogram/p99"));
+
+  AWAIT_READY(metrics::remove(histogram));
+}
+
+
 TEST_F(MetricsTest, THREADSAFE_Snapshot)
 {
   UPID upid("metrics", process::address());
@@ -25,8 +25,10 @@
 #endif // __WINDOWS__
 
 #include <atomic>
+#include <chrono>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <process/async.hpp>
@@ -64,6 +66,7 @@
 #include <stout/os/write.hpp>
 
 #include "encoder.hpp"
+#include "tracer.hpp"
 
 namespace http = process::http;
 namespace inject = process::inject;
@@ -96,6 +99,7 @@ using process::firewall::FirewallRule;
 
 using process::network::inet::Address;
 using process::network::inet::Socket;
+using process::network::internal::SocketImpl;
 
 using std::move;
 using std::string;
@@ -1203,6 +1207,25 @@ TEST(ProcessTest, THREADSAFE_Pid)
 }
 
 
+// This test verifies that a UPID gets parsed from its string
+// representation, ignoring any surrounding whitespace.
+TEST(ProcessTest, ParsePid)
+{
+  UPID pid(" sender@127.0.0.1:5050\n");
+
+  EXPECT_EQ("sender", pid.id);
+  EXPECT_EQ(net::IP::parse("127.0.0.1", AF_INET).get(), pid.address.ip);
+  EXPECT_EQ(5050, pid.address.port);
+
+  EXPECT_EQ(pid, UPID(stringify(pid)));
+
+  // Malformed UPIDs are empty.
+  EXPECT_EQ(UPID(), UPID("sender"));
+  EXPECT_EQ(UPID(), UPID("sender@127.0.0.1"));
+  EXPECT_EQ(UPID(), UPID("sender@127.0.0.1:port"));
+}
+
+
 class Listener1 : public Process<Listener1>
 {
 public:
@@ -1396,6 +1419,169 @@ TEST(ProcessTest, THREADSAFE_Remote)
 }
 
 
+// Verifies that the events served by a process are accounted for in
+// the '/__processes__' endpoint, by type and by message name.
+TEST(ProcessTest, THREADSAFE_EventStatistics)
+{
+  RemoteProcess process;
+  PID<RemoteProcess> pid = spawn(process);
+
+  Future<Nothing> handler;
+  EXPECT_CALL(process, handler(_, _))
+    .WillOnce(FutureSatisfy(&handler));
+
+  post(pid, "handler");
+
+  AWAIT_READY(handler);
+
+  // Make sure the message has been accounted for, which happens after
+  // the handler returns.
+  AWAIT_READY(dispatch(pid, []() { return Nothing(); }));
+
+  http::URL url = http::URL(
+      "http",
+      process::address().ip,
+      process::address().port,
+      "/__processes__");
+
+  Future<http::Response> response = http::get(url);
+
+  AWAIT_READY(response);
+  ASSERT_EQ(http::Status::OK, response->code);
+
+  Try<JSON::Array> processes = JSON::parse<JSON::Array>(response->body);
+  ASSERT_SOME(processes);
+
+  Option<JSON::Object> statistics;
+  foreach (const JSON::Value& value, processes->values) {
+    ASSERT_TRUE(value.is<JSON::Object>());
+
+    const JSON::Object& object = value.as<JSON::Object>();
+
+    Result<JSON::String> id = object.at<JSON::String>("id");
+    ASSERT_SOME(id);
+
+    if (id->value == pid.id) {
+      Result<JSON::Object> result = object.at<JSON::Object>("statistics");
+      ASSERT_SOME(result);
+      statistics = result.get();
+    }
+  }
+
+  ASSERT_SOME(statistics);
+
+  EXPECT_SOME_EQ(
+      JSON::Number(1),
+      statistics->find<JSON::Number>("messages.handler.count"));
+
+  EXPECT_SOME_EQ(
+      JSON::Number(1),
+      statistics->find<JSON::Number>("types.MESSAGE.count"));
+
+  Result<JSON::Number> dispatches =
+    statistics->find<JSON::Number>("types.DISPATCH.count");
+
+  ASSERT_SOME(dispatches);
+  EXPECT_LE(1u, dispatches->as<uint64_t>());
+
+  terminate(process);
+  wait(process);
+}
+
+
+// Verifies that the tracer only keeps the most recent records and
+// dumps them in the Chrome trace event format.
+TEST(ProcessTest, Tracer)
+{
+  process::Tracer tracer(2);
+
+  const uint64_t trace = tracer.trace();
+
+  for (int i = 0; i < 3; i++) {
+    process::Tracer::Record record;
+    record.phase = 'X';
+    record.category = "MESSAGE";
+    record.name = "message" + stringify(i);
+    record.process = "process";
+    record.trace = trace;
+    record.started = std::chrono::steady_clock::now();
+    record.served = std::chrono::milliseconds(1);
+    record.queued = std::chrono::milliseconds(2);
+    record.thread = std::this_thread::get_id();
+
+    tracer.record(std::move(record));
+  }
+
+  JSON::Object json = tracer.json();
+
+  Result<JSON::Array> events = json.at<JSON::Array>("traceEvents");
+  ASSERT_SOME(events);
+  ASSERT_EQ(2u, events->values.size());
+
+  ASSERT_TRUE(events->values[0].is<JSON::Object>());
+  const JSON::Object& event = events->values[0].as<JSON::Object>();
+
+  EXPECT_SOME_EQ(JSON::String("message1"), event.at<JSON::String>("name"));
+  EXPECT_SOME_EQ(JSON::String("X"), event.at<JSON::String>("ph"));
+  EXPECT_SOME_EQ(JSON::Number(1000), event.at<JSON::Number>("dur"));
+  EXPECT_SOME_EQ(JSON::Number(trace), event.find<JSON::Number>("args.trace"));
+  EXPECT_SOME_EQ(
+      JSON::Number(2000),
+      event.find<JSON::Number>("args.queued_us"));
+}
+
+
+// Like the 'remote' test but sends a large message using the gather
+// writes of a `MessageEncoder`.
+TEST(ProcessTest, THREADSAFE_RemoteGather)
+{
+  RemoteProcess process;
+  spawn(process);
+
+  const string body(4 * 1024 * 1024, 'x');
+
+  Future<Nothing> handler;
+  EXPECT_CALL(process, handler(_, body))
+    .WillOnce(FutureSatisfy(&handler));
+
+  Try<Socket> create = Socket::create();
+  ASSERT_SOME(create);
+
+  Socket socket = create.get();
+
+  AWAIT_READY(socket.connect(process.self().address));
+
+  Try<Address> sender = socket.address();
+  ASSERT_SOME(sender);
+
+  Message message;
+  message.name = "handler";
+  message.from = UPID("sender", sender.get());
+  message.to = process.self();
+  message.body = body;
+
+  const string data = MessageEncoder::encode(message);
+
+  MessageEncoder encoder(std::move(message));
+  EXPECT_EQ(data.size(), encoder.remaining());
+
+  while (encoder.remaining() > 0) {
+    vector<SocketImpl::Segment> segments;
+    size_t size = encoder.next(&segments);
+
+    Future<size_t> length = socket.send(segments);
+    AWAIT_READY(length);
+
+    encoder.backup(size - length.get());
+  }
+
+  AWAIT_READY(handler);
+
+  terminate(process);
+  wait(process);
+}
+
+
 // Like the 'remote' test but uses http::connect.
 TEST(ProcessTest, THREADSAFE_Http1)
 {
@@ -13,6 +13,7 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <vector>
 
 #include <stout/duration.hpp>
 #include <stout/gtest.hpp>
@@ -40,6 +41,7 @@ using process::READWRITE_HTTP_AUTHENTICATION_REALM;
 using process::UPID;
 
 using std::string;
+using std::vector;
 
 
 // TODO(greggomann): Move this into a base class in 'mesos.hpp'.
@@ -134,3 +136,50 @@ TEST_F(ProfilerTest, StartAndStopAuthenticationEnabled)
   response = http::get(upid, "stop");
   AWAIT_EXPECT_RESPONSE_STATUS_EQ(Unauthorized({}).status, response);
 }
+
+
+// Tests that the memory profiler's HTTP endpoints return the correct
+// responses based on whether or not perftools has been enabled.
+TEST_F(ProfilerTest, MemoryProfilerStatistics)
+{
+  UPID upid("memory-profiler", process::address());
+
+  Future<Response> response = http::get(upid, "statistics");
+#ifdef ENABLE_GPERFTOOLS
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+
+  response = http::get(upid, "stop");
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(BadRequest().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("Heap profiler not running.\n", response);
+#else
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(BadRequest().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(
+      "Perftools is disabled. To enable perftools, "
+      "configure libprocess with --enable-perftools.\n",
+      response);
+#endif
+}
+
+
+// Tests that the memory profiler's HTTP endpoints reject
+// unauthenticated requests when HTTP authentication is enabled.
+TEST_F(ProfilerTest, MemoryProfilerAuthenticationEnabled)
+{
+  process::Owned<Authenticator> authenticator(
+    new BasicAuthenticator(
+        READWRITE_HTTP_AUTHENTICATION_REALM, {{"foo", "bar"}}));
+
+  AWAIT_READY(
+      setAuthenticator(READWRITE_HTTP_AUTHENTICATION_REALM, authenticator));
+
+  UPID upid("memory-profiler", process::address());
+
+  const vector<string> endpoints = {
+    "start", "stop", "download/heap", "heap_sample", "statistics"};
+
+  foreach (const string& endpoint, endpoints) {
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(
+        Unauthorized({}).status,
+        http::get(upid, endpoint));
+  }
+}
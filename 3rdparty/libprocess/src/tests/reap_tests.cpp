@@ -15,6 +15,10 @@
 
 #include <sys/wait.h>
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
 #include <gtest/gtest.h>
 
 #include <process/clock.hpp>
@@ -173,3 +177,39 @@ TEST(ReapTest, THREADSAFE_TerminatedChildProcess)
 
   Clock::resume();
 }
+
+
+#if defined(__linux__) && defined(SYS_pidfd_open)
+// This test checks that a child process gets reaped without the
+// reaper polling it when the kernel supports pidfds.
+TEST(ReapTest, THREADSAFE_ChildProcessPidfd)
+{
+  int pidfd = ::syscall(SYS_pidfd_open, ::getpid(), 0);
+  if (pidfd < 0) {
+    LOG(WARNING) << "Skipping the test as pidfds are not supported";
+    return;
+  }
+
+  ::close(pidfd);
+
+  Try<ProcessTree> tree = Fork(None(),
+                               Exec("sleep 10"))();
+
+  ASSERT_SOME(tree);
+  pid_t child = tree.get();
+
+  // Pausing the clock keeps the reaper from polling the child.
+  Clock::pause();
+
+  Future<Option<int>> status = process::reap(child);
+
+  // Make sure the reaper has opened the pidfd before killing the child.
+  Clock::settle();
+
+  EXPECT_EQ(0, kill(child, SIGKILL));
+
+  AWAIT_EXPECT_WTERMSIG_EQ(SIGKILL, status);
+
+  Clock::resume();
+}
+#endif // __linux__ && SYS_pidfd_open
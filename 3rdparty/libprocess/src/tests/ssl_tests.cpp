@@ -178,6 +178,49 @@ TEST_P(SSLTest, BasicSameProcess)
 }
 
 
+// Ensure that a client reconnecting to the same server resumes the
+// TLS session of its previous connection.
+TEST_F(SSLTest, SessionResumption)
+{
+  set_environment_variables({
+      {"LIBPROCESS_SSL_ENABLED", "true"},
+      {"LIBPROCESS_SSL_KEY_FILE", key_path().string()},
+      {"LIBPROCESS_SSL_CERT_FILE", certificate_path().string()},
+      {"LIBPROCESS_SSL_ENABLE_SESSION_RESUMPTION", "true"}});
+
+  Try<Socket> server = Socket::create(SocketImpl::Kind::SSL);
+  ASSERT_SOME(server);
+
+  ASSERT_SOME(server->bind(Address(net::IP(process::address().ip), 0)));
+  ASSERT_SOME(server->listen(BACKLOG));
+
+  Try<Address> address = server->address();
+  ASSERT_SOME(address);
+
+  const string data = "Hello World!";
+
+  for (int i = 0; i < 2; i++) {
+    Try<Socket> client = Socket::create(SocketImpl::Kind::SSL);
+    ASSERT_SOME(client);
+
+    Future<Socket> accept = server->accept();
+
+    AWAIT_ASSERT_READY(client->connect(address.get()));
+    AWAIT_ASSERT_READY(accept);
+
+    Socket socket = accept.get();
+
+    // With TLS 1.3 the client only receives the session ticket after
+    // the handshake, along with the data sent by the server.
+    AWAIT_ASSERT_READY(socket.send(data));
+    AWAIT_ASSERT_EQ(data, client->recv(data.size()));
+  }
+
+  // Only the second connection could have resumed a session.
+  EXPECT_EQ(1, SSL_CTX_sess_hits(openssl::context()));
+}
+
+
 #ifndef __WINDOWS__
 TEST_P(SSLTest, BasicSameProcessUnix)
 {
@@ -878,6 +878,32 @@ TEST_F(SubprocessTest, EnvironmentOverride)
 
   AWAIT_EXPECT_WEXITSTATUS_EQ(0, s.get().status());
 }
+
+
+// This test verifies that failing to execute a subprocess launched
+// without any hooks, which gets spawned rather than forked, is still
+// reported through its exit status.
+TEST_F(SubprocessTest, NonexistentPath)
+{
+  Try<Subprocess> s = subprocess(
+      "/nonexistent/path",
+      {"path"},
+      Subprocess::FD(STDIN_FILENO),
+      Subprocess::FD(STDOUT_FILENO),
+      Subprocess::FD(STDERR_FILENO));
+
+  ASSERT_SOME(s);
+
+  // Advance time until the internal reaper reaps the subprocess.
+  Clock::pause();
+  while (s.get().status().isPending()) {
+    Clock::advance(MAX_REAP_INTERVAL());
+    Clock::settle();
+  }
+  Clock::resume();
+
+  AWAIT_EXPECT_WEXITSTATUS_EQ(ENOENT, s.get().status());
+}
 #endif // __WINDOWS__
 
 
@@ -0,0 +1,159 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#include <list>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <process/clock.hpp>
+#include <process/time.hpp>
+#include <process/timer.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/foreach.hpp>
+#include <stout/gtest.hpp>
+
+#include "timer_wheel.hpp"
+
+using process::Clock;
+using process::Time;
+using process::Timer;
+using process::TimerWheel;
+
+using std::list;
+using std::vector;
+
+
+class TimerWheelTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    Clock::pause();
+
+    wheel.reset(Clock::now());
+  }
+
+  virtual void TearDown()
+  {
+    Clock::resume();
+  }
+
+  // Returns a timer for the given duration from now, which is only
+  // added to the wheel of the test rather than to the clock.
+  Timer timer(const Duration& duration)
+  {
+    Timer timer = Clock::timer(duration, []() {});
+    Clock::cancel(timer);
+
+    wheel.add(timer);
+
+    return timer;
+  }
+
+  static vector<Time> timeouts(const list<Timer>& timers)
+  {
+    vector<Time> timeouts;
+    foreach (const Timer& timer, timers) {
+      timeouts.push_back(timer.timeout().time());
+    }
+    return timeouts;
+  }
+
+  TimerWheel wheel;
+};
+
+
+// This test verifies that timers expire in the order of their
+// timeouts, with the precision of their timeouts rather than of the
+// ticks of the wheel, across all the levels of the wheel.
+TEST_F(TimerWheelTest, Expire)
+{
+  const Time now = Clock::now();
+
+  const vector<Duration> durations = {
+    Days(100),     // Overflow.
+    Hours(1),      // Third level.
+    Seconds(10),   // Second level.
+    Microseconds(1500),
+    Microseconds(1200),
+    Nanoseconds(0)
+  };
+
+  foreach (const Duration& duration, durations) {
+    timer(duration);
+  }
+
+  EXPECT_EQ(durations.size(), wheel.size());
+  EXPECT_SOME_EQ(now, wheel.next());
+
+  EXPECT_EQ(vector<Time>({now}), timeouts(wheel.expire(now)));
+  EXPECT_SOME_EQ(now + Microseconds(1200), wheel.next());
+
+  // The timers might be in the same tick, but only one has expired.
+  EXPECT_EQ(vector<Time>({now + Microseconds(1200)}),
+            timeouts(wheel.expire(now + Microseconds(1300))));
+
+  EXPECT_EQ(vector<Time>({now + Microseconds(1500), now + Seconds(10)}),
+            timeouts(wheel.expire(now + Minutes(1))));
+
+  EXPECT_SOME_EQ(now + Hours(1), wheel.next());
+
+  EXPECT_EQ(vector<Time>({now + Hours(1), now + Days(100)}),
+            timeouts(wheel.expire(now + Days(365))));
+
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_NONE(wheel.next());
+}
+
+
+TEST_F(TimerWheelTest, Remove)
+{
+  const Time now = Clock::now();
+
+  Timer timer1 = timer(Seconds(1));
+  Timer timer2 = timer(Seconds(2));
+
+  EXPECT_SOME_EQ(now + Seconds(1), wheel.next());
+
+  EXPECT_TRUE(wheel.remove(timer1));
+  EXPECT_FALSE(wheel.remove(timer1));
+
+  EXPECT_SOME_EQ(now + Seconds(2), wheel.next());
+
+  EXPECT_EQ(vector<Time>({now + Seconds(2)}),
+            timeouts(wheel.expire(now + Seconds(3))));
+
+  // Expired timers are no longer pending.
+  EXPECT_FALSE(wheel.remove(timer2));
+}
+
+
+// This test verifies that timers added with a timeout before the
+// current time of the wheel expire the next time the wheel expires.
+TEST_F(TimerWheelTest, Late)
+{
+  const Time now = Clock::now();
+
+  wheel.expire(now + Seconds(10));
+
+  timer(Seconds(1));
+  timer(Seconds(20));
+
+  EXPECT_SOME_EQ(now + Seconds(1), wheel.next());
+
+  EXPECT_EQ(vector<Time>({now + Seconds(1)}),
+            timeouts(wheel.expire(now + Seconds(11))));
+
+  EXPECT_EQ(1u, wheel.size());
+}
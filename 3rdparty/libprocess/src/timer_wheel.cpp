@@ -0,0 +1,314 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+
+#include "timer_wheel.hpp"
+
+using std::list;
+
+namespace process {
+
+// Definitions of the constants, in case they get ODR-used.
+constexpr size_t TimerWheel::LEVELS;
+constexpr size_t TimerWheel::BITS;
+constexpr size_t TimerWheel::SLOTS;
+constexpr int TimerWheel::LEVEL_NONE;
+constexpr int TimerWheel::LEVEL_LATE;
+constexpr int TimerWheel::LEVEL_OVERFLOW;
+
+
+TimerWheel::TimerWheel(const Duration& _resolution)
+  : resolution(_resolution.ns()),
+    current(0)
+{
+  CHECK_GT(resolution, 0);
+
+  counts.fill(0);
+}
+
+
+void TimerWheel::reset(const Time& time)
+{
+  if (entries.empty()) {
+    current = tickOf(time);
+  }
+}
+
+
+void TimerWheel::add(const Timer& timer)
+{
+  CHECK(!entries.contains(timer.id));
+
+  const Time timeout = timer.timeout().time();
+
+  list<Entry> added;
+  added.push_back({timer, tickOf(timeout), LEVEL_NONE, nullptr});
+
+  // NOTE: The iterator stays valid as the entry moves between lists.
+  list<Entry>::iterator entry = added.begin();
+  entries[timer.id] = entry;
+
+  place(entry, &added);
+
+  // The earliest timeout is only known if it was cached or the timer
+  // is the only one.
+  if (earliest.isSome()) {
+    earliest = std::min(earliest.get(), timeout);
+  } else if (entries.size() == 1) {
+    earliest = timeout;
+  }
+}
+
+
+bool TimerWheel::remove(const Timer& timer)
+{
+  auto it = entries.find(timer.id);
+  if (it == entries.end()) {
+    return false;
+  }
+
+  list<Entry>::iterator entry = it->second;
+
+  if (entry->level >= 0 && entry->level < static_cast<int>(LEVELS)) {
+    counts[entry->level]--;
+  }
+
+  if (earliest.isSome() && entry->timer.timeout().time() == earliest.get()) {
+    earliest = None();
+  }
+
+  entry->slot->erase(entry);
+  entries.erase(it);
+
+  return true;
+}
+
+
+list<Timer> TimerWheel::expire(const Time& time)
+{
+  list<Entry> expired;
+
+  const int64_t target = tickOf(time);
+
+  collect(&late, time, &expired);
+
+  // The current tick might still have timers if the wheel was last
+  // expired up to a time within the tick.
+  collect(&levels[0][current & (SLOTS - 1)], time, &expired);
+
+  while (current < target) {
+    // Look for the lowest level with timers: as the levels below it
+    // are empty, no timer can expire before the current tick reaches
+    // the next slot of that level.
+    size_t lowest = 0;
+    while (lowest < LEVELS && counts[lowest] == 0) {
+      lowest++;
+    }
+
+    if (lowest == LEVELS && overflow.empty()) {
+      current = target;
+      break;
+    }
+
+    const int64_t next =
+      (current | ((static_cast<int64_t>(1) << (BITS * lowest)) - 1)) + 1;
+
+    if (next > target) {
+      current = target;
+      break;
+    }
+
+    current = next;
+
+    // Cascade the timers of the slots the current tick has reached,
+    // starting with the highest level since the cascaded timers might
+    // end up in a lower slot the current tick has reached too.
+    if ((current & ((static_cast<int64_t>(1) << (BITS * LEVELS)) - 1)) == 0) {
+      cascade(&overflow);
+    }
+
+    for (size_t level = LEVELS - 1; level > 0; level--) {
+      const int64_t mask =
+        (static_cast<int64_t>(1) << (BITS * level)) - 1;
+
+      if ((current & mask) == 0) {
+        cascade(&levels[level][(current >> (BITS * level)) & (SLOTS - 1)]);
+      }
+    }
+
+    collect(&levels[0][current & (SLOTS - 1)], time, &expired);
+  }
+
+  // The timers of the same tick, and the late ones, are not sorted.
+  expired.sort([](const Entry& left, const Entry& right) {
+    return left.timer.timeout().time() < right.timer.timeout().time();
+  });
+
+  list<Timer> timers;
+  foreach (const Entry& entry, expired) {
+    entries.erase(entry.timer.id);
+    timers.push_back(entry.timer);
+  }
+
+  if (!timers.empty()) {
+    earliest = None();
+  }
+
+  return timers;
+}
+
+
+Option<Time> TimerWheel::next()
+{
+  if (entries.empty() || earliest.isSome()) {
+    return earliest;
+  }
+
+  auto consider = [this](const list<Entry>& slot) {
+    foreach (const Entry& entry, slot) {
+      const Time timeout = entry.timer.timeout().time();
+      if (earliest.isNone() || timeout < earliest.get()) {
+        earliest = timeout;
+      }
+    }
+  };
+
+  consider(late);
+
+  // The timers of a level are all later than the timers of the levels
+  // below it, and their slots are ordered starting from the slot of
+  // the current tick. So the earliest timer is either a late one, or
+  // one in the first non-empty slot of the lowest non-empty level.
+  for (size_t level = 0; level < LEVELS; level++) {
+    if (counts[level] == 0) {
+      continue;
+    }
+
+    for (size_t slot = (current >> (BITS * level)) & (SLOTS - 1);
+         slot < SLOTS;
+         slot++) {
+      if (!levels[level][slot].empty()) {
+        consider(levels[level][slot]);
+        return earliest;
+      }
+    }
+
+    LOG(FATAL) << "Failed to find the timers of level " << level;
+  }
+
+  consider(overflow);
+
+  return earliest;
+}
+
+
+void TimerWheel::clear()
+{
+  for (size_t level = 0; level < LEVELS; level++) {
+    foreach (list<Entry>& slot, levels[level]) {
+      slot.clear();
+    }
+  }
+
+  counts.fill(0);
+  overflow.clear();
+  late.clear();
+  entries.clear();
+  earliest = None();
+}
+
+
+int64_t TimerWheel::tickOf(const Time& time) const
+{
+  return time.duration().ns() / resolution;
+}
+
+
+void TimerWheel::place(list<Entry>::iterator entry, list<Entry>* from)
+{
+  if (entry->level >= 0 && entry->level < static_cast<int>(LEVELS)) {
+    counts[entry->level]--;
+  }
+
+  int level = LEVEL_OVERFLOW;
+  list<Entry>* slot = &overflow;
+
+  if (entry->tick < current) {
+    level = LEVEL_LATE;
+    slot = &late;
+  } else {
+    // The entry goes to the lowest level whose slots share their
+    // higher bits with the current tick, i.e., the level where its
+    // slot comes after the slot of the current tick (or is the slot of
+    // the current tick in the first level).
+    for (size_t i = 0; i < LEVELS; i++) {
+      if ((entry->tick >> (BITS * (i + 1))) ==
+          (current >> (BITS * (i + 1)))) {
+        level = static_cast<int>(i);
+        slot = &levels[i][(entry->tick >> (BITS * i)) & (SLOTS - 1)];
+        counts[i]++;
+        break;
+      }
+    }
+  }
+
+  entry->level = level;
+  entry->slot = slot;
+
+  slot->splice(slot->end(), *from, entry);
+}
+
+
+void TimerWheel::cascade(list<Entry>* slot)
+{
+  list<Entry> cascaded;
+  cascaded.splice(cascaded.end(), *slot);
+
+  while (!cascaded.empty()) {
+    place(cascaded.begin(), &cascaded);
+  }
+}
+
+
+void TimerWheel::collect(
+    list<Entry>* slot,
+    const Time& time,
+    list<Entry>* expired)
+{
+  list<Entry>::iterator entry = slot->begin();
+  while (entry != slot->end()) {
+    list<Entry>::iterator next = std::next(entry);
+
+    if (entry->timer.timeout().time() <= time) {
+      if (entry->level >= 0 && entry->level < static_cast<int>(LEVELS)) {
+        counts[entry->level]--;
+      }
+
+      entry->level = LEVEL_NONE;
+      entry->slot = expired;
+
+      expired->splice(expired->end(), *slot, entry);
+    }
+
+    entry = next;
+  }
+}
+
+} // namespace process {
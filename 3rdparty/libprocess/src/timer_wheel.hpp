@@ -0,0 +1,138 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#ifndef __PROCESS_TIMER_WHEEL_HPP__
+#define __PROCESS_TIMER_WHEEL_HPP__
+
+#include <stdint.h>
+
+#include <array>
+#include <list>
+
+#include <process/time.hpp>
+#include <process/timer.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/option.hpp>
+
+namespace process {
+
+// A hierarchical timing wheel holding the pending timers of the clock.
+//
+// Time is divided into ticks of `resolution`. Each level of the wheel
+// has 256 slots: a slot of the first level holds the timers of a
+// single tick, a slot of the second level holds the timers of 256
+// ticks, and so on. A timer is added to the lowest level whose slots
+// can tell it apart from the current tick, and gets moved ("cascaded")
+// to the lower levels as the wheel advances, until it expires from the
+// first level. Timers too far in the future for the highest level are
+// kept in an overflow list.
+//
+// Adding and removing timers take constant time, and advancing the
+// wheel only visits the slots of the ticks holding timers. Timers
+// still fire with the precision of their timeout, not just of a tick.
+//
+// NOTE: This is not thread-safe, the clock synchronizes the accesses.
+class TimerWheel
+{
+public:
+  explicit TimerWheel(const Duration& resolution = Milliseconds(1));
+
+  // Sets the current time of the wheel, if it has no timers.
+  //
+  // NOTE: The wheel is correct for any added timer and any time it
+  // expires the timers up to, but timers added before the current
+  // time of the wheel have to be scanned until they expire.
+  void reset(const Time& time);
+
+  void add(const Timer& timer);
+
+  // Returns whether the timer was pending, in which case it has been
+  // removed.
+  bool remove(const Timer& timer);
+
+  // Removes and returns the timers with a timeout up to `time`, in
+  // the order of their timeouts.
+  std::list<Timer> expire(const Time& time);
+
+  // Returns the earliest timeout of the pending timers, if any.
+  Option<Time> next();
+
+  bool empty() const { return entries.empty(); }
+  size_t size() const { return entries.size(); }
+
+  void clear();
+
+private:
+  static constexpr size_t LEVELS = 4;
+  static constexpr size_t BITS = 8;
+  static constexpr size_t SLOTS = 1 << BITS;
+
+  // The pseudo levels of the entries which are not in a slot of the
+  // levels of the wheel.
+  static constexpr int LEVEL_NONE = -2;
+  static constexpr int LEVEL_LATE = -1;
+  static constexpr int LEVEL_OVERFLOW = LEVELS;
+
+  struct Entry
+  {
+    Timer timer;
+    int64_t tick;
+
+    // The level and the slot holding this entry, updated when it gets
+    // cascaded.
+    int level;
+    std::list<Entry>* slot;
+  };
+
+  int64_t tickOf(const Time& time) const;
+
+  // Moves the entry from the list `from` to the slot matching its tick
+  // relative to the current tick.
+  void place(std::list<Entry>::iterator entry, std::list<Entry>* from);
+
+  // Moves all the entries of the slot to the slots matching their
+  // ticks relative to the current tick.
+  void cascade(std::list<Entry>* slot);
+
+  // Moves the entries of the slot with a timeout up to `time` to
+  // `expired`.
+  void collect(
+      std::list<Entry>* slot,
+      const Time& time,
+      std::list<Entry>* expired);
+
+  const int64_t resolution;
+
+  // The current tick. Every tick before it has been expired.
+  int64_t current;
+
+  std::array<std::array<std::list<Entry>, SLOTS>, LEVELS> levels;
+  std::array<size_t, LEVELS> counts;
+
+  // The timers too far in the future for the highest level.
+  std::list<Entry> overflow;
+
+  // The timers added with a tick before the current tick.
+  std::list<Entry> late;
+
+  hashmap<uint64_t, std::list<Entry>::iterator> entries;
+
+  // Caches the earliest timeout, invalidated when the timer with the
+  // earliest timeout gets removed or expires.
+  Option<Time> earliest;
+};
+
+} // namespace process {
+
+#endif // __PROCESS_TIMER_WHEEL_HPP__
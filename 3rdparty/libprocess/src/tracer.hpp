@@ -0,0 +1,141 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#ifndef __PROCESS_TRACER_HPP__
+#define __PROCESS_TRACER_HPP__
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <boost/circular_buffer.hpp>
+
+#include <stout/foreach.hpp>
+#include <stout/json.hpp>
+#include <stout/synchronized.hpp>
+
+namespace process {
+
+// A flight recorder of the events served by processes and of the
+// messages sent to remote processes. Only the most recent records
+// are kept, and they can be dumped in the Chrome trace event format
+// (see chrome://tracing).
+//
+// Events carry a trace ID which correlates them across processes:
+// an event enqueued while serving another event (e.g., a dispatch or
+// a message sent from within a process) gets the trace ID of the
+// event being served, otherwise it starts a new trace.
+class Tracer
+{
+public:
+  struct Record
+  {
+    // The phase of the record in the Chrome trace event format, either
+    // 'X' for a served event or 'i' for a sent message.
+    char phase;
+
+    // The type of the event, e.g., "MESSAGE".
+    std::string category;
+
+    // The message name or the HTTP request path, if any.
+    std::string name;
+
+    // The process that served the event or sent the message.
+    std::string process;
+
+    uint64_t trace;
+
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::duration served;
+    std::chrono::steady_clock::duration queued;
+
+    std::thread::id thread;
+  };
+
+  explicit Tracer(size_t capacity) : records(capacity), traces(0) {}
+
+  // Returns the ID for a new trace.
+  uint64_t trace()
+  {
+    return traces.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  void record(Record&& record)
+  {
+    synchronized (mutex) {
+      records.push_back(std::move(record));
+    }
+  }
+
+  // Returns the records in the Chrome trace event format.
+  JSON::Object json()
+  {
+    boost::circular_buffer<Record> records_;
+    synchronized (mutex) {
+      records_ = records;
+    }
+
+    auto microseconds = [](const std::chrono::steady_clock::duration& d) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+
+    JSON::Array events;
+    foreach (const Record& record, records_) {
+      JSON::Object event;
+      event.values["ph"] = std::string(1, record.phase);
+      event.values["cat"] = record.category;
+      event.values["name"] =
+        record.name.empty() ? record.category : record.name;
+      // All records are from this OS process, the threads are the
+      // libprocess worker threads.
+      event.values["pid"] = 0;
+      event.values["tid"] = std::hash<std::thread::id>()(record.thread);
+      event.values["ts"] = microseconds(record.started.time_since_epoch());
+
+      JSON::Object args;
+      args.values["process"] = record.process;
+      args.values["trace"] = record.trace;
+
+      if (record.phase == 'X') {
+        event.values["dur"] = microseconds(record.served);
+        args.values["queued_us"] = microseconds(record.queued);
+      } else {
+        // Instant events are scoped to the thread.
+        event.values["s"] = "t";
+      }
+
+      event.values["args"] = args;
+
+      events.values.push_back(event);
+    }
+
+    JSON::Object object;
+    object.values["traceEvents"] = events;
+    object.values["displayTimeUnit"] = "ms";
+    return object;
+  }
+
+private:
+  std::mutex mutex;
+  boost::circular_buffer<Record> records;
+
+  std::atomic<uint64_t> traces;
+};
+
+} // namespace process {
+
+#endif // __PROCESS_TRACER_HPP__
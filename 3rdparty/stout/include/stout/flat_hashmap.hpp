@@ -0,0 +1,191 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __STOUT_FLAT_HASHMAP_HPP__
+#define __STOUT_FLAT_HASHMAP_HPP__
+
+#include <functional>
+#include <list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "foreach.hpp"
+#include "hashset.hpp"
+#include "none.hpp"
+#include "option.hpp"
+
+#include "internal/flat_hashtable.hpp"
+
+namespace internal {
+
+struct FlatHashmapKeyOf
+{
+  template <typename Pair>
+  const typename Pair::first_type& operator()(const Pair& pair) const
+  {
+    return pair.first;
+  }
+};
+
+} // namespace internal {
+
+
+// Provides a hash map storing its entries contiguously, in an open
+// addressing hash table, rather than in a node per entry like
+// `hashmap`. This saves an allocation per entry and makes lookups
+// more cache friendly, at the cost of entries moving when the map
+// changes. It supports the commonly used subset of the interface of
+// `hashmap`.
+//
+// NOTE: Any insertion or removal invalidates the references to and the
+// iterators of all the entries of the map, so a `flat_hashmap` is not a
+// drop-in replacement for a `hashmap` whose entries are referenced, or
+// that gets modified while being iterated.
+template <typename Key,
+          typename Value,
+          typename Hash = typename std::conditional<
+            std::is_enum<Key>::value,
+            EnumClassHash,
+            std::hash<Key>>::type,
+          typename Equal = std::equal_to<Key>>
+class flat_hashmap
+  : public internal::FlatHashTable<
+        Key,
+        std::pair<const Key, Value>,
+        internal::FlatHashmapKeyOf,
+        Hash,
+        Equal>
+{
+  typedef internal::FlatHashTable<
+      Key,
+      std::pair<const Key, Value>,
+      internal::FlatHashmapKeyOf,
+      Hash,
+      Equal> Table;
+
+public:
+  typedef Value mapped_type;
+  typedef typename Table::value_type value_type;
+  typedef typename Table::iterator iterator;
+  typedef typename Table::const_iterator const_iterator;
+
+  // An explicit default constructor is needed so
+  // 'const flat_hashmap<T> map;' is not an error.
+  flat_hashmap() {}
+
+  // Allow simple construction via initializer list.
+  flat_hashmap(std::initializer_list<std::pair<Key, Value>> list)
+  {
+    Table::reserve(list.size());
+
+    foreach (const auto& pair, list) {
+      Table::insert(value_type(pair.first, pair.second));
+    }
+  }
+
+  Value& operator[](const Key& key)
+  {
+    iterator it = Table::find(key);
+    if (it == Table::end()) {
+      it = Table::insert(value_type(key, Value())).first;
+    }
+    return it->second;
+  }
+
+  Value& at(const Key& key)
+  {
+    iterator it = Table::find(key);
+    if (it == Table::end()) {
+      throw std::out_of_range("flat_hashmap::at");
+    }
+    return it->second;
+  }
+
+  const Value& at(const Key& key) const
+  {
+    const_iterator it = Table::find(key);
+    if (it == Table::end()) {
+      throw std::out_of_range("flat_hashmap::at");
+    }
+    return it->second;
+  }
+
+  template <typename K, typename V>
+  std::pair<iterator, bool> emplace(K&& key, V&& value)
+  {
+    return Table::insert(
+        value_type(std::forward<K>(key), std::forward<V>(value)));
+  }
+
+  // Checks whether this map contains a binding for a key.
+  bool contains(const Key& key) const
+  {
+    return Table::count(key) > 0;
+  }
+
+  // Checks whether there exists a bound value in this map.
+  bool containsValue(const Value& v) const
+  {
+    foreachvalue (const Value& value, *this) {
+      if (value == v) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Inserts a key, value pair into the map replacing an old value
+  // if the key is already present.
+  void put(const Key& key, const Value& value)
+  {
+    iterator it = Table::find(key);
+    if (it != Table::end()) {
+      it->second = value;
+    } else {
+      Table::insert(value_type(key, value));
+    }
+  }
+
+  // Returns an Option for the binding to the key.
+  Option<Value> get(const Key& key) const
+  {
+    const_iterator it = Table::find(key);
+    if (it == Table::end()) {
+      return None();
+    }
+    return it->second;
+  }
+
+  // Returns the set of keys in this map.
+  hashset<Key, Hash, Equal> keys() const
+  {
+    hashset<Key, Hash, Equal> result;
+    result.reserve(Table::size());
+    foreachkey (const Key& key, *this) {
+      result.insert(key);
+    }
+    return result;
+  }
+
+  // Returns the list of values in this map.
+  std::list<Value> values() const
+  {
+    std::list<Value> result;
+    foreachvalue (const Value& value, *this) {
+      result.push_back(value);
+    }
+    return result;
+  }
+};
+
+#endif // __STOUT_FLAT_HASHMAP_HPP__
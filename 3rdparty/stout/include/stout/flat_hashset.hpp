@@ -0,0 +1,104 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __STOUT_FLAT_HASHSET_HPP__
+#define __STOUT_FLAT_HASHSET_HPP__
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "foreach.hpp"
+#include "hashset.hpp"
+
+#include "internal/flat_hashtable.hpp"
+
+namespace internal {
+
+struct FlatHashsetKeyOf
+{
+  template <typename Elem>
+  const Elem& operator()(const Elem& elem) const
+  {
+    return elem;
+  }
+};
+
+} // namespace internal {
+
+
+// Provides a hash set storing its elements contiguously, in an open
+// addressing hash table, see `flat_hashmap`. It supports the commonly
+// used subset of the interface of `hashset`.
+//
+// NOTE: Any insertion or removal invalidates the references to and the
+// iterators of all the elements of the set.
+template <typename Elem,
+          typename Hash = typename std::conditional<
+            std::is_enum<Elem>::value,
+            EnumClassHash,
+            std::hash<Elem>>::type,
+          typename Equal = std::equal_to<Elem>>
+class flat_hashset
+  : public internal::FlatHashTable<
+        Elem,
+        Elem,
+        internal::FlatHashsetKeyOf,
+        Hash,
+        Equal>
+{
+  typedef internal::FlatHashTable<
+      Elem,
+      Elem,
+      internal::FlatHashsetKeyOf,
+      Hash,
+      Equal> Table;
+
+public:
+  // Like for `std::unordered_set`, the elements can't be modified
+  // through the iterators since that could change their hash.
+  typedef typename Table::const_iterator iterator;
+  typedef typename Table::const_iterator const_iterator;
+
+  // An explicit default constructor is needed so
+  // 'const flat_hashset<T> set;' is not an error.
+  flat_hashset() {}
+
+  // Allow simple construction via initializer list.
+  flat_hashset(std::initializer_list<Elem> list)
+  {
+    Table::reserve(list.size());
+
+    foreach (const Elem& elem, list) {
+      Table::insert(elem);
+    }
+  }
+
+  const_iterator begin() const { return Table::begin(); }
+  const_iterator end() const { return Table::end(); }
+
+  const_iterator find(const Elem& elem) const { return Table::find(elem); }
+
+  template <typename E>
+  std::pair<const_iterator, bool> insert(E&& elem)
+  {
+    return Table::insert(std::forward<E>(elem));
+  }
+
+  // Checks whether this set contains an element.
+  bool contains(const Elem& elem) const
+  {
+    return Table::count(elem) > 0;
+  }
+};
+
+#endif // __STOUT_FLAT_HASHSET_HPP__
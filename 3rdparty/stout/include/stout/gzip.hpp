@@ -25,7 +25,6 @@
 
 
 // Compression utilities.
-// TODO(bmahler): Provide streaming compression as well.
 namespace gzip {
 
 namespace internal {
@@ -169,6 +168,115 @@ private:
 };
 
 
+// Provides the ability to incrementally compress a stream of input
+// data. Every chunk of compressed data returned by 'compress' can be
+// decompressed by the receiver right away (i.e., the compressed
+// stream is flushed), which allows using this for streamed responses.
+// The compression level should be within the range [-1, 9], see
+// 'compress' below.
+class Compressor
+{
+public:
+  explicit Compressor(int level = Z_DEFAULT_COMPRESSION)
+    : _finished(false)
+  {
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.next_in = Z_NULL;
+    stream.avail_in = 0;
+
+    int code = deflateInit2(
+        &stream,
+        level,          // Compression level.
+        Z_DEFLATED,     // Compression method.
+        MAX_WBITS + 16, // Zlib magic for gzip compression / decompression.
+        8,              // Default memLevel value.
+        Z_DEFAULT_STRATEGY);
+
+    if (code != Z_OK) {
+      Error error = internal::GzipError("Failed to deflateInit2", stream, code);
+      ABORT(error.message);
+    }
+  }
+
+  Compressor(const Compressor&) = delete;
+  Compressor& operator=(const Compressor&) = delete;
+
+  ~Compressor()
+  {
+    // NOTE: `deflateEnd` returns `Z_DATA_ERROR` if the stream was not
+    // finished, which is expected when the stream is abandoned.
+    deflateEnd(&stream);
+  }
+
+  // Returns the next compressed chunk of data, or an Error if
+  // compression fails.
+  Try<std::string> compress(const std::string& decompressed)
+  {
+    return deflate(decompressed, Z_SYNC_FLUSH);
+  }
+
+  // Finishes the compression stream, returning the remaining
+  // compressed data (including the gzip trailer).
+  Try<std::string> finish()
+  {
+    Try<std::string> result = deflate("", Z_FINISH);
+
+    if (result.isSome()) {
+      _finished = true;
+    }
+
+    return result;
+  }
+
+  // Returns whether the compression stream is finished.
+  bool finished() const
+  {
+    return _finished;
+  }
+
+private:
+  Try<std::string> deflate(const std::string& decompressed, int flush)
+  {
+    if (_finished) {
+      return Error("Stream is already finished");
+    }
+
+    stream.next_in =
+      const_cast<Bytef*>(reinterpret_cast<const Bytef*>(decompressed.data()));
+    stream.avail_in = static_cast<uInt>(decompressed.length());
+
+    // Build up the compressed result. We keep calling `deflate` until
+    // it has room left in the output buffer, which means that all of
+    // the input has been consumed and the output has been flushed.
+    Bytef buffer[GZIP_BUFFER_SIZE];
+    std::string result;
+
+    do {
+      stream.next_out = buffer;
+      stream.avail_out = GZIP_BUFFER_SIZE;
+
+      int code = ::deflate(&stream, flush);
+
+      if (code != Z_OK && code != Z_STREAM_END && code != Z_BUF_ERROR) {
+        return internal::GzipError("Failed to deflate", stream, code);
+      }
+
+      // Consume output and reset the buffer.
+      result.append(
+          reinterpret_cast<char*>(buffer),
+          GZIP_BUFFER_SIZE - stream.avail_out);
+    } while (stream.avail_out == 0);
+
+    return result;
+  }
+
+  z_stream_s stream;
+  bool _finished;
+};
+
+
 // Returns a gzip compressed version of the provided string.
 // The compression level should be within the range [-1, 9].
 // See zlib.h:
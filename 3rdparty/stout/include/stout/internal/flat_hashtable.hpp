@@ -0,0 +1,434 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __STOUT_INTERNAL_FLAT_HASHTABLE_HPP__
+#define __STOUT_INTERNAL_FLAT_HASHTABLE_HPP__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace internal {
+
+// An open addressing hash table storing its values contiguously, used
+// to implement `flat_hashmap` and `flat_hashset`.
+//
+// Collisions are resolved with linear probing and Robin Hood hashing:
+// a value being inserted takes the slot of any value closer to its own
+// home slot, which bounds the variance of the probe lengths and lets
+// lookups of missing keys stop early. Removals shift the following
+// values back instead of leaving tombstones.
+//
+// NOTE: Unlike for `std::unordered_map`, inserting or removing a value
+// may move other values, which invalidates any reference, pointer or
+// iterator to the values of the table.
+template <typename Key,
+          typename Value,
+          typename KeyOf,
+          typename Hash,
+          typename Equal>
+class FlatHashTable
+{
+public:
+  typedef Key key_type;
+  typedef Value value_type;
+  typedef Hash hasher;
+  typedef Equal key_equal;
+  typedef size_t size_type;
+
+  template <bool Const>
+  class Iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename FlatHashTable::value_type value_type;
+    typedef ptrdiff_t difference_type;
+
+    typedef typename std::conditional<
+        Const, const value_type*, value_type*>::type pointer;
+
+    typedef typename std::conditional<
+        Const, const value_type&, value_type&>::type reference;
+
+    Iterator() : table(nullptr), index(0) {}
+
+    // Allows converting an `iterator` to a `const_iterator`.
+    template <bool C = Const, typename = typename std::enable_if<C>::type>
+    Iterator(const Iterator<false>& that)
+      : table(that.table), index(that.index) {}
+
+    reference operator*() const { return table->slot(index); }
+    pointer operator->() const { return &table->slot(index); }
+
+    Iterator& operator++()
+    {
+      index++;
+      skip();
+      return *this;
+    }
+
+    Iterator operator++(int)
+    {
+      Iterator iterator = *this;
+      ++(*this);
+      return iterator;
+    }
+
+    bool operator==(const Iterator& that) const
+    {
+      return table == that.table && index == that.index;
+    }
+
+    bool operator!=(const Iterator& that) const { return !(*this == that); }
+
+  private:
+    friend class FlatHashTable;
+    friend class Iterator<true>;
+
+    typedef typename std::conditional<
+        Const, const FlatHashTable*, FlatHashTable*>::type Table;
+
+    Iterator(Table _table, size_t _index) : table(_table), index(_index)
+    {
+      skip();
+    }
+
+    // Moves to the next slot holding a value, if not already on one.
+    void skip()
+    {
+      while (index < table->capacity && table->distances[index] == 0) {
+        index++;
+      }
+    }
+
+    Table table;
+    size_t index;
+  };
+
+  typedef Iterator<false> iterator;
+  typedef Iterator<true> const_iterator;
+
+  FlatHashTable() : capacity(0), shift(0), elements(0) {}
+
+  FlatHashTable(const FlatHashTable& that)
+    : capacity(0), shift(0), elements(0)
+  {
+    allocate(that.capacity);
+
+    // The values get copied to the same slots since the tables have
+    // the same capacity.
+    for (size_t i = 0; i < that.capacity; i++) {
+      if (that.distances[i] != 0) {
+        new (&slots[i]) Value(that.slot(i));
+        distances[i] = that.distances[i];
+      }
+    }
+
+    elements = that.elements;
+  }
+
+  FlatHashTable(FlatHashTable&& that)
+    : capacity(0), shift(0), elements(0)
+  {
+    swap(that);
+  }
+
+  ~FlatHashTable() { destroy(); }
+
+  FlatHashTable& operator=(FlatHashTable that)
+  {
+    swap(that);
+    return *this;
+  }
+
+  void swap(FlatHashTable& that)
+  {
+    std::swap(capacity, that.capacity);
+    std::swap(shift, that.shift);
+    std::swap(elements, that.elements);
+    std::swap(distances, that.distances);
+    std::swap(slots, that.slots);
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, capacity); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, capacity); }
+
+  size_t size() const { return elements; }
+  bool empty() const { return elements == 0; }
+
+  iterator find(const Key& key) { return iterator(this, locate(key)); }
+
+  const_iterator find(const Key& key) const
+  {
+    return const_iterator(this, locate(key));
+  }
+
+  size_t count(const Key& key) const { return locate(key) != capacity; }
+
+  // Inserts the value unless the table already has a value with the
+  // same key, see `std::unordered_map::insert`.
+  template <typename V>
+  std::pair<iterator, bool> insert(V&& value)
+  {
+    const size_t index = locate(KeyOf()(value));
+    if (index != capacity) {
+      return std::make_pair(iterator(this, index), false);
+    }
+
+    return std::make_pair(iterator(this, place(std::forward<V>(value))), true);
+  }
+
+  size_t erase(const Key& key)
+  {
+    size_t index = locate(key);
+    if (index == capacity) {
+      return 0;
+    }
+
+    slot(index).~Value();
+
+    // Shift the following values of the probe sequence back by one.
+    size_t next = (index + 1) & (capacity - 1);
+    while (distances[next] > 1) {
+      new (&slots[index]) Value(std::move(slot(next)));
+      slot(next).~Value();
+
+      distances[index] = distances[next] - 1;
+
+      index = next;
+      next = (next + 1) & (capacity - 1);
+    }
+
+    distances[index] = 0;
+    elements--;
+
+    return 1;
+  }
+
+  void clear()
+  {
+    for (size_t i = 0; i < capacity; i++) {
+      if (distances[i] != 0) {
+        slot(i).~Value();
+        distances[i] = 0;
+      }
+    }
+
+    elements = 0;
+  }
+
+  // Makes room for at least `size` values without rehashing.
+  void reserve(size_t size)
+  {
+    size_t capacity_ = std::max<size_t>(capacity, MIN_CAPACITY);
+    while (size * LOAD_DENOMINATOR > capacity_ * LOAD_NUMERATOR) {
+      capacity_ *= 2;
+    }
+
+    if (capacity_ != capacity) {
+      rehash(capacity_);
+    }
+  }
+
+private:
+  typedef typename std::aligned_storage<
+      sizeof(Value), std::alignment_of<Value>::value>::type Storage;
+
+  // The table grows once it is 7/8 full.
+  static constexpr size_t LOAD_NUMERATOR = 7;
+  static constexpr size_t LOAD_DENOMINATOR = 8;
+
+  static constexpr size_t MIN_CAPACITY = 8;
+
+  Value& slot(size_t index)
+  {
+    return *reinterpret_cast<Value*>(&slots[index]);
+  }
+
+  const Value& slot(size_t index) const
+  {
+    return *reinterpret_cast<const Value*>(&slots[index]);
+  }
+
+  // Returns the home slot of a key. The hash gets multiplied by 2^64
+  // divided by the golden ratio and the highest bits of the result are
+  // used, so that hashes which only differ in their high bits, e.g.,
+  // aligned pointers, are spread over the table.
+  size_t home(const Key& key) const
+  {
+    const uint64_t hash = static_cast<uint64_t>(Hash()(key));
+    return static_cast<size_t>((hash * 11400714819323198485ull) >> shift);
+  }
+
+  // Returns the slot of the value with the key, or the capacity if
+  // there is none.
+  size_t locate(const Key& key) const
+  {
+    if (elements == 0) {
+      return capacity;
+    }
+
+    size_t index = home(key);
+
+    // A value further from its home slot than the key would be, had
+    // it been inserted, means the key is missing.
+    for (size_t distance = 1; distances[index] >= distance; distance++) {
+      if (distances[index] == distance && Equal()(KeyOf()(slot(index)), key)) {
+        return index;
+      }
+
+      index = (index + 1) & (capacity - 1);
+    }
+
+    return capacity;
+  }
+
+  // Places a value whose key is not in the table yet, and returns its
+  // slot.
+  template <typename V>
+  size_t place(V&& value)
+  {
+    if ((elements + 1) * LOAD_DENOMINATOR > capacity * LOAD_NUMERATOR) {
+      rehash(std::max(capacity * 2, MIN_CAPACITY));
+    }
+
+    // The value being placed, which changes as values get displaced.
+    Storage storage;
+    Value* placed = new (&storage) Value(std::forward<V>(value));
+
+    size_t index = home(KeyOf()(*placed));
+    uint32_t distance = 1;
+
+    // The slot which got the value passed in.
+    size_t result = capacity;
+
+    while (true) {
+      if (distances[index] == 0) {
+        new (&slots[index]) Value(std::move(*placed));
+        placed->~Value();
+
+        distances[index] = distance;
+        elements++;
+
+        return result != capacity ? result : index;
+      }
+
+      if (distances[index] < distance) {
+        // Displace the value closer to its home slot.
+        Storage temporary;
+        Value* displaced = new (&temporary) Value(std::move(slot(index)));
+        slot(index).~Value();
+
+        new (&slots[index]) Value(std::move(*placed));
+        placed->~Value();
+
+        placed = new (&storage) Value(std::move(*displaced));
+        displaced->~Value();
+
+        std::swap(distances[index], distance);
+
+        if (result == capacity) {
+          result = index;
+        }
+      }
+
+      index = (index + 1) & (capacity - 1);
+      distance++;
+    }
+  }
+
+  void rehash(size_t capacity_)
+  {
+    FlatHashTable old;
+    swap(old);
+
+    allocate(capacity_);
+
+    for (size_t i = 0; i < old.capacity; i++) {
+      if (old.distances[i] != 0) {
+        place(std::move(old.slot(i)));
+      }
+    }
+  }
+
+  // Allocates the slots of an empty table.
+  void allocate(size_t capacity_)
+  {
+    capacity = capacity_;
+
+    shift = 64;
+    for (size_t i = capacity; i > 1; i /= 2) {
+      shift--;
+    }
+
+    if (capacity > 0) {
+      distances.reset(new uint32_t[capacity]());
+      slots.reset(new Storage[capacity]);
+    }
+  }
+
+  void destroy()
+  {
+    clear();
+
+    distances.reset();
+    slots.reset();
+    capacity = 0;
+  }
+
+  // The number of slots, always a power of 2.
+  size_t capacity;
+
+  // The number of bits to shift a multiplied hash by to get its slot,
+  // i.e., 64 - log2(capacity).
+  size_t shift;
+
+  // The number of values.
+  size_t elements;
+
+  // The distance of the value in each slot to its home slot, plus one;
+  // zero for an empty slot.
+  std::unique_ptr<uint32_t[]> distances;
+
+  std::unique_ptr<Storage[]> slots;
+};
+
+
+template <typename Key, typename Value, typename KeyOf,
+          typename Hash, typename Equal>
+constexpr size_t
+FlatHashTable<Key, Value, KeyOf, Hash, Equal>::LOAD_NUMERATOR;
+
+
+template <typename Key, typename Value, typename KeyOf,
+          typename Hash, typename Equal>
+constexpr size_t
+FlatHashTable<Key, Value, KeyOf, Hash, Equal>::LOAD_DENOMINATOR;
+
+
+template <typename Key, typename Value, typename KeyOf,
+          typename Hash, typename Equal>
+constexpr size_t
+FlatHashTable<Key, Value, KeyOf, Hash, Equal>::MIN_CAPACITY;
+
+} // namespace internal {
+
+#endif // __STOUT_INTERNAL_FLAT_HASHTABLE_HPP__
@@ -880,13 +880,91 @@ inline Value convert(const picojson::value& value)
   return Null();
 }
 
+
+// A picojson parse context which builds a `Value` while parsing,
+// rather than building a `picojson::value` first and then converting
+// it, which needs twice the allocations and copies every string.
+class ParseContext
+{
+public:
+  explicit ParseContext(Value* _value) : value(_value) {}
+
+  ParseContext(const ParseContext&) = delete;
+  ParseContext& operator=(const ParseContext&) = delete;
+
+  bool set_null()
+  {
+    *value = Null();
+    return true;
+  }
+
+  bool set_bool(bool b)
+  {
+    *value = Boolean(b);
+    return true;
+  }
+
+  bool set_int64(int64_t i)
+  {
+    *value = Number(i);
+    return true;
+  }
+
+  bool set_number(double d)
+  {
+    *value = Number(d);
+    return true;
+  }
+
+  template <typename Iter>
+  bool parse_string(picojson::input<Iter>& in)
+  {
+    *value = String();
+    return picojson::_parse_string(boost::get<String>(value)->value, in);
+  }
+
+  bool parse_array_start()
+  {
+    *value = Array();
+    return true;
+  }
+
+  template <typename Iter>
+  bool parse_array_item(picojson::input<Iter>& in, size_t)
+  {
+    std::vector<Value>& values = boost::get<Array>(value)->values;
+    values.emplace_back();
+
+    ParseContext context(&values.back());
+    return picojson::_parse(context, in);
+  }
+
+  bool parse_array_stop(size_t) { return true; }
+
+  bool parse_object_start()
+  {
+    *value = Object();
+    return true;
+  }
+
+  template <typename Iter>
+  bool parse_object_item(picojson::input<Iter>& in, const std::string& key)
+  {
+    ParseContext context(&boost::get<Object>(value)->values[key]);
+    return picojson::_parse(context, in);
+  }
+
+private:
+  Value* value;
+};
+
 } // namespace internal {
 
 
 inline Try<Value> parse(const std::string& s)
 {
   const char* parseBegin = s.c_str();
-  picojson::value value;
+  Value value;
   std::string error;
 
   // Because PicoJson supports repeated parsing of multiple objects/arrays in a
@@ -897,8 +975,9 @@ inline Try<Value> parse(const std::string& s)
 
   // Parse the string, returning a pointer to the character
   // immediately following the last one parsed.
+  internal::ParseContext context(&value);
   const char* parseEnd =
-    picojson::parse(value, parseBegin, parseBegin + s.size(), &error);
+    picojson::_parse(context, parseBegin, parseBegin + s.size(), &error);
 
   if (!error.empty()) {
     return Error(error);
@@ -908,7 +987,7 @@ inline Try<Value> parse(const std::string& s)
         + s.substr(parseEnd - parseBegin, lastVisibleChar + 1 - parseEnd));
   }
 
-  return internal::convert(value);
+  return value;
 }
 
 
@@ -19,6 +19,8 @@
 
 #include <clocale>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <ostream>
 #include <sstream>
@@ -368,11 +370,64 @@ public:
   void append(const std::string& value) { append(value.data(), value.size()); }
 
 private:
+  static bool escaped(char c)
+  {
+    return c == '"' || c == '\\' || c == '/' ||
+           static_cast<unsigned char>(c) < 0x20 || c == 0x7f;
+  }
+
+  // Returns whether any of the 8 bytes of `word` might need to be
+  // escaped. This checks the bytes all at once rather than one by one,
+  // see https://graphics.stanford.edu/~seander/bithacks.html#HasLessInWord.
+  static bool escaped(uint64_t word)
+  {
+    const uint64_t ones = 0x0101010101010101ull;
+    const uint64_t highs = 0x8080808080808080ull;
+
+    auto less = [=](uint64_t x, uint64_t n) {
+      return ((x - ones * n) & ~x & highs) != 0;
+    };
+
+    auto equal = [=](uint64_t x, uint64_t n) {
+      return less(x ^ (ones * n), 1);
+    };
+
+    return less(word, 0x20) ||
+           equal(word, '"') ||
+           equal(word, '\\') ||
+           equal(word, '/') ||
+           equal(word, 0x7f);
+  }
+
+  // Writes the runs of characters which don't need to be escaped at
+  // once, skipping over them a word at a time, since strings rarely
+  // have characters to escape.
   void append(const char* value, std::size_t size)
   {
-    for (std::size_t i = 0; i < size; ++i) {
-      append(value[i]);
+    std::size_t written = 0;
+    std::size_t i = 0;
+
+    while (i < size) {
+      if (size - i >= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, value + i, sizeof(word));
+
+        if (!escaped(word)) {
+          i += sizeof(word);
+          continue;
+        }
+      }
+
+      if (escaped(value[i])) {
+        stream_->write(value + written, i - written);
+        append(value[i]);
+        written = i + 1;
+      }
+
+      ++i;
     }
+
+    stream_->write(value + written, size - written);
   }
 
   std::ostream* stream_;
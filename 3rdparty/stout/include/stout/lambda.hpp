@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -332,11 +333,13 @@ struct Invoke<void>
 // This is similar to `std::function`, but it can only be called once.
 // The "called once" semantics is enforced by having rvalue-ref qualifier
 // on `operator()`, so instances of `CallableOnce` must be `std::move`'d
-// in order to be invoked. Similar to `std::function`, this has heap
-// allocation overhead due to type erasure.
+// in order to be invoked.
 //
-// Note: Heap allocation can be avoided in some cases by implementing
-// small buffer optimization. This is currently not implemented.
+// Similar to `std::function`, small callables (e.g., a lambda capturing
+// a few pointers, or a member function pointer bound to a couple of
+// small arguments) are stored inline to avoid the heap allocation
+// otherwise required by the type erasure. This matters for
+// `process::dispatch`, which creates one `CallableOnce` per call.
 template <typename F>
 class CallableOnce;
 
@@ -356,12 +359,24 @@ public:
                  R>::value),
           int>::type = 0>
   CallableOnce(F&& f)
-    : f(new CallableFn<typename std::decay<F>::type>(std::forward<F>(f))) {}
+  {
+    construct(std::forward<F>(f), Inline<typename std::decay<F>::type>());
+  }
 
-  CallableOnce(CallableOnce&&) = default;
+  CallableOnce(CallableOnce&& that) { steal(std::move(that)); }
   CallableOnce(const CallableOnce&) = delete;
 
-  CallableOnce& operator=(CallableOnce&&) = default;
+  ~CallableOnce() { destroy(); }
+
+  CallableOnce& operator=(CallableOnce&& that)
+  {
+    if (this != &that) {
+      destroy();
+      steal(std::move(that));
+    }
+    return *this;
+  }
+
   CallableOnce& operator=(const CallableOnce&) = delete;
 
   R operator()(Args... args) &&
@@ -375,6 +390,9 @@ private:
   {
     virtual ~Callable() = default;
     virtual R operator()(Args&&...) && = 0;
+
+    // Move constructs the callable into the given inline storage.
+    virtual Callable* move(void* storage) && = 0;
   };
 
   template <typename F>
@@ -389,9 +407,74 @@ private:
     {
       return internal::Invoke<R>{}(std::move(f), std::forward<Args>(args)...);
     }
+
+    virtual Callable* move(void* storage) &&
+    {
+      return new (storage) CallableFn(std::move(f));
+    }
   };
 
-  std::unique_ptr<Callable> f;
+  // Room for a member function pointer bound to a few small arguments.
+  typedef typename std::aligned_storage<6 * sizeof(void*)>::type Storage;
+
+  // Only callables which can't throw while being moved are stored
+  // inline, since moving a `CallableOnce` moves them.
+  template <typename F>
+  using Inline = std::integral_constant<
+      bool,
+      sizeof(CallableFn<F>) <= sizeof(Storage) &&
+        std::alignment_of<CallableFn<F>>::value <=
+          std::alignment_of<Storage>::value &&
+        std::is_nothrow_move_constructible<F>::value>;
+
+  template <typename F>
+  void construct(F&& f_, std::true_type)
+  {
+    f = new (&storage) CallableFn<typename std::decay<F>::type>(
+        std::forward<F>(f_));
+    inlined = true;
+  }
+
+  template <typename F>
+  void construct(F&& f_, std::false_type)
+  {
+    f = new CallableFn<typename std::decay<F>::type>(std::forward<F>(f_));
+    inlined = false;
+  }
+
+  void steal(CallableOnce&& that)
+  {
+    inlined = that.inlined;
+
+    if (that.f == nullptr) {
+      f = nullptr;
+    } else if (that.inlined) {
+      f = std::move(*that.f).move(&storage);
+      that.destroy();
+    } else {
+      f = that.f;
+      that.f = nullptr;
+    }
+  }
+
+  void destroy()
+  {
+    if (f == nullptr) {
+      return;
+    }
+
+    if (inlined) {
+      f->~Callable();
+    } else {
+      delete f;
+    }
+
+    f = nullptr;
+  }
+
+  Storage storage;
+  Callable* f;
+  bool inlined;
 };
 
 } // namespace lambda {
@@ -30,10 +30,13 @@
 #include <stout/foreach.hpp>
 #include <stout/lambda.hpp>
 #include <stout/option.hpp>
+#include <stout/path.hpp>
 #include <stout/proc.hpp>
 #include <stout/result.hpp>
+#include <stout/stringify.hpp>
 #include <stout/try.hpp>
 
+#include <stout/os/exists.hpp>
 #include <stout/os/process.hpp>
 
 namespace os {
@@ -225,6 +228,54 @@ inline Try<std::set<pid_t>> pids()
 }
 
 
+// Returns the process with the specified pid and all its descendants,
+// reading only the entries of these processes in /proc rather than the
+// entries of every process, or None if the kernel does not list the
+// children of processes.
+inline Result<std::list<Process>> descendants(pid_t pid)
+{
+  std::list<Process> result;
+  std::set<pid_t> visited;
+
+  std::queue<pid_t> queue;
+  queue.push(pid);
+
+  while (!queue.empty()) {
+    const pid_t next = queue.front();
+    queue.pop();
+
+    if (!visited.insert(next).second) {
+      continue;
+    }
+
+    const Result<Process> process = os::process(next);
+    if (process.isError()) {
+      return Error(process.error());
+    } else if (process.isNone()) {
+      continue; // The process has terminated.
+    }
+
+    const Result<std::set<pid_t>> children = proc::children(next);
+    if (children.isNone()) {
+      return None();
+    } else if (children.isError()) {
+      if (!os::exists(path::join("/proc", stringify(next)))) {
+        continue; // The process has terminated.
+      }
+      return Error(children.error());
+    }
+
+    result.push_back(process.get());
+
+    foreach (pid_t child, children.get()) {
+      queue.push(child);
+    }
+  }
+
+  return result;
+}
+
+
 // Returns the total size of main and free memory.
 inline Try<Memory> memory()
 {
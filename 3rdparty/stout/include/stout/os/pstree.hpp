@@ -15,11 +15,16 @@
 
 #include <list>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include <stout/error.hpp>
 #include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/hashset.hpp>
 #include <stout/none.hpp>
 #include <stout/option.hpp>
+#include <stout/result.hpp>
 #include <stout/stringify.hpp>
 #include <stout/try.hpp>
 
@@ -28,9 +33,13 @@
 
 namespace os {
 
-// Forward declaration.
+// Forward declarations.
 inline Try<std::list<Process>> processes();
 
+#ifdef __linux__
+inline Result<std::list<Process>> descendants(pid_t pid);
+#endif // __linux__
+
 
 // Returns a process tree rooted at the specified pid using the
 // specified list of processes (or an error if one occurs).
@@ -38,24 +47,65 @@ inline Try<ProcessTree> pstree(
     pid_t pid,
     const std::list<Process>& processes)
 {
-  std::list<ProcessTree> children;
+  // Index the processes by pid and by parent first, so that building
+  // the tree doesn't look through all the processes for every process.
+  hashmap<pid_t, const Process*> pids;
+  hashmap<pid_t, std::vector<const Process*>> children;
+
   foreach (const Process& process, processes) {
-    if (process.parent == pid) {
-      Try<ProcessTree> tree = pstree(process.pid, processes);
-      if (tree.isError()) {
-        return Error(tree.error());
-      }
-      children.push_back(tree.get());
+    if (!pids.contains(process.pid)) {
+      pids[process.pid] = &process;
     }
+    children[process.parent].push_back(&process);
   }
 
-  foreach (const Process& process, processes) {
-    if (process.pid == pid) {
-      return ProcessTree(process, children);
-    }
+  if (!pids.contains(pid)) {
+    return Error("No process found at " + stringify(pid));
   }
 
-  return Error("No process found at " + stringify(pid));
+  // The trees are built depth-first without recursion, a process
+  // being visited before and after its children. The trees of the
+  // children get collected by pid of their parent until the tree of
+  // the parent gets built.
+  hashmap<pid_t, std::list<ProcessTree>> trees;
+  hashset<pid_t> visited;
+
+  std::vector<std::pair<const Process*, bool>> stack;
+  stack.push_back(std::make_pair(pids[pid], false));
+
+  while (true) {
+    const Process* process = stack.back().first;
+
+    if (!stack.back().second) {
+      stack.back().second = true;
+      visited.insert(process->pid);
+
+      if (children.contains(process->pid)) {
+        const std::vector<const Process*>& processes_ =
+          children[process->pid];
+
+        // Push the children in reverse to build their trees in order.
+        for (auto it = processes_.rbegin(); it != processes_.rend(); ++it) {
+          if (!visited.contains((*it)->pid)) {
+            stack.push_back(std::make_pair(*it, false));
+          }
+        }
+      }
+
+      continue;
+    }
+
+    stack.pop_back();
+
+    ProcessTree tree(*process, trees[process->pid]);
+    trees.erase(process->pid);
+
+    if (stack.empty()) {
+      return tree;
+    }
+
+    trees[process->parent].push_back(tree);
+  }
 }
 
 
@@ -69,6 +119,20 @@ inline Try<ProcessTree> pstree(Option<pid_t> pid = None())
     pid = getpid();
   }
 
+#ifdef __linux__
+  // Only look at the processes of the tree, if the kernel lists the
+  // children of processes.
+  const Result<std::list<Process>> descendants = os::descendants(pid.get());
+
+  if (descendants.isError()) {
+    return Error(descendants.error());
+  }
+
+  if (descendants.isSome()) {
+    return pstree(pid.get(), descendants.get());
+  }
+#endif // __linux__
+
   const Try<std::list<Process>> processes = os::processes();
 
   if (processes.isError()) {
@@ -58,10 +58,23 @@ inline std::string join(
     const std::string& path2,
     const char _separator = os::PATH_SEPARATOR)
 {
-  const std::string separator = stringify(_separator);
-  return strings::remove(path1, separator, strings::SUFFIX) +
-         separator +
-         strings::remove(path2, separator, strings::PREFIX);
+  // NOTE: This is equivalent to removing a single trailing separator
+  // from `path1` and a single leading separator from `path2` and
+  // concatenating both around a separator, but builds the result in a
+  // single allocation as it is used on hot paths (e.g., sandbox and
+  // cgroup paths).
+  const size_t length1 = !path1.empty() && path1.back() == _separator
+    ? path1.size() - 1
+    : path1.size();
+
+  const size_t offset2 = !path2.empty() && path2.front() == _separator ? 1 : 0;
+
+  std::string result;
+  result.reserve(length1 + 1 + path2.size() - offset2);
+  result.append(path1, 0, length1);
+  result += _separator;
+  result.append(path2, offset2, std::string::npos);
+  return result;
 }
 
 
@@ -20,6 +20,7 @@
 
 #include <errno.h>
 #include <signal.h>
+#include <stdio.h>
 
 #include <sys/types.h> // For pid_t.
 
@@ -27,7 +28,7 @@
 #include <list>
 #include <queue>
 #include <set>
-#include <sstream> // For 'std::istringstream'.
+#include <sstream> // For 'std::stringbuf'.
 #include <string>
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include <stout/numify.hpp>
 #include <stout/option.hpp>
 #include <stout/path.hpp>
+#include <stout/stringify.hpp>
 #include <stout/strings.hpp>
 #include <stout/try.hpp>
 
@@ -177,42 +179,56 @@ inline Result<ProcessStatus> status(pid_t pid)
     return Error(read.error());
   }
 
-  std::istringstream data(read.get());
-
-  std::string comm;
-  char state;
-  pid_t ppid;
-  pid_t pgrp;
-  pid_t session;
-  int tty_nr;
-  pid_t tpgid;
-  unsigned int flags;
-  unsigned long minflt;
-  unsigned long cminflt;
-  unsigned long majflt;
-  unsigned long cmajflt;
-  unsigned long utime;
-  unsigned long stime;
-  long cutime;
-  long cstime;
-  long priority;
-  long nice;
-  long num_threads;
-  long itrealvalue;
-  unsigned long long starttime;
-  unsigned long vsize;
-  long rss;
-  unsigned long rsslim;
-  unsigned long startcode;
-  unsigned long endcode;
-  unsigned long startstack;
-  unsigned long kstkeip;
-  unsigned long signal;
-  unsigned long blocked;
-  unsigned long sigcatch;
-  unsigned long wchan;
-  unsigned long nswap;
-  unsigned long cnswap;
+  const std::string& data = read.get();
+
+  // The command is wrapped in parentheses and may contain any
+  // character, including spaces and parentheses, so it ends at the
+  // last closing parenthesis. (When printing out the process in a
+  // process tree we use parentheses to indicate "zombie" processes.)
+  const size_t open = data.find('(');
+  const size_t close = data.rfind(')');
+
+  if (open == std::string::npos ||
+      close == std::string::npos ||
+      close < open) {
+    return Error("Failed to read/parse '" + path + "'");
+  }
+
+  const std::string comm = data.substr(open + 1, close - open - 1);
+
+  char state = 0;
+  pid_t ppid = 0;
+  pid_t pgrp = 0;
+  pid_t session = 0;
+  int tty_nr = 0;
+  pid_t tpgid = 0;
+  unsigned int flags = 0;
+  unsigned long minflt = 0;
+  unsigned long cminflt = 0;
+  unsigned long majflt = 0;
+  unsigned long cmajflt = 0;
+  unsigned long utime = 0;
+  unsigned long stime = 0;
+  long cutime = 0;
+  long cstime = 0;
+  long priority = 0;
+  long nice = 0;
+  long num_threads = 0;
+  long itrealvalue = 0;
+  unsigned long long starttime = 0;
+  unsigned long vsize = 0;
+  long rss = 0;
+  unsigned long rsslim = 0;
+  unsigned long startcode = 0;
+  unsigned long endcode = 0;
+  unsigned long startstack = 0;
+  unsigned long kstkeip = 0;
+  unsigned long signal = 0;
+  unsigned long blocked = 0;
+  unsigned long sigcatch = 0;
+  unsigned long wchan = 0;
+  unsigned long nswap = 0;
+  unsigned long cnswap = 0;
 
   // NOTE: The following are unused for now.
   // int exit_signal;
@@ -223,27 +239,24 @@ inline Result<ProcessStatus> status(pid_t pid)
   // unsigned long guest_time;
   // unsigned int cguest_time;
 
-  std::string _; // For ignoring fields.
-
-  // Parse all fields from stat.
-  data >> _ >> comm >> state >> ppid >> pgrp >> session >> tty_nr
-       >> tpgid >> flags >> minflt >> cminflt >> majflt >> cmajflt
-       >> utime >> stime >> cutime >> cstime >> priority >> nice
-       >> num_threads >> itrealvalue >> starttime >> vsize >> rss
-       >> rsslim >> startcode >> endcode >> startstack >> kstkeip
-       >> signal >> blocked >> sigcatch >> wchan >> nswap >> cnswap;
+  // Parse the fields following the command at once, rather than
+  // through a stream, since this gets called for every process when
+  // listing processes.
+  const int fields = sscanf(
+      data.c_str() + close + 1,
+      " %c %d %d %d %d %d %u %lu %lu %lu %lu %lu %lu %ld %ld %ld %ld %ld"
+      " %ld %llu %lu %ld %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu",
+      &state, &ppid, &pgrp, &session, &tty_nr, &tpgid, &flags, &minflt,
+      &cminflt, &majflt, &cmajflt, &utime, &stime, &cutime, &cstime,
+      &priority, &nice, &num_threads, &itrealvalue, &starttime, &vsize,
+      &rss, &rsslim, &startcode, &endcode, &startstack, &kstkeip, &signal,
+      &blocked, &sigcatch, &wchan, &nswap, &cnswap);
 
   // Check for any read/parse errors.
-  if (data.fail() && !data.eof()) {
+  if (fields != 33) {
     return Error("Failed to read/parse '" + path + "'");
   }
 
-  // Remove the parentheses that is wrapped around 'comm' (when
-  // printing out the process in a process tree we use parentheses to
-  // indicate "zombie" processes).
-  comm = strings::remove(comm, "(", strings::PREFIX);
-  comm = strings::remove(comm, ")", strings::SUFFIX);
-
   return ProcessStatus(pid, comm, state, ppid, pgrp, session, tty_nr,
                        tpgid, flags, minflt, cminflt, majflt, cmajflt,
                        utime, stime, cutime, cstime, priority, nice,
@@ -342,6 +355,50 @@ inline Try<std::set<pid_t>> threads(pid_t pid)
 }
 
 
+// Reads from /proc/<pid>/task/*/children and returns the children of
+// the process, or None if the kernel does not list the children of
+// processes (this needs CONFIG_PROC_CHILDREN).
+inline Result<std::set<pid_t>> children(pid_t pid)
+{
+  Try<std::set<pid_t>> threads = proc::threads(pid);
+  if (threads.isError()) {
+    return Error(threads.error());
+  }
+
+  std::set<pid_t> children;
+
+  foreach (pid_t thread, threads.get()) {
+    const std::string task =
+      path::join("/proc", stringify(pid), "task", stringify(thread));
+
+    const std::string path = path::join(task, "children");
+
+    Try<std::string> read = os::read(path);
+    if (read.isError()) {
+      // Need to check if the file exists AFTER we open it to tell a
+      // kernel without the file from a thread that has terminated.
+      if (!os::exists(path)) {
+        if (os::exists(task)) {
+          return None();
+        }
+        continue;
+      }
+      return Error(read.error());
+    }
+
+    foreach (const std::string& token, strings::tokenize(read.get(), " \n")) {
+      Try<pid_t> child = numify<pid_t>(token);
+      if (child.isError()) {
+        return Error("Failed to parse '" + path + "': " + child.error());
+      }
+      children.insert(child.get());
+    }
+  }
+
+  return children;
+}
+
+
 // Snapshot of a system (modeled after /proc/stat).
 struct SystemStatus
 {
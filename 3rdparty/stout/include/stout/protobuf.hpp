@@ -40,9 +40,11 @@
 #include <stout/jsonify.hpp>
 #include <stout/none.hpp>
 #include <stout/nothing.hpp>
+#include <stout/option.hpp>
 #include <stout/representation.hpp>
 #include <stout/result.hpp>
 #include <stout/stringify.hpp>
+#include <stout/strings.hpp>
 #include <stout/try.hpp>
 
 #include <stout/os/close.hpp>
@@ -613,6 +615,145 @@ inline Try<Nothing> parse(
 }
 
 
+// A picojson parse context which sets the fields of a protobuf message
+// while parsing, following the same rules as `Parser` above, rather
+// than building the `JSON::Value` of the whole message first. It
+// parses a JSON object into `message`, or any JSON value into `field`
+// of `message` if `field` is set.
+class ParseContext
+{
+public:
+  ParseContext(
+      google::protobuf::Message* _message,
+      const google::protobuf::FieldDescriptor* _field,
+      Option<Error>* _error)
+    : message(_message),
+      field(_field),
+      error(_error) {}
+
+  ParseContext(const ParseContext&) = delete;
+  ParseContext& operator=(const ParseContext&) = delete;
+
+  bool set_null()
+  {
+    return apply(JSON::Null());
+  }
+
+  bool set_bool(bool b)
+  {
+    return apply(JSON::Boolean(b));
+  }
+
+  bool set_int64(int64_t i)
+  {
+    return apply(JSON::Number(i));
+  }
+
+  bool set_number(double d)
+  {
+    return apply(JSON::Number(d));
+  }
+
+  template <typename Iter>
+  bool parse_string(picojson::input<Iter>& in)
+  {
+    JSON::String string;
+    if (!picojson::_parse_string(string.value, in)) {
+      return false;
+    }
+
+    return apply(string);
+  }
+
+  bool parse_array_start()
+  {
+    if (field == nullptr) {
+      return fail("Expecting a JSON object");
+    }
+
+    if (!field->is_repeated()) {
+      return fail(
+          "Not expecting a JSON array for field '" + field->name() + "'");
+    }
+
+    return true;
+  }
+
+  template <typename Iter>
+  bool parse_array_item(picojson::input<Iter>& in, size_t)
+  {
+    ParseContext context(message, field, error);
+    return picojson::_parse(context, in);
+  }
+
+  bool parse_array_stop(size_t) { return true; }
+
+  bool parse_object_start()
+  {
+    if (field == nullptr) {
+      return true;
+    }
+
+    if (field->type() != google::protobuf::FieldDescriptor::TYPE_MESSAGE) {
+      return fail(
+          "Not expecting a JSON object for field '" + field->name() + "'");
+    }
+
+    // The items of the object are the fields of the nested message.
+    const google::protobuf::Reflection* reflection = message->GetReflection();
+    if (field->is_repeated()) {
+      message = reflection->AddMessage(message, field);
+    } else {
+      message = reflection->MutableMessage(message, field);
+    }
+
+    field = nullptr;
+    return true;
+  }
+
+  template <typename Iter>
+  bool parse_object_item(picojson::input<Iter>& in, const std::string& key)
+  {
+    const google::protobuf::FieldDescriptor* field_ =
+      message->GetDescriptor()->FindFieldByName(key);
+
+    // The values of unknown fields are parsed but ignored.
+    if (field_ == nullptr) {
+      picojson::null_parse_context context;
+      return picojson::_parse(context, in);
+    }
+
+    ParseContext context(message, field_, error);
+    return picojson::_parse(context, in);
+  }
+
+private:
+  bool apply(const JSON::Value& value)
+  {
+    if (field == nullptr) {
+      return fail("Expecting a JSON object");
+    }
+
+    Try<Nothing> apply = boost::apply_visitor(Parser(message, field), value);
+    if (apply.isError()) {
+      return fail(apply.error());
+    }
+
+    return true;
+  }
+
+  bool fail(const std::string& message)
+  {
+    *error = Error(message);
+    return false;
+  }
+
+  google::protobuf::Message* message;
+  const google::protobuf::FieldDescriptor* field;
+  Option<Error>* error;
+};
+
+
 // Parses a single protobuf message of type T from a JSON::Object.
 // NOTE: This struct is used by the public parse<T>() function below. See
 // comments there for the reason why we opted for this design.
@@ -698,6 +839,54 @@ Try<T> parse(const JSON::Value& value)
   return internal::Parse<T>()(value);
 }
 
+
+// Parses a protobuf message of type T from a JSON string. This is the
+// same as parsing the string into a `JSON::Value` and then parsing the
+// message from it, except that the fields of the message get set while
+// the string is parsed, which saves building the `JSON::Value`.
+//
+// NOTE: Unlike when parsing through a `JSON::Object`, if a key appears
+// more than once in an object, all the values for a repeated field
+// are kept and the values for a nested message get merged.
+template <typename T>
+Try<T> parseJSON(const std::string& json)
+{
+  static_assert(std::is_convertible<T*, google::protobuf::Message*>::value,
+                "T must be a protobuf message");
+
+  T message;
+
+  Option<Error> error;
+  internal::ParseContext context(&message, nullptr, &error);
+
+  const char* begin = json.c_str();
+  std::string syntax;
+
+  const char* end =
+    picojson::_parse(context, begin, begin + json.size(), &syntax);
+
+  if (error.isSome()) {
+    return error.get();
+  } else if (!syntax.empty()) {
+    return Error(syntax);
+  }
+
+  // See `JSON::parse` for why trailing characters need to be checked.
+  const char* last = begin + json.find_last_not_of(strings::WHITESPACE);
+  if (end != last + 1) {
+    return Error(
+        "Parsed JSON included non-whitespace trailing characters: " +
+        json.substr(end - begin, last + 1 - end));
+  }
+
+  if (!message.IsInitialized()) {
+    return Error("Missing required fields: " +
+                 message.InitializationErrorString());
+  }
+
+  return message;
+}
+
 } // namespace protobuf {
 
 namespace JSON {
@@ -14,7 +14,9 @@
 #define __STOUT_RECORDIO_HPP__
 
 #include <stdlib.h>
+#include <string.h>
 
+#include <algorithm>
 #include <deque>
 #include <functional>
 #include <string>
@@ -65,8 +67,18 @@ public:
    */
   std::string encode(const T& record) const
   {
-    std::string s = serialize(record);
-    return stringify(s.size()) + "\n" + s;
+    const std::string s = serialize(record);
+    const std::string header = stringify(s.size());
+
+    // Building the result in place avoids reallocating it (and
+    // copying the record again) while appending the record.
+    std::string result;
+    result.reserve(header.size() + 1 + s.size());
+    result.append(header);
+    result.push_back('\n');
+    result.append(s);
+
+    return result;
   }
 
 private:
@@ -105,14 +117,26 @@ public:
 
     std::deque<Try<T>> records;
 
-    foreach (char c, data) {
+    // Rather than going through the data a character at a time, look
+    // for the end of each header and copy the (partial) records in
+    // one go.
+    size_t position = 0;
+
+    while (position < data.size()) {
       if (state == HEADER) {
+        const char* newline = static_cast<const char*>(::memchr(
+            data.data() + position, '\n', data.size() - position));
+
         // Keep reading until we have the entire header.
-        if (c != '\n') {
-          buffer += c;
-          continue;
+        if (newline == nullptr) {
+          buffer.append(data, position, std::string::npos);
+          break;
         }
 
+        const size_t end = newline - data.data();
+        buffer.append(data, position, end - position);
+        position = end + 1;
+
         Try<size_t> numify = ::numify<size_t>(buffer);
 
         // If we were unable to decode the length header, do not
@@ -137,7 +161,11 @@ public:
         CHECK_SOME(length);
         CHECK_LT(buffer.size(), length.get());
 
-        buffer += c;
+        const size_t size =
+          std::min(length.get() - buffer.size(), data.size() - position);
+
+        buffer.append(data, position, size);
+        position += size;
 
         if (buffer.size() == length.get()) {
           records.push_back(deserialize(buffer));
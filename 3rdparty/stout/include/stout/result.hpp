@@ -17,6 +17,7 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
 
 #include <stout/abort.hpp>
 #include <stout/error.hpp>
@@ -78,6 +79,16 @@ public:
            Try<Option<T>>(Some(_t.get())) :
            Try<Option<T>>(Error(_t.error()))) {}
 
+  Result(Option<T>&& option)
+    : data(option.isSome() ?
+           Try<Option<T>>(Some(std::move(option).get())) :
+           Try<Option<T>>(None())) {}
+
+  Result(Try<T>&& _t)
+    : data(_t.isSome() ?
+           Try<Option<T>>(Some(std::move(_t).get())) :
+           Try<Option<T>>(Error(_t.error()))) {}
+
   Result(const None& none)
     : data(none) {}
 
@@ -99,6 +110,7 @@ public:
   // We don't need to implement these because we are leveraging
   // Try<Option<T>>.
   Result(const Result<T>& that) = default;
+  Result(Result<T>&& that) = default;
   ~Result() = default;
   Result<T>& operator=(const Result<T>& that) = default;
   Result<T>& operator=(Result<T>&& that) = default;
@@ -109,24 +121,12 @@ public:
   bool isNone() const { return data.isSome() && data.get().isNone(); }
   bool isError() const { return data.isError(); }
 
-  const T& get() const
-  {
-    if (!isSome()) {
-      std::string errorMessage = "Result::get() but state == ";
-      if (isError()) {
-        errorMessage += "ERROR: " + data.error();
-      } else if (isNone()) {
-        errorMessage += "NONE";
-      }
-      ABORT(errorMessage);
-    }
-    return data.get().get();
-  }
+  const T& get() const & { return get(*this); }
+  T& get() & { return get(*this); }
 
-  T& get()
-  {
-    return const_cast<T&>(static_cast<const Result&>(*this).get());
-  }
+  // See `Try::get() &&`.
+  T&& get() && { return get(std::move(*this)); }
+  const T&& get() const && { return get(std::move(*this)); }
 
   const T* operator->() const { return &get(); }
   T* operator->() { return &get(); }
@@ -134,6 +134,22 @@ public:
   const std::string& error() const { assert(isError()); return data.error(); }
 
 private:
+  template <typename Self>
+  static auto get(Self&& self)
+    -> decltype(std::forward<Self>(self).data.get().get())
+  {
+    if (!self.isSome()) {
+      std::string errorMessage = "Result::get() but state == ";
+      if (self.isError()) {
+        errorMessage += "ERROR: " + self.data.error();
+      } else if (self.isNone()) {
+        errorMessage += "NONE";
+      }
+      ABORT(errorMessage);
+    }
+    return std::forward<Self>(self).data.get().get();
+  }
+
   // We leverage Try<Option<T>> to avoid dynamic allocation of T. This
   // means we can take advantage of all the RAII features of 'Try' and
   // makes the implementation of this class much simpler!
@@ -85,6 +85,47 @@ inline std::string stringify(bool b)
 }
 
 
+// We provide explicit overloads for the integral types most commonly
+// stringified (e.g., IDs, ports, sizes and counters when building
+// paths and metric keys) so we do not incur the overhead of a
+// stringstream. Narrower types (e.g., `char`, `int8_t`) still go
+// through the stream so they keep being rendered as characters.
+inline std::string stringify(int i)
+{
+  return std::to_string(i);
+}
+
+
+inline std::string stringify(long l)
+{
+  return std::to_string(l);
+}
+
+
+inline std::string stringify(long long ll)
+{
+  return std::to_string(ll);
+}
+
+
+inline std::string stringify(unsigned int u)
+{
+  return std::to_string(u);
+}
+
+
+inline std::string stringify(unsigned long ul)
+{
+  return std::to_string(ul);
+}
+
+
+inline std::string stringify(unsigned long long ull)
+{
+  return std::to_string(ull);
+}
+
+
 template <typename T>
 std::string stringify(const std::set<T>& set)
 {
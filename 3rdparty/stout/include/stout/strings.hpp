@@ -299,6 +299,45 @@ std::stringstream& join(
   return stream;
 }
 
+
+inline void append(std::string& result, const std::string& value)
+{
+  result += value;
+}
+
+
+inline void append(std::string& result, const char* value)
+{
+  result += value;
+}
+
+
+template <typename T>
+void append(std::string& result, const T& value)
+{
+  result += ::stringify(value);
+}
+
+
+template <typename T>
+void join(std::string& result, const std::string& separator, const T& tail)
+{
+  append(result, tail);
+}
+
+
+template <typename THead, typename... TTail>
+void join(
+    std::string& result,
+    const std::string& separator,
+    const THead& head,
+    const TTail&... tail)
+{
+  append(result, head);
+  result += separator;
+  internal::join(result, separator, tail...);
+}
+
 } // namespace internal {
 
 
@@ -324,14 +363,12 @@ std::string join(
     THead2&& head2,
     TTail&&... tail)
 {
-  std::stringstream stream;
-  internal::join(
-      stream,
-      separator,
-      std::forward<THead1>(head1),
-      std::forward<THead2>(head2),
-      std::forward<TTail>(tail)...);
-  return stream.str();
+  // NOTE: We append to a string directly rather than going through a
+  // stringstream since this is used on hot paths (e.g., when building
+  // metric keys).
+  std::string result;
+  internal::join(result, separator, head1, head2, tail...);
+  return result;
 }
 
 
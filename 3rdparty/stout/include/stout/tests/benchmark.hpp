@@ -0,0 +1,167 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __STOUT_TESTS_BENCHMARK_HPP__
+#define __STOUT_TESTS_BENCHMARK_HPP__
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <stout/duration.hpp>
+#include <stout/foreach.hpp>
+#include <stout/json.hpp>
+#include <stout/option.hpp>
+#include <stout/stringify.hpp>
+
+#include <stout/os/getenv.hpp>
+
+// The environment variable naming the file the benchmark reports get
+// appended to, one JSON object per line.
+constexpr char BENCHMARK_OUTPUT_ENVIRONMENT_VARIABLE[] = "BENCHMARK_OUTPUT";
+
+
+// Collects the measurements of a benchmark, and reports them as JSON
+// so that runs can be compared with `support/compare-benchmarks.py`:
+//
+//   BenchmarkReport report;
+//   report.parameter("agents", agentCount);
+//
+//   for (size_t i = 0; i < repetitions; i++) {
+//     ...
+//     report.sample("allocation", watch.elapsed());
+//   }
+//
+//   report.write();
+//
+// Each metric gets summarized by the number of samples, the mean, the
+// minimum, the maximum and the 50th, 90th and 99th percentiles. Rates
+// should use a unit ending with "/s", which tells the comparison that
+// higher values are better.
+class BenchmarkReport
+{
+public:
+  // Names the report after the current test, including the index of
+  // the parameters of a value-parameterized test.
+  BenchmarkReport()
+  {
+    const ::testing::TestInfo* test =
+      ::testing::UnitTest::GetInstance()->current_test_info();
+
+    if (test != nullptr) {
+      name = std::string(test->test_case_name()) + "." + test->name();
+    }
+  }
+
+  explicit BenchmarkReport(const std::string& _name) : name(_name) {}
+
+  template <typename T>
+  void parameter(const std::string& key, const T& value)
+  {
+    parameters.values[key] = value;
+  }
+
+  // Durations are reported in seconds.
+  void sample(const std::string& metric, const Duration& duration)
+  {
+    sample(metric, duration.secs(), "s");
+  }
+
+  void sample(
+      const std::string& metric,
+      double value,
+      const std::string& unit = "")
+  {
+    Metric& _metric = metrics[metric];
+    _metric.unit = unit;
+    _metric.samples.push_back(value);
+  }
+
+  JSON::Object json() const
+  {
+    JSON::Object _metrics;
+
+    foreach (const auto& metric, metrics) {
+      std::vector<double> samples = metric.second.samples;
+      std::sort(samples.begin(), samples.end());
+
+      double sum = 0;
+      foreach (double sample, samples) {
+        sum += sample;
+      }
+
+      JSON::Object summary;
+      if (!metric.second.unit.empty()) {
+        summary.values["unit"] = metric.second.unit;
+      }
+
+      summary.values["samples"] = samples.size();
+      summary.values["mean"] = sum / samples.size();
+      summary.values["min"] = samples.front();
+      summary.values["p50"] = percentile(samples, 50);
+      summary.values["p90"] = percentile(samples, 90);
+      summary.values["p99"] = percentile(samples, 99);
+      summary.values["max"] = samples.back();
+
+      _metrics.values[metric.first] = summary;
+    }
+
+    JSON::Object object;
+    object.values["name"] = name;
+    object.values["parameters"] = parameters;
+    object.values["metrics"] = _metrics;
+
+    return object;
+  }
+
+  // Appends the report to the file named by `BENCHMARK_OUTPUT`, if set.
+  void write() const
+  {
+    Option<std::string> path =
+      os::getenv(BENCHMARK_OUTPUT_ENVIRONMENT_VARIABLE);
+
+    if (path.isNone()) {
+      return;
+    }
+
+    std::ofstream file(path.get(), std::ios::app);
+    file << stringify(json()) << std::endl;
+
+    EXPECT_TRUE(file.good())
+      << "Failed to write the benchmark report to '" << path.get() << "'";
+  }
+
+private:
+  struct Metric
+  {
+    std::string unit;
+    std::vector<double> samples;
+  };
+
+  // Returns the percentile of non-empty, sorted samples, using the
+  // nearest rank.
+  static double percentile(const std::vector<double>& samples, double percent)
+  {
+    const size_t rank = static_cast<size_t>(samples.size() * percent / 100.0);
+    return samples[std::min(rank, samples.size() - 1)];
+  }
+
+  std::string name;
+  JSON::Object parameters;
+  std::map<std::string, Metric> metrics;
+};
+
+#endif // __STOUT_TESTS_BENCHMARK_HPP__
@@ -17,6 +17,8 @@
 
 #include <iostream>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include <stout/abort.hpp>
 #include <stout/error.hpp>
@@ -55,6 +57,10 @@ public:
   Try(T&& t)
     : data(Some(std::move(t))) {}
 
+  template <typename U>
+  Try(_Some<U>&& some)
+    : data(std::move(some)) {}
+
   // We don't need to implement these because we are leveraging
   // Option<T>.
   Try(const Try& that) = default;
@@ -70,19 +76,13 @@ public:
   bool isSome() const { return data.isSome(); }
   bool isError() const { return data.isNone(); }
 
-  const T& get() const
-  {
-    if (!data.isSome()) {
-      assert(error_.isSome());
-      ABORT("Try::get() but state == ERROR: " + error_.get().message);
-    }
-    return data.get();
-  }
+  const T& get() const & { return get(*this); }
+  T& get() & { return get(*this); }
 
-  T& get()
-  {
-    return const_cast<T&>(static_cast<const Try&>(*this).get());
-  }
+  // Allows moving the value out of a `Try` which is an rvalue, e.g.,
+  // `std::move(t).get()`, rather than copying it.
+  T&& get() && { return get(std::move(*this)); }
+  const T&& get() const && { return get(std::move(*this)); }
 
   const T* operator->() const { return &get(); }
   T* operator->() { return &get(); }
@@ -99,6 +99,16 @@ public:
   }
 
 private:
+  template <typename Self>
+  static auto get(Self&& self) -> decltype(std::forward<Self>(self).data.get())
+  {
+    if (!self.data.isSome()) {
+      assert(self.error_.isSome());
+      ABORT("Try::get() but state == ERROR: " + self.error_.get().message);
+    }
+    return std::forward<Self>(self).data.get();
+  }
+
   static const std::string& error_impl(const Error& err) { return err.message; }
 
   template <typename Err>
@@ -0,0 +1,217 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stout/flat_hashmap.hpp>
+#include <stout/foreach.hpp>
+#include <stout/gtest.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/stopwatch.hpp>
+#include <stout/stringify.hpp>
+
+using std::string;
+using std::unique_ptr;
+
+
+TEST(FlatHashMapTest, InitializerList)
+{
+  flat_hashmap<string, int> map{{"hello", 1}};
+  EXPECT_EQ(1u, map.size());
+
+  EXPECT_TRUE((flat_hashmap<int, int>{}.empty()));
+
+  flat_hashmap<int, int> map2{{1, 2}, {2, 3}, {3, 4}};
+  EXPECT_EQ(3u, map2.size());
+  EXPECT_SOME_EQ(2, map2.get(1));
+  EXPECT_SOME_EQ(3, map2.get(2));
+  EXPECT_SOME_EQ(4, map2.get(3));
+  EXPECT_NONE(map2.get(4));
+}
+
+
+TEST(FlatHashMapTest, Insert)
+{
+  flat_hashmap<string, int> map;
+  map["abc"] = 1;
+  map.put("def", 2);
+
+  EXPECT_SOME_EQ(1, map.get("abc"));
+  EXPECT_SOME_EQ(2, map.get("def"));
+  EXPECT_EQ(2u, map.size());
+
+  map.put("def", 4);
+  EXPECT_SOME_EQ(4, map.get("def"));
+  EXPECT_EQ(2u, map.size());
+
+  EXPECT_FALSE(map.emplace("abc", 5).second);
+  EXPECT_EQ(1, map.at("abc"));
+
+  EXPECT_TRUE(map.emplace("ghi", 6).second);
+  EXPECT_EQ(6, map.at("ghi"));
+
+  EXPECT_THROW(map.at("jkl"), std::out_of_range);
+
+  EXPECT_TRUE(map.contains("abc"));
+  EXPECT_FALSE(map.contains("jkl"));
+
+  EXPECT_TRUE(map.containsValue(4));
+  EXPECT_FALSE(map.containsValue(2));
+
+  EXPECT_EQ(hashset<string>({"abc", "def", "ghi"}), map.keys());
+}
+
+
+// This test verifies that the map stays consistent with an
+// `std::unordered_map` while entries get inserted and erased, i.e.,
+// while entries get displaced, shifted back and rehashed.
+TEST(FlatHashMapTest, Consistency)
+{
+  flat_hashmap<int, string> map;
+  std::unordered_map<int, string> expected;
+
+  for (int i = 0; i < 10000; i++) {
+    const int key = (i * 7919) % 3001;
+
+    if (i % 3 == 2) {
+      EXPECT_EQ(expected.erase(key), map.erase(key));
+    } else {
+      map.put(key, stringify(i));
+      expected[key] = stringify(i);
+    }
+  }
+
+  ASSERT_EQ(expected.size(), map.size());
+
+  size_t size = 0;
+  foreachpair (int key, const string& value, map) {
+    ASSERT_EQ(1u, expected.count(key));
+    EXPECT_EQ(expected.at(key), value);
+    size++;
+  }
+
+  EXPECT_EQ(expected.size(), size);
+
+  // Copies and moves keep all the entries.
+  flat_hashmap<int, string> copy = map;
+  EXPECT_EQ(map.size(), copy.size());
+
+  flat_hashmap<int, string> moved = std::move(copy);
+  EXPECT_EQ(map.size(), moved.size());
+  EXPECT_TRUE(copy.empty());
+
+  foreachpair (int key, const string& value, expected) {
+    EXPECT_SOME_EQ(value, moved.get(key));
+  }
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_NONE(map.get(expected.begin()->first));
+}
+
+
+// This test verifies that a hash function mapping all the keys to the
+// same slot is supported, if slow.
+TEST(FlatHashMapTest, Collisions)
+{
+  struct ConstantHash
+  {
+    size_t operator()(int) const { return 42; }
+  };
+
+  flat_hashmap<int, int, ConstantHash> map;
+
+  for (int i = 0; i < 1000; i++) {
+    map[i] = i;
+  }
+
+  for (int i = 0; i < 1000; i += 2) {
+    map.erase(i);
+  }
+
+  EXPECT_EQ(500u, map.size());
+
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(i % 2 == 1, map.contains(i));
+  }
+}
+
+
+// This test verifies that move-only values are supported.
+TEST(FlatHashMapTest, MoveOnly)
+{
+  flat_hashmap<int, unique_ptr<int>> map;
+
+  for (int i = 0; i < 100; i++) {
+    map.emplace(i, unique_ptr<int>(new int(i)));
+  }
+
+  for (int i = 0; i < 100; i += 2) {
+    map.erase(i);
+  }
+
+  EXPECT_EQ(50u, map.size());
+
+  foreachpair (int key, const unique_ptr<int>& value, map) {
+    EXPECT_EQ(key, *value);
+  }
+}
+
+
+// Compares the time it takes to insert and find integers in a
+// `flat_hashmap` and in a `hashmap`.
+TEST(FlatHashMapTest, Performance)
+{
+  const int size = 100000;
+
+  Stopwatch watch;
+
+  watch.start();
+
+  hashmap<int, int> map1;
+  for (int i = 0; i < size; i++) {
+    map1[i * 31] = i;
+  }
+
+  size_t found1 = 0;
+  for (int i = 0; i < size * 2; i++) {
+    found1 += map1.count(i * 31);
+  }
+
+  watch.stop();
+
+  std::cout << "Took " << watch.elapsed() << " for hashmap" << std::endl;
+
+  watch.start();
+
+  flat_hashmap<int, int> map2;
+  for (int i = 0; i < size; i++) {
+    map2[i * 31] = i;
+  }
+
+  size_t found2 = 0;
+  for (int i = 0; i < size * 2; i++) {
+    found2 += map2.count(i * 31);
+  }
+
+  watch.stop();
+
+  std::cout << "Took " << watch.elapsed() << " for flat_hashmap" << std::endl;
+
+  EXPECT_EQ(found1, found2);
+}
@@ -0,0 +1,87 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License
+
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <stout/flat_hashset.hpp>
+#include <stout/foreach.hpp>
+
+using std::string;
+
+
+TEST(FlatHashsetTest, InitializerList)
+{
+  flat_hashset<string> set{"hello"};
+  EXPECT_EQ(1u, set.size());
+
+  EXPECT_TRUE((flat_hashset<int>{}.empty()));
+
+  flat_hashset<int> set1{1, 3, 5, 7, 11};
+  EXPECT_EQ(5u, set1.size());
+  EXPECT_TRUE(set1.contains(1));
+  EXPECT_TRUE(set1.contains(3));
+  EXPECT_TRUE(set1.contains(5));
+  EXPECT_TRUE(set1.contains(7));
+  EXPECT_TRUE(set1.contains(11));
+
+  EXPECT_FALSE(set1.contains(2));
+}
+
+
+TEST(FlatHashsetTest, InsertErase)
+{
+  flat_hashset<string> set;
+
+  EXPECT_TRUE(set.insert("a").second);
+  EXPECT_FALSE(set.insert("a").second);
+  EXPECT_TRUE(set.insert("b").second);
+  EXPECT_EQ(2u, set.size());
+
+  EXPECT_EQ("b", *set.find("b"));
+  EXPECT_TRUE(set.find("c") == set.end());
+
+  EXPECT_EQ(1u, set.erase("a"));
+  EXPECT_EQ(0u, set.erase("a"));
+  EXPECT_FALSE(set.contains("a"));
+  EXPECT_EQ(1u, set.size());
+}
+
+
+// This test verifies that the set stays consistent with an `std::set`
+// as it grows and shrinks.
+TEST(FlatHashsetTest, Consistency)
+{
+  flat_hashset<int> set;
+  std::set<int> expected;
+
+  for (int i = 0; i < 10000; i++) {
+    const int elem = (i * 7919) % 2003;
+
+    if (i % 4 == 3) {
+      EXPECT_EQ(expected.erase(elem), set.erase(elem));
+    } else {
+      EXPECT_EQ(expected.insert(elem).second, set.insert(elem).second);
+    }
+  }
+
+  EXPECT_EQ(expected.size(), set.size());
+
+  std::set<int> elems;
+  foreach (int elem, set) {
+    EXPECT_TRUE(elems.insert(elem).second);
+  }
+
+  EXPECT_EQ(expected, elems);
+}
@@ -64,6 +64,53 @@ TEST(GzipTest, CompressDecompressString)
 }
 
 
+TEST(GzipTest, Compressor)
+{
+  string s =
+    "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do "
+    "eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim ad "
+    "minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+    "aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit "
+    "in voluptate velit esse cillum dolore eu fugiat nulla pariatur. "
+    "Excepteur sint occaecat cupidatat non proident, sunt in culpa qui "
+    "officia deserunt mollit anim id est laborum.";
+
+  gzip::Compressor compressor;
+  gzip::Decompressor decompressor;
+
+  // Compress 10 bytes at a time, each compressed chunk should be
+  // decompressible right away.
+  string decompressed;
+
+  for (size_t i = 0; i < s.size(); i += 10) {
+    Try<string> compressed = compressor.compress(s.substr(i, 10));
+    ASSERT_SOME(compressed);
+
+    Try<string> decompressedChunk = decompressor.decompress(compressed.get());
+    ASSERT_SOME(decompressedChunk);
+    EXPECT_EQ(s.substr(i, 10), decompressedChunk.get());
+
+    decompressed += decompressedChunk.get();
+  }
+
+  EXPECT_FALSE(decompressor.finished());
+
+  Try<string> compressed = compressor.finish();
+  ASSERT_SOME(compressed);
+  EXPECT_TRUE(compressor.finished());
+
+  Try<string> decompressedChunk = decompressor.decompress(compressed.get());
+  ASSERT_SOME(decompressedChunk);
+  EXPECT_EQ("", decompressedChunk.get());
+
+  EXPECT_TRUE(decompressor.finished());
+
+  ASSERT_EQ(s, decompressed);
+
+  EXPECT_ERROR(compressor.compress(s));
+}
+
+
 TEST(GzipTest, Decompressor)
 {
   string s =
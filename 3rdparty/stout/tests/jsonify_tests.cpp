@@ -124,6 +124,31 @@ TEST(JsonifyTest, String)
 }
 
 
+// Tests that the characters to escape are found at any position of a
+// string, since the characters of a string get checked a word at a time.
+TEST(JsonifyTest, StringEscapingPositions)
+{
+  const string escapes("\"\\/\b\x01\x7F", 6);
+  const vector<string> escaped =
+    {"\\\"", "\\\\", "\\/", "\\b", "\\u0001", "\\u007f"};
+
+  // Characters beyond ASCII are not escaped.
+  const string base = "abcdefg\xC3\xA9hijklmnopqrstuvwxyz";
+
+  for (size_t i = 0; i < escapes.size(); i++) {
+    for (size_t position = 0; position < base.size(); position++) {
+      string value = base;
+      value[position] = escapes[i];
+
+      EXPECT_EQ(
+          "\"" + base.substr(0, position) + escaped[i] +
+            base.substr(position + 1) + "\"",
+          string(jsonify(value)));
+    }
+  }
+}
+
+
 // Tests that `JSON::String`s are jsonified correctly, including escaping.
 TEST(JsonifyTest, JSONString)
 {
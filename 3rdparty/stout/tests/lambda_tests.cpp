@@ -10,6 +10,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License
 
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <stout/lambda.hpp>
@@ -222,3 +227,68 @@ TEST(PartialTest, Test)
   mp2();
   std::move(mp2)();
 }
+
+
+// This test verifies that `CallableOnce` invokes and destroys its
+// target exactly once, whether the target is small enough to be
+// stored inline or not, as the `CallableOnce` gets moved around.
+TEST(CallableOnceTest, Move)
+{
+  struct Counter
+  {
+    explicit Counter(int* _destroyed) : destroyed(_destroyed) {}
+
+    Counter(Counter&& that) noexcept : destroyed(that.destroyed)
+    {
+      that.destroyed = nullptr;
+    }
+
+    ~Counter()
+    {
+      if (destroyed != nullptr) {
+        (*destroyed)++;
+      }
+    }
+
+    int* destroyed;
+  };
+
+  int destroyed = 0;
+
+  {
+    Counter counter(&destroyed);
+    lambda::CallableOnce<int(int)> f(lambda::partial(
+        [](const Counter&, int i) { return i + 1; },
+        std::move(counter),
+        lambda::_1));
+
+    lambda::CallableOnce<int(int)> g(std::move(f));
+    f = std::move(g);
+
+    EXPECT_EQ(2, std::move(f)(1));
+  }
+
+  EXPECT_EQ(1, destroyed);
+
+  destroyed = 0;
+
+  {
+    Counter counter(&destroyed);
+
+    // Too large to be stored inline.
+    std::array<char, 1024> padding;
+    padding.fill('a');
+
+    lambda::CallableOnce<char(int)> f(lambda::partial(
+        [padding](const Counter&, int i) { return padding[i]; },
+        std::move(counter),
+        lambda::_1));
+
+    lambda::CallableOnce<char(int)> g(std::move(f));
+    f = std::move(g);
+
+    EXPECT_EQ('a', std::move(f)(1));
+  }
+
+  EXPECT_EQ(1, destroyed);
+}
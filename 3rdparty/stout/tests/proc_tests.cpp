@@ -12,6 +12,9 @@
 
 #include <unistd.h> // For getpid, getppid.
 
+#include <sys/prctl.h>
+#include <sys/wait.h>
+
 #include <condition_variable>
 #include <iostream>
 #include <list>
@@ -77,6 +80,71 @@ TEST(ProcTest, ProcessStatus)
 }
 
 
+// Tests that the status of a process whose command contains spaces and
+// parentheses is parsed correctly.
+TEST(ProcTest, ProcessStatusCommand)
+{
+  pid_t pid = ::fork();
+  ASSERT_NE(-1, pid);
+
+  if (pid == 0) {
+    ::prctl(PR_SET_NAME, "a (b) c", 0, 0, 0);
+    while (true) {
+      ::pause();
+    }
+  }
+
+  Result<ProcessStatus> status = None();
+
+  Duration elapsed = Duration::zero();
+  while (true) {
+    status = proc::status(pid);
+    ASSERT_SOME(status);
+
+    if (status->comm == "a (b) c") {
+      break;
+    }
+
+    if (elapsed > Seconds(10)) {
+      FAIL() << "Failed to wait for the child to set its name";
+    }
+
+    os::sleep(Milliseconds(5));
+    elapsed += Milliseconds(5);
+  }
+
+  EXPECT_EQ(pid, status->pid);
+  EXPECT_EQ(getpid(), status->ppid);
+
+  ::kill(pid, SIGKILL);
+  ASSERT_EQ(pid, ::waitpid(pid, nullptr, 0));
+}
+
+
+TEST(ProcTest, Children)
+{
+  pid_t pid = ::fork();
+  ASSERT_NE(-1, pid);
+
+  if (pid == 0) {
+    while (true) {
+      ::pause();
+    }
+  }
+
+  Result<set<pid_t>> children = proc::children(getpid());
+  ASSERT_FALSE(children.isError()) << children.error();
+
+  // The kernel might not list the children of processes.
+  if (children.isSome()) {
+    EXPECT_EQ(1u, children->count(pid));
+  }
+
+  ::kill(pid, SIGKILL);
+  ASSERT_EQ(pid, ::waitpid(pid, nullptr, 0));
+}
+
+
 // NOTE: This test assumes there is a single thread running for the test.
 TEST(ProcTest, SingleThread)
 {
@@ -418,6 +418,74 @@ TEST(ProtobufTest, ParseJSONNestedError)
 }
 
 
+// Tests that parsing a message straight from a JSON string gives the
+// same message, or the same errors, as parsing it from a `JSON::Value`.
+TEST(ProtobufTest, ParseJSONString)
+{
+  tests::Message message;
+  message.set_b(true);
+  message.set_str("string");
+  message.set_bytes("bytes");
+  message.set_int32(-1);
+  message.set_uint64(1);
+  message.set_f(1.0);
+  message.set_d(1.0);
+  message.set_e(tests::ONE);
+  message.mutable_nested()->set_str("nested");
+  message.add_repeated_string("repeated_string");
+  message.add_repeated_double(1.0);
+  message.add_repeated_double(2.0);
+  message.add_repeated_enum(tests::TWO);
+  message.add_repeated_nested()->set_str("repeated_nested1");
+  message.add_repeated_nested()->set_str("repeated_nested2");
+
+  const JSON::Object object = JSON::protobuf(message);
+  const string json = stringify(object);
+
+  Try<tests::Message> expected = protobuf::parse<tests::Message>(object);
+  ASSERT_SOME(expected);
+
+  Try<tests::Message> parse = protobuf::parseJSON<tests::Message>(json);
+  ASSERT_SOME(parse);
+
+  EXPECT_EQ(expected->SerializeAsString(), parse->SerializeAsString());
+
+  // Unknown fields and 'null' values are ignored.
+  Try<tests::Nested> nested = protobuf::parseJSON<tests::Nested>(
+      "{\"str\": \"value\", \"unknown\": {\"a\": [1]}, "
+      "\"optional_str\": null}");
+
+  ASSERT_SOME(nested);
+  EXPECT_EQ("value", nested->str());
+  EXPECT_FALSE(nested->has_optional_str());
+
+  Try<tests::Message> error = protobuf::parseJSON<tests::Message>(
+      "{\"b\": true, \"nested\": {\"str\": 1.0}}");
+
+  ASSERT_ERROR(error);
+  EXPECT_TRUE(strings::contains(
+      error.error(), "Not expecting a JSON number for field"));
+
+  error = protobuf::parseJSON<tests::Message>("{\"str\": [\"string\"]}");
+  ASSERT_ERROR(error);
+  EXPECT_TRUE(strings::contains(
+      error.error(), "Not expecting a JSON array for field"));
+
+  error = protobuf::parseJSON<tests::Message>("{\"b\": {}}");
+  ASSERT_ERROR(error);
+  EXPECT_TRUE(strings::contains(
+      error.error(), "Not expecting a JSON object for field"));
+
+  EXPECT_ERROR(protobuf::parseJSON<tests::Message>("[]"));
+  EXPECT_ERROR(protobuf::parseJSON<tests::Message>("null"));
+  EXPECT_ERROR(protobuf::parseJSON<tests::Message>("{\"b\": "));
+  EXPECT_ERROR(protobuf::parseJSON<tests::Message>(json + " {}"));
+
+  // The required fields must be set.
+  EXPECT_ERROR(protobuf::parseJSON<tests::Nested>("{}"));
+}
+
+
 // Tests when parsing protobuf from JSON, for the optional enum field which
 // has an unrecognized enum value, after the parsing the field will be unset
 // and its getter will return the default enum value. For the repeated enum
@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 
 #include <stout/error.hpp>
+#include <stout/foreach.hpp>
 #include <stout/gtest.hpp>
 #include <stout/recordio.hpp>
 #include <stout/some.hpp>
@@ -157,3 +158,39 @@ TEST(RecordIOTest, Decoder)
   EXPECT_ERROR(decoder.decode("not a number\n"));
   EXPECT_ERROR(decoder.decode("1\n"));
 }
+
+
+// This test verifies that the records get decoded the same way no
+// matter how the data is split into chunks.
+TEST(RecordIOTest, DecoderChunks)
+{
+  recordio::Encoder<string> encoder([](const string& s) { return s; });
+
+  const deque<string> expected = {"hello", "", "13 characters", "!"};
+
+  string data;
+  foreach (const string& record, expected) {
+    data += encoder.encode(record);
+  }
+
+  for (size_t size = 1; size <= data.size(); size++) {
+    recordio::Decoder<string> decoder(
+        [](const string& s) { return Try<string>(s); });
+
+    deque<string> records;
+
+    for (size_t position = 0; position < data.size(); position += size) {
+      Try<deque<Try<string>>> decode =
+        decoder.decode(data.substr(position, size));
+
+      ASSERT_SOME(decode);
+
+      foreach (const Try<string>& record, decode.get()) {
+        ASSERT_SOME(record);
+        records.push_back(record.get());
+      }
+    }
+
+    EXPECT_EQ(expected, records) << "Chunks of size " << size;
+  }
+}
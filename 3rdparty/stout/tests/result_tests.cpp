@@ -10,7 +10,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
 #include <string>
+#include <utility>
 
 #include <gmock/gmock.h>
 
@@ -20,6 +22,7 @@
 #include <stout/try.hpp>
 
 using std::string;
+using std::unique_ptr;
 
 // Verify Try to Result conversion.
 TEST(ResultTest, TryToResultConversion)
@@ -57,3 +60,23 @@ TEST(ResultTest, ArrowOperator)
   s->clear();
   EXPECT_TRUE(s->empty());
 }
+
+
+TEST(ResultTest, MoveGet)
+{
+  Result<unique_ptr<int>> result = unique_ptr<int>(new int(42));
+  ASSERT_SOME(result);
+
+  // Moving the `Result` itself must not copy the value either.
+  Result<unique_ptr<int>> moved = std::move(result);
+  ASSERT_SOME(moved);
+
+  unique_ptr<int> i = std::move(moved).get();
+  ASSERT_NE(nullptr, i.get());
+  EXPECT_EQ(42, *i);
+
+  Try<unique_ptr<int>> t = unique_ptr<int>(new int(7));
+  Result<unique_ptr<int>> converted = std::move(t);
+  ASSERT_SOME(converted);
+  EXPECT_EQ(7, *converted.get());
+}
@@ -477,6 +477,11 @@ TEST(StringsTest, Join)
   EXPECT_EQ(
       "a/gnarly/true/{ 1, 2, 3 }/c",
       strings::join("/", "a", gnarly, is_true, my_set, "c"));
+
+  EXPECT_EQ(
+      "1/x/-2/3/4",
+      strings::join("/", 1, 'x', -2L, static_cast<uint64_t>(3),
+                    static_cast<uint16_t>(4)));
 }
 
 
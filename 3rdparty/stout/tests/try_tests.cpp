@@ -10,13 +10,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
 #include <string>
+#include <utility>
 
 #include <gtest/gtest.h>
 
 #include <stout/try.hpp>
 
 using std::string;
+using std::unique_ptr;
 
 TEST(TryTest, ArrowOperator)
 {
@@ -26,3 +29,20 @@ TEST(TryTest, ArrowOperator)
   s->clear();
   EXPECT_TRUE(s->empty());
 }
+
+
+// This test verifies that the value of an rvalue `Try` gets moved
+// rather than copied, which also allows for move-only types.
+TEST(TryTest, MoveGet)
+{
+  Try<unique_ptr<int>> t = unique_ptr<int>(new int(42));
+  ASSERT_TRUE(t.isSome());
+
+  unique_ptr<int> i = std::move(t).get();
+  ASSERT_NE(nullptr, i.get());
+  EXPECT_EQ(42, *i);
+
+  Try<string> s = string("hello");
+  string moved = std::move(s).get();
+  EXPECT_EQ("hello", moved);
+}
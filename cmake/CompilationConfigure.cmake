@@ -87,6 +87,18 @@ option(
   "Build libprocess with lock free run queue."
   FALSE)
 
+option(
+  ENABLE_WORK_STEALING_RUN_QUEUE
+  "Build libprocess with per-worker work-stealing run queue."
+  FALSE)
+
+if (ENABLE_LOCK_FREE_RUN_QUEUE AND ENABLE_WORK_STEALING_RUN_QUEUE)
+  message(
+    FATAL_ERROR
+    "ENABLE_LOCK_FREE_RUN_QUEUE and ENABLE_WORK_STEALING_RUN_QUEUE "
+    "cannot both be enabled.")
+endif ()
+
 option(
   ENABLE_LOCK_FREE_EVENT_QUEUE
   "Build libprocess with lock free event queue."
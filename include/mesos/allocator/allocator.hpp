@@ -32,6 +32,7 @@
 #include <process/future.hpp>
 
 #include <stout/duration.hpp>
+#include <stout/foreach.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
 #include <stout/lambda.hpp>
@@ -81,6 +82,18 @@ public:
    *     to the frameworks.
    * @param inverseOfferCallback A callback the allocator uses to send reclaim
    *     allocations from the frameworks.
+   * @param allocationShards The number of shards the agents are partitioned
+   *     into during an allocation run. How (and whether) shards are used
+   *     depends on the implementation.
+   * @param allocationSweepInterval If set, batch allocations only need to
+   *     consider the agents whose resources may have changed since the
+   *     previous batch allocation, as long as all agents are considered
+   *     at least once per interval. Whether this is used depends on the
+   *     implementation.
+   * @param maxAllocationInterval If set, the interval between batch
+   *     allocations may be adapted to the load of the allocator, between
+   *     `allocationInterval` and this interval. Whether this is used
+   *     depends on the implementation.
    */
   virtual void initialize(
       const Duration& allocationInterval,
@@ -95,7 +108,10 @@ public:
       const Option<std::set<std::string>>&
         fairnessExcludeResourceNames = None(),
       bool filterGpuResources = true,
-      const Option<DomainInfo>& domain = None()) = 0;
+      const Option<DomainInfo>& domain = None(),
+      size_t allocationShards = 1,
+      const Option<Duration>& allocationSweepInterval = None(),
+      const Option<Duration>& maxAllocationInterval = None()) = 0;
 
   /**
    * Informs the allocator of the recovered state from the master.
@@ -362,6 +378,33 @@ public:
       const Resources& resources,
       const Option<Filters>& filters) = 0;
 
+  /**
+   * Recovers the resources of multiple agents at once.
+   *
+   * This is equivalent to recovering the resources allocated to each
+   * role on each agent separately, see `recoverResources()`, and is
+   * used when a framework declines many offers in a single call.
+   * The default implementation does exactly that, allocators can
+   * override it to recover all of the resources at once.
+   *
+   * @param frameworkId The framework the resources were allocated to.
+   * @param resources The allocated resources to recover, keyed by agent.
+   * @param filters The filters to install for each agent and role.
+   */
+  virtual void batchRecoverResources(
+      const FrameworkID& frameworkId,
+      const hashmap<SlaveID, Resources>& resources,
+      const Option<Filters>& filters)
+  {
+    foreachpair (const SlaveID& slaveId,
+                 const Resources& resources_,
+                 resources) {
+      foreachvalue (const Resources& allocation, resources_.allocations()) {
+        recoverResources(frameworkId, slaveId, allocation, filters);
+      }
+    }
+  }
+
   /**
    * Suppresses offers.
    *
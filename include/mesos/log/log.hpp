@@ -189,16 +189,22 @@ public:
   // Creates a new replicated log that assumes the specified quorum
   // size, is backed by a file at the specified path, and coordinates
   // with other replicas via the set of process PIDs.
+  //
+  // If 'batchWrites' is true, the local replica persists the writes
+  // of concurrent requests together with a single synchronous write
+  // and does not sync the notices of learned entries (which can be
+  // recovered from the other replicas after a crash).
   Log(int quorum,
       const std::string& path,
       const std::set<process::UPID>& pids,
       bool autoInitialize = false,
-      const Option<std::string>& metricsPrefix = None());
+      const Option<std::string>& metricsPrefix = None(),
+      bool batchWrites = false);
 
   // Creates a new replicated log that assumes the specified quorum
   // size, is backed by a file at the specified path, and coordinates
   // with other replicas associated with the specified ZooKeeper
-  // servers, timeout, and znode.
+  // servers, timeout, and znode. See above for 'batchWrites'.
   Log(int quorum,
       const std::string& path,
       const std::string& servers,
@@ -206,7 +212,8 @@ public:
       const std::string& znode,
       const Option<zookeeper::Authentication>& auth = None(),
       bool autoInitialize = false,
-      const Option<std::string>& metricsPrefix = None());
+      const Option<std::string>& metricsPrefix = None(),
+      bool batchWrites = false);
 
   ~Log();
 
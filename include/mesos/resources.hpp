@@ -17,12 +17,17 @@
 #ifndef __RESOURCES_HPP__
 #define __RESOURCES_HPP__
 
+#include <stdint.h>
+
 #include <map>
 #include <iosfwd>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include <boost/iterator/iterator_adaptor.hpp>
+
 #include <google/protobuf/repeated_field.h>
 
 #include <mesos/mesos.hpp>
@@ -90,15 +95,7 @@ private:
   class Resource_
   {
   public:
-    /*implicit*/ Resource_(const Resource& _resource)
-      : resource(_resource),
-        sharedCount(None())
-    {
-      // Setting the counter to 1 to denote "one copy" of the shared resource.
-      if (resource.has_shared()) {
-        sharedCount = 1;
-      }
-    }
+    /*implicit*/ Resource_(const Resource& _resource);
 
     // By implicitly converting to Resource we are able to keep Resource_
     // logic internal and expose only the protobuf object.
@@ -140,9 +137,50 @@ private:
         std::ostream& stream, const Resource_& resource_);
 
   private:
+    // Recomputes `nameId`, `roleId`, `allocationId` and `plainScalar`.
+    // This must be called whenever `resource` is changed, other than
+    // by changing its value.
+    void updateIds();
+
+    // Returns false if this Resource_ and `that` differ in name or
+    // reservation role, in which case they are neither addable nor
+    // subtractable and neither contains the other. This is a cheap
+    // check done before the full protobuf comparisons.
+    bool mayMatch(const Resource_& that) const
+    {
+      return nameId == that.nameId && roleId == that.roleId;
+    }
+
+    // Returns true if this Resource_ and `that` are plain scalars (see
+    // `plainScalar`) with the same name and allocation role, in which
+    // case they are addable and subtractable, and containment only
+    // depends on their values. This allows the common case of
+    // unreserved scalar arithmetic to skip the protobuf comparisons.
+    bool isSamePlainScalar(const Resource_& that) const
+    {
+      return plainScalar &&
+             that.plainScalar &&
+             nameId == that.nameId &&
+             allocationId == that.allocationId;
+    }
+
     // The protobuf Resource that is being managed.
     Resource resource;
 
+    // The interned ids of the resource name and of the reservation
+    // role ("*" if unreserved) of `resource`.
+    uint32_t nameId;
+    uint32_t roleId;
+
+    // The interned id of the allocation role of `resource` ("" if
+    // unallocated), only meaningful for plain scalars.
+    uint32_t allocationId;
+
+    // Whether `resource` is a non-shared and unreserved scalar without
+    // disk info, revocable info or resource provider ID, which is
+    // either unallocated or allocated to a (non-empty) role.
+    bool plainScalar;
+
     // The counter for grouping shared 'resource' objects, None if the
     // 'resource' is non-shared. This is an int so as to support arithmetic
     // operations involving subtraction.
@@ -368,7 +406,11 @@ public:
   /*implicit*/
   Resources(const google::protobuf::RepeatedPtrField<Resource>& _resources);
 
+  // NOTE: Copying a `Resources` only copies the pointers to the
+  // underlying `Resource_` objects, which are shared until one of the
+  // copies is mutated (copy-on-write).
   Resources(const Resources& that) : resources(that.resources) {}
+  Resources(Resources&& that) : resources(std::move(that.resources)) {}
 
   Resources& operator=(const Resources& that)
   {
@@ -378,6 +420,14 @@ public:
     return *this;
   }
 
+  Resources& operator=(Resources&& that)
+  {
+    if (this != &that) {
+      resources = std::move(that.resources);
+    }
+    return *this;
+  }
+
   bool empty() const { return resources.size() == 0; }
 
   size_t size() const { return resources.size(); }
@@ -542,24 +592,32 @@ public:
   // which holds the ephemeral ports allocation logic.
   Option<Value::Ranges> ephemeral_ports() const;
 
-  // NOTE: Non-`const` `iterator`, `begin()` and `end()` are __intentionally__
-  // defined with `const` semantics in order to prevent mutable access to the
-  // `Resource` objects within `resources`.
-  typedef std::vector<Resource_>::const_iterator iterator;
-  typedef std::vector<Resource_>::const_iterator const_iterator;
-
-  const_iterator begin()
+  // NOTE: `iterator` is __intentionally__ defined with `const` semantics
+  // in order to prevent mutable access to the `Resource` objects within
+  // `resources`, which may be shared with other `Resources` objects.
+  class const_iterator
+    : public boost::iterator_adaptor<
+          const_iterator,
+          std::vector<std::shared_ptr<Resource_>>::const_iterator,
+          const Resource_>
   {
-    return static_cast<const std::vector<Resource_>&>(resources).begin();
-  }
+  public:
+    const_iterator() {}
 
-  const_iterator end()
-  {
-    return static_cast<const std::vector<Resource_>&>(resources).end();
-  }
+    explicit const_iterator(
+        const std::vector<std::shared_ptr<Resource_>>::const_iterator& it)
+      : const_iterator::iterator_adaptor_(it) {}
+
+  private:
+    friend class boost::iterator_core_access;
 
-  const_iterator begin() const { return resources.begin(); }
-  const_iterator end() const { return resources.end(); }
+    const Resource_& dereference() const { return **this->base(); }
+  };
+
+  typedef const_iterator iterator;
+
+  const_iterator begin() const { return const_iterator(resources.begin()); }
+  const_iterator end() const { return const_iterator(resources.end()); }
 
   // Using this operator makes it easy to copy a resources object into
   // a protocol buffer field.
@@ -617,7 +675,16 @@ private:
   Resources operator-(const Resource_& that) const;
   Resources& operator-=(const Resource_& that);
 
-  std::vector<Resource_> resources;
+  // Returns a mutable reference to the `Resource_` at `index`, first
+  // making a private copy of it if it is shared with another
+  // `Resources` object (copy-on-write).
+  Resource_& mutableResource(size_t index);
+
+  // The `Resource_` objects are shared between copies of a `Resources`
+  // object and are only copied before they are mutated. This makes
+  // copying a `Resources` object cheap, which matters because they are
+  // copied pervasively (e.g., by the arithmetic operators).
+  std::vector<std::shared_ptr<Resource_>> resources;
 };
 
 
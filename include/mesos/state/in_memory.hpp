@@ -47,6 +47,7 @@ public:
       const internal::state::Entry& entry,
       const UUID& uuid);
   virtual process::Future<bool> expunge(const internal::state::Entry& entry);
+  virtual process::Future<bool> apply(const internal::state::Batch& batch);
   virtual process::Future<std::set<std::string>> names();
 
 private:
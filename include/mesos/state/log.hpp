@@ -39,7 +39,14 @@ class LogStorageProcess;
 class LogStorage : public mesos::state::Storage
 {
 public:
-  LogStorage(mesos::log::Log* log, size_t diffsBetweenSnapshots = 0);
+  // If 'operationsBetweenCheckpoints' is non-zero a checkpoint of
+  // every entry is appended to the log after that many operations so
+  // that the log can be truncated to (and recovery can start from)
+  // the latest checkpoint.
+  LogStorage(
+      mesos::log::Log* log,
+      size_t diffsBetweenSnapshots = 0,
+      size_t operationsBetweenCheckpoints = 0);
 
   virtual ~LogStorage();
 
@@ -50,7 +57,10 @@ public:
       const internal::state::Entry& entry,
       const UUID& uuid);
   virtual process::Future<bool> expunge(const internal::state::Entry& entry);
+  virtual process::Future<bool> apply(const internal::state::Batch& batch);
   virtual process::Future<std::set<std::string>> names();
+  virtual process::Future<std::set<std::string>> names(
+      const std::string& prefix);
 
 private:
   LogStorageProcess* process;
@@ -108,6 +108,10 @@ public:
   // Returns the collection of variable names in the state.
   process::Future<std::set<std::string>> names();
 
+  // Returns the names of the variables in the state that start with
+  // the specified prefix.
+  process::Future<std::set<std::string>> names(const std::string& prefix);
+
 private:
   // Helpers to handle future results from fetch and swap. We make
   // these static members of State for friend access to Variable's
@@ -189,6 +193,13 @@ inline process::Future<std::set<std::string>> State::names()
   return storage->names();
 }
 
+
+inline process::Future<std::set<std::string>> State::names(
+    const std::string& prefix)
+{
+  return storage->names(prefix);
+}
+
 } // namespace state {
 } // namespace mesos {
 
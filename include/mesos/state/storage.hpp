@@ -25,6 +25,7 @@
 #include <process/future.hpp>
 
 #include <stout/option.hpp>
+#include <stout/strings.hpp>
 #include <stout/uuid.hpp>
 
 namespace mesos {
@@ -50,8 +51,34 @@ public:
   virtual process::Future<bool> expunge(
       const internal::state::Entry& entry) = 0;
 
+  // Atomically applies a batch of "set" and "expunge" operations.
+  // Returns true if the version of every entry matched and all of
+  // the operations were applied, otherwise returns false and none of
+  // them are applied.
+  virtual process::Future<bool> apply(
+      const internal::state::Batch& batch) = 0;
+
   // Returns the collection of variable names in the state.
   virtual process::Future<std::set<std::string>> names() = 0;
+
+  // Returns the names of the variables in the state that start with
+  // the specified prefix. The default implementation filters the
+  // result of 'names()'; implementations that keep their names
+  // ordered can override this to avoid copying every name.
+  virtual process::Future<std::set<std::string>> names(
+      const std::string& prefix)
+  {
+    return names()
+      .then([prefix](const std::set<std::string>& names) {
+        std::set<std::string> result;
+        for (auto it = names.lower_bound(prefix);
+             it != names.end() && strings::startsWith(*it, prefix);
+             ++it) {
+          result.insert(*it);
+        }
+        return result;
+      });
+  }
 };
 
 } // namespace state {
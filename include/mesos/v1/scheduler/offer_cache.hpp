@@ -0,0 +1,155 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __MESOS_V1_SCHEDULER_OFFER_CACHE_HPP__
+#define __MESOS_V1_SCHEDULER_OFFER_CACHE_HPP__
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mesos/v1/attributes.hpp>
+#include <mesos/v1/mesos.hpp>
+#include <mesos/v1/resources.hpp>
+
+#include <mesos/v1/scheduler/scheduler.hpp>
+
+#include <process/time.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/hashset.hpp>
+#include <stout/option.hpp>
+
+namespace mesos {
+namespace v1 {
+namespace scheduler {
+
+/**
+ * Keeps track of the outstanding offers of a framework, indexed by
+ * agent, so that frameworks don't need to re-implement the offer
+ * bookkeeping on top of the `OFFERS` and `RESCIND` events.
+ *
+ * The offers of each agent are aggregated into a view of the agent,
+ * which is updated incrementally as offers get added and removed.
+ * The agents are further indexed by their attributes and by the
+ * names of the resources they offer, so that matching a task
+ * against the offers only considers the agents that can run it.
+ *
+ * Offers that go unused for longer than the expiration get declined
+ * with a short filter, see `declineExpired()`, so that the resources
+ * are offered to other frameworks in the meantime.
+ *
+ * NOTE: This class is not thread-safe.
+ */
+class OfferCache
+{
+public:
+  // The aggregated view of the outstanding offers of an agent.
+  struct Agent
+  {
+    AgentID id;
+    std::string hostname;
+    Attributes attributes;
+
+    // The sum of the resources of the offers, without their
+    // allocation info.
+    Resources available;
+
+    hashmap<OfferID, Offer> offers;
+  };
+
+  /**
+   * @param expiration how long an offer can remain unused before it
+   *     gets declined by `declineExpired()`.
+   * @param refusal the duration of the filter used when declining
+   *     the expired offers.
+   */
+  explicit OfferCache(
+      const Duration& expiration = Seconds(30),
+      const Duration& refusal = Seconds(1));
+
+  // Adds an offer, e.g., for each offer of an `OFFERS` event.
+  void add(const Offer& offer);
+
+  // Removes an offer, e.g., when it gets rescinded or used. Returns
+  // the offer if it was cached.
+  Option<Offer> remove(const OfferID& offerId);
+
+  // Removes all of the offers of an agent, e.g., when the agent is
+  // lost or when all of them get used. Returns the removed offers.
+  std::vector<Offer> remove(const AgentID& agentId);
+
+  // Applies an event to the cache, i.e., adds the offers of an
+  // `OFFERS` event, removes the offer of a `RESCIND` event and
+  // removes the offers of the agent of a `FAILURE` event. The other
+  // events are ignored.
+  void update(const Event& event);
+
+  // Returns the view of an agent, if it has any outstanding offers.
+  const Agent* agent(const AgentID& agentId) const;
+
+  /**
+   * Returns the agents whose offers, in aggregate, contain the
+   * resources and that have all of the attributes.
+   *
+   * The resources are matched without their allocation info, and
+   * otherwise as by `Resources::contains`, e.g., the reservations of
+   * the resources need to match. The attributes are matched as by
+   * `Attributes::contains`.
+   */
+  std::vector<AgentID> match(
+      const Resources& resources,
+      const Attributes& attributes = Attributes()) const;
+
+  /**
+   * Removes the offers that have been cached for longer than the
+   * expiration and returns a `DECLINE` call for them with the short
+   * refusal filter, or none if no offers have expired.
+   */
+  Option<Call> declineExpired(const FrameworkID& frameworkId);
+
+  // Returns the number of outstanding offers.
+  size_t size() const { return offers.size(); }
+
+private:
+  void index(const Agent& agent);
+  void unindex(const Agent& agent);
+
+  const Duration expiration;
+  const Duration refusal;
+
+  hashmap<AgentID, Agent> agents;
+
+  // The agent of each outstanding offer.
+  hashmap<OfferID, AgentID> offers;
+
+  // The offers in the order they were added, along with the time
+  // they were added. Removed offers are skipped lazily.
+  std::deque<std::pair<process::Time, OfferID>> added;
+
+  // Inverted indexes of the agents by the attributes they have and by
+  // the names of the resources they offer.
+  hashmap<std::string, hashset<AgentID>> attributeIndex;
+  hashmap<std::string, hashset<AgentID>> resourceIndex;
+};
+
+} // namespace scheduler {
+} // namespace v1 {
+} // namespace mesos {
+
+#endif // __MESOS_V1_SCHEDULER_OFFER_CACHE_HPP__
@@ -341,6 +341,11 @@ private:
   // cache and 'Some' represents a valid cache.
   Option<std::set<Group::Membership>> memberships;
 
+  // The data of the cached memberships, which gets read along with
+  // the memberships. This is safe since the data of a membership can
+  // only be set when joining the group.
+  std::map<int32_t, std::string> contents;
+
   // A timer that controls when we should give up on waiting for the
   // current connection attempt to succeed and try to reconnect.
   Option<process::Timer> connectTimer;
@@ -270,6 +270,30 @@ public:
       std::string* result,
       Stat* stat);
 
+  /**
+   * \brief gets the data associated with several nodes synchronously.
+   *
+   * The reads are pipelined, i.e., all of the requests are sent to
+   * the server before waiting for any of the responses, which takes a
+   * single round trip rather than one per node.
+   *
+   * \param paths the names of the nodes. Expressed as file names with
+   *    slashes separating ancestors of the nodes.
+   * \param watch if nonzero, a watch will be set at the server to
+   *    notify the client if any of the nodes change.
+   * \param results the data returned by the server for each of the
+   *    nodes, in the same order as `paths`.
+   * \param stats if not `nullptr`, will hold the value of stat for
+   *    each of the nodes on return.
+   * \return the return code of the read of each of the nodes, in the
+   *    same order as `paths`, see `get` above.
+   */
+  std::vector<int> get(
+      const std::vector<std::string>& paths,
+      bool watch,
+      std::vector<std::string>* results,
+      std::vector<Stat>* stats);
+
   /**
    * \brief lists the children of a node synchronously.
    *
@@ -311,6 +335,23 @@ public:
    */
   int set(const std::string& path, const std::string& data, int version);
 
+  /**
+   * \brief atomically executes a series of operations synchronously.
+   *
+   * \param ops the operations to execute, initialized via
+   *    zoo_create_op_init, zoo_delete_op_init, zoo_set_op_init or
+   *    zoo_check_op_init. Any buffers referenced by the operations
+   *    must remain valid until this function returns.
+   * \return ZOK if all of the operations completed successfully,
+   * otherwise the return code of the first operation that failed (in
+   * which case none of the operations are applied) or one of the
+   * following values.
+   * ZBADARGUMENTS - invalid input parameters
+   * ZINVALIDSTATE - state is ZOO_SESSION_EXPIRED_STATE or ZOO_AUTH_FAILED_STATE
+   * ZMARSHALLINGERROR - failed to marshall a request; possibly, out of memory
+   */
+  int multi(const std::vector<zoo_op_t>& ops);
+
   /**
    * \brief return a message describing the return code.
    *
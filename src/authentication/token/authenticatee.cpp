@@ -0,0 +1,142 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "authentication/token/authenticatee.hpp"
+
+#include <string>
+
+#include <process/defer.hpp>
+#include <process/dispatch.hpp>
+#include <process/id.hpp>
+#include <process/process.hpp>
+#include <process/protobuf.hpp>
+
+#include "logging/logging.hpp"
+
+#include "messages/messages.hpp"
+
+namespace mesos {
+namespace internal {
+namespace token {
+
+using namespace process;
+using std::string;
+
+class TokenAuthenticateeProcess
+  : public ProtobufProcess<TokenAuthenticateeProcess>
+{
+public:
+  TokenAuthenticateeProcess(const string& _token, const UPID& _client)
+    : ProcessBase(ID::generate("token-authenticatee")),
+      token(_token),
+      client(_client) {}
+
+  virtual ~TokenAuthenticateeProcess() {}
+
+  virtual void finalize()
+  {
+    discarded(); // Fail the promise.
+  }
+
+  Future<bool> authenticate(const UPID& pid)
+  {
+    AuthenticateMessage message;
+    message.set_pid(client);
+    message.set_token(token);
+    send(pid, message);
+
+    // Stop authenticating if nobody cares.
+    promise.future().onDiscard(defer(self(), &Self::discarded));
+
+    return promise.future();
+  }
+
+protected:
+  virtual void initialize()
+  {
+    install<AuthenticationCompletedMessage>(
+        &TokenAuthenticateeProcess::completed);
+
+    install<AuthenticationFailedMessage>(
+        &TokenAuthenticateeProcess::failed);
+
+    install<AuthenticationErrorMessage>(
+        &TokenAuthenticateeProcess::error,
+        &AuthenticationErrorMessage::error);
+  }
+
+  void completed()
+  {
+    LOG(INFO) << "Authentication with token success";
+
+    promise.set(true);
+  }
+
+  void failed()
+  {
+    promise.set(false);
+  }
+
+  void error(const string& error)
+  {
+    promise.fail("Authentication error: " + error);
+  }
+
+  void discarded()
+  {
+    promise.fail("Authentication discarded");
+  }
+
+private:
+  const string token;
+
+  // PID of the client that needs to be authenticated.
+  const UPID client;
+
+  Promise<bool> promise;
+};
+
+
+TokenAuthenticatee::TokenAuthenticatee(const string& _token)
+  : token(_token),
+    process(nullptr) {}
+
+
+TokenAuthenticatee::~TokenAuthenticatee()
+{
+  if (process != nullptr) {
+    terminate(process);
+    wait(process);
+    delete process;
+  }
+}
+
+
+Future<bool> TokenAuthenticatee::authenticate(
+    const UPID& pid,
+    const UPID& client,
+    const Credential& credential)
+{
+  CHECK(process == nullptr);
+  process = new TokenAuthenticateeProcess(token, client);
+  spawn(process);
+
+  return dispatch(process, &TokenAuthenticateeProcess::authenticate, pid);
+}
+
+} // namespace token {
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,65 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __AUTHENTICATION_TOKEN_AUTHENTICATEE_HPP__
+#define __AUTHENTICATION_TOKEN_AUTHENTICATEE_HPP__
+
+#include <string>
+
+#include <mesos/mesos.hpp>
+
+#include <mesos/module/authenticatee.hpp>
+
+#include <process/future.hpp>
+#include <process/pid.hpp>
+
+namespace mesos {
+namespace internal {
+namespace token {
+
+// Forward declaration.
+class TokenAuthenticateeProcess;
+
+
+// Authenticates with a token issued by a master after a previous
+// authentication, see `AuthenticationTokenMessage`. This takes a
+// single message, but the client has to fall back to its regular
+// authenticatee if the master does not accept the token, e.g., if
+// it has expired.
+class TokenAuthenticatee : public Authenticatee
+{
+public:
+  explicit TokenAuthenticatee(const std::string& token);
+
+  virtual ~TokenAuthenticatee();
+
+  // NOTE: The credential is not used.
+  process::Future<bool> authenticate(
+      const process::UPID& pid,
+      const process::UPID& client,
+      const Credential& credential);
+
+private:
+  const std::string token;
+
+  TokenAuthenticateeProcess* process;
+};
+
+} // namespace token {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __AUTHENTICATION_TOKEN_AUTHENTICATEE_HPP__
@@ -16,6 +16,7 @@
 
 #include "authorizer/local/authorizer.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -30,6 +31,7 @@
 #include <process/protobuf.hpp>
 
 #include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
 #include <stout/none.hpp>
 #include <stout/option.hpp>
 #include <stout/path.hpp>
@@ -169,31 +171,109 @@ static bool allows(const ACL::Entity& request, const ACL::Entity& acl)
 }
 
 
-class LocalAuthorizerObjectApprover : public ObjectApprover
+// The generic ACLs of an action compiled for a subject. Since the
+// subject of an object approver is fixed, only the ACLs matching the
+// subject are kept, and the values of their objects are indexed. This
+// way, objects with a single value (e.g., the user of a task) are
+// approved by a hash lookup rather than by matching every ACL in turn,
+// which matters for endpoints approving many objects, e.g., `/state`.
+class CompiledACLs
 {
 public:
-  LocalAuthorizerObjectApprover(
+  CompiledACLs(
       const vector<GenericACL>& acls,
       const Option<authorization::Subject>& subject,
-      const authorization::Action& action,
-      bool permissive)
-    : acls_(acls),
-      subject_(subject),
-      action_(action),
-      permissive_(permissive) {}
-
-  virtual Try<bool> approved(
-      const Option<ObjectApprover::Object>& object) const noexcept override
+      bool _permissive)
+    : permissive(_permissive)
   {
-    // Construct subject.
     ACL::Entity aclSubject;
-    if (subject_.isSome()) {
-      aclSubject.add_values(subject_->value());
+    if (subject.isSome()) {
+      aclSubject.add_values(subject->value());
       aclSubject.set_type(mesos::ACL::Entity::SOME);
     } else {
       aclSubject.set_type(mesos::ACL::Entity::ANY);
     }
 
+    foreach (const GenericACL& acl, acls) {
+      if (!matches(aclSubject, acl.subjects)) {
+        continue;
+      }
+
+      const size_t index = objects.size();
+
+      objects.push_back(acl.objects);
+      subjectAllowed.push_back(allows(aclSubject, acl.subjects));
+
+      if (acl.objects.type() == ACL::Entity::SOME) {
+        foreach (const string& value, acl.objects.values()) {
+          // Keep the first ACL for each value, as the first matching
+          // ACL decides.
+          if (!indices.contains(value)) {
+            indices[value] = index;
+          }
+        }
+      } else if (wildcard.isNone()) {
+        // ANY and NONE match all objects with a single value.
+        wildcard = index;
+      }
+    }
+  }
+
+  bool approved(const ACL::Entity& object) const
+  {
+    if (object.type() == ACL::Entity::SOME && object.values_size() == 1) {
+      Option<size_t> index = wildcard;
+
+      auto it = indices.find(object.values(0));
+      if (it != indices.end() && (index.isNone() || it->second < index.get())) {
+        index = it->second;
+      }
+
+      if (index.isNone()) {
+        return permissive; // None of the ACLs match.
+      }
+
+      return subjectAllowed[index.get()] &&
+             allows(object, objects[index.get()]);
+    }
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+      if (matches(object, objects[i])) {
+        return subjectAllowed[i] && allows(object, objects[i]);
+      }
+    }
+
+    return permissive; // None of the ACLs match.
+  }
+
+private:
+  // The objects of the ACLs matching the subject, in order, and
+  // whether the ACL allows the subject.
+  vector<ACL::Entity> objects;
+  vector<bool> subjectAllowed;
+
+  // The index of the first ACL which has each value in its objects.
+  hashmap<string, size_t> indices;
+
+  // The index of the first ACL whose objects are ANY or NONE.
+  Option<size_t> wildcard;
+
+  const bool permissive;
+};
+
+
+class LocalAuthorizerObjectApprover : public ObjectApprover
+{
+public:
+  LocalAuthorizerObjectApprover(
+      const std::shared_ptr<const CompiledACLs>& acls,
+      const authorization::Action& action)
+    : acls_(acls),
+      action_(action) {}
+
+  virtual Try<bool> approved(
+      const Option<ObjectApprover::Object>& object) const noexcept override
+  {
     // Construct object.
     ACL::Entity aclObject;
 
@@ -430,29 +510,12 @@ public:
       }
     }
 
-    return approved(acls_, aclSubject, aclObject);
+    return acls_->approved(aclObject);
   }
 
 private:
-  bool approved(
-      const vector<GenericACL>& acls,
-      const ACL::Entity& subject,
-      const ACL::Entity& object) const
-  {
-    // Authorize subject/object.
-    foreach (const GenericACL& acl, acls) {
-      if (matches(subject, acl.subjects) && matches(object, acl.objects)) {
-        return allows(subject, acl.subjects) && allows(object, acl.objects);
-      }
-    }
-
-    return permissive_; // None of the ACLs match.
-  }
-
-  const vector<GenericACL> acls_;
-  const Option<authorization::Subject> subject_;
+  const std::shared_ptr<const CompiledACLs> acls_;
   const authorization::Action action_;
-  const bool permissive_;
 };
 
 
@@ -465,8 +528,12 @@ public:
       const Option<authorization::Subject>& subject,
       const authorization::Action& action,
       bool permissive)
-    : childApprover_(userAcls, subject, action, permissive),
-      parentApprover_(parentAcls, subject, action, permissive) {}
+    : childApprover_(
+          std::make_shared<CompiledACLs>(userAcls, subject, permissive),
+          action),
+      parentApprover_(
+          std::make_shared<CompiledACLs>(parentAcls, subject, permissive),
+          action) {}
 
   // Launching Nested Containers and sessions in Nester Containers is
   // authorized if a principal is allowed to launch nester container (sessions)
@@ -1146,6 +1213,22 @@ public:
       case authorization::WAIT_STANDALONE_CONTAINER:
       case authorization::MODIFY_RESOURCE_PROVIDER_CONFIG:
       case authorization::UNKNOWN: {
+        Option<string> principal;
+        if (subject.isSome()) {
+          principal = subject->value();
+        }
+
+        // The ACLs never change, so the compiled ACLs can be reused
+        // by all the approvers for the same action and subject.
+        hashmap<Option<string>, std::shared_ptr<const CompiledACLs>>& cache =
+          compiledACLs[action];
+
+        auto it = cache.find(principal);
+        if (it != cache.end()) {
+          return Owned<ObjectApprover>(
+              new LocalAuthorizerObjectApprover(it->second, action));
+        }
+
         Result<vector<GenericACL>> genericACLs =
           createGenericACLs(action, acls);
         if (genericACLs.isError()) {
@@ -1156,9 +1239,19 @@ public:
           return Owned<ObjectApprover>(new RejectingObjectApprover());
         }
 
+        std::shared_ptr<const CompiledACLs> compiled(
+            new CompiledACLs(genericACLs.get(), subject, acls.permissive()));
+
+        // Bound the memory used by the cache, which has an entry for
+        // each principal that has been authorized for the action.
+        if (cache.size() >= MAX_COMPILED_ACLS) {
+          cache.clear();
+        }
+
+        cache[principal] = compiled;
+
         return Owned<ObjectApprover>(
-            new LocalAuthorizerObjectApprover(
-                genericACLs.get(), subject, action, acls.permissive()));
+            new LocalAuthorizerObjectApprover(compiled, action));
       }
     }
 
@@ -1508,6 +1601,16 @@ private:
   }
 
   ACLs acls;
+
+  // The maximum number of subjects whose compiled ACLs are cached for
+  // each action.
+  static constexpr size_t MAX_COMPILED_ACLS = 1024;
+
+  // The generic ACLs compiled for each action and subject.
+  hashmap<
+      authorization::Action,
+      hashmap<Option<string>, std::shared_ptr<const CompiledACLs>>>
+    compiledACLs;
 };
 
 
@@ -108,6 +108,7 @@ Try<Owned<Checker>> Checker::create(
           None(),
           None(),
           None(),
+          false,
           false));
 }
 
@@ -119,7 +120,8 @@ Try<Owned<Checker>> Checker::create(
     const TaskID& taskId,
     const ContainerID& taskContainerId,
     const http::URL& agentURL,
-    const Option<string>& authorizationHeader)
+    const Option<string>& authorizationHeader,
+    bool persistentCommandCheck)
 {
   // Validate the `CheckInfo` protobuf.
   Option<Error> error = validation::checkInfo(check);
@@ -138,7 +140,8 @@ Try<Owned<Checker>> Checker::create(
           taskContainerId,
           agentURL,
           authorizationHeader,
-          true));
+          true,
+          persistentCommandCheck));
 }
 
 
@@ -152,7 +155,8 @@ Checker::Checker(
     const Option<ContainerID>& _taskContainerId,
     const Option<http::URL>& _agentURL,
     const Option<string>& _authorizationHeader,
-    bool _commandCheckViaAgent)
+    bool _commandCheckViaAgent,
+    bool _persistentCommandCheck)
   : check(_check),
     callback(_callback),
     name(CheckInfo::Type_Name(check.type()) + " check"),
@@ -175,7 +179,8 @@ Checker::Checker(
           _authorizationHeader,
           None(),
           name,
-          _commandCheckViaAgent));
+          _commandCheckViaAgent,
+          _persistentCommandCheck));
 
   spawn(process.get());
 }
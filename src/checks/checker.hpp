@@ -75,7 +75,8 @@ public:
    *
    * If the check is a COMMAND check, the checker will delegate the execution
    * of the check to the Mesos agent via the `LaunchNestedContainerSession`
-   * API call.
+   * API call, or, if `persistentCommandCheck` is set, to a single
+   * long-lived nested container launched that way.
    *
    * @param check The protobuf message definition of a check.
    * @param launcherDir A directory where Mesos helper binaries are located.
@@ -87,6 +88,8 @@ public:
    * @param agentURL The URL of the agent.
    * @param authorizationHeader The authorization header the checker should use
    *     to authenticate with the agent operator API.
+   * @param persistentCommandCheck Whether COMMAND checks should reuse one
+   *     nested container instead of launching a new one per check.
    * @return A `Checker` object or an error if `create` fails.
    *
    * @todo A better approach would be to return a stream of updates, e.g.,
@@ -99,7 +102,8 @@ public:
       const TaskID& taskId,
       const ContainerID& taskContainerId,
       const process::http::URL& agentURL,
-      const Option<std::string>& authorizationHeader);
+      const Option<std::string>& authorizationHeader,
+      bool persistentCommandCheck = false);
 
   ~Checker();
 
@@ -122,7 +126,8 @@ private:
       const Option<ContainerID>& _taskContainerId,
       const Option<process::http::URL>& _agentURL,
       const Option<std::string>& _authorizationHeader,
-      bool _commandCheckViaAgent);
+      bool _commandCheckViaAgent,
+      bool _persistentCommandCheck);
 
   void processCheckResult(const Try<CheckStatusInfo>& result);
 
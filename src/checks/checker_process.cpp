@@ -16,6 +16,7 @@
 
 #include "checks/checker_process.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -35,16 +36,21 @@
 #include <process/delay.hpp>
 #include <process/future.hpp>
 #include <process/io.hpp>
+#include <process/loop.hpp>
 #include <process/protobuf.hpp>
+#include <process/socket.hpp>
 #include <process/subprocess.hpp>
 #include <process/time.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/check.hpp>
 #include <stout/duration.hpp>
 #include <stout/error.hpp>
 #include <stout/foreach.hpp>
+#include <stout/ip.hpp>
 #include <stout/jsonify.hpp>
 #include <stout/nothing.hpp>
+#include <stout/numify.hpp>
 #include <stout/option.hpp>
 #include <stout/protobuf.hpp>
 #include <stout/recordio.hpp>
@@ -53,8 +59,11 @@
 #include <stout/try.hpp>
 #include <stout/uuid.hpp>
 
+#include <stout/os/close.hpp>
 #include <stout/os/environment.hpp>
 #include <stout/os/killtree.hpp>
+#include <stout/os/open.hpp>
+#include <stout/os/wait.hpp>
 
 #include "common/http.hpp"
 #include "common/protobuf_utils.hpp"
@@ -67,7 +76,11 @@
 #endif
 
 namespace http = process::http;
+namespace network = process::network;
 
+using process::Break;
+using process::Continue;
+using process::ControlFlow;
 using process::Failure;
 using process::Future;
 using process::Owned;
@@ -94,11 +107,31 @@ constexpr char TCP_CHECK_COMMAND[] = "mesos-tcp-connect.exe";
 
 static const string DEFAULT_HTTP_SCHEME = "http";
 
+// Same as the default maximum of curl.
+constexpr size_t HTTP_CHECK_MAX_REDIRECTS = 50;
+
+// The maximum size of the status line and header fields of a response
+// read by in-process HTTP checks.
+constexpr size_t HTTP_CHECK_MAX_HEAD_SIZE = 64 * 1024;
+
 // Use '127.0.0.1' and '::1' instead of 'localhost', because the
 // host file in some container images may not contain 'localhost'.
 constexpr char DEFAULT_IPV4_DOMAIN[] = "127.0.0.1";
 constexpr char DEFAULT_IPV6_DOMAIN[] = "::1";
 
+// The scripts run by the helper container of persistent COMMAND checks,
+// see `CheckerProcess::helperCommandCheck()`. Every line read from stdin
+// runs the check command once, writing its output to stderr and its
+// exit code to stdout. The check command is passed as the positional
+// parameters of the script: a shell command is passed as `$1`, while
+// the executable and the arguments of other commands are passed as `$0`
+// and `$@` respectively.
+static const string CHECK_HELPER_SHELL_SCRIPT =
+  "while read -r _; do (eval \"$1\") </dev/null 1>&2; echo \"$?\"; done";
+
+static const string CHECK_HELPER_EXEC_SCRIPT =
+  "while read -r _; do \"$0\" \"$@\" </dev/null 1>&2; echo \"$?\"; done";
+
 
 #ifdef __linux__
 // TODO(alexr): Instead of defining this ad-hoc clone function, provide a
@@ -141,6 +174,52 @@ static pid_t cloneWithSetns(
 #endif
 
 
+// Returns the authority component of the URL of HTTP checks.
+static string httpCheckAuthority(bool ipv6, uint32_t port)
+{
+  const string domain = ipv6 ?
+                        "[" + string(DEFAULT_IPV6_DOMAIN) + "]" :
+                        DEFAULT_IPV4_DOMAIN;
+
+  return domain + ":" + stringify(port);
+}
+
+
+// Receives the status line and the header fields of an HTTP response,
+// dropping the terminating empty line and anything after it.
+static Future<string> recvHttpHead(network::Socket socket)
+{
+  auto head = std::make_shared<string>();
+
+  return process::loop(
+      [=]() mutable {
+        return socket.recv();
+      },
+      [=](const string& data) -> Future<ControlFlow<string>> {
+        if (data.empty()) {
+          return Failure("Connection closed before receiving the response");
+        }
+
+        head->append(data);
+
+        const size_t end = head->find("\r\n\r\n");
+        if (end != string::npos) {
+          ControlFlow<string> flow = Break(head->substr(0, end));
+          return flow;
+        }
+
+        if (head->size() > HTTP_CHECK_MAX_HEAD_SIZE) {
+          return Failure(
+              "Response header exceeds " +
+              stringify(Bytes(HTTP_CHECK_MAX_HEAD_SIZE)));
+        }
+
+        ControlFlow<string> flow = Continue();
+        return flow;
+      });
+}
+
+
 // Reads `ProcessIO::Data` records from a string containing "Record-IO"
 // data encoded in protobuf messages, and returns the stdout and stderr.
 //
@@ -184,6 +263,39 @@ static Try<tuple<string, string>> decodeProcessIOData(const string& data)
 }
 
 
+struct CheckerProcess::CheckHelper
+{
+  explicit CheckHelper(const ContainerID& _containerId)
+    : containerId(_containerId),
+      encoder(lambda::bind(serialize, ContentType::PROTOBUF, lambda::_1)),
+      decoder(lambda::bind(
+          deserialize<v1::agent::ProcessIO>,
+          ContentType::PROTOBUF,
+          lambda::_1)) {}
+
+  const ContainerID containerId;
+
+  // The connection used to launch the helper, closing it makes the
+  // agent kill the helper.
+  Option<http::Connection> launchConnection;
+
+  // The connection used to stream the stdin of the helper.
+  Option<http::Connection> attachConnection;
+
+  http::Pipe input;
+  Option<http::Pipe::Reader> output;
+
+  ::recordio::Encoder<v1::agent::Call> encoder;
+  ::recordio::Decoder<v1::agent::ProcessIO> decoder;
+
+  // The stdout of the helper that does not form a full line yet.
+  string stdout_;
+
+  // The promise of the check the helper is currently performing, if any.
+  shared_ptr<Promise<int>> pending;
+};
+
+
 CheckerProcess::CheckerProcess(
     const CheckInfo& _check,
     const string& _launcherDir,
@@ -197,6 +309,7 @@ CheckerProcess::CheckerProcess(
     const Option<string>& _scheme,
     const std::string& _name,
     bool _commandCheckViaAgent,
+    bool _persistentCommandCheck,
     bool _ipv6)
   : ProcessBase(process::ID::generate("checker")),
     check(_check),
@@ -211,6 +324,7 @@ CheckerProcess::CheckerProcess(
     scheme(_scheme),
     name(_name),
     commandCheckViaAgent(_commandCheckViaAgent),
+    persistentCommandCheck(_persistentCommandCheck),
     ipv6(_ipv6),
     paused(false)
 {
@@ -233,6 +347,55 @@ CheckerProcess::CheckerProcess(
     clone = lambda::bind(&cloneWithSetns, lambda::_1, taskPid, namespaces);
   }
 #endif
+
+  // Of the namespaces of the task, only the network namespace matters
+  // for HTTP and TCP checks performed in-process.
+  const bool enterNetNamespace =
+    std::find(namespaces.begin(), namespaces.end(), "net") != namespaces.end();
+
+  inProcessProbes = !enterNetNamespace;
+
+#ifdef __linux__
+  if (enterNetNamespace && taskPid.isSome()) {
+    Try<int> task = os::open(
+        path::join("/proc", stringify(taskPid.get()), "ns", "net"),
+        O_RDONLY | O_CLOEXEC);
+
+    Try<int> self = os::open("/proc/self/ns/net", O_RDONLY | O_CLOEXEC);
+
+    if (task.isSome() && self.isSome()) {
+      taskNetNamespace = task.get();
+      selfNetNamespace = self.get();
+      inProcessProbes = true;
+    } else {
+      LOG(WARNING) << "Failed to open the network namespaces for the " << name
+                   << " for task '" << taskId << "': "
+                   << (task.isError() ? task.error() : self.error());
+
+      if (task.isSome()) {
+        os::close(task.get());
+      }
+
+      if (self.isSome()) {
+        os::close(self.get());
+      }
+    }
+  }
+#endif // __linux__
+}
+
+
+CheckerProcess::~CheckerProcess()
+{
+#ifdef __linux__
+  if (taskNetNamespace.isSome()) {
+    os::close(taskNetNamespace.get());
+  }
+
+  if (selfNetNamespace.isSome()) {
+    os::close(selfNetNamespace.get());
+  }
+#endif // __linux__
 }
 
 
@@ -244,6 +407,8 @@ void CheckerProcess::initialize()
 
 void CheckerProcess::finalize()
 {
+  killCheckHelper();
+
   LOG(INFO) << "Stopped " << name << " for task '" << taskId << "'";
 }
 
@@ -259,8 +424,15 @@ void CheckerProcess::performCheck()
 
   switch (check.type()) {
     case CheckInfo::COMMAND: {
-      Future<int> future = commandCheckViaAgent ? nestedCommandCheck()
-                                                : commandCheck();
+      Future<int> future;
+      if (!commandCheckViaAgent) {
+        future = commandCheck();
+      } else if (persistentCommandCheck) {
+        future = helperCommandCheck();
+      } else {
+        future = nestedCommandCheck();
+      }
+
       future.onAny(defer(
           self(),
           &Self::processCommandCheckResult, stopwatch, lambda::_1));
@@ -721,6 +893,470 @@ void CheckerProcess::nestedCommandCheckFailure(
 }
 
 
+// Instead of launching a nested container for every check, which takes
+// several calls to the agent and the launch and destruction of a
+// container, the check command is run by a long-lived helper container.
+// The helper is launched via `LAUNCH_NESTED_CONTAINER_SESSION` and runs
+// the check command whenever it receives a line via
+// `ATTACH_CONTAINER_INPUT`, responding with the exit code of the command
+// on its output stream. The helper is killed if a check times out or
+// its streams fail, and a new one is launched for the next check.
+Future<int> CheckerProcess::helperCommandCheck()
+{
+  CHECK_EQ(CheckInfo::COMMAND, check.type());
+  CHECK(check.has_command());
+  CHECK_SOME(taskContainerId);
+  CHECK_SOME(agentURL);
+
+  // As for `nestedCommandCheck()`, the promise is discarded if there
+  // was a transient error.
+  auto promise = std::make_shared<Promise<int>>();
+
+  if (helper.get() != nullptr) {
+    runCheckHelper(promise);
+  } else {
+    launchCheckHelper(promise);
+  }
+
+  // TODO(alexr): Use a lambda named capture for
+  // this cached value once it is available.
+  const Duration timeout = checkTimeout;
+
+  return promise->future()
+    .after(checkTimeout,
+           defer(self(), [this, timeout](Future<int> future) {
+      future.discard();
+
+      // The helper is still running the command, killing it makes
+      // sure that the next check doesn't get the result of this one.
+      killCheckHelper();
+
+      return Failure("Command timed out after " + stringify(timeout));
+    }));
+}
+
+
+void CheckerProcess::launchCheckHelper(shared_ptr<Promise<int>> promise)
+{
+  // Remove the previous helper once it has terminated. Unlike the
+  // nested containers of `nestedCommandCheck()`, the next helper can
+  // be launched before the previous one has been removed.
+  if (previousCheckContainerId.isSome()) {
+    const ContainerID containerId = previousCheckContainerId.get();
+    previousCheckContainerId = None();
+
+    waitNestedContainer(containerId)
+      .onAny(defer(self(), [this, containerId](const Future<Option<int>>&) {
+        agent::Call call;
+        call.set_type(agent::Call::REMOVE_NESTED_CONTAINER);
+
+        call.mutable_remove_nested_container()->mutable_container_id()
+          ->CopyFrom(containerId);
+
+        http::Request request;
+        request.method = "POST";
+        request.url = agentURL.get();
+        request.body = serialize(ContentType::PROTOBUF, evolve(call));
+        request.headers = {{"Accept", stringify(ContentType::PROTOBUF)},
+                           {"Content-Type", stringify(ContentType::PROTOBUF)}};
+
+        if (authorizationHeader.isSome()) {
+          request.headers["Authorization"] = authorizationHeader.get();
+        }
+
+        http::request(request, false)
+          .onAny(defer(self(), [this, containerId](
+              const Future<http::Response>& response) {
+            if (!response.isReady() ||
+                response->code != http::Status::OK) {
+              LOG(WARNING) << "Failed to remove the nested container '"
+                           << containerId << "' used for the " << name
+                           << " for task '" << taskId << "': "
+                           << (response.isReady()
+                                 ? response->status
+                                 : (response.isFailed()
+                                      ? response.failure()
+                                      : "discarded"));
+            }
+          }));
+      }));
+  }
+
+  // TODO(alexr): Use lambda named captures for
+  // these cached values once they are available.
+  const TaskID _taskId = taskId;
+  const string _name = name;
+
+  ContainerID helperContainerId;
+  helperContainerId.set_value("check-" + UUID::random().toString());
+  helperContainerId.mutable_parent()->CopyFrom(taskContainerId.get());
+
+  http::connect(agentURL.get())
+    .onFailed(defer(self(), [_taskId, _name, promise](const string& failure) {
+      LOG(WARNING) << "Unable to establish connection with the agent to launch "
+                   << _name << " for task '" << _taskId << "'"
+                   << ": " << failure;
+
+      // We treat this as a transient failure.
+      promise->discard();
+    }))
+    .onReady(defer(self(),
+                   &Self::_launchCheckHelper,
+                   promise,
+                   helperContainerId,
+                   lambda::_1));
+}
+
+
+void CheckerProcess::_launchCheckHelper(
+    shared_ptr<Promise<int>> promise,
+    const ContainerID& helperContainerId,
+    http::Connection connection)
+{
+  // The check might have timed out while connecting.
+  if (promise->future().hasDiscard()) {
+    connection.disconnect();
+    promise->discard();
+    return;
+  }
+
+  CHECK(helper.get() == nullptr);
+
+  helper.reset(new CheckHelper(helperContainerId));
+  helper->launchConnection = connection;
+
+  // The helper runs the check command with its environment.
+  const CommandInfo& command = check.command().command();
+
+  CommandInfo helperCommand(command);
+  helperCommand.set_shell(false);
+  helperCommand.set_value("/bin/sh");
+  helperCommand.clear_arguments();
+  helperCommand.add_arguments("sh");
+  helperCommand.add_arguments("-c");
+
+  if (command.shell()) {
+    helperCommand.add_arguments(CHECK_HELPER_SHELL_SCRIPT);
+    helperCommand.add_arguments("sh");
+    helperCommand.add_arguments(command.value());
+  } else {
+    helperCommand.add_arguments(CHECK_HELPER_EXEC_SCRIPT);
+    helperCommand.add_arguments(command.value());
+
+    // NOTE: The first argument is the name of the executable, the
+    // executable is run with its path as the name instead.
+    for (int i = 1; i < command.arguments_size(); i++) {
+      helperCommand.add_arguments(command.arguments(i));
+    }
+  }
+
+  agent::Call call;
+  call.set_type(agent::Call::LAUNCH_NESTED_CONTAINER_SESSION);
+
+  agent::Call::LaunchNestedContainerSession* launch =
+    call.mutable_launch_nested_container_session();
+
+  launch->mutable_container_id()->CopyFrom(helperContainerId);
+  launch->mutable_command()->CopyFrom(helperCommand);
+
+  http::Request request;
+  request.method = "POST";
+  request.url = agentURL.get();
+  request.body = serialize(ContentType::PROTOBUF, evolve(call));
+  request.headers = {{"Accept", stringify(ContentType::RECORDIO)},
+                     {"Message-Accept", stringify(ContentType::PROTOBUF)},
+                     {"Content-Type", stringify(ContentType::PROTOBUF)}};
+
+  if (authorizationHeader.isSome()) {
+    request.headers["Authorization"] = authorizationHeader.get();
+  }
+
+  // The response is streamed so that the exit codes of the checks can
+  // be read while the helper is running.
+  connection.send(request, true)
+    .onAny(defer(self(),
+                 &Self::__launchCheckHelper,
+                 promise,
+                 helperContainerId,
+                 lambda::_1));
+}
+
+
+void CheckerProcess::__launchCheckHelper(
+    shared_ptr<Promise<int>> promise,
+    const ContainerID& helperContainerId,
+    const Future<http::Response>& launchResponse)
+{
+  // The helper might have been killed while it was being launched,
+  // e.g., because the check timed out.
+  if (helper.get() == nullptr || helper->containerId != helperContainerId) {
+    promise->discard();
+    return;
+  }
+
+  if (!launchResponse.isReady()) {
+    LOG(WARNING) << "Connection to the agent to launch " << name
+                 << " for task '" << taskId << "' failed: "
+                 << (launchResponse.isFailed()
+                       ? launchResponse.failure()
+                       : "discarded");
+
+    killCheckHelper();
+    promise->discard();
+    return;
+  }
+
+  if (launchResponse->code != http::Status::OK) {
+    // The agent was unable to launch the helper,
+    // we treat this as a transient failure.
+    LOG(WARNING) << "Received '" << launchResponse->status << "' while"
+                 << " launching " << name << " for task '" << taskId << "'";
+
+    killCheckHelper();
+    promise->discard();
+    return;
+  }
+
+  CHECK_SOME(launchResponse->reader);
+  helper->output = launchResponse->reader.get();
+
+  helper->output->read()
+    .onAny(defer(self(),
+                 &Self::readCheckHelper,
+                 helperContainerId,
+                 lambda::_1));
+
+  http::connect(agentURL.get())
+    .onAny(defer(self(),
+                 &Self::___launchCheckHelper,
+                 promise,
+                 helperContainerId,
+                 lambda::_1));
+}
+
+
+void CheckerProcess::___launchCheckHelper(
+    shared_ptr<Promise<int>> promise,
+    const ContainerID& helperContainerId,
+    const Future<http::Connection>& connection)
+{
+  if (helper.get() == nullptr || helper->containerId != helperContainerId) {
+    if (connection.isReady()) {
+      http::Connection(connection.get()).disconnect();
+    }
+
+    promise->discard();
+    return;
+  }
+
+  if (!connection.isReady()) {
+    LOG(WARNING) << "Unable to establish connection with the agent to attach"
+                 << " to " << name << " for task '" << taskId << "': "
+                 << (connection.isFailed() ? connection.failure()
+                                           : "discarded");
+
+    killCheckHelper();
+    promise->discard();
+    return;
+  }
+
+  helper->attachConnection = connection.get();
+
+  agent::Call call;
+  call.set_type(agent::Call::ATTACH_CONTAINER_INPUT);
+
+  agent::Call::AttachContainerInput* attach =
+    call.mutable_attach_container_input();
+
+  attach->set_type(agent::Call::AttachContainerInput::CONTAINER_ID);
+  attach->mutable_container_id()->CopyFrom(helperContainerId);
+
+  http::Pipe::Writer writer = helper->input.writer();
+  writer.write(helper->encoder.encode(evolve(call)));
+
+  http::Request request;
+  request.method = "POST";
+  request.url = agentURL.get();
+  request.type = http::Request::PIPE;
+  request.reader = helper->input.reader();
+  request.headers = {{"Accept", stringify(ContentType::PROTOBUF)},
+                     {"Content-Type", stringify(ContentType::RECORDIO)},
+                     {MESSAGE_CONTENT_TYPE, stringify(ContentType::PROTOBUF)}};
+
+  if (authorizationHeader.isSome()) {
+    request.headers["Authorization"] = authorizationHeader.get();
+  }
+
+  // The agent only responds once the stdin of the helper has been
+  // closed or the helper has terminated.
+  helper->attachConnection->send(request)
+    .onAny(defer(self(), [this, helperContainerId](
+        const Future<http::Response>& response) {
+      if (helper.get() != nullptr &&
+          helper->containerId == helperContainerId) {
+        LOG(WARNING) << "Attaching to " << name << " for task '" << taskId
+                     << "' ended: "
+                     << (response.isReady()
+                           ? response->status
+                           : (response.isFailed() ? response.failure()
+                                                  : "discarded"));
+
+        killCheckHelper();
+      }
+    }));
+
+  runCheckHelper(promise);
+}
+
+
+void CheckerProcess::runCheckHelper(shared_ptr<Promise<int>> promise)
+{
+  CHECK(helper.get() != nullptr);
+  CHECK(helper->pending.get() == nullptr);
+
+  // The check might have timed out while the helper was being launched.
+  if (promise->future().hasDiscard()) {
+    promise->discard();
+    return;
+  }
+
+  VLOG(1) << "Running " << name << " for task '" << taskId << "' in"
+          << " nested container '" << helper->containerId << "'";
+
+  agent::Call call;
+  call.set_type(agent::Call::ATTACH_CONTAINER_INPUT);
+
+  agent::Call::AttachContainerInput* attach =
+    call.mutable_attach_container_input();
+
+  attach->set_type(agent::Call::AttachContainerInput::PROCESS_IO);
+
+  agent::ProcessIO* processIO = attach->mutable_process_io();
+  processIO->set_type(agent::ProcessIO::DATA);
+  processIO->mutable_data()->set_type(agent::ProcessIO::Data::STDIN);
+  processIO->mutable_data()->set_data("\n");
+
+  helper->pending = promise;
+
+  http::Pipe::Writer writer = helper->input.writer();
+  if (!writer.write(helper->encoder.encode(evolve(call)))) {
+    // The agent closed the stdin of the helper.
+    killCheckHelper();
+  }
+}
+
+
+void CheckerProcess::readCheckHelper(
+    const ContainerID& helperContainerId,
+    const Future<string>& data)
+{
+  if (helper.get() == nullptr || helper->containerId != helperContainerId) {
+    return;
+  }
+
+  if (!data.isReady() || data->empty()) {
+    // The helper terminated, e.g., because the task finished.
+    LOG(WARNING) << "The output of " << name << " for task '" << taskId
+                 << "' ended"
+                 << (data.isFailed() ? ": " + data.failure() : "");
+
+    killCheckHelper();
+    return;
+  }
+
+  Try<std::deque<Try<v1::agent::ProcessIO>>> records =
+    helper->decoder.decode(data.get());
+
+  if (records.isError()) {
+    LOG(WARNING) << "Failed to decode the output of the " << name
+                 << " for task '" << taskId << "': " << records.error();
+
+    killCheckHelper();
+    return;
+  }
+
+  foreach (const Try<v1::agent::ProcessIO>& record, records.get()) {
+    if (record.isError()) {
+      LOG(WARNING) << "Failed to decode the output of the " << name
+                   << " for task '" << taskId << "': " << record.error();
+
+      killCheckHelper();
+      return;
+    }
+
+    if (record->data().type() == v1::agent::ProcessIO::Data::STDOUT) {
+      helper->stdout_ += record->data().data();
+    } else if (record->data().type() == v1::agent::ProcessIO::Data::STDERR) {
+      LOG(INFO) << "Output of the " << name << " for task '" << taskId
+                << "':" << std::endl << record->data().data();
+    }
+  }
+
+  // Every line written to stdout by the helper is the exit code of a
+  // check command.
+  size_t newline;
+  while ((newline = helper->stdout_.find('\n')) != string::npos) {
+    const string line = helper->stdout_.substr(0, newline);
+    helper->stdout_.erase(0, newline + 1);
+
+    if (helper->pending.get() == nullptr) {
+      LOG(WARNING) << "Ignoring unexpected output '" << line << "' of the "
+                   << name << " for task '" << taskId << "'";
+      continue;
+    }
+
+    shared_ptr<Promise<int>> promise = helper->pending;
+    helper->pending.reset();
+
+    Try<int> exitCode = numify<int>(strings::trim(line));
+    if (exitCode.isError()) {
+      promise->fail("Unable to get the exit code: " + exitCode.error());
+    } else {
+      promise->set(W_EXITCODE(exitCode.get(), 0));
+    }
+  }
+
+  helper->output->read()
+    .onAny(defer(self(),
+                 &Self::readCheckHelper,
+                 helperContainerId,
+                 lambda::_1));
+}
+
+
+void CheckerProcess::killCheckHelper()
+{
+  if (helper.get() == nullptr) {
+    return;
+  }
+
+  VLOG(1) << "Killing nested container '" << helper->containerId
+          << "' used for the " << name << " for task '" << taskId << "'";
+
+  // The result of the check in flight, if any, is lost, we treat
+  // this as a transient failure.
+  if (helper->pending.get() != nullptr) {
+    helper->pending->discard();
+  }
+
+  // Closing the connections makes the agent kill the helper.
+  helper->input.writer().close();
+
+  if (helper->attachConnection.isSome()) {
+    helper->attachConnection->disconnect();
+  }
+
+  if (helper->launchConnection.isSome()) {
+    helper->launchConnection->disconnect();
+  }
+
+  // The helper gets removed before the next one is launched.
+  previousCheckContainerId = helper->containerId;
+
+  helper.reset();
+}
+
+
 Future<Option<int>> CheckerProcess::waitNestedContainer(
     const ContainerID& containerId)
 {
@@ -829,6 +1465,25 @@ Future<int> CheckerProcess::httpCheck()
   const string _scheme = scheme.isSome() ? scheme.get() : DEFAULT_HTTP_SCHEME;
   const string path = http.has_path() ? http.path() : "";
 
+  // TODO(alexr): Use a lambda named capture for
+  // this cached value once it is available.
+  const Duration timeout = checkTimeout;
+
+  // HTTPS checks are left to curl, which can skip the validation of
+  // the certificate of the task.
+  if (inProcessProbes && _scheme == DEFAULT_HTTP_SCHEME) {
+    VLOG(1) << "Sending " << name << " to '"
+            << httpCheckAuthority(ipv6, http.port()) << path << "'"
+            << " for task '" << taskId << "'";
+
+    return httpProbe(path.empty() ? "/" : path, 0)
+      .after(timeout, [timeout](Future<int> future) {
+        future.discard();
+
+        return Failure("HTTP request timed out after " + stringify(timeout));
+      });
+  }
+
   // As per "curl --manual", the square brackets are required to tell curl that
   // it's an IPv6 address, and we need to set "-g" option below to stop curl
   // from interpreting the square brackets as special globbing characters.
@@ -876,7 +1531,6 @@ Future<int> CheckerProcess::httpCheck()
   // these cached values once it is available.
   const pid_t curlPid = s->pid();
   const string _name = name;
-  const Duration timeout = checkTimeout;
   const TaskID _taskId = taskId;
 
   return await(
@@ -959,6 +1613,143 @@ Future<int> CheckerProcess::_httpCheck(
 }
 
 
+Try<network::Socket> CheckerProcess::createSocket()
+{
+  const network::Address::Family family = ipv6
+    ? network::Address::Family::INET6
+    : network::Address::Family::INET4;
+
+#ifdef __linux__
+  if (taskNetNamespace.isSome()) {
+    CHECK_SOME(selfNetNamespace);
+
+    // A socket stays in the network namespace it was created in, so the
+    // calling thread only has to be in the network namespace of the task
+    // while creating the socket, which doesn't affect other threads.
+    if (::setns(taskNetNamespace.get(), CLONE_NEWNET) == -1) {
+      return ErrnoError("Failed to enter the network namespace of the task");
+    }
+
+    Try<network::Socket> socket = network::Socket::create(
+        family, network::internal::SocketImpl::Kind::POLL);
+
+    if (::setns(selfNetNamespace.get(), CLONE_NEWNET) == -1) {
+      // The calling thread would keep running the actors scheduled on
+      // it in the network namespace of the task otherwise.
+      PLOG(FATAL) << "Failed to return to the network namespace of the "
+                  << name << " for task '" << taskId << "'";
+    }
+
+    return socket;
+  }
+#endif // __linux__
+
+  return network::Socket::create(
+      family, network::internal::SocketImpl::Kind::POLL);
+}
+
+
+// Sends an HTTP GET request to the task from within this process, and
+// returns the status code of the response. Unlike curl, the response
+// body is not read.
+Future<int> CheckerProcess::httpProbe(const string& path, size_t redirects)
+{
+  Try<net::IP> ip =
+    net::IP::parse(ipv6 ? DEFAULT_IPV6_DOMAIN : DEFAULT_IPV4_DOMAIN);
+  CHECK_SOME(ip);
+
+  const network::inet::Address address(ip.get(), check.http().port());
+
+  Try<network::Socket> socket = createSocket();
+  if (socket.isError()) {
+    return Failure("Failed to create socket: " + socket.error());
+  }
+
+  const string request =
+    "GET " + path + " HTTP/1.1\r\n"
+    "Host: " + httpCheckAuthority(ipv6, check.http().port()) + "\r\n"
+    "Accept: */*\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+  network::Socket socket_ = socket.get();
+
+  return socket_.connect(address)
+    .then([=]() mutable {
+      return socket_.send(request);
+    })
+    .then([=]() {
+      return recvHttpHead(socket_);
+    })
+    .then(defer(self(), &Self::_httpProbe, redirects, lambda::_1));
+}
+
+
+Future<int> CheckerProcess::_httpProbe(size_t redirects, const string& head)
+{
+  const vector<string> lines = strings::split(head, "\r\n");
+  const vector<string> status = strings::tokenize(lines[0], " ");
+
+  if (status.size() < 2 || !strings::startsWith(status[0], "HTTP/")) {
+    return Failure("Unexpected status line '" + lines[0] + "'");
+  }
+
+  Try<int> statusCode = numify<int>(status[1]);
+  if (statusCode.isError()) {
+    return Failure("Unexpected status line '" + lines[0] + "'");
+  }
+
+  // Follow redirects like `curl -L` does.
+  if (statusCode.get() == http::Status::MOVED_PERMANENTLY ||
+      statusCode.get() == http::Status::FOUND ||
+      statusCode.get() == http::Status::SEE_OTHER ||
+      statusCode.get() == http::Status::TEMPORARY_REDIRECT ||
+      statusCode.get() == 308) {
+    Option<string> location;
+    for (size_t i = 1; i < lines.size(); i++) {
+      const size_t colon = lines[i].find(':');
+      if (colon != string::npos &&
+          strings::lower(strings::trim(lines[i].substr(0, colon))) ==
+            "location") {
+        location = strings::trim(lines[i].substr(colon + 1));
+      }
+    }
+
+    // Only redirects to the task are followed, since the network
+    // namespace of the task might not be able to reach other hosts.
+    const string origin =
+      "http://" + httpCheckAuthority(ipv6, check.http().port());
+
+    Option<string> path;
+    if (location.isSome()) {
+      if (strings::startsWith(location.get(), "/")) {
+        path = location.get();
+      } else if (location.get() == origin) {
+        path = "/";
+      } else if (strings::startsWith(location.get(), origin + "/")) {
+        path = location->substr(origin.size());
+      } else {
+        VLOG(1) << "Not following the redirect of the " << name
+                << " for task '" << taskId << "' to '" << location.get()
+                << "'";
+      }
+    }
+
+    if (path.isSome()) {
+      if (redirects >= HTTP_CHECK_MAX_REDIRECTS) {
+        return Failure(
+            "Maximum (" + stringify(HTTP_CHECK_MAX_REDIRECTS) +
+            ") redirects followed");
+      }
+
+      return httpProbe(path.get(), redirects + 1);
+    }
+  }
+
+  return statusCode.get();
+}
+
+
 void CheckerProcess::processHttpCheckResult(
     const Stopwatch& stopwatch,
     const Future<int>& future)
@@ -995,11 +1786,52 @@ Future<bool> CheckerProcess::tcpCheck()
   CHECK_EQ(CheckInfo::TCP, check.type());
   CHECK(check.has_tcp());
 
+  const CheckInfo::Tcp& tcp = check.tcp();
+
+  // TODO(alexr): Use lambda named captures for
+  // these cached values once they are available.
+  const string _name = name;
+  const Duration timeout = checkTimeout;
+  const TaskID _taskId = taskId;
+
+  if (inProcessProbes) {
+    VLOG(1) << "Connecting " << name << " for task '" << taskId << "'"
+            << " to port " << tcp.port();
+
+    Try<net::IP> ip =
+      net::IP::parse(ipv6 ? DEFAULT_IPV6_DOMAIN : DEFAULT_IPV4_DOMAIN);
+    CHECK_SOME(ip);
+
+    Try<network::Socket> socket = createSocket();
+    if (socket.isError()) {
+      return Failure("Failed to create socket: " + socket.error());
+    }
+
+    network::Socket socket_ = socket.get();
+
+    // As for TCP_CHECK_COMMAND, any failure to connect is treated as a
+    // connection failure.
+    return socket_.connect(network::inet::Address(ip.get(), tcp.port()))
+      .then([socket_]() {
+        // Keep the socket open until the connection has been established.
+        return true;
+      })
+      .repair([_name, _taskId](const Future<bool>& future) {
+        VLOG(1) << "Connection of the " << _name << " for task '" << _taskId
+                << "' failed: " << future.failure();
+
+        return false;
+      })
+      .after(timeout, [timeout](Future<bool> future) {
+        future.discard();
+
+        return Failure("Connection timed out after " + stringify(timeout));
+      });
+  }
+
   // TCP_CHECK_COMMAND should be reachable.
   CHECK(os::exists(launcherDir));
 
-  const CheckInfo::Tcp& tcp = check.tcp();
-
   VLOG(1) << "Launching " << name << " for task '" << taskId << "'"
           << " at port " << tcp.port();
 
@@ -1032,9 +1864,6 @@ Future<bool> CheckerProcess::tcpCheck()
   // TODO(alexr): Use lambda named captures for
   // these cached values once they are available.
   pid_t commandPid = s->pid();
-  const string _name = name;
-  const Duration timeout = checkTimeout;
-  const TaskID _taskId = taskId;
 
   return await(
       s->status(),
@@ -26,7 +26,9 @@
 
 #include <process/future.hpp>
 #include <process/http.hpp>
+#include <process/owned.hpp>
 #include <process/protobuf.hpp>
+#include <process/socket.hpp>
 
 #include <stout/duration.hpp>
 #include <stout/option.hpp>
@@ -56,18 +58,21 @@ public:
       const Option<std::string>& _scheme,
       const std::string& _name,
       bool _commandCheckViaAgent,
+      bool _persistentCommandCheck,
       bool _ipv6 = false);
 
   void pause();
   void resume();
 
-  virtual ~CheckerProcess() {}
+  virtual ~CheckerProcess();
 
 protected:
   void initialize() override;
   void finalize() override;
 
 private:
+  struct CheckHelper;
+
   void performCheck();
   void scheduleNext(const Duration& duration);
   void processCheckResult(
@@ -93,6 +98,26 @@ private:
       std::shared_ptr<bool> checkTimedOut,
       const std::string& failure);
 
+  process::Future<int> helperCommandCheck();
+  void launchCheckHelper(std::shared_ptr<process::Promise<int>> promise);
+  void _launchCheckHelper(
+      std::shared_ptr<process::Promise<int>> promise,
+      const ContainerID& helperContainerId,
+      process::http::Connection connection);
+  void __launchCheckHelper(
+      std::shared_ptr<process::Promise<int>> promise,
+      const ContainerID& helperContainerId,
+      const process::Future<process::http::Response>& launchResponse);
+  void ___launchCheckHelper(
+      std::shared_ptr<process::Promise<int>> promise,
+      const ContainerID& helperContainerId,
+      const process::Future<process::http::Connection>& connection);
+  void runCheckHelper(std::shared_ptr<process::Promise<int>> promise);
+  void readCheckHelper(
+      const ContainerID& helperContainerId,
+      const process::Future<std::string>& data);
+  void killCheckHelper();
+
   process::Future<Option<int>> waitNestedContainer(
       const ContainerID& containerId);
   process::Future<Option<int>> _waitNestedContainer(
@@ -112,6 +137,11 @@ private:
       const Stopwatch& stopwatch,
       const process::Future<int>& future);
 
+  Try<process::network::Socket> createSocket();
+
+  process::Future<int> httpProbe(const std::string& path, size_t redirects);
+  process::Future<int> _httpProbe(size_t redirects, const std::string& head);
+
   process::Future<bool> tcpCheck();
   process::Future<bool> _tcpCheck(
       const std::tuple<process::Future<Option<int>>,
@@ -140,6 +170,11 @@ private:
   const std::string name;
   const bool commandCheckViaAgent;
 
+  // If set to true, COMMAND checks performed via the agent are run in a
+  // single long-lived nested container rather than in a new nested
+  // container per check, see `helperCommandCheck()`.
+  const bool persistentCommandCheck;
+
   // If set to true, the TCP/HTTP(S) check will be performed over IPv6,
   // otherwise, it will be performed over IPv4.
   //
@@ -150,11 +185,27 @@ private:
 
   Option<lambda::function<pid_t(const lambda::function<int()>&)>> clone;
 
+  // If set to true, HTTP checks (unless they use HTTPS) and TCP checks
+  // are performed from within this process rather than by launching a
+  // helper binary for every check.
+  bool inProcessProbes;
+
+#ifdef __linux__
+  // The network namespaces the sockets of in-process probes are created
+  // in and switched back from, if the task has its own network namespace.
+  Option<int> taskNetNamespace;
+  Option<int> selfNetNamespace;
+#endif // __linux__
+
   bool paused;
 
   // Contains the ID of the most recently terminated nested container
   // that was used to perform a COMMAND check.
   Option<ContainerID> previousCheckContainerId;
+
+  // The nested container performing COMMAND checks if
+  // `persistentCommandCheck` is set, null until it has been launched.
+  process::Owned<CheckHelper> helper;
 };
 
 } // namespace checks {
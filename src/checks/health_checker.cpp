@@ -196,6 +196,7 @@ Try<Owned<HealthChecker>> HealthChecker::create(
           None(),
           None(),
           None(),
+          false,
           false));
 }
 
@@ -207,7 +208,8 @@ Try<Owned<HealthChecker>> HealthChecker::create(
     const TaskID& taskId,
     const ContainerID& taskContainerId,
     const process::http::URL& agentURL,
-    const Option<string>& authorizationHeader)
+    const Option<string>& authorizationHeader,
+    bool persistentCommandCheck)
 {
   // Validate the 'HealthCheck' protobuf.
   Option<Error> error = validation::healthCheck(healthCheck);
@@ -226,7 +228,8 @@ Try<Owned<HealthChecker>> HealthChecker::create(
           taskContainerId,
           agentURL,
           authorizationHeader,
-          true));
+          true,
+          persistentCommandCheck));
 }
 
 
@@ -240,7 +243,8 @@ HealthChecker::HealthChecker(
       const Option<ContainerID>& taskContainerId,
       const Option<process::http::URL>& agentURL,
       const Option<std::string>& authorizationHeader,
-      bool commandCheckViaAgent)
+      bool commandCheckViaAgent,
+      bool persistentCommandCheck)
   : healthCheck(_healthCheck),
     callback(_callback),
     name(HealthCheck::Type_Name(healthCheck.type()) + " health check"),
@@ -284,6 +288,7 @@ HealthChecker::HealthChecker(
           scheme,
           name,
           commandCheckViaAgent,
+          persistentCommandCheck,
           ipv6));
 
   spawn(process.get());
@@ -79,7 +79,8 @@ public:
    *
    * If the check is a command health check, the checker will delegate the
    * execution of the check to the Mesos agent via the
-   * `LaunchNestedContainerSession` API call.
+   * `LaunchNestedContainerSession` API call, or, if `persistentCommandCheck`
+   * is set, to a single long-lived nested container launched that way.
    *
    * @param healthCheck The protobuf message definition of health check.
    * @param launcherDir A directory where Mesos helper binaries are located.
@@ -90,6 +91,8 @@ public:
    * @param agentURL The URL of the agent.
    * @param authorizationHeader The authorization header the health checker
    *     should use to authenticate with the agent operator API.
+   * @param persistentCommandCheck Whether command health checks should reuse
+   *     one nested container instead of launching a new one per check.
    * @return A `HealthChecker` object or an error if `create` fails.
    *
    * @todo A better approach would be to return a stream of updates, e.g.,
@@ -102,7 +105,8 @@ public:
       const TaskID& taskId,
       const ContainerID& taskContainerId,
       const process::http::URL& agentURL,
-      const Option<std::string>& authorizationHeader);
+      const Option<std::string>& authorizationHeader,
+      bool persistentCommandCheck = false);
 
   ~HealthChecker();
 
@@ -121,7 +125,8 @@ private:
       const Option<ContainerID>& taskContainerId,
       const Option<process::http::URL>& agentURL,
       const Option<std::string>& authorizationHeader,
-      bool commandCheckViaAgent);
+      bool commandCheckViaAgent,
+      bool persistentCommandCheck);
 
   void processCheckResult(const Try<CheckStatusInfo>& result);
   void failure();
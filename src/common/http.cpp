@@ -39,6 +39,7 @@
 
 #include <stout/duration.hpp>
 #include <stout/foreach.hpp>
+#include <stout/jsonify.hpp>
 #include <stout/protobuf.hpp>
 #include <stout/recordio.hpp>
 #include <stout/stringify.hpp>
@@ -114,7 +115,9 @@ string serialize(
       return message.SerializeAsString();
     }
     case ContentType::JSON: {
-      return stringify(JSON::protobuf(message));
+      // Write the JSON while traversing the message rather than
+      // building a `JSON::Object` first.
+      return jsonify(JSON::Protobuf(message));
     }
     case ContentType::RECORDIO: {
       LOG(FATAL) << "Serializing a RecordIO stream is not supported";
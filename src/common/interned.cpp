@@ -0,0 +1,107 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include <stout/check.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/synchronized.hpp>
+
+#include "common/interned.hpp"
+
+using std::deque;
+using std::string;
+
+namespace mesos {
+namespace internal {
+
+namespace {
+
+struct Table
+{
+  std::mutex mutex;
+
+  hashmap<string, uint32_t> ids;
+
+  // We use a `deque` so that references returned by `interned()`
+  // remain valid as the table grows.
+  deque<string> values;
+};
+
+
+// NOTE: The table is intentionally leaked to avoid destruction order
+// issues with other static objects that may intern strings.
+Table* table()
+{
+  static Table* table = new Table();
+  return table;
+}
+
+} // namespace {
+
+
+uint32_t intern(const string& value)
+{
+  static thread_local hashmap<string, uint32_t>* cache = nullptr;
+
+  if (cache == nullptr) {
+    cache = new hashmap<string, uint32_t>();
+  }
+
+  auto it = cache->find(value);
+  if (it != cache->end()) {
+    return it->second;
+  }
+
+  uint32_t id;
+
+  Table* table_ = table();
+
+  synchronized (table_->mutex) {
+    auto found = table_->ids.find(value);
+    if (found != table_->ids.end()) {
+      id = found->second;
+    } else {
+      id = static_cast<uint32_t>(table_->values.size());
+      table_->values.push_back(value);
+      table_->ids.emplace(value, id);
+    }
+  }
+
+  cache->emplace(value, id);
+
+  return id;
+}
+
+
+const string& interned(uint32_t id)
+{
+  const string* value = nullptr;
+
+  Table* table_ = table();
+
+  synchronized (table_->mutex) {
+    CHECK_LT(id, table_->values.size());
+    value = &table_->values[id];
+  }
+
+  return *value;
+}
+
+} // namespace internal {
+} // namespace mesos {
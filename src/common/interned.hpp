@@ -0,0 +1,49 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __COMMON_INTERNED_HPP__
+#define __COMMON_INTERNED_HPP__
+
+#include <stdint.h>
+
+#include <string>
+
+namespace mesos {
+namespace internal {
+
+// Returns the id of `value` in a process-wide interning table, adding
+// `value` to the table if it is not already present. Two strings have
+// the same id if and only if they are equal, so ids can be compared
+// instead of the strings themselves.
+//
+// This is intended for the small set of strings that are compared
+// over and over again, e.g., resource names and roles. Entries are
+// never removed from the table.
+//
+// NOTE: This is thread-safe. Each thread keeps a cache of the ids it
+// has looked up, so the table is only locked for strings that the
+// calling thread has not seen before.
+uint32_t intern(const std::string& value);
+
+
+// Returns the string with the given id. The id must have been
+// returned by `intern()`.
+const std::string& interned(uint32_t id);
+
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __COMMON_INTERNED_HPP__
@@ -22,9 +22,12 @@
 #include <pwd.h>
 #endif // __WINDOWS__
 
+#include <algorithm>
 #include <ostream>
 #include <vector>
 
+#include <boost/uuid/sha1.hpp>
+
 #include <mesos/slave/isolator.hpp>
 
 #include <mesos/type_utils.hpp>
@@ -1003,7 +1006,8 @@ bool operator==(const Capabilities& left, const Capabilities& right)
   return left.multiRole == right.multiRole &&
          left.hierarchicalRole == right.hierarchicalRole &&
          left.reservationRefinement == right.reservationRefinement &&
-         left.resourceProvider == right.resourceProvider;
+         left.resourceProvider == right.resourceProvider &&
+         left.statusUpdateBatches == right.statusUpdateBatches;
 }
 
 
@@ -1059,6 +1063,44 @@ ContainerState createContainerState(
   return state;
 }
 
+
+string createFrameworkDigest(
+    const vector<TaskID>& taskIds,
+    const vector<ExecutorID>& executorIds)
+{
+  vector<string> ids;
+
+  foreach (const TaskID& taskId, taskIds) {
+    ids.push_back("task:" + taskId.value());
+  }
+
+  foreach (const ExecutorID& executorId, executorIds) {
+    ids.push_back("executor:" + executorId.value());
+  }
+
+  std::sort(ids.begin(), ids.end());
+
+  boost::uuids::detail::sha1 sha1;
+
+  // NOTE: Every ID is terminated to avoid ambiguities between the
+  // concatenations of different IDs.
+  foreach (const string& id, ids) {
+    sha1.process_bytes(id.c_str(), id.size() + 1);
+  }
+
+  unsigned int words[5];
+  sha1.get_digest(words);
+
+  string digest;
+  foreach (unsigned int word, words) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      digest.push_back(static_cast<char>((word >> shift) & 0xff));
+    }
+  }
+
+  return digest;
+}
+
 } // namespace slave {
 
 namespace maintenance {
@@ -21,6 +21,7 @@
 #include <ostream>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <sys/stat.h>
 
@@ -266,6 +267,9 @@ struct Capabilities
         case SlaveInfo::Capability::RESOURCE_PROVIDER:
           resourceProvider = true;
           break;
+        case SlaveInfo::Capability::STATUS_UPDATE_BATCHES:
+          statusUpdateBatches = true;
+          break;
         // If adding another case here be sure to update the
         // equality operator.
       }
@@ -277,6 +281,7 @@ struct Capabilities
   bool hierarchicalRole = false;
   bool reservationRefinement = false;
   bool resourceProvider = false;
+  bool statusUpdateBatches = false;
 
   google::protobuf::RepeatedPtrField<SlaveInfo::Capability>
   toRepeatedPtrField() const
@@ -294,6 +299,9 @@ struct Capabilities
     if (resourceProvider) {
       result.Add()->set_type(SlaveInfo::Capability::RESOURCE_PROVIDER);
     }
+    if (statusUpdateBatches) {
+      result.Add()->set_type(SlaveInfo::Capability::STATUS_UPDATE_BATCHES);
+    }
 
     return result;
   }
@@ -317,6 +325,14 @@ mesos::slave::ContainerState createContainerState(
     pid_t pid,
     const std::string& directory);
 
+
+// Returns a digest of the IDs of the tasks and executors of a
+// framework on an agent, which does not depend on their order. See
+// `ReregisterSlaveMessage.framework_digests`.
+std::string createFrameworkDigest(
+    const std::vector<TaskID>& taskIds,
+    const std::vector<ExecutorID>& executorIds);
+
 } // namespace slave {
 
 namespace maintenance {
@@ -373,11 +389,19 @@ struct Capabilities
         case MasterInfo::Capability::AGENT_UPDATE:
           agentUpdate = true;
           break;
+        case MasterInfo::Capability::AGENT_REREGISTRATION_DIGESTS:
+          agentReregistrationDigests = true;
+          break;
+        case MasterInfo::Capability::STATUS_UPDATE_BATCHES:
+          statusUpdateBatches = true;
+          break;
       }
     }
   }
 
   bool agentUpdate = false;
+  bool agentReregistrationDigests = false;
+  bool statusUpdateBatches = false;
 };
 
 namespace event {
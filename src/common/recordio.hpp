@@ -17,6 +17,7 @@
 #ifndef __COMMON_RECORDIO_HPP__
 #define __COMMON_RECORDIO_HPP__
 
+#include <deque>
 #include <queue>
 #include <string>
 #include <utility>
@@ -92,6 +93,21 @@ public:
     return process::dispatch(process, &internal::ReaderProcess<T>::read);
   }
 
+  /**
+   * Returns all of the pieces of data decoded from the pipe so far,
+   * in order, waiting for the next one if there are none. This lets
+   * the caller consume the records decoded from the same chunk of
+   * the pipe at once rather than one at a time. The records end with
+   * none when end-of-file is reached, and the returned future is a
+   * failure when the pipe or decoder has failed.
+   *
+   * NOTE: This should not be mixed with `read()`.
+   */
+  process::Future<std::deque<Result<T>>> readAll()
+  {
+    return process::dispatch(process, &internal::ReaderProcess<T>::readAll);
+  }
+
 private:
   process::PID<internal::ReaderProcess<T>> process;
 };
@@ -152,7 +168,7 @@ public:
       ::recordio::Decoder<T>&& _decoder,
       process::http::Pipe::Reader _reader)
     : process::ProcessBase(process::ID::generate("__reader__")),
-      decoder(_decoder),
+      decoder(std::move(_decoder)),
       reader(_reader),
       done(false) {}
 
@@ -162,7 +178,7 @@ public:
   {
     if (!records.empty()) {
       Result<T> record = std::move(records.front());
-      records.pop();
+      records.pop_front();
       return record;
     }
 
@@ -180,6 +196,30 @@ public:
     return waiters.back()->future();
   }
 
+  process::Future<std::deque<Result<T>>> readAll()
+  {
+    if (!records.empty()) {
+      std::deque<Result<T>> result;
+      std::swap(result, records);
+      return result;
+    }
+
+    if (error.isSome()) {
+      return process::Failure(error.get().message);
+    }
+
+    if (done) {
+      std::deque<Result<T>> result;
+      result.push_back(None());
+      return result;
+    }
+
+    auto waiter = process::Owned<process::Promise<std::deque<Result<T>>>>(
+        new process::Promise<std::deque<Result<T>>>());
+    batchWaiters.push(std::move(waiter));
+    return batchWaiters.back()->future();
+  }
+
 protected:
   virtual void initialize() override
   {
@@ -201,6 +241,11 @@ private:
       waiters.front()->fail(message);
       waiters.pop();
     }
+
+    while (!batchWaiters.empty()) {
+      batchWaiters.front()->fail(message);
+      batchWaiters.pop();
+    }
   }
 
   void complete()
@@ -211,6 +256,13 @@ private:
       waiters.front()->set(Result<T>::none());
       waiters.pop();
     }
+
+    while (!batchWaiters.empty()) {
+      std::deque<Result<T>> result;
+      result.push_back(None());
+      batchWaiters.front()->set(std::move(result));
+      batchWaiters.pop();
+    }
   }
 
   using process::Process<ReaderProcess<T>>::consume;
@@ -242,15 +294,24 @@ private:
       return;
     }
 
-    foreach (const Try<T>& record, decode.get()) {
+    foreach (Try<T>& record, decode.get()) {
       if (!waiters.empty()) {
         waiters.front()->set(Result<T>(std::move(record)));
         waiters.pop();
       } else {
-        records.push(std::move(record));
+        records.push_back(std::move(record));
       }
     }
 
+    // Hand all of the records decoded from this chunk to the next
+    // batch waiter at once.
+    if (!batchWaiters.empty() && !records.empty()) {
+      std::deque<Result<T>> result;
+      std::swap(result, records);
+      batchWaiters.front()->set(std::move(result));
+      batchWaiters.pop();
+    }
+
     consume();
   }
 
@@ -258,7 +319,9 @@ private:
   process::http::Pipe::Reader reader;
 
   std::queue<process::Owned<process::Promise<Result<T>>>> waiters;
-  std::queue<Result<T>> records;
+  std::queue<process::Owned<process::Promise<std::deque<Result<T>>>>>
+    batchWaiters;
+  std::deque<Result<T>> records;
 
   bool done;
   Option<Error> error;
@@ -0,0 +1,356 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <mesos/values.hpp>
+
+#include <stout/check.hpp>
+#include <stout/error.hpp>
+#include <stout/foreach.hpp>
+#include <stout/numify.hpp>
+#include <stout/strings.hpp>
+
+#include "common/resource_quantities.hpp"
+
+using std::map;
+using std::ostream;
+using std::set;
+using std::string;
+using std::vector;
+
+namespace mesos {
+namespace internal {
+
+// NOTE: These mirror the fixed point conversions used for
+// `Value::Scalar` arithmetic in `common/values.cpp`, so that
+// quantities are rounded exactly as the equivalent `Resources`.
+static long long convertToFixed(double floatValue)
+{
+  return std::llround(floatValue * 1000);
+}
+
+
+static double convertToFloating(long long fixedValue)
+{
+  double quotient = static_cast<double>(fixedValue / 1000);
+  double remainder = static_cast<double>(fixedValue % 1000) / 1000.0;
+
+  return quotient + remainder;
+}
+
+
+Try<ResourceQuantities> ResourceQuantities::fromString(const string& text)
+{
+  map<string, long long> quantities;
+
+  foreach (const string& token, strings::tokenize(text, ";")) {
+    vector<string> pair = strings::tokenize(token, ":");
+    if (pair.size() != 2) {
+      return Error("Failed to parse '" + token + "': missing or extra ':'");
+    }
+
+    const string name = strings::trim(pair[0]);
+    if (name.empty()) {
+      return Error("Failed to parse '" + token + "': empty name");
+    }
+
+    Try<double> value = numify<double>(strings::trim(pair[1]));
+    if (value.isError()) {
+      return Error(
+          "Failed to parse '" + token + "': " + value.error());
+    }
+
+    if (!std::isfinite(value.get()) || value.get() < 0) {
+      return Error(
+          "Failed to parse '" + token + "': quantity must be a"
+          " non-negative finite number");
+    }
+
+    if (quantities.count(name) > 0) {
+      return Error("Failed to parse '" + text + "': duplicate '" + name + "'");
+    }
+
+    quantities[name] = convertToFixed(value.get());
+  }
+
+  ResourceQuantities result;
+  foreachpair (const string& name, long long value, quantities) {
+    if (value > 0) {
+      result.names.push_back(name);
+      result.values.push_back(value);
+    }
+  }
+
+  return result;
+}
+
+
+ResourceQuantities ResourceQuantities::fromScalarResources(
+    const Resources& resources)
+{
+  map<string, long long> quantities;
+
+  foreach (const Resource& resource, resources) {
+    if (resource.type() == Value::SCALAR) {
+      quantities[resource.name()] += convertToFixed(resource.scalar().value());
+    }
+  }
+
+  ResourceQuantities result;
+  foreachpair (const string& name, long long value, quantities) {
+    if (value > 0) {
+      result.names.push_back(name);
+      result.values.push_back(value);
+    }
+  }
+
+  return result;
+}
+
+
+Value::Scalar ResourceQuantities::get(const string& name) const
+{
+  Value::Scalar scalar;
+  scalar.set_value(0);
+
+  auto it = std::lower_bound(names.begin(), names.end(), name);
+  if (it != names.end() && *it == name) {
+    scalar.set_value(convertToFloating(values[it - names.begin()]));
+  }
+
+  return scalar;
+}
+
+
+Value::Scalar ResourceQuantities::at(size_t index) const
+{
+  CHECK_LT(index, values.size());
+
+  Value::Scalar scalar;
+  scalar.set_value(convertToFloating(values[index]));
+  return scalar;
+}
+
+
+bool ResourceQuantities::contains(const ResourceQuantities& that) const
+{
+  size_t i = 0;
+
+  for (size_t j = 0; j < that.names.size(); j++) {
+    while (i < names.size() && names[i] < that.names[j]) {
+      i++;
+    }
+
+    if (i == names.size() ||
+        names[i] != that.names[j] ||
+        values[i] < that.values[j]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+double ResourceQuantities::dominantShare(
+    const ResourceQuantities& total,
+    const Option<set<string>>& excluded) const
+{
+  double share = 0.0;
+
+  size_t i = 0;
+  size_t j = 0;
+
+  while (i < names.size() && j < total.names.size()) {
+    if (names[i] < total.names[j]) {
+      i++;
+    } else if (total.names[j] < names[i]) {
+      j++;
+    } else {
+      if (excluded.isNone() || excluded->count(names[i]) == 0) {
+        share = std::max(
+            share,
+            static_cast<double>(values[i]) /
+              static_cast<double>(total.values[j]));
+      }
+
+      i++;
+      j++;
+    }
+  }
+
+  return share;
+}
+
+
+Resources ResourceQuantities::toUnreservedResources() const
+{
+  Resources result;
+
+  for (size_t i = 0; i < names.size(); i++) {
+    Resource resource;
+    resource.set_name(names[i]);
+    resource.set_type(Value::SCALAR);
+    resource.mutable_scalar()->set_value(convertToFloating(values[i]));
+
+    result += resource;
+  }
+
+  return result;
+}
+
+
+bool ResourceQuantities::operator==(const ResourceQuantities& that) const
+{
+  return names == that.names && values == that.values;
+}
+
+
+bool ResourceQuantities::operator!=(const ResourceQuantities& that) const
+{
+  return !(*this == that);
+}
+
+
+ResourceQuantities ResourceQuantities::operator+(
+    const ResourceQuantities& that) const
+{
+  ResourceQuantities result = *this;
+  result += that;
+  return result;
+}
+
+
+ResourceQuantities ResourceQuantities::operator-(
+    const ResourceQuantities& that) const
+{
+  ResourceQuantities result = *this;
+  result -= that;
+  return result;
+}
+
+
+ResourceQuantities& ResourceQuantities::operator+=(
+    const ResourceQuantities& that)
+{
+  merge(that, 1);
+  return *this;
+}
+
+
+ResourceQuantities& ResourceQuantities::operator-=(
+    const ResourceQuantities& that)
+{
+  merge(that, -1);
+  return *this;
+}
+
+
+void ResourceQuantities::merge(const ResourceQuantities& that, int sign)
+{
+  // Fast path: in the bookkeeping done by the allocator both operands
+  // almost always have the same names, in which case we only need to
+  // combine the contiguous value arrays.
+  if (names == that.names) {
+    bool zero = false;
+
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = std::max(0LL, values[i] + sign * that.values[i]);
+      zero = zero || values[i] == 0;
+    }
+
+    if (!zero) {
+      return;
+    }
+
+    size_t k = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+      if (values[i] > 0) {
+        names[k] = std::move(names[i]);
+        values[k] = values[i];
+        k++;
+      }
+    }
+
+    names.resize(k);
+    values.resize(k);
+    return;
+  }
+
+  vector<string> mergedNames;
+  vector<long long> mergedValues;
+
+  mergedNames.reserve(names.size() + that.names.size());
+  mergedValues.reserve(names.size() + that.names.size());
+
+  size_t i = 0;
+  size_t j = 0;
+
+  while (i < names.size() || j < that.names.size()) {
+    string name;
+    long long value;
+
+    if (j == that.names.size() ||
+        (i < names.size() && names[i] < that.names[j])) {
+      name = std::move(names[i]);
+      value = values[i];
+      i++;
+    } else if (i == names.size() || that.names[j] < names[i]) {
+      name = that.names[j];
+      value = sign * that.values[j];
+      j++;
+    } else {
+      name = std::move(names[i]);
+      value = values[i] + sign * that.values[j];
+      i++;
+      j++;
+    }
+
+    if (value > 0) {
+      mergedNames.push_back(std::move(name));
+      mergedValues.push_back(value);
+    }
+  }
+
+  names = std::move(mergedNames);
+  values = std::move(mergedValues);
+}
+
+
+ostream& operator<<(ostream& stream, const ResourceQuantities& quantities)
+{
+  const vector<string>& names = quantities.keys();
+
+  for (size_t i = 0; i < names.size(); i++) {
+    if (i > 0) {
+      stream << "; ";
+    }
+
+    stream << names[i] << ":" << quantities.at(i);
+  }
+
+  return stream;
+}
+
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,129 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __COMMON_RESOURCE_QUANTITIES_HPP__
+#define __COMMON_RESOURCE_QUANTITIES_HPP__
+
+#include <iosfwd>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <mesos/mesos.hpp>
+#include <mesos/resources.hpp>
+
+#include <stout/none.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+namespace mesos {
+namespace internal {
+
+// An efficient collection of resource quantities, i.e., aggregated
+// scalar values keyed by resource name only. All other resource
+// metadata (reservations, disk info, sharedness, etc.) is dropped.
+//
+// This is used where only the amount of each kind of resource
+// matters, e.g., for the allocation bookkeeping in the sorter and
+// for quota headroom calculations in the allocator, so that these
+// avoid the cost of `Resources` arithmetic.
+//
+// Quantities are kept as a flat array sorted by name, with the
+// values stored separately in the same fixed point representation
+// used for `Value::Scalar` arithmetic (see `common/values.cpp`).
+// Names are compared only to align the two operands of a binary
+// operation; the arithmetic itself is exact integer math.
+//
+// A quantity is never negative: subtraction saturates at zero and
+// entries which become zero are removed.
+class ResourceQuantities
+{
+public:
+  // Parses the text and returns the corresponding quantities, e.g.,
+  // "cpus:10;mem:1024;disk:0". Returns an error if any of the
+  // entries is not a non-negative scalar or if a name is duplicated.
+  static Try<ResourceQuantities> fromString(const std::string& text);
+
+  // Returns the quantities of the scalar resources in `resources`.
+  // Non-scalar resources are ignored.
+  static ResourceQuantities fromScalarResources(const Resources& resources);
+
+  ResourceQuantities() {}
+
+  ResourceQuantities(const ResourceQuantities& that) = default;
+  ResourceQuantities(ResourceQuantities&& that) = default;
+
+  ResourceQuantities& operator=(const ResourceQuantities& that) = default;
+  ResourceQuantities& operator=(ResourceQuantities&& that) = default;
+
+  bool empty() const { return names.empty(); }
+
+  size_t size() const { return names.size(); }
+
+  // The names of the quantities, in sorted order.
+  const std::vector<std::string>& keys() const { return names; }
+
+  // Returns the quantity with the given name, or zero if absent.
+  Value::Scalar get(const std::string& name) const;
+
+  // Returns the quantity at the given position in `keys()`.
+  Value::Scalar at(size_t index) const;
+
+  // Returns true if the quantity of each name in `that` is less
+  // than or equal to the corresponding quantity in this object.
+  bool contains(const ResourceQuantities& that) const;
+
+  // Returns the largest ratio of a quantity in this object to the
+  // corresponding quantity of `total`, skipping names for which
+  // `total` has no quantity and names in `excluded`. This
+  // is the dominant share used by the DRF sorter.
+  double dominantShare(
+      const ResourceQuantities& total,
+      const Option<std::set<std::string>>& excluded = None()) const;
+
+  // Converts the quantities to unreserved scalar resources.
+  Resources toUnreservedResources() const;
+
+  bool operator==(const ResourceQuantities& that) const;
+  bool operator!=(const ResourceQuantities& that) const;
+
+  ResourceQuantities operator+(const ResourceQuantities& that) const;
+  ResourceQuantities operator-(const ResourceQuantities& that) const;
+
+  ResourceQuantities& operator+=(const ResourceQuantities& that);
+  ResourceQuantities& operator-=(const ResourceQuantities& that);
+
+private:
+  // Adds `that` to (or, if `sign` is negative, subtracts it from)
+  // this object, saturating each quantity at zero.
+  void merge(const ResourceQuantities& that, int sign);
+
+  // Sorted names and their fixed point values. The two vectors have
+  // the same size and are kept separate so that the values form a
+  // contiguous array.
+  std::vector<std::string> names;
+  std::vector<long long> values;
+};
+
+
+std::ostream& operator<<(
+    std::ostream& stream,
+    const ResourceQuantities& quantities);
+
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __COMMON_RESOURCE_QUANTITIES_HPP__
@@ -40,9 +40,6 @@ using std::ostream;
 using std::string;
 using std::vector;
 
-using mesos::internal::values::intervalSetToRanges;
-using mesos::internal::values::rangesToIntervalSet;
-
 namespace mesos {
 
 // We manipulate scalar values by converting them from floating point to a
@@ -145,39 +142,36 @@ struct Range
 };
 
 
-// Coalesces the vector of ranges provided and modifies `result` to contain the
-// solution.
+// Coalesces the vector of ranges provided in place, leaving it sorted and
+// without overlapping or neighbouring ranges.
 // The algorithm first sorts all the individual intervals so that we can iterate
 // over them sequentially.
 // The algorithm does a single pass, after the sort, and builds up the solution
-// in place. It then modifies the `result` with as few steps as possible. The
-// expensive part of this operation is modification of the protobuf, which is
-// why we prefer to build up the solution in a temporary vector.
-void coalesce(Value::Ranges* result, vector<Range> ranges)
+// in place.
+void coalesce(vector<Range>* ranges)
 {
   // Exit early if empty.
-  if (ranges.empty()) {
-    result->clear_range();
+  if (ranges->empty()) {
     return;
   }
 
   std::sort(
-      ranges.begin(),
-      ranges.end(),
+      ranges->begin(),
+      ranges->end(),
       [](const Range& left, const Range& right) {
         return std::tie(left.start, left.end) <
                std::tie(right.start, right.end);
       });
 
   // We build up initial state of the current range.
-  CHECK(!ranges.empty());
-  int count = 1;
-  Range current = ranges.front();
+  CHECK(!ranges->empty());
+  size_t count = 1;
+  Range current = ranges->front();
 
   // In a single pass, we compute the size of the end result, as well as modify
   // in place the intermediate data structure to build up result as we
   // solve it.
-  foreach (const Range& range, ranges) {
+  foreach (const Range& range, *ranges) {
     // Skip if this range is equivalent to the current range.
     if (range.start == current.start && range.end == current.end) {
       continue;
@@ -193,7 +187,7 @@ void coalesce(Value::Ranges* result, vector<Range> ranges)
         current.end = max(current.end, range.end);
       } else {
         // 2. No overlap and we are adding a new range.
-        ranges[count - 1] = current;
+        (*ranges)[count - 1] = current;
         ++count;
         current = range;
       }
@@ -201,9 +195,21 @@ void coalesce(Value::Ranges* result, vector<Range> ranges)
   }
 
   // Record the state of the last range into of ranges vector.
-  ranges[count - 1] = current;
+  (*ranges)[count - 1] = current;
+
+  CHECK(count <= ranges->size());
+
+  ranges->resize(count);
+}
+
 
-  CHECK(count <= static_cast<int>(ranges.size()));
+// Modifies `result` to contain the given ranges. The expensive part of the
+// range arithmetic is modification of the protobuf, which is why we prefer
+// to build up the solution in a temporary vector and then modify `result`
+// with as few steps as possible.
+void assign(Value::Ranges* result, const vector<Range>& ranges)
+{
+  const int count = static_cast<int>(ranges.size());
 
   // Shrink result if it is too large by deleting trailing subrange.
   if (count < result->range_size()) {
@@ -229,6 +235,46 @@ void coalesce(Value::Ranges* result, vector<Range> ranges)
   CHECK_EQ(result->range_size(), count);
 }
 
+
+// Coalesces the vector of ranges provided and modifies `result` to contain the
+// solution.
+void coalesce(Value::Ranges* result, vector<Range> ranges)
+{
+  coalesce(&ranges);
+  assign(result, ranges);
+}
+
+
+// Returns the given ranges coalesced, see above.
+//
+// NOTE: The result of the range arithmetic is always coalesced, so this
+// does not need to sort the ranges in the common case.
+vector<Range> coalesced(const Value::Ranges& ranges)
+{
+  vector<Range> result;
+  result.reserve(ranges.range_size());
+
+  bool sorted = true;
+  foreach (const Value::Range& range, ranges.range()) {
+    // The ranges are coalesced if each range starts at least two
+    // after the end of the previous range.
+    if (range.begin() > range.end() ||
+        (!result.empty() &&
+         (range.begin() <= result.back().end ||
+          range.begin() - result.back().end < 2))) {
+      sorted = false;
+    }
+
+    result.push_back({range.begin(), range.end()});
+  }
+
+  if (!sorted) {
+    coalesce(&result);
+  }
+
+  return result;
+}
+
 } // namespace internal {
 
 
@@ -295,55 +341,37 @@ ostream& operator<<(ostream& stream, const Value::Ranges& ranges)
 
 bool operator==(const Value::Ranges& _left, const Value::Ranges& _right)
 {
-  Value::Ranges left;
-  coalesce(&left, {_left});
-
-  Value::Ranges right;
-  coalesce(&right, {_right});
-
-  if (left.range_size() == right.range_size()) {
-    for (int i = 0; i < left.range_size(); i++) {
-      // Make sure this range is equal to a range in the right.
-      bool found = false;
-      for (int j = 0; j < right.range_size(); j++) {
-        if (left.range(i).begin() == right.range(j).begin() &&
-            left.range(i).end() == right.range(j).end()) {
-          found = true;
-          break;
-        }
-      }
-
-      if (!found) {
-        return false;
-      }
-    }
-
-    return true;
-  }
-
-  return false;
+  const vector<internal::Range> left = internal::coalesced(_left);
+  const vector<internal::Range> right = internal::coalesced(_right);
+
+  return left.size() == right.size() &&
+         std::equal(
+             left.begin(),
+             left.end(),
+             right.begin(),
+             [](const internal::Range& left, const internal::Range& right) {
+               return left.start == right.start && left.end == right.end;
+             });
 }
 
 
 bool operator<=(const Value::Ranges& _left, const Value::Ranges& _right)
 {
-  Value::Ranges left;
-  coalesce(&left, {_left});
-
-  Value::Ranges right;
-  coalesce(&right, {_right});
-
-  for (int i = 0; i < left.range_size(); i++) {
-    // Make sure this range is a subset of a range in right.
-    bool matched = false;
-    for (int j = 0; j < right.range_size(); j++) {
-      if (left.range(i).begin() >= right.range(j).begin() &&
-          left.range(i).end() <= right.range(j).end()) {
-        matched = true;
-        break;
-      }
+  const vector<internal::Range> left = internal::coalesced(_left);
+  const vector<internal::Range> right = internal::coalesced(_right);
+
+  // Since both are sorted, we make sure that each range is a subset of
+  // a range in right in a single pass over the ranges. Note that a
+  // coalesced range can not be a subset of multiple coalesced ranges.
+  size_t j = 0;
+  foreach (const internal::Range& range, left) {
+    while (j < right.size() && right[j].end < range.start) {
+      ++j;
     }
-    if (!matched) {
+
+    if (j == right.size() ||
+        right[j].start > range.start ||
+        right[j].end < range.end) {
       return false;
     }
   }
@@ -377,11 +405,44 @@ Value::Ranges& operator+=(Value::Ranges& left, const Value::Ranges& right)
 
 Value::Ranges& operator-=(Value::Ranges& _left, const Value::Ranges& _right)
 {
-  IntervalSet<uint64_t> left, right;
+  const vector<internal::Range> left = internal::coalesced(_left);
+  const vector<internal::Range> right = internal::coalesced(_right);
+
+  vector<internal::Range> result;
+  result.reserve(left.size() + right.size());
+
+  // Since both are sorted, we cut the ranges in right out of the ranges
+  // in left in a single pass over the ranges.
+  size_t j = 0;
+  foreach (internal::Range range, left) {
+    // Skip the ranges in right that end before this range.
+    while (j < right.size() && right[j].end < range.start) {
+      ++j;
+    }
+
+    bool subsumed = false;
+
+    // NOTE: A range in right that overlaps the end of this range might
+    // also overlap the next range in left, so `j` is not advanced past it.
+    for (; j < right.size() && right[j].start <= range.end; ++j) {
+      if (right[j].start > range.start) {
+        result.push_back({range.start, right[j].start - 1});
+      }
+
+      if (right[j].end >= range.end) {
+        subsumed = true;
+        break;
+      }
+
+      range.start = right[j].end + 1;
+    }
+
+    if (!subsumed) {
+      result.push_back(range);
+    }
+  }
 
-  left = rangesToIntervalSet<uint64_t>(_left).get();
-  right = rangesToIntervalSet<uint64_t>(_right).get();
-  _left = intervalSetToRanges(left - right);
+  internal::assign(&_left, result);
 
   return _left;
 }
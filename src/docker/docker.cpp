@@ -15,6 +15,7 @@
 // limitations under the License.
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <stout/error.hpp>
@@ -32,8 +33,10 @@
 #include <stout/os/read.hpp>
 #include <stout/os/write.hpp>
 
+#include <process/address.hpp>
 #include <process/check.hpp>
 #include <process/collect.hpp>
+#include <process/http.hpp>
 #include <process/io.hpp>
 
 #include "common/status_utils.hpp"
@@ -54,6 +57,10 @@ using namespace mesos::internal::slave;
 
 using namespace process;
 
+#ifndef __WINDOWS__
+namespace unix = process::network::unix;
+#endif // __WINDOWS__
+
 using std::list;
 using std::map;
 using std::string;
@@ -105,9 +112,14 @@ Try<Owned<Docker>> Docker::create(
     const string& path,
     const string& socket,
     bool validate,
-    const Option<JSON::Object>& config)
+    const Option<JSON::Object>& config,
+    bool engineApi)
 {
-#ifndef __WINDOWS__
+#ifdef __WINDOWS__
+  if (engineApi) {
+    return Error("The Docker Engine API is not supported on Windows");
+  }
+#else
   // TODO(hausdorff): Currently, `path::absolute` does not handle all the edge
   // cases of Windows. Revisit this when MESOS-3442 is resolved.
   //
@@ -120,7 +132,7 @@ Try<Owned<Docker>> Docker::create(
   }
 #endif // __WINDOWS__
 
-  Owned<Docker> docker(new Docker(path, socket, config));
+  Owned<Docker> docker(new Docker(path, socket, config, engineApi));
   if (!validate) {
     return docker;
   }
@@ -1243,6 +1255,13 @@ Future<Docker::Container> Docker::inspect(
 {
   Owned<Promise<Docker::Container>> promise(new Promise<Docker::Container>());
 
+  if (engineApiSocket.isSome()) {
+    _inspectEngine(
+        engineApiSocket.get(), containerName, promise, retryInterval);
+
+    return promise->future();
+  }
+
   const string cmd = path + " -H " + socket + " inspect " + containerName;
   _inspect(cmd, promise, retryInterval);
 
@@ -1373,6 +1392,202 @@ void Docker::___inspect(
 }
 
 
+#ifndef __WINDOWS__
+// Returns a future that becomes ready once the Docker daemon reports
+// through its event stream that the container has started, or after
+// `timeout` has elapsed, whichever comes first. The latter ensures
+// that a start event which was missed, e.g., because the container
+// started before subscribing, only delays the next inspection.
+static Future<Nothing> awaitStart(
+    const unix::Address& address,
+    const string& containerName,
+    const Duration& timeout)
+{
+  struct Subscription
+  {
+    Promise<Nothing> promise;
+    Option<http::Connection> connection;
+  };
+
+  std::shared_ptr<Subscription> subscription =
+    std::make_shared<Subscription>();
+
+  Clock::timer(timeout, [subscription]() {
+    subscription->promise.set(Nothing());
+  });
+
+  http::Request request;
+  request.method = "GET";
+  request.url.domain = "docker";
+  request.url.path = "/events";
+  request.url.query["filters"] =
+    "{\"container\":[\"" + containerName + "\"],\"event\":[\"start\"]}";
+
+  http::connect(address, http::Scheme::HTTP)
+    .then([=](http::Connection connection) -> Future<string> {
+      if (!subscription->promise.future().isPending()) {
+        connection.disconnect();
+        return Failure("No longer waiting for the container to start");
+      }
+
+      subscription->connection = connection;
+
+      return connection.send(request, true)
+        .then([](const http::Response& response) -> Future<string> {
+          if (response.code != http::Status::OK ||
+              response.type != http::Response::PIPE) {
+            return Failure("Unexpected response '" + response.status + "'");
+          }
+
+          CHECK_SOME(response.reader);
+          http::Pipe::Reader reader = response.reader.get();
+
+          // Since the events are filtered, the first event is the start
+          // of the container. An empty read means end-of-file.
+          return reader.read();
+        });
+    })
+    .onReady([subscription](const string& event) {
+      if (!event.empty()) {
+        subscription->promise.set(Nothing());
+      }
+    });
+
+  return subscription->promise.future()
+    .onAny([subscription]() {
+      if (subscription->connection.isSome()) {
+        subscription->connection->disconnect();
+      }
+    });
+}
+#endif // __WINDOWS__
+
+
+void Docker::_inspectEngine(
+    const string& socket,
+    const string& containerName,
+    const Owned<Promise<Docker::Container>>& promise,
+    const Option<Duration>& retryInterval)
+{
+  if (promise->future().hasDiscard()) {
+    promise->discard();
+    return;
+  }
+
+#ifdef __WINDOWS__
+  UNREACHABLE();
+#else
+  Try<unix::Address> address = unix::Address::create(socket);
+  if (address.isError()) {
+    promise->fail(
+        "Invalid Docker socket path '" + socket + "': " + address.error());
+    return;
+  }
+
+  VLOG(1) << "Inspecting container '" << containerName << "' through the"
+          << " Docker Engine API at '" << socket << "'";
+
+  http::Request request;
+  request.method = "GET";
+  request.url.domain = "docker";
+  request.url.path = "/containers/" + containerName + "/json";
+  request.keepAlive = false;
+
+  http::connect(address.get(), http::Scheme::HTTP)
+    .then([request](http::Connection connection) {
+      // This is a non Keep-Alive request which means the connection
+      // will be closed when the response is received. Since the
+      // 'Connection' is reference-counted, we must maintain a copy
+      // until the disconnection occurs.
+      connection.disconnected()
+        .onAny([connection]() {});
+
+      return connection.send(request);
+    })
+    .onAny([=](const Future<http::Response>& response) {
+      __inspectEngine(
+          socket, containerName, promise, retryInterval, response);
+    });
+#endif // __WINDOWS__
+}
+
+
+void Docker::__inspectEngine(
+    const string& socket,
+    const string& containerName,
+    const Owned<Promise<Docker::Container>>& promise,
+    const Option<Duration>& retryInterval,
+    const Future<http::Response>& response)
+{
+  if (promise->future().hasDiscard()) {
+    promise->discard();
+    return;
+  }
+
+  if (!response.isReady()) {
+    promise->fail(
+        "Failed to inspect container '" + containerName + "' through the"
+        " Docker Engine API: " +
+        (response.isFailed() ? response.failure() : "discarded"));
+    return;
+  }
+
+  // Retries the inspection once the container has started, or after
+  // the retry interval at the latest.
+  auto retry = [=]() {
+#ifdef __WINDOWS__
+    UNREACHABLE();
+#else
+    Try<unix::Address> address = unix::Address::create(socket);
+    CHECK_SOME(address);
+
+    awaitStart(address.get(), containerName, retryInterval.get())
+      .onAny([=]() {
+        _inspectEngine(socket, containerName, promise, retryInterval);
+      });
+#endif // __WINDOWS__
+  };
+
+  // Like for a non-zero exit status of 'docker inspect', we retry if
+  // the container is not found (yet).
+  if (response->code != http::Status::OK) {
+    if (retryInterval.isSome()) {
+      VLOG(1) << "Retrying inspect of container '" << containerName << "'"
+              << " with response '" << response->status << "', interval: "
+              << stringify(retryInterval.get());
+      retry();
+      return;
+    }
+
+    promise->fail(
+        "Failed to inspect container '" + containerName + "' through the"
+        " Docker Engine API: " + response->status + "; body='" +
+        response->body + "'");
+    return;
+  }
+
+  // The Engine API returns the container, whereas 'docker inspect'
+  // returns an array of the inspected containers.
+  Try<Docker::Container> container =
+    Docker::Container::create("[" + response->body + "]");
+
+  if (container.isError()) {
+    promise->fail("Unable to create container: " + container.error());
+    return;
+  }
+
+  if (retryInterval.isSome() && !container->started) {
+    VLOG(1) << "Retrying inspect since container '" << containerName << "'"
+            << " not yet started, interval: "
+            << stringify(retryInterval.get());
+    retry();
+    return;
+  }
+
+  promise->set(container.get());
+}
+
+
 Future<list<Docker::Container>> Docker::ps(
     bool all,
     const Option<string>& prefix) const
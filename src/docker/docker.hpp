@@ -22,6 +22,7 @@
 #include <string>
 
 #include <process/future.hpp>
+#include <process/http.hpp>
 #include <process/owned.hpp>
 #include <process/subprocess.hpp>
 
@@ -56,11 +57,17 @@ class Docker
 {
 public:
   // Create Docker abstraction and optionally validate docker.
+  //
+  // If `engineApi` is true, the operations that support it query the
+  // Docker daemon through its Engine API over `socket` rather than by
+  // running the Docker CLI. Currently this is only `inspect`, which
+  // is also used by `ps`, and is not supported on Windows.
   static Try<process::Owned<Docker>> create(
       const std::string& path,
       const std::string& socket,
       bool validate = true,
-      const Option<JSON::Object>& config = None());
+      const Option<JSON::Object>& config = None(),
+      bool engineApi = false);
 
   virtual ~Docker() {}
 
@@ -317,10 +324,12 @@ protected:
   // Uses the specified path to the Docker CLI tool.
   Docker(const std::string& _path,
          const std::string& _socket,
-         const Option<JSON::Object>& _config)
+         const Option<JSON::Object>& _config,
+         bool engineApi = false)
        : path(_path),
          socket(DEFAULT_DOCKER_HOST_PREFIX + _socket),
-         config(_config) {}
+         config(_config),
+         engineApiSocket(engineApi ? Option<std::string>(_socket) : None()) {}
 
 private:
   static process::Future<Version> _version(
@@ -355,6 +364,20 @@ private:
       const Option<Duration>& retryInterval,
       const process::Future<std::string>& output);
 
+  // Inspects the container through the Docker Engine API.
+  static void _inspectEngine(
+      const std::string& socket,
+      const std::string& containerName,
+      const process::Owned<process::Promise<Container>>& promise,
+      const Option<Duration>& retryInterval);
+
+  static void __inspectEngine(
+      const std::string& socket,
+      const std::string& containerName,
+      const process::Owned<process::Promise<Container>>& promise,
+      const Option<Duration>& retryInterval,
+      const process::Future<process::http::Response>& response);
+
   static process::Future<std::list<Container>> _ps(
       const Docker& docker,
       const std::string& cmd,
@@ -414,6 +437,10 @@ private:
   const std::string path;
   const std::string socket;
   const Option<JSON::Object> config;
+
+  // The path of the socket to use the Docker Engine API over, if the
+  // Engine API is used, see `create()`.
+  const Option<std::string> engineApiSocket;
 };
 
 #endif // __DOCKER_HPP__
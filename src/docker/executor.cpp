@@ -913,8 +913,19 @@ int main(int argc, char** argv)
     EXIT(EXIT_FAILURE) << flags.usage("Missing required option --launcher_dir");
   }
 
+  // Like the other Mesos executors, use a lightweight libprocess
+  // runtime unless the operator configured one explicitly.
+  const bool lightweight = os::getenv("LIBPROCESS_LIGHTWEIGHT").isNone();
+  if (lightweight) {
+    os::setenv("LIBPROCESS_LIGHTWEIGHT", "true");
+  }
+
   process::initialize();
 
+  if (lightweight) {
+    os::unsetenv("LIBPROCESS_LIGHTWEIGHT");
+  }
+
   // The 2nd argument for docker create is set to false so we skip
   // validation when creating a docker abstraction, as the slave
   // should have already validated docker.
@@ -22,11 +22,14 @@
 
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/shared_array.hpp>
 
+#include <process/after.hpp>
 #include <process/defer.hpp>
 #include <process/deferred.hpp> // TODO(benh): This is required by Clang.
 #include <process/dispatch.hpp>
@@ -34,9 +37,12 @@
 #include <process/help.hpp>
 #include <process/http.hpp>
 #include <process/io.hpp>
+#include <process/loop.hpp>
 #include <process/mime.hpp>
 #include <process/process.hpp>
+#include <process/timeout.hpp>
 
+#include <stout/duration.hpp>
 #include <stout/error.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/json.hpp>
@@ -75,12 +81,17 @@ using mesos::Authorizer;
 
 using process::AUTHENTICATION;
 using process::AUTHORIZATION;
+using process::Break;
+using process::Continue;
+using process::ControlFlow;
 using process::defer;
 using process::DESCRIPTION;
 using process::Failure;
 using process::Future;
 using process::HELP;
+using process::loop;
 using process::Process;
+using process::Timeout;
 using process::TLDR;
 using process::wait; // Necessary on some OS's to disambiguate.
 
@@ -88,6 +99,7 @@ using process::http::authentication::Principal;
 
 using std::list;
 using std::map;
+using std::pair;
 using std::string;
 using std::tuple;
 using std::vector;
@@ -95,6 +107,11 @@ using std::vector;
 namespace mesos {
 namespace internal {
 
+// The maximum duration a `/files/read` request may wait for data to
+// be appended to a file, and how often the file is checked meanwhile.
+static const Duration MAX_READ_WAIT = Minutes(1);
+static const Duration READ_WAIT_INTERVAL = Milliseconds(100);
+
 class FilesProcess : public Process<FilesProcess>
 {
 public:
@@ -152,6 +169,15 @@ private:
       Option<size_t> length,
       const string& path);
 
+  // Like `read()`, but if the file ends at `offset` it waits for data
+  // to be appended to the file until the `deadline` expires.
+  Future<Try<tuple<size_t, string>, FilesError>> tail(
+      size_t offset,
+      const Option<size_t>& length,
+      const string& path,
+      const Option<Principal>& principal,
+      const Timeout& deadline);
+
   // Reads data from a file at a given offset and for a given length.
   // See the jquery pailer for the expected behavior.
   Future<http::Response> __read(
@@ -165,7 +191,9 @@ private:
       const http::Request& request,
       const Option<Principal>& principal);
 
-  Future<http::Response> _download(const string& path);
+  Future<http::Response> _download(
+      const string& path,
+      const Option<string>& range);
 
   // Returns the internal virtual path mapping.
   Future<http::Response> debug(
@@ -508,7 +536,12 @@ const string FilesProcess::READ_HELP = HELP(
         ">        path=VALUE          The path of directory to browse.",
         ">        offset=VALUE        Value added to base address to obtain "
         "a second address",
-        ">        length=VALUE        Length of file to read."),
+        ">        length=VALUE        Length of file to read.",
+        ">        wait=VALUE          Duration (e.g., `30secs`) to wait for",
+        ">                            data to be appended to the file if",
+        ">                            `offset` is at the end of the file,",
+        ">                            at most one minute. Lets clients tail",
+        ">                            a file without polling it."),
     AUTHENTICATION(true),
     AUTHORIZATION(
         "Reading files requires that the request principal is",
@@ -583,9 +616,28 @@ Future<http::Response> FilesProcess::__read(
     length = 0;
   }
 
+  Option<Duration> wait;
+
+  if (request.url.query.get("wait").isSome()) {
+    Try<Duration> result = Duration::parse(request.url.query.get("wait").get());
+
+    if (result.isError()) {
+      return BadRequest("Failed to parse wait: " + result.error() + ".\n");
+    }
+
+    wait = std::min(result.get(), MAX_READ_WAIT);
+  }
+
   Option<string> jsonp = request.url.query.get("jsonp");
 
-  return read(offset_, length, path.get(), principal)
+  // Only wait for data when reading some, but not for the length of
+  // the file to be determined (see above).
+  Future<Try<tuple<size_t, string>, FilesError>> contents =
+    wait.isSome() && offset != -1 && length != 0
+      ? tail(offset_, length, path.get(), principal, Timeout::in(wait.get()))
+      : read(offset_, length, path.get(), principal);
+
+  return contents
     .then([offset, jsonp](const Try<tuple<size_t, string>, FilesError>& result)
         -> Future<http::Response> {
       if (result.isError()) {
@@ -638,6 +690,46 @@ Future<Try<tuple<size_t, string>, FilesError>> FilesProcess::read(
 }
 
 
+Future<Try<tuple<size_t, string>, FilesError>> FilesProcess::tail(
+    size_t offset,
+    const Option<size_t>& length,
+    const string& path,
+    const Option<Principal>& principal,
+    const Timeout& deadline)
+{
+  return authorize(path, principal)
+    .then(defer(self(),
+        [=](bool authorized)
+          -> Future<Try<tuple<size_t, string>, FilesError>> {
+      if (!authorized) {
+        return FilesError(FilesError::Type::UNAUTHORIZED);
+      }
+
+      typedef Try<tuple<size_t, string>, FilesError> Contents;
+
+      // NOTE: We poll the file rather than watching it for changes, since
+      // doing so is a lot cheaper than clients polling the endpoint.
+      return loop(
+          self(),
+          [=]() { return _read(offset, length, path); },
+          [=](const Contents& contents) -> Future<ControlFlow<Contents>> {
+            // Keep waiting only while the file ends at the offset, e.g.,
+            // not if it got truncated.
+            if (contents.isError() ||
+                std::get<0>(contents.get()) != offset ||
+                deadline.expired()) {
+              ControlFlow<Contents> flow = Break(contents);
+              return flow;
+            }
+
+            return process::after(
+                std::min(READ_WAIT_INTERVAL, deadline.remaining()))
+              .then([]() -> ControlFlow<Contents> { return Continue(); });
+          });
+    }));
+}
+
+
 Future<Try<tuple<size_t, string>, FilesError>> FilesProcess::_read(
     size_t offset,
     Option<size_t> length,
@@ -741,6 +833,10 @@ const string FilesProcess::DOWNLOAD_HELP = HELP(
         "This endpoint will return the raw file contents for the",
         "given path.",
         "",
+        "A single byte range of the file can be requested with a `Range`",
+        "header, e.g., `Range: bytes=1024-`, which is returned in a",
+        "`206 Partial Content` response.",
+        "",
         "Query parameters:",
         "",
         ">        path=VALUE          The path of directory to browse."),
@@ -768,11 +864,13 @@ Future<http::Response> FilesProcess::download(
 
   string requestedPath = path.get();
 
+  Option<string> range = request.headers.get("Range");
+
   return authorize(requestedPath, principal)
     .then(defer(self(),
-        [this, path](bool authorized) -> Future<http::Response> {
+        [this, path, range](bool authorized) -> Future<http::Response> {
       if (authorized) {
-        return _download(path.get());
+        return _download(path.get(), range);
       }
 
       return Forbidden();
@@ -780,7 +878,68 @@ Future<http::Response> FilesProcess::download(
 }
 
 
-Future<http::Response> FilesProcess::_download(const string& path)
+// Parses the value of a `Range` header (see RFC 7233) into the first
+// and last byte of the range, for a file of the given size. Returns
+// None if the header is not a single byte range, in which case it is
+// ignored, and an error if the range cannot be satisfied.
+static Result<pair<off_t, off_t>> parseRange(const string& range, off_t size)
+{
+  const string bytes = "bytes=";
+
+  const string value = strings::trim(range);
+  if (!strings::startsWith(value, bytes) ||
+      strings::contains(value, ",")) {
+    return None();
+  }
+
+  const vector<string> tokens =
+    strings::split(strings::trim(value.substr(bytes.size())), "-");
+
+  if (tokens.size() != 2 || (tokens[0].empty() && tokens[1].empty())) {
+    return None();
+  }
+
+  // A suffix range, i.e., the last bytes of the file.
+  if (tokens[0].empty()) {
+    Try<off_t> length = numify<off_t>(tokens[1]);
+    if (length.isError()) {
+      return None();
+    }
+
+    if (length.get() == 0 || size == 0) {
+      return Error("Empty range");
+    }
+
+    return std::make_pair(std::max<off_t>(0, size - length.get()), size - 1);
+  }
+
+  Try<off_t> first = numify<off_t>(tokens[0]);
+  if (first.isError()) {
+    return None();
+  }
+
+  off_t last = size - 1;
+
+  if (!tokens[1].empty()) {
+    Try<off_t> last_ = numify<off_t>(tokens[1]);
+    if (last_.isError() || last_.get() < first.get()) {
+      return None();
+    }
+
+    last = std::min(last, last_.get());
+  }
+
+  if (first.get() >= size) {
+    return Error("Range starts beyond the end of the file");
+  }
+
+  return std::make_pair(first.get(), last);
+}
+
+
+Future<http::Response> FilesProcess::_download(
+    const string& path,
+    const Option<string>& range)
 {
   Result<string> resolvedPath = resolve(path);
 
@@ -803,6 +962,7 @@ Future<http::Response> FilesProcess::_download(const string& path)
   response.headers["Content-Type"] = "application/octet-stream";
   response.headers["Content-Disposition"] =
     strings::format("attachment; filename=%s", basename).get();
+  response.headers["Accept-Ranges"] = "bytes";
 
   // Attempt to detect the mime type.
   Option<string> extension = Path(resolvedPath.get()).extension();
@@ -811,6 +971,124 @@ Future<http::Response> FilesProcess::_download(const string& path)
     response.headers["Content-Type"] = mime::types[extension.get()];
   }
 
+  if (range.isNone()) {
+    return response;
+  }
+
+  Try<int_fd> fd = os::open(resolvedPath.get(), O_RDONLY | O_CLOEXEC);
+  if (fd.isError()) {
+    string error = strings::format(
+        "Failed to open file at '%s': %s",
+        resolvedPath.get(),
+        fd.error()).get();
+    LOG(WARNING) << error;
+    return InternalServerError(error + ".\n");
+  }
+
+  Try<off_t> size = os::lseek(fd.get(), 0, SEEK_END);
+  if (size.isError()) {
+    string error = strings::format(
+        "Failed to seek file at '%s': %s",
+        resolvedPath.get(),
+        size.error()).get();
+    LOG(WARNING) << error;
+    os::close(fd.get());
+    return InternalServerError(error + ".\n");
+  }
+
+  Result<pair<off_t, off_t>> bytes = parseRange(range.get(), size.get());
+
+  if (bytes.isNone()) {
+    os::close(fd.get());
+    return response;
+  }
+
+  if (bytes.isError()) {
+    os::close(fd.get());
+
+    http::Response unsatisfiable(
+        bytes.error() + ".\n",
+        http::Status::REQUESTED_RANGE_NOT_SATISFIABLE);
+    unsatisfiable.headers["Content-Range"] = "bytes */" + stringify(size.get());
+    return unsatisfiable;
+  }
+
+  Try<off_t> lseek = os::lseek(fd.get(), bytes->first, SEEK_SET);
+  if (lseek.isError()) {
+    string error = strings::format(
+        "Failed to seek file at '%s': %s",
+        resolvedPath.get(),
+        lseek.error()).get();
+    LOG(WARNING) << error;
+    os::close(fd.get());
+    return InternalServerError(error + ".\n");
+  }
+
+  Try<Nothing> nonblock = os::nonblock(fd.get());
+  if (nonblock.isError()) {
+    string error =
+      "Failed to set file descriptor nonblocking: " + nonblock.error();
+    LOG(WARNING) << error;
+    os::close(fd.get());
+    return InternalServerError(error + ".\n");
+  }
+
+  // Stream the range of the file rather than reading it into memory.
+  // NOTE: Pipes do not apply backpressure, so the range is read as
+  // fast as the disk allows rather than as fast as the client reads.
+  http::Pipe pipe;
+  http::Pipe::Writer writer = pipe.writer();
+
+  response.code = http::Status::PARTIAL_CONTENT;
+  response.status = http::Status::string(response.code);
+  response.type = response.PIPE;
+  response.path.clear();
+  response.reader = pipe.reader();
+  response.headers["Content-Range"] = strings::format(
+      "bytes %lld-%lld/%lld",
+      static_cast<long long>(bytes->first),
+      static_cast<long long>(bytes->second),
+      static_cast<long long>(size.get())).get();
+
+  const size_t chunk = os::pagesize() * 16;
+
+  boost::shared_array<char> data(new char[chunk]);
+  std::shared_ptr<size_t> remaining(
+      new size_t(bytes->second - bytes->first + 1));
+
+  int_fd fd_ = fd.get();
+
+  loop(
+      None(),
+      [=]() {
+        return io::read(fd_, data.get(), std::min(*remaining, chunk));
+      },
+      [=](size_t length) mutable -> ControlFlow<Nothing> {
+        // The file got truncated while being read.
+        if (length == 0) {
+          writer.fail("Unexpected end of file");
+          return Break();
+        }
+
+        // Stop reading if the client has gone away.
+        if (!writer.write(string(data.get(), length))) {
+          return Break();
+        }
+
+        *remaining -= length;
+
+        if (*remaining == 0) {
+          writer.close();
+          return Break();
+        }
+
+        return Continue();
+      })
+    .onAny([fd_]() { os::close(fd_); })
+    .onFailed([writer](const string& message) mutable {
+      writer.fail(message);
+    });
+
   return response;
 }
 
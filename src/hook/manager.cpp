@@ -17,6 +17,7 @@
 #include <list>
 #include <mutex>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <mesos/hook.hpp>
@@ -26,8 +27,13 @@
 #include <process/collect.hpp>
 #include <process/future.hpp>
 
+#include <process/metrics/metrics.hpp>
+#include <process/metrics/timer.hpp>
+
 #include <stout/check.hpp>
+#include <stout/duration.hpp>
 #include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
 #include <stout/linkedhashmap.hpp>
 #include <stout/nothing.hpp>
 #include <stout/strings.hpp>
@@ -44,14 +50,69 @@ using std::vector;
 using process::collect;
 using process::Future;
 
+using process::metrics::Timer;
+
 using mesos::modules::ModuleManager;
 
 namespace mesos {
 namespace internal {
 
+// Invocations of hooks taking longer than this are logged, since hooks
+// run synchronously on the actor of the master or agent calling them.
+constexpr Duration SLOW_HOOK_THRESHOLD = Seconds(1);
+
 static std::mutex mutex;
 static LinkedHashMap<string, Hook*> availableHooks;
 
+// The timers of the invocations of each hook of each hook module,
+// keyed by the name of the module and then of the hook.
+static hashmap<string, hashmap<string, Timer<Milliseconds>>> timers;
+
+
+// Returns the timer of the hook `hook` of the hook module `name`,
+// i.e., the `hooks/<name>/<hook>_ms` metric.
+//
+// NOTE: The `mutex` must be held.
+static Timer<Milliseconds>& timer(const string& name, const string& hook)
+{
+  hashmap<string, Timer<Milliseconds>>& hooks = timers[name];
+
+  if (!hooks.contains(hook)) {
+    Timer<Milliseconds> timer("hooks/" + name + "/" + hook);
+    process::metrics::add(timer);
+
+    hooks.put(hook, timer);
+  }
+
+  return hooks.at(hook);
+}
+
+
+// Invokes the hook `hook` of the hook module `name` through `f`, and
+// records how long it took.
+//
+// NOTE: The `mutex` must be held.
+template <typename F>
+static typename std::result_of<F()>::type invoke(
+    const string& name,
+    const string& hook,
+    F&& f)
+{
+  Timer<Milliseconds>& timer_ = timer(name, hook);
+
+  timer_.start();
+
+  typename std::result_of<F()>::type result = f();
+
+  const Milliseconds elapsed = timer_.stop();
+  if (elapsed > SLOW_HOOK_THRESHOLD) {
+    LOG(WARNING) << "Hook '" << hook << "' of module '" << name
+                 << "' took " << elapsed;
+  }
+
+  return result;
+}
+
 
 Try<Nothing> HookManager::initialize(const string& hookList)
 {
@@ -93,6 +154,14 @@ Try<Nothing> HookManager::unload(const string& hookName)
 
     // Now remove the hook from the list of available hooks.
     availableHooks.erase(hookName);
+
+    if (timers.contains(hookName)) {
+      foreachvalue (const Timer<Milliseconds>& timer, timers.at(hookName)) {
+        process::metrics::remove(timer);
+      }
+
+      timers.erase(hookName);
+    }
   }
 
   return Nothing();
@@ -107,48 +176,123 @@ bool HookManager::hooksAvailable()
 }
 
 
+// Applies the label decorators of the hook modules to `taskInfo`.
+//
+// NOTE: The `mutex` must be held.
+static Labels _masterLaunchTaskLabelDecorator(
+    const TaskInfo& taskInfo,
+    const FrameworkInfo& frameworkInfo,
+    const SlaveInfo& slaveInfo)
+{
+  // We need a mutable copy of the task info and set the new
+  // labels after each hook invocation. Otherwise, the last hook
+  // will be the only effective hook setting the labels.
+  TaskInfo taskInfo_ = taskInfo;
+
+  foreachpair (const string& name, Hook* hook, availableHooks) {
+    const Result<Labels> result = invoke(
+        name,
+        "master_launch_task_label_decorator",
+        [&]() {
+          return hook->masterLaunchTaskLabelDecorator(
+              taskInfo_,
+              frameworkInfo,
+              slaveInfo);
+        });
+
+    // NOTE: If the hook returns None(), the task labels won't be
+    // changed.
+    if (result.isSome()) {
+      taskInfo_.mutable_labels()->CopyFrom(result.get());
+    } else if (result.isError()) {
+      LOG(WARNING) << "Master label decorator hook failed for module '"
+                  << name << "': " << result.error();
+    }
+  }
+
+  return taskInfo_.labels();
+}
+
+
 Labels HookManager::masterLaunchTaskLabelDecorator(
     const TaskInfo& taskInfo,
     const FrameworkInfo& frameworkInfo,
     const SlaveInfo& slaveInfo)
 {
   synchronized (mutex) {
-    // We need a mutable copy of the task info and set the new
-    // labels after each hook invocation. Otherwise, the last hook
-    // will be the only effective hook setting the labels.
-    TaskInfo taskInfo_ = taskInfo;
+    return _masterLaunchTaskLabelDecorator(
+        taskInfo, frameworkInfo, slaveInfo);
+  }
+}
+
+
+vector<Labels> HookManager::masterLaunchTaskLabelDecorator(
+    const vector<TaskInfo>& taskInfos,
+    const FrameworkInfo& frameworkInfo,
+    const SlaveInfo& slaveInfo)
+{
+  vector<Labels> labels;
+  labels.reserve(taskInfos.size());
+
+  synchronized (mutex) {
+    foreach (const TaskInfo& taskInfo, taskInfos) {
+      labels.push_back(_masterLaunchTaskLabelDecorator(
+          taskInfo, frameworkInfo, slaveInfo));
+    }
+  }
+
+  return labels;
+}
 
+
+void HookManager::masterSlaveLostHook(const SlaveInfo& slaveInfo)
+{
+  synchronized (mutex) {
     foreachpair (const string& name, Hook* hook, availableHooks) {
-      const Result<Labels> result =
-        hook->masterLaunchTaskLabelDecorator(
-            taskInfo_,
-            frameworkInfo,
-            slaveInfo);
+      Try<Nothing> result = invoke(name, "master_slave_lost_hook", [&]() {
+        return hook->masterSlaveLostHook(slaveInfo);
+      });
 
-      // NOTE: If the hook returns None(), the task labels won't be
-      // changed.
-      if (result.isSome()) {
-        taskInfo_.mutable_labels()->CopyFrom(result.get());
-      } else if (result.isError()) {
-        LOG(WARNING) << "Master label decorator hook failed for module '"
-                    << name << "': " << result.error();
+      if (result.isError()) {
+        LOG(WARNING) << "Master agent-lost hook failed for module '"
+                     << name << "': " << result.error();
       }
     }
-
-    return taskInfo_.labels();
   }
 }
 
 
-void HookManager::masterSlaveLostHook(const SlaveInfo& slaveInfo)
+// Applies the label decorators of the hook modules to `taskInfo`.
+//
+// NOTE: The `mutex` must be held.
+static Labels _slaveRunTaskLabelDecorator(
+    const TaskInfo& taskInfo,
+    const ExecutorInfo& executorInfo,
+    const FrameworkInfo& frameworkInfo,
+    const SlaveInfo& slaveInfo)
 {
+  TaskInfo taskInfo_ = taskInfo;
+
   foreachpair (const string& name, Hook* hook, availableHooks) {
-    Try<Nothing> result = hook->masterSlaveLostHook(slaveInfo);
-    if (result.isError()) {
-      LOG(WARNING) << "Master agent-lost hook failed for module '"
-                   << name << "': " << result.error();
+    const Result<Labels> result = invoke(
+        name,
+        "slave_run_task_label_decorator",
+        [&]() {
+          return hook->slaveRunTaskLabelDecorator(
+              taskInfo_, executorInfo, frameworkInfo, slaveInfo);
+        });
+
+    // NOTE: If the hook returns None(), the task labels won't be
+    // changed.
+    if (result.isSome()) {
+      taskInfo_.mutable_labels()->CopyFrom(result.get());
+    } else if (result.isError()) {
+      LOG(WARNING) << "Agent label decorator hook failed for module '"
+                  << name << "': " << result.error();
     }
   }
+
+  return taskInfo_.labels();
 }
 
 
@@ -159,24 +303,29 @@ Labels HookManager::slaveRunTaskLabelDecorator(
     const SlaveInfo& slaveInfo)
 {
   synchronized (mutex) {
-    TaskInfo taskInfo_ = taskInfo;
+    return _slaveRunTaskLabelDecorator(
+        taskInfo, executorInfo, frameworkInfo, slaveInfo);
+  }
+}
 
-    foreachpair (const string& name, Hook* hook, availableHooks) {
-      const Result<Labels> result = hook->slaveRunTaskLabelDecorator(
-          taskInfo_, executorInfo, frameworkInfo, slaveInfo);
 
-      // NOTE: If the hook returns None(), the task labels won't be
-      // changed.
-      if (result.isSome()) {
-        taskInfo_.mutable_labels()->CopyFrom(result.get());
-      } else if (result.isError()) {
-        LOG(WARNING) << "Agent label decorator hook failed for module '"
-                    << name << "': " << result.error();
-      }
-    }
+vector<Labels> HookManager::slaveRunTaskLabelDecorator(
+    const vector<TaskInfo>& taskInfos,
+    const ExecutorInfo& executorInfo,
+    const FrameworkInfo& frameworkInfo,
+    const SlaveInfo& slaveInfo)
+{
+  vector<Labels> labels;
+  labels.reserve(taskInfos.size());
 
-    return taskInfo_.labels();
+  synchronized (mutex) {
+    foreach (const TaskInfo& taskInfo, taskInfos) {
+      labels.push_back(_slaveRunTaskLabelDecorator(
+          taskInfo, executorInfo, frameworkInfo, slaveInfo));
+    }
   }
+
+  return labels;
 }
 
 
@@ -185,8 +334,12 @@ Environment HookManager::slaveExecutorEnvironmentDecorator(
 {
   synchronized (mutex) {
     foreachpair (const string& name, Hook* hook, availableHooks) {
-      const Result<Environment> result =
-        hook->slaveExecutorEnvironmentDecorator(executorInfo);
+      const Result<Environment> result = invoke(
+          name,
+          "slave_executor_environment_decorator",
+          [&]() {
+            return hook->slaveExecutorEnvironmentDecorator(executorInfo);
+          });
 
       // NOTE: If the hook returns None(), the environment won't be
       // changed.
@@ -218,16 +371,19 @@ Future<DockerTaskExecutorPrepareInfo>
   // (the last hook takes priority).
   list<Future<Option<DockerTaskExecutorPrepareInfo>>> futures;
 
-  foreachvalue (Hook* hook, availableHooks) {
-    // Chain together each hook.
-    futures.push_back(
-        hook->slavePreLaunchDockerTaskExecutorDecorator(
-            taskInfo,
-            executorInfo,
-            containerName,
-            containerWorkDirectory,
-            mappedSandboxDirectory,
-            env));
+  synchronized (mutex) {
+    foreachpair (const string& name, Hook* hook, availableHooks) {
+      // Chain together each hook.
+      futures.push_back(
+          timer(name, "slave_pre_launch_docker_task_executor_decorator").time(
+              hook->slavePreLaunchDockerTaskExecutorDecorator(
+                  taskInfo,
+                  executorInfo,
+                  containerName,
+                  containerWorkDirectory,
+                  mappedSandboxDirectory,
+                  env)));
+    }
   }
 
   return collect(futures)
@@ -250,11 +406,16 @@ void HookManager::slavePostFetchHook(
     const ContainerID& containerId,
     const string& directory)
 {
-  foreachpair (const string& name, Hook* hook, availableHooks) {
-    Try<Nothing> result = hook->slavePostFetchHook(containerId, directory);
-    if (result.isError()) {
-      LOG(WARNING) << "Agent post fetch hook failed for module "
-                   << "'" << name << "': " << result.error();
+  synchronized (mutex) {
+    foreachpair (const string& name, Hook* hook, availableHooks) {
+      Try<Nothing> result = invoke(name, "slave_post_fetch_hook", [&]() {
+        return hook->slavePostFetchHook(containerId, directory);
+      });
+
+      if (result.isError()) {
+        LOG(WARNING) << "Agent post fetch hook failed for module "
+                     << "'" << name << "': " << result.error();
+      }
     }
   }
 }
@@ -264,12 +425,17 @@ void HookManager::slaveRemoveExecutorHook(
     const FrameworkInfo& frameworkInfo,
     const ExecutorInfo& executorInfo)
 {
-  foreachpair (const string& name, Hook* hook, availableHooks) {
-    const Try<Nothing> result =
-      hook->slaveRemoveExecutorHook(frameworkInfo, executorInfo);
-    if (result.isError()) {
-      LOG(WARNING) << "Agent remove executor hook failed for module '"
-                   << name << "': " << result.error();
+  synchronized (mutex) {
+    foreachpair (const string& name, Hook* hook, availableHooks) {
+      const Try<Nothing> result =
+        invoke(name, "slave_remove_executor_hook", [&]() {
+          return hook->slaveRemoveExecutorHook(frameworkInfo, executorInfo);
+        });
+
+      if (result.isError()) {
+        LOG(WARNING) << "Agent remove executor hook failed for module '"
+                     << name << "': " << result.error();
+      }
     }
   }
 }
@@ -282,7 +448,9 @@ TaskStatus HookManager::slaveTaskStatusDecorator(
   synchronized (mutex) {
     foreachpair (const string& name, Hook* hook, availableHooks) {
       const Result<TaskStatus> result =
-        hook->slaveTaskStatusDecorator(frameworkId, status);
+        invoke(name, "slave_task_status_decorator", [&]() {
+          return hook->slaveTaskStatusDecorator(frameworkId, status);
+        });
 
       // NOTE: Labels/ContainerStatus remain unchanged if the hook returns
       // None().
@@ -318,7 +486,9 @@ Resources HookManager::slaveResourcesDecorator(
   synchronized (mutex) {
     foreachpair (const string& name, Hook* hook, availableHooks) {
       const Result<Resources> result =
-        hook->slaveResourcesDecorator(slaveInfo_);
+        invoke(name, "slave_resources_decorator", [&]() {
+          return hook->slaveResourcesDecorator(slaveInfo_);
+        });
 
       // NOTE: Resources remain unchanged if the hook returns None().
       if (result.isSome()) {
@@ -346,7 +516,9 @@ Attributes HookManager::slaveAttributesDecorator(
   synchronized (mutex) {
     foreachpair (const string& name, Hook* hook, availableHooks) {
       const Result<Attributes> result =
-        hook->slaveAttributesDecorator(slaveInfo_);
+        invoke(name, "slave_attributes_decorator", [&]() {
+          return hook->slaveAttributesDecorator(slaveInfo_);
+        });
 
       // NOTE: Attributes remain unchanged if the hook returns None().
       if (result.isSome()) {
@@ -18,6 +18,7 @@
 #define __HOOK_MANAGER_HPP__
 
 #include <string>
+#include <vector>
 
 #include <mesos/mesos.hpp>
 #include <mesos/hook.hpp>
@@ -45,6 +46,14 @@ public:
       const FrameworkInfo& frameworkInfo,
       const SlaveInfo& slaveInfo);
 
+  // Decorates the labels of all the tasks of a task group at once, so
+  // that the hook modules are entered just once for the whole group.
+  // The returned labels are in the order of `taskInfos`.
+  static std::vector<Labels> masterLaunchTaskLabelDecorator(
+      const std::vector<TaskInfo>& taskInfos,
+      const FrameworkInfo& frameworkInfo,
+      const SlaveInfo& slaveInfo);
+
   static void masterSlaveLostHook(const SlaveInfo& slaveInfo);
 
   static Labels slaveRunTaskLabelDecorator(
@@ -53,6 +62,13 @@ public:
       const FrameworkInfo& frameworkInfo,
       const SlaveInfo& slaveInfo);
 
+  // See the batched `masterLaunchTaskLabelDecorator` above.
+  static std::vector<Labels> slaveRunTaskLabelDecorator(
+      const std::vector<TaskInfo>& taskInfos,
+      const ExecutorInfo& executorInfo,
+      const FrameworkInfo& frameworkInfo,
+      const SlaveInfo& slaveInfo);
+
   static Environment slaveExecutorEnvironmentDecorator(
       ExecutorInfo executorInfo);
 
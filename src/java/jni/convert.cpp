@@ -17,12 +17,16 @@
 #include <jni.h>
 
 #include <string>
+#include <vector>
 #include <assert.h>
 
+#include <google/protobuf/message.h>
+
 #include <mesos/mesos.hpp>
 
 #include <mesos/v1/scheduler/scheduler.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/result.hpp>
 #include <stout/strings.hpp>
 
@@ -36,6 +40,7 @@
 using namespace mesos;
 
 using std::string;
+using std::vector;
 
 // Facilities for loading Mesos-related classes with the correct
 // ClassLoader. Unfortunately, JNI's FindClass uses the system
@@ -106,6 +111,33 @@ jclass FindMesosClass(JNIEnv* env, const char* className)
   return cls;
 }
 
+
+// Serializes the message straight into a new Java byte array, rather
+// than into a string which then gets copied into the array.
+jbyteArray serialize(JNIEnv* env, const google::protobuf::Message& message)
+{
+  const size_t size = message.ByteSizeLong();
+
+  // byte[] data = ..;
+  jbyteArray jdata = env->NewByteArray(size);
+  if (jdata == nullptr) {
+    return nullptr; // An OutOfMemoryError is pending.
+  }
+
+  // NOTE: No JNI function may be called until the array is released.
+  void* data = env->GetPrimitiveArrayCritical(jdata, nullptr);
+  if (data == nullptr) {
+    return nullptr;
+  }
+
+  message.SerializeWithCachedSizesToArray(
+      reinterpret_cast<google::protobuf::uint8*>(data));
+
+  env->ReleasePrimitiveArrayCritical(jdata, data, 0);
+
+  return jdata;
+}
+
 } // namespace {
 
 
@@ -407,12 +439,7 @@ jobject convert(JNIEnv* env, const TaskInfo& task)
 template <>
 jobject convert(JNIEnv* env, const TaskStatus& status)
 {
-  string data;
-  status.SerializeToString(&data);
-
-  // byte[] data = ..;
-  jbyteArray jdata = env->NewByteArray(data.size());
-  env->SetByteArrayRegion(jdata, 0, data.size(), (jbyte*) data.data());
+  jbyteArray jdata = serialize(env, status);
 
   // TaskStatus status = TaskStatus.parseFrom(data);
   jclass clazz = FindMesosClass(env, "org/apache/mesos/Protos$TaskStatus");
@@ -430,12 +457,7 @@ jobject convert(JNIEnv* env, const TaskStatus& status)
 template <>
 jobject convert(JNIEnv* env, const Offer& offer)
 {
-  string data;
-  offer.SerializeToString(&data);
-
-  // byte[] data = ..;
-  jbyteArray jdata = env->NewByteArray(data.size());
-  env->SetByteArrayRegion(jdata, 0, data.size(), (jbyte*) data.data());
+  jbyteArray jdata = serialize(env, offer);
 
   // Offer offer = Offer.parseFrom(data);
   jclass clazz = FindMesosClass(env, "org/apache/mesos/Protos$Offer");
@@ -450,6 +472,42 @@ jobject convert(JNIEnv* env, const Offer& offer)
 }
 
 
+template <>
+jobject convert(JNIEnv* env, const vector<Offer>& offers)
+{
+  // List offers = new ArrayList(offers.size());
+  jclass clazz = env->FindClass("java/util/ArrayList");
+
+  jmethodID _init_ = env->GetMethodID(clazz, "<init>", "(I)V");
+  jobject joffers = env->NewObject(clazz, _init_, (jint) offers.size());
+
+  jmethodID add = env->GetMethodID(clazz, "add", "(Ljava/lang/Object;)Z");
+
+  // The class and its 'parseFrom' method are looked up once for all
+  // the offers, rather than for each of them as 'convert<Offer>' does.
+  clazz = FindMesosClass(env, "org/apache/mesos/Protos$Offer");
+
+  jmethodID parseFrom =
+    env->GetStaticMethodID(clazz, "parseFrom",
+                           "([B)Lorg/apache/mesos/Protos$Offer;");
+
+  foreach (const Offer& offer, offers) {
+    jbyteArray jdata = serialize(env, offer);
+
+    // offers.add(Offer.parseFrom(data));
+    jobject joffer = env->CallStaticObjectMethod(clazz, parseFrom, jdata);
+    env->CallBooleanMethod(joffers, add, joffer);
+
+    // Only the list is returned, so release the local references of
+    // each offer instead of piling them up until the callback returns.
+    env->DeleteLocalRef(joffer);
+    env->DeleteLocalRef(jdata);
+  }
+
+  return joffers;
+}
+
+
 template <>
 jobject convert(JNIEnv* env, const ExecutorInfo& executor)
 {
@@ -493,12 +551,7 @@ jobject convert(JNIEnv* env, const Status& status)
 template <>
 jobject convert(JNIEnv* env, const v1::scheduler::Event& event)
 {
-  string data;
-  event.SerializeToString(&data);
-
-  // byte[] data = ..;
-  jbyteArray jdata = env->NewByteArray(data.size());
-  env->SetByteArrayRegion(jdata, 0, data.size(), (jbyte*) data.data());
+  jbyteArray jdata = serialize(env, event);
 
   // Event event = Event.parseFrom(data);
   jclass clazz =
@@ -200,19 +200,7 @@ void JNIScheduler::resourceOffers(SchedulerDriver* driver,
 		     "(Lorg/apache/mesos/SchedulerDriver;"
 		     "Ljava/util/List;)V");
 
-  // List offers = new ArrayList();
-  clazz = env->FindClass("java/util/ArrayList");
-
-  jmethodID _init_ = env->GetMethodID(clazz, "<init>", "()V");
-  jobject joffers = env->NewObject(clazz, _init_);
-
-  jmethodID add = env->GetMethodID(clazz, "add", "(Ljava/lang/Object;)Z");
-
-  // Loop through C++ vector and add each offer to the Java list.
-  foreach (const Offer& offer, offers) {
-    jobject joffer = convert<Offer>(env, offer);
-    env->CallBooleanMethod(joffers, add, joffer);
-  }
+  jobject joffers = convert<vector<Offer>>(env, offers);
 
   env->ExceptionClear();
 
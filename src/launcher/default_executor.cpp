@@ -41,6 +41,7 @@
 #include <stout/linkedhashmap.hpp>
 #include <stout/option.hpp>
 #include <stout/os.hpp>
+#include <stout/result.hpp>
 #include <stout/uuid.hpp>
 
 #include "checks/checker.hpp"
@@ -48,6 +49,7 @@
 
 #include "common/http.hpp"
 #include "common/protobuf_utils.hpp"
+#include "common/recordio.hpp"
 #include "common/status_utils.hpp"
 
 #include "internal/devolve.hpp"
@@ -103,9 +105,11 @@ private:
     // Health checker for the container.
     Option<Owned<checks::HealthChecker>> healthChecker;
 
-    // Connection used for waiting on the child container. It is possible
-    // that a container is active but a connection for sending the
-    // `WAIT_NESTED_CONTAINER` call has not been established yet.
+    // Connection used for waiting on the child container, shared with
+    // the other child containers waited upon by the same
+    // `WATCH_NESTED_CONTAINERS` call. It is possible that a container is
+    // active but a connection for sending the call has not been
+    // established yet.
     Option<Connection> waiting;
 
     // TODO(bennoe): Create a real state machine instead of adding
@@ -132,7 +136,8 @@ public:
       const ::URL& _agent,
       const string& _sandboxDirectory,
       const string& _launcherDirectory,
-      const Option<string>& _authorizationHeader)
+      const Option<string>& _authorizationHeader,
+      bool _persistentCommandChecks)
     : ProcessBase(process::ID::generate("default-executor")),
       state(DISCONNECTED),
       contentType(ContentType::PROTOBUF),
@@ -146,7 +151,8 @@ public:
       agent(_agent),
       sandboxDirectory(_sandboxDirectory),
       launcherDirectory(_launcherDirectory),
-      authorizationHeader(_authorizationHeader) {}
+      authorizationHeader(_authorizationHeader),
+      persistentCommandChecks(_persistentCommandChecks) {}
 
   virtual ~DefaultExecutor() = default;
 
@@ -402,7 +408,11 @@ protected:
     LOG(INFO) << "Setting 'MESOS_CONTAINER_IP' to: " << containerIP.value();
 
     list<ContainerID> containerIds;
-    list<Future<Response>> responses;
+
+    // The containers of all the tasks are launched with a single call,
+    // so that the agent launches them concurrently.
+    agent::Call call;
+    call.set_type(agent::Call::LAUNCH_NESTED_CONTAINERS);
 
     foreach (const TaskInfo& task, taskGroup.tasks()) {
       ContainerID containerId;
@@ -428,11 +438,8 @@ protected:
       const TaskStatus status = createTaskStatus(task.task_id(), TASK_STARTING);
       forward(status);
 
-      agent::Call call;
-      call.set_type(agent::Call::LAUNCH_NESTED_CONTAINER);
-
       agent::Call::LaunchNestedContainer* launch =
-        call.mutable_launch_nested_container();
+        call.mutable_launch_nested_containers()->add_containers();
 
       launch->mutable_container_id()->CopyFrom(containerId);
 
@@ -485,11 +492,9 @@ protected:
       // in the Mesos CNI and default-executor documentation.
       CommandInfo *command = launch->mutable_command();
       command->mutable_environment()->add_variables()->CopyFrom(containerIP);
-
-      responses.push_back(post(connection.get(), call));
     }
 
-    process::collect(responses)
+    post(connection.get(), call)
       .onAny(defer(self(),
                    &Self::__launchGroup,
                    taskGroup,
@@ -502,7 +507,7 @@ protected:
       const TaskGroupInfo& taskGroup,
       const list<ContainerID>& containerIds,
       const Connection& connection,
-      const Future<list<Response>>& responses)
+      const Future<Response>& response)
   {
     if (shuttingDown) {
       LOG(WARNING) << "Ignoring the launch operation as the "
@@ -513,24 +518,22 @@ protected:
     // This could happen if the agent process failed while the child
     // containers were being launched. Shutdown the executor if this
     // happens.
-    if (!responses.isReady()) {
+    if (!response.isReady()) {
       LOG(ERROR) << "Unable to receive a response from the agent for "
-                 << "the LAUNCH_NESTED_CONTAINER call: "
-                 << (responses.isFailed() ? responses.failure() : "discarded");
+                 << "the LAUNCH_NESTED_CONTAINERS call: "
+                 << (response.isFailed() ? response.failure() : "discarded");
       _shutdown();
       return;
     }
 
-    // Check if we received a 200 OK response for all the
-    // `LAUNCH_NESTED_CONTAINER` calls. Shutdown the executor
-    // if this is not the case.
-    foreach (const Response& response, responses.get()) {
-      if (response.code != process::http::Status::OK) {
-        LOG(ERROR) << "Received '" << response.status << "' ("
-                   << response.body << ") while launching child container";
-        _shutdown();
-        return;
-      }
+    // Check if we received a 200 OK response, i.e., all the child
+    // containers were launched. Shutdown the executor if this is not
+    // the case.
+    if (response->code != process::http::Status::OK) {
+      LOG(ERROR) << "Received '" << response->status << "' ("
+                 << response->body << ") while launching child containers";
+      _shutdown();
+      return;
     }
 
     // This could happen if the agent process failed after the child
@@ -563,7 +566,8 @@ protected:
               taskId,
               containerId,
               agent,
-              authorizationHeader);
+              authorizationHeader,
+              persistentCommandChecks);
 
         if (checker.isError()) {
           // TODO(anand): Should we send a TASK_FAILED instead?
@@ -584,7 +588,8 @@ protected:
               taskId,
               containerId,
               agent,
-              authorizationHeader);
+              authorizationHeader,
+              persistentCommandChecks);
 
         if (healthChecker.isError()) {
           // TODO(anand): Should we send a TASK_FAILED instead?
@@ -651,18 +656,16 @@ protected:
     CHECK(launched);
     CHECK_SOME(connectionId);
 
-    list<Future<Connection>> connections;
-    for (size_t i = 0; i < taskIds.size(); i++) {
-      connections.push_back(process::http::connect(agent));
-    }
-
-    process::collect(connections)
+    // The child containers are all waited upon over a single connection
+    // rather than with a `WAIT_NESTED_CONTAINER` call (and connection)
+    // per child container.
+    process::http::connect(agent)
       .onAny(defer(
           self(), &Self::_wait, lambda::_1, taskIds, connectionId.get()));
   }
 
   void _wait(
-      const Future<list<Connection>>& _connections,
+      const Future<Connection>& connection,
       const list<TaskID>& taskIds,
       const UUID& _connectionId)
   {
@@ -674,10 +677,10 @@ protected:
       return;
     }
 
-    if (!_connections.isReady()) {
+    if (!connection.isReady()) {
       LOG(ERROR)
         << "Unable to establish connection with the agent: "
-        << (_connections.isFailed() ? _connections.failure() : "discarded");
+        << (connection.isFailed() ? connection.failure() : "discarded");
       _shutdown();
       return;
     }
@@ -685,19 +688,13 @@ protected:
     CHECK_EQ(SUBSCRIBED, state);
     CHECK_SOME(connectionId);
 
-    list<Connection> connections = _connections.get();
-
-    CHECK_EQ(taskIds.size(), connections.size());
-    foreach (const TaskID& taskId, taskIds) {
-      __wait(connectionId.get(), connections.front(), taskId);
-      connections.pop_front();
-    }
+    __wait(connectionId.get(), connection.get(), taskIds);
   }
 
   void __wait(
       const UUID& _connectionId,
       const Connection& connection,
-      const TaskID& taskId)
+      const list<TaskID>& taskIds)
   {
     if (connectionId != _connectionId) {
       VLOG(1) << "Ignoring the wait operation from a stale connection";
@@ -706,96 +703,227 @@ protected:
 
     CHECK_EQ(SUBSCRIBED, state);
     CHECK_SOME(connectionId);
-    CHECK(containers.contains(taskId));
 
-    Owned<Container> container = containers.at(taskId);
+    agent::Call call;
+    call.set_type(agent::Call::WATCH_NESTED_CONTAINERS);
 
-    LOG(INFO) << "Waiting for child container " << container->containerId
-              << " of task '" << taskId << "'";
+    agent::Call::WatchNestedContainers* watch =
+      call.mutable_watch_nested_containers();
 
-    CHECK_NONE(container->waiting);
-    container->waiting = connection;
+    foreach (const TaskID& taskId, taskIds) {
+      CHECK(containers.contains(taskId));
 
-    agent::Call call;
-    call.set_type(agent::Call::WAIT_NESTED_CONTAINER);
+      Owned<Container> container = containers.at(taskId);
+
+      LOG(INFO) << "Waiting for child container " << container->containerId
+                << " of task '" << taskId << "'";
 
-    agent::Call::WaitNestedContainer* containerWait =
-      call.mutable_wait_nested_container();
+      CHECK_NONE(container->waiting);
+      container->waiting = connection;
 
-    containerWait->mutable_container_id()->CopyFrom(container->containerId);
+      watch->add_container_ids()->CopyFrom(container->containerId);
+    }
 
-    Future<Response> response = post(connection, call);
-    response
+    ::Request request;
+    request.method = "POST";
+    request.url = agent;
+    request.body = serialize(contentType, evolve(call));
+    request.keepAlive = true;
+    request.headers = {{"Accept", APPLICATION_RECORDIO},
+                       {MESSAGE_ACCEPT, stringify(contentType)},
+                       {"Content-Type", stringify(contentType)}};
+
+    if (authorizationHeader.isSome()) {
+      request.headers["Authorization"] = authorizationHeader.get();
+    }
+
+    Connection connection_ = connection; // Remove const.
+
+    connection_.send(request, true)
       .onAny(defer(self(),
-                   &Self::waited,
+                   &Self::watching,
                    connectionId.get(),
-                   taskId,
+                   taskIds,
                    lambda::_1));
   }
 
-  void waited(
+  void watching(
       const UUID& _connectionId,
-      const TaskID& taskId,
+      const list<TaskID>& taskIds,
       const Future<Response>& response)
   {
     // It is possible that this callback executed after the agent process
     // failed in the interim. We can resume waiting on the child containers
     // once we subscribe again with the agent.
     if (connectionId != _connectionId) {
-      VLOG(1) << "Ignoring the waited callback from a stale connection";
+      VLOG(1) << "Ignoring the watching callback from a stale connection";
       return;
     }
 
     CHECK_EQ(SUBSCRIBED, state);
-    CHECK(containers.contains(taskId));
-
-    Owned<Container> container = containers.at(taskId);
-
-    CHECK_SOME(container->waiting);
-
-    auto retry_ = [this, container]() mutable {
-      container->waiting->disconnect();
-      container->waiting = None();
-      retry(connectionId.get(), container->taskInfo.task_id());
-    };
 
     // It is possible that the response failed due to a network blip
     // rather than the agent process failing. In that case, reestablish
     // the connection.
     if (!response.isReady()) {
       LOG(ERROR)
-        << "Connection for waiting on child container "
-        << container->containerId << " of task '" << taskId << "' interrupted: "
+        << "Connection for waiting on the child containers of tasks "
+        << stringify(taskIds) << " interrupted: "
         << (response.isFailed() ? response.failure() : "discarded");
-      retry_();
+      rewait(taskIds);
       return;
     }
 
     // It is possible that the agent was still recovering when we
     // subscribed again after an agent process failure and started to
-    // wait for the child container. In that case, reestablish
+    // wait for the child containers. In that case, reestablish
     // the connection.
     if (response->code == process::http::Status::SERVICE_UNAVAILABLE) {
       LOG(WARNING) << "Received '" << response->status << "' ("
-                   << response->body << ") waiting on child container "
-                   << container->containerId << " of task '" << taskId << "'";
-      retry_();
+                   << response->body << ") waiting on the child containers"
+                   << " of tasks " << stringify(taskIds);
+      rewait(taskIds);
       return;
     }
 
-    // Check if we receive a 200 OK response for the `WAIT_NESTED_CONTAINER`
-    // calls. Shutdown the executor otherwise.
+    // Check if we receive a 200 OK response for the
+    // `WATCH_NESTED_CONTAINERS` call. Shutdown the executor otherwise.
     if (response->code != process::http::Status::OK) {
       LOG(ERROR) << "Received '" << response->status << "' ("
-                 << response->body << ") waiting on child container "
-                 << container->containerId << " of task '" << taskId << "'";
+                 << response->body << ") waiting on the child containers"
+                 << " of tasks " << stringify(taskIds);
+      _shutdown();
+      return;
+    }
+
+    CHECK_EQ(Response::PIPE, response->type);
+    CHECK_SOME(response->reader);
+
+    Owned<recordio::Reader<agent::Response>> reader(
+        new recordio::Reader<agent::Response>(
+            ::recordio::Decoder<agent::Response>(lambda::bind(
+                deserialize<agent::Response>, contentType, lambda::_1)),
+            response->reader.get()));
+
+    read(connectionId.get(), taskIds, reader);
+  }
+
+  void read(
+      const UUID& _connectionId,
+      const list<TaskID>& taskIds,
+      const Owned<recordio::Reader<agent::Response>>& reader)
+  {
+    reader->read()
+      .onAny(defer(self(),
+                   &Self::_read,
+                   _connectionId,
+                   taskIds,
+                   reader,
+                   lambda::_1));
+  }
+
+  void _read(
+      const UUID& _connectionId,
+      const list<TaskID>& taskIds,
+      const Owned<recordio::Reader<agent::Response>>& reader,
+      const Future<Result<agent::Response>>& record)
+  {
+    if (connectionId != _connectionId) {
+      VLOG(1) << "Ignoring the watching callback from a stale connection";
+      return;
+    }
+
+    CHECK_EQ(SUBSCRIBED, state);
+
+    // The tasks whose child containers have not terminated yet.
+    list<TaskID> waiting;
+    foreach (const TaskID& taskId, taskIds) {
+      if (containers.contains(taskId)) {
+        waiting.push_back(taskId);
+      }
+    }
+
+    if (!record.isReady()) {
+      LOG(ERROR)
+        << "Connection for waiting on the child containers of tasks "
+        << stringify(waiting) << " interrupted: "
+        << (record.isFailed() ? record.failure() : "discarded");
+      rewait(waiting);
+      return;
+    }
+
+    if (record->isNone()) {
+      // The agent closes the stream once all the child containers
+      // have terminated.
+      if (!waiting.empty()) {
+        LOG(ERROR)
+          << "Connection for waiting on the child containers of tasks "
+          << stringify(waiting) << " closed";
+        rewait(waiting);
+      }
+      return;
+    }
+
+    if (record->isError()) {
+      LOG(ERROR) << "Failed to read the termination of a child container: "
+                 << record->error();
       _shutdown();
       return;
     }
 
-    Try<agent::Response> waitResponse =
-      deserialize<agent::Response>(contentType, response->body);
-    CHECK_SOME(waitResponse);
+    CHECK(record->get().has_watch_nested_containers());
+
+    const agent::Response::WatchNestedContainers& watch =
+      record->get().watch_nested_containers();
+
+    Option<TaskID> taskId;
+    foreach (const TaskID& taskId_, waiting) {
+      if (containers.at(taskId_)->containerId == watch.container_id()) {
+        taskId = taskId_;
+        break;
+      }
+    }
+
+    if (taskId.isNone()) {
+      LOG(WARNING) << "Ignoring the termination of unknown child container "
+                   << watch.container_id();
+    } else if (!watch.has_wait_container()) {
+      LOG(ERROR) << "Child container " << watch.container_id()
+                 << " of task '" << taskId.get() << "' cannot be found";
+      _shutdown();
+      return;
+    } else {
+      waited(taskId.get(), watch.wait_container());
+    }
+
+    read(_connectionId, taskIds, reader);
+  }
+
+  // Waits again on the child containers of the tasks, after the
+  // connection used for waiting on them got interrupted.
+  void rewait(const list<TaskID>& taskIds)
+  {
+    foreach (const TaskID& taskId, taskIds) {
+      CHECK(containers.contains(taskId));
+
+      Owned<Container> container = containers.at(taskId);
+
+      if (container->waiting.isSome()) {
+        container->waiting->disconnect();
+        container->waiting = None();
+      }
+    }
+
+    retry(connectionId.get(), taskIds);
+  }
+
+  void waited(
+      const TaskID& taskId,
+      const agent::Response::WaitContainer& waitContainer)
+  {
+    CHECK(containers.contains(taskId));
+
+    Owned<Container> container = containers.at(taskId);
 
     // If the task is checked, pause the associated checker to avoid
     // sending check updates after a terminal status update.
@@ -818,11 +946,11 @@ protected:
     Option<TaskStatus::Reason> reason;
     Option<TaskResourceLimitation> limitation;
 
-    if (!waitResponse->wait_nested_container().has_exit_status()) {
+    if (!waitContainer.has_exit_status()) {
       taskState = TASK_FAILED;
       message = "Command terminated with unknown status";
     } else {
-      int status = waitResponse->wait_nested_container().exit_status();
+      int status = waitContainer.exit_status();
 
       CHECK(WIFEXITED(status) || WIFSIGNALED(status))
         << "Unexpected wait status " << status;
@@ -845,25 +973,25 @@ protected:
     // in general, the agent has more specific information about why
     // the container exited (e.g. this might be a container resource
     // limitation).
-    if (waitResponse->wait_nested_container().has_state()) {
-      taskState = waitResponse->wait_nested_container().state();
+    if (waitContainer.has_state()) {
+      taskState = waitContainer.state();
     }
 
-    if (waitResponse->wait_nested_container().has_reason()) {
-      reason = waitResponse->wait_nested_container().reason();
+    if (waitContainer.has_reason()) {
+      reason = waitContainer.reason();
     }
 
-    if (waitResponse->wait_nested_container().has_message()) {
+    if (waitContainer.has_message()) {
       if (message.isSome()) {
         message->append(
-            ": " +  waitResponse->wait_nested_container().message());
+            ": " +  waitContainer.message());
       } else {
-        message = waitResponse->wait_nested_container().message();
+        message = waitContainer.message();
       }
     }
 
-    if (waitResponse->wait_nested_container().has_limitation()) {
-      limitation = waitResponse->wait_nested_container().limitation();
+    if (waitContainer.has_limitation()) {
+      limitation = waitContainer.limitation();
     }
 
     TaskStatus taskStatus = createTaskStatus(
@@ -1403,7 +1531,7 @@ private:
                                : process::http::request(request);
   }
 
-  void retry(const UUID& _connectionId, const TaskID& taskId)
+  void retry(const UUID& _connectionId, const list<TaskID>& taskIds)
   {
     if (connectionId != _connectionId) {
       VLOG(1) << "Ignoring retry attempt from a stale connection";
@@ -1417,13 +1545,13 @@ private:
                    &Self::_retry,
                    lambda::_1,
                    connectionId.get(),
-                   taskId));
+                   taskIds));
   }
 
   void _retry(
       const Future<Connection>& connection,
       const UUID& _connectionId,
-      const TaskID& taskId)
+      const list<TaskID>& taskIds)
   {
     const Duration duration = Seconds(1);
 
@@ -1434,31 +1562,32 @@ private:
 
     CHECK_EQ(SUBSCRIBED, state);
     CHECK_SOME(connectionId);
-    CHECK(containers.contains(taskId) && containers.at(taskId)->launched);
 
-    const Owned<Container>& container = containers.at(taskId);
+    foreach (const TaskID& taskId, taskIds) {
+      CHECK(containers.contains(taskId) && containers.at(taskId)->launched);
+    }
 
     if (!connection.isReady()) {
       LOG(ERROR)
         << "Unable to establish connection with the agent ("
         << (connection.isFailed() ? connection.failure() : "discarded")
-        << ") for waiting on child container " << container->containerId
-        << " of task '" << taskId << "'; Retrying again in " << duration;
+        << ") for waiting on the child containers of tasks "
+        << stringify(taskIds) << "; Retrying again in " << duration;
 
       process::delay(
-          duration, self(), &Self::retry, connectionId.get(), taskId);
+          duration, self(), &Self::retry, connectionId.get(), taskIds);
 
       return;
     }
 
     LOG(INFO)
-      << "Established connection to wait for child container "
-      << container->containerId << " of task '" << taskId
-      << "'; Retrying the WAIT_NESTED_CONTAINER call " << "in " << duration;
+      << "Established connection to wait for the child containers of tasks "
+      << stringify(taskIds) << "; Retrying the WATCH_NESTED_CONTAINERS call "
+      << "in " << duration;
 
     // It is possible that we were able to reestablish the connection
     // but the agent might still be recovering. To avoid the vicious
-    // cycle i.e., the `WAIT_NESTED_CONTAINER` call failing immediately
+    // cycle i.e., the `WATCH_NESTED_CONTAINERS` call failing immediately
     // with a '503 SERVICE UNAVAILABLE' followed by retrying establishing
     // the connection again, we wait before making the call.
     process::delay(
@@ -1467,7 +1596,7 @@ private:
         &Self::__wait,
         connectionId.get(),
         connection.get(),
-        taskId);
+        taskIds);
   }
 
   enum State
@@ -1490,6 +1619,7 @@ private:
   const string sandboxDirectory;
   const string launcherDirectory;
   const Option<string> authorizationHeader;
+  const bool persistentCommandChecks;
 
   LinkedHashMap<UUID, Call::Update> unacknowledgedUpdates;
 
@@ -1517,9 +1647,17 @@ public:
         "launcher_dir",
         "Directory path of Mesos binaries.",
         PKGLIBEXECDIR);
+
+    add(&Flags::persistent_command_checks,
+        "persistent_command_checks",
+        "Whether to run the command checks and health checks of a task\n"
+        "in one long-lived nested container rather than launching a new\n"
+        "nested container for every check.",
+        false);
   }
 
   string launcher_dir;
+  bool persistent_command_checks;
 };
 
 
@@ -1585,8 +1723,19 @@ int main(int argc, char** argv)
       << "Expecting 'MESOS_SLAVE_PID' to be set in the environment";
   }
 
+  // Use a lightweight libprocess runtime unless the operator configured
+  // one explicitly, without passing the variable on to the tasks.
+  const bool lightweight = os::getenv("LIBPROCESS_LIGHTWEIGHT").isNone();
+  if (lightweight) {
+    os::setenv("LIBPROCESS_LIGHTWEIGHT", "true");
+  }
+
   process::initialize();
 
+  if (lightweight) {
+    os::unsetenv("LIBPROCESS_LIGHTWEIGHT");
+  }
+
   UPID upid(value.get());
   CHECK(upid) << "Failed to parse MESOS_SLAVE_PID '" << value.get() << "'";
 
@@ -1616,7 +1765,8 @@ int main(int argc, char** argv)
           agent,
           sandboxDirectory,
           flags.launcher_dir,
-          authorizationHeader));
+          authorizationHeader,
+          flags.persistent_command_checks));
 
   process::spawn(executor.get());
   process::wait(executor.get());
@@ -1270,8 +1270,20 @@ int main(int argc, char** argv)
     shutdownGracePeriod = parse.get();
   }
 
+  // The command executor only runs a few actors, so it uses a
+  // lightweight libprocess runtime unless the operator configured one
+  // explicitly. The variable is not passed on to the task.
+  const bool lightweight = os::getenv("LIBPROCESS_LIGHTWEIGHT").isNone();
+  if (lightweight) {
+    os::setenv("LIBPROCESS_LIGHTWEIGHT", "true");
+  }
+
   process::initialize();
 
+  if (lightweight) {
+    os::unsetenv("LIBPROCESS_LIGHTWEIGHT");
+  }
+
   Owned<mesos::internal::CommandExecutor> executor(
       new mesos::internal::CommandExecutor(
           flags.launcher_dir,
@@ -14,7 +14,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <process/owned.hpp>
@@ -30,6 +33,8 @@
 
 #include <stout/os/constants.hpp>
 #include <stout/os/copyfile.hpp>
+#include <stout/os/mkdtemp.hpp>
+#include <stout/os/rename.hpp>
 
 #include <mesos/mesos.hpp>
 
@@ -42,6 +47,7 @@
 #include "logging/flags.hpp"
 #include "logging/logging.hpp"
 
+#include "slave/constants.hpp"
 #include "slave/slave.hpp"
 
 #include "slave/containerizer/fetcher.hpp"
@@ -56,6 +62,7 @@ using std::vector;
 
 using mesos::fetcher::FetcherInfo;
 
+using mesos::internal::slave::FETCHER_MAX_CONCURRENT_DOWNLOADS;
 using mesos::internal::slave::Fetcher;
 
 
@@ -281,12 +288,45 @@ static Try<string> chmodExecutable(const string& filePath)
 }
 
 
+// Downloads the URI into the given staging directory, from which it is
+// moved into the sandbox by `fetchBypassingCache`. Returns the path of
+// the downloaded file.
+static Try<string> downloadBypassingCache(
+    const CommandInfo::URI& uri,
+    const string& stagingDirectory,
+    const Option<string>& frameworksHome)
+{
+  LOG(INFO) << "Downloading '" << uri.value() << "' for the sandbox directory";
+
+  Try<string> outputFile = uri.has_output_file()
+    ? uri.output_file()
+    : Fetcher::basename(uri.value());
+
+  if (outputFile.isError()) {
+    return Error(outputFile.error());
+  }
+
+  // NOTE: Files are staged by their base name in a directory of their
+  // own, since every item may have the same output file.
+  Try<string> directory = os::mkdtemp(path::join(stagingDirectory, "XXXXXX"));
+  if (directory.isError()) {
+    return Error(
+        "Failed to create staging directory: " + directory.error());
+  }
+
+  return download(
+      uri.value(),
+      path::join(directory.get(), Path(outputFile.get()).basename()),
+      frameworksHome);
+}
+
+
 // Returns the resulting file or in case of extraction the destination
 // directory (for logging).
 static Try<string> fetchBypassingCache(
     const CommandInfo::URI& uri,
-    const string& sandboxDirectory,
-    const Option<string>& frameworksHome)
+    const string& downloaded,
+    const string& sandboxDirectory)
 {
   LOG(INFO) << "Fetching directly into the sandbox directory";
 
@@ -315,13 +355,15 @@ static Try<string> fetchBypassingCache(
 
   string path = path::join(sandboxDirectory, outputFile.get());
 
-  Try<string> downloaded = download(uri.value(), path, frameworksHome);
-  if (downloaded.isError()) {
-    return Error(downloaded.error());
+  Try<Nothing> rename = os::rename(downloaded, path);
+  if (rename.isError()) {
+    return Error(
+        "Failed to move '" + downloaded + "' to '" + path + "': " +
+        rename.error());
   }
 
   if (uri.executable()) {
-    return chmodExecutable(downloaded.get());
+    return chmodExecutable(path);
   } else if (uri.extract()) {
     Try<bool> extracted = extract(path, sandboxDirectory);
     if (extracted.isError()) {
@@ -333,7 +375,7 @@ static Try<string> fetchBypassingCache(
     }
   }
 
-  return downloaded;
+  return path;
 }
 
 
@@ -398,12 +440,9 @@ static Try<string> fetchFromCache(
 }
 
 
-// Returns the resulting file or in case of extraction the destination
-// directory (for logging).
-static Try<string> fetchThroughCache(
+static Try<Nothing> downloadThroughCache(
     const FetcherInfo::Item& item,
     const Option<string>& cacheDirectory,
-    const string& sandboxDirectory,
     const Option<string>& frameworksHome)
 {
   if (cacheDirectory.isNone() || cacheDirectory.get().empty()) {
@@ -423,7 +462,7 @@ static Try<string> fetchThroughCache(
     << "Fetcher cache directory was expected to exist but was not found";
 
   if (item.action() == FetcherInfo::Item::DOWNLOAD_AND_CACHE) {
-    LOG(INFO) << "Downloading into cache";
+    LOG(INFO) << "Downloading '" << item.uri().value() << "' into cache";
 
     Try<string> downloaded = download(
         item.uri().value(),
@@ -435,7 +474,43 @@ static Try<string> fetchThroughCache(
     }
   }
 
-  return fetchFromCache(item, cacheDirectory.get(), sandboxDirectory);
+  return Nothing();
+}
+
+
+// Downloads the URI of the item, either into the staging directory or
+// into the cache, unless it is retrieved from the cache. Returns the
+// path of the file downloaded into the staging directory, if any.
+//
+// NOTE: This may be called concurrently for the items of a task, see
+// `main()`, so it must not touch the sandbox directory.
+static Try<Option<string>> download(
+    const FetcherInfo::Item& item,
+    const Option<string>& cacheDirectory,
+    const string& stagingDirectory,
+    const Option<string>& frameworksHome)
+{
+  if (item.action() == FetcherInfo::Item::BYPASS_CACHE) {
+    Try<string> downloaded = downloadBypassingCache(
+        item.uri(),
+        stagingDirectory,
+        frameworksHome);
+
+    if (downloaded.isError()) {
+      return Error(downloaded.error());
+    }
+
+    return Some(downloaded.get());
+  }
+
+  Try<Nothing> downloaded =
+    downloadThroughCache(item, cacheDirectory, frameworksHome);
+
+  if (downloaded.isError()) {
+    return Error(downloaded.error());
+  }
+
+  return None();
 }
 
 
@@ -443,24 +518,21 @@ static Try<string> fetchThroughCache(
 // directory (for logging).
 static Try<string> fetch(
     const FetcherInfo::Item& item,
+    const Option<string>& downloaded,
     const Option<string>& cacheDirectory,
-    const string& sandboxDirectory,
-    const Option<string>& frameworksHome)
+    const string& sandboxDirectory)
 {
   LOG(INFO) << "Fetching URI '" << item.uri().value() << "'";
 
   if (item.action() == FetcherInfo::Item::BYPASS_CACHE) {
-    return fetchBypassingCache(
-        item.uri(),
-        sandboxDirectory,
-        frameworksHome);
+    CHECK_SOME(downloaded);
+
+    return fetchBypassingCache(item.uri(), downloaded.get(), sandboxDirectory);
   }
 
-  return fetchThroughCache(
-      item,
-      cacheDirectory,
-      sandboxDirectory,
-      frameworksHome);
+  CHECK_SOME(cacheDirectory);
+
+  return fetchFromCache(item, cacheDirectory.get(), sandboxDirectory);
 }
 
 
@@ -592,11 +664,70 @@ int main(int argc, char* argv[])
       Option<string>::some(fetcherInfo.get().frameworks_home()) :
         Option<string>::none();
 
+  // The URIs that bypass the cache are downloaded into a staging
+  // directory in the sandbox first, see below.
+  Try<string> stagingDirectory =
+    os::mkdtemp(path::join(sandboxDirectory, ".fetcher.XXXXXX"));
+
+  if (stagingDirectory.isError()) {
+    EXIT(EXIT_FAILURE)
+      << "Could not create the fetcher staging directory: "
+      << stagingDirectory.error();
+  }
+
+  const FetcherInfo& info = fetcherInfo.get();
+  const size_t items = info.items_size();
+
+  // Download the URIs concurrently, since this is what takes most of
+  // the time to fetch several URIs. The downloaded files are moved or
+  // copied into the sandbox (and extracted) afterwards, in the order
+  // of the URIs, since the files of a URI may overwrite those of the
+  // URIs before it.
+  vector<Option<string>> downloaded(items);
+  vector<Option<string>> errors(items);
+
+  std::atomic<size_t> next(0);
+
+  auto downloader = [&]() {
+    for (size_t i = next++; i < items; i = next++) {
+      Try<Option<string>> download_ = download(
+          info.items(i),
+          cacheDirectory,
+          stagingDirectory.get(),
+          frameworksHome);
+
+      if (download_.isError()) {
+        errors[i] = download_.error();
+      } else {
+        downloaded[i] = download_.get();
+      }
+    }
+  };
+
+  vector<std::thread> threads;
+  for (size_t i = 1;
+       i < std::min(items, FETCHER_MAX_CONCURRENT_DOWNLOADS);
+       i++) {
+    threads.emplace_back(downloader);
+  }
+
+  downloader();
+
+  foreach (std::thread& thread, threads) {
+    thread.join();
+  }
+
   // Fetch each URI to a local file and chmod if necessary.
-  foreach (const FetcherInfo::Item& item, fetcherInfo.get().items()) {
-    Try<string> fetched =
-      fetch(item, cacheDirectory, sandboxDirectory, frameworksHome);
+  for (size_t i = 0; i < items; i++) {
+    const FetcherInfo::Item& item = info.items(i);
+
+    Try<string> fetched = errors[i].isSome()
+      ? Error(errors[i].get())
+      : fetch(item, downloaded[i], cacheDirectory, sandboxDirectory);
+
     if (fetched.isError()) {
+      os::rmdir(stagingDirectory.get());
+
       EXIT(EXIT_FAILURE)
         << "Failed to fetch '" << item.uri().value() << "': " + fetched.error();
     } else {
@@ -605,6 +736,12 @@ int main(int argc, char* argv[])
     }
   }
 
+  Try<Nothing> rmdir = os::rmdir(stagingDirectory.get());
+  if (rmdir.isError()) {
+    LOG(WARNING) << "Failed to remove the fetcher staging directory '"
+                 << stagingDirectory.get() << "': " << rmdir.error();
+  }
+
   LOG(INFO) << "Successfully fetched all URIs into "
             << "'" << sandboxDirectory << "'";
 
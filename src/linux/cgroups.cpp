@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <sys/epoll.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
 
@@ -34,6 +35,7 @@ extern "C" {
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <fstream>
 #include <list>
 #include <map>
@@ -1390,7 +1392,8 @@ public:
     : ProcessBase(ID::generate("cgroups-freezer")),
       hierarchy(_hierarchy),
       cgroup(_cgroup),
-      start(Clock::now()) {}
+      start(Clock::now()),
+      interval(Milliseconds(1)) {}
 
   virtual ~Freezer() {}
 
@@ -1421,7 +1424,7 @@ public:
     }
 
     // Attempt to freeze the freezer cgroup again.
-    delay(Milliseconds(100), self(), &Self::freeze);
+    delay(backoff(), self(), &Self::freeze);
   }
 
   void thaw()
@@ -1450,7 +1453,7 @@ public:
     }
 
     // Attempt to thaw the freezer cgroup again.
-    delay(Milliseconds(100), self(), &Self::thaw);
+    delay(backoff(), self(), &Self::thaw);
   }
 
   Future<Nothing> future() { return promise.future(); }
@@ -1476,9 +1479,20 @@ protected:
   }
 
 private:
+  // Returns the interval to wait before checking the freezer state
+  // again. A cgroup usually transitions within a few milliseconds, so
+  // we start checking often and back off up to every 100ms.
+  Duration backoff()
+  {
+    const Duration current = interval;
+    interval = std::min(interval * 2, Duration(Milliseconds(100)));
+    return current;
+  }
+
   const string hierarchy;
   const string cgroup;
   const Time start;
+  Duration interval;
   Promise<Nothing> promise;
 };
 
@@ -1540,6 +1554,18 @@ private:
   }
 
   void killTasks() {
+    // There is nothing to kill in an empty cgroup, e.g., in most of the
+    // nested cgroups of a container, so skip freezing and thawing it.
+    // NOTE: Processes can only enter a cgroup by being assigned to it
+    // or forked by a process in it, which the caller of `destroy` is
+    // expected to prevent.
+    Try<set<pid_t>> processes = cgroups::processes(hierarchy, cgroup);
+    if (processes.isSome() && processes->empty()) {
+      promise.set(Nothing());
+      terminate(self());
+      return;
+    }
+
     // Chain together the steps needed to kill all tasks in the cgroup.
     chain = freeze()                     // Freeze the cgroup.
       .then(defer(self(), &Self::kill))  // Send kill signal.
@@ -2696,22 +2722,86 @@ ostream& operator<<(ostream& stream, Level level)
 }
 
 
-// The process drives the event::Listener to keep listening on cgroups
-// memory pressure counters.
+class CounterProcess;
+
+
+// Multiplexes the eventfds of all memory pressure counters into a
+// single epoll set. That way libprocess polls one file descriptor for
+// the pressure events of all containers, rather than three (one per
+// level) for each of them, each with its own listener process.
+//
+// NOTE: The multiplexer owns the eventfds it has been handed, which
+// are only read and closed on its actor, so that an eventfd returned
+// by `epoll_wait` cannot get closed and reused before it is read.
+class CounterMultiplexer : public Process<CounterMultiplexer>
+{
+public:
+  // Returns the multiplexer shared by all counters.
+  // NOTE: The multiplexer is intentionally leaked to avoid destruction
+  // order issues with counters destroyed by other static objects.
+  static CounterMultiplexer* instance()
+  {
+    static CounterMultiplexer* multiplexer = []() {
+      CounterMultiplexer* multiplexer = new CounterMultiplexer();
+      spawn(multiplexer);
+      return multiplexer;
+    }();
+
+    return multiplexer;
+  }
+
+  // Takes ownership of the eventfd and reports its events to `counter`.
+  void add(int efd, const PID<CounterProcess>& counter);
+
+  // Stops reporting the events of and closes the eventfd.
+  void remove(int efd);
+
+protected:
+  virtual void initialize()
+  {
+    int fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (fd < 0) {
+      error = ErrnoError("Failed to create epoll set");
+      return;
+    }
+
+    epollfd = fd;
+
+    poll();
+  }
+
+private:
+  CounterMultiplexer()
+    : ProcessBase(ID::generate("cgroups-pressure-multiplexer")) {}
+
+  void poll()
+  {
+    io::poll(epollfd.get(), io::READ)
+      .onAny(defer(self(), &Self::_poll, lambda::_1));
+  }
+
+  void _poll(const Future<short>& future);
+
+  Option<int> epollfd;
+  Option<Error> error;
+  hashmap<int, PID<CounterProcess>> counters;
+};
+
+
+// The process keeps track of the number of memory pressure events of
+// a given level for a cgroup, as reported by the `CounterMultiplexer`.
 class CounterProcess : public Process<CounterProcess>
 {
 public:
-  CounterProcess(const string& hierarchy,
-                 const string& cgroup,
-                 Level level)
+  CounterProcess(const string& _hierarchy,
+                 const string& _cgroup,
+                 Level _level)
     : ProcessBase(ID::generate("cgroups-counter")),
+      hierarchy(_hierarchy),
+      cgroup(_cgroup),
+      level(_level),
       value_(0),
-      error(None()),
-      process(new event::Listener(
-          hierarchy,
-          cgroup,
-          "memory.pressure_level",
-          stringify(level))) {}
+      error(None()) {}
 
   virtual ~CounterProcess() {}
 
@@ -2724,46 +2814,145 @@ public:
     return value_;
   }
 
-protected:
-  virtual void initialize()
+  void increment(uint64_t count)
   {
-    spawn(CHECK_NOTNULL(process.get()));
-    listen();
+    value_ += count;
   }
 
-  virtual void finalize()
+  void fail(const string& message)
   {
-    terminate(process.get());
-    wait(process.get());
+    if (error.isNone()) {
+      error = Error(message);
+    }
   }
 
-private:
-  void listen()
+protected:
+  virtual void initialize()
   {
-    dispatch(process.get(), &event::Listener::listen)
-      .onAny(defer(self(), &CounterProcess::_listen, lambda::_1));
+    Try<int> fd = event::registerNotifier(
+        hierarchy, cgroup, "memory.pressure_level", stringify(level));
+
+    if (fd.isError()) {
+      error = Error("Failed to register notification eventfd: " + fd.error());
+      return;
+    }
+
+    efd = fd.get();
+
+    dispatch(CounterMultiplexer::instance(),
+             &CounterMultiplexer::add,
+             efd.get(),
+             self());
   }
 
-  void _listen(const process::Future<uint64_t>& future)
+  virtual void finalize()
   {
-    CHECK_NONE(error);
-
-    if (future.isReady()) {
-      value_ += future.get();
-      listen();
-    } else if (future.isFailed()) {
-      error = Error(future.failure());
-    } else if (future.isDiscarded()) {
-      error = Error("Listening stopped unexpectedly");
+    if (efd.isSome()) {
+      dispatch(CounterMultiplexer::instance(),
+               &CounterMultiplexer::remove,
+               efd.get());
     }
   }
 
+private:
+  const string hierarchy;
+  const string cgroup;
+  const Level level;
+
   uint64_t value_;
   Option<Error> error;
-  process::Owned<event::Listener> process;
+  Option<int> efd;
 };
 
 
+void CounterMultiplexer::add(int efd, const PID<CounterProcess>& counter)
+{
+  if (error.isSome()) {
+    os::close(efd);
+    dispatch(counter, &CounterProcess::fail, error->message);
+    return;
+  }
+
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = efd;
+
+  if (::epoll_ctl(epollfd.get(), EPOLL_CTL_ADD, efd, &event) < 0) {
+    ErrnoError error("Failed to add eventfd to epoll set");
+    os::close(efd);
+    dispatch(counter, &CounterProcess::fail, error.message);
+    return;
+  }
+
+  counters[efd] = counter;
+}
+
+
+void CounterMultiplexer::remove(int efd)
+{
+  if (!counters.contains(efd)) {
+    return;
+  }
+
+  counters.erase(efd);
+
+  if (::epoll_ctl(epollfd.get(), EPOLL_CTL_DEL, efd, nullptr) < 0) {
+    PLOG(ERROR) << "Failed to remove eventfd from epoll set";
+  }
+
+  os::close(efd);
+}
+
+
+void CounterMultiplexer::_poll(const Future<short>& future)
+{
+  if (!future.isReady()) {
+    error = Error(
+        "Failed to poll epoll set: " +
+        (future.isFailed() ? future.failure() : "discarded"));
+
+    LOG(ERROR) << error->message;
+
+    foreachpair (int efd, const PID<CounterProcess>& counter, counters) {
+      os::close(efd);
+      dispatch(counter, &CounterProcess::fail, error->message);
+    }
+
+    counters.clear();
+    return;
+  }
+
+  struct epoll_event events[64];
+
+  int count = ::epoll_wait(epollfd.get(), events, 64, 0);
+  if (count < 0 && errno != EINTR) {
+    PLOG(ERROR) << "Failed to wait for events of epoll set";
+  }
+
+  for (int i = 0; i < count; i++) {
+    const int efd = events[i].data.fd;
+
+    if (!counters.contains(efd)) {
+      continue;
+    }
+
+    uint64_t data;
+    ssize_t length = ::read(efd, &data, sizeof(data));
+
+    if (length == sizeof(data)) {
+      dispatch(counters.at(efd), &CounterProcess::increment, data);
+    } else if (length < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+      ErrnoError error("Failed to read eventfd");
+
+      dispatch(counters.at(efd), &CounterProcess::fail, error.message);
+      remove(efd);
+    }
+  }
+
+  poll();
+}
+
+
 Try<Owned<Counter>> Counter::create(
     const string& hierarchy,
     const string& cgroup,
@@ -17,6 +17,7 @@
 #include "linux/fs.hpp"
 
 #include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -32,6 +33,7 @@ extern "C" {
 }
 
 #include <list>
+#include <mutex>
 #include <set>
 #include <utility>
 
@@ -44,10 +46,13 @@ extern "C" {
 #include <stout/path.hpp>
 #include <stout/strings.hpp>
 #include <stout/synchronized.hpp>
+#include <stout/unreachable.hpp>
 
 #include <stout/fs.hpp>
 #include <stout/os.hpp>
 
+#include <stout/os/close.hpp>
+#include <stout/os/open.hpp>
 #include <stout/os/read.hpp>
 #include <stout/os/realpath.hpp>
 #include <stout/os/shell.hpp>
@@ -266,6 +271,99 @@ Try<MountInfoTable> MountInfoTable::read(
 }
 
 
+Try<MountInfoTable> MountInfoTable::cached(bool hierarchicalSort)
+{
+  // The state of the cache, which is never deleted so that it can be
+  // used until the process exits.
+  struct Cache
+  {
+    std::mutex mutex;
+
+    // The open mountinfo file polled for changes, and the inode of
+    // the mount namespace it was opened in.
+    Option<int_fd> fd;
+    ino_t mnt;
+
+    // The contents of the mountinfo file when last read, and the
+    // tables parsed from them.
+    Option<string> lines;
+    Option<MountInfoTable> table;
+    Option<MountInfoTable> sortedTable;
+  };
+
+  static Cache* cache = new Cache();
+
+  synchronized (cache->mutex) {
+    // The file has to be opened again if the process has moved to
+    // another mount namespace since the polled file still refers to
+    // the mount table of the previous mount namespace.
+    Try<ino_t> mnt = os::stat::inode("/proc/self/ns/mnt");
+    if (mnt.isError()) {
+      return Error("Failed to get the mount namespace: " + mnt.error());
+    }
+
+    if (cache->fd.isNone() || cache->mnt != mnt.get()) {
+      if (cache->fd.isSome()) {
+        os::close(cache->fd.get());
+        cache->fd = None();
+      }
+
+      Try<int_fd> fd = os::open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+      if (fd.isError()) {
+        return Error("Failed to open mountinfo file: " + fd.error());
+      }
+
+      cache->fd = fd.get();
+      cache->mnt = mnt.get();
+      cache->lines = None();
+    }
+
+    // The kernel reports `POLLPRI` and `POLLERR` once after every
+    // change of the mount table. The file is read after polling, so
+    // a change which happens in between only causes an extra read.
+    struct pollfd pollfd;
+    pollfd.fd = cache->fd.get();
+    pollfd.events = POLLPRI;
+    pollfd.revents = 0;
+
+    if (::poll(&pollfd, 1, 0) < 0) {
+      return ErrnoError("Failed to poll mountinfo file");
+    }
+
+    if ((pollfd.revents & (POLLPRI | POLLERR)) != 0) {
+      cache->lines = None();
+    }
+
+    if (cache->lines.isNone()) {
+      Try<string> lines = os::read("/proc/self/mountinfo");
+      if (lines.isError()) {
+        return Error("Failed to read mountinfo file: " + lines.error());
+      }
+
+      cache->lines = lines.get();
+      cache->table = None();
+      cache->sortedTable = None();
+    }
+
+    Option<MountInfoTable>& table =
+      hierarchicalSort ? cache->sortedTable : cache->table;
+
+    if (table.isNone()) {
+      Try<MountInfoTable> parse = read(cache->lines.get(), hierarchicalSort);
+      if (parse.isError()) {
+        return Error(parse.error());
+      }
+
+      table = std::move(parse.get());
+    }
+
+    return table.get();
+  }
+
+  UNREACHABLE();
+}
+
+
 Try<MountInfoTable::Entry> MountInfoTable::findByTarget(
     const std::string& target)
 {
@@ -277,6 +277,19 @@ struct MountInfoTable {
       const std::string& lines,
       bool hierarchicalSort = true);
 
+  // Read the mountinfo table for the calling process like `read()`,
+  // but only parse '/proc/self/mountinfo' again if the mount table
+  // has changed since the last call, which the kernel reports by
+  // polling the file (see the /proc/[pid]/mountinfo section in
+  // 'man proc'). This is meant for the agent, which reads the mount
+  // table of its mount namespace every time a container gets
+  // updated or cleaned up, while the table can hold thousands of
+  // entries.
+  //
+  // NOTE: This must not be called in a child process between fork
+  // and exec since it synchronizes with a mutex.
+  static Try<MountInfoTable> cached(bool hierarchicalSort = true);
+
   // Find the mount table entry by the given target path. If there is
   // no mount table entry that matches the exact target path, return
   // the mount table entry that is the immediate parent of the given
@@ -18,7 +18,10 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <linux/perf_event.h>
+
 #include <sys/prctl.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 
@@ -37,6 +40,7 @@
 #include <process/subprocess.hpp>
 
 #include <stout/os.hpp>
+#include <stout/path.hpp>
 #include <stout/strings.hpp>
 
 #include <stout/os/signals.hpp>
@@ -189,9 +193,305 @@ private:
   Option<Subprocess> perf;
 };
 
+
+// The attributes of a perf event for `perf_event_open()`.
+struct Event
+{
+  // The name of the event's field in `PerfStatistics`.
+  string field;
+
+  uint32_t type;
+  uint64_t config;
+};
+
+
+// Returns the events which can be counted with `perf_event_open()`,
+// keyed by their normalized names, including the alternate names
+// supported by `perf stat`.
+static const hashmap<string, Event>& events()
+{
+  static const hashmap<string, Event>* events = []() {
+    hashmap<string, Event>* events = new hashmap<string, Event>({
+      {"cycles", {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES}},
+      {"cpu_cycles", {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES}},
+      {"instructions",
+       {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS}},
+      {"cache_references",
+       {"cache_references",
+        PERF_TYPE_HARDWARE,
+        PERF_COUNT_HW_CACHE_REFERENCES}},
+      {"cache_misses",
+       {"cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}},
+      {"branches",
+       {"branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS}},
+      {"branch_instructions",
+       {"branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS}},
+      {"branch_misses",
+       {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}},
+      {"bus_cycles",
+       {"bus_cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BUS_CYCLES}},
+      {"stalled_cycles_frontend",
+       {"stalled_cycles_frontend",
+        PERF_TYPE_HARDWARE,
+        PERF_COUNT_HW_STALLED_CYCLES_FRONTEND}},
+      {"idle_cycles_frontend",
+       {"stalled_cycles_frontend",
+        PERF_TYPE_HARDWARE,
+        PERF_COUNT_HW_STALLED_CYCLES_FRONTEND}},
+      {"stalled_cycles_backend",
+       {"stalled_cycles_backend",
+        PERF_TYPE_HARDWARE,
+        PERF_COUNT_HW_STALLED_CYCLES_BACKEND}},
+      {"idle_cycles_backend",
+       {"stalled_cycles_backend",
+        PERF_TYPE_HARDWARE,
+        PERF_COUNT_HW_STALLED_CYCLES_BACKEND}},
+      {"ref_cycles",
+       {"ref_cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES}},
+      {"cpu_clock",
+       {"cpu_clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK}},
+      {"task_clock",
+       {"task_clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK}},
+      {"page_faults",
+       {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}},
+      {"faults",
+       {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}},
+      {"minor_faults",
+       {"minor_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MIN}},
+      {"major_faults",
+       {"major_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ}},
+      {"context_switches",
+       {"context_switches",
+        PERF_TYPE_SOFTWARE,
+        PERF_COUNT_SW_CONTEXT_SWITCHES}},
+      {"cs",
+       {"context_switches",
+        PERF_TYPE_SOFTWARE,
+        PERF_COUNT_SW_CONTEXT_SWITCHES}},
+      {"cpu_migrations",
+       {"cpu_migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS}},
+      {"migrations",
+       {"cpu_migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS}},
+      {"alignment_faults",
+       {"alignment_faults",
+        PERF_TYPE_SOFTWARE,
+        PERF_COUNT_SW_ALIGNMENT_FAULTS}},
+      {"emulation_faults",
+       {"emulation_faults",
+        PERF_TYPE_SOFTWARE,
+        PERF_COUNT_SW_EMULATION_FAULTS}},
+    });
+
+    // The hardware cache events, see perf_event_open(2) for the
+    // encoding of their configuration.
+    const hashmap<string, uint64_t> caches = {
+      {"l1_dcache", PERF_COUNT_HW_CACHE_L1D},
+      {"l1_icache", PERF_COUNT_HW_CACHE_L1I},
+      {"llc", PERF_COUNT_HW_CACHE_LL},
+      {"dtlb", PERF_COUNT_HW_CACHE_DTLB},
+      {"itlb", PERF_COUNT_HW_CACHE_ITLB},
+      {"branch", PERF_COUNT_HW_CACHE_BPU},
+      {"node", PERF_COUNT_HW_CACHE_NODE},
+    };
+
+    const hashmap<string, uint64_t> operations = {
+      {"load", PERF_COUNT_HW_CACHE_OP_READ},
+      {"store", PERF_COUNT_HW_CACHE_OP_WRITE},
+      {"prefetch", PERF_COUNT_HW_CACHE_OP_PREFETCH},
+    };
+
+    foreachpair (const string& cache, uint64_t id, caches) {
+      foreachpair (const string& operation, uint64_t op, operations) {
+        const string accesses = cache + "_" +
+          (operation == "prefetch" ? "prefetches" : operation + "s");
+        const string misses = cache + "_" + operation + "_misses";
+
+        const uint64_t config = id | (op << 8);
+
+        // Only the events with a field in `PerfStatistics` are
+        // supported.
+        const google::protobuf::Descriptor* descriptor =
+          mesos::PerfStatistics::descriptor();
+
+        if (descriptor->FindFieldByName(accesses) != nullptr) {
+          events->put(accesses, {
+              accesses,
+              PERF_TYPE_HW_CACHE,
+              config | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16)});
+        }
+
+        if (descriptor->FindFieldByName(misses) != nullptr) {
+          events->put(misses, {
+              misses,
+              PERF_TYPE_HW_CACHE,
+              config | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)});
+        }
+      }
+    }
+
+    return events;
+  }();
+
+  return *events;
+}
+
 } // namespace internal {
 
 
+Option<Error> Counters::validate(const set<string>& events)
+{
+  foreach (const string& event, events) {
+    if (!internal::events().contains(internal::normalize(event))) {
+      return Error("Event '" + event + "' cannot be counted in process");
+    }
+  }
+
+  return None();
+}
+
+
+Try<Owned<Counters>> Counters::open(
+    const set<string>& events,
+    const string& hierarchy,
+    const string& cgroup)
+{
+  Option<Error> error = validate(events);
+  if (error.isSome()) {
+    return error.get();
+  }
+
+  // The counters of a cgroup are opened with a file descriptor of the
+  // cgroup directory in place of a pid.
+  const string path = path::join(hierarchy, cgroup);
+
+  Try<int> fd = os::open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd.isError()) {
+    return Error("Failed to open '" + path + "': " + fd.error());
+  }
+
+  unsigned long flags = PERF_FLAG_PID_CGROUP;
+#ifdef PERF_FLAG_FD_CLOEXEC
+  flags |= PERF_FLAG_FD_CLOEXEC;
+#endif
+
+  Owned<Counters> counters(new Counters(Clock::now()));
+
+  // NOTE: Cgroup counters are per CPU, they cannot count on all CPUs.
+  const long cpus = ::sysconf(_SC_NPROCESSORS_CONF);
+
+  foreach (const string& event, events) {
+    const internal::Event& event_ =
+      internal::events().at(internal::normalize(event));
+
+    counters->counters.emplace_back(event_.field, vector<int>());
+
+    for (long cpu = 0; cpu < cpus; cpu++) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+
+      attr.size = sizeof(attr);
+      attr.type = event_.type;
+      attr.config = event_.config;
+      attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      int counter = ::syscall(
+          __NR_perf_event_open, &attr, fd.get(), cpu, -1, flags);
+
+      if (counter == -1) {
+        // Offline CPUs cannot be counted on.
+        if (errno == ENODEV) {
+          continue;
+        }
+
+        Error error = ErrnoError(
+            "Failed to open a counter for event '" + event + "'"
+            " on CPU " + stringify(cpu));
+
+        // The counters opened so far are closed along with `counters`.
+        os::close(fd.get());
+        return error;
+      }
+
+#ifndef PERF_FLAG_FD_CLOEXEC
+      os::cloexec(counter);
+#endif
+
+      counters->counters.back().second.push_back(counter);
+    }
+  }
+
+  os::close(fd.get());
+
+  return counters;
+}
+
+
+Counters::~Counters()
+{
+  foreach (const auto& counter, counters) {
+    foreach (int fd, counter.second) {
+      os::close(fd);
+    }
+  }
+}
+
+
+Try<mesos::PerfStatistics> Counters::read() const
+{
+  mesos::PerfStatistics statistics;
+  statistics.set_timestamp(started.secs());
+  statistics.set_duration((Clock::now() - started).secs());
+
+  const google::protobuf::Reflection* reflection =
+    statistics.GetReflection();
+
+  foreach (const auto& counter, counters) {
+    const google::protobuf::FieldDescriptor* field =
+      statistics.GetDescriptor()->FindFieldByName(counter.first);
+
+    CHECK_NOTNULL(field);
+
+    double value = 0;
+
+    foreach (int fd, counter.second) {
+      // The count, followed by the time the counter was enabled and
+      // the time it was running (see `read_format`).
+      uint64_t values[3];
+
+      ssize_t length = ::read(fd, values, sizeof(values));
+      if (length == -1) {
+        return ErrnoError("Failed to read the counter of '" +
+                          counter.first + "'");
+      } else if (length != sizeof(values)) {
+        return Error("Failed to read the counter of '" + counter.first +
+                     "': Read " + stringify(length) + " bytes");
+      }
+
+      if (values[2] > 0) {
+        value += values[0] * (static_cast<double>(values[1]) / values[2]);
+      }
+    }
+
+    switch (field->type()) {
+      case google::protobuf::FieldDescriptor::TYPE_DOUBLE:
+        // Only the clock events are reported as doubles, which `perf
+        // stat` reports in milliseconds rather than nanoseconds.
+        reflection->SetDouble(&statistics, field, value / 1000000);
+        break;
+      case google::protobuf::FieldDescriptor::TYPE_UINT64:
+        reflection->SetUInt64(
+            &statistics, field, static_cast<uint64_t>(value));
+        break;
+      default:
+        return Error("Unsupported perf field type of '" + counter.first + "'");
+    }
+  }
+
+  return statistics;
+}
+
+
 Future<Version> version()
 {
   internal::Perf* perf = new internal::Perf({"--version"});
@@ -21,11 +21,18 @@
 
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <process/future.hpp>
+#include <process/owned.hpp>
+#include <process/time.hpp>
 
 #include <stout/duration.hpp>
+#include <stout/error.hpp>
 #include <stout/hashmap.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
 #include <stout/version.hpp>
 
 // For PerfStatistics protobuf.
@@ -43,6 +50,46 @@ process::Future<hashmap<std::string, mesos::PerfStatistics>> sample(
     const Duration& duration);
 
 
+// Counts perf events for the processes in a perf_event cgroup with
+// counters kept open in the kernel (see perf_event_open(2)), rather
+// than running `perf stat` like `sample()`. The counts accumulate
+// from when the counters are opened, and are read on demand.
+class Counters
+{
+public:
+  // Returns an error if any of the events cannot be counted this way,
+  // e.g., raw hardware events. The events are named as in `perf list`.
+  static Option<Error> validate(const std::set<std::string>& events);
+
+  // Opens a counter for each event on each online CPU.
+  // NOTE: The cgroup should be relative to the perf_event hierarchy,
+  // e.g., mesos/test for /sys/fs/cgroup/perf_event/mesos/test.
+  static Try<process::Owned<Counters>> open(
+      const std::set<std::string>& events,
+      const std::string& hierarchy,
+      const std::string& cgroup);
+
+  ~Counters();
+
+  // Returns the counts since the counters were opened, scaled up to
+  // account for the time the counters were not running because the
+  // kernel multiplexed more events than there are hardware counters.
+  Try<mesos::PerfStatistics> read() const;
+
+private:
+  explicit Counters(const process::Time& _started) : started(_started) {}
+
+  Counters(const Counters&) = delete;
+  Counters& operator=(const Counters&) = delete;
+
+  const process::Time started;
+
+  // The file descriptors of the counters of each event, one per CPU,
+  // keyed by the name of the event's field in `PerfStatistics`.
+  std::vector<std::pair<std::string, std::vector<int>>> counters;
+};
+
+
 // Validate a set of events are accepted by `perf stat`.
 bool valid(const std::set<std::string>& events);
 
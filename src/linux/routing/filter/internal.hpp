@@ -34,6 +34,7 @@
 #include <netlink/route/cls/u32.h>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <process/shared.hpp>
@@ -278,21 +279,12 @@ inline Try<Nothing> attach(
 }
 
 
-// Generates the handle for the given filter on the link. Returns none
-// if we decide to let the kernel choose the handle.
-template <typename Classifier>
-Result<U32Handle> generateU32Handle(
+// Returns all the libnl filters (rtnl_cls) attached to the given
+// parent on the link.
+inline Try<std::vector<Netlink<struct rtnl_cls>>> getClses(
     const Netlink<struct rtnl_link>& link,
-    const Filter<Classifier>& filter)
+    const Handle& parent)
 {
-  // If the user does not specify a priority, we have no choice but
-  // let the kernel choose the handle because we do not know the
-  // 'htid' that is associated with that priority.
-  if (filter.priority.isNone()) {
-    return None();
-  }
-
-  // Scan all the filters attached to the given parent on the link.
   Try<Netlink<struct nl_sock>> socket = routing::socket();
   if (socket.isError()) {
     return Error(socket.error());
@@ -304,7 +296,7 @@ Result<U32Handle> generateU32Handle(
   int error = rtnl_cls_alloc_cache(
       socket.get().get(),
       rtnl_link_get_ifindex(link.get()),
-      filter.parent.get(),
+      parent.get(),
       &c);
 
   if (error != 0) {
@@ -315,30 +307,73 @@ Result<U32Handle> generateU32Handle(
 
   Netlink<struct nl_cache> cache(c);
 
+  std::vector<Netlink<struct rtnl_cls>> results;
+
+  for (struct nl_object* o = nl_cache_get_first(cache.get());
+       o != nullptr; o = nl_cache_get_next(o)) {
+    // NOTE: We increment the reference counter here because 'cache'
+    // will be freed when this function finishes and we want this
+    // object's life to be longer than this function.
+    nl_object_get(o);
+
+    results.push_back(Netlink<struct rtnl_cls>((struct rtnl_cls*) o));
+  }
+
+  return results;
+}
+
+
+// The handles used by the u32 filters attached to a parent.
+struct U32Handles
+{
   // A map from priority to the corresponding 'htid'.
   hashmap<uint16_t, uint32_t> htids;
 
   // A map from 'htid' to a set of already used nodes.
   hashmap<uint32_t, hashset<uint32_t>> nodes;
+};
 
-  for (struct nl_object* o = nl_cache_get_first(cache.get());
-       o != nullptr; o = nl_cache_get_next(o)) {
-    struct rtnl_cls* cls = (struct rtnl_cls*) o;
 
+// Returns the handles used by the given libnl filters.
+inline U32Handles getU32Handles(
+    const std::vector<Netlink<struct rtnl_cls>>& clses)
+{
+  U32Handles handles;
+
+  foreach (const Netlink<struct rtnl_cls>& cls, clses) {
     // Only look at u32 filters. For other type of filters, their
     // handles are generated by the kernel correctly.
-    if (rtnl_tc_get_kind(TC_CAST(cls)) == std::string("u32")) {
-      U32Handle handle(rtnl_tc_get_handle(TC_CAST(cls)));
+    if (rtnl_tc_get_kind(TC_CAST(cls.get())) == std::string("u32")) {
+      U32Handle handle(rtnl_tc_get_handle(TC_CAST(cls.get())));
 
-      htids[rtnl_cls_get_prio(cls)] = handle.htid();
-      nodes[handle.htid()].insert(handle.node());
+      handles.htids[rtnl_cls_get_prio(cls.get())] = handle.htid();
+      handles.nodes[handle.htid()].insert(handle.node());
     }
   }
 
+  return handles;
+}
+
+
+// Generates the handle for the given filter from the handles already
+// in use, and marks it as used. Returns none if we decide to let the
+// kernel choose the handle.
+template <typename Classifier>
+Result<U32Handle> generateU32Handle(
+    U32Handles* handles,
+    const Filter<Classifier>& filter)
+{
+  // If the user does not specify a priority, we have no choice but
+  // let the kernel choose the handle because we do not know the
+  // 'htid' that is associated with that priority.
+  if (filter.priority.isNone()) {
+    return None();
+  }
+
   // If this filter has a new priority, we need to let the kernel
   // decide the handle because we don't know which 'htid' this
   // priority will be associated with.
-  if (!htids.contains(filter.priority.get().get())) {
+  if (!handles->htids.contains(filter.priority.get().get())) {
     return None();
   }
 
@@ -346,9 +381,10 @@ Result<U32Handle> generateU32Handle(
   // means all filters will be in hash bucket 0. Also, kernel assigns
   // node id starting from 0x800 by default. Here, we keep the same
   // semantics as kernel.
-  uint32_t htid = htids[filter.priority.get().get()];
+  uint32_t htid = handles->htids[filter.priority.get().get()];
   for (uint32_t node = 0x800; node <= 0xfff; node++) {
-    if (!nodes[htid].contains(node)) {
+    if (!handles->nodes[htid].contains(node)) {
+      handles->nodes[htid].insert(node);
       return U32Handle(htid, 0x0, node);
     }
   }
@@ -357,13 +393,41 @@ Result<U32Handle> generateU32Handle(
 }
 
 
+// Generates the handle for the given filter on the link. Returns none
+// if we decide to let the kernel choose the handle.
+template <typename Classifier>
+Result<U32Handle> generateU32Handle(
+    const Netlink<struct rtnl_link>& link,
+    const Filter<Classifier>& filter)
+{
+  // See above.
+  if (filter.priority.isNone()) {
+    return None();
+  }
+
+  // Scan all the filters attached to the given parent on the link.
+  Try<std::vector<Netlink<struct rtnl_cls>>> clses =
+    getClses(link, filter.parent);
+
+  if (clses.isError()) {
+    return Error(clses.error());
+  }
+
+  U32Handles handles = getU32Handles(clses.get());
+
+  return generateU32Handle(&handles, filter);
+}
+
+
 // Encodes a filter (in our representation) to a libnl filter
-// (rtnl_cls). We use template here so that it works for any type of
-// classifier.
+// (rtnl_cls). If `handles` is specified, an unused u32 handle gets
+// generated from it rather than from the filters on the link. We use
+// template here so that it works for any type of classifier.
 template <typename Classifier>
 Try<Netlink<struct rtnl_cls>> encodeFilter(
     const Netlink<struct rtnl_link>& link,
-    const Filter<Classifier>& filter)
+    const Filter<Classifier>& filter,
+    U32Handles* handles = nullptr)
 {
   struct rtnl_cls* c = rtnl_cls_alloc();
   if (c == nullptr) {
@@ -407,7 +471,10 @@ Try<Netlink<struct rtnl_cls>> encodeFilter(
     // handle of the filter by picking an unused handle.
     // TODO(jieyu): Revisit this once the kernel bug is fixed.
     if (rtnl_tc_get_kind(TC_CAST(cls.get())) == std::string("u32")) {
-      Result<U32Handle> handle = generateU32Handle(link, filter);
+      Result<U32Handle> handle = handles != nullptr
+        ? generateU32Handle(handles, filter)
+        : generateU32Handle(link, filter);
+
       if (handle.isError()) {
         return Error("Failed to find an unused u32 handle: " + handle.error());
       }
@@ -490,50 +557,6 @@ Result<Filter<Classifier>> decodeFilter(const Netlink<struct rtnl_cls>& cls)
 // Helpers for internal APIs.
 /////////////////////////////////////////////////
 
-// Returns all the libnl filters (rtnl_cls) attached to the given
-// parent on the link.
-inline Try<std::vector<Netlink<struct rtnl_cls>>> getClses(
-    const Netlink<struct rtnl_link>& link,
-    const Handle& parent)
-{
-  Try<Netlink<struct nl_sock>> socket = routing::socket();
-  if (socket.isError()) {
-    return Error(socket.error());
-  }
-
-  // Dump all the libnl filters (i.e., rtnl_cls) attached to the given
-  // parent on the link.
-  struct nl_cache* c = nullptr;
-  int error = rtnl_cls_alloc_cache(
-      socket.get().get(),
-      rtnl_link_get_ifindex(link.get()),
-      parent.get(),
-      &c);
-
-  if (error != 0) {
-    return Error(
-        "Failed to get filter info from kernel: " +
-        std::string(nl_geterror(error)));
-  }
-
-  Netlink<struct nl_cache> cache(c);
-
-  std::vector<Netlink<struct rtnl_cls>> results;
-
-  for (struct nl_object* o = nl_cache_get_first(cache.get());
-       o != nullptr; o = nl_cache_get_next(o)) {
-    // NOTE: We increment the reference counter here because 'cache'
-    // will be freed when this function finishes and we want this
-    // object's life to be longer than this function.
-    nl_object_get(o);
-
-    results.push_back(Netlink<struct rtnl_cls>((struct rtnl_cls*) o));
-  }
-
-  return results;
-}
-
-
 // Returns the libnl filter (rtnl_cls) attached to the given parent
 // that matches the specified classifier on the link. Returns None if
 // no match has been found. We use template here so that it works for
@@ -647,6 +670,149 @@ Try<bool> create(const std::string& _link, const Filter<Classifier>& filter)
 }
 
 
+// Creates the filters on the link, submitting their requests to the
+// kernel in batches (see `routing::batch()`) rather than one at a
+// time. Returns, in order, false for each filter attached to the same
+// parent with the same classifier as an existing filter, or as an
+// earlier filter in `filters`. Filters after a failed one may already
+// have been created when an error is returned. We use template here
+// so that it works for any type of classifier.
+template <typename Classifier>
+Try<std::vector<bool>> create(
+    const std::string& _link,
+    const std::vector<Filter<Classifier>>& filters)
+{
+  Result<Netlink<struct rtnl_link>> link = link::internal::get(_link);
+  if (link.isError()) {
+    return Error(link.error());
+  } else if (link.isNone()) {
+    return Error("Link '" + _link + "' is not found");
+  }
+
+  Try<Netlink<struct nl_sock>> socket = routing::socket();
+  if (socket.isError()) {
+    return Error(socket.error());
+  }
+
+  std::vector<bool> results(filters.size(), false);
+
+  // The requests not yet submitted, and the indices of their filters.
+  std::vector<Netlink<struct nl_msg>> messages;
+  std::vector<size_t> indices;
+
+  auto submit = [&]() -> Try<Nothing> {
+    Try<std::vector<int>> errors = routing::batch(socket.get(), messages);
+    if (errors.isError()) {
+      return Error(errors.error());
+    }
+
+    for (size_t i = 0; i < indices.size(); i++) {
+      int error = errors->at(i);
+      if (error == 0) {
+        results[indices[i]] = true;
+      } else if (error != -NLE_EXIST) {
+        return Error(std::string(nl_geterror(error)));
+      }
+    }
+
+    messages.clear();
+    indices.clear();
+
+    return Nothing();
+  };
+
+  // The classifiers and the u32 handles of the filters attached to
+  // each parent, keyed by the parent handle. Each parent is dumped
+  // once instead of once per filter.
+  hashmap<uint32_t, std::vector<Classifier>> classifiers;
+  hashmap<uint32_t, U32Handles> handles;
+
+  for (size_t i = 0; i < filters.size(); i++) {
+    const Filter<Classifier>& filter = filters[i];
+    const uint32_t parent = filter.parent.get();
+
+    if (!classifiers.contains(parent)) {
+      Try<std::vector<Netlink<struct rtnl_cls>>> clses =
+        getClses(link.get(), filter.parent);
+
+      if (clses.isError()) {
+        return Error("Check filter existence failed: " + clses.error());
+      }
+
+      classifiers[parent] = {};
+
+      foreach (const Netlink<struct rtnl_cls>& cls, clses.get()) {
+        Result<Filter<Classifier>> existing = decodeFilter<Classifier>(cls);
+        if (existing.isError()) {
+          return Error(
+              "Check filter existence failed: Failed to decode: " +
+              existing.error());
+        } else if (existing.isSome()) {
+          classifiers[parent].push_back(existing->classifier);
+        }
+      }
+
+      handles[parent] = getU32Handles(clses.get());
+    }
+
+    bool exists = false;
+    foreach (const Classifier& classifier, classifiers[parent]) {
+      if (classifier == filter.classifier) {
+        exists = true;
+        break;
+      }
+    }
+
+    if (exists) {
+      continue;
+    }
+
+    classifiers[parent].push_back(filter.classifier);
+
+    Try<Netlink<struct rtnl_cls>> cls =
+      encodeFilter(link.get(), filter, &handles[parent]);
+
+    if (cls.isError()) {
+      return Error("Failed to encode the filter: " + cls.error());
+    }
+
+    struct nl_msg* msg = nullptr;
+    int error = rtnl_cls_build_add_request(
+        cls.get().get(),
+        NLM_F_CREATE | NLM_F_EXCL,
+        &msg);
+
+    if (error != 0) {
+      return Error(std::string(nl_geterror(error)));
+    }
+
+    messages.push_back(Netlink<struct nl_msg>(msg));
+    indices.push_back(i);
+
+    // If the kernel chooses the handle of a u32 filter (i.e., for a
+    // new priority), the handles of the following filters can only be
+    // generated once the filter exists (see `encodeFilter()`).
+    if (rtnl_tc_get_kind(TC_CAST(cls.get().get())) == std::string("u32") &&
+        rtnl_tc_get_handle(TC_CAST(cls.get().get())) == 0) {
+      Try<Nothing> submitted = submit();
+      if (submitted.isError()) {
+        return Error(submitted.error());
+      }
+
+      classifiers.erase(parent);
+      handles.erase(parent);
+    }
+  }
+
+  Try<Nothing> submitted = submit();
+  if (submitted.isError()) {
+    return Error(submitted.error());
+  }
+
+  return results;
+}
+
+
 // Removes the filter attached to the given parent that matches the
 // specified classifier from the link. Returns false if such a filter
 // is not found. We use template here so that it works for any type of
@@ -689,6 +855,91 @@ Try<bool> remove(
 }
 
 
+// Removes the filters attached to the given parent that match the
+// specified classifiers from the link, submitting their requests to
+// the kernel in batches (see `routing::batch()`). Returns, in order,
+// false for each classifier whose filter is not found. We use
+// template here so that it works for any type of classifier.
+template <typename Classifier>
+Try<std::vector<bool>> remove(
+    const std::string& _link,
+    const Handle& parent,
+    const std::vector<Classifier>& classifiers)
+{
+  std::vector<bool> results(classifiers.size(), false);
+
+  Result<Netlink<struct rtnl_link>> link = link::internal::get(_link);
+  if (link.isError()) {
+    return Error(link.error());
+  } else if (link.isNone()) {
+    return results;
+  }
+
+  Try<std::vector<Netlink<struct rtnl_cls>>> clses =
+    getClses(link.get(), parent);
+
+  if (clses.isError()) {
+    return Error(clses.error());
+  }
+
+  // Decode the filters attached to the parent once for all the
+  // classifiers.
+  std::vector<std::pair<Classifier, Netlink<struct rtnl_cls>>> existing;
+
+  foreach (const Netlink<struct rtnl_cls>& cls, clses.get()) {
+    Result<Filter<Classifier>> filter = decodeFilter<Classifier>(cls);
+    if (filter.isError()) {
+      return Error("Failed to decode: " + filter.error());
+    } else if (filter.isSome()) {
+      existing.emplace_back(filter->classifier, cls);
+    }
+  }
+
+  std::vector<Netlink<struct nl_msg>> messages;
+  std::vector<size_t> indices;
+
+  for (size_t i = 0; i < classifiers.size(); i++) {
+    for (auto it = existing.begin(); it != existing.end(); ++it) {
+      if (it->first == classifiers[i]) {
+        struct nl_msg* msg = nullptr;
+        int error = rtnl_cls_build_delete_request(it->second.get(), 0, &msg);
+        if (error != 0) {
+          return Error(std::string(nl_geterror(error)));
+        }
+
+        messages.push_back(Netlink<struct nl_msg>(msg));
+        indices.push_back(i);
+
+        existing.erase(it);
+        break;
+      }
+    }
+  }
+
+  Try<Netlink<struct nl_sock>> socket = routing::socket();
+  if (socket.isError()) {
+    return Error(socket.error());
+  }
+
+  Try<std::vector<int>> errors = routing::batch(socket.get(), messages);
+  if (errors.isError()) {
+    return Error(errors.error());
+  }
+
+  for (size_t i = 0; i < indices.size(); i++) {
+    if (errors->at(i) != 0) {
+      // TODO(jieyu): Interpret the error code and return false if it
+      // indicates that the filter is not found.
+      return Error(std::string(nl_geterror(errors->at(i))));
+    }
+
+    results[indices[i]] = true;
+  }
+
+  return results;
+}
+
+
 // Updates the action of the filter attached to the given parent that
 // matches the specified classifier on the link. Returns false if such
 // a filter is not found. We use template here so that it works for
@@ -547,6 +547,14 @@ Try<bool> create(
 }
 
 
+Try<vector<bool>> create(
+    const string& link,
+    const vector<Filter<Classifier>>& filters)
+{
+  return internal::create(link, filters);
+}
+
+
 Try<bool> remove(
     const string& link,
     const Handle& parent,
@@ -556,6 +564,15 @@ Try<bool> remove(
 }
 
 
+Try<vector<bool>> remove(
+    const string& link,
+    const Handle& parent,
+    const vector<Classifier>& classifiers)
+{
+  return internal::remove(link, parent, classifiers);
+}
+
+
 Result<vector<Filter<Classifier>>> filters(
     const string& link,
     const Handle& parent)
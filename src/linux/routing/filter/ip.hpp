@@ -174,6 +174,16 @@ Try<bool> create(
     const Option<Handle>& classid);
 
 
+// Creates the IP packet filters on the link with a few netlink round
+// trips rather than one per filter. Returns, in order, false for each
+// filter attached to the same parent with the same classifier as an
+// existing filter. If an error is returned, some of the filters may
+// have been created.
+Try<std::vector<bool>> create(
+    const std::string& link,
+    const std::vector<Filter<Classifier>>& filters);
+
+
 // Removes the IP packet filter attached to the given parent that
 // matches the specified classifier from the link. Returns false if
 // such a filter is not found.
@@ -183,6 +193,16 @@ Try<bool> remove(
     const Classifier& classifier);
 
 
+// Removes the IP packet filters attached to the given parent that
+// match the specified classifiers from the link with a few netlink
+// round trips rather than one per filter. Returns, in order, false
+// for each classifier whose filter is not found.
+Try<std::vector<bool>> remove(
+    const std::string& link,
+    const Handle& parent,
+    const std::vector<Classifier>& classifiers);
+
+
 // Returns all the IP packet filters attached to the given parent on
 // the link. Returns none if the link or the parent is not found.
 Result<std::vector<Filter<Classifier>>> filters(
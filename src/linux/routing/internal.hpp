@@ -19,11 +19,14 @@
 
 #include <netlink/cache.h>
 #include <netlink/errno.h>
+#include <netlink/msg.h>
 #include <netlink/netlink.h>
 #include <netlink/socket.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <stout/error.hpp>
 #include <stout/try.hpp>
@@ -49,6 +52,13 @@ inline void cleanup(struct nl_sock* sock)
 }
 
 
+template <>
+inline void cleanup(struct nl_msg* msg)
+{
+  nlmsg_free(msg);
+}
+
+
 // A helper class for managing netlink objects (e.g., rtnl_link,
 // nl_sock, etc.). It manages the life cycle of a netlink object. It
 // is copyable and assignable, and multiple copies share the same
@@ -107,6 +117,56 @@ inline Try<Netlink<struct nl_sock>> socket(int protocol = NETLINK_ROUTE)
   return sock;
 }
 
+
+// The maximum number of netlink messages sent to the kernel at once
+// by `batch()`. This bounds the number of acknowledgements queued on
+// the socket, which would otherwise overflow its receive buffer.
+constexpr size_t MAX_BATCH_SIZE = 64;
+
+
+// Sends the netlink requests to the kernel, packing up to
+// `MAX_BATCH_SIZE` of them into a single `sendmsg`, and then waits
+// for their acknowledgements. Returns the libnl error code of each
+// request (0 on success) in order. The kernel processes the requests
+// in order and keeps going if one of them fails.
+inline Try<std::vector<int>> batch(
+    const Netlink<struct nl_sock>& sock,
+    const std::vector<Netlink<struct nl_msg>>& messages)
+{
+  std::vector<int> errors;
+  errors.reserve(messages.size());
+
+  for (size_t begin = 0; begin < messages.size(); begin += MAX_BATCH_SIZE) {
+    const size_t end = std::min(begin + MAX_BATCH_SIZE, messages.size());
+
+    std::string buffer;
+    for (size_t i = begin; i < end; i++) {
+      // Sets the sequence number and requests an acknowledgement.
+      nl_complete_msg(sock.get(), messages[i].get());
+
+      const struct nlmsghdr* header = nlmsg_hdr(messages[i].get());
+      buffer.append(
+          reinterpret_cast<const char*>(header),
+          NLMSG_ALIGN(header->nlmsg_len));
+    }
+
+    int sent = nl_sendto(sock.get(), &buffer[0], buffer.size());
+    if (sent < 0) {
+      return Error(
+          "Failed to send netlink messages: " +
+          std::string(nl_geterror(sent)));
+    }
+
+    // NOTE: Each acknowledgement is a separate netlink message, which
+    // also carries the error of the corresponding request, if any.
+    for (size_t i = begin; i < end; i++) {
+      errors.push_back(nl_wait_for_ack(sock.get()));
+    }
+  }
+
+  return errors;
+}
+
 } // namespace routing {
 
 #endif // __LINUX_ROUTING_INTERNAL_HPP__
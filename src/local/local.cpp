@@ -79,6 +79,8 @@
 
 #include "module/manager.hpp"
 
+#include "secret/caching_resolver.hpp"
+
 #include "slave/gc.hpp"
 #include "slave/slave.hpp"
 #include "slave/task_status_update_manager.hpp"
@@ -423,7 +425,7 @@ PID<Master> launch(const Flags& flags, Allocator* _allocator)
         << slaveFlags.runtime_dir << "': " << mkdir.error();
     }
 
-    garbageCollectors->push_back(new GarbageCollector());
+    garbageCollectors->push_back(new GarbageCollector(slaveFlags.work_dir));
     taskStatusUpdateManagers->push_back(
         new TaskStatusUpdateManager(slaveFlags));
     fetchers->push_back(new Fetcher(slaveFlags));
@@ -500,6 +502,11 @@ PID<Master> launch(const Flags& flags, Allocator* _allocator)
         << "Failed to initialize secret resolver: " << secretResolver.error();
     }
 
+    if (slaveFlags.secret_resolver.isSome()) {
+      secretResolver = new CachingSecretResolver(
+          secretResolver.get(), slaveFlags.secret_resolver_cache_ttl);
+    }
+
     Try<Containerizer*> containerizer = Containerizer::create(
         slaveFlags,
         true,
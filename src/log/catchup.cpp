@@ -16,13 +16,16 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <list>
+#include <set>
 
 #include <process/collect.hpp>
 #include <process/id.hpp>
 #include <process/process.hpp>
 #include <process/timer.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/lambda.hpp>
 #include <stout/stringify.hpp>
 
@@ -34,6 +37,7 @@
 using namespace process;
 
 using std::list;
+using std::set;
 
 namespace mesos {
 namespace internal {
@@ -165,6 +169,202 @@ static Future<uint64_t> catchup(
 }
 
 
+// The maximum number of positions asked for with a single transfer
+// request. The replica that responds may cover fewer positions in
+// order to bound the size of its response.
+static const uint64_t TRANSFER_CHUNK_SIZE = 1000;
+
+
+// Copies the actions that the other replicas in the network have
+// learned for a range of positions to the local replica, a chunk at a
+// time. Since a learned action has already been agreed on, it can be
+// persisted by the local replica as is, which is much cheaper than
+// running Paxos for each position. Each chunk is taken from the first
+// replica that responds. This is best-effort: the transfer stops at
+// the first chunk that no other replica responds to in time (e.g.,
+// because only older replicas, which do not support transfers, are
+// reachable), and the positions it did not catch-up are left to be
+// filled using Paxos.
+class TransferProcess : public Process<TransferProcess>
+{
+public:
+  TransferProcess(
+      const Shared<Replica>& _replica,
+      const Shared<Network>& _network,
+      const Interval<uint64_t>& _positions,
+      const Duration& _timeout)
+    : ProcessBase(ID::generate("log-transfer")),
+      replica(_replica),
+      network(_network),
+      positions(_positions),
+      timeout(_timeout) {}
+
+  virtual ~TransferProcess() {}
+
+  Future<Nothing> future() { return promise.future(); }
+
+protected:
+  virtual void initialize()
+  {
+    // Stop when no one cares.
+    promise.future().onDiscard(lambda::bind(
+        static_cast<void(*)(const UPID&, bool)>(terminate), self(), true));
+
+    current = positions.lower();
+
+    transfer();
+  }
+
+  virtual void finalize()
+  {
+    transferring.discard();
+
+    foreach (Future<TransferResponse> response, responses) {
+      response.discard();
+    }
+
+    promise.discard();
+  }
+
+private:
+  static void timedout(Future<uint64_t> transferring)
+  {
+    transferring.discard();
+  }
+
+  void transfer()
+  {
+    if (current >= positions.upper()) {
+      promise.set(Nothing());
+      terminate(self());
+      return;
+    }
+
+    TransferRequest request;
+    request.set_from(current);
+    request.set_to(
+        std::min(positions.upper() - 1, current + TRANSFER_CHUNK_SIZE - 1));
+
+    VLOG(2) << "Requesting the learned actions for positions "
+            << request.from() << " -> " << request.to();
+
+    // There is no point in asking the local replica.
+    transferring =
+      network->broadcast(protocol::transfer, request, {replica->pid()})
+        .then(defer(self(), &Self::receive, lambda::_1))
+        .then(defer(self(), &Self::learn, lambda::_1));
+
+    transferring.onAny(defer(self(), &Self::transferred));
+
+    Clock::timer(timeout, lambda::bind(&Self::timedout, transferring));
+  }
+
+  Future<Future<TransferResponse>> receive(
+      const set<Future<TransferResponse>>& _responses)
+  {
+    if (_responses.empty()) {
+      return Failure("No other replicas in the network");
+    }
+
+    responses = _responses;
+
+    // NOTE: Failed responses are not selected, so this only fails
+    // (once discarded) if no replica responds in time.
+    return select(responses);
+  }
+
+  Future<uint64_t> learn(const Future<TransferResponse>& future)
+  {
+    // Enforced by the select semantics.
+    CHECK_READY(future);
+
+    const TransferResponse& response = future.get();
+
+    if (response.to() < current) {
+      return Failure("Unexpected transfer response");
+    }
+
+    list<Action> actions;
+    foreach (const Action& action, response.actions()) {
+      if (action.position() >= current && action.position() <= response.to()) {
+        actions.push_back(action);
+      }
+    }
+
+    // We continue after the positions covered by this response, even
+    // if the range requested was larger.
+    const uint64_t next = std::min(response.to(), positions.upper() - 1) + 1;
+
+    return replica->learn(actions)
+      .then(defer(self(), &Self::learned, lambda::_1, next));
+  }
+
+  Future<uint64_t> learned(bool learned, uint64_t next)
+  {
+    if (!learned) {
+      return Failure("Failed to persist the learned actions");
+    }
+
+    return next;
+  }
+
+  void transferred()
+  {
+    // The other responses are no longer needed.
+    foreach (Future<TransferResponse> response, responses) {
+      response.discard();
+    }
+
+    responses.clear();
+
+    if (transferring.isReady()) {
+      current = transferring.get();
+      transfer();
+      return;
+    }
+
+    LOG(INFO) << "Stopped transferring learned actions at position "
+              << current << ": "
+              << (transferring.isFailed()
+                  ? transferring.failure()
+                  : "no replica responded in " + stringify(timeout));
+
+    promise.set(Nothing());
+    terminate(self());
+  }
+
+  const Shared<Replica> replica;
+  const Shared<Network> network;
+  const Interval<uint64_t> positions;
+  const Duration timeout;
+
+  uint64_t current;
+
+  process::Promise<Nothing> promise;
+  Future<uint64_t> transferring;
+  set<Future<TransferResponse>> responses;
+};
+
+
+static Future<Nothing> transfer(
+    const Shared<Replica>& replica,
+    const Shared<Network>& network,
+    const Interval<uint64_t>& positions,
+    const Duration& timeout)
+{
+  TransferProcess* process =
+    new TransferProcess(
+        replica,
+        network,
+        positions,
+        timeout);
+
+  Future<Nothing> future = process->future();
+  spawn(process, true);
+  return future;
+}
+
+
 // TODO(jieyu): Our current implementation catches-up each position in
 // the set sequentially. In the future, we may want to parallelize it
 // to improve the performance. Also, we may want to implement rate
@@ -332,7 +532,19 @@ Future<Nothing> catchup(
 
   Future<Nothing> future = Nothing();
 
+  // We first copy the actions that other replicas have already
+  // learned and then run Paxos for the positions that are still
+  // missing (if any). The latter is cheap for positions that have
+  // been copied, as they are checked locally first.
   foreach (const Interval<uint64_t>& interval, positions) {
+    future = future.then(
+        lambda::bind(
+            &transfer,
+            replica,
+            network,
+            interval,
+            timeout));
+
     future = future.then(
         lambda::bind(
             f,
@@ -17,14 +17,17 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <deque>
 
 #include <mesos/type_utils.hpp>
 
 #include <process/defer.hpp>
 #include <process/dispatch.hpp>
 #include <process/id.hpp>
+#include <process/owned.hpp>
 #include <process/process.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/none.hpp>
 
 #include "log/catchup.hpp"
@@ -35,6 +38,7 @@
 
 using namespace process;
 
+using std::deque;
 using std::string;
 
 namespace mesos {
@@ -68,7 +72,11 @@ protected:
   virtual void finalize()
   {
     electing.discard();
-    writing.discard();
+
+    foreach (Write& write, writing) {
+      write.future.discard();
+      write.promise->discard();
+    }
   }
 
 private:
@@ -99,10 +107,13 @@ private:
       const WriteResponse& response);
   Future<Nothing> runLearnPhase(const Action& action);
   Future<bool> checkLearnPhase(const Action& action);
-  Future<Option<uint64_t>> updateIndexAfterWritten(bool missing);
+  Future<Option<uint64_t>> checkIndexAfterWritten(
+      const Action& action,
+      bool missing);
   void writingFinished();
   void writingFailed();
   void writingAborted();
+  void returnWritten();
 
   const size_t quorum;
   const Shared<Replica> replica;
@@ -121,7 +132,6 @@ private:
     INITIAL,
     ELECTING,
     ELECTED,
-    WRITING,
   } state;
 
   // The current proposal number used by this coordinator.
@@ -131,7 +141,20 @@ private:
   uint64_t index;
 
   Future<Option<uint64_t>> electing;
-  Future<Option<uint64_t>> writing;
+
+  // The writes (appends and truncates) that are in progress, in
+  // position order. An elected coordinator does not wait for a write
+  // to finish before it starts writing the next position, so several
+  // positions may be in flight at once. Each write is returned to the
+  // caller through its promise once all of the preceding writes have
+  // been returned, see 'returnWritten()'.
+  struct Write
+  {
+    Future<Option<uint64_t>> future;
+    Owned<process::Promise<Option<uint64_t>>> promise;
+  };
+
+  deque<Write> writing;
 };
 
 
@@ -142,12 +165,12 @@ private:
 
 Future<Option<uint64_t>> CoordinatorProcess::elect()
 {
-  if (state == ELECTING) {
+  if (!writing.empty()) {
+    return Failure("Coordinator already elected, and is currently writing");
+  } else if (state == ELECTING) {
     return electing;
   } else if (state == ELECTED) {
     return index - 1; // The last learned position!
-  } else if (state == WRITING) {
-    return Failure("Coordinator already elected, and is currently writing");
   }
 
   CHECK_EQ(state, INITIAL);
@@ -283,12 +306,12 @@ void CoordinatorProcess::electingAborted()
 
 Future<uint64_t> CoordinatorProcess::demote()
 {
-  if (state == INITIAL) {
+  if (!writing.empty()) {
+    return Failure("Coordinator is currently writing");
+  } else if (state == INITIAL) {
     return Failure("Coordinator is not elected");
   } else if (state == ELECTING) {
     return Failure("Coordinator is being elected");
-  } else if (state == WRITING) {
-    return Failure("Coordinator is currently writing");
   }
 
   CHECK_EQ(state, ELECTED);
@@ -307,12 +330,10 @@ Future<Option<uint64_t>> CoordinatorProcess::append(const string& bytes)
 {
   if (state == INITIAL || state == ELECTING) {
     return None();
-  } else if (state == WRITING) {
-    return Failure("Coordinator is currently writing");
   }
 
   Action action;
-  action.set_position(index);
+  action.set_position(index++);
   action.set_promised(proposal);
   action.set_performed(proposal);
   action.set_type(Action::APPEND);
@@ -327,12 +348,10 @@ Future<Option<uint64_t>> CoordinatorProcess::truncate(uint64_t to)
 {
   if (state == INITIAL || state == ELECTING) {
     return None();
-  } else if (state == WRITING) {
-    return Failure("Coordinator is currently writing");
   }
 
   Action action;
-  action.set_position(index);
+  action.set_position(index++);
   action.set_promised(proposal);
   action.set_performed(proposal);
   action.set_type(Action::TRUNCATE);
@@ -351,15 +370,25 @@ Future<Option<uint64_t>> CoordinatorProcess::write(const Action& action)
   CHECK_EQ(state, ELECTED);
   CHECK(action.has_performed() && action.has_type());
 
-  state = WRITING;
+  Write write;
 
-  writing = runWritePhase(action)
+  write.future = runWritePhase(action)
     .then(defer(self(), &Self::checkWritePhase, action, lambda::_1))
     .onReady(defer(self(), &Self::writingFinished))
     .onFailed(defer(self(), &Self::writingFailed))
     .onDiscarded(defer(self(), &Self::writingAborted));
 
-  return writing;
+  write.promise.reset(new process::Promise<Option<uint64_t>>());
+
+  // Discarding the returned future only discards this write, the
+  // preceding writes are still returned first.
+  Future<Option<uint64_t>> future = write.future;
+  write.promise->future()
+    .onDiscard([future]() mutable { future.discard(); });
+
+  writing.push_back(write);
+
+  return write.promise->future();
 }
 
 
@@ -378,12 +407,18 @@ Future<Option<uint64_t>> CoordinatorProcess::checkWritePhase(
     CHECK_LE(proposal, response.proposal());
     proposal = response.proposal();
 
+    // Another coordinator has been elected, so any writes that are
+    // still in flight will be rejected as well. We get demoted so that
+    // we fill this position if we are elected again, since we have
+    // already written past it.
+    state = INITIAL;
+
     return None();
   }
 
   return runLearnPhase(action)
     .then(defer(self(), &Self::checkLearnPhase, action))
-    .then(defer(self(), &Self::updateIndexAfterWritten, lambda::_1));
+    .then(defer(self(), &Self::checkIndexAfterWritten, action, lambda::_1));
 }
 
 
@@ -402,39 +437,64 @@ Future<bool> CoordinatorProcess::checkLearnPhase(const Action& action)
 }
 
 
-Future<Option<uint64_t>> CoordinatorProcess::updateIndexAfterWritten(
+Future<Option<uint64_t>> CoordinatorProcess::checkIndexAfterWritten(
+    const Action& action,
     bool missing)
 {
   CHECK(!missing) << "Not expecting local replica to be missing position "
-                  << index << " after the writing is done";
+                  << action.position() << " after the writing is done";
 
-  return index++;
+  return action.position();
 }
 
 
 void CoordinatorProcess::writingFinished()
 {
-  CHECK_EQ(state, WRITING);
-  state = ELECTED;
+  returnWritten();
 }
 
 
 void CoordinatorProcess::writingFailed()
 {
-  CHECK_EQ(state, WRITING);
+  // The writes that are still in flight are returned as usual, but
+  // no more writes are accepted until the coordinator is elected
+  // again.
   state = INITIAL;
+
+  returnWritten();
 }
 
 
 void CoordinatorProcess::writingAborted()
 {
-  CHECK_EQ(state, WRITING);
-
   // Demote the coordinator if a write operation is discarded since we
   // don't actually know the write was successful or not and we really
   // need to "catch-up" that position before we try and do another
   // write (see MESOS-1038 for more details).
   state = INITIAL;
+
+  returnWritten();
+}
+
+
+void CoordinatorProcess::returnWritten()
+{
+  // Positions may finish out of order when several writes are in
+  // flight, but callers (e.g., the log writer) expect to observe the
+  // writes in the order in which they were made.
+  while (!writing.empty() && !writing.front().future.isPending()) {
+    Write write = writing.front();
+    writing.pop_front();
+
+    // The handlers above may not have run yet for this write, so we
+    // make sure the coordinator is demoted before the caller learns
+    // about the failure.
+    if (!write.future.isReady()) {
+      state = INITIAL;
+    }
+
+    write.promise->associate(write.future);
+  }
 }
 
 
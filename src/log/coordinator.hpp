@@ -61,6 +61,10 @@ public:
   // Appends the specified bytes to the end of the log. Returns the
   // position of the appended entry if the operation succeeds or none
   // if the coordinator was demoted.
+  //
+  // NOTE: Appends and truncates do not need to wait for the previous
+  // ones to finish; several of them may be in flight at once, and
+  // their results are returned in the order in which they were made.
   process::Future<Option<uint64_t>> append(const std::string& bytes);
 
   // Removes all log entries preceding the log entry at the given
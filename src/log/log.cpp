@@ -67,10 +67,11 @@ LogProcess::LogProcess(
     const string& path,
     const set<UPID>& pids,
     bool _autoInitialize,
-    const Option<string>& metricsPrefix)
+    const Option<string>& metricsPrefix,
+    bool batchWrites)
   : ProcessBase(ID::generate("log")),
     quorum(_quorum),
-    replica(new Replica(path)),
+    replica(new Replica(path, batchWrites)),
     network(new Network(pids + (UPID) replica->pid())),
     autoInitialize(_autoInitialize),
     group(nullptr),
@@ -85,10 +86,11 @@ LogProcess::LogProcess(
     const string& znode,
     const Option<zookeeper::Authentication>& auth,
     bool _autoInitialize,
-    const Option<string>& metricsPrefix)
+    const Option<string>& metricsPrefix,
+    bool batchWrites)
   : ProcessBase(ID::generate("log")),
     quorum(_quorum),
-    replica(new Replica(path)),
+    replica(new Replica(path, batchWrites)),
     network(new ZooKeeperNetwork(
         servers,
         timeout,
@@ -623,7 +625,8 @@ Log::Log(
     const string& path,
     const set<UPID>& pids,
     bool autoInitialize,
-    const Option<string>& metricsPrefix)
+    const Option<string>& metricsPrefix,
+    bool batchWrites)
 {
   GOOGLE_PROTOBUF_VERIFY_VERSION;
 
@@ -633,7 +636,8 @@ Log::Log(
         path,
         pids,
         autoInitialize,
-        metricsPrefix);
+        metricsPrefix,
+        batchWrites);
 
   spawn(process);
 }
@@ -647,7 +651,8 @@ Log::Log(
     const string& znode,
     const Option<zookeeper::Authentication>& auth,
     bool autoInitialize,
-    const Option<string>& metricsPrefix)
+    const Option<string>& metricsPrefix,
+    bool batchWrites)
 {
   GOOGLE_PROTOBUF_VERIFY_VERSION;
 
@@ -660,7 +665,8 @@ Log::Log(
         znode,
         auth,
         autoInitialize,
-        metricsPrefix);
+        metricsPrefix,
+        batchWrites);
 
   spawn(process);
 }
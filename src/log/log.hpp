@@ -48,7 +48,8 @@ public:
       const std::string& path,
       const std::set<process::UPID>& pids,
       bool _autoInitialize,
-      const Option<std::string>& metricsPrefix);
+      const Option<std::string>& metricsPrefix,
+      bool batchWrites);
 
   LogProcess(
       size_t _quorum,
@@ -58,7 +59,8 @@ public:
       const std::string& znode,
       const Option<zookeeper::Authentication>& auth,
       bool _autoInitialize,
-      const Option<std::string>& metricsPrefix);
+      const Option<std::string>& metricsPrefix,
+      bool batchWrites);
 
   // Recovers the log by catching up if needed. Returns a shared
   // pointer to the local replica if the recovery succeeds.
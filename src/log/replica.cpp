@@ -17,16 +17,21 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include <mesos/type_utils.hpp>
 
 #include <process/dispatch.hpp>
 #include <process/id.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/check.hpp>
 #include <stout/error.hpp>
 #include <stout/exit.hpp>
 #include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/lambda.hpp>
 #include <stout/none.hpp>
 #include <stout/nothing.hpp>
 #include <stout/result.hpp>
@@ -43,6 +48,7 @@ using namespace process;
 
 using std::list;
 using std::string;
+using std::vector;
 
 namespace mesos {
 namespace internal {
@@ -54,16 +60,23 @@ namespace protocol {
 Protocol<PromiseRequest, PromiseResponse> promise;
 Protocol<WriteRequest, WriteResponse> write;
 Protocol<RecoverRequest, RecoverResponse> recover;
+Protocol<TransferRequest, TransferResponse> transfer;
 
 } // namespace protocol {
 
 
+// The (approximate) maximum size of the actions in a response to a
+// transfer request.
+static const Bytes MAX_TRANSFER_SIZE = Megabytes(4);
+
+
 class ReplicaProcess : public ProtobufProcess<ReplicaProcess>
 {
 public:
   // Constructs a new replica process using specified path to a
-  // directory for storing the underlying log.
-  explicit ReplicaProcess(const string& path);
+  // directory for storing the underlying log. See 'Replica' for a
+  // description of 'batchWrites'.
+  ReplicaProcess(const string& path, bool batchWrites);
 
   virtual ~ReplicaProcess();
 
@@ -99,6 +112,11 @@ public:
   // Returns the highest implicit promise this replica has given.
   uint64_t promised();
 
+  // Persists the specified learned actions, skipping the positions
+  // that are already learned or truncated. Returns true on success and
+  // false otherwise.
+  bool learn(const list<Action>& actions);
+
   // Updates the status of this replica. The update will be persisted
   // to storage. Returns true on success and false otherwise.
   bool update(const Metadata::Status& status);
@@ -114,12 +132,36 @@ private:
   // Handles a request from a recover process.
   void recover(const UPID& from, const RecoverRequest& request);
 
+  // Handles a request from a replica that is catching up for the
+  // actions learned in a range of positions.
+  void transfer(const UPID& from, const TransferRequest& request);
+
   // Handles a message notifying of a learned action.
   void learned(const UPID& from, const Action& action);
 
-  // Persists the specified action to storage. Returns true on success
-  // and false otherwise.
-  bool persist(const Action& action);
+  // Persists the specified action(s) to storage. Returns true on
+  // success and false otherwise. When writes are batched, the actions
+  // are only staged here and are persisted by the next 'flush()'.
+  bool persist(const Action& action, bool sync = true);
+  bool persist(const list<Action>& actions, bool sync = true);
+
+  // Persists all of the staged actions with a single write to
+  // storage and then sends the responses that were held back until
+  // the actions were persisted.
+  void flush();
+
+  // Sends the response to a protocol request. The response is held
+  // back while there are staged actions, since it may depend on them
+  // having been persisted.
+  template <typename Message>
+  void respond(const UPID& to, const Message& message)
+  {
+    if (staged.empty()) {
+      send(to, message);
+    } else {
+      responses.push_back([=]() { send(to, message); });
+    }
+  }
 
   // Updates the highest promise this replica has given. The update
   // will be persisted to storage. Returns true on success and false
@@ -132,6 +174,17 @@ private:
   // Underlying storage for the log.
   Storage* storage;
 
+  // Whether writes to the storage are batched, see 'Replica'.
+  const bool batchWrites;
+
+  // The actions that have been staged, but not yet persisted, keyed
+  // by position, and whether any of them need to be synced.
+  hashmap<uint64_t, Action> staged;
+  bool syncStaged;
+
+  // The responses that are waiting for the staged actions.
+  vector<lambda::function<void()>> responses;
+
   // The cached metadata for this replica. It includes the current
   // status of the replica and the last promise it made.
   Metadata metadata;
@@ -150,8 +203,10 @@ private:
 };
 
 
-ReplicaProcess::ReplicaProcess(const string& path)
+ReplicaProcess::ReplicaProcess(const string& path, bool _batchWrites)
   : ProcessBase(ID::generate("log-replica")),
+    batchWrites(_batchWrites),
+    syncStaged(false),
     begin(0),
     end(0)
 {
@@ -170,6 +225,9 @@ ReplicaProcess::ReplicaProcess(const string& path)
   install<RecoverRequest>(
       &ReplicaProcess::recover);
 
+  install<TransferRequest>(
+      &ReplicaProcess::transfer);
+
   install<LearnedMessage>(
       &ReplicaProcess::learned,
       &LearnedMessage::action);
@@ -190,6 +248,8 @@ Result<Action> ReplicaProcess::read(uint64_t position)
     return None(); // These semantics are assumed above!
   } else if (holes.contains(position)) {
     return None();
+  } else if (staged.contains(position)) {
+    return staged.at(position);
   }
 
   // Must exist in storage ...
@@ -224,21 +284,34 @@ Future<list<Action>> ReplicaProcess::read(uint64_t from, uint64_t to)
   VLOG(2) << "Starting read from '" << stringify(from) << "' to '"
           << stringify(to) << "'";
 
-  list<Action> actions;
+  // Make sure that the staged actions (if any) can be read.
+  flush();
 
-  for (uint64_t position = from; position <= to; position++) {
-    Result<Action> result = read(position);
+  Try<list<Action>> actions = storage->read(from, to);
 
-    if (result.isError()) {
-      process::Promise<list<Action>> promise;
-      promise.fail(result.error());
-      return promise.future();
-    } else if (result.isSome()) {
-      actions.push_back(result.get());
-    }
+  if (actions.isError()) {
+    process::Promise<list<Action>> promise;
+    promise.fail(actions.error());
+    return promise.future();
+  }
+
+  // Every position in the range, except for the holes, must have an
+  // action in storage.
+  IntervalSet<uint64_t> positions(
+      Bound<uint64_t>::closed(from),
+      Bound<uint64_t>::closed(to));
+
+  positions -= holes;
+
+  if (actions->size() != positions.size()) {
+    process::Promise<list<Action>> promise;
+    promise.fail(
+        "Expecting " + stringify(positions.size()) + " actions but only " +
+        stringify(actions->size()) + " were found in storage");
+    return promise.future();
   }
 
-  return actions;
+  return std::move(actions).get();
 }
 
 
@@ -306,8 +379,33 @@ uint64_t ReplicaProcess::promised()
 }
 
 
+bool ReplicaProcess::learn(const list<Action>& actions)
+{
+  list<Action> learned;
+
+  foreach (const Action& action, actions) {
+    if (!action.has_learned() || !action.learned()) {
+      LOG(WARNING) << "Ignoring unlearned action at position "
+                   << action.position();
+    } else if (missing(action.position())) {
+      learned.push_back(action);
+    }
+  }
+
+  if (learned.empty()) {
+    return true;
+  }
+
+  LOG(INFO) << "Persisting " << learned.size() << " learned actions";
+
+  return persist(learned);
+}
+
+
 bool ReplicaProcess::update(const Metadata::Status& status)
 {
+  flush();
+
   Metadata metadata_;
   metadata_.set_status(status);
   metadata_.set_promised(promised());
@@ -330,6 +428,10 @@ bool ReplicaProcess::update(const Metadata::Status& status)
 
 bool ReplicaProcess::updatePromised(uint64_t promised)
 {
+  // Make sure the metadata is never persisted ahead of the actions
+  // that were staged before it.
+  flush();
+
   Metadata metadata_;
   metadata_.set_status(status());
   metadata_.set_promised(promised);
@@ -383,7 +485,7 @@ void ReplicaProcess::promise(const UPID& from, const PromiseRequest& request)
     response.set_type(PromiseResponse::IGNORED);
     response.set_okay(false);
     response.set_proposal(request.proposal());
-    reply(response);
+    respond(from, response);
     return;
   }
 
@@ -419,7 +521,7 @@ void ReplicaProcess::promise(const UPID& from, const PromiseRequest& request)
       response.set_okay(true);
       response.set_proposal(request.proposal());
       response.mutable_action()->MergeFrom(action);
-      reply(response);
+      respond(from, response);
       return;
     }
 
@@ -452,7 +554,7 @@ void ReplicaProcess::promise(const UPID& from, const PromiseRequest& request)
         response.set_type(PromiseResponse::REJECT);
         response.set_okay(false);
         response.set_proposal(promised());
-        reply(response);
+        respond(from, response);
       } else {
         Action action;
         action.set_position(request.position());
@@ -464,7 +566,7 @@ void ReplicaProcess::promise(const UPID& from, const PromiseRequest& request)
           response.set_okay(true);
           response.set_proposal(request.proposal());
           response.set_position(request.position());
-          reply(response);
+          respond(from, response);
         }
       }
     } else {
@@ -477,7 +579,7 @@ void ReplicaProcess::promise(const UPID& from, const PromiseRequest& request)
         response.set_type(PromiseResponse::REJECT);
         response.set_okay(false);
         response.set_proposal(action.promised());
-        reply(response);
+        respond(from, response);
       } else {
         Action original = action;
         action.set_promised(request.proposal());
@@ -488,7 +590,7 @@ void ReplicaProcess::promise(const UPID& from, const PromiseRequest& request)
           response.set_okay(true);
           response.set_proposal(request.proposal());
           response.mutable_action()->MergeFrom(original);
-          reply(response);
+          respond(from, response);
         }
       }
     }
@@ -504,7 +606,7 @@ void ReplicaProcess::promise(const UPID& from, const PromiseRequest& request)
       response.set_type(PromiseResponse::REJECT);
       response.set_okay(false);
       response.set_proposal(promised());
-      reply(response);
+      respond(from, response);
     } else {
       if (updatePromised(request.proposal())) {
         // Return the last position written.
@@ -513,7 +615,7 @@ void ReplicaProcess::promise(const UPID& from, const PromiseRequest& request)
         response.set_okay(true);
         response.set_proposal(request.proposal());
         response.set_position(end);
-        reply(response);
+        respond(from, response);
       }
     }
   }
@@ -533,7 +635,7 @@ void ReplicaProcess::write(const UPID& from, const WriteRequest& request)
     response.set_okay(false);
     response.set_proposal(request.proposal());
     response.set_position(request.position());
-    reply(response);
+    respond(from, response);
     return;
   }
 
@@ -552,7 +654,7 @@ void ReplicaProcess::write(const UPID& from, const WriteRequest& request)
       response.set_okay(false);
       response.set_proposal(promised());
       response.set_position(request.position());
-      reply(response);
+      respond(from, response);
     } else {
       Action action;
       action.set_position(request.position());
@@ -584,7 +686,7 @@ void ReplicaProcess::write(const UPID& from, const WriteRequest& request)
         response.set_okay(true);
         response.set_proposal(request.proposal());
         response.set_position(request.position());
-        reply(response);
+        respond(from, response);
       }
     }
   } else if (result.isSome()) {
@@ -597,7 +699,7 @@ void ReplicaProcess::write(const UPID& from, const WriteRequest& request)
       response.set_okay(false);
       response.set_proposal(action.promised());
       response.set_position(request.position());
-      reply(response);
+      respond(from, response);
     } else {
       if (action.has_learned() && action.learned()) {
         // We ignore the write request if this position has already
@@ -663,7 +765,7 @@ void ReplicaProcess::write(const UPID& from, const WriteRequest& request)
           response.set_okay(true);
           response.set_proposal(request.proposal());
           response.set_position(request.position());
-          reply(response);
+          respond(from, response);
         }
       }
     }
@@ -689,64 +791,177 @@ void ReplicaProcess::recover(const UPID& from, const RecoverRequest& request)
 }
 
 
+void ReplicaProcess::transfer(
+    const UPID& from,
+    const TransferRequest& request)
+{
+  LOG(INFO) << "Replica received transfer request for positions "
+            << request.from() << " -> " << request.to() << " from " << from;
+
+  TransferResponse response;
+  response.set_to(request.to());
+
+  // NOTE: Truncated positions (i.e., those before 'begin') and
+  // positions past 'end' can't have been learned by this replica.
+  const uint64_t first = std::max(request.from(), begin);
+  const uint64_t last = std::min(request.to(), end);
+
+  if (first <= last) {
+    // Make sure that the staged actions (if any) can be read.
+    flush();
+
+    // Bound the size of the response. The requester will ask for the
+    // rest of the range with another request.
+    Try<list<Action>> actions = storage->read(first, last, MAX_TRANSFER_SIZE);
+
+    if (actions.isError()) {
+      LOG(ERROR) << "Error getting log records from " << first
+                 << " to " << last << ": " << actions.error();
+      return;
+    }
+
+    foreach (const Action& action, actions.get()) {
+      if (action.has_learned() && action.learned()) {
+        response.add_actions()->CopyFrom(action);
+      }
+    }
+
+    if (!actions->empty() && actions->back().position() < last) {
+      response.set_to(actions->back().position());
+    }
+  }
+
+  respond(from, response);
+}
+
+
 void ReplicaProcess::learned(const UPID& from, const Action& action)
 {
   LOG(INFO) << "Replica received learned notice for position "
             << action.position() << " from " << from;
 
   CHECK(action.learned());
-  persist(action);
+
+  // When writes are batched we don't sync learned notices since
+  // losing one is harmless: the action itself has already been
+  // persisted (and synced) by the write request, and a position that
+  // is still unlearned after a restart gets learned again via
+  // catch-up.
+  persist(action, !batchWrites);
 }
 
 
-bool ReplicaProcess::persist(const Action& action)
+bool ReplicaProcess::persist(const Action& action, bool _sync)
 {
-  Try<Nothing> persisted = storage->persist(action);
+  return persist(list<Action>({action}), _sync);
+}
 
-  if (persisted.isError()) {
-    LOG(ERROR) << "Error writing to log: " << persisted.error();
-    return false;
+
+bool ReplicaProcess::persist(const list<Action>& actions, bool _sync)
+{
+  if (batchWrites) {
+    // Flush the staged actions after all of the requests that are
+    // already queued for this replica have been handled, so that
+    // concurrent requests share a single write.
+    if (staged.empty()) {
+      dispatch(self(), &ReplicaProcess::flush);
+    }
+
+    foreach (const Action& action, actions) {
+      staged[action.position()] = action;
+
+      VLOG(1) << "Staged action " << action.type()
+              << " at position " << action.position();
+    }
+
+    syncStaged = syncStaged || _sync;
+  } else {
+    Try<Nothing> persisted = storage->persist(actions, _sync);
+
+    if (persisted.isError()) {
+      LOG(ERROR) << "Error writing to log: " << persisted.error();
+      return false;
+    }
+
+    foreach (const Action& action, actions) {
+      VLOG(1) << "Persisted action " << action.type()
+              << " at position " << action.position();
+    }
   }
 
-  VLOG(1) << "Persisted action " << action.type()
-          << " at position " << action.position();
+  foreach (const Action& action, actions) {
+    // No longer a hole here (if there even was one).
+    holes -= action.position();
 
-  // No longer a hole here (if there even was one).
-  holes -= action.position();
+    // Update unlearned positions and deal with truncation actions.
+    if (action.has_learned() && action.learned()) {
+      unlearned -= action.position();
 
-  // Update unlearned positions and deal with truncation actions.
-  if (action.has_learned() && action.learned()) {
-    unlearned -= action.position();
+      if (action.has_type() && action.type() == Action::TRUNCATE) {
+        // No longer consider truncated positions as holes (so that a
+        // coordinator doesn't try and fill them).
+        holes -= (Bound<uint64_t>::open(0),
+                  Bound<uint64_t>::open(action.truncate().to()));
 
-    if (action.has_type() && action.type() == Action::TRUNCATE) {
-      // No longer consider truncated positions as holes (so that a
-      // coordinator doesn't try and fill them).
-      holes -= (Bound<uint64_t>::open(0),
-                Bound<uint64_t>::open(action.truncate().to()));
+        // No longer consider truncated positions as unlearned (so that
+        // a coordinator doesn't try and fill them).
+        unlearned -= (Bound<uint64_t>::open(0),
+                      Bound<uint64_t>::open(action.truncate().to()));
 
-      // No longer consider truncated positions as unlearned (so that
-      // a coordinator doesn't try and fill them).
-      unlearned -= (Bound<uint64_t>::open(0),
-                    Bound<uint64_t>::open(action.truncate().to()));
+        // And update the beginning position.
+        begin = std::max(begin, action.truncate().to());
+      }
+    } else {
+      // We just introduced an unlearned position.
+      unlearned += action.position();
+    }
 
-      // And update the beginning position.
-      begin = std::max(begin, action.truncate().to());
+    // Update holes if we just wrote many positions past the last end.
+    if (action.position() > end) {
+      holes += (Bound<uint64_t>::open(end),
+                Bound<uint64_t>::open(action.position()));
     }
-  } else {
-    // We just introduced an unlearned position.
-    unlearned += action.position();
+
+    // And update the end position.
+    end = std::max(end, action.position());
   }
 
-  // Update holes if we just wrote many positions past the last end.
-  if (action.position() > end) {
-    holes += (Bound<uint64_t>::open(end),
-              Bound<uint64_t>::open(action.position()));
+  return true;
+}
+
+
+void ReplicaProcess::flush()
+{
+  if (staged.empty()) {
+    return;
   }
 
-  // And update the end position.
-  end = std::max(end, action.position());
+  list<Action> actions;
+  foreachvalue (const Action& action, staged) {
+    actions.push_back(action);
+  }
 
-  return true;
+  Try<Nothing> persisted = storage->persist(actions, syncStaged);
+
+  // The staged actions are already reflected in the state of this
+  // replica (e.g., its holes and unlearned positions), so we can't
+  // simply ignore the failure as we do for unbatched writes.
+  if (persisted.isError()) {
+    EXIT(EXIT_FAILURE) << "Failed to persist " << actions.size()
+                       << " actions to the log: " << persisted.error();
+  }
+
+  VLOG(1) << "Persisted " << actions.size() << " staged actions";
+
+  staged.clear();
+  syncStaged = false;
+
+  vector<lambda::function<void()>> responses_;
+  std::swap(responses, responses_);
+
+  foreach (const lambda::function<void()>& response, responses_) {
+    response();
+  }
 }
 
 
@@ -783,9 +998,9 @@ void ReplicaProcess::restore(const string& path)
 }
 
 
-Replica::Replica(const string& path)
+Replica::Replica(const string& path, bool batchWrites)
 {
-  process = new ReplicaProcess(path);
+  process = new ReplicaProcess(path, batchWrites);
   spawn(process);
 }
 
@@ -841,6 +1056,12 @@ Future<uint64_t> Replica::promised() const
 }
 
 
+Future<bool> Replica::learn(const list<Action>& actions) const
+{
+  return dispatch(process, &ReplicaProcess::learn, actions);
+}
+
+
 Future<bool> Replica::update(const Metadata::Status& status)
 {
   return dispatch(process, &ReplicaProcess::update, status);
@@ -40,6 +40,7 @@ namespace protocol {
 extern Protocol<PromiseRequest, PromiseResponse> promise;
 extern Protocol<WriteRequest, WriteResponse> write;
 extern Protocol<RecoverRequest, RecoverResponse> recover;
+extern Protocol<TransferRequest, TransferResponse> transfer;
 
 } // namespace protocol {
 
@@ -57,7 +58,11 @@ public:
   // reply to any request except the recover request). The recover
   // process will later decide if this replica can be re-allowed to
   // vote depending on the status of other replicas.
-  explicit Replica(const std::string& path);
+  //
+  // If 'batchWrites' is true, the actions written by concurrent
+  // requests are persisted together with a single synchronous write,
+  // and learned notices are persisted without syncing.
+  explicit Replica(const std::string& path, bool batchWrites = false);
   virtual ~Replica();
 
   // Returns all the actions between the specified positions, unless
@@ -89,6 +94,12 @@ public:
   // Returns the highest implicit promise this replica has given.
   process::Future<uint64_t> promised() const;
 
+  // Persists the specified actions, which must have been learned
+  // (e.g., by another replica), at once. Actions for positions that
+  // this replica has already learned or truncated are skipped.
+  // Returns true on success and false otherwise.
+  process::Future<bool> learn(const std::list<Action>& actions) const;
+
   // Updates the status of this replica. Returns true if status was
   // updated successfully, false otherwise. Made "virtual" for
   // mocking in tests.
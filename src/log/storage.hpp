@@ -19,10 +19,15 @@
 
 #include <stdint.h>
 
+#include <list>
 #include <string>
 
+#include <stout/bytes.hpp>
+#include <stout/foreach.hpp>
 #include <stout/interval.hpp>
+#include <stout/none.hpp>
 #include <stout/nothing.hpp>
+#include <stout/option.hpp>
 #include <stout/try.hpp>
 
 #include "messages/log.hpp"
@@ -53,7 +58,32 @@ public:
   virtual Try<State> restore(const std::string& path) = 0;
   virtual Try<Nothing> persist(const Metadata& metadata) = 0;
   virtual Try<Nothing> persist(const Action& action) = 0;
+
+  // Persists the specified actions at once. If 'sync' is false the
+  // actions may be lost if the machine (but not just the process)
+  // crashes. By default the actions are persisted one at a time.
+  virtual Try<Nothing> persist(const std::list<Action>& actions, bool sync)
+  {
+    foreach (const Action& action, actions) {
+      Try<Nothing> persisted = persist(action);
+      if (persisted.isError()) {
+        return persisted;
+      }
+    }
+
+    return Nothing();
+  }
+
   virtual Try<Action> read(uint64_t position) = 0;
+
+  // Returns the actions persisted for the positions between 'from'
+  // and 'to' (inclusive) in position order, skipping the positions
+  // that have no action. If 'limit' is given, stops early once the
+  // size of the actions read reaches 'limit'.
+  virtual Try<std::list<Action>> read(
+      uint64_t from,
+      uint64_t to,
+      const Option<Bytes>& limit = None()) = 0;
 };
 
 } // namespace log {
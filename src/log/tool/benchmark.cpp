@@ -17,6 +17,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <deque>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -25,6 +27,7 @@
 
 #include <process/clock.hpp>
 #include <process/future.hpp>
+#include <process/owned.hpp>
 #include <process/process.hpp>
 #include <process/time.hpp>
 
@@ -44,6 +47,7 @@
 using namespace process;
 
 using std::cout;
+using std::deque;
 using std::endl;
 using std::ifstream;
 using std::ofstream;
@@ -80,6 +84,16 @@ Benchmark::Flags::Flags()
       "Path to the input trace file. Each line in the trace file\n"
       "specifies the size of the append (e.g. 100B, 2MB, etc.)");
 
+  add(&Flags::appends,
+      "appends",
+      "Number of appends of `--size` bytes each, to use instead of\n"
+      "a trace file, e.g., to model the large writes of the registrar");
+
+  add(&Flags::size,
+      "size",
+      "Size of each append when using `--appends`",
+      Bytes(1, Bytes::MEGABYTES));
+
   add(&Flags::output,
       "output",
       "Path to the output file");
@@ -92,6 +106,30 @@ Benchmark::Flags::Flags()
       "  random: all bits are randomly chosen\n",
       "random");
 
+  add(&Flags::concurrency,
+      "concurrency",
+      "Maximum number of appends in flight at once. With more than\n"
+      "one, the appends get pipelined by the writer",
+      1);
+
+  add(&Flags::truncate_interval,
+      "truncate_interval",
+      "If set, truncates the log up to the latest append after every\n"
+      "this many appends, like the registrar does after its writes");
+
+  add(&Flags::batch_writes,
+      "batch_writes",
+      "Whether the local replica persists the writes of concurrent\n"
+      "requests together with a single synchronous write, see\n"
+      "`mesos::log::Log`",
+      false);
+
+  add(&Flags::catchup_path,
+      "catchup_path",
+      "If set, starts another replica backed by a log at this path\n"
+      "once the appends are done, and measures how long it takes to\n"
+      "catch up with the log");
+
   add(&Flags::initialize,
       "initialize",
       "Whether to initialize the log",
@@ -99,6 +137,54 @@ Benchmark::Flags::Flags()
 }
 
 
+// Returns the given percentile of the durations.
+static Duration percentile(vector<Duration> durations, double percent)
+{
+  if (durations.empty()) {
+    return Duration::zero();
+  }
+
+  const size_t index = std::min(
+      durations.size() - 1,
+      static_cast<size_t>(durations.size() * percent / 100.0));
+
+  std::nth_element(
+      durations.begin(), durations.begin() + index, durations.end());
+
+  return durations[index];
+}
+
+
+static void summarize(const string& name, const vector<Duration>& durations)
+{
+  cout << name << " latency: p50 " << percentile(durations, 50)
+       << ", p90 " << percentile(durations, 90)
+       << ", p99 " << percentile(durations, 99)
+       << ", max " << percentile(durations, 100) << endl;
+}
+
+
+// Returns an error unless a write of the log writer succeeded.
+static Try<Log::Position> validate(
+    const string& operation,
+    const Future<Option<Log::Position>>& position)
+{
+  if (!position.await(Seconds(10))) {
+    return Error("Failed to " + operation + ": timed out");
+  } else if (!position.isReady()) {
+    return Error("Failed to " + operation + ": " +
+                 (position.isFailed()
+                  ? position.failure()
+                  : "Discarded future"));
+  } else if (position.get().isNone()) {
+    return Error(
+        "Failed to " + operation + ": exclusive write promise lost");
+  }
+
+  return position.get().get();
+}
+
+
 Try<Nothing> Benchmark::execute(int argc, char** argv)
 {
   flags.setUsageMessage(
@@ -106,9 +192,15 @@ Try<Nothing> Benchmark::execute(int argc, char** argv)
       "\n"
       "This command is used to do performance test on the\n"
       "replicated log. It takes a trace file of write sizes\n"
-      "and replay that trace to measure the latency of each\n"
-      "write. The data to be written for each write can be\n"
-      "specified using the --type flag.\n"
+      "(or a number of writes of the same size) and replays\n"
+      "that trace to measure the latency of each write. The\n"
+      "data to be written for each write can be specified\n"
+      "using the --type flag.\n"
+      "\n"
+      "The writes can be pipelined (--concurrency), mixed\n"
+      "with truncations (--truncate_interval) and batched by\n"
+      "the local replica (--batch_writes), and the catch-up\n"
+      "of a new replica can be measured (--catchup_path).\n"
       "\n");
 
   // Configure the tool by parsing command line arguments.
@@ -147,14 +239,23 @@ Try<Nothing> Benchmark::execute(int argc, char** argv)
     return Error(flags.usage("Missing required option --znode"));
   }
 
-  if (flags.input.isNone()) {
-    return Error(flags.usage("Missing required option --input"));
+  if (flags.input.isNone() == flags.appends.isNone()) {
+    return Error(
+        flags.usage("Exactly one of --input and --appends is required"));
   }
 
   if (flags.output.isNone()) {
     return Error(flags.usage("Missing required option --output"));
   }
 
+  if (flags.concurrency == 0) {
+    return Error(flags.usage("--concurrency must be positive"));
+  }
+
+  if (flags.truncate_interval.isSome() && flags.truncate_interval.get() == 0) {
+    return Error(flags.usage("--truncate_interval must be positive"));
+  }
+
   // Initialize the log.
   if (flags.initialize) {
     Initialize initialize;
@@ -172,7 +273,11 @@ Try<Nothing> Benchmark::execute(int argc, char** argv)
       flags.path.get(),
       flags.servers.get(),
       Seconds(10),
-      flags.znode.get());
+      flags.znode.get(),
+      None(),
+      false,
+      None(),
+      flags.batch_writes);
 
   // Create the log writer.
   Log::Writer writer(&log);
@@ -192,25 +297,30 @@ Try<Nothing> Benchmark::execute(int argc, char** argv)
   vector<Bytes> sizes;
   vector<Duration> durations;
   vector<Time> timestamps;
+  vector<Duration> truncations;
 
-  // Read sizes from the input trace file.
-  ifstream input(flags.input.get().c_str());
-  if (!input.is_open()) {
-    return Error("Failed to open the trace file " + flags.input.get());
-  }
+  if (flags.input.isSome()) {
+    // Read sizes from the input trace file.
+    ifstream input(flags.input.get().c_str());
+    if (!input.is_open()) {
+      return Error("Failed to open the trace file " + flags.input.get());
+    }
+
+    string line;
+    while (getline(input, line)) {
+      Try<Bytes> size = Bytes::parse(strings::trim(line));
+      if (size.isError()) {
+        return Error("Failed to parse the trace file: " + size.error());
+      }
 
-  string line;
-  while (getline(input, line)) {
-    Try<Bytes> size = Bytes::parse(strings::trim(line));
-    if (size.isError()) {
-      return Error("Failed to parse the trace file: " + size.error());
+      sizes.push_back(size.get());
     }
 
-    sizes.push_back(size.get());
+    input.close();
+  } else {
+    sizes.assign(flags.appends.get(), flags.size);
   }
 
-  input.close();
-
   // Generate the data to be written.
   vector<string> data;
   for (size_t i = 0; i < sizes.size(); i++) {
@@ -223,32 +333,131 @@ Try<Nothing> Benchmark::execute(int argc, char** argv)
     }
   }
 
+  durations.resize(sizes.size());
+  timestamps.resize(sizes.size());
+
+  // The appends in flight, oldest first.
+  struct Append
+  {
+    size_t index;
+    Time start;
+    Future<Option<Log::Position>> position;
+  };
+
+  deque<Append> appends;
+
+  // Waits for the oldest append in flight.
+  auto complete = [&]() -> Try<Log::Position> {
+    Append append = appends.front();
+    appends.pop_front();
+
+    Try<Log::Position> position = validate("append", append.position);
+    if (position.isError()) {
+      return position;
+    }
+
+    timestamps[append.index] = Clock::now();
+    durations[append.index] = timestamps[append.index] - append.start;
+
+    return position;
+  };
+
   Stopwatch stopwatch;
   stopwatch.start();
 
   for (size_t i = 0; i < sizes.size(); i++) {
-    Stopwatch stopwatch;
-    stopwatch.start();
-
-    position = writer.append(data[i]);
-
-    if (!position.await(Seconds(10))) {
-      return Error("Failed to append: timed out");
-    } else if (!position.isReady()) {
-      return Error("Failed to append: " +
-                   (position.isFailed()
-                    ? position.failure()
-                    : "Discarded future"));
-    } else if (position.get().isNone()) {
-      return Error("Failed to append: exclusive write promise lost");
+    while (appends.size() >= flags.concurrency) {
+      Try<Log::Position> position = complete();
+      if (position.isError()) {
+        return Error(position.error());
+      }
     }
 
-    durations.push_back(stopwatch.elapsed());
-    timestamps.push_back(Clock::now());
+    appends.push_back({i, Clock::now(), writer.append(data[i])});
+
+    if (flags.truncate_interval.isSome() &&
+        (i + 1) % flags.truncate_interval.get() == 0) {
+      // Truncate up to the latest append once it is done.
+      Option<Log::Position> latest;
+      while (!appends.empty()) {
+        Try<Log::Position> position = complete();
+        if (position.isError()) {
+          return Error(position.error());
+        }
+
+        latest = position.get();
+      }
+
+      Stopwatch truncation;
+      truncation.start();
+
+      Try<Log::Position> position =
+        validate("truncate", writer.truncate(latest.get()));
+
+      if (position.isError()) {
+        return Error(position.error());
+      }
+
+      truncations.push_back(truncation.elapsed());
+    }
+  }
+
+  while (!appends.empty()) {
+    Try<Log::Position> position = complete();
+    if (position.isError()) {
+      return Error(position.error());
+    }
+  }
+
+  const Duration elapsed = stopwatch.elapsed();
+
+  Bytes total;
+  foreach (const Bytes& size, sizes) {
+    total += size;
   }
 
   cout << "Total number of appends: " << sizes.size() << endl;
-  cout << "Total time used: " << stopwatch.elapsed() << endl;
+  cout << "Total time used: " << elapsed << endl;
+  cout << "Throughput: " << sizes.size() / elapsed.secs() << " appends/sec, "
+       << total.bytes() / elapsed.secs() / Bytes::MEGABYTES
+       << " MB/sec" << endl;
+
+  summarize("Append", durations);
+
+  if (!truncations.empty()) {
+    cout << "Total number of truncations: " << truncations.size() << endl;
+    summarize("Truncation", truncations);
+  }
+
+  if (flags.catchup_path.isSome()) {
+    // Start a new replica, which catches up with the log while it
+    // recovers, before it can serve any reads.
+    Stopwatch catchup;
+    catchup.start();
+
+    Owned<Log> replica(new Log(
+        flags.quorum.get(),
+        flags.catchup_path.get(),
+        flags.servers.get(),
+        Seconds(10),
+        flags.znode.get(),
+        None(),
+        false,
+        None(),
+        flags.batch_writes));
+
+    Log::Reader reader(replica.get());
+
+    Future<Log::Position> ending = reader.ending();
+    if (!ending.await(Minutes(10))) {
+      return Error("Failed to catch up a new replica: timed out");
+    } else if (!ending.isReady()) {
+      return Error("Failed to catch up a new replica: " +
+                   (ending.isFailed() ? ending.failure() : "Discarded future"));
+    }
+
+    cout << "Caught up a new replica in " << catchup.elapsed() << endl;
+  }
 
   // Ouput statistics.
   ofstream output(flags.output.get().c_str());
@@ -17,6 +17,7 @@
 #ifndef __LOG_TOOL_BENCHMARK_HPP__
 #define __LOG_TOOL_BENCHMARK_HPP__
 
+#include <stout/bytes.hpp>
 #include <stout/flags.hpp>
 #include <stout/option.hpp>
 
@@ -42,8 +43,14 @@ public:
     Option<std::string> servers;
     Option<std::string> znode;
     Option<std::string> input;
+    Option<size_t> appends;
+    Bytes size;
     Option<std::string> output;
     std::string type;
+    size_t concurrency;
+    Option<size_t> truncate_interval;
+    bool batch_writes;
+    Option<std::string> catchup_path;
     bool initialize;
     bool help;
   };
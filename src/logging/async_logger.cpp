@@ -0,0 +1,168 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+#include <stout/stringify.hpp>
+
+#include "logging/async_logger.hpp"
+
+using std::string;
+using std::unique_lock;
+using std::vector;
+
+namespace mesos {
+namespace internal {
+namespace logging {
+
+AsyncLogger::AsyncLogger(google::base::Logger* _logger, const Bytes& _capacity)
+  : logger(CHECK_NOTNULL(_logger)),
+    capacity(static_cast<size_t>(_capacity.bytes())),
+    writer(&AsyncLogger::run, this) {}
+
+
+AsyncLogger::~AsyncLogger()
+{
+  {
+    unique_lock<std::mutex> lock(mutex);
+    stopping = true;
+    pending.notify_one();
+  }
+
+  writer.join();
+}
+
+
+void AsyncLogger::Write(
+    bool forceFlush,
+    time_t timestamp,
+    const char* message,
+    int length)
+{
+  unique_lock<std::mutex> lock(mutex);
+
+  if (!forceFlush && size + length > capacity) {
+    dropped++;
+    return;
+  }
+
+  buffer.push_back({forceFlush, timestamp, string(message, length)});
+  size += length;
+  buffered++;
+
+  if (forceFlush) {
+    flush(&lock);
+  } else if (buffer.size() == 1) {
+    pending.notify_one();
+  }
+}
+
+
+void AsyncLogger::Flush()
+{
+  unique_lock<std::mutex> lock(mutex);
+  flush(&lock);
+}
+
+
+google::uint32 AsyncLogger::LogSize()
+{
+  return logger->LogSize();
+}
+
+
+void AsyncLogger::flush(unique_lock<std::mutex>* lock)
+{
+  const uint64_t target = buffered;
+
+  if (synced >= target) {
+    return;
+  }
+
+  flushing = std::max(flushing, target);
+  pending.notify_one();
+
+  flushed.wait(*lock, [=]() { return synced >= target; });
+}
+
+
+void AsyncLogger::run()
+{
+  unique_lock<std::mutex> lock(mutex);
+
+  while (true) {
+    pending.wait(lock, [this]() {
+      return !buffer.empty() || flushing > synced || stopping;
+    });
+
+    if (buffer.empty() && flushing <= synced) {
+      CHECK(stopping);
+      break;
+    }
+
+    vector<Message> messages;
+    std::swap(messages, buffer);
+    size = 0;
+
+    const uint64_t _dropped = dropped;
+    dropped = 0;
+
+    const bool sync = flushing > synced;
+
+    // Write the messages without holding the lock, so the threads
+    // logging can keep buffering messages meanwhile.
+    lock.unlock();
+
+    foreach (const Message& message, messages) {
+      logger->Write(
+          message.forceFlush,
+          message.timestamp,
+          message.text.data(),
+          static_cast<int>(message.text.size()));
+    }
+
+    if (_dropped > 0) {
+      const string message =
+        "Dropped " + stringify(_dropped) +
+        " log messages because the log buffer was full\n";
+
+      logger->Write(
+          false,
+          time(nullptr),
+          message.data(),
+          static_cast<int>(message.size()));
+    }
+
+    if (sync) {
+      logger->Flush();
+    }
+
+    lock.lock();
+
+    written += messages.size();
+
+    if (sync) {
+      synced = written;
+      flushed.notify_all();
+    }
+  }
+}
+
+} // namespace logging {
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,115 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __LOGGING_ASYNC_LOGGER_HPP__
+#define __LOGGING_ASYNC_LOGGER_HPP__
+
+#include <stdint.h>
+#include <time.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <stout/bytes.hpp>
+
+namespace mesos {
+namespace internal {
+namespace logging {
+
+// A glog logger buffering the messages written to another logger
+// (e.g., the log file of a severity) in memory, and writing them from
+// a background thread. This keeps the threads logging, most notably
+// the libprocess worker threads, from stalling on writes to the log
+// files.
+//
+// The messages which glog asks to flush immediately (by default, the
+// ones of severity WARNING and above) are written before `Write`
+// returns, along with all the messages buffered before them. When the
+// buffer is full, the other messages are dropped, and the number of
+// dropped messages is written once there is room again.
+class AsyncLogger : public google::base::Logger
+{
+public:
+  AsyncLogger(google::base::Logger* logger, const Bytes& capacity);
+
+  virtual ~AsyncLogger();
+
+  virtual void Write(
+      bool forceFlush,
+      time_t timestamp,
+      const char* message,
+      int length);
+
+  // Waits for the buffered messages to be written and flushed.
+  virtual void Flush();
+
+  virtual google::uint32 LogSize();
+
+private:
+  struct Message
+  {
+    bool forceFlush;
+    time_t timestamp;
+    std::string text;
+  };
+
+  void run();
+
+  // Waits for the messages buffered so far to be written and flushed.
+  // Requires `mutex` to be held.
+  void flush(std::unique_lock<std::mutex>* lock);
+
+  google::base::Logger* const logger;
+  const size_t capacity;
+
+  std::mutex mutex;
+
+  // Signals the writer that there are messages to write, a flush to
+  // do, or that it should stop.
+  std::condition_variable pending;
+
+  // Signals the threads waiting for a flush that it has been done.
+  std::condition_variable flushed;
+
+  std::vector<Message> buffer;
+  size_t size = 0; // The number of bytes in `buffer`.
+  uint64_t dropped = 0;
+
+  // The number of messages buffered, written, and written and flushed
+  // since the beginning, which tells the threads waiting on a flush
+  // when it is done.
+  uint64_t buffered = 0;
+  uint64_t written = 0;
+  uint64_t synced = 0;
+
+  // The number of buffered messages which a thread wants flushed.
+  uint64_t flushing = 0;
+
+  bool stopping = false;
+
+  std::thread writer;
+};
+
+} // namespace logging {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __LOGGING_ASYNC_LOGGER_HPP__
@@ -46,6 +46,16 @@ mesos::internal::logging::Flags::Flags()
       "By default, logs are flushed immediately.",
       0);
 
+  add(&Flags::async_log_buffer,
+      "async_log_buffer",
+      "If set, the log messages written to `--log_dir` are buffered in\n"
+      "memory, up to this size, and written to the log files by a\n"
+      "background thread, so that logging does not wait on the disk.\n"
+      "The messages of severity `WARNING` and above are still written\n"
+      "before the logging call returns. When the buffer is full, the\n"
+      "messages of severity `INFO` are dropped and the number of dropped\n"
+      "messages is logged. By default, messages are written directly.");
+
   add(&Flags::initialize_driver_logging,
       "initialize_driver_logging",
       "Whether the master/agent should initialize Google logging for the\n"
@@ -19,6 +19,7 @@
 
 #include <string>
 
+#include <stout/bytes.hpp>
 #include <stout/flags.hpp>
 #include <stout/option.hpp>
 
@@ -35,6 +36,7 @@ public:
   std::string logging_level;
   Option<std::string> log_dir;
   int logbufsecs;
+  Option<Bytes> async_log_buffer;
   bool initialize_driver_logging;
   Option<std::string> external_log_file;
 };
@@ -35,6 +35,7 @@
 #include <stout/os/signals.hpp>
 #endif // __WINDOWS__
 
+#include "logging/async_logger.hpp"
 #include "logging/logging.hpp"
 
 #ifdef __linux__
@@ -152,6 +153,12 @@ void initialize(
     exit(EXIT_FAILURE);
   }
 
+  if (flags.async_log_buffer.isSome() &&
+      flags.async_log_buffer.get() == Bytes(0)) {
+    cerr << "'async_log_buffer' must be positive" << endl;
+    exit(EXIT_FAILURE);
+  }
+
   if (flags.log_dir.isSome()) {
     Try<Nothing> mkdir = os::mkdir(flags.log_dir.get());
     if (mkdir.isError()) {
@@ -201,6 +208,21 @@ void initialize(
     LOG_AT_LEVEL(FLAGS_minloglevel)
       << google::GetLogSeverityName(FLAGS_minloglevel)
       << " level logging started!";
+
+    if (flags.async_log_buffer.isSome()) {
+      // The FATAL log file is left alone since the process aborts
+      // right after logging to it.
+      for (int severity = google::INFO; severity < google::FATAL; severity++) {
+        google::base::SetLogger(
+            severity,
+            new AsyncLogger(
+                google::base::GetLogger(severity),
+                flags.async_log_buffer.get()));
+      }
+
+      // Write out the buffered messages when exiting normally.
+      atexit([]() { google::FlushLogFiles(google::INFO); });
+    }
   }
 
   VLOG(1) << "Logging to " <<
@@ -26,6 +26,7 @@
 
 using std::string;
 
+using mesos::internal::master::allocator::HierarchicalBucketedDRFAllocator;
 using mesos::internal::master::allocator::HierarchicalDRFAllocator;
 
 namespace mesos {
@@ -41,6 +42,10 @@ Try<Allocator*> Allocator::create(const string& name)
     return HierarchicalDRFAllocator::create();
   }
 
+  if (name == mesos::internal::master::BUCKETED_DRF_ALLOCATOR) {
+    return HierarchicalBucketedDRFAllocator::create();
+  }
+
   return modules::ModuleManager::create<Allocator>(name);
 }
 
@@ -59,7 +59,10 @@ public:
       const Option<std::set<std::string>>&
         fairnessExcludeResourceNames = None(),
       bool filterGpuResources = true,
-      const Option<DomainInfo>& domain = None());
+      const Option<DomainInfo>& domain = None(),
+      size_t allocationShards = 1,
+      const Option<Duration>& allocationSweepInterval = None(),
+      const Option<Duration>& maxAllocationInterval = None());
 
   void recover(
       const int expectedAgentCount,
@@ -153,6 +156,11 @@ public:
       const Resources& resources,
       const Option<Filters>& filters);
 
+  void batchRecoverResources(
+      const FrameworkID& frameworkId,
+      const hashmap<SlaveID, Resources>& resources,
+      const Option<Filters>& filters);
+
   void suppressOffers(
       const FrameworkID& frameworkId,
       const std::set<std::string>& roles);
@@ -205,7 +213,10 @@ public:
       const Option<std::set<std::string>>&
         fairnessExcludeResourceNames = None(),
       bool filterGpuResources = true,
-      const Option<DomainInfo>& domain = None()) = 0;
+      const Option<DomainInfo>& domain = None(),
+      size_t allocationShards = 1,
+      const Option<Duration>& allocationSweepInterval = None(),
+      const Option<Duration>& maxAllocationInterval = None()) = 0;
 
   virtual void recover(
       const int expectedAgentCount,
@@ -300,6 +311,11 @@ public:
       const Resources& resources,
       const Option<Filters>& filters) = 0;
 
+  virtual void batchRecoverResources(
+      const FrameworkID& frameworkId,
+      const hashmap<SlaveID, Resources>& resources,
+      const Option<Filters>& filters) = 0;
+
   virtual void suppressOffers(
       const FrameworkID& frameworkId,
       const std::set<std::string>& roles) = 0;
@@ -360,7 +376,10 @@ inline void MesosAllocator<AllocatorProcess>::initialize(
       inverseOfferCallback,
     const Option<std::set<std::string>>& fairnessExcludeResourceNames,
     bool filterGpuResources,
-    const Option<DomainInfo>& domain)
+    const Option<DomainInfo>& domain,
+    size_t allocationShards,
+    const Option<Duration>& allocationSweepInterval,
+    const Option<Duration>& maxAllocationInterval)
 {
   process::dispatch(
       process,
@@ -370,7 +389,10 @@ inline void MesosAllocator<AllocatorProcess>::initialize(
       inverseOfferCallback,
       fairnessExcludeResourceNames,
       filterGpuResources,
-      domain);
+      domain,
+      allocationShards,
+      allocationSweepInterval,
+      maxAllocationInterval);
 }
 
 
@@ -655,6 +677,21 @@ inline void MesosAllocator<AllocatorProcess>::recoverResources(
 }
 
 
+template <typename AllocatorProcess>
+inline void MesosAllocator<AllocatorProcess>::batchRecoverResources(
+    const FrameworkID& frameworkId,
+    const hashmap<SlaveID, Resources>& resources,
+    const Option<Filters>& filters)
+{
+  process::dispatch(
+      process,
+      &MesosAllocatorProcess::batchRecoverResources,
+      frameworkId,
+      resources,
+      filters);
+}
+
+
 template <typename AllocatorProcess>
 inline void MesosAllocator<AllocatorProcess>::suppressOffers(
     const FrameworkID& frameworkId,
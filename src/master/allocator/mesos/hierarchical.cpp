@@ -27,6 +27,7 @@
 #include <mesos/type_utils.hpp>
 
 #include <process/after.hpp>
+#include <process/clock.hpp>
 #include <process/delay.hpp>
 #include <process/dispatch.hpp>
 #include <process/event.hpp>
@@ -41,6 +42,7 @@
 #include <stout/stringify.hpp>
 
 #include "common/protobuf_utils.hpp"
+#include "common/resource_quantities.hpp"
 
 using std::set;
 using std::string;
@@ -49,6 +51,7 @@ using std::vector;
 using mesos::allocator::InverseOfferStatus;
 
 using process::after;
+using process::Clock;
 using process::Continue;
 using process::ControlFlow;
 using process::Failure;
@@ -56,6 +59,7 @@ using process::Future;
 using process::loop;
 using process::Owned;
 using process::PID;
+using process::Time;
 using process::Timeout;
 
 using mesos::internal::protobuf::framework::Capabilities;
@@ -72,17 +76,33 @@ class OfferFilter
 public:
   virtual ~OfferFilter() {}
 
-  virtual bool filter(const Resources& resources) const = 0;
+  // The `quantities` are those of the scalar `resources`, which are
+  // passed in so that they are computed only once when checking many
+  // filters against the same resources.
+  virtual bool filter(
+      const Resources& resources,
+      const ResourceQuantities& quantities) const = 0;
 };
 
 
 class RefusedOfferFilter : public OfferFilter
 {
 public:
-  RefusedOfferFilter(const Resources& _resources) : resources(_resources) {}
+  RefusedOfferFilter(const Resources& _resources)
+    : resources(_resources),
+      quantities(ResourceQuantities::fromScalarResources(_resources)) {}
 
-  virtual bool filter(const Resources& _resources) const
+  virtual bool filter(
+      const Resources& _resources,
+      const ResourceQuantities& _quantities) const
   {
+    // The refused resources can only be a superset if their
+    // quantities are, which is much cheaper to check and rejects
+    // most of the filters which do not apply.
+    if (!quantities.contains(_quantities)) {
+      return false;
+    }
+
     // TODO(jieyu): Consider separating the superset check for regular
     // and revocable resources. For example, frameworks might want
     // more revocable resources only or non-revocable resources only,
@@ -93,6 +113,7 @@ public:
 
 private:
   const Resources resources;
+  const ResourceQuantities quantities;
 };
 
 
@@ -133,6 +154,14 @@ private:
 };
 
 
+HierarchicalAllocatorProcess::~HierarchicalAllocatorProcess()
+{
+  foreachvalue (const OfferFilterExpiry& expiry, offerFilterExpiries) {
+    delete expiry.offerFilter;
+  }
+}
+
+
 HierarchicalAllocatorProcess::Framework::Framework(
     const FrameworkInfo& frameworkInfo,
     const set<string>& _suppressedRoles,
@@ -155,7 +184,10 @@ void HierarchicalAllocatorProcess::initialize(
       _inverseOfferCallback,
     const Option<set<string>>& _fairnessExcludeResourceNames,
     bool _filterGpuResources,
-    const Option<DomainInfo>& _domain)
+    const Option<DomainInfo>& _domain,
+    size_t _allocationShards,
+    const Option<Duration>& _allocationSweepInterval,
+    const Option<Duration>& _maxAllocationInterval)
 {
   allocationInterval = _allocationInterval;
   offerCallback = _offerCallback;
@@ -163,6 +195,10 @@ void HierarchicalAllocatorProcess::initialize(
   fairnessExcludeResourceNames = _fairnessExcludeResourceNames;
   filterGpuResources = _filterGpuResources;
   domain = _domain;
+  allocationShards = std::max<size_t>(_allocationShards, 1);
+  allocationSweepInterval = _allocationSweepInterval;
+  maxAllocationInterval = _maxAllocationInterval;
+  currentAllocationInterval = _allocationInterval;
   initialized = true;
   paused = false;
 
@@ -172,18 +208,38 @@ void HierarchicalAllocatorProcess::initialize(
   roleSorter->initialize(fairnessExcludeResourceNames);
   quotaRoleSorter->initialize(fairnessExcludeResourceNames);
 
+  if (allocationShards > 1) {
+    metrics.setAllocationShards(allocationShards);
+  }
+
+  metrics.allocation_interval = currentAllocationInterval.ms();
+
   VLOG(1) << "Initialized hierarchical allocator process";
 
   // Start a loop to run allocation periodically.
   PID<HierarchicalAllocatorProcess> _self = self();
 
+  const bool adaptive = _maxAllocationInterval.isSome();
+
   loop(
       None(), // Use `None` so we iterate outside the allocator process.
-      [_allocationInterval]() {
-        return after(_allocationInterval);
+      [_self, _allocationInterval, adaptive]() -> Future<Nothing> {
+        if (!adaptive) {
+          return after(_allocationInterval);
+        }
+
+        // NOTE: The interval is determined once the allocator has
+        // worked through the events queued after the previous batch
+        // allocation, which by itself holds off allocations while the
+        // allocator is backlogged.
+        return dispatch(
+            _self, &HierarchicalAllocatorProcess::nextAllocationInterval)
+          .then([](const Duration& interval) {
+            return after(interval);
+          });
       },
       [_self](const Nothing&) {
-        return dispatch(_self, &HierarchicalAllocatorProcess::allocate)
+        return dispatch(_self, &HierarchicalAllocatorProcess::batch)
           .then([]() -> ControlFlow<Nothing> { return Continue(); });
       });
 }
@@ -490,6 +546,9 @@ void HierarchicalAllocatorProcess::updateFramework(
   framework.roles = newRoles;
   framework.suppressedRoles = suppressedRoles;
   framework.capabilities = frameworkInfo.capabilities();
+
+  // The framework may now be offered resources of any agent.
+  nextSweep = None();
 }
 
 
@@ -510,11 +569,15 @@ void HierarchicalAllocatorProcess::addSlave(
 
   Slave& slave = slaves.at(slaveId);
 
-  slave.total = total;
-  slave.allocated = Resources::sum(used);
+  slave.updateTotal(total);
+  slave.allocate(Resources::sum(used));
   slave.activated = true;
   slave.info = slaveInfo;
   slave.capabilities = protobuf::slave::Capabilities(capabilities);
+  slave.requirements = requirements(slave);
+
+  offeredOrAllocated +=
+    ResourceQuantities::fromScalarResources(slave.getAllocated());
 
   // NOTE: We currently implement maintenance in the allocator to be able to
   // leverage state and features such as the FrameworkSorter and OfferFilter.
@@ -527,6 +590,8 @@ void HierarchicalAllocatorProcess::addSlave(
   // See comment at `quotaRoleSorter` declaration regarding non-revocable.
   quotaRoleSorter->add(slaveId, total.nonRevocable());
 
+  updateResourceMetrics();
+
   foreachpair (const FrameworkID& frameworkId,
                const Resources& allocation,
                used) {
@@ -570,8 +635,8 @@ void HierarchicalAllocatorProcess::addSlave(
   }
 
   LOG(INFO) << "Added agent " << slaveId << " (" << slave.info.hostname() << ")"
-            << " with " << slave.total
-            << " (allocated: " << slave.allocated << ")";
+            << " with " << slave.getTotal()
+            << " (allocated: " << slave.getAllocated() << ")";
 
   allocate(slaveId);
 }
@@ -589,13 +654,20 @@ void HierarchicalAllocatorProcess::removeSlave(
   // all the resources. Fixing this would require more information
   // than what we currently track in the allocator.
 
-  roleSorter->remove(slaveId, slaves.at(slaveId).total);
+  roleSorter->remove(slaveId, slaves.at(slaveId).getTotal());
 
   // See comment at `quotaRoleSorter` declaration regarding non-revocable.
-  quotaRoleSorter->remove(slaveId, slaves.at(slaveId).total.nonRevocable());
+  quotaRoleSorter->remove(
+      slaveId, slaves.at(slaveId).getTotal().nonRevocable());
+
+  offeredOrAllocated -=
+    ResourceQuantities::fromScalarResources(slaves.at(slaveId).getAllocated());
+
+  updateResourceMetrics();
 
   slaves.erase(slaveId);
   allocationCandidates.erase(slaveId);
+  changedSlaves.erase(slaveId);
 
   // Note that we DO NOT actually delete any filters associated with
   // this slave, that will occur when the delayed
@@ -642,6 +714,7 @@ void HierarchicalAllocatorProcess::updateSlave(
     // to re-register with a different hostname) inside the allocator it
     // doesn't matter, as the algorithm will work correctly either way.
     slave.info = info;
+    slave.requirements = requirements(slave);
   }
 
   // Update agent capabilities.
@@ -702,8 +775,13 @@ void HierarchicalAllocatorProcess::addResourceProvider(
   }
 
   Slave& slave = slaves.at(slaveId);
-  updateSlaveTotal(slaveId, slave.total + total);
-  slave.allocated += Resources::sum(used);
+  updateSlaveTotal(slaveId, slave.getTotal() + total);
+
+  const Resources allocated = Resources::sum(used);
+  slave.allocate(allocated);
+
+  offeredOrAllocated += ResourceQuantities::fromScalarResources(allocated);
+  updateResourceMetrics();
 
   VLOG(1)
     << "Grew agent " << slaveId << " by "
@@ -746,6 +824,7 @@ void HierarchicalAllocatorProcess::activateSlave(
   CHECK(slaves.contains(slaveId));
 
   slaves.at(slaveId).activated = true;
+  changedSlaves.insert(slaveId);
 
   LOG(INFO) << "Agent " << slaveId << " reactivated";
 }
@@ -770,6 +849,10 @@ void HierarchicalAllocatorProcess::updateWhitelist(
 
   whitelist = _whitelist;
 
+  // Agents which are no longer filtered by the whitelist need to be
+  // allocated by the next batch allocation.
+  nextSweep = None();
+
   if (whitelist.isSome()) {
     LOG(INFO) << "Updated agent whitelist: " << stringify(whitelist.get());
 
@@ -840,8 +923,15 @@ void HierarchicalAllocatorProcess::updateAllocation(
   const Resources& updatedOfferedResources = _updatedOfferedResources.get();
 
   // Update the per-slave allocation.
-  slave.allocated -= offeredResources;
-  slave.allocated += updatedOfferedResources;
+  slave.unallocate(offeredResources);
+  slave.allocate(updatedOfferedResources);
+
+  offeredOrAllocated -=
+    ResourceQuantities::fromScalarResources(offeredResources);
+  offeredOrAllocated +=
+    ResourceQuantities::fromScalarResources(updatedOfferedResources);
+
+  updateResourceMetrics();
 
   // Update the allocation in the framework sorter.
   frameworkSorter->update(
@@ -900,7 +990,7 @@ void HierarchicalAllocatorProcess::updateAllocation(
     strippedConversions.emplace_back(consumed, converted);
   }
 
-  Try<Resources> updatedTotal = slave.total.apply(strippedConversions);
+  Try<Resources> updatedTotal = slave.getTotal().apply(strippedConversions);
   CHECK_SOME(updatedTotal);
 
   updateSlaveTotal(slaveId, updatedTotal.get());
@@ -959,7 +1049,7 @@ Future<Nothing> HierarchicalAllocatorProcess::updateAvailable(
   }
 
   // Update the total resources.
-  Try<Resources> updatedTotal = slave.total.apply(operations);
+  Try<Resources> updatedTotal = slave.getTotal().apply(operations);
   CHECK_SOME(updatedTotal);
 
   // Update the total resources in the allocator and role and quota sorters.
@@ -1180,14 +1270,17 @@ void HierarchicalAllocatorProcess::recoverResources(
   if (slaves.contains(slaveId)) {
     Slave& slave = slaves.at(slaveId);
 
-    CHECK(slave.allocated.contains(resources))
-      << slave.allocated << " does not contain " << resources;
+    CHECK(slave.getAllocated().contains(resources))
+      << slave.getAllocated() << " does not contain " << resources;
+
+    slave.unallocate(resources);
 
-    slave.allocated -= resources;
+    offeredOrAllocated -= ResourceQuantities::fromScalarResources(resources);
+    updateResourceMetrics();
 
     VLOG(1) << "Recovered " << resources
-            << " (total: " << slave.total
-            << ", allocated: " << slave.allocated << ")"
+            << " (total: " << slave.getTotal()
+            << ", allocated: " << slave.getAllocated() << ")"
             << " on agent " << slaveId
             << " from framework " << frameworkId;
   }
@@ -1257,21 +1350,32 @@ void HierarchicalAllocatorProcess::recoverResources(
     // (MESOS-3078), we would not need to increase the timeout here.
     timeout = std::max(allocationInterval, timeout.get());
 
-    // We need to disambiguate the function call to pick the correct
-    // `expire()` overload.
-    void (Self::*expireOffer)(
-        const FrameworkID&,
-        const string&,
-        const SlaveID&,
-        OfferFilter*) = &Self::expire;
-
-    delay(timeout.get(),
-          self(),
-          expireOffer,
-          frameworkId,
-          role,
-          slaveId,
-          offerFilter);
+    auto expiry = offerFilterExpiries.emplace(
+        Clock::now() + timeout.get(),
+        OfferFilterExpiry{frameworkId, role, slaveId, offerFilter});
+
+    // Only the earliest expiry has a timer, which needs to be moved
+    // if this filter expires before all the others.
+    if (expiry == offerFilterExpiries.begin()) {
+      scheduleExpire();
+    }
+  }
+}
+
+
+void HierarchicalAllocatorProcess::batchRecoverResources(
+    const FrameworkID& frameworkId,
+    const hashmap<SlaveID, Resources>& resources,
+    const Option<Filters>& filters)
+{
+  CHECK(initialized);
+
+  foreachpair (const SlaveID& slaveId,
+               const Resources& resources_,
+               resources) {
+    foreachvalue (const Resources& allocation, resources_.allocations()) {
+      recoverResources(frameworkId, slaveId, allocation, filters);
+    }
   }
 }
 
@@ -1379,6 +1483,10 @@ void HierarchicalAllocatorProcess::setQuota(
   //
   // If we add the ability for quota changes to incur a rebalancing
   // of offered resources, then we should trigger that here.
+  //
+  // The subsequent batch allocation needs to sweep all agents for the
+  // change to be reflected in the allocation of every agent.
+  nextSweep = None();
 }
 
 
@@ -1407,6 +1515,10 @@ void HierarchicalAllocatorProcess::removeQuota(
   //
   // If we add the ability for quota changes to incur a rebalancing
   // of offered resources, then we should trigger that here.
+  //
+  // The subsequent batch allocation needs to sweep all agents for the
+  // change to be reflected in the allocation of every agent.
+  nextSweep = None();
 }
 
 
@@ -1428,6 +1540,10 @@ void HierarchicalAllocatorProcess::updateWeights(
   //
   // If we add the ability for weight changes to incur a rebalancing
   // of offered resources, then we should trigger that here.
+  //
+  // The subsequent batch allocation needs to sweep all agents for the
+  // change to be reflected in the allocation of every agent.
+  nextSweep = None();
 }
 
 
@@ -1485,7 +1601,83 @@ Future<Nothing> HierarchicalAllocatorProcess::allocate(
 }
 
 
-Nothing HierarchicalAllocatorProcess::_allocate()
+Future<Nothing> HierarchicalAllocatorProcess::batch()
+{
+  if (paused) {
+    VLOG(2) << "Skipped allocation because the allocator is paused";
+
+    return Nothing();
+  }
+
+  // Nothing changed if no agent changed and no change which affects
+  // all agents forces a sweep.
+  idleBatch = changedSlaves.empty() &&
+    (allocationSweepInterval.isNone() || nextSweep.isSome());
+
+  if (allocationSweepInterval.isSome() &&
+      nextSweep.isSome() &&
+      !nextSweep->expired()) {
+    hashset<SlaveID> slaveIds;
+    std::swap(slaveIds, changedSlaves);
+
+    if (slaveIds.empty()) {
+      return Nothing();
+    }
+
+    return allocate(slaveIds);
+  }
+
+  if (allocationSweepInterval.isSome()) {
+    nextSweep = Timeout::in(allocationSweepInterval.get());
+  }
+
+  changedSlaves.clear();
+
+  return allocate();
+}
+
+
+Duration HierarchicalAllocatorProcess::nextAllocationInterval()
+{
+  CHECK_SOME(maxAllocationInterval);
+
+  const size_t backlog = eventCount<process::DispatchEvent>();
+
+  if (backlog >= ALLOCATION_BACKLOG_THRESHOLD ||
+      lastAllocationRun >= currentAllocationInterval) {
+    // Allocation runs pile up, back off so that the allocator
+    // catches up with the other events.
+    currentAllocationInterval = std::min(
+        maxAllocationInterval.get(),
+        std::max(currentAllocationInterval, lastAllocationRun) * 2);
+
+    ++metrics.allocation_interval_busy;
+  } else if (idleBatch &&
+             changedSlaves.empty() &&
+             allocationCandidates.empty()) {
+    // Nothing changed before the previous batch allocation nor since,
+    // hence another one is unlikely to offer anything new.
+    currentAllocationInterval = std::min(
+        maxAllocationInterval.get(),
+        currentAllocationInterval * 2);
+
+    ++metrics.allocation_interval_idle;
+  } else {
+    currentAllocationInterval = allocationInterval;
+  }
+
+  VLOG(2) << "Next batch allocation in " << currentAllocationInterval
+          << " (" << backlog << " queued events, " << changedSlaves.size()
+          << " changed agents, last allocation run took "
+          << lastAllocationRun << ")";
+
+  metrics.allocation_interval = currentAllocationInterval.ms();
+
+  return currentAllocationInterval;
+}
+
+
+Future<Nothing> HierarchicalAllocatorProcess::_allocate()
 {
   metrics.allocation_run_latency.stop();
 
@@ -1497,31 +1689,109 @@ Nothing HierarchicalAllocatorProcess::_allocate()
 
   ++metrics.allocation_runs;
 
-  Stopwatch stopwatch;
-  stopwatch.start();
+  allocationStopwatch.start();
   metrics.allocation_run.start();
 
-  __allocate();
+  // Partition the candidates into shards. Agents are assigned to
+  // shards round-robin, so that shards are of (roughly) equal size.
+  //
+  // NOTE: The candidates are cleared here rather than on completion
+  // of the allocation run, because events processed in between shards
+  // may add new candidates. These are allocated in a subsequent run.
+  shards =
+    vector<hashset<SlaveID>>(std::min(
+        allocationShards,
+        std::max<size_t>(allocationCandidates.size(), 1)));
+
+  size_t index = 0;
+  foreach (const SlaveID& slaveId, allocationCandidates) {
+    shards[index++ % shards.size()].insert(slaveId);
+  }
+
+  allocationCandidates.clear();
+
+  return allocateShard(0);
+}
+
+
+Future<Nothing> HierarchicalAllocatorProcess::allocateShard(size_t shard)
+{
+  CHECK_LT(shard, shards.size());
+
+  // The allocator may have been paused in between shards, in which
+  // case the agents of the remaining shards are kept as candidates
+  // for the next allocation run.
+  if (paused) {
+    VLOG(2) << "Skipped allocation because the allocator is paused";
+
+    for (size_t i = shard; i < shards.size(); ++i) {
+      allocationCandidates |= shards[i];
+    }
+
+    shards.clear();
+
+    metrics.allocation_run.stop();
+
+    return Nothing();
+  }
+
+  if (shards.size() > 1) {
+    CHECK_LT(shard, metrics.allocation_run_shards.size());
+    metrics.allocation_run_shards[shard].start();
+  }
+
+  __allocate(shards[shard]);
 
   // NOTE: For now, we implement maintenance inverse offers within the
   // allocator. We leverage the existing timer/cycle of offers to also do any
   // "deallocation" (inverse offers) necessary to satisfy maintenance needs.
-  deallocate();
+  deallocate(shards[shard]);
+
+  // The metrics are updated once for all of the allocations of the
+  // shard rather than for each of them.
+  updateResourceMetrics();
+
+  if (shards.size() > 1) {
+    metrics.allocation_run_shards[shard].stop();
+  }
+
+  if (shard + 1 < shards.size()) {
+    return dispatch(self(), &Self::allocateShard, shard + 1);
+  }
 
   metrics.allocation_run.stop();
 
-  VLOG(1) << "Performed allocation for " << allocationCandidates.size()
-          << " agents in " << stopwatch.elapsed();
+  size_t count = 0;
+  foreach (const hashset<SlaveID>& slaveIds, shards) {
+    count += slaveIds.size();
+  }
 
-  // Clear the candidates on completion of the allocation run.
-  allocationCandidates.clear();
+  if (shards.size() > 1) {
+    VLOG(1) << "Performed allocation for " << count << " agents in "
+            << shards.size() << " shards in " << allocationStopwatch.elapsed();
+  } else {
+    VLOG(1) << "Performed allocation for " << count << " agents in "
+            << allocationStopwatch.elapsed();
+  }
+
+  lastAllocationRun = allocationStopwatch.elapsed();
+
+  shards.clear();
+
+  // Agents that became allocation candidates while the shards were
+  // allocated need another allocation run.
+  if (!allocationCandidates.empty()) {
+    metrics.allocation_run_latency.start();
+    return dispatch(self(), &Self::_allocate);
+  }
 
   return Nothing();
 }
 
 
 // TODO(alexr): Consider factoring out the quota allocation logic.
-void HierarchicalAllocatorProcess::__allocate()
+void HierarchicalAllocatorProcess::__allocate(
+    const hashset<SlaveID>& candidates)
 {
   // Compute the offerable resources, per framework:
   //   (1) For reserved resources on the slave, allocate these to a
@@ -1530,16 +1800,16 @@ void HierarchicalAllocatorProcess::__allocate()
   //       to a framework of any role.
   hashmap<FrameworkID, hashmap<string, hashmap<SlaveID, Resources>>> offerable;
 
-  // NOTE: This function can operate on a small subset of
-  // `allocationCandidates`, we have to make sure that we don't
-  // assume cluster knowledge when summing resources from that set.
+  // NOTE: This function can operate on a small subset of the
+  // agents, we have to make sure that we don't assume cluster
+  // knowledge when summing resources from that set.
 
   vector<SlaveID> slaveIds;
-  slaveIds.reserve(allocationCandidates.size());
+  slaveIds.reserve(candidates.size());
 
   // Filter out non-whitelisted, removed, and deactivated slaves
   // in order not to send offers for them.
-  foreach (const SlaveID& slaveId, allocationCandidates) {
+  foreach (const SlaveID& slaveId, candidates) {
     if (isWhitelisted(slaveId) &&
         slaves.contains(slaveId) &&
         slaves.at(slaveId).activated) {
@@ -1560,14 +1830,15 @@ void HierarchicalAllocatorProcess::__allocate()
   // its quota.
   //
   // NOTE: Revocable resources are excluded in `quotaRoleSorter`.
-  auto getQuotaRoleAllocatedResources = [this](const string& role) {
-    CHECK(quotas.contains(role));
+  auto getQuotaRoleAllocatedQuantities =
+    [this](const string& role) -> const ResourceQuantities& {
+      CHECK(quotas.contains(role));
 
-    // NOTE: `allocationScalarQuantities` omits dynamic reservation,
-    // persistent volume info, and allocation info. We additionally
-    // remove the static reservations here via `toUnreserved()`.
-    return quotaRoleSorter->allocationScalarQuantities(role).toUnreserved();
-  };
+      // NOTE: `allocationQuantities` omits all reservation, persistent
+      // volume and allocation info, since the quantities are keyed by
+      // resource name only.
+      return quotaRoleSorter->allocationQuantities(role);
+    };
 
   // Due to the two stages in the allocation algorithm and the nature of
   // shared resources being re-offerable even if already allocated, the
@@ -1580,14 +1851,22 @@ void HierarchicalAllocatorProcess::__allocate()
   // allocated in the current cycle.
   hashmap<SlaveID, Resources> offeredSharedResources;
 
+  // The guarantees are looked up for every agent and quota role below,
+  // so we only convert them to quantities once per allocation run.
+  //
+  // NOTE: Only scalars are considered for quota.
+  hashmap<string, ResourceQuantities> guarantees;
+  foreachpair (const string& role, const Quota& quota, quotas) {
+    guarantees.put(
+        role, ResourceQuantities::fromScalarResources(quota.info.guarantee()));
+  }
+
   // Quota comes first and fair share second. Here we process only those
   // roles for which quota is set (quota'ed roles). Such roles form a
   // special allocation group with a dedicated sorter.
   foreach (const SlaveID& slaveId, slaveIds) {
     foreach (const string& role, quotaRoleSorter->sort()) {
-      CHECK(quotas.contains(role));
-
-      const Quota& quota = quotas.at(role);
+      CHECK(guarantees.contains(role));
 
       // If there are no active frameworks in this role, we do not
       // need to do any allocations for this role.
@@ -1597,7 +1876,10 @@ void HierarchicalAllocatorProcess::__allocate()
 
       // Get the total quantity of resources allocated to a quota role. The
       // value omits role, reservation, and persistence info.
-      Resources roleConsumedResources = getQuotaRoleAllocatedResources(role);
+      const ResourceQuantities& roleConsumedQuantities =
+        getQuotaRoleAllocatedQuantities(role);
+
+      const ResourceQuantities& guaranteeQuantities = guarantees.at(role);
 
       // If quota for the role is satisfied, we do not need to do
       // any further allocations for this role, at least at this
@@ -1615,8 +1897,10 @@ void HierarchicalAllocatorProcess::__allocate()
       //   * A custom sorter that is aware of quotas and sorts accordingly.
       //   * Removing satisfied roles from the sorter.
       bool someGuaranteesReached = false;
-      foreach (const Resource& guarantee, quota.info.guarantee()) {
-        if (roleConsumedResources.contains(guarantee)) {
+      for (size_t i = 0; i < guaranteeQuantities.size(); i++) {
+        const string& name = guaranteeQuantities.keys()[i];
+
+        if (guaranteeQuantities.at(i) <= roleConsumedQuantities.get(name)) {
           someGuaranteesReached = true;
           break;
         }
@@ -1643,18 +1927,12 @@ void HierarchicalAllocatorProcess::__allocate()
 
         Slave& slave = slaves.at(slaveId);
 
-        // Only offer resources from slaves that have GPUs to
-        // frameworks that are capable of receiving GPUs.
-        // See MESOS-5634.
-        if (filterGpuResources &&
-            !framework.capabilities.gpuResources &&
-            slave.total.gpus().getOrElse(0) > 0) {
-          continue;
-        }
-
-        // If this framework is not region-aware, don't offer it
-        // resources on agents in remote regions.
-        if (!framework.capabilities.regionAware && isRemoteSlave(slave)) {
+        // Only offer resources to frameworks which are capable of
+        // handling the agent, e.g., frameworks that are not capable of
+        // receiving GPUs are not offered resources of agents that have
+        // GPUs (see MESOS-5634), and frameworks that are not region-aware
+        // are not offered resources of agents in remote regions.
+        if ((slave.requirements & ~framework.supported()) != 0) {
           continue;
         }
 
@@ -1664,12 +1942,12 @@ void HierarchicalAllocatorProcess::__allocate()
         // Since shared resources are offerable even when they are in use, we
         // make one copy of the shared resources available regardless of the
         // past allocations.
-        Resources available = slave.available().nonShared();
+        Resources available = slave.getAvailableNonShared();
 
         // Offer a shared resource only if it has not been offered in
         // this offer cycle to a framework.
         if (framework.capabilities.sharedResources) {
-          available += slave.total.shared();
+          available += slave.getTotalShared();
           if (offeredSharedResources.contains(slaveId)) {
             available -= offeredSharedResources[slaveId];
           }
@@ -1735,7 +2013,10 @@ void HierarchicalAllocatorProcess::__allocate()
         offerable[frameworkId][role][slaveId] += resources;
         offeredSharedResources[slaveId] += resources.shared();
 
-        slave.allocated += resources;
+        slave.allocate(resources);
+
+        offeredOrAllocated +=
+          ResourceQuantities::fromScalarResources(resources);
 
         trackAllocatedResources(slaveId, frameworkId, resources);
       }
@@ -1761,22 +2042,23 @@ void HierarchicalAllocatorProcess::__allocate()
 
   // Frameworks in a quota'ed role may temporarily reject resources by
   // filtering or suppressing offers. Hence quotas may not be fully allocated.
-  Resources unallocatedQuotaResources;
-  foreachpair (const string& name, const Quota& quota, quotas) {
+  ResourceQuantities unallocatedQuotaQuantities;
+  foreachpair (const string& name,
+               const ResourceQuantities& required,
+               guarantees) {
     // Compute the amount of quota that the role does not have allocated.
     //
     // NOTE: Revocable resources are excluded in `quotaRoleSorter`.
-    // NOTE: Only scalars are considered for quota.
-    Resources allocated = getQuotaRoleAllocatedResources(name);
-    const Resources required = quota.info.guarantee();
-    unallocatedQuotaResources += (required - allocated);
+    unallocatedQuotaQuantities +=
+      (required - getQuotaRoleAllocatedQuantities(name));
   }
 
   // Determine how many resources we may allocate during the next stage.
   //
   // NOTE: Resources for quota allocations are already accounted in
   // `remainingClusterResources`.
-  remainingClusterResources -= unallocatedQuotaResources;
+  remainingClusterResources -=
+    unallocatedQuotaQuantities.toUnreservedResources();
 
   // Shared resources are excluded in determination of over-allocation of
   // available resources since shared resources are always allocatable.
@@ -1798,11 +2080,24 @@ void HierarchicalAllocatorProcess::__allocate()
   // (typically by using `Resources::createStrippedScalarQuantity`).
   Resources allocatedStage2;
 
+  // The quantities of `remainingClusterResources` and `allocatedStage2`,
+  // i.e., their scalar values summed by name, are much cheaper to check
+  // than the resources themselves. An offer can only fit into the
+  // remaining resources if its quantities fit into the remaining
+  // quantities, so most offers that do not fit are rejected without any
+  // `Resources` arithmetic. As `allocatedStage2` is always contained in
+  // `remainingClusterResources`, the quantities also tell whether there
+  // are resources left for the second stage.
+  const ResourceQuantities remainingClusterQuantities =
+    ResourceQuantities::fromScalarResources(remainingClusterResources);
+
+  ResourceQuantities allocatedStage2Quantities;
+
   // At this point resources for quotas are allocated or accounted for.
   // Proceed with allocating the remaining free pool.
   foreach (const SlaveID& slaveId, slaveIds) {
     // If there are no resources available for the second stage, stop.
-    if (!allocatable(remainingClusterResources - allocatedStage2)) {
+    if (!allocatable(remainingClusterQuantities - allocatedStage2Quantities)) {
       break;
     }
 
@@ -1821,18 +2116,12 @@ void HierarchicalAllocatorProcess::__allocate()
         const Framework& framework = frameworks.at(frameworkId);
         Slave& slave = slaves.at(slaveId);
 
-        // Only offer resources from slaves that have GPUs to
-        // frameworks that are capable of receiving GPUs.
-        // See MESOS-5634.
-        if (filterGpuResources &&
-            !framework.capabilities.gpuResources &&
-            slave.total.gpus().getOrElse(0) > 0) {
-          continue;
-        }
-
-        // If this framework is not region-aware, don't offer it
-        // resources on agents in remote regions.
-        if (!framework.capabilities.regionAware && isRemoteSlave(slave)) {
+        // Only offer resources to frameworks which are capable of
+        // handling the agent, e.g., frameworks that are not capable of
+        // receiving GPUs are not offered resources of agents that have
+        // GPUs (see MESOS-5634), and frameworks that are not region-aware
+        // are not offered resources of agents in remote regions.
+        if ((slave.requirements & ~framework.supported()) != 0) {
           continue;
         }
 
@@ -1842,12 +2131,12 @@ void HierarchicalAllocatorProcess::__allocate()
         // Since shared resources are offerable even when they are in use, we
         // make one copy of the shared resources available regardless of the
         // past allocations.
-        Resources available = slave.available().nonShared();
+        Resources available = slave.getAvailableNonShared();
 
         // Offer a shared resource only if it has not been offered in
         // this offer cycle to a framework.
         if (framework.capabilities.sharedResources) {
-          available += slave.total.shared();
+          available += slave.getTotalShared();
           if (offeredSharedResources.contains(slaveId)) {
             available -= offeredSharedResources[slaveId];
           }
@@ -1924,8 +2213,19 @@ void HierarchicalAllocatorProcess::__allocate()
         //
         // We exclude shared resources from over-allocation check because
         // shared resources are always allocatable.
+        const Resources nonShared = resources.nonShared();
+
+        const ResourceQuantities quantities =
+          ResourceQuantities::fromScalarResources(nonShared);
+
+        if (!remainingClusterQuantities.contains(
+                allocatedStage2Quantities + quantities)) {
+          continue;
+        }
+
+        // The quantities fit, but the reservations might not.
         const Resources scalarQuantity =
-          resources.nonShared().createStrippedScalarQuantity();
+          nonShared.createStrippedScalarQuantity();
 
         if (!remainingClusterResources.contains(
                 allocatedStage2 + scalarQuantity)) {
@@ -1945,8 +2245,12 @@ void HierarchicalAllocatorProcess::__allocate()
         offerable[frameworkId][role][slaveId] += resources;
         offeredSharedResources[slaveId] += resources.shared();
         allocatedStage2 += scalarQuantity;
+        allocatedStage2Quantities += quantities;
+
+        slave.allocate(resources);
 
-        slave.allocated += resources;
+        offeredOrAllocated +=
+          ResourceQuantities::fromScalarResources(resources);
 
         trackAllocatedResources(slaveId, frameworkId, resources);
       }
@@ -1964,7 +2268,8 @@ void HierarchicalAllocatorProcess::__allocate()
 }
 
 
-void HierarchicalAllocatorProcess::deallocate()
+void HierarchicalAllocatorProcess::deallocate(
+    const hashset<SlaveID>& candidates)
 {
   // If no frameworks are currently registered, no work to do.
   if (roles.empty()) {
@@ -1988,8 +2293,12 @@ void HierarchicalAllocatorProcess::deallocate()
   // responded yet.
 
   foreachvalue (const Owned<Sorter>& frameworkSorter, frameworkSorters) {
-    foreach (const SlaveID& slaveId, allocationCandidates) {
-      CHECK(slaves.contains(slaveId));
+    foreach (const SlaveID& slaveId, candidates) {
+      // NOTE: The agent may have been removed while an earlier shard
+      // of the allocation run was processed.
+      if (!slaves.contains(slaveId)) {
+        continue;
+      }
 
       Slave& slave = slaves.at(slaveId);
 
@@ -2064,56 +2373,82 @@ void HierarchicalAllocatorProcess::deallocate()
 }
 
 
-void HierarchicalAllocatorProcess::_expire(
-    const FrameworkID& frameworkId,
-    const string& role,
-    const SlaveID& slaveId,
-    OfferFilter* offerFilter)
+void HierarchicalAllocatorProcess::scheduleExpire()
 {
-  // The filter might have already been removed (e.g., if the
-  // framework no longer exists or in `reviveOffers()`) but not
-  // yet deleted (to keep the address from getting reused
-  // possibly causing premature expiration).
-  //
-  // Since this is a performance-sensitive piece of code,
-  // we use find to avoid the doing any redundant lookups.
+  if (expireTimer.isSome()) {
+    Clock::cancel(expireTimer.get());
+    expireTimer = None();
+  }
 
-  auto frameworkIterator = frameworks.find(frameworkId);
-  if (frameworkIterator != frameworks.end()) {
-    Framework& framework = frameworkIterator->second;
+  if (offerFilterExpiries.empty()) {
+    return;
+  }
+
+  // We need to disambiguate the function call to pick the correct
+  // `expire()` overload.
+  void (Self::*expireOffers)() = &Self::expire;
+
+  expireTimer = delay(
+      std::max(
+          Duration::zero(),
+          offerFilterExpiries.begin()->first - Clock::now()),
+      self(),
+      expireOffers);
+}
+
+
+void HierarchicalAllocatorProcess::_expire(const Time& time)
+{
+  while (!offerFilterExpiries.empty() &&
+         offerFilterExpiries.begin()->first <= time) {
+    const OfferFilterExpiry& expiry = offerFilterExpiries.begin()->second;
+
+    // The filter might have already been removed (e.g., if the
+    // framework no longer exists or in `reviveOffers()`) but not
+    // yet deleted (to keep the address from getting reused
+    // possibly causing premature expiration).
+    //
+    // Since this is a performance-sensitive piece of code,
+    // we use find to avoid the doing any redundant lookups.
+
+    auto frameworkIterator = frameworks.find(expiry.frameworkId);
+    if (frameworkIterator != frameworks.end()) {
+      Framework& framework = frameworkIterator->second;
 
-    auto roleFilters = framework.offerFilters.find(role);
-    if (roleFilters != framework.offerFilters.end()) {
-      auto agentFilters = roleFilters->second.find(slaveId);
+      auto roleFilters = framework.offerFilters.find(expiry.role);
+      if (roleFilters != framework.offerFilters.end()) {
+        auto agentFilters = roleFilters->second.find(expiry.slaveId);
 
-      if (agentFilters != roleFilters->second.end()) {
-        // Erase the filter (may be a no-op per the comment above).
-        agentFilters->second.erase(offerFilter);
+        if (agentFilters != roleFilters->second.end()) {
+          // Erase the filter (may be a no-op per the comment above).
+          agentFilters->second.erase(expiry.offerFilter);
 
-        if (agentFilters->second.empty()) {
-          roleFilters->second.erase(slaveId);
+          if (agentFilters->second.empty()) {
+            roleFilters->second.erase(expiry.slaveId);
+          }
         }
       }
     }
+
+    if (slaves.contains(expiry.slaveId)) {
+      changedSlaves.insert(expiry.slaveId);
+    }
+
+    delete expiry.offerFilter;
+
+    offerFilterExpiries.erase(offerFilterExpiries.begin());
   }
 
-  delete offerFilter;
+  scheduleExpire();
 }
 
 
-void HierarchicalAllocatorProcess::expire(
-    const FrameworkID& frameworkId,
-    const string& role,
-    const SlaveID& slaveId,
-    OfferFilter* offerFilter)
+void HierarchicalAllocatorProcess::expire()
 {
-  dispatch(
-      self(),
-      &Self::_expire,
-      frameworkId,
-      role,
-      slaveId,
-      offerFilter);
+  // The timer has fired, `scheduleExpire()` must not cancel it.
+  expireTimer = None();
+
+  dispatch(self(), &Self::_expire, Clock::now());
 }
 
 
@@ -2139,6 +2474,10 @@ void HierarchicalAllocatorProcess::expire(
     if (filters != framework.inverseOfferFilters.end()) {
       filters->second.erase(inverseOfferFilter);
 
+      if (slaves.contains(slaveId)) {
+        changedSlaves.insert(slaveId);
+      }
+
       if (filters->second.empty()) {
         framework.inverseOfferFilters.erase(slaveId);
       }
@@ -2211,8 +2550,11 @@ bool HierarchicalAllocatorProcess::isFiltered(
     return false;
   }
 
+  const ResourceQuantities quantities =
+    ResourceQuantities::fromScalarResources(resources);
+
   foreach (OfferFilter* offerFilter, agentFilters->second) {
-    if (offerFilter->filter(resources)) {
+    if (offerFilter->filter(resources, quantities)) {
       VLOG(1) << "Filtered offer with " << resources
               << " on agent " << slaveId
               << " for role " << role
@@ -2262,32 +2604,20 @@ bool HierarchicalAllocatorProcess::allocatable(
 }
 
 
-double HierarchicalAllocatorProcess::_resources_offered_or_allocated(
-    const string& resource)
+bool HierarchicalAllocatorProcess::allocatable(
+    const ResourceQuantities& quantities)
 {
-  double offered_or_allocated = 0;
-
-  foreachvalue (const Slave& slave, slaves) {
-    Option<Value::Scalar> value =
-      slave.allocated.get<Value::Scalar>(resource);
+  const double cpus = quantities.get("cpus").value();
+  const Bytes mem = Megabytes(
+      static_cast<uint64_t>(quantities.get("mem").value()));
 
-    if (value.isSome()) {
-      offered_or_allocated += value->value();
-    }
-  }
-
-  return offered_or_allocated;
+  return cpus >= MIN_CPUS || mem >= MIN_MEM;
 }
 
 
-double HierarchicalAllocatorProcess::_resources_total(
-    const string& resource)
+void HierarchicalAllocatorProcess::updateResourceMetrics()
 {
-  Option<Value::Scalar> total =
-    roleSorter->totalScalarQuantities()
-      .get<Value::Scalar>(resource);
-
-  return total.isSome() ? total->value() : 0;
+  metrics.setResources(roleSorter->totalQuantities(), offeredOrAllocated);
 }
 
 
@@ -2295,11 +2625,7 @@ double HierarchicalAllocatorProcess::_quota_allocated(
     const string& role,
     const string& resource)
 {
-  Option<Value::Scalar> used =
-    quotaRoleSorter->allocationScalarQuantities(role)
-      .get<Value::Scalar>(resource);
-
-  return used.isSome() ? used->value() : 0;
+  return quotaRoleSorter->allocationQuantities(role).get(resource).value();
 }
 
 
@@ -2308,13 +2634,26 @@ double HierarchicalAllocatorProcess::_offer_filters_active(
 {
   double result = 0;
 
-  foreachvalue (const Framework& framework, frameworks) {
+  if (!roles.contains(role)) {
+    return result;
+  }
+
+  // Only the frameworks tracked under the role can have filters for it,
+  // so there is no need to look at all of the frameworks for each role.
+  foreach (const FrameworkID& frameworkId, roles.at(role)) {
+    if (!frameworks.contains(frameworkId)) {
+      continue;
+    }
+
+    const Framework& framework = frameworks.at(frameworkId);
+
     if (!framework.offerFilters.contains(role)) {
       continue;
     }
 
-    foreachkey (const SlaveID& slaveId, framework.offerFilters.at(role)) {
-      result += framework.offerFilters.at(role).at(slaveId).size();
+    foreachvalue (const hashset<OfferFilter*>& filters,
+                  framework.offerFilters.at(role)) {
+      result += filters.size();
     }
   }
 
@@ -2403,30 +2742,56 @@ bool HierarchicalAllocatorProcess::updateSlaveTotal(
 
   Slave& slave = slaves.at(slaveId);
 
-  const Resources oldTotal = slave.total;
+  const Resources oldTotal = slave.getTotal();
 
   if (oldTotal == total) {
     return false;
   }
 
-  slave.total = total;
+  slave.updateTotal(total);
+  slave.requirements = requirements(slave);
+
+  changedSlaves.insert(slaveId);
 
   // Currently `roleSorter` and `quotaRoleSorter`, being the root-level
   // sorters, maintain all of `slaves[slaveId].total` (or the `nonRevocable()`
   // portion in the case of `quotaRoleSorter`) in their own totals (which
   // don't get updated in the allocation runs or during recovery of allocated
-  // resources). So, we update them using the resources in `slave.total`.
-  roleSorter->remove(slaveId, oldTotal);
-  roleSorter->add(slaveId, total);
+  // resources). So, we update them with the changes of `slave.total`, which
+  // are typically much smaller than the total of agents with resource
+  // providers.
+  const Resources removed = oldTotal - total;
+  const Resources added = total - oldTotal;
+
+  roleSorter->remove(slaveId, removed);
+  roleSorter->add(slaveId, added);
 
   // See comment at `quotaRoleSorter` declaration regarding non-revocable.
-  quotaRoleSorter->remove(slaveId, oldTotal.nonRevocable());
-  quotaRoleSorter->add(slaveId, total.nonRevocable());
+  quotaRoleSorter->remove(slaveId, removed.nonRevocable());
+  quotaRoleSorter->add(slaveId, added.nonRevocable());
+
+  updateResourceMetrics();
 
   return true;
 }
 
 
+uint8_t HierarchicalAllocatorProcess::requirements(const Slave& slave) const
+{
+  uint8_t requirements = 0;
+
+  if (filterGpuResources && slave.getTotal().gpus().getOrElse(0) > 0) {
+    requirements |= GPU_RESOURCES;
+  }
+
+  if (isRemoteSlave(slave)) {
+    requirements |= REGION_AWARE;
+  }
+
+  return requirements;
+}
+
+
 bool HierarchicalAllocatorProcess::isRemoteSlave(const Slave& slave) const
 {
   // If the slave does not have a configured domain, assume it is not remote.
@@ -2511,6 +2876,10 @@ void HierarchicalAllocatorProcess::untrackAllocatedResources(
   // the framework's resources.
   CHECK(frameworks.contains(frameworkId));
 
+  if (slaves.contains(slaveId)) {
+    changedSlaves.insert(slaveId);
+  }
+
   // TODO(bmahler): Calling allocations() is expensive since it has
   // to construct a map. Avoid this.
   foreachpair (const string& role,
@@ -17,26 +17,33 @@
 #ifndef __MASTER_ALLOCATOR_MESOS_HIERARCHICAL_HPP__
 #define __MASTER_ALLOCATOR_MESOS_HIERARCHICAL_HPP__
 
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <mesos/mesos.hpp>
 
 #include <process/future.hpp>
 #include <process/id.hpp>
 #include <process/owned.hpp>
+#include <process/timeout.hpp>
+#include <process/time.hpp>
+#include <process/timer.hpp>
 
 #include <stout/duration.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
 #include <stout/lambda.hpp>
 #include <stout/option.hpp>
+#include <stout/stopwatch.hpp>
 
 #include "common/protobuf_utils.hpp"
 
 #include "master/allocator/mesos/allocator.hpp"
 #include "master/allocator/mesos/metrics.hpp"
 
+#include "master/allocator/sorter/bucketed/sorter.hpp"
 #include "master/allocator/sorter/drf/sorter.hpp"
 
 #include "master/constants.hpp"
@@ -60,6 +67,14 @@ HierarchicalDRFAllocatorProcess;
 typedef MesosAllocator<HierarchicalDRFAllocatorProcess>
 HierarchicalDRFAllocator;
 
+// Sorts the frameworks of each role with the approximate, bucketed
+// DRF sorter, while the roles are still sorted with exact DRF.
+typedef HierarchicalAllocatorProcess<DRFSorter, BucketedDRFSorter, DRFSorter>
+HierarchicalBucketedDRFAllocatorProcess;
+
+typedef MesosAllocator<HierarchicalBucketedDRFAllocatorProcess>
+HierarchicalBucketedDRFAllocator;
+
 
 namespace internal {
 
@@ -84,7 +99,7 @@ public:
       quotaRoleSorter(quotaRoleSorterFactory()),
       frameworkSorterFactory(_frameworkSorterFactory) {}
 
-  virtual ~HierarchicalAllocatorProcess() {}
+  virtual ~HierarchicalAllocatorProcess();
 
   process::PID<HierarchicalAllocatorProcess> self() const
   {
@@ -104,7 +119,10 @@ public:
       const Option<std::set<std::string>>&
         fairnessExcludeResourceNames = None(),
       bool filterGpuResources = true,
-      const Option<DomainInfo>& domain = None());
+      const Option<DomainInfo>& domain = None(),
+      size_t allocationShards = 1,
+      const Option<Duration>& allocationSweepInterval = None(),
+      const Option<Duration>& maxAllocationInterval = None());
 
   void recover(
       const int _expectedAgentCount,
@@ -198,6 +216,11 @@ public:
       const Resources& resources,
       const Option<Filters>& filters);
 
+  void batchRecoverResources(
+      const FrameworkID& frameworkId,
+      const hashmap<SlaveID, Resources>& resources,
+      const Option<Filters>& filters);
+
   void suppressOffers(
       const FrameworkID& frameworkId,
       const std::set<std::string>& roles);
@@ -235,27 +258,40 @@ protected:
   // is deferred and batched with other allocation requests.
   process::Future<Nothing> allocate(const hashset<SlaveID>& slaveIds);
 
+  // Performs the periodic batch allocation, which allocates either
+  // all agents or, if `allocationSweepInterval` is set and a sweep of
+  // all agents is not due, only the `changedSlaves`.
+  process::Future<Nothing> batch();
+
+  // Returns the interval until the next batch allocation, which is
+  // adapted to the load of the allocator if `maxAllocationInterval`
+  // is set, see `--max_allocation_interval`.
+  Duration nextAllocationInterval();
+
   // Method that performs allocation work.
-  Nothing _allocate();
+  process::Future<Nothing> _allocate();
+
+  // Helper for `_allocate()` that allocates the resources of the
+  // agents in the given shard of the current allocation run. Every
+  // shard but the last dispatches the allocation of the next shard,
+  // so that other events can be processed in between shards.
+  process::Future<Nothing> allocateShard(size_t shard);
 
   // Helper for `_allocate()` that allocates resources for offers.
-  void __allocate();
+  void __allocate(const hashset<SlaveID>& candidates);
 
   // Helper for `_allocate()` that deallocates resources for inverse offers.
-  void deallocate();
+  void deallocate(const hashset<SlaveID>& candidates);
 
-  // Remove an offer filter for the specified role of the framework.
-  void expire(
-      const FrameworkID& frameworkId,
-      const std::string& role,
-      const SlaveID& slaveId,
-      OfferFilter* offerFilter);
+  // Sets the timer for the earliest offer filter expiry, if any,
+  // replacing the current timer.
+  void scheduleExpire();
 
-  void _expire(
-      const FrameworkID& frameworkId,
-      const std::string& role,
-      const SlaveID& slaveId,
-      OfferFilter* offerFilter);
+  // Remove the offer filters which have expired by now.
+  void expire();
+
+  // Remove the offer filters which expire no later than `time`.
+  void _expire(const process::Time& time);
 
   // Remove an inverse offer filter for the specified framework.
   void expire(
@@ -282,6 +318,11 @@ protected:
 
   static bool allocatable(const Resources& resources);
 
+  // Same as above for the quantities of resources, i.e., `cpus` and
+  // `mem` are summed across reservations like `Resources::cpus()` and
+  // `Resources::mem()` do.
+  static bool allocatable(const ResourceQuantities& quantities);
+
   bool initialized;
   bool paused;
 
@@ -290,6 +331,23 @@ protected:
 
   Duration allocationInterval;
 
+  struct OfferFilterExpiry
+  {
+    FrameworkID frameworkId;
+    std::string role;
+    SlaveID slaveId;
+    OfferFilter* offerFilter;
+  };
+
+  // The offer filters ordered by when they expire. Rather than a
+  // timer per filter, there is a single timer for the earliest
+  // expiry, which keeps the number of timers constant when there are
+  // many filters, e.g., due to frameworks declining offers with a long
+  // `refuse_seconds` on many agents. Filters are owned by this and
+  // deleted on expiry, see `reviveOffers()`.
+  std::multimap<process::Time, OfferFilterExpiry> offerFilterExpiries;
+  Option<process::Timer> expireTimer;
+
   lambda::function<
       void(const FrameworkID&,
            const hashmap<std::string, hashmap<SlaveID, Resources>>&)>
@@ -303,6 +361,21 @@ protected:
   friend Metrics;
   Metrics metrics;
 
+  // Properties of an agent which a framework needs to be capable of
+  // handling to be offered resources of the agent. These are kept as
+  // a bitset per agent, which is updated along with the agent, so that
+  // the allocation loops can skip incompatible frameworks with a single
+  // bitwise test rather than by inspecting the agent's resources and
+  // domain for every framework.
+  enum Requirement : uint8_t
+  {
+    // The agent has GPUs and `filterGpuResources` is set, see MESOS-5634.
+    GPU_RESOURCES = 1 << 0,
+
+    // The agent is in a different region than the master.
+    REGION_AWARE = 1 << 1,
+  };
+
   struct Framework
   {
     Framework(
@@ -316,6 +389,14 @@ protected:
 
     protobuf::framework::Capabilities capabilities;
 
+    // Returns the bitset of the agent requirements the framework is
+    // capable of handling, see `Requirement`.
+    uint8_t supported() const
+    {
+      return (capabilities.gpuResources ? GPU_RESOURCES : 0) |
+             (capabilities.regionAware ? REGION_AWARE : 0);
+    }
+
     // Active offer and inverse offer filters for the framework.
     // Offer filters are tied to the role the filtered resources
     // were allocated to.
@@ -330,11 +411,9 @@ protected:
     return static_cast<double>(eventCount<process::DispatchEvent>());
   }
 
-  double _resources_total(
-      const std::string& resource);
-
-  double _resources_offered_or_allocated(
-      const std::string& resource);
+  // Pushes the current resource quantities to the gauges of the
+  // metrics, see `Metrics::setResources()`.
+  void updateResourceMetrics();
 
   double _quota_allocated(
       const std::string& role,
@@ -347,37 +426,51 @@ protected:
 
   struct Slave
   {
-    // Total amount of regular *and* oversubscribed resources.
-    Resources total;
+    const Resources& getTotal() const { return total; }
 
-    // Regular *and* oversubscribed resources that are allocated.
-    //
-    // NOTE: We maintain multiple copies of each shared resource allocated
-    // to a slave, where the number of copies represents the number of times
-    // this shared resource has been allocated to (and has not been recovered
-    // from) a specific framework.
-    //
-    // NOTE: We keep track of slave's allocated resources despite
-    // having that information in sorters. This is because the
-    // information in sorters is not accurate if some framework
-    // hasn't reregistered. See MESOS-2919 for details.
-    Resources allocated;
+    const Resources& getAllocated() const { return allocated; }
 
     // We track the total and allocated resources on the slave, the
-    // available resources are computed as follows:
+    // available resources are kept up to date as follows:
     //
     //   available = total - allocated
     //
     // Note that it's possible for the slave to be over-allocated!
     // In this case, allocated > total.
-    Resources available() const
+    //
+    // NOTE: The available resources are looked up for every role and
+    // framework considered for the agent in an allocation run, which
+    // is why they are cached rather than computed on demand.
+    const Resources& available() const { return available_; }
+
+    // The views of the resources that an allocation run starts from
+    // for every framework: the available non-shared resources, and
+    // all the shared resources on the agent, which are offerable even
+    // when they are in use.
+    const Resources& getAvailableNonShared() const
     {
-      // In order to subtract from the total,
-      // we strip the allocation information.
-      Resources allocated_ = allocated;
-      allocated_.unallocate();
+      return availableNonShared;
+    }
 
-      return total - allocated_;
+    const Resources& getTotalShared() const { return totalShared; }
+
+    void updateTotal(const Resources& _total)
+    {
+      total = _total;
+      totalShared = total.shared();
+      updateAvailable();
+    }
+
+    void allocate(const Resources& resources)
+    {
+      allocated += resources;
+      updateAvailable();
+    }
+
+    void unallocate(const Resources& resources)
+    {
+      allocated -= resources;
+      updateAvailable();
     }
 
     bool activated;  // Whether to offer resources.
@@ -390,6 +483,10 @@ protected:
 
     protobuf::slave::Capabilities capabilities;
 
+    // The bitset of the `Requirement`s of the agent, which depend on
+    // `total` and `info`, see `requirements()`.
+    uint8_t requirements = 0;
+
     // Represents a scheduled unavailability due to maintenance for a specific
     // slave, and the responses from frameworks as to whether they will be able
     // to gracefully handle this unavailability.
@@ -425,6 +522,40 @@ protected:
     // a given point in time, for an optional duration. This information is used
     // to send out `InverseOffers`.
     Option<Maintenance> maintenance;
+
+  private:
+    void updateAvailable()
+    {
+      // In order to subtract from the total,
+      // we strip the allocation information.
+      Resources allocated_ = allocated;
+      allocated_.unallocate();
+
+      available_ = total - allocated_;
+      availableNonShared = available_.nonShared();
+    }
+
+    // Total amount of regular *and* oversubscribed resources.
+    Resources total;
+
+    // Regular *and* oversubscribed resources that are allocated.
+    //
+    // NOTE: We maintain multiple copies of each shared resource allocated
+    // to a slave, where the number of copies represents the number of times
+    // this shared resource has been allocated to (and has not been recovered
+    // from) a specific framework.
+    //
+    // NOTE: We keep track of slave's allocated resources despite
+    // having that information in sorters. This is because the
+    // information in sorters is not accurate if some framework
+    // hasn't reregistered. See MESOS-2919 for details.
+    Resources allocated;
+
+    Resources available_;
+
+    // Derived from `available_` and `total` respectively.
+    Resources availableNonShared;
+    Resources totalShared;
   };
 
   hashmap<SlaveID, Slave> slaves;
@@ -438,12 +569,61 @@ protected:
   // ready after the allocation run is complete.
   Option<process::Future<Nothing>> allocation;
 
+  // Number of shards the allocation candidates are partitioned into
+  // in an allocation run. Each shard is allocated in a separate step
+  // of the allocator process: events that arrive while a run is in
+  // progress are processed in between shards and offers for a shard
+  // are sent out before the next shard is allocated. All shards are
+  // allocated on the allocator process, so quota and DRF accounting
+  // remains the same as for a single (unsharded) run.
+  size_t allocationShards = 1;
+
+  // The shards of the allocation run in progress, if any.
+  std::vector<hashset<SlaveID>> shards;
+
+  // If set, batch allocations only consider the agents which changed
+  // since the previous batch allocation, while all agents are swept at
+  // most this long apart.
+  Option<Duration> allocationSweepInterval;
+
+  // The agents whose available resources or filters may have changed
+  // since the previous batch allocation, without an allocation of the
+  // agent having been triggered.
+  hashset<SlaveID> changedSlaves;
+
+  // When the next batch allocation needs to sweep all agents. This is
+  // reset by changes which affect all agents, e.g., of the whitelist,
+  // quota or weights, so that the next batch allocation sweeps.
+  Option<process::Timeout> nextSweep;
+
+  // If set, the interval between batch allocations is adapted to the
+  // load of the allocator, between `allocationInterval` and this.
+  Option<Duration> maxAllocationInterval;
+
+  // The current interval between batch allocations.
+  Duration currentAllocationInterval;
+
+  // Whether no agent changed before the last batch allocation, see
+  // `nextAllocationInterval()`.
+  bool idleBatch = false;
+
+  // Stopwatch for the allocation run in progress.
+  Stopwatch allocationStopwatch;
+
+  // The duration of the last completed allocation run.
+  Duration lastAllocationRun;
+
   // We track information about roles that we're aware of in the system.
   // Specifically, we keep track of the roles when a framework subscribes to
   // the role, and/or when there are resources allocated to the role
   // (e.g. some tasks and/or executors are consuming resources under the role).
   hashmap<std::string, hashset<FrameworkID>> roles;
 
+  // The quantities of the offered or allocated resources of all the
+  // agents, i.e., the sum of `Slave::allocated`, which are maintained
+  // for the metrics rather than summed up whenever they are read.
+  ResourceQuantities offeredOrAllocated;
+
   // Configured quota for each role, if any. Setting quota for a role
   // changes the order that the role's frameworks are offered
   // resources. Quota comes before fair share, hence setting quota moves
@@ -556,6 +736,9 @@ private:
   // the agent and the master are both configured with a fault domain.
   bool isRemoteSlave(const Slave& slave) const;
 
+  // Helper that computes the `Requirement`s of the agent.
+  uint8_t requirements(const Slave& slave) const;
+
   // Helper to track allocated resources on an agent.
   void trackAllocatedResources(
       const SlaveID& slaveId,
@@ -22,14 +22,18 @@
 
 #include <process/metrics/gauge.hpp>
 #include <process/metrics/metrics.hpp>
+#include <process/metrics/timer.hpp>
 
 #include <stout/hashmap.hpp>
+#include <stout/stringify.hpp>
 
 #include "master/allocator/mesos/hierarchical.hpp"
 
 using std::string;
 
 using process::metrics::Gauge;
+using process::metrics::PushGauge;
+using process::metrics::Timer;
 
 namespace mesos {
 namespace internal {
@@ -49,13 +53,19 @@ Metrics::Metrics(const HierarchicalAllocatorProcess& _allocator)
             allocator, &HierarchicalAllocatorProcess::_event_queue_dispatches)),
     allocation_runs("allocator/mesos/allocation_runs"),
     allocation_run("allocator/mesos/allocation_run", Hours(1)),
-    allocation_run_latency("allocator/mesos/allocation_run_latency", Hours(1))
+    allocation_run_latency("allocator/mesos/allocation_run_latency", Hours(1)),
+    allocation_interval("allocator/mesos/allocation_interval_ms"),
+    allocation_interval_busy("allocator/mesos/allocation_interval/busy"),
+    allocation_interval_idle("allocator/mesos/allocation_interval/idle")
 {
   process::metrics::add(event_queue_dispatches);
   process::metrics::add(event_queue_dispatches_);
   process::metrics::add(allocation_runs);
   process::metrics::add(allocation_run);
   process::metrics::add(allocation_run_latency);
+  process::metrics::add(allocation_interval);
+  process::metrics::add(allocation_interval_busy);
+  process::metrics::add(allocation_interval_idle);
 
   // Create and install gauges for the total and allocated
   // amount of standard scalar resources.
@@ -67,20 +77,13 @@ Metrics::Metrics(const HierarchicalAllocatorProcess& _allocator)
   string resources[] = {"cpus", "mem", "disk"};
 
   foreach (const string& resource, resources) {
-    Gauge total(
-        "allocator/mesos/resources/" + resource + "/total",
-        defer(allocator,
-              &HierarchicalAllocatorProcess::_resources_total,
-              resource));
+    PushGauge total("allocator/mesos/resources/" + resource + "/total");
 
-    Gauge offered_or_allocated(
-        "allocator/mesos/resources/" + resource + "/offered_or_allocated",
-        defer(allocator,
-              &HierarchicalAllocatorProcess::_resources_offered_or_allocated,
-              resource));
+    PushGauge offered_or_allocated(
+        "allocator/mesos/resources/" + resource + "/offered_or_allocated");
 
-    resources_total.push_back(total);
-    resources_offered_or_allocated.push_back(offered_or_allocated);
+    resources_total.put(resource, total);
+    resources_offered_or_allocated.put(resource, offered_or_allocated);
 
     process::metrics::add(total);
     process::metrics::add(offered_or_allocated);
@@ -95,12 +98,19 @@ Metrics::~Metrics()
   process::metrics::remove(allocation_runs);
   process::metrics::remove(allocation_run);
   process::metrics::remove(allocation_run_latency);
+  process::metrics::remove(allocation_interval);
+  process::metrics::remove(allocation_interval_busy);
+  process::metrics::remove(allocation_interval_idle);
+
+  foreach (const Timer<Milliseconds>& timer, allocation_run_shards) {
+    process::metrics::remove(timer);
+  }
 
-  foreach (const Gauge& gauge, resources_total) {
+  foreachvalue (const PushGauge& gauge, resources_total) {
     process::metrics::remove(gauge);
   }
 
-  foreach (const Gauge& gauge, resources_offered_or_allocated) {
+  foreachvalue (const PushGauge& gauge, resources_offered_or_allocated) {
     process::metrics::remove(gauge);
   }
 
@@ -122,6 +132,22 @@ Metrics::~Metrics()
 }
 
 
+void Metrics::setResources(
+    const ResourceQuantities& total,
+    const ResourceQuantities& offeredOrAllocated)
+{
+  foreachpair (const string& resource, PushGauge& gauge, resources_total) {
+    gauge = total.get(resource).value();
+  }
+
+  foreachpair (const string& resource,
+               PushGauge& gauge,
+               resources_offered_or_allocated) {
+    gauge = offeredOrAllocated.get(resource).value();
+  }
+}
+
+
 void Metrics::setQuota(const string& role, const Quota& quota)
 {
   CHECK(!quota_allocated.contains(role));
@@ -201,6 +227,22 @@ void Metrics::removeRole(const string& role)
   process::metrics::remove(gauge.get());
 }
 
+
+void Metrics::setAllocationShards(size_t shards)
+{
+  CHECK(allocation_run_shards.empty());
+
+  for (size_t shard = 0; shard < shards; ++shard) {
+    Timer<Milliseconds> timer(
+        "allocator/mesos/shards/" + stringify(shard) + "/allocation_run",
+        Hours(1));
+
+    allocation_run_shards.push_back(timer);
+
+    process::metrics::add(timer);
+  }
+}
+
 } // namespace internal {
 } // namespace allocator {
 } // namespace master {
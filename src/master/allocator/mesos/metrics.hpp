@@ -24,12 +24,15 @@
 
 #include <process/metrics/counter.hpp>
 #include <process/metrics/gauge.hpp>
+#include <process/metrics/push_gauge.hpp>
 #include <process/metrics/timer.hpp>
 
 #include <process/pid.hpp>
 
 #include <stout/hashmap.hpp>
 
+#include "common/resource_quantities.hpp"
+
 namespace mesos {
 namespace internal {
 namespace master {
@@ -53,6 +56,14 @@ struct Metrics
   void addRole(const std::string& role);
   void removeRole(const std::string& role);
 
+  void setAllocationShards(size_t shards);
+
+  // Sets the gauges of the total and the offered or allocated amount
+  // of each resource in the cluster.
+  void setResources(
+      const ResourceQuantities& total,
+      const ResourceQuantities& offeredOrAllocated);
+
   const process::PID<HierarchicalAllocatorProcess> allocator;
 
   // Number of dispatch events currently waiting in the allocator process.
@@ -72,11 +83,28 @@ struct Metrics
   // The latency of allocation runs due to the batching of allocation requests.
   process::metrics::Timer<Milliseconds> allocation_run_latency;
 
+  // Time spent in the allocation algorithm for each shard of the agents,
+  // if the allocation runs are sharded.
+  std::vector<process::metrics::Timer<Milliseconds>> allocation_run_shards;
+
+  // The current interval between batch allocations in milliseconds,
+  // see `--max_allocation_interval`.
+  process::metrics::PushGauge allocation_interval;
+
+  // Number of times the interval between batch allocations was
+  // lengthened because the allocator was busy or idle, respectively.
+  process::metrics::Counter allocation_interval_busy;
+  process::metrics::Counter allocation_interval_idle;
+
   // Gauges for the total amount of each resource in the cluster.
-  std::vector<process::metrics::Gauge> resources_total;
+  //
+  // NOTE: These gauges are pushed by the allocator as the resources
+  // change, so that reading them does not dispatch to the allocator.
+  hashmap<std::string, process::metrics::PushGauge> resources_total;
 
   // Gauges for the allocated amount of each resource in the cluster.
-  std::vector<process::metrics::Gauge> resources_offered_or_allocated;
+  hashmap<std::string, process::metrics::PushGauge>
+    resources_offered_or_allocated;
 
   // Gauges for the per-role quota allocation for each resource.
   hashmap<std::string, hashmap<std::string, process::metrics::Gauge>>
@@ -0,0 +1,539 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "master/allocator/sorter/bucketed/sorter.hpp"
+
+#include <cmath>
+#include <limits>
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <mesos/mesos.hpp>
+#include <mesos/resources.hpp>
+
+#include <process/owned.hpp>
+#include <process/pid.hpp>
+
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/option.hpp>
+
+using std::list;
+using std::set;
+using std::string;
+using std::vector;
+
+using process::Owned;
+using process::UPID;
+
+namespace mesos {
+namespace internal {
+namespace master {
+namespace allocator {
+
+struct BucketedDRFSorter::Client
+{
+  explicit Client(const string& _name)
+    : name(_name), active(false), share(0), bucket(0) {}
+
+  string name;
+
+  bool active;
+
+  // The share and the bucket are only up to date for active clients.
+  double share;
+  int bucket;
+
+  // The position of an active client in the list of its bucket.
+  list<Client*>::iterator position;
+
+  // Same as the allocation of a node of `DRFSorter`.
+  struct Allocation
+  {
+    void add(const SlaveID& slaveId, const Resources& toAdd)
+    {
+      // Add shared resources to the allocated quantities when the same
+      // resources don't already exist in the allocation.
+      const Resources sharedToAdd = toAdd.shared()
+        .filter([this, slaveId](const Resource& resource) {
+            return !resources[slaveId].contains(resource);
+        });
+
+      const Resources quantitiesToAdd =
+        (toAdd.nonShared() + sharedToAdd).createStrippedScalarQuantity();
+
+      resources[slaveId] += toAdd;
+      scalarQuantities += quantitiesToAdd;
+      quantities += ResourceQuantities::fromScalarResources(quantitiesToAdd);
+    }
+
+    void subtract(const SlaveID& slaveId, const Resources& toRemove)
+    {
+      CHECK(resources.contains(slaveId));
+      CHECK(resources.at(slaveId).contains(toRemove))
+        << "Resources " << resources.at(slaveId) << " at agent " << slaveId
+        << " does not contain " << toRemove;
+
+      resources[slaveId] -= toRemove;
+
+      // Remove shared resources from the allocated quantities when there
+      // are no instances of same resources left in the allocation.
+      const Resources sharedToRemove = toRemove.shared()
+        .filter([this, slaveId](const Resource& resource) {
+            return !resources[slaveId].contains(resource);
+        });
+
+      const Resources quantitiesToRemove =
+        (toRemove.nonShared() + sharedToRemove).createStrippedScalarQuantity();
+
+      CHECK(scalarQuantities.contains(quantitiesToRemove))
+        << scalarQuantities << " does not contain " << quantitiesToRemove;
+
+      scalarQuantities -= quantitiesToRemove;
+      quantities -= ResourceQuantities::fromScalarResources(quantitiesToRemove);
+
+      if (resources[slaveId].empty()) {
+        resources.erase(slaveId);
+      }
+    }
+
+    void update(
+        const SlaveID& slaveId,
+        const Resources& oldAllocation,
+        const Resources& newAllocation)
+    {
+      const Resources oldAllocationQuantity =
+        oldAllocation.createStrippedScalarQuantity();
+      const Resources newAllocationQuantity =
+        newAllocation.createStrippedScalarQuantity();
+
+      CHECK(resources.contains(slaveId));
+      CHECK(resources[slaveId].contains(oldAllocation))
+        << "Resources " << resources[slaveId] << " at agent " << slaveId
+        << " does not contain " << oldAllocation;
+
+      CHECK(scalarQuantities.contains(oldAllocationQuantity))
+        << scalarQuantities << " does not contain " << oldAllocationQuantity;
+
+      resources[slaveId] -= oldAllocation;
+      resources[slaveId] += newAllocation;
+
+      scalarQuantities -= oldAllocationQuantity;
+      scalarQuantities += newAllocationQuantity;
+
+      quantities -=
+        ResourceQuantities::fromScalarResources(oldAllocationQuantity);
+      quantities +=
+        ResourceQuantities::fromScalarResources(newAllocationQuantity);
+    }
+
+    hashmap<SlaveID, Resources> resources;
+    Resources scalarQuantities;
+    ResourceQuantities quantities;
+  } allocation;
+};
+
+
+BucketedDRFSorter::BucketedDRFSorter()
+  : BucketedDRFSorter(LOGARITHMIC, 0.05) {}
+
+
+BucketedDRFSorter::BucketedDRFSorter(
+    const UPID& allocator,
+    const string& metricsPrefix)
+  : BucketedDRFSorter() {}
+
+
+BucketedDRFSorter::BucketedDRFSorter(Bucketing _bucketing, double _width)
+  : bucketing(_bucketing),
+    width(_width)
+{
+  CHECK_GT(width, 0.0);
+}
+
+
+void BucketedDRFSorter::initialize(
+    const Option<set<string>>& _fairnessExcludeResourceNames)
+{
+  fairnessExcludeResourceNames = _fairnessExcludeResourceNames;
+}
+
+
+void BucketedDRFSorter::add(const string& clientPath)
+{
+  CHECK(!clients.contains(clientPath)) << clientPath;
+
+  clients[clientPath] = Owned<Client>(new Client(clientPath));
+}
+
+
+void BucketedDRFSorter::remove(const string& clientPath)
+{
+  Client* client = CHECK_NOTNULL(find(clientPath));
+
+  if (client->active) {
+    unbucket(client);
+  }
+
+  clients.erase(clientPath);
+}
+
+
+void BucketedDRFSorter::activate(const string& clientPath)
+{
+  Client* client = CHECK_NOTNULL(find(clientPath));
+
+  if (client->active) {
+    return;
+  }
+
+  client->active = true;
+
+  // The share gets calculated as the client is placed in its bucket,
+  // which `sort()` does for every client if the sorter is dirty.
+  client->share = 0;
+  client->bucket = bucketOf(0);
+
+  list<Client*>& bucket = buckets[client->bucket];
+  client->position = bucket.insert(bucket.end(), client);
+
+  if (!dirty) {
+    rebucket(client);
+  }
+}
+
+
+void BucketedDRFSorter::deactivate(const string& clientPath)
+{
+  Client* client = CHECK_NOTNULL(find(clientPath));
+
+  if (!client->active) {
+    return;
+  }
+
+  unbucket(client);
+
+  client->active = false;
+}
+
+
+void BucketedDRFSorter::updateWeight(const string& path, double weight)
+{
+  weights[path] = weight;
+
+  // Weights only apply to the client with the exact path.
+  Client* client = find(path);
+  if (client != nullptr && client->active && !dirty) {
+    rebucket(client);
+  }
+}
+
+
+void BucketedDRFSorter::allocated(
+    const string& clientPath,
+    const SlaveID& slaveId,
+    const Resources& resources)
+{
+  Client* client = CHECK_NOTNULL(find(clientPath));
+
+  client->allocation.add(slaveId, resources);
+
+  if (client->active && !dirty) {
+    rebucket(client);
+  }
+}
+
+
+void BucketedDRFSorter::update(
+    const string& clientPath,
+    const SlaveID& slaveId,
+    const Resources& oldAllocation,
+    const Resources& newAllocation)
+{
+  Client* client = CHECK_NOTNULL(find(clientPath));
+
+  client->allocation.update(slaveId, oldAllocation, newAllocation);
+
+  // NOTE: Updates are expected to preserve the quantities of the
+  // allocation (e.g., when reserving resources), so we do not move the
+  // client to another bucket here. A change in quantities is reflected
+  // on the next change of the client's allocation or of the total.
+}
+
+
+void BucketedDRFSorter::unallocated(
+    const string& clientPath,
+    const SlaveID& slaveId,
+    const Resources& resources)
+{
+  Client* client = CHECK_NOTNULL(find(clientPath));
+
+  client->allocation.subtract(slaveId, resources);
+
+  if (client->active && !dirty) {
+    rebucket(client);
+  }
+}
+
+
+const hashmap<SlaveID, Resources>& BucketedDRFSorter::allocation(
+    const string& clientPath) const
+{
+  const Client* client = CHECK_NOTNULL(find(clientPath));
+  return client->allocation.resources;
+}
+
+
+const Resources& BucketedDRFSorter::allocationScalarQuantities(
+    const string& clientPath) const
+{
+  const Client* client = CHECK_NOTNULL(find(clientPath));
+  return client->allocation.scalarQuantities;
+}
+
+
+const ResourceQuantities& BucketedDRFSorter::allocationQuantities(
+    const string& clientPath) const
+{
+  const Client* client = CHECK_NOTNULL(find(clientPath));
+  return client->allocation.quantities;
+}
+
+
+hashmap<string, Resources> BucketedDRFSorter::allocation(
+    const SlaveID& slaveId) const
+{
+  hashmap<string, Resources> result;
+
+  foreachvalue (const Owned<Client>& client, clients) {
+    if (client->allocation.resources.contains(slaveId)) {
+      result.emplace(client->name, client->allocation.resources.at(slaveId));
+    }
+  }
+
+  return result;
+}
+
+
+Resources BucketedDRFSorter::allocation(
+    const string& clientPath,
+    const SlaveID& slaveId) const
+{
+  const Client* client = CHECK_NOTNULL(find(clientPath));
+
+  if (client->allocation.resources.contains(slaveId)) {
+    return client->allocation.resources.at(slaveId);
+  }
+
+  return Resources();
+}
+
+
+const Resources& BucketedDRFSorter::totalScalarQuantities() const
+{
+  return total_.scalarQuantities;
+}
+
+
+const ResourceQuantities& BucketedDRFSorter::totalQuantities() const
+{
+  return total_.quantities;
+}
+
+
+void BucketedDRFSorter::add(const SlaveID& slaveId, const Resources& resources)
+{
+  if (!resources.empty()) {
+    // Add shared resources to the total quantities when the same
+    // resources don't already exist in the total.
+    const Resources newShared = resources.shared()
+      .filter([this, slaveId](const Resource& resource) {
+        return !total_.resources[slaveId].contains(resource);
+      });
+
+    total_.resources[slaveId] += resources;
+
+    const Resources scalarQuantities =
+      (resources.nonShared() + newShared).createStrippedScalarQuantity();
+
+    total_.scalarQuantities += scalarQuantities;
+    total_.quantities +=
+      ResourceQuantities::fromScalarResources(scalarQuantities);
+
+    // All the shares change with the total, they get recalculated on
+    // the next `sort()`.
+    dirty = true;
+  }
+}
+
+
+void BucketedDRFSorter::remove(
+    const SlaveID& slaveId,
+    const Resources& resources)
+{
+  if (!resources.empty()) {
+    CHECK(total_.resources.contains(slaveId));
+    CHECK(total_.resources[slaveId].contains(resources))
+      << total_.resources[slaveId] << " does not contain " << resources;
+
+    total_.resources[slaveId] -= resources;
+
+    // Remove shared resources from the total quantities when there
+    // are no instances of same resources left in the total.
+    const Resources absentShared = resources.shared()
+      .filter([this, slaveId](const Resource& resource) {
+        return !total_.resources[slaveId].contains(resource);
+      });
+
+    const Resources scalarQuantities =
+      (resources.nonShared() + absentShared).createStrippedScalarQuantity();
+
+    CHECK(total_.scalarQuantities.contains(scalarQuantities));
+    total_.scalarQuantities -= scalarQuantities;
+    total_.quantities -=
+      ResourceQuantities::fromScalarResources(scalarQuantities);
+
+    if (total_.resources[slaveId].empty()) {
+      total_.resources.erase(slaveId);
+    }
+
+    dirty = true;
+  }
+}
+
+
+vector<string> BucketedDRFSorter::sort()
+{
+  if (dirty) {
+    dirty = false;
+
+    foreachvalue (const Owned<Client>& client, clients) {
+      if (client->active) {
+        rebucket(client.get());
+      }
+    }
+  }
+
+  vector<string> result;
+  result.reserve(clients.size());
+
+  // The buckets are ordered by increasing shares. Within a bucket, the
+  // clients are returned starting from the one which is the longest
+  // without having been first, and the first one is moved to the end.
+  foreachvalue (list<Client*>& bucket, buckets) {
+    foreach (const Client* client, bucket) {
+      result.push_back(client->name);
+    }
+
+    bucket.splice(bucket.end(), bucket, bucket.begin());
+  }
+
+  return result;
+}
+
+
+bool BucketedDRFSorter::contains(const string& client) const
+{
+  return find(client) != nullptr;
+}
+
+
+int BucketedDRFSorter::count() const
+{
+  return clients.size();
+}
+
+
+int BucketedDRFSorter::bucketOf(double share) const
+{
+  if (share <= 0.0) {
+    return std::numeric_limits<int>::min();
+  }
+
+  double bucket = 0.0;
+
+  switch (bucketing) {
+    case LOGARITHMIC:
+      bucket = std::floor(std::log(share) / std::log1p(width));
+      break;
+    case FIXED_WIDTH:
+      bucket = std::floor(share / width);
+      break;
+  }
+
+  // Shares are bounded by 1 divided by the weight, but we do not want
+  // a tiny weight to overflow the bucket.
+  return static_cast<int>(std::min(
+      bucket, static_cast<double>(std::numeric_limits<int>::max())));
+}
+
+
+void BucketedDRFSorter::rebucket(Client* client)
+{
+  CHECK(client->active);
+
+  Option<double> weight = weights.get(client->name);
+
+  client->share = client->allocation.quantities.dominantShare(
+      total_.quantities, fairnessExcludeResourceNames) / weight.getOrElse(1.0);
+
+  const int bucket = bucketOf(client->share);
+
+  if (bucket == client->bucket) {
+    return;
+  }
+
+  unbucket(client);
+
+  client->bucket = bucket;
+
+  list<Client*>& clients_ = buckets[bucket];
+  client->position = clients_.insert(clients_.end(), client);
+}
+
+
+void BucketedDRFSorter::unbucket(Client* client)
+{
+  auto bucket = buckets.find(client->bucket);
+  CHECK(bucket != buckets.end());
+
+  bucket->second.erase(client->position);
+
+  if (bucket->second.empty()) {
+    buckets.erase(bucket);
+  }
+}
+
+
+BucketedDRFSorter::Client* BucketedDRFSorter::find(
+    const string& clientPath) const
+{
+  Option<Owned<Client>> client = clients.get(clientPath);
+
+  if (client.isNone()) {
+    return nullptr;
+  }
+
+  return client->get();
+}
+
+} // namespace allocator {
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
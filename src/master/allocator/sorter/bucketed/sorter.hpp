@@ -0,0 +1,195 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __MASTER_ALLOCATOR_SORTER_BUCKETED_SORTER_HPP__
+#define __MASTER_ALLOCATOR_SORTER_BUCKETED_SORTER_HPP__
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <mesos/mesos.hpp>
+#include <mesos/resources.hpp>
+
+#include <process/owned.hpp>
+#include <process/pid.hpp>
+
+#include <stout/hashmap.hpp>
+#include <stout/option.hpp>
+
+#include "common/resource_quantities.hpp"
+
+#include "master/allocator/sorter/sorter.hpp"
+
+
+namespace mesos {
+namespace internal {
+namespace master {
+namespace allocator {
+
+// An approximate DRF sorter, meant for sorters with a large number of
+// clients with similar shares, e.g., the frameworks of a role.
+//
+// Rather than ordering the clients by their exact dominant shares,
+// the sorter groups the active clients into buckets of similar shares.
+// The buckets are sorted by share, and the clients of a bucket are
+// returned in a round-robin order: every `sort()` moves the first
+// client of each bucket to the end of the bucket. A change to the
+// allocation of a client only moves that client between buckets, and
+// a `sort()` which follows changes of single clients only visits the
+// clients to return them.
+//
+// NOTE: The clients are not hierarchical, i.e., a client path like
+// "a/b" is an opaque name, and weights only apply to the client with
+// the exact path. This makes the sorter unsuitable for sorting
+// hierarchical roles.
+class BucketedDRFSorter : public Sorter
+{
+public:
+  enum Bucketing
+  {
+    // Buckets whose bounds grow geometrically by `1 + width`, i.e.,
+    // the shares of the clients of a bucket differ by less than
+    // `width` relative to each other.
+    LOGARITHMIC,
+
+    // Buckets of shares differing by less than `width`.
+    FIXED_WIDTH
+  };
+
+  // Uses logarithmic buckets of 5%.
+  BucketedDRFSorter();
+
+  // Metrics are not supported, the arguments only allow the sorter
+  // to be used by `HierarchicalAllocatorProcess`.
+  BucketedDRFSorter(
+      const process::UPID& allocator,
+      const std::string& metricsPrefix);
+
+  BucketedDRFSorter(Bucketing bucketing, double width);
+
+  virtual ~BucketedDRFSorter() = default;
+
+  virtual void initialize(
+      const Option<std::set<std::string>>& fairnessExcludeResourceNames);
+
+  virtual void add(const std::string& client);
+
+  virtual void remove(const std::string& client);
+
+  virtual void activate(const std::string& client);
+
+  virtual void deactivate(const std::string& client);
+
+  virtual void updateWeight(const std::string& path, double weight);
+
+  virtual void allocated(
+      const std::string& client,
+      const SlaveID& slaveId,
+      const Resources& resources);
+
+  virtual void update(
+      const std::string& client,
+      const SlaveID& slaveId,
+      const Resources& oldAllocation,
+      const Resources& newAllocation);
+
+  virtual void unallocated(
+      const std::string& client,
+      const SlaveID& slaveId,
+      const Resources& resources);
+
+  virtual const hashmap<SlaveID, Resources>& allocation(
+      const std::string& client) const;
+
+  virtual const Resources& allocationScalarQuantities(
+      const std::string& client) const;
+
+  virtual const ResourceQuantities& allocationQuantities(
+      const std::string& client) const;
+
+  virtual hashmap<std::string, Resources> allocation(
+      const SlaveID& slaveId) const;
+
+  virtual Resources allocation(
+      const std::string& client,
+      const SlaveID& slaveId) const;
+
+  virtual const Resources& totalScalarQuantities() const;
+
+  virtual const ResourceQuantities& totalQuantities() const;
+
+  virtual void add(const SlaveID& slaveId, const Resources& resources);
+
+  virtual void remove(const SlaveID& slaveId, const Resources& resources);
+
+  virtual std::vector<std::string> sort();
+
+  virtual bool contains(const std::string& client) const;
+
+  virtual int count() const;
+
+private:
+  struct Client;
+
+  // Returns the bucket of a share. Clients without allocations are in
+  // the lowest bucket.
+  int bucketOf(double share) const;
+
+  // Recalculates the share of an active client and moves it to its
+  // bucket, if it changed.
+  void rebucket(Client* client);
+
+  // Removes an active client from its bucket.
+  void unbucket(Client* client);
+
+  Client* find(const std::string& client) const;
+
+  const Bucketing bucketing;
+  const double width;
+
+  // Resources (by name) that will be excluded from fair sharing.
+  Option<std::set<std::string>> fairnessExcludeResourceNames;
+
+  // If true, `sort()` recalculates the shares of all the clients, as
+  // the total resources or the weights changed.
+  bool dirty = false;
+
+  hashmap<std::string, process::Owned<Client>> clients;
+
+  // The active clients, by bucket.
+  std::map<int, std::list<Client*>> buckets;
+
+  // Weights of client paths, including paths not in the sorter.
+  hashmap<std::string, double> weights;
+
+  // Total resources, see `DRFSorter`.
+  struct Total
+  {
+    hashmap<SlaveID, Resources> resources;
+    Resources scalarQuantities;
+    ResourceQuantities quantities;
+  } total_;
+};
+
+} // namespace allocator {
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __MASTER_ALLOCATOR_SORTER_BUCKETED_SORTER_HPP__
@@ -171,6 +171,7 @@ void DRFSorter::add(const string& clientPath)
 
   // TODO(neilc): Avoid dirtying the tree in some circumstances.
   dirty = true;
+  sorted = None();
 
   if (metrics.isSome()) {
     metrics->add(clientPath);
@@ -258,6 +259,7 @@ void DRFSorter::remove(const string& clientPath)
 
   // TODO(neilc): Avoid dirtying the tree in some circumstances.
   dirty = true;
+  sorted = None();
 
   if (metrics.isSome()) {
     metrics->remove(clientPath);
@@ -273,18 +275,21 @@ void DRFSorter::activate(const string& clientPath)
     client->kind = Node::ACTIVE_LEAF;
 
     // `client` has been activated, so move it to the beginning of its
-    // parent's list of children. We mark the tree dirty, so that the
-    // client's share is updated correctly and it is sorted properly.
-    //
-    // TODO(neilc): We could instead calculate share here and insert
-    // the client into the appropriate place here, which would avoid
-    // dirtying the whole tree.
+    // parent's list of children. The share of an inactive leaf is not
+    // kept up to date, so unless the whole tree is going to be resorted
+    // anyway, we calculate the client's share and insert it into the
+    // appropriate place among its siblings.
     CHECK_NOTNULL(client->parent);
 
     client->parent->removeChild(client);
     client->parent->addChild(client);
 
-    dirty = true;
+    if (!dirty) {
+      client->share = calculateShare(client);
+      client->parent->resortChild(client);
+    }
+
+    sorted = None();
   }
 }
 
@@ -302,6 +307,8 @@ void DRFSorter::deactivate(const string& clientPath)
 
     client->parent->removeChild(client);
     client->parent->addChild(client);
+
+    sorted = None();
   }
 }
 
@@ -312,6 +319,7 @@ void DRFSorter::updateWeight(const string& path, double weight)
 
   // TODO(neilc): Avoid dirtying the tree in some circumstances.
   dirty = true;
+  sorted = None();
 }
 
 
@@ -325,13 +333,18 @@ void DRFSorter::allocated(
   // NOTE: We don't currently update the `allocation` for the root
   // node. This is debatable, but the current implementation doesn't
   // require looking at the allocation of the root node.
+  Node* client = current;
+
   while (current != root) {
     current->allocation.add(slaveId, resources);
     current = CHECK_NOTNULL(current->parent);
   }
 
-  // TODO(neilc): Avoid dirtying the tree in some circumstances.
-  dirty = true;
+  // The allocation only changed for the client and its ancestors, so
+  // only their positions in the tree need to be updated.
+  if (!dirty) {
+    updateShares(client);
+  }
 }
 
 
@@ -351,13 +364,18 @@ void DRFSorter::update(
   // NOTE: We don't currently update the `allocation` for the root
   // node. This is debatable, but the current implementation doesn't
   // require looking at the allocation of the root node.
+  Node* client = current;
+
   while (current != root) {
     current->allocation.update(slaveId, oldAllocation, newAllocation);
     current = CHECK_NOTNULL(current->parent);
   }
 
-  // Just assume the total has changed, per the TODO above.
-  dirty = true;
+  // Just assume the shares of the client and its ancestors have
+  // changed, per the TODO above.
+  if (!dirty) {
+    updateShares(client);
+  }
 }
 
 
@@ -371,13 +389,16 @@ void DRFSorter::unallocated(
   // NOTE: We don't currently update the `allocation` for the root
   // node. This is debatable, but the current implementation doesn't
   // require looking at the allocation of the root node.
+  Node* client = current;
+
   while (current != root) {
     current->allocation.subtract(slaveId, resources);
     current = CHECK_NOTNULL(current->parent);
   }
 
-  // TODO(neilc): Avoid dirtying the tree in some circumstances.
-  dirty = true;
+  if (!dirty) {
+    updateShares(client);
+  }
 }
 
 
@@ -397,6 +418,14 @@ const Resources& DRFSorter::allocationScalarQuantities(
 }
 
 
+const ResourceQuantities& DRFSorter::allocationQuantities(
+    const string& clientPath) const
+{
+  const Node* client = CHECK_NOTNULL(find(clientPath));
+  return client->allocation.quantities;
+}
+
+
 hashmap<string, Resources> DRFSorter::allocation(const SlaveID& slaveId) const
 {
   hashmap<string, Resources> result;
@@ -443,6 +472,12 @@ const Resources& DRFSorter::totalScalarQuantities() const
 }
 
 
+const ResourceQuantities& DRFSorter::totalQuantities() const
+{
+  return total_.quantities;
+}
+
+
 void DRFSorter::add(const SlaveID& slaveId, const Resources& resources)
 {
   if (!resources.empty()) {
@@ -459,16 +494,15 @@ void DRFSorter::add(const SlaveID& slaveId, const Resources& resources)
       (resources.nonShared() + newShared).createStrippedScalarQuantity();
 
     total_.scalarQuantities += scalarQuantities;
-
-    foreach (const Resource& resource, scalarQuantities) {
-      total_.totals[resource.name()] += resource.scalar();
-    }
+    total_.quantities +=
+      ResourceQuantities::fromScalarResources(scalarQuantities);
 
     // We have to recalculate all shares when the total resources
     // change, but we put it off until `sort` is called so that if
     // something else changes before the next allocation we don't
     // recalculate everything twice.
     dirty = true;
+    sorted = None();
   }
 }
 
@@ -492,18 +526,17 @@ void DRFSorter::remove(const SlaveID& slaveId, const Resources& resources)
     const Resources scalarQuantities =
       (resources.nonShared() + absentShared).createStrippedScalarQuantity();
 
-    foreach (const Resource& resource, scalarQuantities) {
-      total_.totals[resource.name()] -= resource.scalar();
-    }
-
     CHECK(total_.scalarQuantities.contains(scalarQuantities));
     total_.scalarQuantities -= scalarQuantities;
+    total_.quantities -=
+      ResourceQuantities::fromScalarResources(scalarQuantities);
 
     if (total_.resources[slaveId].empty()) {
       total_.resources.erase(slaveId);
     }
 
     dirty = true;
+    sorted = None();
   }
 }
 
@@ -545,6 +578,11 @@ vector<string> DRFSorter::sort()
     sortTree(root);
 
     dirty = false;
+    sorted = None();
+  }
+
+  if (sorted.isSome()) {
+    return sorted.get();
   }
 
   // Return all active leaves in the tree via pre-order traversal.
@@ -574,6 +612,8 @@ vector<string> DRFSorter::sort()
 
   listClients(root);
 
+  sorted = result;
+
   return result;
 }
 
@@ -592,31 +632,37 @@ int DRFSorter::count() const
 
 double DRFSorter::calculateShare(const Node* node) const
 {
-  double share = 0.0;
-
   // TODO(benh): This implementation of "dominant resource fairness"
   // currently does not take into account resources that are not
   // scalars.
+  const double share = node->allocation.quantities.dominantShare(
+      total_.quantities, fairnessExcludeResourceNames);
 
-  foreachpair (const string& resourceName,
-               const Value::Scalar& scalar,
-               total_.totals) {
-    // Filter out the resources excluded from fair sharing.
-    if (fairnessExcludeResourceNames.isSome() &&
-        fairnessExcludeResourceNames->count(resourceName) > 0) {
-      continue;
-    }
+  return share / findWeight(node);
+}
 
-    if (scalar.value() > 0.0 &&
-        node->allocation.totals.contains(resourceName)) {
-      const double allocation =
-        node->allocation.totals.at(resourceName).value();
 
-      share = std::max(share, allocation / scalar.value());
-    }
+void DRFSorter::updateShares(Node* node)
+{
+  CHECK(!dirty);
+
+  // The share of an inactive leaf is only calculated once it is
+  // activated, see `activate()`. We still need to update its ancestors.
+  if (node->kind == Node::INACTIVE_LEAF) {
+    node = CHECK_NOTNULL(node->parent);
   }
 
-  return share / findWeight(node);
+  while (node != root) {
+    Node* parent = CHECK_NOTNULL(node->parent);
+
+    node->share = calculateShare(node);
+
+    if (parent->resortChild(node)) {
+      sorted = None();
+    }
+
+    node = parent;
+  }
 }
 
 
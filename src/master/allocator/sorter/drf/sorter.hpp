@@ -30,6 +30,8 @@
 #include <stout/hashmap.hpp>
 #include <stout/option.hpp>
 
+#include "common/resource_quantities.hpp"
+
 #include "master/allocator/sorter/drf/metrics.hpp"
 
 #include "master/allocator/sorter/sorter.hpp"
@@ -86,6 +88,9 @@ public:
   virtual const Resources& allocationScalarQuantities(
       const std::string& clientPath) const;
 
+  virtual const ResourceQuantities& allocationQuantities(
+      const std::string& clientPath) const;
+
   virtual hashmap<std::string, Resources> allocation(
       const SlaveID& slaveId) const;
 
@@ -95,6 +100,8 @@ public:
 
   virtual const Resources& totalScalarQuantities() const;
 
+  virtual const ResourceQuantities& totalQuantities() const;
+
   virtual void add(const SlaveID& slaveId, const Resources& resources);
 
   virtual void remove(const SlaveID& slaveId, const Resources& resources);
@@ -112,6 +119,12 @@ private:
   // Returns the dominant resource share for the node.
   double calculateShare(const Node* node) const;
 
+  // Recalculates the share of every node on the path from `node` to
+  // the root and moves each of them to its DRF position among its
+  // siblings. This must only be called when the tree is not dirty,
+  // i.e., when the siblings of each node on the path are sorted.
+  void updateShares(Node* node);
+
   // Returns the weight associated with the node. If no weight has
   // been configured for the node's path, the default weight (1.0) is
   // returned.
@@ -126,8 +139,17 @@ private:
   Option<std::set<std::string>> fairnessExcludeResourceNames;
 
   // If true, sort() will recalculate all shares and resort the tree.
+  //
+  // Only changes that can affect the share of every node (i.e., changes
+  // to the total resources and to weights) and changes to the tree
+  // structure dirty the tree. Changes to the allocation of a single
+  // client are applied incrementally, see `updateShares()`.
   bool dirty = false;
 
+  // The result of the last `sort()`. This is cleared whenever the
+  // order of the active clients in the tree might have changed.
+  Option<std::vector<std::string>> sorted;
+
   // The root node in the sorter tree.
   Node* root;
 
@@ -168,14 +190,10 @@ private:
     // identities of resources and not quantities.
     Resources scalarQuantities;
 
-    // We also store a map version of `scalarQuantities`, mapping
-    // the `Resource::name` to aggregated scalar. This improves the
-    // performance of calculating shares. See MESOS-4694.
-    //
-    // TODO(bmahler): Ideally we do not store `scalarQuantities`
-    // redundantly here, investigate performance improvements to
-    // `Resources` to make this unnecessary.
-    hashmap<std::string, Value::Scalar> totals;
+    // We also store the quantities of `scalarQuantities` keyed by
+    // name only, which is all that is needed to calculate shares.
+    // See MESOS-4694.
+    ResourceQuantities quantities;
   } total_;
 
   // Metrics are optionally exposed by the sorter.
@@ -316,6 +334,39 @@ struct DRFSorter::Node
     }
   }
 
+  // Moves `child` to its DRF position among the active leaves and
+  // internal nodes of this node, assuming all other such children are
+  // already sorted. Returns true if the position of `child` changed.
+  bool resortChild(Node* child)
+  {
+    CHECK(child->kind != INACTIVE_LEAF);
+
+    auto it = std::find(children.begin(), children.end(), child);
+    CHECK(it != children.end());
+
+    const size_t index = it - children.begin();
+
+    children.erase(it);
+
+    // Inactive leaves are stored at the end of `children` (see
+    // invariant (1) above), so the active prefix can be found via a
+    // binary search.
+    auto active = std::partition_point(
+        children.begin(),
+        children.end(),
+        [](const Node* node) { return node->kind != INACTIVE_LEAF; });
+
+    auto position =
+      std::upper_bound(children.begin(), active, child, compareDRF);
+
+    const bool moved =
+      static_cast<size_t>(position - children.begin()) != index;
+
+    children.insert(position, child);
+
+    return moved;
+  }
+
   // Allocation for a node.
   struct Allocation
   {
@@ -335,10 +386,7 @@ struct DRFSorter::Node
 
       resources[slaveId] += toAdd;
       scalarQuantities += quantitiesToAdd;
-
-      foreach (const Resource& resource, quantitiesToAdd) {
-        totals[resource.name()] += resource.scalar();
-      }
+      quantities += ResourceQuantities::fromScalarResources(quantitiesToAdd);
 
       count++;
     }
@@ -362,14 +410,11 @@ struct DRFSorter::Node
       const Resources quantitiesToRemove =
         (toRemove.nonShared() + sharedToRemove).createStrippedScalarQuantity();
 
-      foreach (const Resource& resource, quantitiesToRemove) {
-        totals[resource.name()] -= resource.scalar();
-      }
-
       CHECK(scalarQuantities.contains(quantitiesToRemove))
         << scalarQuantities << " does not contain " << quantitiesToRemove;
 
       scalarQuantities -= quantitiesToRemove;
+      quantities -= ResourceQuantities::fromScalarResources(quantitiesToRemove);
 
       if (resources[slaveId].empty()) {
         resources.erase(slaveId);
@@ -400,13 +445,10 @@ struct DRFSorter::Node
       scalarQuantities -= oldAllocationQuantity;
       scalarQuantities += newAllocationQuantity;
 
-      foreach (const Resource& resource, oldAllocationQuantity) {
-        totals[resource.name()] -= resource.scalar();
-      }
-
-      foreach (const Resource& resource, newAllocationQuantity) {
-        totals[resource.name()] += resource.scalar();
-      }
+      quantities -=
+        ResourceQuantities::fromScalarResources(oldAllocationQuantity);
+      quantities +=
+        ResourceQuantities::fromScalarResources(newAllocationQuantity);
     }
 
     // We store the number of times this client has been chosen for
@@ -429,14 +471,10 @@ struct DRFSorter::Node
     // the corresponding resource. See notes above.
     Resources scalarQuantities;
 
-    // We also store a map version of `scalarQuantities`, mapping
-    // the `Resource::name` to aggregated scalar. This improves the
-    // performance of calculating shares. See MESOS-4694.
-    //
-    // TODO(bmahler): Ideally we do not store `scalarQuantities`
-    // redundantly here, investigate performance improvements to
-    // `Resources` to make this unnecessary.
-    hashmap<std::string, Value::Scalar> totals;
+    // We also store the quantities of `scalarQuantities` keyed by
+    // name only, which is all that is needed to calculate shares.
+    // See MESOS-4694.
+    ResourceQuantities quantities;
   } allocation;
 
   // Compares two nodes according to DRF share.
@@ -26,6 +26,8 @@
 
 #include <process/pid.hpp>
 
+#include "common/resource_quantities.hpp"
+
 namespace mesos {
 namespace internal {
 namespace master {
@@ -113,6 +115,11 @@ public:
   virtual const Resources& allocationScalarQuantities(
       const std::string& client) const = 0;
 
+  // Returns the quantities (i.e., aggregated scalar values keyed by
+  // name only) of the resources that are allocated to this client.
+  virtual const ResourceQuantities& allocationQuantities(
+      const std::string& client) const = 0;
+
   // Returns the clients that have allocations on this slave.
   virtual hashmap<std::string, Resources> allocation(
       const SlaveID& slaveId) const = 0;
@@ -128,6 +135,10 @@ public:
   // `Resources::createStrippedScalarQuantity`.
   virtual const Resources& totalScalarQuantities() const = 0;
 
+  // Returns the quantities (i.e., aggregated scalar values keyed by
+  // name only) of the total resources in this sorter.
+  virtual const ResourceQuantities& totalQuantities() const = 0;
+
   // Add resources to the total pool of resources this
   // Sorter should consider.
   virtual void add(const SlaveID& slaveId, const Resources& resources) = 0;
@@ -0,0 +1,102 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utility>
+
+#include <mesos/type_utils.hpp>
+
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+
+#include "common/interned.hpp"
+
+#include "master/completed_tasks.hpp"
+
+namespace mesos {
+namespace internal {
+namespace master {
+
+TaskID CompletedTasks::Archived::task_id() const
+{
+  TaskID taskId_;
+  taskId_.set_value(taskId);
+  return taskId_;
+}
+
+
+SlaveID CompletedTasks::Archived::slave_id() const
+{
+  SlaveID slaveId_;
+  slaveId_.set_value(interned(slaveId));
+  return slaveId_;
+}
+
+
+Task CompletedTasks::Archived::inflate() const
+{
+  Task task;
+
+  // NOTE: The packed task is missing required fields, hence the
+  // partial parse (and serialization in `push_back`).
+  CHECK(task.ParsePartialFromString(data));
+
+  task.mutable_task_id()->set_value(taskId);
+  task.mutable_framework_id()->set_value(interned(frameworkId));
+  task.mutable_slave_id()->set_value(interned(slaveId));
+
+  foreach (TaskStatus& status, *task.mutable_statuses()) {
+    if (!status.has_task_id()) {
+      status.mutable_task_id()->CopyFrom(task.task_id());
+    }
+  }
+
+  return task;
+}
+
+
+void CompletedTasks::push_back(Task&& task)
+{
+  Archived archived;
+  archived.frameworkId = intern(task.framework_id().value());
+  archived.slaveId = intern(task.slave_id().value());
+  archived.state_ = task.state();
+
+  if (task.statuses_size() > 0) {
+    archived.timestamp_ = task.statuses(0).timestamp();
+  }
+
+  foreach (TaskStatus& status, *task.mutable_statuses()) {
+    // A status for a different task should never end up here, but
+    // we keep its task ID (rather than losing it) just in case.
+    if (status.task_id() == task.task_id()) {
+      status.clear_task_id();
+    }
+  }
+
+  archived.taskId = task.task_id().value();
+
+  task.clear_task_id();
+  task.clear_framework_id();
+  task.clear_slave_id();
+
+  CHECK(task.SerializePartialToString(&archived.data));
+
+  tasks.push_back(std::move(archived));
+}
+
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
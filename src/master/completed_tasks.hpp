@@ -0,0 +1,106 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __MASTER_COMPLETED_TASKS_HPP__
+#define __MASTER_COMPLETED_TASKS_HPP__
+
+#include <stdint.h>
+
+#include <string>
+
+#include <boost/circular_buffer.hpp>
+
+#include <mesos/mesos.hpp>
+
+#include <stout/option.hpp>
+
+namespace mesos {
+namespace internal {
+namespace master {
+
+// A fixed-size archive of the tasks of a framework that have reached
+// a terminal state. Rather than keeping a `Task` protobuf per task,
+// which takes several times more memory than its serialized form,
+// each task is archived in a packed, serialized form and only gets
+// inflated back into a `Task` when it is read:
+//
+//   (1) The framework and agent IDs are interned (see
+//       "common/interned.hpp") rather than stored per task.
+//   (2) The task ID is stripped from every status in the status
+//       history since it always matches the ID of the task.
+//
+// The task ID, agent ID, state, and timestamp of the first status of
+// an archived task can be read without inflating it, which is enough
+// to summarize, filter, and sort the tasks.
+//
+// We use boost::circular_buffer rather than BoundedHashMap because
+// there can be multiple completed tasks with the same task ID.
+class CompletedTasks
+{
+public:
+  class Archived
+  {
+  public:
+    TaskID task_id() const;
+    SlaveID slave_id() const;
+    TaskState state() const { return state_; }
+
+    // Returns the timestamp of the first status of the task, if any.
+    const Option<double>& timestamp() const { return timestamp_; }
+
+    // Returns the original task.
+    Task inflate() const;
+
+  private:
+    friend class CompletedTasks;
+
+    std::string taskId;
+    uint32_t frameworkId;
+    uint32_t slaveId;
+    TaskState state_;
+    Option<double> timestamp_;
+
+    // The packed task, serialized.
+    std::string data;
+  };
+
+  typedef boost::circular_buffer<Archived>::const_iterator const_iterator;
+
+  // Archived tasks are immutable.
+  typedef const_iterator iterator;
+
+  explicit CompletedTasks(size_t capacity) : tasks(capacity) {}
+
+  // Archives the task, evicting the oldest archived task if the
+  // archive is full.
+  void push_back(Task&& task);
+
+  size_t size() const { return tasks.size(); }
+  bool empty() const { return tasks.empty(); }
+
+  // Iterates over the archived tasks, oldest first.
+  const_iterator begin() const { return tasks.begin(); }
+  const_iterator end() const { return tasks.end(); }
+
+private:
+  boost::circular_buffer<Archived> tasks;
+};
+
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __MASTER_COMPLETED_TASKS_HPP__
@@ -24,6 +24,8 @@ std::vector<MasterInfo::Capability> MASTER_CAPABILITIES()
 {
   MasterInfo::Capability::Type types[] = {
     MasterInfo::Capability::AGENT_UPDATE,
+    MasterInfo::Capability::AGENT_REREGISTRATION_DIGESTS,
+    MasterInfo::Capability::STATUS_UPDATE_BATCHES,
   };
 
   std::vector<MasterInfo::Capability> result;
@@ -47,6 +47,10 @@ constexpr double MIN_CPUS = 0.01;
 // Minimum amount of memory per offer.
 constexpr Bytes MIN_MEM = Megabytes(32);
 
+// Maximum number of status update acknowledgements forwarded to an
+// agent in a single batch.
+constexpr size_t MAX_STATUS_UPDATE_ACKNOWLEDGEMENT_BATCH_SIZE = 1000;
+
 // Default interval the master uses to send heartbeats to an HTTP
 // scheduler.
 constexpr Duration DEFAULT_HEARTBEAT_INTERVAL = Seconds(15);
@@ -100,12 +104,28 @@ constexpr Duration WHITELIST_WATCH_INTERVAL = Seconds(5);
 // Default number of tasks (limit) for /master/tasks endpoint.
 constexpr size_t TASK_LIMIT = 100;
 
+// Number of tasks reconciled at a time, the master handles its other
+// events in between.
+constexpr size_t RECONCILIATION_BATCH_SIZE = 1000;
+
+// Number of agents or frameworks rendered at a time by the
+// /master/state and /master/state-summary endpoints when streaming.
+constexpr size_t STATE_STREAM_BATCH_SIZE = 100;
+
+// Number of operator API events the master keeps for the subscribers
+// which reconnect to resume from.
+constexpr size_t OPERATOR_EVENT_LOG_SIZE = 1000;
+
 constexpr Duration DEFAULT_REGISTRY_GC_INTERVAL = Minutes(15);
 
 constexpr Duration DEFAULT_REGISTRY_MAX_AGENT_AGE = Weeks(2);
 
 constexpr size_t DEFAULT_REGISTRY_MAX_AGENT_COUNT = 100 * 1024;
 
+// Maximum number of deltas the registrar stores before compacting
+// them into a snapshot of the registry, see `--registry_deltas`.
+constexpr size_t REGISTRY_MAX_DELTAS = 1000;
+
 /**
  * Label used by the Leader Contender and Detector.
  *
@@ -127,12 +147,29 @@ constexpr Duration ZOOKEEPER_SESSION_TIMEOUT = Seconds(10);
 // Name of the default, CRAM-MD5 authenticator.
 constexpr char DEFAULT_AUTHENTICATOR[] = "crammd5";
 
+// Default number of authenticator instances of the master.
+constexpr size_t DEFAULT_AUTHENTICATOR_WORKERS = 4;
+
+// Default maximum number of authentications in progress at once.
+constexpr size_t DEFAULT_MAX_PENDING_AUTHENTICATIONS = 1000;
+
+// Default duration for which authentication tokens are valid.
+constexpr Duration DEFAULT_AUTHENTICATION_TOKEN_TTL = Hours(1);
+
 // Name of the default, HierarchicalDRF authenticator.
 constexpr char DEFAULT_ALLOCATOR[] = "HierarchicalDRF";
 
+// Name of the HierarchicalDRF allocator which sorts the frameworks of
+// a role with the bucketed DRF sorter.
+constexpr char BUCKETED_DRF_ALLOCATOR[] = "HierarchicalBucketedDRF";
+
 // The default interval between allocations.
 constexpr Duration DEFAULT_ALLOCATION_INTERVAL = Seconds(1);
 
+// Number of dispatches queued in the allocator beyond which it is
+// considered busy, see `--max_allocation_interval`.
+constexpr size_t ALLOCATION_BACKLOG_THRESHOLD = 1000;
+
 // Name of the default, local authorizer.
 constexpr char DEFAULT_AUTHORIZER[] = "local";
 
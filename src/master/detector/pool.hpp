@@ -0,0 +1,90 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __MASTER_DETECTOR_POOL_HPP__
+#define __MASTER_DETECTOR_POOL_HPP__
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <mesos/master/detector.hpp>
+
+#include <stout/hashmap.hpp>
+#include <stout/synchronized.hpp>
+#include <stout/try.hpp>
+
+namespace mesos {
+namespace master {
+namespace detector {
+
+// The DetectorPool is responsible for tracking single detector per url
+// to avoid having multiple detectors per url when multiple frameworks
+// are instantiated per process, be it with the scheduler driver or
+// with the scheduler library. See MESOS-3595.
+class DetectorPool
+{
+public:
+  virtual ~DetectorPool() {}
+
+  static Try<std::shared_ptr<MasterDetector>> get(const std::string& url)
+  {
+    synchronized (DetectorPool::instance()->poolMutex) {
+      // Get or create the `weak_ptr` map entry.
+      std::shared_ptr<MasterDetector> result =
+        DetectorPool::instance()->pool[url].lock();
+
+      if (result) {
+        // Return existing master detector.
+        return result;
+      } else {
+        // Else, create the master detector and record it in the map.
+        Try<MasterDetector*> detector = MasterDetector::create(url);
+        if (detector.isError()) {
+          return Error(detector.error());
+        }
+
+        result = std::shared_ptr<MasterDetector>(detector.get());
+        DetectorPool::instance()->pool[url] = result;
+        return result;
+      }
+    }
+  }
+
+private:
+  // Hide the constructors and assignment operator.
+  DetectorPool() {}
+  DetectorPool(const DetectorPool&) = delete;
+  DetectorPool& operator=(const DetectorPool&) = delete;
+
+  // Instead of having multiple detectors for multiple frameworks,
+  // keep track of one detector per url.
+  hashmap<std::string, std::weak_ptr<MasterDetector>> pool;
+  std::mutex poolMutex;
+
+  // Internal Singleton.
+  static DetectorPool* instance()
+  {
+    static DetectorPool* singleton = new DetectorPool();
+    return singleton;
+  }
+};
+
+} // namespace detector {
+} // namespace master {
+} // namespace mesos {
+
+#endif // __MASTER_DETECTOR_POOL_HPP__
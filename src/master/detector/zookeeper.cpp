@@ -16,6 +16,8 @@
 
 #include "master/detector/zookeeper.hpp"
 
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 
@@ -33,8 +35,11 @@
 #include <process/process.hpp>
 
 #include <stout/duration.hpp>
+#include <stout/hashmap.hpp>
 #include <stout/lambda.hpp>
 #include <stout/protobuf.hpp>
+#include <stout/stringify.hpp>
+#include <stout/synchronized.hpp>
 
 #include "common/protobuf_utils.hpp"
 
@@ -44,7 +49,9 @@ using namespace process;
 using namespace zookeeper;
 
 using std::set;
+using std::shared_ptr;
 using std::string;
+using std::weak_ptr;
 
 namespace mesos {
 namespace master {
@@ -52,6 +59,56 @@ namespace detector {
 
 const Duration MASTER_DETECTOR_ZK_SESSION_TIMEOUT = Seconds(10);
 
+
+// The GroupPool is responsible for tracking a single group per
+// ZooKeeper URL and session timeout, so that the detectors of the
+// frameworks instantiated in the same process share a ZooKeeper
+// session and a watch of the group rather than each opening its own.
+// The group is destroyed along with the last detector using it.
+class GroupPool
+{
+public:
+  static shared_ptr<Group> get(
+      const zookeeper::URL& url,
+      const Duration& sessionTimeout)
+  {
+    const string key = stringify(url) + "?" + stringify(sessionTimeout);
+
+    synchronized (GroupPool::instance()->poolMutex) {
+      // Get or create the `weak_ptr` map entry.
+      shared_ptr<Group> result = GroupPool::instance()->pool[key].lock();
+
+      if (!result) {
+        result.reset(new Group(
+            url.servers,
+            sessionTimeout,
+            url.path,
+            url.authentication));
+
+        GroupPool::instance()->pool[key] = result;
+      }
+
+      return result;
+    }
+  }
+
+private:
+  // Hide the constructors and assignment operator.
+  GroupPool() {}
+  GroupPool(const GroupPool&) = delete;
+  GroupPool& operator=(const GroupPool&) = delete;
+
+  hashmap<string, weak_ptr<Group>> pool;
+  std::mutex poolMutex;
+
+  // Internal Singleton.
+  static GroupPool* instance()
+  {
+    static GroupPool* singleton = new GroupPool();
+    return singleton;
+  }
+};
+
 class ZooKeeperMasterDetectorProcess
   : public Process<ZooKeeperMasterDetectorProcess>
 {
@@ -60,7 +117,7 @@ public:
       const zookeeper::URL& url,
       const Duration& sessionTimeout);
 
-  explicit ZooKeeperMasterDetectorProcess(Owned<Group> group);
+  explicit ZooKeeperMasterDetectorProcess(shared_ptr<Group> group);
   ~ZooKeeperMasterDetectorProcess();
 
   virtual void initialize();
@@ -77,7 +134,8 @@ private:
       const Group::Membership& membership,
       const Future<Option<string>>& data);
 
-  Owned<Group> group;
+  // NOTE: The group might be shared with other detectors.
+  shared_ptr<Group> group;
   LeaderDetector detector;
 
   // The leading Master.
@@ -92,15 +150,11 @@ private:
 ZooKeeperMasterDetectorProcess::ZooKeeperMasterDetectorProcess(
     const zookeeper::URL& url,
     const Duration& sessionTimeout)
-  : ZooKeeperMasterDetectorProcess(Owned<Group>(
-    new Group(url.servers,
-              sessionTimeout,
-              url.path,
-              url.authentication))) {}
+  : ZooKeeperMasterDetectorProcess(GroupPool::get(url, sessionTimeout)) {}
 
 
 ZooKeeperMasterDetectorProcess::ZooKeeperMasterDetectorProcess(
-    Owned<Group> _group)
+    shared_ptr<Group> _group)
   : ProcessBase(ID::generate("zookeeper-master-detector")),
     group(_group),
     detector(group.get()),
@@ -277,7 +331,8 @@ ZooKeeperMasterDetector::ZooKeeperMasterDetector(
 
 ZooKeeperMasterDetector::ZooKeeperMasterDetector(Owned<Group> group)
 {
-  process = new ZooKeeperMasterDetectorProcess(group);
+  process = new ZooKeeperMasterDetectorProcess(
+      shared_ptr<Group>(group.release()));
   spawn(process);
 }
 
@@ -45,7 +45,9 @@ class ZooKeeperMasterDetector : public MasterDetector
 {
 public:
   // Creates a detector which uses ZooKeeper to determine (i.e.,
-  // elect) a leading master.
+  // elect) a leading master. The detectors created in the same
+  // process with the same URL and session timeout share a ZooKeeper
+  // session and a watch of the group.
   explicit ZooKeeperMasterDetector(
       const zookeeper::URL& url,
       const Duration& sessionTimeout = MASTER_DETECTOR_ZK_SESSION_TIMEOUT);
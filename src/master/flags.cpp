@@ -114,6 +114,41 @@ mesos::internal::master::Flags::Flags()
       "after which the operation is considered a failure.",
       Seconds(20));
 
+  add(&Flags::registry_deltas,
+      "registry_deltas",
+      "Whether the registrar persists changes to the agents in the registry\n"
+      "as deltas instead of storing the entire registry on every update.\n"
+      "The deltas are compacted into a snapshot of the registry once their\n"
+      "total size exceeds the size of the snapshot, when anything other\n"
+      "than the agents changes, and whenever the master recovers.\n"
+      "NOTE: Masters that do not support this flag ignore the deltas, so\n"
+      "it must be disabled and the master failed over before downgrading.",
+      false);
+
+  add(&Flags::registry_max_batch_size,
+      "registry_max_batch_size",
+      "Maximum number of operations the registrar applies in a single\n"
+      "write to the registry. By default all queued operations are\n"
+      "written together.",
+      [](const Option<size_t>& value) -> Option<Error> {
+        if (value.isSome() && value.get() == 0) {
+          return Error("Expected --registry_max_batch_size to be positive");
+        }
+        return None();
+      });
+
+  add(&Flags::registry_batch_linger,
+      "registry_batch_linger",
+      "Maximum amount of time the registrar waits for more operations\n"
+      "before writing to the registry, if no write is in progress.\n"
+      "Operations that arrive while a write is in progress are always\n"
+      "batched into the next write. The wait is also limited to the\n"
+      "median latency of recent writes (see `registrar/state_store_ms`),\n"
+      "so that it at most doubles the typical latency of an operation.\n"
+      "The wait ends early once `--registry_max_batch_size` operations\n"
+      "are queued.",
+      Duration::zero());
+
   add(&Flags::log_auto_initialize,
       "log_auto_initialize",
       "Whether to automatically initialize the replicated log used for the\n"
@@ -121,6 +156,17 @@ mesos::internal::master::Flags::Flags()
       "initialized when used for the very first time.",
       true);
 
+  add(&Flags::log_batch_writes,
+      "log_batch_writes",
+      "Whether the local replica of the replicated log used for the\n"
+      "registry should persist the writes of concurrent requests with a\n"
+      "single synchronous disk write, instead of one synchronous write per\n"
+      "request. Notices that a log entry has been learned are then also\n"
+      "written without syncing, since they can be recovered from the other\n"
+      "replicas. This reduces the number of fsyncs on disks where they are\n"
+      "slow.",
+      false);
+
   add(&Flags::agent_reregister_timeout,
       "agent_reregister_timeout",
       flags::DeprecatedName("slave_reregister_timeout"),
@@ -163,6 +209,39 @@ mesos::internal::master::Flags::Flags()
       "By default, agents will be removed as soon as they fail the health\n"
       "checks. The value is of the form `(Number of agents)/(Duration)`.");
 
+  add(&Flags::max_concurrent_agent_admissions,
+      "max_concurrent_agent_admissions",
+      "The maximum number of agent (re-)registrations that the master\n"
+      "processes at a time (e.g., while they are pending in the authorizer\n"
+      "or the registrar). Further (re-)registrations are queued in the\n"
+      "order given by `--agent_admission_priority_attribute`, and the\n"
+      "agents are asked to hold off retrying for\n"
+      "`--agent_admission_retry_interval`. By default, there is no limit.",
+      [](const Option<size_t>& value) -> Option<Error> {
+        if (value.isSome() && value.get() == 0) {
+          return Error(
+              "Expected `--max_concurrent_agent_admissions` to be positive");
+        }
+        return None();
+      });
+
+  add(&Flags::agent_admission_priority_attribute,
+      "agent_admission_priority_attribute",
+      "The name of a scalar agent attribute by which queued agent\n"
+      "(re-)registrations are admitted (see\n"
+      "`--max_concurrent_agent_admissions`), highest value first. Agents\n"
+      "without the attribute have a priority of 0. Among agents of the same\n"
+      "priority, re-registrations are admitted before registrations, and\n"
+      "otherwise agents are admitted in the order they arrived.");
+
+  add(&Flags::agent_admission_retry_interval,
+      "agent_admission_retry_interval",
+      "The amount of time that agents whose (re-)registration is queued\n"
+      "(see `--max_concurrent_agent_admissions`) are asked to wait before\n"
+      "retrying. The master admits queued agents without waiting for them\n"
+      "to retry.",
+      Seconds(10));
+
   add(&Flags::webui_dir,
       "webui_dir",
       "Directory path of the webui files/assets",
@@ -194,6 +273,47 @@ mesos::internal::master::Flags::Flags()
       " (batch) allocations (e.g., 500ms, 1sec, etc).",
       DEFAULT_ALLOCATION_INTERVAL);
 
+  add(&Flags::allocation_shards,
+      "allocation_shards",
+      "Number of shards the agents are partitioned into during an\n"
+      "allocation run. Each shard is allocated in a separate step of the\n"
+      "allocator, so that other allocator events are processed and offers\n"
+      "for a shard are sent out while the remaining shards are pending.\n"
+      "Quota and fair sharing are accounted across all shards. Setting\n"
+      "this to a value greater than 1 is useful for large clusters, where\n"
+      "a single allocation run can take a significant amount of time.",
+      1,
+      [](size_t value) -> Option<Error> {
+        if (value < 1) {
+          return Error("Expected `--allocation_shards` to be at least 1");
+        }
+        return None();
+      });
+
+  add(&Flags::allocation_sweep_interval,
+      "allocation_sweep_interval",
+      "If set, batch allocations only consider the agents whose available\n"
+      "resources may have changed since the previous batch allocation\n"
+      "(e.g., due to recovered resources or expired offer filters), and\n"
+      "all agents are only considered once per this interval. This makes\n"
+      "the cost of batch allocations proportional to the churn in the\n"
+      "cluster rather than to its size. Must be at least the\n"
+      "`--allocation_interval`. If not set, all agents are considered by\n"
+      "every batch allocation.");
+
+  add(&Flags::max_allocation_interval,
+      "max_allocation_interval",
+      "If set, the interval between batch allocations adapts to the load\n"
+      "of the allocator, between `--allocation_interval` and this interval.\n"
+      "The interval is doubled while the allocator is busy, i.e., while\n"
+      "allocation runs take longer than the interval or many events are\n"
+      "queued in the allocator, and while it is idle, i.e., while no agent\n"
+      "changed since the previous batch allocation. Otherwise it is reset\n"
+      "to `--allocation_interval`. Allocations triggered by events (e.g.,\n"
+      "added agents or revived offers) are not delayed. Must be at least\n"
+      "the `--allocation_interval`. If not set, batch allocations are\n"
+      "performed every `--allocation_interval`.");
+
   add(&Flags::cluster,
       "cluster",
       "Human readable name for the cluster, displayed in the webui.");
@@ -376,6 +496,15 @@ mesos::internal::master::Flags::Flags()
       "or frameworks that accidentally drop offers.\n"
       "If not set, offers do not timeout.");
 
+  add(&Flags::operator_event_stream_flush_interval,
+      "operator_event_stream_flush_interval",
+      "Maximum amount of time for which events for the subscribers of the\n"
+      "operator API (i.e., the `SUBSCRIBE` call) are buffered, so that\n"
+      "bursts of events are written to each subscriber in batches rather\n"
+      "than one at a time. By default every event is written as soon as\n"
+      "it occurs.",
+      Duration::zero());
+
   // This help message for --modules flag is the same for
   // {master,slave,sched,tests}/flags.[ch]pp and should always be kept in
   // sync.
@@ -441,10 +570,45 @@ mesos::internal::master::Flags::Flags()
       "or load an alternate authenticator module using `--modules`.",
       DEFAULT_AUTHENTICATOR);
 
+  add(&Flags::authenticator_workers,
+      "authenticator_workers",
+      "Number of instances of the authenticator to spread the authentication\n"
+      "of frameworks and agents over. Each instance authenticates in its own\n"
+      "processes, which lets concurrent authentications, e.g., after a master\n"
+      "failover, use multiple cores.",
+      DEFAULT_AUTHENTICATOR_WORKERS);
+
+  add(&Flags::max_pending_authentications,
+      "max_pending_authentications",
+      "Maximum number of authentications of frameworks and agents in progress\n"
+      "at once. Further authentication attempts are refused with an error,\n"
+      "and get retried by the frameworks and agents after a backoff.",
+      DEFAULT_MAX_PENDING_AUTHENTICATIONS);
+
+#ifdef USE_SSL_SOCKET
+  add(&Flags::authentication_token_secret_key,
+      "authentication_token_secret_key",
+      "Path to a file containing the key used to sign authentication tokens.\n"
+      "If set, the master hands out a token to each authenticated framework\n"
+      "and agent, which lets it authenticate again in a single message, e.g.,\n"
+      "after a failover to another master using the same key.\n"
+      "This flag is only available when Mesos is built with SSL support.");
+
+  add(&Flags::authentication_token_ttl,
+      "authentication_token_ttl",
+      "How long the authentication tokens handed out by the master are valid\n"
+      "for (see `--authentication_token_secret_key`).\n"
+      "This flag is only available when Mesos is built with SSL support.",
+      DEFAULT_AUTHENTICATION_TOKEN_TTL);
+#endif // USE_SSL_SOCKET
+
   add(&Flags::allocator,
       "allocator",
       "Allocator to use for resource allocation to frameworks.\n"
-      "Use the default `" + string(DEFAULT_ALLOCATOR) + "` allocator, or\n"
+      "Use the default `" + string(DEFAULT_ALLOCATOR) + "` allocator, the\n"
+      "`" + string(BUCKETED_DRF_ALLOCATOR) + "` allocator, which sorts the\n"
+      "frameworks of a role approximately by placing frameworks of similar\n"
+      "shares in the same bucket and rotating through each bucket, or\n"
       "load an alternate allocator module using `--modules`.",
       DEFAULT_ALLOCATOR);
 
@@ -562,6 +726,69 @@ mesos::internal::master::Flags::Flags()
       "Maximum number of unreachable tasks per framework to store in memory.",
       DEFAULT_MAX_UNREACHABLE_TASKS_PER_FRAMEWORK);
 
+  add(&Flags::state_cache_max_staleness,
+      "state_cache_max_staleness",
+      "Maximum amount of time for which a rendering of the state of the\n"
+      "master (i.e., the `/state` endpoint and the `GET_STATE` call) is\n"
+      "served to later requests of the same principal, even though the\n"
+      "state of the master might have changed in the meantime. Renderings\n"
+      "are always shared by concurrent requests, and by later requests as\n"
+      "long as the master has not changed.",
+      Duration::zero());
+
+  add(&Flags::standby_state_refresh_interval,
+      "standby_state_refresh_interval",
+      "If set, a master that is not the leader fetches the `/state` and\n"
+      "`/state-summary` endpoints of the leading master at this interval,\n"
+      "and serves its copies to requests for these endpoints rather than\n"
+      "redirecting them to the leading master. The responses carry an\n"
+      "`Age` header with the number of seconds since the copy was fetched.\n"
+      "Requests with query parameters are still redirected, as are all\n"
+      "requests when an authorizer is configured, since the copies are\n"
+      "not filtered for the principal of each request.",
+      [](const Option<Duration>& value) -> Option<Error> {
+        if (value.isSome() && value.get() <= Duration::zero()) {
+          return Error(
+              "Expected `--standby_state_refresh_interval` to be positive");
+        }
+
+        return None();
+      });
+
+  add(&Flags::state_snapshot_dir,
+      "state_snapshot_dir",
+      "If set, the leading master periodically writes a snapshot of the\n"
+      "state of the cluster (i.e., what the `GET_STATE` call returns) into\n"
+      "a new directory in this directory, named after the time of the\n"
+      "snapshot in seconds since the epoch. A snapshot holds a gzip\n"
+      "compressed file per kind of entity (e.g., `completed_tasks.gz`),\n"
+      "with the protobuf records of the entities, each prefixed with its\n"
+      "length as a 32 bit integer in host byte order. The state is only\n"
+      "collected on the master actor; it is serialized, compressed and\n"
+      "written in the background. Old snapshots are not removed.");
+
+  add(&Flags::state_snapshot_interval,
+      "state_snapshot_interval",
+      "Amount of time between the snapshots of the state of the cluster,\n"
+      "see `--state_snapshot_dir`.",
+      Minutes(1),
+      [](const Duration& value) -> Option<Error> {
+        if (value <= Duration::zero()) {
+          return Error("Expected `--state_snapshot_interval` to be positive");
+        }
+
+        return None();
+      });
+
+  add(&Flags::status_update_acknowledgement_flush_interval,
+      "status_update_acknowledgement_flush_interval",
+      "Maximum amount of time for which the master holds on to status\n"
+      "update acknowledgements for an agent in order to forward them to\n"
+      "the agent in batches. Only applies to agents with the\n"
+      "`STATUS_UPDATE_BATCHES` capability. By default, acknowledgements\n"
+      "are forwarded right away, one by one.",
+      Duration::zero());
+
   add(&Flags::master_contender,
       "master_contender",
       "The symbol name of the master contender to use.\n"
@@ -54,15 +54,25 @@ public:
   bool registry_strict;
   Duration registry_fetch_timeout;
   Duration registry_store_timeout;
+  bool registry_deltas;
+  Option<size_t> registry_max_batch_size;
+  Duration registry_batch_linger;
   bool log_auto_initialize;
+  bool log_batch_writes;
   Duration agent_reregister_timeout;
   std::string recovery_agent_removal_limit;
   Option<std::string> agent_removal_rate_limit;
+  Option<size_t> max_concurrent_agent_admissions;
+  Option<std::string> agent_admission_priority_attribute;
+  Duration agent_admission_retry_interval;
   std::string webui_dir;
   Option<Path> whitelist;
   std::string user_sorter;
   std::string framework_sorter;
   Duration allocation_interval;
+  size_t allocation_shards;
+  Option<Duration> allocation_sweep_interval;
+  Option<Duration> max_allocation_interval;
   Option<std::string> cluster;
   Option<std::string> roles;
   Option<std::string> weights;
@@ -76,9 +86,16 @@ public:
   Option<Firewall> firewall_rules;
   Option<RateLimits> rate_limits;
   Option<Duration> offer_timeout;
+  Duration operator_event_stream_flush_interval;
   Option<Modules> modules;
   Option<std::string> modulesDir;
   std::string authenticators;
+  size_t authenticator_workers;
+  size_t max_pending_authentications;
+#ifdef USE_SSL_SOCKET
+  Option<Path> authentication_token_secret_key;
+  Duration authentication_token_ttl;
+#endif // USE_SSL_SOCKET
   std::string allocator;
   Option<std::set<std::string>> fair_sharing_excluded_resource_names;
   bool filter_gpu_resources;
@@ -91,6 +108,11 @@ public:
   size_t max_completed_frameworks;
   size_t max_completed_tasks_per_framework;
   size_t max_unreachable_tasks_per_framework;
+  Duration state_cache_max_staleness;
+  Option<Duration> standby_state_refresh_interval;
+  Option<std::string> state_snapshot_dir;
+  Duration state_snapshot_interval;
+  Duration status_update_acknowledgement_flush_interval;
   Option<std::string> master_contender;
   Option<std::string> master_detector;
   Duration registry_gc_interval;
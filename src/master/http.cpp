@@ -36,16 +36,20 @@
 
 #include <mesos/v1/master/master.hpp>
 
+#include <process/async.hpp>
 #include <process/collect.hpp>
 #include <process/defer.hpp>
 #include <process/help.hpp>
 #include <process/logging.hpp>
+#include <process/loop.hpp>
+#include <process/shared.hpp>
 
 #include <process/metrics/metrics.hpp>
 
 #include <stout/base64.hpp>
 #include <stout/errorbase.hpp>
 #include <stout/foreach.hpp>
+#include <stout/gzip.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
 #include <stout/json.hpp>
@@ -57,6 +61,7 @@
 #include <stout/numify.hpp>
 #include <stout/option.hpp>
 #include <stout/os.hpp>
+#include <stout/path.hpp>
 #include <stout/protobuf.hpp>
 #include <stout/representation.hpp>
 #include <stout/result.hpp>
@@ -90,13 +95,22 @@ using google::protobuf::RepeatedPtrField;
 
 using process::AUTHENTICATION;
 using process::AUTHORIZATION;
+using process::Break;
 using process::Clock;
+using process::Continue;
+using process::ControlFlow;
 using process::DESCRIPTION;
 using process::Failure;
 using process::Future;
 using process::HELP;
 using process::Logging;
+using process::Shared;
 using process::TLDR;
+using process::Time;
+using process::UPID;
+
+using process::async;
+using process::loop;
 
 using process::http::Accepted;
 using process::http::BadRequest;
@@ -344,13 +358,16 @@ struct FullFrameworkWriter {
     });
 
     writer->field("completed_tasks", [this](JSON::ArrayWriter* writer) {
-      foreach (const Owned<Task>& task, framework_->completedTasks) {
+      foreach (const CompletedTasks::Archived& archived,
+               framework_->completedTasks) {
+        const Task task = archived.inflate();
+
         // Skip unauthorized tasks.
-        if (!authorizeTask_->accept(*task, framework_->info)) {
+        if (!authorizeTask_->accept(task, framework_->info)) {
           continue;
         }
 
-        writer->element(*task);
+        writer->element(task);
       }
 
       // Unreachable tasks belonging to a non-partition-aware framework
@@ -574,6 +591,348 @@ struct SlavesWriter
 };
 
 
+// Renders a JSON object in parts so that big objects (e.g., the state
+// of the master) can be streamed rather than rendered into a single
+// string. The object is made up of sections that are rendered in
+// order: fields, which are rendered all at once, and arrays, which
+// are rendered `batchSize` elements at a time.
+class JsonStream
+{
+public:
+  // Writes the elements in the range [begin, end) of an array.
+  typedef std::function<void(JSON::ArrayWriter*, size_t, size_t)> Elements;
+
+  explicit JsonStream(size_t _batchSize) : batchSize(_batchSize)
+  {
+    CHECK_GT(batchSize, 0u);
+  }
+
+  void fields(const std::function<void(JSON::ObjectWriter*)>& write)
+  {
+    sections.push_back(Section{"", write, nullptr, 0});
+  }
+
+  void array(const string& name, size_t size, const Elements& write)
+  {
+    sections.push_back(Section{name, nullptr, write, size});
+  }
+
+  // Returns the next part of the object, or `None()` once all of the
+  // object has been returned. Concatenating the parts gives the same
+  // object as rendering all of the sections with `jsonify`.
+  Option<string> next()
+  {
+    if (finished) {
+      return None();
+    }
+
+    string part;
+
+    if (!started) {
+      part += '{';
+      started = true;
+    }
+
+    if (index < sections.size()) {
+      const Section& section = sections[index];
+
+      if (section.fields) {
+        append(&part, strip(jsonify(section.fields)), &fieldsEmpty);
+        index++;
+      } else {
+        if (offset == 0) {
+          if (!fieldsEmpty) {
+            part += ',';
+          }
+
+          part += string(jsonify(section.name)) + ":[";
+          fieldsEmpty = false;
+          elementsEmpty = true;
+        }
+
+        const size_t begin = offset;
+        const size_t end = std::min(offset + batchSize, section.size);
+
+        if (begin < end) {
+          append(
+              &part,
+              strip(jsonify([&](JSON::ArrayWriter* writer) {
+                section.elements(writer, begin, end);
+              })),
+              &elementsEmpty);
+        }
+
+        offset = end;
+
+        if (offset == section.size) {
+          part += ']';
+          index++;
+          offset = 0;
+        }
+      }
+    }
+
+    if (index == sections.size()) {
+      part += '}';
+      finished = true;
+    }
+
+    return part;
+  }
+
+private:
+  struct Section
+  {
+    string name;
+    std::function<void(JSON::ObjectWriter*)> fields;
+    Elements elements;
+    size_t size;
+  };
+
+  // Removes the enclosing braces or brackets.
+  static string strip(const string& json)
+  {
+    CHECK_GE(json.size(), 2u);
+    return json.substr(1, json.size() - 2);
+  }
+
+  // Appends the (comma separated) members or elements in `json`.
+  static void append(string* part, const string& json, bool* empty)
+  {
+    if (!json.empty()) {
+      if (!*empty) {
+        *part += ',';
+      }
+
+      *part += json;
+      *empty = false;
+    }
+  }
+
+  const size_t batchSize;
+
+  vector<Section> sections;
+
+  size_t index = 0; // Current section.
+  size_t offset = 0; // Next element of the current array section.
+
+  bool started = false;
+  bool finished = false;
+  bool fieldsEmpty = true;
+  bool elementsEmpty = true;
+};
+
+
+// Renders all of the object of `stream` at once.
+static string render(const Owned<JsonStream>& stream)
+{
+  string json;
+
+  for (Option<string> part = stream->next();
+       part.isSome();
+       part = stream->next()) {
+    json += part.get();
+  }
+
+  return json;
+}
+
+
+// Returns a response with the rendered `json`, optionally wrapped in a
+// JSONP callback.
+static Response respond(const string& json, const Option<string>& jsonp)
+{
+  OK ok;
+  ok.headers["Content-Type"] =
+    jsonp.isSome() ? "text/javascript" : "application/json";
+
+  ok.type = Response::BODY;
+
+  if (jsonp.isSome()) {
+    ok.body = jsonp.get() + "(" + json + ");";
+  } else {
+    ok.body = json;
+  }
+
+  ok.headers["Content-Length"] = stringify(ok.body.size());
+
+  return ok;
+}
+
+
+// Returns a response with the object of `stream`, optionally wrapped
+// in a JSONP callback. Unless `streaming` is set the object is rendered
+// at once. Otherwise the object is sent as a chunked response, where
+// each part is rendered in a separate event on `pid`. This means that
+// the object never has to be rendered into one big string and that
+// `pid` serves other events while the object is rendered.
+static Response respond(
+    const UPID& pid,
+    const Owned<JsonStream>& stream,
+    bool streaming,
+    const Option<string>& jsonp)
+{
+  if (!streaming) {
+    return respond(render(stream), jsonp);
+  }
+
+  OK ok;
+  ok.headers["Content-Type"] =
+    jsonp.isSome() ? "text/javascript" : "application/json";
+
+  Pipe pipe;
+  ok.type = Response::PIPE;
+  ok.reader = pipe.reader();
+
+  Pipe::Writer writer = pipe.writer();
+
+  if (jsonp.isSome()) {
+    writer.write(jsonp.get() + "(");
+  }
+
+  // NOTE: A `loop` runs synchronously if its futures are ready, so we
+  // `dispatch` the rendering of each part to let `pid` serve the events
+  // that were enqueued in the meantime.
+  loop(
+      pid,
+      [pid, stream]() {
+        return process::dispatch(pid, [stream]() { return stream->next(); });
+      },
+      [writer, jsonp](const Option<string>& part) mutable
+          -> ControlFlow<Nothing> {
+        if (part.isNone()) {
+          if (jsonp.isSome()) {
+            writer.write(");");
+          }
+
+          writer.close();
+          return Break();
+        }
+
+        // Stop rendering if the client has gone away.
+        if (!writer.write(part.get())) {
+          return Break();
+        }
+
+        return Continue();
+      })
+    .onAbandoned([writer]() mutable {
+      writer.fail("Abandoned rendering the response");
+    });
+
+  return ok;
+}
+
+
+// Evolves `response` and serializes it in a separate process (see
+// `process::async`) rather than on the master actor. Converting a big
+// response (e.g., to `GET_STATE`) into its v1 form and serializing it
+// often takes longer than collecting it, so this keeps the master free
+// to serve other events and lets concurrent responses be serialized in
+// parallel. The collected response is immutable once it is shared.
+static Future<string> serializeAsync(
+    ContentType contentType,
+    mesos::master::Response&& response)
+{
+  mesos::master::Response* _response = new mesos::master::Response();
+  _response->Swap(&response);
+
+  Shared<mesos::master::Response> shared(_response);
+
+  return async([contentType, shared]() {
+    return serialize(contentType, evolve(*shared));
+  });
+}
+
+
+// Writes each list of entities of `getState` (e.g., the completed
+// tasks) into its own gzip compressed file in `directory`, named after
+// the field of the list (e.g., `completed_tasks.gz`). A file holds the
+// records of the entities, each prefixed with its length as a 32 bit
+// integer in host byte order (see `::protobuf::write`), so that offline
+// analyses only need to read the kinds of entities they look at. The
+// snapshot is written next to `directory` and then renamed, hence
+// `directory` only ever holds complete snapshots.
+static Try<Nothing> writeSnapshot(
+    const string& directory,
+    const mesos::master::Response::GetState& getState)
+{
+  const string temporary = directory + ".tmp";
+
+  Try<Nothing> mkdir = os::mkdir(temporary);
+  if (mkdir.isError()) {
+    return Error(
+        "Failed to create directory '" + temporary + "': " + mkdir.error());
+  }
+
+  const google::protobuf::Descriptor* descriptor = getState.GetDescriptor();
+  const google::protobuf::Reflection* reflection = getState.GetReflection();
+
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    const google::protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (field->cpp_type() !=
+          google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE ||
+        field->is_repeated()) {
+      continue;
+    }
+
+    // E.g., `get_tasks`.
+    const google::protobuf::Message& message =
+      reflection->GetMessage(getState, field);
+
+    const google::protobuf::Descriptor* _descriptor =
+      message.GetDescriptor();
+    const google::protobuf::Reflection* _reflection =
+      message.GetReflection();
+
+    for (int j = 0; j < _descriptor->field_count(); j++) {
+      // E.g., `completed_tasks`.
+      const google::protobuf::FieldDescriptor* entities =
+        _descriptor->field(j);
+
+      if (entities->cpp_type() !=
+            google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE ||
+          !entities->is_repeated()) {
+        continue;
+      }
+
+      string records;
+      for (int k = 0; k < _reflection->FieldSize(message, entities); k++) {
+        const google::protobuf::Message& record =
+          _reflection->GetRepeatedMessage(message, entities, k);
+
+        const uint32_t size = record.ByteSize();
+        records.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        record.AppendToString(&records);
+      }
+
+      Try<string> compressed = gzip::compress(records);
+      if (compressed.isError()) {
+        return Error(
+            "Failed to compress '" + entities->name() + "': " +
+            compressed.error());
+      }
+
+      const string path = path::join(temporary, entities->name() + ".gz");
+
+      Try<Nothing> write = os::write(path, compressed.get());
+      if (write.isError()) {
+        return Error("Failed to write '" + path + "': " + write.error());
+      }
+    }
+  }
+
+  Try<Nothing> rename = os::rename(temporary, directory);
+  if (rename.isError()) {
+    return Error(
+        "Failed to rename '" + temporary + "' to '" + directory + "': " +
+        rename.error());
+  }
+
+  return Nothing();
+}
+
+
 static void json(JSON::ObjectWriter* writer, const Summary<Framework>& summary)
 {
   const Framework& framework = summary;
@@ -657,7 +1016,14 @@ Future<Response> Master::Http::api(
     return MethodNotAllowed({"POST"}, request.method);
   }
 
-  v1::master::Call v1Call;
+  // The versioned call only lives until it gets devolved, so when
+  // parsing protobuf its fields are allocated on an arena and freed all
+  // at once at the end of the request.
+  google::protobuf::Arena arena;
+  v1::master::Call* v1Call = nullptr;
+
+  // The call parsed from JSON, which does not use the arena.
+  Option<v1::master::Call> json;
 
   // TODO(anand): Content type values are case-insensitive.
   Option<string> contentType = request.headers.get("Content-Type");
@@ -667,32 +1033,31 @@ Future<Response> Master::Http::api(
   }
 
   if (contentType.get() == APPLICATION_PROTOBUF) {
-    if (!v1Call.ParseFromString(request.body)) {
+    v1Call = google::protobuf::Arena::CreateMessage<v1::master::Call>(&arena);
+
+    if (!v1Call->ParseFromString(request.body)) {
       return BadRequest("Failed to parse body into Call protobuf");
     }
   } else if (contentType.get() == APPLICATION_JSON) {
-    Try<JSON::Value> value = JSON::parse(request.body);
-
-    if (value.isError()) {
-      return BadRequest("Failed to parse body into JSON: " + value.error());
-    }
-
+    // Parse the protobuf straight from the body rather than through
+    // a `JSON::Value`, since calls can be large.
     Try<v1::master::Call> parse =
-      ::protobuf::parse<v1::master::Call>(value.get());
+      ::protobuf::parseJSON<v1::master::Call>(request.body);
 
     if (parse.isError()) {
-      return BadRequest("Failed to convert JSON into Call protobuf: " +
+      return BadRequest("Failed to parse JSON body into Call protobuf: " +
                         parse.error());
     }
 
-    v1Call = parse.get();
+    json = std::move(parse.get());
+    v1Call = &json.get();
   } else {
     return UnsupportedMediaType(
         string("Expecting 'Content-Type' of ") +
         APPLICATION_JSON + " or " + APPLICATION_PROTOBUF);
   }
 
-  mesos::master::Call call = devolve(v1Call);
+  mesos::master::Call call = devolve(*v1Call);
 
   Option<Error> error = validation::master::call::validate(call, principal);
 
@@ -883,12 +1248,28 @@ Future<Response> Master::Http::subscribe(
 
           mesos::master::Event event;
           event.set_type(mesos::master::Event::SUBSCRIBED);
-          event.mutable_subscribed()->mutable_get_state()->CopyFrom(
-              _getState(
-                  frameworksApprover,
-                  tasksApprover,
-                  executorsApprover,
-                  rolesAcceptor));
+
+          // The events the client missed get sent after this event, in
+          // which case the snapshot of the state is left out.
+          if (call.has_subscribe() &&
+              call.subscribe().has_version() &&
+              master->subscribers.resume(
+                  http.streamId, call.subscribe().version())) {
+            event.mutable_subscribed()->set_version(
+                call.subscribe().version());
+          } else {
+            CHECK_SOME(master->subscribers.version);
+
+            event.mutable_subscribed()->mutable_get_state()->CopyFrom(
+                _getState(
+                    frameworksApprover,
+                    tasksApprover,
+                    executorsApprover,
+                    rolesAcceptor));
+
+            event.mutable_subscribed()->set_version(
+                master->subscribers.version.get());
+          }
 
           event.mutable_subscribed()->set_heartbeat_interval_seconds(
               DEFAULT_HEARTBEAT_INTERVAL.secs());
@@ -962,7 +1343,10 @@ Future<Response> Master::Http::scheduler(
     return MethodNotAllowed({"POST"}, request.method);
   }
 
-  v1::scheduler::Call v1Call;
+  // See `Http::api` for why the call gets parsed on an arena.
+  google::protobuf::Arena arena;
+  v1::scheduler::Call* v1Call = nullptr;
+  Option<v1::scheduler::Call> json;
 
   // TODO(anand): Content type values are case-insensitive.
   Option<string> contentType = request.headers.get("Content-Type");
@@ -972,32 +1356,30 @@ Future<Response> Master::Http::scheduler(
   }
 
   if (contentType.get() == APPLICATION_PROTOBUF) {
-    if (!v1Call.ParseFromString(request.body)) {
+    v1Call =
+      google::protobuf::Arena::CreateMessage<v1::scheduler::Call>(&arena);
+
+    if (!v1Call->ParseFromString(request.body)) {
       return BadRequest("Failed to parse body into Call protobuf");
     }
   } else if (contentType.get() == APPLICATION_JSON) {
-    Try<JSON::Value> value = JSON::parse(request.body);
-
-    if (value.isError()) {
-      return BadRequest("Failed to parse body into JSON: " + value.error());
-    }
-
     Try<v1::scheduler::Call> parse =
-      ::protobuf::parse<v1::scheduler::Call>(value.get());
+      ::protobuf::parseJSON<v1::scheduler::Call>(request.body);
 
     if (parse.isError()) {
-      return BadRequest("Failed to convert JSON into Call protobuf: " +
+      return BadRequest("Failed to parse JSON body into Call protobuf: " +
                         parse.error());
     }
 
-    v1Call = parse.get();
+    json = std::move(parse.get());
+    v1Call = &json.get();
   } else {
     return UnsupportedMediaType(
         string("Expecting 'Content-Type' of ") +
         APPLICATION_JSON + " or " + APPLICATION_PROTOBUF);
   }
 
-  scheduler::Call call = devolve(v1Call);
+  scheduler::Call call = devolve(*v1Call);
 
   Option<Error> error = validation::scheduler::call::validate(call, principal);
 
@@ -1748,8 +2130,10 @@ Future<Response> Master::Http::getFrameworks(
       response.mutable_get_frameworks()->CopyFrom(
           _getFrameworks(frameworksApprover));
 
-      return OK(serialize(contentType, evolve(response)),
-                stringify(contentType));
+      return serializeAsync(contentType, std::move(response))
+        .then([contentType](const string& body) -> Response {
+          return OK(body, stringify(contentType));
+        });
     }));
 }
 
@@ -1821,8 +2205,10 @@ Future<Response> Master::Http::getExecutors(
       response.mutable_get_executors()->CopyFrom(
           _getExecutors(frameworksApprover, executorsApprover));
 
-      return OK(serialize(contentType, evolve(response)),
-                stringify(contentType));
+      return serializeAsync(contentType, std::move(response))
+        .then([contentType](const string& body) -> Response {
+          return OK(body, stringify(contentType));
+        });
     }));
 }
 
@@ -1886,6 +2272,15 @@ Future<Response> Master::Http::getState(
 {
   CHECK_EQ(mesos::master::Call::GET_STATE, call.type());
 
+  const string name = "GET_STATE " + stringify(contentType);
+
+  Option<Future<View>> view = cached(name, principal);
+  if (view.isSome()) {
+    return view->then([contentType](const View& view) -> Response {
+      return OK(view.body, stringify(contentType));
+    });
+  }
+
   // Retrieve Approvers for authorizing frameworks and tasks.
   Future<Owned<ObjectApprover>> frameworksApprover;
   Future<Owned<ObjectApprover>> tasksApprover;
@@ -1913,14 +2308,14 @@ Future<Response> Master::Http::getState(
         master->authorizer,
         authorization::VIEW_ROLE);
 
-  return collect(
+  Future<View> rendering = collect(
       frameworksApprover, tasksApprover, executorsApprover, rolesAcceptor)
     .then(defer(master->self(),
         [=](const tuple<Owned<ObjectApprover>,
                         Owned<ObjectApprover>,
                         Owned<ObjectApprover>,
                         Owned<AuthorizationAcceptor>>& approvers)
-            -> Future<Response> {
+            -> Future<View> {
           // Get approver from tuple.
           Owned<ObjectApprover> frameworksApprover;
           Owned<ObjectApprover> tasksApprover;
@@ -1940,9 +2335,19 @@ Future<Response> Master::Http::getState(
                   executorsApprover,
                   rolesAcceptor));
 
-          return OK(
-              serialize(contentType, evolve(response)), stringify(contentType));
+          const uint64_t generation = master->generation;
+          const Time time = Clock::now();
+
+          return serializeAsync(contentType, std::move(response))
+            .then([generation, time](const string& body) {
+              return View{body, generation, time};
+            });
     }));
+
+  return cache(name, principal, rendering)
+    .then([contentType](const View& view) -> Response {
+      return OK(view.body, stringify(contentType));
+    });
 }
 
 
@@ -1974,6 +2379,38 @@ mesos::master::Response::GetState Master::Http::_getState(
 }
 
 
+Future<Nothing> Master::Http::snapshot(const string& directory) const
+{
+  // NOTE: Snapshots are meant for operators, hence they are not
+  // filtered, i.e., they hold what `GET_STATE` returns without an
+  // authorizer.
+  return AuthorizationAcceptor::create(
+      None(), None(), authorization::VIEW_ROLE)
+    .then(defer(master->self(),
+        [=](const Owned<AuthorizationAcceptor>& rolesAcceptor)
+            -> Future<Nothing> {
+          const Owned<ObjectApprover> approver(new AcceptingObjectApprover());
+
+          Shared<mesos::master::Response::GetState> getState(
+              new mesos::master::Response::GetState(
+                  _getState(approver, approver, approver, rolesAcceptor)));
+
+          // Only collecting the state runs on the master actor, it is
+          // serialized, compressed and written in a separate process.
+          return async([directory, getState]() {
+              return writeSnapshot(directory, *getState);
+            })
+            .then([](const Try<Nothing>& write) -> Future<Nothing> {
+              if (write.isError()) {
+                return Failure(write.error());
+              }
+
+              return Nothing();
+            });
+    }));
+}
+
+
 class Master::Http::FlagsError : public Error
 {
 public:
@@ -2353,6 +2790,32 @@ Future<Response> Master::Http::redirect(const Request& request) const
 }
 
 
+Future<Response> Master::Http::standby(
+    const Request& request,
+    const string& name) const
+{
+  // NOTE: The copies are fetched with the permissions of the leading
+  // master, hence they are only served when the requests are not
+  // subject to authorization. Requests with query parameters (e.g.,
+  // `jsonp`) are redirected as well.
+  if (master->flags.standby_state_refresh_interval.isNone() ||
+      master->authorizer.isSome() ||
+      !request.url.query.empty() ||
+      !master->standbyViews.contains(name)) {
+    return redirect(request);
+  }
+
+  const Master::StandbyView& view = master->standbyViews.at(name);
+
+  OK response(view.body);
+  response.headers["Content-Type"] = APPLICATION_JSON;
+  response.headers["Age"] =
+    stringify(static_cast<int64_t>((Clock::now() - view.time).secs()));
+
+  return response;
+}
+
+
 string Master::Http::RESERVE_HELP()
 {
   return HELP(
@@ -2594,8 +3057,10 @@ Future<process::http::Response> Master::Http::getAgents(
           response.set_type(mesos::master::Response::GET_AGENTS);
           response.mutable_get_agents()->CopyFrom(_getAgents(rolesAcceptor));
 
-          return OK(serialize(contentType, evolve(response)),
-                    stringify(contentType));
+          return serializeAsync(contentType, std::move(response))
+            .then([contentType](const string& body) -> Response {
+              return OK(body, stringify(contentType));
+            });
     }));
 }
 
@@ -2772,6 +3237,22 @@ string Master::Http::STATE_HELP()
         "The information shown might be filtered based on the user",
         "accessing the endpoint.",
         "",
+        "Query parameters:",
+        "",
+        ">        stream=(true|false)  Whether to stream the response.",
+        ">        framework_id=VALUE   Only return the framework with this ID.",
+        ">        slave_id=VALUE       Only return the agent with this ID.",
+        "",
+        "A streamed response is sent in chunks which are rendered a few",
+        "agents or frameworks at a time, so that the master keeps serving",
+        "other requests in between. Note that a streamed response is not",
+        "a consistent snapshot of the state and is not compressed.",
+        "",
+        "When filtering by a framework ID, only that framework is returned",
+        "out of the registered and completed frameworks, but all the agents",
+        "are returned unless filtering by an agent ID as well, and vice",
+        "versa.",
+        "",
         "Example (**Note**: this is not exhaustive):",
         "",
         "```",
@@ -2863,9 +3344,33 @@ Future<Response> Master::Http::state(
         "string. The master currently requires that principals have a value");
   }
 
-  // When current master is not the leader, redirect to the leading master.
+  // When current master is not the leader, serve the copy of the
+  // leading master's state if there is one, or redirect to it.
   if (!master->elected()) {
-    return redirect(request);
+    return standby(request, "state");
+  }
+
+  const bool streaming = request.url.query.get("stream") == string("true");
+  const Option<string> jsonp = request.url.query.get("jsonp");
+
+  const Option<string> frameworkId = request.url.query.get("framework_id");
+  const Option<string> slaveId = request.url.query.get("slave_id");
+
+  const IDAcceptor<FrameworkID> selectFrameworkId(frameworkId);
+  const IDAcceptor<SlaveID> selectSlaveId(slaveId);
+
+  // NOTE: A streamed state is rendered while it is sent, hence it is
+  // neither served from nor added to the cache. Neither is a filtered
+  // state, which only renders a fraction of the cluster.
+  const bool filtered = frameworkId.isSome() || slaveId.isSome();
+
+  if (!streaming && !filtered) {
+    Option<Future<View>> view = cached("/state", principal);
+    if (view.isSome()) {
+      return view->then([jsonp](const View& view) {
+        return respond(view.body, jsonp);
+      });
+    }
   }
 
   Future<Owned<AuthorizationAcceptor>> authorizeRole =
@@ -2884,7 +3389,7 @@ Future<Response> Master::Http::state(
     AuthorizationAcceptor::create(
         principal, master->authorizer, authorization::VIEW_FLAGS);
 
-  return collect(
+  Future<Owned<JsonStream>> stream = collect(
       authorizeRole,
       authorizeFrameworkInfo,
       authorizeTask,
@@ -2892,26 +3397,27 @@ Future<Response> Master::Http::state(
       authorizeFlags)
     .then(defer(
         master->self(),
-        [this, request](const tuple<Owned<AuthorizationAcceptor>,
-                                    Owned<AuthorizationAcceptor>,
-                                    Owned<AuthorizationAcceptor>,
-                                    Owned<AuthorizationAcceptor>,
-                                    Owned<AuthorizationAcceptor>>& acceptors)
-          -> Response {
-      // This lambda is consumed before the outer lambda
-      // returns, hence capture by reference is fine here.
-      auto state = [this, &acceptors](JSON::ObjectWriter* writer) {
-        Owned<AuthorizationAcceptor> authorizeRole;
-        Owned<AuthorizationAcceptor> authorizeFrameworkInfo;
-        Owned<AuthorizationAcceptor> authorizeTask;
-        Owned<AuthorizationAcceptor> authorizeExecutorInfo;
-        Owned<AuthorizationAcceptor> authorizeFlags;
-        tie(authorizeRole,
-            authorizeFrameworkInfo,
-            authorizeTask,
-            authorizeExecutorInfo,
-            authorizeFlags) = acceptors;
-
+        [this, selectFrameworkId, selectSlaveId](
+            const tuple<Owned<AuthorizationAcceptor>,
+                        Owned<AuthorizationAcceptor>,
+                        Owned<AuthorizationAcceptor>,
+                        Owned<AuthorizationAcceptor>,
+                        Owned<AuthorizationAcceptor>>& acceptors)
+          -> Owned<JsonStream> {
+      Owned<AuthorizationAcceptor> authorizeRole;
+      Owned<AuthorizationAcceptor> authorizeFrameworkInfo;
+      Owned<AuthorizationAcceptor> authorizeTask;
+      Owned<AuthorizationAcceptor> authorizeExecutorInfo;
+      Owned<AuthorizationAcceptor> authorizeFlags;
+      tie(authorizeRole,
+          authorizeFrameworkInfo,
+          authorizeTask,
+          authorizeExecutorInfo,
+          authorizeFlags) = acceptors;
+
+      Owned<JsonStream> state(new JsonStream(STATE_STREAM_BATCH_SIZE));
+
+      state->fields([this, authorizeFlags](JSON::ObjectWriter* writer) {
         writer->field("version", MESOS_VERSION);
 
         if (build::GIT_SHA.isSome()) {
@@ -2981,71 +3487,121 @@ Future<Response> Master::Http::state(
               }
             });
         }
+      });
+
+      // Model all of the registered slaves.
+      //
+      // NOTE: When streaming, slaves and frameworks might get removed
+      // while we are rendering, hence we look them up by their ids.
+      vector<SlaveID> slaveIds;
+      foreachvalue (Slave* slave, master->slaves.registered) {
+        if (selectSlaveId.accept(slave->id)) {
+          slaveIds.push_back(slave->id);
+        }
+      }
 
-        // Model all of the registered slaves.
-        writer->field("slaves",
-          [this, &authorizeRole](JSON::ArrayWriter* writer) {
-            foreachvalue (Slave* slave, master->slaves.registered) {
-              writer->element(SlaveWriter(*slave, authorizeRole));
+      state->array(
+          "slaves",
+          slaveIds.size(),
+          [this, slaveIds, authorizeRole](
+              JSON::ArrayWriter* writer, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+              Slave* slave = master->slaves.registered.get(slaveIds[i]);
+              if (slave != nullptr) {
+                writer->element(SlaveWriter(*slave, authorizeRole));
+              }
             }
           });
 
-        // Model all of the recovered slaves.
-        writer->field("recovered_slaves", [this](JSON::ArrayWriter* writer) {
-          foreachvalue (const SlaveInfo& slaveInfo, master->slaves.recovered) {
-            writer->element([&slaveInfo](JSON::ObjectWriter* writer) {
-              json(writer, slaveInfo);
+      // Model all of the recovered slaves.
+      state->fields([this, selectSlaveId](JSON::ObjectWriter* writer) {
+        writer->field(
+            "recovered_slaves",
+            [this, &selectSlaveId](JSON::ArrayWriter* writer) {
+              foreachvalue (const SlaveInfo& slaveInfo,
+                            master->slaves.recovered) {
+                if (!selectSlaveId.accept(slaveInfo.id())) {
+                  continue;
+                }
+
+                writer->element([&slaveInfo](JSON::ObjectWriter* writer) {
+                  json(writer, slaveInfo);
+                });
+              }
             });
-          }
-        });
+      });
 
-        // Model all of the frameworks.
-        writer->field(
-            "frameworks",
-            [this,
-             &authorizeFrameworkInfo,
-             &authorizeTask,
-             &authorizeExecutorInfo](JSON::ArrayWriter* writer) {
-          foreachvalue (
-              Framework* framework,
-              master->frameworks.registered) {
-            // Skip unauthorized frameworks.
-            if (!authorizeFrameworkInfo->accept(framework->info)) {
-              continue;
-            }
+      // Model all of the frameworks.
+      vector<FrameworkID> frameworkIds;
+      foreachkey (const FrameworkID& frameworkId,
+                  master->frameworks.registered) {
+        if (selectFrameworkId.accept(frameworkId)) {
+          frameworkIds.push_back(frameworkId);
+        }
+      }
 
-            auto frameworkWriter = FullFrameworkWriter(
-                authorizeTask,
-                authorizeExecutorInfo,
-                framework);
+      state->array(
+          "frameworks",
+          frameworkIds.size(),
+          [this,
+           frameworkIds,
+           authorizeFrameworkInfo,
+           authorizeTask,
+           authorizeExecutorInfo](
+              JSON::ArrayWriter* writer, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+              Framework* framework = master->getFramework(frameworkIds[i]);
+
+              // Skip removed and unauthorized frameworks.
+              if (framework == nullptr ||
+                  !authorizeFrameworkInfo->accept(framework->info)) {
+                continue;
+              }
 
-            writer->element(frameworkWriter);
-          }
-        });
+              auto frameworkWriter = FullFrameworkWriter(
+                  authorizeTask,
+                  authorizeExecutorInfo,
+                  framework);
 
-        // Model all of the completed frameworks.
-        writer->field(
-            "completed_frameworks",
-            [this,
-             &authorizeFrameworkInfo,
-             &authorizeTask,
-             &authorizeExecutorInfo](JSON::ArrayWriter* writer) {
-          foreachvalue (const Owned<Framework>& framework,
-                        master->frameworks.completed) {
-            // Skip unauthorized frameworks.
-            if (!authorizeFrameworkInfo->accept(framework->info)) {
-              continue;
+              writer->element(frameworkWriter);
             }
+          });
 
-            auto frameworkWriter = FullFrameworkWriter(
-                authorizeTask,
-                authorizeExecutorInfo,
-                framework.get());
+      // Model all of the completed frameworks.
+      vector<Owned<Framework>> completedFrameworks;
+      foreachvalue (const Owned<Framework>& framework,
+                    master->frameworks.completed) {
+        if (selectFrameworkId.accept(framework->id())) {
+          completedFrameworks.push_back(framework);
+        }
+      }
 
-            writer->element(frameworkWriter);
-          }
-        });
+      state->array(
+          "completed_frameworks",
+          completedFrameworks.size(),
+          [completedFrameworks,
+           authorizeFrameworkInfo,
+           authorizeTask,
+           authorizeExecutorInfo](
+              JSON::ArrayWriter* writer, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+              const Owned<Framework>& framework = completedFrameworks[i];
+
+              // Skip unauthorized frameworks.
+              if (!authorizeFrameworkInfo->accept(framework->info)) {
+                continue;
+              }
+
+              auto frameworkWriter = FullFrameworkWriter(
+                  authorizeTask,
+                  authorizeExecutorInfo,
+                  framework.get());
+
+              writer->element(frameworkWriter);
+            }
+          });
 
+      state->fields([](JSON::ObjectWriter* writer) {
         // Orphan tasks are no longer possible. We emit an empty array
         // for the sake of backward compatibility.
         writer->field("orphan_tasks", [](JSON::ArrayWriter*) {});
@@ -3053,10 +3609,78 @@ Future<Response> Master::Http::state(
         // Unregistered frameworks are no longer possible. We emit an
         // empty array for the sake of backward compatibility.
         writer->field("unregistered_frameworks", [](JSON::ArrayWriter*) {});
-      };
+      });
 
-      return OK(jsonify(state), request.url.query.get("jsonp"));
+      return state;
     }));
+
+  if (streaming || filtered) {
+    return stream.then(defer(
+        master->self(),
+        [this, streaming, jsonp](const Owned<JsonStream>& state) {
+          return respond(master->self(), state, streaming, jsonp);
+        }));
+  }
+
+  Future<View> rendering = stream.then(defer(
+      master->self(),
+      [this](const Owned<JsonStream>& state) {
+        return View{render(state), master->generation, Clock::now()};
+      }));
+
+  return cache("/state", principal, rendering)
+    .then([jsonp](const View& view) {
+      return respond(view.body, jsonp);
+    });
+}
+
+
+// Returns the key of the view `name` for the class of `principal`.
+// Without an authorizer every principal is allowed to see the same.
+static string viewKey(
+    const string& name,
+    const Option<Principal>& principal,
+    bool authorized)
+{
+  if (!authorized || principal.isNone()) {
+    return name;
+  }
+
+  return name + " " + stringify(principal.get());
+}
+
+
+Option<Future<Master::Http::View>> Master::Http::cached(
+    const string& name,
+    const Option<Principal>& principal) const
+{
+  const string key = viewKey(name, principal, master->authorizer.isSome());
+
+  Option<Future<View>> view = views.get(key);
+  if (view.isNone() || view->isPending()) {
+    return view;
+  }
+
+  if (view->isReady() &&
+      (view->get().generation == master->generation ||
+       Clock::now() - view->get().time <=
+         master->flags.state_cache_max_staleness)) {
+    return view;
+  }
+
+  views.erase(key);
+
+  return None();
+}
+
+
+Future<Master::Http::View> Master::Http::cache(
+    const string& name,
+    const Option<Principal>& principal,
+    const Future<View>& view) const
+{
+  views[viewKey(name, principal, master->authorizer.isSome())] = view;
+  return view;
 }
 
 
@@ -3137,9 +3761,11 @@ public:
         slavesToFrameworks[task->slave_id()].insert(frameworkId);
       }
 
-      foreach (const Owned<Task>& task, framework->completedTasks) {
-        frameworksToSlaves[frameworkId].insert(task->slave_id());
-        slavesToFrameworks[task->slave_id()].insert(frameworkId);
+      foreach (const CompletedTasks::Archived& task,
+               framework->completedTasks) {
+        const SlaveID slaveId = task.slave_id();
+        frameworksToSlaves[frameworkId].insert(slaveId);
+        slavesToFrameworks[slaveId].insert(frameworkId);
       }
     }
   }
@@ -3191,7 +3817,12 @@ struct TaskStateSummary
   // Account for the state of the given task.
   void count(const Task& task)
   {
-    switch (task.state()) {
+    count(task.state());
+  }
+
+  void count(const TaskState& state)
+  {
+    switch (state) {
       case TASK_STAGING: { ++staging; break; }
       case TASK_STARTING: { ++starting; break; }
       case TASK_RUNNING: { ++running; break; }
@@ -3258,9 +3889,10 @@ public:
         slaveTaskSummaries[task->slave_id()].count(*task);
       }
 
-      foreach (const Owned<Task>& task, framework->completedTasks) {
-        frameworkTaskSummaries[frameworkId].count(*task);
-        slaveTaskSummaries[task->slave_id()].count(*task);
+      foreach (const CompletedTasks::Archived& task,
+               framework->completedTasks) {
+        frameworkTaskSummaries[frameworkId].count(task.state());
+        slaveTaskSummaries[task.slave_id()].count(task.state());
       }
     }
   }
@@ -3303,7 +3935,16 @@ string Master::Http::STATESUMMARY_HELP()
         "This endpoint gives a summary of the agents, tasks, and",
         "registered frameworks in the cluster as a JSON object.",
         "The information shown might be filtered based on the user",
-        "accessing the endpoint."),
+        "accessing the endpoint.",
+        "",
+        "Query parameters:",
+        "",
+        ">        stream=(true|false)  Whether to stream the response.",
+        "",
+        "A streamed response is sent in chunks which are rendered a few",
+        "agents or frameworks at a time, so that the master keeps serving",
+        "other requests in between. Note that a streamed response is not",
+        "a consistent snapshot of the state and is not compressed."),
     AUTHENTICATION(true),
     AUTHORIZATION(
         "This endpoint might be filtered based on the user accessing it.",
@@ -3326,9 +3967,10 @@ Future<Response> Master::Http::stateSummary(
         "string. The master currently requires that principals have a value");
   }
 
-  // When current master is not the leader, redirect to the leading master.
+  // When current master is not the leader, serve the copy of the
+  // leading master's state summary if there is one, or redirect to it.
   if (!master->elected()) {
-    return redirect(request);
+    return standby(request, "state-summary");
   }
 
   Future<Owned<AuthorizationAcceptor>> authorizeRole =
@@ -3343,143 +3985,179 @@ Future<Response> Master::Http::stateSummary(
       [this, request](const tuple<Owned<AuthorizationAcceptor>,
                                   Owned<AuthorizationAcceptor>>& acceptors)
           -> Response {
-        auto stateSummary = [this, &acceptors](JSON::ObjectWriter* writer) {
-          Owned<AuthorizationAcceptor> authorizeRole;
-          Owned<AuthorizationAcceptor> authorizeFrameworkInfo;
-          tie(authorizeRole, authorizeFrameworkInfo) = acceptors;
+        Owned<AuthorizationAcceptor> authorizeRole;
+        Owned<AuthorizationAcceptor> authorizeFrameworkInfo;
+        tie(authorizeRole, authorizeFrameworkInfo) = acceptors;
+
+        Owned<JsonStream> stateSummary(
+            new JsonStream(STATE_STREAM_BATCH_SIZE));
 
+        stateSummary->fields([this](JSON::ObjectWriter* writer) {
           writer->field("hostname", master->info().hostname());
 
           if (master->flags.cluster.isSome()) {
             writer->field("cluster", master->flags.cluster.get());
           }
+        });
 
-          // We use the tasks in the 'Frameworks' struct to compute summaries
-          // for this endpoint. This is done 1) for consistency between the
-          // 'slaves' and 'frameworks' subsections below 2) because we want to
-          // provide summary information for frameworks that are currently
-          // registered 3) the frameworks keep a circular buffer of completed
-          // tasks that we can use to keep a limited view on the history of
-          // recent completed / failed tasks.
-
-          // Generate mappings from 'slave' to 'framework' and reverse.
-          SlaveFrameworkMapping slaveFrameworkMapping(
-              master->frameworks.registered);
-
-          // Generate 'TaskState' summaries for all framework and slave ids.
-          TaskStateSummaries taskStateSummaries(master->frameworks.registered);
+        // We use the tasks in the 'Frameworks' struct to compute summaries
+        // for this endpoint. This is done 1) for consistency between the
+        // 'slaves' and 'frameworks' subsections below 2) because we want to
+        // provide summary information for frameworks that are currently
+        // registered 3) the frameworks keep a circular buffer of completed
+        // tasks that we can use to keep a limited view on the history of
+        // recent completed / failed tasks.
+        //
+        // NOTE: When streaming, the summaries are computed up front and
+        // slaves and frameworks might get removed while we are rendering,
+        // hence we look them up by their ids.
+
+        // Generate mappings from 'slave' to 'framework' and reverse.
+        Owned<SlaveFrameworkMapping> slaveFrameworkMapping(
+            new SlaveFrameworkMapping(master->frameworks.registered));
+
+        // Generate 'TaskState' summaries for all framework and slave ids.
+        Owned<TaskStateSummaries> taskStateSummaries(
+            new TaskStateSummaries(master->frameworks.registered));
+
+        // Model all of the slaves.
+        vector<SlaveID> slaveIds;
+        foreachvalue (Slave* slave, master->slaves.registered) {
+          slaveIds.push_back(slave->id);
+        }
 
-          // Model all of the slaves.
-          writer->field(
-              "slaves",
-              [this,
-               &slaveFrameworkMapping,
-               &taskStateSummaries,
-               &authorizeRole](JSON::ArrayWriter* writer) {
-                foreachvalue (Slave* slave, master->slaves.registered) {
-                  writer->element(
-                      [&slave,
-                       &slaveFrameworkMapping,
-                       &taskStateSummaries,
-                       &authorizeRole](JSON::ObjectWriter* writer) {
-                        SlaveWriter slaveWriter(*slave, authorizeRole);
-                        slaveWriter(writer);
-
-                        // Add the 'TaskState' summary for this slave.
-                        const TaskStateSummary& summary =
-                            taskStateSummaries.slave(slave->id);
-
-                        // Certain per-agent status totals will always be zero
-                        // (e.g., TASK_ERROR, TASK_UNREACHABLE). We report them
-                        // here anyway, for completeness.
-                        //
-                        // TODO(neilc): Update for TASK_GONE and
-                        // TASK_GONE_BY_OPERATOR.
-                        writer->field("TASK_STAGING", summary.staging);
-                        writer->field("TASK_STARTING", summary.starting);
-                        writer->field("TASK_RUNNING", summary.running);
-                        writer->field("TASK_KILLING", summary.killing);
-                        writer->field("TASK_FINISHED", summary.finished);
-                        writer->field("TASK_KILLED", summary.killed);
-                        writer->field("TASK_FAILED", summary.failed);
-                        writer->field("TASK_LOST", summary.lost);
-                        writer->field("TASK_ERROR", summary.error);
-                        writer->field("TASK_UNREACHABLE", summary.unreachable);
-
-                        // Add the ids of all the frameworks running on this
-                        // slave.
-                        const hashset<FrameworkID>& frameworks =
-                            slaveFrameworkMapping.frameworks(slave->id);
-
-                        writer->field(
-                            "framework_ids",
-                            [&frameworks](JSON::ArrayWriter* writer) {
-                              foreach (
-                                  const FrameworkID& frameworkId,
-                                  frameworks) {
-                                writer->element(frameworkId.value());
-                              }
-                            });
-                      });
+        stateSummary->array(
+            "slaves",
+            slaveIds.size(),
+            [this,
+             slaveIds,
+             slaveFrameworkMapping,
+             taskStateSummaries,
+             authorizeRole](
+                JSON::ArrayWriter* writer, size_t begin, size_t end) {
+              for (size_t i = begin; i < end; i++) {
+                Slave* slave = master->slaves.registered.get(slaveIds[i]);
+                if (slave == nullptr) {
+                  continue;
                 }
-              });
 
-          // Model all of the frameworks.
-          writer->field(
-              "frameworks",
-              [this,
-               &slaveFrameworkMapping,
-               &taskStateSummaries,
-               &authorizeFrameworkInfo](JSON::ArrayWriter* writer) {
-                foreachpair (const FrameworkID& frameworkId,
-                             Framework* framework,
-                             master->frameworks.registered) {
-                  // Skip unauthorized frameworks.
-                  if (!authorizeFrameworkInfo->accept(framework->info)) {
-                    continue;
-                  }
+                writer->element(
+                    [&slave,
+                     &slaveFrameworkMapping,
+                     &taskStateSummaries,
+                     &authorizeRole](JSON::ObjectWriter* writer) {
+                      SlaveWriter slaveWriter(*slave, authorizeRole);
+                      slaveWriter(writer);
+
+                      // Add the 'TaskState' summary for this slave.
+                      const TaskStateSummary& summary =
+                          taskStateSummaries->slave(slave->id);
+
+                      // Certain per-agent status totals will always be zero
+                      // (e.g., TASK_ERROR, TASK_UNREACHABLE). We report them
+                      // here anyway, for completeness.
+                      //
+                      // TODO(neilc): Update for TASK_GONE and
+                      // TASK_GONE_BY_OPERATOR.
+                      writer->field("TASK_STAGING", summary.staging);
+                      writer->field("TASK_STARTING", summary.starting);
+                      writer->field("TASK_RUNNING", summary.running);
+                      writer->field("TASK_KILLING", summary.killing);
+                      writer->field("TASK_FINISHED", summary.finished);
+                      writer->field("TASK_KILLED", summary.killed);
+                      writer->field("TASK_FAILED", summary.failed);
+                      writer->field("TASK_LOST", summary.lost);
+                      writer->field("TASK_ERROR", summary.error);
+                      writer->field("TASK_UNREACHABLE", summary.unreachable);
+
+                      // Add the ids of all the frameworks running on this
+                      // slave.
+                      const hashset<FrameworkID>& frameworks =
+                          slaveFrameworkMapping->frameworks(slave->id);
+
+                      writer->field(
+                          "framework_ids",
+                          [&frameworks](JSON::ArrayWriter* writer) {
+                            foreach (
+                                const FrameworkID& frameworkId,
+                                frameworks) {
+                              writer->element(frameworkId.value());
+                            }
+                          });
+                    });
+              }
+            });
+
+        // Model all of the frameworks.
+        vector<FrameworkID> frameworkIds;
+        foreachkey (const FrameworkID& frameworkId,
+                    master->frameworks.registered) {
+          frameworkIds.push_back(frameworkId);
+        }
 
-                  writer->element(
-                      [&frameworkId,
-                       &framework,
-                       &slaveFrameworkMapping,
-                       &taskStateSummaries](JSON::ObjectWriter* writer) {
-                        json(writer, Summary<Framework>(*framework));
-
-                        // Add the 'TaskState' summary for this framework.
-                        const TaskStateSummary& summary =
-                            taskStateSummaries.framework(frameworkId);
-
-                        // TODO(neilc): Update for TASK_GONE and
-                        // TASK_GONE_BY_OPERATOR.
-                        writer->field("TASK_STAGING", summary.staging);
-                        writer->field("TASK_STARTING", summary.starting);
-                        writer->field("TASK_RUNNING", summary.running);
-                        writer->field("TASK_KILLING", summary.killing);
-                        writer->field("TASK_FINISHED", summary.finished);
-                        writer->field("TASK_KILLED", summary.killed);
-                        writer->field("TASK_FAILED", summary.failed);
-                        writer->field("TASK_LOST", summary.lost);
-                        writer->field("TASK_ERROR", summary.error);
-                        writer->field("TASK_UNREACHABLE", summary.unreachable);
-
-                        // Add the ids of all the slaves running this framework.
-                        const hashset<SlaveID>& slaves =
-                            slaveFrameworkMapping.slaves(frameworkId);
-
-                        writer->field(
-                            "slave_ids",
-                            [&slaves](JSON::ArrayWriter* writer) {
-                              foreach (const SlaveID& slaveId, slaves) {
-                                writer->element(slaveId.value());
-                              }
-                            });
-                      });
+        stateSummary->array(
+            "frameworks",
+            frameworkIds.size(),
+            [this,
+             frameworkIds,
+             slaveFrameworkMapping,
+             taskStateSummaries,
+             authorizeFrameworkInfo](
+                JSON::ArrayWriter* writer, size_t begin, size_t end) {
+              for (size_t i = begin; i < end; i++) {
+                const FrameworkID& frameworkId = frameworkIds[i];
+                Framework* framework = master->getFramework(frameworkId);
+
+                // Skip removed and unauthorized frameworks.
+                if (framework == nullptr ||
+                    !authorizeFrameworkInfo->accept(framework->info)) {
+                  continue;
                 }
-              });
-        };
 
-        return OK(jsonify(stateSummary), request.url.query.get("jsonp"));
+                writer->element(
+                    [&frameworkId,
+                     &framework,
+                     &slaveFrameworkMapping,
+                     &taskStateSummaries](JSON::ObjectWriter* writer) {
+                      json(writer, Summary<Framework>(*framework));
+
+                      // Add the 'TaskState' summary for this framework.
+                      const TaskStateSummary& summary =
+                          taskStateSummaries->framework(frameworkId);
+
+                      // TODO(neilc): Update for TASK_GONE and
+                      // TASK_GONE_BY_OPERATOR.
+                      writer->field("TASK_STAGING", summary.staging);
+                      writer->field("TASK_STARTING", summary.starting);
+                      writer->field("TASK_RUNNING", summary.running);
+                      writer->field("TASK_KILLING", summary.killing);
+                      writer->field("TASK_FINISHED", summary.finished);
+                      writer->field("TASK_KILLED", summary.killed);
+                      writer->field("TASK_FAILED", summary.failed);
+                      writer->field("TASK_LOST", summary.lost);
+                      writer->field("TASK_ERROR", summary.error);
+                      writer->field("TASK_UNREACHABLE", summary.unreachable);
+
+                      // Add the ids of all the slaves running this framework.
+                      const hashset<SlaveID>& slaves =
+                          slaveFrameworkMapping->slaves(frameworkId);
+
+                      writer->field(
+                          "slave_ids",
+                          [&slaves](JSON::ArrayWriter* writer) {
+                            foreach (const SlaveID& slaveId, slaves) {
+                              writer->element(slaveId.value());
+                            }
+                          });
+                    });
+              }
+            });
+
+        return respond(
+            master->self(),
+            stateSummary,
+            request.url.query.get("stream") == string("true"),
+            request.url.query.get("jsonp"));
       }));
 }
 
@@ -3726,7 +4404,7 @@ Future<Response> Master::Http::getRoles(
   return _roles(principal)
     .then(defer(master->self(),
         [this, contentType](const vector<string>& filteredRoles)
-          -> Response {
+          -> Future<Response> {
       mesos::master::Response response;
       response.set_type(mesos::master::Response::GET_ROLES);
 
@@ -3757,8 +4435,10 @@ Future<Response> Master::Http::getRoles(
         getRoles->add_roles()->CopyFrom(role);
       }
 
-      return OK(serialize(contentType, evolve(response)),
-                stringify(contentType));
+      return serializeAsync(contentType, std::move(response))
+        .then([contentType](const string& body) -> Response {
+          return OK(body, stringify(contentType));
+        });
     }));
 }
 
@@ -3901,50 +4581,76 @@ Future<Response> Master::Http::teardown(
 }
 
 
+// Orders tasks by the timestamp of their first status, if any. Tasks
+// without any status come first in ascending order and last in
+// descending order.
 struct TaskComparator
 {
-  static bool ascending(const Task* lhs, const Task* rhs)
+  static bool ascending(const Option<double>& lhs, const Option<double>& rhs)
   {
-    size_t lhsSize = lhs->statuses().size();
-    size_t rhsSize = rhs->statuses().size();
-
-    if ((lhsSize == 0) && (rhsSize == 0)) {
+    if (lhs.isNone() && rhs.isNone()) {
       return false;
     }
 
-    if (lhsSize == 0) {
+    if (lhs.isNone()) {
       return true;
     }
 
-    if (rhsSize == 0) {
+    if (rhs.isNone()) {
       return false;
     }
 
-    return (lhs->statuses(0).timestamp() < rhs->statuses(0).timestamp());
+    return lhs.get() < rhs.get();
   }
 
-  static bool descending(const Task* lhs, const Task* rhs)
+  static bool descending(const Option<double>& lhs, const Option<double>& rhs)
   {
-    size_t lhsSize = lhs->statuses().size();
-    size_t rhsSize = rhs->statuses().size();
-
-    if ((lhsSize == 0) && (rhsSize == 0)) {
+    if (lhs.isNone() && rhs.isNone()) {
       return false;
     }
 
-    if (rhsSize == 0) {
+    if (rhs.isNone()) {
       return true;
     }
 
-    if (lhsSize == 0) {
+    if (lhs.isNone()) {
       return false;
     }
 
-    return (lhs->statuses(0).timestamp() > rhs->statuses(0).timestamp());
+    return lhs.get() > rhs.get();
   }
 };
 
 
+// A task that is a candidate for the `/tasks` endpoint. Completed
+// tasks remain archived (i.e., `task` is NULL) until they are
+// actually returned, so that we only inflate and authorize the tasks
+// that end up on the requested page.
+struct TaskCandidate
+{
+  TaskCandidate(const Framework* _framework, const Task* _task)
+    : framework(_framework), task(_task), archived(nullptr)
+  {
+    if (task->statuses_size() > 0) {
+      timestamp = task->statuses(0).timestamp();
+    }
+  }
+
+  TaskCandidate(
+      const Framework* _framework,
+      const CompletedTasks::Archived* _archived)
+    : framework(_framework),
+      task(nullptr),
+      archived(_archived),
+      timestamp(archived->timestamp()) {}
+
+  const Framework* framework;
+  const Task* task;
+  const CompletedTasks::Archived* archived;
+  Option<double> timestamp;
+};
+
+
 string Master::Http::TASKS_HELP()
 {
   return HELP(
@@ -4072,61 +4778,101 @@ Future<Response> Master::Http::tasks(
             frameworks.push_back(framework.get());
           }
 
-          // Construct task list with both running,
-          // completed and unreachable tasks.
-          vector<const Task*> tasks;
+          // Construct the list of candidate tasks with both running,
+          // completed and unreachable tasks. Only the task ID is
+          // checked here, authorization is deferred until the tasks
+          // are selected below.
+          vector<TaskCandidate> candidates;
           foreach (const Framework* framework, frameworks) {
             foreachvalue (Task* task, framework->tasks) {
               CHECK_NOTNULL(task);
-              // Skip unauthorized tasks or tasks without matching task ID.
-              if (!selectTaskId.accept(task->task_id()) ||
-                  !authorizeTask->accept(*task, framework->info)) {
-                continue;
+              if (selectTaskId.accept(task->task_id())) {
+                candidates.emplace_back(framework, task);
               }
-
-              tasks.push_back(task);
             }
 
             foreachvalue (
                 const Owned<Task>& task,
                 framework->unreachableTasks) {
-              // Skip unauthorized tasks or tasks without matching task ID.
-              if (!selectTaskId.accept(task->task_id()) ||
-                  !authorizeTask->accept(*task, framework->info)) {
-                continue;
+              if (selectTaskId.accept(task->task_id())) {
+                candidates.emplace_back(framework, task.get());
               }
-
-              tasks.push_back(task.get());
             }
 
-            foreach (const Owned<Task>& task, framework->completedTasks) {
-              // Skip unauthorized tasks or tasks without matching task ID.
-              if (!selectTaskId.accept(task->task_id()) ||
-                  !authorizeTask->accept(*task, framework->info)) {
-                continue;
+            foreach (const CompletedTasks::Archived& archived,
+                     framework->completedTasks) {
+              if (selectTaskId.accept(archived.task_id())) {
+                candidates.emplace_back(framework, &archived);
               }
-
-              tasks.push_back(task.get());
             }
           }
 
-          // Sort tasks by task status timestamp. Default order is descending.
-          // The earliest timestamp is chosen for comparison when
-          // multiple are present.
-          if (_order == "asc") {
-            sort(tasks.begin(), tasks.end(), TaskComparator::ascending);
-          } else {
-            sort(tasks.begin(), tasks.end(), TaskComparator::descending);
+          // Order tasks by task status timestamp. Default order is
+          // descending. The earliest timestamp is chosen for comparison
+          // when multiple are present.
+          //
+          // Rather than sorting all of the candidates we build a heap
+          // (in linear time) and only pop the `offset + limit` tasks
+          // that we need, since usually only a small page is requested
+          // out of a large number of (mostly completed) tasks. Note
+          // that `std::pop_heap` moves the greatest element, hence the
+          // inverted comparator.
+          auto compare = [&_order](
+              const TaskCandidate& lhs,
+              const TaskCandidate& rhs) {
+            return _order == "asc"
+              ? TaskComparator::descending(lhs.timestamp, rhs.timestamp)
+              : TaskComparator::ascending(lhs.timestamp, rhs.timestamp);
+          };
+
+          std::make_heap(candidates.begin(), candidates.end(), compare);
+
+          vector<const Task*> tasks;
+
+          // Owns the completed tasks that get inflated from the
+          // archive of each framework.
+          vector<Owned<Task>> completedTasks;
+
+          // Number of authorized tasks skipped due to `offset`.
+          size_t skipped = 0;
+
+          for (auto end = candidates.end();
+               end != candidates.begin() && tasks.size() < limit;
+               --end) {
+            std::pop_heap(candidates.begin(), end, compare);
+
+            const TaskCandidate& candidate = *(end - 1);
+
+            const Task* task = candidate.task;
+
+            Owned<Task> completed;
+            if (candidate.archived != nullptr) {
+              completed.reset(new Task(candidate.archived->inflate()));
+              task = completed.get();
+            }
+
+            // Skip unauthorized tasks.
+            if (!authorizeTask->accept(*task, candidate.framework->info)) {
+              continue;
+            }
+
+            // Skip the first 'offset' number of tasks.
+            if (skipped < offset) {
+              skipped++;
+              continue;
+            }
+
+            tasks.push_back(task);
+
+            if (completed.get() != nullptr) {
+              completedTasks.push_back(completed);
+            }
           }
 
-          auto tasksWriter =
-            [&tasks, limit, offset](JSON::ObjectWriter* writer) {
-            writer->field("tasks",
-                          [&tasks, limit, offset](JSON::ArrayWriter* writer) {
-              // Collect 'limit' number of tasks starting from 'offset'.
-              size_t end = std::min(offset + limit, tasks.size());
-              for (size_t i = offset; i < end; i++) {
-                writer->element(*tasks[i]);
+          auto tasksWriter = [&tasks](JSON::ObjectWriter* writer) {
+            writer->field("tasks", [&tasks](JSON::ArrayWriter* writer) {
+              foreach (const Task* task, tasks) {
+                writer->element(*task);
               }
             });
           };
@@ -4177,8 +4923,10 @@ Future<Response> Master::Http::getTasks(
           _getTasks(frameworksApprover,
                     tasksApprover));
 
-      return OK(serialize(contentType, evolve(response)),
-                stringify(contentType));
+      return serializeAsync(contentType, std::move(response))
+        .then([contentType](const string& body) -> Response {
+          return OK(body, stringify(contentType));
+        });
   }));
 }
 
@@ -4254,13 +5002,16 @@ mesos::master::Response::GetTasks Master::Http::_getTasks(
     }
 
     // Completed tasks.
-    foreach (const Owned<Task>& task, framework->completedTasks) {
+    foreach (const CompletedTasks::Archived& archived,
+             framework->completedTasks) {
+      Task task = archived.inflate();
+
       // Skip unauthorized tasks.
-      if (!approveViewTask(tasksApprover, *task, framework->info)) {
+      if (!approveViewTask(tasksApprover, task, framework->info)) {
         continue;
       }
 
-      getTasks.add_completed_tasks()->CopyFrom(*task);
+      getTasks.add_completed_tasks()->Swap(&task);
     }
   }
 
@@ -383,7 +383,8 @@ int main(int argc, char** argv)
           path::join(url.get().path, "log_replicas"),
           url.get().authentication,
           flags.log_auto_initialize,
-          "registrar/");
+          "registrar/",
+          flags.log_batch_writes);
     } else {
       // Use replicated log without ZooKeeper.
       log = new Log(
@@ -391,7 +392,8 @@ int main(int argc, char** argv)
           path::join(flags.work_dir.get(), "replicated_log"),
           set<UPID>(),
           flags.log_auto_initialize,
-          "registrar/");
+          "registrar/",
+          flags.log_batch_writes);
     }
     storage = new LogStorage(log);
 #endif // __WINDOWS__
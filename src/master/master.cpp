@@ -23,6 +23,7 @@
 #include <iomanip>
 #include <list>
 #include <memory>
+#include <random>
 #include <set>
 #include <sstream>
 #include <tuple>
@@ -49,6 +50,9 @@
 #include <process/delay.hpp>
 #include <process/http.hpp>
 #include <process/id.hpp>
+#ifdef USE_SSL_SOCKET
+#include <process/jwt.hpp>
+#endif // USE_SSL_SOCKET
 #include <process/limiter.hpp>
 #include <process/owned.hpp>
 #include <process/run.hpp>
@@ -73,6 +77,8 @@
 #include <stout/utils.hpp>
 #include <stout/uuid.hpp>
 
+#include <stout/os/read.hpp>
+
 #include "authentication/cram_md5/authenticator.hpp"
 
 #include "common/build.hpp"
@@ -110,9 +116,11 @@ using std::vector;
 using process::await;
 using process::wait; // Necessary on some OS's to disambiguate.
 using process::Clock;
+using process::Event;
 using process::ExitedEvent;
 using process::Failure;
 using process::Future;
+using process::HttpEvent;
 using process::MessageEvent;
 using process::Owned;
 using process::PID;
@@ -128,6 +136,11 @@ using process::http::Pipe;
 
 using process::http::authentication::Principal;
 
+#ifdef USE_SSL_SOCKET
+using process::http::authentication::JWT;
+using process::http::authentication::JWTError;
+#endif // USE_SSL_SOCKET
+
 using process::metrics::Counter;
 
 using google::protobuf::RepeatedPtrField;
@@ -147,87 +160,170 @@ using mesos::master::detector::MasterDetector;
 static bool isValidFailoverTimeout(const FrameworkInfo& frameworkInfo);
 
 
+// Pings the registered agents periodically, and marks an agent
+// unreachable once it has not responded to `maxSlavePingTimeouts`
+// pings in a row.
+//
+// A single observer checks the health of all the agents, rather than
+// a process per agent: the ping timeout is divided into `SLOTS` ticks
+// and every agent is assigned to the slot of the tick it was added
+// in. On each tick the agents of the next slot get pinged again, after
+// accounting for a missing pong, so all the agents of a slot share a
+// single timer.
 class SlaveObserver : public ProtobufProcess<SlaveObserver>
 {
 public:
-  SlaveObserver(const UPID& _slave,
-                const SlaveInfo& _slaveInfo,
-                const SlaveID& _slaveId,
-                const PID<Master>& _master,
+  SlaveObserver(const PID<Master>& _master,
                 const Option<shared_ptr<RateLimiter>>& _limiter,
                 const shared_ptr<Metrics>& _metrics,
                 const Duration& _slavePingTimeout,
                 const size_t _maxSlavePingTimeouts)
     : ProcessBase(process::ID::generate("slave-observer")),
-      slave(_slave),
-      slaveInfo(_slaveInfo),
-      slaveId(_slaveId),
       master(_master),
       limiter(_limiter),
       metrics(_metrics),
-      slavePingTimeout(_slavePingTimeout),
+      tick(std::max(_slavePingTimeout / SLOTS, Duration(Nanoseconds(1)))),
       maxSlavePingTimeouts(_maxSlavePingTimeouts),
-      timeouts(0),
-      pinged(false),
-      connected(true)
+      slots(SLOTS),
+      current(0),
+      ticking(false)
   {
     install<PongSlaveMessage>(&SlaveObserver::pong);
   }
 
-  void reconnect()
+  void add(const SlaveID& slaveId, const UPID& pid)
+  {
+    CHECK(!agents.contains(slaveId)) << "Duplicate agent " << slaveId;
+
+    // The agent is added to the slot of the current tick, so that it
+    // gets checked once all the other slots have been, i.e., after the
+    // ping timeout.
+    Agent& agent = agents[slaveId];
+    agent.pid = pid;
+    agent.slot = current;
+
+    slots[current].insert(slaveId);
+    pids[pid].insert(slaveId);
+
+    ping(&agent);
+
+    if (!ticking) {
+      ticking = true;
+      delay(tick, self(), &Self::advance);
+    }
+  }
+
+  void remove(const SlaveID& slaveId)
   {
-    connected = true;
+    if (!agents.contains(slaveId)) {
+      return;
+    }
+
+    const Agent& agent = agents.at(slaveId);
+
+    slots[agent.slot].erase(slaveId);
+
+    pids[agent.pid].erase(slaveId);
+    if (pids[agent.pid].empty()) {
+      pids.erase(agent.pid);
+    }
+
+    // NOTE: A pending unreachable transition of the agent gets ignored
+    // in `_markUnreachable` once the agent is removed.
+    agents.erase(slaveId);
   }
 
-  void disconnect()
+  void reconnect(const SlaveID& slaveId)
   {
-    connected = false;
+    if (agents.contains(slaveId)) {
+      agents.at(slaveId).connected = true;
+    }
   }
 
-protected:
-  virtual void initialize()
+  void disconnect(const SlaveID& slaveId)
   {
-    ping();
+    if (agents.contains(slaveId)) {
+      agents.at(slaveId).connected = false;
+    }
   }
 
-  void ping()
+private:
+  static constexpr size_t SLOTS = 16;
+
+  struct Agent
+  {
+    Agent() : slot(0), timeouts(0), pinged(false), connected(true) {}
+
+    UPID pid;
+    size_t slot;
+    uint32_t timeouts;
+    bool pinged;
+    bool connected;
+    Option<Future<Nothing>> markingUnreachable;
+  };
+
+  void ping(Agent* agent)
   {
     PingSlaveMessage message;
-    message.set_connected(connected);
-    send(slave, message);
+    message.set_connected(agent->connected);
+    send(agent->pid, message);
+
+    agent->pinged = true;
+  }
+
+  void pong(const UPID& from)
+  {
+    if (!pids.contains(from)) {
+      return;
+    }
+
+    foreach (const SlaveID& slaveId, pids.at(from)) {
+      Agent& agent = agents.at(slaveId);
 
-    pinged = true;
-    delay(slavePingTimeout, self(), &SlaveObserver::timeout);
+      agent.timeouts = 0;
+      agent.pinged = false;
+
+      // Cancel any pending unreachable transitions.
+      if (agent.markingUnreachable.isSome()) {
+        // Need a copy for non-const access.
+        Future<Nothing> future = agent.markingUnreachable.get();
+        future.discard();
+      }
+    }
   }
 
-  void pong()
+  void advance()
   {
-    timeouts = 0;
-    pinged = false;
+    // Stop ticking until an agent gets added again.
+    if (agents.empty()) {
+      ticking = false;
+      return;
+    }
+
+    current = (current + 1) % SLOTS;
 
-    // Cancel any pending unreachable transitions.
-    if (markingUnreachable.isSome()) {
-      // Need a copy for non-const access.
-      Future<Nothing> future = markingUnreachable.get();
-      future.discard();
+    foreach (const SlaveID& slaveId, slots[current]) {
+      timeout(slaveId, &agents.at(slaveId));
     }
+
+    delay(tick, self(), &Self::advance);
   }
 
-  void timeout()
+  void timeout(const SlaveID& slaveId, Agent* agent)
   {
-    if (pinged) {
-      timeouts++; // No pong has been received before the timeout.
-      if (timeouts >= maxSlavePingTimeouts) {
+    if (agent->pinged) {
+      agent->timeouts++; // No pong has been received before the timeout.
+      if (agent->timeouts >= maxSlavePingTimeouts) {
         // No pong has been received for the last
         // 'maxSlavePingTimeouts' pings.
-        markUnreachable();
+        markUnreachable(slaveId, agent);
       }
     }
 
     // NOTE: We keep pinging even if we schedule a transition to
     // UNREACHABLE. This is because if the slave eventually responds
     // to a ping, we can cancel the UNREACHABLE transition.
-    ping();
+    ping(agent);
   }
 
   // Marking slaves unreachable is rate-limited and can be canceled if
@@ -239,9 +335,9 @@ protected:
   // agent reregisters, so a rate-limit is a useful safety
   // precaution. Once all frameworks are PARTITION_AWARE, we can
   // likely remove the rate-limit (MESOS-5948).
-  void markUnreachable()
+  void markUnreachable(const SlaveID& slaveId, Agent* agent)
   {
-    if (markingUnreachable.isSome()) {
+    if (agent->markingUnreachable.isSome()) {
       return; // Unreachable transition is already in progress.
     }
 
@@ -254,25 +350,36 @@ protected:
       acquire = limiter.get()->acquire();
     }
 
-    markingUnreachable = acquire.onAny(defer(self(), &Self::_markUnreachable));
+    agent->markingUnreachable = acquire.onAny(
+        defer(self(), &Self::_markUnreachable, slaveId, lambda::_1));
+
     ++metrics->slave_unreachable_scheduled;
   }
 
-  void _markUnreachable()
+  void _markUnreachable(const SlaveID& slaveId, const Future<Nothing>& future)
   {
-    CHECK_SOME(markingUnreachable);
-
-    const Future<Nothing>& future = markingUnreachable.get();
+    // Ignore the transition if the agent has been removed since, even
+    // if it has been added back.
+    if (!agents.contains(slaveId) ||
+        agents.at(slaveId).markingUnreachable.isNone() ||
+        agents.at(slaveId).markingUnreachable.get() != future) {
+      return;
+    }
 
     CHECK(!future.isFailed());
 
     if (future.isReady()) {
       ++metrics->slave_unreachable_completed;
 
-      dispatch(master,
-               &Master::markUnreachable,
-               slaveId,
-               "health check timed out");
+      // Coalesce the agents which become unreachable together, e.g.,
+      // the agents of a partitioned rack failing their health checks
+      // on the same tick, so that the master marks them unreachable
+      // within a single registry operation.
+      if (unreachable.empty()) {
+        dispatch(self(), &Self::__markUnreachable);
+      }
+
+      unreachable.push_back(slaveId);
     } else if (future.isDiscarded()) {
       LOG(INFO) << "Canceling transition of agent " << slaveId
                 << " to UNREACHABLE because a pong was received!";
@@ -280,25 +387,53 @@ protected:
       ++metrics->slave_unreachable_canceled;
     }
 
-    markingUnreachable = None();
+    agents.at(slaveId).markingUnreachable = None();
+  }
+
+  void __markUnreachable()
+  {
+    vector<SlaveID> slaveIds;
+    std::swap(slaveIds, unreachable);
+
+    if (slaveIds.size() == 1) {
+      dispatch(master,
+               &Master::markUnreachable,
+               slaveIds.front(),
+               "health check timed out");
+    } else if (!slaveIds.empty()) {
+      dispatch(master,
+               &Master::markSlavesUnreachable,
+               slaveIds,
+               "health check timed out");
+    }
   }
 
-private:
-  const UPID slave;
-  const SlaveInfo slaveInfo;
-  const SlaveID slaveId;
   const PID<Master> master;
   const Option<shared_ptr<RateLimiter>> limiter;
   shared_ptr<Metrics> metrics;
-  Option<Future<Nothing>> markingUnreachable;
-  const Duration slavePingTimeout;
+  const Duration tick;
   const size_t maxSlavePingTimeouts;
-  uint32_t timeouts;
-  bool pinged;
-  bool connected;
+
+  hashmap<SlaveID, Agent> agents;
+
+  // The agents by their pid, to look up the agents a pong is from.
+  hashmap<UPID, hashset<SlaveID>> pids;
+
+  // The agents of each slot, and the slot of the last tick.
+  vector<hashset<SlaveID>> slots;
+  size_t current;
+
+  bool ticking;
+
+  // The agents to mark unreachable once the pending transitions which
+  // completed together have been accounted for.
+  vector<SlaveID> unreachable;
 };
 
 
+constexpr size_t SlaveObserver::SLOTS;
+
+
 Master::Master(
     Allocator* _allocator,
     Registrar* _registrar,
@@ -318,7 +453,6 @@ Master::Master(
     detector(_detector),
     authorizer(_authorizer),
     frameworks(flags),
-    authenticator(None()),
     metrics(new Metrics(*this)),
     electedTime(None())
 {
@@ -436,12 +570,8 @@ void Framework::untrackUnderRole(const string& role)
   // to the role. We don't do this currently because this function is used in
   // `Master::removeFramework` where we're still subscribed to `roles`.
 
-  auto allocatedToRole = [&role](const Resource& resource) {
-    return resource.allocation_info().role() == role;
-  };
-
-  CHECK(totalUsedResources.filter(allocatedToRole).empty());
-  CHECK(totalOfferedResources.filter(allocatedToRole).empty());
+  CHECK(!usedResourcesByRole.contains(role));
+  CHECK(!offeredResourcesByRole.contains(role));
 
   master->roles.at(role)->removeFramework(this);
   if (master->roles.at(role)->frameworks.empty()) {
@@ -539,6 +669,19 @@ void Master::initialize()
     credentials = _credentials.get();
   }
 
+#ifdef USE_SSL_SOCKET
+  if (flags.authentication_token_secret_key.isSome()) {
+    Try<string> key = os::read(flags.authentication_token_secret_key.get());
+    if (key.isError()) {
+      EXIT(EXIT_FAILURE)
+        << "Failed to read the file specified by "
+        << "--authentication_token_secret_key: " << key.error();
+    }
+
+    authenticationTokenKey = key.get();
+  }
+#endif // USE_SSL_SOCKET
+
   // Extract authenticator names and validate them.
   authenticatorNames = strings::split(flags.authenticators, ",");
   if (authenticatorNames.empty()) {
@@ -557,44 +700,56 @@ void Master::initialize()
       << " (see --modules)";
   }
 
+  if (flags.authenticator_workers == 0) {
+    EXIT(EXIT_FAILURE) << "--authenticator_workers must be positive";
+  }
+
   // TODO(tillt): Allow multiple authenticators to be loaded and enable
   // the authenticatee to select the appropriate one. See MESOS-1939.
-  if (authenticatorNames[0] == DEFAULT_AUTHENTICATOR) {
-    LOG(INFO) << "Using default '" << DEFAULT_AUTHENTICATOR
-              << "' authenticator";
-    authenticator = new cram_md5::CRAMMD5Authenticator();
-  } else {
-    Try<Authenticator*> module =
-      modules::ModuleManager::create<Authenticator>(authenticatorNames[0]);
-    if (module.isError()) {
-      EXIT(EXIT_FAILURE)
-        << "Could not create authenticator module '"
-        << authenticatorNames[0] << "': " << module.error();
-    }
-    LOG(INFO) << "Using '" << authenticatorNames[0] << "' authenticator";
-    authenticator = module.get();
-  }
+  LOG(INFO) << "Using " << flags.authenticator_workers << " instance(s) of the "
+            << "'" << authenticatorNames[0] << "' authenticator";
 
-  // Give Authenticator access to credentials when needed.
-  CHECK_SOME(authenticator);
-  Try<Nothing> initialize = authenticator.get()->initialize(credentials);
-  if (initialize.isError()) {
-    const string error =
-      "Failed to initialize authenticator '" + authenticatorNames[0] +
-      "': " + initialize.error();
-    if (flags.authenticate_frameworks || flags.authenticate_agents) {
-      EXIT(EXIT_FAILURE)
-        << "Failed to start master with authentication enabled: " << error;
+  for (size_t i = 0; i < flags.authenticator_workers; i++) {
+    Authenticator* authenticator;
+    if (authenticatorNames[0] == DEFAULT_AUTHENTICATOR) {
+      authenticator = new cram_md5::CRAMMD5Authenticator();
     } else {
-      // A failure to initialize the authenticator does lead to
-      // unusable authentication but still allows non authenticating
-      // frameworks and slaves to connect.
-      LOG(WARNING) << "Only non-authenticating frameworks and agents are "
-                   << "allowed to connect. "
-                   << "Authentication is disabled: " << error;
-      delete authenticator.get();
-      authenticator = None();
+      Try<Authenticator*> module =
+        modules::ModuleManager::create<Authenticator>(authenticatorNames[0]);
+      if (module.isError()) {
+        EXIT(EXIT_FAILURE)
+          << "Could not create authenticator module '"
+          << authenticatorNames[0] << "': " << module.error();
+      }
+      authenticator = module.get();
+    }
+
+    // Give Authenticator access to credentials when needed.
+    Try<Nothing> initialize = authenticator->initialize(credentials);
+    if (initialize.isError()) {
+      const string error =
+        "Failed to initialize authenticator '" + authenticatorNames[0] +
+        "': " + initialize.error();
+      if (flags.authenticate_frameworks || flags.authenticate_agents) {
+        EXIT(EXIT_FAILURE)
+          << "Failed to start master with authentication enabled: " << error;
+      } else {
+        // A failure to initialize the authenticator does lead to
+        // unusable authentication but still allows non authenticating
+        // frameworks and slaves to connect.
+        LOG(WARNING) << "Only non-authenticating frameworks and agents are "
+                     << "allowed to connect. "
+                     << "Authentication is disabled: " << error;
+        delete authenticator;
+        foreach (Authenticator* _authenticator, authenticators) {
+          delete _authenticator;
+        }
+        authenticators.clear();
+        break;
+      }
     }
+
+    authenticators.push_back(authenticator);
   }
 
   if (flags.authenticate_http_readonly) {
@@ -758,6 +913,22 @@ void Master::initialize()
       << " for --offer_timeout: Must be greater than zero";
   }
 
+  if (flags.allocation_sweep_interval.isSome() &&
+      flags.allocation_sweep_interval.get() < flags.allocation_interval) {
+    EXIT(EXIT_FAILURE)
+      << "Invalid value '" << flags.allocation_sweep_interval.get() << "'"
+      << " for --allocation_sweep_interval: Must be at least"
+      << " --allocation_interval";
+  }
+
+  if (flags.max_allocation_interval.isSome() &&
+      flags.max_allocation_interval.get() < flags.allocation_interval) {
+    EXIT(EXIT_FAILURE)
+      << "Invalid value '" << flags.max_allocation_interval.get() << "'"
+      << " for --max_allocation_interval: Must be at least"
+      << " --allocation_interval";
+  }
+
   // Initialize the allocator.
   allocator->initialize(
       flags.allocation_interval,
@@ -765,7 +936,10 @@ void Master::initialize()
       defer(self(), &Master::inverseOffer, lambda::_1, lambda::_2),
       flags.fair_sharing_excluded_resource_names,
       flags.filter_gpu_resources,
-      flags.domain);
+      flags.domain,
+      flags.allocation_shards,
+      flags.allocation_sweep_interval,
+      flags.max_allocation_interval);
 
   // Parse the whitelist. Passing Allocator::updateWhitelist()
   // callback is safe because we shut down the whitelistWatcher in
@@ -780,6 +954,15 @@ void Master::initialize()
       });
   spawn(whitelistWatcher);
 
+  slaveObserver = new SlaveObserver(
+      self(),
+      slaves.limiter,
+      metrics,
+      flags.agent_ping_timeout,
+      flags.max_agent_ping_timeouts);
+
+  spawn(slaveObserver);
+
   nextFrameworkId = 0;
   nextSlaveId = 0;
   nextOfferId = 0;
@@ -866,6 +1049,9 @@ void Master::initialize()
       &StatusUpdateMessage::update,
       &StatusUpdateMessage::pid);
 
+  install<StatusUpdatesMessage>(
+      &Master::statusUpdates);
+
   // Added in 0.24.0 to support HTTP schedulers. Since
   // these do not have a pid, the slave must forward
   // messages through the master.
@@ -895,7 +1081,8 @@ void Master::initialize()
 
   install<AuthenticateMessage>(
       &Master::authenticate,
-      &AuthenticateMessage::pid);
+      &AuthenticateMessage::pid,
+      &AuthenticateMessage::token);
 
   // Setup HTTP routes.
   route("/api/v1",
@@ -1144,6 +1331,16 @@ void Master::initialize()
     .onAny(defer(self(), &Master::contended, lambda::_1));
   detector->detect()
     .onAny(defer(self(), &Master::detected, lambda::_1));
+
+  if (flags.standby_state_refresh_interval.isSome()) {
+    delay(flags.standby_state_refresh_interval.get(),
+          self(),
+          &Master::refreshStandbyViews);
+  }
+
+  if (flags.state_snapshot_dir.isSome()) {
+    delay(flags.state_snapshot_interval, self(), &Master::snapshotState);
+  }
 }
 
 
@@ -1195,11 +1392,6 @@ void Master::finalize()
     // recovering the resources in the allocator.
     slave->pendingTasks.clear();
 
-    // Terminate the slave observer.
-    terminate(slave->observer);
-    wait(slave->observer);
-
-    delete slave->observer;
     delete slave;
   }
   slaves.registered.clear();
@@ -1264,9 +1456,14 @@ void Master::finalize()
   wait(whitelistWatcher);
   delete whitelistWatcher;
 
-  if (authenticator.isSome()) {
-    delete authenticator.get();
+  terminate(slaveObserver);
+  wait(slaveObserver);
+  delete slaveObserver;
+
+  foreach (Authenticator* authenticator, authenticators) {
+    delete authenticator;
   }
+  authenticators.clear();
 }
 
 
@@ -1466,6 +1663,25 @@ Future<bool> Master::authorizeLogAccess(const Option<Principal>& principal)
 }
 
 
+void Master::serve(Event&& event)
+{
+  // Apart from `GET` requests, any event might change the state of the
+  // master, which invalidates the cached views of the master.
+  if (!event.is<HttpEvent>() ||
+      event.as<HttpEvent>().request->method != "GET") {
+    generation++;
+  }
+
+  ProtobufProcess<Master>::serve(std::move(event));
+
+  // Agent (re-)registrations finish in many places, so rather than
+  // in each of them, we admit any queued agents after every event.
+  if (!slaves.admissions.empty()) {
+    admitAgents();
+  }
+}
+
+
 void Master::consume(MessageEvent&& event)
 {
   // There are three cases about the message's UPID with respect to
@@ -1703,8 +1919,16 @@ Future<Nothing> Master::recover()
 
 Future<Nothing> Master::_recover(const Registry& registry)
 {
+  // The registry can hold tens of thousands of agents, so size the
+  // tables upfront rather than rehashing them as the agents get added.
+  slaves.recovered.reserve(registry.slaves().slaves_size());
+  machines.reserve(registry.machines().machines_size());
+  quotas.reserve(registry.quotas_size());
+
   foreach (const Registry::Slave& slave, registry.slaves().slaves()) {
-    SlaveInfo slaveInfo = slave.info();
+    // Copy the `SlaveInfo` into the table once and convert it there.
+    SlaveInfo& slaveInfo = slaves.recovered[slave.info().id()];
+    slaveInfo.CopyFrom(slave.info());
 
     // We store the `SlaveInfo`'s resources in the `pre-reservation-refinement`
     // in order to support downgrades. We convert them back to `post-` format
@@ -1712,8 +1936,6 @@ Future<Nothing> Master::_recover(const Registry& registry)
     // resources within master memory.
     convertResourceFormat(
       slaveInfo.mutable_resources(), POST_RESERVATION_REFINEMENT);
-
-    slaves.recovered.put(slaveInfo.id(), slaveInfo);
   }
 
   foreach (const Registry::UnreachableSlave& unreachable,
@@ -1783,6 +2005,9 @@ Future<Nothing> Master::_recover(const Registry& registry)
       weights.clear();
     }
 
+    weightInfos.reserve(registry.weights_size());
+    weights.reserve(registry.weights_size());
+
     foreach (const Registry::Weight& weight, registry.weights()) {
       WeightInfo weightInfo;
       weightInfo.set_role(weight.info().role());
@@ -2207,6 +2432,9 @@ void Master::detected(const Future<Option<MasterInfo>>& _leader)
   bool wasElected = elected();
   leader = _leader.get();
 
+  // The copies of the views of the previous leader are outdated.
+  standbyViews.clear();
+
   if (elected()) {
     electedTime = Clock::now();
 
@@ -2769,7 +2997,7 @@ void Master::_subscribe(
     // Start the heartbeat after sending SUBSCRIBED event.
     framework->heartbeat();
 
-    if (!subscribers.subscribed.empty()) {
+    if (subscribers.active()) {
       subscribers.send(
           protobuf::master::event::createFrameworkAdded(*framework));
     }
@@ -2820,7 +3048,7 @@ void Master::_subscribe(
     }
   }
 
-  if (!subscribers.subscribed.empty()) {
+  if (subscribers.active()) {
     subscribers.send(
         protobuf::master::event::createFrameworkUpdated(*framework));
   }
@@ -3074,7 +3302,7 @@ void Master::_subscribe(
     message.mutable_master_info()->MergeFrom(info_);
     framework->send(message);
 
-    if (!subscribers.subscribed.empty()) {
+    if (subscribers.active()) {
       subscribers.send(
           protobuf::master::event::createFrameworkAdded(*framework));
     }
@@ -3151,7 +3379,7 @@ void Master::_subscribe(
       LOG(INFO) << "Framework " << *framework << " failed over";
       failoverFramework(framework, from);
 
-      if (!subscribers.subscribed.empty()) {
+      if (subscribers.active()) {
         subscribers.send(
             protobuf::master::event::createFrameworkUpdated(*framework));
       }
@@ -3203,7 +3431,7 @@ void Master::_subscribe(
       message.mutable_master_info()->MergeFrom(info_);
       framework->send(message);
 
-      if (!subscribers.subscribed.empty()) {
+      if (subscribers.active()) {
         subscribers.send(
             protobuf::master::event::createFrameworkUpdated(*framework));
       }
@@ -3224,7 +3452,7 @@ void Master::_subscribe(
       return;
     }
 
-    if (!subscribers.subscribed.empty()) {
+    if (subscribers.active()) {
       subscribers.send(
           protobuf::master::event::createFrameworkUpdated(*framework));
     }
@@ -3371,7 +3599,7 @@ void Master::disconnect(Slave* slave)
   slave->connected = false;
 
   // Inform the slave observer.
-  dispatch(slave->observer, &SlaveObserver::disconnect);
+  dispatch(slaveObserver, &SlaveObserver::disconnect, slave->id);
 
   // Remove the slave from authenticated. This is safe because
   // a slave will always reauthenticate before (re-)registering.
@@ -5199,14 +5427,24 @@ void Master::_accept(
             << _offeredResources << " does not contain " << consumed;
 
           _offeredResources -= consumed;
+        }
 
-          if (HookManager::hooksAvailable()) {
-            // Set labels retrieved from label-decorator hooks.
-            task.mutable_labels()->CopyFrom(
-                HookManager::masterLaunchTaskLabelDecorator(
-                    task,
-                    framework->info,
-                    slave->info));
+        if (HookManager::hooksAvailable()) {
+          // Set labels retrieved from label-decorator hooks, decorating
+          // all the tasks of the group in a single batch.
+          const vector<Labels> labels =
+            HookManager::masterLaunchTaskLabelDecorator(
+                vector<TaskInfo>(
+                    message.task_group().tasks().begin(),
+                    message.task_group().tasks().end()),
+                framework->info,
+                slave->info);
+
+          CHECK_EQ(labels.size(), (size_t) message.task_group().tasks_size());
+
+          for (int i = 0; i < message.task_group().tasks_size(); ++i) {
+            message.mutable_task_group()->mutable_tasks(i)->mutable_labels()
+              ->CopyFrom(labels[i]);
           }
         }
 
@@ -5490,15 +5728,16 @@ void Master::decline(
 
   ++metrics->messages_decline_offers;
 
-  //  Return resources to the allocator.
+  // The declined resources, keyed by the framework and the agent they
+  // were offered to. These are returned to the allocator at once,
+  // since frameworks may decline many offers in a single call.
+  hashmap<FrameworkID, hashmap<SlaveID, Resources>> declined;
+
   foreach (const OfferID& offerId, decline.offer_ids()) {
     Offer* offer = getOffer(offerId);
     if (offer != nullptr) {
-      allocator->recoverResources(
-          offer->framework_id(),
-          offer->slave_id(),
-          offer->resources(),
-          decline.filters());
+      declined[offer->framework_id()][offer->slave_id()] +=
+        offer->resources();
 
       removeOffer(offer);
       continue;
@@ -5509,6 +5748,12 @@ void Master::decline(
     LOG(WARNING) << "Ignoring decline of offer " << offerId
                  << " since it is no longer valid";
   }
+
+  //  Return resources to the allocator.
+  foreachkey (const FrameworkID& frameworkId, declined) {
+    allocator->batchRecoverResources(
+        frameworkId, declined.at(frameworkId), decline.filters());
+  }
 }
 
 
@@ -5885,9 +6130,56 @@ void Master::acknowledge(
   message.mutable_task_id()->CopyFrom(taskId);
   message.set_uuid(uuid.toBytes());
 
-  send(slave->pid, message);
-
   metrics->valid_status_update_acknowledgements++;
+
+  const Duration interval = flags.status_update_acknowledgement_flush_interval;
+
+  if (interval == Duration::zero() ||
+      !slave->capabilities.statusUpdateBatches) {
+    send(slave->pid, message);
+    return;
+  }
+
+  *slave->acknowledgements.add_acknowledgements() = std::move(message);
+
+  if (slave->acknowledgements.acknowledgements_size() >=
+        static_cast<int>(MAX_STATUS_UPDATE_ACKNOWLEDGEMENT_BATCH_SIZE)) {
+    flushAcknowledgements(slaveId);
+  } else if (!slave->flushingAcknowledgements) {
+    slave->flushingAcknowledgements = true;
+    delay(interval, self(), &Master::flushAcknowledgements, slaveId);
+  }
+}
+
+
+void Master::flushAcknowledgements(const SlaveID& slaveId)
+{
+  Slave* slave = slaves.registered.get(slaveId);
+
+  if (slave == nullptr) {
+    return;
+  }
+
+  // NOTE: Any pending `delay()` still fires, but then finds fewer (or
+  // no) acknowledgements to forward, which is harmless.
+  slave->flushingAcknowledgements = false;
+
+  if (slave->acknowledgements.acknowledgements_size() == 0) {
+    return;
+  }
+
+  // The agent retries the updates of acknowledgements that don't make
+  // it, so we can drop them if the agent got disconnected meanwhile.
+  if (slave->connected) {
+    send(slave->pid, slave->acknowledgements);
+  } else {
+    LOG(WARNING) << "Dropping "
+                 << slave->acknowledgements.acknowledgements_size()
+                 << " status update acknowledgements for disconnected agent "
+                 << *slave;
+  }
+
+  slave->acknowledgements.Clear();
 }
 
 
@@ -6087,6 +6379,18 @@ void Master::registerSlave(
     return;
   }
 
+  if (!admitAgent(from, slaveInfo, false, [=]() {
+        registerSlave(
+            from,
+            slaveInfo,
+            checkpointedResources,
+            version,
+            agentCapabilities,
+            resourceVersions);
+      })) {
+    return;
+  }
+
   LOG(INFO) << "Received register agent message from "
             << from << " (" << slaveInfo.hostname() << ")";
 
@@ -6195,12 +6499,16 @@ void Master::_registerSlave(
     LOG(WARNING) << "Failed to parse version '" << version << "'"
                  << " of agent at " << pid << ": " << parsedVersion.error()
                  << "; ignoring agent registration attempt";
+
+    slaves.registering.erase(pid);
     return;
   } else if (parsedVersion.get() < MINIMUM_AGENT_VERSION) {
     LOG(WARNING) << "Ignoring registration attempt from old agent at "
                  << pid << ": agent version is " << parsedVersion.get()
                  << ", minimum supported agent version is "
                  << MINIMUM_AGENT_VERSION;
+
+    slaves.registering.erase(pid);
     return;
   }
 
@@ -6215,6 +6523,8 @@ void Master::_registerSlave(
                  << "domain " << slaveInfo.domain() << " "
                  << "but the master has no configured domain. "
                  << "Ignoring agent registration attempt";
+
+    slaves.registering.erase(pid);
     return;
   }
 
@@ -6420,6 +6730,12 @@ void Master::reregisterSlave(
     return;
   }
 
+  if (!admitAgent(from, slaveInfo, true, [=]() mutable {
+        reregisterSlave(from, std::move(reregisterSlaveMessage));
+      })) {
+    return;
+  }
+
   LOG(INFO) << "Received re-register agent message from agent "
             << slaveInfo.id() << " at " << from << " ("
             << slaveInfo.hostname() << ")";
@@ -6455,6 +6771,89 @@ void Master::reregisterSlave(
 }
 
 
+bool Master::admitAgent(
+    const UPID& pid,
+    const SlaveInfo& slaveInfo,
+    bool reregistering,
+    lambda::function<void()>&& admit)
+{
+  if (flags.max_concurrent_agent_admissions.isNone()) {
+    return true;
+  }
+
+  // NOTE: Since queued agents are admitted after every event (see
+  // `serve()`), there is only room for another (re-)registration
+  // while agents are queued if a queued agent is being admitted.
+  const size_t admitting =
+    slaves.registering.size() + slaves.reregistering.size();
+
+  if (admitting < flags.max_concurrent_agent_admissions.get()) {
+    return true;
+  }
+
+  if (slaves.admissions.contains(pid)) {
+    // The agent keeps its place in the queue, but we retry its latest
+    // (re-)registration attempt once its turn comes.
+    slaves.admissions.at(pid).admit = std::move(admit);
+  } else {
+    double priority = 0.0;
+
+    if (flags.agent_admission_priority_attribute.isSome()) {
+      foreach (const Attribute& attribute, slaveInfo.attributes()) {
+        if (attribute.name() ==
+              flags.agent_admission_priority_attribute.get() &&
+            attribute.type() == Value::SCALAR) {
+          priority = attribute.scalar().value();
+          break;
+        }
+      }
+    }
+
+    Slaves::Admission admission;
+    admission.key =
+      std::make_tuple(-priority, !reregistering, slaves.admissionSequence++);
+    admission.admit = std::move(admit);
+
+    slaves.admissionOrder[admission.key] = pid;
+    slaves.admissions[pid] = std::move(admission);
+  }
+
+  LOG(INFO) << "Queuing "
+            << (reregistering ? "re-registration" : "registration")
+            << " of agent at " << pid << " (" << slaveInfo.hostname() << ")"
+            << " because " << admitting << " agent (re-)registrations are"
+            << " already in progress";
+
+  SlaveAdmissionBackoffMessage message;
+  message.set_retry_after_seconds(flags.agent_admission_retry_interval.secs());
+  send(pid, message);
+
+  return false;
+}
+
+
+void Master::admitAgents()
+{
+  CHECK_SOME(flags.max_concurrent_agent_admissions);
+
+  while (!slaves.admissionOrder.empty() &&
+         slaves.registering.size() + slaves.reregistering.size() <
+           flags.max_concurrent_agent_admissions.get()) {
+    const UPID pid = slaves.admissionOrder.begin()->second;
+    slaves.admissionOrder.erase(slaves.admissionOrder.begin());
+
+    lambda::function<void()> admit =
+      std::move(slaves.admissions.at(pid).admit);
+
+    slaves.admissions.erase(pid);
+
+    VLOG(1) << "Admitting queued agent at " << pid;
+
+    admit();
+  }
+}
+
+
 void Master::_reregisterSlave(
     const UPID& pid,
     ReregisterSlaveMessage&& reregisterSlaveMessage,
@@ -6496,6 +6895,8 @@ void Master::_reregisterSlave(
       << "Ignoring re-register agent message from agent "
       << slaveInfo.id() << " at " << pid << " ("
       << slaveInfo.hostname() << ") as a gone operation is already in progress";
+
+    slaves.reregistering.erase(slaveInfo.id());
     return;
   }
 
@@ -6506,6 +6907,8 @@ void Master::_reregisterSlave(
     ShutdownMessage message;
     message.set_message("Agent has been marked gone");
     send(pid, message);
+
+    slaves.reregistering.erase(slaveInfo.id());
     return;
   }
 
@@ -6542,12 +6945,16 @@ void Master::_reregisterSlave(
     LOG(WARNING) << "Failed to parse version '" << version << "'"
                  << " of agent at " << pid << ": " << parsedVersion.error()
                  << "; ignoring agent re-registration attempt";
+
+    slaves.reregistering.erase(slaveInfo.id());
     return;
   } else if (parsedVersion.get() < MINIMUM_AGENT_VERSION) {
     LOG(WARNING) << "Ignoring re-registration attempt from old agent at "
                  << pid << ": agent version is " << parsedVersion.get()
                  << ", minimum supported agent version is "
                  << MINIMUM_AGENT_VERSION;
+
+    slaves.reregistering.erase(slaveInfo.id());
     return;
   }
 
@@ -6562,6 +6969,26 @@ void Master::_reregisterSlave(
                  << "domain " << slaveInfo.domain() << " "
                  << "but the master has no configured domain."
                  << "Ignoring agent re-registration attempt";
+
+    slaves.reregistering.erase(slaveInfo.id());
+    return;
+  }
+
+  // Digests of the tasks and executors of frameworks are of no use to
+  // a master that does not know about the agent's tasks, e.g., after
+  // a master failover or when the agent was unreachable, so we ask the
+  // agent to re-register with all of its tasks and executors instead.
+  if (reregisterSlaveMessage.framework_digests_size() > 0 &&
+      !slaves.registered.contains(slaveInfo.id())) {
+    LOG(INFO) << "Asking agent " << slaveInfo.id() << " at " << pid
+              << " (" << slaveInfo.hostname() << ") to re-register with"
+              << " all of its tasks and executors";
+
+    ReregisterSlaveDetailsMessage message;
+    message.mutable_slave_id()->CopyFrom(slaveInfo.id());
+    send(pid, message);
+
+    slaves.reregistering.erase(slaveInfo.id());
     return;
   }
 
@@ -6687,6 +7114,8 @@ void Master::__reregisterSlave(
       << "Ignoring re-register agent message from agent "
       << slaveInfo.id() << " at " << pid << " ("
       << slaveInfo.hostname() << ") as a gone operation is already in progress";
+
+    slaves.reregistering.erase(slaveInfo.id());
     return;
   }
 
@@ -6697,6 +7126,8 @@ void Master::__reregisterSlave(
     ShutdownMessage message;
     message.set_message("Agent has been marked gone");
     send(pid, message);
+
+    slaves.reregistering.erase(slaveInfo.id());
     return;
   }
 
@@ -6805,6 +7236,8 @@ void Master::__reregisterSlave(
   // master (those tasks were previously marked "unreachable", so they
   // should be removed from that collection).
   vector<Task> recoveredTasks;
+  recoveredTasks.reserve(reregisterSlaveMessage.tasks_size());
+
   foreach (Task& task, *reregisterSlaveMessage.mutable_tasks()) {
     const FrameworkID& frameworkId = task.framework_id();
 
@@ -6920,6 +7353,8 @@ void Master::___reregisterSlave(
       << "Ignoring re-register agent message from agent "
       << slaveInfo.id() << " at " << pid << " ("
       << slaveInfo.hostname() << ") as a gone operation is already in progress";
+
+    slaves.reregistering.erase(slaveInfo.id());
     return;
   }
 
@@ -6930,6 +7365,8 @@ void Master::___reregisterSlave(
     ShutdownMessage message;
     message.set_message("Agent has been marked gone");
     send(pid, message);
+
+    slaves.reregistering.erase(slaveInfo.id());
     return;
   }
 
@@ -6948,34 +7385,94 @@ void Master::___reregisterSlave(
 
   Slave* slave = slaves.registered.get(slaveInfo.id());
 
-  // Update the slave pid and relink to it.
-  // NOTE: Re-linking the slave here always rather than only when
-  // the slave is disconnected can lead to multiple exited events
-  // in succession for a disconnected slave. As a result, we
-  // ignore duplicate exited events for disconnected slaves.
-  // See: https://issues.apache.org/jira/browse/MESOS-675
-  slave->pid = pid;
-  link(slave->pid);
+  vector<ExecutorInfo> executorInfos =
+    google::protobuf::convert(reregisterSlaveMessage.executor_infos());
+  vector<Task> tasks =
+    google::protobuf::convert(reregisterSlaveMessage.tasks());
 
-  const string& version = reregisterSlaveMessage.version();
-  const vector<SlaveInfo::Capability> agentCapabilities =
-    google::protobuf::convert(reregisterSlaveMessage.agent_capabilities());
-  const vector<ResourceVersionUUID> resourceVersions =
-    google::protobuf::convert(reregisterSlaveMessage.resource_version_uuids());
+  // For the frameworks that the agent only sent digests of, we use our
+  // own view of their tasks and executors if it matches the digest,
+  // and otherwise ask the agent to re-register with them.
+  if (reregisterSlaveMessage.framework_digests_size() > 0) {
+    ReregisterSlaveDetailsMessage message;
+    message.mutable_slave_id()->CopyFrom(slave->id);
 
-  Try<Nothing> stateUpdated =
-    slave->update(slaveInfo, version, agentCapabilities, resourceVersions);
+    foreach (const ReregisterSlaveMessage::FrameworkDigest& digest,
+             reregisterSlaveMessage.framework_digests()) {
+      const FrameworkID& frameworkId = digest.framework_id();
 
-  // As of now, the only way `slave->update()` can fail is if the agent sent
-  // different checkpointed resources than it had before. A well-behaving
-  // agent shouldn't do this, so this one is either malicious or buggy. Either
-  // way, we refuse the re-registration attempt.
-  if (stateUpdated.isError()) {
-    LOG(WARNING) << "Refusing re-registration of agent " << slaveInfo.id()
-                 << " at " << pid << " (" << slaveInfo.hostname() << ")"
-                 << " because state update failed: " << stateUpdated.error();
+      vector<TaskID> taskIds;
+      vector<ExecutorID> executorIds;
 
-    ShutdownMessage message;
+      if (slave->tasks.contains(frameworkId)) {
+        foreachkey (const TaskID& taskId, slave->tasks.at(frameworkId)) {
+          taskIds.push_back(taskId);
+        }
+      }
+
+      if (slave->executors.contains(frameworkId)) {
+        foreachkey (const ExecutorID& executorId,
+                    slave->executors.at(frameworkId)) {
+          executorIds.push_back(executorId);
+        }
+      }
+
+      if (digest.digest() !=
+            protobuf::slave::createFrameworkDigest(taskIds, executorIds)) {
+        message.add_framework_ids()->CopyFrom(frameworkId);
+        continue;
+      }
+
+      foreach (const TaskID& taskId, taskIds) {
+        tasks.push_back(*slave->tasks.at(frameworkId).at(taskId));
+      }
+
+      foreach (const ExecutorID& executorId, executorIds) {
+        executorInfos.push_back(
+            slave->executors.at(frameworkId).at(executorId));
+      }
+    }
+
+    if (message.framework_ids_size() > 0) {
+      LOG(INFO) << "Asking agent " << *slave << " to re-register with the"
+                << " tasks and executors of " << message.framework_ids_size()
+                << " framework(s) whose digests do not match";
+
+      send(pid, message);
+
+      slaves.reregistering.erase(slaveInfo.id());
+      return;
+    }
+  }
+
+  // Update the slave pid and relink to it.
+  // NOTE: Re-linking the slave here always rather than only when
+  // the slave is disconnected can lead to multiple exited events
+  // in succession for a disconnected slave. As a result, we
+  // ignore duplicate exited events for disconnected slaves.
+  // See: https://issues.apache.org/jira/browse/MESOS-675
+  slave->pid = pid;
+  link(slave->pid);
+
+  const string& version = reregisterSlaveMessage.version();
+  const vector<SlaveInfo::Capability> agentCapabilities =
+    google::protobuf::convert(reregisterSlaveMessage.agent_capabilities());
+  const vector<ResourceVersionUUID> resourceVersions =
+    google::protobuf::convert(reregisterSlaveMessage.resource_version_uuids());
+
+  Try<Nothing> stateUpdated =
+    slave->update(slaveInfo, version, agentCapabilities, resourceVersions);
+
+  // As of now, the only way `slave->update()` can fail is if the agent sent
+  // different checkpointed resources than it had before. A well-behaving
+  // agent shouldn't do this, so this one is either malicious or buggy. Either
+  // way, we refuse the re-registration attempt.
+  if (stateUpdated.isError()) {
+    LOG(WARNING) << "Refusing re-registration of agent " << slaveInfo.id()
+                 << " at " << pid << " (" << slaveInfo.hostname() << ")"
+                 << " because state update failed: " << stateUpdated.error();
+
+    ShutdownMessage message;
     message.set_message(stateUpdated.error());
     send(pid, message);
 
@@ -6991,10 +7488,6 @@ void Master::___reregisterSlave(
     slave->totalResources,
     agentCapabilities);
 
-  const vector<ExecutorInfo> executorInfos =
-    google::protobuf::convert(reregisterSlaveMessage.executor_infos());
-  const vector<Task> tasks =
-    google::protobuf::convert(reregisterSlaveMessage.tasks());
   const vector<FrameworkInfo> frameworks =
     google::protobuf::convert(reregisterSlaveMessage.frameworks());
 
@@ -7011,7 +7504,7 @@ void Master::___reregisterSlave(
     Clock::cancel(slave->reregistrationTimer.get());
 
     slave->connected = true;
-    dispatch(slave->observer, &SlaveObserver::reconnect);
+    dispatch(slaveObserver, &SlaveObserver::reconnect, slave->id);
 
     slave->active = true;
     allocator->activateSlave(slave->id);
@@ -7249,11 +7742,10 @@ void Master::updateSlave(const UpdateSlaveMessage& message)
         slave->totalResources.revocable().filter(agentResources)) +
     newResourceProviderResources;
 
-  // TODO(bbannier): We only need to update if any changes from
-  // resource providers are reported.
-  bool updated =
-    slave->totalResources != newSlaveResources ||
-    message.has_resource_providers();
+  // NOTE: Changes of resource providers are reflected in the total
+  // resources, the resource versions or the offer operations below,
+  // so an update reporting the same state of them is ignored.
+  bool updated = slave->totalResources != newSlaveResources;
 
   // Agents which can support resource providers always update the
   // master on their resource versions uuid via `UpdateSlaveMessage`.
@@ -7532,6 +8024,15 @@ void Master::updateSlave(const UpdateSlaveMessage& message)
     }
   }
 
+  const Resources oldSlaveResources = slave->totalResources;
+
+  // The resource providers whose total resources changed, for which
+  // the outstanding offers need to be rescinded. All outstanding offers
+  // are rescinded if a resource provider was added, so that frameworks
+  // get offered its resources along with the ones of the agent.
+  hashset<ResourceProviderID> updatedResourceProviders;
+  bool addedResourceProvider = false;
+
   // Update master and allocator state.
   foreachpair (
       const Option<ResourceProviderID>& providerId,
@@ -7593,6 +8094,8 @@ void Master::updateSlave(const UpdateSlaveMessage& message)
           slaveId,
           provider.newTotal.get(),
           usedByOperations);
+
+      addedResourceProvider = true;
     } else {
       // If this is a known resource provider or agent its total capacity cannot
       // have changed, and it would not know about any non-terminal offer
@@ -7635,11 +8138,28 @@ void Master::updateSlave(const UpdateSlaveMessage& message)
       if (provider.newTotal.isSome()) {
         slave->totalResources += provider.newTotal.get();
       }
+
+      if (providerId.isSome() && provider.oldTotal != provider.newTotal) {
+        updatedResourceProviders.insert(providerId.get());
+      }
     }
   }
 
   // Now update the agent's state and total resources in the allocator.
-  allocator->updateSlave(slaveId, slave->info, slave->totalResources);
+  //
+  // NOTE: Updates which only change the resource versions or the offer
+  // operations do not need to update the allocator.
+  if (slave->totalResources != oldSlaveResources) {
+    allocator->updateSlave(slaveId, slave->info, slave->totalResources);
+  }
+
+  // Outstanding revocable offers only need to be rescinded when the
+  // agent's revocable resources shrink: when they merely grow, the
+  // offered revocable resources remain available and the allocator
+  // offers the additional ones separately.
+  const bool revocableShrunk =
+    !slave->totalResources.revocable().contains(
+        oldSlaveResources.revocable());
 
   // Then rescind outstanding offers affected by the update.
   // NOTE: Need a copy of offers because the offers are removed inside the loop.
@@ -7650,7 +8170,7 @@ void Master::updateSlave(const UpdateSlaveMessage& message)
     // Since updates of the agent's oversubscribed resources are sent at regular
     // intervals, we only rescind offers containing revocable resources to
     // reduce churn.
-    if (hasOversubscribed && !offered.revocable().empty()) {
+    if (hasOversubscribed && revocableShrunk && !offered.revocable().empty()) {
       LOG(INFO) << "Removing offer " << offer->id()
                 << " with revocable resources " << offered << " on agent "
                 << *slave;
@@ -7659,15 +8179,23 @@ void Master::updateSlave(const UpdateSlaveMessage& message)
     }
 
     // Updates on resource providers can change the agent total
-    // resources, so we rescind all offers.
-    //
-    // TODO(bbannier): Only rescind offers possibly containing
-    // affected resources.
-    if (message.has_resource_providers()) {
-      LOG(INFO) << "Removing offer " << offer->id() << " with resources "
-                << offered << " on agent " << *slave;
+    // resources, so we rescind the offers containing resources of the
+    // resource providers whose total resources changed.
+    if (!rescind) {
+      rescind = addedResourceProvider;
 
-      rescind = true;
+      foreach (const Resource& resource, offered) {
+        if (Resources::hasResourceProvider(resource) &&
+            updatedResourceProviders.contains(resource.provider_id())) {
+          rescind = true;
+          break;
+        }
+      }
+
+      if (rescind) {
+        LOG(INFO) << "Removing offer " << offer->id() << " with resources "
+                  << offered << " on agent " << *slave;
+      }
     }
 
     if (!rescind) {
@@ -7762,6 +8290,26 @@ void Master::updateUnavailability(
 // because the status updates will be sent by the slave.
 //
 // TODO(vinod): Add a benchmark test for status update handling.
+void Master::statusUpdates(
+    const UPID& from,
+    StatusUpdatesMessage&& statusUpdatesMessage)
+{
+  foreach (StatusUpdateMessage& message,
+           *statusUpdatesMessage.mutable_updates()) {
+    const UPID pid(message.pid());
+
+    if (pid == UPID()) {
+      LOG(WARNING) << "Ignoring status update " << message.update()
+                   << " from " << from << " without a valid agent pid";
+      ++metrics->invalid_status_updates;
+      continue;
+    }
+
+    statusUpdate(std::move(*message.mutable_update()), pid);
+  }
+}
+
+
 void Master::statusUpdate(StatusUpdate update, const UPID& pid)
 {
   CHECK_NE(pid, UPID());
@@ -8094,20 +8642,16 @@ void Master::shutdown(
 }
 
 
-// TODO(neilc): Refactor to reduce code duplication with
-// `Master::removeSlave`.
-void Master::markUnreachable(const SlaveID& slaveId, const string& message)
+bool Master::canMarkUnreachable(const SlaveID& slaveId)
 {
-  Slave* slave = slaves.registered.get(slaveId);
-
-  if (slave == nullptr) {
+  if (!slaves.registered.contains(slaveId)) {
     // Possible when the `SlaveObserver` dispatches a message to mark an
     // unhealthy slave as unreachable, but the slave is concurrently
     // removed for another reason (e.g., `UnregisterSlaveMessage` is
     // received).
     LOG(WARNING) << "Unable to mark unknown agent "
                  << slaveId << " unreachable";
-    return;
+    return false;
   }
 
   if (slaves.markingUnreachable.contains(slaveId)) {
@@ -8122,35 +8666,50 @@ void Master::markUnreachable(const SlaveID& slaveId, const string& message)
     LOG(WARNING) << "Not marking agent " << slaveId
                  << " unreachable because another unreachable"
                  << " transition is already in progress";
-    return;
+    return false;
   }
 
   if (slaves.removing.contains(slaveId)) {
     LOG(WARNING) << "Not marking agent " << slaveId
                  << " unreachable because it is unregistering";
-    return;
+    return false;
   }
 
   if (slaves.markingGone.contains(slaveId)) {
     LOG(INFO) << "Canceling transition of agent " << slaveId
               << " to unreachable because an agent gone"
               << " operation is in progress";
-    return;
+    return false;
   }
 
   if (slaves.gone.contains(slaveId)) {
     LOG(INFO) << "Canceling transition of agent " << slaveId
               << " to unreachable because the agent has"
               << " been marked gone";
+    return false;
+  }
+
+  CHECK(!slaves.unreachable.contains(slaveId));
+  CHECK(slaves.removed.get(slaveId).isNone());
+
+  return true;
+}
+
+
+// TODO(neilc): Refactor to reduce code duplication with
+// `Master::removeSlave`.
+void Master::markUnreachable(const SlaveID& slaveId, const string& message)
+{
+  if (!canMarkUnreachable(slaveId)) {
     return;
   }
 
+  Slave* slave = slaves.registered.get(slaveId);
+  CHECK_NOTNULL(slave);
+
   LOG(INFO) << "Marking agent " << *slave
             << " unreachable: " << message;
 
-  CHECK(!slaves.unreachable.contains(slaveId));
-  CHECK(slaves.removed.get(slaveId).isNone());
-
   slaves.markingUnreachable.insert(slave->id);
 
   // Use the same timestamp for all status updates sent below; we also
@@ -8165,7 +8724,52 @@ void Master::markUnreachable(const SlaveID& slaveId, const string& message)
           new MarkSlaveUnreachable(slave->info, unreachableTime)))
     .onAny(defer(self(),
                  &Self::_markUnreachable,
-                 slave,
+                 vector<Slave*>{slave},
+                 unreachableTime,
+                 message,
+                 lambda::_1));
+}
+
+
+void Master::markSlavesUnreachable(
+    const vector<SlaveID>& slaveIds,
+    const string& message)
+{
+  vector<Slave*> slaves_;
+  vector<SlaveInfo> infos;
+
+  foreach (const SlaveID& slaveId, slaveIds) {
+    // NOTE: We also skip duplicates here, since the first occurrence
+    // is already being marked unreachable once it has been seen.
+    if (!canMarkUnreachable(slaveId)) {
+      continue;
+    }
+
+    Slave* slave = slaves.registered.get(slaveId);
+    CHECK_NOTNULL(slave);
+
+    LOG(INFO) << "Marking agent " << *slave
+              << " unreachable: " << message;
+
+    slaves.markingUnreachable.insert(slave->id);
+
+    slaves_.push_back(slave);
+    infos.push_back(slave->info);
+  }
+
+  if (slaves_.empty()) {
+    return;
+  }
+
+  TimeInfo unreachableTime = protobuf::getCurrentTime();
+
+  // Move all the slaves to the list of unreachable slaves within a
+  // single registry operation, see `markUnreachable` above.
+  registrar->apply(Owned<Operation>(
+          new MarkSlavesUnreachable(infos, unreachableTime)))
+    .onAny(defer(self(),
+                 &Self::_markUnreachable,
+                 slaves_,
                  unreachableTime,
                  message,
                  lambda::_1));
@@ -8173,34 +8777,38 @@ void Master::markUnreachable(const SlaveID& slaveId, const string& message)
 
 
 void Master::_markUnreachable(
-    Slave* slave,
+    const vector<Slave*>& slaves_,
     const TimeInfo& unreachableTime,
     const string& message,
     const Future<bool>& registrarResult)
 {
-  CHECK_NOTNULL(slave);
-  CHECK(slaves.markingUnreachable.contains(slave->info.id()));
-  slaves.markingUnreachable.erase(slave->info.id());
+  foreach (Slave* slave, slaves_) {
+    CHECK_NOTNULL(slave);
+    CHECK(slaves.markingUnreachable.contains(slave->info.id()));
+    slaves.markingUnreachable.erase(slave->info.id());
+  }
 
   if (registrarResult.isFailed()) {
-    LOG(FATAL) << "Failed to mark agent " << *slave
+    LOG(FATAL) << "Failed to mark " << slaves_.size() << " agent(s)"
                << " unreachable in the registry: "
                << registrarResult.failure();
   }
 
   CHECK(!registrarResult.isDiscarded());
 
-  // `MarkSlaveUnreachable` registry operation should never fail.
+  // The unreachable registry operations should never fail.
   CHECK(registrarResult.get());
 
-  LOG(INFO) << "Marked agent " << *slave << " unreachable: " << message;
+  foreach (Slave* slave, slaves_) {
+    LOG(INFO) << "Marked agent " << *slave << " unreachable: " << message;
 
-  ++metrics->slave_removals;
-  ++metrics->slave_removals_reason_unhealthy;
+    ++metrics->slave_removals;
+    ++metrics->slave_removals_reason_unhealthy;
 
-  slaves.unreachable[slave->id] = unreachableTime;
+    slaves.unreachable[slave->id] = unreachableTime;
 
-  __removeSlave(slave, message, unreachableTime);
+    __removeSlave(slave, message, unreachableTime);
+  }
 }
 
 
@@ -8240,7 +8848,12 @@ void Master::reconcile(
     statuses.push_back(status);
   }
 
-  _reconcileTasks(framework, statuses);
+  _reconcileTasks(
+      framework,
+      statuses,
+      reconcile.has_since()
+        ? Option<TimeInfo>(reconcile.since())
+        : Option<TimeInfo>::none());
 }
 
 
@@ -8269,7 +8882,8 @@ void Master::reconcileTasks(
 
 void Master::_reconcileTasks(
     Framework* framework,
-    const vector<TaskStatus>& statuses)
+    const vector<TaskStatus>& statuses,
+    const Option<TimeInfo>& since)
 {
   CHECK_NOTNULL(framework);
 
@@ -8278,67 +8892,48 @@ void Master::_reconcileTasks(
   if (statuses.empty()) {
     // Implicit reconciliation.
     LOG(INFO) << "Performing implicit task state reconciliation"
-                 " for framework " << *framework;
+                 " for framework " << *framework
+              << (since.isSome()
+                    ? " of the tasks updated since " +
+                      stringify(Nanoseconds(since->nanoseconds()))
+                    : "");
 
-    foreachvalue (const TaskInfo& task, framework->pendingTasks) {
-      const StatusUpdate& update = protobuf::createStatusUpdate(
-          framework->id(),
-          task.slave_id(),
-          task.task_id(),
-          TASK_STAGING,
-          TaskStatus::SOURCE_MASTER,
-          None(),
-          "Reconciliation: Latest task state",
-          TaskStatus::REASON_RECONCILIATION);
+    // The tasks are reconciled in batches, so we take the IDs of the
+    // tasks to reconcile up front. Note that the pending tasks are
+    // always reconciled since they have no status updates yet.
+    vector<TaskStatus> tasks;
 
-      VLOG(1) << "Sending implicit reconciliation state "
-              << update.status().state()
-              << " for task " << update.status().task_id()
-              << " of framework " << *framework;
-
-      // TODO(bmahler): Consider using forward(); might lead to too
-      // much logging.
-      StatusUpdateMessage message;
-      message.mutable_update()->CopyFrom(update);
-      framework->send(message);
+    foreachvalue (const TaskInfo& task, framework->pendingTasks) {
+      TaskStatus status;
+      status.mutable_task_id()->CopyFrom(task.task_id());
+      status.mutable_slave_id()->CopyFrom(task.slave_id());
+      status.set_state(TASK_STAGING); // Dummy status.
+      tasks.push_back(status);
     }
 
     foreachvalue (Task* task, framework->tasks) {
-      const TaskState& state = task->has_status_update_state()
-          ? task->status_update_state()
-          : task->state();
-
-      const Option<ExecutorID>& executorId = task->has_executor_id()
-          ? Option<ExecutorID>(task->executor_id())
-          : None();
+      if (since.isSome() && task->statuses_size() > 0) {
+        const TaskStatus& latest =
+          task->statuses(task->statuses_size() - 1);
 
-      const StatusUpdate& update = protobuf::createStatusUpdate(
-          framework->id(),
-          task->slave_id(),
-          task->task_id(),
-          state,
-          TaskStatus::SOURCE_MASTER,
-          None(),
-          "Reconciliation: Latest task state",
-          TaskStatus::REASON_RECONCILIATION,
-          executorId,
-          protobuf::getTaskHealth(*task),
-          protobuf::getTaskCheckStatus(*task),
-          None(),
-          protobuf::getTaskContainerStatus(*task));
-
-      VLOG(1) << "Sending implicit reconciliation state "
-              << update.status().state()
-              << " for task " << update.status().task_id()
-              << " of framework " << *framework;
+        if (latest.timestamp() * Seconds(1).ns() <= since->nanoseconds()) {
+          continue;
+        }
+      }
 
-      // TODO(bmahler): Consider using forward(); might lead to too
-      // much logging.
-      StatusUpdateMessage message;
-      message.mutable_update()->CopyFrom(update);
-      framework->send(message);
+      TaskStatus status;
+      status.mutable_task_id()->CopyFrom(task->task_id());
+      status.mutable_slave_id()->CopyFrom(task->slave_id());
+      status.set_state(TASK_RUNNING); // Dummy status.
+      tasks.push_back(status);
     }
 
+    __reconcileTasks(
+        framework->id(),
+        std::make_shared<const vector<TaskStatus>>(std::move(tasks)),
+        true,
+        0);
+
     return;
   }
 
@@ -8346,6 +8941,28 @@ void Master::_reconcileTasks(
   LOG(INFO) << "Performing explicit task state reconciliation for "
             << statuses.size() << " tasks of framework " << *framework;
 
+  __reconcileTasks(
+      framework->id(),
+      std::make_shared<const vector<TaskStatus>>(statuses),
+      false,
+      0);
+}
+
+
+void Master::__reconcileTasks(
+    const FrameworkID& frameworkId,
+    const shared_ptr<const vector<TaskStatus>>& statuses,
+    bool implicit,
+    size_t offset)
+{
+  Framework* framework = getFramework(frameworkId);
+  if (framework == nullptr) {
+    LOG(INFO) << "Dropping reconciliation of " << statuses->size() - offset
+              << " tasks of framework " << frameworkId
+              << " because the framework is no longer known";
+    return;
+  }
+
   // Explicit reconciliation occurs for the following cases:
   //   (1) Task is known, but pending: TASK_STAGING.
   //   (2) Task is known: send the latest state.
@@ -8357,7 +8974,22 @@ void Master::_reconcileTasks(
   //
   // For cases (3), (5), (6) and (7) TASK_LOST is sent instead if the
   // framework has not opted-in to the PARTITION_AWARE capability.
-  foreach (const TaskStatus& status, statuses) {
+  //
+  // Implicit reconciliation only covers the cases (1) and (2), the
+  // tasks that became unknown since the reconciliation started (e.g.,
+  // they completed) are skipped.
+  const size_t end =
+    std::min(offset + RECONCILIATION_BATCH_SIZE, statuses->size());
+
+  for (size_t i = offset; i < end; i++) {
+    const TaskStatus& status = statuses->at(i);
+
+    if (implicit &&
+        !framework->pendingTasks.contains(status.task_id()) &&
+        framework->getTask(status.task_id()) == nullptr) {
+      continue;
+    }
+
     Option<SlaveID> slaveId = None();
     if (status.has_slave_id()) {
       slaveId = status.slave_id();
@@ -8491,7 +9123,8 @@ void Master::_reconcileTasks(
     }
 
     if (update.isSome()) {
-      VLOG(1) << "Sending explicit reconciliation state "
+      VLOG(1) << "Sending " << (implicit ? "implicit" : "explicit")
+              << " reconciliation state "
               << update.get().status().state()
               << " for task " << update.get().status().task_id()
               << " of framework " << *framework;
@@ -8503,6 +9136,18 @@ void Master::_reconcileTasks(
       framework->send(message);
     }
   }
+
+  if (end < statuses->size()) {
+    // Let the master handle its other events before reconciling the
+    // next batch of tasks.
+    dispatch(
+        self(),
+        &Master::__reconcileTasks,
+        frameworkId,
+        statuses,
+        implicit,
+        end);
+  }
 }
 
 
@@ -8623,7 +9268,6 @@ void Master::offer(
       offer->mutable_slave_id()->MergeFrom(slave->id);
       offer->set_hostname(slave->info.hostname());
       offer->mutable_url()->MergeFrom(url);
-      offer->mutable_resources()->MergeFrom(offered);
       offer->mutable_attributes()->MergeFrom(slave->info.attributes());
       offer->mutable_allocation_info()->set_role(role);
 
@@ -8648,6 +9292,15 @@ void Master::offer(
             machines[slave->machineId].info.unavailability());
       }
 
+      // The offer sent to the framework is built in place in the message
+      // and differs from the master's copy only in its resources, see
+      // below. To avoid copying the resources more than necessary, they
+      // are only added after copying the rest of the offer.
+      Offer* offer_ = message.add_offers();
+      offer_->CopyFrom(*offer);
+
+      offer->mutable_resources()->CopyFrom(offered);
+
       offers[offer->id()] = offer;
 
       framework->addOffer(offer);
@@ -8665,12 +9318,9 @@ void Master::offer(
       // TODO(jieyu): For now, we strip 'ephemeral_ports' resource from
       // offers so that frameworks do not see this resource. This is a
       // short term workaround. Revisit this once we resolve MESOS-1654.
-      Offer offer_ = *offer;
-      offer_.clear_resources();
-
       foreach (const Resource& resource, offered) {
         if (resource.name() != "ephemeral_ports") {
-          offer_.add_resources()->CopyFrom(resource);
+          offer_->add_resources()->CopyFrom(resource);
         }
       }
 
@@ -8684,20 +9334,19 @@ void Master::offer(
       // information doesn't provide any value to a pre-MULTI_ROLE
       // scheduler, we preserve the old `Offer` format for them.
       if (!framework->capabilities.multiRole) {
-        offer_.clear_allocation_info();
+        offer_->clear_allocation_info();
 
-        foreach (Resource& resource, *offer_.mutable_resources()) {
+        foreach (Resource& resource, *offer_->mutable_resources()) {
           resource.clear_allocation_info();
         }
       }
 
       if (!framework->capabilities.reservationRefinement) {
         convertResourceFormat(
-            offer_.mutable_resources(), PRE_RESERVATION_REFINEMENT);
+            offer_->mutable_resources(), PRE_RESERVATION_REFINEMENT);
       }
 
-      // Add the offer *AND* the corresponding slave's PID.
-      message.add_offers()->MergeFrom(offer_);
+      // Add the corresponding slave's PID along with the offer.
       message.add_pids(slave->pid);
     }
   }
@@ -8809,7 +9458,10 @@ void Master::inverseOffer(
 // 'authenticate' message doesn't contain the 'FrameworkID'.
 // 'from' is the authenticatee process with which to communicate.
 // 'pid' is the framework/slave process being authenticated.
-void Master::authenticate(const UPID& from, const UPID& pid)
+void Master::authenticate(
+    const UPID& from,
+    const UPID& pid,
+    const string& token)
 {
   ++metrics->messages_authenticate;
 
@@ -8840,7 +9492,7 @@ void Master::authenticate(const UPID& from, const UPID& pid)
 
   authenticated.erase(pid);
 
-  if (authenticator.isNone()) {
+  if (authenticators.empty()) {
     // The default authenticator is CRAM-MD5 rather than none.
     // Since the default parameters specify CRAM-MD5 authenticator, no
     // required authentication, and no credentials, we must support
@@ -8871,15 +9523,57 @@ void Master::authenticate(const UPID& from, const UPID& pid)
 
     // Retry after the current authenticator session finishes.
     authenticating[pid]
-      .onAny(defer(self(), &Self::authenticate, from, pid));
+      .onAny(defer(self(), &Self::authenticate, from, pid, token));
+
+    return;
+  }
+
+  if (!token.empty()) {
+    Try<string> principal = verifyAuthenticationToken(pid, token);
+
+    if (principal.isError()) {
+      LOG(WARNING) << "Failed to authenticate " << pid << " with token: "
+                   << principal.error();
+
+      // The client is expected to fall back to its authenticatee.
+      AuthenticationErrorMessage message;
+      message.set_error(principal.error());
+      send(from, message);
+
+      return;
+    }
+
+    LOG(INFO) << "Successfully authenticated principal '" << principal.get()
+              << "' at " << pid << " with token";
+
+    authenticated.put(pid, principal.get());
+
+    send(from, AuthenticationCompletedMessage());
+
+    issueAuthenticationToken(pid, principal.get());
+
+    return;
+  }
+
+  if (authenticating.size() >= flags.max_pending_authentications) {
+    LOG(WARNING) << "Refusing to authenticate " << pid << " because "
+                 << authenticating.size() << " authentications are pending";
+
+    // The client retries after a backoff.
+    AuthenticationErrorMessage message;
+    message.set_error("Too many pending authentications");
+    send(from, message);
 
     return;
   }
 
   LOG(INFO) << "Authenticating " << pid;
 
+  Authenticator* authenticator =
+    authenticators[std::hash<UPID>()(pid) % authenticators.size()];
+
   // Start authentication.
-  const Future<Option<string>> future = authenticator.get()->authenticate(from);
+  const Future<Option<string>> future = authenticator->authenticate(from);
 
   // Save our state.
   authenticating[pid] = future;
@@ -8910,6 +9604,8 @@ void Master::_authenticate(
               << "' at " << pid;
 
     authenticated.put(pid, future.get().get());
+
+    issueAuthenticationToken(pid, future.get().get());
   }
 
   CHECK(authenticating.contains(pid));
@@ -8928,6 +9624,69 @@ void Master::authenticationTimeout(Future<Option<string>> future)
 }
 
 
+Try<string> Master::verifyAuthenticationToken(
+    const UPID& pid,
+    const string& token) const
+{
+#ifdef USE_SSL_SOCKET
+  if (authenticationTokenKey.isNone()) {
+    return Error("Authentication tokens are not enabled");
+  }
+
+  // NOTE: This also verifies that the token has not expired.
+  Try<JWT, JWTError> jwt = JWT::parse(token, authenticationTokenKey.get());
+  if (jwt.isError()) {
+    return Error("Invalid authentication token: " + jwt.error().message);
+  }
+
+  Result<JSON::String> _pid = jwt->payload.at<JSON::String>("pid");
+  if (!_pid.isSome() || _pid->value != static_cast<string>(pid)) {
+    return Error("Authentication token was not issued to " + stringify(pid));
+  }
+
+  Result<JSON::String> principal = jwt->payload.at<JSON::String>("sub");
+  if (!principal.isSome()) {
+    return Error("Authentication token has no principal");
+  }
+
+  return principal->value;
+#else
+  return Error("Authentication tokens are not supported");
+#endif // USE_SSL_SOCKET
+}
+
+
+void Master::issueAuthenticationToken(
+    const UPID& pid,
+    const string& principal)
+{
+#ifdef USE_SSL_SOCKET
+  if (authenticationTokenKey.isNone()) {
+    return;
+  }
+
+  // The token is bound to the PID, which the agents and the scheduler
+  // drivers keep across master failovers.
+  JSON::Object payload;
+  payload.values["sub"] = principal;
+  payload.values["pid"] = static_cast<string>(pid);
+  payload.values["exp"] = static_cast<int64_t>(
+      (Clock::now() + flags.authentication_token_ttl).secs());
+
+  Try<JWT, JWTError> jwt = JWT::create(payload, authenticationTokenKey.get());
+  if (jwt.isError()) {
+    LOG(WARNING) << "Failed to create authentication token for " << pid
+                 << ": " << jwt.error().message;
+    return;
+  }
+
+  AuthenticationTokenMessage message;
+  message.set_token(stringify(jwt.get()));
+  send(pid, message);
+#endif // USE_SSL_SOCKET
+}
+
+
 void Master::reconcileKnownSlave(
     Slave* slave,
     const vector<ExecutorInfo>& executors,
@@ -9424,6 +10183,10 @@ void Master::removeFramework(Framework* framework)
   // Remove the pending tasks from the framework.
   framework->pendingTasks.clear();
 
+  // Recover the resources of the framework's tasks and executors once
+  // per agent and role below, rather than once per task and executor.
+  batchRecoverResources();
+
   // Remove pointers to the framework's tasks in slaves and mark those
   // tasks as completed.
   foreachvalue (Task* task, utils::copy(framework->tasks)) {
@@ -9513,6 +10276,8 @@ void Master::removeFramework(Framework* framework)
     }
   }
 
+  _recoverResources();
+
   foreachvalue (OfferOperation* operation,
                 utils::copy(framework->offerOperations)) {
     framework->removeOfferOperation(operation);
@@ -9560,7 +10325,7 @@ void Master::removeFramework(Framework* framework)
   // The framework pointer is now owned by `frameworks.completed`.
   frameworks.completed.set(framework->id(), Owned<Framework>(framework));
 
-  if (!subscribers.subscribed.empty()) {
+  if (subscribers.active()) {
     subscribers.send(
         protobuf::master::event::createFrameworkRemoved(framework->info));
   }
@@ -9633,18 +10398,8 @@ void Master::addSlave(
   CHECK(!machines[slave->machineId].slaves.contains(slave->id));
   machines[slave->machineId].slaves.insert(slave->id);
 
-  // Set up an observer for the slave.
-  slave->observer = new SlaveObserver(
-      slave->pid,
-      slave->info,
-      slave->id,
-      self(),
-      slaves.limiter,
-      metrics,
-      flags.agent_ping_timeout,
-      flags.max_agent_ping_timeouts);
-
-  spawn(slave->observer);
+  // Start checking the health of the slave.
+  dispatch(slaveObserver, &SlaveObserver::add, slave->id, slave->pid);
 
   // Add the slave's executors to the frameworks.
   foreachkey (const FrameworkID& frameworkId, slave->executors) {
@@ -9730,7 +10485,7 @@ void Master::addSlave(
       slave->totalResources,
       slave->usedResources);
 
-  if (!subscribers.subscribed.empty()) {
+  if (subscribers.active()) {
     subscribers.send(protobuf::master::event::createAgentAdded(*slave));
   }
 }
@@ -9868,13 +10623,14 @@ void Master::_removeSlave(
   foreach (Offer* offer, utils::copy(slave->offers)) {
     // TODO(vinod): We don't need to call 'Allocator::recoverResources'
     // once MESOS-621 is fixed.
-    allocator->recoverResources(
-        offer->framework_id(), slave->id, offer->resources(), None());
+    recoverResources(offer->framework_id(), slave->id, offer->resources());
 
     // Remove and rescind offers.
     removeOffer(offer, true); // Rescind!
   }
 
+  _recoverResources();
+
   // Remove inverse offers because sending them for a slave that is
   // gone doesn't make sense.
   foreach (InverseOffer* inverseOffer, utils::copy(slave->inverseOffers)) {
@@ -9897,16 +10653,14 @@ void Master::_removeSlave(
   CHECK(machines[slave->machineId].slaves.contains(slave->id));
   machines[slave->machineId].slaves.erase(slave->id);
 
-  // Kill the slave observer.
-  terminate(slave->observer);
-  wait(slave->observer);
-  delete slave->observer;
+  // Stop checking the health of the slave.
+  dispatch(slaveObserver, &SlaveObserver::remove, slave->id);
 
   // TODO(benh): unlink(slave->pid);
 
   sendSlaveLost(slave->info);
 
-  if (!subscribers.subscribed.empty()) {
+  if (subscribers.active()) {
     subscribers.send(protobuf::master::event::createAgentRemoved(slave->id));
   }
 
@@ -9929,6 +10683,11 @@ void Master::__removeSlave(
   // the slave is already removed.
   allocator->removeSlave(slave->id);
 
+  // Recover the resources of the agent's tasks, executors and offers
+  // once per framework and role below, rather than once per task,
+  // executor and offer.
+  batchRecoverResources();
+
   // Transition tasks to TASK_UNREACHABLE/TASK_GONE_BY_OPERATOR/TASK_LOST
   // and remove them. We only use TASK_UNREACHABLE/TASK_GONE_BY_OPERATOR if
   // the framework has opted in to the PARTITION_AWARE capability.
@@ -10019,10 +10778,8 @@ void Master::__removeSlave(
   CHECK(machines[slave->machineId].slaves.contains(slave->id));
   machines[slave->machineId].slaves.erase(slave->id);
 
-  // Kill the slave observer.
-  terminate(slave->observer);
-  wait(slave->observer);
-  delete slave->observer;
+  // Stop checking the health of the slave.
+  dispatch(slaveObserver, &SlaveObserver::remove, slave->id);
 
   // TODO(benh): unlink(slave->pid);
 
@@ -10087,7 +10844,8 @@ void Master::updateTask(Task* task, const StatusUpdate& update)
       task->statuses(task->statuses_size() - 1).state() == status.state()) {
     task->mutable_statuses()->RemoveLast();
   }
-  task->add_statuses()->CopyFrom(status);
+  TaskStatus* latest = task->add_statuses();
+  latest->CopyFrom(status);
 
   // Delete data (maybe very large since it's stored by on-top framework) we
   // are not interested in to avoid OOM.
@@ -10095,9 +10853,12 @@ void Master::updateTask(Task* task, const StatusUpdate& update)
   // if every task stores 10MB data into TaskStatus, then mesos-master will be
   // killed by OOM killer after 400 tasks have finished.
   // MESOS-1746.
-  task->mutable_statuses(task->statuses_size() - 1)->clear_data();
+  //
+  // NOTE: The data gets released rather than cleared, since clearing
+  // the string keeps its memory around for as long as the status.
+  delete latest->release_data();
 
-  if (sendSubscribersUpdate && !subscribers.subscribed.empty()) {
+  if (sendSubscribersUpdate && subscribers.active()) {
     subscribers.send(protobuf::master::event::createTaskUpdated(
         *task, task->state(), status));
   }
@@ -10109,11 +10870,8 @@ void Master::updateTask(Task* task, const StatusUpdate& update)
 
   // Once the task becomes removable, recover the resources.
   if (removable) {
-    allocator->recoverResources(
-        task->framework_id(),
-        task->slave_id(),
-        task->resources(),
-        None());
+    recoverResources(
+        task->framework_id(), task->slave_id(), task->resources());
 
     // The slave owns the Task object and cannot be nullptr.
     Slave* slave = slaves.registered.get(task->slave_id());
@@ -10200,11 +10958,7 @@ void Master::removeTask(Task* task, bool unreachable)
 
     // If the task is not removable, then the resources have
     // not yet been recovered.
-    allocator->recoverResources(
-        task->framework_id(),
-        task->slave_id(),
-        resources,
-        None());
+    recoverResources(task->framework_id(), task->slave_id(), resources);
   } else {
     // Note that we use `Resources` for output as it's faster than
     // logging raw protobuf data.
@@ -10241,8 +10995,7 @@ void Master::removeExecutor(
             << "' with resources " << executor.resources()
             << " of framework " << frameworkId << " on agent " << *slave;
 
-  allocator->recoverResources(
-      frameworkId, slave->id, executor.resources(), None());
+  recoverResources(frameworkId, slave->id, executor.resources());
 
   Framework* framework = getFramework(frameworkId);
   if (framework != nullptr) { // The framework might not be re-registered yet.
@@ -10253,6 +11006,53 @@ void Master::removeExecutor(
 }
 
 
+void Master::recoverResources(
+    const FrameworkID& frameworkId,
+    const SlaveID& slaveId,
+    const Resources& resources)
+{
+  if (recoveries.isSome()) {
+    recoveries.get()[frameworkId][slaveId] += resources;
+  } else {
+    allocator->recoverResources(frameworkId, slaveId, resources, None());
+  }
+}
+
+
+void Master::batchRecoverResources()
+{
+  CHECK_NONE(recoveries);
+
+  recoveries = hashmap<FrameworkID, hashmap<SlaveID, Resources>>();
+}
+
+
+void Master::_recoverResources()
+{
+  CHECK_SOME(recoveries);
+
+  hashmap<FrameworkID, hashmap<SlaveID, Resources>> recoveries_ =
+    std::move(recoveries.get());
+
+  recoveries = None();
+
+  foreachpair (const FrameworkID& frameworkId,
+               const auto& slaves_,
+               recoveries_) {
+    foreachpair (const SlaveID& slaveId,
+                 const Resources& resources,
+                 slaves_) {
+      // The allocator requires resources to be recovered within a
+      // single allocation role.
+      foreachvalue (const Resources& allocation, resources.allocations()) {
+        allocator->recoverResources(
+            frameworkId, slaveId, allocation, None());
+      }
+    }
+  }
+}
+
+
 void Master::addOfferOperation(
     Framework* framework,
     Slave* slave,
@@ -11054,71 +11854,161 @@ static bool isValidFailoverTimeout(const FrameworkInfo& frameworkInfo)
 }
 
 
+const string& Master::Subscribers::EncodedEvent::encode(
+    ContentType contentType)
+{
+  if (records.count(contentType) == 0) {
+    records[contentType] =
+      HttpConnection::encode<mesos::master::Event, v1::master::Event>(
+          contentType, event);
+  }
+
+  return records.at(contentType);
+}
+
+
+Master::Subscribers::Subscriber::Subscriber(
+    Master* _master,
+    const HttpConnection& _http,
+    const Option<Principal> _principal)
+  : master(_master),
+    http(_http),
+    principal(_principal)
+{
+  mesos::master::Event event;
+  event.set_type(mesos::master::Event::HEARTBEAT);
+
+  heartbeater =
+    Owned<Heartbeater<mesos::master::Event, v1::master::Event>>(
+        new Heartbeater<mesos::master::Event, v1::master::Event>(
+            "subscriber " + stringify(http.streamId),
+            event,
+            http,
+            DEFAULT_HEARTBEAT_INTERVAL,
+            DEFAULT_HEARTBEAT_INTERVAL));
+
+  process::spawn(heartbeater.get());
+
+  acceptors = collect(
+      AuthorizationAcceptor::create(
+          principal, master->authorizer, authorization::VIEW_ROLE),
+      AuthorizationAcceptor::create(
+          principal, master->authorizer, authorization::VIEW_FRAMEWORK),
+      AuthorizationAcceptor::create(
+          principal, master->authorizer, authorization::VIEW_TASK),
+      AuthorizationAcceptor::create(
+          principal, master->authorizer, authorization::VIEW_EXECUTOR));
+}
+
+
+Master::Subscribers::Subscriber::~Subscriber()
+{
+  flush();
+
+  // TODO(anand): Refactor `HttpConnection` to being a RAII class instead.
+  // It is possible that a caller might accidentally invoke `close()`
+  // after passing ownership to the `Subscriber` object. See MESOS-5843
+  // for more details.
+  http.close();
+
+  terminate(heartbeater.get());
+  wait(heartbeater.get());
+}
+
+
 void Master::Subscribers::send(const mesos::master::Event& event)
 {
+  if (version.isNone()) {
+    return; // No client has subscribed yet.
+  }
+
   VLOG(1) << "Notifying all active subscribers about " << event.type()
           << " event";
 
-  foreachvalue (const Owned<Subscriber>& subscriber, subscribed) {
-    Future<Owned<AuthorizationAcceptor>> authorizeRole =
-      AuthorizationAcceptor::create(
-          subscriber->principal,
-          subscriber->master->authorizer,
-          authorization::VIEW_ROLE);
+  version = version.get() + 1;
 
-    Future<Owned<AuthorizationAcceptor>> authorizeFramework =
-      AuthorizationAcceptor::create(
-          subscriber->principal,
-          subscriber->master->authorizer,
-          authorization::VIEW_FRAMEWORK);
+  mesos::master::Event versioned = event;
+  versioned.set_version(version.get());
 
-    Future<Owned<AuthorizationAcceptor>> authorizeTask =
-      AuthorizationAcceptor::create(
-          subscriber->principal,
-          subscriber->master->authorizer,
-          authorization::VIEW_TASK);
+  // The event is shared by all of the subscribers, so that it is only
+  // copied once and encoded at most once for each content type.
+  Owned<EncodedEvent> encoded(new EncodedEvent(std::move(versioned)));
 
-    Future<Owned<AuthorizationAcceptor>> authorizeExecutor =
-      AuthorizationAcceptor::create(
-          subscriber->principal,
-          subscriber->master->authorizer,
-          authorization::VIEW_EXECUTOR);
+  log.push_back(encoded);
+  if (log.size() > OPERATOR_EVENT_LOG_SIZE) {
+    log.pop_front();
+  }
 
-    collect(authorizeRole, authorizeFramework, authorizeTask, authorizeExecutor)
-      .then(defer(subscriber->master->self(),
-          [=](const tuple<Owned<AuthorizationAcceptor>,
-                          Owned<AuthorizationAcceptor>,
-                          Owned<AuthorizationAcceptor>,
-                          Owned<AuthorizationAcceptor>>& acceptors) {
-        Owned<AuthorizationAcceptor> authorizeRole;
-        Owned<AuthorizationAcceptor> authorizeFramework;
-        Owned<AuthorizationAcceptor> authorizeTask;
-        Owned<AuthorizationAcceptor> authorizeExecutor;
+  foreachvalue (const Owned<Subscriber>& subscriber, subscribed) {
+    send(subscriber, encoded);
+  }
+}
 
-        tie(authorizeRole,
-            authorizeFramework,
-            authorizeTask,
-            authorizeExecutor) = acceptors;
 
-        subscriber->send(event,
-            authorizeRole,
-            authorizeFramework,
-            authorizeTask,
-            authorizeExecutor);
+bool Master::Subscribers::resume(const UUID& id, uint64_t _version)
+{
+  // The log holds the events from `version - log.size() + 1` up to
+  // `version`.
+  if (version.isNone() ||
+      _version > version.get() ||
+      _version + log.size() < version.get()) {
+    return false;
+  }
+
+  CHECK(subscribed.contains(id));
 
-        return Nothing();
-      }));
+  const Owned<Subscriber>& subscriber = subscribed.at(id);
+
+  foreach (const Owned<EncodedEvent>& encoded, log) {
+    if (encoded->event.version() > _version) {
+      send(subscriber, encoded);
+    }
   }
+
+  return true;
+}
+
+
+void Master::Subscribers::send(
+    const Owned<Subscriber>& subscriber,
+    const Owned<EncodedEvent>& encoded)
+{
+  subscriber->acceptors
+    .then(defer(subscriber->master->self(),
+        [=](const tuple<Owned<AuthorizationAcceptor>,
+                        Owned<AuthorizationAcceptor>,
+                        Owned<AuthorizationAcceptor>,
+                        Owned<AuthorizationAcceptor>>& acceptors) {
+      Owned<AuthorizationAcceptor> authorizeRole;
+      Owned<AuthorizationAcceptor> authorizeFramework;
+      Owned<AuthorizationAcceptor> authorizeTask;
+      Owned<AuthorizationAcceptor> authorizeExecutor;
+
+      tie(authorizeRole,
+          authorizeFramework,
+          authorizeTask,
+          authorizeExecutor) = acceptors;
+
+      subscriber->send(encoded,
+          authorizeRole,
+          authorizeFramework,
+          authorizeTask,
+          authorizeExecutor);
+
+      return Nothing();
+    }));
 }
 
 
 void Master::Subscribers::Subscriber::send(
-    const mesos::master::Event& event,
+    const Owned<EncodedEvent>& encoded,
     const Owned<AuthorizationAcceptor>& authorizeRole,
     const Owned<AuthorizationAcceptor>& authorizeFramework,
     const Owned<AuthorizationAcceptor>& authorizeTask,
     const Owned<AuthorizationAcceptor>& authorizeExecutor)
 {
+  const mesos::master::Event& event = encoded->event;
+
   switch (event.type()) {
     case mesos::master::Event::TASK_ADDED: {
       Framework* framework =
@@ -11130,7 +12020,7 @@ void Master::Subscribers::Subscriber::send(
 
       if (authorizeTask->accept(event.task_added().task(), framework->info) &&
           authorizeFramework->accept(framework->info)) {
-        http.send<mesos::master::Event, v1::master::Event>(event);
+        write(encoded->encode(http.contentType));
       }
       break;
     }
@@ -11151,7 +12041,7 @@ void Master::Subscribers::Subscriber::send(
 
       if (authorizeTask->accept(*task, framework->info) &&
           authorizeFramework->accept(framework->info)) {
-        http.send<mesos::master::Event, v1::master::Event>(event);
+        write(encoded->encode(http.contentType));
       }
       break;
     }
@@ -11182,7 +12072,8 @@ void Master::Subscribers::Subscriber::send(
           }
         }
 
-        http.send<mesos::master::Event, v1::master::Event>(event_);
+        write(HttpConnection::encode<mesos::master::Event, v1::master::Event>(
+            http.contentType, event_));
       }
       break;
     }
@@ -11213,14 +12104,15 @@ void Master::Subscribers::Subscriber::send(
           }
         }
 
-        http.send<mesos::master::Event, v1::master::Event>(event_);
+        write(HttpConnection::encode<mesos::master::Event, v1::master::Event>(
+            http.contentType, event_));
       }
       break;
     }
     case mesos::master::Event::FRAMEWORK_REMOVED: {
       if (authorizeFramework->accept(
               event.framework_removed().framework_info())) {
-        http.send<mesos::master::Event, v1::master::Event>(event);
+        write(encoded->encode(http.contentType));
       }
       break;
     }
@@ -11238,16 +12130,48 @@ void Master::Subscribers::Subscriber::send(
         }
       }
 
-      http.send<mesos::master::Event, v1::master::Event>(event_);
+      write(HttpConnection::encode<mesos::master::Event, v1::master::Event>(
+          http.contentType, event_));
       break;
     }
     default:
-      http.send<mesos::master::Event, v1::master::Event>(event);
+      write(encoded->encode(http.contentType));
       break;
   }
 }
 
 
+
+void Master::Subscribers::Subscriber::write(const string& record)
+{
+  const Duration& interval =
+    master->flags.operator_event_stream_flush_interval;
+
+  if (interval == Duration::zero()) {
+    http.write(record);
+    return;
+  }
+
+  buffered += record;
+
+  if (!flushing) {
+    flushing = true;
+    delay(interval, master->self(), &Master::flushSubscriber, http.streamId);
+  }
+}
+
+
+void Master::Subscribers::Subscriber::flush()
+{
+  if (!buffered.empty()) {
+    http.write(buffered);
+    buffered.clear();
+  }
+
+  flushing = false;
+}
+
+
 void Master::exited(const UUID& id)
 {
   if (!subscribers.subscribed.contains(id)) {
@@ -11262,6 +12186,122 @@ void Master::exited(const UUID& id)
 }
 
 
+void Master::flushSubscriber(const UUID& id)
+{
+  // The subscriber might have disconnected in the meantime.
+  if (subscribers.subscribed.contains(id)) {
+    subscribers.subscribed.at(id)->flush();
+  }
+}
+
+
+void Master::refreshStandbyViews()
+{
+  CHECK_SOME(flags.standby_state_refresh_interval);
+
+  // NOTE: A master that lost leadership commits suicide, hence once
+  // elected this master no longer needs the copies.
+  if (elected()) {
+    standbyViews.clear();
+    return;
+  }
+
+  if (leader.isSome()) {
+    const UPID pid(leader->pid());
+    const Time requested = Clock::now();
+
+    const vector<string> names = {"state", "state-summary"};
+
+    foreach (const string& name, names) {
+      process::http::get(pid, name)
+        .onAny(defer(
+            self(),
+            &Master::_refreshStandbyViews,
+            pid,
+            name,
+            requested,
+            lambda::_1));
+    }
+  }
+
+  delay(flags.standby_state_refresh_interval.get(),
+        self(),
+        &Master::refreshStandbyViews);
+}
+
+
+void Master::_refreshStandbyViews(
+    const UPID& pid,
+    const string& name,
+    const Time& requested,
+    const Future<process::http::Response>& response)
+{
+  // Drop the copies of a previous leader.
+  if (elected() || leader.isNone() || UPID(leader->pid()) != pid) {
+    return;
+  }
+
+  if (!response.isReady() ||
+      response->status != process::http::OK().status ||
+      response->type != process::http::Response::BODY) {
+    LOG(WARNING) << "Failed to fetch '" << name << "' from the leading "
+                 << "master " << pid << ": "
+                 << (response.isReady()
+                     ? response->status
+                     : (response.isFailed() ? response.failure()
+                                            : "discarded"));
+
+    // Redirect to the leading master rather than serving a copy that
+    // gets staler and staler.
+    standbyViews.erase(name);
+    return;
+  }
+
+  // A response to an earlier request might arrive last.
+  if (standbyViews.contains(name) &&
+      standbyViews.at(name).time > requested) {
+    return;
+  }
+
+  standbyViews[name] = StandbyView{response->body, requested};
+}
+
+
+void Master::snapshotState()
+{
+  CHECK_SOME(flags.state_snapshot_dir);
+
+  // Only the leading master knows the state of the cluster.
+  if (!elected()) {
+    delay(flags.state_snapshot_interval, self(), &Master::snapshotState);
+    return;
+  }
+
+  const string directory = path::join(
+      flags.state_snapshot_dir.get(),
+      stringify(static_cast<int64_t>(Clock::now().secs())));
+
+  // NOTE: The next snapshot is only scheduled once this one has been
+  // written, so that slow disks do not pile up snapshots in memory.
+  http.snapshot(directory)
+    .onAny(defer(self(), &Master::_snapshotState, directory, lambda::_1));
+}
+
+
+void Master::_snapshotState(
+    const string& directory,
+    const Future<Nothing>& snapshot)
+{
+  if (!snapshot.isReady()) {
+    LOG(WARNING) << "Failed to write the snapshot of the state into '"
+                 << directory << "': "
+                 << (snapshot.isFailed() ? snapshot.failure() : "discarded");
+  }
+
+  delay(flags.state_snapshot_interval, self(), &Master::snapshotState);
+}
+
+
 void Master::subscribe(
     const HttpConnection& http,
     const Option<Principal>& principal)
@@ -11279,6 +12319,17 @@ void Master::subscribe(
       http.streamId,
       Owned<Subscribers::Subscriber>(
           new Subscribers::Subscriber{this, http, principal}));
+
+  // Start versioning the events with the first subscription, see
+  // `mesos::master::Event::version`.
+  if (subscribers.version.isNone()) {
+    std::random_device device;
+    std::mt19937_64 generator(
+        (static_cast<uint64_t>(device()) << 32) | device());
+
+    // Leave enough room for the versions to never overflow.
+    subscribers.version = generator() >> 1;
+  }
 }
 
 
@@ -11305,7 +12356,6 @@ Slave::Slave(
     connected(true),
     active(true),
     checkpointedResources(std::move(_checkpointedResources)),
-    observer(nullptr),
     resourceVersions(std::move(_resourceVersions))
 {
   CHECK(info.has_id());
@@ -11372,7 +12422,7 @@ void Slave::addTask(Task* task)
     usedResources[frameworkId] += resources;
   }
 
-  if (!master->subscribers.subscribed.empty()) {
+  if (master->subscribers.active()) {
     master->subscribers.send(protobuf::master::event::createTaskAdded(*task));
   }
 
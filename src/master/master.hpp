@@ -19,14 +19,15 @@
 
 #include <stdint.h>
 
+#include <deque>
 #include <list>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
-#include <boost/circular_buffer.hpp>
-
 #include <mesos/mesos.hpp>
 #include <mesos/resources.hpp>
 #include <mesos/type_utils.hpp>
@@ -58,6 +59,7 @@
 #include <stout/foreach.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
+#include <stout/lambda.hpp>
 #include <stout/linkedhashmap.hpp>
 #include <stout/multihashmap.hpp>
 #include <stout/nothing.hpp>
@@ -75,6 +77,7 @@
 #include "internal/devolve.hpp"
 #include "internal/evolve.hpp"
 
+#include "master/completed_tasks.hpp"
 #include "master/constants.hpp"
 #include "master/flags.hpp"
 #include "master/machine.hpp"
@@ -242,6 +245,11 @@ struct Slave
   // This is used for reconciliation when the slave re-registers.
   multihashmap<FrameworkID, TaskID> killedTasks;
 
+  // Status update acknowledgements waiting to be forwarded to the
+  // agent in a batch, see `--status_update_acknowledgement_flush_interval`.
+  StatusUpdateAcknowledgementsMessage acknowledgements;
+  bool flushingAcknowledgements = false;
+
   // Pending operations or terminal operations that have
   // unacknowledged status updates on this agent.
   hashmap<UUID, OfferOperation*> offerOperations;
@@ -271,8 +279,6 @@ struct Slave
   // includes revocable resources as well.
   Resources totalResources;
 
-  SlaveObserver* observer;
-
   hashmap<Option<ResourceProviderID>, UUID> resourceVersions;
   hashmap<ResourceProviderID, ResourceProviderInfo> resourceProviders;
 
@@ -304,11 +310,24 @@ struct HttpConnection
   // versioned event e.g., `v1::scheduler::Event` or `v1::master::Event`.
   template <typename Message, typename Event = v1::scheduler::Event>
   bool send(const Message& message)
+  {
+    return write(encode<Message, Event>(contentType, message));
+  }
+
+  // Returns the RecordIO record of the evolved `message`.
+  template <typename Message, typename Event = v1::scheduler::Event>
+  static std::string encode(ContentType contentType, const Message& message)
   {
     ::recordio::Encoder<Event> encoder (lambda::bind(
         serialize, contentType, lambda::_1));
 
-    return writer.write(encoder.encode(evolve(message)));
+    return encoder.encode(evolve(message));
+  }
+
+  // Writes already encoded records, see `encode()`.
+  bool write(const std::string& records)
+  {
+    return writer.write(records);
   }
 
   bool close()
@@ -476,6 +495,19 @@ public:
       const process::UPID& from,
       ReregisterSlaveMessage&& incomingMessage);
 
+  // Returns whether the (re-)registration of the agent at `pid` can
+  // proceed without exceeding `--max_concurrent_agent_admissions`.
+  // Otherwise it queues `admit` to retry the (re-)registration once
+  // the agent's turn comes, and asks the agent to hold off.
+  bool admitAgent(
+      const process::UPID& pid,
+      const SlaveInfo& slaveInfo,
+      bool reregistering,
+      lambda::function<void()>&& admit);
+
+  // Retries the queued (re-)registrations that can now proceed.
+  void admitAgents();
+
   void unregisterSlave(
       const process::UPID& from,
       const SlaveID& slaveId);
@@ -484,6 +516,10 @@ public:
       StatusUpdate update,
       const process::UPID& pid);
 
+  void statusUpdates(
+      const process::UPID& from,
+      StatusUpdatesMessage&& statusUpdatesMessage);
+
   void reconcileTasks(
       const process::UPID& from,
       const FrameworkID& frameworkId,
@@ -509,11 +545,19 @@ public:
       const SlaveID& slaveId,
       const std::string& message);
 
+  // Marks all the given agents unreachable within a single registry
+  // operation, e.g., when the agents of a partitioned rack all fail
+  // their health checks on the same tick.
+  void markSlavesUnreachable(
+      const std::vector<SlaveID>& slaveIds,
+      const std::string& message);
+
   void markGone(Slave* slave, const TimeInfo& goneTime);
 
   void authenticate(
       const process::UPID& from,
-      const process::UPID& pid);
+      const process::UPID& pid,
+      const std::string& token);
 
   // TODO(bmahler): It would be preferred to use a unique libprocess
   // Process identifier (PID is not sufficient) for identifying the
@@ -551,6 +595,8 @@ protected:
   void initialize() override;
   void finalize() override;
 
+  void serve(process::Event&& event) override;
+
   void consume(process::MessageEvent&& event) override;
   void consume(process::ExitedEvent&& event) override;
 
@@ -561,6 +607,28 @@ protected:
   // Invoked upon noticing a subscriber disconnection.
   void exited(const UUID& id);
 
+  // Writes the events buffered for a subscriber, see
+  // `--operator_event_stream_flush_interval`.
+  void flushSubscriber(const UUID& id);
+
+  // Fetches the views of the leading master served by this master
+  // while it is not the leader, see `--standby_state_refresh_interval`.
+  void refreshStandbyViews();
+
+  void _refreshStandbyViews(
+      const process::UPID& leader,
+      const std::string& name,
+      const process::Time& requested,
+      const process::Future<process::http::Response>& response);
+
+  // Writes a snapshot of the state of the cluster into a new directory
+  // in `--state_snapshot_dir`, see `--state_snapshot_interval`.
+  void snapshotState();
+
+  void _snapshotState(
+      const std::string& directory,
+      const process::Future<Nothing>& snapshot);
+
   void agentReregisterTimeout(const SlaveID& slaveId);
   Nothing _agentReregisterTimeout(const SlaveID& slaveId);
 
@@ -633,6 +701,18 @@ protected:
 
   void authenticationTimeout(process::Future<Option<std::string>> future);
 
+  // Returns the principal an authentication token was issued to, if
+  // the token is valid for the PID.
+  Try<std::string> verifyAuthenticationToken(
+      const process::UPID& pid,
+      const std::string& token) const;
+
+  // Sends a new authentication token to an authenticated PID, if the
+  // master is configured to issue them.
+  void issueAuthenticationToken(
+      const process::UPID& pid,
+      const std::string& principal);
+
   void fileAttached(const process::Future<Nothing>& result,
                     const std::string& path);
 
@@ -640,10 +720,21 @@ protected:
   void contended(const process::Future<process::Future<Nothing>>& candidacy);
 
   // Task reconciliation, split from the message handler
-  // to allow re-use.
+  // to allow re-use. If `since` is set, implicit reconciliation
+  // only considers the tasks updated after it.
   void _reconcileTasks(
       Framework* framework,
-      const std::vector<TaskStatus>& statuses);
+      const std::vector<TaskStatus>& statuses,
+      const Option<TimeInfo>& since = None());
+
+  // Reconciles a batch of the tasks starting at `offset`, and then
+  // dispatches itself to reconcile the next batch. This lets the
+  // master handle other events while reconciling many tasks.
+  void __reconcileTasks(
+      const FrameworkID& frameworkId,
+      const std::shared_ptr<const std::vector<TaskStatus>>& statuses,
+      bool implicit,
+      size_t offset);
 
   // When a slave that was previously registered with this master
   // re-registers, we need to reconcile the master's view of the
@@ -713,8 +804,12 @@ protected:
       Slave* slave,
       std::vector<Archive::Framework>&& completedFrameworks);
 
+  // Returns whether the agent can be marked unreachable, i.e., it is
+  // registered and not already transitioning, or being removed.
+  bool canMarkUnreachable(const SlaveID& slaveId);
+
   void _markUnreachable(
-      Slave* slave,
+      const std::vector<Slave*>& slaves,
       const TimeInfo& unreachableTime,
       const std::string& message,
       const process::Future<bool>& registrarResult);
@@ -874,6 +969,20 @@ protected:
       const FrameworkID& frameworkId,
       const ExecutorID& executorId);
 
+  // Recovers the resources in the allocator, or accumulates them
+  // while the removal of a framework or agent is batching the
+  // recoveries, see `recoveries`.
+  void recoverResources(
+      const FrameworkID& frameworkId,
+      const SlaveID& slaveId,
+      const Resources& resources);
+
+  // Starts accumulating the recovered resources, so that they are
+  // recovered in the allocator once per framework, agent and role by
+  // `_recoverResources()` rather than once per task and executor.
+  void batchRecoverResources();
+  void _recoverResources();
+
   // Adds the given offer operation to the framework and the agent.
   void addOfferOperation(
       Framework* framework,
@@ -1035,6 +1144,10 @@ private:
       Framework* framework,
       const scheduler::Call::Acknowledge& acknowledge);
 
+  // Forwards the batch of status update acknowledgements pending for
+  // the agent, if any.
+  void flushAcknowledgements(const SlaveID& slaveId);
+
   void acknowledgeOfferOperationUpdate(
       Framework* framework,
       const scheduler::Call::AcknowledgeOfferOperationUpdate& acknowledge);
@@ -1347,6 +1460,13 @@ private:
     process::Future<process::http::Response> redirect(
         const process::http::Request& request) const;
 
+    // Serves the copy of the leading master's view `name` kept by this
+    // master, if any (see `--standby_state_refresh_interval`), and
+    // redirects the request to the leading master otherwise.
+    process::Future<process::http::Response> standby(
+        const process::http::Request& request,
+        const std::string& name) const;
+
     // /master/reserve
     process::Future<process::http::Response> reserve(
         const process::http::Request& request,
@@ -1454,6 +1574,11 @@ private:
     static std::string QUOTA_HELP();
     static std::string WEIGHTS_HELP();
 
+    // Writes the state of the master (i.e., what `GET_STATE` returns)
+    // into `directory` as compressed length-prefixed records, one file
+    // per kind of entity, see `--state_snapshot_dir`.
+    process::Future<Nothing> snapshot(const std::string& directory) const;
+
   private:
     JSON::Object __flags() const;
 
@@ -1717,8 +1842,43 @@ private:
     process::Future<process::http::Response> _markAgentGone(
         const SlaveID& slaveId) const;
 
+    // A rendering of a read-only view of the master (e.g., its state)
+    // that can be served to multiple requests.
+    struct View
+    {
+      std::string body;
+
+      // The generation of the master (see `Master::generation`) and
+      // the time when the view was rendered.
+      uint64_t generation;
+      process::Time time;
+    };
+
+    // Returns the cached rendering of the view `name` for the class of
+    // `principal`, if it is still fresh. A rendering is fresh while it
+    // is pending, so that concurrent requests share a single rendering,
+    // as long as the master has not served any event that might have
+    // changed its state since, and for `--state_cache_max_staleness`
+    // after it was rendered.
+    Option<process::Future<View>> cached(
+        const std::string& name,
+        const Option<process::http::authentication::Principal>&
+            principal) const;
+
+    // Caches `view` as the rendering of the view `name` for the class
+    // of `principal`, and returns it.
+    process::Future<View> cache(
+        const std::string& name,
+        const Option<process::http::authentication::Principal>& principal,
+        const process::Future<View>& view) const;
+
     Master* master;
 
+    // Renderings of views of the master, see `cached()`. Keyed by the
+    // name of the view and the class of the principal, i.e., all
+    // principals share a rendering without an authorizer.
+    mutable hashmap<std::string, process::Future<View>> views;
+
     // NOTE: The quota specific pieces of the Operator API are factored
     // out into this separate class.
     QuotaHandler quotaHandler;
@@ -1754,8 +1914,24 @@ private:
 
   Option<MasterInfo> leader; // Current leading master.
 
+  // A copy of a view (e.g., `/state`) of the leading master, fetched
+  // when this master is not the leader, see `refreshStandbyViews()`.
+  struct StandbyView
+  {
+    std::string body;
+
+    // The time when the copy was requested from the leading master.
+    process::Time time;
+  };
+
+  // The copies of the views of the current leading master, by name.
+  hashmap<std::string, StandbyView> standbyViews;
+
   mesos::allocator::Allocator* allocator;
   WhitelistWatcher* whitelistWatcher;
+
+  // Checks the health of the registered agents.
+  SlaveObserver* slaveObserver;
   Registrar* registrar;
   Files* files;
 
@@ -1809,6 +1985,27 @@ private:
     hashset<process::UPID> registering;
     hashset<SlaveID> reregistering;
 
+    // Agents that attempted to (re-)register while the maximum number
+    // of (re-)registrations were in progress (see the
+    // `--max_concurrent_agent_admissions` flag), by agent. They are
+    // admitted in the order of their keys as (re-)registrations finish,
+    // see `Master::admitAgent()`.
+    struct Admission
+    {
+      // The negated priority of the agent, whether it is registering
+      // rather than re-registering, and a sequence number.
+      typedef std::tuple<double, bool, uint64_t> Key;
+
+      Key key;
+
+      // Retries the (re-)registration.
+      lambda::function<void()> admit;
+    };
+
+    hashmap<process::UPID, Admission> admissions;
+    std::map<Admission::Key, process::UPID> admissionOrder;
+    uint64_t admissionSequence = 0;
+
     // Registered slaves are indexed by SlaveID and UPID. Note that
     // iteration is supported but is exposed as iteration over a
     // hashmap<SlaveID, Slave*> since it is tedious to convert
@@ -1960,6 +2157,24 @@ private:
 
   struct Subscribers
   {
+    // An event which is encoded (see `HttpConnection::encode()`) at
+    // most once for each content type, no matter how many subscribers
+    // it is sent to.
+    class EncodedEvent
+    {
+    public:
+      explicit EncodedEvent(mesos::master::Event _event)
+        : event(std::move(_event)) {}
+
+      // Returns the RecordIO record of the event for `contentType`.
+      const std::string& encode(ContentType contentType);
+
+      const mesos::master::Event event;
+
+    private:
+      std::map<ContentType, std::string> records;
+    };
+
     // Represents a client subscribed to the 'api/vX' endpoint.
     //
     // TODO(anand): Add support for filtering. Some subscribers
@@ -1969,61 +2184,79 @@ private:
       Subscriber(
           Master* _master,
           const HttpConnection& _http,
-          const Option<process::http::authentication::Principal> _principal)
-        : master(_master),
-          http(_http),
-          principal(_principal)
-      {
-        mesos::master::Event event;
-        event.set_type(mesos::master::Event::HEARTBEAT);
-
-        heartbeater =
-          process::Owned<Heartbeater<mesos::master::Event, v1::master::Event>>(
-              new Heartbeater<mesos::master::Event, v1::master::Event>(
-                  "subscriber " + stringify(http.streamId),
-                  event,
-                  http,
-                  DEFAULT_HEARTBEAT_INTERVAL,
-                  DEFAULT_HEARTBEAT_INTERVAL));
-
-        process::spawn(heartbeater.get());
-      }
+          const Option<process::http::authentication::Principal> _principal);
 
       // Not copyable, not assignable.
       Subscriber(const Subscriber&) = delete;
       Subscriber& operator=(const Subscriber&) = delete;
 
-      void send(const mesos::master::Event& event,
+      void send(const process::Owned<EncodedEvent>& event,
           const process::Owned<AuthorizationAcceptor>& authorizeRole,
           const process::Owned<AuthorizationAcceptor>& authorizeFramework,
           const process::Owned<AuthorizationAcceptor>& authorizeTask,
           const process::Owned<AuthorizationAcceptor>& authorizeExecutor);
 
-      ~Subscriber()
-      {
-        // TODO(anand): Refactor `HttpConnection` to being a RAII class instead.
-        // It is possible that a caller might accidentally invoke `close()`
-        // after passing ownership to the `Subscriber` object. See MESOS-5843
-        // for more details.
-        http.close();
-
-        terminate(heartbeater.get());
-        wait(heartbeater.get());
-      }
+      // Writes the encoded `record` to the subscriber, or buffers it
+      // until the next `flush()` if the records are written in batches
+      // (see `--operator_event_stream_flush_interval`).
+      void write(const std::string& record);
+
+      // Writes all of the buffered records to the subscriber.
+      void flush();
+
+      ~Subscriber();
 
       Master* master;
       HttpConnection http;
       process::Owned<Heartbeater<mesos::master::Event, v1::master::Event>>
         heartbeater;
       const Option<process::http::authentication::Principal> principal;
+
+      // The acceptors that authorize the events sent to the subscriber.
+      // Like the authorization of a framework, they are only created
+      // once when the client subscribes, rather than for every event.
+      process::Future<std::tuple<
+          process::Owned<AuthorizationAcceptor>,
+          process::Owned<AuthorizationAcceptor>,
+          process::Owned<AuthorizationAcceptor>,
+          process::Owned<AuthorizationAcceptor>>> acceptors;
+
+      // The records that have not been written yet, and whether a
+      // `flush()` has been scheduled for them.
+      std::string buffered;
+      bool flushing = false;
     };
 
-    // Sends the event to all subscribers connected to the 'api/vX' endpoint.
+    // Returns whether the events of the master have to be sent, i.e.,
+    // whether a client has subscribed since the master started. Once
+    // it has, the events are logged for the clients to resume from
+    // even if no client remains subscribed.
+    bool active() const { return version.isSome(); }
+
+    // Sends the event to all subscribers connected to the 'api/vX'
+    // endpoint, with the next version, and logs it.
     void send(const mesos::master::Event& event);
 
+    // Sends the logged events after `version` to the subscriber with
+    // the stream identifier `id`. Returns false, without sending any
+    // event, if the events after `version` are no longer all logged.
+    bool resume(const UUID& id, uint64_t version);
+
     // Active subscribers to the 'api/vX' endpoint keyed by the stream
     // identifier.
     hashmap<UUID, process::Owned<Subscriber>> subscribed;
+
+    // The version of the last event sent, set when the first client
+    // subscribes.
+    Option<uint64_t> version;
+
+    // The last events sent, see `OPERATOR_EVENT_LOG_SIZE`.
+    std::deque<process::Owned<EncodedEvent>> log;
+
+  private:
+    void send(
+        const process::Owned<Subscriber>& subscriber,
+        const process::Owned<EncodedEvent>& event);
   } subscribers;
 
   hashmap<OfferID, Offer*> offers;
@@ -2032,6 +2265,12 @@ private:
   hashmap<OfferID, InverseOffer*> inverseOffers;
   hashmap<OfferID, process::Timer> inverseOfferTimers;
 
+  // The resources recovered while removing a framework or an agent,
+  // which are accumulated to avoid dispatching to the allocator for
+  // each of its (possibly hundreds of thousands of) tasks. This is
+  // `None` outside of such removals.
+  Option<hashmap<FrameworkID, hashmap<SlaveID, Resources>>> recoveries;
+
   // We track information about roles that we're aware of in the system.
   // Specifically, we keep track of the roles when a framework subscribes to
   // the role, and/or when there are resources allocated to the role
@@ -2053,7 +2292,10 @@ private:
   // Authenticator names as supplied via flags.
   std::vector<std::string> authenticatorNames;
 
-  Option<Authenticator*> authenticator;
+  // The instances of the authenticator, see `--authenticator_workers`.
+  // The authentications of a PID always go to the same instance. Empty
+  // if the authenticator could not be initialized.
+  std::vector<Authenticator*> authenticators;
 
   // Frameworks/slaves that are currently in the process of authentication.
   // 'authenticating' future is completed when authenticator
@@ -2064,6 +2306,11 @@ private:
   // Principals of authenticated frameworks/slaves keyed by PID.
   hashmap<process::UPID, std::string> authenticated;
 
+#ifdef USE_SSL_SOCKET
+  // The key signing the authentication tokens, if they are enabled.
+  Option<std::string> authenticationTokenKey;
+#endif // USE_SSL_SOCKET
+
   int64_t nextFrameworkId; // Used to give each framework a unique ID.
   int64_t nextOfferId;     // Used to give each slot offer a unique ID.
   int64_t nextSlaveId;     // Used to give each slave a unique ID.
@@ -2101,6 +2348,11 @@ private:
     return offers.size();
   }
 
+  double _authentication_pending()
+  {
+    return authenticating.size();
+  }
+
   double _event_queue_messages()
   {
     return static_cast<double>(eventCount<process::MessageEvent>());
@@ -2134,6 +2386,10 @@ private:
 
   Option<process::Time> electedTime; // Time when this master is elected.
 
+  // Incremented before serving any event that might change the state
+  // of the master, see `Master::serve()`.
+  uint64_t generation = 0;
+
   // Validates the framework including authorization.
   // Returns None if the framework is valid.
   // Returns Error if the framework is invalid.
@@ -2237,6 +2493,7 @@ struct Framework
       const Resources resources = task->resources();
       totalUsedResources += resources;
       usedResources[task->slave_id()] += resources;
+      addResources(usedResourcesByRole, resources);
 
       // It's possible that we're not tracking the task's role for
       // this framework if the role is absent from the framework's
@@ -2264,11 +2521,13 @@ struct Framework
       << "Unknown task " << task->task_id()
       << " of framework " << task->framework_id();
 
-    totalUsedResources -= task->resources();
-    usedResources[task->slave_id()] -= task->resources();
+    const Resources resources = task->resources();
+    totalUsedResources -= resources;
+    usedResources[task->slave_id()] -= resources;
     if (usedResources[task->slave_id()].empty()) {
       usedResources.erase(task->slave_id());
     }
+    removeResources(usedResourcesByRole, resources);
 
     // If we are no longer subscribed to the role to which these resources are
     // being returned to, and we have no more resources allocated to us for that
@@ -2277,13 +2536,8 @@ struct Framework
     const std::string& role =
       task->resources().begin()->allocation_info().role();
 
-    auto allocatedToRole = [&role](const Resource& resource) {
-      return resource.allocation_info().role() == role;
-    };
-
-    if (roles.count(role) == 0 &&
-        totalUsedResources.filter(allocatedToRole).empty()) {
-      CHECK(totalOfferedResources.filter(allocatedToRole).empty());
+    if (roles.count(role) == 0 && !usedResourcesByRole.contains(role)) {
+      CHECK(!offeredResourcesByRole.contains(role));
       untrackUnderRole(role);
     }
   }
@@ -2315,7 +2569,7 @@ struct Framework
     // means that there might be multiple completed tasks with the
     // same task ID. We should consider rejecting attempts to reuse
     // task IDs (MESOS-6779).
-    completedTasks.push_back(process::Owned<Task>(new Task(std::move(task))));
+    completedTasks.push_back(std::move(task));
   }
 
   void addUnreachableTask(const Task& task)
@@ -2353,8 +2607,11 @@ struct Framework
   {
     CHECK(!offers.contains(offer)) << "Duplicate offer " << offer->id();
     offers.insert(offer);
-    totalOfferedResources += offer->resources();
-    offeredResources[offer->slave_id()] += offer->resources();
+
+    const Resources resources = offer->resources();
+    totalOfferedResources += resources;
+    offeredResources[offer->slave_id()] += resources;
+    addResources(offeredResourcesByRole, resources);
   }
 
   void removeOffer(Offer* offer)
@@ -2362,11 +2619,13 @@ struct Framework
     CHECK(offers.find(offer) != offers.end())
       << "Unknown offer " << offer->id();
 
-    totalOfferedResources -= offer->resources();
-    offeredResources[offer->slave_id()] -= offer->resources();
+    const Resources resources = offer->resources();
+    totalOfferedResources -= resources;
+    offeredResources[offer->slave_id()] -= resources;
     if (offeredResources[offer->slave_id()].empty()) {
       offeredResources.erase(offer->slave_id());
     }
+    removeResources(offeredResourcesByRole, resources);
 
     offers.erase(offer);
   }
@@ -2407,8 +2666,11 @@ struct Framework
     }
 
     executors[slaveId][executorInfo.executor_id()] = executorInfo;
-    totalUsedResources += executorInfo.resources();
-    usedResources[slaveId] += executorInfo.resources();
+
+    const Resources resources = executorInfo.resources();
+    totalUsedResources += resources;
+    usedResources[slaveId] += resources;
+    addResources(usedResourcesByRole, resources);
 
     // It's possible that we're not tracking the task's role for
     // this framework if the role is absent from the framework's
@@ -2434,11 +2696,13 @@ struct Framework
 
     const ExecutorInfo& executorInfo = executors[slaveId][executorId];
 
-    totalUsedResources -= executorInfo.resources();
-    usedResources[slaveId] -= executorInfo.resources();
+    const Resources resources = executorInfo.resources();
+    totalUsedResources -= resources;
+    usedResources[slaveId] -= resources;
     if (usedResources[slaveId].empty()) {
       usedResources.erase(slaveId);
     }
+    removeResources(usedResourcesByRole, resources);
 
     // If we are no longer subscribed to the role to which these resources are
     // being returned to, and we have no more resources allocated to us for that
@@ -2447,13 +2711,8 @@ struct Framework
       const std::string& role =
         executorInfo.resources().begin()->allocation_info().role();
 
-      auto allocatedToRole = [&role](const Resource& resource) {
-        return resource.allocation_info().role() == role;
-      };
-
-      if (roles.count(role) == 0 &&
-          totalUsedResources.filter(allocatedToRole).empty()) {
-        CHECK(totalOfferedResources.filter(allocatedToRole).empty());
+      if (roles.count(role) == 0 && !usedResourcesByRole.contains(role)) {
+        CHECK(!offeredResourcesByRole.contains(role));
         untrackUnderRole(role);
       }
     }
@@ -2497,6 +2756,7 @@ struct Framework
 
       totalUsedResources += consumed.get();
       usedResources[slaveId] += consumed.get();
+      addResources(usedResourcesByRole, consumed.get());
 
       // It's possible that we're not tracking the role from the
       // resources in the offer operation for this framework if the
@@ -2537,19 +2797,15 @@ struct Framework
     if (usedResources[slaveId].empty()) {
       usedResources.erase(slaveId);
     }
+    removeResources(usedResourcesByRole, consumed.get());
 
     // If we are no longer subscribed to the role to which these
     // resources are being returned to, and we have no more resources
     // allocated to us for that role, stop tracking the framework
     // under the role.
     foreachkey (const std::string& role, consumed->allocations()) {
-      auto allocatedToRole = [&role](const Resource& resource) {
-        return resource.allocation_info().role() == role;
-      };
-
-      if (roles.count(role) == 0 &&
-          totalUsedResources.filter(allocatedToRole).empty()) {
-        CHECK(totalOfferedResources.filter(allocatedToRole).empty());
+      if (roles.count(role) == 0 && !usedResourcesByRole.contains(role)) {
+        CHECK(!offeredResourcesByRole.contains(role));
         untrackUnderRole(role);
       }
     }
@@ -2663,14 +2919,10 @@ struct Framework
     }();
 
     foreach (const std::string& role, removedRoles) {
-      auto allocatedToRole = [&role](const Resource& resource) {
-        return resource.allocation_info().role() == role;
-      };
-
       // Stop tracking the framework under this role if there are
       // no longer any resources allocated to it.
-      if (totalUsedResources.filter(allocatedToRole).empty()) {
-        CHECK(totalOfferedResources.filter(allocatedToRole).empty());
+      if (!usedResourcesByRole.contains(role)) {
+        CHECK(!offeredResourcesByRole.contains(role));
         untrackUnderRole(role);
       }
     }
@@ -2774,6 +3026,38 @@ struct Framework
   void trackUnderRole(const std::string& role);
   void untrackUnderRole(const std::string& role);
 
+  // Adds (removes) the resources to (from) the per-role breakdown
+  // of the resources, see `usedResourcesByRole`.
+  static void addResources(
+      hashmap<std::string, Resources>& resourcesByRole,
+      const Resources& resources)
+  {
+    foreachpair (const std::string& role,
+                 const Resources& allocation,
+                 resources.allocations()) {
+      resourcesByRole[role] += allocation;
+    }
+  }
+
+  static void removeResources(
+      hashmap<std::string, Resources>& resourcesByRole,
+      const Resources& resources)
+  {
+    foreachpair (const std::string& role,
+                 const Resources& allocation,
+                 resources.allocations()) {
+      auto it = resourcesByRole.find(role);
+      if (it == resourcesByRole.end()) {
+        continue;
+      }
+
+      it->second -= allocation;
+      if (it->second.empty()) {
+        resourcesByRole.erase(it);
+      }
+    }
+  }
+
   Master* const master;
 
   FrameworkInfo info;
@@ -2805,10 +3089,8 @@ struct Framework
 
   // Tasks launched by this framework that have reached a terminal
   // state and have had all their updates acknowledged. We only keep a
-  // fixed-size cache to avoid consuming too much memory. We use
-  // boost::circular_buffer rather than BoundedHashMap because there
-  // can be multiple completed tasks with the same task ID.
-  boost::circular_buffer<process::Owned<Task>> completedTasks;
+  // fixed-size archive to avoid consuming too much memory.
+  CompletedTasks completedTasks;
 
   // When an agent is marked unreachable, tasks running on it are stored
   // here. We only keep a fixed-size cache to avoid consuming too much memory.
@@ -2866,6 +3148,14 @@ struct Framework
   Resources totalOfferedResources;
   hashmap<SlaveID, Resources> offeredResources;
 
+  // The used and offered resources, keyed by the role they are
+  // allocated to. These are maintained along with the totals, so that
+  // per-role aggregates (e.g., for the `/roles` endpoint) and checks
+  // for whether the framework has resources allocated to a role do
+  // not need to filter the total resources of the framework.
+  hashmap<std::string, Resources> usedResourcesByRole;
+  hashmap<std::string, Resources> offeredResourcesByRole;
+
   // This is only set for HTTP frameworks.
   Option<process::Owned<Heartbeater<scheduler::Event, v1::scheduler::Event>>>
     heartbeater;
@@ -2938,16 +3228,16 @@ struct Role
   {
     Resources resources;
 
-    auto allocatedTo = [](const std::string& role) {
-      return [role](const Resource& resource) {
-        CHECK(resource.has_allocation_info());
-        return resource.allocation_info().role() == role;
-      };
-    };
-
     foreachvalue (Framework* framework, frameworks) {
-      resources += framework->totalUsedResources.filter(allocatedTo(role));
-      resources += framework->totalOfferedResources.filter(allocatedTo(role));
+      auto used = framework->usedResourcesByRole.find(role);
+      if (used != framework->usedResourcesByRole.end()) {
+        resources += used->second;
+      }
+
+      auto offered = framework->offeredResourcesByRole.find(role);
+      if (offered != framework->offeredResourcesByRole.end()) {
+        resources += offered->second;
+      }
     }
 
     return resources;
@@ -57,6 +57,8 @@ struct Metrics
 
   process::metrics::Gauge outstanding_offers;
 
+  process::metrics::Gauge authentication_pending;
+
   // Task state metrics.
   process::metrics::Gauge tasks_staging;
   process::metrics::Gauge tasks_starting;
@@ -14,14 +14,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <deque>
+#include <list>
+#include <map>
+#include <set>
 #include <string>
 
 #include <mesos/type_utils.hpp>
 
 #include <mesos/state/state.hpp>
 
+#include <process/clock.hpp>
+#include <process/collect.hpp>
 #include <process/defer.hpp>
+#include <process/delay.hpp>
 #include <process/dispatch.hpp>
 #include <process/future.hpp>
 #include <process/help.hpp>
@@ -29,30 +36,44 @@
 #include <process/id.hpp>
 #include <process/owned.hpp>
 #include <process/process.hpp>
+#include <process/statistics.hpp>
+#include <process/timer.hpp>
 
 #include <process/metrics/gauge.hpp>
 #include <process/metrics/metrics.hpp>
+#include <process/metrics/push_gauge.hpp>
 #include <process/metrics/timer.hpp>
 
+#include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/hashset.hpp>
 #include <stout/lambda.hpp>
 #include <stout/none.hpp>
 #include <stout/nothing.hpp>
+#include <stout/numify.hpp>
 #include <stout/option.hpp>
 #include <stout/protobuf.hpp>
 #include <stout/stopwatch.hpp>
+#include <stout/strings.hpp>
 
+#include "master/constants.hpp"
 #include "master/registrar.hpp"
 #include "master/registry.hpp"
 
+using google::protobuf::RepeatedPtrField;
+
 using mesos::state::State;
 using mesos::state::Variable;
 
+using process::collect;
+using process::delay;
 using process::dispatch;
 using process::spawn;
 using process::terminate;
 using process::wait; // Necessary on some OS's to disambiguate.
 
 using process::AUTHENTICATION;
+using process::Clock;
 using process::DESCRIPTION;
 using process::Failure;
 using process::Future;
@@ -61,6 +82,7 @@ using process::Owned;
 using process::PID;
 using process::Process;
 using process::Promise;
+using process::Statistics;
 using process::TLDR;
 
 using process::http::OK;
@@ -68,9 +90,12 @@ using process::http::OK;
 using process::http::authentication::Principal;
 
 using process::metrics::Gauge;
+using process::metrics::PushGauge;
 using process::metrics::Timer;
 
 using std::deque;
+using std::list;
+using std::map;
 using std::string;
 
 namespace mesos {
@@ -92,6 +117,9 @@ public:
     : ProcessBase(process::ID::generate("registrar")),
       metrics(*this),
       state(_state),
+      snapshotSize(0),
+      deltasSize(0),
+      nextDelta(0),
       updating(false),
       flags(_flags),
       authenticationRealm(_authenticationRealm) {}
@@ -156,13 +184,16 @@ private:
             "registrar/registry_size_bytes",
             defer(process, &RegistrarProcess::_registry_size_bytes)),
         state_fetch("registrar/state_fetch"),
-        state_store("registrar/state_store", Days(1))
+        state_store("registrar/state_store", Days(1)),
+        batch_size("registrar/batch_size", Days(1))
     {
       process::metrics::add(queued_operations);
       process::metrics::add(registry_size_bytes);
 
       process::metrics::add(state_fetch);
       process::metrics::add(state_store);
+
+      process::metrics::add(batch_size);
     }
 
     ~Metrics()
@@ -172,6 +203,8 @@ private:
 
       process::metrics::remove(state_fetch);
       process::metrics::remove(state_store);
+
+      process::metrics::remove(batch_size);
     }
 
     Gauge queued_operations;
@@ -179,6 +212,9 @@ private:
 
     Timer<Milliseconds> state_fetch;
     Timer<Milliseconds> state_store;
+
+    // Number of operations applied in each store.
+    PushGauge batch_size;
   } metrics;
 
   // Gauge handlers.
@@ -200,15 +236,34 @@ private:
   void _recover(
       const MasterInfo& info,
       const Future<Variable>& recovery);
-  void __recover(const Future<bool>& recover);
+  void __recover(
+      const MasterInfo& info,
+      const Future<list<Variable>>& recovery);
+  void ___recover(const Future<bool>& recover);
   Future<bool> _apply(Owned<Operation> operation);
 
+  // Fetches the variables holding the registry deltas in the order
+  // in which they were stored, given the names of all variables.
+  Future<list<Variable>> fetchDeltas(const std::set<string>& names);
+
+  // Starts an update right away, or once more operations have been
+  // queued, based on `--registry_max_batch_size` and
+  // `--registry_batch_linger`.
+  void schedule();
+  void linger();
+
   // Helper for updating state (performing store).
   void update();
   void _update(
       const Future<Option<Variable>>& store,
       const Owned<Registry>& updatedRegistry,
-      deque<Owned<Operation>> operations);
+      deque<Owned<Operation>> operations,
+      const Option<RegistryDelta>& delta);
+
+  // Helper for expunging the registry deltas once a snapshot of
+  // the registry that includes them has been stored.
+  void compact();
+  void _compact(const Future<bool>& expunge);
 
   // Fails all pending operations and transitions the Registrar
   // into an error state in which all subsequent operations will fail.
@@ -230,9 +285,23 @@ private:
   Option<Variable> variable;
   Option<Registry> registry;
 
+  // When `--registry_deltas` is set, changes that only affect the
+  // agents are stored as `RegistryDelta`s in separate variables,
+  // named by `REGISTRY_DELTA_PREFIX` and an increasing sequence
+  // number, rather than storing the entire registry. These are the
+  // deltas stored since the last snapshot, oldest first, which are
+  // expunged once a new snapshot has been stored.
+  deque<Variable> deltas;
+  size_t snapshotSize;
+  size_t deltasSize;
+  uint64_t nextDelta;
+
   deque<Owned<Operation>> operations;
   bool updating; // Used to signify fetching (recovering) or storing.
 
+  // Set while waiting for more operations before an update.
+  Option<process::Timer> lingering;
+
   const Flags flags;
 
   // Used to compose our operations with recovery.
@@ -272,6 +341,200 @@ void fail(deque<Owned<Operation>>* operations, const string& message)
 }
 
 
+static const char REGISTRY_DELTA_PREFIX[] = "registry_delta_";
+
+
+static const SlaveID& slaveID(const Registry::Slave& slave)
+{
+  return slave.info().id();
+}
+
+
+static const SlaveID& slaveID(const Registry::UnreachableSlave& slave)
+{
+  return slave.id();
+}
+
+
+static const SlaveID& slaveID(const Registry::GoneSlave& slave)
+{
+  return slave.id();
+}
+
+
+static bool equal(
+    const google::protobuf::Message& left,
+    const google::protobuf::Message& right)
+{
+  return left.SerializePartialAsString() ==
+    right.SerializePartialAsString();
+}
+
+
+template <typename T>
+static bool equal(
+    const RepeatedPtrField<T>& left,
+    const RepeatedPtrField<T>& right)
+{
+  if (left.size() != right.size()) {
+    return false;
+  }
+
+  for (int i = 0; i < left.size(); i++) {
+    if (!equal(left.Get(i), right.Get(i))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+// Records the entries of `to` that are new or differ from `from` in
+// `updated`, and the IDs of the agents that are only in `from` in
+// `removed`.
+template <typename T>
+static void diff(
+    const RepeatedPtrField<T>& from,
+    const RepeatedPtrField<T>& to,
+    RepeatedPtrField<T>* updated,
+    RepeatedPtrField<SlaveID>* removed)
+{
+  hashmap<SlaveID, const T*> previous;
+  foreach (const T& entry, from) {
+    previous[slaveID(entry)] = &entry;
+  }
+
+  foreach (const T& entry, to) {
+    auto it = previous.find(slaveID(entry));
+
+    if (it == previous.end() || !equal(*it->second, entry)) {
+      updated->Add()->CopyFrom(entry);
+    }
+
+    if (it != previous.end()) {
+      previous.erase(it);
+    }
+  }
+
+  foreachkey (const SlaveID& slaveId, previous) {
+    removed->Add()->CopyFrom(slaveId);
+  }
+}
+
+
+// Inverse of `diff()`: removes the agents in `removed` from `entries`
+// and then replaces or appends the entries in `updated`. The relative
+// order of the remaining entries is preserved.
+template <typename T>
+static void patch(
+    RepeatedPtrField<T>* entries,
+    const RepeatedPtrField<T>& updated,
+    const RepeatedPtrField<SlaveID>& removed)
+{
+  if (!removed.empty()) {
+    hashset<SlaveID> ids;
+    foreach (const SlaveID& slaveId, removed) {
+      ids.insert(slaveId);
+    }
+
+    int size = 0;
+    for (int i = 0; i < entries->size(); i++) {
+      if (!ids.contains(slaveID(entries->Get(i)))) {
+        entries->SwapElements(i, size++);
+      }
+    }
+
+    while (entries->size() > size) {
+      entries->RemoveLast();
+    }
+  }
+
+  if (!updated.empty()) {
+    hashmap<SlaveID, int> indices;
+    for (int i = 0; i < entries->size(); i++) {
+      indices[slaveID(entries->Get(i))] = i;
+    }
+
+    foreach (const T& entry, updated) {
+      Option<int> index = indices.get(slaveID(entry));
+
+      if (index.isSome()) {
+        entries->Mutable(index.get())->CopyFrom(entry);
+      } else {
+        indices[slaveID(entry)] = entries->size();
+        entries->Add()->CopyFrom(entry);
+      }
+    }
+  }
+}
+
+
+// Returns the changes to the agents between the two registries, or
+// none if anything other than the agents changed, in which case the
+// entire registry needs to be stored.
+//
+// NOTE: Any fields added to `Registry` must be compared here.
+static Option<RegistryDelta> diff(const Registry& from, const Registry& to)
+{
+  if (from.has_master() != to.has_master() ||
+      !equal(from.master(), to.master()) ||
+      from.has_machines() != to.has_machines() ||
+      !equal(from.machines(), to.machines()) ||
+      !equal(from.schedules(), to.schedules()) ||
+      !equal(from.quotas(), to.quotas()) ||
+      !equal(from.weights(), to.weights()) ||
+      from.has_resource_provider_registry() !=
+        to.has_resource_provider_registry() ||
+      !equal(
+          from.resource_provider_registry(),
+          to.resource_provider_registry())) {
+    return None();
+  }
+
+  RegistryDelta delta;
+
+  diff(from.slaves().slaves(),
+       to.slaves().slaves(),
+       delta.mutable_slaves(),
+       delta.mutable_removed_slaves());
+
+  diff(from.unreachable().slaves(),
+       to.unreachable().slaves(),
+       delta.mutable_unreachable(),
+       delta.mutable_removed_unreachable());
+
+  diff(from.gone().slaves(),
+       to.gone().slaves(),
+       delta.mutable_gone(),
+       delta.mutable_removed_gone());
+
+  return delta;
+}
+
+
+static void patch(Registry* registry, const RegistryDelta& delta)
+{
+  if (!delta.slaves().empty() || !delta.removed_slaves().empty()) {
+    patch(registry->mutable_slaves()->mutable_slaves(),
+          delta.slaves(),
+          delta.removed_slaves());
+  }
+
+  if (!delta.unreachable().empty() || !delta.removed_unreachable().empty()) {
+    patch(registry->mutable_unreachable()->mutable_slaves(),
+          delta.unreachable(),
+          delta.removed_unreachable());
+  }
+
+  if (!delta.gone().empty() || !delta.removed_gone().empty()) {
+    patch(registry->mutable_gone()->mutable_slaves(),
+          delta.gone(),
+          delta.removed_gone());
+  }
+}
+
+
 Future<Response> RegistrarProcess::getRegistry(
     const Request& request,
     const Option<Principal>&)
@@ -386,30 +649,115 @@ void RegistrarProcess::_recover(
     return;
   }
 
-  Duration elapsed = metrics.state_fetch.stop();
-
-  LOG(INFO) << "Successfully fetched the registry"
-            << " (" << Bytes(deserialized->ByteSize()) << ")"
-            << " in " << elapsed;
-
   // Save the registry.
   variable = recovery.get();
+  snapshotSize = recovery->value().size();
 
   // Workaround for immovable protobuf messages.
   registry = Option<Registry>(Registry());
   registry->Swap(&deserialized.get());
 
-  // Perform the Recover operation to add the new MasterInfo.
+  // The deltas stored since the snapshot are applied on top of it,
+  // regardless of `--registry_deltas`, since they may have been
+  // stored by a previous master.
+  updating = true;
+
+  state->names()
+    .then(defer(self(), &Self::fetchDeltas, lambda::_1))
+    .after(flags.registry_fetch_timeout,
+           lambda::bind(
+               &timeout<list<Variable>>,
+               "fetch",
+               flags.registry_fetch_timeout,
+               lambda::_1))
+    .onAny(defer(self(), &Self::__recover, info, lambda::_1));
+}
+
+
+Future<list<Variable>> RegistrarProcess::fetchDeltas(
+    const std::set<string>& names)
+{
+  map<uint64_t, string> sorted;
+
+  foreach (const string& name, names) {
+    if (!strings::startsWith(name, REGISTRY_DELTA_PREFIX)) {
+      continue;
+    }
+
+    Try<uint64_t> sequence = numify<uint64_t>(
+        strings::remove(name, REGISTRY_DELTA_PREFIX, strings::PREFIX));
+
+    if (sequence.isError()) {
+      return Failure(
+          "Failed to parse registry delta '" + name + "': " +
+          sequence.error());
+    }
+
+    sorted[sequence.get()] = name;
+  }
+
+  if (!sorted.empty()) {
+    nextDelta = sorted.rbegin()->first + 1;
+  }
+
+  list<Future<Variable>> futures;
+  foreachvalue (const string& name, sorted) {
+    futures.push_back(state->fetch(name));
+  }
+
+  return collect(futures);
+}
+
+
+void RegistrarProcess::__recover(
+    const MasterInfo& info,
+    const Future<list<Variable>>& recovery)
+{
+  updating = false;
+
+  CHECK(!recovery.isPending());
+
+  if (!recovery.isReady()) {
+    recovered.get()->fail("Failed to recover registrar: " +
+        (recovery.isFailed() ? recovery.failure() : "discarded"));
+    return;
+  }
+
+  foreach (const Variable& variable, recovery.get()) {
+    Try<RegistryDelta> delta =
+      ::protobuf::deserialize<RegistryDelta>(variable.value());
+    if (delta.isError()) {
+      recovered.get()->fail("Failed to recover registrar: " +
+                            delta.error());
+      return;
+    }
+
+    patch(&registry.get(), delta.get());
+
+    deltas.push_back(variable);
+    deltasSize += variable.value().size();
+  }
+
+  Duration elapsed = metrics.state_fetch.stop();
+
+  LOG(INFO) << "Successfully fetched the registry"
+            << " (" << Bytes(snapshotSize) << ")"
+            << " and " << deltas.size() << " deltas"
+            << " (" << Bytes(deltasSize) << ")"
+            << " in " << elapsed;
+
+  // Perform the Recover operation to add the new MasterInfo. This
+  // also compacts the deltas, since the MasterInfo is not an agent.
   Owned<Operation> operation(new Recover(info));
   operations.push_back(operation);
   operation->future()
-    .onAny(defer(self(), &Self::__recover, lambda::_1));
+    .onAny(defer(self(), &Self::___recover, lambda::_1));
 
   update();
 }
 
 
-void RegistrarProcess::__recover(const Future<bool>& recover)
+void RegistrarProcess::___recover(const Future<bool>& recover)
 {
   CHECK(!recover.isPending());
 
@@ -455,14 +803,59 @@ Future<bool> RegistrarProcess::_apply(Owned<Operation> operation)
   operations.push_back(operation);
   Future<bool> future = operation->future();
   if (!updating) {
-    update();
+    schedule();
   }
   return future;
 }
 
 
+void RegistrarProcess::schedule()
+{
+  CHECK(!updating);
+
+  if (flags.registry_max_batch_size.isSome() &&
+      operations.size() >= flags.registry_max_batch_size.get()) {
+    update();
+    return;
+  }
+
+  Duration duration = flags.registry_batch_linger;
+
+  // Waiting for longer than a typical store takes would add more
+  // latency than batching saves.
+  Option<Statistics<double>> statistics = metrics.state_store.statistics();
+  if (statistics.isSome()) {
+    duration = std::min(duration, Milliseconds(1) * statistics->p50);
+  }
+
+  if (duration <= Duration::zero()) {
+    update();
+    return;
+  }
+
+  if (lingering.isNone()) {
+    lingering = delay(duration, self(), &Self::linger);
+  }
+}
+
+
+void RegistrarProcess::linger()
+{
+  lingering = None();
+
+  if (!updating) {
+    update();
+  }
+}
+
+
 void RegistrarProcess::update()
 {
+  if (lingering.isSome()) {
+    Clock::cancel(lingering.get());
+    lingering = None();
+  }
+
   if (operations.empty()) {
     return; // No-op.
   }
@@ -477,6 +870,20 @@ void RegistrarProcess::update()
 
   updating = true;
 
+  // Take the operations for this update, the rest remain queued
+  // for the next update.
+  size_t size = operations.size();
+  if (flags.registry_max_batch_size.isSome()) {
+    size = std::min(size, flags.registry_max_batch_size.get());
+  }
+
+  deque<Owned<Operation>> batch(
+      operations.begin(), operations.begin() + size);
+
+  operations.erase(operations.begin(), operations.begin() + size);
+
+  metrics.batch_size = static_cast<double>(batch.size());
+
   // Create a snapshot of the current registry. We use an `Owned` here
   // to avoid copying, since protobuf doesn't suppport move construction.
   auto updatedRegistry = Owned<Registry>(new Registry(registry.get()));
@@ -487,27 +894,69 @@ void RegistrarProcess::update()
     slaveIDs.insert(slave.info().id());
   }
 
-  foreach (Owned<Operation>& operation, operations) {
+  foreach (Owned<Operation>& operation, batch) {
     // No need to process the result of the operation.
     (*operation)(updatedRegistry.get(), &slaveIDs);
   }
 
-  LOG(INFO) << "Applied " << operations.size() << " operations in "
+  LOG(INFO) << "Applied " << batch.size() << " operations in "
             << stopwatch.elapsed() << "; attempting to update the registry";
 
   // Perform the store, and time the operation.
   metrics.state_store.start();
 
-  // Serialize updated registry.
-  Try<string> serialized = ::protobuf::serialize(*updatedRegistry);
-  if (serialized.isError()) {
-    string message = "Failed to update registry: " + serialized.error();
-    fail(&operations, message);
-    abort(message);
-    return;
+  // When only agents changed, try to store just the changes. We fall
+  // back to storing the entire registry once the deltas would take
+  // longer to recover than the registry itself, which also bounds the
+  // number of variables that are expunged when compacting.
+  Option<RegistryDelta> delta;
+  if (flags.registry_deltas) {
+    delta = diff(registry.get(), *updatedRegistry);
   }
 
-  state->store(variable->mutate(serialized.get()))
+  Option<string> serialized;
+
+  if (delta.isSome() && deltas.size() < REGISTRY_MAX_DELTAS) {
+    Try<string> serializedDelta = ::protobuf::serialize(delta.get());
+    if (serializedDelta.isError()) {
+      string message = "Failed to update registry: " + serializedDelta.error();
+      fail(&batch, message);
+      abort(message);
+      return;
+    }
+
+    if (deltasSize + serializedDelta->size() <= snapshotSize) {
+      serialized = serializedDelta.get();
+    }
+  }
+
+  Future<Option<Variable>> store;
+
+  if (serialized.isSome()) {
+    const string name = REGISTRY_DELTA_PREFIX + stringify(nextDelta++);
+    const string value = serialized.get();
+
+    store = state->fetch(name)
+      .then(defer(self(), [=](const Variable& variable) {
+        return state->store(variable.mutate(value));
+      }));
+  } else {
+    delta = None();
+
+    // Serialize updated registry.
+    Try<string> serializedRegistry = ::protobuf::serialize(*updatedRegistry);
+    if (serializedRegistry.isError()) {
+      string message =
+        "Failed to update registry: " + serializedRegistry.error();
+      fail(&batch, message);
+      abort(message);
+      return;
+    }
+
+    store = state->store(variable->mutate(serializedRegistry.get()));
+  }
+
+  store
     .after(flags.registry_store_timeout,
            lambda::bind(
                &timeout<Option<Variable>>,
@@ -515,17 +964,20 @@ void RegistrarProcess::update()
                flags.registry_store_timeout,
                lambda::_1))
     .onAny(defer(
-        self(), &Self::_update, lambda::_1, updatedRegistry, operations));
-
-  // Clear the operations, _update will transition the Promises!
-  operations.clear();
+        self(),
+        &Self::_update,
+        lambda::_1,
+        updatedRegistry,
+        batch,
+        delta));
 }
 
 
 void RegistrarProcess::_update(
     const Future<Option<Variable>>& store,
     const Owned<Registry>& updatedRegistry,
-    deque<Owned<Operation>> applied)
+    deque<Owned<Operation>> applied,
+    const Option<RegistryDelta>& delta)
 {
   updating = false;
 
@@ -549,10 +1001,24 @@ void RegistrarProcess::_update(
 
   Duration elapsed = metrics.state_store.stop();
 
-  LOG(INFO) << "Successfully updated the registry in " << elapsed;
+  if (delta.isSome()) {
+    LOG(INFO) << "Successfully stored a registry delta in " << elapsed;
+
+    // We apply the delta rather than swapping in the updated registry
+    // so that the registry is exactly what a recovering master would
+    // reconstruct from the snapshot and the deltas.
+    patch(&registry.get(), delta.get());
+
+    deltas.push_back(store->get());
+    deltasSize += store->get().value().size();
+  } else {
+    LOG(INFO) << "Successfully updated the registry in " << elapsed;
+
+    variable = store->get();
+    registry->Swap(updatedRegistry.get());
 
-  variable = store.get().get();
-  registry->Swap(updatedRegistry.get());
+    snapshotSize = variable->value().size();
+  }
 
   // Remove the operations.
   while (!applied.empty()) {
@@ -562,12 +1028,70 @@ void RegistrarProcess::_update(
     operation->set();
   }
 
+  // The new snapshot includes all of the deltas, which we expunge
+  // before performing any further updates.
+  if (delta.isNone() && !deltas.empty()) {
+    deltasSize = 0;
+    compact();
+    return;
+  }
+
   if (!operations.empty()) {
     update();
   }
 }
 
 
+void RegistrarProcess::compact()
+{
+  if (deltas.empty()) {
+    updating = false;
+    update();
+    return;
+  }
+
+  updating = true;
+
+  // NOTE: The deltas are expunged oldest first so that, should we
+  // fail part way, a recovering master applies a suffix of the
+  // deltas to a snapshot that already includes them, which has no
+  // effect since applying a delta is idempotent.
+  state->expunge(deltas.front())
+    .after(flags.registry_store_timeout,
+           lambda::bind(
+               &timeout<bool>,
+               "expunge",
+               flags.registry_store_timeout,
+               lambda::_1))
+    .onAny(defer(self(), &Self::_compact, lambda::_1));
+}
+
+
+void RegistrarProcess::_compact(const Future<bool>& expunge)
+{
+  updating = false;
+
+  if (!expunge.isReady() || !expunge.get()) {
+    string message = "Failed to compact registry: ";
+
+    if (expunge.isFailed()) {
+      message += expunge.failure();
+    } else if (expunge.isDiscarded()) {
+      message += "discarded";
+    } else {
+      message += "version mismatch";
+    }
+
+    abort(message);
+    return;
+  }
+
+  deltas.pop_front();
+
+  compact();
+}
+
+
 void RegistrarProcess::abort(const string& message)
 {
   error = Error(message);
@@ -14,10 +14,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <vector>
+
+#include <stout/foreach.hpp>
+#include <stout/stringify.hpp>
+
 #include "master/registry_operations.hpp"
 
 #include "common/resources_utils.hpp"
 
+using std::vector;
+
 namespace mesos {
 namespace internal {
 namespace master {
@@ -140,6 +147,73 @@ Try<bool> MarkSlaveUnreachable::perform(
 }
 
 
+// Move several slaves at once from the list of admitted slaves to the
+// list of unreachable slaves.
+MarkSlavesUnreachable::MarkSlavesUnreachable(
+    const vector<SlaveInfo>& _infos,
+    const TimeInfo& _unreachableTime)
+  : infos(_infos)
+  , unreachableTime(_unreachableTime)
+{
+  foreach (const SlaveInfo& info, infos) {
+    CHECK(info.has_id()) << "SlaveInfo is missing the 'id' field";
+  }
+}
+
+
+Try<bool> MarkSlavesUnreachable::perform(
+    Registry* registry,
+    hashset<SlaveID>* slaveIDs)
+{
+  hashset<SlaveID> ids;
+
+  foreach (const SlaveInfo& info, infos) {
+    // As with `MarkSlaveUnreachable`, the master only marks slaves
+    // unreachable that are currently admitted.
+    if (!slaveIDs->contains(info.id())) {
+      return Error("Agent " + stringify(info.id()) + " not yet admitted");
+    }
+
+    ids.insert(info.id());
+  }
+
+  if (ids.empty()) {
+    return false; // No mutation.
+  }
+
+  // Remove the slaves within a single pass, keeping the order of the
+  // remaining admitted slaves.
+  google::protobuf::RepeatedPtrField<Registry::Slave>* slaves =
+    registry->mutable_slaves()->mutable_slaves();
+
+  int remaining = 0;
+  for (int i = 0; i < slaves->size(); i++) {
+    if (!ids.contains(slaves->Get(i).info().id())) {
+      slaves->SwapElements(i, remaining++);
+    }
+  }
+
+  if (slaves->size() - remaining != static_cast<int>(ids.size())) {
+    // Should not happen.
+    return Error("Failed to find all the agents " + stringify(ids));
+  }
+
+  slaves->DeleteSubrange(remaining, slaves->size() - remaining);
+
+  foreach (const SlaveID& id, ids) {
+    slaveIDs->erase(id);
+
+    Registry::UnreachableSlave* unreachable =
+      registry->mutable_unreachable()->add_slaves();
+
+    unreachable->mutable_id()->CopyFrom(id);
+    unreachable->mutable_timestamp()->CopyFrom(unreachableTime);
+  }
+
+  return true; // Mutation.
+}
+
+
 // Add a slave back to the list of admitted slaves. The slave will
 // typically be in the "unreachable" list; if so, it is removed from
 // that list. The slave might also be in the "admitted" list already.
@@ -17,6 +17,8 @@
 #ifndef __MASTER_REGISTRY_OPERATIONS_HPP__
 #define __MASTER_REGISTRY_OPERATIONS_HPP__
 
+#include <vector>
+
 #include <mesos/mesos.hpp>
 #include <mesos/type_utils.hpp>
 
@@ -73,6 +75,26 @@ private:
 };
 
 
+// Move several slaves at once from the list of admitted slaves to the
+// list of unreachable slaves, e.g., when a network partition cuts off
+// a whole rack. This is a single pass over the admitted slaves, rather
+// than one per slave as with a `MarkSlaveUnreachable` per slave.
+class MarkSlavesUnreachable : public Operation
+{
+public:
+  MarkSlavesUnreachable(
+      const std::vector<SlaveInfo>& _infos,
+      const TimeInfo& _unreachableTime);
+
+protected:
+  virtual Try<bool> perform(Registry* registry, hashset<SlaveID>* slaveIDs);
+
+private:
+  const std::vector<SlaveInfo> infos;
+  const TimeInfo unreachableTime;
+};
+
+
 // Add a slave back to the list of admitted slaves. The slave will
 // typically be in the "unreachable" list; if so, it is removed from
 // that list. The slave might also be in the "admitted" list already.
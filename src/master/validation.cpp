@@ -17,6 +17,7 @@
 #include "master/validation.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <set>
 #include <string>
@@ -1069,10 +1070,14 @@ Option<Error> validate(
   }
 
   const vector<lambda::function<Option<Error>()>> executorValidators = {
-    lambda::bind(internal::validateFrameworkID, executor, framework),
-    lambda::bind(internal::validateResources, executor),
     lambda::bind(
-        internal::validateCompatibleExecutorInfo, executor, framework, slave),
+        internal::validateFrameworkID, std::cref(executor), framework),
+    lambda::bind(internal::validateResources, std::cref(executor)),
+    lambda::bind(
+        internal::validateCompatibleExecutorInfo,
+        std::cref(executor),
+        framework,
+        slave),
   };
 
   foreach (const auto& validator, executorValidators) {
@@ -1301,15 +1306,15 @@ Option<Error> validateTask(
   // NOTE: The order in which the following validate functions are
   // executed does matter!
   vector<lambda::function<Option<Error>()>> validators = {
-    lambda::bind(internal::validateTaskID, task),
-    lambda::bind(internal::validateUniqueTaskID, task, framework),
-    lambda::bind(internal::validateSlaveID, task, slave),
-    lambda::bind(internal::validateKillPolicy, task),
-    lambda::bind(internal::validateCheck, task),
-    lambda::bind(internal::validateHealthCheck, task),
-    lambda::bind(internal::validateResources, task),
-    lambda::bind(internal::validateCommandInfo, task),
-    lambda::bind(internal::validateContainerInfo, task)
+    lambda::bind(internal::validateTaskID, std::cref(task)),
+    lambda::bind(internal::validateUniqueTaskID, std::cref(task), framework),
+    lambda::bind(internal::validateSlaveID, std::cref(task), slave),
+    lambda::bind(internal::validateKillPolicy, std::cref(task)),
+    lambda::bind(internal::validateCheck, std::cref(task)),
+    lambda::bind(internal::validateHealthCheck, std::cref(task)),
+    lambda::bind(internal::validateResources, std::cref(task)),
+    lambda::bind(internal::validateCommandInfo, std::cref(task)),
+    lambda::bind(internal::validateContainerInfo, std::cref(task))
   };
 
   foreach (const lambda::function<Option<Error>()>& validator, validators) {
@@ -1445,8 +1450,13 @@ Option<Error> validate(
   CHECK_NOTNULL(slave);
 
   vector<lambda::function<Option<Error>()>> validators = {
-    lambda::bind(internal::validateTask, task, framework, slave),
-    lambda::bind(internal::validateExecutor, task, framework, slave, offered)
+    lambda::bind(internal::validateTask, std::cref(task), framework, slave),
+    lambda::bind(
+        internal::validateExecutor,
+        std::cref(task),
+        framework,
+        slave,
+        std::cref(offered))
   };
 
   foreach (const lambda::function<Option<Error>()>& validator, validators) {
@@ -1881,11 +1891,11 @@ Option<Error> validate(
   CHECK_NOTNULL(framework);
 
   vector<lambda::function<Option<Error>()>> validators = {
-    lambda::bind(validateUniqueOfferID, offerIds),
-    lambda::bind(validateOfferIds, offerIds, master),
-    lambda::bind(validateFramework, offerIds, master, framework),
-    lambda::bind(validateAllocationRole, offerIds, master),
-    lambda::bind(validateSlave, offerIds, master)
+    lambda::bind(validateUniqueOfferID, std::cref(offerIds)),
+    lambda::bind(validateOfferIds, std::cref(offerIds), master),
+    lambda::bind(validateFramework, std::cref(offerIds), master, framework),
+    lambda::bind(validateAllocationRole, std::cref(offerIds), master),
+    lambda::bind(validateSlave, std::cref(offerIds), master)
   };
 
   foreach (const lambda::function<Option<Error>()>& validator, validators) {
@@ -1908,10 +1918,10 @@ Option<Error> validateInverseOffers(
   CHECK_NOTNULL(framework);
 
   vector<lambda::function<Option<Error>()>> validators = {
-    lambda::bind(validateUniqueOfferID, offerIds),
-    lambda::bind(validateInverseOfferIds, offerIds, master),
-    lambda::bind(validateFramework, offerIds, master, framework),
-    lambda::bind(validateSlave, offerIds, master)
+    lambda::bind(validateUniqueOfferID, std::cref(offerIds)),
+    lambda::bind(validateInverseOfferIds, std::cref(offerIds), master),
+    lambda::bind(validateFramework, std::cref(offerIds), master, framework),
+    lambda::bind(validateSlave, std::cref(offerIds), master)
   };
 
   foreach (const lambda::function<Option<Error>()>& validator, validators) {
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <deque>
 #include <numeric>
 
 #include <glog/logging.h>
@@ -149,6 +150,11 @@ static bool isValidType(const string& s)
 static const Duration CSI_ENDPOINT_CREATION_TIMEOUT = Seconds(5);
 
 
+// The maximum number of volumes returned by a `ListVolumes` call, to
+// keep the responses of plugins with many volumes reasonably sized.
+static const uint32_t CSI_LIST_VOLUMES_MAX_ENTRIES = 1000;
+
+
 // Returns a prefix for naming standalone containers to run CSI plugins
 // for the resource provider. The prefix is of the following format:
 //     <rp_type>-<rp_name>--
@@ -290,7 +296,8 @@ public:
       contentType(ContentType::PROTOBUF),
       info(_info),
       slaveId(_slaveId),
-      authToken(_authToken) {}
+      authToken(_authToken),
+      outstandingCalls(0) {}
 
   StorageLocalResourceProviderProcess(
       const StorageLocalResourceProviderProcess& other) = delete;
@@ -343,6 +350,17 @@ private:
   Future<csi::Client> getService(const ContainerID& containerId);
   Future<Nothing> killService(const ContainerID& containerId);
 
+  // Calls the plugin through the latest CSI client for the specified
+  // plugin container once the number of outstanding calls to the
+  // plugin is below `max_concurrent_calls`.
+  template <typename T>
+  Future<T> call(
+      const ContainerID& containerId,
+      const lambda::function<Future<T>(csi::Client)>& f);
+
+  Future<Nothing> acquireCall();
+  void releaseCall();
+
   Future<Nothing> prepareControllerService();
   Future<Nothing> prepareNodeService();
   Future<Resources> importResources();
@@ -406,6 +424,11 @@ private:
   hashmap<ContainerID, Owned<ContainerDaemon>> daemons;
   hashmap<ContainerID, Owned<Promise<csi::Client>>> services;
 
+  // The number of outstanding calls to the plugin, and the calls
+  // waiting for an outstanding one to complete.
+  size_t outstandingCalls;
+  std::deque<Owned<Promise<Nothing>>> pendingCalls;
+
   Option<csi::GetPluginInfoResponse> controllerInfo;
   Option<csi::GetPluginInfoResponse> nodeInfo;
   Option<csi::ControllerCapabilities> controllerCapabilities;
@@ -1370,6 +1393,49 @@ Future<csi::Client> StorageLocalResourceProviderProcess::getService(
 }
 
 
+template <typename T>
+Future<T> StorageLocalResourceProviderProcess::call(
+    const ContainerID& containerId,
+    const lambda::function<Future<T>(csi::Client)>& f)
+{
+  return acquireCall()
+    .then(defer(self(), &Self::getService, containerId))
+    .then(defer(self(), f))
+    .onAny(defer(self(), &Self::releaseCall));
+}
+
+
+Future<Nothing> StorageLocalResourceProviderProcess::acquireCall()
+{
+  const uint32_t maxConcurrentCalls =
+    info.storage().plugin().max_concurrent_calls();
+
+  if (maxConcurrentCalls == 0 || outstandingCalls < maxConcurrentCalls) {
+    outstandingCalls++;
+    return Nothing();
+  }
+
+  pendingCalls.emplace_back(new Promise<Nothing>());
+  return pendingCalls.back()->future();
+}
+
+
+void StorageLocalResourceProviderProcess::releaseCall()
+{
+  CHECK_GT(outstandingCalls, 0u);
+
+  // Hand the completed call's slot over to the first pending call.
+  if (!pendingCalls.empty()) {
+    Owned<Promise<Nothing>> pendingCall = pendingCalls.front();
+    pendingCalls.pop_front();
+    pendingCall->set(Nothing());
+    return;
+  }
+
+  outstandingCalls--;
+}
+
+
 // Kills the specified plugin container and returns a future that waits
 // for it to terminate.
 Future<Nothing> StorageLocalResourceProviderProcess::killService(
@@ -1545,43 +1611,65 @@ Future<Resources> StorageLocalResourceProviderProcess::importResources()
   Future<Resources> preprovisioned;
 
   if (controllerCapabilities->listVolumes) {
-    preprovisioned = getService(controllerContainerId)
-      .then(defer(self(), [=](csi::Client client) {
-        // TODO(chhsiao): Set the max entries and use a loop to do
-        // mutliple `ListVolumes` calls.
-        csi::ListVolumesRequest request;
-        request.mutable_version()->CopyFrom(csiVersion);
+    // The volumes are listed in pages of `CSI_LIST_VOLUMES_MAX_ENTRIES`
+    // volumes, each page starting from the token returned by the last.
+    shared_ptr<vector<csi::VolumeInfo>> volumeInfos(
+        new vector<csi::VolumeInfo>());
+    shared_ptr<string> token(new string());
 
-        return client.ListVolumes(request)
-          .then(defer(self(), [=](const csi::ListVolumesResponse& response) {
-            Resources resources;
-
-            // Recover volume profiles from the checkpointed state.
-            hashmap<string, string> volumesToProfiles;
-            foreach (const Resource& resource, totalResources) {
-              if (resource.disk().source().has_id() &&
-                  resource.disk().source().has_profile()) {
-                volumesToProfiles[resource.disk().source().id()] =
-                  resource.disk().source().profile();
-              }
-            }
+    preprovisioned = loop(
+        self(),
+        [=]() {
+          return call<csi::ListVolumesResponse>(
+              controllerContainerId, [=](csi::Client client) {
+                csi::ListVolumesRequest request;
+                request.mutable_version()->CopyFrom(csiVersion);
+                request.set_max_entries(CSI_LIST_VOLUMES_MAX_ENTRIES);
+                request.set_starting_token(*token);
+
+                return client.ListVolumes(request);
+              });
+        },
+        [=](const csi::ListVolumesResponse& response)
+            -> ControlFlow<Nothing> {
+          foreach (const auto& entry, response.entries()) {
+            volumeInfos->push_back(entry.volume_info());
+          }
 
-            foreach (const auto& entry, response.entries()) {
-              resources += createRawDiskResource(
-                  info,
-                  entry.volume_info().capacity_bytes(),
-                  volumesToProfiles.contains(entry.volume_info().id())
-                    ? volumesToProfiles.at(entry.volume_info().id())
-                    : Option<string>::none(),
-                  entry.volume_info().id(),
-                  entry.volume_info().attributes().empty()
-                    ? Option<Labels>::none()
-                    : convertStringMapToLabels(
-                          entry.volume_info().attributes()));
-            }
+          if (response.next_token().empty()) {
+            return Break();
+          }
 
-            return resources;
-          }));
+          *token = response.next_token();
+          return Continue();
+        })
+      .then(defer(self(), [=] {
+        Resources resources;
+
+        // Recover volume profiles from the checkpointed state.
+        hashmap<string, string> volumesToProfiles;
+        foreach (const Resource& resource, totalResources) {
+          if (resource.disk().source().has_id() &&
+              resource.disk().source().has_profile()) {
+            volumesToProfiles[resource.disk().source().id()] =
+              resource.disk().source().profile();
+          }
+        }
+
+        foreach (const csi::VolumeInfo& volumeInfo, *volumeInfos) {
+          resources += createRawDiskResource(
+              info,
+              volumeInfo.capacity_bytes(),
+              volumesToProfiles.contains(volumeInfo.id())
+                ? volumesToProfiles.at(volumeInfo.id())
+                : Option<string>::none(),
+              volumeInfo.id(),
+              volumeInfo.attributes().empty()
+                ? Option<Labels>::none()
+                : convertStringMapToLabels(volumeInfo.attributes()));
+        }
+
+        return resources;
       }));
   } else {
     preprovisioned = Resources();
@@ -1592,61 +1680,61 @@ Future<Resources> StorageLocalResourceProviderProcess::importResources()
       list<Future<Resources>> futures;
 
       foreach (const Resource& resource, preprovisioned) {
-        futures.push_back(getService(controllerContainerId)
-          .then(defer(self(), [=](csi::Client client) {
-            csi::ValidateVolumeCapabilitiesRequest request;
-            request.mutable_version()->CopyFrom(csiVersion);
-            request.set_volume_id(resource.disk().source().id());
-
-            // The default profile is used if `profile` is unset.
-            request.add_volume_capabilities()->CopyFrom(
-                profiles.at(resource.disk().source().profile()).capability);
-
-            if (resource.disk().source().has_metadata()) {
-              request.mutable_volume_attributes()->swap(
-                  convertLabelsToStringMap(
-                      resource.disk().source().metadata()).get());
-            }
+        futures.push_back(call<Resources>(
+            controllerContainerId, [=](csi::Client client) {
+              csi::ValidateVolumeCapabilitiesRequest request;
+              request.mutable_version()->CopyFrom(csiVersion);
+              request.set_volume_id(resource.disk().source().id());
 
-            return client.ValidateVolumeCapabilities(request)
-              .then(defer(self(), [=](
-                  const csi::ValidateVolumeCapabilitiesResponse& response)
-                  -> Future<Resources> {
-                if (!response.supported()) {
-                  return Failure(
-                      "Unsupported volume capability for resource " +
-                      stringify(resource) + ": " + response.message());
-                }
-
-                return resource;
-              }));
-          })));
-      }
+              // The default profile is used if `profile` is unset.
+              request.add_volume_capabilities()->CopyFrom(
+                  profiles.at(resource.disk().source().profile()).capability);
 
-      if (controllerCapabilities->getCapacity) {
-        foreachkey (const string& profile, profiles) {
-          futures.push_back(getService(controllerContainerId)
-            .then(defer(self(), [=](csi::Client client) {
-              csi::GetCapacityRequest request;
-              request.mutable_version()->CopyFrom(csiVersion);
-              request.add_volume_capabilities()
-                ->CopyFrom(profiles.at(profile).capability);
-              *request.mutable_parameters() = profiles.at(profile).parameters;
+              if (resource.disk().source().has_metadata()) {
+                request.mutable_volume_attributes()->swap(
+                    convertLabelsToStringMap(
+                        resource.disk().source().metadata()).get());
+              }
 
-              return client.GetCapacity(request)
+              return client.ValidateVolumeCapabilities(request)
                 .then(defer(self(), [=](
-                    const csi::GetCapacityResponse& response)
+                    const csi::ValidateVolumeCapabilitiesResponse& response)
                     -> Future<Resources> {
-                  if (response.available_capacity() == 0) {
-                    return Resources();
+                  if (!response.supported()) {
+                    return Failure(
+                        "Unsupported volume capability for resource " +
+                        stringify(resource) + ": " + response.message());
                   }
 
-                  return createRawDiskResource(
-                      info,
-                      response.available_capacity(),
-                      profile.empty() ? Option<string>::none() : profile);
+                  return resource;
+                }));
+            }));
+      }
+
+      if (controllerCapabilities->getCapacity) {
+        foreachkey (const string& profile, profiles) {
+          futures.push_back(call<Resources>(
+              controllerContainerId, [=](csi::Client client) {
+                csi::GetCapacityRequest request;
+                request.mutable_version()->CopyFrom(csiVersion);
+                request.add_volume_capabilities()
+                  ->CopyFrom(profiles.at(profile).capability);
+                *request.mutable_parameters() = profiles.at(profile).parameters;
+
+                return client.GetCapacity(request)
+                  .then(defer(self(), [=](
+                      const csi::GetCapacityResponse& response)
+                      -> Future<Resources> {
+                    if (response.available_capacity() == 0) {
+                      return Resources();
+                    }
+
+                    return createRawDiskResource(
+                        info,
+                        response.available_capacity(),
+                        profile.empty() ? Option<string>::none() : profile);
+                }));
               }));
-            })));
         }
       }
 
@@ -1684,27 +1772,27 @@ Future<Nothing> StorageLocalResourceProviderProcess::controllerPublish(
   Future<Nothing> controllerPublished;
 
   if (controllerCapabilities->publishUnpublishVolume) {
-    controllerPublished = getService(controllerContainerId)
-      .then(defer(self(), [=](csi::Client client) {
-        csi::ControllerPublishVolumeRequest request;
-        request.mutable_version()->CopyFrom(csiVersion);
-        request.set_volume_id(volumeId);
-        request.set_node_id(nodeId.get());
-        request.mutable_volume_capability()
-          ->CopyFrom(volumes.at(volumeId).state.volume_capability());
-        request.set_readonly(false);
-        *request.mutable_volume_attributes() =
-          volumes.at(volumeId).state.volume_attributes();
-
-        return client.ControllerPublishVolume(request)
-          .then(defer(self(), [=](
-              const csi::ControllerPublishVolumeResponse& response) {
-            *volumes.at(volumeId).state.mutable_publish_volume_info() =
-              response.publish_volume_info();
-
-            return Nothing();
-          }));
-      }));
+    controllerPublished = call<Nothing>(
+        controllerContainerId, [=](csi::Client client) {
+          csi::ControllerPublishVolumeRequest request;
+          request.mutable_version()->CopyFrom(csiVersion);
+          request.set_volume_id(volumeId);
+          request.set_node_id(nodeId.get());
+          request.mutable_volume_capability()
+            ->CopyFrom(volumes.at(volumeId).state.volume_capability());
+          request.set_readonly(false);
+          *request.mutable_volume_attributes() =
+            volumes.at(volumeId).state.volume_attributes();
+
+          return client.ControllerPublishVolume(request)
+            .then(defer(self(), [=](
+                const csi::ControllerPublishVolumeResponse& response) {
+              *volumes.at(volumeId).state.mutable_publish_volume_info() =
+                response.publish_volume_info();
+
+              return Nothing();
+            }));
+        });
   } else {
     controllerPublished = Nothing();
   }
@@ -1751,16 +1839,16 @@ Future<Nothing> StorageLocalResourceProviderProcess::controllerUnpublish(
   Future<Nothing> controllerUnpublished;
 
   if (controllerCapabilities->publishUnpublishVolume) {
-    controllerUnpublished = getService(controllerContainerId)
-      .then(defer(self(), [=](csi::Client client) {
-        csi::ControllerUnpublishVolumeRequest request;
-        request.mutable_version()->CopyFrom(csiVersion);
-        request.set_volume_id(volumeId);
-        request.set_node_id(nodeId.get());
-
-        return client.ControllerUnpublishVolume(request)
-          .then([] { return Nothing(); });
-      }));
+    controllerUnpublished = call<Nothing>(
+        controllerContainerId, [=](csi::Client client) {
+          csi::ControllerUnpublishVolumeRequest request;
+          request.mutable_version()->CopyFrom(csiVersion);
+          request.set_volume_id(volumeId);
+          request.set_node_id(nodeId.get());
+
+          return client.ControllerUnpublishVolume(request)
+            .then([] { return Nothing(); });
+        });
   } else {
     controllerUnpublished = Nothing();
   }
@@ -1811,22 +1899,22 @@ Future<Nothing> StorageLocalResourceProviderProcess::nodePublish(
         "Failed to create mount point '" + mountPath + "': " + mkdir.error());
   }
 
-  return getService(nodeContainerId)
-    .then(defer(self(), [=](csi::Client client) {
-      csi::NodePublishVolumeRequest request;
-      request.mutable_version()->CopyFrom(csiVersion);
-      request.set_volume_id(volumeId);
-      *request.mutable_publish_volume_info() =
-        volumes.at(volumeId).state.publish_volume_info();
-      request.set_target_path(mountPath);
-      request.mutable_volume_capability()
-        ->CopyFrom(volumes.at(volumeId).state.volume_capability());
-      request.set_readonly(false);
-      *request.mutable_volume_attributes() =
-        volumes.at(volumeId).state.volume_attributes();
-
-      return client.NodePublishVolume(request);
-    }))
+  return call<csi::NodePublishVolumeResponse>(
+      nodeContainerId, [=](csi::Client client) {
+        csi::NodePublishVolumeRequest request;
+        request.mutable_version()->CopyFrom(csiVersion);
+        request.set_volume_id(volumeId);
+        *request.mutable_publish_volume_info() =
+          volumes.at(volumeId).state.publish_volume_info();
+        request.set_target_path(mountPath);
+        request.mutable_volume_capability()
+          ->CopyFrom(volumes.at(volumeId).state.volume_capability());
+        request.set_readonly(false);
+        *request.mutable_volume_attributes() =
+          volumes.at(volumeId).state.volume_attributes();
+
+        return client.NodePublishVolume(request);
+      })
     .then(defer(self(), [=] {
       volumes.at(volumeId).state.set_state(csi::state::VolumeState::PUBLISHED);
       volumes.at(volumeId).state.set_boot_id(bootId);
@@ -1870,16 +1958,16 @@ Future<Nothing> StorageLocalResourceProviderProcess::nodeUnpublish(
   Future<Nothing> nodeUnpublished;
 
   if (os::exists(mountPath)) {
-    nodeUnpublished = getService(nodeContainerId)
-      .then(defer(self(), [=](csi::Client client) {
-        csi::NodeUnpublishVolumeRequest request;
-        request.mutable_version()->CopyFrom(csiVersion);
-        request.set_volume_id(volumeId);
-        request.set_target_path(mountPath);
-
-        return client.NodeUnpublishVolume(request)
-          .then([] { return Nothing(); });
-      }));
+    nodeUnpublished = call<Nothing>(
+        nodeContainerId, [=](csi::Client client) {
+          csi::NodeUnpublishVolumeRequest request;
+          request.mutable_version()->CopyFrom(csiVersion);
+          request.set_volume_id(volumeId);
+          request.set_target_path(mountPath);
+
+          return client.NodeUnpublishVolume(request)
+            .then([] { return Nothing(); });
+        });
   } else {
     // The volume has been actually unpublished before failover.
     CHECK_EQ(RECOVERING, state);
@@ -1924,43 +2012,42 @@ Future<string> StorageLocalResourceProviderProcess::createVolume(
     return Failure("Capability 'CREATE_DELETE_VOLUME' is not supported");
   }
 
-  return getService(controllerContainerId)
-    .then(defer(self(), [=](csi::Client client) {
-      csi::CreateVolumeRequest request;
-      request.mutable_version()->CopyFrom(csiVersion);
-      request.set_name(name);
-      request.mutable_capacity_range()
-        ->set_required_bytes(capacity.bytes());
-      request.mutable_capacity_range()
-        ->set_limit_bytes(capacity.bytes());
-      request.add_volume_capabilities()->CopyFrom(profile.capability);
-      *request.mutable_parameters() = profile.parameters;
-
-      return client.CreateVolume(request)
-        .then(defer(self(), [=](const csi::CreateVolumeResponse& response) {
-          const csi::VolumeInfo& volumeInfo = response.volume_info();
-
-          if (volumes.contains(volumeInfo.id())) {
-            // The resource provider failed over after the last
-            // `CreateVolume` call, but before the operation status
-            // was checkpointed.
-            CHECK_EQ(csi::state::VolumeState::CREATED,
-                     volumes.at(volumeInfo.id()).state.state());
-          } else {
-            csi::state::VolumeState volumeState;
-            volumeState.set_state(csi::state::VolumeState::CREATED);
-            volumeState.mutable_volume_capability()
-              ->CopyFrom(profile.capability);
-            *volumeState.mutable_volume_attributes() =
-              volumeInfo.attributes();
-
-            volumes.put(volumeInfo.id(), std::move(volumeState));
-            checkpointVolumeState(volumeInfo.id());
-          }
+  return call<string>(controllerContainerId, [=](csi::Client client) {
+    csi::CreateVolumeRequest request;
+    request.mutable_version()->CopyFrom(csiVersion);
+    request.set_name(name);
+    request.mutable_capacity_range()
+      ->set_required_bytes(capacity.bytes());
+    request.mutable_capacity_range()
+      ->set_limit_bytes(capacity.bytes());
+    request.add_volume_capabilities()->CopyFrom(profile.capability);
+    *request.mutable_parameters() = profile.parameters;
+
+    return client.CreateVolume(request)
+      .then(defer(self(), [=](const csi::CreateVolumeResponse& response) {
+        const csi::VolumeInfo& volumeInfo = response.volume_info();
+
+        if (volumes.contains(volumeInfo.id())) {
+          // The resource provider failed over after the last
+          // `CreateVolume` call, but before the operation status
+          // was checkpointed.
+          CHECK_EQ(csi::state::VolumeState::CREATED,
+                   volumes.at(volumeInfo.id()).state.state());
+        } else {
+          csi::state::VolumeState volumeState;
+          volumeState.set_state(csi::state::VolumeState::CREATED);
+          volumeState.mutable_volume_capability()
+            ->CopyFrom(profile.capability);
+          *volumeState.mutable_volume_attributes() =
+            volumeInfo.attributes();
 
-          return volumeInfo.id();
-        }));
-    }));
+          volumes.put(volumeInfo.id(), std::move(volumeState));
+          checkpointVolumeState(volumeInfo.id());
+        }
+
+        return volumeInfo.id();
+      }));
+  });
 }
 
 
@@ -1998,20 +2085,22 @@ Future<Nothing> StorageLocalResourceProviderProcess::deleteVolume(
       }
       case csi::state::VolumeState::CREATED: {
         deleted = deleted
-          .then(defer(self(), &Self::getService, controllerContainerId))
-          .then(defer(self(), [=](csi::Client client) {
-            csi::DeleteVolumeRequest request;
-            request.mutable_version()->CopyFrom(csiVersion);
-            request.set_volume_id(volumeId);
-
-            return client.DeleteVolume(request)
-              .then(defer(self(), [=] {
-                // NOTE: This will destruct the volume's sequence!
-                volumes.erase(volumeId);
-                CHECK_SOME(os::rmdir(volumePath));
-
-                return Nothing();
-              }));
+          .then(defer(self(), [=] {
+            return call<csi::DeleteVolumeResponse>(
+                controllerContainerId, [=](csi::Client client) {
+                  csi::DeleteVolumeRequest request;
+                  request.mutable_version()->CopyFrom(csiVersion);
+                  request.set_volume_id(volumeId);
+
+                  return client.DeleteVolume(request);
+                });
+          }))
+          .then(defer(self(), [=] {
+            // NOTE: This will destruct the volume's sequence!
+            volumes.erase(volumeId);
+            CHECK_SOME(os::rmdir(volumePath));
+
+            return Nothing();
           }));
         break;
       }
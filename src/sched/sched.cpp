@@ -81,6 +81,8 @@
 
 #include "authentication/cram_md5/authenticatee.hpp"
 
+#include "authentication/token/authenticatee.hpp"
+
 #include "common/protobuf_utils.hpp"
 
 #include "local/flags.hpp"
@@ -89,6 +91,8 @@
 #include "logging/flags.hpp"
 #include "logging/logging.hpp"
 
+#include "master/detector/pool.hpp"
+
 #include "messages/messages.hpp"
 
 #include "module/manager.hpp"
@@ -103,6 +107,7 @@ using namespace mesos::internal;
 using namespace mesos::internal::master;
 using namespace mesos::scheduler;
 
+using mesos::master::detector::DetectorPool;
 using mesos::master::detector::MasterDetector;
 
 using process::Clock;
@@ -118,7 +123,6 @@ using std::mutex;
 using std::shared_ptr;
 using std::string;
 using std::vector;
-using std::weak_ptr;
 
 using process::wait; // Necessary on some OS's to disambiguate.
 
@@ -128,58 +132,6 @@ namespace mesos {
 namespace internal {
 
 
-// The DetectorPool is responsible for tracking single detector per url
-// to avoid having multiple detectors per url when multiple frameworks
-// are instantiated per process. See MESOS-3595.
-
-class DetectorPool
-{
-public:
-  virtual ~DetectorPool() {}
-
-  static Try<shared_ptr<MasterDetector>> get(const string& url)
-  {
-    synchronized (DetectorPool::instance()->poolMutex) {
-      // Get or create the `weak_ptr` map entry.
-      shared_ptr<MasterDetector> result =
-        DetectorPool::instance()->pool[url].lock();
-
-      if (result) {
-        // Return existing master detector.
-        return result;
-      } else {
-        // Else, create the master detector and record it in the map.
-        Try<MasterDetector*> detector = MasterDetector::create(url);
-        if (detector.isError()) {
-          return Error(detector.error());
-        }
-
-        result = shared_ptr<MasterDetector>(detector.get());
-        DetectorPool::instance()->pool[url] = result;
-        return result;
-      }
-    }
-  }
-
-private:
-  // Hide the constructors and assignment operator.
-  DetectorPool() {}
-  DetectorPool(const DetectorPool&) = delete;
-  DetectorPool& operator=(const DetectorPool&) = delete;
-
-  // Instead of having multiple detectors for multiple frameworks,
-  // keep track of one detector per url.
-  hashmap<string, weak_ptr<MasterDetector>> pool;
-  std::mutex poolMutex;
-
-  // Internal Singleton.
-  static DetectorPool* instance()
-  {
-    static DetectorPool* singleton = new DetectorPool();
-    return singleton;
-  }
-};
-
 // The scheduler process (below) is responsible for interacting with
 // the master and responding to Mesos API calls from scheduler
 // drivers. In order to allow a message to be sent back to the master
@@ -227,7 +179,8 @@ public:
       authenticating(None()),
       authenticated(false),
       reauthenticate(false),
-      failedAuthentications(0)
+      failedAuthentications(0),
+      authenticatingWithToken(false)
   {
     LOG(INFO) << "Version: " << MESOS_VERSION;
   }
@@ -288,6 +241,10 @@ protected:
         &SchedulerProcess::error,
         &FrameworkErrorMessage::message);
 
+    install<AuthenticationTokenMessage>(
+        &SchedulerProcess::authenticationTokenIssued,
+        &AuthenticationTokenMessage::token);
+
     // Start detecting masters.
     detector->detect()
       .onAny(defer(self(), &SchedulerProcess::detected, lambda::_1));
@@ -399,7 +356,15 @@ protected:
 
     CHECK(authenticatee == nullptr);
 
-    if (flags.authenticatee == scheduler::DEFAULT_AUTHENTICATEE) {
+    // A token is only tried once: the master hands out a new one after
+    // each successful authentication.
+    if (reauthenticationToken.isSome()) {
+      LOG(INFO) << "Using the authentication token issued by the master";
+      authenticatee =
+        new token::TokenAuthenticatee(reauthenticationToken.get());
+      reauthenticationToken = None();
+      authenticatingWithToken = true;
+    } else if (flags.authenticatee == scheduler::DEFAULT_AUTHENTICATEE) {
       LOG(INFO) << "Using default CRAM-MD5 authenticatee";
       authenticatee = new cram_md5::CRAMMD5Authenticatee();
     } else {
@@ -447,6 +412,9 @@ protected:
     delete CHECK_NOTNULL(authenticatee);
     authenticatee = nullptr;
 
+    const bool withToken = authenticatingWithToken;
+    authenticatingWithToken = false;
+
     CHECK_SOME(authenticating);
     const Future<bool>& future = authenticating.get();
 
@@ -462,6 +430,21 @@ protected:
       return;
     }
 
+    if (withToken &&
+        !reauthenticate &&
+        (!future.isReady() || !future.get())) {
+      LOG(INFO)
+        << "Failed to authenticate with master " << master.get().pid()
+        << " using the authentication token: "
+        << (future.isFailed() ? future.failure() :
+           (future.isReady() ? "refused" : "future discarded"));
+
+      // Retry right away with the authenticatee.
+      authenticating = None();
+      authenticate();
+      return;
+    }
+
     if (reauthenticate || !future.isReady()) {
       LOG(INFO)
         << "Failed to authenticate with master " << master.get().pid() << ": "
@@ -527,6 +510,19 @@ protected:
     }
   }
 
+  void authenticationTokenIssued(const UPID& from, const string& token)
+  {
+    if (master.isNone() || from != master.get().pid()) {
+      LOG(WARNING) << "Ignoring authentication token from " << from
+                   << " because it is not the expected master: "
+                   << (master.isSome() ? stringify(master.get().pid())
+                                       : "None");
+      return;
+    }
+
+    reauthenticationToken = token;
+  }
+
   void drop(const Event& event, const string& message)
   {
     // TODO(bmahler): Increment a metric.
@@ -1681,6 +1677,14 @@ private:
 
   // Indicates the number of failed authentication attempts.
   uint64_t failedAuthentications;
+
+  // The token issued by the master after the last authentication, if
+  // any, which is used instead of the authenticatee in the next
+  // authentication attempt.
+  Option<string> reauthenticationToken;
+
+  // Indicates if the authentication attempt in progress uses a token.
+  bool authenticatingWithToken;
 };
 
 } // namespace internal {
@@ -0,0 +1,308 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mesos/v1/scheduler/offer_cache.hpp>
+
+#include <process/clock.hpp>
+
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+#include <stout/stringify.hpp>
+
+using process::Clock;
+using process::Time;
+
+using std::string;
+using std::vector;
+
+namespace mesos {
+namespace v1 {
+namespace scheduler {
+
+OfferCache::OfferCache(const Duration& _expiration, const Duration& _refusal)
+  : expiration(_expiration),
+    refusal(_refusal) {}
+
+
+void OfferCache::add(const Offer& offer)
+{
+  if (offers.contains(offer.id())) {
+    return;
+  }
+
+  Agent& agent = agents[offer.agent_id()];
+
+  if (agent.offers.empty()) {
+    agent.id = offer.agent_id();
+    agent.hostname = offer.hostname();
+    agent.attributes = offer.attributes();
+  } else {
+    unindex(agent);
+  }
+
+  Resources resources = offer.resources();
+  resources.unallocate();
+
+  agent.available += resources;
+  agent.offers[offer.id()] = offer;
+
+  index(agent);
+
+  offers[offer.id()] = offer.agent_id();
+  added.emplace_back(Clock::now(), offer.id());
+}
+
+
+Option<Offer> OfferCache::remove(const OfferID& offerId)
+{
+  if (!offers.contains(offerId)) {
+    return None();
+  }
+
+  const AgentID agentId = offers.at(offerId);
+  offers.erase(offerId);
+
+  CHECK(agents.contains(agentId));
+  Agent& agent = agents.at(agentId);
+
+  CHECK(agent.offers.contains(offerId));
+  const Offer offer = agent.offers.at(offerId);
+  agent.offers.erase(offerId);
+
+  unindex(agent);
+
+  if (agent.offers.empty()) {
+    agents.erase(agentId);
+  } else {
+    Resources resources = offer.resources();
+    resources.unallocate();
+
+    agent.available -= resources;
+
+    index(agent);
+  }
+
+  return offer;
+}
+
+
+vector<Offer> OfferCache::remove(const AgentID& agentId)
+{
+  vector<Offer> removed;
+
+  if (!agents.contains(agentId)) {
+    return removed;
+  }
+
+  foreach (const OfferID& offerId, agents.at(agentId).offers.keys()) {
+    Option<Offer> offer = remove(offerId);
+    CHECK_SOME(offer);
+    removed.push_back(offer.get());
+  }
+
+  return removed;
+}
+
+
+void OfferCache::update(const Event& event)
+{
+  switch (event.type()) {
+    case Event::OFFERS:
+      foreach (const Offer& offer, event.offers().offers()) {
+        add(offer);
+      }
+      break;
+
+    case Event::RESCIND:
+      remove(event.rescind().offer_id());
+      break;
+
+    case Event::FAILURE:
+      // Only the failure of an agent carries no executor ID.
+      if (event.failure().has_agent_id() &&
+          !event.failure().has_executor_id()) {
+        remove(event.failure().agent_id());
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+
+const OfferCache::Agent* OfferCache::agent(const AgentID& agentId) const
+{
+  auto it = agents.find(agentId);
+  return it == agents.end() ? nullptr : &it->second;
+}
+
+
+vector<AgentID> OfferCache::match(
+    const Resources& resources,
+    const Attributes& attributes) const
+{
+  vector<AgentID> result;
+
+  // Look up the agents having each of the attributes and offering
+  // each of the resources, any missing entry means no agent matches.
+  vector<const hashset<AgentID>*> indexes;
+
+  foreach (const Attribute& attribute, attributes) {
+    auto it = attributeIndex.find(stringify(attribute));
+    if (it == attributeIndex.end()) {
+      return result;
+    }
+
+    indexes.push_back(&it->second);
+  }
+
+  foreach (const string& name, resources.names()) {
+    auto it = resourceIndex.find(name);
+    if (it == resourceIndex.end()) {
+      return result;
+    }
+
+    indexes.push_back(&it->second);
+  }
+
+  Resources required = resources;
+  required.unallocate();
+
+  auto matches = [&](const Agent& agent) {
+    foreach (const Attribute& attribute, attributes) {
+      if (!agent.attributes.contains(attribute)) {
+        return false;
+      }
+    }
+
+    return agent.available.contains(required);
+  };
+
+  if (indexes.empty()) {
+    foreachvalue (const Agent& agent, agents) {
+      if (matches(agent)) {
+        result.push_back(agent.id);
+      }
+    }
+
+    return result;
+  }
+
+  // Only the agents of the smallest index are candidates, the other
+  // indexes are checked for each of them.
+  const hashset<AgentID>* smallest = indexes.front();
+  foreach (const hashset<AgentID>* index, indexes) {
+    if (index->size() < smallest->size()) {
+      smallest = index;
+    }
+  }
+
+  foreach (const AgentID& agentId, *smallest) {
+    bool indexed = true;
+    foreach (const hashset<AgentID>* index, indexes) {
+      if (!index->contains(agentId)) {
+        indexed = false;
+        break;
+      }
+    }
+
+    if (indexed && matches(agents.at(agentId))) {
+      result.push_back(agentId);
+    }
+  }
+
+  return result;
+}
+
+
+Option<Call> OfferCache::declineExpired(const FrameworkID& frameworkId)
+{
+  const Time now = Clock::now();
+
+  vector<OfferID> expired;
+
+  // NOTE: The entries of the offers that got removed in the meantime
+  // are skipped, they get dropped once expired.
+  while (!added.empty() && now - added.front().first >= expiration) {
+    const OfferID offerId = added.front().second;
+    added.pop_front();
+
+    if (remove(offerId).isSome()) {
+      expired.push_back(offerId);
+    }
+  }
+
+  if (expired.empty()) {
+    return None();
+  }
+
+  Call call;
+  call.set_type(Call::DECLINE);
+  call.mutable_framework_id()->CopyFrom(frameworkId);
+
+  Call::Decline* decline = call.mutable_decline();
+
+  foreach (const OfferID& offerId, expired) {
+    decline->add_offer_ids()->CopyFrom(offerId);
+  }
+
+  decline->mutable_filters()->set_refuse_seconds(refusal.secs());
+
+  return call;
+}
+
+
+void OfferCache::index(const Agent& agent)
+{
+  foreach (const Attribute& attribute, agent.attributes) {
+    attributeIndex[stringify(attribute)].insert(agent.id);
+  }
+
+  foreach (const string& name, agent.available.names()) {
+    resourceIndex[name].insert(agent.id);
+  }
+}
+
+
+void OfferCache::unindex(const Agent& agent)
+{
+  foreach (const Attribute& attribute, agent.attributes) {
+    const string key = stringify(attribute);
+
+    if (attributeIndex.contains(key)) {
+      attributeIndex.at(key).erase(agent.id);
+
+      if (attributeIndex.at(key).empty()) {
+        attributeIndex.erase(key);
+      }
+    }
+  }
+
+  foreach (const string& name, agent.available.names()) {
+    if (resourceIndex.contains(name)) {
+      resourceIndex.at(name).erase(agent.id);
+
+      if (resourceIndex.at(name).empty()) {
+        resourceIndex.erase(name);
+      }
+    }
+  }
+}
+
+} // namespace scheduler {
+} // namespace v1 {
+} // namespace mesos {
@@ -29,6 +29,7 @@
 #include <arpa/inet.h>
 #endif // __WINDOWS__
 
+#include <deque>
 #include <iostream>
 #include <memory>
 #include <queue>
@@ -89,6 +90,8 @@
 
 #include "master/validation.hpp"
 
+#include "master/detector/pool.hpp"
+
 #include "messages/messages.hpp"
 
 #include "module/manager.hpp"
@@ -101,6 +104,7 @@ using namespace mesos::internal::master;
 
 using namespace process;
 
+using std::deque;
 using std::get;
 using std::ostream;
 using std::queue;
@@ -111,6 +115,7 @@ using std::vector;
 
 using mesos::internal::recordio::Reader;
 
+using mesos::master::detector::DetectorPool;
 using mesos::master::detector::MasterDetector;
 
 using process::collect;
@@ -195,15 +200,18 @@ public:
     }
 
     if (_detector.isNone()) {
-      Try<MasterDetector*> create =
-        MasterDetector::create(pid.isSome() ? string(pid.get()) : master);
+      // The detector is shared with the other instances of the library
+      // (and the scheduler drivers) in this process using the same
+      // master, see `DetectorPool`.
+      Try<shared_ptr<MasterDetector>> create =
+        DetectorPool::get(pid.isSome() ? string(pid.get()) : master);
 
       if (create.isError()) {
         EXIT(EXIT_FAILURE)
           << "Failed to create a master detector: " << create.error();
       }
 
-      detector.reset(create.get());
+      detector = create.get();
     } else {
       detector = _detector.get();
     }
@@ -513,9 +521,10 @@ protected:
 
   Future<Nothing> _receive()
   {
-    Future<Nothing> future = async(callbacks.received, events);
-    events = queue<Event>();
-    return future;
+    // Hand the queued events over to the callback without copying them.
+    queue<Event> events_;
+    std::swap(events_, events);
+    return async(callbacks.received, std::move(events_));
   }
 
   // Helper for injecting an ERROR event.
@@ -677,16 +686,22 @@ protected:
 
   void read()
   {
-    subscribed->decoder->read()
+    // We read all of the events decoded so far at once, so that the
+    // events received together get delivered in a single 'received'
+    // callback. Note that the events are decoded by the reader's own
+    // process rather than by this process.
+    subscribed->decoder->readAll()
       .onAny(defer(self(),
                    &Self::_read,
                    subscribed->reader,
                    lambda::_1));
   }
 
-  void _read(const Pipe::Reader& reader, const Future<Result<Event>>& event)
+  void _read(
+      const Pipe::Reader& reader,
+      const Future<deque<Result<Event>>>& events)
   {
-    CHECK(!event.isDiscarded());
+    CHECK(!events.isDiscarded());
 
     // Ignore enqueued events from the previous Subscribe call reader.
     if (!subscribed.isSome() || subscribed->reader != reader) {
@@ -698,27 +713,31 @@ protected:
     CHECK_SOME(connectionId);
 
     // This could happen if the master failed over while sending a event.
-    if (event.isFailed()) {
+    if (events.isFailed()) {
       LOG(ERROR) << "Failed to decode the stream of events: "
-                 << event.failure();
-      disconnected(connectionId.get(), event.failure());
+                 << events.failure();
+      disconnected(connectionId.get(), events.failure());
       return;
     }
 
-    // This could happen if the master failed over after sending an event.
-    if (event->isNone()) {
-      const string error = "End-Of-File received from master. The master "
-                           "closed the event stream";
-      LOG(ERROR) << error;
+    foreach (const Result<Event>& event, events.get()) {
 
-      disconnected(connectionId.get(), error);
-      return;
-    }
+      // This could happen if the master failed over after sending an
+      // event.
+      if (event.isNone()) {
+        const string error = "End-Of-File received from master. The master "
+                             "closed the event stream";
+        LOG(ERROR) << error;
 
-    if (event->isError()) {
-      error("Failed to de-serialize event: " + event->error());
-    } else {
-      receive(event.get().get(), false);
+        disconnected(connectionId.get(), error);
+        return;
+      }
+
+      if (event.isError()) {
+        error("Failed to de-serialize event: " + event.error());
+      } else {
+        receive(event.get(), false);
+      }
     }
 
     read();
@@ -0,0 +1,192 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include <process/clock.hpp>
+#include <process/defer.hpp>
+#include <process/dispatch.hpp>
+#include <process/id.hpp>
+#include <process/process.hpp>
+#include <process/time.hpp>
+
+#include <process/metrics/counter.hpp>
+#include <process/metrics/metrics.hpp>
+#include <process/metrics/timer.hpp>
+
+#include <stout/hashmap.hpp>
+
+#include "secret/caching_resolver.hpp"
+
+using std::string;
+
+using process::Clock;
+using process::Future;
+using process::Owned;
+using process::Process;
+using process::Time;
+
+namespace mesos {
+namespace internal {
+
+class CachingSecretResolverProcess
+  : public Process<CachingSecretResolverProcess>
+{
+public:
+  CachingSecretResolverProcess(
+      SecretResolver* _resolver,
+      const Option<Duration>& _ttl)
+    : ProcessBase(process::ID::generate("caching-secret-resolver")),
+      resolver(_resolver),
+      ttl(_ttl) {}
+
+  Future<Secret::Value> resolve(const Secret& secret)
+  {
+    // A reference is only made of a name and a key, so equal
+    // references serialize the same.
+    const string key = secret.reference().SerializeAsString();
+
+    if (cache.contains(key)) {
+      const Cached& cached = cache.at(key);
+
+      if (Clock::now() < cached.expiry) {
+        ++metrics.cache_hits;
+        return cached.value;
+      }
+
+      cache.erase(key);
+    }
+
+    if (pending.contains(key)) {
+      ++metrics.resolutions_shared;
+      return pending.at(key);
+    }
+
+    ++metrics.resolutions;
+
+    // NOTE: The resolution is shared by all the callers, so none of
+    // them may discard it.
+    Future<Secret::Value> future =
+      undiscardable(metrics.resolution_time.time(resolver->resolve(secret)));
+
+    pending.put(key, future);
+
+    future.onAny(defer(
+        self(), &CachingSecretResolverProcess::_resolve, key, future));
+
+    return future;
+  }
+
+private:
+  void _resolve(const string& key, const Future<Secret::Value>& future)
+  {
+    if (pending.contains(key) && pending.at(key) == future) {
+      pending.erase(key);
+    }
+
+    if (!future.isReady()) {
+      ++metrics.resolution_failures;
+      return;
+    }
+
+    if (ttl.isSome()) {
+      cache.put(key, Cached{future.get(), Clock::now() + ttl.get()});
+    }
+  }
+
+  struct Cached
+  {
+    Secret::Value value;
+    Time expiry;
+  };
+
+  struct Metrics
+  {
+    Metrics()
+      : cache_hits("secret_resolver/cache_hits"),
+        resolutions_shared("secret_resolver/resolutions_shared"),
+        resolutions("secret_resolver/resolutions"),
+        resolution_failures("secret_resolver/resolution_failures"),
+        resolution_time("secret_resolver/resolution_time")
+    {
+      process::metrics::add(cache_hits);
+      process::metrics::add(resolutions_shared);
+      process::metrics::add(resolutions);
+      process::metrics::add(resolution_failures);
+      process::metrics::add(resolution_time);
+    }
+
+    ~Metrics()
+    {
+      process::metrics::remove(cache_hits);
+      process::metrics::remove(resolutions_shared);
+      process::metrics::remove(resolutions);
+      process::metrics::remove(resolution_failures);
+      process::metrics::remove(resolution_time);
+    }
+
+    // Resolutions served from the cache, or by one still in progress
+    // for the same reference.
+    process::metrics::Counter cache_hits;
+    process::metrics::Counter resolutions_shared;
+
+    // Calls to the wrapped resolver, and the ones which failed.
+    process::metrics::Counter resolutions;
+    process::metrics::Counter resolution_failures;
+
+    process::metrics::Timer<Milliseconds> resolution_time;
+  } metrics;
+
+  SecretResolver* resolver;
+  const Option<Duration> ttl;
+
+  hashmap<string, Cached> cache;
+  hashmap<string, Future<Secret::Value>> pending;
+};
+
+
+CachingSecretResolver::CachingSecretResolver(
+    SecretResolver* _resolver,
+    const Option<Duration>& ttl)
+  : resolver(_resolver),
+    process(new CachingSecretResolverProcess(_resolver, ttl))
+{
+  spawn(process.get());
+}
+
+
+CachingSecretResolver::~CachingSecretResolver()
+{
+  terminate(process.get());
+  wait(process.get());
+}
+
+
+Future<Secret::Value> CachingSecretResolver::resolve(
+    const Secret& secret) const
+{
+  if (secret.type() != Secret::REFERENCE || !secret.has_reference()) {
+    return resolver->resolve(secret);
+  }
+
+  return dispatch(
+      process.get(),
+      &CachingSecretResolverProcess::resolve,
+      secret);
+}
+
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,61 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __SECRET_CACHING_RESOLVER_HPP__
+#define __SECRET_CACHING_RESOLVER_HPP__
+
+#include <mesos/mesos.hpp>
+
+#include <mesos/secret/resolver.hpp>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/option.hpp>
+
+namespace mesos {
+namespace internal {
+
+// Forward declaration.
+class CachingSecretResolverProcess;
+
+
+// Wraps a secret resolver, e.g., a module querying a remote secret
+// store, so that concurrent resolutions of the same reference share a
+// single call to the wrapped resolver. If a TTL is given, resolved
+// references are also cached for that long.
+//
+// Secrets of type VALUE are passed through to the wrapped resolver.
+class CachingSecretResolver : public SecretResolver
+{
+public:
+  // Takes ownership of the wrapped resolver.
+  CachingSecretResolver(SecretResolver* resolver, const Option<Duration>& ttl);
+
+  ~CachingSecretResolver() override;
+
+  process::Future<Secret::Value> resolve(const Secret& secret) const override;
+
+private:
+  process::Owned<SecretResolver> resolver;
+  process::Owned<CachingSecretResolverProcess> process;
+};
+
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __SECRET_CACHING_RESOLVER_HPP__
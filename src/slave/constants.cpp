@@ -38,7 +38,8 @@ vector<SlaveInfo::Capability> AGENT_CAPABILITIES()
   SlaveInfo::Capability::Type types[] = {
     SlaveInfo::Capability::MULTI_ROLE,
     SlaveInfo::Capability::HIERARCHICAL_ROLE,
-    SlaveInfo::Capability::RESERVATION_REFINEMENT
+    SlaveInfo::Capability::RESERVATION_REFINEMENT,
+    SlaveInfo::Capability::STATUS_UPDATE_BATCHES
   };
 
   vector<SlaveInfo::Capability> result;
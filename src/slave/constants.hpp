@@ -55,6 +55,11 @@ constexpr Duration RECOVERY_TIMEOUT = Minutes(15);
 constexpr Duration STATUS_UPDATE_RETRY_INTERVAL_MIN = Seconds(10);
 constexpr Duration STATUS_UPDATE_RETRY_INTERVAL_MAX = Minutes(10);
 
+// Number of processes the task status update streams are sharded over
+// by framework, so that the checkpointing and retries of the updates
+// of a busy framework do not delay the updates of other frameworks.
+constexpr size_t TASK_STATUS_UPDATE_MANAGER_SHARDS = 4;
+
 // Default backoff interval used by the slave to wait before registration.
 constexpr Duration DEFAULT_REGISTRATION_BACKOFF_FACTOR = Seconds(1);
 
@@ -78,6 +83,10 @@ constexpr Duration DISK_WATCH_INTERVAL = Minutes(1);
 // Minimum free disk capacity enforced by the garbage collector.
 constexpr double GC_DISK_HEADROOM = 0.1;
 
+// The meta journal is only compacted once it has grown to at least
+// this size, and to more than twice the size of its live records.
+constexpr Bytes META_JOURNAL_MIN_COMPACTION_SIZE = Megabytes(64);
+
 // Maximum number of completed frameworks to store in memory.
 constexpr size_t MAX_COMPLETED_FRAMEWORKS = 50;
 
@@ -85,6 +94,10 @@ constexpr size_t MAX_COMPLETED_FRAMEWORKS = 50;
 // to store in memory.
 constexpr size_t DEFAULT_MAX_COMPLETED_EXECUTORS_PER_FRAMEWORK = 150;
 
+// Default maximum number of status updates forwarded to the master
+// in a single batch.
+constexpr size_t DEFAULT_MAX_STATUS_UPDATE_BATCH_SIZE = 1000;
+
 // Maximum number of completed tasks per executor to store in memory.
 constexpr size_t MAX_COMPLETED_TASKS_PER_EXECUTOR = 200;
 
@@ -131,6 +144,11 @@ constexpr Duration DOCKER_INSPECT_DELAY = Seconds(1);
 // in parallel to prevent hitting system's open file descriptor limit.
 constexpr size_t DOCKER_PS_MAX_INSPECT_CALLS = 100;
 
+// Maximum number of containers an isolator inspects in parallel while
+// recovering, e.g., to look up their on-disk state, to bound the number
+// of blocked threads.
+constexpr size_t MAX_ISOLATOR_RECOVERY_CONCURRENCY = 8;
+
 // Default duration that docker containerizer will wait to check
 // docker version.
 // TODO(tnachen): Make this a flag.
@@ -159,6 +177,9 @@ constexpr char EXECUTOR_HTTP_AUTHENTICATION_REALM[] = "mesos-agent-executor";
 // Default maximum storage space to be used by the fetcher cache.
 constexpr Bytes DEFAULT_FETCHER_CACHE_SIZE = Gigabytes(2);
 
+// Maximum number of URIs of a task that the fetcher downloads at a time.
+constexpr size_t FETCHER_MAX_CONCURRENT_DOWNLOADS = 8;
+
 // If no pings received within this timeout, then the slave will
 // trigger a re-detection of the master to cause a re-registration.
 Duration DEFAULT_MASTER_PING_TIMEOUT();
@@ -173,6 +194,10 @@ constexpr char MESOS_DEFAULT_EXECUTOR[] = "mesos-default-executor";
 // Virtual path on which agent logs are mounted in `/files/` endpoint.
 constexpr char AGENT_LOG_VIRTUAL_PATH[] = "/slave/log";
 
+// Virtual path on which the Docker layer tar balls served to peer
+// agents are mounted in `/files/` endpoint, see `--docker_layer_peers`.
+constexpr char DOCKER_BLOBS_VIRTUAL_PATH[] = "/docker/blobs";
+
 std::vector<SlaveInfo::Capability> AGENT_CAPABILITIES();
 
 } // namespace slave {
@@ -102,6 +102,7 @@ public:
     CHECK_GT(flags.libprocess_num_worker_threads, 0u);
     environment["LIBPROCESS_NUM_WORKER_THREADS"] =
       stringify(flags.libprocess_num_worker_threads);
+    environment.emplace("LIBPROCESS_LIGHTWEIGHT", "true");
 
     // Copy the global rotation flags.
     // These will act as the defaults in case the executor environment
@@ -111,6 +112,9 @@ public:
     overriddenFlags.logrotate_stdout_options = flags.logrotate_stdout_options;
     overriddenFlags.max_stderr_size = flags.max_stderr_size;
     overriddenFlags.logrotate_stderr_options = flags.logrotate_stderr_options;
+    overriddenFlags.max_stdout_files = flags.max_stdout_files;
+    overriddenFlags.max_stderr_files = flags.max_stderr_files;
+    overriddenFlags.compress_rotated_logs = flags.compress_rotated_logs;
 
     // Check for overrides of the rotation settings in the
     // `ExecutorInfo`s environment variables.
@@ -143,6 +147,48 @@ public:
       foreach (const flags::Warning& warning, load->warnings) {
         LOG(WARNING) << warning.message;
       }
+
+      // Choosing how to rotate a stream in the executor's environment
+      // overrides the global choice for that stream.
+      auto overrideRotation = [&executorEnvironment](
+          const string& files,
+          const string& options,
+          Option<size_t>* maxFiles,
+          Option<string>* logrotateOptions) {
+        if (executorEnvironment.count(files) > 0 &&
+            executorEnvironment.count(options) == 0) {
+          *logrotateOptions = None();
+        } else if (executorEnvironment.count(options) > 0 &&
+                   executorEnvironment.count(files) == 0) {
+          *maxFiles = None();
+        }
+      };
+
+      overrideRotation(
+          "max_stdout_files",
+          "logrotate_stdout_options",
+          &overriddenFlags.max_stdout_files,
+          &overriddenFlags.logrotate_stdout_options);
+
+      overrideRotation(
+          "max_stderr_files",
+          "logrotate_stderr_options",
+          &overriddenFlags.max_stderr_files,
+          &overriddenFlags.logrotate_stderr_options);
+    }
+
+    if (overriddenFlags.max_stdout_files.isSome() &&
+        overriddenFlags.logrotate_stdout_options.isSome()) {
+      return Failure(
+          "Only one of max_stdout_files and logrotate_stdout_options "
+          "may be set");
+    }
+
+    if (overriddenFlags.max_stderr_files.isSome() &&
+        overriddenFlags.logrotate_stderr_options.isSome()) {
+      return Failure(
+          "Only one of max_stderr_files and logrotate_stderr_options "
+          "may be set");
     }
 
     // NOTE: We manually construct a pipe here instead of using
@@ -174,6 +220,10 @@ public:
     mesos::internal::logger::rotate::Flags outFlags;
     outFlags.max_size = overriddenFlags.max_stdout_size;
     outFlags.logrotate_options = overriddenFlags.logrotate_stdout_options;
+    outFlags.max_files = overriddenFlags.max_stdout_files;
+    outFlags.compress =
+      overriddenFlags.max_stdout_files.isSome() &&
+      overriddenFlags.compress_rotated_logs;
     outFlags.log_filename = path::join(sandboxDirectory, "stdout");
     outFlags.logrotate_path = flags.logrotate_path;
     outFlags.user = user;
@@ -232,6 +282,10 @@ public:
     mesos::internal::logger::rotate::Flags errFlags;
     errFlags.max_size = overriddenFlags.max_stderr_size;
     errFlags.logrotate_options = overriddenFlags.logrotate_stderr_options;
+    errFlags.max_files = overriddenFlags.max_stderr_files;
+    errFlags.compress =
+      overriddenFlags.max_stderr_files.isSome() &&
+      overriddenFlags.compress_rotated_logs;
     errFlags.log_filename = path::join(sandboxDirectory, "stderr");
     errFlags.logrotate_path = flags.logrotate_path;
     errFlags.user = user;
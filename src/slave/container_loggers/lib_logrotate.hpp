@@ -67,6 +67,14 @@ struct LoggerFlags : public virtual flags::FlagsBase
         "  }\n"
         "NOTE: The 'size' option will be overridden by this module.");
 
+    add(&LoggerFlags::max_stdout_files,
+        "max_stdout_files",
+        "If specified, the stdout log file is rotated by the companion\n"
+        "logger process itself rather than by 'logrotate', keeping at most\n"
+        "this many rotated files.  This bounds the total size of the stdout\n"
+        "logs to 'max_stdout_size' times 'max_stdout_files' plus one.\n"
+        "Cannot be combined with 'logrotate_stdout_options'.");
+
     add(&LoggerFlags::max_stderr_size,
         "max_stderr_size",
         "Maximum size, in bytes, of a single stderr log file.\n"
@@ -84,6 +92,20 @@ struct LoggerFlags : public virtual flags::FlagsBase
         "    size <max_stderr_size>\n"
         "  }\n"
         "NOTE: The 'size' option will be overridden by this module.");
+
+    add(&LoggerFlags::max_stderr_files,
+        "max_stderr_files",
+        "If specified, the stderr log file is rotated by the companion\n"
+        "logger process itself rather than by 'logrotate', keeping at most\n"
+        "this many rotated files.  This bounds the total size of the stderr\n"
+        "logs to 'max_stderr_size' times 'max_stderr_files' plus one.\n"
+        "Cannot be combined with 'logrotate_stderr_options'.");
+
+    add(&LoggerFlags::compress_rotated_logs,
+        "compress_rotated_logs",
+        "Whether to gzip the rotated stdout and stderr log files when\n"
+        "they are rotated via 'max_stdout_files' and 'max_stderr_files'.",
+        false);
   }
 
   static Option<Error> validateSize(const Bytes& value)
@@ -99,9 +121,13 @@ struct LoggerFlags : public virtual flags::FlagsBase
 
   Bytes max_stdout_size;
   Option<std::string> logrotate_stdout_options;
+  Option<size_t> max_stdout_files;
 
   Bytes max_stderr_size;
   Option<std::string> logrotate_stderr_options;
+  Option<size_t> max_stderr_files;
+
+  bool compress_rotated_logs;
 };
 
 
@@ -113,12 +139,15 @@ struct Flags : public virtual LoggerFlags
         "environment_variable_prefix",
         "Prefix for environment variables meant to modify the behavior of\n"
         "the logrotate logger for the specific executor being launched.\n"
-        "The logger will look for four prefixed environment variables in the\n"
+        "The logger will look for these prefixed environment variables in the\n"
         "'ExecutorInfo's 'CommandInfo's 'Environment':\n"
         "  * MAX_STDOUT_SIZE\n"
         "  * LOGROTATE_STDOUT_OPTIONS\n"
+        "  * MAX_STDOUT_FILES\n"
         "  * MAX_STDERR_SIZE\n"
         "  * LOGROTATE_STDERR_OPTIONS\n"
+        "  * MAX_STDERR_FILES\n"
+        "  * COMPRESS_ROTATED_LOGS\n"
         "If present, these variables will overwrite the global values set\n"
         "via module parameters.",
         "CONTAINER_LOGGER_");
@@ -30,12 +30,17 @@
 #include <stout/bytes.hpp>
 #include <stout/error.hpp>
 #include <stout/exit.hpp>
+#include <stout/gzip.hpp>
 #include <stout/nothing.hpp>
 #include <stout/path.hpp>
 #include <stout/stringify.hpp>
 #include <stout/try.hpp>
 
+#include <stout/os/exists.hpp>
 #include <stout/os/pagesize.hpp>
+#include <stout/os/read.hpp>
+#include <stout/os/rename.hpp>
+#include <stout/os/rm.hpp>
 #include <stout/os/shell.hpp>
 #include <stout/os/su.hpp>
 #include <stout/os/write.hpp>
@@ -79,6 +84,20 @@ public:
   // leading log file, and manages total log size.
   Future<Nothing> run()
   {
+    // NOTE: This is a prerequisuite for `io::read`.
+    Try<Nothing> nonblock = os::nonblock(STDIN_FILENO);
+    if (nonblock.isError()) {
+      return Failure("Failed to set nonblocking pipe: " + nonblock.error());
+    }
+
+    // No configuration is needed if we rotate the files ourselves.
+    if (flags.max_files.isSome()) {
+      // NOTE: This does not block.
+      loop();
+
+      return promise.future();
+    }
+
     // Populate the `logrotate` configuration file.
     // See `Flags::logrotate_options` for the format.
     //
@@ -98,12 +117,6 @@ public:
       return Failure("Failed to write configuration file: " + result.error());
     }
 
-    // NOTE: This is a prerequisuite for `io::read`.
-    Try<Nothing> nonblock = os::nonblock(STDIN_FILENO);
-    if (nonblock.isError()) {
-      return Failure("Failed to set nonblocking pipe: " + nonblock.error());
-    }
-
     // NOTE: This does not block.
     loop();
 
@@ -182,7 +195,7 @@ public:
     return Nothing();
   }
 
-  // Calls `logrotate` on the leading log file and resets the `bytesWritten`.
+  // Rotates the leading log file and resets the `bytesWritten`.
   void rotate()
   {
     if (leading.isSome()) {
@@ -190,6 +203,14 @@ public:
       leading = None();
     }
 
+    if (flags.max_files.isSome()) {
+      _rotate();
+
+      // Reset the number of bytes written.
+      bytesWritten = 0;
+      return;
+    }
+
     // Call `logrotate` to move around the files.
     // NOTE: If `logrotate` fails for whatever reason, we will ignore
     // the error and continue logging.  In case the leading log file
@@ -204,6 +225,85 @@ public:
     bytesWritten = 0;
   }
 
+  // Rotates the leading log file without `logrotate`, by shifting the
+  // rotated files by one and removing the oldest.
+  // NOTE: Like with `logrotate`, errors are ignored and we continue
+  // appending to the leading log file if it could not be rotated.
+  void _rotate()
+  {
+    const std::string& filename = flags.log_filename.get();
+    const std::string suffix = flags.compress ? ".gz" : "";
+
+    auto rotated = [&](size_t index) {
+      return filename + "." + stringify(index) + suffix;
+    };
+
+    const size_t maxFiles = flags.max_files.get();
+
+    if (maxFiles == 0) {
+      os::rm(filename);
+      return;
+    }
+
+    if (os::exists(rotated(maxFiles))) {
+      os::rm(rotated(maxFiles));
+    }
+
+    for (size_t index = maxFiles - 1; index > 0; index--) {
+      if (os::exists(rotated(index))) {
+        os::rename(rotated(index), rotated(index + 1));
+      }
+    }
+
+    if (!flags.compress) {
+      Try<Nothing> rename = os::rename(filename, rotated(1));
+      if (rename.isError()) {
+        std::cerr << "Failed to rotate '" << filename << "': "
+                  << rename.error() << std::endl;
+      }
+
+      return;
+    }
+
+    // NOTE: The leading log file is at most `--max_size`, so we
+    // compress it in memory. The compressed file is written under a
+    // temporary name first so that a partially written file is never
+    // mistaken for a rotated file.
+    Try<std::string> read = os::read(filename);
+    if (read.isError()) {
+      std::cerr << "Failed to read '" << filename << "': "
+                << read.error() << std::endl;
+      return;
+    }
+
+    Try<std::string> compressed = gzip::compress(read.get());
+    if (compressed.isError()) {
+      std::cerr << "Failed to compress '" << filename << "': "
+                << compressed.error() << std::endl;
+      return;
+    }
+
+    const std::string temporary = rotated(1) + ".tmp";
+
+    Try<Nothing> write = os::write(temporary, compressed.get());
+    if (write.isError()) {
+      std::cerr << "Failed to write '" << temporary << "': "
+                << write.error() << std::endl;
+      os::rm(temporary);
+      return;
+    }
+
+    Try<Nothing> rename = os::rename(temporary, rotated(1));
+    if (rename.isError()) {
+      std::cerr << "Failed to rotate '" << filename << "': "
+                << rename.error() << std::endl;
+      os::rm(temporary);
+      return;
+    }
+
+    os::rm(filename);
+  }
+
 private:
   Flags flags;
 
@@ -238,6 +338,19 @@ int main(int argc, char** argv)
     return EXIT_FAILURE;
   }
 
+  if (flags.max_files.isSome() && flags.logrotate_options.isSome()) {
+    std::cerr << flags.usage(
+        "Only one of --max_files and --logrotate_options may be set")
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (flags.compress && flags.max_files.isNone()) {
+    std::cerr << flags.usage("Expected --max_files to be set with --compress")
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
   mesos::internal::logging::initialize(argv[0], false);
 
   // Log any flag warnings.
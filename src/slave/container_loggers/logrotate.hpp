@@ -77,6 +77,22 @@ struct Flags : public virtual flags::FlagsBase
         "  }\n"
         "NOTE: The 'size' option will be overridden by this command.");
 
+    add(&Flags::max_files,
+        "max_files",
+        "If specified, the leading log file is rotated by this command\n"
+        "rather than by 'logrotate', keeping at most this many rotated\n"
+        "files named '<log_filename>.1' (the most recent) through\n"
+        "'<log_filename>.<max_files>'.  This avoids running 'logrotate'\n"
+        "on every rotation and bounds the total size of the logs to\n"
+        "'--max_size' times '--max_files' plus one.\n"
+        "Cannot be combined with '--logrotate_options'.");
+
+    add(&Flags::compress,
+        "compress",
+        "Whether to gzip the rotated files, which are then suffixed\n"
+        "with '.gz'.  Requires '--max_files'.",
+        false);
+
     add(&Flags::log_filename,
         "log_filename",
         "Absolute path to the leading log file.\n"
@@ -121,6 +137,8 @@ struct Flags : public virtual flags::FlagsBase
 
   Bytes max_size;
   Option<std::string> logrotate_options;
+  Option<size_t> max_files;
+  bool compress;
   Option<std::string> log_filename;
   std::string logrotate_path;
   Option<std::string> user;
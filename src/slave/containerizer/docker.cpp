@@ -175,7 +175,8 @@ Try<DockerContainerizer*> DockerContainerizer::create(
       flags.docker,
       flags.docker_socket,
       true,
-      flags.docker_config);
+      flags.docker_config,
+      flags.docker_engine_api);
 
   if (create.isError()) {
     return Error("Failed to create docker: " + create.error());
@@ -642,7 +643,7 @@ Try<Nothing> DockerContainerizerProcess::unmountPersistentVolumes(
   // We assume volumes are only supported on Linux, and also
   // the target path contains the containerId.
 #ifdef __linux__
-  Try<fs::MountInfoTable> table = fs::MountInfoTable::read();
+  Try<fs::MountInfoTable> table = fs::MountInfoTable::cached();
   if (table.isError()) {
     return Error("Failed to get mount table: " + table.error());
   }
@@ -868,6 +868,9 @@ Future<Nothing> FetcherProcess::run(
   // supports that.
   environment.emplace("LIBPROCESS_IP", "127.0.0.1");
 
+  // The fetcher only runs a few actors.
+  environment.emplace("LIBPROCESS_LIGHTWEIGHT", "true");
+
   VLOG(1) << "Fetching URIs using command '" << command << "'";
 
   Try<Subprocess> fetcherSubprocess = subprocess(
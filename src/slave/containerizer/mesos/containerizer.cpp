@@ -23,6 +23,7 @@
 
 #include <mesos/slave/isolator.hpp>
 
+#include <process/async.hpp>
 #include <process/collect.hpp>
 #include <process/defer.hpp>
 #include <process/http.hpp>
@@ -59,6 +60,7 @@
 
 #include "slave/containerizer/mesos/constants.hpp"
 #include "slave/containerizer/mesos/containerizer.hpp"
+#include "slave/containerizer/mesos/isolator.hpp"
 #include "slave/containerizer/mesos/launch.hpp"
 #include "slave/containerizer/mesos/launcher.hpp"
 #include "slave/containerizer/mesos/paths.hpp"
@@ -113,6 +115,7 @@
 #include "slave/containerizer/mesos/isolators/xfs/disk.hpp"
 #endif
 
+using process::async;
 using process::collect;
 using process::dispatch;
 using process::defer;
@@ -484,13 +487,19 @@ Try<MesosContainerizer*> MesosContainerizer::create(
                    isolator.error());
     }
 
+    // Time the isolator under the name it is enabled with, except for
+    // the cgroups isolator which handles all the cgroups subsystems.
+    Owned<Isolator> timed(new TimedIsolator(
+        strings::startsWith(isolation, "cgroups/") ? "cgroups" : isolation,
+        Owned<Isolator>(isolator.get())));
+
     // NOTE: The filesystem isolator must be the first isolator used
     // so that the runtime isolators can have a consistent view on the
     // prepared filesystem (e.g., any volume mounts are performed).
     if (strings::contains(isolation, "filesystem/")) {
-      isolators.insert(isolators.begin(), Owned<Isolator>(isolator.get()));
+      isolators.insert(isolators.begin(), timed);
     } else {
-      isolators.push_back(Owned<Isolator>(isolator.get()));
+      isolators.push_back(timed);
     }
   }
 
@@ -1283,9 +1292,10 @@ Future<Containerizer::LaunchResult> MesosContainerizerProcess::launch(
                   pidCheckpointPath));
   }
 
-  container->provisioning = provisioner->provision(
-      containerId,
-      containerConfig.container_info().mesos().image());
+  container->provisioning = metrics.launch_provision.time(
+      provisioner->provision(
+          containerId,
+          containerConfig.container_info().mesos().image()));
 
   return container->provisioning
     .then(defer(
@@ -1397,7 +1407,7 @@ Future<Nothing> MesosContainerizerProcess::prepare(
       });
   }
 
-  container->launchInfos = f;
+  container->launchInfos = metrics.launch_prepare.time(f);
 
   return f.then([]() { return Nothing(); });
 }
@@ -1424,13 +1434,13 @@ Future<Nothing> MesosContainerizerProcess::fetch(
 
   const string directory = container->config->directory();
 
-  return fetcher->fetch(
+  return metrics.launch_fetch.time(fetcher->fetch(
       containerId,
       container->config->command_info(),
       directory,
       container->config->has_user()
         ? container->config->user()
-        : Option<string>::none())
+        : Option<string>::none()))
     .then([=]() -> Future<Nothing> {
       if (HookManager::hooksAvailable()) {
         HookManager::slavePostFetchHook(containerId, directory);
@@ -1908,6 +1918,8 @@ Future<Containerizer::LaunchResult> MesosContainerizerProcess::_launch(
   argv[0] = path::join(flags.launcher_dir, MESOS_CONTAINERIZER);
   argv[1] = MesosContainerizerLaunch::NAME;
 
+  metrics.launch_fork.start();
+
   Try<pid_t> forked = launcher->fork(
       containerId,
       argv[0],
@@ -1926,6 +1938,8 @@ Future<Containerizer::LaunchResult> MesosContainerizerProcess::_launch(
     return Failure("Failed to fork: " + forked.error());
   }
 
+  metrics.launch_fork.stop();
+
   pid_t pid = forked.get();
   container->pid = pid;
 
@@ -2029,7 +2043,7 @@ Future<Nothing> MesosContainerizerProcess::isolate(
   }
 
   // Wait for all isolators to complete.
-  Future<list<Nothing>> future = collect(futures);
+  Future<list<Nothing>> future = metrics.launch_isolate.time(collect(futures));
 
   container->isolation = future;
 
@@ -2624,15 +2638,37 @@ void MesosContainerizerProcess::______destroy(
       LOG(ERROR) << "Failed to checkpoint nested container's termination state"
                  << " to '" << terminationPath << "': " << checkpointed.error();
     }
-  } else if (os::exists(runtimePath)) {
-    Try<Nothing> rmdir = os::rmdir(runtimePath);
-    if (rmdir.isError()) {
-      LOG(WARNING) << "Failed to remove the runtime directory"
-                   << " for container " << containerId
-                   << ": " << rmdir.error();
-    }
+
+    _______destroy(containerId, termination);
+    return;
   }
 
+  // Removing the runtime directories of a top-level container and of
+  // all its nested containers can take a while, so we do it off the
+  // containerizer actor to not delay the operations on other
+  // containers (e.g., during a destroy storm).
+  async([=]() {
+    if (os::exists(runtimePath)) {
+      Try<Nothing> rmdir = os::rmdir(runtimePath);
+      if (rmdir.isError()) {
+        LOG(WARNING) << "Failed to remove the runtime directory"
+                     << " for container " << containerId
+                     << ": " << rmdir.error();
+      }
+    }
+  })
+  .onAny(defer(self(), &Self::_______destroy, containerId, termination));
+}
+
+
+void MesosContainerizerProcess::_______destroy(
+    const ContainerID& containerId,
+    const ContainerTermination& termination)
+{
+  CHECK(containers_.contains(containerId));
+
+  const Owned<Container>& container = containers_.at(containerId);
+
   container->termination.set(termination);
 
   if (containerId.has_parent()) {
@@ -2700,26 +2736,37 @@ Future<Nothing> MesosContainerizerProcess::remove(
   const string runtimePath =
     containerizer::paths::getRuntimePath(flags.runtime_dir, containerId);
 
-  if (os::exists(runtimePath)) {
-    Try<Nothing> rmdir = os::rmdir(runtimePath);
-    if (rmdir.isError()) {
-      return Failure(
-          "Failed to remove the runtime directory: " + rmdir.error());
-    }
-  }
-
   const string sandboxPath = containerizer::paths::getSandboxPath(
       containers_[rootContainerId]->directory.get(), containerId);
 
-  if (os::exists(sandboxPath)) {
-    Try<Nothing> rmdir = os::rmdir(sandboxPath);
-    if (rmdir.isError()) {
-      return Failure(
-          "Failed to remove the sandbox directory: " + rmdir.error());
+  // The sandbox of a nested container can be large, so we remove the
+  // directories off the containerizer actor.
+  return async([=]() -> Try<Nothing> {
+    if (os::exists(runtimePath)) {
+      Try<Nothing> rmdir = os::rmdir(runtimePath);
+      if (rmdir.isError()) {
+        return Error(
+            "Failed to remove the runtime directory: " + rmdir.error());
+      }
     }
-  }
 
-  return Nothing();
+    if (os::exists(sandboxPath)) {
+      Try<Nothing> rmdir = os::rmdir(sandboxPath);
+      if (rmdir.isError()) {
+        return Error(
+            "Failed to remove the sandbox directory: " + rmdir.error());
+      }
+    }
+
+    return Nothing();
+  })
+  .then([](const Try<Nothing>& removed) -> Future<Nothing> {
+    if (removed.isError()) {
+      return Failure(removed.error());
+    }
+
+    return Nothing();
+  });
 }
 
 
@@ -2870,15 +2917,32 @@ Future<Nothing> MesosContainerizerProcess::pruneImages(
 
 MesosContainerizerProcess::Metrics::Metrics()
   : container_destroy_errors(
-        "containerizer/mesos/container_destroy_errors")
+        "containerizer/mesos/container_destroy_errors"),
+    launch_provision("containerizer/mesos/launch/provision", Days(1)),
+    launch_prepare("containerizer/mesos/launch/prepare", Days(1)),
+    launch_fork("containerizer/mesos/launch/fork", Days(1)),
+    launch_isolate("containerizer/mesos/launch/isolate", Days(1)),
+    launch_fetch("containerizer/mesos/launch/fetch", Days(1))
 {
   process::metrics::add(container_destroy_errors);
+
+  process::metrics::add(launch_provision);
+  process::metrics::add(launch_prepare);
+  process::metrics::add(launch_fork);
+  process::metrics::add(launch_isolate);
+  process::metrics::add(launch_fetch);
 }
 
 
 MesosContainerizerProcess::Metrics::~Metrics()
 {
   process::metrics::remove(container_destroy_errors);
+
+  process::metrics::remove(launch_provision);
+  process::metrics::remove(launch_prepare);
+  process::metrics::remove(launch_fork);
+  process::metrics::remove(launch_isolate);
+  process::metrics::remove(launch_fetch);
 }
 
 
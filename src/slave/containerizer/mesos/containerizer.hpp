@@ -30,7 +30,9 @@
 #include <process/shared.hpp>
 
 #include <process/metrics/counter.hpp>
+#include <process/metrics/timer.hpp>
 
+#include <stout/duration.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/multihashmap.hpp>
 #include <stout/os/int_fd.hpp>
@@ -270,6 +272,12 @@ private:
       const Option<mesos::slave::ContainerTermination>& termination,
       const process::Future<bool>& destroy);
 
+  // Continues '______destroy()' once the runtime directory of the
+  // container has been cleaned up.
+  void _______destroy(
+      const ContainerID& containerId,
+      const mesos::slave::ContainerTermination& termination);
+
   // Call back for when an isolator limits a container and impacts the
   // processes. This will trigger container destruction.
   void limited(
@@ -388,6 +396,14 @@ private:
     ~Metrics();
 
     process::metrics::Counter container_destroy_errors;
+
+    // The time spent in each phase of launching a container, see
+    // `TimedIsolator` for the time spent in each isolator.
+    process::metrics::Timer<Milliseconds> launch_provision;
+    process::metrics::Timer<Milliseconds> launch_prepare;
+    process::metrics::Timer<Milliseconds> launch_fork;
+    process::metrics::Timer<Milliseconds> launch_isolate;
+    process::metrics::Timer<Milliseconds> launch_fetch;
   } metrics;
 };
 
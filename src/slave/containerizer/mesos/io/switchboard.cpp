@@ -19,6 +19,7 @@
 
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -79,6 +80,7 @@ namespace unix = process::network::unix;
 
 using std::list;
 using std::map;
+using std::set;
 using std::string;
 using std::vector;
 
@@ -542,6 +544,9 @@ Future<Option<ContainerLaunchInfo>> IOSwitchboard::_prepare(
   // TODO(jieyu): Consider making this configurable.
   environment.emplace("LIBPROCESS_NUM_WORKER_THREADS", "8");
 
+  // The switchboard needs neither the profiler nor system statistics.
+  environment.emplace("LIBPROCESS_LIGHTWEIGHT", "true");
+
   VLOG(1) << "Launching '" << IOSwitchboardServer::NAME << "' with flags '"
           << switchboardFlags << "' for container " << containerId;
 
@@ -935,15 +940,23 @@ private:
   public:
     HttpConnection(
         const http::Pipe::Writer& _writer,
-        const ContentType& contentType)
+        const ContentType& _contentType)
       : writer(_writer),
-        encoder(lambda::bind(serialize, contentType, lambda::_1)) {}
+        contentType(_contentType),
+        encoder(lambda::bind(serialize, _contentType, lambda::_1)) {}
 
     bool send(const agent::ProcessIO& message)
     {
       return writer.write(encoder.encode(message));
     }
 
+    // Sends records which are already encoded with the content
+    // type of this connection.
+    bool send(const string& records)
+    {
+      return writer.write(records);
+    }
+
     bool close()
     {
       return writer.close();
@@ -954,6 +967,8 @@ private:
       return writer.readerClosed();
     }
 
+    const ContentType contentType;
+
   private:
     http::Pipe::Writer writer;
     ::recordio::Encoder<agent::ProcessIO> encoder;
@@ -994,6 +1009,10 @@ private:
       const string& data,
       const agent::ProcessIO::Data::Type& type);
 
+  // Sends the output encoded by `outputHook` since the last flush to
+  // the output connections, in a single write per connection.
+  void flushOutput();
+
   bool tty;
   int stdinToFd;
   int stdoutFromFd;
@@ -1010,6 +1029,12 @@ private:
   // The following must be a `std::list`
   // for proper erase semantics later on.
   list<HttpConnection> outputConnections;
+
+  // The encoded records of the output not yet sent to the output
+  // connections, keyed by the content type of the connections.
+  map<ContentType, string> pendingOutput;
+  bool flushPending;
+
   Option<Failure> failure;
 };
 
@@ -1124,7 +1149,8 @@ IOSwitchboardServerProcess::IOSwitchboardServerProcess(
     socket(_socket),
     waitForConnection(_waitForConnection),
     heartbeatInterval(_heartbeatInterval),
-    inputConnected(false) {}
+    inputConnected(false),
+    flushPending(false) {}
 
 
 Future<Nothing> IOSwitchboardServerProcess::run()
@@ -1241,6 +1267,8 @@ void IOSwitchboardServerProcess::finalize()
   // maintain a reference to the socket, which would cause a leak.
   accept.discard();
 
+  flushOutput();
+
   foreach (HttpConnection& connection, outputConnections) {
     connection.close();
 
@@ -1269,6 +1297,9 @@ void IOSwitchboardServerProcess::heartbeatLoop()
   message.mutable_control()->mutable_heartbeat()
       ->mutable_interval()->set_nanoseconds(heartbeatInterval.get().ns());
 
+  // Keep the heartbeat ordered after the output read before it.
+  flushOutput();
+
   foreach (HttpConnection& connection, outputConnections) {
     connection.send(message);
   }
@@ -1730,16 +1761,49 @@ void IOSwitchboardServerProcess::outputHook(
   message.mutable_data()->set_type(type);
   message.mutable_data()->set_data(data);
 
-  // Walk through our list of connections and write the message to
-  // them. It's possible that a write might fail if the writer has
+  // Encode the message once for each content type used by the
+  // connections, rather than once per connection.
+  set<ContentType> encoded;
+  foreach (const HttpConnection& connection, outputConnections) {
+    if (encoded.count(connection.contentType) > 0) {
+      continue;
+    }
+
+    ::recordio::Encoder<agent::ProcessIO> encoder(
+        lambda::bind(serialize, connection.contentType, lambda::_1));
+
+    pendingOutput[connection.contentType] += encoder.encode(message);
+    encoded.insert(connection.contentType);
+  }
+
+  // Rather than writing every message to the connections right away,
+  // we batch the messages of the output read while the flush below
+  // is queued, i.e., while a chatty container keeps the redirects
+  // busy, so that they get sent as a single chunk per connection.
+  if (!flushPending) {
+    flushPending = true;
+    dispatch(self(), &Self::flushOutput);
+  }
+}
+
+
+void IOSwitchboardServerProcess::flushOutput()
+{
+  flushPending = false;
+
+  // Walk through our list of connections and write the pending output
+  // to them. It's possible that a write might fail if the writer has
   // been closed. That's OK because we already take care of removing
   // closed connections from our list via the future returned by
-  // the `HttpConnection::closed()` call above. We might do a few
-  // unnecessary writes if we have a bunch of messages queued up,
-  // but that shouldn't be a problem.
+  // the `HttpConnection::closed()` call above.
   foreach (HttpConnection& connection, outputConnections) {
-    connection.send(message);
+    auto records = pendingOutput.find(connection.contentType);
+    if (records != pendingOutput.end()) {
+      connection.send(records->second);
+    }
   }
+
+  pendingOutput.clear();
 }
 #endif // __WINDOWS__
 
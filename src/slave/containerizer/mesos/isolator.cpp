@@ -16,6 +16,8 @@
 
 #include <process/dispatch.hpp>
 
+#include <process/metrics/metrics.hpp>
+
 #include "slave/containerizer/mesos/isolator.hpp"
 
 using namespace process;
@@ -131,6 +133,99 @@ Future<Nothing> MesosIsolator::cleanup(
                   containerId);
 }
 
+
+
+TimedIsolator::TimedIsolator(
+    const string& name,
+    Owned<mesos::slave::Isolator> _isolator)
+  : isolator(_isolator),
+    metrics(name) {}
+
+
+TimedIsolator::~TimedIsolator() {}
+
+
+bool TimedIsolator::supportsNesting()
+{
+  return isolator->supportsNesting();
+}
+
+
+Future<Nothing> TimedIsolator::recover(
+    const list<ContainerState>& states,
+    const hashset<ContainerID>& orphans)
+{
+  return isolator->recover(states, orphans);
+}
+
+
+Future<Option<ContainerLaunchInfo>> TimedIsolator::prepare(
+    const ContainerID& containerId,
+    const ContainerConfig& containerConfig)
+{
+  return metrics.prepare.time(isolator->prepare(containerId, containerConfig));
+}
+
+
+Future<Nothing> TimedIsolator::isolate(
+    const ContainerID& containerId,
+    pid_t pid)
+{
+  return metrics.isolate.time(isolator->isolate(containerId, pid));
+}
+
+
+Future<ContainerLimitation> TimedIsolator::watch(
+    const ContainerID& containerId)
+{
+  return isolator->watch(containerId);
+}
+
+
+Future<Nothing> TimedIsolator::update(
+    const ContainerID& containerId,
+    const Resources& resources)
+{
+  return isolator->update(containerId, resources);
+}
+
+
+Future<ResourceStatistics> TimedIsolator::usage(
+    const ContainerID& containerId)
+{
+  return isolator->usage(containerId);
+}
+
+
+Future<ContainerStatus> TimedIsolator::status(
+    const ContainerID& containerId)
+{
+  return isolator->status(containerId);
+}
+
+
+Future<Nothing> TimedIsolator::cleanup(
+    const ContainerID& containerId)
+{
+  return isolator->cleanup(containerId);
+}
+
+
+TimedIsolator::Metrics::Metrics(const string& name)
+  : prepare("containerizer/mesos/isolators/" + name + "/prepare", Days(1)),
+    isolate("containerizer/mesos/isolators/" + name + "/isolate", Days(1))
+{
+  process::metrics::add(prepare);
+  process::metrics::add(isolate);
+}
+
+
+TimedIsolator::Metrics::~Metrics()
+{
+  process::metrics::remove(prepare);
+  process::metrics::remove(isolate);
+}
+
 } // namespace slave {
 } // namespace internal {
 } // namespace mesos {
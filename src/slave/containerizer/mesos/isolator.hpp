@@ -22,6 +22,9 @@
 #include <process/owned.hpp>
 #include <process/process.hpp>
 
+#include <process/metrics/timer.hpp>
+
+#include <stout/duration.hpp>
 #include <stout/none.hpp>
 
 namespace mesos {
@@ -139,6 +142,63 @@ public:
   }
 };
 
+
+// A wrapper class that forwards all calls to the wrapped 'Isolator'
+// and records how long it takes to prepare and isolate containers
+// in the 'containerizer/mesos/isolators/<name>/...' metrics, so that
+// slow isolators can be told apart when launching containers.
+class TimedIsolator : public mesos::slave::Isolator
+{
+public:
+  TimedIsolator(
+      const std::string& name,
+      process::Owned<mesos::slave::Isolator> isolator);
+
+  virtual ~TimedIsolator();
+
+  virtual bool supportsNesting();
+
+  virtual process::Future<Nothing> recover(
+      const std::list<mesos::slave::ContainerState>& states,
+      const hashset<ContainerID>& orphans);
+
+  virtual process::Future<Option<mesos::slave::ContainerLaunchInfo>> prepare(
+      const ContainerID& containerId,
+      const mesos::slave::ContainerConfig& containerConfig);
+
+  virtual process::Future<Nothing> isolate(
+      const ContainerID& containerId,
+      pid_t pid);
+
+  virtual process::Future<mesos::slave::ContainerLimitation> watch(
+      const ContainerID& containerId);
+
+  virtual process::Future<Nothing> update(
+      const ContainerID& containerId,
+      const Resources& resources);
+
+  virtual process::Future<ResourceStatistics> usage(
+      const ContainerID& containerId);
+
+  virtual process::Future<ContainerStatus> status(
+      const ContainerID& containerId);
+
+  virtual process::Future<Nothing> cleanup(
+      const ContainerID& containerId);
+
+private:
+  process::Owned<mesos::slave::Isolator> isolator;
+
+  struct Metrics
+  {
+    explicit Metrics(const std::string& name);
+    ~Metrics();
+
+    process::metrics::Timer<Milliseconds> prepare;
+    process::metrics::Timer<Milliseconds> isolate;
+  } metrics;
+};
+
 } // namespace slave {
 } // namespace internal {
 } // namespace mesos {
@@ -14,31 +14,627 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <utility>
+#include <vector>
+
 #include <process/id.hpp>
 
+#include <stout/foreach.hpp>
+#include <stout/numify.hpp>
+#include <stout/path.hpp>
+#include <stout/stringify.hpp>
+#include <stout/strings.hpp>
+
+#include <stout/os/exists.hpp>
+#include <stout/os/ls.hpp>
+#include <stout/os/read.hpp>
+#include <stout/os/rm.hpp>
+
+#include "linux/cgroups.hpp"
+
+#include "slave/state.hpp"
+
 #include "slave/containerizer/mesos/isolators/cgroups/subsystems/cpuset.hpp"
 
+using process::Failure;
+using process::Future;
 using process::Owned;
 
+using std::list;
+using std::map;
+using std::pair;
+using std::set;
 using std::string;
+using std::vector;
 
 namespace mesos {
 namespace internal {
 namespace slave {
 
+Try<CpuTopology> CpuTopology::discover(const set<unsigned int>& cpus)
+{
+  // The NUMA nodes are not exposed by kernels without NUMA support,
+  // in which case all CPUs are on node 0.
+  map<unsigned int, unsigned int> nodes;
+
+  const string nodeDir = "/sys/devices/system/node";
+  if (os::exists(nodeDir)) {
+    Try<list<string>> entries = os::ls(nodeDir);
+    if (entries.isError()) {
+      return Error("Failed to list '" + nodeDir + "': " + entries.error());
+    }
+
+    foreach (const string& entry, entries.get()) {
+      if (!strings::startsWith(entry, "node")) {
+        continue;
+      }
+
+      Try<unsigned int> node = numify<unsigned int>(entry.substr(4));
+      if (node.isError()) {
+        continue;
+      }
+
+      const string path = path::join(nodeDir, entry, "cpulist");
+
+      Try<string> read = os::read(path);
+      if (read.isError()) {
+        return Error("Failed to read '" + path + "': " + read.error());
+      }
+
+      Try<set<unsigned int>> list = parseCpuList(read.get());
+      if (list.isError()) {
+        return Error("Failed to parse '" + path + "': " + list.error());
+      }
+
+      foreach (unsigned int cpu, list.get()) {
+        nodes[cpu] = node.get();
+      }
+    }
+  }
+
+  map<unsigned int, Cpu> topology;
+
+  foreach (unsigned int cpu, cpus) {
+    const string cpuDir =
+      path::join("/sys/devices/system/cpu", "cpu" + stringify(cpu), "topology");
+
+    auto read = [&cpuDir](const string& file) -> Try<int> {
+      const string path = path::join(cpuDir, file);
+
+      Try<string> read = os::read(path);
+      if (read.isError()) {
+        return Error("Failed to read '" + path + "': " + read.error());
+      }
+
+      // NOTE: The physical package ID is -1 if it is not known.
+      Try<int> id = numify<int>(strings::trim(read.get()));
+      if (id.isError()) {
+        return Error("Failed to parse '" + path + "': " + id.error());
+      }
+
+      return id.get();
+    };
+
+    Try<int> socket = read("physical_package_id");
+    if (socket.isError()) {
+      return Error(socket.error());
+    }
+
+    Try<int> core = read("core_id");
+    if (core.isError()) {
+      return Error(core.error());
+    }
+
+    Cpu cpu_;
+    cpu_.node = nodes.count(cpu) > 0 ? nodes.at(cpu) : 0;
+    cpu_.socket = socket.get();
+    cpu_.core = core.get();
+
+    topology[cpu] = cpu_;
+  }
+
+  return CpuTopology(topology);
+}
+
+
+Option<set<unsigned int>> CpuTopology::allocate(
+    const set<unsigned int>& available,
+    size_t count) const
+{
+  // The available CPUs of each core, grouped by NUMA node.
+  map<unsigned int, map<pair<int, int>, vector<unsigned int>>> nodes;
+
+  foreach (unsigned int cpu, available) {
+    if (cpus.count(cpu) > 0) {
+      const Cpu& cpu_ = cpus.at(cpu);
+      nodes[cpu_.node][std::make_pair(cpu_.socket, cpu_.core)].push_back(cpu);
+    }
+  }
+
+  // Use the node with the fewest available CPUs that can fit all of
+  // them, which leaves the larger nodes for larger containers.
+  // Otherwise spread the CPUs over the nodes with the most available
+  // CPUs first.
+  vector<pair<size_t, unsigned int>> sizes;
+
+  foreachpair (unsigned int node, const auto& cores, nodes) {
+    size_t size = 0;
+    foreachvalue (const vector<unsigned int>& core, cores) {
+      size += core.size();
+    }
+
+    sizes.push_back(std::make_pair(size, node));
+  }
+
+  std::sort(sizes.begin(), sizes.end());
+
+  auto fit = std::find_if(
+      sizes.begin(),
+      sizes.end(),
+      [count](const pair<size_t, unsigned int>& size) {
+        return size.first >= count;
+      });
+
+  if (fit != sizes.end()) {
+    sizes = {*fit};
+  } else {
+    std::reverse(sizes.begin(), sizes.end());
+  }
+
+  set<unsigned int> result;
+  size_t remaining = count;
+
+  foreach (const auto& size, sizes) {
+    if (remaining == 0) {
+      break;
+    }
+
+    vector<vector<unsigned int>> cores;
+    foreachvalue (const vector<unsigned int>& core, nodes.at(size.second)) {
+      cores.push_back(core);
+    }
+
+    // Take whole cores first, starting with the cores with the most
+    // available hyperthreads.
+    std::stable_sort(
+        cores.begin(),
+        cores.end(),
+        [](const vector<unsigned int>& a, const vector<unsigned int>& b) {
+          return a.size() > b.size();
+        });
+
+    Option<vector<unsigned int>> partial;
+
+    foreach (const vector<unsigned int>& core, cores) {
+      if (core.size() <= remaining) {
+        result.insert(core.begin(), core.end());
+        remaining -= core.size();
+      } else if (partial.isNone() || core.size() < partial->size()) {
+        partial = core;
+      }
+    }
+
+    // Take the remaining CPUs from the core with the fewest available
+    // hyperthreads that can fit them.
+    if (remaining > 0 && partial.isSome()) {
+      result.insert(partial->begin(), partial->begin() + remaining);
+      remaining = 0;
+    }
+  }
+
+  if (remaining > 0) {
+    return None();
+  }
+
+  return result;
+}
+
+
+set<unsigned int> CpuTopology::nodes(const set<unsigned int>& cpus_) const
+{
+  set<unsigned int> result;
+
+  foreach (unsigned int cpu, cpus_) {
+    if (cpus.count(cpu) > 0) {
+      result.insert(cpus.at(cpu).node);
+    }
+  }
+
+  return result;
+}
+
+
+Try<set<unsigned int>> parseCpuList(const string& list)
+{
+  set<unsigned int> result;
+
+  foreach (const string& token, strings::tokenize(strings::trim(list), ",")) {
+    vector<string> range = strings::split(token, "-");
+    if (range.size() > 2) {
+      return Error("Invalid range '" + token + "'");
+    }
+
+    Try<unsigned int> first = numify<unsigned int>(range.front());
+    if (first.isError()) {
+      return Error("Invalid range '" + token + "': " + first.error());
+    }
+
+    Try<unsigned int> last = numify<unsigned int>(range.back());
+    if (last.isError()) {
+      return Error("Invalid range '" + token + "': " + last.error());
+    }
+
+    if (first.get() > last.get()) {
+      return Error("Invalid range '" + token + "'");
+    }
+
+    for (unsigned int i = first.get(); i <= last.get(); i++) {
+      result.insert(i);
+    }
+  }
+
+  return result;
+}
+
+
+string stringifyCpuList(const set<unsigned int>& list)
+{
+  vector<string> ranges;
+
+  auto it = list.begin();
+  while (it != list.end()) {
+    const unsigned int first = *it;
+    unsigned int last = first;
+
+    for (++it; it != list.end() && *it == last + 1; ++it) {
+      last = *it;
+    }
+
+    ranges.push_back(
+        first == last
+          ? stringify(first)
+          : stringify(first) + "-" + stringify(last));
+  }
+
+  return strings::join(",", ranges);
+}
+
+
+// Returns the path of the checkpointed CPUs assigned exclusively to a
+// container. These are checkpointed in the runtime directory since
+// the assignments do not outlive the containers.
+static string getCpusPath(
+    const string& runtimeDir,
+    const ContainerID& containerId)
+{
+  return path::join(runtimeDir, "cgroups", "cpuset", containerId.value());
+}
+
+
+static Try<Nothing> assign(
+    const string& hierarchy,
+    const string& cgroup,
+    const set<unsigned int>& cpus,
+    const set<unsigned int>& mems)
+{
+  Try<Nothing> write = cgroups::write(
+      hierarchy, cgroup, "cpuset.cpus", stringifyCpuList(cpus));
+
+  if (write.isError()) {
+    return Error("Failed to write 'cpuset.cpus': " + write.error());
+  }
+
+  write = cgroups::write(
+      hierarchy, cgroup, "cpuset.mems", stringifyCpuList(mems));
+
+  if (write.isError()) {
+    return Error("Failed to write 'cpuset.mems': " + write.error());
+  }
+
+  return Nothing();
+}
+
+
 Try<Owned<Subsystem>> CpusetSubsystem::create(
     const Flags& flags,
     const string& hierarchy)
 {
-  return Owned<Subsystem>(new CpusetSubsystem(flags, hierarchy));
+  if (!flags.cgroups_cpuset_exclusive_cpus) {
+    return Owned<Subsystem>(
+        new CpusetSubsystem(flags, hierarchy, None(), {}, {}));
+  }
+
+  // The CPUs and NUMA nodes of the containers are those of the root
+  // cgroup of the agent.
+  Try<string> cpus =
+    cgroups::read(hierarchy, flags.cgroups_root, "cpuset.cpus");
+
+  if (cpus.isError()) {
+    return Error("Failed to read 'cpuset.cpus': " + cpus.error());
+  }
+
+  Try<set<unsigned int>> cpus_ = parseCpuList(cpus.get());
+  if (cpus_.isError()) {
+    return Error("Failed to parse 'cpuset.cpus': " + cpus_.error());
+  }
+
+  Try<string> mems =
+    cgroups::read(hierarchy, flags.cgroups_root, "cpuset.mems");
+
+  if (mems.isError()) {
+    return Error("Failed to read 'cpuset.mems': " + mems.error());
+  }
+
+  Try<set<unsigned int>> mems_ = parseCpuList(mems.get());
+  if (mems_.isError()) {
+    return Error("Failed to parse 'cpuset.mems': " + mems_.error());
+  }
+
+  Try<CpuTopology> topology = CpuTopology::discover(cpus_.get());
+  if (topology.isError()) {
+    return Error("Failed to discover the CPU topology: " + topology.error());
+  }
+
+  return Owned<Subsystem>(new CpusetSubsystem(
+      flags, hierarchy, topology.get(), cpus_.get(), mems_.get()));
 }
 
 
 CpusetSubsystem::CpusetSubsystem(
     const Flags& _flags,
-    const string& _hierarchy)
+    const string& _hierarchy,
+    const Option<CpuTopology>& _topology,
+    const set<unsigned int>& _cpus,
+    const set<unsigned int>& _mems)
   : ProcessBase(process::ID::generate("cgroups-cpuset-subsystem")),
-    Subsystem(_flags, _hierarchy) {}
+    Subsystem(_flags, _hierarchy),
+    topology(_topology),
+    cpus(_cpus),
+    mems(_mems) {}
+
+
+Future<Nothing> CpusetSubsystem::recover(
+    const ContainerID& containerId,
+    const string& cgroup)
+{
+  if (infos.contains(containerId)) {
+    return Failure("The subsystem '" + name() + "' has already been recovered");
+  }
+
+  Owned<Info> info(new Info(cgroup));
+
+  const string path = getCpusPath(flags.runtime_dir, containerId);
+
+  if (topology.isSome() && os::exists(path)) {
+    Try<string> read = os::read(path);
+    if (read.isError()) {
+      return Failure(
+          "Failed to read the checkpointed CPUs at '" + path + "': " +
+          read.error());
+    }
+
+    Try<set<unsigned int>> cpus_ = parseCpuList(read.get());
+    if (cpus_.isError()) {
+      return Failure(
+          "Failed to parse the checkpointed CPUs at '" + path + "': " +
+          cpus_.error());
+    }
+
+    info->cpus = cpus_.get();
+  }
+
+  infos.put(containerId, info);
+
+  return Nothing();
+}
+
+
+Future<Nothing> CpusetSubsystem::prepare(
+    const ContainerID& containerId,
+    const string& cgroup)
+{
+  if (infos.contains(containerId)) {
+    return Failure("The subsystem '" + name() + "' has already been prepared");
+  }
+
+  infos.put(containerId, Owned<Info>(new Info(cgroup)));
+
+  // The cgroup inherits all the CPUs of its parent, including those
+  // assigned exclusively to other containers.
+  if (topology.isSome()) {
+    Try<Nothing> assign_ = assign(hierarchy, cgroup, shared(), mems);
+    if (assign_.isError()) {
+      return Failure("Failed to assign the shared CPUs: " + assign_.error());
+    }
+  }
+
+  return Nothing();
+}
+
+
+Future<Nothing> CpusetSubsystem::update(
+    const ContainerID& containerId,
+    const string& cgroup,
+    const Resources& resources)
+{
+  if (!infos.contains(containerId)) {
+    return Failure(
+        "Failed to update subsystem '" + name() + "': Unknown container");
+  }
+
+  if (topology.isNone()) {
+    return Nothing();
+  }
+
+  if (resources.cpus().isNone()) {
+    return Failure(
+        "Failed to update subsystem '" + name() + "': "
+        "No cpus resource given");
+  }
+
+  const Owned<Info>& info = infos[containerId];
+
+  // Only containers allocated a whole number of non-revocable CPUs
+  // get CPUs assigned exclusively.
+  const double cpus_ = resources.cpus().get();
+
+  size_t count = 0;
+  if (resources.revocable().cpus().isNone() &&
+      cpus_ >= 1 &&
+      cpus_ == std::floor(cpus_)) {
+    count = static_cast<size_t>(cpus_);
+  }
+
+  if ((info->cpus.isNone() && count == 0) ||
+      (info->cpus.isSome() && info->cpus->size() == count)) {
+    return Nothing();
+  }
+
+  Option<set<unsigned int>> assigned;
+
+  if (count > 0) {
+    set<unsigned int> available = shared();
+    if (info->cpus.isSome()) {
+      available.insert(info->cpus->begin(), info->cpus->end());
+    }
+
+    // Always leave a CPU to the containers sharing CPUs.
+    if (available.size() > count) {
+      assigned = topology->allocate(available, count);
+    }
+
+    if (assigned.isNone()) {
+      LOG(WARNING) << "Not enough CPUs to assign " << count << " CPUs "
+                   << "exclusively to container " << containerId
+                   << ", sharing CPUs instead";
+    }
+  }
+
+  const string path = getCpusPath(flags.runtime_dir, containerId);
+
+  if (assigned.isSome()) {
+    Try<Nothing> checkpoint =
+      slave::state::checkpoint(path, stringifyCpuList(assigned.get()));
+
+    if (checkpoint.isError()) {
+      return Failure(
+          "Failed to checkpoint the CPUs at '" + path + "': " +
+          checkpoint.error());
+    }
+  } else if (os::exists(path)) {
+    Try<Nothing> rm = os::rm(path);
+    if (rm.isError()) {
+      return Failure(
+          "Failed to remove the checkpointed CPUs at '" + path + "': " +
+          rm.error());
+    }
+  }
+
+  info->cpus = assigned;
+
+  // NOTE: This also assigns the shared CPUs to the container if it
+  // does not get CPUs assigned exclusively.
+  reassign();
+
+  if (assigned.isSome()) {
+    // Pin the memory to the NUMA nodes of the CPUs.
+    set<unsigned int> mems_;
+    foreach (unsigned int node, topology->nodes(assigned.get())) {
+      if (mems.count(node) > 0) {
+        mems_.insert(node);
+      }
+    }
+
+    Try<Nothing> assign_ = assign(
+        hierarchy,
+        cgroup,
+        assigned.get(),
+        mems_.empty() ? mems : mems_);
+
+    if (assign_.isError()) {
+      return Failure("Failed to assign the CPUs: " + assign_.error());
+    }
+
+    LOG(INFO) << "Assigned CPUs " << stringifyCpuList(assigned.get())
+              << " exclusively to container " << containerId;
+  }
+
+  return Nothing();
+}
+
+
+Future<Nothing> CpusetSubsystem::cleanup(
+    const ContainerID& containerId,
+    const string& cgroup)
+{
+  if (!infos.contains(containerId)) {
+    VLOG(1) << "Ignoring cleanup subsystem '" << name() << "' "
+            << "request for unknown container " << containerId;
+
+    return Nothing();
+  }
+
+  const bool exclusive = infos[containerId]->cpus.isSome();
+
+  infos.erase(containerId);
+
+  const string path = getCpusPath(flags.runtime_dir, containerId);
+
+  if (os::exists(path)) {
+    Try<Nothing> rm = os::rm(path);
+    if (rm.isError()) {
+      return Failure(
+          "Failed to remove the checkpointed CPUs at '" + path + "': " +
+          rm.error());
+    }
+  }
+
+  // Give the CPUs back to the containers sharing CPUs.
+  if (exclusive && topology.isSome()) {
+    reassign();
+  }
+
+  return Nothing();
+}
+
+
+set<unsigned int> CpusetSubsystem::shared() const
+{
+  set<unsigned int> result = cpus;
+
+  foreachvalue (const Owned<Info>& info, infos) {
+    if (info->cpus.isSome()) {
+      foreach (unsigned int cpu, info->cpus.get()) {
+        result.erase(cpu);
+      }
+    }
+  }
+
+  return result;
+}
+
+
+void CpusetSubsystem::reassign()
+{
+  const set<unsigned int> cpus_ = shared();
+
+  foreachpair (const ContainerID& containerId,
+               const Owned<Info>& info,
+               infos) {
+    if (info->cpus.isNone()) {
+      // NOTE: This fails if the container created nested cgroups with
+      // CPUs that are no longer shared, which the executor must avoid.
+      Try<Nothing> assign_ = assign(hierarchy, info->cgroup, cpus_, mems);
+      if (assign_.isError()) {
+        LOG(WARNING) << "Failed to assign the shared CPUs to container "
+                     << containerId << ": " << assign_.error();
+      }
+    }
+  }
+}
 
 } // namespace slave {
 } // namespace internal {
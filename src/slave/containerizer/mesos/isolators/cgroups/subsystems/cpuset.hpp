@@ -17,10 +17,18 @@
 #ifndef __CGROUPS_ISOLATOR_SUBSYSTEMS_CPUSET_HPP__
 #define __CGROUPS_ISOLATOR_SUBSYSTEMS_CPUSET_HPP__
 
+#include <map>
+#include <set>
 #include <string>
 
+#include <mesos/resources.hpp>
+
+#include <process/future.hpp>
 #include <process/owned.hpp>
 
+#include <stout/hashmap.hpp>
+#include <stout/nothing.hpp>
+#include <stout/option.hpp>
 #include <stout/try.hpp>
 
 #include "slave/flags.hpp"
@@ -32,6 +40,58 @@ namespace mesos {
 namespace internal {
 namespace slave {
 
+// The CPU topology of the agent: the NUMA node and the physical core
+// of each CPU, where the CPUs of a core are its hyperthread siblings.
+//
+// This is used to choose the CPUs assigned exclusively to a
+// container, such that the container gets whole cores from a single
+// NUMA node whenever possible.
+class CpuTopology
+{
+public:
+  struct Cpu
+  {
+    unsigned int node;
+
+    // The physical package (i.e., socket) and the core ID, the latter
+    // is only unique within a socket.
+    int socket;
+    int core;
+  };
+
+  // Discovers the topology of the given CPUs from sysfs.
+  static Try<CpuTopology> discover(const std::set<unsigned int>& cpus);
+
+  explicit CpuTopology(const std::map<unsigned int, Cpu>& _cpus)
+    : cpus(_cpus) {}
+
+  // Chooses `count` CPUs out of the `available` ones. The CPUs are
+  // taken from the NUMA node with the fewest available CPUs that can
+  // fit all of them, or from as few nodes as possible otherwise.
+  // Within a node, whole cores are taken first so that the container
+  // does not share cores with others. Returns None if there are not
+  // enough available CPUs.
+  Option<std::set<unsigned int>> allocate(
+      const std::set<unsigned int>& available,
+      size_t count) const;
+
+  // Returns the NUMA nodes of the given CPUs.
+  std::set<unsigned int> nodes(const std::set<unsigned int>& cpus) const;
+
+private:
+  std::map<unsigned int, Cpu> cpus;
+};
+
+
+// Parses a list of CPUs or NUMA nodes in the format used by cpusets
+// and sysfs, e.g., "0-3,8,10-11".
+Try<std::set<unsigned int>> parseCpuList(const std::string& list);
+
+
+// Formats a list of CPUs or NUMA nodes in the format used by cpusets.
+std::string stringifyCpuList(const std::set<unsigned int>& list);
+
+
 /**
  * Represent cgroups cpuset subsystem.
  */
@@ -49,8 +109,59 @@ public:
     return CGROUP_SUBSYSTEM_CPUSET_NAME;
   };
 
+  virtual process::Future<Nothing> recover(
+      const ContainerID& containerId,
+      const std::string& cgroup);
+
+  virtual process::Future<Nothing> prepare(
+      const ContainerID& containerId,
+      const std::string& cgroup);
+
+  virtual process::Future<Nothing> update(
+      const ContainerID& containerId,
+      const std::string& cgroup,
+      const Resources& resources);
+
+  virtual process::Future<Nothing> cleanup(
+      const ContainerID& containerId,
+      const std::string& cgroup);
+
 private:
-  CpusetSubsystem(const Flags& flags, const std::string& hierarchy);
+  CpusetSubsystem(
+      const Flags& flags,
+      const std::string& hierarchy,
+      const Option<CpuTopology>& topology,
+      const std::set<unsigned int>& cpus,
+      const std::set<unsigned int>& mems);
+
+  struct Info
+  {
+    Info(const std::string& _cgroup) : cgroup(_cgroup) {}
+
+    const std::string cgroup;
+
+    // The CPUs assigned exclusively to the container, if any. The
+    // other containers share the CPUs not assigned exclusively.
+    Option<std::set<unsigned int>> cpus;
+  };
+
+  // Returns the CPUs not assigned exclusively to any container.
+  std::set<unsigned int> shared() const;
+
+  // Sets the cpuset of the containers sharing CPUs to the CPUs not
+  // assigned exclusively, e.g., after an assignment changed.
+  void reassign();
+
+  // The topology of the CPUs, only known if CPUs are assigned
+  // exclusively (see the `--cgroups_cpuset_exclusive_cpus` flag).
+  const Option<CpuTopology> topology;
+
+  // The CPUs and NUMA nodes available to the containers.
+  const std::set<unsigned int> cpus;
+  const std::set<unsigned int> mems;
+
+  // Stores cgroups associated information for container.
+  hashmap<ContainerID, process::Owned<Info>> infos;
 };
 
 } // namespace slave {
@@ -44,11 +44,12 @@ Try<Owned<Subsystem>> PerfEventSubsystem::create(
     const Flags& flags,
     const string& hierarchy)
 {
-  if (!perf::supported()) {
+  // Counting the events continuously does not need the perf binary.
+  if (!flags.perf_continuous && !perf::supported()) {
     return Error("Perf is not supported");
   }
 
-  if (flags.perf_duration > flags.perf_interval) {
+  if (!flags.perf_continuous && flags.perf_duration > flags.perf_interval) {
     return Error(
         "Sampling perf for duration (" + stringify(flags.perf_duration) + ") > "
         "interval (" + stringify(flags.perf_interval) + ") is not supported.");
@@ -64,6 +65,18 @@ Try<Owned<Subsystem>> PerfEventSubsystem::create(
     events.insert(event);
   }
 
+  if (flags.perf_continuous) {
+    Option<Error> error = perf::Counters::validate(events);
+    if (error.isSome()) {
+      return Error("Invalid perf events: " + error->message);
+    }
+
+    LOG(INFO) << "perf_event subsystem will count continuously "
+              << "for events: " << stringify(events);
+
+    return Owned<Subsystem>(new PerfEventSubsystem(flags, hierarchy, events));
+  }
+
   if (!perf::valid(events)) {
     return Error("Invalid perf events: " + stringify(events));
   }
@@ -88,8 +101,11 @@ PerfEventSubsystem::PerfEventSubsystem(
 
 void PerfEventSubsystem::initialize()
 {
-  // Start sampling.
-  sample();
+  // Start sampling, unless the counters of each container are read
+  // on demand instead.
+  if (!flags.perf_continuous) {
+    sample();
+  }
 }
 
 
@@ -103,6 +119,10 @@ Future<Nothing> PerfEventSubsystem::recover(
 
   infos.put(containerId, Owned<Info>(new Info(cgroup)));
 
+  if (flags.perf_continuous) {
+    open(containerId);
+  }
+
   return Nothing();
 }
 
@@ -117,6 +137,10 @@ Future<Nothing> PerfEventSubsystem::prepare(
 
   infos.put(containerId, Owned<Info>(new Info(cgroup)));
 
+  if (flags.perf_continuous) {
+    open(containerId);
+  }
+
   return Nothing();
 }
 
@@ -131,8 +155,19 @@ Future<ResourceStatistics> PerfEventSubsystem::usage(
         ": Unknown container");
   }
 
+  const Owned<Info>& info = infos[containerId];
+
+  if (info->counters.isSome()) {
+    Try<PerfStatistics> read = info->counters.get()->read();
+    if (read.isError()) {
+      return Failure("Failed to read the perf counters: " + read.error());
+    }
+
+    info->statistics = read.get();
+  }
+
   ResourceStatistics statistics;
-  statistics.mutable_perf()->CopyFrom(infos[containerId]->statistics);
+  statistics.mutable_perf()->CopyFrom(info->statistics);
 
   return statistics;
 }
@@ -155,6 +190,25 @@ Future<Nothing> PerfEventSubsystem::cleanup(
 }
 
 
+void PerfEventSubsystem::open(const ContainerID& containerId)
+{
+  const Owned<Info>& info = infos[containerId];
+
+  Try<Owned<perf::Counters>> counters =
+    perf::Counters::open(events, hierarchy, info->cgroup);
+
+  // Like when sampling fails, the container keeps reporting its
+  // initial empty statistics.
+  if (counters.isError()) {
+    LOG(ERROR) << "Failed to open the perf counters of container "
+               << containerId << ": " << counters.error();
+    return;
+  }
+
+  info->counters = counters.get();
+}
+
+
 void PerfEventSubsystem::sample()
 {
   // Collect a perf sample for all cgroups that are not being
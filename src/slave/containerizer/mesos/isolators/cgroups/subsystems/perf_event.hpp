@@ -28,6 +28,9 @@
 #include <process/time.hpp>
 
 #include <stout/hashmap.hpp>
+#include <stout/option.hpp>
+
+#include "linux/perf.hpp"
 
 #include "slave/flags.hpp"
 
@@ -95,8 +98,16 @@ private:
 
     const std::string cgroup;
     PerfStatistics statistics;
+
+    // The counters of the container, if the events are counted
+    // continuously (see the `--perf_continuous` flag).
+    Option<process::Owned<perf::Counters>> counters;
   };
 
+  // Opens the counters of the container, if the events are counted
+  // continuously rather than sampled.
+  void open(const ContainerID& containerId);
+
   void sample();
 
   void _sample(
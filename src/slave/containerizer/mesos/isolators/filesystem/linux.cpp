@@ -528,7 +528,7 @@ Future<Nothing> LinuxFilesystemIsolatorProcess::update(
       // not, mount the persistent volume as we did below. This is
       // possible because the slave could crash after it unmounts the
       // volume but before it is able to delete the mount point.
-      Try<fs::MountInfoTable> table = fs::MountInfoTable::read();
+      Try<fs::MountInfoTable> table = fs::MountInfoTable::cached();
       if (table.isError()) {
         return Failure("Failed to get mount table: " + table.error());
       }
@@ -626,7 +626,7 @@ Future<Nothing> LinuxFilesystemIsolatorProcess::cleanup(
   // Cleanup the mounts for this container in the host mount
   // namespace, including container's work directory and all the
   // persistent volume mounts.
-  Try<fs::MountInfoTable> table = fs::MountInfoTable::read();
+  Try<fs::MountInfoTable> table = fs::MountInfoTable::cached();
   if (table.isError()) {
     return Failure("Failed to get mount table: " + table.error());
   }
@@ -16,18 +16,24 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
 #include <ostream>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <glog/logging.h>
+
 #include <process/check.hpp>
 #include <process/dispatch.hpp>
 #include <process/future.hpp>
 #include <process/once.hpp>
 #include <process/process.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/nothing.hpp>
+#include <stout/option.hpp>
 #include <stout/set.hpp>
 #include <stout/stringify.hpp>
 #include <stout/strings.hpp>
@@ -43,7 +49,9 @@ using process::Future;
 using process::Once;
 using process::PID;
 
+using std::map;
 using std::ostream;
+using std::pair;
 using std::set;
 using std::string;
 using std::vector;
@@ -74,9 +82,9 @@ set<T> operator-(const set<T>& left, const set<T>& right)
 }
 
 
-// Return the GPUs devices to manage
+// Return the GPUs devices to manage, along with their NVML handles,
 // based on the flags and resource scalars.
-static Try<set<Gpu>> enumerateGpus(
+static Try<map<Gpu, nvmlDevice_t>> enumerateGpus(
     const Flags& flags,
     const Resources& resources)
 {
@@ -90,7 +98,7 @@ static Try<set<Gpu>> enumerateGpus(
     }
   }
 
-  set<Gpu> gpus;
+  map<Gpu, nvmlDevice_t> gpus;
 
   foreach (unsigned int index, indices) {
     Try<nvmlDevice_t> handle = nvml::deviceGetHandleByIndex(index);
@@ -107,13 +115,49 @@ static Try<set<Gpu>> enumerateGpus(
     gpu.major = NVIDIA_MAJOR_DEVICE;
     gpu.minor = minor.get();
 
-    gpus.insert(gpu);
+    gpus[gpu] = handle.get();
   }
 
   return gpus;
 }
 
 
+// Return the distance between each pair of GPUs, which is the level
+// of their closest common ancestor in the system topology (see
+// `nvmlGpuTopologyLevel_t`). The GPUs are considered to be as far as
+// possible from each other if their topology is not known.
+static map<pair<Gpu, Gpu>, unsigned int> enumerateGpuDistances(
+    const map<Gpu, nvmlDevice_t>& gpus)
+{
+  map<pair<Gpu, Gpu>, unsigned int> distances;
+
+  foreachpair (const Gpu& gpu1, nvmlDevice_t handle1, gpus) {
+    foreachpair (const Gpu& gpu2, nvmlDevice_t handle2, gpus) {
+      if (gpu1 >= gpu2) {
+        continue;
+      }
+
+      Try<nvmlGpuTopologyLevel_t> level =
+        nvml::deviceGetTopologyCommonAncestor(handle1, handle2);
+
+      if (level.isError()) {
+        LOG(WARNING) << "Failed to determine the topology of GPUs " << gpu1
+                     << " and " << gpu2 << ": " << level.error();
+      }
+
+      const unsigned int distance = level.isSome()
+        ? static_cast<unsigned int>(level.get())
+        : static_cast<unsigned int>(NVML_TOPOLOGY_SYSTEM);
+
+      distances[std::make_pair(gpu1, gpu2)] = distance;
+      distances[std::make_pair(gpu2, gpu1)] = distance;
+    }
+  }
+
+  return distances;
+}
+
+
 // To determine the proper number of GPU resources to return, we
 // need to check both --resources and --nvidia_gpu_devices.
 // There are two cases to consider:
@@ -249,8 +293,11 @@ class NvidiaGpuAllocatorProcess
   : public process::Process<NvidiaGpuAllocatorProcess>
 {
 public:
-  NvidiaGpuAllocatorProcess(const set<Gpu>& gpus)
-    : available(gpus) {}
+  NvidiaGpuAllocatorProcess(
+      const set<Gpu>& gpus,
+      const map<pair<Gpu, Gpu>, unsigned int>& _distances)
+    : available(gpus),
+      distances(_distances) {}
 
   Future<set<Gpu>> allocate(size_t count)
   {
@@ -259,9 +306,51 @@ public:
                      " " + stringify(available.size()) + " available");
     }
 
-    set<Gpu> allocation(
-        available.begin(),
-        std::next(available.begin(), count));
+    // Grow an allocation from each available GPU by repeatedly adding
+    // the GPU closest to those already in it, and keep the allocation
+    // with the smallest sum of distances between its GPUs. Ties are
+    // broken in favor of the lowest GPUs, which means the GPUs get
+    // allocated in order if their topology is not known.
+    set<Gpu> allocation;
+    Option<unsigned int> cost;
+
+    if (count > 0) {
+      foreach (const Gpu& first, available) {
+        set<Gpu> candidate = {first};
+        unsigned int candidateCost = 0;
+
+        while (candidate.size() < count) {
+          Option<Gpu> closest;
+          unsigned int closestCost = 0;
+
+          foreach (const Gpu& gpu, available) {
+            if (candidate.count(gpu) > 0) {
+              continue;
+            }
+
+            unsigned int gpuCost = 0;
+            foreach (const Gpu& other, candidate) {
+              gpuCost += distance(gpu, other);
+            }
+
+            if (closest.isNone() || gpuCost < closestCost) {
+              closest = gpu;
+              closestCost = gpuCost;
+            }
+          }
+
+          CHECK_SOME(closest);
+
+          candidate.insert(closest.get());
+          candidateCost += closestCost;
+        }
+
+        if (cost.isNone() || candidateCost < cost.get()) {
+          allocation = candidate;
+          cost = candidateCost;
+        }
+      }
+    }
 
     return allocate(allocation)
       .then([=]() -> Future<set<Gpu>> { return allocation; });
@@ -296,8 +385,20 @@ public:
   }
 
 private:
+  unsigned int distance(const Gpu& gpu1, const Gpu& gpu2) const
+  {
+    auto it = distances.find(std::make_pair(gpu1, gpu2));
+    if (it == distances.end()) {
+      return gpu1 == gpu2 ? 0 : NVML_TOPOLOGY_SYSTEM;
+    }
+
+    return it->second;
+  }
+
   set<Gpu> available;
   set<Gpu> allocated;
+
+  const map<pair<Gpu, Gpu>, unsigned int> distances;
 };
 
 } // namespace {
@@ -305,9 +406,13 @@ private:
 
 struct NvidiaGpuAllocator::Data
 {
-  Data(const set<Gpu>& gpus_)
+  Data(
+      const set<Gpu>& gpus_,
+      const map<pair<Gpu, Gpu>, unsigned int>& distances)
     : gpus(gpus_),
-      process(process::spawn(new NvidiaGpuAllocatorProcess(gpus_), true)) {}
+      process(process::spawn(
+          new NvidiaGpuAllocatorProcess(gpus_, distances),
+          true)) {}
 
   ~Data()
   {
@@ -323,12 +428,17 @@ Try<NvidiaGpuAllocator> NvidiaGpuAllocator::create(
     const Flags& flags,
     const Resources& resources)
 {
-  Try<set<Gpu>> gpus = enumerateGpus(flags, resources);
+  Try<map<Gpu, nvmlDevice_t>> gpus = enumerateGpus(flags, resources);
   if (gpus.isError()) {
     return Error(gpus.error());
   }
 
-  return NvidiaGpuAllocator(gpus.get());
+  set<Gpu> total;
+  foreachkey (const Gpu& gpu, gpus.get()) {
+    total.insert(gpu);
+  }
+
+  return NvidiaGpuAllocator(total, enumerateGpuDistances(gpus.get()));
 }
 
 
@@ -339,8 +449,9 @@ Try<Resources> NvidiaGpuAllocator::resources(const Flags& flags)
 
 
 NvidiaGpuAllocator::NvidiaGpuAllocator(
-    const set<Gpu>& gpus)
-  : data(std::make_shared<NvidiaGpuAllocator::Data>(gpus)) {}
+    const set<Gpu>& gpus,
+    const map<pair<Gpu, Gpu>, unsigned int>& distances)
+  : data(std::make_shared<NvidiaGpuAllocator::Data>(gpus, distances)) {}
 
 
 const set<Gpu>& NvidiaGpuAllocator::total() const { return data->gpus; }
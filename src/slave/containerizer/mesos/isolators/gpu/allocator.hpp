@@ -18,8 +18,10 @@
 #define __NVIDIA_GPU_ALLOCATOR_HPP__
 
 #include <iosfwd>
+#include <map>
 #include <memory>
 #include <set>
+#include <utility>
 
 #include <mesos/resources.hpp>
 
@@ -62,12 +64,18 @@ public:
 
   const std::set<Gpu>& total() const;
 
+  // Allocates `count` GPUs which are as close to each other as
+  // possible in the system topology (e.g., behind the same PCIe
+  // switch rather than attached to different CPUs), to minimize the
+  // cost of the communication between them.
   process::Future<std::set<Gpu>> allocate(size_t count);
   process::Future<Nothing> allocate(const std::set<Gpu>& gpus);
   process::Future<Nothing> deallocate(const std::set<Gpu>& gpus);
 
 private:
-  NvidiaGpuAllocator(const std::set<Gpu>& gpus);
+  NvidiaGpuAllocator(
+      const std::set<Gpu>& gpus,
+      const std::map<std::pair<Gpu, Gpu>, unsigned int>& distances);
 
   // Forward declaration.
   struct Data;
@@ -55,17 +55,25 @@ struct NvidiaManagementLibrary
       nvmlReturn_t (*_deviceGetCount)(unsigned int*),
       nvmlReturn_t (*_deviceGetHandleByIndex)(unsigned int, nvmlDevice_t*),
       nvmlReturn_t (*_deviceGetMinorNumber)(nvmlDevice_t, unsigned int*),
+      nvmlReturn_t (*_deviceGetTopologyCommonAncestor)(
+          nvmlDevice_t, nvmlDevice_t, nvmlGpuTopologyLevel_t*),
       const char* (*_errorString)(nvmlReturn_t))
     : systemGetDriverVersion(_systemGetDriverVersion),
       deviceGetCount(_deviceGetCount),
       deviceGetHandleByIndex(_deviceGetHandleByIndex),
       deviceGetMinorNumber(_deviceGetMinorNumber),
+      deviceGetTopologyCommonAncestor(_deviceGetTopologyCommonAncestor),
       errorString(_errorString) {}
 
   nvmlReturn_t (*systemGetDriverVersion)(char *, unsigned int);
   nvmlReturn_t (*deviceGetCount)(unsigned int*);
   nvmlReturn_t (*deviceGetHandleByIndex)(unsigned int, nvmlDevice_t*);
   nvmlReturn_t (*deviceGetMinorNumber)(nvmlDevice_t, unsigned int*);
+
+  // NOTE: This is null if the driver does not provide the symbol.
+  nvmlReturn_t (*deviceGetTopologyCommonAncestor)(
+      nvmlDevice_t, nvmlDevice_t, nvmlGpuTopologyLevel_t*);
+
   const char* (*errorString)(nvmlReturn_t);
 };
 
@@ -120,6 +128,11 @@ Try<Nothing> initialize()
     symbols.at(name) = symbol.get();
   }
 
+  // The topology of the GPUs is only used for placement, so we do
+  // not require drivers to provide it.
+  Try<void*> nvmlDeviceGetTopologyCommonAncestor =
+    library->loadSymbol("nvmlDeviceGetTopologyCommonAncestor");
+
   auto nvmlInit =
     (nvmlReturn_t (*)()) symbols.at("nvmlInit_v2");
 
@@ -142,6 +155,11 @@ Try<Nothing> initialize()
           symbols.at("nvmlDeviceGetHandleByIndex"),
       (nvmlReturn_t (*)(nvmlDevice_t, unsigned int*))
           symbols.at("nvmlDeviceGetMinorNumber"),
+      nvmlDeviceGetTopologyCommonAncestor.isSome()
+        ? (nvmlReturn_t (*)(
+              nvmlDevice_t, nvmlDevice_t, nvmlGpuTopologyLevel_t*))
+            nvmlDeviceGetTopologyCommonAncestor.get()
+        : nullptr,
       (const char* (*)(nvmlReturn_t))
           symbols.at("nvmlErrorString"));
 
@@ -247,4 +265,26 @@ Try<unsigned int> deviceGetMinorNumber(nvmlDevice_t handle)
   return minor;
 }
 
+
+Try<nvmlGpuTopologyLevel_t> deviceGetTopologyCommonAncestor(
+    nvmlDevice_t handle1,
+    nvmlDevice_t handle2)
+{
+  if (nvml == nullptr) {
+    return Error("NVML has not been initialized");
+  }
+
+  if (nvml->deviceGetTopologyCommonAncestor == nullptr) {
+    return Error("Not supported by the NVML library");
+  }
+
+  nvmlGpuTopologyLevel_t level;
+  nvmlReturn_t result =
+    nvml->deviceGetTopologyCommonAncestor(handle1, handle2, &level);
+  if (result != NVML_SUCCESS) {
+    return Error(nvml->errorString(result));
+  }
+  return level;
+}
+
 } // namespace nvml {
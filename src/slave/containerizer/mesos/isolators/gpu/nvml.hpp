@@ -52,6 +52,13 @@ Try<unsigned int> deviceGetCount();
 Try<nvmlDevice_t> deviceGetHandleByIndex(unsigned int index);
 Try<unsigned int> deviceGetMinorNumber(nvmlDevice_t handle);
 
+// Returns the closest common ancestor of two GPUs in the system
+// topology, e.g., `NVML_TOPOLOGY_CPU` if they are attached to the
+// same CPU. This is not supported by all drivers.
+Try<nvmlGpuTopologyLevel_t> deviceGetTopologyCommonAncestor(
+    nvmlDevice_t handle1,
+    nvmlDevice_t handle2);
+
 } // namespace nvml {
 
 #endif // __NVIDIA_NVML_HPP__
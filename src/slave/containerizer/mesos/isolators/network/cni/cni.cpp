@@ -1255,22 +1255,7 @@ Future<Nothing> NetworkCniIsolatorProcess::attach(
           << "' to attach container " << containerId << " to network '"
           << networkName << "'";
 
-  Try<Subprocess> s = subprocess(
-      plugin.get(),
-      {plugin.get()},
-      Subprocess::PATH(networkConfigPath),
-      Subprocess::PIPE(),
-      Subprocess::PIPE(),
-      nullptr,
-      environment);
-
-  if (s.isError()) {
-    return Failure(
-        "Failed to execute the CNI plugin '" +
-        plugin.get() + "': " + s.error());
-  }
-
-  return await(s->status(), io::read(s->out().get()), io::read(s->err().get()))
+  return invokePlugin(plugin.get(), networkConfigPath, environment)
     .then(defer(
         PID<NetworkCniIsolatorProcess>(this),
         &NetworkCniIsolatorProcess::_attach,
@@ -1608,25 +1593,7 @@ Future<Nothing> NetworkCniIsolatorProcess::detach(
           << "' to detach container " << containerId << " from network '"
           << networkName << "'";
 
-  Try<Subprocess> s = subprocess(
-      plugin.get(),
-      {plugin.get()},
-      Subprocess::PATH(networkConfigPath),
-      Subprocess::PIPE(),
-      Subprocess::PIPE(),
-      nullptr,
-      environment);
-
-  if (s.isError()) {
-    return Failure(
-        "Failed to execute the CNI plugin '" + plugin.get() +
-        "': " + s.error());
-  }
-
-  return await(
-      s->status(),
-      io::read(s->out().get()),
-      io::read(s->err().get()))
+  return invokePlugin(plugin.get(), networkConfigPath, environment)
     .then(defer(
         PID<NetworkCniIsolatorProcess>(this),
         &NetworkCniIsolatorProcess::_detach,
@@ -1699,6 +1666,67 @@ Future<Nothing> NetworkCniIsolatorProcess::_detach(
 }
 
 
+Future<tuple<Future<Option<int>>, Future<string>, Future<string>>>
+NetworkCniIsolatorProcess::invokePlugin(
+    const string& plugin,
+    const string& networkConfigPath,
+    const map<string, string>& environment)
+{
+  if (flags.network_cni_max_concurrent_plugins.isSome() &&
+      runningPlugins >= flags.network_cni_max_concurrent_plugins.get()) {
+    Owned<Invocation> invocation(new Invocation());
+    invocation->plugin = plugin;
+    invocation->networkConfigPath = networkConfigPath;
+    invocation->environment = environment;
+
+    queuedInvocations.push_back(invocation);
+
+    return invocation->promise.future();
+  }
+
+  Try<Subprocess> s = subprocess(
+      plugin,
+      {plugin},
+      Subprocess::PATH(networkConfigPath),
+      Subprocess::PIPE(),
+      Subprocess::PIPE(),
+      nullptr,
+      environment);
+
+  if (s.isError()) {
+    return Failure(
+        "Failed to execute the CNI plugin '" + plugin + "': " + s.error());
+  }
+
+  runningPlugins++;
+
+  return await(s->status(), io::read(s->out().get()), io::read(s->err().get()))
+    .onAny(defer(
+        PID<NetworkCniIsolatorProcess>(this),
+        &NetworkCniIsolatorProcess::_invokePlugin));
+}
+
+
+void NetworkCniIsolatorProcess::_invokePlugin()
+{
+  CHECK_GT(runningPlugins, 0u);
+  runningPlugins--;
+
+  // NOTE: We loop since a plugin which fails to execute does not take
+  // up the slot freed by the terminated plugin.
+  while (!queuedInvocations.empty() &&
+         runningPlugins < flags.network_cni_max_concurrent_plugins.get()) {
+    Owned<Invocation> invocation = queuedInvocations.front();
+    queuedInvocations.pop_front();
+
+    invocation->promise.associate(invokePlugin(
+        invocation->plugin,
+        invocation->networkConfigPath,
+        invocation->environment));
+  }
+}
+
+
 Try<JSON::Object> NetworkCniIsolatorProcess::getNetworkConfigJSON(
     const string& network,
     const string& path)
@@ -1740,10 +1768,27 @@ Try<JSON::Object> NetworkCniIsolatorProcess::getNetworkConfigJSON(
     const string& network)
 {
   if (networkConfigs.contains(network)) {
+    const string& path = networkConfigs[network];
+
+    // Reuse the parsed configuration unless its file has changed.
+    Try<long> mtime = os::stat::mtime(path);
+    Try<Bytes> size = os::stat::size(path);
+
+    if (mtime.isSome() && size.isSome() &&
+        parsedNetworkConfigs.contains(network)) {
+      const NetworkConfig& parsed = parsedNetworkConfigs.at(network);
+
+      if (parsed.path == path &&
+          parsed.mtime == mtime.get() &&
+          parsed.size == size.get()) {
+        return parsed.json;
+      }
+    }
+
+    parsedNetworkConfigs.erase(network);
+
     // Make sure the JSON is valid.
-    Try<JSON::Object> config = getNetworkConfigJSON(
-        network,
-        networkConfigs[network]);
+    Try<JSON::Object> config = getNetworkConfigJSON(network, path);
 
     if (config.isError()) {
       LOG(WARNING) << "Removing the network '" << network
@@ -1754,6 +1799,11 @@ Try<JSON::Object> NetworkCniIsolatorProcess::getNetworkConfigJSON(
 
       // Fall-through and do a reload.
     } else {
+      if (mtime.isSome() && size.isSome()) {
+        parsedNetworkConfigs[network] =
+          NetworkConfig{path, mtime.get(), size.get(), config.get()};
+      }
+
       return config;
     }
   }
@@ -17,9 +17,18 @@
 #ifndef __NETWORK_CNI_ISOLATOR_HPP__
 #define __NETWORK_CNI_ISOLATOR_HPP__
 
+#include <deque>
+#include <map>
+#include <string>
+#include <tuple>
+
+#include <process/future.hpp>
 #include <process/id.hpp>
+#include <process/owned.hpp>
 #include <process/subprocess.hpp>
 
+#include <stout/bytes.hpp>
+#include <stout/json.hpp>
 #include <stout/subcommand.hpp>
 
 #include "slave/flags.hpp"
@@ -112,6 +121,30 @@ private:
     const Option<std::string> hostname;
   };
 
+  // A CNI plugin invocation waiting for one of the running plugins to
+  // terminate, see `--network_cni_max_concurrent_plugins`.
+  struct Invocation
+  {
+    std::string plugin;
+    std::string networkConfigPath;
+    std::map<std::string, std::string> environment;
+
+    process::Promise<std::tuple<
+        process::Future<Option<int>>,
+        process::Future<std::string>,
+        process::Future<std::string>>> promise;
+  };
+
+  // A parsed CNI network configuration, along with the modification
+  // time and size of its file when it was read.
+  struct NetworkConfig
+  {
+    std::string path;
+    long mtime;
+    Bytes size;
+    JSON::Object json;
+  };
+
   // Reads each CNI config present in `configDir`, validates if the
   // `plugin` is present in the search path associated with
   // `pluginDir` and adds the CNI network config to `networkConfigs`
@@ -180,6 +213,20 @@ private:
       const ContainerID& containerId,
       const std::list<process::Future<Nothing>>& detaches);
 
+  // Invokes the CNI plugin with the network configuration file as its
+  // input once fewer than `--network_cni_max_concurrent_plugins`
+  // plugins are running. Returns the exit status and the output of
+  // the plugin.
+  process::Future<std::tuple<
+      process::Future<Option<int>>,
+      process::Future<std::string>,
+      process::Future<std::string>>> invokePlugin(
+          const std::string& plugin,
+          const std::string& networkConfigPath,
+          const std::map<std::string, std::string>& environment);
+
+  void _invokePlugin();
+
   // Searches the `networkConfigs` hashmap for a CNI network. If the
   // hashmap doesn't contain the network, will try to load all the CNI
   // configs from `flags.network_cni_config_dir`, and will then
@@ -215,6 +262,15 @@ private:
 
   // Information of CNI networks that each container joins.
   hashmap<ContainerID, process::Owned<Info>> infos;
+
+  // The parsed CNI network configurations keyed by the network name,
+  // which are reused until their files change.
+  hashmap<std::string, NetworkConfig> parsedNetworkConfigs;
+
+  // The number of CNI plugins running, and the invocations waiting
+  // because of `--network_cni_max_concurrent_plugins`.
+  size_t runningPlugins = 0;
+  std::deque<process::Owned<Invocation>> queuedInvocations;
 };
 
 
@@ -2205,6 +2205,51 @@ Future<Nothing> PortMappingIsolatorProcess::recover(
     }
   }
 
+  // Get the flow IDs once rather than for every container, since
+  // dumping the filters on host eth0 takes time linear in the number
+  // of containers.
+  hashmap<PortRange, uint16_t> flowIds;
+
+  if (flags.egress_unique_flow_per_container) {
+    // Get all egress IP flow classifiers on eth0.
+    Result<vector<filter::Filter<ip::Classifier>>> eth0EgressFilters =
+      ip::filters(eth0, hostTxFqCodelHandle);
+
+    if (eth0EgressFilters.isError()) {
+      return Failure(
+          "Failed to get all the IP flow classifiers on " + eth0 +
+          ": " + eth0EgressFilters.error());
+    } else if (eth0EgressFilters.isNone()) {
+      return Failure(
+          "Failed to get all the IP flow classifiers on " + eth0 +
+          ": link does not exist");
+    }
+
+    // Construct a port range to flow ID mapping from host eth0
+    // egress. This map will be used later.
+    foreach (const filter::Filter<ip::Classifier>& filter,
+             eth0EgressFilters.get()) {
+      const Option<PortRange> sourcePorts = filter.classifier.sourcePorts;
+      const Option<Handle> classid = filter.classid;
+
+      if (sourcePorts.isNone()) {
+        return Failure("Missing source ports for filters on egress of " + eth0);
+      }
+
+      if (classid.isNone()) {
+        return Failure("Missing classid for filters on egress of " + eth0);
+      }
+
+      if (flowIds.contains(sourcePorts.get())) {
+        return Failure(
+          "Duplicated port range " + stringify(sourcePorts.get()) +
+          " detected on egress of " + eth0);
+      }
+
+      flowIds[sourcePorts.get()] = classid.get().secondary();
+    }
+  }
+
   // Now, actually recover the isolator from slave's state.
   foreach (const ContainerState& state, states) {
     const ContainerID& containerId = state.container_id();
@@ -2236,7 +2281,7 @@ Future<Nothing> PortMappingIsolatorProcess::recover(
       continue;
     }
 
-    Try<Info*> recover = _recover(pid);
+    Try<Info*> recover = _recover(pid, flowIds);
     if (recover.isError()) {
       foreachvalue (Info* info, infos) {
         delete info;
@@ -2260,7 +2305,7 @@ Future<Nothing> PortMappingIsolatorProcess::recover(
   vector<Info*> unknownOrphans;
 
   foreach (pid_t pid, pids) {
-    Try<Info*> recover = _recover(pid);
+    Try<Info*> recover = _recover(pid, flowIds);
     if (recover.isError()) {
       foreachvalue (Info* info, infos) {
         delete info;
@@ -2330,7 +2375,9 @@ Future<Nothing> PortMappingIsolatorProcess::recover(
 
 
 Try<PortMappingIsolatorProcess::Info*>
-PortMappingIsolatorProcess::_recover(pid_t pid)
+PortMappingIsolatorProcess::_recover(
+    pid_t pid,
+    const hashmap<PortRange, uint16_t>& flowIds)
 {
   // Get all the IP filters on veth.
   // NOTE: We only look at veth devices to recover port ranges
@@ -2351,48 +2398,6 @@ PortMappingIsolatorProcess::_recover(pid_t pid)
         ": link does not exist");
   }
 
-  hashmap<PortRange, uint16_t> flowIds;
-
-  if (flags.egress_unique_flow_per_container) {
-    // Get all egress IP flow classifiers on eth0.
-    Result<vector<filter::Filter<ip::Classifier>>> eth0EgressFilters =
-      ip::filters(eth0, hostTxFqCodelHandle);
-
-    if (eth0EgressFilters.isError()) {
-      return Error(
-          "Failed to get all the IP flow classifiers on " + eth0 +
-          ": " + eth0EgressFilters.error());
-    } else if (eth0EgressFilters.isNone()) {
-      return Error(
-          "Failed to get all the IP flow classifiers on " + eth0 +
-          ": link does not exist");
-    }
-
-    // Construct a port range to flow ID mapping from host eth0
-    // egress. This map will be used later.
-    foreach (const filter::Filter<ip::Classifier>& filter,
-             eth0EgressFilters.get()) {
-      const Option<PortRange> sourcePorts = filter.classifier.sourcePorts;
-      const Option<Handle> classid = filter.classid;
-
-      if (sourcePorts.isNone()) {
-        return Error("Missing source ports for filters on egress of " + eth0);
-      }
-
-      if (classid.isNone()) {
-        return Error("Missing classid for filters on egress of " + eth0);
-      }
-
-      if (flowIds.contains(sourcePorts.get())) {
-        return Error(
-          "Duplicated port range " + stringify(sourcePorts.get()) +
-          " detected on egress of " + eth0);
-      }
-
-      flowIds[sourcePorts.get()] = classid.get().secondary();
-    }
-  }
-
   IntervalSet<uint16_t> nonEphemeralPorts;
   IntervalSet<uint16_t> ephemeralPorts;
   Option<uint16_t> flowId;
@@ -2667,8 +2672,10 @@ Future<Nothing> PortMappingIsolatorProcess::isolate(
 
   // For each port range, add a set of IP packet filters to properly
   // redirect IP traffic to/from containers.
-  foreach (const PortRange& range,
-           getPortRanges(info->nonEphemeralPorts + info->ephemeralPorts)) {
+  const vector<PortRange> ranges =
+    getPortRanges(info->nonEphemeralPorts + info->ephemeralPorts);
+
+  foreach (const PortRange& range, ranges) {
     if (info->flowId.isSome()) {
       LOG(INFO) << "Adding IP packet filters with ports " << range
                 << " with flow ID " << info->flowId.get()
@@ -2677,14 +2684,14 @@ Future<Nothing> PortMappingIsolatorProcess::isolate(
       LOG(INFO) << "Adding IP packet filters with ports " << range
                 << " for container " << containerId;
     }
+  }
 
-    Try<Nothing> add = addHostIPFilters(range, info->flowId, veth(pid));
-    if (add.isError()) {
-      return Failure(
-          "Failed to add IP packet filter with ports " +
-          stringify(range) + " for container with pid " +
-          stringify(pid) + ": " + add.error());
-    }
+  Try<Nothing> add = addHostIPFilters(ranges, info->flowId, veth(pid));
+  if (add.isError()) {
+    return Failure(
+        "Failed to add IP packet filters with ports " +
+        stringify(ranges) + " for container with pid " +
+        stringify(pid) + ": " + add.error());
   }
 
   // Relay ICMP packets from veth of the container to host eth0.
@@ -3061,29 +3068,31 @@ Future<Nothing> PortMappingIsolatorProcess::update(
       LOG(INFO) << "Adding IP packet filters with ports " << range
                 << " for container " << containerId;
     }
+  }
 
-    // All IP packets from a container will be assigned a single flow
-    // on host eth0.
-    Try<Nothing> add = addHostIPFilters(range, info->flowId, veth(pid));
-    if (add.isError()) {
-      return Failure(
-          "Failed to add IP packet filter with ports " +
-          stringify(range) + " for container with pid " +
-          stringify(pid) + ": " + add.error());
-    }
+  // All IP packets from a container will be assigned a single flow
+  // on host eth0.
+  Try<Nothing> add = addHostIPFilters(portsToAdd, info->flowId, veth(pid));
+  if (add.isError()) {
+    return Failure(
+        "Failed to add IP packet filters with ports " +
+        stringify(portsToAdd) + " for container with pid " +
+        stringify(pid) + ": " + add.error());
   }
 
   foreach (const PortRange& range, portsToRemove) {
     LOG(INFO) << "Removing IP packet filters with ports " << range
               << " for container with pid " << pid;
+  }
 
-    Try<Nothing> removing = removeHostIPFilters(range, veth(pid));
-    if (removing.isError()) {
-      return Failure(
-          "Failed to remove IP packet filter with ports " +
-          stringify(range) + " for container with pid " +
-          stringify(pid) + ": " + removing.error());
-    }
+  const vector<PortRange> ranges(portsToRemove.begin(), portsToRemove.end());
+
+  Try<Nothing> removing = removeHostIPFilters(ranges, veth(pid));
+  if (removing.isError()) {
+    return Failure(
+        "Failed to remove IP packet filters with ports " +
+        stringify(ranges) + " for container with pid " +
+        stringify(pid) + ": " + removing.error());
   }
 
   // Update the non-ephemeral ports of this container.
@@ -3210,9 +3219,34 @@ Future<ResourceStatistics> PortMappingIsolatorProcess::usage(
     result.set_net_tx_dropped(tx_dropped.get());
   }
 
+  // The statistics from inside the container are collected by the
+  // network helper, whose results are reused for up to
+  // '--network_statistics_cache_interval' and shared by concurrent
+  // calls so that we don't fork a process per container and call.
+  if (info->statistics.isNone() ||
+      info->statistics->isFailed() ||
+      info->statistics->isDiscarded() ||
+      (info->statistics->isReady() &&
+       Clock::now() - info->statisticsTime >=
+         flags.network_statistics_cache_interval)) {
+    info->statistics = statistics(info->pid.get());
+    info->statisticsTime = Clock::now();
+  }
+
+  return undiscardable(info->statistics.get())
+    .then([result](const ResourceStatistics& statistics) {
+      ResourceStatistics usage = result;
+      usage.MergeFrom(statistics);
+      return usage;
+    });
+}
+
+
+Future<ResourceStatistics> PortMappingIsolatorProcess::statistics(pid_t pid)
+{
   // Retrieve the socket information from inside the container.
   PortMappingStatistics statistics;
-  statistics.flags.pid = info->pid.get();
+  statistics.flags.pid = pid;
   statistics.flags.eth0_name = eth0;
   statistics.flags.enable_socket_statistics_summary =
     flags.network_enable_socket_statistics_summary;
@@ -3247,7 +3281,7 @@ Future<ResourceStatistics> PortMappingIsolatorProcess::usage(
     .then(defer(
         PID<PortMappingIsolatorProcess>(this),
         &PortMappingIsolatorProcess::_usage,
-        result,
+        ResourceStatistics(),
         s.get()));
 }
 
@@ -3375,20 +3409,22 @@ Try<Nothing> PortMappingIsolatorProcess::_cleanup(
 
   // Remove the IP filters on eth0 and lo for non-ephemeral port
   // ranges and the ephemeral port range.
-  foreach (const PortRange& range,
-           getPortRanges(info->nonEphemeralPorts + info->ephemeralPorts)) {
+  const vector<PortRange> ranges =
+    getPortRanges(info->nonEphemeralPorts + info->ephemeralPorts);
+
+  foreach (const PortRange& range, ranges) {
     LOG(INFO) << "Removing IP packet filters with ports " << range
               << " for container with pid " << pid;
+  }
 
-    // No need to remove filters on veth as they will be automatically
-    // removed by the kernel when we remove the link below.
-    Try<Nothing> removing = removeHostIPFilters(range, veth(pid), false);
-    if (removing.isError()) {
-      errors.push_back(
-          "Failed to remove IP packet filter with ports " +
-          stringify(range) + " for container with pid " +
-          stringify(pid) + ": " + removing.error());
-    }
+  // No need to remove filters on veth as they will be automatically
+  // removed by the kernel when we remove the link below.
+  Try<Nothing> removing = removeHostIPFilters(ranges, veth(pid), false);
+  if (removing.isError()) {
+    errors.push_back(
+        "Failed to remove IP packet filters with ports " +
+        stringify(ranges) + " for container with pid " +
+        stringify(pid) + ": " + removing.error());
   }
 
   // Free the ephemeral ports used by this container.
@@ -3614,184 +3650,191 @@ Try<Nothing> PortMappingIsolatorProcess::_cleanup(
 }
 
 
-// Helper function to set up IP filters on the host side for a given
-// port range.
+// Helper function to set up IP filters on the host side for the given
+// port ranges. The filters on each link are created in a batch (see
+// `filter::ip::create()`) rather than one netlink round trip at a
+// time, which matters for containers with many port ranges.
 Try<Nothing> PortMappingIsolatorProcess::addHostIPFilters(
-    const PortRange& range,
+    const vector<PortRange>& ranges,
     const Option<uint16_t>& flowId,
     const string& veth)
 {
   // NOTE: The order in which these filters are added is important!
-  // For each port range, we need to make sure that we don't try to
-  // add filters on host eth0 and host lo until we have successfully
-  // added filters on veth. This is because the slave could crash
-  // while we are adding filters, we want to make sure we don't leak
-  // any filters on host eth0 and host lo.
-
-  // Add an IP packet filter from veth of the container to host eth0
-  // to properly redirect IP packets sent from one container to
-  // external hosts. This filter has a lower priority compared to the
-  // 'vethToHostLo' filter because it does not check the destination
-  // IP. Notice that here we also check the source port of a packet.
-  // If the source port is not within the port ranges allocated for
-  // the container, the packet will get dropped.
-  Try<bool> vethToHostEth0 = filter::ip::create(
-      veth,
-      ingress::HANDLE,
-      ip::Classifier(None(), None(), range, None()),
-      Priority(IP_FILTER_PRIORITY, LOW),
-      action::Redirect(eth0));
+  // We need to make sure that we don't try to add filters on host
+  // eth0 and host lo until we have successfully added filters on
+  // veth. This is because the slave could crash while we are adding
+  // filters, we want to make sure we don't leak any filters on host
+  // eth0 and host lo.
 
-  if (vethToHostEth0.isError()) {
-    ++metrics.adding_veth_ip_filters_errors;
+  vector<filter::Filter<ip::Classifier>> vethFilters;
+  vector<filter::Filter<ip::Classifier>> hostEth0Filters;
+  vector<filter::Filter<ip::Classifier>> hostLoFilters;
+  vector<filter::Filter<ip::Classifier>> hostEth0EgressFilters;
 
-    return Error(
-        "Failed to create an IP packet filter from " + veth +
-        " to host " + eth0 + ": " + vethToHostEth0.error());
-  } else if (!vethToHostEth0.get()) {
-    ++metrics.adding_veth_ip_filters_already_exist;
+  foreach (const PortRange& range, ranges) {
+    // Add an IP packet filter from veth of the container to host eth0
+    // to properly redirect IP packets sent from one container to
+    // external hosts. This filter has a lower priority compared to
+    // the 'vethToHostLo' filter because it does not check the
+    // destination IP. Notice that here we also check the source port
+    // of a packet. If the source port is not within the port ranges
+    // allocated for the container, the packet will get dropped.
+    vethFilters.push_back(filter::Filter<ip::Classifier>(
+        ingress::HANDLE,
+        ip::Classifier(None(), None(), range, None()),
+        Priority(IP_FILTER_PRIORITY, LOW),
+        None(),
+        None(),
+        action::Redirect(eth0)));
+
+    // Add two IP packet filters (one for public IP and one for
+    // loopback IP) from veth of the container to host lo to properly
+    // redirect IP packets sent from one container to either the host
+    // or another container. Notice that here we also check the source
+    // port of a packet. If the source port is not within the port
+    // ranges allocated for the container, the packet will get dropped.
+    vethFilters.push_back(filter::Filter<ip::Classifier>(
+        ingress::HANDLE,
+        ip::Classifier(None(), hostIPNetwork.address(), range, None()),
+        Priority(IP_FILTER_PRIORITY, NORMAL),
+        None(),
+        None(),
+        action::Redirect(lo)));
 
-    return Error(
-        "The IP packet filter from " + veth +
-        " to host " + eth0 + " already exists");
+    vethFilters.push_back(filter::Filter<ip::Classifier>(
+        ingress::HANDLE,
+        ip::Classifier(
+            None(),
+            net::IP::Network::LOOPBACK_V4().address(),
+            range,
+            None()),
+        Priority(IP_FILTER_PRIORITY, NORMAL),
+        None(),
+        None(),
+        action::Redirect(lo)));
+
+    // Add an IP packet filter from host eth0 to veth of the container
+    // such that any incoming IP packet will be properly redirected to
+    // the corresponding container based on its destination port.
+    hostEth0Filters.push_back(filter::Filter<ip::Classifier>(
+        ingress::HANDLE,
+        ip::Classifier(hostMAC, hostIPNetwork.address(), None(), range),
+        Priority(IP_FILTER_PRIORITY, NORMAL),
+        None(),
+        None(),
+        action::Redirect(veth)));
+
+    // Add an IP packet filter from host lo to veth of the container
+    // such that any internally generated IP packet will be properly
+    // redirected to the corresponding container based on its
+    // destination port.
+    hostLoFilters.push_back(filter::Filter<ip::Classifier>(
+        ingress::HANDLE,
+        ip::Classifier(None(), None(), None(), range),
+        Priority(IP_FILTER_PRIORITY, NORMAL),
+        None(),
+        None(),
+        action::Redirect(veth)));
+
+    if (flowId.isSome()) {
+      // Add IP packet filters to classify traffic sending to eth0
+      // in the same way so that traffic of each container will be
+      // classified to different flows defined by fq_codel.
+      hostEth0EgressFilters.push_back(filter::Filter<ip::Classifier>(
+          hostTxFqCodelHandle,
+          ip::Classifier(None(), None(), range, None()),
+          Priority(IP_FILTER_PRIORITY, LOW),
+          None(),
+          Handle(hostTxFqCodelHandle, flowId.get()),
+          action::Terminal()));
+    }
   }
 
-  // Add two IP packet filters (one for public IP and one for loopback
-  // IP) from veth of the container to host lo to properly redirect IP
-  // packets sent from one container to either the host or another
-  // container. Notice that here we also check the source port of a
-  // packet. If the source port is not within the port ranges
-  // allocated for the container, the packet will get dropped.
-  Try<bool> vethToHostLoPublic = filter::ip::create(
-      veth,
-      ingress::HANDLE,
-      ip::Classifier(None(), hostIPNetwork.address(), range, None()),
-      Priority(IP_FILTER_PRIORITY, NORMAL),
-      action::Redirect(lo));
+  // Creates the filters on the link, failing if any of them can't be
+  // created or already exists.
+  auto create = [](
+      const string& link,
+      const vector<filter::Filter<ip::Classifier>>& filters,
+      const string& description,
+      process::metrics::Counter& errors,
+      process::metrics::Counter& alreadyExist) -> Try<Nothing> {
+    if (filters.empty()) {
+      return Nothing();
+    }
 
-  if (vethToHostLoPublic.isError()) {
-    ++metrics.adding_veth_ip_filters_errors;
+    Try<vector<bool>> created = filter::ip::create(link, filters);
+    if (created.isError()) {
+      ++errors;
 
-    return Error(
-        "Failed to create an IP packet filter (for public IP) from " +
-        veth + " to host " + lo + ": " + vethToHostLoPublic.error());
-  } else if (!vethToHostLoPublic.get()) {
-    ++metrics.adding_veth_ip_filters_already_exist;
+      return Error(
+          "Failed to create the " + description + ": " + created.error());
+    }
 
-    return Error(
-        "The IP packet filter (for public IP) from " +
-        veth + " to host " + lo + " already exists");
-  }
+    foreach (bool created_, created.get()) {
+      if (!created_) {
+        ++alreadyExist;
 
-  Try<bool> vethToHostLoLoopback = filter::ip::create(
-      veth,
-      ingress::HANDLE,
-      ip::Classifier(
-          None(),
-          net::IP::Network::LOOPBACK_V4().address(),
-          range,
-          None()),
-      Priority(IP_FILTER_PRIORITY, NORMAL),
-      action::Redirect(lo));
+        return Error("One of the " + description + " already exists");
+      }
+    }
 
-  if (vethToHostLoLoopback.isError()) {
-    ++metrics.adding_veth_ip_filters_errors;
+    return Nothing();
+  };
 
-    return Error(
-        "Failed to create an IP packet filter (for loopback IP) from " +
-        veth + " to host " + lo + ": " + vethToHostLoLoopback.error());
-  } else if (!vethToHostLoLoopback.get()) {
-    ++metrics.adding_veth_ip_filters_already_exist;
+  Try<Nothing> vethToHost = create(
+      veth,
+      vethFilters,
+      "IP packet filters from " + veth + " to host " + eth0 + " and " + lo,
+      metrics.adding_veth_ip_filters_errors,
+      metrics.adding_veth_ip_filters_already_exist);
 
-    return Error(
-        "The IP packet filter (for loopback IP) from " +
-        veth + " to host " + lo + " already exists");
+  if (vethToHost.isError()) {
+    return Error(vethToHost.error());
   }
 
-  // Add an IP packet filter from host eth0 to veth of the container
-  // such that any incoming IP packet will be properly redirected to
-  // the corresponding container based on its destination port.
-  Try<bool> hostEth0ToVeth = filter::ip::create(
+  Try<Nothing> hostEth0ToVeth = create(
       eth0,
-      ingress::HANDLE,
-      ip::Classifier(hostMAC, hostIPNetwork.address(), None(), range),
-      Priority(IP_FILTER_PRIORITY, NORMAL),
-      action::Redirect(veth));
+      hostEth0Filters,
+      "IP packet filters from host " + eth0 + " to " + veth,
+      metrics.adding_eth0_ip_filters_errors,
+      metrics.adding_eth0_ip_filters_already_exist);
 
   if (hostEth0ToVeth.isError()) {
-    ++metrics.adding_eth0_ip_filters_errors;
-
-    return Error(
-        "Failed to create an IP packet filter from host " +
-        eth0 + " to " + veth + ": " + hostEth0ToVeth.error());
-  } else if (!hostEth0ToVeth.get()) {
-    ++metrics.adding_eth0_ip_filters_already_exist;
-
-    return Error(
-        "The IP packet filter from host " + eth0 + " to " +
-        veth + " already exists");
+    return Error(hostEth0ToVeth.error());
   }
 
-  // Add an IP packet filter from host lo to veth of the container
-  // such that any internally generated IP packet will be properly
-  // redirected to the corresponding container based on its
-  // destination port.
-  Try<bool> hostLoToVeth = filter::ip::create(
+  Try<Nothing> hostLoToVeth = create(
       lo,
-      ingress::HANDLE,
-      ip::Classifier(None(), None(), None(), range),
-      Priority(IP_FILTER_PRIORITY, NORMAL),
-      action::Redirect(veth));
+      hostLoFilters,
+      "IP packet filters from host " + lo + " to " + veth,
+      metrics.adding_lo_ip_filters_errors,
+      metrics.adding_lo_ip_filters_already_exist);
 
   if (hostLoToVeth.isError()) {
-    ++metrics.adding_lo_ip_filters_errors;
-
-    return Error(
-        "Failed to create an IP packet filter from host " +
-        lo + " to " + veth + ": " + hostLoToVeth.error());
-  } else if (!hostLoToVeth.get()) {
-    ++metrics.adding_lo_ip_filters_already_exist;
-
-    return Error(
-        "The IP packet filter from host " + lo + " to " +
-        veth + " already exists");
+    return Error(hostLoToVeth.error());
   }
 
-  if (flowId.isSome()) {
-    // Add IP packet filters to classify traffic sending to eth0
-    // in the same way so that traffic of each container will be
-    // classified to different flows defined by fq_codel.
-    Try<bool> hostEth0Egress = filter::ip::create(
-        eth0,
-        hostTxFqCodelHandle,
-        ip::Classifier(None(), None(), range, None()),
-        Priority(IP_FILTER_PRIORITY, LOW),
-        Handle(hostTxFqCodelHandle, flowId.get()));
-
-    if (hostEth0Egress.isError()) {
-      ++metrics.adding_eth0_egress_filters_errors;
-
-      return Error(
-          "Failed to create a flow classifier for " + veth +
-          " on host " + eth0 + ": " + hostEth0Egress.error());
-    } else if (!hostEth0Egress.get()) {
-      ++metrics.adding_eth0_egress_filters_already_exist;
+  Try<Nothing> hostEth0Egress = create(
+      eth0,
+      hostEth0EgressFilters,
+      "flow classifiers for " + veth + " on host " + eth0,
+      metrics.adding_eth0_egress_filters_errors,
+      metrics.adding_eth0_egress_filters_already_exist);
 
-      return Error(
-          "The flow classifier for veth " + veth +
-          " on host " + eth0 + " already exists");
-    }
+  if (hostEth0Egress.isError()) {
+    return Error(hostEth0Egress.error());
   }
 
   return Nothing();
 }
 
 
-// Helper function to remove IP filters from the host side for a given
-// port range. The boolean flag 'removeFiltersOnVeth' indicates if we
-// need to remove filters on veth.
+// Helper function to remove IP filters from the host side for the
+// given port ranges. The boolean flag 'removeFiltersOnVeth' indicates
+// if we need to remove filters on veth. Like above, the filters on
+// each link are removed in a batch.
 Try<Nothing> PortMappingIsolatorProcess::removeHostIPFilters(
-    const PortRange& range,
+    const vector<PortRange>& ranges,
     const string& veth,
     bool removeFiltersOnVeth)
 {
@@ -3799,133 +3842,125 @@ Try<Nothing> PortMappingIsolatorProcess::removeHostIPFilters(
   // removed is important. We need to remove filters on host eth0 and
   // host lo first before we remove filters on veth.
 
-  // Remove the IP packet filter from host eth0 to veth of the container.
-  Try<bool> hostEth0ToVeth = filter::ip::remove(
-      eth0,
-      ingress::HANDLE,
-      ip::Classifier(hostMAC, hostIPNetwork.address(), None(), range));
+  vector<ip::Classifier> hostEth0Classifiers;
+  vector<ip::Classifier> hostLoClassifiers;
+  vector<ip::Classifier> hostEth0EgressClassifiers;
+  vector<ip::Classifier> vethClassifiers;
 
-  if (hostEth0ToVeth.isError()) {
-    ++metrics.removing_eth0_ip_filters_errors;
-
-    return Error(
-        "Failed to remove the IP packet filter from host " +
-        eth0 + " to " + veth + ": " + hostEth0ToVeth.error());
-  } else if (!hostEth0ToVeth.get()) {
-    ++metrics.removing_eth0_ip_filters_do_not_exist;
-
-    LOG(ERROR) << "The IP packet filter from host " << eth0
-               << " to " << veth << " does not exist";
-  }
-
-  // Remove the IP packet filter from host lo to veth of the container.
-  Try<bool> hostLoToVeth = filter::ip::remove(
-      lo,
-      ingress::HANDLE,
-      ip::Classifier(None(), None(), None(), range));
+  foreach (const PortRange& range, ranges) {
+    // The IP packet filter from host eth0 to veth of the container.
+    hostEth0Classifiers.push_back(
+        ip::Classifier(hostMAC, hostIPNetwork.address(), None(), range));
 
-  if (hostLoToVeth.isError()) {
-    ++metrics.removing_lo_ip_filters_errors;
+    // The IP packet filter from host lo to veth of the container.
+    hostLoClassifiers.push_back(
+        ip::Classifier(None(), None(), None(), range));
 
-    return Error(
-        "Failed to remove the IP packet filter from host " +
-        lo + " to " + veth + ": " + hostLoToVeth.error());
-  } else if (!hostLoToVeth.get()) {
-    ++metrics.removing_lo_ip_filters_do_not_exist;
+    // The egress flow classifier on host eth0.
+    if (flags.egress_unique_flow_per_container) {
+      hostEth0EgressClassifiers.push_back(
+          ip::Classifier(None(), None(), range, None()));
+    }
 
-    LOG(ERROR) << "The IP packet filter from host " << lo
-               << " to " << veth << " does not exist";
+    // The IP packet filters from veth of the container to host lo
+    // for the public IP and for the loopback IP, and to host eth0.
+    if (removeFiltersOnVeth) {
+      vethClassifiers.push_back(
+          ip::Classifier(None(), hostIPNetwork.address(), range, None()));
+
+      vethClassifiers.push_back(
+          ip::Classifier(
+              None(),
+              net::IP::Network::LOOPBACK_V4().address(),
+              range,
+              None()));
+
+      vethClassifiers.push_back(
+          ip::Classifier(None(), None(), range, None()));
+    }
   }
 
-  if (flags.egress_unique_flow_per_container) {
-    // Remove the egress flow classifier on host eth0.
-    Try<bool> hostEth0Egress = filter::ip::remove(
-        eth0,
-        hostTxFqCodelHandle,
-        ip::Classifier(None(), None(), range, None()));
+  // Removes the filters from the link, failing if any of them can't
+  // be removed. Filters which do not exist are only logged.
+  auto remove = [](
+      const string& link,
+      const Handle& parent,
+      const vector<ip::Classifier>& classifiers,
+      const string& description,
+      process::metrics::Counter& errors,
+      process::metrics::Counter& doNotExist) -> Try<Nothing> {
+    if (classifiers.empty()) {
+      return Nothing();
+    }
+
+    Try<vector<bool>> removed =
+      filter::ip::remove(link, parent, classifiers);
 
-    if (hostEth0Egress.isError()) {
-      ++metrics.removing_eth0_egress_filters_errors;
+    if (removed.isError()) {
+      ++errors;
 
       return Error(
-          "Failed to remove the flow classifier from host " +
-          eth0 + " for " + veth + ": " + hostEth0Egress.error());
-    } else if (!hostEth0Egress.get()) {
-      ++metrics.removing_eth0_egress_filters_do_not_exist;
+          "Failed to remove the " + description + ": " + removed.error());
+    }
+
+    foreach (bool removed_, removed.get()) {
+      if (!removed_) {
+        ++doNotExist;
 
-      LOG(ERROR) << "The flow classifier from host " << eth0
-                 << " for " << range << " does not exist";
+        LOG(ERROR) << "One of the " << description << " does not exist";
+      }
     }
-  }
 
-  // Now, we try to remove filters on veth. No need to proceed if the
-  // user does not ask us to do so.
-  if (!removeFiltersOnVeth) {
     return Nothing();
-  }
+  };
 
-  // Remove the IP packet filter from veth of the container to
-  // host lo for the public IP.
-  Try<bool> vethToHostLoPublic = filter::ip::remove(
-      veth,
+  Try<Nothing> hostEth0ToVeth = remove(
+      eth0,
       ingress::HANDLE,
-      ip::Classifier(None(), hostIPNetwork.address(), range, None()));
-
-  if (vethToHostLoPublic.isError()) {
-    ++metrics.removing_lo_ip_filters_errors;
+      hostEth0Classifiers,
+      "IP packet filters from host " + eth0 + " to " + veth,
+      metrics.removing_eth0_ip_filters_errors,
+      metrics.removing_eth0_ip_filters_do_not_exist);
 
-    return Error(
-        "Failed to remove the IP packet filter (for public IP) from " +
-        veth + " to host " + lo + ": " + vethToHostLoPublic.error());
-  } else if (!vethToHostLoPublic.get()) {
-    ++metrics.removing_lo_ip_filters_do_not_exist;
-
-    LOG(ERROR) << "The IP packet filter (for public IP) from "
-               << veth << " to host " << lo << " does not exist";
+  if (hostEth0ToVeth.isError()) {
+    return Error(hostEth0ToVeth.error());
   }
 
-  // Remove the IP packet filter from veth of the container to
-  // host lo for the loopback IP.
-  Try<bool> vethToHostLoLoopback = filter::ip::remove(
-      veth,
+  Try<Nothing> hostLoToVeth = remove(
+      lo,
       ingress::HANDLE,
-      ip::Classifier(
-          None(),
-          net::IP::Network::LOOPBACK_V4().address(),
-          range,
-          None()));
+      hostLoClassifiers,
+      "IP packet filters from host " + lo + " to " + veth,
+      metrics.removing_lo_ip_filters_errors,
+      metrics.removing_lo_ip_filters_do_not_exist);
 
-  if (vethToHostLoLoopback.isError()) {
-    ++metrics.removing_veth_ip_filters_errors;
+  if (hostLoToVeth.isError()) {
+    return Error(hostLoToVeth.error());
+  }
 
-    return Error(
-        "Failed to remove the IP packet filter (for loopback IP) from " +
-        veth + " to host " + lo + ": " + vethToHostLoLoopback.error());
-  } else if (!vethToHostLoLoopback.get()) {
-    ++metrics.removing_veth_ip_filters_do_not_exist;
+  Try<Nothing> hostEth0Egress = remove(
+      eth0,
+      hostTxFqCodelHandle,
+      hostEth0EgressClassifiers,
+      "flow classifiers from host " + eth0 + " for " + veth,
+      metrics.removing_eth0_egress_filters_errors,
+      metrics.removing_eth0_egress_filters_do_not_exist);
 
-    LOG(ERROR) << "The IP packet filter (for loopback IP) from "
-               << veth << " to host " << lo << " does not exist";
+  if (hostEth0Egress.isError()) {
+    return Error(hostEth0Egress.error());
   }
 
-  // Remove the IP packet filter from veth of the container to
-  // host eth0.
-  Try<bool> vethToHostEth0 = filter::ip::remove(
+  // Now, we try to remove filters on veth, if the user asks us to.
+  Try<Nothing> vethToHost = remove(
       veth,
       ingress::HANDLE,
-      ip::Classifier(None(), None(), range, None()));
-
-  if (vethToHostEth0.isError()) {
-    ++metrics.removing_veth_ip_filters_errors;
-
-    return Error(
-        "Failed to remove the IP packet filter from " + veth +
-        " to host " + eth0 + ": " + vethToHostEth0.error());
-  } else if (!vethToHostEth0.get()) {
-    ++metrics.removing_veth_ip_filters_do_not_exist;
+      vethClassifiers,
+      "IP packet filters from " + veth + " to host " + eth0 + " and " + lo,
+      metrics.removing_veth_ip_filters_errors,
+      metrics.removing_veth_ip_filters_do_not_exist);
 
-    LOG(ERROR) << "The IP packet filter from " << veth
-               << " to host " << eth0 << " does not exist";
+  if (vethToHost.isError()) {
+    return Error(vethToHost.error());
   }
 
   return Nothing();
@@ -4131,37 +4166,20 @@ Try<Interval<uint16_t>> EphemeralPortsAllocator::allocate()
     return Error("Number of ephemeral ports per container is zero");
   }
 
-  Option<Interval<uint16_t>> allocated;
-
-  foreach (const Interval<uint16_t>& interval, free) {
-    uint16_t upper = interval.upper();
-    uint16_t lower = interval.lower();
-    uint16_t size = upper - lower;
-
-    if (size < portsPerContainer_) {
-      continue;
-    }
-
-    // If 'lower' is not aligned, calculate the new aligned 'lower'.
-    if (lower % portsPerContainer_ != 0) {
-      lower = nextMultipleOf(lower, portsPerContainer_);
-      if (lower + portsPerContainer_ > upper) {
-        continue;
-      }
-    }
-
-    allocated = (Bound<uint16_t>::closed(lower),
-                 Bound<uint16_t>::open(lower + portsPerContainer_));
-    break;
-  }
-
-  if (allocated.isNone()) {
+  // Like a first fit over the free ports, pick the lowest free block.
+  if (freeBlocks.empty()) {
     return Error("Failed to allocate ephemeral ports");
   }
 
-  allocate(allocated.get());
+  const uint32_t lower = *freeBlocks.begin();
+
+  Interval<uint16_t> allocated =
+    (Bound<uint16_t>::closed(lower),
+     Bound<uint16_t>::open(lower + portsPerContainer_));
 
-  return allocated.get();
+  allocate(allocated);
+
+  return allocated;
 }
 
 
@@ -4171,6 +4189,8 @@ void EphemeralPortsAllocator::allocate(const Interval<uint16_t>& ports)
   CHECK(!used.contains(ports));
   free -= ports;
   used += ports;
+
+  updateFreeBlocks(ports);
 }
 
 
@@ -4180,6 +4200,32 @@ void EphemeralPortsAllocator::deallocate(const Interval<uint16_t>& ports)
   CHECK(used.contains(ports));
   free += ports;
   used -= ports;
+
+  updateFreeBlocks(ports);
+}
+
+
+void EphemeralPortsAllocator::updateFreeBlocks(
+    const Interval<uint16_t>& ports)
+{
+  if (portsPerContainer_ == 0) {
+    return;
+  }
+
+  const uint32_t begin = ports.lower() - ports.lower() % portsPerContainer_;
+  const uint32_t end = nextMultipleOf(ports.upper(), portsPerContainer_);
+
+  for (uint32_t lower = begin; lower < end; lower += portsPerContainer_) {
+    Interval<uint16_t> block =
+      (Bound<uint16_t>::closed(lower),
+       Bound<uint16_t>::open(lower + portsPerContainer_));
+
+    if (free.contains(block)) {
+      freeBlocks.insert(lower);
+    } else {
+      freeBlocks.erase(lower);
+    }
+  }
 }
 
 
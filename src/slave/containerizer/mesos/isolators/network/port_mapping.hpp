@@ -25,14 +25,17 @@
 #include <string>
 #include <vector>
 
+#include <process/future.hpp>
 #include <process/id.hpp>
 #include <process/owned.hpp>
 #include <process/subprocess.hpp>
+#include <process/time.hpp>
 
 #include <process/metrics/metrics.hpp>
 #include <process/metrics/counter.hpp>
 
 #include <stout/bytes.hpp>
+#include <stout/foreach.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
 #include <stout/ip.hpp>
@@ -85,10 +88,16 @@ class EphemeralPortsAllocator
 {
 public:
   EphemeralPortsAllocator(
-      const IntervalSet<uint16_t>& total,
+      const IntervalSet<uint16_t>& _total,
       size_t _portsPerContainer)
-    : free(total),
-      portsPerContainer_(_portsPerContainer) {}
+    : total(_total),
+      free(_total),
+      portsPerContainer_(_portsPerContainer)
+  {
+    foreach (const Interval<uint16_t>& interval, total) {
+      updateFreeBlocks(interval);
+    }
+  }
 
   // Returns the number of ephemeral ports for each container.
   size_t portsPerContainer() const { return portsPerContainer_; }
@@ -109,7 +118,7 @@ public:
   // the allocator, regardless it has been allocated to use or not.
   bool isManaged(const Interval<uint16_t>& ports)
   {
-    return (free + used).contains(ports);
+    return total.contains(ports);
   }
 
 private:
@@ -117,9 +126,21 @@ private:
   // x and t % m == 0.
   static uint32_t nextMultipleOf(uint32_t x, uint32_t m);
 
+  // Updates the free blocks overlapping with the specified port range
+  // after it has been allocated or deallocated.
+  void updateFreeBlocks(const Interval<uint16_t>& ports);
+
+  const IntervalSet<uint16_t> total;
+
   IntervalSet<uint16_t> free;
   IntervalSet<uint16_t> used;
 
+  // The lower bounds of the free port ranges that are aligned to, and
+  // of the size of, the ports for each container. This indexes the
+  // ranges `allocate()` can return, so that it does not need to scan
+  // the (possibly fragmented) free ports.
+  std::set<uint32_t> freeBlocks;
+
   // The number of ephemeral ports for each container.
   size_t portsPerContainer_;
 };
@@ -201,6 +222,11 @@ private:
 
     Option<pid_t> pid;
     Option<uint16_t> flowId;
+
+    // The statistics last collected from inside the container, and
+    // when their collection started (see 'usage').
+    Option<process::Future<ResourceStatistics>> statistics;
+    process::Time statisticsTime;
   };
 
   // Define the metrics used by the port mapping network isolator.
@@ -279,7 +305,9 @@ private:
 
   // Continuations.
   Try<Nothing> _cleanup(Info* info, const Option<ContainerID>& containerId);
-  Try<Info*> _recover(pid_t pid);
+  Try<Info*> _recover(
+      pid_t pid,
+      const hashmap<routing::filter::ip::PortRange, uint16_t>& flowIds);
 
   void _update(
       const ContainerID& containerId,
@@ -294,13 +322,18 @@ private:
       const process::Future<std::string>& out);
 
   // Helper functions.
+
+  // Collects the statistics from inside the network namespace of the
+  // container by running the network helper.
+  process::Future<ResourceStatistics> statistics(pid_t pid);
+
   Try<Nothing> addHostIPFilters(
-      const routing::filter::ip::PortRange& range,
+      const std::vector<routing::filter::ip::PortRange>& ranges,
       const Option<uint16_t>& flowId,
       const std::string& veth);
 
   Try<Nothing> removeHostIPFilters(
-      const routing::filter::ip::PortRange& range,
+      const std::vector<routing::filter::ip::PortRange>& ranges,
       const std::string& veth,
       bool removeFiltersOnVeth = true);
 
@@ -20,6 +20,8 @@
 
 #include <sys/types.h>
 
+#include <memory>
+
 #include <process/after.hpp>
 #include <process/async.hpp>
 #include <process/defer.hpp>
@@ -67,15 +69,125 @@ namespace mesos {
 namespace internal {
 namespace slave {
 
+// The container and the process found holding a listening socket by
+// a scan, and the file descriptor the process holds it with.
+struct SocketOwner
+{
+  ContainerID containerId;
+  pid_t pid;
+  int fd;
+};
+
+
+// Extract the inode field from a /proc/$PID/fd entry. The format of
+// the socket entry is "socket:[nnnn]" where nnnn is the numberic inode
+// number of the socket.
+static uint32_t extractSocketInode(const string& sock)
+{
+  const size_t s = sizeof("socket:[]") - 1;
+  const string val = sock.substr(s - 1, sock.size() - s);
+
+  Try<uint32_t> value = numify<uint32_t>(val);
+  CHECK_SOME(value);
+
+  return value.get();
+}
+
+
+// Return the file descriptors of all the sockets open in the given
+// process, indexed by the socket inode.
+static Try<hashmap<uint32_t, int>> getProcessSocketDescriptors(pid_t pid)
+{
+  const string fdPath = path::join("/proc", stringify(pid), "fd");
+
+  DIR* dir = opendir(fdPath.c_str());
+  if (dir == nullptr) {
+    return ErrnoError("Failed to open directory '" + fdPath + "'");
+  }
+
+  hashmap<uint32_t, int> fds;
+  struct dirent* entry;
+  char target[NAME_MAX];
+
+  while (true) {
+    errno = 0;
+    if ((entry = readdir(dir)) == nullptr) {
+      // If errno is non-zero, readdir failed.
+      if (errno != 0) {
+        Error error = ErrnoError("Failed to read directory '" + fdPath + "'");
+        CHECK_EQ(closedir(dir), 0) << os::strerror(errno);
+        return error;
+      }
+
+      // Otherwise we just reached the end of the directory and we are done.
+      CHECK_EQ(closedir(dir), 0) << os::strerror(errno);
+      return fds;
+    }
+
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+
+    ssize_t nbytes = readlinkat(
+        dirfd(dir), entry->d_name, target, sizeof(target) - 1);
+
+    if (nbytes == -1) {
+      Error error = ErrnoError(
+          "Failed to read symbolic link '" +
+          path::join(fdPath, entry->d_name) + "'");
+
+      CHECK_EQ(closedir(dir), 0) << os::strerror(errno);
+      return error;
+    }
+
+    target[nbytes] = '\0';
+
+    if (strings::startsWith(target, "socket:[")) {
+      Try<int> fd = numify<int>(entry->d_name);
+      CHECK_SOME(fd);
+
+      fds.put(extractSocketInode(target), fd.get());
+    }
+  }
+}
+
+
+// Return whether the process still holds the socket with the given
+// file descriptor.
+static bool holdsSocket(pid_t pid, int fd, uint32_t inode)
+{
+  const string fdPath =
+    path::join("/proc", stringify(pid), "fd", stringify(fd));
+
+  char target[NAME_MAX];
+
+  ssize_t nbytes = ::readlink(fdPath.c_str(), target, sizeof(target) - 1);
+  if (nbytes == -1) {
+    return false;
+  }
+
+  target[nbytes] = '\0';
+
+  return strings::startsWith(target, "socket:[") &&
+         extractSocketInode(target) == inode;
+}
+
+
 // Given a cgroup hierarchy and a set of container IDs, collect
 // the ports of all the listening sockets open in each cgroup,
 // indexed by container ID.
+//
+// Scanning all the file descriptors of all the processes of the
+// containers is expensive, so the owners of the listening sockets
+// found by the previous scan are checked first, and the processes
+// are only scanned until the remaining listening sockets are found.
 static hashmap<ContainerID, IntervalSet<uint16_t>>
 collectContainerListeners(
     const string& cgroupsRoot,
     const string& freezerHierarchy,
     const Option<IntervalSet<uint16_t>>& agentPorts,
-    const hashset<ContainerID>& containerIds)
+    const hashset<ContainerID>& containerIds,
+    const std::shared_ptr<hashmap<uint32_t, SocketOwner>>& owners)
 {
   hashmap<ContainerID, IntervalSet<uint16_t>> listeners;
 
@@ -88,29 +200,94 @@ collectContainerListeners(
     return listeners;
   }
 
-  if (listenInfos->empty()) {
-    return listeners;
+  // If we are filtering by agent ports, then we only look for the
+  // listen sockets within the agent port range.
+  if (agentPorts.isSome()) {
+    foreach (uint32_t inode, listenInfos->keys()) {
+      if (!agentPorts->contains(
+              ntohs(listenInfos->at(inode).sourcePort.get()))) {
+        listenInfos->erase(inode);
+      }
+    }
   }
 
-  foreach (const ContainerID& containerId, containerIds) {
-    // Reconstruct the cgroup path from the container ID.
-    string cgroup = LinuxLauncher::cgroup(cgroupsRoot, containerId);
+  hashmap<uint32_t, SocketOwner> found;
+
+  // Record the listen socket as held by the process of the container,
+  // and stop looking for it.
+  auto listening = [&](
+      uint32_t inode,
+      const ContainerID& containerId,
+      pid_t pid,
+      int fd) {
+    const auto& socketInfo = listenInfos->at(inode);
+
+    process::network::inet::Address address(
+        socketInfo.sourceIP.get(),
+        ntohs(socketInfo.sourcePort.get()));
+
+    if (VLOG_IS_ON(1)) {
+      Result<string> cmd = proc::cmdline(pid);
+      if (cmd.isSome()) {
+        VLOG(1) << "PID " << pid << " in container " << containerId
+                << " (" << cmd.get() << ")"
+                << " is listening on port " << address.port;
+      } else {
+        VLOG(1) << "PID " << pid << " in container " << containerId
+                << " is listening on port " << address.port;
+      }
+    }
 
-    VLOG(1) << "Checking processes for container " << containerId
-            << " in cgroup " << cgroup;
+    listeners[containerId].add(address.port);
+    found.put(inode, SocketOwner{containerId, pid, fd});
+    listenInfos->erase(inode);
+  };
 
-    Try<set<pid_t>> pids = cgroups::processes(freezerHierarchy, cgroup);
-    if (pids.isError()) {
-      LOG(ERROR) << "Failed to list processes for container "
-                 << containerId << ": " << pids.error();
-      continue;
+  hashmap<ContainerID, set<pid_t>> processes;
+
+  if (!listenInfos->empty()) {
+    foreach (const ContainerID& containerId, containerIds) {
+      // Reconstruct the cgroup path from the container ID.
+      string cgroup = LinuxLauncher::cgroup(cgroupsRoot, containerId);
+
+      VLOG(1) << "Checking processes for container " << containerId
+              << " in cgroup " << cgroup;
+
+      Try<set<pid_t>> pids = cgroups::processes(freezerHierarchy, cgroup);
+      if (pids.isError()) {
+        LOG(ERROR) << "Failed to list processes for container "
+                   << containerId << ": " << pids.error();
+        continue;
+      }
+
+      processes.put(containerId, pids.get());
+    }
+  }
+
+  foreachpair (uint32_t inode, const SocketOwner& owner, *owners) {
+    if (listenInfos->contains(inode) &&
+        processes.contains(owner.containerId) &&
+        processes.at(owner.containerId).count(owner.pid) > 0 &&
+        holdsSocket(owner.pid, owner.fd, inode)) {
+      listening(inode, owner.containerId, owner.pid, owner.fd);
+    }
+  }
+
+  foreachpair (const ContainerID& containerId,
+               const set<pid_t>& pids,
+               processes) {
+    if (listenInfos->empty()) {
+      break;
     }
 
     // For each process in this container, check whether any of its open
     // sockets matches something in the listening set.
-    foreach (pid_t pid, pids.get()) {
-      Try<vector<uint32_t>> sockets =
-        NetworkPortsIsolatorProcess::getProcessSockets(pid);
+    foreach (pid_t pid, pids) {
+      if (listenInfos->empty()) {
+        break;
+      }
+
+      Try<hashmap<uint32_t, int>> sockets = getProcessSocketDescriptors(pid);
 
       // The PID might have exited since we sampled the cgroup tasks, so
       // don't worry too much if this fails.
@@ -120,42 +297,16 @@ collectContainerListeners(
         continue;
       }
 
-      if (sockets->empty()) {
-        continue;
-      }
-
-      foreach (uint32_t inode, sockets.get()) {
-        if (!listenInfos->contains(inode)) {
-          continue;
-        }
-
-        const auto& socketInfo = listenInfos->at(inode);
-
-        process::network::inet::Address address(
-            socketInfo.sourceIP.get(),
-            ntohs(socketInfo.sourcePort.get()));
-
-        if (VLOG_IS_ON(1)) {
-          Result<string> cmd = proc::cmdline(pid);
-          if (cmd.isSome()) {
-            VLOG(1) << "PID " << pid << " in container " << containerId
-                    << " (" << cmd.get() << ")"
-                    << " is listening on port " << address.port;
-          } else {
-            VLOG(1) << "PID " << pid << " in container " << containerId
-                    << " is listening on port " << address.port;
-          }
-        }
-
-        // If we are filtering by agent ports, then we only collect this
-        // listen socket if it falls within the agent port range.
-        if (agentPorts.isNone() || agentPorts->contains(address.port)) {
-          listeners[containerId].add(address.port);
+      foreachpair (uint32_t inode, int fd, sockets.get()) {
+        if (listenInfos->contains(inode)) {
+          listening(inode, containerId, pid, fd);
         }
       }
     }
   }
 
+  *owners = std::move(found);
+
   return listeners;
 }
 
@@ -188,72 +339,20 @@ NetworkPortsIsolatorProcess::getListeningSockets()
 }
 
 
-// Extract the inode field from a /proc/$PID/fd entry. The format of
-// the socket entry is "socket:[nnnn]" where nnnn is the numberic inode
-// number of the socket.
-static uint32_t extractSocketInode(const string& sock)
-{
-  const size_t s = sizeof("socket:[]") - 1;
-  const string val = sock.substr(s - 1, sock.size() - s);
-
-  Try<uint32_t> value = numify<uint32_t>(val);
-  CHECK_SOME(value);
-
-  return value.get();
-}
-
-
 // Return the inodes of all the sockets open in the the given process.
 Try<vector<uint32_t>> NetworkPortsIsolatorProcess::getProcessSockets(pid_t pid)
 {
-  const string fdPath = path::join("/proc", stringify(pid), "fd");
-
-  DIR* dir = opendir(fdPath.c_str());
-  if (dir == nullptr) {
-    return ErrnoError("Failed to open directory '" + fdPath + "'");
+  Try<hashmap<uint32_t, int>> fds = getProcessSocketDescriptors(pid);
+  if (fds.isError()) {
+    return Error(fds.error());
   }
 
   vector<uint32_t> inodes;
-  struct dirent* entry;
-  char target[NAME_MAX];
-
-  while (true) {
-    errno = 0;
-    if ((entry = readdir(dir)) == nullptr) {
-      // If errno is non-zero, readdir failed.
-      if (errno != 0) {
-        Error error = ErrnoError("Failed to read directory '" + fdPath + "'");
-        CHECK_EQ(closedir(dir), 0) << os::strerror(errno);
-        return error;
-      }
-
-      // Otherwise we just reached the end of the directory and we are done.
-      CHECK_EQ(closedir(dir), 0) << os::strerror(errno);
-      return inodes;
-    }
-
-    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-      continue;
-    }
-
-    ssize_t nbytes = readlinkat(
-        dirfd(dir), entry->d_name, target, sizeof(target) - 1);
-
-    if (nbytes == -1) {
-      Error error = ErrnoError(
-          "Failed to read symbolic link '" +
-          path::join(fdPath, entry->d_name) + "'");
-
-      CHECK_EQ(closedir(dir), 0) << os::strerror(errno);
-      return error;
-    }
-
-    target[nbytes] = '\0';
-
-    if (strings::startsWith(target, "socket:[")) {
-      inodes.push_back(extractSocketInode(target));
-    }
+  foreachkey (uint32_t inode, fds.get()) {
+    inodes.push_back(inode);
   }
+
+  return inodes;
 }
 
 
@@ -595,6 +694,11 @@ void NetworkPortsIsolatorProcess::initialize()
 {
   process::PID<NetworkPortsIsolatorProcess> self(this);
 
+  // The owners of the listening sockets found by the last check,
+  // only used by one check at a time.
+  std::shared_ptr<hashmap<uint32_t, SocketOwner>> owners(
+      new hashmap<uint32_t, SocketOwner>());
+
   // Start a loop to periodically reconcile listening ports against allocated
   // resources. Note that we have to do this after the process we want the
   // loop to schedule against (the ports isolator process) has been spawned.
@@ -609,7 +713,8 @@ void NetworkPortsIsolatorProcess::initialize()
             cgroupsRoot,
             freezerHierarchy,
             agentPorts,
-            infos.keys())
+            infos.keys(),
+            owners)
           .then(defer(self, &NetworkPortsIsolatorProcess::check, lambda::_1))
           .then([]() -> ControlFlow<Nothing> { return Continue(); });
       });
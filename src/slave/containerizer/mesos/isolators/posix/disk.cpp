@@ -14,6 +14,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fnmatch.h>
+#include <fts.h>
 #include <signal.h>
 
 #ifdef __linux__
@@ -22,10 +24,13 @@
 #include <sys/types.h>
 
 #include <deque>
+#include <set>
 #include <tuple>
+#include <utility>
 
 #include <glog/logging.h>
 
+#include <process/async.hpp>
 #include <process/check.hpp>
 #include <process/collect.hpp>
 #include <process/defer.hpp>
@@ -54,6 +59,8 @@ namespace io = process::io;
 
 using std::deque;
 using std::list;
+using std::pair;
+using std::set;
 using std::string;
 using std::vector;
 
@@ -101,7 +108,9 @@ PosixDiskIsolatorProcess::Info::PathInfo::~PathInfo()
 PosixDiskIsolatorProcess::PosixDiskIsolatorProcess(const Flags& _flags)
   : ProcessBase(process::ID::generate("posix-disk-isolator")),
     flags(_flags),
-    collector(flags.container_disk_watch_interval) {}
+    collector(
+        flags.container_disk_watch_interval,
+        flags.container_disk_watch_in_process) {}
 
 
 PosixDiskIsolatorProcess::~PosixDiskIsolatorProcess() {}
@@ -455,12 +464,115 @@ Future<Nothing> PosixDiskIsolatorProcess::cleanup(
 }
 
 
+// Returns whether 'path' matches any of the 'excludes' patterns the
+// same way as `du --exclude` does, i.e., a pattern matches either the
+// whole path or any trailing sequence of its components.
+static bool excluded(const string& path, const vector<string>& excludes)
+{
+  foreach (const string& exclude, excludes) {
+    size_t position = 0;
+
+    while (true) {
+      if (::fnmatch(exclude.c_str(), path.c_str() + position, 0) == 0) {
+        return true;
+      }
+
+      position = path.find('/', position);
+      if (position == string::npos) {
+        break;
+      }
+
+      position++;
+    }
+  }
+
+  return false;
+}
+
+
+// Returns the disk usage rooted at 'path' the same way as `du -k -s`
+// does: the blocks of every file and directory are counted once, even
+// if a file has multiple hard links, symbolic links are not followed
+// (unless 'path' ends with a "/"), and entries matching any of the
+// 'excludes' are skipped along with their descendants.
+//
+// NOTE: This blocks the calling thread until the whole tree is walked.
+static Try<Bytes> walk(const string& path, const vector<string>& excludes)
+{
+  char* path_[] = {const_cast<char*>(path.c_str()), nullptr};
+
+  FTS* tree = ::fts_open(path_, FTS_NOCHDIR | FTS_PHYSICAL, nullptr);
+  if (tree == nullptr) {
+    return ErrnoError("Failed to open '" + path + "'");
+  }
+
+  set<pair<dev_t, ino_t>> links;
+  uint64_t blocks = 0;
+
+  for (FTSENT* node = ::fts_read(tree);
+       node != nullptr; node = ::fts_read(tree)) {
+    if (excluded(node->fts_path, excludes)) {
+      if (node->fts_info == FTS_D) {
+        ::fts_set(tree, node, FTS_SKIP);
+      }
+      continue;
+    }
+
+    switch (node->fts_info) {
+      case FTS_DP:
+      case FTS_DC:
+        // Directories are counted in preorder, and cycles can't
+        // happen since we don't follow symbolic links.
+        continue;
+      case FTS_DNR:
+      case FTS_ERR:
+      case FTS_NS:
+        // Ignore entries that were removed while walking the tree.
+        if (node->fts_errno == ENOENT) {
+          continue;
+        }
+
+        ::fts_close(tree);
+        return ErrnoError(
+            node->fts_errno, "Failed to read '" + string(node->fts_path) + "'");
+      default:
+        break;
+    }
+
+    const struct stat& s = *node->fts_statp;
+
+    if (!S_ISDIR(s.st_mode) &&
+        s.st_nlink > 1 &&
+        !links.insert(std::make_pair(s.st_dev, s.st_ino)).second) {
+      continue;
+    }
+
+    // NOTE: 'st_blocks' is the number of 512-byte blocks allocated.
+    blocks += s.st_blocks;
+  }
+
+  if (errno != 0) {
+    Error error = ErrnoError("Failed to walk '" + path + "'");
+    ::fts_close(tree);
+    return error;
+  }
+
+  if (::fts_close(tree) != 0) {
+    return ErrnoError("Failed to stop walking '" + path + "'");
+  }
+
+  // Round up to 1K blocks like `du -k`.
+  return Kilobytes((blocks + 1) / 2);
+}
+
+
 class DiskUsageCollectorProcess : public Process<DiskUsageCollectorProcess>
 {
 public:
-  DiskUsageCollectorProcess(const Duration& _interval)
+  DiskUsageCollectorProcess(const Duration& _interval, bool _inProcess)
     : ProcessBase(process::ID::generate("posix-disk-usage-collector")),
-      interval(_interval) {}
+      interval(_interval),
+      inProcess(_inProcess) {}
   virtual ~DiskUsageCollectorProcess() {}
 
   Future<Bytes> usage(
@@ -514,14 +626,15 @@ private:
     string path;
     vector<string> excludes;
     Option<Subprocess> du;
+    bool started = false;
     Promise<Bytes> promise;
   };
 
   void discard(const string& path)
   {
     for (auto it = entries.begin(); it != entries.end(); ++it) {
-      // We only cancel those checks whose 'du' haven't been launched.
-      if ((*it)->path == path && (*it)->du.isNone()) {
+      // We only cancel those checks that haven't been started.
+      if ((*it)->path == path && !(*it)->started) {
         (*it)->promise.discard();
         entries.erase(it);
         break;
@@ -541,6 +654,13 @@ private:
     }
 
     const Owned<Entry>& entry = entries.front();
+    entry->started = true;
+
+    if (inProcess) {
+      process::async(&walk, entry->path, entry->excludes)
+        .onAny(defer(self(), &Self::_walk, lambda::_1));
+      return;
+    }
 
     // Invoke 'du' and report number of 1K-byte blocks. We fix the
     // block size here so that we can get consistent results on all
@@ -658,16 +778,39 @@ private:
     delay(interval, self(), &Self::schedule);
   }
 
+  void _walk(const Future<Try<Bytes>>& future)
+  {
+    CHECK(!entries.empty());
+
+    const Owned<Entry>& entry = entries.front();
+
+    if (!future.isReady()) {
+      entry->promise.fail(
+          "Failed to walk '" + entry->path + "': " +
+          (future.isFailed() ? future.failure() : "discarded"));
+    } else if (future->isError()) {
+      entry->promise.fail(future->error());
+    } else {
+      entry->promise.set(future->get());
+    }
+
+    entries.pop_front();
+    delay(interval, self(), &Self::schedule);
+  }
+
   const Duration interval;
+  const bool inProcess;
 
   // A queue of pending checks.
   deque<Owned<Entry>> entries;
 };
 
 
-DiskUsageCollector::DiskUsageCollector(const Duration& interval)
+DiskUsageCollector::DiskUsageCollector(
+    const Duration& interval,
+    bool inProcess)
 {
-  process = new DiskUsageCollectorProcess(interval);
+  process = new DiskUsageCollectorProcess(interval, inProcess);
   spawn(process);
 }
 
@@ -38,11 +38,14 @@ class DiskUsageCollectorProcess;
 
 
 // Responsible for collecting disk usage for paths, while ensuring
-// that an interval elapses between each collection.
+// that an interval elapses between each collection. The disk usage is
+// collected by running 'du', or by walking the file tree on a separate
+// thread if 'inProcess' is set, which avoids forking a process per
+// collection.
 class DiskUsageCollector
 {
 public:
-  DiskUsageCollector(const Duration& interval);
+  DiskUsageCollector(const Duration& interval, bool inProcess = false);
   ~DiskUsageCollector();
 
   // Returns the disk usage rooted at 'path'. The user can discard the
@@ -16,8 +16,16 @@
 
 #include "slave/containerizer/mesos/isolators/xfs/disk.hpp"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <glog/logging.h>
 
+#include <process/async.hpp>
+#include <process/clock.hpp>
+#include <process/collect.hpp>
+#include <process/defer.hpp>
 #include <process/id.hpp>
 
 #include <stout/check.hpp>
@@ -26,11 +34,16 @@
 
 #include <stout/os/stat.hpp>
 
+#include "slave/constants.hpp"
 #include "slave/paths.hpp"
 
 using std::list;
+using std::pair;
 using std::string;
+using std::vector;
 
+using process::Clock;
+using process::defer;
 using process::Failure;
 using process::Future;
 using process::Owned;
@@ -48,6 +61,37 @@ namespace mesos {
 namespace internal {
 namespace slave {
 
+// Returns the project IDs of the sandboxes that have one, skipping the
+// "latest" symlinks. This does a blocking `ioctl()` per sandbox, hence
+// it is meant to be run on its own thread via `process::async`.
+static Try<vector<pair<string, prid_t>>> getProjectIds(
+    const vector<string>& sandboxes)
+{
+  vector<pair<string, prid_t>> projectIds;
+
+  foreach (const string& sandbox, sandboxes) {
+    // Skip the "latest" symlink.
+    if (os::stat::islink(sandbox)) {
+      continue;
+    }
+
+    Result<prid_t> projectId = xfs::getProjectId(sandbox);
+    if (projectId.isError()) {
+      return Error(projectId.error());
+    }
+
+    // If there is no project ID, don't worry about it. This can happen the
+    // first time an operator enables the XFS disk isolator and we recover a
+    // set of containers that we did not isolate.
+    if (projectId.isSome()) {
+      projectIds.emplace_back(sandbox, projectId.get());
+    }
+  }
+
+  return projectIds;
+}
+
+
 static Try<IntervalSet<prid_t>> getIntervalSet(
     const Value::Ranges& ranges)
 {
@@ -160,21 +204,40 @@ Try<Isolator*> XfsDiskIsolatorProcess::create(const Flags& flags)
     flags.enforce_container_disk_quota ? xfs::QuotaPolicy::ENFORCING
                                        : xfs::QuotaPolicy::ACCOUNTING;
 
+  // Check whether the kernel supports reporting all the project
+  // quotas at once.
+  Try<hashmap<prid_t, xfs::QuotaInfo>> quotas =
+    xfs::getProjectQuotas(flags.work_dir);
+
+  if (quotas.isError()) {
+    LOG(WARNING) << "Querying the XFS project quotas separately for each "
+                 << "container, since they cannot be reported at once: "
+                 << quotas.error();
+  }
+
   return new MesosIsolator(Owned<MesosIsolatorProcess>(
       new XfsDiskIsolatorProcess(
-          quotaPolicy, flags.work_dir, totalProjectIds.get())));
+          quotaPolicy,
+          flags.work_dir,
+          totalProjectIds.get(),
+          flags.container_disk_watch_interval,
+          quotas.isSome())));
 }
 
 
 XfsDiskIsolatorProcess::XfsDiskIsolatorProcess(
     xfs::QuotaPolicy _quotaPolicy,
     const std::string& _workDir,
-    const IntervalSet<prid_t>& projectIds)
+    const IntervalSet<prid_t>& projectIds,
+    const Duration& _watchInterval,
+    bool _batchQuotas)
   : ProcessBase(process::ID::generate("xfs-disk-isolator")),
     quotaPolicy(_quotaPolicy),
     workDir(_workDir),
     totalProjectIds(projectIds),
-    freeProjectIds(projectIds)
+    freeProjectIds(projectIds),
+    watchInterval(_watchInterval),
+    batchQuotas(_batchQuotas)
 {
   // At the beginning, the free project range is the same as the
   // configured project range.
@@ -208,48 +271,72 @@ Future<Nothing> XfsDiskIsolatorProcess::recover(
     return Failure("Failed to scan sandbox directories: " + sandboxes.error());
   }
 
+  // Look up the project IDs of the sandboxes on a bounded number of
+  // threads, rather than one sandbox after another on this process.
+  vector<vector<string>> batches(std::max<size_t>(
+      1, std::min(sandboxes->size(), MAX_ISOLATOR_RECOVERY_CONCURRENCY)));
+
+  size_t index = 0;
+  foreach (const string& sandbox, sandboxes.get()) {
+    batches[index++ % batches.size()].push_back(sandbox);
+  }
+
+  list<Future<Try<vector<pair<string, prid_t>>>>> futures;
+  foreach (const vector<string>& batch, batches) {
+    futures.push_back(process::async(&getProjectIds, batch));
+  }
+
+  return process::collect(futures)
+    .then(defer(
+        self(),
+        &XfsDiskIsolatorProcess::_recover,
+        states,
+        orphans,
+        lambda::_1));
+}
+
+
+Future<Nothing> XfsDiskIsolatorProcess::_recover(
+    const list<ContainerState>& states,
+    const hashset<ContainerID>& orphans,
+    const list<Try<vector<pair<string, prid_t>>>>& projectIds)
+{
   hashset<ContainerID> alive;
 
   foreach (const ContainerState& state, states) {
     alive.insert(state.container_id());
   }
 
-  foreach (const string& sandbox, sandboxes.get()) {
-    // Skip the "latest" symlink.
-    if (os::stat::islink(sandbox)) {
-      continue;
+  // We fail the isolator recovery upon failure in any container because
+  // failing to get the project ID usually suggests some fatal issue on the
+  // host.
+  foreach (const auto& batch, projectIds) {
+    if (batch.isError()) {
+      return Failure(batch.error());
     }
+  }
 
-    ContainerID containerId;
-    containerId.set_value(Path(sandbox).basename());
-
-    CHECK(!infos.contains(containerId)) << "ContainerIDs should never collide";
+  foreach (const auto& batch, projectIds) {
+    foreach (const auto& projectId, batch.get()) {
+      const string& sandbox = projectId.first;
 
-    // We fail the isolator recovery upon failure in any container because
-    // failing to get the project ID usually suggests some fatal issue on the
-    // host.
-    Result<prid_t> projectId = xfs::getProjectId(sandbox);
-    if (projectId.isError()) {
-      return Failure(projectId.error());
-    }
+      ContainerID containerId;
+      containerId.set_value(Path(sandbox).basename());
 
-    // If there is no project ID, don't worry about it. This can happen the
-    // first time an operator enables the XFS disk isolator and we recover a
-    // set of containers that we did not isolate.
-    if (projectId.isNone()) {
-      continue;
-    }
+      CHECK(!infos.contains(containerId))
+        << "ContainerIDs should never collide";
 
-    infos.put(containerId, Owned<Info>(new Info(sandbox, projectId.get())));
-    freeProjectIds -= projectId.get();
+      infos.put(containerId, Owned<Info>(new Info(sandbox, projectId.second)));
+      freeProjectIds -= projectId.second;
 
-    // If this is a known orphan, the containerizer will send a cleanup call
-    // later. If this is a live container, we will manage it. Otherwise, we have
-    // to dispatch a cleanup ourselves.  Note that we don't wait for the result
-    // of the cleanups as we don't want to block agent recovery for unknown
-    // orphans.
-    if (!orphans.contains(containerId) && !alive.contains(containerId)) {
-      dispatch(self(), &XfsDiskIsolatorProcess::cleanup, containerId);
+      // If this is a known orphan, the containerizer will send a cleanup
+      // call later. If this is a live container, we will manage it.
+      // Otherwise, we have to dispatch a cleanup ourselves.  Note that we
+      // don't wait for the result of the cleanups as we don't want to block
+      // agent recovery for unknown orphans.
+      if (!orphans.contains(containerId) && !alive.contains(containerId)) {
+        dispatch(self(), &XfsDiskIsolatorProcess::cleanup, containerId);
+      }
     }
   }
 
@@ -372,27 +459,46 @@ Future<ResourceStatistics> XfsDiskIsolatorProcess::usage(
     return ResourceStatistics();
   }
 
-  ResourceStatistics statistics;
   const Owned<Info>& info = infos[containerId];
 
-  Result<xfs::QuotaInfo> quota = xfs::getProjectQuota(
-      info->directory, info->projectId);
-
-  if (quota.isError()) {
-    return Failure(quota.error());
-  }
+  const prid_t projectId = info->projectId;
 
   // If we didn't set the quota (ie. we are in ACCOUNTING mode),
   // the quota limit will be 0. Since we are already tracking
   // what the quota ought to be in the Info, we just always
   // use that.
-  statistics.set_disk_limit_bytes(info->quota.bytes());
+  const Bytes limit = info->quota;
+
+  auto statistics = [limit](const Option<xfs::QuotaInfo>& quota) {
+    ResourceStatistics statistics;
+    statistics.set_disk_limit_bytes(limit.bytes());
 
-  if (quota.isSome()) {
-    statistics.set_disk_used_bytes(quota->used.bytes());
+    if (quota.isSome()) {
+      statistics.set_disk_used_bytes(quota->used.bytes());
+    }
+
+    return statistics;
+  };
+
+  if (batchQuotas) {
+    return getProjectQuotas()
+      .then([=](const hashmap<prid_t, xfs::QuotaInfo>& quotas) {
+        return statistics(quotas.get(projectId));
+      });
   }
 
-  return statistics;
+  // The quota is queried on its own thread, since `quotactl()` can
+  // block on the filesystem.
+  return process::async(&xfs::getProjectQuota, info->directory, projectId)
+    .then([=](const Result<xfs::QuotaInfo>& quota)
+        -> Future<ResourceStatistics> {
+      if (quota.isError()) {
+        return Failure(quota.error());
+      }
+
+      return statistics(
+          quota.isSome() ? Option<xfs::QuotaInfo>(quota.get()) : None());
+    });
 }
 
 
@@ -445,6 +551,35 @@ Future<Nothing> XfsDiskIsolatorProcess::cleanup(const ContainerID& containerId)
 }
 
 
+Future<hashmap<prid_t, xfs::QuotaInfo>>
+XfsDiskIsolatorProcess::getProjectQuotas()
+{
+  // Fetch the quotas again if the previous report failed, or is
+  // older than the watch interval.
+  if (quotas.isNone() ||
+      quotas->isFailed() ||
+      quotas->isDiscarded() ||
+      (quotas->isReady() && Clock::now() - quotasTime >= watchInterval)) {
+    quotasTime = Clock::now();
+
+    quotas = process::async(&xfs::getProjectQuotas, workDir)
+      .then([](const Try<hashmap<prid_t, xfs::QuotaInfo>>& quotas)
+          -> Future<hashmap<prid_t, xfs::QuotaInfo>> {
+        if (quotas.isError()) {
+          return Failure(
+              "Failed to get the XFS project quotas: " + quotas.error());
+        }
+
+        return quotas.get();
+      });
+  }
+
+  // NOTE: The report is shared by the callers, so none of them may
+  // discard it.
+  return undiscardable(quotas.get());
+}
+
+
 Option<prid_t> XfsDiskIsolatorProcess::nextProjectId()
 {
   if (freeProjectIds.empty()) {
@@ -17,13 +17,18 @@
 #ifndef __XFS_DISK_ISOLATOR_HPP__
 #define __XFS_DISK_ISOLATOR_HPP__
 
+#include <list>
 #include <string>
+#include <vector>
 
+#include <process/future.hpp>
 #include <process/owned.hpp>
+#include <process/time.hpp>
 
 #include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/hashmap.hpp>
+#include <stout/try.hpp>
 
 #include "slave/flags.hpp"
 
@@ -73,7 +78,15 @@ private:
   XfsDiskIsolatorProcess(
       xfs::QuotaPolicy quotaPolicy,
       const std::string& workDir,
-      const IntervalSet<prid_t>& projectIds);
+      const IntervalSet<prid_t>& projectIds,
+      const Duration& watchInterval,
+      bool batchQuotas);
+
+  process::Future<Nothing> _recover(
+      const std::list<mesos::slave::ContainerState>& states,
+      const hashset<ContainerID>& orphans,
+      const std::list<Try<std::vector<std::pair<std::string, prid_t>>>>&
+        projectIds);
 
   // Take the next project ID from the unallocated pool.
   Option<prid_t> nextProjectId();
@@ -81,6 +94,11 @@ private:
   // Return this project ID to the unallocated pool.
   void returnProjectId(prid_t projectId);
 
+  // Returns the quotas of all the projects on the filesystem of the
+  // work directory. These are fetched on a separate thread at most
+  // once per `watchInterval`, and shared by the `usage()` calls.
+  process::Future<hashmap<prid_t, xfs::QuotaInfo>> getProjectQuotas();
+
   struct Info
   {
     explicit Info(const std::string& _directory, prid_t _projectId)
@@ -96,6 +114,15 @@ private:
   const IntervalSet<prid_t> totalProjectIds;
   IntervalSet<prid_t> freeProjectIds;
   hashmap<ContainerID, process::Owned<Info>> infos;
+
+  const Duration watchInterval;
+
+  // Whether the kernel can report the quotas of all the projects at
+  // once, otherwise the quota of each container is queried separately.
+  const bool batchQuotas;
+
+  Option<process::Future<hashmap<prid_t, xfs::QuotaInfo>>> quotas;
+  process::Time quotasTime;
 };
 
 } // namespace slave {
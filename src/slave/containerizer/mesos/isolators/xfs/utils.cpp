@@ -37,6 +37,8 @@
 #include <linux/quota.h>
 #include <sys/quota.h>
 
+#include <limits>
+
 #include <stout/check.hpp>
 #include <stout/error.hpp>
 #include <stout/numify.hpp>
@@ -55,6 +57,12 @@ using std::string;
 #define PRJQUOTA 2
 #endif
 
+// Manually define this for old kernel headers. Compatible with the one
+// in <linux/dqblk_xfs.h>.
+#ifndef Q_XGETNEXTQUOTA
+#define Q_XGETNEXTQUOTA XQM_CMD(9)
+#endif
+
 namespace mesos {
 namespace internal {
 namespace xfs {
@@ -253,6 +261,60 @@ Result<QuotaInfo> getProjectQuota(
 }
 
 
+Try<hashmap<prid_t, QuotaInfo>> getProjectQuotas(const string& path)
+{
+  Try<string> devname = getDeviceForPath(path);
+  if (devname.isError()) {
+    return Error(devname.error());
+  }
+
+  hashmap<prid_t, QuotaInfo> quotas;
+
+  // Each Q_XGETNEXTQUOTA returns the quota of the lowest project ID
+  // that is greater or equal to the given one.
+  prid_t projectId = NON_PROJECT_ID;
+
+  while (true) {
+    fs_disk_quota_t quota = {0};
+
+    quota.d_version = FS_DQUOT_VERSION;
+    quota.d_id = projectId;
+    quota.d_flags = FS_PROJ_QUOTA;
+
+    if (::quotactl(QCMD(Q_XGETNEXTQUOTA, PRJQUOTA),
+                   devname.get().c_str(),
+                   projectId,
+                   reinterpret_cast<caddr_t>(&quota)) == -1) {
+      // ENOENT means that there are no more project quotas.
+      if (errno == ENOENT) {
+        break;
+      }
+
+      return ErrnoError("Failed to get the next quota from project ID " +
+                        stringify(projectId));
+    }
+
+    // Zero quota means that no quota is assigned, see above.
+    if (quota.d_id != NON_PROJECT_ID &&
+        (quota.d_blk_hardlimit != 0 || quota.d_bcount != 0)) {
+      QuotaInfo info;
+      info.limit = BasicBlocks(quota.d_blk_hardlimit).bytes();
+      info.used = BasicBlocks(quota.d_bcount).bytes();
+
+      quotas[quota.d_id] = info;
+    }
+
+    if (quota.d_id == std::numeric_limits<prid_t>::max()) {
+      break;
+    }
+
+    projectId = quota.d_id + 1;
+  }
+
+  return quotas;
+}
+
+
 Try<Nothing> setProjectQuota(
     const string& path,
     prid_t projectId,
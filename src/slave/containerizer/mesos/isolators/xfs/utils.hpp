@@ -20,6 +20,7 @@
 #include <string>
 
 #include <stout/bytes.hpp>
+#include <stout/hashmap.hpp>
 #include <stout/interval.hpp>
 #include <stout/nothing.hpp>
 #include <stout/try.hpp>
@@ -98,6 +99,13 @@ Result<QuotaInfo> getProjectQuota(
     prid_t projectId);
 
 
+// Returns the quotas of all the projects which have one on the
+// filesystem at the given path, using a single pass over the quotas
+// rather than one `quotactl()` per project. This requires a kernel
+// supporting `Q_XGETNEXTQUOTA` (Linux 4.6 or newer).
+Try<hashmap<prid_t, QuotaInfo>> getProjectQuotas(const std::string& path);
+
+
 Try<Nothing> setProjectQuota(
     const std::string& path,
     prid_t projectId,
@@ -459,12 +459,34 @@ Try<pid_t> LinuxLauncherProcess::fork(
     }));
   }
 
-  // Hook for creating and assigning the child into a freezer cgroup.
+  // Create the freezer cgroup for the child before cloning it, rather
+  // than in the hook below. The child is blocked until all the parent
+  // hooks have run, and until the child execs every page written by
+  // the agent in the meantime gets copied (copy-on-write), which gets
+  // expensive for large agents. Keeping the hooks short keeps that
+  // window, and the launch latency, short.
+  const string cgroup =
+    LinuxLauncher::cgroup(this->flags.cgroups_root, containerId);
+
+  Try<bool> exists = cgroups::exists(freezerHierarchy, cgroup);
+  if (exists.isError()) {
+    return Error(
+        "Failed to check existence of freezer cgroup '" + cgroup + "': " +
+        exists.error());
+  }
+
+  if (!exists.get()) {
+    Try<Nothing> create = cgroups::create(freezerHierarchy, cgroup, true);
+    if (create.isError()) {
+      return Error(
+          "Failed to create freezer cgroup '" + cgroup + "': " +
+          create.error());
+    }
+  }
+
+  // Hook for assigning the child into the freezer cgroup.
   parentHooks.emplace_back(Subprocess::ParentHook([=](pid_t child) {
-    return cgroups::isolate(
-        freezerHierarchy,
-        LinuxLauncher::cgroup(this->flags.cgroups_root, containerId),
-        child);
+    return cgroups::assign(freezerHierarchy, cgroup, child);
   }));
 
   Try<Subprocess> child = subprocess(
@@ -496,6 +518,16 @@ Try<pid_t> LinuxLauncherProcess::fork(
       {Subprocess::ChildHook::SETSID()});
 
   if (child.isError()) {
+    // Only remove the freezer cgroup if we created it above, so that
+    // we don't interfere with an existing container.
+    if (!exists.get()) {
+      Try<Nothing> remove = cgroups::remove(freezerHierarchy, cgroup);
+      if (remove.isError()) {
+        LOG(ERROR) << "Failed to remove freezer cgroup '" << cgroup
+                   << "': " << remove.error();
+      }
+    }
+
     return Error("Failed to clone child process: " + child.error());
   }
 
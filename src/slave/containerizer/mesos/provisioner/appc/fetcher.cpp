@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <tuple>
+
+#include <process/collect.hpp>
+
 #include <stout/os.hpp>
 #include <stout/strings.hpp>
 
@@ -28,6 +32,7 @@
 namespace http = process::http;
 
 using std::string;
+using std::tuple;
 
 using process::Failure;
 using process::Future;
@@ -189,6 +194,8 @@ Future<Nothing> Fetcher::fetch(const Image::Appc& appc, const Path& directory)
       directory,
       Path(uri->path()).basename()));
 
+  const string untarPath(aciBundle.string() + ".untar");
+
   return fetcher->fetch(uri.get(), directory)
     .then([=]() -> Future<Nothing> {
       // Change the extension to ".gz" as gzip utility expects it.
@@ -203,20 +210,33 @@ Future<Nothing> Fetcher::fetch(const Image::Appc& appc, const Path& directory)
 
       return command::decompress(_aciBundle);
     })
-    .then([=]() -> Future<string> {
-      return command::sha512(aciBundle);
-    })
-    .then([=](const string& shasum) -> Future<Nothing> {
-      const string imagePath(path::join(directory, "sha512-" + shasum));
-
-      Try<Nothing> mkdir = os::mkdir(imagePath);
+    .then([=]() -> Future<tuple<string, Nothing>> {
+      // The image id is the digest of the bundle, so the bundle gets
+      // untarred while computing its digest and the directory of the
+      // image is renamed afterwards.
+      Try<Nothing> mkdir = os::mkdir(untarPath);
       if (mkdir.isError()) {
         return Failure(
             "Failed to create directory for untarring image '" +
             appc.name() + "': " + mkdir.error());
       }
 
-      return command::untar(aciBundle, imagePath);
+      return process::collect(
+          command::sha512(aciBundle),
+          command::untar(aciBundle, untarPath));
+    })
+    .then([=](const tuple<string, Nothing>& results) -> Future<Nothing> {
+      const string imagePath(
+          path::join(directory, "sha512-" + std::get<0>(results)));
+
+      Try<Nothing> rename = os::rename(untarPath, imagePath);
+      if (rename.isError()) {
+        return Failure(
+            "Failed to rename directory '" + untarPath + "' to '" +
+            imagePath + "': " + rename.error());
+      }
+
+      return Nothing();
     })
     .then([=]() -> Future<Nothing> {
       // Remove the bundle file if everything goes well.
@@ -97,6 +97,11 @@ private:
 
   Owned<Cache> cache;
   Owned<Fetcher> fetcher;
+
+  // The fetches in progress, keyed by the image id if it is known or
+  // by the image name and labels otherwise, so that containers
+  // launching from the same image at once only fetch it once.
+  hashmap<string, Owned<Promise<string>>> fetching;
 };
 
 
@@ -254,7 +259,28 @@ Future<vector<string>> StoreProcess::fetchImage(
     }
   }
 
-  return _fetchImage(appc)
+  string key = appc.has_id() ? appc.id() : appc.name();
+  if (!appc.has_id()) {
+    foreach (const mesos::Label& label, appc.labels().labels()) {
+      key += "," + label.key() + "=" + label.value();
+    }
+  }
+
+  if (!fetching.contains(key)) {
+    Owned<Promise<string>> promise(new Promise<string>());
+
+    Future<string> future = _fetchImage(appc)
+      .onAny(defer(self(), [=](const Future<string>&) {
+        fetching.erase(key);
+      }));
+
+    promise->associate(future);
+    fetching[key] = promise;
+  } else {
+    VLOG(1) << "Image '" << appc.name() << "' is already being fetched";
+  }
+
+  return fetching[key]->future()
     .then(defer(self(), &Self::__fetchImage, lambda::_1, cached));
 }
 
@@ -244,7 +244,7 @@ Future<bool> AufsBackendProcess::destroy(
     const string& rootfs,
     const string& backendDir)
 {
-  Try<fs::MountInfoTable> mountTable = fs::MountInfoTable::read();
+  Try<fs::MountInfoTable> mountTable = fs::MountInfoTable::cached();
   if (mountTable.isError()) {
     return Failure("Failed to read mount table: " + mountTable.error());
   }
@@ -184,7 +184,7 @@ Future<Nothing> BindBackendProcess::provision(
 
 Future<bool> BindBackendProcess::destroy(const string& rootfs)
 {
-  Try<fs::MountInfoTable> mountTable = fs::MountInfoTable::read();
+  Try<fs::MountInfoTable> mountTable = fs::MountInfoTable::cached();
 
   if (mountTable.isError()) {
     return Failure("Failed to read mount table: " + mountTable.error());
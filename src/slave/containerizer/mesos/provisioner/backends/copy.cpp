@@ -18,6 +18,7 @@
 
 #include <mesos/docker/spec.hpp>
 
+#include <process/async.hpp>
 #include <process/collect.hpp>
 #include <process/defer.hpp>
 #include <process/dispatch.hpp>
@@ -56,7 +57,15 @@ public:
   Future<bool> destroy(const string& rootfs);
 
 private:
-  Future<Nothing> _provision(string layer, const string& rootfs);
+  Future<Nothing> _provision(
+      const string& layer,
+      const string& rootfs,
+      bool first);
+
+  Future<Nothing> __provision(
+      string layer,
+      const string& rootfs,
+      const Try<vector<string>>& whiteouts);
 };
 
 
@@ -118,10 +127,14 @@ Future<Nothing> CopyBackendProcess::provision(
 
   list<Future<Nothing>> futures{Nothing()};
 
+  bool first = true;
+
   foreach (const string layer, layers) {
     futures.push_back(
         futures.back().then(
-            defer(self(), &Self::_provision, layer, rootfs)));
+            defer(self(), &Self::_provision, layer, rootfs, first)));
+
+    first = false;
   }
 
   return collect(futures)
@@ -129,19 +142,23 @@ Future<Nothing> CopyBackendProcess::provision(
 }
 
 
-Future<Nothing> CopyBackendProcess::_provision(
-    string layer,
-    const string& rootfs)
-{
 #ifndef __WINDOWS__
-  // Traverse the layer to check if there is any whiteout files, if
-  // yes, remove the corresponding files/directories from the rootfs.
-  // Note: We assume all image types use AUFS whiteout format.
+// Traverses the layer to check if there is any whiteout files, if yes,
+// removes the corresponding files/directories from the rootfs. Returns
+// the whiteout files to remove from the rootfs once the layer has been
+// copied to it. If the rootfs is `empty`, i.e., this is the first layer,
+// there is nothing to remove and only the whiteout files get collected.
+// Note: We assume all image types use AUFS whiteout format.
+static Try<vector<string>> prepare(
+    const string& layer,
+    const string& rootfs,
+    bool empty)
+{
   char* source[] = {const_cast<char*>(layer.c_str()), nullptr};
 
   FTS* tree = ::fts_open(source, FTS_NOCHDIR | FTS_PHYSICAL, nullptr);
   if (tree == nullptr) {
-    return Failure("Failed to open '" + layer + "': " + os::strerror(errno));
+    return Error("Failed to open '" + layer + "': " + os::strerror(errno));
   }
 
   vector<string> whiteouts;
@@ -152,8 +169,10 @@ Future<Nothing> CopyBackendProcess::_provision(
     if (node->fts_info == FTS_DNR ||
         node->fts_info == FTS_ERR ||
         node->fts_info == FTS_NS) {
-      return Failure(
+      Error error(
           "Failed to read '" + ftsPath + "': " + os::strerror(node->fts_errno));
+      ::fts_close(tree);
+      return error;
     }
 
     // Skip the postorder visit of a directory.
@@ -180,6 +199,10 @@ Future<Nothing> CopyBackendProcess::_provision(
       // remove them from rootfs after layer is copied to rootfs.
       whiteouts.push_back(rootfsPath);
 
+      if (empty) {
+        continue;
+      }
+
       if (node->fts_name == string(docker::spec::WHITEOUT_OPAQUE_PREFIX)) {
         removePath = path::join(rootfs, whiteout.dirname());
       } else {
@@ -190,7 +213,7 @@ Future<Nothing> CopyBackendProcess::_provision(
       }
     }
 
-    if (os::exists(rootfsPath)) {
+    if (!empty && os::exists(rootfsPath)) {
       bool ftsIsDir = node->fts_info == FTS_D || node->fts_info == FTS_DC;
       if (os::stat::isdir(rootfsPath) != ftsIsDir) {
         // Handle overwriting between a directory and a non-directory.
@@ -223,7 +246,7 @@ Future<Nothing> CopyBackendProcess::_provision(
         Try<Nothing> rmdir = os::rmdir(removePath.get());
         if (rmdir.isError()) {
           ::fts_close(tree);
-          return Failure(
+          return Error(
               "Failed to remove directory '" +
               removePath.get() + "': " + rmdir.error());
         }
@@ -231,7 +254,7 @@ Future<Nothing> CopyBackendProcess::_provision(
         Try<Nothing> rm = os::rm(removePath.get());
         if (rm.isError()) {
           ::fts_close(tree);
-          return Failure(
+          return Error(
               "Failed to remove file '" +
               removePath.get() + "': " + rm.error());
         }
@@ -242,14 +265,47 @@ Future<Nothing> CopyBackendProcess::_provision(
   if (errno != 0) {
     Error error = ErrnoError();
     ::fts_close(tree);
-    return Failure(error);
+    return error;
   }
 
   if (::fts_close(tree) != 0) {
-    return Failure(
+    return Error(
         "Failed to stop traversing file system: " + os::strerror(errno));
   }
 
+  return whiteouts;
+}
+#endif // __WINDOWS__
+
+
+Future<Nothing> CopyBackendProcess::_provision(
+    const string& layer,
+    const string& rootfs,
+    bool first)
+{
+#ifndef __WINDOWS__
+  // NOTE: The layer is traversed in another thread rather than in this
+  // actor, so that the rootfses of several containers can be prepared
+  // at the same time.
+  return async(&prepare, layer, rootfs, first)
+    .then(defer(self(), &Self::__provision, layer, rootfs, lambda::_1));
+#else
+  return Failure(
+      "Provisioning a rootfs from an image is not supported on Windows");
+#endif // __WINDOWS__
+}
+
+
+Future<Nothing> CopyBackendProcess::__provision(
+    string layer,
+    const string& rootfs,
+    const Try<vector<string>>& whiteouts)
+{
+#ifndef __WINDOWS__
+  if (whiteouts.isError()) {
+    return Failure(whiteouts.error());
+  }
+
   VLOG(1) << "Copying layer path '" << layer << "' to rootfs '" << rootfs
           << "'";
 
@@ -262,7 +318,11 @@ Future<Nothing> CopyBackendProcess::_provision(
   // slash so we only copy the content but not the folder.
   vector<string> args{"cp", "-a", layer, rootfs};
 #else
-  vector<string> args{"cp", "-aT", layer, rootfs};
+  // Clone the files rather than copying their data on file systems
+  // that support it (e.g., btrfs, XFS with reflink enabled), so that
+  // provisioning takes about the same time regardless of the size of
+  // the layer. Other file systems fall back to a regular copy.
+  vector<string> args{"cp", "-aT", "--reflink=auto", layer, rootfs};
 #endif // __APPLE__ || __FreeBSD__
 
   Try<Subprocess> s = subprocess(
@@ -290,7 +350,7 @@ Future<Nothing> CopyBackendProcess::_provision(
       }
 
       // Remove the whiteout files from rootfs.
-      foreach (const string whiteout, whiteouts) {
+      foreach (const string whiteout, whiteouts.get()) {
         Try<Nothing> rm = os::rm(whiteout);
         if (rm.isError()) {
           return Failure(
@@ -14,6 +14,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <functional>
+
+#include <process/async.hpp>
+#include <process/defer.hpp>
 #include <process/dispatch.hpp>
 #include <process/id.hpp>
 #include <process/process.hpp>
@@ -21,12 +25,20 @@
 #include <stout/adaptor.hpp>
 #include <stout/foreach.hpp>
 #include <stout/fs.hpp>
+#include <stout/hashset.hpp>
+#include <stout/option.hpp>
 #include <stout/os.hpp>
+#include <stout/stringify.hpp>
 
 #include <stout/os/realpath.hpp>
+#include <stout/os/shell.hpp>
+
+#include "common/status_utils.hpp"
 
 #include "linux/fs.hpp"
 
+#include "slave/paths.hpp"
+
 #include "slave/containerizer/mesos/provisioner/backends/overlay.hpp"
 
 using process::Failure;
@@ -35,6 +47,8 @@ using process::Owned;
 using process::Process;
 using process::Shared;
 
+using process::async;
+using process::defer;
 using process::dispatch;
 using process::spawn;
 using process::wait;
@@ -49,8 +63,12 @@ namespace slave {
 class OverlayBackendProcess : public Process<OverlayBackendProcess>
 {
 public:
-  OverlayBackendProcess()
-    : ProcessBase(process::ID::generate("overlay-provisioner-backend")) {}
+  OverlayBackendProcess(
+      const Option<size_t>& _flattenThreshold,
+      const string& _flattenedDir)
+    : ProcessBase(process::ID::generate("overlay-provisioner-backend")),
+      flattenThreshold(_flattenThreshold),
+      flattenedDir(_flattenedDir) {}
 
   Future<Nothing> provision(
       const vector<string>& layers,
@@ -60,17 +78,184 @@ public:
   Future<bool> destroy(
       const string& rootfs,
       const string& backendDir);
+
+private:
+  // Returns the flattened layer of the given layers if it is ready,
+  // otherwise starts flattening them in the background.
+  Option<string> flattened(const vector<string>& layers);
+
+  // Removes the flattened layers of which some layer has been removed
+  // from the image store, e.g., by an image garbage collection.
+  void evict();
+
+  const Option<size_t> flattenThreshold;
+  const string flattenedDir;
+
+  // The directories of the flattened layers being created.
+  hashset<string> flattening;
 };
 
 
-Try<Owned<Backend>> OverlayBackend::create(const Flags&)
+// The file listing the layers that a flattened layer was built from.
+constexpr char FLATTENED_LAYERS_FILE[] = "layers";
+
+
+// Suffix of the directory a flattened layer gets built in, before
+// being atomically renamed into place.
+constexpr char FLATTENED_STAGING_SUFFIX[] = ".staging";
+
+
+// Removes the directory of a flattened layer being built, after
+// unmounting the overlay under it if the agent failed while the layer
+// was being copied.
+static Try<Nothing> removeStaging(const string& staging)
+{
+  const string merged = path::join(staging, "merged");
+
+  if (os::exists(merged)) {
+    // NOTE: This fails if the overlay is not mounted.
+    fs::unmount(merged, MNT_DETACH);
+  }
+
+  return os::rmdir(staging);
+}
+
+
+// Merges the given layers into a single layer at `directory`. The
+// layers are mounted read-only with overlayfs and the merged view is
+// copied. Since these are the lowest layers of an image, there is
+// nothing below them for their whiteouts to hide, so the flattened
+// layer needs none.
+static Try<Nothing> flatten(
+    const vector<string>& layers,
+    const string& directory)
+{
+  const string staging = directory + FLATTENED_STAGING_SUFFIX;
+
+  if (os::exists(staging)) {
+    Try<Nothing> remove = removeStaging(staging);
+    if (remove.isError()) {
+      return Error(
+          "Failed to remove '" + staging + "': " + remove.error());
+    }
+  }
+
+  const string merged = path::join(staging, "merged");
+  const string rootfs = path::join(staging, "rootfs");
+
+  const vector<string> directories = {merged, rootfs};
+
+  foreach (const string& dir, directories) {
+    Try<Nothing> mkdir = os::mkdir(dir);
+    if (mkdir.isError()) {
+      return Error(
+          "Failed to create directory '" + dir + "': " + mkdir.error());
+    }
+  }
+
+  // We use symlinks with shorter paths to the layers, like when
+  // provisioning, so that the mount options fit in a page.
+  Try<string> tempDir = os::mkdtemp();
+  if (tempDir.isError()) {
+    return Error(
+        "Failed to create temporary directory for symlinks to layers: " +
+        tempDir.error());
+  }
+
+  vector<string> links;
+  links.reserve(layers.size());
+
+  for (size_t i = 0; i < layers.size(); i++) {
+    const string link = path::join(tempDir.get(), stringify(i));
+
+    Try<Nothing> symlink = ::fs::symlink(layers[i], link);
+    if (symlink.isError()) {
+      os::rmdir(tempDir.get());
+      return Error(
+          "Failed to create symlink at '" + link +
+          "' -> '" + layers[i] + "': " + symlink.error());
+    }
+
+    links.push_back(link);
+  }
+
+  Try<Nothing> mount = fs::mount(
+      "overlay",
+      merged,
+      "overlay",
+      MS_RDONLY,
+      "lowerdir=" + strings::join(":", adaptor::reverse(links)));
+
+  if (mount.isError()) {
+    os::rmdir(tempDir.get());
+    return Error(
+        "Failed to mount the layers with overlayfs: " + mount.error());
+  }
+
+  const int status = os::spawn("cp", {"cp", "-aT", merged, rootfs});
+
+  Try<Nothing> unmount = fs::unmount(merged);
+
+  os::rmdir(tempDir.get());
+
+  if (status != 0) {
+    return Error(
+        "Failed to copy the merged layers, exit status: " +
+        WSTRINGIFY(status));
+  }
+
+  if (unmount.isError()) {
+    return Error(
+        "Failed to unmount '" + merged + "': " + unmount.error());
+  }
+
+  Try<Nothing> rmdir = os::rmdir(merged);
+  if (rmdir.isError()) {
+    return Error(
+        "Failed to remove directory '" + merged + "': " + rmdir.error());
+  }
+
+  Try<Nothing> write = os::write(
+      path::join(staging, FLATTENED_LAYERS_FILE),
+      strings::join("\n", layers));
+
+  if (write.isError()) {
+    return Error("Failed to write the flattened layers: " + write.error());
+  }
+
+  // Replace a stale flattened layer, if any.
+  if (os::exists(directory)) {
+    rmdir = os::rmdir(directory);
+    if (rmdir.isError()) {
+      return Error(
+          "Failed to remove directory '" + directory + "': " + rmdir.error());
+    }
+  }
+
+  Try<Nothing> rename = os::rename(staging, directory);
+  if (rename.isError()) {
+    return Error(
+        "Failed to rename '" + staging + "' to '" + directory + "': " +
+        rename.error());
+  }
+
+  return Nothing();
+}
+
+
+Try<Owned<Backend>> OverlayBackend::create(const Flags& flags)
 {
   if (geteuid() != 0) {
     return Error("OverlayBackend requires root privileges");
   }
 
   return Owned<Backend>(new OverlayBackend(
-      Owned<OverlayBackendProcess>(new OverlayBackendProcess())));
+      Owned<OverlayBackendProcess>(new OverlayBackendProcess(
+          flags.image_provisioner_flatten_threshold,
+          path::join(
+              paths::getProvisionerDir(flags.work_dir),
+              "overlay",
+              "flattened")))));
 }
 
 
@@ -169,13 +354,29 @@ Future<Nothing> OverlayBackendProcess::provision(
 
   VLOG(1) << "Created symlink '" << tempLink << "' -> '" << tempDir << "'";
 
+  // For deep images, the lowest layers get merged into one flattened
+  // layer, so that at most `flattenThreshold` layers are stacked.
+  vector<string> lowerLayers = layers;
+
+  if (flattenThreshold.isSome() && layers.size() > flattenThreshold.get()) {
+    const size_t upper = flattenThreshold.get() - 1;
+
+    Option<string> flattenedLayer =
+      flattened(vector<string>(layers.begin(), layers.end() - upper));
+
+    if (flattenedLayer.isSome()) {
+      lowerLayers = {flattenedLayer.get()};
+      lowerLayers.insert(lowerLayers.end(), layers.end() - upper, layers.end());
+    }
+  }
+
   vector<string> links;
-  links.reserve(layers.size());
+  links.reserve(lowerLayers.size());
 
   // We create symlinks with file name 0, 1, ..., N-1 in tempDir which
   // points to the corresponding layers in the same order.
   size_t idx = 0;
-  foreach (const string& layer, layers) {
+  foreach (const string& layer, lowerLayers) {
     const string link = path::join(tempDir, std::to_string(idx++));
 
     Try<Nothing> symlink = ::fs::symlink(layer, link);
@@ -245,7 +446,7 @@ Future<bool> OverlayBackendProcess::destroy(
     const string& rootfs,
     const string& backendDir)
 {
-  Try<fs::MountInfoTable> mountTable = fs::MountInfoTable::read();
+  Try<fs::MountInfoTable> mountTable = fs::MountInfoTable::cached();
   if (mountTable.isError()) {
     return Failure("Failed to read mount table: " + mountTable.error());
   }
@@ -312,6 +513,122 @@ Future<bool> OverlayBackendProcess::destroy(
   return false;
 }
 
+
+Option<string> OverlayBackendProcess::flattened(const vector<string>& layers)
+{
+  // The flattened layers are addressed by the layers they were built
+  // from, the paths of which are unique in the image store.
+  const string manifest = strings::join("\n", layers);
+  const string directory =
+    path::join(flattenedDir, stringify(std::hash<string>()(manifest)));
+
+  if (flattening.contains(directory)) {
+    return None();
+  }
+
+  if (os::exists(directory)) {
+    Try<string> read =
+      os::read(path::join(directory, FLATTENED_LAYERS_FILE));
+
+    if (read.isSome() && read.get() == manifest) {
+      return path::join(directory, "rootfs");
+    }
+
+    if (read.isSome()) {
+      VLOG(1) << "Not flattening layers since '" << directory
+              << "' holds the flattened layer of other layers";
+
+      return None();
+    }
+  }
+
+  evict();
+
+  LOG(INFO) << "Flattening the " << layers.size() << " lowest image layers"
+            << " into '" << directory << "'";
+
+  flattening.insert(directory);
+
+  async(&flatten, layers, directory)
+    .onAny(defer(self(), [=](const Future<Try<Nothing>>& future) {
+      flattening.erase(directory);
+
+      if (!future.isReady() || future->isError()) {
+        LOG(WARNING) << "Failed to flatten image layers into '" << directory
+                     << "': "
+                     << (future.isFailed()
+                           ? future.failure()
+                           : future.isDiscarded()
+                               ? "discarded"
+                               : future->error());
+      }
+    }));
+
+  return None();
+}
+
+
+void OverlayBackendProcess::evict()
+{
+  if (!os::exists(flattenedDir)) {
+    return;
+  }
+
+  Try<std::list<string>> entries = os::ls(flattenedDir);
+  if (entries.isError()) {
+    LOG(WARNING) << "Failed to list flattened layers in '" << flattenedDir
+                 << "': " << entries.error();
+    return;
+  }
+
+  foreach (const string& entry, entries.get()) {
+    const string directory = path::join(flattenedDir, entry);
+
+    if (strings::endsWith(entry, FLATTENED_STAGING_SUFFIX)) {
+      // Remove what is left from a flattening when the agent failed.
+      const string target = strings::remove(
+          directory, FLATTENED_STAGING_SUFFIX, strings::SUFFIX);
+
+      if (!flattening.contains(target)) {
+        Try<Nothing> remove = removeStaging(directory);
+        if (remove.isError()) {
+          LOG(WARNING) << "Failed to remove '" << directory << "': "
+                       << remove.error();
+        }
+      }
+
+      continue;
+    }
+
+    Try<string> read =
+      os::read(path::join(directory, FLATTENED_LAYERS_FILE));
+
+    bool stale = read.isError();
+
+    if (read.isSome()) {
+      foreach (const string& layer, strings::tokenize(read.get(), "\n")) {
+        if (!os::exists(layer)) {
+          stale = true;
+          break;
+        }
+      }
+    }
+
+    // NOTE: The image store only removes the layers which are not used
+    // by any container, so no rootfs is stacked on a stale flattened
+    // layer.
+    if (stale) {
+      LOG(INFO) << "Removing stale flattened layer '" << directory << "'";
+
+      Try<Nothing> rmdir = os::rmdir(directory);
+      if (rmdir.isError()) {
+        LOG(WARNING) << "Failed to remove '" << directory << "': "
+                     << rmdir.error();
+      }
+    }
+  }
+}
+
 } // namespace slave {
 } // namespace internal {
 } // namespace mesos {
@@ -42,6 +42,15 @@ class OverlayBackendProcess;
 //                            |-- upperdir
 //                            |-- workdir
 //                            |-- links (symlink to temp dir with links to layers) // NOLINT(whitespace/line_length)
+//     |-- overlay
+//         |-- flattened
+//             |-- <hash of the layers> (a flattened layer)
+//                 |-- layers (the layers it was built from)
+//                 |-- rootfs
+//
+// With the '--image_provisioner_flatten_threshold' flag, the lowest
+// layers of deep images get merged into a flattened layer, which is
+// stacked in place of those layers once it has been built.
 class OverlayBackend : public Backend
 {
 public:
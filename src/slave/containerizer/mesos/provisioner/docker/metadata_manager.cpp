@@ -19,15 +19,20 @@
 
 #include <glog/logging.h>
 
+#include <stout/duration.hpp>
 #include <stout/foreach.hpp>
 #include <stout/hashset.hpp>
 #include <stout/os.hpp>
 #include <stout/protobuf.hpp>
 
+#include <process/clock.hpp>
 #include <process/defer.hpp>
 #include <process/dispatch.hpp>
 #include <process/owned.hpp>
 
+#include <process/metrics/gauge.hpp>
+#include <process/metrics/metrics.hpp>
+
 #include "common/status_utils.hpp"
 
 #include "slave/state.hpp"
@@ -41,6 +46,7 @@ namespace spec = docker::spec;
 using std::string;
 using std::vector;
 
+using process::Clock;
 using process::Failure;
 using process::Future;
 using process::Owned;
@@ -53,7 +59,9 @@ namespace docker {
 class MetadataManagerProcess : public process::Process<MetadataManagerProcess>
 {
 public:
-  MetadataManagerProcess(const Flags& _flags) : flags(_flags) {}
+  MetadataManagerProcess(const Flags& _flags)
+    : flags(_flags),
+      metrics(*this) {}
 
   ~MetadataManagerProcess() {}
 
@@ -74,12 +82,51 @@ private:
   // Write out metadata manager state to persistent store.
   Try<Nothing> persist();
 
+  double _images()
+  {
+    return static_cast<double>(storedImages.size());
+  }
+
+  double _layers()
+  {
+    hashset<string> layerIds;
+    foreachvalue (const Image& image, storedImages) {
+      layerIds.insert(image.layer_ids().begin(), image.layer_ids().end());
+    }
+
+    return static_cast<double>(layerIds.size());
+  }
+
   const Flags flags;
 
   // This is a lookup table for images that are stored in memory. It is keyed
   // by image name.
   // For example, "ubuntu:14.04" -> ubuntu14:04 Image.
   hashmap<string, Image> storedImages;
+
+  struct Metrics
+  {
+    explicit Metrics(const MetadataManagerProcess& process)
+      : images(
+            "containerizer/mesos/provisioner/docker_store/images",
+            defer(process, &MetadataManagerProcess::_images)),
+        layers(
+            "containerizer/mesos/provisioner/docker_store/layers",
+            defer(process, &MetadataManagerProcess::_layers))
+    {
+      process::metrics::add(images);
+      process::metrics::add(layers);
+    }
+
+    ~Metrics()
+    {
+      process::metrics::remove(images);
+      process::metrics::remove(layers);
+    }
+
+    process::metrics::Gauge images;
+    process::metrics::Gauge layers;
+  } metrics;
 };
 
 
@@ -157,6 +204,8 @@ Future<Image> MetadataManagerProcess::put(
     dockerImage.add_layer_ids(layerId);
   }
 
+  dockerImage.set_last_used(Clock::now().secs());
+
   storedImages[imageReference] = dockerImage;
 
   Try<Nothing> status = persist();
@@ -187,6 +236,10 @@ Future<Option<Image>> MetadataManagerProcess::get(
     return None();
   }
 
+  // NOTE: To avoid a checkpoint per provisioned container, the time of
+  // use only gets persisted along with the next change to the images.
+  storedImages[imageReference].set_last_used(Clock::now().secs());
+
   return storedImages[imageReference];
 }
 
@@ -217,6 +270,33 @@ Future<hashset<string>> MetadataManagerProcess::prune(
     }
   }
 
+  // Retain the images used within the retention period, if any, so
+  // that only the least recently used images get removed.
+  if (flags.image_gc_config.isSome() &&
+      flags.image_gc_config->has_image_retention_period()) {
+    const Duration retention = Nanoseconds(
+        flags.image_gc_config->image_retention_period().nanoseconds());
+
+    const double now = Clock::now().secs();
+
+    foreachpair (const string& imageName, const Image& image, storedImages) {
+      if (retainedImages.contains(imageName) ||
+          !image.has_last_used() ||
+          now - image.last_used() >= retention.secs()) {
+        continue;
+      }
+
+      VLOG(1) << "Docker image '" << imageName << "' is retained as it has"
+              << " been used within the last " << retention;
+
+      retainedImages[imageName] = image;
+
+      foreach (const string& layerId, image.layer_ids()) {
+        retainedLayers.insert(layerId);
+      }
+    }
+  }
+
   storedImages = std::move(retainedImages);
 
   Try<Nothing> status = persist();
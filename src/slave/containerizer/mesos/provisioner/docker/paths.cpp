@@ -125,6 +125,18 @@ string getGcLayerPath(const string& storeDir, const string& layerId)
       layerId + "." + stringify(process::Clock::now().duration().ns()));
 }
 
+
+string getBlobsDir(const string& storeDir)
+{
+  return path::join(storeDir, "blobs");
+}
+
+
+string getBlobPath(const string& storeDir, const string& blobSum)
+{
+  return path::join(getBlobsDir(storeDir), blobSum);
+}
+
 } // namespace paths {
 } // namespace docker {
 } // namespace slave {
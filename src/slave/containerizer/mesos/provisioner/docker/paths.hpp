@@ -42,6 +42,8 @@ namespace paths {
  *           |-- rootfs
  *           |-- json(manifest)
  *           |-- VERSION
+ *    |--blobs (only with '--docker_layer_peers')
+ *       |--<blob_sum> (layer tar ball served to peer agents)
  *    |--storedImages (file holding on cached images)
  *    |--gc (dir holding marked layers to be sweeped)
  */
@@ -103,6 +105,14 @@ std::string getGcLayerPath(
     const std::string& layerId);
 
 
+std::string getBlobsDir(const std::string& storeDir);
+
+
+std::string getBlobPath(
+    const std::string& storeDir,
+    const std::string& blobSum);
+
+
 Try<std::list<std::string>> listLayers(const std::string& storeDir);
 
 } // namespace paths {
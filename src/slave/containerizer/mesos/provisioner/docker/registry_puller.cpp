@@ -14,6 +14,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <deque>
+
 #include <glog/logging.h>
 
 #include <mesos/secret/resolver.hpp>
@@ -23,14 +26,23 @@
 #include <process/dispatch.hpp>
 #include <process/http.hpp>
 
+#include <stout/numify.hpp>
+#include <stout/strings.hpp>
+
 #include <stout/os/exists.hpp>
 #include <stout/os/mkdir.hpp>
+#include <stout/os/mkdtemp.hpp>
+#include <stout/os/rename.hpp>
 #include <stout/os/rm.hpp>
+#include <stout/os/rmdir.hpp>
 #include <stout/os/write.hpp>
 
 #include "common/command_utils.hpp"
 
 #include "uri/schemes/docker.hpp"
+#include "uri/schemes/http.hpp"
+
+#include "slave/constants.hpp"
 
 #include "slave/containerizer/mesos/provisioner/docker/paths.hpp"
 #include "slave/containerizer/mesos/provisioner/docker/registry_puller.hpp"
@@ -38,6 +50,7 @@
 namespace http = process::http;
 namespace spec = docker::spec;
 
+using std::deque;
 using std::list;
 using std::string;
 using std::vector;
@@ -46,6 +59,7 @@ using process::Failure;
 using process::Future;
 using process::Owned;
 using process::Process;
+using process::Promise;
 using process::Shared;
 
 using process::defer;
@@ -64,6 +78,8 @@ public:
   RegistryPullerProcess(
       const string& _storeDir,
       const http::URL& _defaultRegistryUrl,
+      const Option<size_t>& _maxConcurrentDownloads,
+      const vector<URI>& _peers,
       const Shared<uri::Fetcher>& _fetcher,
       SecretResolver* _secretResolver);
 
@@ -90,16 +106,55 @@ private:
     const spec::ImageReference& reference,
     const string& directory,
     const spec::v2::ImageManifest& manifest,
-    const hashset<string>& blobSums,
+    const hashmap<string, Future<Nothing>>& blobs,
     const string& backend);
 
-  Future<hashset<string>> fetchBlobs(
+  // Starts fetching the blobs of the layers that are not in the store
+  // yet, and returns the fetches keyed by blob sum.
+  Try<hashmap<string, Future<Nothing>>> fetchBlobs(
     const spec::ImageReference& reference,
     const string& directory,
     const spec::v2::ImageManifest& manifest,
     const string& backend,
     const Option<Secret::Value>& config);
 
+  // Fetches the blob once fewer than `maxConcurrentDownloads` blobs
+  // are being fetched.
+  Future<Nothing> fetchBlob(
+      const string& blobSum,
+      const URI& uri,
+      const string& directory,
+      const Option<string>& data);
+
+  void _fetchBlob();
+
+  // Fetches the blob from the peers if any, otherwise from `uri`.
+  Future<Nothing> download(
+      const string& blobSum,
+      const URI& uri,
+      const string& directory,
+      const Option<string>& data);
+
+  // Tries to fetch the blob from each of the `candidates` in turn.
+  Future<Nothing> fetchBlobFromPeers(
+      const string& blobSum,
+      const string& directory,
+      deque<URI> candidates);
+
+  Future<Nothing> fetchBlobFromPeer(
+      const string& blobSum,
+      const URI& peer,
+      const string& directory);
+
+  struct Download
+  {
+    string blobSum;
+    URI uri;
+    string directory;
+    Option<string> data;
+    Promise<Nothing> promise;
+  };
+
   RegistryPullerProcess(const RegistryPullerProcess&) = delete;
   RegistryPullerProcess& operator=(const RegistryPullerProcess&) = delete;
 
@@ -109,8 +164,19 @@ private:
   // reference, this registry url will be used as the default.
   const http::URL defaultRegistryUrl;
 
+  const Option<size_t> maxConcurrentDownloads;
+
+  // The `/files/download` endpoints of the peer agents to fetch blobs
+  // from before falling back to the registry, see `--docker_layer_peers`.
+  const vector<URI> peers;
+
   Shared<uri::Fetcher> fetcher;
   SecretResolver* secretResolver;
+
+  // The number of blobs being fetched, and the blobs waiting to be
+  // fetched because of `maxConcurrentDownloads`.
+  size_t downloads = 0;
+  deque<Owned<Download>> queuedDownloads;
 };
 
 
@@ -126,13 +192,41 @@ Try<Owned<Puller>> RegistryPuller::create(
         defaultRegistryUrl.error());
   }
 
+  vector<URI> peers;
+
+  if (flags.docker_layer_peers.isSome()) {
+    foreach (const string& token,
+             strings::tokenize(flags.docker_layer_peers.get(), ",")) {
+      const string peer = strings::trim(token);
+      const vector<string> hostPort = strings::split(peer, ":");
+
+      if (hostPort.size() != 2 || hostPort[0].empty()) {
+        return Error(
+            "Failed to parse Docker layer peer '" + peer + "': "
+            "Expecting 'host:port'");
+      }
+
+      Try<int> port = numify<int>(hostPort[1]);
+      if (port.isError()) {
+        return Error(
+            "Failed to parse the port of Docker layer peer '" + peer +
+            "': " + port.error());
+      }
+
+      peers.push_back(uri::http(hostPort[0], "/files/download", port.get()));
+    }
+  }
+
   VLOG(1) << "Creating registry puller with docker registry '"
-          << flags.docker_registry << "'";
+          << flags.docker_registry << "' and " << peers.size()
+          << " Docker layer peers";
 
   Owned<RegistryPullerProcess> process(
       new RegistryPullerProcess(
           flags.docker_store_dir,
           defaultRegistryUrl.get(),
+          flags.max_concurrent_docker_layer_downloads,
+          peers,
           fetcher,
           secretResolver));
 
@@ -173,11 +267,15 @@ Future<vector<string>> RegistryPuller::pull(
 RegistryPullerProcess::RegistryPullerProcess(
     const string& _storeDir,
     const http::URL& _defaultRegistryUrl,
+    const Option<size_t>& _maxConcurrentDownloads,
+    const vector<URI>& _peers,
     const Shared<uri::Fetcher>& _fetcher,
     SecretResolver* _secretResolver)
   : ProcessBase(process::ID::generate("docker-provisioner-registry-puller")),
     storeDir(_storeDir),
     defaultRegistryUrl(_defaultRegistryUrl),
+    maxConcurrentDownloads(_maxConcurrentDownloads),
+    peers(_peers),
     fetcher(_fetcher),
     secretResolver(_secretResolver) {}
 
@@ -321,14 +419,14 @@ Future<vector<string>> RegistryPullerProcess::__pull(
     return Failure("'fsLayers' and 'history' have different size in manifest");
   }
 
-  return fetchBlobs(reference, directory, manifest.get(), backend, config)
-    .then(defer(self(),
-                &Self::___pull,
-                reference,
-                directory,
-                manifest.get(),
-                lambda::_1,
-                backend));
+  Try<hashmap<string, Future<Nothing>>> blobs =
+    fetchBlobs(reference, directory, manifest.get(), backend, config);
+
+  if (blobs.isError()) {
+    return Failure(blobs.error());
+  }
+
+  return ___pull(reference, directory, manifest.get(), blobs.get(), backend);
 }
 
 
@@ -336,7 +434,7 @@ Future<vector<string>> RegistryPullerProcess::___pull(
     const spec::ImageReference& reference,
     const string& directory,
     const spec::v2::ImageManifest& manifest,
-    const hashset<string>& blobSums,
+    const hashmap<string, Future<Nothing>>& blobs,
     const string& backend)
 {
   // Docker reads the layer ids from the disk:
@@ -410,15 +508,36 @@ Future<vector<string>> RegistryPullerProcess::___pull(
           v1.id() + "': " + write.error());
     }
 
-    futures.push_back(command::untar(Path(tar), Path(rootfs)));
+    // Extract each layer as soon as its blob is fetched, rather than
+    // waiting for all the blobs.
+    CHECK(blobs.contains(blobSum));
+
+    futures.push_back(blobs.at(blobSum)
+      .then(defer(self(), [=]() {
+        return command::untar(Path(tar), Path(rootfs));
+      })));
   }
 
   return collect(futures)
     .then([=]() -> Future<vector<string>> {
-      // Remove the tarballs after the extraction.
-      foreach (const string& blobSum, blobSums) {
+      // Remove the tarballs after the extraction, unless they are kept
+      // to be served to the peers.
+      foreachkey (const string& blobSum, blobs) {
         const string tar = path::join(directory, blobSum);
 
+        if (!peers.empty()) {
+          const string blob = paths::getBlobPath(storeDir, blobSum);
+
+          Try<Nothing> rename = os::rename(tar, blob);
+          if (rename.isError()) {
+            return Failure(
+                "Failed to move '" + tar + "' to '" + blob + "' "
+                "after extraction: " + rename.error());
+          }
+
+          continue;
+        }
+
         Try<Nothing> rm = os::rm(tar);
         if (rm.isError()) {
           return Failure(
@@ -432,7 +551,7 @@ Future<vector<string>> RegistryPullerProcess::___pull(
 }
 
 
-Future<hashset<string>> RegistryPullerProcess::fetchBlobs(
+Try<hashmap<string, Future<Nothing>>> RegistryPullerProcess::fetchBlobs(
     const spec::ImageReference& reference,
     const string& directory,
     const spec::v2::ImageManifest& manifest,
@@ -465,7 +584,7 @@ Future<hashset<string>> RegistryPullerProcess::fetchBlobs(
   }
 
   // Now, actually fetch the blobs.
-  list<Future<Nothing>> futures;
+  hashmap<string, Future<Nothing>> blobs;
 
   foreach (const string& blobSum, blobSums) {
     URI blobUri;
@@ -473,12 +592,12 @@ Future<hashset<string>> RegistryPullerProcess::fetchBlobs(
     if (reference.has_registry()) {
       Result<int> port = spec::getRegistryPort(reference.registry());
       if (port.isError()) {
-        return Failure("Failed to get registry port: " + port.error());
+        return Error("Failed to get registry port: " + port.error());
       }
 
       Try<string> scheme = spec::getRegistryScheme(reference.registry());
       if (scheme.isError()) {
-        return Failure("Failed to get registry scheme: " + scheme.error());
+        return Error("Failed to get registry scheme: " + scheme.error());
       }
 
       // If users want to use the registry specified in '--docker_image',
@@ -507,14 +626,169 @@ Future<hashset<string>> RegistryPullerProcess::fetchBlobs(
           port);
     }
 
-    futures.push_back(fetcher->fetch(
+    blobs[blobSum] = fetchBlob(
+        blobSum,
         blobUri,
         directory,
-        config.isSome() ? config->data() : Option<string>()));
+        config.isSome() ? config->data() : Option<string>());
   }
 
-  return collect(futures)
-    .then([blobSums]() -> hashset<string> { return blobSums; });
+  return blobs;
+}
+
+
+Future<Nothing> RegistryPullerProcess::fetchBlob(
+    const string& blobSum,
+    const URI& uri,
+    const string& directory,
+    const Option<string>& data)
+{
+  if (maxConcurrentDownloads.isNone() ||
+      downloads < maxConcurrentDownloads.get()) {
+    downloads++;
+
+    return download(blobSum, uri, directory, data)
+      .onAny(defer(self(), &Self::_fetchBlob));
+  }
+
+  Owned<Download> download(new Download());
+  download->blobSum = blobSum;
+  download->uri = uri;
+  download->directory = directory;
+  download->data = data;
+
+  queuedDownloads.push_back(download);
+
+  return download->promise.future();
+}
+
+
+void RegistryPullerProcess::_fetchBlob()
+{
+  CHECK_GT(downloads, 0u);
+  downloads--;
+
+  if (queuedDownloads.empty()) {
+    return;
+  }
+
+  Owned<Download> download = queuedDownloads.front();
+  queuedDownloads.pop_front();
+
+  download->promise.associate(fetchBlob(
+      download->blobSum,
+      download->uri,
+      download->directory,
+      download->data));
+}
+
+
+Future<Nothing> RegistryPullerProcess::download(
+    const string& blobSum,
+    const URI& uri,
+    const string& directory,
+    const Option<string>& data)
+{
+  if (peers.empty()) {
+    return fetcher->fetch(uri, directory, data);
+  }
+
+  // Try the peers in a random order to spread the load of rolling out
+  // an image to many agents across the peers.
+  vector<URI> candidates = peers;
+  std::random_shuffle(candidates.begin(), candidates.end());
+
+  return fetchBlobFromPeers(
+      blobSum,
+      directory,
+      deque<URI>(candidates.begin(), candidates.end()))
+    .repair(defer(self(), [=](const Future<Nothing>& future) {
+      VLOG(1) << "Fetching blob '" << blobSum << "' from the registry: "
+              << (future.isFailed() ? future.failure() : "discarded");
+
+      return fetcher->fetch(uri, directory, data);
+    }));
+}
+
+
+Future<Nothing> RegistryPullerProcess::fetchBlobFromPeers(
+    const string& blobSum,
+    const string& directory,
+    deque<URI> candidates)
+{
+  if (candidates.empty()) {
+    return Failure("Failed to fetch the blob from any peer");
+  }
+
+  const URI peer = candidates.front();
+  candidates.pop_front();
+
+  return fetchBlobFromPeer(blobSum, peer, directory)
+    .repair(defer(self(), [=](const Future<Nothing>& future) {
+      VLOG(1) << "Failed to fetch blob '" << blobSum << "' from peer '"
+              << peer.host() << ":" << peer.port() << "': "
+              << (future.isFailed() ? future.failure() : "discarded");
+
+      return fetchBlobFromPeers(blobSum, directory, candidates);
+    }));
+}
+
+
+Future<Nothing> RegistryPullerProcess::fetchBlobFromPeer(
+    const string& blobSum,
+    const URI& peer,
+    const string& directory)
+{
+  // Blobs are only fetched from peers if their digest can be verified.
+  const string algorithm = "sha256:";
+  if (!strings::startsWith(blobSum, algorithm)) {
+    return Failure("Unsupported digest algorithm");
+  }
+
+  URI uri = peer;
+  uri.set_query(
+      "path=" +
+      http::encode(string(DOCKER_BLOBS_VIRTUAL_PATH) + "/" + blobSum));
+
+  // NOTE: The blob is downloaded into its own directory since the
+  // fetcher names the file after the endpoint, i.e., 'download'.
+  Try<string> temp = os::mkdtemp(path::join(directory, "peer.XXXXXX"));
+  if (temp.isError()) {
+    return Failure("Failed to create temporary directory: " + temp.error());
+  }
+
+  const string tar = path::join(temp.get(), "download");
+
+  return fetcher->fetch(uri, temp.get())
+    .then([tar]() {
+      return command::sha256(Path(tar));
+    })
+    .then([=](const string& digest) -> Future<Nothing> {
+      if (algorithm + digest != blobSum) {
+        return Failure("Mismatched digest '" + algorithm + digest + "'");
+      }
+
+      const string blob = path::join(directory, blobSum);
+
+      Try<Nothing> rename = os::rename(tar, blob);
+      if (rename.isError()) {
+        return Failure(
+            "Failed to move '" + tar + "' to '" + blob + "': " +
+            rename.error());
+      }
+
+      VLOG(1) << "Fetched blob '" << blobSum << "' from peer '"
+              << peer.host() << ":" << peer.port() << "'";
+
+      return Nothing();
+    })
+    .onAny([temp]() {
+      Try<Nothing> rmdir = os::rmdir(temp.get());
+      if (rmdir.isError()) {
+        LOG(WARNING) << "Failed to remove '" << temp.get() << "': "
+                     << rmdir.error();
+      }
+    });
 }
 
 } // namespace docker {
@@ -141,6 +141,7 @@ Try<Owned<slave::Store>> Store::create(
   // TODO(dpravat): Remove after resolving MESOS-5473.
 #ifndef __WINDOWS__
   _flags.docker_config = flags.docker_config;
+  _flags.docker_in_process_requests = flags.docker_in_process_requests;
 #endif
 
   Try<Owned<uri::Fetcher>> fetcher = uri::fetcher::create(_flags);
@@ -186,6 +187,14 @@ Try<Owned<slave::Store>> Store::create(
                  mkdir.error());
   }
 
+  if (flags.docker_layer_peers.isSome()) {
+    mkdir = os::mkdir(paths::getBlobsDir(flags.docker_store_dir));
+    if (mkdir.isError()) {
+      return Error("Failed to create Docker store blobs directory: " +
+                   mkdir.error());
+    }
+  }
+
   Try<Owned<MetadataManager>> metadataManager = MetadataManager::create(flags);
   if (metadataManager.isError()) {
     return Error(metadataManager.error());
@@ -306,8 +315,15 @@ Future<Image> StoreProcess::_get(
   }
 
   // If there is already a pulling going on for the given 'name', we
-  // will skip the additional pulling.
-  const string name = stringify(reference);
+  // will skip the additional pulling. The name is taken without the
+  // default tag so that, e.g., 'busybox' and 'busybox:latest' share
+  // the same pulling when many containers launch from an image.
+  spec::ImageReference normalized = reference;
+  if (!normalized.has_digest() && !normalized.has_tag()) {
+    normalized.set_tag("latest");
+  }
+
+  const string name = stringify(normalized);
 
   if (!pulling.contains(name)) {
     Try<string> staging =
@@ -349,7 +365,21 @@ Future<Image> StoreProcess::_get(
     return promise->future();
   }
 
-  return pulling[name]->future();
+  // The image might be pulled under a different reference than the
+  // one asked for, which is recorded too so that the next lookup for
+  // this reference finds the image in the cache.
+  return pulling[name]->future()
+    .then(defer(self(), [=](const Image& pulled) -> Future<Image> {
+      if (stringify(pulled.reference()) == stringify(reference)) {
+        return pulled;
+      }
+
+      return metadataManager->put(
+          reference,
+          vector<string>(
+              pulled.layer_ids().begin(),
+              pulled.layer_ids().end()));
+    }));
 }
 
 
@@ -558,6 +588,31 @@ Future<Nothing> StoreProcess::_prune(
     }
   }
 
+  // The layer tar balls kept for peer agents are not tracked per image,
+  // instead they are all removed along with the unused layers.
+  if (flags.docker_layer_peers.isSome()) {
+    const string blobsDir = paths::getBlobsDir(flags.docker_store_dir);
+    const string target =
+      paths::getGcLayerPath(flags.docker_store_dir, "blobs");
+
+    VLOG(1) << "Marking blobs to gc by renaming '" << blobsDir << "' to '"
+            << target << "'";
+
+    Try<Nothing> rename = os::rename(blobsDir, target);
+    if (rename.isError()) {
+      return Failure(
+          "Failed to move blobs from '" + blobsDir +
+          "' to '" + target + "': " + rename.error());
+    }
+
+    Try<Nothing> mkdir = os::mkdir(blobsDir);
+    if (mkdir.isError()) {
+      return Failure(
+          "Failed to create blobs directory '" + blobsDir + "': " +
+          mkdir.error());
+    }
+  }
+
   const string gcDir = paths::getGcDir(flags.docker_store_dir);
   auto rmdirs = [gcDir]() {
     Try<list<string>> targets = os::ls(gcDir);
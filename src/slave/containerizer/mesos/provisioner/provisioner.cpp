@@ -35,6 +35,7 @@
 #include <stout/lambda.hpp>
 #include <stout/os.hpp>
 #include <stout/stringify.hpp>
+#include <stout/strings.hpp>
 #include <stout/uuid.hpp>
 
 #include <stout/os/realpath.hpp>
@@ -61,6 +62,8 @@ using process::Future;
 using process::Owned;
 using process::ReadWriteLock;
 
+using process::metrics::Timer;
+
 using mesos::internal::slave::AUFS_BACKEND;
 using mesos::internal::slave::BIND_BACKEND;
 using mesos::internal::slave::COPY_BACKEND;
@@ -373,7 +376,8 @@ ProvisionerProcess::ProvisionerProcess(
     rootDir(_rootDir),
     defaultBackend(_defaultBackend),
     stores(_stores),
-    backends(_backends) {}
+    backends(_backends),
+    metrics(_stores, _backends) {}
 
 
 Future<Nothing> ProvisionerProcess::recover(
@@ -512,7 +516,8 @@ Future<ProvisionInfo> ProvisionerProcess::provision(
       }
 
       // Get and then provision image layers from the store.
-      return stores.get(image.type()).get()->get(image, defaultBackend)
+      return metrics.store_get.at(image.type()).time(
+          stores.get(image.type()).get()->get(image, defaultBackend))
         .then(defer(
             self(),
             &Self::_provision,
@@ -561,10 +566,11 @@ Future<ProvisionInfo> ProvisionerProcess::_provision(
       containerId,
       backend);
 
-  return backends.get(backend).get()->provision(
-      imageInfo.layers,
-      rootfs,
-      backendDir)
+  return metrics.backend_provision.at(backend).time(
+      backends.get(backend).get()->provision(
+          imageInfo.layers,
+          rootfs,
+          backendDir))
     .then([=]() -> Future<ProvisionInfo> {
       const string path =
         provisioner::paths::getLayersFilePath(rootDir, containerId);
@@ -784,17 +790,46 @@ Future<Nothing> ProvisionerProcess::pruneImages(
 }
 
 
-ProvisionerProcess::Metrics::Metrics()
+ProvisionerProcess::Metrics::Metrics(
+    const hashmap<Image::Type, Owned<Store>>& stores,
+    const hashmap<string, Owned<Backend>>& backends)
   : remove_container_errors(
       "containerizer/mesos/provisioner/remove_container_errors")
 {
   process::metrics::add(remove_container_errors);
+
+  foreachkey (Image::Type type, stores) {
+    Timer<Milliseconds> timer(
+        "containerizer/mesos/provisioner/stores/" +
+        strings::lower(Image::Type_Name(type)) + "/get",
+        Days(1));
+
+    process::metrics::add(timer);
+    store_get.put(type, timer);
+  }
+
+  foreachkey (const string& backend, backends) {
+    Timer<Milliseconds> timer(
+        "containerizer/mesos/provisioner/backends/" + backend + "/provision",
+        Days(1));
+
+    process::metrics::add(timer);
+    backend_provision.put(backend, timer);
+  }
 }
 
 
 ProvisionerProcess::Metrics::~Metrics()
 {
   process::metrics::remove(remove_container_errors);
+
+  foreachvalue (const Timer<Milliseconds>& timer, store_get) {
+    process::metrics::remove(timer);
+  }
+
+  foreachvalue (const Timer<Milliseconds>& timer, backend_provision) {
+    process::metrics::remove(timer);
+  }
 }
 
 } // namespace slave {
@@ -38,6 +38,7 @@
 
 #include <process/metrics/counter.hpp>
 #include <process/metrics/metrics.hpp>
+#include <process/metrics/timer.hpp>
 
 #include "slave/flags.hpp"
 
@@ -191,10 +192,19 @@ private:
 
   struct Metrics
   {
-    Metrics();
+    Metrics(
+        const hashmap<Image::Type, process::Owned<Store>>& stores,
+        const hashmap<std::string, process::Owned<Backend>>& backends);
+
     ~Metrics();
 
     process::metrics::Counter remove_container_errors;
+
+    // The time it takes each store to get an image and each backend
+    // to provision a container rootfs from its layers.
+    hashmap<Image::Type, process::metrics::Timer<Milliseconds>> store_get;
+    hashmap<std::string, process::metrics::Timer<Milliseconds>>
+      backend_provision;
   } metrics;
 
   // This `ReadWriteLock` instance is used to protect the critical
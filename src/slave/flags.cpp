@@ -154,6 +154,25 @@ mesos::internal::slave::Flags::Flags()
       "Strategy for provisioning container rootfs from images,\n"
       "e.g., `aufs`, `bind`, `copy`, `overlay`.");
 
+  add(&Flags::image_provisioner_flatten_threshold,
+      "image_provisioner_flatten_threshold",
+      "The maximum number of image layers that the `overlay` provisioner\n"
+      "backend stacks for a container rootfs. The lowest layers of deeper\n"
+      "images get merged into a single flattened layer in the background\n"
+      "the first time such an image is provisioned, and the rootfses\n"
+      "provisioned from the same layers afterwards use the flattened\n"
+      "layer. Flattened layers are kept in the provisioner directory and\n"
+      "removed once any of their layers gets removed from the image store.\n"
+      "By default, all the layers are stacked.",
+      [](const Option<size_t>& value) -> Option<Error> {
+        if (value.isSome() && value.get() == 0) {
+          return Error(
+              "Expected `--image_provisioner_flatten_threshold` to be "
+              "positive");
+        }
+        return None();
+      });
+
   add(&Flags::image_gc_config,
       "image_gc_config",
       "JSON-formatted configuration for automatic container image garbage\n"
@@ -173,7 +192,10 @@ mesos::internal::slave::Flags::Flags()
       "  \"image_disk_watch_interval\": {\n"
       "    \"nanoseconds\": 3600\n"
       "  },\n"
-      "  \"excluded_images\": []\n"
+      "  \"excluded_images\": [],\n"
+      "  \"image_retention_period\": {\n"
+      "    \"nanoseconds\": 86400000000000\n"
+      "  }\n"
       "}");
 
   add(&Flags::appc_simple_discovery_uri_prefix,
@@ -207,6 +229,44 @@ mesos::internal::slave::Flags::Flags()
       "volumes that each container uses.",
       "/var/run/mesos/isolators/docker/volume");
 
+  add(&Flags::max_concurrent_docker_layer_downloads,
+      "max_concurrent_docker_layer_downloads",
+      "The maximum number of image layers that the Docker provisioner\n"
+      "downloads from registries at a time, across all images being\n"
+      "pulled. Each layer is extracted as soon as it is downloaded.\n"
+      "By default, there is no limit.",
+      [](const Option<size_t>& value) -> Option<Error> {
+        if (value.isSome() && value.get() == 0) {
+          return Error(
+              "Expected `--max_concurrent_docker_layer_downloads` to be "
+              "positive");
+        }
+        return None();
+      });
+
+  add(&Flags::docker_layer_peers,
+      "docker_layer_peers",
+      "Comma-separated list of peer agents (`host:port`) from which the\n"
+      "Docker provisioner first tries to fetch image layers before falling\n"
+      "back to the registry, e.g., `10.0.0.1:5051,10.0.0.2:5051`. If set,\n"
+      "the agent also keeps the layer tar balls it has downloaded in the\n"
+      "Docker store, until the next image garbage collection, and serves\n"
+      "them to its peers via the `/files/download` endpoint. Layers fetched\n"
+      "from peers are verified against their digest. Please note that the\n"
+      "layers get served without checking the registry credentials, so\n"
+      "this should only be enabled among agents allowed to run the same\n"
+      "images.");
+
+  add(&Flags::docker_in_process_requests,
+      "docker_in_process_requests",
+      "Whether the Docker provisioner should send the HTTP requests for\n"
+      "image manifests and registry auth tokens from within the agent,\n"
+      "rather than by launching a `curl` process for each of them. HTTPS\n"
+      "requests are only sent from within the agent if it is built with\n"
+      "SSL support, and none are if a proxy is configured through\n"
+      "the environment. Image layers are always downloaded with `curl`.",
+      false);
+
   add(&Flags::default_role,
       "default_role",
       "Any resources in the `--resources` flag that\n"
@@ -329,6 +389,17 @@ mesos::internal::slave::Flags::Flags()
       "etc) up to a maximum of " + stringify(REGISTER_RETRY_INTERVAL_MAX),
       DEFAULT_REGISTRATION_BACKOFF_FACTOR);
 
+  add(&Flags::reregistration_digests,
+      "reregistration_digests",
+      "Whether the agent re-registers with digests of the tasks and\n"
+      "executors of its frameworks rather than the tasks and executors\n"
+      "themselves, if the master has the `AGENT_REREGISTRATION_DIGESTS`\n"
+      "capability. The master asks for the tasks and executors of the\n"
+      "frameworks whose digests do not match its own view of the agent,\n"
+      "or for all of them if it does not know about the agent's tasks\n"
+      "(e.g., after a master failover), which takes another round trip.",
+      false);
+
   add(&Flags::authentication_backoff_factor,
       "authentication_backoff_factor",
       "After a failed authentication the agent picks a random amount of time\n"
@@ -504,12 +575,45 @@ mesos::internal::slave::Flags::Flags()
       "state as possible is recovered.\n",
       true);
 
+  add(&Flags::meta_journal,
+      "meta_journal",
+      "Whether to also journal the files checkpointed under the agent's\n"
+      "meta directory to a single append-only file, which is read in one\n"
+      "sequential pass during recovery rather than opening every file.\n"
+      "This speeds up the restart of agents running many tasks. The\n"
+      "journal is built from the checkpointed files the first time the\n"
+      "agent recovers with it enabled, and is removed if the agent is\n"
+      "restarted with it disabled.",
+      false);
+
   add(&Flags::max_completed_executors_per_framework,
       "max_completed_executors_per_framework",
       "Maximum number of completed executors per framework to store\n"
       "in memory.\n",
       DEFAULT_MAX_COMPLETED_EXECUTORS_PER_FRAMEWORK);
 
+  add(&Flags::status_update_flush_interval,
+      "status_update_flush_interval",
+      "Maximum amount of time for which the agent holds on to status\n"
+      "updates in order to forward them to the master in batches of up\n"
+      "to `--max_status_update_batch_size` updates. Only applies to\n"
+      "masters with the `STATUS_UPDATE_BATCHES` capability. By default,\n"
+      "status updates are forwarded right away, one by one.",
+      Duration::zero());
+
+  add(&Flags::max_status_update_batch_size,
+      "max_status_update_batch_size",
+      "Maximum number of status updates that the agent forwards to the\n"
+      "master in a single batch (see `--status_update_flush_interval`).",
+      DEFAULT_MAX_STATUS_UPDATE_BATCH_SIZE,
+      [](size_t value) -> Option<Error> {
+        if (value == 0) {
+          return Error(
+              "Expected `--max_status_update_batch_size` to be positive");
+        }
+        return None();
+      });
+
 #ifdef __linux__
   add(&Flags::cgroups_hierarchy,
       "cgroups_hierarchy",
@@ -539,6 +643,17 @@ mesos::internal::slave::Flags::Flags()
       "inside a container.\n",
       false);
 
+  add(&Flags::cgroups_cpuset_exclusive_cpus,
+      "cgroups_cpuset_exclusive_cpus",
+      "Whether to assign CPUs exclusively to the containers allocated a\n"
+      "whole number of non-revocable CPUs (including the resources of\n"
+      "their executor), the other containers share the remaining CPUs.\n"
+      "The CPUs are chosen based on the CPU topology: whole cores from a\n"
+      "single NUMA node are preferred, and the memory of the containers\n"
+      "is allocated from the NUMA nodes of their CPUs. This requires the\n"
+      "`cgroups/cpuset` isolator.",
+      false);
+
   add(&Flags::cgroups_net_cls_primary_handle,
       "cgroups_net_cls_primary_handle",
       "A non-zero, 16-bit handle of the form `0xAAAA`. This will be \n"
@@ -628,6 +743,17 @@ mesos::internal::slave::Flags::Flags()
       "than the `perf_interval`.",
       Seconds(10));
 
+  add(&Flags::perf_continuous,
+      "perf_continuous",
+      "Whether to count the perf events of each container continuously,\n"
+      "with counters kept open by the agent (see perf_event_open(2)),\n"
+      "rather than sampling them with `perf stat` for `perf_duration`\n"
+      "every `perf_interval`. The counters are read when the usage of\n"
+      "the container is collected, and the reported counts accumulate\n"
+      "from the start of the container. This does not need the perf\n"
+      "binary, but does not support raw hardware events.",
+      false);
+
   add(&Flags::revocable_cpu_low_priority,
       "revocable_cpu_low_priority",
       "Run containers with revocable CPU at a lower priority than\n"
@@ -845,6 +971,16 @@ mesos::internal::slave::Flags::Flags()
       "  }\n"
       "}");
 
+  add(&Flags::docker_engine_api,
+      "docker_engine_api",
+      "Whether the agent should query the Docker daemon through the Docker\n"
+      "Engine API over `--docker_socket` rather than by running the Docker\n"
+      "CLI, for the operations that support it. Currently only inspecting\n"
+      "containers is supported, which the agent does for every container\n"
+      "on recovery and when collecting resource usage. This avoids running\n"
+      "a `docker inspect` process each time. Not supported on Windows.",
+      false);
+
   add(&Flags::sandbox_directory,
       "sandbox_directory",
       "The absolute path for the directory in the container where the\n"
@@ -1076,6 +1212,15 @@ mesos::internal::slave::Flags::Flags()
       "isolator.",
       false);
 
+  add(&Flags::network_statistics_cache_interval,
+      "network_statistics_cache_interval",
+      "The amount of time for which the statistics collected from inside\n"
+      "each container (e.g., socket and SNMP statistics) are reused by the\n"
+      "'network/port_mapping' isolator, rather than running a helper\n"
+      "process in the network namespace of the container each time its\n"
+      "usage is queried.",
+      Seconds(0));
+
 #endif // ENABLE_PORT_MAPPING_ISOLATOR
 
 #ifdef ENABLE_NETWORK_PORTS_ISOLATOR
@@ -1108,12 +1253,55 @@ mesos::internal::slave::Flags::Flags()
       "the operator should install a network configuration file in JSON\n"
       "format in the specified directory.");
 
+  add(&Flags::network_cni_max_concurrent_plugins,
+      "network_cni_max_concurrent_plugins",
+      "The maximum number of CNI plugins that the `network/cni` isolator\n"
+      "runs at a time, across all the containers and networks being\n"
+      "attached or detached. By default, there is no limit.",
+      [](const Option<size_t>& value) -> Option<Error> {
+        if (value.isSome() && value.get() == 0) {
+          return Error(
+              "Expected `--network_cni_max_concurrent_plugins` to be "
+              "positive");
+        }
+        return None();
+      });
+
   add(&Flags::container_disk_watch_interval,
       "container_disk_watch_interval",
       "The interval between disk quota checks for containers. This flag is\n"
-      "used for the `disk/du` isolator.",
+      "used for the `disk/du` isolator, and by the `disk/xfs` isolator\n"
+      "to reuse the project quotas reported for all containers at once.",
       Seconds(15));
 
+  add(&Flags::container_disk_watch_in_process,
+      "container_disk_watch_in_process",
+      "Whether the `disk/du` isolator collects the disk usage of containers\n"
+      "by walking their directories on a separate thread of the agent,\n"
+      "rather than by forking a `du` process for every check. The reported\n"
+      "usage is the same.",
+      false);
+
+  add(&Flags::container_usage_cache_ttl,
+      "container_usage_cache_ttl",
+      "How long the agent reuses the resource statistics of a container,\n"
+      "e.g., when serving the `/monitor/statistics` endpoint and the\n"
+      "`GET_CONTAINERS` call, before collecting them from the\n"
+      "containerizer again. Concurrent requests within this duration share\n"
+      "a single collection. A zero duration disables the cache.",
+      Seconds(0));
+
+  add(&Flags::state_cache_max_staleness,
+      "state_cache_max_staleness",
+      "Maximum amount of time for which a rendering of the state of the\n"
+      "agent (i.e., the `/state` endpoint and the `GET_STATE`,\n"
+      "`GET_FRAMEWORKS`, `GET_EXECUTORS` and `GET_TASKS` calls) is served\n"
+      "to later requests of the same principal, even though the state of\n"
+      "the agent might have changed in the meantime. Renderings are always\n"
+      "shared by concurrent requests, and by later requests as long as the\n"
+      "agent has not changed.",
+      Duration::zero());
+
   // TODO(jieyu): Consider enabling this flag by default. Remember
   // to update the user doc if we decide to do so.
   add(&Flags::enforce_container_disk_quota,
@@ -1255,6 +1443,14 @@ mesos::internal::slave::Flags::Flags()
       "the default behavior is to resolve value-based secrets and error on\n"
       "reference-based secrets.");
 
+  add(&Flags::secret_resolver_cache_ttl,
+      "secret_resolver_cache_ttl",
+      "How long the secrets resolved by the `--secret_resolver` module are\n"
+      "cached for, e.g., to reuse them for the other tasks needing the same\n"
+      "secret reference. If this flag is not specified, secrets are not\n"
+      "cached, but concurrent resolutions of the same reference still share\n"
+      "a single call to the module.");
+
   add(&Flags::resource_estimator,
       "resource_estimator",
       "The name of the resource estimator to use for oversubscription.");
@@ -1302,6 +1498,14 @@ mesos::internal::slave::Flags::Flags()
       "production yet.",
       false);
 
+  add(&Flags::persistent_command_checks,
+      "persistent_command_checks",
+      "Whether the default executor should run the command checks and\n"
+      "health checks of a task in one long-lived nested container, rather\n"
+      "than launching a new nested container for every check. The check\n"
+      "commands are then run by `/bin/sh` in the task's container.",
+      false);
+
   add(&Flags::ip,
       "ip",
       "IP address to listen on. This cannot be used in conjunction\n"
@@ -51,6 +51,7 @@ public:
 
   Option<std::string> image_providers;
   Option<std::string> image_provisioner_backend;
+  Option<size_t> image_provisioner_flatten_threshold;
   Option<ImageGcConfig> image_gc_config;
 
   std::string appc_simple_discovery_uri_prefix;
@@ -59,6 +60,9 @@ public:
   std::string docker_registry;
   std::string docker_store_dir;
   std::string docker_volume_checkpoint_dir;
+  Option<size_t> max_concurrent_docker_layer_downloads;
+  Option<std::string> docker_layer_peers;
+  bool docker_in_process_requests;
 
   std::string default_role;
   Option<std::string> attributes;
@@ -69,6 +73,8 @@ public:
   std::string launcher_dir;
   std::string hadoop_home; // TODO(benh): Make an Option.
   size_t max_completed_executors_per_framework;
+  Duration status_update_flush_interval;
+  size_t max_status_update_batch_size;
 
 #ifndef __WINDOWS__
   bool switch_user;
@@ -76,6 +82,7 @@ public:
   Duration http_heartbeat_interval;
   std::string frameworks_home;  // TODO(benh): Make an Option.
   Duration registration_backoff_factor;
+  bool reregistration_digests;
   Duration authentication_backoff_factor;
   Option<JSON::Object> executor_environment_variables;
   Duration executor_registration_timeout;
@@ -95,6 +102,7 @@ public:
   std::string recover;
   Duration recovery_timeout;
   bool strict;
+  bool meta_journal;
   Duration register_retry_interval_min;
 #ifdef __linux__
   std::string cgroups_hierarchy;
@@ -102,6 +110,7 @@ public:
   bool cgroups_enable_cfs;
   bool cgroups_limit_swap;
   bool cgroups_cpu_enable_pids_and_tids_count;
+  bool cgroups_cpuset_exclusive_cpus;
   Option<std::string> cgroups_net_cls_primary_handle;
   Option<std::string> cgroups_net_cls_secondary_handles;
   Option<DeviceWhitelist> allowed_devices;
@@ -110,6 +119,7 @@ public:
   Option<std::string> perf_events;
   Duration perf_interval;
   Duration perf_duration;
+  bool perf_continuous;
   bool revocable_cpu_low_priority;
   bool systemd_enable_support;
   std::string systemd_runtime_directory;
@@ -134,6 +144,7 @@ public:
   bool docker_kill_orphans;
   std::string docker_socket;
   Option<JSON::Object> docker_config;
+  bool docker_engine_api;
 
 #ifdef ENABLE_PORT_MAPPING_ISOLATOR
   uint16_t ephemeral_ports_per_container;
@@ -145,6 +156,7 @@ public:
   bool network_enable_socket_statistics_summary;
   bool network_enable_socket_statistics_details;
   bool network_enable_snmp_statistics;
+  Duration network_statistics_cache_interval;
 #endif // ENABLE_PORT_MAPPING_ISOLATOR
 
 #ifdef ENABLE_NETWORK_PORTS_ISOLATOR
@@ -154,7 +166,11 @@ public:
 
   Option<std::string> network_cni_plugins_dir;
   Option<std::string> network_cni_config_dir;
+  Option<size_t> network_cni_max_concurrent_plugins;
   Duration container_disk_watch_interval;
+  bool container_disk_watch_in_process;
+  Duration container_usage_cache_ttl;
+  Duration state_cache_max_staleness;
   bool enforce_container_disk_quota;
   Option<Modules> modules;
   Option<std::string> modulesDir;
@@ -169,6 +185,7 @@ public:
   Option<Path> http_credentials;
   Option<std::string> hooks;
   Option<std::string> secret_resolver;
+  Option<Duration> secret_resolver_cache_ttl;
   Option<std::string> resource_estimator;
   Option<std::string> qos_controller;
   Duration qos_correction_interval_min;
@@ -178,6 +195,7 @@ public:
   std::string xfs_project_range;
 #endif
   bool http_command_executor;
+  bool persistent_command_checks;
   Option<SlaveCapabilities> agent_features;
   Option<DomainInfo> domain;
 
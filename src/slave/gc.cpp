@@ -27,12 +27,19 @@
 
 #include <stout/foreach.hpp>
 #include <stout/lambda.hpp>
+#include <stout/path.hpp>
+#include <stout/uuid.hpp>
 
+#include <stout/os/exists.hpp>
+#include <stout/os/ls.hpp>
+#include <stout/os/mkdir.hpp>
+#include <stout/os/rename.hpp>
 #include <stout/os/rmdir.hpp>
 
 #include "logging/logging.hpp"
 
 #include "slave/gc_process.hpp"
+#include "slave/paths.hpp"
 
 using namespace process;
 
@@ -83,6 +90,37 @@ GarbageCollectorProcess::~GarbageCollectorProcess()
 }
 
 
+void GarbageCollectorProcess::initialize()
+{
+  if (trashDir.isNone()) {
+    return;
+  }
+
+  Try<Nothing> mkdir = os::mkdir(trashDir.get());
+  if (mkdir.isError()) {
+    LOG(WARNING) << "Failed to create trash directory '" << trashDir.get()
+                 << "': " << mkdir.error() << "; deleting paths in place";
+    return;
+  }
+
+  // Delete whatever was left in the trash, e.g., by an agent that got
+  // restarted while emptying it.
+  Try<list<string>> entries = os::ls(trashDir.get());
+  if (entries.isError()) {
+    LOG(WARNING) << "Failed to list trash directory '" << trashDir.get()
+                 << "': " << entries.error();
+    return;
+  }
+
+  list<string> trash;
+  foreach (const string& entry, entries.get()) {
+    trash.push_back(path::join(trashDir.get(), entry));
+  }
+
+  emptyTrash(trash);
+}
+
+
 Future<Nothing> GarbageCollectorProcess::schedule(
     const Duration& d,
     const string& path)
@@ -194,12 +232,43 @@ void GarbageCollectorProcess::remove(const Timeout& removalTime)
     Counter _succeeded = metrics.path_removals_succeeded;
     Counter _failed = metrics.path_removals_failed;
 
-    auto rmdirs = [_succeeded, _failed, infos]() {
+    // The trash directory is only usable if `initialize` created it.
+    Option<string> trashDir_ = None();
+    if (trashDir.isSome() && os::exists(trashDir.get())) {
+      trashDir_ = trashDir;
+    }
+
+    auto rmdirs = [_succeeded, _failed, infos, trashDir_]() {
       // Make mutable copies of the counters to work around MESOS-7907.
       Counter succeeded = _succeeded;
       Counter failed = _failed;
 
+      list<string> trash;
+
       foreach (const Owned<PathInfo>& info, infos) {
+        // Moving the path into the trash directory removes it at once
+        // if it is on the same filesystem, otherwise (or if it is a
+        // mount point) we fall back to deleting it in place.
+        if (trashDir_.isSome() && os::exists(info->path)) {
+          const string target =
+            path::join(trashDir_.get(), id::UUID::random().toString());
+
+          Try<Nothing> rename = os::rename(info->path, target);
+          if (rename.isSome()) {
+            LOG(INFO) << "Moved '" << info->path << "' to '" << target
+                      << "' for deletion";
+            info->promise.set(Nothing());
+
+            ++succeeded;
+
+            trash.push_back(target);
+            continue;
+          }
+
+          VLOG(1) << "Failed to move '" << info->path << "' to '" << target
+                  << "': " << rename.error();
+        }
+
         // Run the removal operation with 'continueOnError = true'.
         // It's possible for tasks and isolators to lay down files
         // that are not deletable by GC. In the face of such errors
@@ -222,7 +291,7 @@ void GarbageCollectorProcess::remove(const Timeout& removalTime)
         }
       }
 
-      return Nothing();
+      return trash;
     };
 
     // NOTE: All `rmdirs` calls are dispatched to one executor so that:
@@ -241,7 +310,7 @@ void GarbageCollectorProcess::remove(const Timeout& removalTime)
 }
 
 
-void  GarbageCollectorProcess::_remove(const Future<Nothing>& result,
+void  GarbageCollectorProcess::_remove(const Future<list<string>>& result,
                                        const list<Owned<PathInfo>> infos)
 {
   CHECK_READY(result);
@@ -252,10 +321,38 @@ void  GarbageCollectorProcess::_remove(const Future<Nothing>& result,
     CHECK_EQ(timeouts.erase(info->path), 1u);
   }
 
+  emptyTrash(result.get());
+
   reset();
 }
 
 
+void GarbageCollectorProcess::emptyTrash(const list<string>& trash)
+{
+  if (trash.empty()) {
+    return;
+  }
+
+  // NOTE: The paths in the trash are deleted on another executor than
+  // the one moving paths into the trash, so that deleting them does
+  // not delay the removal of the paths scheduled after them.
+  trashExecutor.execute([trash]() {
+    foreach (const string& path, trash) {
+      Try<Nothing> rmdir = os::rmdir(path, true, true, true);
+
+      if (rmdir.isError()) {
+        LOG(WARNING) << "Failed to delete '" << path << "': "
+                     << rmdir.error();
+      } else {
+        VLOG(1) << "Deleted '" << path << "'";
+      }
+    }
+
+    return Nothing();
+  });
+}
+
+
 void GarbageCollectorProcess::prune(const Duration& d)
 {
   foreach (const Timeout& removalTime, paths.keys()) {
@@ -268,9 +365,14 @@ void GarbageCollectorProcess::prune(const Duration& d)
 }
 
 
-GarbageCollector::GarbageCollector()
+GarbageCollector::GarbageCollector(const Option<string>& workDir)
 {
-  process = new GarbageCollectorProcess();
+  Option<string> trashDir = None();
+  if (workDir.isSome()) {
+    trashDir = paths::getGcTrashDir(workDir.get());
+  }
+
+  process = new GarbageCollectorProcess(trashDir);
   spawn(process);
 }
 
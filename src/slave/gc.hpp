@@ -23,7 +23,9 @@
 #include <process/future.hpp>
 
 #include <stout/duration.hpp>
+#include <stout/none.hpp>
 #include <stout/nothing.hpp>
+#include <stout/option.hpp>
 
 namespace mesos {
 namespace internal {
@@ -42,7 +44,10 @@ class GarbageCollectorProcess;
 class GarbageCollector
 {
 public:
-  GarbageCollector();
+  // If a work directory is given, paths on the same filesystem are
+  // removed by moving them into a trash directory in it first, see
+  // `paths::getGcTrashDir()`.
+  explicit GarbageCollector(const Option<std::string>& workDir = None());
   virtual ~GarbageCollector();
 
   // Schedules the specified path for removal after the specified
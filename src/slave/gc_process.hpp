@@ -35,6 +35,7 @@
 #include <stout/hashmap.hpp>
 #include <stout/multimap.hpp>
 #include <stout/nothing.hpp>
+#include <stout/option.hpp>
 #include <stout/try.hpp>
 
 namespace mesos {
@@ -45,9 +46,11 @@ class GarbageCollectorProcess :
     public process::Process<GarbageCollectorProcess>
 {
 public:
-  GarbageCollectorProcess()
+  explicit GarbageCollectorProcess(
+      const Option<std::string>& _trashDir = None())
     : ProcessBase(process::ID::generate("agent-garbage-collector")),
-      metrics(this) {}
+      metrics(this),
+      trashDir(_trashDir) {}
 
   virtual ~GarbageCollectorProcess();
 
@@ -59,6 +62,9 @@ public:
 
   void prune(const Duration& d);
 
+protected:
+  virtual void initialize();
+
 private:
   void reset();
 
@@ -82,11 +88,15 @@ private:
     bool removing = false;
   };
 
-  // Callback for `remove` for bookkeeping after path removal.
+  // Callback for `remove` for bookkeeping after path removal. The
+  // result contains the paths moved into the trash directory.
   void _remove(
-      const process::Future<Nothing>& result,
+      const process::Future<std::list<std::string>>& result,
       const std::list<process::Owned<PathInfo>> infos);
 
+  // Deletes the given paths in the trash directory.
+  void emptyTrash(const std::list<std::string>& trash);
+
   struct Metrics
   {
     explicit Metrics(GarbageCollectorProcess *gc);
@@ -110,6 +120,13 @@ private:
 
   // For executing path removals in a separate actor.
   process::Executor executor;
+
+  // If set, paths are removed by moving them into this directory,
+  // which is fast, and are then deleted in the background by
+  // `trashExecutor`. That way the deletion of a large sandbox does not
+  // hold up the removals scheduled after it.
+  const Option<std::string> trashDir;
+  process::Executor trashExecutor;
 };
 
 } // namespace slave {
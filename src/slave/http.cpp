@@ -37,6 +37,8 @@
 
 #include <mesos/v1/executor/executor.hpp>
 
+#include <process/async.hpp>
+#include <process/clock.hpp>
 #include <process/collect.hpp>
 #include <process/future.hpp>
 #include <process/help.hpp>
@@ -45,6 +47,8 @@
 #include <process/logging.hpp>
 #include <process/loop.hpp>
 #include <process/owned.hpp>
+#include <process/shared.hpp>
+#include <process/time.hpp>
 
 #include <process/metrics/metrics.hpp>
 
@@ -86,6 +90,7 @@ using mesos::slave::ContainerTermination;
 
 using process::AUTHENTICATION;
 using process::AUTHORIZATION;
+using process::async;
 using process::Break;
 using process::Continue;
 using process::ControlFlow;
@@ -97,6 +102,8 @@ using process::HELP;
 using process::Logging;
 using process::loop;
 using process::Owned;
+using process::Shared;
+using process::Time;
 using process::TLDR;
 
 using process::http::Accepted;
@@ -167,6 +174,94 @@ using process::http::Response;
 using process::http::Request;
 
 
+// Returns the termination information of a container in the form
+// returned by the agent API.
+static mesos::agent::Response::WaitContainer createWaitContainer(
+    const ContainerTermination& termination)
+{
+  mesos::agent::Response::WaitContainer waitContainer;
+
+  if (termination.has_status()) {
+    waitContainer.set_exit_status(termination.status());
+  }
+
+  if (termination.has_state()) {
+    waitContainer.set_state(termination.state());
+  }
+
+  if (termination.has_reason()) {
+    waitContainer.set_reason(termination.reason());
+  }
+
+  if (!termination.limited_resources().empty()) {
+    waitContainer.mutable_limitation()->mutable_resources()
+      ->CopyFrom(termination.limited_resources());
+  }
+
+  if (termination.has_message()) {
+    waitContainer.set_message(termination.message());
+  }
+
+  return waitContainer;
+}
+
+
+// Evolves `response` and serializes it in a separate process (see
+// `process::async`) rather than on the agent actor, so that the agent
+// keeps launching tasks and forwarding status updates while big
+// responses (e.g., to `GET_STATE`) are converted and serialized.
+static Future<string> serializeAsync(
+    ContentType contentType,
+    mesos::agent::Response&& response)
+{
+  mesos::agent::Response* _response = new mesos::agent::Response();
+  _response->Swap(&response);
+
+  Shared<mesos::agent::Response> shared(_response);
+
+  return async([contentType, shared]() {
+    return serialize(contentType, evolve(*shared));
+  });
+}
+
+
+// Returns a response with the rendered `json`, optionally wrapped in a
+// JSONP callback.
+static Response respond(const string& json, const Option<string>& jsonp)
+{
+  OK ok;
+  ok.headers["Content-Type"] =
+    jsonp.isSome() ? "text/javascript" : "application/json";
+
+  ok.type = Response::BODY;
+
+  if (jsonp.isSome()) {
+    ok.body = jsonp.get() + "(" + json + ");";
+  } else {
+    ok.body = json;
+  }
+
+  ok.headers["Content-Length"] = stringify(ok.body.size());
+
+  return ok;
+}
+
+
+// Returns the key of the view `name` for the class of `principal`.
+// Without an authorizer every principal is allowed to see the same.
+static string viewKey(
+    const string& name,
+    const Option<Principal>& principal,
+    bool authorized)
+{
+  if (!authorized || principal.isNone()) {
+    return name;
+  }
+
+  return name + " " + stringify(principal.get());
+}
+
+
 // Filtered representation of an Executor. Tasks within this executor
 // are filtered based on whether the user is authorized to view them.
 struct ExecutorWriter
@@ -624,6 +719,12 @@ Future<Response> Http::_api(
 
     case mesos::agent::Call::REMOVE_RESOURCE_PROVIDER_CONFIG:
       return removeResourceProviderConfig(call, principal);
+
+    case mesos::agent::Call::WATCH_NESTED_CONTAINERS:
+      return watchNestedContainers(call, mediaTypes, principal);
+
+    case mesos::agent::Call::LAUNCH_NESTED_CONTAINERS:
+      return launchNestedContainers(call, mediaTypes.accept, principal);
   }
 
   UNREACHABLE();
@@ -710,20 +811,15 @@ Future<Response> Http::executor(
       return BadRequest("Failed to parse body into Call protobuf");
     }
   } else if (contentType.get() == APPLICATION_JSON) {
-    Try<JSON::Value> value = JSON::parse(request.body);
-    if (value.isError()) {
-      return BadRequest("Failed to parse body into JSON: " + value.error());
-    }
-
     Try<v1::executor::Call> parse =
-      ::protobuf::parse<v1::executor::Call>(value.get());
+      ::protobuf::parseJSON<v1::executor::Call>(request.body);
 
     if (parse.isError()) {
-      return BadRequest("Failed to convert JSON into Call protobuf: " +
+      return BadRequest("Failed to parse JSON body into Call protobuf: " +
                         parse.error());
     }
 
-    v1Call = parse.get();
+    v1Call.Swap(&parse.get());
   } else {
     return UnsupportedMediaType(
         string("Expecting 'Content-Type' of ") +
@@ -1265,6 +1361,15 @@ Future<Response> Http::state(
     return ServiceUnavailable("Agent has not finished recovery");
   }
 
+  const Option<string> jsonp = request.url.query.get("jsonp");
+
+  Option<Future<View>> view = cached("/state", principal);
+  if (view.isSome()) {
+    return view->then([jsonp](const View& view) {
+      return respond(view.body, jsonp);
+    });
+  }
+
   // Retrieve `ObjectApprover`s for authorizing frameworks and tasks.
   Future<Owned<ObjectApprover>> frameworksApprover;
   Future<Owned<ObjectApprover>> tasksApprover;
@@ -1297,7 +1402,7 @@ Future<Response> Http::state(
     rolesApprover = Owned<ObjectApprover>(new AcceptingObjectApprover());
   }
 
-  return collect(
+  Future<View> rendering = collect(
       frameworksApprover,
       tasksApprover,
       executorsApprover,
@@ -1305,12 +1410,12 @@ Future<Response> Http::state(
       rolesApprover)
     .then(defer(
         slave->self(),
-        [this, request](const tuple<Owned<ObjectApprover>,
-                                    Owned<ObjectApprover>,
-                                    Owned<ObjectApprover>,
-                                    Owned<ObjectApprover>,
-                                    Owned<ObjectApprover>>& approvers)
-          -> Response {
+        [this](const tuple<Owned<ObjectApprover>,
+                           Owned<ObjectApprover>,
+                           Owned<ObjectApprover>,
+                           Owned<ObjectApprover>,
+                           Owned<ObjectApprover>>& approvers)
+          -> View {
       // This lambda is consumed before the outer lambda
       // returns, hence capture by reference is fine here.
       auto state = [this, &approvers](JSON::ObjectWriter* writer) {
@@ -1495,8 +1600,13 @@ Future<Response> Http::state(
         });
       };
 
-      return OK(jsonify(state), request.url.query.get("jsonp"));
+      return View{jsonify(state), slave->generation, Clock::now()};
     }));
+
+  return cache("/state", principal, rendering)
+    .then([jsonp](const View& view) {
+      return respond(view.body, jsonp);
+    });
 }
 
 
@@ -1509,6 +1619,15 @@ Future<Response> Http::getFrameworks(
 
   LOG(INFO) << "Processing GET_FRAMEWORKS call";
 
+  const string name = "GET_FRAMEWORKS " + stringify(acceptType);
+
+  Option<Future<View>> view = cached(name, principal);
+  if (view.isSome()) {
+    return view->then([acceptType](const View& view) -> Response {
+      return OK(view.body, stringify(acceptType));
+    });
+  }
+
   // Retrieve `ObjectApprover`s for authorizing frameworks.
   Future<Owned<ObjectApprover>> frameworksApprover;
 
@@ -1521,18 +1640,28 @@ Future<Response> Http::getFrameworks(
     frameworksApprover = Owned<ObjectApprover>(new AcceptingObjectApprover());
   }
 
-  return frameworksApprover
+  Future<View> rendering = frameworksApprover
     .then(defer(slave->self(),
         [this, acceptType](const Owned<ObjectApprover>& frameworksApprover)
-          -> Future<Response> {
-          mesos::agent::Response response;
+          -> Future<View> {
+      mesos::agent::Response response;
       response.set_type(mesos::agent::Response::GET_FRAMEWORKS);
       response.mutable_get_frameworks()->CopyFrom(
           _getFrameworks(frameworksApprover));
 
-      return OK(serialize(acceptType, evolve(response)),
-                stringify(acceptType));
+      const uint64_t generation = slave->generation;
+      const Time time = Clock::now();
+
+      return serializeAsync(acceptType, std::move(response))
+        .then([generation, time](const string& body) {
+          return View{body, generation, time};
+        });
     }));
+
+  return cache(name, principal, rendering)
+    .then([acceptType](const View& view) -> Response {
+      return OK(view.body, stringify(acceptType));
+    });
 }
 
 
@@ -1573,6 +1702,15 @@ Future<Response> Http::getExecutors(
 
   LOG(INFO) << "Processing GET_EXECUTORS call";
 
+  const string name = "GET_EXECUTORS " + stringify(acceptType);
+
+  Option<Future<View>> view = cached(name, principal);
+  if (view.isSome()) {
+    return view->then([acceptType](const View& view) -> Response {
+      return OK(view.body, stringify(acceptType));
+    });
+  }
+
   // Retrieve `ObjectApprover`s for authorizing frameworks and executors.
   Future<Owned<ObjectApprover>> frameworksApprover;
   Future<Owned<ObjectApprover>> executorsApprover;
@@ -1589,11 +1727,11 @@ Future<Response> Http::getExecutors(
     executorsApprover = Owned<ObjectApprover>(new AcceptingObjectApprover());
   }
 
-  return collect(frameworksApprover, executorsApprover)
+  Future<View> rendering = collect(frameworksApprover, executorsApprover)
     .then(defer(slave->self(),
         [this, acceptType](const tuple<Owned<ObjectApprover>,
                                         Owned<ObjectApprover>>& approvers)
-          -> Future<Response> {
+          -> Future<View> {
       // Get approver from tuple.
       Owned<ObjectApprover> frameworksApprover;
       Owned<ObjectApprover> executorsApprover;
@@ -1605,9 +1743,19 @@ Future<Response> Http::getExecutors(
       response.mutable_get_executors()->CopyFrom(
           _getExecutors(frameworksApprover, executorsApprover));
 
-      return OK(serialize(acceptType, evolve(response)),
-                stringify(acceptType));
+      const uint64_t generation = slave->generation;
+      const Time time = Clock::now();
+
+      return serializeAsync(acceptType, std::move(response))
+        .then([generation, time](const string& body) {
+          return View{body, generation, time};
+        });
     }));
+
+  return cache(name, principal, rendering)
+    .then([acceptType](const View& view) -> Response {
+      return OK(view.body, stringify(acceptType));
+    });
 }
 
 
@@ -1676,6 +1824,15 @@ Future<Response> Http::getTasks(
 
   LOG(INFO) << "Processing GET_TASKS call";
 
+  const string name = "GET_TASKS " + stringify(acceptType);
+
+  Option<Future<View>> view = cached(name, principal);
+  if (view.isSome()) {
+    return view->then([acceptType](const View& view) -> Response {
+      return OK(view.body, stringify(acceptType));
+    });
+  }
+
   // Retrieve Approvers for authorizing frameworks and tasks.
   Future<Owned<ObjectApprover>> frameworksApprover;
   Future<Owned<ObjectApprover>> tasksApprover;
@@ -1697,12 +1854,13 @@ Future<Response> Http::getTasks(
     executorsApprover = Owned<ObjectApprover>(new AcceptingObjectApprover());
   }
 
-  return collect(frameworksApprover, tasksApprover, executorsApprover)
+  Future<View> rendering = collect(
+      frameworksApprover, tasksApprover, executorsApprover)
     .then(defer(slave->self(),
-      [this, acceptType](const tuple<Owned<ObjectApprover>,
-                                      Owned<ObjectApprover>,
-                                      Owned<ObjectApprover>>& approvers)
-        -> Future<Response> {
+        [this, acceptType](const tuple<Owned<ObjectApprover>,
+                                        Owned<ObjectApprover>,
+                                        Owned<ObjectApprover>>& approvers)
+          -> Future<View> {
       // Get approver from tuple.
       Owned<ObjectApprover> frameworksApprover;
       Owned<ObjectApprover> tasksApprover;
@@ -1717,9 +1875,19 @@ Future<Response> Http::getTasks(
                     tasksApprover,
                     executorsApprover));
 
-      return OK(serialize(acceptType, evolve(response)),
-                stringify(acceptType));
-  }));
+      const uint64_t generation = slave->generation;
+      const Time time = Clock::now();
+
+      return serializeAsync(acceptType, std::move(response))
+        .then([generation, time](const string& body) {
+          return View{body, generation, time};
+        });
+    }));
+
+  return cache(name, principal, rendering)
+    .then([acceptType](const View& view) -> Response {
+      return OK(view.body, stringify(acceptType));
+    });
 }
 
 
@@ -1906,6 +2074,15 @@ Future<Response> Http::getState(
 
   LOG(INFO) << "Processing GET_STATE call";
 
+  const string name = "GET_STATE " + stringify(acceptType);
+
+  Option<Future<View>> view = cached(name, principal);
+  if (view.isSome()) {
+    return view->then([acceptType](const View& view) -> Response {
+      return OK(view.body, stringify(acceptType));
+    });
+  }
+
   // Retrieve Approvers for authorizing frameworks and tasks.
   Future<Owned<ObjectApprover>> frameworksApprover;
   Future<Owned<ObjectApprover>> tasksApprover;
@@ -1927,12 +2104,13 @@ Future<Response> Http::getState(
     executorsApprover = Owned<ObjectApprover>(new AcceptingObjectApprover());
   }
 
-  return collect(frameworksApprover, tasksApprover, executorsApprover)
+  Future<View> rendering = collect(
+      frameworksApprover, tasksApprover, executorsApprover)
     .then(defer(slave->self(),
-      [=](const tuple<Owned<ObjectApprover>,
-                      Owned<ObjectApprover>,
-                      Owned<ObjectApprover>>& approvers)
-        -> Future<Response> {
+        [=](const tuple<Owned<ObjectApprover>,
+                        Owned<ObjectApprover>,
+                        Owned<ObjectApprover>>& approvers)
+          -> Future<View> {
       // Get approver from tuple.
       Owned<ObjectApprover> frameworksApprover;
       Owned<ObjectApprover> tasksApprover;
@@ -1946,9 +2124,19 @@ Future<Response> Http::getState(
                     tasksApprover,
                     executorsApprover));
 
-      return OK(serialize(acceptType, evolve(response)),
-                stringify(acceptType));
+      const uint64_t generation = slave->generation;
+      const Time time = Clock::now();
+
+      return serializeAsync(acceptType, std::move(response))
+        .then([generation, time](const string& body) {
+          return View{body, generation, time};
+        });
     }));
+
+  return cache(name, principal, rendering)
+    .then([acceptType](const View& view) -> Response {
+      return OK(view.body, stringify(acceptType));
+    });
 }
 
 
@@ -1972,6 +2160,40 @@ mesos::agent::Response::GetState Http::_getState(
 }
 
 
+Option<Future<Http::View>> Http::cached(
+    const string& name,
+    const Option<Principal>& principal) const
+{
+  const string key = viewKey(name, principal, slave->authorizer.isSome());
+
+  Option<Future<View>> view = views.get(key);
+  if (view.isNone() || view->isPending()) {
+    return view;
+  }
+
+  if (view->isReady() &&
+      (view->get().generation == slave->generation ||
+       Clock::now() - view->get().time <=
+         slave->flags.state_cache_max_staleness)) {
+    return view;
+  }
+
+  views.erase(key);
+
+  return None();
+}
+
+
+Future<Http::View> Http::cache(
+    const string& name,
+    const Option<Principal>& principal,
+    const Future<View>& view) const
+{
+  views[viewKey(name, principal, slave->authorizer.isSome())] = view;
+  return view;
+}
+
+
 string Http::STATISTICS_HELP()
 {
   return HELP(
@@ -2264,7 +2486,7 @@ Future<JSON::Array> Http::__containers(
 
       metadata->push_back(entry);
       statusFutures.push_back(slave->containerizer->status(containerId));
-      statsFutures.push_back(slave->containerizer->usage(containerId));
+      statsFutures.push_back(slave->containerUsage(containerId));
     }
   }
 
@@ -2428,6 +2650,77 @@ Future<Response> Http::launchNestedContainer(
 }
 
 
+Future<Response> Http::launchNestedContainers(
+    const mesos::agent::Call& call,
+    ContentType acceptType,
+    const Option<Principal>& principal) const
+{
+  CHECK_EQ(mesos::agent::Call::LAUNCH_NESTED_CONTAINERS, call.type());
+  CHECK(call.has_launch_nested_containers());
+
+  LOG(INFO) << "Processing LAUNCH_NESTED_CONTAINERS call for "
+            << call.launch_nested_containers().containers_size()
+            << " containers";
+
+  Future<Owned<AuthorizationAcceptor>> authorizer =
+    AuthorizationAcceptor::create(
+        principal, slave->authorizer, authorization::LAUNCH_NESTED_CONTAINER);
+
+  return authorizer
+    .then(defer(
+        slave->self(),
+        [=](const Owned<AuthorizationAcceptor>& authorizer) {
+          // All the launches are started before any of them completes,
+          // so the containerizer provisions and prepares them
+          // concurrently.
+          list<ContainerID> containerIds;
+          list<Future<Response>> launches;
+
+          foreach (const mesos::agent::Call::LaunchNestedContainer& launch,
+                   call.launch_nested_containers().containers()) {
+            containerIds.push_back(launch.container_id());
+
+            launches.push_back(_launchContainer(
+                launch.container_id(),
+                launch.command(),
+                None(),
+                launch.has_container()
+                  ? launch.container()
+                  : Option<ContainerInfo>::none(),
+                ContainerClass::DEFAULT,
+                acceptType,
+                authorizer));
+          }
+
+          return await(launches)
+            .then([containerIds](const list<Future<Response>>& launches)
+                -> Response {
+              auto containerId = containerIds.begin();
+
+              foreach (const Future<Response>& launch, launches) {
+                if (!launch.isReady()) {
+                  return InternalServerError(
+                      "Failed to launch container '" +
+                      stringify(*containerId) + "': " +
+                      (launch.isFailed() ? launch.failure() : "discarded"));
+                }
+
+                if (launch->code != process::http::Status::OK) {
+                  return Response(
+                      "Failed to launch container '" +
+                      stringify(*containerId) + "': " + launch->body,
+                      launch->code);
+                }
+
+                ++containerId;
+              }
+
+              return OK();
+            });
+        }));
+}
+
+
 Future<Response> Http::launchContainer(
     const mesos::agent::Call& call,
     ContentType acceptType,
@@ -2748,35 +3041,124 @@ Future<Response> Http::_waitContainer(
         }
       } else {
         response.set_type(mesos::agent::Response::WAIT_CONTAINER);
+        *response.mutable_wait_container() =
+          createWaitContainer(termination.get());
+      }
 
-        mesos::agent::Response::WaitContainer* waitContainer =
-          response.mutable_wait_container();
+      return OK(serialize(acceptType, evolve(response)),
+                stringify(acceptType));
+    });
+}
 
-        if (termination->has_status()) {
-          waitContainer->set_exit_status(termination->status());
-        }
 
-        if (termination->has_state()) {
-          waitContainer->set_state(termination->state());
-        }
+Future<Response> Http::watchNestedContainers(
+    const mesos::agent::Call& call,
+    const RequestMediaTypes& mediaTypes,
+    const Option<Principal>& principal) const
+{
+  CHECK_EQ(mesos::agent::Call::WATCH_NESTED_CONTAINERS, call.type());
+  CHECK(call.has_watch_nested_containers());
 
-        if (termination->has_reason()) {
-          waitContainer->set_reason(termination->reason());
-        }
+  LOG(INFO) << "Processing WATCH_NESTED_CONTAINERS call for containers "
+            << call.watch_nested_containers().container_ids();
 
-        if (!termination->limited_resources().empty()) {
-          waitContainer->mutable_limitation()->mutable_resources()
-            ->CopyFrom(termination->limited_resources());
-        }
+  if (!streamingMediaType(mediaTypes.accept)) {
+    return NotAcceptable(
+        string("Expecting 'Accept' to allow ") + APPLICATION_RECORDIO +
+        " for " + stringify(call.type()) + " call");
+  }
 
-        if (termination->has_message()) {
-          waitContainer->set_message(termination->message());
-        }
+  Future<Owned<AuthorizationAcceptor>> authorizer =
+    AuthorizationAcceptor::create(
+        principal, slave->authorizer, authorization::WAIT_NESTED_CONTAINER);
+
+  return authorizer
+    .then(defer(
+        slave->self(),
+        [=](const Owned<AuthorizationAcceptor>& authorizer) {
+          return _watchNestedContainers(call, mediaTypes, authorizer);
+        }));
+}
+
+
+Future<Response> Http::_watchNestedContainers(
+    const mesos::agent::Call& call,
+    const RequestMediaTypes& mediaTypes,
+    const Owned<AuthorizationAcceptor>& authorizer) const
+{
+  const auto& containerIds = call.watch_nested_containers().container_ids();
+
+  // The containers are authorized the same way as for a
+  // `WAIT_NESTED_CONTAINER` call, see `_waitContainer()`.
+  foreach (const ContainerID& containerId, containerIds) {
+    Executor* executor = slave->getExecutor(containerId);
+    if (executor == nullptr) {
+      if (!authorizer->accept(containerId)) {
+        return Forbidden();
       }
+    } else {
+      Framework* framework = slave->getFramework(executor->frameworkId);
+      CHECK_NOTNULL(framework);
 
-      return OK(serialize(acceptType, evolve(response)),
-                stringify(acceptType));
+      if (!authorizer->accept(
+              executor->info,
+              framework->info,
+              containerId)) {
+        return Forbidden();
+      }
+    }
+  }
+
+  CHECK_SOME(mediaTypes.messageAccept);
+  const ContentType messageAcceptType = mediaTypes.messageAccept.get();
+
+  Pipe pipe;
+  Pipe::Writer writer = pipe.writer();
+
+  OK ok;
+  ok.headers["Content-Type"] = stringify(mediaTypes.accept);
+  ok.headers[MESSAGE_CONTENT_TYPE] = stringify(messageAcceptType);
+  ok.type = Response::PIPE;
+  ok.reader = pipe.reader();
+
+  ::recordio::Encoder<v1::agent::Response> encoder(lambda::bind(
+      serialize, messageAcceptType, lambda::_1));
+
+  list<Future<Nothing>> waits;
+
+  foreach (const ContainerID& containerId, containerIds) {
+    waits.push_back(slave->containerizer->wait(containerId)
+      .then([=](const Option<ContainerTermination>& termination) mutable {
+        mesos::agent::Response response;
+        response.set_type(mesos::agent::Response::WATCH_NESTED_CONTAINERS);
+
+        mesos::agent::Response::WatchNestedContainers* watch =
+          response.mutable_watch_nested_containers();
+
+        watch->mutable_container_id()->CopyFrom(containerId);
+
+        if (termination.isSome()) {
+          *watch->mutable_wait_container() =
+            createWaitContainer(termination.get());
+        }
+
+        writer.write(encoder.encode(evolve(response)));
+
+        return Nothing();
+      }));
+  }
+
+  // The stream ends once all the containers have terminated.
+  collect(waits)
+    .onAny([writer](const Future<list<Nothing>>& future) mutable {
+      if (future.isReady()) {
+        writer.close();
+      } else {
+        writer.fail(future.isFailed() ? future.failure() : "discarded");
+      }
     });
+
+  return ok;
 }
 
 
@@ -17,12 +17,18 @@
 #ifndef __SLAVE_HTTP_HPP__
 #define __SLAVE_HTTP_HPP__
 
+#include <stdint.h>
+
+#include <string>
+
 #include <process/authenticator.hpp>
 #include <process/http.hpp>
 #include <process/future.hpp>
 #include <process/owned.hpp>
 #include <process/limiter.hpp>
+#include <process/time.hpp>
 
+#include <stout/hashmap.hpp>
 #include <stout/json.hpp>
 #include <stout/option.hpp>
 
@@ -220,6 +226,11 @@ private:
       ContentType acceptType,
       const Option<process::http::authentication::Principal>& principal) const;
 
+  process::Future<process::http::Response> launchNestedContainers(
+      const mesos::agent::Call& call,
+      ContentType acceptType,
+      const Option<process::http::authentication::Principal>& principal) const;
+
   process::Future<process::http::Response> launchContainer(
       const mesos::agent::Call& call,
       ContentType acceptType,
@@ -250,6 +261,16 @@ private:
       const process::Owned<AuthorizationAcceptor>& authorizer,
       const bool deprecated) const;
 
+  process::Future<process::http::Response> watchNestedContainers(
+      const mesos::agent::Call& call,
+      const RequestMediaTypes& mediaTypes,
+      const Option<process::http::authentication::Principal>& principal) const;
+
+  process::Future<process::http::Response> _watchNestedContainers(
+      const mesos::agent::Call& call,
+      const RequestMediaTypes& mediaTypes,
+      const process::Owned<AuthorizationAcceptor>& authorizer) const;
+
   process::Future<process::http::Response> killNestedContainer(
       const mesos::agent::Call& call,
       ContentType acceptType,
@@ -318,10 +339,45 @@ private:
       const mesos::agent::Call& call,
       const Option<process::http::authentication::Principal>& principal) const;
 
+  // A rendering of a read-only view of the agent (e.g., its state)
+  // that can be served to multiple requests.
+  struct View
+  {
+    std::string body;
+
+    // The generation of the agent (see `Slave::generation`) and the
+    // time when the view was rendered.
+    uint64_t generation;
+    process::Time time;
+  };
+
+  // Returns the cached rendering of the view `name` for the class of
+  // `principal`, if it is still fresh. A rendering is fresh while it
+  // is pending, so that concurrent requests share a single rendering,
+  // as long as the agent has not served any event that might have
+  // changed its state since, and for `--state_cache_max_staleness`
+  // after it was rendered.
+  Option<process::Future<View>> cached(
+      const std::string& name,
+      const Option<process::http::authentication::Principal>&
+          principal) const;
+
+  // Caches `view` as the rendering of the view `name` for the class
+  // of `principal`, and returns it.
+  process::Future<View> cache(
+      const std::string& name,
+      const Option<process::http::authentication::Principal>& principal,
+      const process::Future<View>& view) const;
+
   Slave* slave;
 
   // Used to rate limit the statistics endpoint.
   process::Shared<process::RateLimiter> statisticsLimiter;
+
+  // Renderings of views of the agent, see `cached()`. Keyed by the
+  // name of the view and the class of the principal, i.e., all
+  // principals share a rendering without an authorizer.
+  mutable hashmap<std::string, process::Future<View>> views;
 };
 
 } // namespace slave {
@@ -73,6 +73,8 @@
 
 #include "module/manager.hpp"
 
+#include "secret/caching_resolver.hpp"
+
 #include "slave/gc.hpp"
 #include "slave/slave.hpp"
 #include "slave/task_status_update_manager.hpp"
@@ -491,6 +493,11 @@ int main(int argc, char** argv)
         << "Failed to initialize secret resolver: " << secretResolver.error();
   }
 
+  if (flags.secret_resolver.isSome()) {
+    secretResolver = new mesos::internal::CachingSecretResolver(
+        secretResolver.get(), flags.secret_resolver_cache_ttl);
+  }
+
   Try<Containerizer*> containerizer =
     Containerizer::create(flags, false, fetcher, secretResolver.get());
 
@@ -544,7 +551,7 @@ int main(int argc, char** argv)
   }
 
   Files* files = new Files(READONLY_HTTP_AUTHENTICATION_REALM, authorizer_);
-  GarbageCollector* gc = new GarbageCollector();
+  GarbageCollector* gc = new GarbageCollector(flags.work_dir);
   TaskStatusUpdateManager* taskStatusUpdateManager =
     new TaskStatusUpdateManager(flags);
 
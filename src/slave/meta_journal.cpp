@@ -0,0 +1,457 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <glog/logging.h>
+
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+#include <stout/path.hpp>
+#include <stout/protobuf.hpp>
+#include <stout/strings.hpp>
+#include <stout/synchronized.hpp>
+
+#include <stout/os/close.hpp>
+#include <stout/os/constants.hpp>
+#include <stout/os/exists.hpp>
+#include <stout/os/ftruncate.hpp>
+#include <stout/os/lseek.hpp>
+#include <stout/os/mkdir.hpp>
+#include <stout/os/mktemp.hpp>
+#include <stout/os/open.hpp>
+#include <stout/os/rename.hpp>
+#include <stout/os/rm.hpp>
+
+#include "slave/constants.hpp"
+#include "slave/meta_journal.hpp"
+#include "slave/paths.hpp"
+
+using std::shared_ptr;
+using std::string;
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+namespace {
+
+struct Registry
+{
+  std::mutex mutex;
+
+  // The journals, keyed by their meta directory.
+  hashmap<string, shared_ptr<MetaJournal>> journals;
+};
+
+
+// NOTE: The registry is intentionally leaked to avoid destruction
+// order issues with other static objects that may checkpoint files.
+Registry* registry()
+{
+  static Registry* registry = new Registry();
+  return registry;
+}
+
+
+size_t recordSize(const MetaJournalRecord& record)
+{
+  // See `::protobuf::write()`.
+  return sizeof(uint32_t) + record.ByteSize();
+}
+
+} // namespace {
+
+
+Try<Nothing> MetaJournal::enable(const string& rootDir)
+{
+  shared_ptr<MetaJournal> journal(new MetaJournal(rootDir));
+
+  Try<Nothing> load = journal->load();
+  if (load.isError()) {
+    return Error(
+        "Failed to load meta journal '" + journal->path + "': " +
+        load.error());
+  }
+
+  LOG(INFO) << "Loaded " << journal->files.size() << " files from meta"
+            << " journal '" << journal->path << "'";
+
+  synchronized (registry()->mutex) {
+    registry()->journals[rootDir] = journal;
+  }
+
+  return Nothing();
+}
+
+
+Try<Nothing> MetaJournal::disable(const string& rootDir)
+{
+  close(rootDir);
+
+  const string path = paths::getMetaJournalPath(rootDir);
+
+  if (os::exists(path)) {
+    Try<Nothing> rm = os::rm(path);
+    if (rm.isError()) {
+      return Error("Failed to remove meta journal '" + path + "': " +
+                   rm.error());
+    }
+  }
+
+  return Nothing();
+}
+
+
+void MetaJournal::close(const string& rootDir)
+{
+  synchronized (registry()->mutex) {
+    registry()->journals.erase(rootDir);
+  }
+}
+
+
+shared_ptr<MetaJournal> MetaJournal::find(const string& path)
+{
+  synchronized (registry()->mutex) {
+    foreachpair (const string& rootDir,
+                 const shared_ptr<MetaJournal>& journal,
+                 registry()->journals) {
+      if (strings::startsWith(path, rootDir + os::PATH_SEPARATOR)) {
+        return journal;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+
+MetaJournal::MetaJournal(const string& _rootDir)
+  : rootDir(_rootDir),
+    path(paths::getMetaJournalPath(_rootDir)),
+    liveSize(0),
+    size(0) {}
+
+
+MetaJournal::~MetaJournal()
+{
+  if (fd.isSome()) {
+    os::close(fd.get());
+  }
+}
+
+
+Option<string> MetaJournal::read(const string& path)
+{
+  synchronized (mutex) {
+    if (fd.isNone()) {
+      return None();
+    }
+
+    auto it = files.find(path.substr(rootDir.size() + 1));
+    if (it != files.end()) {
+      return it->second;
+    }
+  }
+
+  return None();
+}
+
+
+void MetaJournal::checkpoint(const string& path, const string& data)
+{
+  synchronized (mutex) {
+    if (fd.isNone()) {
+      return;
+    }
+
+    MetaJournalRecord record;
+    record.set_type(MetaJournalRecord::CHECKPOINT);
+    record.set_path(path.substr(rootDir.size() + 1));
+    record.set_data(data);
+
+    // Recovery falls back to reading the file from now on.
+    files.erase(record.path());
+
+    append(record);
+  }
+}
+
+
+void MetaJournal::remove(const string& path)
+{
+  synchronized (mutex) {
+    if (fd.isNone()) {
+      return;
+    }
+
+    MetaJournalRecord record;
+    record.set_type(MetaJournalRecord::REMOVE);
+    record.set_path(path.substr(rootDir.size() + 1));
+
+    files.erase(record.path());
+
+    append(record);
+  }
+}
+
+
+Try<Nothing> MetaJournal::compact()
+{
+  synchronized (mutex) {
+    if (fd.isNone()) {
+      return Nothing();
+    }
+
+    Try<Nothing> compact = _compact();
+    if (compact.isError()) {
+      fail("Failed to compact meta journal '" + path + "': " +
+           compact.error());
+      return Error(compact.error());
+    }
+  }
+
+  return Nothing();
+}
+
+
+Try<Nothing> MetaJournal::load()
+{
+  Try<Nothing> mkdir = os::mkdir(rootDir);
+  if (mkdir.isError()) {
+    return Error("Failed to create '" + rootDir + "': " + mkdir.error());
+  }
+
+  Try<int_fd> open = os::open(
+      path,
+      O_CREAT | O_RDWR | O_APPEND | O_CLOEXEC,
+      S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+  if (open.isError()) {
+    return Error("Failed to open: " + open.error());
+  }
+
+  fd = open.get();
+
+  Result<MetaJournalRecord> record = None();
+  while (true) {
+    // Ignore errors due to partial protobuf read and enable undoing
+    // failed reads by reverting to the previous seek position.
+    record = ::protobuf::read<MetaJournalRecord>(fd.get(), true, true);
+
+    if (!record.isSome()) {
+      break;
+    }
+
+    const size_t recordSize_ = recordSize(record.get());
+
+    switch (record->type()) {
+      case MetaJournalRecord::CHECKPOINT:
+        files[record->path()] = record->data();
+        sizes[record->path()] = recordSize_;
+        break;
+      case MetaJournalRecord::REMOVE:
+        files.erase(record->path());
+        sizes.erase(record->path());
+        break;
+    }
+
+    size += recordSize_;
+  }
+
+  // The records following a corrupted record are dropped along with
+  // it, their files get read from disk instead.
+  if (record.isError()) {
+    LOG(WARNING) << "Truncating meta journal '" << path << "' after "
+                 << size << " bytes: " << record.error();
+  }
+
+  // Always truncate the journal to contain only valid records.
+  // NOTE: This is safe even though we ignore partial protobuf read
+  // errors above, because the `fd` is properly set to the end of the
+  // last valid record by `protobuf::read()`.
+  Try<off_t> position = os::lseek(fd.get(), 0, SEEK_CUR);
+  if (position.isError()) {
+    return Error("Failed to lseek: " + position.error());
+  }
+
+  Try<Nothing> truncated = os::ftruncate(fd.get(), position.get());
+  if (truncated.isError()) {
+    return Error("Failed to truncate: " + truncated.error());
+  }
+
+  foreachvalue (size_t recordSize_, sizes) {
+    liveSize += recordSize_;
+  }
+
+  return Nothing();
+}
+
+
+void MetaJournal::append(const MetaJournalRecord& record)
+{
+  CHECK_SOME(fd);
+
+  Try<Nothing> write = ::protobuf::write(fd.get(), record);
+  if (write.isError()) {
+    fail("Failed to append to meta journal '" + path + "': " + write.error());
+    return;
+  }
+
+  const size_t recordSize_ = recordSize(record);
+
+  size += recordSize_;
+
+  if (sizes.contains(record.path())) {
+    liveSize -= sizes.at(record.path());
+    sizes.erase(record.path());
+  }
+
+  if (record.type() == MetaJournalRecord::CHECKPOINT) {
+    liveSize += recordSize_;
+    sizes[record.path()] = recordSize_;
+  }
+
+  if (size >= META_JOURNAL_MIN_COMPACTION_SIZE.bytes() &&
+      size > 2 * liveSize) {
+    Try<Nothing> compact = _compact();
+    if (compact.isError()) {
+      fail("Failed to compact meta journal '" + path + "': " +
+           compact.error());
+    }
+  }
+}
+
+
+Try<Nothing> MetaJournal::_compact()
+{
+  CHECK_SOME(fd);
+
+  // Read the latest record of each file.
+  Try<int_fd> in = os::open(path, O_RDONLY | O_CLOEXEC);
+  if (in.isError()) {
+    return Error("Failed to open: " + in.error());
+  }
+
+  hashmap<string, MetaJournalRecord> records;
+
+  Result<MetaJournalRecord> record = None();
+  while (true) {
+    record = ::protobuf::read<MetaJournalRecord>(in.get());
+
+    if (!record.isSome()) {
+      break;
+    }
+
+    switch (record->type()) {
+      case MetaJournalRecord::CHECKPOINT:
+        records[record->path()] = record.get();
+        break;
+      case MetaJournalRecord::REMOVE:
+        records.erase(record->path());
+        break;
+    }
+  }
+
+  os::close(in.get());
+
+  if (record.isError()) {
+    return Error("Failed to read: " + record.error());
+  }
+
+  // Write the records of the files that still exist to a temporary
+  // journal, which then replaces the journal.
+  Try<string> temp = os::mktemp(path + ".XXXXXX");
+  if (temp.isError()) {
+    return Error("Failed to create temporary file: " + temp.error());
+  }
+
+  Try<int_fd> out = os::open(temp.get(), O_WRONLY | O_APPEND | O_CLOEXEC);
+  if (out.isError()) {
+    os::rm(temp.get());
+    return Error("Failed to open '" + temp.get() + "': " + out.error());
+  }
+
+  hashmap<string, size_t> sizes_;
+  size_t size_ = 0;
+
+  foreachvalue (const MetaJournalRecord& record, records) {
+    if (!os::exists(path::join(rootDir, record.path()))) {
+      continue;
+    }
+
+    Try<Nothing> write = ::protobuf::write(out.get(), record);
+    if (write.isError()) {
+      os::close(out.get());
+      os::rm(temp.get());
+      return Error("Failed to write '" + temp.get() + "': " + write.error());
+    }
+
+    sizes_[record.path()] = recordSize(record);
+    size_ += recordSize(record);
+  }
+
+  Try<Nothing> rename = os::rename(temp.get(), path);
+  if (rename.isError()) {
+    os::close(out.get());
+    os::rm(temp.get());
+    return Error("Failed to rename '" + temp.get() + "': " + rename.error());
+  }
+
+  VLOG(1) << "Compacted meta journal '" << path << "' from " << size
+          << " to " << size_ << " bytes";
+
+  os::close(fd.get());
+  fd = out.get();
+
+  // The loaded files are only needed until the checkpointed state
+  // has been recovered, which is when the journal first gets compacted.
+  files.clear();
+
+  sizes = sizes_;
+  liveSize = size_;
+  size = size_;
+
+  return Nothing();
+}
+
+
+void MetaJournal::fail(const string& message)
+{
+  LOG(ERROR) << message << "; no longer using the meta journal";
+
+  if (fd.isSome()) {
+    os::ftruncate(fd.get(), 0);
+    os::close(fd.get());
+    fd = None();
+  }
+
+  files.clear();
+  sizes.clear();
+
+  // NOTE: The journal might be missing files checkpointed from now on,
+  // so it must not be used for recovery.
+  Try<Nothing> rm = os::rm(path);
+  if (rm.isError()) {
+    LOG(ERROR) << "Failed to remove meta journal '" << path << "': "
+               << rm.error();
+  }
+}
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,129 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __SLAVE_META_JOURNAL_HPP__
+#define __SLAVE_META_JOURNAL_HPP__
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <stout/hashmap.hpp>
+#include <stout/nothing.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+#include <stout/os/int_fd.hpp>
+
+#include "messages/messages.hpp"
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// An append-only journal of the files checkpointed (see
+// `state::checkpoint()`) under the agent's meta directory, which lets
+// the agent recover its checkpointed state with one sequential read
+// of the journal rather than opening every file (see `--meta_journal`).
+//
+// The journal is only a cache of the checkpointed files: the files are
+// still written as before and remain the source of truth for which
+// frameworks, executors, runs and tasks exist (see "slave/paths.hpp").
+// Recovery reads a file from the journal if it has a record of it and
+// from disk otherwise, journaling it then. An agent thus migrates to
+// the journal by simply being restarted with it enabled: the first
+// recovery reads the files as before and journals them.
+//
+// A file's record is appended to the journal before the file itself is
+// replaced, so that the journal is never older than the file it caches.
+// If the journal can't be written it is removed and no longer used.
+//
+// The journal is compacted, dropping the records that have been
+// superseded and those of files that no longer exist (e.g., garbage
+// collected), once after recovery and whenever it grows to twice the
+// size of its live records.
+class MetaJournal
+{
+public:
+  // Starts journaling the files checkpointed under the meta directory
+  // `rootDir`, loading the records of its existing journal, if any.
+  static Try<Nothing> enable(const std::string& rootDir);
+
+  // Stops journaling the files checkpointed under `rootDir` and
+  // removes its journal, if any, since the journal would otherwise get
+  // out of date with the files.
+  static Try<Nothing> disable(const std::string& rootDir);
+
+  // Stops journaling the files checkpointed under `rootDir`, keeping
+  // its journal (e.g., when the agent terminates).
+  static void close(const std::string& rootDir);
+
+  // Returns the journal of the meta directory that `path` is in, if
+  // journaling is enabled for it.
+  static std::shared_ptr<MetaJournal> find(const std::string& path);
+
+  ~MetaJournal();
+
+  // Returns the loaded content of the file at `path`, if the journal
+  // has a record of it and hasn't been compacted since it was loaded.
+  Option<std::string> read(const std::string& path);
+
+  // Records that the file at `path` is being checkpointed with `data`.
+  void checkpoint(const std::string& path, const std::string& data);
+
+  // Records that the file at `path` failed to be checkpointed, so its
+  // previous record, if any, can no longer be trusted.
+  void remove(const std::string& path);
+
+  // Rewrites the journal with the latest record of each file that
+  // still exists, dropping the loaded records.
+  Try<Nothing> compact();
+
+private:
+  explicit MetaJournal(const std::string& rootDir);
+
+  Try<Nothing> load();
+  void append(const MetaJournalRecord& record);
+  Try<Nothing> _compact();
+
+  // Stops using the journal after a failure, removing it.
+  void fail(const std::string& message);
+
+  const std::string rootDir;
+  const std::string path;
+
+  std::mutex mutex;
+
+  // The journal, open for appending, or none if the journal failed.
+  Option<int_fd> fd;
+
+  // The content of the files as of when the journal was loaded,
+  // keyed by their path relative to `rootDir`, for recovery.
+  hashmap<std::string, std::string> files;
+
+  // The size of the latest record of each file, and their total.
+  hashmap<std::string, size_t> sizes;
+  size_t liveSize;
+
+  // The size of the journal.
+  size_t size;
+};
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __SLAVE_META_JOURNAL_HPP__
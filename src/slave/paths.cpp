@@ -52,6 +52,7 @@ namespace paths {
 
 // File names.
 const char BOOT_ID_FILE[] = "boot_id";
+const char META_JOURNAL_FILE[] = "journal";
 const char SLAVE_INFO_FILE[] = "slave.info";
 const char FRAMEWORK_PID_FILE[] = "framework.pid";
 const char FRAMEWORK_INFO_FILE[] = "framework.info";
@@ -69,6 +70,7 @@ const char RESOURCE_PROVIDER_STATE_FILE[] = "resource_provider.state";
 
 const char CONTAINERS_DIR[] = "containers";
 const char CSI_DIR[] = "csi";
+const char GC_TRASH_DIR[] = "trash";
 const char SLAVES_DIR[] = "slaves";
 const char FRAMEWORKS_DIR[] = "frameworks";
 const char EXECUTORS_DIR[] = "executors";
@@ -147,12 +149,24 @@ string getCsiRootDir(const string& workDir)
 }
 
 
+string getGcTrashDir(const string& workDir)
+{
+  return path::join(workDir, GC_TRASH_DIR);
+}
+
+
 string getBootIdPath(const string& rootDir)
 {
   return path::join(rootDir, BOOT_ID_FILE);
 }
 
 
+string getMetaJournalPath(const string& rootDir)
+{
+  return path::join(rootDir, META_JOURNAL_FILE);
+}
+
+
 string getLatestSlavePath(const string& rootDir)
 {
   return path::join(rootDir, SLAVES_DIR, LATEST_SYMLINK);
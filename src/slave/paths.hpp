@@ -103,6 +103,7 @@ namespace paths {
 //   |           |-- <persistence_id> (persistent volume)
 //   |-- provisioner
 //   |-- csi
+//   |-- trash (paths being deleted by the garbage collector)
 
 
 struct ExecutorRunPath
@@ -144,12 +145,18 @@ std::string getProvisionerDir(const std::string& rootDir);
 std::string getCsiRootDir(const std::string& workDir);
 
 
+std::string getGcTrashDir(const std::string& workDir);
+
+
 std::string getLatestSlavePath(const std::string& rootDir);
 
 
 std::string getBootIdPath(const std::string& rootDir);
 
 
+std::string getMetaJournalPath(const std::string& rootDir);
+
+
 std::string getSlaveInfoPath(
     const std::string& rootDir,
     const SlaveID& slaveId);
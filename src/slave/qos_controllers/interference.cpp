@@ -0,0 +1,459 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include <mesos/module/qos_controller.hpp>
+
+#include <mesos/slave/qos_controller.hpp>
+
+#include <process/defer.hpp>
+#include <process/dispatch.hpp>
+#include <process/id.hpp>
+#include <process/owned.hpp>
+#include <process/process.hpp>
+
+#include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/lambda.hpp>
+#include <stout/numify.hpp>
+#include <stout/option.hpp>
+#include <stout/stringify.hpp>
+
+#include "slave/qos_controllers/interference.hpp"
+
+using namespace mesos;
+using namespace process;
+
+using std::list;
+using std::string;
+using std::vector;
+
+using mesos::modules::Module;
+
+using mesos::slave::QoSController;
+using mesos::slave::QoSCorrection;
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+namespace {
+
+// The weight of the latest sample in the average instructions per
+// cycle of a latency-critical executor.
+constexpr double IPC_AVERAGE_WEIGHT = 0.1;
+
+
+// The signals of an executor between two resource usage samples.
+struct Signals
+{
+  // The fraction of CFS periods in which the executor was throttled.
+  Option<double> throttled;
+
+  // The medium memory pressure events per second, which include the
+  // critical ones.
+  Option<double> memoryPressure;
+
+  // The CPU time used per second.
+  Option<double> cpus;
+
+  // The instructions per cycle.
+  Option<double> ipc;
+
+  // The cache misses per second.
+  Option<double> cacheMisses;
+};
+
+
+Signals signals(
+    const ResourceStatistics& previous,
+    const ResourceStatistics& current)
+{
+  Signals signals;
+
+  const double elapsed = current.timestamp() - previous.timestamp();
+  if (elapsed <= 0) {
+    return signals;
+  }
+
+  if (previous.has_cpus_nr_periods() && current.has_cpus_nr_periods() &&
+      previous.has_cpus_nr_throttled() && current.has_cpus_nr_throttled() &&
+      current.cpus_nr_periods() > previous.cpus_nr_periods() &&
+      current.cpus_nr_throttled() >= previous.cpus_nr_throttled()) {
+    signals.throttled =
+      static_cast<double>(
+          current.cpus_nr_throttled() - previous.cpus_nr_throttled()) /
+      (current.cpus_nr_periods() - previous.cpus_nr_periods());
+  }
+
+  if (previous.has_mem_medium_pressure_counter() &&
+      current.has_mem_medium_pressure_counter() &&
+      current.mem_medium_pressure_counter() >=
+        previous.mem_medium_pressure_counter()) {
+    signals.memoryPressure =
+      (current.mem_medium_pressure_counter() -
+       previous.mem_medium_pressure_counter()) / elapsed;
+  }
+
+  if (previous.has_cpus_user_time_secs() &&
+      previous.has_cpus_system_time_secs() &&
+      current.has_cpus_user_time_secs() &&
+      current.has_cpus_system_time_secs()) {
+    const double cpus =
+      (current.cpus_user_time_secs() + current.cpus_system_time_secs()) -
+      (previous.cpus_user_time_secs() + previous.cpus_system_time_secs());
+
+    if (cpus >= 0) {
+      signals.cpus = cpus / elapsed;
+    }
+  }
+
+  if (previous.has_perf() && current.has_perf()) {
+    const PerfStatistics& before = previous.perf();
+    const PerfStatistics& after = current.perf();
+
+    // With `--perf_continuous` the counts accumulate from the start
+    // of the container, in which case only the duration of the sample
+    // changes. Otherwise they cover the latest sampling interval.
+    const bool cumulative =
+      after.timestamp() == before.timestamp() &&
+      after.duration() > before.duration();
+
+    auto count = [cumulative](uint64_t before, uint64_t after) -> double {
+      if (!cumulative) {
+        return static_cast<double>(after);
+      }
+
+      return after >= before ? static_cast<double>(after - before) : 0;
+    };
+
+    const double duration = cumulative
+      ? after.duration() - before.duration()
+      : after.duration();
+
+    if (after.has_instructions() && after.has_cycles()) {
+      const double cycles = count(before.cycles(), after.cycles());
+      if (cycles > 0) {
+        signals.ipc =
+          count(before.instructions(), after.instructions()) / cycles;
+      }
+    }
+
+    if (after.has_cache_misses() && duration > 0) {
+      signals.cacheMisses =
+        count(before.cache_misses(), after.cache_misses()) / duration;
+    }
+  }
+
+  return signals;
+}
+
+} // namespace {
+
+
+class InterferenceQoSControllerProcess
+  : public Process<InterferenceQoSControllerProcess>
+{
+public:
+  InterferenceQoSControllerProcess(
+      const lambda::function<Future<ResourceUsage>()>& _usage,
+      const InterferenceQoSController::Thresholds& _thresholds,
+      size_t _samples)
+    : ProcessBase(process::ID::generate("qos-interference-controller")),
+      usage(_usage),
+      thresholds(_thresholds),
+      samples(_samples),
+      degraded(0) {}
+
+  Future<list<QoSCorrection>> corrections()
+  {
+    return usage().then(defer(self(), &Self::_corrections, lambda::_1));
+  }
+
+  Future<list<QoSCorrection>> _corrections(const ResourceUsage& usage)
+  {
+    hashmap<ContainerID, ResourceStatistics> statistics_;
+    hashmap<ContainerID, double> ipcs_;
+
+    // The revocable executors along with their signals.
+    vector<std::pair<const ResourceUsage::Executor*, Signals>> revocable;
+
+    bool interfered = false;
+
+    foreach (const ResourceUsage::Executor& executor, usage.executors()) {
+      if (!executor.has_statistics()) {
+        continue;
+      }
+
+      const ContainerID& containerId = executor.container_id();
+
+      statistics_[containerId] = executor.statistics();
+
+      if (!statistics.contains(containerId)) {
+        continue;
+      }
+
+      const Signals signals_ =
+        signals(statistics.at(containerId), executor.statistics());
+
+      if (!Resources(executor.allocated()).revocable().empty()) {
+        revocable.push_back(std::make_pair(&executor, signals_));
+        continue;
+      }
+
+      const Option<double> ipc = ipcs.get(containerId);
+
+      Option<string> degradation = None();
+
+      if (thresholds.throttled.isSome() &&
+          signals_.throttled.isSome() &&
+          signals_.throttled.get() > thresholds.throttled.get()) {
+        degradation = "throttled in " +
+          stringify(signals_.throttled.get() * 100) + "% of CFS periods";
+      } else if (thresholds.memoryPressure.isSome() &&
+                 signals_.memoryPressure.isSome() &&
+                 signals_.memoryPressure.get() >
+                   thresholds.memoryPressure.get()) {
+        degradation = stringify(signals_.memoryPressure.get()) +
+          " memory pressure events per second";
+      } else if (thresholds.ipcDegradation.isSome() &&
+                 signals_.ipc.isSome() &&
+                 ipc.isSome() &&
+                 signals_.ipc.get() <
+                   ipc.get() * (1 - thresholds.ipcDegradation.get())) {
+        degradation = "instructions per cycle dropped to " +
+          stringify(signals_.ipc.get()) + " from " + stringify(ipc.get());
+      }
+
+      if (degradation.isSome()) {
+        LOG(INFO) << "Executor '" << executor.executor_info().executor_id()
+                  << "' of framework "
+                  << executor.executor_info().framework_id()
+                  << " is degraded: " << degradation.get();
+
+        interfered = true;
+
+        // Keep the average of the instructions per cycle while the
+        // executor was not degraded.
+        if (ipc.isSome()) {
+          ipcs_[containerId] = ipc.get();
+        }
+      } else if (signals_.ipc.isSome()) {
+        ipcs_[containerId] = ipc.isSome()
+          ? (1 - IPC_AVERAGE_WEIGHT) * ipc.get() +
+              IPC_AVERAGE_WEIGHT * signals_.ipc.get()
+          : signals_.ipc.get();
+      } else if (ipc.isSome()) {
+        ipcs_[containerId] = ipc.get();
+      }
+    }
+
+    // Only keep the state of the executors which are still running.
+    statistics = statistics_;
+    ipcs = ipcs_;
+
+    if (!interfered) {
+      degraded = 0;
+      return list<QoSCorrection>();
+    }
+
+    if (++degraded < samples) {
+      return list<QoSCorrection>();
+    }
+
+    // Rank the revocable executors by their cache misses if any of
+    // them reports those, since they are a better indication of
+    // interference than the CPU usage.
+    bool cacheMisses = false;
+    foreach (const auto& executor, revocable) {
+      if (executor.second.cacheMisses.isSome()) {
+        cacheMisses = true;
+      }
+    }
+
+    auto score = [cacheMisses](const Signals& signals) {
+      return cacheMisses
+        ? signals.cacheMisses.getOrElse(0)
+        : signals.cpus.getOrElse(0);
+    };
+
+    const ResourceUsage::Executor* aggressor = nullptr;
+    double highest = 0;
+
+    foreach (const auto& executor, revocable) {
+      if (aggressor == nullptr || score(executor.second) > highest) {
+        aggressor = executor.first;
+        highest = score(executor.second);
+      }
+    }
+
+    if (aggressor == nullptr) {
+      LOG(WARNING) << "No revocable executors to evict for the degraded"
+                   << " executors";
+      return list<QoSCorrection>();
+    }
+
+    LOG(INFO) << "Evicting revocable executor '"
+              << aggressor->executor_info().executor_id()
+              << "' of framework " << aggressor->executor_info().framework_id()
+              << " with " << highest
+              << (cacheMisses ? " cache misses" : " CPUs") << " per second";
+
+    degraded = 0;
+
+    QoSCorrection correction;
+
+    correction.set_type(mesos::slave::QoSCorrection_Type_KILL);
+    correction.mutable_kill()->mutable_framework_id()->CopyFrom(
+        aggressor->executor_info().framework_id());
+    correction.mutable_kill()->mutable_executor_id()->CopyFrom(
+        aggressor->executor_info().executor_id());
+    correction.mutable_kill()->mutable_container_id()->CopyFrom(
+        aggressor->container_id());
+
+    return list<QoSCorrection>({correction});
+  }
+
+private:
+  const lambda::function<Future<ResourceUsage>()> usage;
+  const InterferenceQoSController::Thresholds thresholds;
+  const size_t samples;
+
+  // The latest statistics of each executor's container.
+  hashmap<ContainerID, ResourceStatistics> statistics;
+
+  // The average instructions per cycle of the latency-critical
+  // executors while they were not degraded.
+  hashmap<ContainerID, double> ipcs;
+
+  // The number of consecutive corrections in which some
+  // latency-critical executor was degraded.
+  size_t degraded;
+};
+
+
+InterferenceQoSController::~InterferenceQoSController()
+{
+  if (process.get() != nullptr) {
+    terminate(process.get());
+    wait(process.get());
+  }
+}
+
+
+Try<Nothing> InterferenceQoSController::initialize(
+  const lambda::function<Future<ResourceUsage>()>& usage)
+{
+  if (process.get() != nullptr) {
+    return Error("Interference QoS Controller has already been initialized");
+  }
+
+  process.reset(
+      new InterferenceQoSControllerProcess(usage, thresholds, samples));
+
+  spawn(process.get());
+
+  return Nothing();
+}
+
+
+process::Future<list<QoSCorrection>> InterferenceQoSController::corrections()
+{
+  if (process.get() == nullptr) {
+    return Failure("Interference QoS Controller is not initialized");
+  }
+
+  return dispatch(
+      process.get(),
+      &InterferenceQoSControllerProcess::corrections);
+}
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
+
+
+static QoSController* create(const Parameters& parameters)
+{
+  mesos::internal::slave::InterferenceQoSController::Thresholds thresholds;
+  size_t samples = 1;
+
+  foreach (const Parameter& parameter, parameters.parameter()) {
+    if (parameter.key() == "samples") {
+      Try<size_t> samplesParam = numify<size_t>(parameter.value());
+      if (samplesParam.isError() || samplesParam.get() == 0) {
+        LOG(ERROR) << "Failed to parse samples: "
+                   << (samplesParam.isError()
+                       ? samplesParam.error()
+                       : "must be positive");
+        return nullptr;
+      }
+
+      samples = samplesParam.get();
+      continue;
+    }
+
+    Option<double>* threshold = nullptr;
+
+    if (parameter.key() == "throttled_threshold") {
+      threshold = &thresholds.throttled;
+    } else if (parameter.key() == "memory_pressure_threshold") {
+      threshold = &thresholds.memoryPressure;
+    } else if (parameter.key() == "ipc_degradation_threshold") {
+      threshold = &thresholds.ipcDegradation;
+    } else {
+      continue;
+    }
+
+    Try<double> thresholdParam = numify<double>(parameter.value());
+    if (thresholdParam.isError()) {
+      LOG(ERROR) << "Failed to parse " << parameter.key() << ": "
+                 << thresholdParam.error();
+      return nullptr;
+    }
+
+    if (thresholdParam.get() < 0) {
+      LOG(ERROR) << "Failed to parse " << parameter.key()
+                 << ": must not be negative";
+      return nullptr;
+    }
+
+    *threshold = thresholdParam.get();
+  }
+
+  if (thresholds.throttled.isNone() &&
+      thresholds.memoryPressure.isNone() &&
+      thresholds.ipcDegradation.isNone()) {
+    LOG(ERROR) << "No thresholds are configured for InterferenceQoSController";
+    return nullptr;
+  }
+
+  return new mesos::internal::slave::InterferenceQoSController(
+      thresholds, samples);
+}
+
+
+Module<QoSController> org_apache_mesos_InterferenceQoSController(
+    MESOS_MODULE_API_VERSION,
+    MESOS_VERSION,
+    "Apache Mesos",
+    "modules@mesos.apache.org",
+    "Interference QoS Controller Module.",
+    nullptr,
+    create);
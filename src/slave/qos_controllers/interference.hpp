@@ -0,0 +1,95 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __SLAVE_QOS_CONTROLLERS_INTERFERENCE_HPP__
+#define __SLAVE_QOS_CONTROLLERS_INTERFERENCE_HPP__
+
+#include <list>
+
+#include <mesos/slave/qos_controller.hpp>
+
+#include <stout/lambda.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// Forward declaration.
+class InterferenceQoSControllerProcess;
+
+
+// The `InterferenceQoSController` protects the latency-critical
+// executors, i.e., the ones without any revocable resources, from the
+// revocable executors interfering with them.
+//
+// A latency-critical executor is considered degraded when, between
+// two consecutive resource usage samples, any of the following is
+// above its configured threshold:
+//   - the fraction of CFS periods in which it was throttled,
+//   - the rate of medium memory pressure events of its cgroup, or
+//   - the relative drop of its instructions per cycle compared to
+//     the average while it was not degraded.
+//
+// When some latency-critical executor is degraded in `samples`
+// consecutive corrections, the revocable executor most likely to
+// cause the interference is evicted: the one with the highest rate
+// of cache misses, or the highest CPU usage if no cache misses are
+// reported. Only one executor is evicted at a time, so that the
+// revocable executors keep running as long as the latency-critical
+// ones recover.
+//
+// NOTE: The cache misses and the instructions per cycle are only
+// available when the `cgroups/perf_event` isolator is enabled with
+// the `cache-misses`, `instructions` and `cycles` events.
+class InterferenceQoSController : public mesos::slave::QoSController
+{
+public:
+  struct Thresholds
+  {
+    Option<double> throttled;
+    Option<double> memoryPressure;
+    Option<double> ipcDegradation;
+  };
+
+  InterferenceQoSController(
+      const Thresholds& _thresholds,
+      size_t _samples)
+    : thresholds(_thresholds),
+      samples(_samples) {}
+
+  virtual ~InterferenceQoSController();
+
+  virtual Try<Nothing> initialize(
+    const lambda::function<process::Future<ResourceUsage>()>& usage);
+
+  virtual process::Future<std::list<mesos::slave::QoSCorrection>> corrections();
+
+private:
+  const Thresholds thresholds;
+  const size_t samples;
+  process::Owned<InterferenceQoSControllerProcess> process;
+};
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __SLAVE_QOS_CONTROLLERS_INTERFERENCE_HPP__
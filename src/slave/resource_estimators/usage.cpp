@@ -0,0 +1,377 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <math.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mesos/module/resource_estimator.hpp>
+
+#include <mesos/slave/resource_estimator.hpp>
+
+#include <process/defer.hpp>
+#include <process/dispatch.hpp>
+#include <process/id.hpp>
+#include <process/owned.hpp>
+#include <process/process.hpp>
+
+#include <stout/bytes.hpp>
+#include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/lambda.hpp>
+#include <stout/numify.hpp>
+#include <stout/option.hpp>
+#include <stout/stringify.hpp>
+
+#include "slave/resource_estimators/usage.hpp"
+
+using namespace mesos;
+using namespace process;
+
+using std::deque;
+using std::vector;
+
+using mesos::modules::Module;
+
+using mesos::slave::ResourceEstimator;
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+namespace {
+
+// A sample of the usage of a resource by an executor.
+struct Sample
+{
+  // The time of the sample, in seconds since the Epoch.
+  double timestamp;
+  double value;
+};
+
+
+// The samples of the usage of an executor within the window.
+struct History
+{
+  // The time and the total CPU time of the latest sample, from which
+  // the CPU usage of the next sample is computed.
+  Option<std::pair<double, double>> cpusTime;
+
+  deque<Sample> cpus;
+  deque<Sample> mem;
+};
+
+
+void add(deque<Sample>& samples, const Sample& sample, const Duration& window)
+{
+  samples.push_back(sample);
+
+  while (samples.front().timestamp <= sample.timestamp - window.secs()) {
+    samples.pop_front();
+  }
+}
+
+
+// Returns the value below which the given fraction of samples are.
+double percentile(const deque<Sample>& samples, double fraction)
+{
+  CHECK(!samples.empty());
+
+  vector<double> values;
+  values.reserve(samples.size());
+
+  foreach (const Sample& sample, samples) {
+    values.push_back(sample.value);
+  }
+
+  size_t index = static_cast<size_t>(ceil(fraction * values.size()));
+  index = std::min(std::max(index, static_cast<size_t>(1)), values.size()) - 1;
+
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+
+  return values[index];
+}
+
+} // namespace {
+
+
+class UsageResourceEstimatorProcess
+  : public Process<UsageResourceEstimatorProcess>
+{
+public:
+  UsageResourceEstimatorProcess(
+      const lambda::function<Future<ResourceUsage>()>& _usage,
+      double _confidence,
+      const Duration& _window,
+      size_t _minSamples,
+      double _minChange)
+    : ProcessBase(process::ID::generate("usage-resource-estimator")),
+      usage(_usage),
+      confidence(_confidence),
+      window(_window),
+      minSamples(_minSamples),
+      minChange(_minChange),
+      cpus(0),
+      mem(0) {}
+
+  Future<Resources> oversubscribable()
+  {
+    return usage().then(defer(self(), &Self::_oversubscribable, lambda::_1));
+  }
+
+  Future<Resources> _oversubscribable(const ResourceUsage& usage)
+  {
+    hashmap<ContainerID, History> histories_;
+
+    Resources allocatedRevocable;
+
+    double cpus_ = 0;
+    double mem_ = 0;
+
+    foreach (const ResourceUsage::Executor& executor, usage.executors()) {
+      allocatedRevocable += Resources(executor.allocated()).revocable();
+
+      const ContainerID& containerId = executor.container_id();
+
+      History history = histories.contains(containerId)
+        ? histories.at(containerId)
+        : History();
+
+      if (executor.has_statistics()) {
+        const ResourceStatistics& statistics = executor.statistics();
+        const double timestamp = statistics.timestamp();
+
+        if (statistics.has_cpus_user_time_secs() &&
+            statistics.has_cpus_system_time_secs()) {
+          const double time =
+            statistics.cpus_user_time_secs() +
+            statistics.cpus_system_time_secs();
+
+          if (history.cpusTime.isSome() &&
+              timestamp > history.cpusTime->first) {
+            const double used =
+              std::max(time - history.cpusTime->second, 0.0) /
+              (timestamp - history.cpusTime->first);
+
+            add(history.cpus, {timestamp, used}, window);
+          }
+
+          history.cpusTime = std::make_pair(timestamp, time);
+        }
+
+        // The total memory usage includes the page cache, which is
+        // conservative since not all of it can be reclaimed.
+        if (statistics.has_mem_total_bytes()) {
+          add(history.mem, {timestamp, (double) statistics.mem_total_bytes()},
+              window);
+        } else if (statistics.has_mem_rss_bytes()) {
+          add(history.mem, {timestamp, (double) statistics.mem_rss_bytes()},
+              window);
+        }
+      }
+
+      histories_[containerId] = history;
+
+      // Only the resources of the executors which are not revocable
+      // themselves can be oversubscribed.
+      const Resources allocated =
+        Resources(executor.allocated()).nonRevocable();
+
+      if (allocated.cpus().isSome() && history.cpus.size() >= minSamples) {
+        cpus_ += std::max(
+            allocated.cpus().get() - percentile(history.cpus, confidence),
+            0.0);
+      }
+
+      if (allocated.mem().isSome() && history.mem.size() >= minSamples) {
+        mem_ += std::max(
+            (double) allocated.mem()->bytes() -
+              percentile(history.mem, confidence),
+            0.0);
+      }
+    }
+
+    // Only keep the histories of the executors which are still running.
+    histories = histories_;
+
+    // Shrink the estimate immediately, but only grow it when it grows
+    // meaningfully, to avoid updating the master on every fluctuation.
+    auto estimate = [this](double previous, double current) {
+      if (current < previous || current - previous > previous * minChange) {
+        return current;
+      }
+
+      return previous;
+    };
+
+    cpus = estimate(cpus, cpus_);
+    mem = estimate(mem, mem_);
+
+    Resources totalRevocable;
+
+    auto revocable = [](const std::string& name, double value) {
+      Resource resource = Resources::parse(name, stringify(value), "*").get();
+      resource.mutable_revocable();
+      return resource;
+    };
+
+    // NOTE: The CPUs are rounded down to hundredths and the memory to
+    // whole megabytes.
+    const double cpusRounded = floor(cpus * 100) / 100;
+    const double memRounded = floor(mem / Megabytes(1).bytes());
+
+    if (cpusRounded > 0) {
+      totalRevocable += revocable("cpus", cpusRounded);
+    }
+
+    if (memRounded > 0) {
+      totalRevocable += revocable("mem", memRounded);
+    }
+
+    auto unallocated = [](const Resources& resources) {
+      Resources result = resources;
+      result.unallocate();
+      return result;
+    };
+
+    return totalRevocable - unallocated(allocatedRevocable);
+  }
+
+private:
+  const lambda::function<Future<ResourceUsage>()> usage;
+  const double confidence;
+  const Duration window;
+  const size_t minSamples;
+  const double minChange;
+
+  hashmap<ContainerID, History> histories;
+
+  // The latest estimate of the oversubscribable CPUs and memory (in
+  // bytes), before subtracting the allocated revocable resources.
+  double cpus;
+  double mem;
+};
+
+
+UsageResourceEstimator::~UsageResourceEstimator()
+{
+  if (process.get() != nullptr) {
+    terminate(process.get());
+    wait(process.get());
+  }
+}
+
+
+Try<Nothing> UsageResourceEstimator::initialize(
+    const lambda::function<Future<ResourceUsage>()>& usage)
+{
+  if (process.get() != nullptr) {
+    return Error("Usage resource estimator has already been initialized");
+  }
+
+  process.reset(new UsageResourceEstimatorProcess(
+      usage, confidence, window, minSamples, minChange));
+
+  spawn(process.get());
+
+  return Nothing();
+}
+
+
+Future<Resources> UsageResourceEstimator::oversubscribable()
+{
+  if (process.get() == nullptr) {
+    return Failure("Usage resource estimator is not initialized");
+  }
+
+  return dispatch(
+      process.get(),
+      &UsageResourceEstimatorProcess::oversubscribable);
+}
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
+
+
+static bool compatible()
+{
+  return true;
+}
+
+
+static ResourceEstimator* create(const Parameters& parameters)
+{
+  double confidence = 0.95;
+  Duration window = Minutes(30);
+  size_t minSamples = 10;
+  double minChange = 0.1;
+
+  foreach (const Parameter& parameter, parameters.parameter()) {
+    if (parameter.key() == "confidence") {
+      Try<double> _confidence = numify<double>(parameter.value());
+      if (_confidence.isError() ||
+          _confidence.get() <= 0 ||
+          _confidence.get() > 1) {
+        LOG(ERROR) << "Invalid confidence '" << parameter.value() << "'";
+        return nullptr;
+      }
+
+      confidence = _confidence.get();
+    } else if (parameter.key() == "window") {
+      Try<Duration> _window = Duration::parse(parameter.value());
+      if (_window.isError() || _window.get() <= Duration::zero()) {
+        LOG(ERROR) << "Invalid window '" << parameter.value() << "'";
+        return nullptr;
+      }
+
+      window = _window.get();
+    } else if (parameter.key() == "min_samples") {
+      Try<size_t> _minSamples = numify<size_t>(parameter.value());
+      if (_minSamples.isError() || _minSamples.get() == 0) {
+        LOG(ERROR) << "Invalid minimum samples '" << parameter.value() << "'";
+        return nullptr;
+      }
+
+      minSamples = _minSamples.get();
+    } else if (parameter.key() == "min_change") {
+      Try<double> _minChange = numify<double>(parameter.value());
+      if (_minChange.isError() || _minChange.get() < 0) {
+        LOG(ERROR) << "Invalid minimum change '" << parameter.value() << "'";
+        return nullptr;
+      }
+
+      minChange = _minChange.get();
+    }
+  }
+
+  return new mesos::internal::slave::UsageResourceEstimator(
+      confidence, window, minSamples, minChange);
+}
+
+
+Module<ResourceEstimator> org_apache_mesos_UsageResourceEstimator(
+    MESOS_MODULE_API_VERSION,
+    MESOS_VERSION,
+    "Apache Mesos",
+    "modules@mesos.apache.org",
+    "Usage Resource Estimator Module.",
+    compatible,
+    create);
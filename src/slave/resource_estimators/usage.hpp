@@ -0,0 +1,81 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __SLAVE_RESOURCE_ESTIMATORS_USAGE_HPP__
+#define __SLAVE_RESOURCE_ESTIMATORS_USAGE_HPP__
+
+#include <mesos/slave/resource_estimator.hpp>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/lambda.hpp>
+#include <stout/try.hpp>
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// Forward declaration.
+class UsageResourceEstimatorProcess;
+
+
+// The `UsageResourceEstimator` estimates the CPUs and memory which
+// are allocated to executors but not used by them during a sliding
+// window of their resource usage samples. The usage of an executor
+// is taken at the `confidence` percentile of its samples within the
+// `window`, and executors with fewer than `minSamples` samples are
+// not oversubscribed at all.
+//
+// To avoid producing a new estimate every time the usage fluctuates,
+// the estimate only grows when it does by more than `minChange`
+// relative to the previous one. It shrinks immediately though, so
+// that revocable executors are not offered resources which are likely
+// to be used by their owners.
+class UsageResourceEstimator : public mesos::slave::ResourceEstimator
+{
+public:
+  UsageResourceEstimator(
+      double _confidence,
+      const Duration& _window,
+      size_t _minSamples,
+      double _minChange)
+    : confidence(_confidence),
+      window(_window),
+      minSamples(_minSamples),
+      minChange(_minChange) {}
+
+  virtual ~UsageResourceEstimator();
+
+  virtual Try<Nothing> initialize(
+      const lambda::function<process::Future<ResourceUsage>()>& usage);
+
+  virtual process::Future<Resources> oversubscribable();
+
+private:
+  const double confidence;
+  const Duration window;
+  const size_t minSamples;
+  const double minChange;
+  process::Owned<UsageResourceEstimatorProcess> process;
+};
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __SLAVE_RESOURCE_ESTIMATORS_USAGE_HPP__
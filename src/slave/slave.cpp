@@ -74,6 +74,8 @@
 
 #include "authentication/cram_md5/authenticatee.hpp"
 
+#include "authentication/token/authenticatee.hpp"
+
 #include "common/build.hpp"
 #include "common/protobuf_utils.hpp"
 #include "common/resources_utils.hpp"
@@ -97,10 +99,13 @@
 #include "slave/compatibility.hpp"
 #include "slave/constants.hpp"
 #include "slave/flags.hpp"
+#include "slave/meta_journal.hpp"
 #include "slave/paths.hpp"
 #include "slave/slave.hpp"
 #include "slave/task_status_update_manager.hpp"
 
+#include "slave/containerizer/mesos/provisioner/docker/paths.hpp"
+
 #ifdef __WINDOWS__
 // Used to install a Windows console ctrl handler.
 // https://msdn.microsoft.com/en-us/library/windows/desktop/ms682066(v=vs.85).aspx
@@ -134,6 +139,7 @@ using std::list;
 using std::map;
 using std::ostream;
 using std::ostringstream;
+using std::pair;
 using std::set;
 using std::shared_ptr;
 using std::string;
@@ -146,8 +152,10 @@ using process::Break;
 using process::Clock;
 using process::Continue;
 using process::ControlFlow;
+using process::Event;
 using process::Failure;
 using process::Future;
+using process::HttpEvent;
 using process::Owned;
 using process::PID;
 using process::Time;
@@ -178,7 +186,8 @@ static string taskOrTaskGroup(
 // Returns the command info for default executor.
 static CommandInfo defaultExecutorCommandInfo(
     const std::string& launcherDir,
-    const Option<std::string>& user);
+    const Option<std::string>& user,
+    bool persistentCommandChecks);
 
 
 Slave::Slave(const string& id,
@@ -217,6 +226,7 @@ Slave::Slave(const string& id,
     authenticated(false),
     reauthenticate(false),
     failedAuthentications(0),
+    authenticatingWithToken(false),
     executorDirectoryMaxAllowedAge(age(0)),
     resourceEstimator(_resourceEstimator),
     qosController(_qosController),
@@ -649,6 +659,15 @@ void Slave::initialize()
       &SlaveReregisteredMessage::reconciliations,
       &SlaveReregisteredMessage::connection);
 
+  install<ReregisterSlaveDetailsMessage>(
+      &Slave::reregistrationDetails,
+      &ReregisterSlaveDetailsMessage::slave_id,
+      &ReregisterSlaveDetailsMessage::framework_ids);
+
+  install<SlaveAdmissionBackoffMessage>(
+      &Slave::admissionBackoff,
+      &SlaveAdmissionBackoffMessage::retry_after_seconds);
+
   install<RunTaskMessage>(
       &Slave::runTask,
       &RunTaskMessage::framework,
@@ -703,6 +722,9 @@ void Slave::initialize()
       &StatusUpdateAcknowledgementMessage::task_id,
       &StatusUpdateAcknowledgementMessage::uuid);
 
+  install<StatusUpdateAcknowledgementsMessage>(
+      &Slave::statusUpdateAcknowledgements);
+
   install<OfferOperationUpdateAcknowledgementMessage>(
       &Slave::offerOperationUpdateAcknowledgement);
 
@@ -738,6 +760,10 @@ void Slave::initialize()
       &Slave::ping,
       &PingSlaveMessage::connected);
 
+  install<AuthenticationTokenMessage>(
+      &Slave::authenticationTokenIssued,
+      &AuthenticationTokenMessage::token);
+
   // Setup the '/api/v1' handler for streaming requests.
   RouteOptions options;
   options.requestStreaming = true;
@@ -865,6 +891,19 @@ void Slave::initialize()
     }
   }
 
+  // Serve the Docker layer tar balls kept by the Docker store to the
+  // agents that use this agent as a peer.
+  if (flags.docker_layer_peers.isSome()) {
+    const string blobsDir = docker::paths::getBlobsDir(flags.docker_store_dir);
+
+    files->attach(blobsDir, DOCKER_BLOBS_VIRTUAL_PATH)
+      .onAny(defer(self(),
+                   &Self::fileAttached,
+                   lambda::_1,
+                   blobsDir,
+                   DOCKER_BLOBS_VIRTUAL_PATH));
+  }
+
   // Check that the reconfiguration_policy flag is valid.
   if (flags.reconfiguration_policy != "equal" &&
       flags.reconfiguration_policy != "additive") {
@@ -896,6 +935,23 @@ void Slave::initialize()
   }
 #endif  // __WINDOWS__
 
+  // Set up the journal of the checkpointed state before recovering it,
+  // see `--meta_journal`.
+  Try<Nothing> journal = flags.meta_journal
+    ? MetaJournal::enable(metaDir)
+    : MetaJournal::disable(metaDir);
+
+  if (journal.isError()) {
+    LOG(WARNING) << "Not using the meta journal: " << journal.error();
+
+    // NOTE: A journal we don't use must be removed since it would
+    // otherwise get out of date with the checkpointed files.
+    Try<Nothing> disable = MetaJournal::disable(metaDir);
+    if (disable.isError()) {
+      EXIT(EXIT_FAILURE) << disable.error();
+    }
+  }
+
   // Do recovery.
   async(&state::recover, metaDir, flags.strict)
     .then(defer(self(), &Slave::recover, lambda::_1))
@@ -926,6 +982,24 @@ void Slave::finalize()
       shutdownFramework(UPID(), frameworkId);
     }
   }
+
+  // NOTE: Files checkpointed from now on (e.g., the forked pid of a
+  // container still being launched) don't get journaled, which is fine
+  // since recovery reads the files the journal has no record of.
+  MetaJournal::close(metaDir);
+}
+
+
+void Slave::serve(Event&& event)
+{
+  // Apart from `GET` requests, any event might change the state of the
+  // agent, which invalidates the cached views of the agent.
+  if (!event.is<HttpEvent>() ||
+      event.as<HttpEvent>().request->method != "GET") {
+    generation++;
+  }
+
+  ProtobufProcess<Slave>::serve(std::move(event));
 }
 
 
@@ -1016,6 +1090,14 @@ void Slave::detected(const Future<Option<MasterInfo>>& _master)
     EXIT(EXIT_FAILURE) << "Failed to detect a master: " << _master.failure();
   }
 
+  masterCapabilities = protobuf::master::Capabilities();
+  detailedFrameworks.clear();
+  detailedReregistration = false;
+
+  // Any updates still batched for the previous master get retried by
+  // the task status update manager once it is resumed.
+  statusUpdates.Clear();
+
   Option<MasterInfo> latest;
 
   if (_master.isDiscarded()) {
@@ -1029,6 +1111,7 @@ void Slave::detected(const Future<Option<MasterInfo>>& _master)
   } else {
     latest = _master.get();
     master = UPID(latest->pid());
+    masterCapabilities = protobuf::master::Capabilities(latest->capabilities());
 
     LOG(INFO) << "New master detected at " << master.get();
 
@@ -1043,9 +1126,6 @@ void Slave::detected(const Future<Option<MasterInfo>>& _master)
     }
 
     if (requiredMasterCapabilities.agentUpdate) {
-      protobuf::master::Capabilities masterCapabilities(
-          latest->capabilities());
-
       if (!masterCapabilities.agentUpdate) {
         EXIT(EXIT_FAILURE) <<
           "Agent state changed on restart, but the detected master lacks the "
@@ -1120,7 +1200,14 @@ void Slave::authenticate()
 
   CHECK(authenticatee == nullptr);
 
-  if (authenticateeName == DEFAULT_AUTHENTICATEE) {
+  // A token is only tried once: the master hands out a new one after
+  // each successful authentication.
+  if (reauthenticationToken.isSome()) {
+    LOG(INFO) << "Using the authentication token issued by the master";
+    authenticatee = new token::TokenAuthenticatee(reauthenticationToken.get());
+    reauthenticationToken = None();
+    authenticatingWithToken = true;
+  } else if (authenticateeName == DEFAULT_AUTHENTICATEE) {
     LOG(INFO) << "Using default CRAM-MD5 authenticatee";
     authenticatee = new cram_md5::CRAMMD5Authenticatee();
   }
@@ -1152,6 +1239,9 @@ void Slave::_authenticate()
   delete CHECK_NOTNULL(authenticatee);
   authenticatee = nullptr;
 
+  const bool withToken = authenticatingWithToken;
+  authenticatingWithToken = false;
+
   CHECK_SOME(authenticating);
   const Future<bool>& future = authenticating.get();
 
@@ -1167,6 +1257,19 @@ void Slave::_authenticate()
     return;
   }
 
+  if (withToken && !reauthenticate && (!future.isReady() || !future.get())) {
+    LOG(INFO)
+      << "Failed to authenticate with master " << master.get()
+      << " using the authentication token: "
+      << (future.isFailed() ? future.failure() :
+         (future.isReady() ? "refused" : "future discarded"));
+
+    // Retry right away with the authenticatee.
+    authenticating = None();
+    authenticate();
+    return;
+  }
+
   if (reauthenticate || !future.isReady()) {
     LOG(WARNING)
       << "Failed to authenticate with master " << master.get() << ": "
@@ -1228,6 +1331,19 @@ void Slave::authenticationTimeout(Future<bool> future)
 }
 
 
+void Slave::authenticationTokenIssued(const UPID& from, const string& token)
+{
+  if (master != from) {
+    LOG(WARNING) << "Ignoring authentication token from " << from
+                 << " because it is not the expected master: "
+                 << (master.isSome() ? stringify(master.get()) : "None");
+    return;
+  }
+
+  reauthenticationToken = token;
+}
+
+
 void Slave::registered(
     const UPID& from,
     const SlaveID& slaveId,
@@ -1563,9 +1679,59 @@ void Slave::doReliableRegistration(Duration maxBackoff)
 
     message.mutable_slave()->CopyFrom(slaveInfo);
 
+    // Unless the master asked for them, we only send digests of the
+    // tasks and executors of frameworks, which saves the master from
+    // going through all of them if it already knows about them.
+    const bool digests =
+      flags.reregistration_digests &&
+      masterCapabilities.agentReregistrationDigests &&
+      !detailedReregistration;
+
     foreachvalue (Framework* framework, frameworks) {
       message.add_frameworks()->CopyFrom(framework->info);
 
+      if (digests && !detailedFrameworks.contains(framework->id())) {
+        // NOTE: These are the IDs of the tasks and executors that we
+        // would otherwise send, see below.
+        vector<TaskID> taskIds;
+        vector<ExecutorID> executorIds;
+
+        typedef hashmap<TaskID, TaskInfo> TaskMap;
+        foreachvalue (const TaskMap& tasks, framework->pendingTasks) {
+          foreachkey (const TaskID& taskId, tasks) {
+            taskIds.push_back(taskId);
+          }
+        }
+
+        foreachvalue (Executor* executor, framework->executors) {
+          foreachkey (const TaskID& taskId, executor->launchedTasks) {
+            taskIds.push_back(taskId);
+          }
+
+          foreachkey (const TaskID& taskId, executor->terminatedTasks) {
+            taskIds.push_back(taskId);
+          }
+
+          foreachkey (const TaskID& taskId, executor->queuedTasks) {
+            taskIds.push_back(taskId);
+          }
+
+          if (!executor->isCommandExecutor() &&
+              executor->state != Executor::TERMINATED) {
+            executorIds.push_back(executor->id);
+          }
+        }
+
+        ReregisterSlaveMessage::FrameworkDigest* digest =
+          message.add_framework_digests();
+
+        digest->mutable_framework_id()->CopyFrom(framework->id());
+        digest->set_digest(
+            protobuf::slave::createFrameworkDigest(taskIds, executorIds));
+
+        continue;
+      }
+
       // TODO(bmahler): We need to send the executors for these
       // pending tasks, and we need to send exited events if they
       // cannot be launched, see MESOS-1715, MESOS-1720, MESOS-1800.
@@ -1613,37 +1779,41 @@ void Slave::doReliableRegistration(Duration maxBackoff)
       }
     }
 
-    // Add completed frameworks.
-    foreachvalue (const Owned<Framework>& completedFramework,
-                  completedFrameworks) {
-      VLOG(1) << "Reregistering completed framework "
+    // Add completed frameworks. These are only needed by a master that
+    // does not know about the agent's tasks, so we don't send them
+    // along with digests.
+    if (message.framework_digests_size() == 0) {
+      foreachvalue (const Owned<Framework>& completedFramework,
+                    completedFrameworks) {
+        VLOG(1) << "Reregistering completed framework "
                 << completedFramework->id();
 
-      Archive::Framework* completedFramework_ =
-        message.add_completed_frameworks();
+        Archive::Framework* completedFramework_ =
+          message.add_completed_frameworks();
 
-      completedFramework_->mutable_framework_info()->CopyFrom(
-          completedFramework->info);
+        completedFramework_->mutable_framework_info()->CopyFrom(
+            completedFramework->info);
 
-      if (completedFramework->pid.isSome()) {
-        completedFramework_->set_pid(completedFramework->pid.get());
-      }
+        if (completedFramework->pid.isSome()) {
+          completedFramework_->set_pid(completedFramework->pid.get());
+        }
 
-      foreach (const Owned<Executor>& executor,
-               completedFramework->completedExecutors) {
-        VLOG(2) << "Reregistering completed executor '" << executor->id
-                << "' with " << executor->terminatedTasks.size()
-                << " terminated tasks, " << executor->completedTasks.size()
-                << " completed tasks";
+        foreach (const Owned<Executor>& executor,
+                 completedFramework->completedExecutors) {
+          VLOG(2) << "Reregistering completed executor '" << executor->id
+                  << "' with " << executor->terminatedTasks.size()
+                  << " terminated tasks, " << executor->completedTasks.size()
+                  << " completed tasks";
 
-        foreachvalue (const Task* task, executor->terminatedTasks) {
-          VLOG(2) << "Reregistering terminated task " << task->task_id();
-          completedFramework_->add_tasks()->CopyFrom(*task);
-        }
+          foreachvalue (const Task* task, executor->terminatedTasks) {
+            VLOG(2) << "Reregistering terminated task " << task->task_id();
+            completedFramework_->add_tasks()->CopyFrom(*task);
+          }
 
-        foreach (const shared_ptr<Task>& task, executor->completedTasks) {
-          VLOG(2) << "Reregistering completed task " << task->task_id();
-          completedFramework_->add_tasks()->CopyFrom(*task);
+          foreach (const shared_ptr<Task>& task, executor->completedTasks) {
+            VLOG(2) << "Reregistering completed task " << task->task_id();
+            completedFramework_->add_tasks()->CopyFrom(*task);
+          }
         }
       }
     }
@@ -1694,6 +1864,79 @@ void Slave::doReliableRegistration(Duration maxBackoff)
 }
 
 
+void Slave::reregistrationDetails(
+    const UPID& from,
+    const SlaveID& slaveId,
+    const vector<FrameworkID>& frameworkIds)
+{
+  if (master != from) {
+    LOG(WARNING) << "Ignoring re-registration details request from " << from
+                 << " because it is not the expected master: "
+                 << (master.isSome() ? stringify(master.get()) : "None");
+    return;
+  }
+
+  if (state != DISCONNECTED || info.id() != slaveId) {
+    LOG(WARNING) << "Ignoring re-registration details request from " << from
+                 << " for agent " << slaveId << " in state " << state;
+    return;
+  }
+
+  if (frameworkIds.empty()) {
+    LOG(INFO) << "Master asked for all tasks and executors";
+
+    detailedReregistration = true;
+  } else {
+    LOG(INFO) << "Master asked for the tasks and executors of frameworks "
+              << stringify(frameworkIds);
+
+    detailedFrameworks.insert(frameworkIds.begin(), frameworkIds.end());
+  }
+
+  // Re-register right away rather than waiting for the next retry,
+  // which replaces the pending one.
+  Clock::cancel(agentRegistrationTimer);
+
+  doReliableRegistration(flags.registration_backoff_factor * 2);
+}
+
+
+void Slave::admissionBackoff(const UPID& from, double retryAfterSeconds)
+{
+  if (master != from) {
+    LOG(WARNING) << "Ignoring admission backoff from " << from
+                 << " because it is not the expected master: "
+                 << (master.isSome() ? stringify(master.get()) : "None");
+    return;
+  }
+
+  if (state != DISCONNECTED) {
+    LOG(WARNING) << "Ignoring admission backoff from " << from
+                 << " in state " << state;
+    return;
+  }
+
+  // The master will (re-)register the agent by itself once its turn
+  // comes, so we only retry in case the master loses track of it. We
+  // add a random amount of time to avoid all the agents that got
+  // queued retrying at once.
+  Duration delay = Seconds(retryAfterSeconds) +
+    flags.registration_backoff_factor * ((double) os::random() / RAND_MAX);
+
+  LOG(INFO) << "Master queued the (re-)registration of the agent;"
+            << " will retry in " << delay << " if necessary";
+
+  // Replace the pending retry, restarting the backoff.
+  Clock::cancel(agentRegistrationTimer);
+
+  agentRegistrationTimer = process::delay(
+      delay,
+      self(),
+      &Slave::doReliableRegistration,
+      flags.registration_backoff_factor * 2);
+}
+
+
 // TODO(vinod): Instead of crashing the slave on checkpoint errors,
 // send TASK_LOST to the framework.
 void Slave::runTask(
@@ -1886,11 +2129,15 @@ void Slave::run(
   const ExecutorID& executorId = executorInfo.executor_id();
 
   if (HookManager::hooksAvailable()) {
-    // Set task labels from run task label decorator.
-    for (auto it = tasks.begin(); it != tasks.end(); ++it) {
-      (*it).mutable_labels()->CopyFrom(
-          HookManager::slaveRunTaskLabelDecorator(
-              (*it), executorInfo, frameworkInfo, info));
+    // Set task labels from run task label decorator, decorating all
+    // the tasks of a task group in a single batch.
+    const vector<Labels> labels = HookManager::slaveRunTaskLabelDecorator(
+        tasks, executorInfo, frameworkInfo, info);
+
+    CHECK_EQ(tasks.size(), labels.size());
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      tasks[i].mutable_labels()->CopyFrom(labels[i]);
     }
 
     // Update `task`/`taskGroup` to reflect the task label updates.
@@ -2541,9 +2788,7 @@ void Slave::__run(
     }
     case Executor::REGISTERING:
       if (executor->checkpoint) {
-        foreach (const TaskInfo& _task, tasks) {
-          executor->checkpointTask(_task);
-        }
+        executor->checkpointTasks(tasks);
       }
 
       if (taskGroup.isSome()) {
@@ -2560,9 +2805,7 @@ void Slave::__run(
       break;
     case Executor::RUNNING: {
       if (executor->checkpoint) {
-        foreach (const TaskInfo& _task, tasks) {
-          executor->checkpointTask(_task);
-        }
+        executor->checkpointTasks(tasks);
       }
 
       // Queue tasks until the containerizer is updated
@@ -2949,7 +3192,10 @@ void Slave::launchExecutor(
     CHECK(!executorInfo_.has_command());
 
     executorInfo_.mutable_command()->CopyFrom(
-        defaultExecutorCommandInfo(flags.launcher_dir, executor->user));
+        defaultExecutorCommandInfo(
+            flags.launcher_dir,
+            executor->user,
+            flags.persistent_command_checks));
   }
 
   Resources resources = executorInfo_.resources();
@@ -3915,6 +4161,22 @@ void Slave::reconcileOfferOperations(
 }
 
 
+void Slave::statusUpdateAcknowledgements(
+    const UPID& from,
+    StatusUpdateAcknowledgementsMessage&& message)
+{
+  foreach (const StatusUpdateAcknowledgementMessage& acknowledgement,
+           message.acknowledgements()) {
+    statusUpdateAcknowledgement(
+        from,
+        acknowledgement.slave_id(),
+        acknowledgement.framework_id(),
+        acknowledgement.task_id(),
+        acknowledgement.uuid());
+  }
+}
+
+
 void Slave::statusUpdateAcknowledgement(
     const UPID& from,
     const SlaveID& slaveId,
@@ -5228,7 +5490,50 @@ void Slave::forward(StatusUpdate update)
   message.mutable_update()->MergeFrom(update);
   message.set_pid(self()); // The ACK will be first received by the slave.
 
-  send(master.get(), message);
+  const Duration interval = flags.status_update_flush_interval;
+
+  if (interval == Duration::zero() || !masterCapabilities.statusUpdateBatches) {
+    send(master.get(), message);
+    return;
+  }
+
+  *statusUpdates.add_updates() = std::move(message);
+
+  if (statusUpdates.updates_size() >=
+        static_cast<int>(flags.max_status_update_batch_size)) {
+    flushStatusUpdates();
+  } else if (!flushingStatusUpdates) {
+    flushingStatusUpdates = true;
+    delay(interval, self(), &Slave::flushStatusUpdates);
+  }
+}
+
+
+void Slave::flushStatusUpdates()
+{
+  // NOTE: A pending `delay()` may still fire after an early flush due
+  // to the batch being full, in which case we might forward a smaller
+  // batch sooner than necessary, which is harmless.
+  flushingStatusUpdates = false;
+
+  if (statusUpdates.updates_size() == 0) {
+    return;
+  }
+
+  // The task status update manager retries the updates that don't
+  // make it to the master, so we can drop the batch here.
+  if (state != RUNNING || master.isNone()) {
+    LOG(WARNING) << "Dropping " << statusUpdates.updates_size()
+                 << " batched status updates because the agent is in "
+                 << state << " state";
+  } else {
+    VLOG(1) << "Forwarding " << statusUpdates.updates_size()
+            << " batched status updates to " << master.get();
+
+    send(master.get(), statusUpdates);
+  }
+
+  statusUpdates.Clear();
 }
 
 
@@ -5866,6 +6171,8 @@ void Slave::removeExecutor(Framework* framework, Executor* executor)
   // Check that this executor has terminated.
   CHECK(executor->state == Executor::TERMINATED) << executor->state;
 
+  containerUsages.erase(executor->containerId);
+
   // Check that either 1) the executor has no tasks with pending
   // updates or 2) the slave/framework is terminating, because no
   // acknowledgements might be received.
@@ -7677,7 +7984,7 @@ Future<ResourceUsage> Slave::usage()
         }
       }
 
-      futures.push_back(containerizer->usage(executor->containerId));
+      futures.push_back(containerUsage(executor->containerId));
     }
   }
 
@@ -7711,6 +8018,36 @@ Future<ResourceUsage> Slave::usage()
 }
 
 
+Future<ResourceStatistics> Slave::containerUsage(
+    const ContainerID& containerId)
+{
+  if (flags.container_usage_cache_ttl == Duration::zero()) {
+    return containerizer->usage(containerId);
+  }
+
+  const Time now = Clock::now();
+
+  // Reuse the statistics unless they are stale or could not be
+  // collected. Statistics that are still being collected are shared
+  // as well, so that concurrent requests only collect them once.
+  Option<pair<Time, Future<ResourceStatistics>>> cached =
+    containerUsages.get(containerId);
+
+  if (cached.isSome() &&
+      !cached->second.isFailed() &&
+      !cached->second.isDiscarded() &&
+      now - cached->first < flags.container_usage_cache_ttl) {
+    return cached->second;
+  }
+
+  Future<ResourceStatistics> usage = containerizer->usage(containerId);
+
+  containerUsages[containerId] = std::make_pair(now, usage);
+
+  return usage;
+}
+
+
 // As a principle, we do not need to re-authorize actions that have already
 // been authorized by the master. However, we re-authorize the RUN_TASK action
 // on the agent even though the master has already authorized it because:
@@ -8902,6 +9239,35 @@ void Executor::checkpointTask(const Task& task)
 }
 
 
+void Executor::checkpointTasks(const vector<TaskInfo>& tasks)
+{
+  CHECK(checkpoint);
+
+  vector<pair<string, Task>> checkpoints;
+  checkpoints.reserve(tasks.size());
+
+  foreach (const TaskInfo& task, tasks) {
+    const string path = paths::getTaskInfoPath(
+        slave->metaDir,
+        slave->info.id(),
+        frameworkId,
+        id,
+        containerId,
+        task.task_id());
+
+    VLOG(1) << "Checkpointing TaskInfo to '" << path << "'";
+
+    // See `checkpointTask()` for why the resources are downgraded.
+    Task task_ = protobuf::createTask(task, TASK_STAGING, frameworkId);
+    downgradeResources(task_.mutable_resources());
+
+    checkpoints.emplace_back(path, std::move(task_));
+  }
+
+  CHECK_SOME(state::checkpoint(checkpoints));
+}
+
+
 void Executor::recoverTask(const TaskState& state, bool recheckpointTask)
 {
   if (state.info.isNone()) {
@@ -9279,7 +9645,8 @@ static string taskOrTaskGroup(
 
 static CommandInfo defaultExecutorCommandInfo(
     const string& launcherDir,
-    const Option<string>& user)
+    const Option<string>& user,
+    bool persistentCommandChecks)
 {
   Result<string> path = os::realpath(
       path::join(launcherDir, MESOS_DEFAULT_EXECUTOR));
@@ -9290,6 +9657,10 @@ static CommandInfo defaultExecutorCommandInfo(
     commandInfo.set_value(path.get());
     commandInfo.add_arguments(MESOS_DEFAULT_EXECUTOR);
     commandInfo.add_arguments("--launcher_dir=" + launcherDir);
+
+    if (persistentCommandChecks) {
+      commandInfo.add_arguments("--persistent_command_checks");
+    }
   } else {
     commandInfo.set_shell(true);
     commandInfo.set_value(
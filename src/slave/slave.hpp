@@ -22,6 +22,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/circular_buffer.hpp>
@@ -53,6 +54,7 @@
 #include <process/process.hpp>
 #include <process/protobuf.hpp>
 #include <process/shared.hpp>
+#include <process/time.hpp>
 
 #include <stout/boundedhashmap.hpp>
 #include <stout/bytes.hpp>
@@ -142,6 +144,18 @@ public:
 
   void doReliableRegistration(Duration maxBackoff);
 
+  // Handles the master asking the agent to re-register with the tasks
+  // and executors of the given frameworks (or of all frameworks, if
+  // none are given) rather than digests of them.
+  void reregistrationDetails(
+      const process::UPID& from,
+      const SlaveID& slaveId,
+      const std::vector<FrameworkID>& frameworkIds);
+
+  // Handles the master asking the agent to hold off retrying to
+  // (re-)register because the master has queued the (re-)registration.
+  void admissionBackoff(const process::UPID& from, double retryAfterSeconds);
+
   // Made 'virtual' for Slave mocking.
   virtual void runTask(
       const process::UPID& from,
@@ -293,6 +307,10 @@ public:
   // added to the update before forwarding.
   void forward(StatusUpdate update);
 
+  // Forwards the batch of status updates pending for the master, if
+  // any (see `--status_update_flush_interval`).
+  void flushStatusUpdates();
+
   void statusUpdateAcknowledgement(
       const process::UPID& from,
       const SlaveID& slaveId,
@@ -300,6 +318,10 @@ public:
       const TaskID& taskId,
       const std::string& uuid);
 
+  void statusUpdateAcknowledgements(
+      const process::UPID& from,
+      StatusUpdateAcknowledgementsMessage&& message);
+
   void offerOperationUpdateAcknowledgement(
       const process::UPID& from,
       const OfferOperationUpdateAcknowledgementMessage& acknowledgement);
@@ -369,6 +391,8 @@ public:
   virtual void finalize();
   virtual void exited(const process::UPID& pid);
 
+  virtual void serve(process::Event&& event);
+
   void __run(
       const process::Future<std::list<bool>>& future,
       const FrameworkInfo& frameworkInfo,
@@ -497,6 +521,12 @@ public:
   // Returns the resource usage information for all executors.
   virtual process::Future<ResourceUsage> usage();
 
+  // Returns the resource statistics of the container. Statistics that
+  // were requested from the containerizer within the last
+  // `--container_usage_cache_ttl` are reused.
+  process::Future<ResourceStatistics> containerUsage(
+      const ContainerID& containerId);
+
   // Handle the second phase of shutting down an executor for those
   // executors that have not properly shutdown within a timeout.
   void shutdownExecutorTimeout(
@@ -517,6 +547,12 @@ private:
   void _authenticate();
   void authenticationTimeout(process::Future<bool> future);
 
+  // Keeps the token issued by the master to authenticate again after
+  // a master failover.
+  void authenticationTokenIssued(
+      const process::UPID& from,
+      const std::string& token);
+
   // Shut down an executor. This is a two phase process. First, an
   // executor receives a shut down message (shut down phase), then
   // after a configurable timeout the slave actually forces a kill
@@ -648,6 +684,25 @@ private:
 
   Option<process::UPID> master;
 
+  // The capabilities of the current master, if any.
+  protobuf::master::Capabilities masterCapabilities;
+
+  // The frameworks whose tasks and executors the current master asked
+  // for when the agent re-registered with digests of them, or whether
+  // it asked for those of all frameworks (see `reregistrationDetails()`).
+  hashset<FrameworkID> detailedFrameworks;
+  bool detailedReregistration = false;
+
+  // Status updates waiting to be forwarded to the master in a batch.
+  StatusUpdatesMessage statusUpdates;
+  bool flushingStatusUpdates = false;
+
+  // The statistics of containers along with when they were requested
+  // from the containerizer (see `containerUsage()`).
+  hashmap<ContainerID,
+          std::pair<process::Time, process::Future<ResourceStatistics>>>
+    containerUsages;
+
   hashmap<FrameworkID, Framework*> frameworks;
 
   // Note that these frameworks are "completed" only in that
@@ -670,6 +725,10 @@ private:
 
   process::Time startTime;
 
+  // Incremented before serving any event that might change the state
+  // of the agent, see `Slave::serve()`.
+  uint64_t generation = 0;
+
   GarbageCollector* gc;
 
   TaskStatusUpdateManager* taskStatusUpdateManager;
@@ -712,6 +771,14 @@ private:
   // Indicates the number of failed authentication attempts.
   uint64_t failedAuthentications;
 
+  // The token issued by the master after the last authentication, if
+  // any, which is used instead of the authenticatee in the next
+  // authentication attempt.
+  Option<std::string> reauthenticationToken;
+
+  // Indicates if the authentication attempt in progress uses a token.
+  bool authenticatingWithToken;
+
   // Maximum age of executor directories. Will be recomputed
   // periodically every flags.disk_watch_interval.
   Duration executorDirectoryMaxAllowedAge;
@@ -803,6 +870,10 @@ public:
   void checkpointTask(const TaskInfo& task);
   void checkpointTask(const Task& task);
 
+  // Checkpoints the tasks in one batch (e.g., the tasks of a task
+  // group), see `state::checkpoint()`.
+  void checkpointTasks(const std::vector<TaskInfo>& tasks);
+
   void recoverTask(const state::TaskState& state, bool recheckpointTask);
 
   Try<Nothing> updateTaskState(const TaskStatus& status);
@@ -14,9 +14,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License
 
+#include <stdint.h>
+#include <string.h>
+
 #include <glog/logging.h>
 
 #include <iostream>
+#include <memory>
 
 #include <process/pid.hpp>
 
@@ -28,6 +32,7 @@
 #include <stout/numify.hpp>
 #include <stout/path.hpp>
 #include <stout/protobuf.hpp>
+#include <stout/stringify.hpp>
 #include <stout/strings.hpp>
 #include <stout/try.hpp>
 
@@ -48,6 +53,7 @@
 
 #include "messages/messages.hpp"
 
+#include "slave/meta_journal.hpp"
 #include "slave/paths.hpp"
 #include "slave/state.hpp"
 
@@ -58,9 +64,78 @@ namespace state {
 
 using std::list;
 using std::max;
+using std::shared_ptr;
 using std::string;
 
 
+namespace {
+
+// Reads the checkpointed file at `path`, from the meta journal if it
+// has a record of the file. Otherwise the file gets journaled, e.g.,
+// when recovering with the journal for the first time.
+Try<string> readCheckpoint(const string& path)
+{
+  shared_ptr<MetaJournal> journal = MetaJournal::find(path);
+  if (!journal) {
+    return os::read(path);
+  }
+
+  const Option<string> data = journal->read(path);
+  if (data.isSome()) {
+    return data.get();
+  }
+
+  Try<string> read = os::read(path);
+  if (read.isSome()) {
+    journal->checkpoint(path, read.get());
+  }
+
+  return read;
+}
+
+
+// Same as `::protobuf::read()`, but through `readCheckpoint()` if the
+// meta journal is enabled.
+template <typename T>
+Result<T> readCheckpoint(const string& path)
+{
+  if (!MetaJournal::find(path)) {
+    return ::protobuf::read<T>(path);
+  }
+
+  Try<string> data = readCheckpoint(path);
+  if (data.isError()) {
+    return Error(data.error());
+  }
+
+  if (data->empty()) {
+    return None();
+  }
+
+  uint32_t size;
+  if (data->size() < sizeof(size)) {
+    return Error("Failed to read size: hit EOF unexpectedly");
+  }
+
+  memcpy(&size, data->data(), sizeof(size));
+
+  if (data->size() - sizeof(size) < size) {
+    return Error(
+        "Failed to read message of size " + stringify(size) +
+        " bytes: hit EOF unexpectedly");
+  }
+
+  T message;
+  if (!message.ParseFromArray(data->data() + sizeof(size), size)) {
+    return Error("Failed to deserialize message");
+  }
+
+  return message;
+}
+
+} // namespace {
+
+
 Try<State> recover(const string& rootDir, bool strict)
 {
   LOG(INFO) << "Recovering state from '" << rootDir << "'";
@@ -130,6 +205,19 @@ Try<State> recover(const string& rootDir, bool strict)
 
   state.slave = slave.get();
 
+  // From now on the meta journal, if any, only needs the records of
+  // the files that still exist.
+  shared_ptr<MetaJournal> journal =
+    MetaJournal::find(paths::getMetaJournalPath(rootDir));
+
+  if (journal) {
+    Try<Nothing> compact = journal->compact();
+    if (compact.isError()) {
+      LOG(WARNING) << "Failed to compact the meta journal: "
+                   << compact.error();
+    }
+  }
+
   return state;
 }
 
@@ -151,7 +239,7 @@ Try<SlaveState> SlaveState::recover(
     return state;
   }
 
-  Result<SlaveInfo> slaveInfo = ::protobuf::read<SlaveInfo>(path);
+  Result<SlaveInfo> slaveInfo = readCheckpoint<SlaveInfo>(path);
 
   if (slaveInfo.isError()) {
     const string& message = "Failed to read agent info from '" + path + "': " +
@@ -228,7 +316,7 @@ Try<FrameworkState> FrameworkState::recover(
   }
 
   const Result<FrameworkInfo>& frameworkInfo =
-    ::protobuf::read<FrameworkInfo>(path);
+    readCheckpoint<FrameworkInfo>(path);
 
   if (frameworkInfo.isError()) {
     message = "Failed to read framework info from '" + path + "': " +
@@ -261,7 +349,7 @@ Try<FrameworkState> FrameworkState::recover(
     return state;
   }
 
-  Try<string> pid = os::read(path);
+  Try<string> pid = readCheckpoint(path);
 
   if (pid.isError()) {
     message =
@@ -394,7 +482,7 @@ Try<ExecutorState> ExecutorState::recover(
     return state;
   }
 
-  Result<ExecutorInfo> executorInfo = ::protobuf::read<ExecutorInfo>(path);
+  Result<ExecutorInfo> executorInfo = readCheckpoint<ExecutorInfo>(path);
 
   if (executorInfo.isError()) {
     message = "Failed to read executor info from '" + path + "': " +
@@ -488,7 +576,7 @@ Try<RunState> RunState::recover(
     return state;
   }
 
-  Try<string> pid = os::read(path);
+  Try<string> pid = readCheckpoint(path);
 
   if (pid.isError()) {
     message = "Failed to read executor forked pid from '" + path +
@@ -524,7 +612,7 @@ Try<RunState> RunState::recover(
       rootDir, slaveId, frameworkId, executorId, containerId);
 
   if (os::exists(path)) {
-    pid = os::read(path);
+    pid = readCheckpoint(path);
 
     if (pid.isError()) {
       message = "Failed to read executor libprocess pid from '" + path +
@@ -595,7 +683,7 @@ Try<TaskState> TaskState::recover(
     return state;
   }
 
-  Result<Task> task = ::protobuf::read<Task>(path);
+  Result<Task> task = readCheckpoint<Task>(path);
 
   if (task.isError()) {
     message = "Failed to read task info from '" + path + "': " + task.error();
@@ -21,6 +21,9 @@
 #include <unistd.h>
 #endif // __WINDOWS__
 
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <mesos/resources.hpp>
@@ -28,6 +31,7 @@
 
 #include <process/pid.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
 #include <stout/path.hpp>
@@ -38,6 +42,7 @@
 
 #include <stout/os/mkdir.hpp>
 #include <stout/os/mktemp.hpp>
+#include <stout/os/read.hpp>
 #include <stout/os/rename.hpp>
 #include <stout/os/rm.hpp>
 #include <stout/os/write.hpp>
@@ -46,6 +51,8 @@
 
 #include "messages/messages.hpp"
 
+#include "slave/meta_journal.hpp"
+
 namespace mesos {
 namespace internal {
 namespace slave {
@@ -103,6 +110,82 @@ Try<Nothing> checkpoint(
 }  // namespace internal {
 
 
+namespace internal {
+
+// Writes an instance of T to a new temporary file next to `path`,
+// whose base directory must exist, and returns the temporary file.
+//
+// NOTE: We create the temporary file at 'base/XXXXXX' to make sure
+// the rename in `commit()` does not cross devices (MESOS-2319).
+//
+// TODO(jieyu): It's possible that the temporary file becomes
+// dangling if slave crashes or restarts while checkpointing.
+// Consider adding a way to garbage collect them.
+template <typename T>
+Try<std::string> stage(const std::string& path, const T& t)
+{
+  Try<std::string> temp =
+    os::mktemp(path::join(Path(path).dirname(), "XXXXXX"));
+
+  if (temp.isError()) {
+    return Error("Failed to create temporary file: " + temp.error());
+  }
+
+  // Now checkpoint the instance of T to the temporary file.
+  Try<Nothing> checkpoint = internal::checkpoint(temp.get(), t);
+  if (checkpoint.isError()) {
+    // Try removing the temporary file on error.
+    os::rm(temp.get());
+
+    return Error("Failed to write temporary file '" + temp.get() +
+                 "': " + checkpoint.error());
+  }
+
+  return temp.get();
+}
+
+
+// Atomically moves the temporary file written by `stage()` to `path`.
+//
+// If the file is under a journaled meta directory (see `MetaJournal`),
+// its content is journaled before it is moved to the desired path.
+inline Try<Nothing> commit(const std::string& temp, const std::string& path)
+{
+  std::shared_ptr<MetaJournal> journal = MetaJournal::find(path);
+
+  if (journal) {
+    Try<std::string> data = os::read(temp);
+    if (data.isError()) {
+      // Try removing the temporary file on error.
+      os::rm(temp);
+
+      return Error("Failed to read temporary file '" + temp +
+                   "': " + data.error());
+    }
+
+    journal->checkpoint(path, data.get());
+  }
+
+  // Rename the temporary file to the path.
+  Try<Nothing> rename = os::rename(temp, path);
+  if (rename.isError()) {
+    // Try removing the temporary file on error.
+    os::rm(temp);
+
+    if (journal) {
+      journal->remove(path);
+    }
+
+    return Error("Failed to rename '" + temp + "' to '" +
+                 path + "': " + rename.error());
+  }
+
+  return Nothing();
+}
+
+}  // namespace internal {
+
+
 // Thin wrapper to checkpoint data to disk and perform the necessary
 // error checking. It checkpoints an instance of T at the given path.
 // We can checkpoint anything as long as T is supported by
@@ -126,35 +209,68 @@ Try<Nothing> checkpoint(const std::string& path, const T& t)
     return Error("Failed to create directory '" + base + "': " + mkdir.error());
   }
 
-  // NOTE: We create the temporary file at 'base/XXXXXX' to make sure
-  // rename below does not cross devices (MESOS-2319).
-  //
-  // TODO(jieyu): It's possible that the temporary file becomes
-  // dangling if slave crashes or restarts while checkpointing.
-  // Consider adding a way to garbage collect them.
-  Try<std::string> temp = os::mktemp(path::join(base, "XXXXXX"));
+  Try<std::string> temp = internal::stage(path, t);
   if (temp.isError()) {
-    return Error("Failed to create temporary file: " + temp.error());
+    return Error(temp.error());
   }
 
-  // Now checkpoint the instance of T to the temporary file.
-  Try<Nothing> checkpoint = internal::checkpoint(temp.get(), t);
-  if (checkpoint.isError()) {
-    // Try removing the temporary file on error.
-    os::rm(temp.get());
+  return internal::commit(temp.get(), path);
+}
 
-    return Error("Failed to write temporary file '" + temp.get() +
-                 "': " + checkpoint.error());
-  }
 
-  // Rename the temporary file to the path.
-  Try<Nothing> rename = os::rename(temp.get(), path);
-  if (rename.isError()) {
-    // Try removing the temporary file on error.
-    os::rm(temp.get());
+// Checkpoints a batch of instances of T, each at its path, e.g., the
+// tasks of a task group. Each base directory is only created once, and
+// all the instances are written to temporary files before any of them
+// is moved to its path, so that a failure to write one of them leaves
+// all the paths untouched. As with checkpointing the instances one by
+// one, each path is atomically replaced, hence an agent failing over
+// in the midst of this recovers either the previous or the new content
+// of each path.
+template <typename T>
+Try<Nothing> checkpoint(
+    const std::vector<std::pair<std::string, T>>& checkpoints)
+{
+  hashset<std::string> bases;
+  std::vector<std::string> temps;
+
+  // Removes the temporary files that have not been moved to their
+  // paths yet, starting at the given index.
+  auto cleanup = [&temps](size_t index) {
+    for (size_t i = index; i < temps.size(); ++i) {
+      os::rm(temps[i]);
+    }
+  };
+
+  foreach (const auto& entry, checkpoints) {
+    const std::string base = Path(entry.first).dirname();
+
+    if (!bases.contains(base)) {
+      Try<Nothing> mkdir = os::mkdir(base);
+      if (mkdir.isError()) {
+        cleanup(0);
+        return Error(
+            "Failed to create directory '" + base + "': " + mkdir.error());
+      }
+
+      bases.insert(base);
+    }
+
+    Try<std::string> temp = internal::stage(entry.first, entry.second);
+    if (temp.isError()) {
+      cleanup(0);
+      return Error(temp.error());
+    }
+
+    temps.push_back(temp.get());
+  }
 
-    return Error("Failed to rename '" + temp.get() + "' to '" +
-                 path + "': " + rename.error());
+  for (size_t i = 0; i < checkpoints.size(); ++i) {
+    Try<Nothing> commit = internal::commit(temps[i], checkpoints[i].first);
+    if (commit.isError()) {
+      // NOTE: `commit()` already removed the failed temporary file.
+      cleanup(i + 1);
+      return commit;
+    }
   }
 
   return Nothing();
@@ -16,6 +16,10 @@
 
 #include "slave/task_status_update_manager.hpp"
 
+#include <list>
+#include <vector>
+
+#include <process/collect.hpp>
 #include <process/delay.hpp>
 #include <process/id.hpp>
 #include <process/process.hpp>
@@ -45,9 +49,11 @@
 
 using lambda::function;
 
+using std::list;
 using std::string;
 
 using process::wait; // Necessary on some OS's to disambiguate.
+using process::collect;
 using process::Failure;
 using process::Future;
 using process::PID;
@@ -559,23 +565,39 @@ void TaskStatusUpdateManagerProcess::cleanupStatusUpdateStream(
 
 TaskStatusUpdateManager::TaskStatusUpdateManager(const Flags& flags)
 {
-  process = new TaskStatusUpdateManagerProcess(flags);
-  spawn(process);
+  for (size_t i = 0; i < TASK_STATUS_UPDATE_MANAGER_SHARDS; i++) {
+    TaskStatusUpdateManagerProcess* process =
+      new TaskStatusUpdateManagerProcess(flags);
+
+    spawn(process);
+    processes.push_back(process);
+  }
 }
 
 
 TaskStatusUpdateManager::~TaskStatusUpdateManager()
 {
-  terminate(process);
-  wait(process);
-  delete process;
+  foreach (TaskStatusUpdateManagerProcess* process, processes) {
+    terminate(process);
+    wait(process);
+    delete process;
+  }
+}
+
+
+TaskStatusUpdateManagerProcess* TaskStatusUpdateManager::shard(
+    const FrameworkID& frameworkId) const
+{
+  return processes[std::hash<FrameworkID>()(frameworkId) % processes.size()];
 }
 
 
 void TaskStatusUpdateManager::initialize(
     const function<void(StatusUpdate)>& forward)
 {
-  dispatch(process, &TaskStatusUpdateManagerProcess::initialize, forward);
+  foreach (TaskStatusUpdateManagerProcess* process, processes) {
+    dispatch(process, &TaskStatusUpdateManagerProcess::initialize, forward);
+  }
 }
 
 
@@ -586,7 +608,7 @@ Future<Nothing> TaskStatusUpdateManager::update(
     const ContainerID& containerId)
 {
   return dispatch(
-      process,
+      shard(update.framework_id()),
       &TaskStatusUpdateManagerProcess::update,
       update,
       slaveId,
@@ -600,7 +622,7 @@ Future<Nothing> TaskStatusUpdateManager::update(
     const SlaveID& slaveId)
 {
   return dispatch(
-      process,
+      shard(update.framework_id()),
       &TaskStatusUpdateManagerProcess::update,
       update,
       slaveId);
@@ -613,7 +635,7 @@ Future<bool> TaskStatusUpdateManager::acknowledgement(
     const UUID& uuid)
 {
   return dispatch(
-      process,
+      shard(frameworkId),
       &TaskStatusUpdateManagerProcess::acknowledgement,
       taskId,
       frameworkId,
@@ -625,26 +647,62 @@ Future<Nothing> TaskStatusUpdateManager::recover(
     const string& rootDir,
     const Option<SlaveState>& state)
 {
-  return dispatch(
-      process, &TaskStatusUpdateManagerProcess::recover, rootDir, state);
+  // Each process recovers the streams of the frameworks it shards.
+  hashmap<TaskStatusUpdateManagerProcess*, Option<SlaveState>> states;
+  foreach (TaskStatusUpdateManagerProcess* process, processes) {
+    states[process] = None();
+  }
+
+  if (state.isSome()) {
+    foreach (TaskStatusUpdateManagerProcess* process, processes) {
+      SlaveState state_ = state.get();
+      state_.frameworks.clear();
+
+      states[process] = state_;
+    }
+
+    foreachpair (const FrameworkID& frameworkId,
+                 const FrameworkState& framework,
+                 state->frameworks) {
+      states[shard(frameworkId)]->frameworks.put(frameworkId, framework);
+    }
+  }
+
+  list<Future<Nothing>> futures;
+  foreachpair (TaskStatusUpdateManagerProcess* process,
+               const Option<SlaveState>& state_,
+               states) {
+    futures.push_back(dispatch(
+        process, &TaskStatusUpdateManagerProcess::recover, rootDir, state_));
+  }
+
+  return collect(futures)
+    .then([]() { return Nothing(); });
 }
 
 
 void TaskStatusUpdateManager::pause()
 {
-  dispatch(process, &TaskStatusUpdateManagerProcess::pause);
+  foreach (TaskStatusUpdateManagerProcess* process, processes) {
+    dispatch(process, &TaskStatusUpdateManagerProcess::pause);
+  }
 }
 
 
 void TaskStatusUpdateManager::resume()
 {
-  dispatch(process, &TaskStatusUpdateManagerProcess::resume);
+  foreach (TaskStatusUpdateManagerProcess* process, processes) {
+    dispatch(process, &TaskStatusUpdateManagerProcess::resume);
+  }
 }
 
 
 void TaskStatusUpdateManager::cleanup(const FrameworkID& frameworkId)
 {
-  dispatch(process, &TaskStatusUpdateManagerProcess::cleanup, frameworkId);
+  dispatch(
+      shard(frameworkId),
+      &TaskStatusUpdateManagerProcess::cleanup,
+      frameworkId);
 }
 
 
@@ -19,6 +19,7 @@
 
 #include <queue>
 #include <string>
+#include <vector>
 
 #include <mesos/mesos.hpp>
 
@@ -119,7 +120,12 @@ public:
   void cleanup(const FrameworkID& frameworkId);
 
 private:
-  TaskStatusUpdateManagerProcess* process;
+  // Returns the process handling the streams of the framework.
+  TaskStatusUpdateManagerProcess* shard(const FrameworkID& frameworkId) const;
+
+  // The streams are sharded over these processes by framework, see
+  // `TASK_STATUS_UPDATE_MANAGER_SHARDS`.
+  std::vector<TaskStatusUpdateManagerProcess*> processes;
 };
 
 
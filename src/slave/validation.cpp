@@ -22,6 +22,8 @@
 
 #include <mesos/agent/agent.hpp>
 
+#include <stout/foreach.hpp>
+#include <stout/hashset.hpp>
 #include <stout/stringify.hpp>
 #include <stout/unreachable.hpp>
 #include <stout/uuid.hpp>
@@ -525,6 +527,64 @@ Option<Error> validate(
 
       return None();
     }
+
+    case mesos::agent::Call::WATCH_NESTED_CONTAINERS: {
+      if (!call.has_watch_nested_containers()) {
+        return Error("Expecting 'watch_nested_containers' to be present");
+      }
+
+      foreach (const ContainerID& containerId,
+               call.watch_nested_containers().container_ids()) {
+        Option<Error> error =
+          validation::container::validateContainerId(containerId);
+
+        if (error.isSome()) {
+          return Error("'watch_nested_containers.container_ids' contains an"
+                       " invalid container ID: " + error->message);
+        }
+
+        // Nested containers always have at least one parent.
+        if (!containerId.has_parent()) {
+          return Error("Expecting the parent to be present for each of"
+                       " 'watch_nested_containers.container_ids'");
+        }
+      }
+
+      return None();
+    }
+
+    case mesos::agent::Call::LAUNCH_NESTED_CONTAINERS: {
+      if (!call.has_launch_nested_containers()) {
+        return Error("Expecting 'launch_nested_containers' to be present");
+      }
+
+      hashset<ContainerID> containerIds;
+
+      foreach (const mesos::agent::Call::LaunchNestedContainer& launch,
+               call.launch_nested_containers().containers()) {
+        // Each container is validated like the container of a
+        // `LAUNCH_NESTED_CONTAINER` call.
+        mesos::agent::Call _call;
+        _call.set_type(mesos::agent::Call::LAUNCH_NESTED_CONTAINER);
+        _call.mutable_launch_nested_container()->CopyFrom(launch);
+
+        Option<Error> error = validate(_call, principal);
+        if (error.isSome()) {
+          return Error("'launch_nested_containers.containers' contains an"
+                       " invalid container: " + error->message);
+        }
+
+        if (containerIds.contains(launch.container_id())) {
+          return Error("'launch_nested_containers.containers' contains the"
+                       " container ID '" + stringify(launch.container_id()) +
+                       "' more than once");
+        }
+
+        containerIds.insert(launch.container_id());
+      }
+
+      return None();
+    }
   }
 
   UNREACHABLE();
@@ -25,7 +25,9 @@
 #include <process/id.hpp>
 #include <process/process.hpp>
 
+#include <stout/foreach.hpp>
 #include <stout/hashmap.hpp>
+#include <stout/hashset.hpp>
 #include <stout/option.hpp>
 #include <stout/uuid.hpp>
 
@@ -35,6 +37,7 @@ using namespace process;
 // 'std::' to disambiguate the 'set' member.
 using std::string;
 
+using mesos::internal::state::Batch;
 using mesos::internal::state::Entry;
 
 namespace mesos {
@@ -82,6 +85,52 @@ public:
     return true;
   }
 
+  Future<bool> apply(const Batch& batch)
+  {
+    hashset<string> names;
+
+    // Check all of the versions first so that either all or none of
+    // the operations get applied.
+    foreach (const Batch::Operation& operation, batch.operations()) {
+      const Entry& entry = operation.entry();
+
+      if (names.contains(entry.name())) {
+        return Failure("Multiple operations on '" + entry.name() + "'");
+      }
+
+      names.insert(entry.name());
+
+      const Option<Entry>& option = entries.get(entry.name());
+
+      switch (operation.type()) {
+        case Batch::Operation::SET:
+          if (option.isSome() &&
+              option.get().uuid() != operation.uuid()) {
+            return false;
+          }
+          break;
+        case Batch::Operation::EXPUNGE:
+          if (option.isNone() || option.get().uuid() != entry.uuid()) {
+            return false;
+          }
+          break;
+      }
+    }
+
+    foreach (const Batch::Operation& operation, batch.operations()) {
+      switch (operation.type()) {
+        case Batch::Operation::SET:
+          entries.put(operation.entry().name(), operation.entry());
+          break;
+        case Batch::Operation::EXPUNGE:
+          entries.erase(operation.entry().name());
+          break;
+      }
+    }
+
+    return true;
+  }
+
   std::set<string> names() // Use std:: to disambiguate 'set' member.
   {
     const hashset<string>& keys = entries.keys();
@@ -127,6 +176,12 @@ Future<bool> InMemoryStorage::expunge(const Entry& entry)
 }
 
 
+Future<bool> InMemoryStorage::apply(const Batch& batch)
+{
+  return dispatch(process, &InMemoryStorageProcess::apply, batch);
+}
+
+
 Future<std::set<string>> InMemoryStorage::names()
 {
   return dispatch(process, &InMemoryStorageProcess::names);
@@ -15,6 +15,7 @@
 // limitations under the License
 
 #include <leveldb/db.h>
+#include <leveldb/write_batch.h>
 
 #include <google/protobuf/message.h>
 
@@ -32,6 +33,8 @@
 #include <process/process.hpp>
 
 #include <stout/error.hpp>
+#include <stout/foreach.hpp>
+#include <stout/hashset.hpp>
 #include <stout/none.hpp>
 #include <stout/option.hpp>
 #include <stout/some.hpp>
@@ -46,6 +49,7 @@ using namespace process;
 // 'std::' to disambiguate the 'set' member.
 using std::string;
 
+using mesos::internal::state::Batch;
 using mesos::internal::state::Entry;
 
 namespace mesos {
@@ -64,6 +68,7 @@ public:
   Future<Option<Entry>> get(const string& name);
   Future<bool> set(const Entry& entry, const UUID& uuid);
   Future<bool> expunge(const Entry& entry);
+  Future<bool> apply(const Batch& batch);
   Future<std::set<string>> names();
 
 private:
@@ -222,6 +227,75 @@ Future<bool> LevelDBStorageProcess::expunge(const Entry& entry)
 }
 
 
+Future<bool> LevelDBStorageProcess::apply(const Batch& batch)
+{
+  if (error.isSome()) {
+    return Failure(error.get());
+  }
+
+  hashset<string> names;
+
+  leveldb::WriteBatch writes;
+
+  foreach (const Batch::Operation& operation, batch.operations()) {
+    const Entry& entry = operation.entry();
+
+    if (names.contains(entry.name())) {
+      return Failure("Multiple operations on '" + entry.name() + "'");
+    }
+
+    names.insert(entry.name());
+
+    // As with 'set' and 'expunge' we read first to check the version.
+    Try<Option<Entry>> option = read(entry.name());
+
+    if (option.isError()) {
+      return Failure(option.error());
+    }
+
+    switch (operation.type()) {
+      case Batch::Operation::SET: {
+        if (option.get().isSome() &&
+            option.get().get().uuid() != operation.uuid()) {
+          return false;
+        }
+
+        string value;
+
+        if (!entry.SerializeToString(&value)) {
+          return Failure("Failed to serialize Entry");
+        }
+
+        writes.Put(entry.name(), value);
+        break;
+      }
+
+      case Batch::Operation::EXPUNGE: {
+        if (option.get().isNone() ||
+            option.get().get().uuid() != entry.uuid()) {
+          return false;
+        }
+
+        writes.Delete(entry.name());
+        break;
+      }
+    }
+  }
+
+  // All of the operations are applied with a single (atomic) write.
+  leveldb::WriteOptions options;
+  options.sync = true;
+
+  leveldb::Status status = db->Write(options, &writes);
+
+  if (!status.ok()) {
+    return Failure(status.ToString());
+  }
+
+  return true;
+}
+
+
 Try<Option<Entry>> LevelDBStorageProcess::read(const string& name)
 {
   CHECK_NONE(error);
@@ -306,6 +380,12 @@ Future<bool> LevelDBStorage::expunge(const Entry& entry)
 }
 
 
+Future<bool> LevelDBStorage::apply(const Batch& batch)
+{
+  return dispatch(process, &LevelDBStorageProcess::apply, batch);
+}
+
+
 Future<std::set<string>> LevelDBStorage::names()
 {
   return dispatch(process, &LevelDBStorageProcess::names);
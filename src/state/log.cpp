@@ -39,10 +39,12 @@
 #include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/foreach.hpp>
+#include <stout/hashset.hpp>
 #include <stout/lambda.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/nothing.hpp>
 #include <stout/option.hpp>
+#include <stout/strings.hpp>
 #include <stout/svn.hpp>
 #include <stout/uuid.hpp>
 
@@ -59,6 +61,7 @@ using std::string;
 
 using mesos::log::Log;
 
+using mesos::internal::state::Batch;
 using mesos::internal::state::Entry;
 using mesos::internal::state::Operation;
 
@@ -84,7 +87,10 @@ namespace state {
 class LogStorageProcess : public Process<LogStorageProcess>
 {
 public:
-  LogStorageProcess(Log* log, size_t diffsBetweenSnapshots);
+  LogStorageProcess(
+      Log* log,
+      size_t diffsBetweenSnapshots,
+      size_t operationsBetweenCheckpoints);
 
   virtual ~LogStorageProcess();
 
@@ -92,7 +98,8 @@ public:
   Future<Option<Entry>> get(const string& name);
   Future<bool> set(const Entry& entry, const UUID& uuid);
   Future<bool> expunge(const Entry& entry);
-  Future<std::set<string>> names();
+  Future<bool> batch(const Batch& batch);
+  Future<std::set<string>> names(const string& prefix);
 
 protected:
   virtual void finalize();
@@ -107,6 +114,11 @@ private:
   // Helper for applying log entries.
   Future<Nothing> apply(const list<Log::Entry>& entries);
 
+  // Helper for performing checkpointing.
+  void checkpoint();
+  Future<Nothing> _checkpoint();
+  Future<Nothing> __checkpoint(const Option<Log::Position>& position);
+
   // Helper for performing truncation.
   void truncate();
   Future<Nothing> _truncate();
@@ -130,12 +142,22 @@ private:
       const Entry& entry,
       const Option<Log::Position>& position);
 
-  Future<std::set<string>> _names();
+  Future<bool> _batch(const Batch& batch);
+  Future<bool> __batch(const Batch& batch);
+  Future<bool> ___batch(
+      const Batch& batch,
+      const Option<Log::Position>& position);
+
+  Future<std::set<string>> _names(const string& prefix);
 
   Log::Reader reader;
   Log::Writer writer;
 
   const size_t diffsBetweenSnapshots;
+  const size_t operationsBetweenCheckpoints;
+
+  // Number of operations in the log since the last checkpoint.
+  size_t operations;
 
   // Used to serialize Log::Writer::append/truncate operations.
   Mutex mutex;
@@ -204,6 +226,10 @@ private:
   // a default/empty constructor.
   hashmap<string, Snapshot> snapshots;
 
+  // Names of all known snapshots, kept ordered so that 'names()' can
+  // be answered without sorting (or walking) all of 'snapshots'.
+  std::set<string> keys;
+
   struct Metrics
   {
     Metrics()
@@ -222,11 +248,16 @@ private:
 };
 
 
-LogStorageProcess::LogStorageProcess(Log* log, size_t diffsBetweenSnapshots)
+LogStorageProcess::LogStorageProcess(
+    Log* log,
+    size_t diffsBetweenSnapshots,
+    size_t operationsBetweenCheckpoints)
   : ProcessBase(process::ID::generate("log-storage")),
     reader(log),
     writer(log),
-    diffsBetweenSnapshots(diffsBetweenSnapshots) {}
+    diffsBetweenSnapshots(diffsBetweenSnapshots),
+    operationsBetweenCheckpoints(operationsBetweenCheckpoints),
+    operations(0) {}
 
 
 LogStorageProcess::~LogStorageProcess() {}
@@ -280,7 +311,9 @@ Future<Nothing> LogStorageProcess::_start(
   // what ever position was known at the time we started the
   // writer. Note that it should always be safe to read a truncated
   // entry since a subsequent operation in the log should invalidate
-  // that entry when we read it instead.
+  // that entry when we read it instead. If checkpointing is enabled
+  // the log gets truncated up to the latest checkpoint, so reading
+  // from the beginning only replays the operations after it.
   if (index.isSome()) {
     // If we've started before (i.e., have an 'index' position) we
     // should also expect to know the last 'truncated' position.
@@ -332,6 +365,8 @@ Future<Nothing> LogStorageProcess::apply(const list<Log::Entry>& entries)
           // Add or update (override) the snapshot.
           Snapshot snapshot(entry.position, operation.snapshot().entry());
           snapshots.put(snapshot.entry.name(), snapshot);
+          keys.insert(snapshot.entry.name());
+          operations++;
           break;
         }
 
@@ -351,12 +386,64 @@ Future<Nothing> LogStorageProcess::apply(const list<Log::Entry>& entries)
 
           // Replace the snapshot with the patched snapshot.
           snapshots.put(patched.get().entry.name(), patched.get());
+          operations++;
           break;
         }
 
         case Operation::EXPUNGE: {
           CHECK(operation.has_expunge());
           snapshots.erase(operation.expunge().name());
+          keys.erase(operation.expunge().name());
+          operations++;
+          break;
+        }
+
+        case Operation::BATCH: {
+          CHECK(operation.has_batch());
+
+          foreach (const Operation& operation_,
+                   operation.batch().operations()) {
+            switch (operation_.type()) {
+              case Operation::SNAPSHOT: {
+                CHECK(operation_.has_snapshot());
+                const Entry& entry_ = operation_.snapshot().entry();
+                snapshots.put(entry_.name(), Snapshot(entry.position, entry_));
+                keys.insert(entry_.name());
+                break;
+              }
+
+              case Operation::EXPUNGE: {
+                CHECK(operation_.has_expunge());
+                snapshots.erase(operation_.expunge().name());
+                keys.erase(operation_.expunge().name());
+                break;
+              }
+
+              default:
+                return Failure(
+                    "Unexpected operation in batch: " +
+                    stringify(operation_.type()));
+            }
+          }
+
+          operations++;
+          break;
+        }
+
+        case Operation::CHECKPOINT: {
+          CHECK(operation.has_checkpoint());
+
+          // A checkpoint captures every entry, so anything we've
+          // applied from earlier positions is superseded.
+          snapshots.clear();
+          keys.clear();
+
+          foreach (const Entry& entry_, operation.checkpoint().entries()) {
+            snapshots.put(entry_.name(), Snapshot(entry.position, entry_));
+            keys.insert(entry_.name());
+          }
+
+          operations = 0;
           break;
         }
 
@@ -372,6 +459,73 @@ Future<Nothing> LogStorageProcess::apply(const list<Log::Entry>& entries)
 }
 
 
+void LogStorageProcess::checkpoint()
+{
+  // Like truncation, the checkpoint gets appended while holding the
+  // mutex so that it captures exactly the snapshots at the position
+  // it gets written to.
+  mutex.lock()
+    .then(defer(self(), &Self::_checkpoint))
+    .onAny(lambda::bind(&Mutex::unlock, mutex));
+}
+
+
+Future<Nothing> LogStorageProcess::_checkpoint()
+{
+  // Another checkpoint might have been written while we were waiting
+  // for the mutex.
+  if (operations < operationsBetweenCheckpoints) {
+    return Nothing();
+  }
+
+  Operation operation;
+  operation.set_type(Operation::CHECKPOINT);
+
+  foreachvalue (const Snapshot& snapshot, snapshots) {
+    operation.mutable_checkpoint()->add_entries()->CopyFrom(snapshot.entry);
+  }
+
+  string value;
+  if (!operation.SerializeToString(&value)) {
+    return Failure("Failed to serialize CHECKPOINT Operation");
+  }
+
+  return writer.append(value)
+    .then(defer(self(), &Self::__checkpoint, lambda::_1));
+
+  // NOTE: As with truncation a failure to append the checkpoint
+  // doesn't propagate, we'll just try again after the next operation.
+}
+
+
+Future<Nothing> LogStorageProcess::__checkpoint(
+    const Option<Log::Position>& position)
+{
+  if (position.isNone()) {
+    starting = None(); // Reset 'starting' so we try again.
+    return Nothing();
+  }
+
+  index = max(index, position);
+
+  // Every snapshot is now represented by the checkpoint, which lets
+  // us truncate all the positions before it.
+  hashmap<string, Snapshot> checkpointed;
+  foreachvalue (const Snapshot& snapshot, snapshots) {
+    checkpointed.put(
+        snapshot.entry.name(),
+        Snapshot(position.get(), snapshot.entry));
+  }
+
+  snapshots.swap(checkpointed);
+  operations = 0;
+
+  truncate();
+
+  return Nothing();
+}
+
+
 // TODO(benh): Truncation could be optimized by saving the "oldest"
 // snapshot and only doing a truncation if/when we update that
 // snapshot.
@@ -574,9 +728,15 @@ Future<bool> LogStorageProcess::___set(
 
   Snapshot snapshot(position.get(), entry, diffs);
   snapshots.put(snapshot.entry.name(), snapshot);
-
-  // And truncate the log if necessary.
-  truncate();
+  keys.insert(snapshot.entry.name());
+
+  // And checkpoint or truncate the log if necessary.
+  if (operationsBetweenCheckpoints > 0 &&
+      ++operations >= operationsBetweenCheckpoints) {
+    checkpoint();
+  } else {
+    truncate();
+  }
 
   return true;
 }
@@ -638,29 +798,162 @@ Future<bool> LogStorageProcess::___expunge(
   // Remove from snapshots and truncate the log if possible.
   CHECK(snapshots.contains(entry.name()));
   snapshots.erase(entry.name());
-  truncate();
+  keys.erase(entry.name());
+
+  if (operationsBetweenCheckpoints > 0 &&
+      ++operations >= operationsBetweenCheckpoints) {
+    checkpoint();
+  } else {
+    truncate();
+  }
 
   return true;
 }
 
 
-Future<std::set<string>> LogStorageProcess::names()
+Future<bool> LogStorageProcess::batch(const Batch& batch)
+{
+  return mutex.lock()
+    .then(defer(self(), &Self::_batch, batch))
+    .onAny(lambda::bind(&Mutex::unlock, mutex));
+}
+
+
+Future<bool> LogStorageProcess::_batch(const Batch& batch)
+{
+  return start()
+    .then(defer(self(), &Self::__batch, batch));
+}
+
+
+Future<bool> LogStorageProcess::__batch(const Batch& batch)
+{
+  hashset<string> names;
+
+  // The whole batch gets appended as a single operation, made up of
+  // full snapshots (rather than diffs) for the entries that are set.
+  Operation operation;
+  operation.set_type(Operation::BATCH);
+
+  foreach (const Batch::Operation& operation_, batch.operations()) {
+    const Entry& entry = operation_.entry();
+
+    if (names.contains(entry.name())) {
+      return Failure("Multiple operations on '" + entry.name() + "'");
+    }
+
+    names.insert(entry.name());
+
+    Option<Snapshot> snapshot = snapshots.get(entry.name());
+
+    switch (operation_.type()) {
+      case Batch::Operation::SET: {
+        if (snapshot.isSome() &&
+            snapshot.get().entry.uuid() != operation_.uuid()) {
+          return false;
+        }
+
+        Operation* snapshot_ = operation.mutable_batch()->add_operations();
+        snapshot_->set_type(Operation::SNAPSHOT);
+        snapshot_->mutable_snapshot()->mutable_entry()->CopyFrom(entry);
+        break;
+      }
+
+      case Batch::Operation::EXPUNGE: {
+        if (snapshot.isNone() ||
+            snapshot.get().entry.uuid() != entry.uuid()) {
+          return false;
+        }
+
+        Operation* expunge = operation.mutable_batch()->add_operations();
+        expunge->set_type(Operation::EXPUNGE);
+        expunge->mutable_expunge()->set_name(entry.name());
+        break;
+      }
+    }
+  }
+
+  string value;
+  if (!operation.SerializeToString(&value)) {
+    return Failure("Failed to serialize BATCH Operation");
+  }
+
+  return writer.append(value)
+    .then(defer(self(), &Self::___batch, batch, lambda::_1));
+}
+
+
+Future<bool> LogStorageProcess::___batch(
+    const Batch& batch,
+    const Option<Log::Position>& position)
+{
+  if (position.isNone()) {
+    starting = None(); // Reset 'starting' so we try again.
+    return false;
+  }
+
+  index = max(index, position);
+
+  foreach (const Batch::Operation& operation, batch.operations()) {
+    const Entry& entry = operation.entry();
+
+    switch (operation.type()) {
+      case Batch::Operation::SET:
+        snapshots.put(entry.name(), Snapshot(position.get(), entry));
+        keys.insert(entry.name());
+        break;
+      case Batch::Operation::EXPUNGE:
+        snapshots.erase(entry.name());
+        keys.erase(entry.name());
+        break;
+    }
+  }
+
+  if (operationsBetweenCheckpoints > 0 &&
+      ++operations >= operationsBetweenCheckpoints) {
+    checkpoint();
+  } else {
+    truncate();
+  }
+
+  return true;
+}
+
+
+Future<std::set<string>> LogStorageProcess::names(const string& prefix)
 {
   return start()
-    .then(defer(self(), &Self::_names));
+    .then(defer(self(), &Self::_names, prefix));
 }
 
 
-Future<std::set<string>> LogStorageProcess::_names()
+Future<std::set<string>> LogStorageProcess::_names(const string& prefix)
 {
-  const hashset<string>& keys = snapshots.keys();
-  return std::set<string>(keys.begin(), keys.end());
+  if (prefix.empty()) {
+    return keys;
+  }
+
+  std::set<string> result;
+  for (auto it = keys.lower_bound(prefix);
+       it != keys.end() && strings::startsWith(*it, prefix);
+       ++it) {
+    result.insert(result.end(), *it);
+  }
+
+  return result;
 }
 
 
-LogStorage::LogStorage(Log* log, size_t diffsBetweenSnapshots)
+LogStorage::LogStorage(
+    Log* log,
+    size_t diffsBetweenSnapshots,
+    size_t operationsBetweenCheckpoints)
 {
-  process = new LogStorageProcess(log, diffsBetweenSnapshots);
+  process = new LogStorageProcess(
+      log,
+      diffsBetweenSnapshots,
+      operationsBetweenCheckpoints);
+
   spawn(process);
 }
 
@@ -691,9 +984,21 @@ Future<bool> LogStorage::expunge(const Entry& entry)
 }
 
 
+Future<bool> LogStorage::apply(const Batch& batch)
+{
+  return dispatch(process, &LogStorageProcess::batch, batch);
+}
+
+
 Future<std::set<string>> LogStorage::names()
 {
-  return dispatch(process, &LogStorageProcess::names);
+  return dispatch(process, &LogStorageProcess::names, "");
+}
+
+
+Future<std::set<string>> LogStorage::names(const string& prefix)
+{
+  return dispatch(process, &LogStorageProcess::names, prefix);
 }
 
 } // namespace state {
@@ -37,7 +37,10 @@
 
 #include <stout/duration.hpp>
 #include <stout/error.hpp>
+#include <stout/foreach.hpp>
+#include <stout/hashset.hpp>
 #include <stout/none.hpp>
+#include <stout/nothing.hpp>
 #include <stout/option.hpp>
 #include <stout/result.hpp>
 #include <stout/some.hpp>
@@ -55,6 +58,7 @@ using std::queue;
 using std::string;
 using std::vector;
 
+using mesos::internal::state::Batch;
 using mesos::internal::state::Entry;
 
 using zookeeper::Authentication;
@@ -79,6 +83,7 @@ public:
   Future<Option<Entry>> get(const string& name);
   Future<bool> set(const Entry& entry, const UUID& uuid);
   virtual Future<bool> expunge(const Entry& entry);
+  Future<bool> apply(const Batch& batch);
   Future<std::set<string>> names();
 
   // ZooKeeper events.
@@ -96,6 +101,10 @@ private:
   Result<Option<Entry>> doGet(const string& name);
   Result<bool> doSet(const Entry& entry, const UUID& uuid);
   Result<bool> doExpunge(const Entry& entry);
+  Result<bool> doApply(const Batch& batch);
+
+  // Helper for creating the directory path znodes as necessary.
+  Result<Nothing> doCreateZNode();
 
   const string servers;
 
@@ -149,6 +158,14 @@ private:
     Promise<bool> promise;
   };
 
+  struct Apply
+  {
+    explicit Apply(const Batch& _batch) : batch(_batch) {}
+
+    Batch batch;
+    Promise<bool> promise;
+  };
+
   // TODO(benh): Make pending a single queue of "operations" that can
   // be "invoked" (C++11 lambdas would help).
   struct {
@@ -156,6 +173,7 @@ private:
     queue<Get*> gets;
     queue<Set*> sets;
     queue<Expunge*> expunges;
+    queue<Apply*> applies;
   } pending;
 
   Option<string> error;
@@ -199,6 +217,7 @@ ZooKeeperStorageProcess::~ZooKeeperStorageProcess()
   fail(&pending.names, "No longer managing storage");
   fail(&pending.gets, "No longer managing storage");
   fail(&pending.sets, "No longer managing storage");
+  fail(&pending.applies, "No longer managing storage");
 
   delete zk;
   delete watcher;
@@ -310,6 +329,30 @@ Future<bool> ZooKeeperStorageProcess::expunge(const Entry& entry)
 }
 
 
+Future<bool> ZooKeeperStorageProcess::apply(const Batch& batch)
+{
+  if (error.isSome()) {
+    return Failure(error.get());
+  } else if (state != CONNECTED) {
+    Apply* apply = new Apply(batch);
+    pending.applies.push(apply);
+    return apply->promise.future();
+  }
+
+  Result<bool> result = doApply(batch);
+
+  if (result.isNone()) { // Try again later.
+    Apply* apply = new Apply(batch);
+    pending.applies.push(apply);
+    return apply->promise.future();
+  } else if (result.isError()) {
+    return Failure(result.error());
+  }
+
+  return result.get();
+}
+
+
 void ZooKeeperStorageProcess::connected(int64_t sessionId, bool reconnect)
 {
   if (sessionId != zk->getSessionId()) {
@@ -374,6 +417,20 @@ void ZooKeeperStorageProcess::connected(int64_t sessionId, bool reconnect)
     pending.sets.pop();
     delete set;
   }
+
+  while (!pending.applies.empty()) {
+    Apply* apply = pending.applies.front();
+    Result<bool> result = doApply(apply->batch);
+    if (result.isNone()) {
+      return; // Try again later.
+    } else if (result.isError()) {
+      apply->promise.fail(result.error());
+    } else {
+      apply->promise.set(result.get());
+    }
+    pending.applies.pop();
+    delete apply;
+  }
 }
 
 
@@ -500,26 +557,12 @@ Result<bool> ZooKeeperStorageProcess::doSet(const Entry& entry,
   int code = zk->get(znode + "/" + entry.name(), false, &result, &stat);
 
   if (code == ZNONODE) {
-    // Create directory path znodes as necessary.
-    CHECK(znode.size() == 0 || znode.at(znode.size() - 1) != '/');
-    size_t index = znode.find('/', 0);
-
-    while (index < string::npos) {
-      // Get out the prefix to create.
-      index = znode.find('/', index + 1);
-      string prefix = znode.substr(0, index);
-
-      // Create the znode (even if it already exists).
-      code = zk->create(prefix, "", acl, 0, nullptr);
-
-      if (code == ZINVALIDSTATE || (code != ZOK && zk->retryable(code))) {
-        CHECK(zk->getState() != ZOO_AUTH_FAILED_STATE);
-        return None(); // Try again later.
-      } else if (code != ZOK && code != ZNODEEXISTS) {
-        return Error(
-            "Failed to create '" + prefix +
-            "' in ZooKeeper: " + zk->message(code));
-      }
+    Result<Nothing> created = doCreateZNode();
+
+    if (!created.isSome()) {
+      return created.isError()
+        ? Result<bool>(Error(created.error()))
+        : Result<bool>(None());
     }
 
     code = zk->create(znode + "/" + entry.name(), data, acl, 0, nullptr);
@@ -627,6 +670,184 @@ Result<bool> ZooKeeperStorageProcess::doExpunge(const Entry& entry)
 }
 
 
+Result<bool> ZooKeeperStorageProcess::doApply(const Batch& batch)
+{
+  CHECK_NONE(error) << ": " << error.get();
+  CHECK(state == CONNECTED);
+
+  if (batch.operations().empty()) {
+    return true;
+  }
+
+  hashset<string> names;
+
+  // The paths and data referenced by the operations need to stay
+  // valid until 'ZooKeeper::multi' returns.
+  vector<string> paths;
+  vector<string> datas;
+  paths.reserve(batch.operations().size());
+  datas.reserve(batch.operations().size());
+
+  foreach (const Batch::Operation& operation, batch.operations()) {
+    const Entry& entry = operation.entry();
+
+    if (names.contains(entry.name())) {
+      return Error("Multiple operations on '" + entry.name() + "'");
+    }
+
+    names.insert(entry.name());
+
+    paths.push_back(znode + "/" + entry.name());
+
+    // Serialize to make sure we're under the 1 MB limit.
+    datas.push_back(string());
+
+    if (operation.type() == Batch::Operation::SET) {
+      if (!entry.SerializeToString(&datas.back())) {
+        return Error("Failed to serialize Entry");
+      }
+
+      if (datas.back().size() > 1024 * 1024) { // 1 MB
+        return Error("Serialized data is too big (> 1 MB)");
+      }
+    }
+  }
+
+  // Like 'doSet' and 'doExpunge' we check the UUID of the current
+  // entries and then rely on the znode versions for atomicity. The
+  // current entries are read with pipelined reads.
+  vector<string> results;
+  vector<Stat> stats;
+
+  const vector<int> codes = zk->get(paths, false, &results, &stats);
+
+  vector<zoo_op_t> ops;
+  bool create = false;
+
+  for (int i = 0; i < batch.operations().size(); i++) {
+    const Batch::Operation& operation = batch.operations(i);
+    const Entry& entry = operation.entry();
+    const string& path = paths[i];
+    const string& data = datas[i];
+    const string& result = results[i];
+    const Stat& stat = stats[i];
+    const int code = codes[i];
+
+    if (code == ZINVALIDSTATE || (code != ZOK && zk->retryable(code))) {
+      CHECK(zk->getState() != ZOO_AUTH_FAILED_STATE);
+      return None(); // Try again later.
+    } else if (code != ZOK && code != ZNONODE) {
+      return Error(
+          "Failed to get '" + path + "' in ZooKeeper: " + zk->message(code));
+    }
+
+    Option<Entry> current = None();
+
+    if (code == ZOK) {
+      google::protobuf::io::ArrayInputStream stream(
+          result.data(),
+          result.size());
+
+      current = Entry();
+
+      if (!current->ParseFromZeroCopyStream(&stream)) {
+        return Error("Failed to deserialize Entry");
+      }
+    }
+
+    zoo_op_t op;
+
+    switch (operation.type()) {
+      case Batch::Operation::SET:
+        if (current.isNone()) {
+          create = true;
+          zoo_create_op_init(
+              &op,
+              path.c_str(),
+              data.data(),
+              data.size(),
+              &acl,
+              0,
+              nullptr,
+              0);
+        } else if (current->uuid() != operation.uuid()) {
+          return false;
+        } else {
+          zoo_set_op_init(
+              &op,
+              path.c_str(),
+              data.data(),
+              data.size(),
+              stat.version,
+              nullptr);
+        }
+        break;
+
+      case Batch::Operation::EXPUNGE:
+        if (current.isNone() || current->uuid() != entry.uuid()) {
+          return false;
+        }
+
+        zoo_delete_op_init(&op, path.c_str(), stat.version);
+        break;
+    }
+
+    ops.push_back(op);
+  }
+
+  if (create) {
+    Result<Nothing> created = doCreateZNode();
+
+    if (!created.isSome()) {
+      return created.isError()
+        ? Result<bool>(Error(created.error()))
+        : Result<bool>(None());
+    }
+  }
+
+  int code = zk->multi(ops);
+
+  if (code == ZNODEEXISTS || code == ZNONODE || code == ZBADVERSION) {
+    return false; // Lost a race with someone else.
+  } else if (code == ZINVALIDSTATE || (code != ZOK && zk->retryable(code))) {
+    CHECK(zk->getState() != ZOO_AUTH_FAILED_STATE);
+    return None(); // Try again later.
+  } else if (code != ZOK) {
+    return Error(
+        "Failed to apply batch in ZooKeeper: " + zk->message(code));
+  }
+
+  return true;
+}
+
+
+Result<Nothing> ZooKeeperStorageProcess::doCreateZNode()
+{
+  CHECK(znode.size() == 0 || znode.at(znode.size() - 1) != '/');
+  size_t index = znode.find('/', 0);
+
+  while (index < string::npos) {
+    // Get out the prefix to create.
+    index = znode.find('/', index + 1);
+    string prefix = znode.substr(0, index);
+
+    // Create the znode (even if it already exists).
+    int code = zk->create(prefix, "", acl, 0, nullptr);
+
+    if (code == ZINVALIDSTATE || (code != ZOK && zk->retryable(code))) {
+      CHECK(zk->getState() != ZOO_AUTH_FAILED_STATE);
+      return None(); // Try again later.
+    } else if (code != ZOK && code != ZNODEEXISTS) {
+      return Error(
+          "Failed to create '" + prefix +
+          "' in ZooKeeper: " + zk->message(code));
+    }
+  }
+
+  return Nothing();
+}
+
+
 ZooKeeperStorage::ZooKeeperStorage(
     const string& servers,
     const Duration& timeout,
@@ -664,6 +885,12 @@ Future<bool> ZooKeeperStorage::expunge(const Entry& entry)
 }
 
 
+Future<bool> ZooKeeperStorage::apply(const Batch& batch)
+{
+  return dispatch(process, &ZooKeeperStorageProcess::apply, batch);
+}
+
+
 Future<std::set<string>> ZooKeeperStorage::names()
 {
   return dispatch(process, &ZooKeeperStorageProcess::names);
@@ -33,11 +33,12 @@ using process::wait; // Necessary on some OS's to disambiguate.
 namespace mesos {
 namespace internal {
 
-OfferOperationStatusUpdateManager::OfferOperationStatusUpdateManager()
+OfferOperationStatusUpdateManager::OfferOperationStatusUpdateManager(
+    const Duration& syncInterval)
   : process(new StatusUpdateManagerProcess<
         UUID,
         OfferOperationStatusUpdateRecord,
-        OfferOperationStatusUpdate>())
+        OfferOperationStatusUpdate>(syncInterval))
 {
   spawn(process.get());
 }
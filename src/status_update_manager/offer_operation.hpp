@@ -25,6 +25,7 @@
 #include <process/owned.hpp>
 #include <process/process.hpp>
 
+#include <stout/duration.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/lambda.hpp>
 #include <stout/uuid.hpp>
@@ -44,7 +45,11 @@ typedef StatusUpdateManagerProcess<
 class OfferOperationStatusUpdateManager
 {
 public:
-  OfferOperationStatusUpdateManager();
+  // If `syncInterval` is non-zero, the checkpointed updates and
+  // acknowledgements are synced to disk in groups at most every
+  // `syncInterval` rather than written synchronously one by one.
+  explicit OfferOperationStatusUpdateManager(
+      const Duration& syncInterval = Duration::zero());
   ~OfferOperationStatusUpdateManager();
 
   OfferOperationStatusUpdateManager(
@@ -25,6 +25,7 @@
 #include <mesos/mesos.hpp>
 #include <mesos/type_utils.hpp>
 
+#include <process/defer.hpp>
 #include <process/delay.hpp>
 #include <process/future.hpp>
 #include <process/owned.hpp>
@@ -44,6 +45,8 @@
 #include <stout/utils.hpp>
 #include <stout/uuid.hpp>
 
+#include <stout/os/fsync.hpp>
+
 #include "common/protobuf_utils.hpp"
 
 #include "slave/constants.hpp"
@@ -71,6 +74,13 @@ namespace internal {
 // This process does NOT garbage collect any checkpointed state. The users of it
 // are responsible for the garbage collection of the status updates files.
 //
+// Checkpointed records are written synchronously by default. If a sync
+// interval is given, the records are written to the page cache instead and
+// the files of all the streams written to within the interval are then synced
+// to disk at once (i.e., a "group commit"). Updates are only forwarded, and
+// the futures returned by `update()` and `acknowledgement()` only satisfied,
+// once their records are on disk.
+//
 // TODO(gkleiman): make `TaskStatusUpdateManager` use this actor (MESOS-8296).
 template <typename IDType, typename CheckpointType, typename UpdateType>
 class StatusUpdateManagerProcess
@@ -108,8 +118,10 @@ public:
     State() : streams(), errors(0) {}
   };
 
-  StatusUpdateManagerProcess()
+  explicit StatusUpdateManagerProcess(
+      const Duration& _syncInterval = Duration::zero())
     : process::ProcessBase(process::ID::generate("status-update-manager")),
+      syncInterval(_syncInterval),
       paused(false) {}
 
   StatusUpdateManagerProcess(const StatusUpdateManagerProcess& that) = delete;
@@ -207,6 +219,18 @@ public:
       return Nothing();
     }
 
+    if (syncing(stream)) {
+      return sync(streamId)
+        .then(process::defer(
+            ProtobufProcess<
+                StatusUpdateManagerProcess<
+                IDType,
+                CheckpointType,
+                UpdateType>>::self(),
+            &StatusUpdateManagerProcess::_update,
+            streamId));
+    }
+
     // Forward the status update if this is at the front of the queue.
     // Subsequent status updates will be sent in `acknowledgement()`.
     if (!paused && stream->pending.size() == 1) {
@@ -263,6 +287,19 @@ public:
 
     stream->timeout = None();
 
+    if (syncing(stream)) {
+      return sync(streamId)
+        .then(process::defer(
+            ProtobufProcess<
+                StatusUpdateManagerProcess<
+                IDType,
+                CheckpointType,
+                UpdateType>>::self(),
+            &StatusUpdateManagerProcess::_acknowledgement,
+            streamId,
+            stream->terminated));
+    }
+
     // Get the next update in the queue.
     const Result<UpdateType>& next = stream->next();
     if (next.isError()) {
@@ -374,6 +411,11 @@ public:
     foreachpair (const IDType& streamId,
                  process::Owned<StatusUpdateStream>& stream,
                  streams) {
+      // Updates not yet synced are forwarded once they are, see `_update()`.
+      if (unsynced.contains(streamId)) {
+        continue;
+      }
+
       const Result<UpdateType>& next = stream->next();
 
       if (next.isSome()) {
@@ -391,6 +433,122 @@ private:
   // Forward declarations.
   class StatusUpdateStream;
 
+  // Continuation of `update()` once the update is on disk.
+  process::Future<Nothing> _update(const IDType& streamId)
+  {
+    // The stream might have been cleaned up in the meantime.
+    if (!streams.contains(streamId)) {
+      return Nothing();
+    }
+
+    StatusUpdateStream* stream = streams[streamId].get();
+
+    const Result<UpdateType>& next = stream->next();
+    if (next.isError()) {
+      return process::Failure(next.error());
+    }
+
+    // NOTE: Several updates of the stream might have been synced at once, so
+    // rather than checking whether this update is the only one queued we
+    // check that the update at the front of the queue isn't being forwarded
+    // already.
+    if (!paused && next.isSome() && stream->timeout.isNone()) {
+      stream->timeout =
+        forward(streamId, next.get(), slave::STATUS_UPDATE_RETRY_INTERVAL_MIN);
+    }
+
+    return Nothing();
+  }
+
+  // Continuation of `acknowledgement()` once the ACK is on disk.
+  process::Future<bool> _acknowledgement(
+      const IDType& streamId,
+      bool terminated)
+  {
+    // The stream might have been cleaned up in the meantime.
+    if (!streams.contains(streamId)) {
+      return !terminated;
+    }
+
+    StatusUpdateStream* stream = streams[streamId].get();
+
+    const Result<UpdateType>& next = stream->next();
+    if (next.isError()) {
+      return process::Failure(next.error());
+    }
+
+    if (terminated) {
+      if (next.isSome()) {
+        LOG(WARNING) << "Acknowledged a terminal status update but updates are"
+                     << " still pending";
+      }
+      cleanupStatusUpdateStream(streamId);
+    } else if (!paused && next.isSome() && stream->timeout.isNone()) {
+      // Forward the next queued status update.
+      stream->timeout =
+        forward(streamId, next.get(), slave::STATUS_UPDATE_RETRY_INTERVAL_MIN);
+    }
+
+    return !terminated;
+  }
+
+  // Returns `true` if the records of the stream are synced to disk in groups
+  // rather than written synchronously.
+  bool syncing(StatusUpdateStream* stream) const
+  {
+    return stream->checkpointed() && syncInterval != Duration::zero();
+  }
+
+  // Returns a future that is satisfied once the records written to the stream
+  // so far are synced to disk, scheduling a sync of all unsynced streams if
+  // there isn't one pending already.
+  process::Future<Nothing> sync(const IDType& streamId)
+  {
+    unsynced.insert(streamId);
+
+    if (pendingSync.isNone()) {
+      pendingSync = process::Owned<process::Promise<Nothing>>(
+          new process::Promise<Nothing>());
+
+      delay(
+          syncInterval,
+          ProtobufProcess<
+              StatusUpdateManagerProcess<
+              IDType,
+              CheckpointType,
+              UpdateType>>::self(),
+          &StatusUpdateManagerProcess::_sync);
+    }
+
+    return pendingSync.get()->future();
+  }
+
+  void _sync()
+  {
+    CHECK_SOME(pendingSync);
+
+    process::Owned<process::Promise<Nothing>> promise = pendingSync.get();
+    pendingSync = None();
+
+    VLOG(1) << "Syncing " << unsynced.size() << " status update streams";
+
+    foreach (const IDType& streamId, unsynced) {
+      CHECK(streams.contains(streamId));
+
+      // NOTE: A failure to sync is a non-retryable error of the stream which
+      // gets surfaced by the continuations of `update()` and
+      // `acknowledgement()`, so we don't fail the promise here.
+      Try<Nothing> synced = streams[streamId]->sync();
+      if (synced.isError()) {
+        LOG(ERROR) << synced.error();
+      }
+    }
+
+    unsynced.clear();
+
+    promise->set(Nothing());
+  }
+
   // Helper methods.
 
   // Creates a new status update stream, adding it to `streams`.
@@ -406,7 +564,8 @@ private:
       StatusUpdateStream::create(
           streamId,
           frameworkId,
-          checkpoint ? Option<std::string>(getPath(streamId)) : None());
+          checkpoint ? Option<std::string>(getPath(streamId)) : None(),
+          syncInterval == Duration::zero());
 
     if (stream.isError()) {
       return Error(stream.error());
@@ -432,7 +591,11 @@ private:
     Result<std::pair<
         process::Owned<StatusUpdateStream>,
         typename StatusUpdateStream::State>> result =
-          StatusUpdateStream::recover(streamId, getPath(streamId), strict);
+          StatusUpdateStream::recover(
+              streamId,
+              getPath(streamId),
+              strict,
+              syncInterval == Duration::zero());
 
     if (result.isError()) {
       return Error(result.error());
@@ -479,6 +642,17 @@ private:
 
     StatusUpdateStream* stream = streams[streamId].get();
 
+    // Make sure that the records of the stream don't get lost along with
+    // the file descriptor.
+    if (unsynced.contains(streamId)) {
+      Try<Nothing> synced = stream->sync();
+      if (synced.isError()) {
+        LOG(ERROR) << synced.error();
+      }
+
+      unsynced.erase(streamId);
+    }
+
     if (stream->frameworkId.isSome()) {
       const FrameworkID frameworkId = stream->frameworkId.get();
 
@@ -530,9 +704,10 @@ private:
     StatusUpdateStream* stream = streams[streamId].get();
 
     // Check and see if we should resend the status update.
-    if (!stream->pending.empty()) {
-      CHECK_SOME(stream->timeout);
-
+    //
+    // NOTE: The timeout might not be set if the ACK of the last forwarded
+    // update is still being synced, see `acknowledgement()`.
+    if (!stream->pending.empty() && stream->timeout.isSome()) {
       if (stream->timeout->expired()) {
         const UpdateType& update = stream->pending.front();
         LOG(WARNING) << "Resending status update " << update;
@@ -551,6 +726,12 @@ private:
 
   hashmap<IDType, process::Owned<StatusUpdateStream>> streams;
   hashmap<FrameworkID, hashset<IDType>> frameworkStreams;
+
+  // See `sync()`.
+  const Duration syncInterval;
+  hashset<IDType> unsynced;
+  Option<process::Owned<process::Promise<Nothing>>> pendingSync;
+
   bool paused;
 
   // Handles the status updates and acknowledgements, checkpointing them if
@@ -585,7 +766,8 @@ private:
     static Try<process::Owned<StatusUpdateStream>> create(
         const IDType& streamId,
         const Option<FrameworkID>& frameworkId,
-        const Option<std::string>& path)
+        const Option<std::string>& path,
+        bool synchronous)
     {
       Option<int_fd> fd;
 
@@ -606,7 +788,7 @@ private:
         // Open the updates file.
         Try<int_fd> result = os::open(
             path.get(),
-            O_CREAT | O_SYNC | O_WRONLY | O_CLOEXEC,
+            O_CREAT | O_WRONLY | O_CLOEXEC | (synchronous ? O_SYNC : 0),
             S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
 
         if (result.isError()) {
@@ -628,7 +810,11 @@ private:
 
 
     static Result<std::pair<process::Owned<StatusUpdateStream>, State>>
-    recover(const IDType& streamId, const std::string& path, bool strict)
+    recover(
+        const IDType& streamId,
+        const std::string& path,
+        bool strict,
+        bool synchronous)
     {
       if (os::exists(Path(path).dirname()) && !os::exists(path)) {
         // This could happen if the process died before it checkpointed any
@@ -637,7 +823,8 @@ private:
       }
 
       // Open the status updates file for reading and writing.
-      Try<int_fd> fd = os::open(path, O_SYNC | O_RDWR | O_CLOEXEC);
+      Try<int_fd> fd =
+        os::open(path, O_RDWR | O_CLOEXEC | (synchronous ? O_SYNC : 0));
 
       if (fd.isError()) {
         return Error(
@@ -862,6 +1049,26 @@ private:
     // Returns `true` if the stream is checkpointed, `false` otherwise.
     bool checkpointed() { return path.isSome(); }
 
+    // Flushes the records written to the status updates file to disk.
+    Try<Nothing> sync()
+    {
+      if (error.isSome()) {
+        return Error(error.get());
+      }
+
+      CHECK_SOME(fd);
+
+      Try<Nothing> fsync = os::fsync(fd.get());
+      if (fsync.isError()) {
+        error =
+          "Failed to sync status updates file '" + path.get() + "': " +
+          fsync.error();
+        return Error(error.get());
+      }
+
+      return Nothing();
+    }
+
     bool terminated;
     Option<FrameworkID> frameworkId;
     Option<process::Timeout> timeout; // Timeout for resending status update.
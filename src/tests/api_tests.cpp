@@ -982,7 +982,7 @@ TEST_P(MasterAPITest, ReserveResources)
 {
   TestAllocator<> allocator;
 
-  EXPECT_CALL(allocator, initialize(_, _, _, _, _, _));
+  EXPECT_CALL(allocator, initialize(_, _, _, _, _, _, _, _, _));
 
   Try<Owned<cluster::Master>> master = StartMaster(&allocator);
   ASSERT_SOME(master);
@@ -1073,7 +1073,7 @@ TEST_P(MasterAPITest, UnreserveResources)
 {
   TestAllocator<> allocator;
 
-  EXPECT_CALL(allocator, initialize(_, _, _, _, _, _));
+  EXPECT_CALL(allocator, initialize(_, _, _, _, _, _, _, _, _));
 
   Try<Owned<cluster::Master>> master = StartMaster(&allocator);
   ASSERT_SOME(master);
@@ -1646,6 +1646,215 @@ TEST_P(MasterAPITest, SubscribeAgentEvents)
 }
 
 
+// This test verifies that a client which subscribes again with the
+// version of the last event it received gets the events it missed,
+// rather than a snapshot of the state.
+TEST_P(MasterAPITest, SubscribeResume)
+{
+  ContentType contentType = GetParam();
+
+  Try<Owned<cluster::Master>> master = this->StartMaster();
+  ASSERT_SOME(master);
+
+  auto subscribe = [&](const Option<uint64_t>& version) {
+    v1::master::Call v1Call;
+    v1Call.set_type(v1::master::Call::SUBSCRIBE);
+
+    if (version.isSome()) {
+      v1Call.mutable_subscribe()->set_version(version.get());
+    }
+
+    http::Headers headers = createBasicAuthHeaders(DEFAULT_CREDENTIAL);
+
+    headers["Accept"] = stringify(contentType);
+
+    return http::streaming::post(
+        master.get()->pid,
+        "api/v1",
+        headers,
+        serialize(contentType, v1Call),
+        stringify(contentType));
+  };
+
+  auto deserializer =
+    lambda::bind(deserialize<v1::master::Event>, contentType, lambda::_1);
+
+  uint64_t version;
+
+  {
+    Future<http::Response> response = subscribe(None());
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, response);
+    ASSERT_EQ(http::Response::PIPE, response->type);
+    ASSERT_SOME(response->reader);
+
+    http::Pipe::Reader reader = response->reader.get();
+
+    Reader<v1::master::Event> decoder(
+        Decoder<v1::master::Event>(deserializer), reader);
+
+    Future<Result<v1::master::Event>> event = decoder.read();
+    AWAIT_READY(event);
+
+    ASSERT_EQ(v1::master::Event::SUBSCRIBED, event->get().type());
+    ASSERT_TRUE(event->get().subscribed().has_get_state());
+    ASSERT_TRUE(event->get().subscribed().has_version());
+
+    version = event->get().subscribed().version();
+
+    reader.close();
+  }
+
+  // Start an agent while the client is not subscribed.
+  Future<SlaveRegisteredMessage> agentRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), master.get()->pid, _);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get());
+  ASSERT_SOME(slave);
+
+  AWAIT_READY(agentRegisteredMessage);
+
+  {
+    Future<http::Response> response = subscribe(version);
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, response);
+    ASSERT_EQ(http::Response::PIPE, response->type);
+    ASSERT_SOME(response->reader);
+
+    Reader<v1::master::Event> decoder(
+        Decoder<v1::master::Event>(deserializer), response->reader.get());
+
+    Future<Result<v1::master::Event>> event = decoder.read();
+    AWAIT_READY(event);
+
+    ASSERT_EQ(v1::master::Event::SUBSCRIBED, event->get().type());
+    EXPECT_FALSE(event->get().subscribed().has_get_state());
+    EXPECT_EQ(version, event->get().subscribed().version());
+
+    event = decoder.read();
+    AWAIT_READY(event);
+
+    EXPECT_EQ(v1::master::Event::HEARTBEAT, event->get().type());
+
+    event = decoder.read();
+    AWAIT_READY(event);
+
+    ASSERT_EQ(v1::master::Event::AGENT_ADDED, event->get().type());
+    EXPECT_EQ(
+        evolve(agentRegisteredMessage->slave_id()),
+        event->get().agent_added().agent().agent_info().id());
+    EXPECT_EQ(version + 1, event->get().version());
+  }
+
+  // A version the master does not know gets a snapshot of the state.
+  {
+    Future<http::Response> response = subscribe(version + 100);
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, response);
+    ASSERT_EQ(http::Response::PIPE, response->type);
+    ASSERT_SOME(response->reader);
+
+    Reader<v1::master::Event> decoder(
+        Decoder<v1::master::Event>(deserializer), response->reader.get());
+
+    Future<Result<v1::master::Event>> event = decoder.read();
+    AWAIT_READY(event);
+
+    ASSERT_EQ(v1::master::Event::SUBSCRIBED, event->get().type());
+    ASSERT_TRUE(event->get().subscribed().has_get_state());
+    EXPECT_EQ(version + 1, event->get().subscribed().version());
+    EXPECT_EQ(
+        1, event->get().subscribed().get_state().get_agents().agents_size());
+  }
+}
+
+
+// This test verifies that events are buffered and written to the
+// subscriber in batches when `--operator_event_stream_flush_interval`
+// is set.
+TEST_P(MasterAPITest, SubscribeFlushInterval)
+{
+  ContentType contentType = GetParam();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.operator_event_stream_flush_interval = Seconds(1);
+
+  Try<Owned<cluster::Master>> master = this->StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  v1::master::Call v1Call;
+  v1Call.set_type(v1::master::Call::SUBSCRIBE);
+
+  http::Headers headers = createBasicAuthHeaders(DEFAULT_CREDENTIAL);
+
+  headers["Accept"] = stringify(contentType);
+
+  Future<http::Response> response = http::streaming::post(
+      master.get()->pid,
+      "api/v1",
+      headers,
+      serialize(contentType, v1Call),
+      stringify(contentType));
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, response);
+  ASSERT_EQ(http::Response::PIPE, response->type);
+  ASSERT_SOME(response->reader);
+
+  http::Pipe::Reader reader = response->reader.get();
+
+  auto deserializer =
+    lambda::bind(deserialize<v1::master::Event>, contentType, lambda::_1);
+
+  Reader<v1::master::Event> decoder(
+      Decoder<v1::master::Event>(deserializer), reader);
+
+  Future<Result<v1::master::Event>> event = decoder.read();
+  AWAIT_READY(event);
+
+  EXPECT_EQ(v1::master::Event::SUBSCRIBED, event->get().type());
+
+  event = decoder.read();
+  AWAIT_READY(event);
+
+  EXPECT_EQ(v1::master::Event::HEARTBEAT, event->get().type());
+
+  Clock::pause();
+
+  // Start one agent.
+  Future<SlaveRegisteredMessage> agentRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), master.get()->pid, _);
+
+  slave::Flags slaveFlags = CreateSlaveFlags();
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get(), slaveFlags);
+  ASSERT_SOME(slave);
+
+  Clock::advance(slaveFlags.registration_backoff_factor);
+
+  AWAIT_READY(agentRegisteredMessage);
+
+  // The `AGENT_ADDED` event is buffered until the flush interval
+  // has elapsed.
+  event = decoder.read();
+
+  Clock::settle();
+  EXPECT_TRUE(event.isPending());
+
+  Clock::advance(masterFlags.operator_event_stream_flush_interval);
+
+  AWAIT_READY(event);
+
+  ASSERT_EQ(v1::master::Event::AGENT_ADDED, event->get().type());
+  EXPECT_EQ(
+      evolve(agentRegisteredMessage->slave_id()),
+      event->get().agent_added().agent().agent_info().id());
+
+  Clock::resume();
+}
+
+
 // This test verifies that no information about reservations and/or allocations
 // is returned to unauthorized users in response to the GET_AGENTS call.
 TEST_P(MasterAPITest, GetAgentsFiltering)
@@ -14,6 +14,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include <mesos/executor.hpp>
@@ -27,6 +29,9 @@
 #include <process/owned.hpp>
 
 #include <stout/nothing.hpp>
+#include <stout/path.hpp>
+
+#include <stout/os/write.hpp>
 
 #include "master/detector/standalone.hpp"
 
@@ -41,6 +46,8 @@ using mesos::internal::slave::Slave;
 using mesos::master::detector::MasterDetector;
 using mesos::master::detector::StandaloneMasterDetector;
 
+using std::string;
+
 using testing::_;
 using testing::Eq;
 using testing::Return;
@@ -372,6 +379,49 @@ TEST_F(AuthenticationTest, RetrySlaveAuthentication)
 }
 
 
+// This test verifies that the master refuses authentications beyond
+// `--max_pending_authentications` while other authentications are in
+// progress.
+TEST_F(AuthenticationTest, MaxPendingAuthentications)
+{
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.max_pending_authentications = 1;
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  // Drop the AuthenticationStepMessage from authenticator, which keeps
+  // the authentication of the scheduler pending.
+  Future<AuthenticationStepMessage> authenticationStepMessage =
+    DROP_PROTOBUF(AuthenticationStepMessage(), _, _);
+
+  driver.start();
+
+  AWAIT_READY(authenticationStepMessage);
+
+  JSON::Object metrics = Metrics();
+  EXPECT_EQ(1, metrics.values["master/authentication_pending"]);
+
+  Future<AuthenticationErrorMessage> authenticationErrorMessage =
+    FUTURE_PROTOBUF(AuthenticationErrorMessage(), _, _);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get());
+  ASSERT_SOME(slave);
+
+  AWAIT_READY(authenticationErrorMessage);
+  EXPECT_EQ("Too many pending authentications",
+            authenticationErrorMessage->error());
+
+  driver.stop();
+  driver.join();
+}
+
+
 // This test verifies that the framework properly retries
 // authentication when an intermediate message in SASL protocol
 // is lost.
@@ -623,6 +673,57 @@ TEST_F(AuthenticationTest, MasterFailoverDuringSlaveAuthentication)
 }
 
 
+#ifdef USE_SSL_SOCKET
+// This test verifies that an agent authenticates with the token handed
+// out by the master after a failover to a master sharing the key used
+// to sign the tokens, without going through the authenticator again.
+TEST_F(AuthenticationTest, MasterFailoverWithAuthenticationToken)
+{
+  const string key = path::join(sandbox.get(), "token_key");
+  ASSERT_SOME(os::write(key, "secret"));
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.authentication_token_secret_key = Path(key);
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  Future<AuthenticationTokenMessage> authenticationTokenMessage =
+    FUTURE_PROTOBUF(AuthenticationTokenMessage(), _, _);
+
+  Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), _, _);
+
+  StandaloneMasterDetector detector(master.get()->pid);
+  Try<Owned<cluster::Slave>> slave = StartSlave(&detector);
+  ASSERT_SOME(slave);
+
+  AWAIT_READY(authenticationTokenMessage);
+  AWAIT_READY(slaveRegisteredMessage);
+
+  master->reset();
+  master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  Future<AuthenticateMessage> authenticateMessage =
+    FUTURE_PROTOBUF(AuthenticateMessage(), _, _);
+
+  // The token replaces the SASL exchange.
+  EXPECT_NO_FUTURE_PROTOBUFS(AuthenticationStartMessage(), _, _);
+
+  Future<SlaveReregisteredMessage> slaveReregisteredMessage =
+    FUTURE_PROTOBUF(SlaveReregisteredMessage(), _, _);
+
+  detector.appoint(master.get()->pid);
+
+  AWAIT_READY(authenticateMessage);
+  EXPECT_EQ(authenticationTokenMessage->token(), authenticateMessage->token());
+
+  AWAIT_READY(slaveReregisteredMessage);
+}
+#endif // USE_SSL_SOCKET
+
+
 // This test verifies that if the scheduler retries authentication
 // before the original authentication finishes (e.g., new master
 // detected due to leader election), it is handled properly.
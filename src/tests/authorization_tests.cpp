@@ -2271,6 +2271,76 @@ TYPED_TEST(AuthorizationTest, ViewFramework)
 }
 
 
+// This tests that the first ACL matching both the subject and the
+// object decides, even if a later ACL explicitly lists the object.
+TYPED_TEST(AuthorizationTest, FirstMatchingACL)
+{
+  // Setup ACLs.
+  ACLs acls;
+
+  {
+    // "foo" principal can view frameworks running under user "alice".
+    mesos::ACL::ViewFramework* acl = acls.add_view_frameworks();
+    acl->mutable_principals()->add_values("foo");
+    acl->mutable_users()->add_values("alice");
+  }
+
+  {
+    // "foo" principal can view no other frameworks.
+    mesos::ACL::ViewFramework* acl = acls.add_view_frameworks();
+    acl->mutable_principals()->add_values("foo");
+    acl->mutable_users()->set_type(mesos::ACL::Entity::NONE);
+  }
+
+  {
+    // This ACL is shadowed by the previous one.
+    mesos::ACL::ViewFramework* acl = acls.add_view_frameworks();
+    acl->mutable_principals()->add_values("foo");
+    acl->mutable_users()->add_values("bob");
+  }
+
+  // Create an `Authorizer` with the ACLs.
+  Try<Authorizer*> create = TypeParam::create(parameterize(acls));
+  ASSERT_SOME(create);
+  Owned<Authorizer> authorizer(create.get());
+
+  // Authorize each object twice, as the authorizer may reuse the
+  // ACLs compiled for the subject.
+  for (int i = 0; i < 2; i++) {
+    // Principal "foo" can view a framework running with user "alice".
+    {
+      authorization::Request request;
+      request.set_action(authorization::VIEW_FRAMEWORK);
+      request.mutable_subject()->set_value("foo");
+      request.mutable_object()->mutable_framework_info()->set_user("alice");
+
+      AWAIT_EXPECT_TRUE(authorizer->authorized(request));
+    }
+
+    // Principal "foo" cannot view a framework running with user "bob".
+    {
+      authorization::Request request;
+      request.set_action(authorization::VIEW_FRAMEWORK);
+      request.mutable_subject()->set_value("foo");
+      request.mutable_object()->mutable_framework_info()->set_user("bob");
+
+      AWAIT_EXPECT_FALSE(authorizer->authorized(request));
+    }
+
+    // Principal "bar" can view a framework running with user "bob",
+    // since no ACL matches and the ACLs are permissive.
+    {
+      authorization::Request request;
+      request.set_action(authorization::VIEW_FRAMEWORK);
+      request.mutable_subject()->set_value("bar");
+      request.mutable_object()->mutable_framework_info()->set_user("bob");
+
+      AWAIT_EXPECT_TRUE(authorizer->authorized(request));
+    }
+  }
+}
+
+
 // This tests the authorization of requests to ViewContainer.
 TYPED_TEST(AuthorizationTest, ViewContainer)
 {
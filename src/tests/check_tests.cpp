@@ -21,11 +21,15 @@
 
 #include <mesos/v1/mesos.hpp>
 
+#include <process/address.hpp>
 #include <process/clock.hpp>
+#include <process/future.hpp>
 #include <process/owned.hpp>
+#include <process/socket.hpp>
 
 #include <stout/hashmap.hpp>
 #include <stout/foreach.hpp>
+#include <stout/ip.hpp>
 #include <stout/nothing.hpp>
 #include <stout/path.hpp>
 #include <stout/try.hpp>
@@ -52,6 +56,7 @@ using mesos::v1::scheduler::Mesos;
 
 using process::Future;
 using process::Owned;
+using process::Promise;
 
 using std::pair;
 using std::string;
@@ -1732,6 +1737,180 @@ TEST_F_TEMP_DISABLED_ON_WINDOWS(
 }
 
 
+// Verifies that a command check's status changes are delivered if the
+// checks are performed in a persistent nested container.
+TEST_F_TEMP_DISABLED_ON_WINDOWS(
+    DefaultExecutorCheckTest,
+    PersistentCommandCheckStatusChange)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  slave::Flags flags = CreateSlaveFlags();
+  flags.persistent_command_checks = true;
+
+  Fetcher fetcher(flags);
+
+  // We have to explicitly create a `Containerizer` in non-local mode,
+  // because `LaunchNestedContainerSession` (used by command checks)
+  // tries to start a IO switchboard, which doesn't work in local mode yet.
+  Try<MesosContainerizer*> _containerizer =
+    MesosContainerizer::create(flags, false, &fetcher);
+
+  ASSERT_SOME(_containerizer);
+
+  Owned<slave::Containerizer> containerizer(_containerizer.get());
+  Owned<MasterDetector> detector = master.get()->createDetector();
+
+  Try<Owned<cluster::Slave>> agent =
+    StartSlave(detector.get(), containerizer.get(), flags);
+  ASSERT_SOME(agent);
+
+  v1::FrameworkInfo frameworkInfo = v1::DEFAULT_FRAMEWORK_INFO;
+
+  const v1::Resources resources =
+    v1::Resources::parse(defaultTaskResourcesString).get();
+
+  v1::ExecutorInfo executorInfo;
+  executorInfo.set_type(v1::ExecutorInfo::DEFAULT);
+  executorInfo.mutable_executor_id()->CopyFrom(v1::DEFAULT_EXECUTOR_ID);
+  executorInfo.mutable_resources()->CopyFrom(resources);
+  executorInfo.mutable_shutdown_grace_period()->set_nanoseconds(
+      Seconds(10).ns());
+
+  auto scheduler = std::make_shared<v1::MockHTTPScheduler>();
+
+  Future<Nothing> connected;
+  EXPECT_CALL(*scheduler, connected(_))
+    .WillOnce(FutureSatisfy(&connected))
+    .WillRepeatedly(Return()); // Ignore teardown reconnections, see MESOS-6033.
+
+  v1::scheduler::TestMesos mesos(
+      master.get()->pid,
+      ContentType::PROTOBUF,
+      scheduler);
+
+  AWAIT_READY(connected);
+
+  Future<v1::scheduler::Event::Subscribed> subscribed;
+  EXPECT_CALL(*scheduler, subscribed(_, _))
+    .WillOnce(FutureArg<1>(&subscribed));
+
+  Future<v1::scheduler::Event::Offers> offers;
+  EXPECT_CALL(*scheduler, offers(_, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  EXPECT_CALL(*scheduler, heartbeat(_))
+    .WillRepeatedly(Return()); // Ignore heartbeats.
+
+  subscribe(&mesos, frameworkInfo);
+
+  AWAIT_READY(subscribed);
+
+  v1::FrameworkID frameworkId(subscribed->framework_id());
+
+  // Update `executorInfo` with the subscribed `frameworkId`.
+  executorInfo.mutable_framework_id()->CopyFrom(frameworkId);
+
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->offers().empty());
+  const v1::Offer& offer = offers->offers(0);
+  const v1::AgentID& agentId = offer.agent_id();
+
+  Future<Event::Update> updateTaskStarting;
+  Future<Event::Update> updateTaskRunning;
+  Future<Event::Update> updateCheckResult;
+  Future<Event::Update> updateCheckResultChanged;
+  Future<Event::Update> updateCheckResultBack;
+
+  EXPECT_CALL(*scheduler, update(_, _))
+    .WillOnce(FutureArg<1>(&updateTaskStarting))
+    .WillOnce(FutureArg<1>(&updateTaskRunning))
+    .WillOnce(FutureArg<1>(&updateCheckResult))
+    .WillOnce(FutureArg<1>(&updateCheckResultChanged))
+    .WillOnce(FutureArg<1>(&updateCheckResultBack))
+    .WillRepeatedly(Return()); // Ignore subsequent updates.
+
+  v1::TaskInfo taskInfo =
+    v1::createTask(agentId, resources, SLEEP_COMMAND(10000));
+
+  v1::CheckInfo* checkInfo = taskInfo.mutable_check();
+  checkInfo->set_type(v1::CheckInfo::COMMAND);
+  checkInfo->set_delay_seconds(0);
+  checkInfo->set_interval_seconds(0);
+  checkInfo->mutable_command()->mutable_command()->set_value(
+      FLAPPING_CHECK_COMMAND(path::join(os::getcwd(), "XXXXXX")));
+
+  v1::TaskGroupInfo taskGroup;
+  taskGroup.add_tasks()->CopyFrom(taskInfo);
+
+  launchTaskGroup(&mesos, offer, executorInfo, taskGroup);
+
+  AWAIT_READY(updateTaskStarting);
+  ASSERT_EQ(TASK_STARTING, updateTaskStarting->status().state());
+  EXPECT_EQ(taskInfo.task_id(), updateTaskStarting->status().task_id());
+
+  acknowledge(&mesos, frameworkId, updateTaskStarting->status());
+
+  AWAIT_READY(updateTaskRunning);
+  ASSERT_EQ(TASK_RUNNING, updateTaskRunning->status().state());
+  EXPECT_EQ(taskInfo.task_id(), updateTaskRunning->status().task_id());
+
+  acknowledge(&mesos, frameworkId, updateTaskRunning->status());
+
+  AWAIT_READY(updateCheckResult);
+  const v1::TaskStatus& checkResult = updateCheckResult->status();
+
+  ASSERT_EQ(TASK_RUNNING, checkResult.state());
+  ASSERT_EQ(
+      v1::TaskStatus::REASON_TASK_CHECK_STATUS_UPDATED,
+      checkResult.reason());
+  EXPECT_TRUE(checkResult.check_status().command().has_exit_code());
+  EXPECT_EQ(1, checkResult.check_status().command().exit_code());
+
+  acknowledge(&mesos, frameworkId, checkResult);
+
+  AWAIT_READY(updateCheckResultChanged);
+  const v1::TaskStatus& checkResultChanged = updateCheckResultChanged->status();
+
+  ASSERT_EQ(TASK_RUNNING, checkResultChanged.state());
+  ASSERT_EQ(
+      v1::TaskStatus::REASON_TASK_CHECK_STATUS_UPDATED,
+      checkResultChanged.reason());
+  EXPECT_TRUE(checkResultChanged.check_status().command().has_exit_code());
+  EXPECT_EQ(0, checkResultChanged.check_status().command().exit_code());
+
+  acknowledge(&mesos, frameworkId, checkResultChanged);
+
+  AWAIT_READY(updateCheckResultBack);
+  const v1::TaskStatus& checkResultBack = updateCheckResultBack->status();
+
+  ASSERT_EQ(TASK_RUNNING, checkResultBack.state());
+  ASSERT_EQ(
+      v1::TaskStatus::REASON_TASK_CHECK_STATUS_UPDATED,
+      checkResultBack.reason());
+  EXPECT_TRUE(checkResultBack.check_status().command().has_exit_code());
+  EXPECT_EQ(1, checkResultBack.check_status().command().exit_code());
+
+  // Cleanup all mesos launched containers.
+  Future<hashset<ContainerID>> containerIds = containerizer->containers();
+  AWAIT_READY(containerIds);
+
+  // All checks should have been performed in the same nested container,
+  // so besides the executor and the task there is only one container.
+  EXPECT_EQ(3u, containerIds->size());
+
+  EXPECT_CALL(*scheduler, disconnected(_));
+
+  teardown(&mesos, frameworkId);
+
+  foreach (const ContainerID& containerId, containerIds.get()) {
+    AWAIT_READY(containerizer->wait(containerId));
+  }
+}
+
+
 // Verifies that an environment variable set for the task is seen by its
 // command check.
 TEST_F_TEMP_DISABLED_ON_WINDOWS(
@@ -3072,6 +3251,76 @@ TEST_F(CheckTest, CheckStatusInfoValidation)
   }
 }
 
+
+// Verifies that HTTP checks, which are performed from within the checker
+// rather than with curl, follow redirects to the task.
+TEST_F(CheckTest, HTTPCheckFollowsRedirect)
+{
+  Try<process::network::inet::Socket> server =
+    process::network::inet::Socket::create();
+  ASSERT_SOME(server);
+
+  Try<net::IP> ip = net::IP::parse("127.0.0.1", AF_INET);
+  ASSERT_SOME(ip);
+
+  Try<process::network::inet::Address> address =
+    server->bind(process::network::inet::Address(ip.get(), 0));
+  ASSERT_SOME(address);
+  ASSERT_SOME(server->listen(1));
+
+  CheckInfo checkInfo;
+  checkInfo.set_type(CheckInfo::HTTP);
+  checkInfo.set_delay_seconds(0);
+  checkInfo.set_interval_seconds(1000);
+  checkInfo.mutable_http()->set_port(address->port);
+  checkInfo.mutable_http()->set_path("/redirect");
+
+  TaskID taskId;
+  taskId.set_value("task");
+
+  Promise<CheckStatusInfo> checkStatus;
+
+  Try<Owned<checks::Checker>> checker = checks::Checker::create(
+      checkInfo,
+      os::getcwd(),
+      [&checkStatus](const CheckStatusInfo& status) {
+        checkStatus.set(status);
+      },
+      taskId,
+      None(),
+      vector<string>());
+
+  ASSERT_SOME(checker);
+
+  const vector<string> responses = {
+    "HTTP/1.1 302 Found\r\nLocation: /ok\r\nContent-Length: 0\r\n\r\n",
+    "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n"
+  };
+
+  vector<string> requests;
+
+  foreach (const string& response, responses) {
+    Future<process::network::inet::Socket> accept = server->accept();
+    AWAIT_READY(accept);
+
+    process::network::inet::Socket client = accept.get();
+
+    Future<string> request = client.recv();
+    AWAIT_READY(request);
+
+    requests.push_back(request.get());
+
+    AWAIT_READY(client.send(response));
+  }
+
+  AWAIT_READY(checkStatus.future());
+  EXPECT_EQ(200u, checkStatus.future()->http().status_code());
+
+  ASSERT_EQ(2u, requests.size());
+  EXPECT_TRUE(strings::startsWith(requests[0], "GET /redirect HTTP/1.1"));
+  EXPECT_TRUE(strings::startsWith(requests[1], "GET /ok HTTP/1.1"));
+}
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
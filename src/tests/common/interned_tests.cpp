@@ -0,0 +1,61 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "common/interned.hpp"
+
+using std::string;
+
+using mesos::internal::intern;
+using mesos::internal::interned;
+
+
+TEST(InternedTest, Intern)
+{
+  const uint32_t cpus = intern("cpus");
+  const uint32_t mem = intern("mem");
+
+  EXPECT_NE(cpus, mem);
+  EXPECT_EQ(cpus, intern(string("cp") + "us"));
+
+  EXPECT_EQ("cpus", interned(cpus));
+  EXPECT_EQ("mem", interned(mem));
+}
+
+
+// Verifies that threads (which each have their own cache) agree on
+// the id of a string.
+TEST(InternedTest, Threads)
+{
+  uint32_t first;
+  uint32_t second;
+
+  std::thread thread1([&first]() { first = intern("eng/team/service"); });
+  std::thread thread2([&second]() { second = intern("eng/team/service"); });
+
+  thread1.join();
+  thread2.join();
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(first, intern("eng/team/service"));
+  EXPECT_EQ("eng/team/service", interned(first));
+}
@@ -14,6 +14,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <deque>
 #include <ostream>
 #include <string>
 
@@ -29,6 +30,7 @@
 
 using process::Future;
 
+using std::deque;
 using std::string;
 
 using namespace mesos;
@@ -104,6 +106,48 @@ TEST(RecordIOReaderTest, EndOfFile)
 }
 
 
+// This test verifies that `readAll()` returns all of the records
+// decoded so far at once.
+TEST(RecordIOReaderTest, ReadAll)
+{
+  ::recordio::Encoder<string> encoder(strings::upper);
+
+  process::http::Pipe pipe;
+  pipe.writer().write(encoder.encode("hello") + encoder.encode("world!"));
+
+  mesos::internal::recordio::Reader<string> reader(
+      ::recordio::Decoder<string>(strings::lower),
+      pipe.reader());
+
+  Future<deque<Result<string>>> records = reader.readAll();
+  AWAIT_READY(records);
+
+  ASSERT_EQ(2u, records->size());
+  EXPECT_EQ(Result<string>::some("hello"), records->at(0));
+  EXPECT_EQ(Result<string>::some("world!"), records->at(1));
+
+  // An outstanding read gets the records of the next write.
+  records = reader.readAll();
+  EXPECT_TRUE(records.isPending());
+
+  pipe.writer().write(encoder.encode("good") + encoder.encode("bye"));
+
+  AWAIT_READY(records);
+
+  ASSERT_EQ(2u, records->size());
+  EXPECT_EQ(Result<string>::some("good"), records->at(0));
+  EXPECT_EQ(Result<string>::some("bye"), records->at(1));
+
+  pipe.writer().close();
+
+  records = reader.readAll();
+  AWAIT_READY(records);
+
+  ASSERT_EQ(1u, records->size());
+  EXPECT_EQ(Result<string>::none(), records->at(0));
+}
+
+
 TEST(RecordIOReaderTest, DecodingFailure)
 {
   ::recordio::Encoder<string> encoder(strings::upper);
@@ -30,6 +30,7 @@
 
 #include <stout/bytes.hpp>
 #include <stout/gtest.hpp>
+#include <stout/gzip.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
 #include <stout/strings.hpp>
@@ -503,6 +504,171 @@ TEST_F(ContainerLoggerTest, LOGROTATE_CustomRotateOptions)
 }
 
 
+// Tests that the packaged logrotate container logger rotates and
+// compresses the log files itself when the number of rotated files
+// is set in the Executor's environment.
+TEST_F(ContainerLoggerTest, LOGROTATE_NativeRotateInSandbox)
+{
+  // Create a master, agent, and framework.
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), _, _);
+
+  // We'll need access to these flags later.
+  slave::Flags flags = CreateSlaveFlags();
+
+  // Use the non-default container logger that rotates logs.
+  flags.container_logger = LOGROTATE_CONTAINER_LOGGER_NAME;
+
+  Fetcher fetcher(flags);
+
+  // We use an actual containerizer + executor since we want something to run.
+  Try<MesosContainerizer*> _containerizer =
+    MesosContainerizer::create(flags, false, &fetcher);
+
+  ASSERT_SOME(_containerizer);
+  Owned<MesosContainerizer> containerizer(_containerizer.get());
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+
+  Try<Owned<cluster::Slave>> slave =
+    StartSlave(detector.get(), containerizer.get(), flags);
+  ASSERT_SOME(slave);
+
+  AWAIT_READY(slaveRegisteredMessage);
+  SlaveID slaveId = slaveRegisteredMessage->slave_id();
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  Future<FrameworkID> frameworkId;
+  EXPECT_CALL(sched, registered(&driver, _, _))
+    .WillOnce(FutureArg<1>(&frameworkId));
+
+  // Wait for an offer, and start a task.
+  Future<vector<Offer>> offers;
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  driver.start();
+  AWAIT_READY(frameworkId);
+
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->empty());
+
+  // Start a task that spams stdout with 11 MB of (mostly blank) output,
+  // like in the `LOGROTATE_RotateInSandbox` test, but have the logger
+  // keep three compressed files of 2 MB each rather than use the
+  // `logrotate` options of the module.
+  TaskInfo task = createTask(
+      offers.get()[0],
+      "i=0; while [ $i -lt 11264 ]; "
+      "do printf '%-1024d\\n' $i; i=$((i+1)); done");
+
+  Environment::Variable* variable =
+    task.mutable_command()->mutable_environment()->add_variables();
+  variable->set_name("CONTAINER_LOGGER_MAX_STDOUT_FILES");
+  variable->set_value("3");
+
+  variable = task.mutable_command()->mutable_environment()->add_variables();
+  variable->set_name("CONTAINER_LOGGER_COMPRESS_ROTATED_LOGS");
+  variable->set_value("true");
+
+  Future<TaskStatus> statusStarting;
+  Future<TaskStatus> statusRunning;
+  Future<TaskStatus> statusFinished;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&statusStarting))
+    .WillOnce(FutureArg<1>(&statusRunning))
+    .WillOnce(FutureArg<1>(&statusFinished))
+    .WillRepeatedly(Return());       // Ignore subsequent updates.
+
+  driver.launchTasks(offers.get()[0].id(), {task});
+
+  AWAIT_READY(statusStarting);
+  EXPECT_EQ(TASK_STARTING, statusStarting->state());
+
+  AWAIT_READY(statusRunning);
+  EXPECT_EQ(TASK_RUNNING, statusRunning->state());
+
+  AWAIT_READY(statusFinished);
+  EXPECT_EQ(TASK_FINISHED, statusFinished->state());
+
+  driver.stop();
+  driver.join();
+
+  // Wait for the logger subprocesses to finish reading the container's
+  // pipe and exit, see the `LOGROTATE_RotateInSandbox` test.
+  Try<os::ProcessTree> pstrees = os::pstree(0);
+  ASSERT_SOME(pstrees);
+  foreach (const os::ProcessTree& pstree, pstrees->children) {
+    Duration waited = Duration::zero();
+    do {
+      if (!os::exists(pstree.process.pid)) {
+        break;
+      }
+
+      Clock::pause();
+      Clock::settle();
+      Clock::advance(Seconds(1));
+      Clock::resume();
+
+      os::sleep(Milliseconds(100));
+      waited += Milliseconds(100);
+    } while (waited < Seconds(5));
+
+    EXPECT_LE(waited, Seconds(5));
+  }
+
+  string sandboxDirectory = path::join(
+      slave::paths::getExecutorPath(
+          flags.work_dir,
+          slaveId,
+          frameworkId.get(),
+          statusRunning->executor_id()),
+      "runs",
+      "latest");
+
+  ASSERT_TRUE(os::exists(sandboxDirectory));
+
+  // No `logrotate` configuration should have been written.
+  EXPECT_FALSE(os::exists(
+      path::join(sandboxDirectory, "stdout.logrotate.conf")));
+
+  // The leading log file should be about half full (1 MB).
+  Try<Bytes> stdoutSize =
+    os::stat::size(path::join(sandboxDirectory, "stdout"));
+
+  ASSERT_SOME(stdoutSize);
+  EXPECT_LE(1024u, stdoutSize->kilobytes());
+  EXPECT_GE(1050u, stdoutSize->kilobytes());
+
+  // We should only have files up to "stdout.3.gz".
+  EXPECT_FALSE(os::exists(path::join(sandboxDirectory, "stdout.4.gz")));
+  EXPECT_FALSE(os::exists(path::join(sandboxDirectory, "stdout.1")));
+
+  for (int i = 1; i <= 3; i++) {
+    const string stdoutPath =
+      path::join(sandboxDirectory, "stdout." + stringify(i) + ".gz");
+
+    Try<string> compressed = os::read(stdoutPath);
+    ASSERT_SOME(compressed);
+
+    Try<string> decompressed = gzip::decompress(compressed.get());
+    ASSERT_SOME(decompressed);
+
+    // NOTE: The rotated files are written in contiguous blocks, meaning
+    // that each file may be less than the maximum allowed size.
+    EXPECT_LE(2040u, Bytes(decompressed->size()).kilobytes());
+    EXPECT_GE(2048u, Bytes(decompressed->size()).kilobytes());
+  }
+}
+
+
 // Tests that the logrotate container logger only closes FDs when it
 // is supposed to and does not interfere with other FDs on the agent.
 TEST_F(ContainerLoggerTest, LOGROTATE_ModuleFDOwnership)
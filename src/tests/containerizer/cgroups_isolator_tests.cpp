@@ -28,6 +28,7 @@
 #include "slave/containerizer/mesos/containerizer.hpp"
 
 #include "slave/containerizer/mesos/isolators/cgroups/constants.hpp"
+#include "slave/containerizer/mesos/isolators/cgroups/subsystems/cpuset.hpp"
 #include "slave/containerizer/mesos/isolators/cgroups/subsystems/net_cls.hpp"
 
 #include "tests/mesos.hpp"
@@ -49,6 +50,7 @@ using mesos::internal::slave::CPU_SHARES_PER_CPU_REVOCABLE;
 using mesos::internal::slave::DEFAULT_EXECUTOR_CPUS;
 
 using mesos::internal::slave::Containerizer;
+using mesos::internal::slave::CpuTopology;
 using mesos::internal::slave::Fetcher;
 using mesos::internal::slave::MesosContainerizer;
 using mesos::internal::slave::MesosContainerizerProcess;
@@ -67,6 +69,7 @@ using process::Queue;
 using process::http::OK;
 using process::http::Response;
 
+using std::map;
 using std::set;
 using std::string;
 using std::vector;
@@ -758,6 +761,76 @@ TEST_F(NetClsHandleManagerTest, SecondaryHandleRange)
 }
 
 
+// Tests the parsing and formatting of cpuset CPU lists.
+TEST(CpuTopologyTest, CpuList)
+{
+  EXPECT_SOME_EQ(
+      set<unsigned int>({0, 1, 2, 3, 8, 10, 11}),
+      mesos::internal::slave::parseCpuList("0-3,8,10-11\n"));
+
+  EXPECT_SOME_EQ(
+      set<unsigned int>(),
+      mesos::internal::slave::parseCpuList(""));
+
+  EXPECT_ERROR(mesos::internal::slave::parseCpuList("3-1"));
+  EXPECT_ERROR(mesos::internal::slave::parseCpuList("1-2-3"));
+  EXPECT_ERROR(mesos::internal::slave::parseCpuList("a"));
+
+  EXPECT_EQ(
+      "0-3,8,10-11",
+      mesos::internal::slave::stringifyCpuList({0, 1, 2, 3, 8, 10, 11}));
+}
+
+
+// Tests that the CPUs assigned exclusively are whole cores from a
+// single NUMA node whenever possible.
+TEST(CpuTopologyTest, Allocate)
+{
+  // Two NUMA nodes with two cores of two hyperthreads each, where
+  // the siblings of CPU `n` is CPU `n + 4`.
+  map<unsigned int, CpuTopology::Cpu> cpus;
+  for (unsigned int cpu = 0; cpu < 8; cpu++) {
+    CpuTopology::Cpu cpu_;
+    cpu_.node = (cpu % 4) / 2;
+    cpu_.socket = cpu_.node;
+    cpu_.core = cpu % 2;
+    cpus[cpu] = cpu_;
+  }
+
+  CpuTopology topology(cpus);
+
+  const set<unsigned int> all = {0, 1, 2, 3, 4, 5, 6, 7};
+
+  // A whole core.
+  EXPECT_SOME_EQ(set<unsigned int>({0, 4}), topology.allocate(all, 2));
+
+  // A whole NUMA node.
+  EXPECT_SOME_EQ(
+      set<unsigned int>({0, 1, 4, 5}),
+      topology.allocate(all, 4));
+
+  EXPECT_EQ(set<unsigned int>({0, 1}), topology.nodes({0, 6}));
+
+  // The node with the fewest available CPUs that can fit them.
+  EXPECT_SOME_EQ(
+      set<unsigned int>({2, 6}),
+      topology.allocate({0, 1, 2, 4, 5, 6}, 2));
+
+  // A single CPU is taken from a partially available core.
+  EXPECT_SOME_EQ(
+      set<unsigned int>({7}),
+      topology.allocate({0, 1, 2, 4, 5, 6, 7}, 1));
+
+  // The CPUs are spread over the nodes if none can fit them.
+  Option<set<unsigned int>> spread = topology.allocate(all, 6);
+  ASSERT_SOME(spread);
+  EXPECT_EQ(6u, spread->size());
+  EXPECT_EQ(set<unsigned int>({0, 1}), topology.nodes(spread.get()));
+
+  EXPECT_NONE(topology.allocate({0, 1}, 3));
+}
+
+
 // This tests the create, prepare, isolate and cleanup methods of the
 // 'CgroupNetClsIsolatorProcess'. The test first creates a
 // 'MesosContainerizer' with net_cls cgroup isolator enabled. The
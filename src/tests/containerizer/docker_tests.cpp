@@ -264,6 +264,79 @@ TEST_F_TEMP_DISABLED_ON_WINDOWS(DockerTest, ROOT_DOCKER_interface)
 }
 
 
+// This test verifies that inspecting a container through the Docker
+// Engine API yields the same container as 'docker inspect'.
+TEST_F_TEMP_DISABLED_ON_WINDOWS(DockerTest, ROOT_DOCKER_InspectEngineApi)
+{
+  const string containerName = NAME_PREFIX + "-test";
+  Resources resources = Resources::parse("cpus:1;mem:512").get();
+
+  Owned<Docker> docker = Docker::create(
+      tests::flags.docker,
+      tests::flags.docker_socket,
+      false).get();
+
+  Owned<Docker> engine = Docker::create(
+      tests::flags.docker,
+      tests::flags.docker_socket,
+      false,
+      None(),
+      true).get();
+
+  // The container does not exist yet.
+  AWAIT_FAILED(engine->inspect(containerName));
+
+  Try<string> directory = environment->mkdtemp();
+  ASSERT_SOME(directory);
+
+  ContainerInfo containerInfo;
+  containerInfo.set_type(ContainerInfo::DOCKER);
+
+  ContainerInfo::DockerInfo dockerInfo;
+  dockerInfo.set_image("alpine");
+  containerInfo.mutable_docker()->CopyFrom(dockerInfo);
+
+  CommandInfo commandInfo;
+  commandInfo.set_value("sleep 120");
+
+  Try<Docker::RunOptions> runOptions = Docker::RunOptions::create(
+      containerInfo,
+      commandInfo,
+      containerName,
+      directory.get(),
+      "/mnt/mesos/sandbox",
+      resources);
+
+  ASSERT_SOME(runOptions);
+
+  Future<Option<int>> status = docker->run(runOptions.get());
+
+  Future<Docker::Container> inspect =
+    engine->inspect(containerName, Seconds(1));
+
+  AWAIT_READY(inspect);
+
+  Future<Docker::Container> expected = docker->inspect(containerName);
+  AWAIT_READY(expected);
+
+  EXPECT_EQ(expected->id, inspect->id);
+  EXPECT_EQ("/" + containerName, inspect->name);
+  EXPECT_EQ(expected->pid, inspect->pid);
+  EXPECT_TRUE(inspect->started);
+
+  AWAIT_READY(docker->stop(containerName));
+  AWAIT_EXPECT_WEXITSTATUS_EQ(128 + SIGKILL, status);
+
+  inspect = engine->inspect(containerName);
+  AWAIT_READY(inspect);
+
+  EXPECT_EQ(expected->id, inspect->id);
+  EXPECT_NONE(inspect->pid);
+
+  AWAIT_READY(docker->rm(containerName));
+}
+
+
 // This tests our 'docker kill' wrapper.
 TEST_F_TEMP_DISABLED_ON_WINDOWS(DockerTest, ROOT_DOCKER_kill)
 {
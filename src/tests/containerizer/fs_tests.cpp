@@ -269,6 +269,49 @@ TEST_F(FsTest, ROOT_SharedMount)
 }
 
 
+// This test verifies that the cached mount table reflects the mounts
+// and unmounts done since it was last read.
+TEST_F(FsTest, ROOT_MountInfoTableCached)
+{
+  string directory = os::getcwd();
+
+  auto mounted = [&directory](const MountInfoTable& table) {
+    foreach (const MountInfoTable::Entry& entry, table.entries) {
+      if (entry.target == directory) {
+        return true;
+      }
+    }
+
+    return false;
+  };
+
+  Try<MountInfoTable> table = MountInfoTable::cached();
+  ASSERT_SOME(table);
+  EXPECT_FALSE(mounted(table.get()));
+
+  // Do a self bind mount of the temporary directory.
+  ASSERT_SOME(fs::mount(directory, directory, None(), MS_BIND, None()));
+
+  table = MountInfoTable::cached();
+  ASSERT_SOME(table);
+  EXPECT_TRUE(mounted(table.get()));
+
+  Try<MountInfoTable> read = MountInfoTable::read();
+  ASSERT_SOME(read);
+  EXPECT_EQ(read->entries.size(), table->entries.size());
+
+  table = MountInfoTable::cached(false);
+  ASSERT_SOME(table);
+  EXPECT_TRUE(mounted(table.get()));
+
+  EXPECT_SOME(fs::unmount(directory));
+
+  table = MountInfoTable::cached();
+  ASSERT_SOME(table);
+  EXPECT_FALSE(mounted(table.get()));
+}
+
+
 TEST_F(FsTest, ROOT_SlaveMount)
 {
   string directory = os::getcwd();
@@ -150,6 +150,75 @@ TEST_F(MesosContainerizerTest, Launch)
 }
 
 
+// This test verifies that the time spent in each phase of launching
+// a container, and in each isolator, is recorded in the metrics.
+TEST_F(MesosContainerizerTest, LaunchMetrics)
+{
+  slave::Flags flags = CreateSlaveFlags();
+  flags.launcher = "posix";
+  flags.isolation = "posix/cpu";
+
+  Fetcher fetcher(flags);
+
+  Try<MesosContainerizer*> create = MesosContainerizer::create(
+      flags,
+      true,
+      &fetcher);
+
+  ASSERT_SOME(create);
+
+  Owned<MesosContainerizer> containerizer(create.get());
+
+  SlaveState state;
+  state.id = SlaveID();
+
+  AWAIT_READY(containerizer->recover(state));
+
+  ContainerID containerId;
+  containerId.set_value(UUID::random().toString());
+
+  Try<string> directory = environment->mkdtemp();
+  ASSERT_SOME(directory);
+
+  Future<Containerizer::LaunchResult> launch = containerizer->launch(
+      containerId,
+      createContainerConfig(
+          None(),
+          createExecutorInfo("executor", "exit 0", "cpus:1"),
+          directory.get()),
+      map<string, string>(),
+      None());
+
+  AWAIT_ASSERT_EQ(Containerizer::LaunchResult::SUCCESS, launch);
+
+  JSON::Object metrics = Metrics();
+
+  EXPECT_EQ(1u, metrics.values.count("containerizer/mesos/launch/prepare_ms"));
+  EXPECT_EQ(1u, metrics.values.count("containerizer/mesos/launch/fork_ms"));
+  EXPECT_EQ(1u, metrics.values.count("containerizer/mesos/launch/isolate_ms"));
+  EXPECT_EQ(1u, metrics.values.count("containerizer/mesos/launch/fetch_ms"));
+
+  EXPECT_EQ(
+      1u,
+      metrics.values.count(
+          "containerizer/mesos/isolators/posix/cpu/prepare_ms"));
+
+  EXPECT_EQ(
+      1u,
+      metrics.values.count(
+          "containerizer/mesos/isolators/posix/cpu/isolate_ms"));
+
+  // No image was provisioned.
+  EXPECT_EQ(
+      0u, metrics.values.count("containerizer/mesos/launch/provision_ms"));
+
+  Future<Option<ContainerTermination>> wait = containerizer->wait(containerId);
+
+  AWAIT_READY(wait);
+  ASSERT_SOME(wait.get());
+}
+
+
 TEST_F(MesosContainerizerTest, StandaloneLaunch)
 {
   slave::Flags flags = CreateSlaveFlags();
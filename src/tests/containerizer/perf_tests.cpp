@@ -55,6 +55,17 @@ TEST_F(PerfTest, ROOT_PERF_Events)
 }
 
 
+TEST_F(PerfTest, CounterEvents)
+{
+  // Events with alternate names, and hardware cache events.
+  EXPECT_NONE(perf::Counters::validate(
+      {"cycles", "cpu-cycles", "task-clock", "cs", "LLC-load-misses"}));
+
+  // Raw events cannot be counted in process.
+  EXPECT_SOME(perf::Counters::validate({"cycles", "r003c"}));
+}
+
+
 TEST_F(PerfTest, ROOT_PERF_Sample)
 {
   // Sampling an empty set of cgroups should be a no-op.
@@ -187,6 +187,51 @@ static void cleanup(const string& eth0, const string& lo)
 }
 
 
+// This test verifies that the ephemeral ports allocator hands out the
+// lowest aligned free port range, also once the free ports have been
+// fragmented by recovered and deallocated port ranges.
+TEST(EphemeralPortsAllocatorTest, Allocate)
+{
+  IntervalSet<uint16_t> total;
+  total += (Bound<uint16_t>::closed(1000), Bound<uint16_t>::open(1100));
+
+  EphemeralPortsAllocator allocator(total, 16);
+
+  // The first aligned range is [1008, 1024).
+  Try<Interval<uint16_t>> ports1 = allocator.allocate();
+  ASSERT_SOME(ports1);
+  EXPECT_EQ(1008u, ports1->lower());
+  EXPECT_EQ(1024u, ports1->upper());
+
+  // Recover a range which is not aligned, this makes both the
+  // [1024, 1040) and [1040, 1056) ranges unavailable.
+  allocator.allocate(
+      (Bound<uint16_t>::closed(1030), Bound<uint16_t>::open(1050)));
+
+  Try<Interval<uint16_t>> ports2 = allocator.allocate();
+  ASSERT_SOME(ports2);
+  EXPECT_EQ(1056u, ports2->lower());
+
+  Try<Interval<uint16_t>> ports3 = allocator.allocate();
+  ASSERT_SOME(ports3);
+  EXPECT_EQ(1072u, ports3->lower());
+
+  // [1088, 1104) exceeds the managed ports.
+  EXPECT_ERROR(allocator.allocate());
+
+  allocator.deallocate(ports1.get());
+
+  Try<Interval<uint16_t>> ports4 = allocator.allocate();
+  ASSERT_SOME(ports4);
+  EXPECT_EQ(ports1.get(), ports4.get());
+
+  EXPECT_TRUE(allocator.isManaged(
+      (Bound<uint16_t>::closed(1000), Bound<uint16_t>::open(1100))));
+  EXPECT_FALSE(allocator.isManaged(
+      (Bound<uint16_t>::closed(1000), Bound<uint16_t>::open(1101))));
+}
+
+
 class PortMappingIsolatorTest : public TemporaryDirectoryTest
 {
 public:
@@ -23,6 +23,7 @@
 #include <stout/path.hpp>
 #include <stout/stringify.hpp>
 
+#include <process/clock.hpp>
 #include <process/future.hpp>
 #include <process/gmock.hpp>
 #include <process/owned.hpp>
@@ -58,6 +59,7 @@ namespace spec = ::docker::spec;
 using std::string;
 using std::vector;
 
+using process::Clock;
 using process::Future;
 using process::Owned;
 using process::PID;
@@ -274,6 +276,53 @@ TEST_F(ProvisionerDockerLocalStoreTest, MissingLayer)
 }
 
 
+// This test verifies that image garbage collection retains the images
+// used within the configured retention period.
+TEST_F(ProvisionerDockerLocalStoreTest, PruneRetainsRecentlyUsedImage)
+{
+  ImageGcConfig config;
+  config.set_image_disk_headroom(0.1);
+  config.mutable_image_disk_watch_interval()->set_nanoseconds(
+      Minutes(1).ns());
+  config.mutable_image_retention_period()->set_nanoseconds(Hours(1).ns());
+
+  slave::Flags flags;
+  flags.docker_registry = path::join(os::getcwd(), "images");
+  flags.docker_store_dir = path::join(os::getcwd(), "store");
+  flags.image_provisioner_backend = COPY_BACKEND;
+  flags.image_gc_config = config;
+
+  Try<Owned<slave::Store>> store = Store::create(flags);
+  ASSERT_SOME(store);
+
+  Image image;
+  image.set_type(Image::DOCKER);
+  image.mutable_docker()->set_name("abc");
+
+  Future<slave::ImageInfo> imageInfo = store.get()->get(
+      image, flags.image_provisioner_backend.get());
+
+  AWAIT_READY(imageInfo);
+
+  Clock::pause();
+
+  const string layerPath =
+    paths::getImageLayerPath(flags.docker_store_dir, "456");
+
+  AWAIT_READY(store.get()->prune({}, {}));
+  EXPECT_TRUE(os::exists(layerPath));
+
+  // Once the image has not been used for longer than the retention
+  // period, its layers should get garbage collected.
+  Clock::advance(Hours(1));
+
+  AWAIT_READY(store.get()->prune({}, {}));
+  EXPECT_FALSE(os::exists(layerPath));
+
+  Clock::resume();
+}
+
+
 class MockPuller : public Puller
 {
 public:
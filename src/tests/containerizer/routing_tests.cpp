@@ -1337,6 +1337,72 @@ TEST_F(RoutingVethTest, ROOT_IPFilterRemove)
 }
 
 
+// Tests creating and removing IP filters in batches, including the
+// generation of unused u32 handles for the filters of a batch which
+// share a priority (see MESOS-1617).
+TEST_F(RoutingVethTest, ROOT_IPFilterBatch)
+{
+  ASSERT_SOME(link::veth::create(TEST_VETH_LINK, TEST_PEER_LINK, None()));
+
+  EXPECT_SOME_TRUE(link::exists(TEST_VETH_LINK));
+  EXPECT_SOME_TRUE(link::exists(TEST_PEER_LINK));
+
+  ASSERT_SOME_TRUE(ingress::create(TEST_VETH_LINK));
+
+  vector<ip::Classifier> classifiers;
+  vector<filter::Filter<ip::Classifier>> filters;
+
+  for (uint16_t port = 1024; port < 1024 + 100; port++) {
+    Try<ip::PortRange> sourcePorts = ip::PortRange::fromBeginEnd(port, port);
+    ASSERT_SOME(sourcePorts);
+
+    ip::Classifier classifier(None(), None(), sourcePorts.get(), None());
+
+    classifiers.push_back(classifier);
+    filters.push_back(filter::Filter<ip::Classifier>(
+        ingress::HANDLE,
+        classifier,
+        Priority(2, 1),
+        None(),
+        None(),
+        action::Redirect(TEST_PEER_LINK)));
+  }
+
+  // Duplicates of existing filters should not be created.
+  filters.push_back(filters.front());
+
+  Try<vector<bool>> created = ip::create(TEST_VETH_LINK, filters);
+  ASSERT_SOME(created);
+  ASSERT_EQ(filters.size(), created->size());
+  EXPECT_EQ(vector<bool>(classifiers.size(), true),
+            vector<bool>(created->begin(), created->end() - 1));
+  EXPECT_FALSE(created->back());
+
+  Result<vector<ip::Classifier>> existing =
+    ip::classifiers(TEST_VETH_LINK, ingress::HANDLE);
+
+  ASSERT_SOME(existing);
+  EXPECT_EQ(classifiers.size(), existing->size());
+
+  // Removing a filter which does not exist should not fail the batch.
+  classifiers.push_back(ip::Classifier(None(), None(), None(), None()));
+
+  Try<vector<bool>> removed =
+    ip::remove(TEST_VETH_LINK, ingress::HANDLE, classifiers);
+
+  ASSERT_SOME(removed);
+  ASSERT_EQ(classifiers.size(), removed->size());
+  EXPECT_EQ(vector<bool>(classifiers.size() - 1, true),
+            vector<bool>(removed->begin(), removed->end() - 1));
+  EXPECT_FALSE(removed->back());
+
+  existing = ip::classifiers(TEST_VETH_LINK, ingress::HANDLE);
+
+  ASSERT_SOME(existing);
+  EXPECT_TRUE(existing->empty());
+}
+
+
 // Test the workaround introduced for MESOS-1617.
 TEST_F(RoutingVethTest, ROOT_HandleGeneration)
 {
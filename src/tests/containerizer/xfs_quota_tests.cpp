@@ -174,6 +174,9 @@ public:
     flags.work_dir = mountPoint.get();
     flags.isolation = "disk/xfs";
     flags.enforce_container_disk_quota = true;
+
+    // Do not reuse the reported project quotas across usage checks.
+    flags.container_disk_watch_interval = Milliseconds(1);
     return flags;
   }
 
@@ -305,6 +308,43 @@ TEST_F(ROOT_XFS_QuotaTest, QuotaLimit)
 }
 
 
+// Verify that the quotas of all the projects are reported at once.
+TEST_F(ROOT_XFS_QuotaTest, QuotaReport)
+{
+  prid_t projectA = 66;
+  prid_t projectB = 77;
+  string rootA = "projectA";
+  string rootB = "projectB";
+  Bytes limit = Megabytes(11);
+  Bytes used = Megabytes(10);
+
+  ASSERT_SOME(os::mkdir(rootA));
+  ASSERT_SOME(os::mkdir(rootB));
+
+  EXPECT_SOME(setProjectQuota(rootA, projectA, limit));
+  EXPECT_SOME(setProjectQuota(rootB, projectB, limit));
+
+  EXPECT_SOME(setProjectId(rootA, projectA));
+  EXPECT_SOME(mkfile(path::join(rootA, "file"), used));
+
+  Try<hashmap<prid_t, QuotaInfo>> quotas = getProjectQuotas(rootA);
+  ASSERT_SOME(quotas);
+
+  EXPECT_SOME_EQ(makeQuotaInfo(limit, used), quotas->get(projectA));
+  EXPECT_SOME_EQ(makeQuotaInfo(limit, Bytes(0)), quotas->get(projectB));
+
+  EXPECT_SOME(clearProjectQuota(rootA, projectA));
+  EXPECT_SOME(clearProjectQuota(rootB, projectB));
+
+  quotas = getProjectQuotas(rootA);
+  ASSERT_SOME(quotas);
+
+  // Only the project which still uses storage is reported.
+  EXPECT_SOME_EQ(makeQuotaInfo(Bytes(0), used), quotas->get(projectA));
+  EXPECT_FALSE(quotas->contains(projectB));
+}
+
+
 TEST_F(ROOT_XFS_QuotaTest, ProjectIdErrors)
 {
   // Setting project IDs should not work for non-directories.
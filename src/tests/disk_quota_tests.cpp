@@ -14,6 +14,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <unistd.h>
+
 #include <string>
 #include <vector>
 
@@ -27,6 +29,7 @@
 #include <process/pid.hpp>
 
 #include <stout/fs.hpp>
+#include <stout/foreach.hpp>
 #include <stout/gtest.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
@@ -172,6 +175,53 @@ TEST_F(DiskUsageCollectorTest, ExcludeRelativePath)
 #endif
 
 
+#ifdef __linux__
+// This test verifies that walking the file tree in process reports
+// the same usage as 'du', including for hard links, symbolic links,
+// and excluded paths.
+TEST_F(DiskUsageCollectorTest, InProcess)
+{
+  const string dir = path::join(os::getcwd(), "dir");
+  const string excluded = path::join(dir, "excluded");
+
+  ASSERT_SOME(os::mkdir(excluded));
+
+  const string file1 = path::join(dir, "file1");
+  const string file2 = path::join(dir, "file2");
+
+  ASSERT_SOME(os::write(file1, string(Kilobytes(64).bytes(), 'x')));
+  ASSERT_SOME(os::write(file2, string(Kilobytes(3).bytes(), 'y')));
+
+  ASSERT_SOME(os::write(
+      path::join(excluded, "file"),
+      string(Kilobytes(128).bytes(), 'z')));
+
+  ASSERT_EQ(0, ::link(file1.c_str(), path::join(dir, "link").c_str()));
+  ASSERT_SOME(fs::symlink(excluded, path::join(dir, "symlink")));
+
+  DiskUsageCollector du(Milliseconds(1));
+  DiskUsageCollector walk(Milliseconds(1), true);
+
+  foreach (const vector<string>& excludes,
+           vector<vector<string>>({{}, {excluded}, {"file*"}})) {
+    Future<Bytes> expected = du.usage(dir, excludes);
+    Future<Bytes> usage = walk.usage(dir, excludes);
+
+    AWAIT_READY(expected);
+    AWAIT_READY(usage);
+
+    EXPECT_EQ(expected.get(), usage.get());
+  }
+
+  // The hard link is only counted once.
+  Future<Bytes> usage = walk.usage(dir, {excluded});
+  AWAIT_READY(usage);
+  EXPECT_GE(usage.get(), Kilobytes(67));
+  EXPECT_LT(usage.get(), Kilobytes(128));
+}
+#endif
+
+
 class DiskQuotaTest : public MesosTest {};
 
 
@@ -240,6 +240,50 @@ TEST_F(FilesTest, ReadTest)
 }
 
 
+// This test verifies that a read at the end of a file waits for data
+// to be appended to the file when asked to.
+TEST_F(FilesTest, ReadWaitTest)
+{
+  Files files;
+  process::UPID upid("files", process::address());
+
+  ASSERT_SOME(os::write("file", "body"));
+  AWAIT_EXPECT_READY(files.attach("file", "myname"));
+
+  Future<Response> response =
+    process::http::get(upid, "read", "path=myname&offset=0&wait=hello");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(BadRequest().status, response);
+
+  // The read should return once the deadline expires.
+  JSON::Object expected;
+  expected.values["offset"] = 4;
+  expected.values["data"] = "";
+
+  response =
+    process::http::get(upid, "read", "path=myname&offset=4&wait=10ms");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(stringify(expected), response);
+
+  // The read should return once data gets appended.
+  response =
+    process::http::get(upid, "read", "path=myname&offset=4&wait=1mins");
+
+  ASSERT_TRUE(response.isPending());
+
+  Try<int_fd> fd = os::open("file", O_WRONLY | O_APPEND | O_CLOEXEC);
+  ASSERT_SOME(fd);
+  ASSERT_SOME(os::write(fd.get(), "more"));
+  ASSERT_SOME(os::close(fd.get()));
+
+  expected.values["data"] = "more";
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(stringify(expected), response);
+}
+
+
 TEST_F_TEMP_DISABLED_ON_WINDOWS(FilesTest, ResolveTest)
 {
   Files files;
@@ -486,6 +530,62 @@ TEST_F(FilesTest, DownloadTest)
 }
 
 
+// This test verifies that a byte range of a file can be downloaded.
+TEST_F(FilesTest, DownloadRangeTest)
+{
+  Files files;
+  process::UPID upid("files", process::address());
+
+  ASSERT_SOME(os::write("file", "0123456789"));
+  AWAIT_EXPECT_READY(files.attach("file", "myname"));
+
+  process::http::Headers headers;
+  headers["Range"] = "bytes=2-5";
+
+  Future<Response> response =
+    process::http::get(upid, "download", "path=myname", headers);
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(
+      process::http::Status::string(process::http::Status::PARTIAL_CONTENT),
+      response);
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ("bytes 2-5/10", "Content-Range", response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("2345", response);
+
+  headers["Range"] = "bytes=7-";
+
+  response = process::http::get(upid, "download", "path=myname", headers);
+
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ("bytes 7-9/10", "Content-Range", response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("789", response);
+
+  headers["Range"] = "bytes=-2";
+
+  response = process::http::get(upid, "download", "path=myname", headers);
+
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ("bytes 8-9/10", "Content-Range", response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("89", response);
+
+  // Ranges beyond the end of the file cannot be satisfied.
+  headers["Range"] = "bytes=10-";
+
+  response = process::http::get(upid, "download", "path=myname", headers);
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(
+      process::http::Status::string(
+          process::http::Status::REQUESTED_RANGE_NOT_SATISFIABLE),
+      response);
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ("bytes */10", "Content-Range", response);
+
+  // Multiple ranges are not supported, so the whole file is returned.
+  headers["Range"] = "bytes=0-1,4-5";
+
+  response = process::http::get(upid, "download", "path=myname", headers);
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("0123456789", response);
+}
+
+
 // Tests that the '/files/debug' endpoint works as expected.
 TEST_F(FilesTest, DebugTest)
 {
@@ -280,6 +280,49 @@ TEST_F(GarbageCollectorTest, Prune)
 }
 
 
+// This test verifies that paths are moved into the trash directory
+// of the work directory, which then gets emptied.
+TEST_F(GarbageCollectorTest, Trash)
+{
+  const string trashDir = slave::paths::getGcTrashDir(os::getcwd());
+
+  // Leave some trash behind, like an agent restarted while emptying
+  // the trash would.
+  ASSERT_SOME(os::mkdir(path::join(trashDir, "leftover")));
+
+  Clock::pause();
+
+  GarbageCollector gc(os::getcwd());
+
+  const string dir = path::join(os::getcwd(), "dir");
+
+  ASSERT_SOME(os::mkdir(dir));
+  ASSERT_SOME(os::touch(path::join(dir, "file")));
+
+  Future<Nothing> scheduleDispatch =
+    FUTURE_DISPATCH(_, &GarbageCollectorProcess::schedule);
+
+  Future<Nothing> schedule = gc.schedule(Seconds(10), dir);
+
+  AWAIT_READY(scheduleDispatch);
+  Clock::settle();
+
+  Clock::advance(Seconds(10));
+
+  AWAIT_READY(schedule);
+  EXPECT_FALSE(os::exists(dir));
+
+  // The trash gets emptied in the background.
+  Clock::settle();
+
+  Try<list<string>> trash = os::ls(trashDir);
+  ASSERT_SOME(trash);
+  EXPECT_TRUE(trash->empty());
+
+  Clock::resume();
+}
+
+
 class GarbageCollectorIntegrationTest : public MesosTest {};
 
 
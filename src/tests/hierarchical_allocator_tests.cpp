@@ -180,7 +180,12 @@ protected:
         flags.allocation_interval,
         offerCallback.get(),
         inverseOfferCallback.get(),
-        flags.fair_sharing_excluded_resource_names);
+        flags.fair_sharing_excluded_resource_names,
+        flags.filter_gpu_resources,
+        flags.domain,
+        flags.allocation_shards,
+        flags.allocation_sweep_interval,
+        flags.max_allocation_interval);
   }
 
   SlaveInfo createSlaveInfo(const Resources& resources)
@@ -1211,6 +1216,216 @@ TEST_F(HierarchicalAllocatorTest, CoarseGrained)
 }
 
 
+// This test ensures that with an allocation sweep interval, batch
+// allocations allocate the agents whose resources changed, and that
+// changes affecting all agents make the next batch allocation sweep.
+TEST_F(HierarchicalAllocatorTest, AllocationSweepInterval)
+{
+  Clock::pause();
+
+  master::Flags flags_;
+  flags_.allocation_sweep_interval = Minutes(10);
+
+  initialize(flags_);
+
+  // The first batch allocation sweeps all (no) agents.
+  Clock::advance(flags_.allocation_interval);
+  Clock::settle();
+
+  FrameworkInfo framework = createFrameworkInfo({"role1"});
+  allocator->addFramework(framework.id(), framework, {}, true, {});
+
+  SlaveInfo agent = createSlaveInfo("cpus:1;mem:512;disk:0");
+  allocator->addSlave(
+      agent.id(),
+      agent,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent.resources(),
+      {});
+
+  Allocation expected = Allocation(
+      framework.id(),
+      {{"role1", {{agent.id(), agent.resources()}}}});
+
+  AWAIT_EXPECT_EQ(expected, allocations.get());
+
+  // Declining the offer changes the available resources of the agent,
+  // so they are offered by the next batch allocation.
+  allocator->recoverResources(
+      framework.id(),
+      agent.id(),
+      allocatedResources(agent.resources(), "role1"),
+      None());
+
+  Clock::advance(flags_.allocation_interval);
+
+  AWAIT_EXPECT_EQ(expected, allocations.get());
+
+  // Exclude the agent by the whitelist, which filters the resources
+  // recovered next.
+  allocator->updateWhitelist(hashset<string>());
+
+  allocator->recoverResources(
+      framework.id(),
+      agent.id(),
+      allocatedResources(agent.resources(), "role1"),
+      None());
+
+  Clock::advance(flags_.allocation_interval);
+  Clock::settle();
+
+  Future<Allocation> allocation = allocations.get();
+  EXPECT_TRUE(allocation.isPending());
+
+  // The agent did not change again, but removing the whitelist makes
+  // the next batch allocation sweep all agents.
+  allocator->updateWhitelist(None());
+
+  Clock::advance(flags_.allocation_interval);
+
+  AWAIT_EXPECT_EQ(expected, allocation);
+}
+
+
+// This test ensures that with a maximum allocation interval, the
+// interval between batch allocations is lengthened while no agent
+// changes, and reset once an agent changed.
+TEST_F(HierarchicalAllocatorTest, AdaptiveAllocationInterval)
+{
+  Clock::pause();
+
+  master::Flags flags_;
+  flags_.max_allocation_interval = flags_.allocation_interval * 4;
+
+  initialize(flags_);
+  Clock::settle();
+
+  JSON::Object metrics = Metrics();
+
+  const string interval = "allocator/mesos/allocation_interval_ms";
+  const string idle = "allocator/mesos/allocation_interval/idle";
+
+  EXPECT_EQ(flags_.allocation_interval.ms(), metrics.values[interval]);
+
+  // Nothing changes, so the interval doubles after every batch
+  // allocation until it reaches the maximum.
+  Clock::advance(flags_.allocation_interval);
+  Clock::settle();
+
+  metrics = Metrics();
+  EXPECT_EQ((flags_.allocation_interval * 2).ms(), metrics.values[interval]);
+  EXPECT_EQ(1, metrics.values[idle]);
+
+  Clock::advance(flags_.allocation_interval * 2);
+  Clock::settle();
+
+  Clock::advance(flags_.allocation_interval * 4);
+  Clock::settle();
+
+  metrics = Metrics();
+  EXPECT_EQ(flags_.max_allocation_interval->ms(), metrics.values[interval]);
+  EXPECT_EQ(3, metrics.values[idle]);
+
+  FrameworkInfo framework = createFrameworkInfo({"role1"});
+  allocator->addFramework(framework.id(), framework, {}, true, {});
+
+  SlaveInfo agent = createSlaveInfo("cpus:1;mem:512;disk:0");
+  allocator->addSlave(
+      agent.id(),
+      agent,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent.resources(),
+      {});
+
+  Allocation expected = Allocation(
+      framework.id(),
+      {{"role1", {{agent.id(), agent.resources()}}}});
+
+  AWAIT_EXPECT_EQ(expected, allocations.get());
+
+  // Declining the offer changes the agent, so the next batch
+  // allocation offers its resources and resets the interval.
+  allocator->recoverResources(
+      framework.id(),
+      agent.id(),
+      allocatedResources(agent.resources(), "role1"),
+      None());
+
+  Clock::advance(flags_.max_allocation_interval.get());
+
+  AWAIT_EXPECT_EQ(expected, allocations.get());
+
+  Clock::settle();
+
+  metrics = Metrics();
+  EXPECT_EQ(flags_.allocation_interval.ms(), metrics.values[interval]);
+}
+
+
+// This test ensures that when allocation runs are sharded, the agents
+// are partitioned across the shards and offers are sent out for each
+// shard separately.
+TEST_F(HierarchicalAllocatorTest, AllocationShards)
+{
+  // Pausing the clock ensures that the batch allocation does not
+  // influence this test.
+  Clock::pause();
+
+  master::Flags flags_;
+  flags_.allocation_shards = 2;
+
+  initialize(flags_);
+
+  hashset<SlaveID> agents;
+
+  for (int i = 0; i < 4; i++) {
+    SlaveInfo agent = createSlaveInfo("cpus:1;mem:512;disk:0");
+    allocator->addSlave(
+        agent.id(),
+        agent,
+        AGENT_CAPABILITIES(),
+        None(),
+        agent.resources(),
+        {});
+
+    agents.insert(agent.id());
+  }
+
+  Clock::settle();
+
+  // Adding the framework triggers an allocation run for all agents,
+  // which is split into two shards of two agents each.
+  FrameworkInfo framework = createFrameworkInfo({"role1"});
+  allocator->addFramework(framework.id(), framework, {}, true, {});
+
+  hashset<SlaveID> offered;
+
+  for (int i = 0; i < 2; i++) {
+    Future<Allocation> allocation = allocations.get();
+    AWAIT_READY(allocation);
+
+    EXPECT_EQ(framework.id(), allocation->frameworkId);
+    ASSERT_TRUE(allocation->resources.contains("role1"));
+    EXPECT_EQ(2u, allocation->resources.at("role1").size());
+
+    foreachkey (const SlaveID& slaveId, allocation->resources.at("role1")) {
+      offered.insert(slaveId);
+    }
+  }
+
+  EXPECT_EQ(agents, offered);
+
+  JSON::Object metrics = Metrics();
+
+  EXPECT_EQ(1u, metrics.values.count(
+      "allocator/mesos/shards/0/allocation_run_ms"));
+  EXPECT_EQ(1u, metrics.values.count(
+      "allocator/mesos/shards/1/allocation_run_ms"));
+}
+
+
 // This test ensures that frameworks that have the same share get an
 // equal number of allocations over time (rather than the same
 // framework getting all the allocations because its name is
@@ -4560,6 +4775,152 @@ TEST_F(HierarchicalAllocatorTest, ReviveOffers)
 }
 
 
+// This test checks that offer filters expire in the order of their
+// timeouts rather than in the order they were created.
+TEST_F(HierarchicalAllocatorTest, OfferFilterExpiryOrder)
+{
+  // Pausing the clock is not necessary, but ensures that the test
+  // doesn't rely on the batch allocation in the allocator, which
+  // would slow down the test.
+  Clock::pause();
+
+  initialize();
+
+  FrameworkInfo framework = createFrameworkInfo({"role1"});
+  allocator->addFramework(framework.id(), framework, {}, true, {});
+
+  SlaveInfo agent1 = createSlaveInfo("cpus:1;mem:512;disk:0");
+  allocator->addSlave(
+      agent1.id(),
+      agent1,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent1.resources(),
+      {});
+
+  Allocation expected1 = Allocation(
+      framework.id(),
+      {{"role1", {{agent1.id(), agent1.resources()}}}});
+
+  AWAIT_EXPECT_EQ(expected1, allocations.get());
+
+  Filters filter100s;
+  filter100s.set_refuse_seconds(100.);
+  allocator->recoverResources(
+      framework.id(),
+      agent1.id(),
+      allocatedResources(agent1.resources(), "role1"),
+      filter100s);
+
+  SlaveInfo agent2 = createSlaveInfo("cpus:1;mem:512;disk:0");
+  allocator->addSlave(
+      agent2.id(),
+      agent2,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent2.resources(),
+      {});
+
+  Allocation expected2 = Allocation(
+      framework.id(),
+      {{"role1", {{agent2.id(), agent2.resources()}}}});
+
+  AWAIT_EXPECT_EQ(expected2, allocations.get());
+
+  // The filter for `agent2` is created last but expires first.
+  Filters filter10s;
+  filter10s.set_refuse_seconds(10.);
+  allocator->recoverResources(
+      framework.id(),
+      agent2.id(),
+      allocatedResources(agent2.resources(), "role1"),
+      filter10s);
+
+  Clock::advance(Seconds(10));
+  Clock::settle();
+
+  // Advance the clock to trigger a batch allocation, only the
+  // resources of `agent2` are offered again.
+  Clock::advance(flags.allocation_interval);
+
+  AWAIT_EXPECT_EQ(expected2, allocations.get());
+
+  Future<Allocation> allocation = allocations.get();
+  EXPECT_TRUE(allocation.isPending());
+
+  Clock::advance(Seconds(90));
+  Clock::settle();
+
+  Clock::advance(flags.allocation_interval);
+
+  AWAIT_EXPECT_EQ(expected1, allocation);
+}
+
+
+// This test verifies that recovering the resources of multiple agents
+// at once installs a filter for each of the agents.
+TEST_F(HierarchicalAllocatorTest, BatchRecoverResources)
+{
+  // Pausing the clock is not necessary, but ensures that the test
+  // doesn't rely on the batch allocation in the allocator, which
+  // would slow down the test.
+  Clock::pause();
+
+  initialize();
+
+  SlaveInfo agent1 = createSlaveInfo("cpus:1;mem:512;disk:0");
+  allocator->addSlave(
+      agent1.id(),
+      agent1,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent1.resources(),
+      {});
+
+  SlaveInfo agent2 = createSlaveInfo("cpus:2;mem:1024;disk:0");
+  allocator->addSlave(
+      agent2.id(),
+      agent2,
+      AGENT_CAPABILITIES(),
+      None(),
+      agent2.resources(),
+      {});
+
+  FrameworkInfo framework = createFrameworkInfo({"role1"});
+  allocator->addFramework(framework.id(), framework, {}, true, {});
+
+  Allocation expected = Allocation(
+      framework.id(),
+      {{"role1", {{agent1.id(), agent1.resources()},
+                  {agent2.id(), agent2.resources()}}}});
+
+  AWAIT_EXPECT_EQ(expected, allocations.get());
+
+  Filters filter10s;
+  filter10s.set_refuse_seconds(10.);
+  allocator->batchRecoverResources(
+      framework.id(),
+      {{agent1.id(), allocatedResources(agent1.resources(), "role1")},
+       {agent2.id(), allocatedResources(agent2.resources(), "role1")}},
+      filter10s);
+
+  // Neither agent is offered in the next batch allocation.
+  Clock::advance(flags.allocation_interval);
+  Clock::settle();
+
+  Future<Allocation> allocation = allocations.get();
+  EXPECT_TRUE(allocation.isPending());
+
+  // Both agents are offered again once the filters expire.
+  Clock::advance(Seconds(10));
+  Clock::settle();
+
+  Clock::advance(flags.allocation_interval);
+
+  AWAIT_EXPECT_EQ(expected, allocation);
+}
+
+
 // This test checks that if a multi-role framework declines resources
 // for one role with a long filter, it will be offered filtered resources
 // again to another role with some suppress and revive logic.
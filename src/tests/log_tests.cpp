@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 
+#include <iostream>
 #include <list>
 #include <set>
 #include <string>
@@ -25,6 +26,7 @@
 #include <mesos/log/log.hpp>
 
 #include <process/clock.hpp>
+#include <process/collect.hpp>
 #include <process/future.hpp>
 #include <process/gmock.hpp>
 #include <process/gtest.hpp>
@@ -65,6 +67,8 @@ using namespace mesos::internal::log;
 
 using namespace process;
 
+using std::cout;
+using std::endl;
 using std::list;
 using std::set;
 using std::string;
@@ -73,6 +77,7 @@ using testing::_;
 using testing::Eq;
 using testing::Invoke;
 using testing::Return;
+using testing::WithParamInterface;
 
 using mesos::log::Log;
 
@@ -321,6 +326,53 @@ TYPED_TEST(LogStorageTest, TruncateWithManyHoles)
 }
 
 
+TYPED_TEST(LogStorageTest, ReadRange)
+{
+  TypeParam storage;
+
+  Try<Storage::State> state = storage.restore(os::getcwd() + "/.log");
+  ASSERT_SOME(state);
+
+  // Append the even positions from position 0 to position 18.
+  list<Action> actions;
+  for (uint64_t i = 0; i < 20; i += 2) {
+    Action action;
+    action.set_position(i);
+    action.set_promised(1);
+    action.set_performed(1);
+    action.set_type(Action::APPEND);
+    action.mutable_append()->set_bytes(stringify(i));
+
+    actions.push_back(action);
+  }
+
+  ASSERT_SOME(storage.persist(actions, true));
+
+  Try<list<Action>> read = storage.read(3, 11);
+  ASSERT_SOME(read);
+
+  // Only the positions with an action are returned.
+  ASSERT_EQ(4u, read->size());
+
+  uint64_t position = 4;
+  foreach (const Action& action, read.get()) {
+    EXPECT_EQ(position, action.position());
+    EXPECT_EQ(stringify(position), action.append().bytes());
+    position += 2;
+  }
+
+  read = storage.read(19, 100);
+  ASSERT_SOME(read);
+  EXPECT_TRUE(read->empty());
+
+  // The read stops as soon as the limit is reached.
+  read = storage.read(0, 18, Bytes(1));
+  ASSERT_SOME(read);
+  ASSERT_EQ(1u, read->size());
+  EXPECT_EQ(0u, read->front().position());
+}
+
+
 class ReplicaTest : public TemporaryDirectoryTest
 {
 protected:
@@ -440,6 +492,63 @@ TEST_F(ReplicaTest, Append)
 }
 
 
+// Tests that a replica that batches its writes persists all of the
+// writes of concurrent requests before accepting them.
+TEST_F(ReplicaTest, BatchedWrites)
+{
+  const string path = os::getcwd() + "/.log";
+  initializer.flags.path = path;
+  ASSERT_SOME(initializer.execute());
+
+  const uint64_t proposal = 1;
+
+  // See the 'Restore' test below for why we use scope levels here.
+  {
+    Replica replica1(path, true);
+
+    PromiseRequest request;
+    request.set_proposal(proposal);
+
+    Future<PromiseResponse> response =
+      protocol::promise(replica1.pid(), request);
+
+    AWAIT_READY(response);
+    EXPECT_EQ(PromiseResponse::ACCEPT, response->type());
+
+    list<Future<WriteResponse>> responses;
+    for (uint64_t position = 1; position <= 10; position++) {
+      WriteRequest request;
+      request.set_proposal(proposal);
+      request.set_position(position);
+      request.set_type(Action::APPEND);
+      request.mutable_append()->set_bytes(stringify(position));
+
+      responses.push_back(protocol::write(replica1.pid(), request));
+    }
+
+    uint64_t position = 1;
+    foreach (const Future<WriteResponse>& response, responses) {
+      AWAIT_READY(response);
+      EXPECT_EQ(WriteResponse::ACCEPT, response->type());
+      EXPECT_EQ(position++, response->position());
+    }
+  }
+
+  Replica replica2(path);
+
+  Future<list<Action>> actions = replica2.read(1, 10);
+
+  AWAIT_READY(actions);
+  ASSERT_EQ(10u, actions->size());
+
+  foreach (const Action& action, actions.get()) {
+    ASSERT_TRUE(action.has_type());
+    ASSERT_EQ(Action::APPEND, action.type());
+    EXPECT_EQ(stringify(action.position()), action.append().bytes());
+  }
+}
+
+
 TEST_F(ReplicaTest, Restore)
 {
   const string path = os::getcwd() + "/.log";
@@ -1205,6 +1314,60 @@ TEST_F(CoordinatorTest, MultipleAppends)
 }
 
 
+// Tests that appends issued without waiting for the previous ones to
+// complete are assigned consecutive positions in the order in which
+// they were issued.
+TEST_F(CoordinatorTest, PipelinedAppends)
+{
+  const string path1 = os::getcwd() + "/.log1";
+  initializer.flags.path = path1;
+  ASSERT_SOME(initializer.execute());
+
+  const string path2 = os::getcwd() + "/.log2";
+  initializer.flags.path = path2;
+  ASSERT_SOME(initializer.execute());
+
+  Shared<Replica> replica1(new Replica(path1));
+  Shared<Replica> replica2(new Replica(path2));
+
+  set<UPID> pids;
+  pids.insert(replica1->pid());
+  pids.insert(replica2->pid());
+
+  Shared<Network> network(new Network(pids));
+
+  Coordinator coord(2, replica1, network);
+
+  {
+    Future<Option<uint64_t>> electing = coord.elect();
+    AWAIT_READY(electing);
+    EXPECT_SOME_EQ(0u, electing.get());
+  }
+
+  list<Future<Option<uint64_t>>> appendings;
+  for (uint64_t position = 1; position <= 10; position++) {
+    appendings.push_back(coord.append(stringify(position)));
+  }
+
+  uint64_t position = 1;
+  foreach (const Future<Option<uint64_t>>& appending, appendings) {
+    AWAIT_READY(appending);
+    EXPECT_SOME_EQ(position++, appending.get());
+  }
+
+  {
+    Future<list<Action>> actions = replica1->read(1, 10);
+    AWAIT_READY(actions);
+    EXPECT_EQ(10u, actions->size());
+    foreach (const Action& action, actions.get()) {
+      ASSERT_TRUE(action.has_type());
+      ASSERT_EQ(Action::APPEND, action.type());
+      EXPECT_EQ(stringify(action.position()), action.append().bytes());
+    }
+  }
+}
+
+
 TEST_F(CoordinatorTest, MultipleAppendsNotLearnedFill)
 {
   const string path1 = os::getcwd() + "/.log1";
@@ -1818,11 +1981,19 @@ TEST_F(RecoverTest, CatchupRetry)
   // promise phase even if replica1 reemerges later.
   DROP_PROTOBUF(PromiseRequest(), _, Eq(replica1->pid()));
 
+  // Prevent the learned actions from being transferred so that the
+  // positions have to be filled.
+  DROP_PROTOBUFS(TransferRequest(), _, _);
+
   Future<Nothing> catching =
     catchup(2, replica3, network2, None(), positions, Seconds(10));
 
   Clock::pause();
 
+  // Wait for the transfer to time out.
+  Clock::settle();
+  Clock::advance(Seconds(10));
+
   // Wait for the retry timer in 'catchup' to be setup.
   Clock::settle();
 
@@ -1844,6 +2015,75 @@ TEST_F(RecoverTest, CatchupRetry)
 }
 
 
+// Tests that the catch-up process copies the actions that have been
+// learned by other replicas without running Paxos for them.
+TEST_F(RecoverTest, CatchupTransfer)
+{
+  const string path1 = os::getcwd() + "/.log1";
+  initializer.flags.path = path1;
+  ASSERT_SOME(initializer.execute());
+
+  const string path2 = os::getcwd() + "/.log2";
+  initializer.flags.path = path2;
+  ASSERT_SOME(initializer.execute());
+
+  const string path3 = os::getcwd() + "/.log3";
+
+  Shared<Replica> replica1(new Replica(path1));
+  Shared<Replica> replica2(new Replica(path2));
+
+  set<UPID> pids;
+  pids.insert(replica1->pid());
+  pids.insert(replica2->pid());
+
+  Shared<Network> network1(new Network(pids));
+
+  Coordinator coord(2, replica1, network1);
+
+  {
+    Future<Option<uint64_t>> electing = coord.elect();
+    AWAIT_READY(electing);
+    EXPECT_SOME_EQ(0u, electing.get());
+  }
+
+  IntervalSet<uint64_t> positions;
+
+  for (uint64_t position = 1; position <= 10; position++) {
+    Future<Option<uint64_t>> appending = coord.append(stringify(position));
+    AWAIT_READY(appending);
+    EXPECT_SOME_EQ(position, appending.get());
+    positions += position;
+  }
+
+  Shared<Replica> replica3(new Replica(path3));
+
+  pids.insert(replica3->pid());
+
+  Shared<Network> network2(new Network(pids));
+
+  // The catch-up process would get stuck if it tried to fill any of
+  // the positions since no promise can be obtained.
+  DROP_PROTOBUFS(PromiseRequest(), _, _);
+
+  Future<Nothing> catching =
+    catchup(2, replica3, network2, None(), positions, Seconds(10));
+
+  AWAIT_READY(catching);
+
+  Future<list<Action>> actions = replica3->read(1, 10);
+
+  AWAIT_READY(actions);
+  ASSERT_EQ(10u, actions->size());
+
+  foreach (const Action& action, actions.get()) {
+    EXPECT_TRUE(action.has_learned() && action.learned());
+    ASSERT_TRUE(action.has_type());
+    ASSERT_EQ(Action::APPEND, action.type());
+    EXPECT_EQ(stringify(action.position()), action.append().bytes());
+  }
+}
+
+
 TEST_F(RecoverTest, AutoInitialization)
 {
   const string path1 = os::getcwd() + "/.log1";
@@ -2108,6 +2348,80 @@ TEST_F(LogTest, Metrics)
 }
 
 
+class LogAppend_BENCHMARK_Test
+  : public TemporaryDirectoryTest,
+    public WithParamInterface<size_t>
+{
+protected:
+  // Used to change the status of a replicated log from `EMPTY` to `VOTING`.
+  tool::Initialize initializer;
+};
+
+
+// The log append benchmark is parameterized by the size of each
+// appended entry in bytes.
+INSTANTIATE_TEST_CASE_P(
+    EntrySize,
+    LogAppend_BENCHMARK_Test,
+    ::testing::Values(64U, 1024U, 16U * 1024U, 256U * 1024U));
+
+
+// Measures the append throughput of a log with two replicas, first
+// waiting for each append before issuing the next one, and then with
+// all appends in flight at once.
+TEST_P(LogAppend_BENCHMARK_Test, Throughput)
+{
+  const size_t appends = 1000;
+  const string data(GetParam(), 'x');
+
+  const string path1 = os::getcwd() + "/.log1";
+  initializer.flags.path = path1;
+  ASSERT_SOME(initializer.execute());
+
+  const string path2 = os::getcwd() + "/.log2";
+  initializer.flags.path = path2;
+  ASSERT_SOME(initializer.execute());
+
+  Replica replica1(path1);
+
+  set<UPID> pids;
+  pids.insert(replica1.pid());
+
+  Log log(2, path2, pids);
+
+  Log::Writer writer(&log);
+
+  Future<Option<Log::Position>> start = writer.start();
+
+  AWAIT_READY(start);
+  ASSERT_SOME(start.get());
+
+  Stopwatch watch;
+  watch.start();
+
+  for (size_t i = 0; i < appends; i++) {
+    Future<Option<Log::Position>> position = writer.append(data);
+    AWAIT_READY(position);
+    ASSERT_SOME(position.get());
+  }
+
+  cout << "Sequential appends of " << GetParam() << " bytes: "
+       << appends / watch.elapsed().secs() << " appends/sec" << endl;
+
+  watch.start();
+
+  list<Future<Option<Log::Position>>> positions;
+  for (size_t i = 0; i < appends; i++) {
+    positions.push_back(writer.append(data));
+  }
+
+  AWAIT_READY_FOR(collect(positions), Minutes(5));
+
+  cout << "Pipelined appends of " << GetParam() << " bytes: "
+       << appends / watch.elapsed().secs() << " appends/sec" << endl;
+}
+
+
 #ifdef MESOS_HAS_JAVA
 // TODO(jieyu): We copy the code from TemporaryDirectoryTest here
 // because we cannot inherit from two test fixtures. In this future,
@@ -14,11 +14,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
 #include <list>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include <mesos/resources.hpp>
+#include <mesos/scheduler.hpp>
 #include <mesos/version.hpp>
 
 #include <process/clock.hpp>
@@ -27,15 +31,28 @@
 #include <process/pid.hpp>
 #include <process/process.hpp>
 #include <process/protobuf.hpp>
+#include <process/time.hpp>
 
+#include <stout/bytes.hpp>
+#include <stout/duration.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/os.hpp>
 #include <stout/stopwatch.hpp>
+#include <stout/uuid.hpp>
+
+#include <stout/tests/benchmark.hpp>
 
 #include "common/protobuf_utils.hpp"
 
+#include "master/detector/standalone.hpp"
+
 #include "tests/mesos.hpp"
 
+using mesos::master::detector::StandaloneMasterDetector;
+
 using process::await;
 using process::Clock;
+using process::collect;
 using process::Failure;
 using process::Future;
 using process::Owned;
@@ -44,6 +61,7 @@ using process::ProcessBase;
 using process::Promise;
 using process::spawn;
 using process::terminate;
+using process::Time;
 using process::UPID;
 
 using std::cout;
@@ -53,6 +71,7 @@ using std::make_tuple;
 using std::string;
 using std::tie;
 using std::tuple;
+using std::vector;
 
 using testing::WithParamInterface;
 
@@ -248,6 +267,308 @@ private:
 };
 
 
+// A fake agent which registers with the master and "runs" the tasks
+// it gets by immediately sending a `TASK_RUNNING` and a `TASK_FINISHED`
+// status update for them, so that the master recovers their resources.
+class SimulatedSlaveProcess : public ProtobufProcess<SimulatedSlaveProcess>
+{
+public:
+  SimulatedSlaveProcess(const UPID& _masterPid, const string& hostname)
+    : ProcessBase(process::ID::generate("simulated-slave")),
+      masterPid(_masterPid)
+  {
+    SlaveID slaveId;
+    slaveId.set_value(hostname);
+
+    slaveInfo = createSlaveInfo(slaveId);
+    slaveInfo.clear_id();
+  }
+
+  void initialize() override
+  {
+    install<SlaveRegisteredMessage>(
+        &Self::registered,
+        &SlaveRegisteredMessage::slave_id);
+
+    install<SlaveReregisteredMessage>(&Self::reregistered);
+
+    install<PingSlaveMessage>(
+        &Self::ping,
+        &PingSlaveMessage::connected);
+
+    install<RunTaskMessage>(
+        &Self::runTask,
+        &RunTaskMessage::framework,
+        &RunTaskMessage::task);
+  }
+
+  Future<Nothing> register_()
+  {
+    RegisterSlaveMessage message;
+    *message.mutable_slave() = slaveInfo;
+    message.set_version(MESOS_VERSION);
+
+    send(masterPid, message);
+
+    return registration.future();
+  }
+
+  // Reregisters with a new master, e.g., after a failover.
+  Future<Nothing> reregister(const UPID& _masterPid)
+  {
+    masterPid = _masterPid;
+
+    reregistration.reset(new Promise<Nothing>());
+
+    ReregisterSlaveMessage message;
+    *message.mutable_slave() = slaveInfo;
+    message.set_version(MESOS_VERSION);
+
+    send(masterPid, message);
+
+    return reregistration->future();
+  }
+
+  SimulatedSlaveProcess(const SimulatedSlaveProcess& other) = delete;
+  SimulatedSlaveProcess& operator=(const SimulatedSlaveProcess& other) = delete;
+
+private:
+  void registered(const SlaveID& slaveId)
+  {
+    *slaveInfo.mutable_id() = slaveId;
+    registration.set(Nothing());
+  }
+
+  void reregistered(const SlaveReregisteredMessage&)
+  {
+    if (reregistration.get() != nullptr) {
+      reregistration->set(Nothing());
+    }
+  }
+
+  void ping(const UPID& from, bool)
+  {
+    send(from, PongSlaveMessage());
+  }
+
+  void runTask(
+      const UPID& from,
+      const FrameworkInfo& frameworkInfo,
+      const TaskInfo& task)
+  {
+    const vector<TaskState> states = {TASK_RUNNING, TASK_FINISHED};
+
+    foreach (const TaskState& state, states) {
+      StatusUpdateMessage message;
+      *message.mutable_update() = protobuf::createStatusUpdate(
+          frameworkInfo.id(),
+          slaveInfo.id(),
+          task.task_id(),
+          state,
+          TaskStatus::SOURCE_EXECUTOR,
+          id::UUID::random());
+      message.set_pid(self());
+
+      send(masterPid, message);
+    }
+  }
+
+  UPID masterPid;
+  SlaveInfo slaveInfo;
+
+  Promise<Nothing> registration;
+  Owned<Promise<Nothing>> reregistration;
+};
+
+
+class SimulatedSlave
+{
+public:
+  SimulatedSlave(const UPID& masterPid, const string& hostname)
+    : process(new SimulatedSlaveProcess(masterPid, hostname))
+  {
+    spawn(process.get());
+  }
+
+  ~SimulatedSlave()
+  {
+    terminate(process.get());
+    process::wait(process.get());
+  }
+
+  Future<Nothing> register_()
+  {
+    return dispatch(process.get(), &SimulatedSlaveProcess::register_);
+  }
+
+  Future<Nothing> reregister(const UPID& masterPid)
+  {
+    return dispatch(
+        process.get(), &SimulatedSlaveProcess::reregister, masterPid);
+  }
+
+private:
+  Owned<SimulatedSlaveProcess> process;
+};
+
+
+// A scheduler which launches a fixed number of tasks on each offer
+// while `launching` is set, and declines the offers it cannot use.
+//
+// NOTE: The counters are only updated from the thread of the driver,
+// so they must only be read once the driver has been stopped.
+class LoadScheduler : public Scheduler
+{
+public:
+  LoadScheduler(size_t _tasksPerOffer, const std::atomic_bool* _launching)
+    : tasksPerOffer(_tasksPerOffer),
+      launching(_launching),
+      offers(0),
+      launches(0),
+      declines(0),
+      finished(0) {}
+
+  void registered(
+      SchedulerDriver*,
+      const FrameworkID&,
+      const MasterInfo&) override
+  {
+    registration.set(Nothing());
+  }
+
+  void reregistered(SchedulerDriver*, const MasterInfo&) override
+  {
+    reregistration.set(Nothing());
+  }
+
+  void disconnected(SchedulerDriver*) override {}
+
+  void resourceOffers(
+      SchedulerDriver* driver,
+      const vector<Offer>& _offers) override
+  {
+    // Have the declined resources offered again right away.
+    Filters filters;
+    filters.set_refuse_seconds(0);
+
+    foreach (const Offer& offer, _offers) {
+      offers++;
+
+      vector<TaskInfo> tasks;
+      if (launching->load()) {
+        Resources remaining = offer.resources();
+        while (tasks.size() < tasksPerOffer) {
+          TaskInfo task = createTaskInfo(offer.slave_id());
+          if (!remaining.contains(task.resources())) {
+            break;
+          }
+
+          remaining -= task.resources();
+          tasks.push_back(task);
+        }
+      }
+
+      if (tasks.empty()) {
+        declines++;
+        driver->declineOffer(offer.id(), filters);
+        continue;
+      }
+
+      const Time now = Clock::now();
+      foreach (const TaskInfo& task, tasks) {
+        launched[task.task_id()] = now;
+      }
+
+      launches += tasks.size();
+      driver->launchTasks(offer.id(), tasks, filters);
+    }
+  }
+
+  void offerRescinded(SchedulerDriver*, const OfferID&) override {}
+
+  void statusUpdate(SchedulerDriver*, const TaskStatus& status) override
+  {
+    if (status.state() == TASK_RUNNING && launched.contains(status.task_id())) {
+      latencies.push_back(Clock::now() - launched.at(status.task_id()));
+      launched.erase(status.task_id());
+    } else if (status.state() == TASK_FINISHED) {
+      finished++;
+    }
+  }
+
+  void frameworkMessage(
+      SchedulerDriver*,
+      const ExecutorID&,
+      const SlaveID&,
+      const string&) override {}
+
+  void slaveLost(SchedulerDriver*, const SlaveID&) override {}
+
+  void executorLost(
+      SchedulerDriver*,
+      const ExecutorID&,
+      const SlaveID&,
+      int) override {}
+
+  void error(SchedulerDriver*, const string& message) override
+  {
+    LOG(ERROR) << "Load scheduler error: " << message;
+  }
+
+  const size_t tasksPerOffer;
+  const std::atomic_bool* launching;
+
+  Promise<Nothing> registration;
+  Promise<Nothing> reregistration;
+
+  size_t offers;
+  size_t launches;
+  size_t declines;
+  size_t finished;
+
+  // The time from launching a task to receiving its `TASK_RUNNING`
+  // status update.
+  vector<Duration> latencies;
+
+private:
+  hashmap<TaskID, Time> launched;
+};
+
+
+// Returns the given percentile of the durations.
+static Duration percentile(vector<Duration> durations, double percent)
+{
+  if (durations.empty()) {
+    return Duration::zero();
+  }
+
+  const size_t index = std::min(
+      durations.size() - 1,
+      static_cast<size_t>(durations.size() * percent / 100.0));
+
+  std::nth_element(
+      durations.begin(), durations.begin() + index, durations.end());
+
+  return durations[index];
+}
+
+
+// Returns the CPU time used by this process so far, and its current
+// resident set size.
+static tuple<Duration, Bytes> usage()
+{
+  Result<os::Process> process = os::process(::getpid());
+  if (!process.isSome()) {
+    return make_tuple(Duration::zero(), Bytes(0));
+  }
+
+  return make_tuple(
+      process->utime.getOrElse(Duration::zero()) +
+        process->stime.getOrElse(Duration::zero()),
+      process->rss.getOrElse(Bytes(0)));
+}
+
+
 class MasterFailover_BENCHMARK_Test
   : public MesosTest,
     public WithParamInterface<tuple<size_t, size_t, size_t, size_t, size_t>> {};
@@ -335,6 +656,197 @@ TEST_P(MasterFailover_BENCHMARK_Test, AgentReregistrationDelay)
        << completedFrameworksPerAgent * tasksPerCompletedFramework * agentCount
        << " completed tasks in "
        << watch.elapsed() << endl;
+
+  BenchmarkReport report;
+  report.parameter("agents", agentCount);
+  report.parameter("frameworks_per_agent", frameworksPerAgent);
+  report.parameter("tasks_per_framework", tasksPerFramework);
+  report.parameter("completed_frameworks_per_agent",
+                   completedFrameworksPerAgent);
+  report.parameter("tasks_per_completed_framework",
+                   tasksPerCompletedFramework);
+  report.sample("reregistration", watch.elapsed());
+  report.write();
+}
+
+
+class MasterLoad_BENCHMARK_Test
+  : public MesosTest,
+    public WithParamInterface<tuple<size_t, size_t, size_t>> {};
+
+
+// The value tuples are defined as:
+// - agentCount
+// - frameworkCount
+// - tasksPerOffer (0 to only decline the offers)
+INSTANTIATE_TEST_CASE_P(
+    AgentFrameworkTaskCount,
+    MasterLoad_BENCHMARK_Test,
+    ::testing::Values(
+        make_tuple(1000, 10, 0),
+        make_tuple(1000, 10, 10),
+        make_tuple(5000, 50, 10),
+        make_tuple(10000, 100, 20)));
+
+
+// This test drives the master with simulated agents and frameworks
+// launching and declining offers for a fixed period, and reports the
+// rates of the offers and launches, the launch latencies, the CPU and
+// memory usage, and the time for the agents and frameworks to
+// reregister after a master failover.
+//
+// NOTE: The master, the simulated agents and the scheduler drivers
+// share this process, so the CPU and memory usage are an upper bound
+// of the usage of the master.
+TEST_P(MasterLoad_BENCHMARK_Test, LaunchAndFailover)
+{
+  size_t agentCount;
+  size_t frameworkCount;
+  size_t tasksPerOffer;
+
+  tie(agentCount, frameworkCount, tasksPerOffer) = GetParam();
+
+  const Duration duration = Seconds(10);
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.authenticate_agents = false;
+  masterFlags.allocation_interval = Milliseconds(100);
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  list<SimulatedSlave> slaves;
+  list<Future<Nothing>> registered;
+
+  for (size_t i = 0; i < agentCount; i++) {
+    slaves.emplace_back(master.get()->pid, "agent" + stringify(i));
+    registered.push_back(slaves.back().register_());
+  }
+
+  AWAIT_READY_FOR(collect(registered), Minutes(5));
+
+  cout << "Registered " << agentCount << " agents" << endl;
+
+  std::atomic_bool launching(true);
+
+  StandaloneMasterDetector detector(master.get()->pid);
+
+  list<LoadScheduler> schedulers;
+  list<Owned<TestingMesosSchedulerDriver>> drivers;
+
+  Duration cpu;
+  Bytes rss;
+  tie(cpu, rss) = usage();
+
+  Stopwatch watch;
+  watch.start();
+
+  for (size_t i = 0; i < frameworkCount; i++) {
+    schedulers.emplace_back(tasksPerOffer, &launching);
+
+    drivers.emplace_back(
+        new TestingMesosSchedulerDriver(&schedulers.back(), &detector));
+
+    drivers.back()->start();
+  }
+
+  list<Future<Nothing>> frameworksRegistered;
+  foreach (LoadScheduler& scheduler, schedulers) {
+    frameworksRegistered.push_back(scheduler.registration.future());
+  }
+
+  AWAIT_READY_FOR(collect(frameworksRegistered), Minutes(5));
+
+  os::sleep(duration);
+
+  launching = false;
+
+  watch.stop();
+
+  Duration _cpu;
+  Bytes _rss;
+  tie(_cpu, _rss) = usage();
+
+  // Fail over to a new master, and measure the time for all agents and
+  // frameworks to reregister with it.
+  master->reset();
+  master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  Stopwatch failover;
+  failover.start();
+
+  detector.appoint(master.get()->pid);
+
+  list<Future<Nothing>> reregistered;
+  foreach (SimulatedSlave& slave, slaves) {
+    reregistered.push_back(slave.reregister(master.get()->pid));
+  }
+
+  foreach (LoadScheduler& scheduler, schedulers) {
+    reregistered.push_back(scheduler.reregistration.future());
+  }
+
+  AWAIT_READY_FOR(collect(reregistered), Minutes(5));
+
+  failover.stop();
+
+  foreach (const Owned<TestingMesosSchedulerDriver>& driver, drivers) {
+    driver->stop();
+    driver->join();
+  }
+
+  size_t offers = 0;
+  size_t launches = 0;
+  size_t declines = 0;
+  size_t finished = 0;
+  vector<Duration> latencies;
+
+  foreach (const LoadScheduler& scheduler, schedulers) {
+    offers += scheduler.offers;
+    launches += scheduler.launches;
+    declines += scheduler.declines;
+    finished += scheduler.finished;
+    latencies.insert(
+        latencies.end(),
+        scheduler.latencies.begin(),
+        scheduler.latencies.end());
+  }
+
+  const double secs = watch.elapsed().secs();
+
+  cout << "Received " << offers << " offers (" << offers / secs
+       << " offers/sec), declined " << declines << " offers and launched "
+       << launches << " tasks (" << launches / secs << " launches/sec), "
+       << finished << " of which finished, in " << watch.elapsed() << endl;
+
+  cout << "Launch latency: p50 " << percentile(latencies, 50)
+       << ", p90 " << percentile(latencies, 90)
+       << ", p99 " << percentile(latencies, 99)
+       << ", max " << percentile(latencies, 100) << endl;
+
+  cout << "Used " << (_cpu - cpu).secs() / secs << " CPUs, "
+       << "resident set size grew from " << rss << " to " << _rss << endl;
+
+  cout << "Reregistered " << agentCount << " agents and " << frameworkCount
+       << " frameworks after a master failover in " << failover.elapsed()
+       << endl;
+
+  BenchmarkReport report;
+  report.parameter("agents", agentCount);
+  report.parameter("frameworks", frameworkCount);
+  report.parameter("tasks_per_offer", tasksPerOffer);
+  report.sample("offers", offers / secs, "offers/s");
+  report.sample("launches", launches / secs, "launches/s");
+  report.sample("cpu", (_cpu - cpu).secs() / secs, "cpus");
+  report.sample("rss", static_cast<double>(_rss.bytes()), "bytes");
+  report.sample("failover", failover.elapsed());
+
+  foreach (const Duration& latency, latencies) {
+    report.sample("launch_latency", latency);
+  }
+
+  report.write();
 }
 
 } // namespace tests {
@@ -0,0 +1,141 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <mesos/mesos.hpp>
+#include <mesos/type_utils.hpp>
+
+#include <stout/foreach.hpp>
+#include <stout/gtest.hpp>
+#include <stout/stringify.hpp>
+
+#include "master/completed_tasks.hpp"
+
+using mesos::internal::master::CompletedTasks;
+
+using std::string;
+using std::vector;
+
+namespace mesos {
+namespace internal {
+namespace tests {
+
+static Task createTask(const string& id, TaskState state)
+{
+  Task task;
+  task.set_name("task-" + id);
+  task.mutable_task_id()->set_value(id);
+  task.mutable_framework_id()->set_value("framework");
+  task.mutable_slave_id()->set_value("agent-" + id);
+  task.set_state(state);
+
+  Label* label = task.mutable_labels()->add_labels();
+  label->set_key("key");
+  label->set_value("value");
+
+  foreach (TaskState state_, vector<TaskState>({TASK_RUNNING, state})) {
+    TaskStatus* status = task.add_statuses();
+    status->mutable_task_id()->CopyFrom(task.task_id());
+    status->mutable_slave_id()->CopyFrom(task.slave_id());
+    status->set_state(state_);
+    status->set_timestamp(1.0);
+  }
+
+  return task;
+}
+
+
+TEST(CompletedTasksTest, Inflate)
+{
+  CompletedTasks tasks(2);
+  EXPECT_TRUE(tasks.empty());
+
+  tasks.push_back(createTask("1", TASK_FINISHED));
+  tasks.push_back(createTask("2", TASK_FAILED));
+
+  ASSERT_EQ(2u, tasks.size());
+
+  vector<string> ids;
+
+  foreach (const CompletedTasks::Archived& archived, tasks) {
+    Task task = archived.inflate();
+
+    // The inflated task should be identical to the one archived.
+    Task expected = createTask(task.task_id().value(), task.state());
+    EXPECT_EQ(expected.SerializeAsString(), task.SerializeAsString());
+
+    EXPECT_EQ(expected.task_id(), archived.task_id());
+    EXPECT_EQ(expected.slave_id(), archived.slave_id());
+    EXPECT_EQ(expected.state(), archived.state());
+    EXPECT_SOME_EQ(1.0, archived.timestamp());
+
+    ids.push_back(task.task_id().value());
+  }
+
+  EXPECT_EQ(vector<string>({"1", "2"}), ids);
+}
+
+
+// Tasks without any status have no timestamp, and still get inflated
+// with their task ID.
+TEST(CompletedTasksTest, NoStatuses)
+{
+  CompletedTasks tasks(1);
+
+  Task task = createTask("1", TASK_KILLED);
+  task.clear_statuses();
+
+  const string expected = task.SerializeAsString();
+
+  tasks.push_back(std::move(task));
+
+  ASSERT_EQ(1u, tasks.size());
+
+  const CompletedTasks::Archived& archived = *tasks.begin();
+
+  EXPECT_NONE(archived.timestamp());
+  EXPECT_EQ("1", archived.task_id().value());
+  EXPECT_EQ(expected, archived.inflate().SerializeAsString());
+}
+
+
+TEST(CompletedTasksTest, Evict)
+{
+  CompletedTasks tasks(2);
+
+  for (int i = 0; i < 5; i++) {
+    tasks.push_back(createTask(stringify(i), TASK_FINISHED));
+  }
+
+  ASSERT_EQ(2u, tasks.size());
+
+  vector<string> ids;
+
+  foreach (const CompletedTasks::Archived& archived, tasks) {
+    ids.push_back(archived.inflate().task_id().value());
+  }
+
+  // Only the most recently archived tasks should be kept.
+  EXPECT_EQ(vector<string>({"3", "4"}), ids);
+}
+
+} // namespace tests {
+} // namespace internal {
+} // namespace mesos {
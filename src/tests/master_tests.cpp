@@ -16,6 +16,7 @@
 
 #include <unistd.h>
 
+#include <list>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,6 +28,8 @@
 
 #include <mesos/allocator/allocator.hpp>
 
+#include <mesos/master/master.hpp>
+
 #include <mesos/scheduler/scheduler.hpp>
 
 #include <process/clock.hpp>
@@ -39,10 +42,12 @@
 #include <process/metrics/counter.hpp>
 #include <process/metrics/metrics.hpp>
 
+#include <stout/gzip.hpp>
 #include <stout/json.hpp>
 #include <stout/net.hpp>
 #include <stout/option.hpp>
 #include <stout/os.hpp>
+#include <stout/path.hpp>
 #include <stout/strings.hpp>
 #include <stout/try.hpp>
 
@@ -109,6 +114,7 @@ using process::http::OK;
 using process::http::Response;
 using process::http::Unauthorized;
 
+using std::list;
 using std::shared_ptr;
 using std::string;
 using std::vector;
@@ -5053,6 +5059,235 @@ TEST_F(MasterTest, StateEndpointAgentCapabilities)
 }
 
 
+// This ensures that the master's /state and /state-summary endpoints
+// return the same objects when the responses are streamed.
+TEST_F(MasterTest, StateEndpointStreaming)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), master.get()->pid, _);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get());
+  ASSERT_SOME(slave);
+
+  AWAIT_READY(slaveRegisteredMessage);
+
+  const vector<string> endpoints = {"state", "state-summary"};
+
+  foreach (const string& endpoint, endpoints) {
+    Future<Response> response = process::http::get(
+        master.get()->pid,
+        endpoint,
+        None(),
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+
+    Try<JSON::Object> expected = JSON::parse<JSON::Object>(response->body);
+    ASSERT_SOME(expected);
+
+    Future<Response> streamed = process::http::get(
+        master.get()->pid,
+        endpoint,
+        "stream=true",
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, streamed);
+    AWAIT_EXPECT_RESPONSE_HEADER_EQ(
+        APPLICATION_JSON, "Content-Type", streamed);
+
+    Try<JSON::Object> parse = JSON::parse<JSON::Object>(streamed->body);
+    ASSERT_SOME(parse);
+
+    EXPECT_EQ(expected.get(), parse.get());
+
+    Result<JSON::Array> slaves = parse->find<JSON::Array>("slaves");
+    ASSERT_SOME(slaves);
+    EXPECT_EQ(1u, slaves->values.size());
+  }
+}
+
+
+// This ensures that the master serves a cached rendering of its
+// /state endpoint within `--state_cache_max_staleness`, even though
+// its state has changed in the meantime.
+TEST_F(MasterTest, StateEndpointCache)
+{
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.state_cache_max_staleness = Days(1);
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  auto slaves = [&master](const Option<string>& query) -> size_t {
+    Future<Response> response = process::http::get(
+        master.get()->pid,
+        "state",
+        query,
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+
+    Try<JSON::Object> parse = JSON::parse<JSON::Object>(response->body);
+    CHECK_SOME(parse);
+
+    Result<JSON::Array> slaves = parse->find<JSON::Array>("slaves");
+    CHECK_SOME(slaves);
+
+    return slaves->values.size();
+  };
+
+  EXPECT_EQ(0u, slaves(None()));
+
+  Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), master.get()->pid, _);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get());
+  ASSERT_SOME(slave);
+
+  AWAIT_READY(slaveRegisteredMessage);
+
+  // The cached (stale) rendering is served.
+  EXPECT_EQ(0u, slaves(None()));
+
+  // Streamed responses are never cached.
+  EXPECT_EQ(1u, slaves(string("stream=true")));
+}
+
+
+// This ensures that the master's /state endpoint only returns the
+// agents and frameworks selected by the query.
+TEST_F(MasterTest, StateEndpointFiltered)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), master.get()->pid, _);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get());
+  ASSERT_SOME(slave);
+
+  AWAIT_READY(slaveRegisteredMessage);
+
+  const SlaveID slaveId = slaveRegisteredMessage->slave_id();
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  Future<FrameworkID> frameworkId;
+  EXPECT_CALL(sched, registered(&driver, _, _))
+    .WillOnce(FutureArg<1>(&frameworkId));
+
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillRepeatedly(Return()); // Ignore offers.
+
+  driver.start();
+
+  AWAIT_READY(frameworkId);
+
+  // The number of agents and frameworks in the state.
+  typedef std::pair<size_t, size_t> Counts;
+
+  auto count = [&master](const string& query) -> Counts {
+    Future<Response> response = process::http::get(
+        master.get()->pid,
+        "state",
+        query,
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+
+    Try<JSON::Object> parse = JSON::parse<JSON::Object>(response->body);
+    CHECK_SOME(parse);
+
+    Result<JSON::Array> slaves = parse->find<JSON::Array>("slaves");
+    CHECK_SOME(slaves);
+
+    Result<JSON::Array> frameworks = parse->find<JSON::Array>("frameworks");
+    CHECK_SOME(frameworks);
+
+    return Counts(slaves->values.size(), frameworks->values.size());
+  };
+
+  EXPECT_EQ(Counts(1, 1), count("slave_id=" + slaveId.value()));
+  EXPECT_EQ(Counts(0, 1), count("slave_id=unknown"));
+
+  EXPECT_EQ(Counts(1, 1),
+            count("framework_id=" + frameworkId->value()));
+  EXPECT_EQ(Counts(1, 0), count("framework_id=unknown"));
+
+  EXPECT_EQ(Counts(0, 0),
+            count("slave_id=unknown&framework_id=unknown&stream=true"));
+
+  driver.stop();
+  driver.join();
+}
+
+
+// This ensures that the leading master writes snapshots of its state
+// into `--state_snapshot_dir`, with a file per kind of entity.
+TEST_F(MasterTest, StateSnapshot)
+{
+  Clock::pause();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.state_snapshot_dir = path::join(sandbox.get(), "snapshots");
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), master.get()->pid, _);
+
+  slave::Flags agentFlags = CreateSlaveFlags();
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get(), agentFlags);
+  ASSERT_SOME(slave);
+
+  Clock::advance(agentFlags.registration_backoff_factor);
+  AWAIT_READY(slaveRegisteredMessage);
+
+  Clock::advance(masterFlags.state_snapshot_interval);
+  Clock::settle();
+
+  Try<list<string>> snapshots = os::ls(masterFlags.state_snapshot_dir.get());
+  ASSERT_SOME(snapshots);
+  ASSERT_EQ(1u, snapshots->size());
+
+  const string snapshot =
+    path::join(masterFlags.state_snapshot_dir.get(), snapshots->front());
+
+  EXPECT_TRUE(os::exists(path::join(snapshot, "tasks.gz")));
+  EXPECT_TRUE(os::exists(path::join(snapshot, "frameworks.gz")));
+
+  Try<string> read = os::read(path::join(snapshot, "agents.gz"));
+  ASSERT_SOME(read);
+
+  Try<string> records = gzip::decompress(read.get());
+  ASSERT_SOME(records);
+
+  // The only record is the registered agent.
+  ASSERT_GE(records->size(), sizeof(uint32_t));
+
+  const uint32_t size = *reinterpret_cast<const uint32_t*>(records->data());
+  ASSERT_EQ(sizeof(size) + size, records->size());
+
+  mesos::master::Response::GetAgents::Agent agent;
+  ASSERT_TRUE(agent.ParseFromString(records->substr(sizeof(size))));
+  EXPECT_EQ(slaveRegisteredMessage->slave_id(), agent.agent_info().id());
+
+  Clock::resume();
+}
+
+
 // This ensures allocation role of task and its executor is exposed
 // in master's /state endpoint.
 TEST_F(MasterTest, StateEndpointAllocationRole)
@@ -8366,6 +8601,89 @@ TEST_F(MasterTest, IgnoreOldAgentReregistration)
 }
 
 
+// This test verifies that the master queues agent registrations
+// beyond `--max_concurrent_agent_admissions`, asks the queued agents
+// to back off, and admits them by priority.
+TEST_F(MasterTest, AgentAdmissionQueue)
+{
+  Clock::pause();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.max_concurrent_agent_admissions = 1;
+  masterFlags.agent_admission_priority_attribute = "priority";
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  // Hold the registry operations admitting the agents.
+  Future<Owned<master::Operation>> admit1;
+  Future<Owned<master::Operation>> admit2;
+  Future<Owned<master::Operation>> admit3;
+  Promise<bool> promise1;
+  Promise<bool> promise2;
+  Promise<bool> promise3;
+  EXPECT_CALL(*master.get()->registrar, apply(_))
+    .WillOnce(DoAll(FutureArg<0>(&admit1), Return(promise1.future())))
+    .WillOnce(DoAll(FutureArg<0>(&admit2), Return(promise2.future())))
+    .WillOnce(DoAll(FutureArg<0>(&admit3), Return(promise3.future())));
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+
+  slave::Flags agentFlags1 = CreateSlaveFlags();
+  Try<Owned<cluster::Slave>> slave1 = StartSlave(detector.get(), agentFlags1);
+  ASSERT_SOME(slave1);
+
+  Clock::advance(agentFlags1.registration_backoff_factor);
+  AWAIT_READY(admit1);
+
+  // The other agents get queued while the first one is registering.
+  Future<SlaveAdmissionBackoffMessage> backoff2 =
+    FUTURE_PROTOBUF(SlaveAdmissionBackoffMessage(), master.get()->pid, _);
+
+  slave::Flags agentFlags2 = CreateSlaveFlags();
+  Try<Owned<cluster::Slave>> slave2 = StartSlave(detector.get(), agentFlags2);
+  ASSERT_SOME(slave2);
+
+  Clock::advance(agentFlags2.registration_backoff_factor);
+  AWAIT_READY(backoff2);
+
+  EXPECT_EQ(
+      masterFlags.agent_admission_retry_interval.secs(),
+      backoff2->retry_after_seconds());
+
+  Future<SlaveAdmissionBackoffMessage> backoff3 =
+    FUTURE_PROTOBUF(SlaveAdmissionBackoffMessage(), master.get()->pid, _);
+
+  slave::Flags agentFlags3 = CreateSlaveFlags();
+  agentFlags3.attributes = "priority:1";
+
+  Try<Owned<cluster::Slave>> slave3 = StartSlave(detector.get(), agentFlags3);
+  ASSERT_SOME(slave3);
+
+  Clock::advance(agentFlags3.registration_backoff_factor);
+  AWAIT_READY(backoff3);
+
+  Future<SlaveRegisteredMessage> slaveRegistered2 =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), _, slave2.get()->pid);
+  Future<SlaveRegisteredMessage> slaveRegistered3 =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), _, slave3.get()->pid);
+
+  // Once the first agent is registered, the third agent is admitted
+  // before the second one because of its higher priority.
+  promise1.associate(master.get()->registrar->unmocked_apply(admit1.get()));
+  AWAIT_READY(admit2);
+
+  promise2.associate(master.get()->registrar->unmocked_apply(admit2.get()));
+  AWAIT_READY(slaveRegistered3);
+  AWAIT_READY(admit3);
+
+  EXPECT_TRUE(slaveRegistered2.isPending());
+
+  promise3.associate(master.get()->registrar->unmocked_apply(admit3.get()));
+  AWAIT_READY(slaveRegistered2);
+}
+
+
 // This test checks that the master correctly garbage collects
 // information about gone agents from the registry using the
 // count-based GC criterion.
@@ -0,0 +1,422 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <mesos/mesos.hpp>
+
+#include <stout/gtest.hpp>
+#include <stout/os.hpp>
+#include <stout/path.hpp>
+#include <stout/stopwatch.hpp>
+#include <stout/stringify.hpp>
+
+#include <stout/tests/utils.hpp>
+
+#include "slave/meta_journal.hpp"
+#include "slave/paths.hpp"
+#include "slave/state.hpp"
+
+namespace paths = mesos::internal::slave::paths;
+namespace state = mesos::internal::slave::state;
+
+using mesos::internal::slave::MetaJournal;
+
+using std::cout;
+using std::endl;
+using std::pair;
+using std::string;
+using std::vector;
+
+using testing::WithParamInterface;
+
+namespace mesos {
+namespace internal {
+namespace tests {
+
+class MetaJournalTest : public TemporaryDirectoryTest
+{
+protected:
+  virtual void SetUp()
+  {
+    TemporaryDirectoryTest::SetUp();
+
+    metaDir = path::join(os::getcwd(), "meta");
+  }
+
+  virtual void TearDown()
+  {
+    MetaJournal::close(metaDir);
+
+    TemporaryDirectoryTest::TearDown();
+  }
+
+  // Checkpoints the state of an agent running an executor with a
+  // single task for each of `executors` executors of a framework.
+  void checkpoint(size_t executors)
+  {
+    SlaveInfo slaveInfo;
+    slaveInfo.set_hostname("localhost");
+    slaveInfo.mutable_id()->CopyFrom(slaveId);
+
+    paths::createSlaveDirectory(metaDir, slaveId);
+
+    ASSERT_SOME(state::checkpoint(
+        paths::getSlaveInfoPath(metaDir, slaveId), slaveInfo));
+
+    FrameworkInfo frameworkInfo;
+    frameworkInfo.set_user("user");
+    frameworkInfo.set_name("framework");
+    frameworkInfo.mutable_id()->CopyFrom(frameworkId);
+
+    ASSERT_SOME(state::checkpoint(
+        paths::getFrameworkInfoPath(metaDir, slaveId, frameworkId),
+        frameworkInfo));
+
+    ASSERT_SOME(state::checkpoint(
+        paths::getFrameworkPidPath(metaDir, slaveId, frameworkId),
+        string("scheduler@127.0.0.1:5050")));
+
+    for (size_t i = 0; i < executors; i++) {
+      ExecutorInfo executorInfo;
+      executorInfo.mutable_executor_id()->set_value("executor-" + stringify(i));
+      executorInfo.mutable_framework_id()->CopyFrom(frameworkId);
+      executorInfo.mutable_command()->set_value("sleep 1000");
+
+      const ExecutorID& executorId = executorInfo.executor_id();
+
+      ContainerID containerId;
+      containerId.set_value("container-" + stringify(i));
+
+      paths::createExecutorDirectory(
+          metaDir, slaveId, frameworkId, executorId, containerId, None());
+
+      ASSERT_SOME(state::checkpoint(
+          paths::getExecutorInfoPath(
+              metaDir, slaveId, frameworkId, executorId),
+          executorInfo));
+
+      ASSERT_SOME(state::checkpoint(
+          paths::getForkedPidPath(
+              metaDir, slaveId, frameworkId, executorId, containerId),
+          stringify(1000 + i)));
+
+      ASSERT_SOME(state::checkpoint(
+          paths::getLibprocessPidPath(
+              metaDir, slaveId, frameworkId, executorId, containerId),
+          string("executor@127.0.0.1:5051")));
+
+      Task task;
+      task.set_name("task");
+      task.mutable_task_id()->set_value("task-" + stringify(i));
+      task.mutable_framework_id()->CopyFrom(frameworkId);
+      task.mutable_slave_id()->CopyFrom(slaveId);
+      task.mutable_executor_id()->CopyFrom(executorId);
+      task.set_state(TASK_RUNNING);
+
+      ASSERT_SOME(state::checkpoint(
+          paths::getTaskInfoPath(
+              metaDir,
+              slaveId,
+              frameworkId,
+              executorId,
+              containerId,
+              task.task_id()),
+          task));
+    }
+  }
+
+  string metaDir;
+
+  const SlaveID slaveId = createSlaveId();
+  const FrameworkID frameworkId = createFrameworkId();
+
+private:
+  static SlaveID createSlaveId()
+  {
+    SlaveID slaveId;
+    slaveId.set_value("agent");
+    return slaveId;
+  }
+
+  static FrameworkID createFrameworkId()
+  {
+    FrameworkID frameworkId;
+    frameworkId.set_value("framework");
+    return frameworkId;
+  }
+};
+
+
+// This test verifies that the files checkpointed before the journal
+// was enabled get journaled by the first recovery, after which they
+// are recovered from the journal rather than from disk.
+TEST_F(MetaJournalTest, Migrate)
+{
+  checkpoint(2);
+
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  Try<state::State> recovered = state::recover(metaDir, true);
+  ASSERT_SOME(recovered);
+  ASSERT_SOME(recovered->slave);
+  EXPECT_EQ(2u, recovered->slave->frameworks.at(frameworkId).executors.size());
+
+  MetaJournal::close(metaDir);
+
+  EXPECT_TRUE(os::exists(paths::getMetaJournalPath(metaDir)));
+
+  // Overwrite a task's file behind the back of the journal, the task
+  // should still get recovered from the journal.
+  const ExecutorID executorId = recovered->slave->frameworks
+    .at(frameworkId).executors.begin()->first;
+
+  const string path = paths::getTaskInfoPath(
+      metaDir,
+      slaveId,
+      frameworkId,
+      executorId,
+      recovered->slave->frameworks.at(frameworkId)
+        .executors.at(executorId).latest.get(),
+      recovered->slave->frameworks.at(frameworkId)
+        .executors.at(executorId).runs.begin()->second
+        .tasks.begin()->first);
+
+  ASSERT_SOME(os::write(path, "garbage"));
+
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  recovered = state::recover(metaDir, true);
+  ASSERT_SOME(recovered);
+  ASSERT_SOME(recovered->slave);
+
+  foreachvalue (const state::ExecutorState& executor,
+                recovered->slave->frameworks.at(frameworkId).executors) {
+    ASSERT_EQ(1u, executor.runs.size());
+
+    const state::RunState& run = executor.runs.begin()->second;
+    EXPECT_SOME(run.forkedPid);
+    EXPECT_SOME(run.libprocessPid);
+
+    ASSERT_EQ(1u, run.tasks.size());
+    EXPECT_SOME(run.tasks.begin()->second.info);
+  }
+}
+
+
+// This test verifies that compacting the journal drops the records of
+// files that have been rewritten or no longer exist.
+TEST_F(MetaJournalTest, Compact)
+{
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  const string path1 = path::join(metaDir, "a", "file");
+  const string path2 = path::join(metaDir, "b", "file");
+
+  ASSERT_SOME(state::checkpoint(path1, string("1")));
+  ASSERT_SOME(state::checkpoint(path1, string("2")));
+  ASSERT_SOME(state::checkpoint(path2, string("3")));
+
+  const string journal = paths::getMetaJournalPath(metaDir);
+
+  Try<Bytes> size = os::stat::size(journal);
+  ASSERT_SOME(size);
+
+  // Remove the second file like the agent garbage collects directories.
+  ASSERT_SOME(os::rmdir(Path(path2).dirname()));
+
+  std::shared_ptr<MetaJournal> metaJournal = MetaJournal::find(path1);
+  ASSERT_TRUE(metaJournal != nullptr);
+  ASSERT_SOME(metaJournal->compact());
+
+  Try<Bytes> compacted = os::stat::size(journal);
+  ASSERT_SOME(compacted);
+  EXPECT_LT(compacted.get(), size.get() / 2);
+
+  MetaJournal::close(metaDir);
+
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  metaJournal = MetaJournal::find(path1);
+  ASSERT_TRUE(metaJournal != nullptr);
+
+  EXPECT_SOME_EQ("2", metaJournal->read(path1));
+  EXPECT_NONE(metaJournal->read(path2));
+}
+
+
+// This test verifies that a partially written last record, e.g., due
+// to the agent crashing while appending it, gets dropped.
+TEST_F(MetaJournalTest, PartialRecord)
+{
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  const string path = path::join(metaDir, "file");
+
+  ASSERT_SOME(state::checkpoint(path, string("data")));
+
+  MetaJournal::close(metaDir);
+
+  const string journal = paths::getMetaJournalPath(metaDir);
+
+  Try<int_fd> fd = os::open(journal, O_WRONLY | O_APPEND | O_CLOEXEC);
+  ASSERT_SOME(fd);
+  ASSERT_SOME(os::write(fd.get(), string("\x20\x00", 2)));
+  ASSERT_SOME(os::close(fd.get()));
+
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  std::shared_ptr<MetaJournal> metaJournal = MetaJournal::find(path);
+  ASSERT_TRUE(metaJournal != nullptr);
+  EXPECT_SOME_EQ("data", metaJournal->read(path));
+
+  // Appending to the journal should not be affected by the partial
+  // record, which got truncated.
+  ASSERT_SOME(state::checkpoint(path, string("more data")));
+
+  MetaJournal::close(metaDir);
+
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  metaJournal = MetaJournal::find(path);
+  ASSERT_TRUE(metaJournal != nullptr);
+  EXPECT_SOME_EQ("more data", metaJournal->read(path));
+}
+
+
+// This test verifies that disabling the journal removes it, so that it
+// can't get out of date with the files.
+TEST_F(MetaJournalTest, Disable)
+{
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  const string path = path::join(metaDir, "file");
+
+  ASSERT_SOME(state::checkpoint(path, string("data")));
+
+  ASSERT_SOME(MetaJournal::disable(metaDir));
+
+  EXPECT_TRUE(MetaJournal::find(path) == nullptr);
+  EXPECT_FALSE(os::exists(paths::getMetaJournalPath(metaDir)));
+
+  // Files are still checkpointed as usual.
+  ASSERT_SOME(state::checkpoint(path, string("more data")));
+  EXPECT_SOME_EQ("more data", os::read(path));
+}
+
+
+// This test verifies that a batch of checkpoints writes and journals
+// every file, and that a batch failing to be written doesn't modify
+// any of them.
+TEST_F(MetaJournalTest, BatchCheckpoint)
+{
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  const string path1 = path::join(metaDir, "a", "file1");
+  const string path2 = path::join(metaDir, "a", "file2");
+  const string path3 = path::join(metaDir, "b", "file");
+
+  ASSERT_SOME(state::checkpoint(vector<pair<string, string>>{
+      {path1, "1"}, {path2, "2"}, {path3, "3"}}));
+
+  EXPECT_SOME_EQ("1", os::read(path1));
+  EXPECT_SOME_EQ("2", os::read(path2));
+  EXPECT_SOME_EQ("3", os::read(path3));
+
+  // The base directory of the second file can't be created since a
+  // file is in the way, so the first file must be left untouched.
+  const string path4 = path::join(metaDir, "a", "file1", "file");
+
+  EXPECT_ERROR(state::checkpoint(vector<pair<string, string>>{
+      {path2, "4"}, {path4, "5"}}));
+
+  EXPECT_SOME_EQ("2", os::read(path2));
+
+  MetaJournal::close(metaDir);
+
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+
+  std::shared_ptr<MetaJournal> metaJournal = MetaJournal::find(path1);
+  ASSERT_TRUE(metaJournal != nullptr);
+
+  EXPECT_SOME_EQ("1", metaJournal->read(path1));
+  EXPECT_SOME_EQ("2", metaJournal->read(path2));
+  EXPECT_SOME_EQ("3", metaJournal->read(path3));
+}
+
+
+class MetaJournal_BENCHMARK_Test
+  : public MetaJournalTest,
+    public WithParamInterface<size_t> {};
+
+
+// The benchmark is parameterized by the number of executors, each
+// running a single task.
+INSTANTIATE_TEST_CASE_P(
+    Executors,
+    MetaJournal_BENCHMARK_Test,
+    ::testing::Values(1000U, 10000U, 50000U));
+
+
+// Measures the time it takes to recover the checkpointed state of an
+// agent from the checkpointed files and from the meta journal.
+//
+// NOTE: The files are likely to be in the page cache, so this mostly
+// measures the overhead of opening and reading every file.
+TEST_P(MetaJournal_BENCHMARK_Test, Recover)
+{
+  const size_t executors = GetParam();
+
+  checkpoint(executors);
+
+  Stopwatch watch;
+  watch.start();
+
+  Try<state::State> recovered = state::recover(metaDir, true);
+
+  watch.stop();
+
+  ASSERT_SOME(recovered);
+
+  cout << "Recovered " << executors << " executors from the files in "
+       << watch.elapsed() << endl;
+
+  // Journal the files.
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+  ASSERT_SOME(state::recover(metaDir, true));
+  MetaJournal::close(metaDir);
+
+  watch.start();
+
+  ASSERT_SOME(MetaJournal::enable(metaDir));
+  recovered = state::recover(metaDir, true);
+
+  watch.stop();
+
+  ASSERT_SOME(recovered);
+
+  cout << "Recovered " << executors << " executors from the journal in "
+       << watch.elapsed() << endl;
+}
+
+} // namespace tests {
+} // namespace internal {
+} // namespace mesos {
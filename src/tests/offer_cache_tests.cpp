@@ -0,0 +1,302 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <mesos/v1/attributes.hpp>
+#include <mesos/v1/mesos.hpp>
+#include <mesos/v1/resources.hpp>
+
+#include <mesos/v1/scheduler/offer_cache.hpp>
+
+#include <process/clock.hpp>
+
+#include <stout/foreach.hpp>
+#include <stout/gtest.hpp>
+#include <stout/stopwatch.hpp>
+#include <stout/stringify.hpp>
+
+using mesos::v1::AgentID;
+using mesos::v1::Attributes;
+using mesos::v1::FrameworkID;
+using mesos::v1::Offer;
+using mesos::v1::OfferID;
+using mesos::v1::Resources;
+
+using mesos::v1::scheduler::Call;
+using mesos::v1::scheduler::Event;
+using mesos::v1::scheduler::OfferCache;
+
+using process::Clock;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+using testing::WithParamInterface;
+
+namespace mesos {
+namespace internal {
+namespace tests {
+
+static Offer createOffer(
+    const string& id,
+    const string& agent,
+    const string& resources,
+    const string& attributes = "")
+{
+  Offer offer;
+  offer.mutable_id()->set_value(id);
+  offer.mutable_framework_id()->set_value("framework");
+  offer.mutable_agent_id()->set_value(agent);
+  offer.set_hostname(agent);
+  offer.mutable_resources()->CopyFrom(
+      Resources::parse(resources).get());
+
+  if (!attributes.empty()) {
+    offer.mutable_attributes()->CopyFrom(Attributes::parse(attributes));
+  }
+
+  return offer;
+}
+
+
+static AgentID agentId(const string& value)
+{
+  AgentID agentId;
+  agentId.set_value(value);
+  return agentId;
+}
+
+
+static OfferID offerId(const string& value)
+{
+  OfferID offerId;
+  offerId.set_value(value);
+  return offerId;
+}
+
+
+// This test verifies that the offers of an agent get aggregated and
+// that matching considers the aggregated resources and attributes.
+TEST(OfferCacheTest, Match)
+{
+  OfferCache cache;
+
+  cache.add(createOffer("o1", "a1", "cpus:1;mem:512", "rack:r1"));
+  cache.add(createOffer("o2", "a1", "cpus:1;mem:512", "rack:r1"));
+  cache.add(createOffer("o3", "a2", "cpus:4;mem:1024", "rack:r2"));
+
+  EXPECT_EQ(3u, cache.size());
+
+  const OfferCache::Agent* agent = cache.agent(agentId("a1"));
+  ASSERT_NE(nullptr, agent);
+  EXPECT_EQ(2u, agent->offers.size());
+  EXPECT_EQ(Resources::parse("cpus:2;mem:1024").get(), agent->available);
+
+  EXPECT_EQ(
+      vector<AgentID>({agentId("a1")}),
+      cache.match(
+          Resources::parse("cpus:2;mem:1024").get(),
+          Attributes::parse("rack:r1")));
+
+  EXPECT_EQ(
+      vector<AgentID>({agentId("a2")}),
+      cache.match(Resources::parse("cpus:3").get()));
+
+  EXPECT_TRUE(cache.match(
+      Resources::parse("cpus:3").get(),
+      Attributes::parse("rack:r1")).empty());
+
+  EXPECT_TRUE(cache.match(Resources::parse("gpus:1").get()).empty());
+
+  // Using an offer updates the view of its agent.
+  EXPECT_SOME(cache.remove(offerId("o1")));
+  EXPECT_NONE(cache.remove(offerId("o1")));
+
+  EXPECT_TRUE(cache.match(
+      Resources::parse("cpus:2").get(),
+      Attributes::parse("rack:r1")).empty());
+
+  EXPECT_EQ(
+      vector<AgentID>({agentId("a1")}),
+      cache.match(
+          Resources::parse("cpus:1").get(),
+          Attributes::parse("rack:r1")));
+}
+
+
+// This test verifies that the offers get removed by the rescind and
+// agent failure events.
+TEST(OfferCacheTest, Update)
+{
+  OfferCache cache;
+
+  Event offers;
+  offers.set_type(Event::OFFERS);
+  offers.mutable_offers()->add_offers()->CopyFrom(
+      createOffer("o1", "a1", "cpus:1"));
+  offers.mutable_offers()->add_offers()->CopyFrom(
+      createOffer("o2", "a1", "cpus:1"));
+  offers.mutable_offers()->add_offers()->CopyFrom(
+      createOffer("o3", "a2", "cpus:1"));
+
+  cache.update(offers);
+  EXPECT_EQ(3u, cache.size());
+
+  Event rescind;
+  rescind.set_type(Event::RESCIND);
+  rescind.mutable_rescind()->mutable_offer_id()->CopyFrom(offerId("o3"));
+
+  cache.update(rescind);
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(nullptr, cache.agent(agentId("a2")));
+
+  Event failure;
+  failure.set_type(Event::FAILURE);
+  failure.mutable_failure()->mutable_agent_id()->CopyFrom(agentId("a1"));
+
+  cache.update(failure);
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(nullptr, cache.agent(agentId("a1")));
+}
+
+
+// This test verifies that the offers which go unused for longer than
+// the expiration get declined with the refusal filter.
+TEST(OfferCacheTest, DeclineExpired)
+{
+  Clock::pause();
+
+  OfferCache cache(Seconds(10), Seconds(2));
+
+  FrameworkID frameworkId;
+  frameworkId.set_value("framework");
+
+  cache.add(createOffer("o1", "a1", "cpus:1"));
+
+  Clock::advance(Seconds(5));
+
+  cache.add(createOffer("o2", "a2", "cpus:1"));
+  cache.add(createOffer("o3", "a3", "cpus:1"));
+
+  EXPECT_NONE(cache.declineExpired(frameworkId));
+
+  Clock::advance(Seconds(5));
+
+  Option<Call> call = cache.declineExpired(frameworkId);
+  ASSERT_SOME(call);
+  EXPECT_EQ(Call::DECLINE, call->type());
+  ASSERT_EQ(1, call->decline().offer_ids_size());
+  EXPECT_EQ(offerId("o1"), call->decline().offer_ids(0));
+  EXPECT_DOUBLE_EQ(2, call->decline().filters().refuse_seconds());
+
+  // A used offer does not get declined.
+  EXPECT_SOME(cache.remove(offerId("o2")));
+
+  Clock::advance(Seconds(5));
+
+  call = cache.declineExpired(frameworkId);
+  ASSERT_SOME(call);
+  ASSERT_EQ(1, call->decline().offer_ids_size());
+  EXPECT_EQ(offerId("o3"), call->decline().offer_ids(0));
+
+  EXPECT_EQ(0u, cache.size());
+
+  Clock::resume();
+}
+
+
+class OfferCache_BENCHMARK_Test
+  : public ::testing::Test,
+    public WithParamInterface<size_t> {};
+
+
+// The benchmark is parameterized by the number of agents.
+INSTANTIATE_TEST_CASE_P(
+    Agents,
+    OfferCache_BENCHMARK_Test,
+    ::testing::Values(1000U, 10000U, 50000U));
+
+
+// Measures the time it takes to match tasks against the offers of
+// many agents, of which only a few have the requested attribute,
+// compared to checking the offers of every agent.
+TEST_P(OfferCache_BENCHMARK_Test, Match)
+{
+  const size_t agents = GetParam();
+
+  OfferCache cache;
+
+  vector<Offer> offers;
+  offers.reserve(agents);
+
+  for (size_t i = 0; i < agents; i++) {
+    offers.push_back(createOffer(
+        "o" + stringify(i),
+        "a" + stringify(i),
+        "cpus:8;mem:16384",
+        "rack:r" + stringify(i % 100)));
+
+    cache.add(offers.back());
+  }
+
+  const Resources resources = Resources::parse("cpus:1;mem:128").get();
+  const Attributes attributes = Attributes::parse("rack:r42");
+
+  const size_t tasks = 1000;
+
+  Stopwatch watch;
+  watch.start();
+
+  size_t matched = 0;
+  for (size_t i = 0; i < tasks; i++) {
+    matched += cache.match(resources, attributes).size();
+  }
+
+  watch.stop();
+
+  cout << "Matched " << tasks << " tasks against the offers of " << agents
+       << " agents (" << matched << " matches) in " << watch.elapsed()
+       << " using the offer cache" << endl;
+
+  watch.start();
+
+  matched = 0;
+  for (size_t i = 0; i < tasks; i++) {
+    foreach (const Offer& offer, offers) {
+      if (Attributes(offer.attributes()).contains(attributes.get(0)) &&
+          Resources(offer.resources()).contains(resources)) {
+        matched++;
+      }
+    }
+  }
+
+  watch.stop();
+
+  cout << "Matched " << tasks << " tasks against the offers of " << agents
+       << " agents (" << matched << " matches) in " << watch.elapsed()
+       << " checking every offer" << endl;
+}
+
+} // namespace tests {
+} // namespace internal {
+} // namespace mesos {
@@ -108,9 +108,11 @@ protected:
     return statusUpdate;
   }
 
-  void resetStatusUpdateManager()
+  void resetStatusUpdateManager(
+      const Duration& syncInterval = Duration::zero())
   {
-    statusUpdateManager.reset(new OfferOperationStatusUpdateManager());
+    statusUpdateManager.reset(
+        new OfferOperationStatusUpdateManager(syncInterval));
 
     const function<void(const OfferOperationStatusUpdate&)> forward =
       [&](const OfferOperationStatusUpdate& update) {
@@ -751,6 +753,91 @@ TEST_F(OfferOperationStatusUpdateManagerTest, NonStrictRecoveryCorruptedFile)
 }
 
 
+// This test verifies that when a sync interval is given, the updates and
+// acknowledgements of several streams are only forwarded and handled once
+// they have been synced to disk together, and that they can be recovered.
+TEST_F(OfferOperationStatusUpdateManagerTest, GroupCommit)
+{
+  const Duration syncInterval = Milliseconds(100);
+
+  resetStatusUpdateManager(syncInterval);
+
+  Future<OfferOperationStatusUpdate> forwardedStatusUpdate1;
+  Future<OfferOperationStatusUpdate> forwardedStatusUpdate2;
+  EXPECT_CALL(statusUpdateProcessor, update(_))
+    .WillOnce(FutureArg<0>(&forwardedStatusUpdate1))
+    .WillOnce(FutureArg<0>(&forwardedStatusUpdate2));
+
+  const UUID operationUuid1 = UUID::random();
+  const UUID statusUuid1 = UUID::random();
+
+  OfferOperationStatusUpdate statusUpdate1 = createOfferOperationStatusUpdate(
+      statusUuid1,
+      operationUuid1,
+      OfferOperationState::OFFER_OPERATION_PENDING);
+
+  const UUID operationUuid2 = UUID::random();
+  const UUID statusUuid2 = UUID::random();
+
+  OfferOperationStatusUpdate statusUpdate2 = createOfferOperationStatusUpdate(
+      statusUuid2,
+      operationUuid2,
+      OfferOperationState::OFFER_OPERATION_PENDING);
+
+  Future<Nothing> update1 = statusUpdateManager->update(statusUpdate1, true);
+  Future<Nothing> update2 = statusUpdateManager->update(statusUpdate2, true);
+
+  // Nothing gets forwarded before the updates are synced.
+  Clock::settle();
+
+  EXPECT_TRUE(update1.isPending());
+  EXPECT_TRUE(update2.isPending());
+  EXPECT_TRUE(forwardedStatusUpdate1.isPending());
+
+  Clock::advance(syncInterval);
+
+  AWAIT_ASSERT_READY(update1);
+  AWAIT_ASSERT_READY(update2);
+
+  AWAIT_EXPECT_EQ(statusUpdate1, forwardedStatusUpdate1);
+  AWAIT_EXPECT_EQ(statusUpdate2, forwardedStatusUpdate2);
+
+  Future<bool> acknowledgement =
+    statusUpdateManager->acknowledgement(operationUuid1, statusUuid1);
+
+  Clock::settle();
+  EXPECT_TRUE(acknowledgement.isPending());
+
+  Clock::advance(syncInterval);
+
+  AWAIT_EXPECT_TRUE(acknowledgement);
+
+  // Recover the streams, the second update should be resent since it
+  // wasn't acknowledged.
+  resetStatusUpdateManager();
+
+  Future<OfferOperationStatusUpdate> forwardedStatusUpdate3;
+  EXPECT_CALL(statusUpdateProcessor, update(_))
+    .WillOnce(FutureArg<0>(&forwardedStatusUpdate3));
+
+  Future<OfferOperationStatusManagerState> state =
+    statusUpdateManager->recover({operationUuid1, operationUuid2}, true);
+
+  AWAIT_ASSERT_READY(state);
+
+  EXPECT_EQ(0u, state->errors);
+  ASSERT_TRUE(state->streams.contains(operationUuid1));
+  ASSERT_TRUE(state->streams.contains(operationUuid2));
+  ASSERT_SOME(state->streams.at(operationUuid1));
+  ASSERT_SOME(state->streams.at(operationUuid2));
+
+  EXPECT_EQ(1u, state->streams.at(operationUuid1)->updates.size());
+  EXPECT_EQ(1u, state->streams.at(operationUuid2)->updates.size());
+
+  AWAIT_EXPECT_EQ(statusUpdate2, forwardedStatusUpdate3);
+}
+
+
 // This test verifies that strict recovery of a status updates file containing
 // a corrupted record at the end fails.
 TEST_F(OfferOperationStatusUpdateManagerTest, StrictRecoveryCorruptedFile)
@@ -31,6 +31,7 @@
 #include <stout/gtest.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
+#include <stout/stringify.hpp>
 
 #include "common/resources_utils.hpp"
 
@@ -44,7 +45,9 @@
 
 #include "slave/flags.hpp"
 #include "slave/slave.hpp"
+#include "slave/qos_controllers/interference.hpp"
 #include "slave/qos_controllers/load.hpp"
+#include "slave/resource_estimators/usage.hpp"
 
 #include "tests/flags.hpp"
 #include "tests/containerizer.hpp"
@@ -59,8 +62,10 @@ using mesos::internal::master::Master;
 
 using mesos::internal::protobuf::createLabel;
 
+using mesos::internal::slave::InterferenceQoSController;
 using mesos::internal::slave::LoadQoSController;
 using mesos::internal::slave::Slave;
+using mesos::internal::slave::UsageResourceEstimator;
 
 using mesos::master::detector::MasterDetector;
 using mesos::master::detector::StandaloneMasterDetector;
@@ -446,11 +451,10 @@ TEST_F(OversubscriptionTest, RevocableOffer)
 }
 
 
-// This test verifies that when the master receives a new estimate for
-// oversubscribed resources it rescinds outstanding revocable offers.
-// In this test the oversubscribed resources are increased, so the master
-// will send out new offers with increased revocable resources.
-TEST_F(OversubscriptionTest, RescindRevocableOfferWithIncreasedRevocable)
+// This test verifies that when the master receives a new estimate of
+// increased oversubscribed resources it keeps the outstanding revocable
+// offers, and only offers the additional revocable resources.
+TEST_F(OversubscriptionTest, KeepRevocableOfferWithIncreasedRevocable)
 {
   // Pause the clock because we want to manually drive the allocations.
   Clock::pause();
@@ -517,9 +521,9 @@ TEST_F(OversubscriptionTest, RescindRevocableOfferWithIncreasedRevocable)
   EXPECT_EQ(allocatedResources(resources1, framework.roles(0)),
             Resources(offer->resources()));
 
-  Future<OfferID> offerId;
+  // The outstanding revocable offer remains valid.
   EXPECT_CALL(sched, offerRescinded(&driver, _))
-    .WillOnce(FutureArg<1>(&offerId));
+    .Times(0);
 
   // Inject another estimation of increased oversubscribable resources
   // while the previous revocable offer is outstanding.
@@ -530,23 +534,14 @@ TEST_F(OversubscriptionTest, RescindRevocableOfferWithIncreasedRevocable)
   Clock::advance(agentFlags.oversubscribed_resources_interval);
   Clock::settle();
 
-  // The previous revocable offer should be rescinded.
-  AWAIT_EXPECT_EQ(offer->id(), offerId);
-
-  // The allocation run triggered by the agent resource update may or
-  // may not take into account the rescinded offer due to a race
-  // between the dispatched allocation and the recovery of the resources
-  // from the recinded offer. Therefore we advance the clock after these
-  // resources are recovered to trigger a batch allocation to make sure
-  // all resources are allocated.
-  Clock::settle();
   Clock::advance(masterFlags.allocation_interval);
   Clock::settle();
 
   ASSERT_GT(offers.size(), 0);
 
-  // The total offered resources after the latest estimate.
-  Resources resources3;
+  // The total offered resources after the latest estimate, including
+  // the outstanding offer.
+  Resources resources3 = offer->resources();
   while (offers.size() != 0) {
     resources3 += offers.get()->resources();
   }
@@ -772,6 +767,73 @@ TEST_F(OversubscriptionTest, FixedResourceEstimator)
 }
 
 
+// This test verifies that the usage resource estimator oversubscribes
+// the resources allocated to an executor but not used by it within
+// the window of its usage samples.
+TEST_F(OversubscriptionTest, UsageResourceEstimator)
+{
+  // Use the highest usage of the executor, once there are at least
+  // two samples of it.
+  UsageResourceEstimator estimator(1.0, Minutes(10), 2, 0.1);
+
+  double timestamp = 0;
+  Bytes mem = Megabytes(256);
+
+  // The executor uses a CPU all the time.
+  estimator.initialize([this, &timestamp, &mem]() -> Future<ResourceUsage> {
+    ResourceUsage usage;
+
+    ResourceStatistics statistics = createResourceStatistics();
+    statistics.set_timestamp(timestamp);
+    statistics.set_cpus_user_time_secs(timestamp * 0.5);
+    statistics.set_cpus_system_time_secs(timestamp * 0.5);
+    statistics.set_mem_total_bytes(mem.bytes());
+
+    ResourceUsage::Executor* executor = usage.add_executors();
+    executor->mutable_executor_info()->CopyFrom(
+        createExecutorInfo("framework", "executor"));
+    executor->mutable_allocated()->CopyFrom(
+        Resources::parse("cpus:4;mem:1024").get());
+    executor->mutable_container_id()->set_value("container");
+    executor->mutable_statistics()->CopyFrom(statistics);
+
+    return usage;
+  });
+
+  // There are not enough samples to oversubscribe anything yet.
+  AWAIT_EXPECT_EQ(Resources(), estimator.oversubscribable());
+
+  // The first CPU usage sample is computed from the second usage.
+  timestamp = 10;
+  AWAIT_EXPECT_EQ(
+      createRevocableResources("mem", "768"),
+      estimator.oversubscribable());
+
+  timestamp = 20;
+  AWAIT_EXPECT_EQ(
+      createRevocableResources("cpus", "3") +
+        createRevocableResources("mem", "768"),
+      estimator.oversubscribable());
+
+  // A higher memory usage shrinks the estimate immediately.
+  timestamp = 30;
+  mem = Megabytes(300);
+  AWAIT_EXPECT_EQ(
+      createRevocableResources("cpus", "3") +
+        createRevocableResources("mem", "724"),
+      estimator.oversubscribable());
+
+  // The estimate does not grow while the higher memory usage is within
+  // the window.
+  timestamp = 40;
+  mem = Megabytes(200);
+  AWAIT_EXPECT_EQ(
+      createRevocableResources("cpus", "3") +
+        createRevocableResources("mem", "724"),
+      estimator.oversubscribable());
+}
+
+
 // This test verifies that the QoS Controller is able to fetch
 // ResourceUsage statistics about running executor.
 TEST_F(OversubscriptionTest, QoSFetchResourceUsage)
@@ -1511,6 +1573,97 @@ TEST_F(OversubscriptionTest, LoadQoSController)
 }
 
 
+// This test verifies that the interference QoS controller evicts the
+// revocable executor with the most cache misses once a latency-critical
+// executor is degraded.
+// 1. Run first correction iteration to take the first sample.
+// 2. Run second correction iteration without any memory pressure on the
+//    latency-critical executor. Eviction should not appear.
+// 3. Run third correction iteration with memory pressure on the
+//    latency-critical executor. Only the revocable executor with the
+//    most cache misses should be evicted.
+TEST_F(OversubscriptionTest, InterferenceQoSController)
+{
+  InterferenceQoSController::Thresholds thresholds;
+  thresholds.memoryPressure = 0.5;
+
+  InterferenceQoSController controller(thresholds, 1);
+
+  double timestamp = 0;
+  uint64_t memoryPressure = 0;
+
+  controller.initialize(
+      [this, &timestamp, &memoryPressure]() -> Future<ResourceUsage> {
+    ResourceUsage usage;
+
+    ResourceStatistics statistics = createResourceStatistics();
+    statistics.set_timestamp(timestamp);
+
+    // Prepare the latency-critical executor.
+    ResourceUsage::Executor* executor = usage.add_executors();
+    executor->mutable_executor_info()->CopyFrom(
+        createExecutorInfo("framework", "executor1"));
+    executor->mutable_allocated()->CopyFrom(
+        Resources::parse("cpus:2;mem:256").get());
+    executor->mutable_container_id()->set_value("container1");
+    executor->mutable_statistics()->CopyFrom(statistics);
+    executor->mutable_statistics()->set_mem_medium_pressure_counter(
+        memoryPressure);
+
+    // Prepare two revocable executors with different cache misses.
+    for (int i = 2; i <= 3; i++) {
+      Resources resources = Resources::parse("mem:128").get();
+      resources += createRevocableResources("cpus", "1");
+
+      executor = usage.add_executors();
+      executor->mutable_executor_info()->CopyFrom(
+          createExecutorInfo("framework", "executor" + stringify(i)));
+      executor->mutable_allocated()->CopyFrom(resources);
+      executor->mutable_container_id()->set_value("container" + stringify(i));
+      executor->mutable_statistics()->CopyFrom(statistics);
+
+      PerfStatistics* perf = executor->mutable_statistics()->mutable_perf();
+      perf->set_timestamp(timestamp);
+      perf->set_duration(1);
+      perf->set_cache_misses(i * 1000);
+    }
+
+    return usage;
+  });
+
+  // First correction iteration. There are no previous samples.
+  Future<list<QoSCorrection>> qosCorrections = controller.corrections();
+
+  AWAIT(qosCorrections);
+
+  EXPECT_TRUE(qosCorrections->empty());
+
+  // Second correction iteration. The latency-critical executor is not
+  // degraded.
+  timestamp = 10;
+  qosCorrections = controller.corrections();
+
+  AWAIT(qosCorrections);
+
+  EXPECT_TRUE(qosCorrections->empty());
+
+  // Third correction iteration. Cause a memory pressure event per
+  // second in the latency-critical executor.
+  timestamp = 20;
+  memoryPressure = 10;
+  qosCorrections = controller.corrections();
+
+  AWAIT(qosCorrections);
+
+  ASSERT_EQ(1u, qosCorrections->size());
+
+  const QoSCorrection& correction = qosCorrections->front();
+  EXPECT_EQ(QoSCorrection::KILL, correction.type());
+  EXPECT_EQ("executor3", correction.kill().executor_id().value());
+  EXPECT_EQ("container3", correction.kill().container_id().value());
+}
+
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
@@ -28,6 +28,7 @@
 
 #include <mesos/log/log.hpp>
 
+#include <mesos/state/in_memory.hpp>
 #include <mesos/state/log.hpp>
 #include <mesos/state/state.hpp>
 #include <mesos/state/storage.hpp>
@@ -113,10 +114,12 @@ using namespace mesos::internal::master::weights;
 
 using mesos::http::authentication::BasicAuthenticatorFactory;
 
+using mesos::state::InMemoryStorage;
 using mesos::state::LogStorage;
 using mesos::state::State;
 using mesos::state::Storage;
 
+using state::Batch;
 using state::Entry;
 
 
@@ -391,6 +394,69 @@ TEST_F(RegistrarTest, MarkUnreachable)
 }
 
 
+// Verify that several admitted slaves can be marked unreachable
+// within a single operation, which fails as a whole if any of the
+// slaves is not admitted.
+TEST_F(RegistrarTest, MarkSlavesUnreachable)
+{
+  Registrar registrar(flags, state);
+  AWAIT_READY(registrar.recover(master));
+
+  SlaveID id1;
+  id1.set_value("1");
+
+  SlaveInfo info1;
+  info1.set_hostname("localhost");
+  info1.mutable_id()->CopyFrom(id1);
+
+  SlaveID id2;
+  id2.set_value("2");
+
+  SlaveInfo info2;
+  info2.set_hostname("localhost");
+  info2.mutable_id()->CopyFrom(id2);
+
+  SlaveID id3;
+  id3.set_value("3");
+
+  SlaveInfo info3;
+  info3.set_hostname("localhost");
+  info3.mutable_id()->CopyFrom(id3);
+
+  AWAIT_TRUE(registrar.apply(Owned<Operation>(new AdmitSlave(info1))));
+  AWAIT_TRUE(registrar.apply(Owned<Operation>(new AdmitSlave(info2))));
+  AWAIT_TRUE(registrar.apply(Owned<Operation>(new AdmitSlave(info3))));
+
+  AWAIT_TRUE(
+      registrar.apply(
+          Owned<Operation>(
+              new MarkSlavesUnreachable(
+                  {info1, info3}, protobuf::getCurrentTime()))));
+
+  // The remaining slave is still admitted.
+  AWAIT_TRUE(
+      registrar.apply(
+          Owned<Operation>(
+              new MarkSlaveUnreachable(info2, protobuf::getCurrentTime()))));
+
+  AWAIT_TRUE(
+      registrar.apply(Owned<Operation>(new MarkSlaveReachable(info1))));
+
+  // The operation fails if any of the slaves is already unreachable.
+  AWAIT_FALSE(
+      registrar.apply(
+          Owned<Operation>(
+              new MarkSlavesUnreachable(
+                  {info1, info3}, protobuf::getCurrentTime()))));
+
+  // Which leaves the admitted slaves admitted.
+  AWAIT_TRUE(
+      registrar.apply(
+          Owned<Operation>(
+              new MarkSlaveUnreachable(info1, protobuf::getCurrentTime()))));
+}
+
+
 // Verify that an admitted slave can be marked as gone.
 TEST_F(RegistrarTest, MarkGone)
 {
@@ -1210,12 +1276,155 @@ TEST_F(RegistrarTest, Bootstrap)
 }
 
 
+// Tests that when `--registry_deltas` is set, changes to the agents
+// are stored as deltas, which are applied and then compacted into a
+// snapshot of the registry when the master recovers.
+TEST_F(RegistrarTest, Deltas)
+{
+  flags.registry_deltas = true;
+
+  SlaveID id1;
+  id1.set_value("1");
+
+  SlaveInfo info1;
+  info1.set_hostname("a");
+  info1.mutable_id()->CopyFrom(id1);
+
+  SlaveID id2;
+  id2.set_value("2");
+
+  SlaveInfo info2;
+  info2.set_hostname("b");
+  info2.mutable_id()->CopyFrom(id2);
+
+  {
+    Registrar registrar(flags, state);
+    AWAIT_READY(registrar.recover(master));
+
+    AWAIT_TRUE(registrar.apply(Owned<Operation>(new AdmitSlave(info1))));
+    AWAIT_TRUE(registrar.apply(Owned<Operation>(new AdmitSlave(info2))));
+
+    AWAIT_TRUE(
+        registrar.apply(
+            Owned<Operation>(
+                new MarkSlaveUnreachable(info1, protobuf::getCurrentTime()))));
+
+    info2.set_hostname("c");
+    AWAIT_TRUE(registrar.apply(Owned<Operation>(new UpdateSlave(info2))));
+  }
+
+  // Each operation was stored as a separate delta.
+  Future<set<string>> names = state->names();
+  AWAIT_READY(names);
+  EXPECT_EQ(
+      set<string>({
+          "registry",
+          "registry_delta_0",
+          "registry_delta_1",
+          "registry_delta_2",
+          "registry_delta_3"}),
+      names.get());
+
+  {
+    Registrar registrar(flags, state);
+    Future<Registry> registry = registrar.recover(master);
+    AWAIT_READY(registry);
+
+    ASSERT_EQ(1, registry->slaves().slaves().size());
+    EXPECT_EQ(info2, registry->slaves().slaves(0).info());
+
+    ASSERT_EQ(1, registry->unreachable().slaves().size());
+    EXPECT_EQ(id1, registry->unreachable().slaves(0).id());
+
+    // Since operations are applied in order, this is stored only
+    // after the deltas were compacted during recovery.
+    AWAIT_TRUE(
+        registrar.apply(Owned<Operation>(new MarkSlaveReachable(info1))));
+  }
+
+  names = state->names();
+  AWAIT_READY(names);
+  EXPECT_EQ(set<string>({"registry", "registry_delta_4"}), names.get());
+
+  {
+    Registrar registrar(flags, state);
+    Future<Registry> registry = registrar.recover(master);
+    AWAIT_READY(registry);
+
+    EXPECT_EQ(2, registry->slaves().slaves().size());
+    EXPECT_TRUE(registry->unreachable().slaves().empty());
+  }
+}
+
+
+// Tests that the registrar waits for more operations before storing
+// the registry, up to `--registry_batch_linger` or until
+// `--registry_max_batch_size` operations are queued.
+TEST_F(RegistrarTest, Batching)
+{
+  Clock::pause();
+
+  InMemoryStorage storage;
+  State state(&storage);
+
+  flags.registry_max_batch_size = 2;
+  flags.registry_batch_linger = Seconds(10);
+
+  SlaveInfo info1 = slave;
+
+  SlaveInfo info2 = slave;
+  info2.mutable_id()->set_value("2");
+
+  // NOTE: The linger is only limited by the latency of previous
+  // stores once there are at least two of them, so each registrar
+  // below waits for the full linger after recovering.
+  {
+    Registrar registrar(flags, &state);
+    AWAIT_READY(registrar.recover(master));
+
+    Future<bool> admit1 =
+      registrar.apply(Owned<Operation>(new AdmitSlave(info1)));
+
+    Clock::settle();
+    EXPECT_TRUE(admit1.isPending());
+
+    // The second operation fills the batch, so both are stored
+    // without waiting for the linger to expire.
+    Future<bool> admit2 =
+      registrar.apply(Owned<Operation>(new AdmitSlave(info2)));
+
+    AWAIT_TRUE(admit1);
+    AWAIT_TRUE(admit2);
+
+    JSON::Object metrics = Metrics();
+    EXPECT_EQ(2, metrics.values["registrar/batch_size"]);
+  }
+
+  {
+    Registrar registrar(flags, &state);
+    AWAIT_READY(registrar.recover(master));
+
+    Future<bool> remove =
+      registrar.apply(Owned<Operation>(new RemoveSlave(info1)));
+
+    Clock::settle();
+    EXPECT_TRUE(remove.isPending());
+
+    Clock::advance(flags.registry_batch_linger);
+    AWAIT_TRUE(remove);
+  }
+
+  Clock::resume();
+}
+
+
 class MockStorage : public Storage
 {
 public:
   MOCK_METHOD1(get, Future<Option<Entry>>(const string&));
   MOCK_METHOD2(set, Future<bool>(const Entry&, const UUID&));
   MOCK_METHOD1(expunge, Future<bool>(const Entry&));
+  MOCK_METHOD1(apply, Future<bool>(const Batch&));
   MOCK_METHOD0(names, Future<std::set<string>>());
 };
 
@@ -1261,6 +1470,9 @@ TEST_F(RegistrarTest, StoreTimeout)
   EXPECT_CALL(storage, get(_))
     .WillOnce(Return(None()));
 
+  EXPECT_CALL(storage, names())
+    .WillOnce(Return(std::set<string>()));
+
   Future<Nothing> set;
   EXPECT_CALL(storage, set(_, _))
     .WillOnce(DoAll(FutureSatisfy(&set),
@@ -1291,6 +1503,9 @@ TEST_F(RegistrarTest, Abort)
   EXPECT_CALL(storage, get(_))
     .WillOnce(Return(None()));
 
+  EXPECT_CALL(storage, names())
+    .WillOnce(Return(std::set<string>()));
+
   EXPECT_CALL(storage, set(_, _))
     .WillOnce(Return(Future<bool>(true)))              // Recovery.
     .WillOnce(Return(Future<bool>::failed("failure"))) // Failure.
@@ -0,0 +1,139 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <stout/gtest.hpp>
+#include <stout/try.hpp>
+
+#include <mesos/resources.hpp>
+
+#include "common/resource_quantities.hpp"
+
+using std::set;
+using std::string;
+using std::vector;
+
+namespace mesos {
+namespace internal {
+namespace tests {
+
+static ResourceQuantities parse(const string& text)
+{
+  Try<ResourceQuantities> quantities = ResourceQuantities::fromString(text);
+  CHECK_SOME(quantities);
+  return quantities.get();
+}
+
+
+TEST(ResourceQuantitiesTest, FromString)
+{
+  ResourceQuantities quantities = parse("mem:512;cpus:1.5;disk:0");
+
+  // Zero quantities are dropped and the names are sorted.
+  EXPECT_EQ(vector<string>({"cpus", "mem"}), quantities.keys());
+  EXPECT_DOUBLE_EQ(1.5, quantities.get("cpus").value());
+  EXPECT_DOUBLE_EQ(512, quantities.get("mem").value());
+  EXPECT_DOUBLE_EQ(0, quantities.get("disk").value());
+
+  EXPECT_ERROR(ResourceQuantities::fromString("cpus"));
+  EXPECT_ERROR(ResourceQuantities::fromString("cpus:abc"));
+  EXPECT_ERROR(ResourceQuantities::fromString("cpus:-1"));
+  EXPECT_ERROR(ResourceQuantities::fromString("cpus:1;cpus:2"));
+}
+
+
+TEST(ResourceQuantitiesTest, FromScalarResources)
+{
+  Resources resources =
+    Resources::parse("cpus:1;cpus(role1):2;mem:10;ports:[1-10]").get();
+
+  ResourceQuantities quantities =
+    ResourceQuantities::fromScalarResources(resources);
+
+  // Reservations are dropped and non-scalar resources are ignored.
+  EXPECT_EQ(parse("cpus:3;mem:10"), quantities);
+
+  EXPECT_EQ(
+      Resources::parse("cpus:3;mem:10").get(),
+      quantities.toUnreservedResources());
+}
+
+
+TEST(ResourceQuantitiesTest, Arithmetic)
+{
+  ResourceQuantities left = parse("cpus:1;mem:10");
+  ResourceQuantities right = parse("cpus:0.5;disk:100");
+
+  EXPECT_EQ(parse("cpus:1.5;disk:100;mem:10"), left + right);
+
+  // Subtraction saturates at zero and drops the zero entries.
+  EXPECT_EQ(parse("cpus:0.5;mem:10"), left - right);
+  EXPECT_EQ(parse("disk:100"), right - left);
+  EXPECT_TRUE((left - left).empty());
+
+  // Fixed point arithmetic does not accumulate rounding errors.
+  ResourceQuantities sum;
+  for (int i = 0; i < 10; i++) {
+    sum += parse("cpus:0.1");
+  }
+
+  EXPECT_EQ(parse("cpus:1"), sum);
+
+  for (int i = 0; i < 10; i++) {
+    sum -= parse("cpus:0.1");
+  }
+
+  EXPECT_TRUE(sum.empty());
+}
+
+
+TEST(ResourceQuantitiesTest, Contains)
+{
+  ResourceQuantities quantities = parse("cpus:2;mem:10");
+
+  EXPECT_TRUE(quantities.contains(ResourceQuantities()));
+  EXPECT_TRUE(quantities.contains(parse("cpus:2")));
+  EXPECT_TRUE(quantities.contains(parse("cpus:1;mem:10")));
+  EXPECT_FALSE(quantities.contains(parse("cpus:3")));
+  EXPECT_FALSE(quantities.contains(parse("cpus:1;disk:1")));
+  EXPECT_FALSE(ResourceQuantities().contains(quantities));
+}
+
+
+TEST(ResourceQuantitiesTest, DominantShare)
+{
+  ResourceQuantities total = parse("cpus:10;disk:100;mem:100");
+
+  EXPECT_DOUBLE_EQ(0, ResourceQuantities().dominantShare(total));
+  EXPECT_DOUBLE_EQ(0.5, parse("cpus:5;mem:10").dominantShare(total));
+
+  // Names that are not in the total are ignored.
+  EXPECT_DOUBLE_EQ(0.1, parse("cpus:1;gpus:1").dominantShare(total));
+
+  // Excluded names are ignored.
+  EXPECT_DOUBLE_EQ(
+      0.1,
+      parse("cpus:5;mem:10").dominantShare(total, set<string>({"cpus"})));
+}
+
+} // namespace tests {
+} // namespace internal {
+} // namespace mesos {
@@ -1176,6 +1176,38 @@ TEST(ResourcesTest, ScalarSubtraction2)
 }
 
 
+// This test verifies the arithmetic of unreserved scalars allocated
+// to different roles, i.e., that the allocation info is respected
+// and kept up to date when allocating and unallocating resources.
+TEST(ResourcesTest, AllocatedScalarArithmetic)
+{
+  Resources cpus1 = Resources::parse("cpus:2").get();
+  cpus1.allocate("role1");
+
+  Resources cpus2 = Resources::parse("cpus:1").get();
+  cpus2.allocate("role2");
+
+  Resources total = cpus1 + cpus2 + Resources::parse("cpus:4").get();
+  EXPECT_EQ(3u, total.size());
+  EXPECT_SOME_EQ(7.0, total.cpus());
+
+  EXPECT_TRUE(total.contains(cpus1));
+  EXPECT_TRUE(total.contains(cpus2));
+  EXPECT_FALSE(total.contains(cpus1 + cpus1));
+
+  total -= cpus1;
+  EXPECT_EQ(2u, total.size());
+  EXPECT_FALSE(total.contains(cpus1));
+
+  total.unallocate();
+  EXPECT_SOME_EQ(5.0, total.cpus());
+  EXPECT_TRUE(total.contains(Resources::parse("cpus:4").get()));
+
+  total.allocate("role1");
+  EXPECT_TRUE(total.contains(cpus1));
+}
+
+
 TEST(ResourcesTest, RangesEquals)
 {
   Resource ports1 = Resources::parse(
@@ -3037,6 +3069,43 @@ TEST(ResourcesTest, Count)
 }
 
 
+// Copies of a `Resources` object share the underlying `Resource`
+// objects; this verifies that mutating a copy leaves the original
+// (and any other copies) untouched.
+TEST(ResourcesTest, CopyOnWrite)
+{
+  Resources original = Resources::parse("cpus:2;mem:512;ports:[1-10]").get();
+
+  Resources added = original;
+  added += Resources::parse("cpus:1;ports:[11-20]").get();
+
+  Resources subtracted = original;
+  subtracted -= Resources::parse("cpus:1;mem:512").get();
+
+  Resources allocated = original;
+  allocated.allocate("role1");
+
+  EXPECT_EQ(Resources::parse("cpus:2;mem:512;ports:[1-10]").get(), original);
+  EXPECT_EQ(Resources::parse("cpus:3;mem:512;ports:[1-20]").get(), added);
+  EXPECT_EQ(Resources::parse("cpus:1;ports:[1-10]").get(), subtracted);
+
+  foreach (const Resource& resource, original) {
+    EXPECT_FALSE(resource.has_allocation_info());
+  }
+
+  foreach (const Resource& resource, allocated) {
+    EXPECT_TRUE(resource.has_allocation_info());
+  }
+
+  allocated.unallocate();
+  EXPECT_EQ(original, allocated);
+
+  // Moving leaves the moved-to object with the original contents.
+  Resources moved = std::move(added);
+  EXPECT_EQ(Resources::parse("cpus:3;mem:512;ports:[1-20]").get(), moved);
+}
+
+
 TEST(ResourcesTest, Evolve)
 {
   string resourcesString = "cpus(role1):2;mem(role1):10;cpus:4;mem:20";
@@ -3439,10 +3508,18 @@ public:
     shared.resources = Resources::parse("cpus:1;mem:128").get() + disk;
     shared.totalOperations = 50000;
 
+    // Test a typical vector of scalars allocated to a role, like the
+    // allocator sums up the resources allocated across agents.
+    ScalarArithmeticParameter allocated;
+    allocated.resources = scalars.resources;
+    allocated.resources.allocate("role");
+    allocated.totalOperations = 50000;
+
     parameters_.push_back(std::move(scalars));
     parameters_.push_back(std::move(reservations));
     parameters_.push_back(std::move(ranges));
     parameters_.push_back(std::move(shared));
+    parameters_.push_back(std::move(allocated));
 
     return parameters_;
   }
@@ -3630,6 +3707,15 @@ public:
     scalars3.superset = scalars1.subset;
     scalars3.totalOperations = 5000;
 
+    // Test a typical vector of scalars allocated to a role, the
+    // superset contains the subset for this case.
+    ContainsParameter allocated;
+    allocated.subset = scalars1.subset;
+    allocated.subset.allocate("role");
+    allocated.superset = scalars1.superset;
+    allocated.superset.allocate("role");
+    allocated.totalOperations = 5000;
+
     // TODO(bmahler): Increase the port range to [1-64,000] once
     // performance is improved such that this doesn't take a
     // long time to run.
@@ -3683,6 +3769,7 @@ public:
     parameters_.push_back(std::move(scalars1));
     parameters_.push_back(std::move(scalars2));
     parameters_.push_back(std::move(scalars3));
+    parameters_.push_back(std::move(allocated));
     parameters_.push_back(std::move(range1));
     parameters_.push_back(std::move(range2));
     parameters_.push_back(std::move(range3));
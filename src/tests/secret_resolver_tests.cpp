@@ -0,0 +1,136 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#include <string>
+
+#include <mesos/mesos.hpp>
+
+#include <mesos/secret/resolver.hpp>
+
+#include <process/clock.hpp>
+#include <process/future.hpp>
+#include <process/gtest.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/gtest.hpp>
+
+#include "secret/caching_resolver.hpp"
+
+using process::Clock;
+using process::Future;
+using process::Promise;
+
+using std::string;
+
+using testing::_;
+using testing::Return;
+
+namespace mesos {
+namespace internal {
+namespace tests {
+
+class MockSecretResolver : public SecretResolver
+{
+public:
+  MOCK_CONST_METHOD1(resolve, Future<Secret::Value>(const Secret&));
+};
+
+
+static Secret reference(const string& name)
+{
+  Secret secret;
+  secret.set_type(Secret::REFERENCE);
+  secret.mutable_reference()->set_name(name);
+  return secret;
+}
+
+
+static Secret::Value value(const string& data)
+{
+  Secret::Value value;
+  value.set_data(data);
+  return value;
+}
+
+
+// This test verifies that concurrent resolutions of the same reference
+// share a single call to the wrapped resolver.
+TEST(CachingSecretResolverTest, SharedResolution)
+{
+  MockSecretResolver* mock = new MockSecretResolver();
+
+  Promise<Secret::Value> promise;
+
+  EXPECT_CALL(*mock, resolve(_))
+    .WillOnce(Return(promise.future()))
+    .WillOnce(Return(value("other")));
+
+  CachingSecretResolver resolver(mock, None());
+
+  Future<Secret::Value> value1 = resolver.resolve(reference("secret"));
+  Future<Secret::Value> value2 = resolver.resolve(reference("secret"));
+  Future<Secret::Value> other = resolver.resolve(reference("other"));
+
+  AWAIT_READY(other);
+  EXPECT_EQ("other", other->data());
+
+  promise.set(value("secret"));
+
+  AWAIT_READY(value1);
+  AWAIT_READY(value2);
+  EXPECT_EQ("secret", value1->data());
+  EXPECT_EQ("secret", value2->data());
+}
+
+
+// This test verifies that resolved references are cached for the TTL.
+TEST(CachingSecretResolverTest, Cache)
+{
+  Clock::pause();
+
+  MockSecretResolver* mock = new MockSecretResolver();
+
+  EXPECT_CALL(*mock, resolve(_))
+    .WillOnce(Return(value("first")))
+    .WillOnce(Return(value("second")));
+
+  CachingSecretResolver resolver(mock, Minutes(1));
+
+  Future<Secret::Value> value1 = resolver.resolve(reference("secret"));
+  AWAIT_READY(value1);
+  EXPECT_EQ("first", value1->data());
+
+  // Wait for the resolution to be cached.
+  Clock::settle();
+
+  Future<Secret::Value> value2 = resolver.resolve(reference("secret"));
+  AWAIT_READY(value2);
+  EXPECT_EQ("first", value2->data());
+
+  Clock::advance(Minutes(1));
+
+  Future<Secret::Value> value3 = resolver.resolve(reference("secret"));
+  AWAIT_READY(value3);
+  EXPECT_EQ("second", value3->data());
+
+  Clock::resume();
+}
+
+} // namespace tests {
+} // namespace internal {
+} // namespace mesos {
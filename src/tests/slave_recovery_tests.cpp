@@ -651,26 +651,22 @@ TYPED_TEST(SlaveRecoveryTest, DISABLED_ROOT_CGROUPS_ReconnectDefaultExecutor)
   Future<v1::executor::Call> updateCall2 =
     DROP_HTTP_CALL(Call(), Call::UPDATE, _, ContentType::PROTOBUF);
 
-  Future<v1::agent::Call> waitCall1 = FUTURE_HTTP_CALL(
+  // The executor waits on both child containers with a single call.
+  Future<v1::agent::Call> waitCall = FUTURE_HTTP_CALL(
       v1::agent::Call(),
-      v1::agent::Call::WAIT_NESTED_CONTAINER,
-      _,
-      ContentType::PROTOBUF);
-
-  Future<v1::agent::Call> waitCall2 = FUTURE_HTTP_CALL(
-      v1::agent::Call(),
-      v1::agent::Call::WAIT_NESTED_CONTAINER,
+      v1::agent::Call::WATCH_NESTED_CONTAINERS,
       _,
       ContentType::PROTOBUF);
 
   // Stop the agent after dropping the update calls and upon receiving the
-  // wait calls. We can't drop the wait calls as doing so results in a
+  // wait call. We can't drop the wait call as doing so results in a
   // '500 Interval Server Error' for the default executor leading to it
   // failing fast.
   AWAIT_READY(updateCall1);
   AWAIT_READY(updateCall2);
-  AWAIT_READY(waitCall1);
-  AWAIT_READY(waitCall2);
+  AWAIT_READY(waitCall);
+
+  EXPECT_EQ(2, waitCall->watch_nested_containers().container_ids_size());
 
   slave.get()->terminate();
 
@@ -3702,7 +3698,7 @@ TYPED_TEST(SlaveRecoveryTest, ReconcileTasksMissingFromSlave)
 {
   TestAllocator<master::allocator::HierarchicalDRFAllocator> allocator;
 
-  EXPECT_CALL(allocator, initialize(_, _, _, _, _, _));
+  EXPECT_CALL(allocator, initialize(_, _, _, _, _, _, _, _, _));
 
   Try<Owned<cluster::Master>> master = this->StartMaster(&allocator);
   ASSERT_SOME(master);
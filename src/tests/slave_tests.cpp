@@ -1748,6 +1748,64 @@ TEST_F(SlaveTest, StateEndpoint)
 }
 
 
+// This ensures that the agent serves a cached rendering of its /state
+// endpoint within `--state_cache_max_staleness`, even though its state
+// has changed in the meantime.
+TEST_F(SlaveTest, StateEndpointCache)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  slave::Flags agentFlags = CreateSlaveFlags();
+  agentFlags.state_cache_max_staleness = Days(1);
+
+  Clock::pause();
+
+  Future<Nothing> __recover = FUTURE_DISPATCH(_, &Slave::__recover);
+
+  Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+    FUTURE_PROTOBUF(SlaveRegisteredMessage(), _, _);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get(), agentFlags);
+  ASSERT_SOME(slave);
+
+  AWAIT_READY(__recover);
+  Clock::settle();
+
+  auto id = [&slave]() -> string {
+    Future<Response> response = process::http::get(
+        slave.get()->pid,
+        "state",
+        None(),
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+
+    Try<JSON::Object> parse = JSON::parse<JSON::Object>(response->body);
+    CHECK_SOME(parse);
+
+    Result<JSON::String> id = parse->find<JSON::String>("id");
+    CHECK_SOME(id);
+
+    return id->value;
+  };
+
+  // The agent has not registered yet.
+  EXPECT_EQ("", id());
+
+  Clock::advance(agentFlags.registration_backoff_factor);
+
+  AWAIT_READY(slaveRegisteredMessage);
+  ASSERT_NE("", slaveRegisteredMessage->slave_id().value());
+
+  // The cached (stale) rendering is served.
+  EXPECT_EQ("", id());
+
+  Clock::resume();
+}
+
+
 // Verifies that requests to the agent's '/state' endpoint are successful when
 // there are pending tasks from a task group. This test was used to confirm the
 // fix for MESOS-7871.
@@ -4667,6 +4725,195 @@ TEST_F(SlaveTest, ReregisterWithStatusUpdateTaskState)
 }
 
 
+// This test verifies that an agent re-registering with a master that
+// knows about its tasks only sends digests of them, and that the
+// master reconciles the agent using its own view of the tasks.
+TEST_F(SlaveTest, ReregisterWithDigests)
+{
+  Clock::pause();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  MockExecutor exec(DEFAULT_EXECUTOR_ID);
+  TestContainerizer containerizer(&exec);
+
+  // Create a StandaloneMasterDetector to enable the slave to trigger
+  // re-registration later.
+  StandaloneMasterDetector detector(master.get()->pid);
+
+  slave::Flags agentFlags = CreateSlaveFlags();
+  agentFlags.reregistration_digests = true;
+
+  Try<Owned<cluster::Slave>> slave =
+    StartSlave(&detector, &containerizer, agentFlags);
+  ASSERT_SOME(slave);
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(&driver, _, _));
+
+  EXPECT_CALL(sched, resourceOffers(_, _))
+    .WillOnce(LaunchTasks(DEFAULT_EXECUTOR_INFO, 1, 2, 1024, "*"))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  EXPECT_CALL(exec, registered(_, _, _, _));
+
+  EXPECT_CALL(exec, launchTask(_, _))
+    .WillOnce(SendStatusUpdateFromTask(TASK_RUNNING));
+
+  Future<TaskStatus> status;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&status));
+
+  driver.start();
+
+  Clock::advance(masterFlags.allocation_interval);
+
+  AWAIT_READY(status);
+  EXPECT_EQ(TASK_RUNNING, status->state());
+
+  Future<ReregisterSlaveMessage> reregisterSlaveMessage =
+    FUTURE_PROTOBUF(ReregisterSlaveMessage(), _, _);
+
+  Future<SlaveReregisteredMessage> slaveReregisteredMessage =
+    FUTURE_PROTOBUF(SlaveReregisteredMessage(), _, _);
+
+  // The digest matches the master's view of the agent, so the master
+  // should not ask for the tasks and executors.
+  EXPECT_NO_FUTURE_PROTOBUFS(ReregisterSlaveDetailsMessage(), _, _);
+
+  // Simulate a new master detected event on the slave,
+  // so that the slave will do a re-registration.
+  detector.appoint(master.get()->pid);
+
+  // Force evaluation of master detection before we advance clock to trigger
+  // agent registration.
+  Clock::settle();
+
+  Clock::advance(agentFlags.registration_backoff_factor);
+  AWAIT_READY(reregisterSlaveMessage);
+
+  EXPECT_EQ(1, reregisterSlaveMessage->frameworks_size());
+  EXPECT_EQ(1, reregisterSlaveMessage->framework_digests_size());
+  EXPECT_EQ(0, reregisterSlaveMessage->tasks_size());
+  EXPECT_EQ(0, reregisterSlaveMessage->executor_infos_size());
+
+  AWAIT_READY(slaveReregisteredMessage);
+
+  // The master should not reconcile the task.
+  EXPECT_EQ(0, slaveReregisteredMessage->reconciliations_size());
+
+  Clock::settle();
+
+  EXPECT_CALL(exec, shutdown(_))
+    .Times(AtMost(1));
+
+  driver.stop();
+  driver.join();
+}
+
+
+// This test verifies that when flush intervals are configured, the
+// agent forwards status updates to the master in batches and the
+// master forwards the acknowledgements back to the agent in batches.
+TEST_F(SlaveTest, StatusUpdateBatches)
+{
+  Clock::pause();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.status_update_acknowledgement_flush_interval = Milliseconds(50);
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  MockExecutor exec(DEFAULT_EXECUTOR_ID);
+  TestContainerizer containerizer(&exec);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+
+  slave::Flags agentFlags = CreateSlaveFlags();
+  agentFlags.status_update_flush_interval = Milliseconds(50);
+
+  Try<Owned<cluster::Slave>> slave =
+    StartSlave(detector.get(), &containerizer, agentFlags);
+  ASSERT_SOME(slave);
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(&driver, _, _));
+
+  EXPECT_CALL(sched, resourceOffers(_, _))
+    .WillOnce(LaunchTasks(DEFAULT_EXECUTOR_INFO, 1, 2, 1024, "*"))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  EXPECT_CALL(exec, registered(_, _, _, _));
+
+  EXPECT_CALL(exec, launchTask(_, _))
+    .WillOnce(SendStatusUpdateFromTask(TASK_RUNNING));
+
+  Future<TaskStatus> status;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&status));
+
+  // No update or acknowledgement should be forwarded on its own.
+  EXPECT_NO_FUTURE_PROTOBUFS(StatusUpdateMessage(), _, master.get()->pid);
+  EXPECT_NO_FUTURE_PROTOBUFS(
+      StatusUpdateAcknowledgementMessage(), master.get()->pid, _);
+
+  Future<StatusUpdatesMessage> statusUpdatesMessage =
+    FUTURE_PROTOBUF(StatusUpdatesMessage(), _, master.get()->pid);
+
+  Future<StatusUpdateAcknowledgementsMessage> acknowledgementsMessage =
+    FUTURE_PROTOBUF(
+        StatusUpdateAcknowledgementsMessage(), master.get()->pid, _);
+
+  Future<Nothing> _statusUpdateAcknowledgement =
+    FUTURE_DISPATCH(_, &Slave::_statusUpdateAcknowledgement);
+
+  driver.start();
+
+  Clock::advance(masterFlags.allocation_interval);
+  Clock::settle();
+
+  // The update is held back until the flush interval elapses.
+  EXPECT_TRUE(statusUpdatesMessage.isPending());
+
+  Clock::advance(agentFlags.status_update_flush_interval);
+
+  AWAIT_READY(statusUpdatesMessage);
+  ASSERT_EQ(1, statusUpdatesMessage->updates_size());
+  EXPECT_EQ(TASK_RUNNING,
+            statusUpdatesMessage->updates(0).update().status().state());
+
+  AWAIT_READY(status);
+  EXPECT_EQ(TASK_RUNNING, status->state());
+
+  Clock::settle();
+  EXPECT_TRUE(acknowledgementsMessage.isPending());
+
+  Clock::advance(masterFlags.status_update_acknowledgement_flush_interval);
+
+  AWAIT_READY(acknowledgementsMessage);
+  ASSERT_EQ(1, acknowledgementsMessage->acknowledgements_size());
+  EXPECT_EQ(status->task_id(),
+            acknowledgementsMessage->acknowledgements(0).task_id());
+
+  AWAIT_READY(_statusUpdateAcknowledgement);
+
+  EXPECT_CALL(exec, shutdown(_))
+    .Times(AtMost(1));
+
+  driver.stop();
+  driver.join();
+}
+
+
 // This test verifies that the slave should properly handle the case
 // where the containerizer usage call fails when getting the usage
 // information.
@@ -4748,6 +4995,115 @@ TEST_F(SlaveTest, ContainerizerUsageFailure)
 }
 
 
+// This test verifies that the agent reuses the statistics of a
+// container within `--container_usage_cache_ttl`.
+TEST_F(SlaveTest, ContainerUsageCache)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  MockExecutor exec(DEFAULT_EXECUTOR_ID);
+  TestContainerizer containerizer(&exec);
+  StandaloneMasterDetector detector(master.get()->pid);
+
+  slave::Flags flags = CreateSlaveFlags();
+  flags.container_usage_cache_ttl = Seconds(10);
+
+  Try<Owned<cluster::Slave>> slave = StartSlave(
+      &detector,
+      &containerizer,
+      flags,
+      true);
+
+  ASSERT_SOME(slave);
+  ASSERT_NE(nullptr, slave.get()->mock());
+
+  slave.get()->start();
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(_, _, _));
+  EXPECT_CALL(exec, registered(_, _, _, _));
+
+  Future<vector<Offer>> offers;
+
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  driver.start();
+
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->empty());
+
+  const Offer& offer = offers.get()[0];
+
+  TaskInfo task = createTask(
+      offer.slave_id(),
+      Resources::parse("cpus:0.1;mem:32").get(),
+      SLEEP_COMMAND(1000),
+      exec.id);
+
+  EXPECT_CALL(exec, launchTask(_, _))
+    .WillOnce(SendStatusUpdateFromTask(TASK_RUNNING));
+
+  Future<TaskStatus> status;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&status));
+
+  driver.launchTasks(offer.id(), {task});
+
+  AWAIT_READY(status);
+  EXPECT_EQ(TASK_RUNNING, status->state());
+
+  ResourceStatistics statistics1;
+  statistics1.set_timestamp(1);
+
+  ResourceStatistics statistics2;
+  statistics2.set_timestamp(2);
+
+  EXPECT_CALL(containerizer, usage(_))
+    .WillOnce(Return(statistics1))
+    .WillOnce(Return(statistics2));
+
+  Clock::pause();
+
+  Future<ResourceUsage> usage = slave.get()->mock()->usage();
+
+  AWAIT_READY(usage);
+  ASSERT_EQ(1, usage->executors_size());
+  EXPECT_EQ(1, usage->executors(0).statistics().timestamp());
+
+  // The statistics should be reused within the TTL.
+  Clock::advance(Seconds(5));
+
+  usage = slave.get()->mock()->usage();
+
+  AWAIT_READY(usage);
+  ASSERT_EQ(1, usage->executors_size());
+  EXPECT_EQ(1, usage->executors(0).statistics().timestamp());
+
+  // The statistics should be collected again after the TTL.
+  Clock::advance(Seconds(5));
+
+  usage = slave.get()->mock()->usage();
+
+  AWAIT_READY(usage);
+  ASSERT_EQ(1, usage->executors_size());
+  EXPECT_EQ(2, usage->executors(0).statistics().timestamp());
+
+  Clock::resume();
+
+  EXPECT_CALL(exec, shutdown(_))
+    .Times(AtMost(1));
+
+  driver.stop();
+  driver.join();
+}
+
+
 // This test verifies that DiscoveryInfo and Port messages, set in TaskInfo,
 // are exposed over the slave state endpoint. The test launches a task with
 // the DiscoveryInfo and Port message fields populated. It then makes an HTTP
@@ -365,6 +365,90 @@ TEST(AgentCallValidationTest, WaitNestedContainer)
 }
 
 
+TEST(AgentCallValidationTest, WatchNestedContainers)
+{
+  // Missing `watch_nested_containers`.
+  agent::Call call;
+  call.set_type(agent::Call::WATCH_NESTED_CONTAINERS);
+
+  Option<Error> error = validation::agent::call::validate(call);
+  EXPECT_SOME(error);
+
+  agent::Call::WatchNestedContainers* watch =
+    call.mutable_watch_nested_containers();
+
+  ContainerID parentContainerId;
+  parentContainerId.set_value(UUID::random().toString());
+
+  ContainerID containerId1;
+  containerId1.set_value(UUID::random().toString());
+  containerId1.mutable_parent()->CopyFrom(parentContainerId);
+
+  watch->add_container_ids()->CopyFrom(containerId1);
+
+  error = validation::agent::call::validate(call);
+  EXPECT_NONE(error);
+
+  // Expecting a `parent` for each of the containers.
+  ContainerID containerId2;
+  containerId2.set_value(UUID::random().toString());
+
+  watch->add_container_ids()->CopyFrom(containerId2);
+
+  error = validation::agent::call::validate(call);
+  EXPECT_SOME(error);
+}
+
+
+TEST(AgentCallValidationTest, LaunchNestedContainers)
+{
+  // Missing `launch_nested_containers`.
+  agent::Call call;
+  call.set_type(agent::Call::LAUNCH_NESTED_CONTAINERS);
+
+  Option<Error> error = validation::agent::call::validate(call);
+  EXPECT_SOME(error);
+
+  agent::Call::LaunchNestedContainers* launches =
+    call.mutable_launch_nested_containers();
+
+  ContainerID parentContainerId;
+  parentContainerId.set_value(UUID::random().toString());
+
+  ContainerID containerId1;
+  containerId1.set_value(UUID::random().toString());
+  containerId1.mutable_parent()->CopyFrom(parentContainerId);
+
+  launches->add_containers()->mutable_container_id()->CopyFrom(containerId1);
+
+  error = validation::agent::call::validate(call);
+  EXPECT_NONE(error);
+
+  // The containers are validated like for `LAUNCH_NESTED_CONTAINER`,
+  // e.g., expecting a `parent`.
+  ContainerID containerId2;
+  containerId2.set_value(UUID::random().toString());
+
+  agent::Call::LaunchNestedContainer* launch = launches->add_containers();
+  launch->mutable_container_id()->CopyFrom(containerId2);
+
+  error = validation::agent::call::validate(call);
+  EXPECT_SOME(error);
+
+  // Expecting distinct container IDs.
+  launch->mutable_container_id()->CopyFrom(containerId1);
+
+  error = validation::agent::call::validate(call);
+  EXPECT_SOME(error);
+
+  containerId2.mutable_parent()->CopyFrom(parentContainerId);
+  launch->mutable_container_id()->CopyFrom(containerId2);
+
+  error = validation::agent::call::validate(call);
+  EXPECT_NONE(error);
+}
+
+
 TEST(AgentCallValidationTest, KillNestedContainer)
 {
   // Missing `kill_nested_container`.
@@ -14,23 +14,35 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <gmock/gmock.h>
 
 #include <mesos/resources.hpp>
 
+#include <process/owned.hpp>
+
 #include <stout/gtest.hpp>
+#include <stout/hashmap.hpp>
+
+#include <stout/tests/benchmark.hpp>
 
+#include "master/allocator/sorter/bucketed/sorter.hpp"
 #include "master/allocator/sorter/drf/sorter.hpp"
 
 #include "tests/mesos.hpp"
 #include "tests/resources_utils.hpp"
 
+using mesos::internal::master::allocator::BucketedDRFSorter;
 using mesos::internal::master::allocator::DRFSorter;
 
+using process::Owned;
+
 using std::cout;
 using std::endl;
 using std::string;
@@ -1074,6 +1086,67 @@ TEST(SorterTest, AllocationForInactiveClient)
 }
 
 
+// This test checks that the sorter keeps clients in the correct order
+// when allocations change in between calls to `sort()`, i.e., when
+// clients are repositioned incrementally rather than by resorting the
+// whole tree.
+TEST(SorterTest, IncrementalSort)
+{
+  DRFSorter sorter;
+
+  SlaveID slaveId;
+  slaveId.set_value("agentId");
+
+  sorter.add(slaveId, Resources::parse("cpus:100;mem:100").get());
+
+  sorter.add("a/x");
+  sorter.activate("a/x");
+
+  sorter.add("a/y");
+  sorter.activate("a/y");
+
+  sorter.add("b");
+  sorter.activate("b");
+
+  EXPECT_EQ(vector<string>({"a/x", "a/y", "b"}), sorter.sort());
+
+  // shares: a = .1, a/x = .1, a/y = 0, b = 0
+  sorter.allocated("a/x", slaveId, Resources::parse("cpus:10").get());
+  EXPECT_EQ(vector<string>({"b", "a/y", "a/x"}), sorter.sort());
+
+  // shares: a = .1, a/x = .1, a/y = 0, b = .2
+  sorter.allocated("b", slaveId, Resources::parse("cpus:20").get());
+  EXPECT_EQ(vector<string>({"a/y", "a/x", "b"}), sorter.sort());
+
+  // shares: a = .15, a/x = .1, a/y = .05, b = .2
+  sorter.allocated("a/y", slaveId, Resources::parse("cpus:5").get());
+  EXPECT_EQ(vector<string>({"a/y", "a/x", "b"}), sorter.sort());
+
+  // shares: a = .05, a/x = 0, a/y = .05, b = .2
+  sorter.unallocated("a/x", slaveId, Resources::parse("cpus:10").get());
+  EXPECT_EQ(vector<string>({"a/x", "a/y", "b"}), sorter.sort());
+
+  // Allocations to an inactive client still affect its ancestors.
+  //
+  // shares: a = .35, a/x = .3, a/y = .05, b = .2
+  sorter.deactivate("a/x");
+  sorter.allocated("a/x", slaveId, Resources::parse("cpus:30").get());
+  EXPECT_EQ(vector<string>({"b", "a/y"}), sorter.sort());
+
+  sorter.activate("a/x");
+  EXPECT_EQ(vector<string>({"b", "a/y", "a/x"}), sorter.sort());
+
+  // shares: a = .35, a/x = .3, a/y = .05, b = .4
+  sorter.update(
+      "b",
+      slaveId,
+      Resources::parse("cpus:20").get(),
+      Resources::parse("cpus:40").get());
+
+  EXPECT_EQ(vector<string>({"a/y", "a/x", "b"}), sorter.sort());
+}
+
+
 // We aggregate resources from multiple slaves into the sorter.
 // Since non-scalar resources don't aggregate well across slaves,
 // we need to keep track of the SlaveIDs of the resources. This
@@ -1550,6 +1623,143 @@ TEST(SorterTest, RemoveSharedResources)
 }
 
 
+// This test verifies that the sorter tracks the name-keyed quantities
+// of the total and allocated resources, aggregating across agents and
+// reservations.
+TEST(SorterTest, Quantities)
+{
+  DRFSorter sorter;
+
+  SlaveID slaveA;
+  slaveA.set_value("agentA");
+
+  SlaveID slaveB;
+  slaveB.set_value("agentB");
+
+  sorter.add("a");
+
+  sorter.add(slaveA, Resources::parse("cpus:4;mem(role1):100").get());
+  sorter.add(slaveB, Resources::parse("cpus:6;mem:100;ports:[1-10]").get());
+
+  EXPECT_EQ(
+      ResourceQuantities::fromString("cpus:10;mem:200").get(),
+      sorter.totalQuantities());
+
+  sorter.allocated("a", slaveA, Resources::parse("cpus:1").get());
+  sorter.allocated("a", slaveB, Resources::parse("cpus:2;mem:50").get());
+
+  EXPECT_EQ(
+      ResourceQuantities::fromString("cpus:3;mem:50").get(),
+      sorter.allocationQuantities("a"));
+
+  sorter.unallocated("a", slaveB, Resources::parse("cpus:2;mem:50").get());
+
+  EXPECT_EQ(
+      ResourceQuantities::fromString("cpus:1").get(),
+      sorter.allocationQuantities("a"));
+
+  sorter.remove(slaveA, Resources::parse("cpus:4;mem(role1):100").get());
+
+  EXPECT_EQ(
+      ResourceQuantities::fromString("cpus:6;mem:100").get(),
+      sorter.totalQuantities());
+}
+
+
+// This test verifies that the bucketed DRF sorter orders the buckets
+// by share, and rotates through the clients of a bucket.
+TEST(SorterTest, BucketedDRFSorter)
+{
+  BucketedDRFSorter sorter(BucketedDRFSorter::FIXED_WIDTH, 0.05);
+
+  SlaveID slaveId;
+  slaveId.set_value("agentId");
+
+  sorter.add(slaveId, Resources::parse("cpus:100;mem:100").get());
+
+  foreach (const string& client, vector<string>({"a", "b", "c", "d"})) {
+    sorter.add(client);
+    sorter.activate(client);
+  }
+
+  sorter.allocated("a", slaveId, Resources::parse("cpus:12;mem:1").get());
+  sorter.allocated("b", slaveId, Resources::parse("cpus:13;mem:1").get());
+  sorter.allocated("c", slaveId, Resources::parse("cpus:33;mem:1").get());
+
+  // Buckets: d = none, a, b = 2 (.12, .13), c = 6 (.33).
+  EXPECT_EQ(vector<string>({"d", "a", "b", "c"}), sorter.sort());
+  EXPECT_EQ(vector<string>({"d", "b", "a", "c"}), sorter.sort());
+  EXPECT_EQ(vector<string>({"d", "a", "b", "c"}), sorter.sort());
+
+  // Buckets: d = none, b = 2 (.13), a = 4 (.22), c = 6 (.33).
+  sorter.allocated("a", slaveId, Resources::parse("cpus:10").get());
+  EXPECT_EQ(vector<string>({"d", "b", "a", "c"}), sorter.sort());
+
+  sorter.deactivate("b");
+  EXPECT_EQ(vector<string>({"d", "a", "c"}), sorter.sort());
+
+  // Buckets: d = none, c = 0 (.033), a = 4 (.22).
+  sorter.updateWeight("c", 10);
+  EXPECT_EQ(vector<string>({"d", "c", "a"}), sorter.sort());
+
+  // Doubling the total halves the shares. Buckets: d = none,
+  // c = 0 (.0165), b = 1 (.065), a = 2 (.11).
+  sorter.add(slaveId, Resources::parse("cpus:100;mem:100").get());
+  sorter.activate("b");
+  EXPECT_EQ(vector<string>({"d", "c", "b", "a"}), sorter.sort());
+
+  sorter.unallocated("a", slaveId, Resources::parse("cpus:22;mem:1").get());
+  EXPECT_EQ(vector<string>({"d", "a", "c", "b"}), sorter.sort());
+
+  sorter.remove("d");
+  EXPECT_FALSE(sorter.contains("d"));
+  EXPECT_EQ(3, sorter.count());
+  EXPECT_EQ(vector<string>({"a", "c", "b"}), sorter.sort());
+}
+
+
+// This test verifies that the logarithmic buckets of the bucketed DRF
+// sorter group clients of shares within 5% of each other, and that
+// shared resources only count once towards the share of a client.
+TEST(SorterTest, BucketedDRFSorterLogarithmic)
+{
+  BucketedDRFSorter sorter;
+
+  SlaveID slaveId;
+  slaveId.set_value("agentId");
+
+  Resource sharedDisk = createDiskResource(
+      "40", "role1", "id1", "path1", None(), true);
+
+  Resources totalResources = Resources::parse(
+      "cpus:100;mem:100;disk(role1):60").get();
+  totalResources += sharedDisk;
+
+  sorter.add(slaveId, totalResources);
+
+  sorter.add("a");
+  sorter.activate("a");
+  sorter.allocated("a", slaveId, Resources::parse("cpus:41").get());
+
+  // Two copies of the shared disk of 40% of the total disk.
+  sorter.add("b");
+  sorter.activate("b");
+  sorter.allocated("b", slaveId, sharedDisk);
+  sorter.allocated("b", slaveId, sharedDisk);
+
+  sorter.add("c");
+  sorter.activate("c");
+  sorter.allocated("c", slaveId, Resources::parse("cpus:60").get());
+
+  EXPECT_EQ(vector<string>({"a", "b", "c"}), sorter.sort());
+  EXPECT_EQ(vector<string>({"b", "a", "c"}), sorter.sort());
+
+  EXPECT_EQ(
+      ResourceQuantities::fromString("disk:40").get(),
+      sorter.allocationQuantities("b"));
+}
+
+
 class Sorter_BENCHMARK_Test
   : public ::testing::Test,
     public ::testing::WithParamInterface<std::tuple<size_t, size_t>> {};
@@ -1576,6 +1786,10 @@ TEST_P(Sorter_BENCHMARK_Test, FullSort)
   cout << "Using " << agentCount << " agents and "
        << clientCount << " clients" << endl;
 
+  BenchmarkReport report;
+  report.parameter("agents", agentCount);
+  report.parameter("clients", clientCount);
+
   vector<SlaveID> agents;
   agents.reserve(agentCount);
 
@@ -1599,6 +1813,7 @@ TEST_P(Sorter_BENCHMARK_Test, FullSort)
 
   cout << "Added " << clientCount << " clients in "
        << watch.elapsed() << endl;
+  report.sample("add_clients", watch.elapsed());
 
   Resources agentResources = Resources::parse(
       "cpus:24;mem:4096;disk:4096;ports:[31000-32000]").get();
@@ -1618,6 +1833,7 @@ TEST_P(Sorter_BENCHMARK_Test, FullSort)
 
   cout << "Added " << agentCount << " agents in "
        << watch.elapsed() << endl;
+  report.sample("add_agents", watch.elapsed());
 
   Resources allocated = Resources::parse(
       "cpus:16;mem:2014;disk:1024").get();
@@ -1642,6 +1858,7 @@ TEST_P(Sorter_BENCHMARK_Test, FullSort)
 
   cout << "Added allocations for " << agentCount << " agents in "
          << watch.elapsed() << endl;
+  report.sample("allocated", watch.elapsed());
 
   watch.start();
   {
@@ -1651,6 +1868,7 @@ TEST_P(Sorter_BENCHMARK_Test, FullSort)
 
   cout << "Full sort of " << clientCount << " clients took "
        << watch.elapsed() << endl;
+  report.sample("full_sort", watch.elapsed());
 
   watch.start();
   {
@@ -1660,6 +1878,7 @@ TEST_P(Sorter_BENCHMARK_Test, FullSort)
 
   cout << "No-op sort of " << clientCount << " clients took "
        << watch.elapsed() << endl;
+  report.sample("noop_sort", watch.elapsed());
 
   watch.start();
   {
@@ -1674,6 +1893,7 @@ TEST_P(Sorter_BENCHMARK_Test, FullSort)
 
   cout << "Removed allocations for " << agentCount << " agents in "
          << watch.elapsed() << endl;
+  report.sample("unallocated", watch.elapsed());
 
   watch.start();
   {
@@ -1685,6 +1905,7 @@ TEST_P(Sorter_BENCHMARK_Test, FullSort)
 
   cout << "Removed " << agentCount << " agents in "
        << watch.elapsed() << endl;
+  report.sample("remove_agents", watch.elapsed());
 
   watch.start();
   {
@@ -1696,6 +1917,9 @@ TEST_P(Sorter_BENCHMARK_Test, FullSort)
 
   cout << "Removed " << clientCount << " clients in "
        << watch.elapsed() << endl;
+  report.sample("remove_clients", watch.elapsed());
+
+  report.write();
 }
 
 
@@ -1877,6 +2101,252 @@ TEST_P(HierarchicalSorter_BENCHMARK_Test, FullSort)
        << watch.elapsed() << endl;
 }
 
+class HierarchicalSorterChurn_BENCHMARK_Test
+  : public ::testing::Test,
+    public ::testing::WithParamInterface<
+        std::tuple<size_t, size_t, size_t, size_t, size_t, bool>> {};
+
+
+// The value tuples are defined as:
+// - roleCount (leaf roles)
+// - roleDepth (levels of the role hierarchy)
+// - frameworkCount
+// - agentCount
+// - churn (percent of the agents reallocated per cycle)
+// - shared (whether the allocations include a shared volume)
+INSTANTIATE_TEST_CASE_P(
+    RoleFrameworkAgentCount,
+    HierarchicalSorterChurn_BENCHMARK_Test,
+    ::testing::Values(
+        std::make_tuple(100U, 2U, 1000U, 10000U, 10U, false),
+        std::make_tuple(400U, 4U, 5000U, 30000U, 10U, false),
+        std::make_tuple(400U, 4U, 5000U, 30000U, 10U, true)));
+
+
+// This benchmark models the sorters of the hierarchical allocator in a
+// large cluster: a role sorter with weighted leaf roles several levels
+// deep, and a framework sorter for each role. Each cycle moves the
+// allocations of a share of the agents to other frameworks, and then
+// sorts the role sorter and all the framework sorters, as an
+// allocation cycle would. The costs of the operations are reported
+// per cycle.
+TEST_P(HierarchicalSorterChurn_BENCHMARK_Test, Churn)
+{
+  size_t roleCount;
+  size_t roleDepth;
+  size_t frameworkCount;
+  size_t agentCount;
+  size_t churn;
+  bool shared;
+
+  std::tie(roleCount, roleDepth, frameworkCount, agentCount, churn, shared) =
+    GetParam();
+
+  const size_t cycles = 10;
+
+  cout << "Using " << roleCount << " roles " << roleDepth << " levels deep, "
+       << frameworkCount << " frameworks and " << agentCount << " agents"
+       << (shared ? " with shared volumes" : "") << endl;
+
+  BenchmarkReport report;
+  report.parameter("roles", roleCount);
+  report.parameter("role_depth", roleDepth);
+  report.parameter("frameworks", frameworkCount);
+  report.parameter("agents", agentCount);
+  report.parameter("churn", churn);
+  report.parameter("shared", shared);
+
+  // The smallest branching factor giving enough distinct role paths.
+  size_t branchingFactor = 1;
+  while (std::pow(branchingFactor, roleDepth) < roleCount) {
+    branchingFactor++;
+  }
+
+  // Name the roles after the digits of their index in the branching
+  // factor, e.g., "r1/r0/r3/r2".
+  vector<string> roles;
+  roles.reserve(roleCount);
+
+  for (size_t i = 0; i < roleCount; i++) {
+    vector<string> components;
+
+    size_t index = i;
+    for (size_t level = 0; level < roleDepth; level++) {
+      components.push_back("r" + stringify(index % branchingFactor));
+      index /= branchingFactor;
+    }
+
+    roles.push_back(strings::join("/", components));
+  }
+
+  Resources agentResources = Resources::parse(
+      "cpus:24;mem:4096;disk:4096;ports:[31000-32000]").get();
+
+  Resources allocation = Resources::parse("cpus:16;mem:2014;disk:1024").get();
+
+  // The allocations of each role, which include a volume shared by the
+  // frameworks of the role if requested.
+  hashmap<string, Resources> allocations;
+  foreach (const string& role, roles) {
+    allocations[role] = allocation;
+
+    if (shared) {
+      allocations[role] += createDiskResource(
+          "64", role, "volume", "path", None(), true);
+    }
+  }
+
+  DRFSorter roleSorter;
+  hashmap<string, Owned<DRFSorter>> frameworkSorters;
+
+  Stopwatch watch;
+
+  watch.start();
+  {
+    for (size_t i = 0; i < roleCount; i++) {
+      roleSorter.add(roles[i]);
+      roleSorter.activate(roles[i]);
+      roleSorter.updateWeight(roles[i], 1.0 + i % 4);
+
+      frameworkSorters[roles[i]].reset(new DRFSorter());
+    }
+
+    for (size_t i = 0; i < frameworkCount; i++) {
+      const string framework = "framework" + stringify(i);
+      DRFSorter* frameworkSorter = frameworkSorters[roles[i % roleCount]].get();
+
+      frameworkSorter->add(framework);
+      frameworkSorter->activate(framework);
+    }
+  }
+  watch.stop();
+
+  cout << "Added " << roleCount << " roles and " << frameworkCount
+       << " frameworks in " << watch.elapsed() << endl;
+
+  vector<SlaveID> agents;
+  agents.reserve(agentCount);
+
+  watch.start();
+  {
+    for (size_t i = 0; i < agentCount; i++) {
+      SlaveID slaveId;
+      slaveId.set_value("agent" + stringify(i));
+
+      agents.push_back(slaveId);
+
+      roleSorter.add(slaveId, agentResources);
+
+      foreachvalue (const Owned<DRFSorter>& frameworkSorter,
+                    frameworkSorters) {
+        frameworkSorter->add(slaveId, agentResources);
+      }
+    }
+  }
+  watch.stop();
+
+  cout << "Added " << agentCount << " agents in " << watch.elapsed() << endl;
+
+  // The index of the framework each agent is allocated to.
+  vector<size_t> owners(agentCount);
+
+  auto allocate = [&](size_t agent, size_t framework) {
+    const string& role = roles[framework % roleCount];
+
+    roleSorter.allocated(role, agents[agent], allocations.at(role));
+
+    frameworkSorters.at(role)->allocated(
+        "framework" + stringify(framework),
+        agents[agent],
+        allocations.at(role));
+
+    owners[agent] = framework;
+  };
+
+  auto unallocate = [&](size_t agent) {
+    const size_t framework = owners[agent];
+    const string& role = roles[framework % roleCount];
+
+    roleSorter.unallocated(role, agents[agent], allocations.at(role));
+
+    frameworkSorters.at(role)->unallocated(
+        "framework" + stringify(framework),
+        agents[agent],
+        allocations.at(role));
+  };
+
+  watch.start();
+  {
+    for (size_t i = 0; i < agentCount; i++) {
+      allocate(i, i % frameworkCount);
+    }
+  }
+  watch.stop();
+
+  cout << "Added allocations for " << agentCount << " agents in "
+       << watch.elapsed() << endl;
+
+  const size_t churned = std::max<size_t>(1, agentCount * churn / 100);
+
+  for (size_t cycle = 0; cycle < cycles; cycle++) {
+    // Reallocate a different range of agents in each cycle.
+    const size_t first = (cycle * churned) % agentCount;
+
+    watch.start();
+    {
+      for (size_t i = 0; i < churned; i++) {
+        unallocate((first + i) % agentCount);
+      }
+    }
+    watch.stop();
+
+    const Duration unallocated = watch.elapsed();
+
+    watch.start();
+    {
+      for (size_t i = 0; i < churned; i++) {
+        const size_t agent = (first + i) % agentCount;
+        allocate(agent, (owners[agent] + 1) % frameworkCount);
+      }
+    }
+    watch.stop();
+
+    const Duration allocated = watch.elapsed();
+
+    watch.start();
+    {
+      roleSorter.sort();
+    }
+    watch.stop();
+
+    const Duration roleSort = watch.elapsed();
+
+    watch.start();
+    {
+      foreachvalue (const Owned<DRFSorter>& frameworkSorter,
+                    frameworkSorters) {
+        frameworkSorter->sort();
+      }
+    }
+    watch.stop();
+
+    const Duration frameworkSort = watch.elapsed();
+
+    cout << "Cycle " << cycle << ": reallocated " << churned << " agents in "
+         << unallocated + allocated << " (" << unallocated / churned
+         << " per unallocation, " << allocated / churned
+         << " per allocation), sorted the roles in " << roleSort
+         << " and the frameworks in " << frameworkSort << endl;
+
+    report.sample("unallocated_per_op", unallocated / churned);
+    report.sample("allocated_per_op", allocated / churned);
+    report.sample("role_sort", roleSort);
+    report.sample("framework_sort", frameworkSort);
+  }
+
+  report.write();
+}
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
@@ -77,6 +77,8 @@ using mesos::state::ZooKeeperStorage;
 using mesos::state::protobuf::State;
 using mesos::state::protobuf::Variable;
 
+using mesos::internal::state::Batch;
+using mesos::internal::state::Entry;
 using mesos::internal::state::Operation;
 
 namespace mesos {
@@ -324,6 +326,97 @@ void Names(State* state)
   AWAIT_READY(names);
   ASSERT_EQ(1u, names->size());
   EXPECT_NE(names->find("slaves"), names->end());
+
+  names = state->names("sl");
+  AWAIT_READY(names);
+  ASSERT_EQ(1u, names->size());
+  EXPECT_NE(names->find("slaves"), names->end());
+
+  names = state->names("slaves/");
+  AWAIT_READY(names);
+  EXPECT_TRUE(names->empty());
+}
+
+
+static void add(
+    Batch* batch,
+    Batch::Operation::Type type,
+    const Entry& entry,
+    const Option<string>& uuid = None())
+{
+  Batch::Operation* operation = batch->add_operations();
+  operation->set_type(type);
+  operation->mutable_entry()->CopyFrom(entry);
+
+  if (uuid.isSome()) {
+    operation->set_uuid(uuid.get());
+  }
+}
+
+
+void ApplyBatch(Storage* storage)
+{
+  Entry a;
+  a.set_name("a");
+  a.set_uuid(UUID::random().toBytes());
+  a.set_value("1");
+
+  Entry b;
+  b.set_name("b");
+  b.set_uuid(UUID::random().toBytes());
+  b.set_value("2");
+
+  Batch batch;
+  add(&batch, Batch::Operation::SET, a);
+  add(&batch, Batch::Operation::SET, b);
+
+  AWAIT_TRUE(storage->apply(batch));
+
+  Future<std::set<string>> names = storage->names();
+  AWAIT_READY(names);
+  EXPECT_EQ(set<string>({"a", "b"}), names.get());
+
+  // A version mismatch for one entry fails the whole batch.
+  Entry a2(a);
+  a2.set_uuid(UUID::random().toBytes());
+  a2.set_value("3");
+
+  batch.Clear();
+  add(&batch, Batch::Operation::SET, a2, UUID::random().toBytes());
+  add(&batch, Batch::Operation::EXPUNGE, b);
+
+  AWAIT_FALSE(storage->apply(batch));
+
+  Future<Option<Entry>> entry = storage->get("a");
+  AWAIT_READY(entry);
+  ASSERT_SOME(entry.get());
+  EXPECT_EQ("1", entry->get().value());
+
+  entry = storage->get("b");
+  AWAIT_READY(entry);
+  EXPECT_SOME(entry.get());
+
+  batch.Clear();
+  add(&batch, Batch::Operation::SET, a2, a.uuid());
+  add(&batch, Batch::Operation::EXPUNGE, b);
+
+  AWAIT_TRUE(storage->apply(batch));
+
+  entry = storage->get("a");
+  AWAIT_READY(entry);
+  ASSERT_SOME(entry.get());
+  EXPECT_EQ("3", entry->get().value());
+
+  entry = storage->get("b");
+  AWAIT_READY(entry);
+  EXPECT_NONE(entry.get());
+
+  // Multiple operations on the same entry are not allowed.
+  batch.Clear();
+  add(&batch, Batch::Operation::SET, a, a2.uuid());
+  add(&batch, Batch::Operation::EXPUNGE, a2);
+
+  AWAIT_FAILED(storage->apply(batch));
 }
 
 
@@ -394,6 +487,12 @@ TEST_F(InMemoryStateTest, Names)
 }
 
 
+TEST_F(InMemoryStateTest, Batch)
+{
+  ApplyBatch(storage);
+}
+
+
 class LevelDBStateTest : public TemporaryDirectoryTest
 {
 public:
@@ -471,6 +570,12 @@ TEST_F(LevelDBStateTest, Names)
 }
 
 
+TEST_F(LevelDBStateTest, Batch)
+{
+  ApplyBatch(storage);
+}
+
+
 class LogStateTest : public TemporaryDirectoryTest
 {
 public:
@@ -570,6 +675,12 @@ TEST_F(LogStateTest, Names)
 }
 
 
+TEST_F(LogStateTest, Batch)
+{
+  ApplyBatch(storage);
+}
+
+
 Future<Option<Variable<Slaves>>> timeout(
     Future<Option<Variable<Slaves>>> future)
 {
@@ -691,6 +802,87 @@ TEST_F(LogStateTest, Diff)
 }
 
 
+TEST_F(LogStateTest, Checkpoint)
+{
+  // Replace the storage with one that checkpoints after every two
+  // operations.
+  delete state;
+  delete storage;
+
+  storage = new mesos::state::LogStorage(log, 1024, 2);
+  state = new State(storage);
+
+  foreach (const string& name, vector<string>({"a", "b", "c"})) {
+    Future<Variable<Slaves>> future1 = state->fetch<Slaves>(name);
+    AWAIT_READY(future1);
+
+    Variable<Slaves> variable = future1.get();
+
+    Slaves slaves = variable.get();
+    slaves.add_slaves()->mutable_info()->set_hostname(name);
+
+    Future<Option<Variable<Slaves>>> future2 =
+      state->store(variable.mutate(slaves));
+
+    AWAIT_READY(future2);
+    ASSERT_SOME(future2.get());
+  }
+
+  // Wait for the checkpoint and the truncation to complete.
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  Log::Reader reader(log);
+
+  Future<Log::Position> beginning = reader.beginning();
+  Future<Log::Position> ending = reader.ending();
+
+  AWAIT_READY(beginning);
+  AWAIT_READY(ending);
+
+  Future<list<Log::Entry>> entries = reader.read(beginning.get(), ending.get());
+
+  AWAIT_READY(entries);
+
+  vector<Operation> operations;
+
+  foreach (const Log::Entry& entry, entries.get()) {
+    Operation operation;
+    ASSERT_TRUE(operation.ParseFromString(entry.data));
+    operations.push_back(operation);
+  }
+
+  // The log should have been truncated up to the checkpoint of the
+  // first two entries, leaving only the snapshot of the third.
+  ASSERT_EQ(2u, operations.size());
+  EXPECT_EQ(Operation::CHECKPOINT, operations[0].type());
+  EXPECT_EQ(2, operations[0].checkpoint().entries_size());
+  EXPECT_EQ(Operation::SNAPSHOT, operations[1].type());
+
+  // A new storage should recover every entry from the checkpoint and
+  // the operations after it.
+  delete state;
+  delete storage;
+
+  storage = new mesos::state::LogStorage(log, 1024, 2);
+  state = new State(storage);
+
+  foreach (const string& name, vector<string>({"a", "b", "c"})) {
+    Future<Variable<Slaves>> future = state->fetch<Slaves>(name);
+    AWAIT_READY(future);
+
+    Slaves slaves = future->get();
+    ASSERT_EQ(1, slaves.slaves().size());
+    EXPECT_EQ(name, slaves.slaves(0).info().hostname());
+  }
+
+  Future<set<string>> names = state->names();
+  AWAIT_READY(names);
+  EXPECT_EQ(set<string>({"a", "b", "c"}), names.get());
+}
+
+
 #ifdef MESOS_HAS_JAVA
 class ZooKeeperStateTest : public tests::ZooKeeperTest
 {
@@ -762,6 +954,12 @@ TEST_F(ZooKeeperStateTest, Names)
 {
   Names(state);
 }
+
+
+TEST_F(ZooKeeperStateTest, Batch)
+{
+  ApplyBatch(storage);
+}
 #endif // MESOS_HAS_JAVA
 
 } // namespace tests {
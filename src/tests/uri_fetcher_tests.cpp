@@ -23,6 +23,8 @@
 
 #include <stout/check.hpp>
 #include <stout/duration.hpp>
+#include <stout/json.hpp>
+#include <stout/numify.hpp>
 #include <stout/gtest.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
@@ -43,6 +45,8 @@
 #include "uri/schemes/hdfs.hpp"
 #include "uri/schemes/http.hpp"
 
+#include "uri/utils.hpp"
+
 namespace http = process::http;
 
 using std::list;
@@ -265,6 +269,160 @@ TEST_F(HadoopFetcherPluginTest, InvokeFetchByName)
 #endif // __WINDOWS__
 
 
+// Emulates the WebHDFS API of a namenode serving a single file, and of
+// the datanode the reads of the file get redirected to.
+class TestWebHdfsServer : public Process<TestWebHdfsServer>
+{
+public:
+  TestWebHdfsServer(
+      const string& _path,
+      const string& _data,
+      const Option<string>& _token)
+    : ProcessBase("webhdfs"),
+      path(_path),
+      data(_data),
+      token(_token) {}
+
+protected:
+  virtual void initialize()
+  {
+    route("/v1", None(), &TestWebHdfsServer::namenode);
+    route("/datanode", None(), &TestWebHdfsServer::datanode);
+  }
+
+private:
+  Future<http::Response> namenode(const http::Request& request)
+  {
+    if (request.url.path != "/webhdfs/v1" + path) {
+      return http::NotFound(
+          "{\"RemoteException\":"
+          "{\"exception\":\"FileNotFoundException\"}}");
+    }
+
+    if (token.isSome() && request.url.query.get("delegation") != token) {
+      return http::Unauthorized({});
+    }
+
+    Option<string> op = request.url.query.get("op");
+
+    if (op == string("GETFILESTATUS")) {
+      JSON::Object status;
+      status.values["type"] = "FILE";
+      status.values["length"] = data.size();
+
+      JSON::Object object;
+      object.values["FileStatus"] = status;
+
+      return http::OK(object);
+    }
+
+    if (op == string("OPEN")) {
+      http::URL location(
+          "http",
+          self().address.ip,
+          self().address.port,
+          "/webhdfs/datanode",
+          request.url.query);
+
+      return http::TemporaryRedirect(stringify(location));
+    }
+
+    return http::BadRequest();
+  }
+
+  Future<http::Response> datanode(const http::Request& request)
+  {
+    Try<size_t> offset =
+      numify<size_t>(request.url.query.get("offset").getOrElse(""));
+    Try<size_t> length =
+      numify<size_t>(request.url.query.get("length").getOrElse(""));
+
+    if (offset.isError() || length.isError()) {
+      return http::BadRequest();
+    }
+
+    return http::OK(data.substr(offset.get(), length.get()));
+  }
+
+  const string path;
+  const string data;
+  const Option<string> token;
+};
+
+
+class WebHdfsFetcherPluginTest : public TemporaryDirectoryTest
+{
+protected:
+  URI webhdfs(const string& path)
+  {
+    return uri::construct(
+        "webhdfs",
+        path,
+        stringify(server->self().address.ip),
+        server->self().address.port);
+  }
+
+  void startServer(
+      const string& path,
+      const string& data,
+      const Option<string>& token = None())
+  {
+    server.reset(new TestWebHdfsServer(path, data, token));
+    spawn(server.get());
+  }
+
+  virtual void TearDown()
+  {
+    if (server.get() != nullptr) {
+      terminate(server.get());
+      wait(server.get());
+    }
+
+    TemporaryDirectoryTest::TearDown();
+  }
+
+  Owned<TestWebHdfsServer> server;
+};
+
+
+// This test verifies that a file read in multiple concurrent ranges,
+// each redirected to the datanode, is reassembled in order.
+TEST_F_TEMP_DISABLED_ON_WINDOWS(WebHdfsFetcherPluginTest, FetchExistingFile)
+{
+  const string data = "abcdefghijklmnopqrstuvwxyz";
+
+  startServer("/dir/file", data, "token");
+
+  uri::fetcher::Flags flags;
+  flags.webhdfs_delegation_token = "token";
+  flags.webhdfs_read_size = Bytes(3);
+  flags.webhdfs_parallel_reads = 4;
+
+  Try<Owned<uri::Fetcher>> fetcher = uri::fetcher::create(flags);
+  ASSERT_SOME(fetcher);
+
+  const string dir = path::join(os::getcwd(), "dir");
+
+  AWAIT_READY(
+      fetcher.get()->fetch(webhdfs("/dir/file"), dir, "webhdfs", None()));
+
+  EXPECT_SOME_EQ(data, os::read(path::join(dir, "file")));
+}
+
+
+TEST_F_TEMP_DISABLED_ON_WINDOWS(WebHdfsFetcherPluginTest, FetchNonExistingFile)
+{
+  startServer("/dir/file", "abc");
+
+  Try<Owned<uri::Fetcher>> fetcher = uri::fetcher::create();
+  ASSERT_SOME(fetcher);
+
+  const string dir = path::join(os::getcwd(), "dir");
+
+  AWAIT_FAILED(fetcher.get()->fetch(webhdfs("/dir/non-exist"), dir));
+}
+
+
 // TODO(jieyu): Expose this constant so that other docker related
 // tests can use this as well.
 static constexpr char DOCKER_REGISTRY_HOST[] = "registry-1.docker.io";
@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 
+#include <iostream>
 #include <sstream>
 
 #include <gtest/gtest.h>
@@ -24,14 +25,20 @@
 
 #include <stout/gtest.hpp>
 #include <stout/interval.hpp>
+#include <stout/stopwatch.hpp>
 #include <stout/try.hpp>
 
 #include "common/values.hpp"
 
 #include "master/master.hpp"
 
+#include "tests/resources_utils.hpp"
+
 using namespace mesos::internal::values;
 
+using std::cout;
+using std::endl;
+
 namespace mesos {
   extern void coalesce(Value::Ranges* ranges);
   extern void coalesce(Value::Ranges* ranges, const Value::Range& range);
@@ -477,6 +484,80 @@ TEST(ValuesTest, RangesSubtraction)
   EXPECT_EQ(parse("[3-8]")->ranges(), ranges1 - ranges2);
 }
 
+
+class Values_Ranges_BENCHMARK_Test
+  : public ::testing::Test,
+    public ::testing::WithParamInterface<size_t> {};
+
+
+// The ranges benchmark is parameterized by the number of ranges,
+// which resembles the fragmented ports of an agent with many tasks.
+INSTANTIATE_TEST_CASE_P(
+    Ranges,
+    Values_Ranges_BENCHMARK_Test,
+    ::testing::Values(10U, 100U, 1000U, 10000U));
+
+
+// Measures the range arithmetic on fragmented ranges, e.g., when
+// offering the ports of an agent and checking that the ports used by
+// a task are contained in the offered ports.
+TEST_P(Values_Ranges_BENCHMARK_Test, Arithmetic)
+{
+  const size_t numRanges = GetParam();
+  const size_t totalOperations = 1000000 / numRanges;
+
+  Try<Value::Ranges> fragmented =
+    fragment(createRange(1, 4 * numRanges), numRanges);
+  ASSERT_SOME(fragmented);
+
+  Value::Ranges ranges;
+  ranges.add_range()->CopyFrom(createRange(1, 4 * numRanges));
+
+  // Every other fragment, i.e., a strict subset of the fragmented ranges.
+  Value::Ranges subset;
+  for (int i = 0; i < fragmented->range_size(); i += 2) {
+    subset.add_range()->CopyFrom(fragmented->range(i));
+  }
+
+  Stopwatch watch;
+
+  watch.start();
+  for (size_t i = 0; i < totalOperations; i++) {
+    Value::Ranges result = subset + fragmented.get();
+  }
+  watch.stop();
+
+  cout << "Took " << watch.elapsed() << " to perform " << totalOperations
+       << " 'a + b' operations on " << numRanges << " ranges" << endl;
+
+  watch.start();
+  for (size_t i = 0; i < totalOperations; i++) {
+    Value::Ranges result = ranges - fragmented.get();
+  }
+  watch.stop();
+
+  cout << "Took " << watch.elapsed() << " to perform " << totalOperations
+       << " 'a - b' operations on " << numRanges << " ranges" << endl;
+
+  watch.start();
+  for (size_t i = 0; i < totalOperations; i++) {
+    EXPECT_TRUE(subset <= fragmented.get());
+  }
+  watch.stop();
+
+  cout << "Took " << watch.elapsed() << " to perform " << totalOperations
+       << " 'a <= b' operations on " << numRanges << " ranges" << endl;
+
+  watch.start();
+  for (size_t i = 0; i < totalOperations; i++) {
+    EXPECT_FALSE(fragmented.get() == subset);
+  }
+  watch.stop();
+
+  cout << "Took " << watch.elapsed() << " to perform " << totalOperations
+       << " 'a == b' operations on " << numRanges << " ranges" << endl;
+}
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
@@ -15,6 +15,7 @@
 // limitations under the License.
 
 #include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 
@@ -141,6 +142,45 @@ TEST_F(ZooKeeperTest, Create)
 }
 
 
+TEST_F(ZooKeeperTest, PipelinedGet)
+{
+  ZooKeeperTest::TestWatcher watcher;
+
+  ZooKeeper zk(server->connectString(), NO_TIMEOUT, &watcher);
+  watcher.awaitSessionEvent(ZOO_CONNECTED_STATE);
+
+  EXPECT_EQ(ZOK, zk.create("/foo",
+                           "42",
+                           ZOO_OPEN_ACL_UNSAFE,
+                           0,
+                           nullptr));
+  EXPECT_EQ(ZOK, zk.create("/bar",
+                           "43",
+                           ZOO_OPEN_ACL_UNSAFE,
+                           0,
+                           nullptr));
+
+  std::vector<std::string> results;
+  std::vector<Stat> stats;
+
+  std::vector<int> codes =
+    zk.get({"/foo", "/baz", "/bar"}, false, &results, &stats);
+
+  ASSERT_EQ(3u, codes.size());
+  ASSERT_EQ(3u, results.size());
+  ASSERT_EQ(3u, stats.size());
+
+  EXPECT_EQ(ZOK, codes[0]);
+  EXPECT_EQ("42", results[0]);
+  EXPECT_EQ(2, stats[0].dataLength);
+
+  EXPECT_EQ(ZNONODE, codes[1]);
+
+  EXPECT_EQ(ZOK, codes[2]);
+  EXPECT_EQ("43", results[2]);
+}
+
+
 TEST_F(ZooKeeperTest, LeaderDetector)
 {
   Group group(server->connectString(), NO_TIMEOUT, "/test/");
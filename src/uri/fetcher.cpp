@@ -54,6 +54,8 @@ Try<Owned<Fetcher>> create(const Option<Flags>& _flags)
     // TODO(dpravat): Enable `Hadoop` and `Docker` plugins. See MESOS-5473.
     {HadoopFetcherPlugin::NAME,
        [flags]() { return HadoopFetcherPlugin::create(flags); }},
+    {WebHdfsFetcherPlugin::NAME,
+       [flags]() { return WebHdfsFetcherPlugin::create(flags); }},
     {DockerFetcherPlugin::NAME,
        [flags]() { return DockerFetcherPlugin::create(flags); }},
 #endif // __WINDOWS__
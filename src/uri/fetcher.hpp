@@ -29,6 +29,7 @@
 #include "uri/fetchers/curl.hpp"
 #include "uri/fetchers/docker.hpp"
 #include "uri/fetchers/hadoop.hpp"
+#include "uri/fetchers/webhdfs.hpp"
 
 namespace mesos {
 namespace uri {
@@ -45,6 +46,7 @@ class Flags :
 #else
   public virtual CurlFetcherPlugin::Flags,
   public virtual HadoopFetcherPlugin::Flags,
+  public virtual WebHdfsFetcherPlugin::Flags,
   public virtual DockerFetcherPlugin::Flags {};
 #endif // __WINDOWS__
 
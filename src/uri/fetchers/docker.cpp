@@ -205,6 +205,70 @@ static Future<http::Response> curl(
 }
 
 
+// Sends an HTTP GET request to the given URL from within this process,
+// instead of running the curl command, and returns the HTTP response
+// it received. Location redirections are followed like `curl -L` does,
+// except that the headers are only sent along to the same origin. The
+// returned HTTP response will have the type 'BODY' (no streaming).
+static Future<http::Response> request(
+    const string& uri,
+    const http::Headers& headers,
+    size_t redirects = 0)
+{
+  // Same as the default maximum of curl.
+  constexpr size_t MAX_REDIRECTS = 50;
+
+  Try<http::URL> url = http::URL::parse(strings::trim(uri));
+  if (url.isError()) {
+    return Failure("Failed to parse URL '" + uri + "': " + url.error());
+  }
+
+  http::Request request;
+  request.method = "GET";
+  request.url = url.get();
+  request.headers = headers;
+
+  return http::request(request)
+    .then([=](const http::Response& response) -> Future<http::Response> {
+      const Option<string> location = response.headers.get("Location");
+
+      if (location.isNone() ||
+          (response.code != http::Status::MOVED_PERMANENTLY &&
+           response.code != http::Status::FOUND &&
+           response.code != http::Status::SEE_OTHER &&
+           response.code != http::Status::TEMPORARY_REDIRECT)) {
+        return response;
+      }
+
+      if (redirects >= MAX_REDIRECTS) {
+        return Failure(
+            "Maximum (" + stringify(MAX_REDIRECTS) + ") redirects followed");
+      }
+
+      http::URL origin = url.get();
+      origin.path = "/";
+      origin.query.clear();
+      origin.fragment = None();
+
+      // Resolve a relative location against the origin of the URL,
+      // without the trailing '/'.
+      const string prefix = strings::remove(
+          stringify(origin), "/", strings::SUFFIX);
+
+      const string target = strings::startsWith(location.get(), "/")
+        ? prefix + location.get()
+        : location.get();
+
+      return ::mesos::uri::request(
+          target,
+          strings::startsWith(target, prefix + "/")
+            ? headers
+            : http::Headers(),
+          redirects + 1);
+    });
+}
+
+
 // TODO(jieyu): Add a comment here.
 static Future<int> download(
     const string& uri,
@@ -375,9 +439,11 @@ class DockerFetcherPluginProcess : public Process<DockerFetcherPluginProcess>
 {
 public:
   DockerFetcherPluginProcess(
-      const hashmap<string, spec::Config::Auth>& _auths)
+      const hashmap<string, spec::Config::Auth>& _auths,
+      bool _inProcessRequests)
     : ProcessBase(process::ID::generate("docker-fetcher-plugin")),
-      auths(_auths) {}
+      auths(_auths),
+      inProcessRequests(_inProcessRequests) {}
 
   Future<Nothing> fetch(
       const URI& uri,
@@ -422,10 +488,23 @@ private:
   URI getManifestUri(const URI& uri);
   URI getBlobUri(const URI& uri);
 
+  // Sends an HTTP GET request for a manifest or an auth token, either
+  // with the curl command or from within this process.
+  Future<http::Response> get(
+      const string& uri,
+      const http::Headers& headers);
+
+  Future<http::Response> get(
+      const URI& uri,
+      const http::Headers& headers);
+
   // This is a lookup table for credentials in docker config file,
   // keyed by registry URL.
   // For example, "https://index.docker.io/v1/" -> spec::Config::Auth
   hashmap<string, spec::Config::Auth> auths;
+
+  // See `--docker_in_process_requests`.
+  const bool inProcessRequests;
 };
 
 
@@ -434,6 +513,13 @@ DockerFetcherPlugin::Flags::Flags()
   add(&Flags::docker_config,
       "docker_config",
       "The default docker config file.");
+
+  add(&Flags::docker_in_process_requests,
+      "docker_in_process_requests",
+      "Whether to send the HTTP requests for image manifests and auth\n"
+      "tokens from within this process rather than with the curl command.\n"
+      "Blobs are always downloaded with the curl command.",
+      false);
 }
 
 
@@ -457,7 +543,8 @@ Try<Owned<Fetcher::Plugin>> DockerFetcherPlugin::create(const Flags& flags)
   }
 
   Owned<DockerFetcherPluginProcess> process(new DockerFetcherPluginProcess(
-      hashmap<string, spec::Config::Auth>(auths)));
+      hashmap<string, spec::Config::Auth>(auths),
+      flags.docker_in_process_requests));
 
   return Owned<Fetcher::Plugin>(new DockerFetcherPlugin(process));
 }
@@ -569,7 +656,7 @@ Future<Nothing> DockerFetcherPluginProcess::fetch(
     {"Accept", "application/vnd.docker.distribution.manifest.v1+json"}
   };
 
-  return curl(manifestUri, manifestHeaders + basicAuthHeaders)
+  return get(manifestUri, manifestHeaders + basicAuthHeaders)
     .then(defer(self(),
                 &Self::_fetch,
                 uri,
@@ -594,7 +681,7 @@ Future<Nothing> DockerFetcherPluginProcess::_fetch(
     return getAuthHeader(manifestUri, basicAuthHeaders, response)
       .then(defer(self(), [=](
           const http::Headers& authHeaders) -> Future<Nothing> {
-        return curl(manifestUri, manifestHeaders + authHeaders)
+        return get(manifestUri, manifestHeaders + authHeaders)
           .then(defer(self(),
                       &Self::__fetch,
                       uri,
@@ -727,7 +814,7 @@ Future<Nothing> DockerFetcherPluginProcess::_fetchBlob(
   // HTTP headers from 'download'. Currently, 'download' only returns
   // the HTTP response code because we don't support parsing HTTP
   // headers alone. Revisit this once that's supported.
-  return curl(blobUri, basicAuthHeaders)
+  return get(blobUri, basicAuthHeaders)
     .then(defer(self(), [=](const http::Response& response) -> Future<Nothing> {
       // We expect a '401 Unauthorized' response here since the
       // 'download' with the same URI returns a '401 Unauthorized'.
@@ -812,7 +899,7 @@ Future<http::Headers> DockerFetcherPluginProcess::getAuthHeader(
       "service=" + authParam.at("service") + "&" +
       "scope=" + authParam.at("scope");
 
-    return curl(authServerUri, basicAuthHeaders)
+    return get(authServerUri, basicAuthHeaders)
       .then([authServerUri](
           const http::Response& response) -> Future<http::Headers> {
         if (response.code != http::Status::OK) {
@@ -844,6 +931,40 @@ Future<http::Headers> DockerFetcherPluginProcess::getAuthHeader(
 }
 
 
+Future<http::Response> DockerFetcherPluginProcess::get(
+    const string& uri,
+    const http::Headers& headers)
+{
+  // Requests sent from within this process neither go through a proxy
+  // nor, unless libprocess is built with SSL support, use HTTPS.
+  bool inProcess = inProcessRequests &&
+    os::getenv("http_proxy").isNone() &&
+    os::getenv("HTTP_PROXY").isNone() &&
+    os::getenv("https_proxy").isNone() &&
+    os::getenv("HTTPS_PROXY").isNone();
+
+#ifndef USE_SSL_SOCKET
+  if (strings::startsWith(strings::trim(uri), "https://")) {
+    inProcess = false;
+  }
+#endif // USE_SSL_SOCKET
+
+  if (inProcess) {
+    return request(uri, headers);
+  }
+
+  return curl(uri, headers);
+}
+
+
+Future<http::Response> DockerFetcherPluginProcess::get(
+    const URI& uri,
+    const http::Headers& headers)
+{
+  return get(stringify(uri), headers);
+}
+
+
 URI DockerFetcherPluginProcess::getManifestUri(const URI& uri)
 {
   string scheme = "https";
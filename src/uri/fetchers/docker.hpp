@@ -40,6 +40,7 @@ public:
     Flags();
 
     Option<JSON::Object> docker_config;
+    bool docker_in_process_requests;
   };
 
   static const char NAME[];
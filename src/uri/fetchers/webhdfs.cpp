@@ -0,0 +1,351 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+
+#include <process/collect.hpp>
+#include <process/http.hpp>
+
+#include <stout/error.hpp>
+#include <stout/foreach.hpp>
+#include <stout/json.hpp>
+#include <stout/path.hpp>
+#include <stout/stringify.hpp>
+
+#include <stout/os/close.hpp>
+#include <stout/os/mkdir.hpp>
+#include <stout/os/open.hpp>
+
+#include "uri/fetchers/webhdfs.hpp"
+
+namespace http = process::http;
+
+using std::list;
+using std::set;
+using std::shared_ptr;
+using std::string;
+
+using process::Failure;
+using process::Future;
+using process::Owned;
+
+namespace mesos {
+namespace uri {
+
+// The number of redirects followed by a request, e.g., from the
+// namenode to the datanode holding the requested range.
+static constexpr int MAX_REDIRECTS = 5;
+
+
+// The state shared by the concurrent reads of a file.
+struct Download
+{
+  Download(int_fd _fd, uint64_t _length)
+    : fd(_fd), length(_length), failed(false) {}
+
+  ~Download() { os::close(fd); }
+
+  const int_fd fd;
+  const uint64_t length;
+
+  // Set once a read failed, to stop the other reads early.
+  std::atomic_bool failed;
+};
+
+
+WebHdfsFetcherPlugin::Flags::Flags()
+{
+  add(&Flags::webhdfs_user,
+      "webhdfs_user",
+      "The user to send WebHDFS requests as, when the cluster uses simple\n"
+      "authentication. Overridden by the user of the URI, if any.\n");
+
+  add(&Flags::webhdfs_delegation_token,
+      "webhdfs_delegation_token",
+      "The delegation token to authenticate WebHDFS requests with, e.g.,\n"
+      "when the cluster uses Kerberos.\n");
+
+  add(&Flags::webhdfs_read_size,
+      "webhdfs_read_size",
+      "The size of the ranges a file is read in by WebHDFS requests.\n",
+      Megabytes(16));
+
+  add(&Flags::webhdfs_parallel_reads,
+      "webhdfs_parallel_reads",
+      "The maximum number of ranges of a file read concurrently.\n",
+      4);
+}
+
+
+const char WebHdfsFetcherPlugin::NAME[] = "webhdfs";
+
+
+Try<Owned<Fetcher::Plugin>> WebHdfsFetcherPlugin::create(const Flags& flags)
+{
+  if (flags.webhdfs_read_size == Bytes(0)) {
+    return Error("Expecting 'webhdfs_read_size' to be positive");
+  }
+
+  if (flags.webhdfs_parallel_reads == 0) {
+    return Error("Expecting 'webhdfs_parallel_reads' to be positive");
+  }
+
+  return Owned<Fetcher::Plugin>(new WebHdfsFetcherPlugin(
+      flags.webhdfs_user,
+      flags.webhdfs_delegation_token,
+      flags.webhdfs_read_size,
+      flags.webhdfs_parallel_reads));
+}
+
+
+set<string> WebHdfsFetcherPlugin::schemes() const
+{
+  return {"webhdfs", "swebhdfs"};
+}
+
+
+string WebHdfsFetcherPlugin::name() const
+{
+  return NAME;
+}
+
+
+// Sends a GET request, following the redirects of the namenode.
+static Future<http::Response> send(
+    const http::URL& url,
+    int redirects = MAX_REDIRECTS)
+{
+  return http::get(url)
+    .then([=](const http::Response& response) -> Future<http::Response> {
+      if (response.code == http::Status::TEMPORARY_REDIRECT) {
+        if (redirects == 0) {
+          return Failure("Too many redirects from '" + stringify(url) + "'");
+        }
+
+        Option<string> location = response.headers.get("Location");
+        if (location.isNone()) {
+          return Failure(
+              "Missing 'Location' header in redirect from '" +
+              stringify(url) + "'");
+        }
+
+        Try<http::URL> redirect = http::URL::parse(location.get());
+        if (redirect.isError()) {
+          return Failure(
+              "Failed to parse redirect location '" + location.get() +
+              "': " + redirect.error());
+        }
+
+        return send(redirect.get(), redirects - 1);
+      }
+
+      if (response.code != http::Status::OK) {
+        // The body holds the 'RemoteException' reported by HDFS.
+        return Failure(
+            "Unexpected response '" + response.status + "' from '" +
+            stringify(url) + "': " + response.body);
+      }
+
+      return response;
+    });
+}
+
+
+// Writes all the data at the given offset of the file.
+static Try<Nothing> write(int_fd fd, const string& data, uint64_t offset)
+{
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t length = ::pwrite(
+        fd,
+        data.data() + written,
+        data.size() - written,
+        offset + written);
+
+    if (length < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return ErrnoError();
+    }
+
+    written += length;
+  }
+
+  return Nothing();
+}
+
+
+// Reads the ranges of the file starting at `offset` and every `stride`
+// bytes after it, one after the other.
+static Future<Nothing> read(
+    const http::URL& url,
+    const shared_ptr<Download>& download,
+    uint64_t offset,
+    uint64_t size,
+    uint64_t stride)
+{
+  if (offset >= download->length || download->failed.load()) {
+    return Nothing();
+  }
+
+  const uint64_t length = std::min(size, download->length - offset);
+
+  http::URL range = url;
+  range.query["op"] = "OPEN";
+  range.query["offset"] = stringify(offset);
+  range.query["length"] = stringify(length);
+
+  return send(range)
+    .then([=](const http::Response& response) -> Future<Nothing> {
+      if (response.body.size() != length) {
+        return Failure(
+            "Expected " + stringify(length) + " bytes at offset " +
+            stringify(offset) + " but received " +
+            stringify(response.body.size()));
+      }
+
+      Try<Nothing> write = uri::write(download->fd, response.body, offset);
+      if (write.isError()) {
+        return Failure(
+            "Failed to write " + stringify(length) + " bytes at offset " +
+            stringify(offset) + ": " + write.error());
+      }
+
+      return read(url, download, offset + stride, size, stride);
+    })
+    .onFailed([=](const string&) {
+      download->failed.store(true);
+    });
+}
+
+
+Future<Nothing> WebHdfsFetcherPlugin::fetch(
+    const URI& uri,
+    const string& directory,
+    const Option<string>& data) const
+{
+  if (!uri.has_host()) {
+    return Failure("URI host is not specified");
+  }
+
+  if (!uri.has_path()) {
+    return Failure("URI path is not specified");
+  }
+
+  Try<Nothing> mkdir = os::mkdir(directory);
+  if (mkdir.isError()) {
+    return Failure(
+        "Failed to create directory '" +
+        directory + "': " + mkdir.error());
+  }
+
+  // The default ports are the ones of the namenode's HTTP server.
+  const bool secure = uri.scheme() == "swebhdfs";
+
+  http::URL url(
+      secure ? "https" : "http",
+      uri.host(),
+      uri.has_port() ? uri.port() : (secure ? 50470 : 50070),
+      path::join("/webhdfs/v1", uri.path()));
+
+  if (delegationToken.isSome()) {
+    url.query["delegation"] = delegationToken.get();
+  } else if (uri.has_user()) {
+    url.query["user.name"] = uri.user();
+  } else if (user.isSome()) {
+    url.query["user.name"] = user.get();
+  }
+
+  const string output = path::join(directory, Path(uri.path()).basename());
+
+  // Look up the length of the file first, so that its ranges can be
+  // read concurrently.
+  http::URL status = url;
+  status.query["op"] = "GETFILESTATUS";
+
+  const uint64_t size = readSize.bytes();
+  const size_t parallelism = parallelReads;
+
+  return send(status)
+    .then([=](const http::Response& response) -> Future<Nothing> {
+      Try<JSON::Object> object = JSON::parse<JSON::Object>(response.body);
+      if (object.isError()) {
+        return Failure("Failed to parse file status: " + object.error());
+      }
+
+      Result<JSON::String> type =
+        object->find<JSON::String>("FileStatus.type");
+
+      if (!type.isSome() || type->value != "FILE") {
+        return Failure("'" + uri.path() + "' is not a file");
+      }
+
+      Result<JSON::Number> length =
+        object->find<JSON::Number>("FileStatus.length");
+
+      if (!length.isSome()) {
+        return Failure("Failed to find the length of '" + uri.path() + "'");
+      }
+
+      Try<int_fd> fd = os::open(
+          output,
+          O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+          S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+      if (fd.isError()) {
+        return Failure(
+            "Failed to create '" + output + "': " + fd.error());
+      }
+
+      shared_ptr<Download> download(
+          new Download(fd.get(), length->as<uint64_t>()));
+
+      // Each of the concurrent reads takes every `parallelism`-th
+      // range, in order.
+      list<Future<Nothing>> reads;
+      for (size_t i = 0; i < parallelism && i * size < download->length; i++) {
+        reads.push_back(
+            read(url, download, i * size, size, parallelism * size));
+      }
+
+      // NOTE: This waits for all the reads rather than failing as soon
+      // as one does, so that the file is closed once none writes to it.
+      return await(reads)
+        .then([](const list<Future<Nothing>>& reads) -> Future<Nothing> {
+          foreach (const Future<Nothing>& read, reads) {
+            if (!read.isReady()) {
+              return Failure(
+                  "Failed to read file: " +
+                  (read.isFailed() ? read.failure() : "discarded"));
+            }
+          }
+
+          return Nothing();
+        });
+    });
+}
+
+} // namespace uri {
+} // namespace mesos {
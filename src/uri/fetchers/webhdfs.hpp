@@ -0,0 +1,89 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __URI_FETCHERS_WEBHDFS_HPP__
+#define __URI_FETCHERS_WEBHDFS_HPP__
+
+#include <set>
+#include <string>
+
+#include <process/owned.hpp>
+
+#include <stout/bytes.hpp>
+#include <stout/flags.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+#include <mesos/uri/fetcher.hpp>
+
+namespace mesos {
+namespace uri {
+
+// Fetches files from HDFS through the WebHDFS (or HttpFS) REST API of
+// the namenode, e.g., 'webhdfs://namenode:50070/path/to/file'. Unlike
+// the hadoop fetcher plugin, this does not launch the hadoop client
+// (and hence a JVM) for every fetch: the file is read in ranges by
+// concurrent HTTP requests issued from this process.
+class WebHdfsFetcherPlugin : public Fetcher::Plugin
+{
+public:
+  class Flags : public virtual flags::FlagsBase
+  {
+  public:
+    Flags();
+
+    Option<std::string> webhdfs_user;
+    Option<std::string> webhdfs_delegation_token;
+    Bytes webhdfs_read_size;
+    size_t webhdfs_parallel_reads;
+  };
+
+  static const char NAME[];
+
+  static Try<process::Owned<Fetcher::Plugin>> create(const Flags& flags);
+
+  virtual ~WebHdfsFetcherPlugin() {}
+
+  virtual std::set<std::string> schemes() const;
+
+  virtual std::string name() const;
+
+  virtual process::Future<Nothing> fetch(
+      const URI& uri,
+      const std::string& directory,
+      const Option<std::string>& data = None()) const;
+
+private:
+  WebHdfsFetcherPlugin(
+      const Option<std::string>& _user,
+      const Option<std::string>& _delegationToken,
+      const Bytes& _readSize,
+      size_t _parallelReads)
+    : user(_user),
+      delegationToken(_delegationToken),
+      readSize(_readSize),
+      parallelReads(_parallelReads) {}
+
+  const Option<std::string> user;
+  const Option<std::string> delegationToken;
+  const Bytes readSize;
+  const size_t parallelReads;
+};
+
+} // namespace uri {
+} // namespace mesos {
+
+#endif // __URI_FETCHERS_WEBHDFS_HPP__
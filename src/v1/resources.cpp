@@ -39,6 +39,7 @@
 #include <stout/strings.hpp>
 #include <stout/unreachable.hpp>
 
+#include "common/interned.hpp"
 #include "common/resources_utils.hpp"
 
 using std::map;
@@ -49,6 +50,8 @@ using std::vector;
 
 using google::protobuf::RepeatedPtrField;
 
+using mesos::internal::intern;
+
 namespace mesos {
 namespace v1 {
 
@@ -1284,6 +1287,30 @@ const string& Resources::reservationRole(const Resource& resource)
 // Public member functions.
 /////////////////////////////////////////////////
 
+Resources::Resource_::Resource_(const Resource& _resource)
+  : resource(_resource),
+    sharedCount(None())
+{
+  // Setting the counter to 1 to denote "one copy" of the shared resource.
+  if (resource.has_shared()) {
+    sharedCount = 1;
+  }
+
+  updateIds();
+}
+
+
+void Resources::Resource_::updateIds()
+{
+  static const uint32_t unreserved = intern("*");
+
+  nameId = intern(resource.name());
+  roleId = resource.reservations_size() > 0
+    ? intern(resource.reservations().rbegin()->role())
+    : unreserved;
+}
+
+
 Option<Error> Resources::Resource_::validate() const
 {
   if (isShared() && sharedCount.get() < 0) {
@@ -1306,6 +1333,10 @@ bool Resources::Resource_::isEmpty() const
 
 bool Resources::Resource_::contains(const Resource_& that) const
 {
+  if (!mayMatch(that)) {
+    return false;
+  }
+
   // Both Resource_ objects should have the same sharedness.
   if (isShared() != that.isShared()) {
     return false;
@@ -1413,7 +1444,7 @@ bool Resources::contains(const Resources& that) const
 {
   Resources remaining = *this;
 
-  foreach (const Resource_& resource_, that.resources) {
+  foreach (const Resource_& resource_, that) {
     // NOTE: We use _contains because Resources only contain valid
     // Resource objects, and we don't want the performance hit of the
     // validity check.
@@ -1441,7 +1472,7 @@ bool Resources::contains(const Resource& that) const
 
 size_t Resources::count(const Resource& that) const
 {
-  foreach (const Resource_& resource_, resources) {
+  foreach (const Resource_& resource_, *this) {
     if (resource_.resource == that) {
       // Return 1 for non-shared resources because non-shared
       // Resource objects in Resources are unique.
@@ -1455,17 +1486,17 @@ size_t Resources::count(const Resource& that) const
 
 void Resources::allocate(const string& role)
 {
-  foreach (Resource_& resource_, resources) {
-    resource_.resource.mutable_allocation_info()->set_role(role);
+  for (size_t i = 0; i < resources.size(); i++) {
+    mutableResource(i).resource.mutable_allocation_info()->set_role(role);
   }
 }
 
 
 void Resources::unallocate()
 {
-  foreach (Resource_& resource_, resources) {
-    if (resource_.resource.has_allocation_info()) {
-      resource_.resource.clear_allocation_info();
+  for (size_t i = 0; i < resources.size(); i++) {
+    if (resources[i]->resource.has_allocation_info()) {
+      mutableResource(i).resource.clear_allocation_info();
     }
   }
 }
@@ -1474,10 +1505,13 @@ void Resources::unallocate()
 Resources Resources::filter(
     const lambda::function<bool(const Resource&)>& predicate) const
 {
+  // NOTE: No two `Resource_` objects in a `Resources` are addable, so
+  // any subset of them can be used as is, sharing the `Resource_`
+  // objects rather than adding (and copying) them one by one.
   Resources result;
-  foreach (const Resource_& resource_, resources) {
-    if (predicate(resource_.resource)) {
-      result.add(resource_);
+  foreach (const std::shared_ptr<Resource_>& resource_, resources) {
+    if (predicate(resource_->resource)) {
+      result.resources.push_back(resource_);
     }
   }
   return result;
@@ -1488,7 +1522,7 @@ hashmap<string, Resources> Resources::reservations() const
 {
   hashmap<string, Resources> result;
 
-  foreach (const Resource_& resource_, resources) {
+  foreach (const Resource_& resource_, *this) {
     if (isReserved(resource_.resource)) {
       result[reservationRole(resource_.resource)].add(resource_);
     }
@@ -1500,7 +1534,24 @@ hashmap<string, Resources> Resources::reservations() const
 
 Resources Resources::reserved(const Option<string>& role) const
 {
-  return filter(lambda::bind(isReserved, lambda::_1, role));
+  if (role.isNone()) {
+    return filter(lambda::bind(isReserved, lambda::_1, role));
+  }
+
+  // Compare the interned role ids rather than the role strings.
+  const uint32_t roleId = intern(role.get());
+
+  Resources result;
+  foreach (const std::shared_ptr<Resource_>& resource_, resources) {
+    CHECK(!resource_->resource.has_role()) << resource_->resource;
+    CHECK(!resource_->resource.has_reservation()) << resource_->resource;
+
+    if (resource_->roleId == roleId &&
+        resource_->resource.reservations_size() > 0) {
+      result.resources.push_back(resource_);
+    }
+  }
+  return result;
 }
 
 
@@ -1552,7 +1603,7 @@ hashmap<string, Resources> Resources::allocations() const
 {
   hashmap<string, Resources> result;
 
-  foreach (const Resource_& resource_, resources) {
+  foreach (const Resource_& resource_, *this) {
     // We require that this is called only when
     // the resources are allocated.
     CHECK(resource_.resource.has_allocation_info());
@@ -1571,6 +1622,7 @@ Resources Resources::pushReservation(
 
   foreach (Resource_ resource_, *this) {
     resource_.resource.add_reservations()->CopyFrom(reservation);
+    resource_.updateIds();
     CHECK_NONE(Resources::validate(resource_.resource));
     result.add(resource_);
   }
@@ -1583,9 +1635,10 @@ Resources Resources::popReservation() const
 {
   Resources result;
 
-  foreach (Resource_ resource_, resources) {
+  foreach (Resource_ resource_, *this) {
     CHECK_GT(resource_.resource.reservations_size(), 0);
     resource_.resource.mutable_reservations()->RemoveLast();
+    resource_.updateIds();
     result.add(resource_);
   }
 
@@ -1599,6 +1652,7 @@ Resources Resources::toUnreserved() const
 
   foreach (Resource_ resource_, *this) {
     resource_.resource.clear_reservations();
+    resource_.updateIds();
     result.add(resource_);
   }
 
@@ -1610,7 +1664,7 @@ Resources Resources::createStrippedScalarQuantity() const
 {
   Resources stripped;
 
-  foreach (const Resource& resource, resources) {
+  foreach (const Resource& resource, *this) {
     if (resource.type() == Value::SCALAR) {
       Resource scalar = resource;
       scalar.clear_provider_id();
@@ -1696,7 +1750,7 @@ Option<Value::Scalar> Resources::get(const string& name) const
   Value::Scalar total;
   bool found = false;
 
-  foreach (const Resource& resource, resources) {
+  foreach (const Resource& resource, *this) {
     if (resource.name() == name &&
         resource.type() == Value::SCALAR) {
       total += resource.scalar();
@@ -1718,7 +1772,7 @@ Option<Value::Set> Resources::get(const string& name) const
   Value::Set total;
   bool found = false;
 
-  foreach (const Resource& resource, resources) {
+  foreach (const Resource& resource, *this) {
     if (resource.name() == name &&
         resource.type() == Value::SET) {
       total += resource.set();
@@ -1740,7 +1794,7 @@ Option<Value::Ranges> Resources::get(const string& name) const
   Value::Ranges total;
   bool found = false;
 
-  foreach (const Resource& resource, resources) {
+  foreach (const Resource& resource, *this) {
     if (resource.name() == name &&
         resource.type() == Value::RANGES) {
       total += resource.ranges();
@@ -1775,7 +1829,7 @@ Resources Resources::scalars() const
 set<string> Resources::names() const
 {
   set<string> result;
-  foreach (const Resource& resource, resources) {
+  foreach (const Resource& resource, *this) {
     result.insert(resource.name());
   }
 
@@ -1786,7 +1840,7 @@ set<string> Resources::names() const
 map<string, Value_Type> Resources::types() const
 {
   map<string, Value_Type> result;
-  foreach (const Resource& resource, resources) {
+  foreach (const Resource& resource, *this) {
     result[resource.name()] = resource.type();
   }
 
@@ -1866,7 +1920,7 @@ Option<Value::Ranges> Resources::ephemeral_ports() const
 
 bool Resources::_contains(const Resource_& that) const
 {
-  foreach (const Resource_& resource_, resources) {
+  foreach (const Resource_& resource_, *this) {
     if (resource_.contains(that)) {
       return true;
     }
@@ -1903,6 +1957,7 @@ Option<Resources> Resources::find(const Resource& target) const
         foreach (Resource_ r, remaining) {
           r.resource.mutable_reservations()->CopyFrom(
               resource_.resource.reservations());
+          r.updateIds();
 
           found.add(r);
         }
@@ -1928,7 +1983,7 @@ Option<Resources> Resources::find(const Resource& target) const
 Resources::operator RepeatedPtrField<Resource>() const
 {
   RepeatedPtrField<Resource> all;
-  foreach (const Resource& resource, resources) {
+  foreach (const Resource& resource, *this) {
     all.Add()->CopyFrom(resource);
   }
 
@@ -1979,9 +2034,10 @@ void Resources::add(const Resource_& that)
   }
 
   bool found = false;
-  foreach (Resource_& resource_, resources) {
-    if (internal::addable(resource_.resource, that)) {
-      resource_ += that;
+  for (size_t i = 0; i < resources.size(); i++) {
+    if (resources[i]->mayMatch(that) &&
+        internal::addable(resources[i]->resource, that)) {
+      mutableResource(i) += that;
       found = true;
       break;
     }
@@ -1989,7 +2045,7 @@ void Resources::add(const Resource_& that)
 
   // Cannot be combined with any existing Resource object.
   if (!found) {
-    resources.push_back(that);
+    resources.push_back(std::make_shared<Resource_>(that));
   }
 }
 
@@ -2053,9 +2109,9 @@ void Resources::subtract(const Resource_& that)
   }
 
   for (size_t i = 0; i < resources.size(); i++) {
-    Resource_& resource_ = resources[i];
-
-    if (internal::subtractable(resource_.resource, that)) {
+    if (resources[i]->mayMatch(that) &&
+        internal::subtractable(resources[i]->resource, that)) {
+      Resource_& resource_ = mutableResource(i);
       resource_ -= that;
 
       // Remove the resource if it has become negative or empty.
@@ -2086,6 +2142,19 @@ void Resources::subtract(const Resource_& that)
 }
 
 
+Resources::Resource_& Resources::mutableResource(size_t index)
+{
+  CHECK_LT(index, resources.size());
+
+  std::shared_ptr<Resource_>& resource_ = resources[index];
+  if (resource_.use_count() > 1) {
+    resource_ = std::make_shared<Resource_>(*resource_);
+  }
+
+  return *resource_;
+}
+
+
 Resources& Resources::operator-=(const Resource_& that)
 {
   if (that.validate().isNone()) {
@@ -533,6 +533,7 @@ void GroupProcess::expired(int64_t sessionId)
   // Invalidate the cache so that we'll sync with ZK after
   // reconnection.
   memberships = None();
+  contents.clear();
 
   // Set all owned memberships as cancelled.
   foreachpair (int32_t sequence, Promise<bool>* cancelled, utils::copy(owned)) {
@@ -697,6 +698,10 @@ Result<Option<string>> GroupProcess::doData(
       zkBasename(membership),
       os::POSIX_PATH_SEPARATOR);
 
+  if (contents.count(membership.sequence) > 0) {
+    return Some(contents.at(membership.sequence));
+  }
+
   LOG(INFO) << "Trying to get '" << path << "' in ZooKeeper";
 
   // Get data associated with ephemeral node.
@@ -801,6 +806,42 @@ Try<bool> GroupProcess::cache()
     current.insert(Group::Membership(sequence, label, cancelled->future()));
   }
 
+  // Read the data of the new memberships, pipelining the reads rather
+  // than reading the data of each membership when it's requested.
+  vector<string> paths;
+  vector<int32_t> added;
+
+  foreach (const Group::Membership& membership, current) {
+    if (contents.count(membership.sequence) == 0) {
+      paths.push_back(path::join(
+          znode,
+          zkBasename(membership),
+          os::POSIX_PATH_SEPARATOR));
+
+      added.push_back(membership.sequence);
+    }
+  }
+
+  // Remove the data of the memberships that are now missing.
+  foreachkey (int32_t sequence, utils::copy(contents)) {
+    if (owned.count(sequence) == 0 && unowned.count(sequence) == 0) {
+      contents.erase(sequence);
+    }
+  }
+
+  if (!paths.empty()) {
+    vector<string> datas;
+    const vector<int> codes = zk->get(paths, false, &datas, nullptr);
+
+    // NOTE: We don't fail caching the memberships if any of the reads
+    // fail, the data is then read by 'doData' instead.
+    for (size_t i = 0; i < codes.size(); i++) {
+      if (codes[i] == ZOK) {
+        contents[added[i]] = datas[i];
+      }
+    }
+  }
+
   memberships = current;
 
   return true;
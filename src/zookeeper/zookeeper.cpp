@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <iostream>
+#include <list>
 #include <map>
 #include <tuple>
 
@@ -24,6 +25,7 @@
 
 #include <mesos/zookeeper/zookeeper.hpp>
 
+#include <process/collect.hpp>
 #include <process/defer.hpp>
 #include <process/dispatch.hpp>
 #include <process/id.hpp>
@@ -39,6 +41,7 @@
 
 using namespace process;
 
+using std::list;
 using std::map;
 using std::string;
 using std::tuple;
@@ -354,6 +357,39 @@ public:
     return future;
   }
 
+  Future<vector<int>> get(
+      const vector<string>& paths,
+      bool watch,
+      vector<string>* results,
+      vector<Stat>* stats)
+  {
+    // The results (and stats) must stay valid until all of the
+    // completions are invoked, which is the case since the caller
+    // blocks on the returned future.
+    CHECK_NOTNULL(results)->assign(paths.size(), string());
+
+    if (stats != nullptr) {
+      stats->assign(paths.size(), Stat());
+    }
+
+    // All of the requests get queued before any of the responses are
+    // awaited, which pipelines them over the connection.
+    list<Future<int>> futures;
+
+    for (size_t i = 0; i < paths.size(); i++) {
+      futures.push_back(get(
+          paths[i],
+          watch,
+          &(*results)[i],
+          stats != nullptr ? &(*stats)[i] : nullptr));
+    }
+
+    return collect(futures)
+      .then([](const list<int>& codes) {
+        return vector<int>(codes.begin(), codes.end());
+      });
+  }
+
   Future<int> getChildren(
       const string& path,
       bool watch,
@@ -405,6 +441,37 @@ public:
     return future;
   }
 
+  Future<int> multi(const vector<zoo_op_t>& ops)
+  {
+    Promise<int>* promise = new Promise<int>();
+
+    Future<int> future = promise->future();
+
+    // The results must stay valid until the completion is invoked.
+    vector<zoo_op_result_t>* results =
+      new vector<zoo_op_result_t>(ops.size());
+
+    tuple<Promise<int>*, vector<zoo_op_result_t>*>* args =
+      new tuple<Promise<int>*, vector<zoo_op_result_t>*>(promise, results);
+
+    int ret = zoo_amulti(
+        zh,
+        ops.size(),
+        ops.data(),
+        results->data(),
+        multiCompletion,
+        args);
+
+    if (ret != ZOK) {
+      delete promise;
+      delete results;
+      delete args;
+      return ret;
+    }
+
+    return future;
+  }
+
 private:
   // This method is registered as a watcher callback function and is
   // invoked by a single ZooKeeper event thread.
@@ -435,6 +502,22 @@ private:
     delete args;
   }
 
+  static void multiCompletion(int ret, const void* data)
+  {
+    const tuple<Promise<int>*, vector<zoo_op_result_t>*>* args =
+      reinterpret_cast<const tuple<Promise<int>*, vector<zoo_op_result_t>*>*>(
+          data);
+
+    Promise<int>* promise = std::get<0>(*args);
+    vector<zoo_op_result_t>* results = std::get<1>(*args);
+
+    promise->set(ret);
+
+    delete promise;
+    delete results;
+    delete args;
+  }
+
   static void stringCompletion(int ret, const char* value, const void* data)
   {
     const tuple<Promise<int>*, string*> *args =
@@ -629,13 +712,26 @@ int ZooKeeper::exists(const string& path, bool watch, Stat* stat)
 
 int ZooKeeper::get(const string& path, bool watch, string* result, Stat* stat)
 {
-  return dispatch(
-      process,
-      &ZooKeeperProcess::get,
-      path,
-      watch,
-      result,
-      stat).get();
+  // NOTE: 'ZooKeeperProcess::get' is overloaded.
+  Future<int> (ZooKeeperProcess::*get)(const string&, bool, string*, Stat*) =
+    &ZooKeeperProcess::get;
+
+  return dispatch(process, get, path, watch, result, stat).get();
+}
+
+
+vector<int> ZooKeeper::get(
+    const vector<string>& paths,
+    bool watch,
+    vector<string>* results,
+    vector<Stat>* stats)
+{
+  // NOTE: 'ZooKeeperProcess::get' is overloaded.
+  Future<vector<int>> (ZooKeeperProcess::*get)(
+      const vector<string>&, bool, vector<string>*, vector<Stat>*) =
+    &ZooKeeperProcess::get;
+
+  return dispatch(process, get, paths, watch, results, stats).get();
 }
 
 
@@ -664,6 +760,12 @@ int ZooKeeper::set(const string& path, const string& data, int version)
 }
 
 
+int ZooKeeper::multi(const vector<zoo_op_t>& ops)
+{
+  return dispatch(process, &ZooKeeperProcess::multi, ops).get();
+}
+
+
 string ZooKeeper::message(int code) const
 {
   return string(zerror(code));
@@ -0,0 +1,138 @@
+#!/usr/bin/env python
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Compares the benchmark reports of two test runs.
+
+The benchmarks write their reports, one JSON object per line, to the
+file named by the `BENCHMARK_OUTPUT` environment variable when run
+with `--benchmark`, e.g.:
+
+  $ BENCHMARK_OUTPUT=baseline.json ./bin/mesos-tests.sh --benchmark \\
+      --gtest_filter='*Sorter_BENCHMARK*'
+
+This script matches the metrics of the reports of a baseline run and
+of a new run by the name of the benchmark, and prints the relative
+change of a statistic of each metric. It exits with a non-zero status
+if any metric regressed by more than the threshold, so that a stored
+baseline can be used to catch regressions, e.g., before a release.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    """
+    Returns the reports in the file, keyed by the benchmark name.
+    If a benchmark was run several times, the last report wins.
+    """
+    reports = {}
+    with open(path) as file:
+        for line in file:
+            line = line.strip()
+            if line:
+                report = json.loads(line)
+                reports[report['name']] = report
+    return reports
+
+
+def higher_is_better(metric):
+    """Rates are reported with a unit ending with '/s'."""
+    return metric.get('unit', '').endswith('/s')
+
+
+def main():
+    """Main function, compares the reports and prints the changes."""
+    parser = argparse.ArgumentParser(
+        description='Compare the benchmark reports of two test runs.')
+
+    parser.add_argument('baseline', help='Reports of the baseline run.')
+    parser.add_argument('current', help='Reports of the run to compare.')
+
+    parser.add_argument(
+        '--statistic',
+        default='p50',
+        choices=['mean', 'min', 'p50', 'p90', 'p99', 'max'],
+        help='The statistic of the metrics to compare (default: p50).')
+
+    parser.add_argument(
+        '--threshold',
+        type=float,
+        default=10.0,
+        help='The relative change, in percent, beyond which a metric is '
+             'considered to have regressed (default: 10).')
+
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+
+    for name in sorted(set(baseline) & set(current)):
+        print(name)
+
+        if baseline[name].get('parameters') != current[name].get('parameters'):
+            print('  Skipping, the parameters differ')
+            continue
+
+        before = baseline[name]['metrics']
+        after = current[name]['metrics']
+
+        for metric in sorted(set(before) & set(after)):
+            old = before[metric][args.statistic]
+            new = after[metric][args.statistic]
+
+            if old == 0:
+                change = 0.0 if new == 0 else float('inf')
+            else:
+                change = (new - old) * 100.0 / old
+
+            if higher_is_better(after[metric]):
+                regressed = -change > args.threshold
+            else:
+                regressed = change > args.threshold
+
+            if regressed:
+                regressions += 1
+
+            print('  {metric}: {old:g} -> {new:g} {unit} ({change:+.1f}%){flag}'
+                  .format(
+                      metric=metric,
+                      old=old,
+                      new=new,
+                      unit=after[metric].get('unit', ''),
+                      change=change,
+                      flag=' REGRESSED' if regressed else ''))
+
+    for name in sorted(set(baseline) - set(current)):
+        print('{name}: missing from {path}'.format(
+            name=name, path=args.current))
+
+    if regressions > 0:
+        print('{count} metric(s) regressed by more than {threshold:g}%'.format(
+            count=regressions, threshold=args.threshold))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()